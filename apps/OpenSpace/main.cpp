@@ -42,8 +42,10 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/boolean.h>
 #include <sgct.h>
+#include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <thread>
 #include <stb_image.h>
 
 #ifdef WIN32
@@ -805,8 +807,8 @@ void mainDecodeFun() {
     LTRACE("main::mainDecodeFun(begin)");
 
     sgct::SharedData::instance()->readVector(&_synchronizationBuffer);
-    std::vector<char> data = _synchronizationBuffer.getVal();
-    openspace::global::openSpaceEngine.decode(std::move(data));
+    const std::vector<char> data = _synchronizationBuffer.getVal();
+    openspace::global::openSpaceEngine.decode(data);
 
     LTRACE("main::mainDecodeFun(end)");
 #ifdef OPENSPACE_HAS_VTUNE
@@ -1013,6 +1015,16 @@ void setSgctDelegateFunctions() {
             w->getViewport(0)->getNonLinearProjectionPtr()
         ) != nullptr;
     };
+    sgctDelegate.isRightEyeOfSingleViewport = []() {
+        // SGCT renders all viewports of a window for the left eye before the right eye,
+        // so only with a single viewport does the right eye follow its own left eye
+        sgct::Engine* engine = sgct::Engine::instance();
+        if (engine->getCurrentFrustumMode() != sgct_core::Frustum::StereoRightEye) {
+            return false;
+        }
+        sgct::SGCTWindow* w = engine->getCurrentWindowPtr();
+        return w->getNumberOfViewports() == 1 && !w->getViewport(0)->hasSubViewports();
+    };
     sgctDelegate.takeScreenshot = [](bool applyWarping) {
         sgct::SGCTSettings::instance()->setCaptureFromBackBuffer(applyWarping);
         sgct::Engine::instance()->takeScreenshot();
@@ -1236,6 +1248,14 @@ int main(int argc, char** argv) {
     // Disable the immediate exit of the application when the ESC key is pressed
     SgctEngine->setExitKey(SGCT_KEY_UNKNOWN);
 
+    // Read screenshots back through pixel buffer objects and encode them on a pool of
+    // capture threads, so that saving frames during a playback does not stall the
+    // rendering on writing the image files
+    sgct::SGCTSettings::instance()->setUsePBO(true);
+    sgct::SGCTSettings::instance()->setNumberOfCaptureThreads(
+        std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1)
+    );
+
     sgct::MessageHandler::instance()->setNotifyLevel(sgct::MessageHandler::NOTIFY_ALL);
 
     // Set encode and decode functions
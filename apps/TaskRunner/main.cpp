@@ -22,8 +22,17 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
 #include <ghoul/glm.h>
 
 #include <ghoul/ghoul.h>
@@ -34,6 +43,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/directory.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/logging/consolelog.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -43,6 +53,7 @@
 #include <openspace/engine/configuration.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
+#include <openspace/json.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/dashboarditem.h>
@@ -75,13 +86,68 @@ void initTextureReaders() {
     #endif // GHOUL_USE_FREEIMAGE
 }
 
-void performTasks(const std::string& path) {
+/**
+ * Writes machine-readable progress information as one JSON object per line into a
+ * stream. All functions are safe to call from multiple threads at the same time and
+ * they don't do anything if no stream was provided.
+ */
+class ProgressReporter {
+public:
+    explicit ProgressReporter(const std::string& path) {
+        if (!path.empty()) {
+            _stream.open(path);
+            if (!_stream.good()) {
+                LERROR(fmt::format("Could not open progress file '{}'", path));
+            }
+        }
+    }
+
+    void report(nlohmann::json event) {
+        if (!_stream.is_open()) {
+            return;
+        }
+        event["time"] = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - _start
+        ).count();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stream << event.dump() << std::endl;
+    }
+
+private:
+    std::ofstream _stream;
+    std::mutex _mutex;
+    const std::chrono::steady_clock::time_point _start =
+        std::chrono::steady_clock::now();
+};
+
+/**
+ * Performs all tasks that are specified in the task file at \p path. At most
+ * \p nThreads tasks are performed at the same time and a task is only started once all
+ * of the tasks it depends on have finished successfully; tasks whose dependencies are
+ * not met are skipped. Among the tasks that are ready to run, the one that comes first
+ * in the task file is picked first, so with a single thread the tasks run in file order
+ * as long as no dependency points to a later task. If \p progressPath is not empty,
+ * the start, progress, and timing of all tasks are written to that file as JSON lines.
+ */
+void performTasks(const std::string& path, int nThreads,
+                  const std::string& progressPath)
+{
     using namespace openspace;
 
+    enum class Status { Waiting, Running, Succeeded, Failed, Skipped };
+
+    struct TaskInfo {
+        Task* task = nullptr;
+        Status status = Status::Waiting;
+        size_t nUnfinishedDependencies = 0;
+        std::vector<size_t> dependents;
+    };
+
     TaskLoader taskLoader;
     std::vector<std::unique_ptr<Task>> tasks = taskLoader.tasksFromFile(path);
 
-    size_t nTasks = tasks.size();
+    const size_t nTasks = tasks.size();
     if (nTasks == 1) {
         LINFO("Task queue has 1 item");
     }
@@ -89,16 +155,208 @@ void performTasks(const std::string& path) {
         LINFO(fmt::format("Task queue has {} items", tasks.size()));
     }
 
-    for (size_t i = 0; i < tasks.size(); i++) {
-        Task& task = *tasks[i].get();
+    std::map<std::string, size_t> identifiers;
+    for (size_t i = 0; i < nTasks; ++i) {
+        const std::string& identifier = tasks[i]->identifier();
+        if (identifier.empty()) {
+            continue;
+        }
+        if (!identifiers.emplace(identifier, i).second) {
+            LWARNING(fmt::format(
+                "Task {} reuses the identifier '{}' of task {}",
+                i + 1, identifier, identifiers[identifier] + 1
+            ));
+        }
+    }
+
+    ProgressReporter reporter(progressPath);
+
+    std::vector<TaskInfo> infos(nTasks);
+    for (size_t i = 0; i < nTasks; ++i) {
+        infos[i].task = tasks[i].get();
+    }
+
+    // Tasks whose dependencies can never be fulfilled are marked as skipped here already
+    std::vector<size_t> unresolved;
+    for (size_t i = 0; i < nTasks; ++i) {
+        for (const std::string& dependency : tasks[i]->dependencies()) {
+            auto it = identifiers.find(dependency);
+            if (it == identifiers.end() || it->second == i) {
+                LERROR(fmt::format(
+                    "Task {} depends on unknown task '{}'", i + 1, dependency
+                ));
+                unresolved.push_back(i);
+                continue;
+            }
+            infos[it->second].dependents.push_back(i);
+            infos[i].nUnfinishedDependencies++;
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::set<size_t> ready;
+    int nRunning = 0;
+
+    // Has to be called with the mutex locked
+    std::function<void(size_t)> skip = [&](size_t i) {
+        if (infos[i].status != Status::Waiting) {
+            return;
+        }
+        infos[i].status = Status::Skipped;
+        LWARNING(fmt::format(
+            "Skipping task {}: {}", i + 1, infos[i].task->description()
+        ));
+        reporter.report({ { "event", "skipped" }, { "task", i + 1 } });
+        for (size_t d : infos[i].dependents) {
+            skip(d);
+        }
+    };
+
+    for (size_t i : unresolved) {
+        skip(i);
+    }
+    for (size_t i = 0; i < nTasks; ++i) {
+        if (infos[i].status == Status::Waiting && infos[i].nUnfinishedDependencies == 0) {
+            ready.insert(i);
+        }
+    }
+
+    // Only a single task can draw a progress bar at a time
+    const bool useProgressBar = (nThreads == 1);
+
+    auto performTask = [&](size_t i) {
+        Task& task = *infos[i].task;
         LINFO(fmt::format(
-            "Performing task {} out of {}: {}", i + 1, tasks.size(), task.description()
+            "Performing task {} out of {}: {}", i + 1, nTasks, task.description()
         ));
-        ProgressBar progressBar(100);
-        auto onProgress = [&progressBar](float progress) {
-            progressBar.print(static_cast<int>(progress * 100.f));
+        reporter.report({
+            { "event", "started" }, { "task", i + 1 },
+            { "description", task.description() }
+        });
+
+        std::unique_ptr<ProgressBar> progressBar;
+        if (useProgressBar) {
+            progressBar = std::make_unique<ProgressBar>(100);
+        }
+        int lastPercentage = -1;
+        auto onProgress = [&](float progress) {
+            const int percentage = static_cast<int>(progress * 100.f);
+            if (percentage == lastPercentage) {
+                return;
+            }
+            lastPercentage = percentage;
+            if (progressBar) {
+                progressBar->print(percentage);
+            }
+            reporter.report({
+                { "event", "progress" }, { "task", i + 1 }, { "progress", progress }
+            });
         };
-        task.perform(onProgress);
+
+        const auto start = std::chrono::steady_clock::now();
+        bool success = true;
+        try {
+            task.perform(onProgress);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+            success = false;
+        }
+        catch (const std::exception& e) {
+            LERROR(e.what());
+            success = false;
+        }
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+
+        LINFO(fmt::format(
+            "{} task {} after {:.2f} s", success ? "Finished" : "Failed", i + 1, seconds
+        ));
+        reporter.report({
+            { "event", success ? "finished" : "failed" }, { "task", i + 1 },
+            { "duration", seconds }
+        });
+        return success;
+    };
+
+    // Every worker picks the first ready task until no task is ready and there are no
+    // running tasks left that could make one ready
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [&]() { return !ready.empty() || nRunning == 0; });
+            if (ready.empty()) {
+                cv.notify_all();
+                return;
+            }
+            const size_t i = *ready.begin();
+            ready.erase(ready.begin());
+            infos[i].status = Status::Running;
+            nRunning++;
+
+            lock.unlock();
+            const bool success = performTask(i);
+            lock.lock();
+
+            nRunning--;
+            infos[i].status = success ? Status::Succeeded : Status::Failed;
+            for (size_t d : infos[i].dependents) {
+                if (!success) {
+                    skip(d);
+                }
+                else if (--infos[d].nUnfinishedDependencies == 0 &&
+                         infos[d].status == Status::Waiting)
+                {
+                    ready.insert(d);
+                }
+            }
+            cv.notify_all();
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    const size_t nWorkers = std::min(static_cast<size_t>(std::max(nThreads, 1)), nTasks);
+    for (size_t i = 1; i < nWorkers; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+
+    // Tasks that are still waiting at this point are part of a dependency cycle
+    for (size_t i = 0; i < nTasks; ++i) {
+        if (infos[i].status == Status::Waiting) {
+            LERROR(fmt::format("Task {} is part of a dependency cycle", i + 1));
+            skip(i);
+        }
+    }
+
+    const auto count = [&infos](Status s) {
+        return std::count_if(
+            infos.begin(), infos.end(),
+            [s](const TaskInfo& info) { return info.status == s; }
+        );
+    };
+    const auto nSucceeded = count(Status::Succeeded);
+    const auto nFailed = count(Status::Failed);
+    const auto nSkipped = count(Status::Skipped);
+    reporter.report({
+        { "event", "done" }, { "succeeded", nSucceeded }, { "failed", nFailed },
+        { "skipped", nSkipped }, { "duration", seconds }
+    });
+
+    if (nFailed > 0 || nSkipped > 0) {
+        LWARNING(fmt::format(
+            "{} tasks succeeded, {} failed, {} were skipped",
+            nSucceeded, nFailed, nSkipped
+        ));
     }
     std::cout << "Done performing tasks." << std::endl;
 }
@@ -136,13 +394,35 @@ int main(int argc, char** argv) {
         )
     );
 
+    int nThreads = 1;
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommand<int>>(
+            nThreads,
+            "--threads",
+            "-j",
+            "The maximum number of tasks that are performed at the same time. Tasks are "
+            "only started once all tasks listed in their Dependencies have finished"
+        )
+    );
+
+    std::string progressPath = "";
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommand<std::string>>(
+            progressPath,
+            "--progress",
+            "-p",
+            "Provides the path to a file into which the start, progress, and duration "
+            "of every task is written as one JSON object per line"
+        )
+    );
+
     commandlineParser.setCommandLine({ argv, argv + argc });
     commandlineParser.execute();
 
     //FileSys.setCurrentDirectory(launchDirectory);
 
     if (tasksPath != "") {
-        performTasks(tasksPath);
+        performTasks(tasksPath, nThreads, progressPath);
         return 0;
     }
 
@@ -153,7 +433,7 @@ int main(int argc, char** argv) {
 
     std::cout << "TASK > ";
     while (std::cin >> tasksPath) {
-        performTasks(tasksPath);
+        performTasks(tasksPath, nThreads, progressPath);
         std::cout << "TASK > ";
     }
 
@@ -103,6 +103,26 @@ int main(int argc, char** argv) {
             )
     );
 
+    std::string upstream = "";
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommand<std::string>>(
+            upstream,
+            "--upstream",
+            "-u",
+            "Relays the session of the server at the provided address:port"
+            )
+    );
+
+    std::string upstreamPassword = "";
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommand<std::string>>(
+            upstreamPassword,
+            "--upstreampassword",
+            "-w",
+            "Sets the password used to connect to the upstream server"
+            )
+    );
+
     commandlineParser.setCommandLine(arguments);
     commandlineParser.execute();
 
@@ -132,6 +152,21 @@ int main(int argc, char** argv) {
     server.setDefaultHostAddress("127.0.0.1");
     LINFO(fmt::format("Server listening to port {}", port));
 
+    if (upstream != "") {
+        const size_t separator = upstream.rfind(':');
+        try {
+            const std::string address = upstream.substr(0, separator);
+            const int upstreamPort = (separator == std::string::npos) ?
+                25001 :
+                std::stoi(upstream.substr(separator + 1));
+            server.startRelay(address, upstreamPort, upstreamPassword, "Wormhole");
+            LINFO(fmt::format("Relaying session of {}:{}", address, upstreamPort));
+        }
+        catch (const std::exception& e) {
+            LERROR(fmt::format("Could not relay {}: {}", upstream, e.what()));
+        }
+    }
+
     while (std::cin.get() != 'q') {}
 
     server.stop();
@@ -282,6 +282,19 @@ struct Documentation {
 TestResult testSpecification(const Documentation& documentation,
     const ghoul::Dictionary& dictionary);
 
+/**
+ * This method tests whether a provided ghoul::Dictionary \p dictionary adheres to the
+ * list of DocumentationEntry%s \p entries. It behaves the same as the method above, but
+ * does not require a Documentation object to be constructed around the \p entries.
+ *
+ * \param entries The list of DocumentationEntry%s that the \p dictionary is tested
+ *        against
+ * \param dictionary The ghoul::Dictionary that is to be tested against the \p entries
+ * \return A TestResult that contains the results of the specification testing
+ */
+TestResult testSpecification(const Documentation::DocumentationEntries& entries,
+    const ghoul::Dictionary& dictionary);
+
 /**
 * This method tests whether a provided ghoul::Dictionary \p dictionary adheres to the
 * specification \p documentation. If the \p dictionary does not adhere to the
@@ -300,6 +313,52 @@ TestResult testSpecification(const Documentation& documentation,
 void testSpecificationAndThrow(const Documentation& documentation,
     const ghoul::Dictionary& dictionary, std::string component);
 
+/**
+ * Returns the Documentation that is created by the \p factory. The \p factory is only
+ * called the first time this function is called with it; later calls return the same
+ * cached object. This avoids rebuilding the verifiers of a Documentation for every
+ * dictionary that is tested against it.
+ *
+ * \param factory The function that creates the Documentation, usually a static
+ *        \c Documentation() function of a class
+ * \return A reference to the cached Documentation that stays valid for the lifetime of
+ *         the application
+ *
+ * \pre \p factory must not be nullptr
+ */
+const Documentation& cachedDocumentation(Documentation (*factory)());
+
+/**
+ * This method behaves the same as the testSpecificationAndThrow method above, but uses
+ * the cached Documentation that is created by the \p factory (see cachedDocumentation).
+ *
+ * \param factory The function that creates the Documentation
+ * \param dictionary The ghoul::Dictionary that is to be tested against the
+ *        Documentation
+ * \param component The component that is using this method; this argument is passed to
+ *        the SpecificationError that is thrown in case of not adhering to the
+ *        Documentation
+ *
+ * \throw SpecificationError If the \p dictionary does not adhere to the Documentation
+ * \pre \p factory must not be nullptr
+ */
+void testSpecificationAndThrow(Documentation (*factory)(),
+    const ghoul::Dictionary& dictionary, std::string component);
+
+/**
+ * While an object of this type is alive, the testSpecificationAndThrow methods return
+ * without testing on the thread that created it. This is used to skip the upfront
+ * validation of assets that were validated before in an unchanged state. The
+ * testSpecification method is not affected.
+ */
+struct SpecificationTestBypass {
+    SpecificationTestBypass();
+    ~SpecificationTestBypass();
+
+    SpecificationTestBypass(const SpecificationTestBypass&) = delete;
+    SpecificationTestBypass& operator=(const SpecificationTestBypass&) = delete;
+};
+
 } // namespace openspace::documentation
 
 // Make the overload for std::to_string available for the Offense::Reason for easier
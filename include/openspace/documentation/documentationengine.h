@@ -29,6 +29,7 @@
 
 #include <openspace/documentation/documentation.h>
 #include <ghoul/misc/exception.h>
+#include <unordered_map>
 
 namespace openspace::documentation {
 
@@ -85,6 +86,17 @@ public:
      */
     std::vector<Documentation> documentations() const;
 
+    /**
+     * Returns the registered Documentation with the provided \p identifier without
+     * copying the list of all Documentation%s.
+     *
+     * \param identifier The identifier of the Documentation that is requested
+     * \return The Documentation with the \p identifier or \c nullptr if no such
+     *         Documentation has been registered. The pointer is invalidated by the next
+     *         call to addDocumentation
+     */
+    const Documentation* documentation(const std::string& identifier) const;
+
     static void initialize();
     static void deinitialize();
     static bool isInitialized();
@@ -113,6 +125,8 @@ private:
 
     /// The list of all Documentation%s that are stored by the DocumentationEngine
     std::vector<Documentation> _documentations;
+    /// Maps the non-empty identifiers in _documentations to their index in that list
+    std::unordered_map<std::string, size_t> _documentationIndices;
     /// The list of templates to render the documentation with.
     std::vector<HandlebarTemplate> _handlebarTemplates;
 
@@ -78,6 +78,7 @@ struct Configuration {
 
     std::string onScreenTextScaling = "window";
     bool usePerSceneCache = false;
+    bool isSkippingValidatedAssetSpecifications = false;
 
     bool isRenderingOnMasterDisabled = false;
     glm::dvec3 globalRotation;
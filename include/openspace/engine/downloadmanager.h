@@ -26,19 +26,33 @@
 #define __OPENSPACE_CORE___DOWNLOADMANAGER___H__
 
 #include <ghoul/misc/boolean.h>
+#include <array>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace ghoul::filesystem { class File; }
 
 namespace openspace {
 
-// Multithreaded
+// All transfers are driven by a single thread through one curl multi handle, which
+// reuses connections, multiplexes requests over HTTP/2 where the server supports it, and
+// limits the number of concurrent transfers
 class DownloadManager {
 public:
+    /// Queued transfers with a higher priority are started first
+    enum class Priority {
+        Low = 0,
+        Normal,
+        High
+    };
+
     struct FileFuture {
         // Since the FileFuture object will be used from multiple threads, we have to be
         // careful about the access pattern, that is, no values should be read and written
@@ -89,6 +103,7 @@ public:
     }
 
     DownloadManager(UseMultipleThreads useMultipleThreads = UseMultipleThreads::Yes);
+    ~DownloadManager();
 
     //downloadFile
     // url - specifies the target of the download
@@ -98,23 +113,49 @@ public:
     // timeout_secs - timeout in seconds before giving up on download (0 = no timeout)
     // finishedCallback - callback when download finished (happens on different thread)
     // progressCallback - callback for status during (happens on different thread)
+    // priority - the order in which queued transfers are started
+    // Setting abortDownload on the returned future cancels the download, both while it
+    // is queued and while it is running
     std::shared_ptr<FileFuture> downloadFile(const std::string& url,
         const ghoul::filesystem::File& file,
         OverrideFile overrideFile = OverrideFile::Yes,
         FailOnError failOnError = FailOnError::No, unsigned int timeout_secs = 0,
         DownloadFinishedCallback finishedCallback = DownloadFinishedCallback(),
-        DownloadProgressCallback progressCallback = DownloadProgressCallback()
+        DownloadProgressCallback progressCallback = DownloadProgressCallback(),
+        Priority priority = Priority::Normal
     );
 
     std::future<MemoryFile> fetchFile(const std::string& url,
         SuccessCallback successCallback = SuccessCallback(),
-        ErrorCallback errorCallback = ErrorCallback());
+        ErrorCallback errorCallback = ErrorCallback(),
+        Priority priority = Priority::Normal);
 
     void getFileExtension(const std::string& url,
         RequestFinishedCallback finishedCallback = RequestFinishedCallback());
 
 private:
+    struct Transfer;
+
+    /// Queues the \p transfer, or performs it right away if no threads are used
+    void enqueue(std::unique_ptr<Transfer> transfer);
+
+    /// Removes the queued transfer with the highest priority, or returns \c nullptr
+    std::unique_ptr<Transfer> nextQueuedTransfer();
+
+    /// The loop of the transfer thread that drives all transfers
+    void transferLoop();
+
     bool _useMultithreadedDownload;
+
+    // The curl multi handle, which is kept as a void pointer so that this header does
+    // not depend on curl
+    void* _multiHandle = nullptr;
+    std::thread _transferThread;
+    std::mutex _queueMutex;
+    std::condition_variable _queueCondition;
+    /// The queued transfers, one queue per Priority
+    std::array<std::deque<std::unique_ptr<Transfer>>, 3> _queues;
+    bool _shouldStop = false;
 };
 
 } // namespace openspace
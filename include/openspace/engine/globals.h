@@ -36,15 +36,19 @@ namespace openspace {
 class Dashboard;
 class DeferredcasterManager;
 class DownloadManager;
+class FrameMemory;
 class LuaConsole;
+class MemoryBudget;
 class MissionManager;
 class ModuleEngine;
 class OpenSpaceEngine;
 class ParallelPeer;
 class RaycasterManager;
 class RenderEngine;
+class ResourceLoader;
 class ScreenSpaceRenderable;
 class SyncEngine;
+class TaskScheduler;
 class TimeManager;
 class VersionChecker;
 class VirtualPropertyManager;
@@ -72,15 +76,19 @@ ghoul::fontrendering::FontManager& gFontManager();
 Dashboard& gDashboard();
 DeferredcasterManager& gDeferredcasterManager();
 DownloadManager& gDownloadManager();
+FrameMemory& gFrameMemory();
 LuaConsole& gLuaConsole();
+MemoryBudget& gMemoryBudget();
 MissionManager& gMissionManager();
 ModuleEngine& gModuleEngine();
 OpenSpaceEngine& gOpenSpaceEngine();
 ParallelPeer& gParallelPeer();
 RaycasterManager& gRaycasterManager();
 RenderEngine& gRenderEngine();
+ResourceLoader& gResourceLoader();
 std::vector<std::unique_ptr<ScreenSpaceRenderable>>& gScreenspaceRenderables();
 SyncEngine& gSyncEngine();
+TaskScheduler& gTaskScheduler();
 TimeManager& gTimeManager();
 VersionChecker& gVersionChecker();
 VirtualPropertyManager& gVirtualPropertyManager();
@@ -103,16 +111,20 @@ static ghoul::fontrendering::FontManager& fontManager = detail::gFontManager();
 static Dashboard& dashboard = detail::gDashboard();
 static DeferredcasterManager& deferredcasterManager = detail::gDeferredcasterManager();
 static DownloadManager& downloadManager = detail::gDownloadManager();
+static FrameMemory& frameMemory = detail::gFrameMemory();
 static LuaConsole& luaConsole = detail::gLuaConsole();
+static MemoryBudget& memoryBudget = detail::gMemoryBudget();
 static MissionManager& missionManager = detail::gMissionManager();
 static ModuleEngine& moduleEngine = detail::gModuleEngine();
 static OpenSpaceEngine& openSpaceEngine = detail::gOpenSpaceEngine();
 static ParallelPeer& parallelPeer = detail::gParallelPeer();
 static RaycasterManager& raycasterManager = detail::gRaycasterManager();
 static RenderEngine& renderEngine = detail::gRenderEngine();
+static ResourceLoader& resourceLoader = detail::gResourceLoader();
 static std::vector<std::unique_ptr<ScreenSpaceRenderable>>& screenSpaceRenderables =
     detail::gScreenspaceRenderables();
 static SyncEngine& syncEngine = detail::gSyncEngine();
+static TaskScheduler& taskScheduler = detail::gTaskScheduler();
 static TimeManager& timeManager = detail::gTimeManager();
 static VersionChecker& versionChecker = detail::gVersionChecker();
 static VirtualPropertyManager& virtualPropertyManager = detail::gVirtualPropertyManager();
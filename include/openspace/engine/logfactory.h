@@ -43,7 +43,9 @@ namespace documentation { struct Documentation; }
  * require the <code>FileName</code> value for the location at which the logfile should be
  * created . Both logs can be customized using the <code>Append</code>,
  * <code>TimeStamping</code>, <code>DateStamping</code>, <code>CategoryStamping</code>,
- * and <code>LogLevelStamping</code> values.
+ * and <code>LogLevelStamping</code> values. If the <code>Asynchronous</code> value is
+ * \c true, the created Log is wrapped in an AsyncLog that writes the messages on a
+ * background thread.
  *
  * \param  dictionary The dictionary from which the ghoul::logging::Log should be created
  * \return The created ghoul::logging::Log
@@ -51,6 +53,7 @@ namespace documentation { struct Documentation; }
  * \throw  ghoul::RuntimeError If there was an error creating the ghoul::logging::Log
  * \sa     ghoul::logging::TextLog
  * \sa     ghoul::logging::HTMLLog
+ * \sa     AsyncLog
  */
 std::unique_ptr<ghoul::logging::Log> createLog(const ghoul::Dictionary& dictionary);
 
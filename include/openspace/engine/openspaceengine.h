@@ -30,7 +30,10 @@
 #include <openspace/util/mouse.h>
 #include <openspace/util/versionchecker.h>
 #include <ghoul/glm.h>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -39,6 +42,7 @@ namespace openspace {
 class AssetManager;
 class LoadingScreen;
 class Scene;
+class SceneInitializer;
 
 namespace scripting { struct LuaLibrary; }
 
@@ -82,7 +86,7 @@ public:
     void mouseScrollWheelCallback(double posX, double posY);
     void externalControlCallback(const char* receivedChars, int size, int clientId);
     std::vector<char> encode();
-    void decode(std::vector<char> data);
+    void decode(const std::vector<char>& data);
 
     void scheduleLoadSingleAsset(std::string assetPath);
     void toggleShutdownMode();
@@ -101,12 +105,47 @@ public:
     static scripting::LuaLibrary luaLibrary();
 
 private:
+    /**
+     * Records the time spent in the enclosing scope as one phase of the startup report,
+     * which is logged once the initial asset has been loaded. Phases that run in the
+     * background can overlap with the phases on the main thread.
+     */
+    class StartupPhase {
+    public:
+        StartupPhase(OpenSpaceEngine& engine, std::string name,
+            bool isBackground = false);
+        ~StartupPhase();
+
+    private:
+        OpenSpaceEngine& _engine;
+        std::string _name;
+        bool _isBackground;
+        std::chrono::steady_clock::time_point _begin;
+    };
+
     void loadSingleAsset(const std::string& assetPath);
     void loadFonts();
 
     void runGlobalCustomizationScripts();
     void configureLogging();
 
+    /// Generates the documentation of all scripts, factories, and static classes
+    void createStaticDocumentation();
+
+    /// Waits until the documentation that is generated in the background has finished
+    void waitForDocumentation();
+
+    /// Logs the duration of all startup phases that were recorded since the last report
+    void logStartupReport();
+
+    /**
+     * Writes the snapshot of the scene that was just loaded to \p path, containing the
+     * fingerprints of all loaded assets and the initialization times measured by
+     * \p initializer.
+     */
+    void writeSceneSnapshot(const std::string& path,
+        const SceneInitializer& initializer) const;
+
     std::unique_ptr<Scene> _scene;
     std::unique_ptr<AssetManager> _assetManager;
     std::unique_ptr<LoadingScreen> _loadingScreen;
@@ -117,12 +156,29 @@ private:
 
     //grabs json from each module to pass to the documentation engine.
     std::string _documentationJson;
+    /// The generation or writing of the documentation that runs in the background
+    std::future<void> _documentationTask;
+
+    struct StartupPhaseTiming {
+        std::string name;
+        /// The seconds between the start of the initialization and the phase
+        double begin;
+        double duration;
+        bool isBackground;
+    };
+    std::chrono::steady_clock::time_point _startupTime;
+    std::mutex _startupPhasesMutex;
+    std::vector<StartupPhaseTiming> _startupPhases;
 
     ShutdownInformation _shutdown;
 
     // The first frame might take some more time in the update loop, so we need to know to
     // disable the synchronization; otherwise a hardware sync will kill us after 1 minute
     bool _isFirstRenderingFirstFrame = true;
+
+    // The delta time that the transformation prefetch for the next frame was based on,
+    // or 0 if nothing was prefetched
+    double _prefetchDeltaTime = 0.0;
 };
 
 } // namespace openspace
@@ -51,7 +51,10 @@ public:
 
     /**
      * Encodes all added Syncables in the injected <code>SyncBuffer</code>.
-     * This method is only called on the SGCT master node
+     * Syncables whose encoding did not change since the previous frame are only sent
+     * as a marker, as the slaves keep the last received encoding of each Syncable.
+     * Large frames are LZ4 compressed. This method is only called on the SGCT master
+     * node
      */
     std::vector<char> encodeSyncables();
 
@@ -59,7 +62,19 @@ public:
      * Decodes the <code>SyncBuffer</code> into the added Syncables.
      * This method is only called on the SGCT slave nodes
      */
-    void decodeSyncables(std::vector<char> data);
+    void decodeSyncables(const std::vector<char>& data);
+
+    /**
+     * Returns the number of bytes that each of the added Syncables encoded in the last
+     * frame that was sent or received, in the order in which they were added
+     */
+    std::vector<size_t> encodedSizes() const;
+
+    /**
+     * Returns the number of bytes of the last frame that was sent or received, after its
+     * compression
+     */
+    size_t frameSize() const;
 
     /**
      * Invokes the presync method of all added Syncables
@@ -103,6 +118,31 @@ private:
      * Databuffer used in encoding/decoding
      */
     SyncBuffer _syncBuffer;
+
+    /**
+     * The encoding of each Syncable in the last frame that was sent (on the master)
+     * or received (on the slaves). As SGCT delivers every frame to every slave before
+     * the next frame starts, the previous frame is known to both sides and every
+     * Syncable that did not change can be sent as a marker only
+     */
+    std::vector<std::vector<char>> _previousFrame;
+
+    /**
+     * If this is \c true, the next frame is encoded completely and the slaves drop
+     * their previous frame. This is the case for the first frame and whenever the
+     * list of Syncables changes
+     */
+    bool _needsKeyframe = true;
+
+    /**
+     * Buffer reused for the uncompressed frame on the slaves
+     */
+    std::vector<char> _decompressionBuffer;
+
+    /**
+     * The size of the last frame that was sent or received in bytes
+     */
+    size_t _frameSize = 0;
 };
 
 } // namespace openspace
@@ -105,6 +105,8 @@ struct WindowDelegate {
 
     bool (*isFisheyeRendering)() = []() { return false; };
 
+    bool (*isRightEyeOfSingleViewport)() = []() { return false; };
+
     void (*takeScreenshot)(bool applyWarping) = [](bool) { };
 
     void (*swapBuffer)() = []() {};
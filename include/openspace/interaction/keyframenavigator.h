@@ -77,10 +77,21 @@ public:
     double currentTime() const;
     void setTimeReferenceMode(KeyframeTimeRef refType, double referenceTimestamp);
 
+    /**
+     * Sets for how many seconds past the last keyframe the camera motion between the
+     * last two keyframes is extrapolated, if no newer keyframe has arrived yet. A value
+     * of 0 disables the extrapolation and the camera stops at the last keyframe.
+     */
+    void setMaximumExtrapolationTime(double seconds);
+
 private:
+    void extrapolateCamera(Camera& camera, const Keyframe<CameraPose>& prevKeyframe,
+        const Keyframe<CameraPose>& lastKeyframe, double now) const;
+
     Timeline<CameraPose> _cameraPoseTimeline;
     KeyframeTimeRef _timeframeMode = KeyframeTimeRef::Relative_applicationStart;
     double _referenceTimestamp = 0.0;
+    double _maximumExtrapolationTime = 0.0;
 };
 
 } // namespace openspace::interaction
@@ -30,8 +30,11 @@
 #include <openspace/interaction/joystickcamerastates.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/util/mouse.h>
 #include <openspace/util/keys.h>
+#include <ghoul/glm.h>
+#include <glm/gtx/quaternion.hpp>
 
 namespace openspace {
     class Camera;
@@ -112,6 +115,19 @@ public:
     static scripting::LuaLibrary luaLibrary();
 
 private:
+    /**
+     * Moves the camera back to the pose that the navigation computed in the previous
+     * frame, if the camera was moved to a predicted pose by #predictCamera.
+     */
+    void restorePredictedCamera();
+
+    /**
+     * Moves the camera ahead along its current motion to where it is expected to be
+     * when the frame is displayed. As the camera is synchronized afterwards, all nodes
+     * of a cluster render the predicted pose.
+     */
+    void predictCamera(double deltaTime);
+
     bool _cameraUpdatedFromScript = false;
     bool _playbackModeEnabled = false;
 
@@ -123,6 +139,23 @@ private:
     std::unique_ptr<KeyframeNavigator> _keyframeNavigator;
 
     properties::BoolProperty _useKeyFrameInteraction;
+    properties::BoolProperty _predictCameraMotion;
+    properties::FloatProperty _predictionFrames;
+
+    struct {
+        /// Whether the values below belong to the previous frame
+        bool hasPreviousFrame = false;
+        /// Whether the camera is currently at the predicted pose
+        bool isApplied = false;
+        const SceneGraphNode* anchor = nullptr;
+        glm::dvec3 anchorPosition = glm::dvec3(0.0);
+        /// The pose as computed by the navigation, without prediction
+        glm::dvec3 position = glm::dvec3(0.0);
+        glm::dquat rotation = glm::dquat(1.0, 0.0, 0.0, 0.0);
+        /// The pose that was set on the camera
+        glm::dvec3 predictedPosition = glm::dvec3(0.0);
+        glm::dquat predictedRotation = glm::dquat(1.0, 0.0, 0.0, 0.0);
+    } _prediction;
 };
 
 } // namespace openspace::interaction
@@ -35,13 +35,13 @@
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/util/updatestructures.h>
 #include <ghoul/glm.h>
 #include <glm/gtx/quaternion.hpp>
 
 namespace openspace {
     class SceneGraphNode;
     class Camera;
-    struct SurfacePositionHandle;
 } // namespace
 
 namespace openspace::interaction {
@@ -159,6 +159,28 @@ private:
     Interpolator<double> _cameraToSurfaceDistanceInterpolator;
     Interpolator<double> _followRotationInterpolator;
 
+    /// The pose that the camera was set to by the last update
+    CameraPose _lastPose;
+    /// Whether nothing but the input and the nodes can change the result of an update
+    bool _hasLastPose = false;
+
+    struct SurfaceCache {
+        const SceneGraphNode* node = nullptr;
+        glm::dvec3 positionModelSpace = glm::dvec3(0.0);
+        SurfacePositionHandle handle;
+        /// The number of updates since the handle was calculated
+        int age = 0;
+    };
+    SurfaceCache _surfaceCache;
+
+    /**
+     * Returns \c true if an update would leave the camera where it is, because the
+     * camera, the anchor and aim nodes, and the input are all at rest and no
+     * interpolation is running. The surface under the camera is checked as well, so
+     * that the camera is still pushed out if newly loaded height data rises above it.
+     */
+    bool isCameraAtRest();
+
     /**
      * Decomposes the camera's rotation in to a global and a local rotation defined by
      * CameraRotationDecomposition. The global rotation defines the rotation so that the
@@ -287,10 +309,16 @@ private:
         const glm::dvec3& centerPos, const SurfacePositionHandle& posHandle);
 
     /**
-     * Calculates a SurfacePositionHandle given a camera position in world space.
+     * Calculates a SurfacePositionHandle given a camera position in world space. The
+     * last handle is reused for the same position, as the surface of a globe involves
+     * sampling its height layers.
      */
     SurfacePositionHandle calculateSurfacePositionHandle(const SceneGraphNode& node,
         const glm::dvec3 cameraPositionWorldSpace);
+
+    /// Same as calculateSurfacePositionHandle but with a position in model space
+    SurfacePositionHandle surfacePositionHandleModelSpace(const SceneGraphNode& node,
+        const glm::dvec3& cameraPositionModelSpace);
 };
 
 } // namespace openspace::interaction
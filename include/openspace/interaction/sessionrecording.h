@@ -27,9 +27,13 @@
 
 #include <openspace/interaction/externinteraction.h>
 #include <openspace/interaction/keyframenavigator.h>
+#include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/scripting/lualibrary.h>
+#include <memory>
 #include <vector>
 
+namespace openspace { class AsyncFileWriter; }
+
 namespace openspace::interaction {
 
 class SessionRecording : public properties::PropertyOwner {
@@ -129,6 +133,19 @@ public:
      */
     void stopPlayback();
 
+    /**
+     * Moves a playback in progress to the provided time, in seconds since the start of
+     * the recording. This requires a binary recording that has an index and a playback
+     * whose keyframe times are relative to the start of the recording. The entries
+     * before the new time are skipped and the simulation time is set to that of the
+     * first camera keyframe that is played back.
+     *
+     * \param recordedTime The time in seconds since the start of the recording
+     *
+     * \return \c true if the playback was moved to the new time
+     */
+    bool seekPlayback(double recordedTime);
+
     /**
      * Enables that rendered frames should be saved during playback
      * \param fps Number of frames per second.
@@ -140,6 +157,14 @@ public:
      */
     void disableTakeScreenShotDuringPlayback();
 
+    /**
+     * Advances the playback by exactly 1 / \p fps seconds with every rendered frame, the
+     * same way as while saving frames, but without taking any screenshots. This makes
+     * the played back frames independent of how long each of them takes to render,
+     * which is used to measure the frame times of a recorded session.
+     */
+    void enableFixedFramePaceDuringPlayback(int fps);
+
     /**
      * Used to check if a session playback is in progress.
      * \returns true if playback is in progress.
@@ -220,6 +245,14 @@ private:
         unsigned int idxIntoKeyframeTypeArray;
         double timestamp;
     };
+    /// A consecutive range of entries in a binary recording, as stored in its index
+    struct RecordedChunk {
+        double timeOs;
+        double timeRec;
+        double timeSim;
+        uint64_t filePosition;
+        uint32_t nEntries;
+    };
     ExternInteraction _externInteract;
     bool _isRecording = false;
     double _timestampRecordStarted = 0.0;
@@ -235,6 +268,13 @@ private:
     void playbackTimeChange();
     void playbackScript();
     bool playbackAddEntriesToTimeline();
+    bool playbackAddBinaryEntryToTimeline(unsigned char frameType);
+    bool playbackAddChunksToTimeline(double currTime);
+    bool playbackAddNextChunkToTimeline();
+    bool readPlaybackIndex();
+    bool isPlaybackFullyLoaded() const;
+    void addEntryToRecordIndex(double timeOs, double timeRec, double timeSim);
+    void saveRecordIndexToFile();
     void signalPlaybackFinishedForComponent(RecordedType type);
     void writeToFileBuffer(double src);
     void writeToFileBuffer(std::vector<char>& cvec);
@@ -267,6 +307,7 @@ private:
     double getNextTimestamp();
     double getPrevTimestamp();
     void cleanUpPlayback();
+    void clearPlaybackTimeline();
 
     RecordedDataMode _recordingDataMode = RecordedDataMode::Binary;
     SessionState _state = SessionState::Idle;
@@ -274,7 +315,7 @@ private:
     std::string _playbackFilename;
     std::ifstream _playbackFile;
     std::string _playbackLineParsing;
-    std::ofstream _recordFile;
+    std::unique_ptr<AsyncFileWriter> _recordFile;
     int _playbackLineNum = 1;
     KeyframeTimeRef _playbackTimeReferenceMode;
     datamessagestructures::CameraKeyframe _prevRecordedCameraKeyframe;
@@ -285,6 +326,7 @@ private:
     bool _setSimulationTimeWithNextCameraKeyframe = false;
 
     bool _saveRenderingDuringPlayback = false;
+    bool _saveRenderingTakesScreenshots = true;
     double _saveRenderingDeltaTime = 1.0 / 30.0;
     double _saveRenderingCurrentRecordedTime;
 
@@ -304,6 +346,12 @@ private:
     std::vector<std::string> _keyframesScript;
     std::vector<timelineEntry> _timeline;
 
+    // The index of a binary recording. While recording, this collects the chunks that
+    // are written to the end of the file. During playback of a file that has an index,
+    // the chunks are read as the playback advances, rather than all up front
+    std::vector<RecordedChunk> _chunks;
+    size_t _idxChunkNext = 0;
+
     unsigned int _idxTimeline_nonCamera = 0;
     unsigned int _idxTime = 0;
     unsigned int _idxScript = 0;
@@ -315,6 +363,8 @@ private:
     double _cameraFirstInTimeline_timestamp = 0;
 
     int _nextCallbackHandle = 0;
+
+    properties::BoolProperty _compressRecordings;
 };
 
 } // namespace openspace
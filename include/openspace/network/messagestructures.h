@@ -26,6 +26,8 @@
 #define __OPENSPACE_CORE___MESSAGESTRUCTURES___H__
 
 #include <ghoul/glm.h>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -36,7 +38,8 @@ namespace openspace::datamessagestructures {
 enum class Type : uint32_t {
     CameraData = 0,
     TimelineData,
-    ScriptData
+    ScriptData,
+    CompactCameraData
 };
 
 struct CameraKeyframe {
@@ -235,6 +238,146 @@ struct CameraKeyframe {
     };
 };
 
+/**
+ * Encodes the unit quaternion \p q with the smallest-three method into 64 bits. The
+ * largest component is dropped and reconstructed from the unit length, its index is
+ * stored in the two most significant bits, and the remaining three components, which
+ * lie in [-1/sqrt(2), 1/sqrt(2)], are quantized to 20 bits each.
+ */
+inline uint64_t encodeRotation(glm::dquat q) {
+    constexpr const double Range = 0.70710678118654752440;
+    constexpr const double Steps = static_cast<double>((1 << 20) - 1);
+
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (std::abs(q[i]) > std::abs(q[largest])) {
+            largest = i;
+        }
+    }
+    // q and -q represent the same rotation, so we can make the dropped component positive
+    if (q[largest] < 0.0) {
+        q = -q;
+    }
+
+    uint64_t result = static_cast<uint64_t>(largest) << 60;
+    int shift = 40;
+    for (int i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        const double v = glm::clamp(q[i] / Range * 0.5 + 0.5, 0.0, 1.0);
+        result |= static_cast<uint64_t>(std::round(v * Steps)) << shift;
+        shift -= 20;
+    }
+    return result;
+}
+
+/**
+ * Decodes a quaternion that was encoded with #encodeRotation.
+ */
+inline glm::dquat decodeRotation(uint64_t value) {
+    constexpr const double Range = 0.70710678118654752440;
+    constexpr const double Steps = static_cast<double>((1 << 20) - 1);
+
+    const int largest = static_cast<int>(value >> 60);
+    glm::dquat q;
+    double sumSquared = 0.0;
+    int shift = 40;
+    for (int i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        const double v = static_cast<double>((value >> shift) & ((1 << 20) - 1)) / Steps;
+        q[i] = (v - 0.5) * 2.0 * Range;
+        sumSquared += q[i] * q[i];
+        shift -= 20;
+    }
+    q[largest] = std::sqrt(std::max(0.0, 1.0 - sumSquared));
+    return q;
+}
+
+/**
+ * A quantized CameraKeyframe that is sent relative to the most recent full
+ * CameraKeyframe, the reference. The position is an offset to the reference position
+ * in single precision, the rotation uses the smallest-three encoding, and the timestamp
+ * is an offset to the reference timestamp. The focus node is always the one of the
+ * reference. This takes 29 bytes compared to the 80+ bytes of a full keyframe.
+ */
+struct CompactCameraKeyframe {
+    CompactCameraKeyframe() {}
+    CompactCameraKeyframe(const std::vector<char> &buffer) {
+        deserialize(buffer);
+    }
+
+    CompactCameraKeyframe(const CameraKeyframe& kf, const CameraKeyframe& reference)
+        : _positionOffset(kf._position - reference._position)
+        , _rotation(encodeRotation(kf._rotation))
+        , _followNodeRotation(kf._followNodeRotation)
+        , _scale(kf._scale)
+        , _timestampOffset(static_cast<float>(kf._timestamp - reference._timestamp))
+    {}
+
+    glm::vec3 _positionOffset;
+    uint64_t _rotation;
+    bool _followNodeRotation;
+    float _scale;
+    float _timestampOffset;
+
+    CameraKeyframe toKeyframe(const CameraKeyframe& reference) const {
+        CameraKeyframe kf;
+        kf._position = reference._position + glm::dvec3(_positionOffset);
+        kf._rotation = decodeRotation(_rotation);
+        kf._followNodeRotation = _followNodeRotation;
+        kf._focusNode = reference._focusNode;
+        kf._scale = _scale;
+        kf._timestamp = reference._timestamp + static_cast<double>(_timestampOffset);
+        return kf;
+    }
+
+    void serialize(std::vector<char> &buffer) const {
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_positionOffset),
+            reinterpret_cast<const char*>(&_positionOffset) + sizeof(_positionOffset)
+        );
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_rotation),
+            reinterpret_cast<const char*>(&_rotation) + sizeof(_rotation)
+        );
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_followNodeRotation),
+            reinterpret_cast<const char*>(&_followNodeRotation) +
+                sizeof(_followNodeRotation)
+        );
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_scale),
+            reinterpret_cast<const char*>(&_scale) + sizeof(_scale)
+        );
+        buffer.insert(
+            buffer.end(),
+            reinterpret_cast<const char*>(&_timestampOffset),
+            reinterpret_cast<const char*>(&_timestampOffset) + sizeof(_timestampOffset)
+        );
+    };
+
+    size_t deserialize(const std::vector<char> &buffer, size_t offset = 0) {
+        memcpy(&_positionOffset, buffer.data() + offset, sizeof(_positionOffset));
+        offset += sizeof(_positionOffset);
+        memcpy(&_rotation, buffer.data() + offset, sizeof(_rotation));
+        offset += sizeof(_rotation);
+        memcpy(&_followNodeRotation, buffer.data() + offset, sizeof(_followNodeRotation));
+        offset += sizeof(_followNodeRotation);
+        memcpy(&_scale, buffer.data() + offset, sizeof(_scale));
+        offset += sizeof(_scale);
+        memcpy(&_timestampOffset, buffer.data() + offset, sizeof(_timestampOffset));
+        offset += sizeof(_timestampOffset);
+        return offset;
+    };
+};
+
 struct TimeKeyframe {
     TimeKeyframe() {}
     TimeKeyframe(const std::vector<char> &buffer) {
@@ -79,6 +79,19 @@ public:
     bool isConnectedOrConnecting() const;
     void sendDataMessage(const ParallelConnection::DataMessage& dataMessage);
     bool sendMessage(const ParallelConnection::Message& message);
+
+    /**
+     * Converts the \p message into the bytes that are sent over the socket, including
+     * the header. This can be used to serialize a message once and send it to many
+     * connections using #sendSerializedMessage
+     */
+    static std::vector<char> serializeMessage(const ParallelConnection::Message& message);
+
+    /**
+     * Sends a message that was created by #serializeMessage
+     */
+    bool sendSerializedMessage(const std::vector<char>& serializedMessage);
+
     void disconnect();
     ghoul::io::TcpSocket* socket();
 
@@ -90,6 +90,7 @@ private:
 
     void sendCameraKeyframe();
     void sendTimeTimeline();
+    void cameraKeyframeReceived(const datamessagestructures::CameraKeyframe& kf);
 
     void setStatus(ParallelConnection::Status status);
     void setHostName(const std::string& hostName);
@@ -113,6 +114,18 @@ private:
     double _lastTimeKeyframeTimestamp = 0.0;
     double _lastCameraKeyframeTimestamp = 0.0;
 
+    // The last full camera keyframe that was sent as host. Compact camera keyframes are
+    // encoded relative to this one
+    datamessagestructures::CameraKeyframe _cameraReference;
+    bool _hasCameraReference = false;
+    int _nCompactCameraKeyframes = 0;
+    ParallelConnection::Status _cameraReferenceStatus =
+        ParallelConnection::Status::Disconnected;
+
+    // The last full camera keyframe that was received as client
+    datamessagestructures::CameraKeyframe _receivedCameraReference;
+    bool _hasReceivedCameraReference = false;
+
     std::atomic_bool _shouldDisconnect = false;
 
     std::atomic<size_t> _nConnections = 0;
@@ -30,6 +30,9 @@
 #include <openspace/util/concurrentqueue.h>
 #include <ghoul/io/socket/tcpsocketserver.h>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -44,20 +47,45 @@ public:
 
     std::string defaultHostAddress() const;
 
+    /**
+     * Turns this server into a relay of the server at \p address and \p port, which is
+     * joined as a client with the \p password using the \p name. The data of the
+     * upstream host is re-broadcast to the peers of this server, so that all peers at
+     * one site share a single upstream connection. The peers of a relay cannot become
+     * the host themselves. Must be called after #start.
+     */
+    void startRelay(const std::string& address, int port, const std::string& password,
+        const std::string& name);
+
     void stop();
 
     size_t nConnections() const;
 
 private:
-    struct Peer {
-        //Peer(size_t id_, std::string name_, ParallelConnection parallelConnection_,
-            //ParallelConnection::Status status_, std::thread )
+    /// A serialized message that is waiting to be sent to a peer
+    struct OutgoingMessage {
+        std::shared_ptr<const std::vector<char>> serialized;
+        /// The data message type of the content, or -1 if it is not a data message
+        int64_t dataType = -1;
+        /// If \c true, the message replaces all queued data messages of the same type
+        bool isSuperseding = false;
+    };
 
+    struct Peer {
         size_t id;
         std::string name;
         ParallelConnection parallelConnection;
         ParallelConnection::Status status;
         std::thread thread;
+
+        /// The messages that the sendThread has not sent yet, so that a slow peer does
+        /// not hold back the other peers
+        std::deque<OutgoingMessage> outgoing;
+        size_t nOutgoingBytes = 0;
+        bool isSending = true;
+        std::mutex outgoingMutex;
+        std::condition_variable outgoingCondition;
+        std::thread sendThread;
     };
 
     struct PeerMessage {
@@ -66,6 +94,17 @@ private:
     };
 
     bool isConnected(const Peer& peer) const;
+    bool hasHost() const;
+
+    /**
+     * Adds the \p message to the outgoing queue of the \p peer, dropping the queued
+     * keyframes that it supersedes. A peer whose queue grows beyond the limit is
+     * disconnected.
+     */
+    void enqueueMessage(Peer& peer, OutgoingMessage message);
+    static OutgoingMessage createOutgoingMessage(
+        ParallelConnection::MessageType messageType, const std::vector<char>& message);
+    void sendQueuedMessages(Peer& peer);
 
     void sendMessage(Peer& peer, ParallelConnection::MessageType messageType,
         const std::vector<char>& message);
@@ -89,6 +128,10 @@ private:
     void handleHostshipResignation(Peer& peer);
     void handleDisconnection(std::shared_ptr<Peer> peer);
 
+    void handleUpstreamMessage(ParallelConnection::Message message);
+    void handleUpstreamConnectionStatus(std::vector<char> message);
+    void handleUpstream();
+
     void handleNewPeers();
     void eventLoop();
     std::shared_ptr<Peer> peer(size_t id);
@@ -114,6 +157,13 @@ private:
     std::string _defaultHostAddress;
 
     ConcurrentQueue<PeerMessage> _incomingMessages;
+
+    // Upstream server of a relay
+    std::atomic_bool _isRelay = false;
+    std::unique_ptr<ParallelConnection> _upstream;
+    std::thread _upstreamThread;
+    std::atomic_bool _upstreamHasHost = false;
+    std::atomic_size_t _upstreamNConnections = 0;
 };
 
 } // namespace openspace
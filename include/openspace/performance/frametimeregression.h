@@ -0,0 +1,84 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___FRAMETIMEREGRESSION___H__
+#define __OPENSPACE_CORE___FRAMETIMEREGRESSION___H__
+
+#include <string>
+
+namespace openspace::performance {
+
+/**
+ * Measures the frame times of a session recording to catch rendering performance
+ * regressions. The recording is played back at a fixed frame pace, so that every run
+ * renders the same frames regardless of how fast they are, while the
+ * PerformanceManager records the CPU time of every phase of each frame and the GPU time
+ * of the rendering. After the playback has finished, the mean, the 50th, 90th, 95th,
+ * and 99th percentiles, and the maximum of each phase are written as JSON to the output
+ * file.
+ *
+ * Optionally, the statistics are compared against a threshold file, which is a JSON
+ * object that maps the name of a phase to an object of statistics and their maximum
+ * value in milliseconds, for example <code>{ "Frame": { "p95": 16.7 } }</code>. The
+ * result of the comparison is logged and stored in the <code>passed</code> and
+ * <code>failures</code> entries of the output file.
+ */
+class FrameTimeRegression {
+public:
+    struct Settings {
+        /// The session recording that is played back
+        std::string recording;
+        /// The number of frames per second at which the recording is played back
+        int fps = 60;
+        /// The path of the JSON file to which the statistics are written
+        std::string outputPath;
+        /// The path of an optional threshold file
+        std::string thresholdPath;
+        /// If \c true, the application is terminated once the results are written
+        bool quitWhenDone = false;
+    };
+
+    /**
+     * Starts the playback of the recording and the frame time recording.
+     *
+     * \return \c true if the playback was started
+     */
+    bool start(Settings settings);
+
+    /// Finishes the measurement once the playback has ended. Called once per frame
+    void update();
+
+    bool isRunning() const;
+
+private:
+    /// Writes the statistics and compares them to the thresholds, if there are any
+    void finish();
+
+    Settings _settings;
+    bool _isRunning = false;
+};
+
+} // namespace openspace::performance
+
+#endif // __OPENSPACE_CORE___FRAMETIMEREGRESSION___H__
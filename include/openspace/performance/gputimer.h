@@ -0,0 +1,80 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___GPUTIMER___H__
+#define __OPENSPACE_CORE___GPUTIMER___H__
+
+#include <ghoul/opengl/ghoul_gl.h>
+#include <array>
+
+namespace openspace::performance {
+
+/**
+ * Measures the GPU time of a sequence of OpenGL commands without stalling the pipeline.
+ * Each measurement is recorded into one of a small ring of \c GL_TIME_ELAPSED queries and
+ * the results are only read back once the GPU has made them available, which is usually
+ * a few frames later. Elapsed time queries cannot be nested, so only one GpuTimer may be
+ * active at a time.
+ */
+class GpuTimer {
+public:
+    /// The number of queries in the ring, which is the maximum latency in measurements
+    static constexpr const int NQueries = 4;
+
+    /**
+     * Starts a new measurement. If all queries in the ring are still waiting for their
+     * results, the measurement is skipped rather than waiting for the GPU. The queries
+     * are created the first time this function is called.
+     */
+    void begin();
+
+    /// Ends the measurement that was started with #begin
+    void end();
+
+    /**
+     * Collects all results that have become available and returns the most recent one in
+     * nanoseconds, or 0 if no measurement has finished yet. This function never blocks.
+     */
+    long long latestResult();
+
+    /// Returns the number of measurements whose results have been collected so far
+    unsigned long long nResults() const;
+
+    /// Deletes the queries. Has to be called while the OpenGL context is still current
+    void deinitialize();
+
+private:
+    std::array<GLuint, NQueries> _queries = {};
+    std::array<bool, NQueries> _isPending = {};
+    /// The index of the query used by the next measurement, which is also the oldest
+    int _current = 0;
+    bool _isActive = false;
+    bool _isInitialized = false;
+    long long _latestResult = 0;
+    unsigned long long _nResults = 0;
+};
+
+} // namespace openspace::performance
+
+#endif // __OPENSPACE_CORE___GPUTIMER___H__
@@ -30,7 +30,7 @@
 namespace openspace::performance {
 
 struct PerformanceLayout {
-    constexpr static const int8_t Version = 0;
+    constexpr static const int8_t Version = 1;
     constexpr static const int LengthName = 256;
     constexpr static const int NumberValues = 256;
     constexpr static const int MaxValues = 1024;
@@ -40,6 +40,7 @@ struct PerformanceLayout {
     struct SceneGraphPerformanceLayout {
         char name[LengthName];
         float renderTime[NumberValues];
+        float renderTimeGpu[NumberValues];
         float updateRenderable[NumberValues];
         float updateTranslation[NumberValues];
         float updateRotation[NumberValues];
@@ -25,9 +25,14 @@
 #ifndef __OPENSPACE_CORE___PERFORMANCEMANAGER___H__
 #define __OPENSPACE_CORE___PERFORMANCEMANAGER___H__
 
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace ghoul { class SharedMemory; }
@@ -39,6 +44,25 @@ struct PerformanceLayout;
 
 class PerformanceManager {
 public:
+    struct FrameZone {
+        const char* name;
+        /// The time in milliseconds between the beginning of the frame and the zone
+        double begin;
+        /// The time in milliseconds that was spent in the zone
+        double duration;
+    };
+
+    struct FrameSummary {
+        /// The duration of the entire frame in milliseconds
+        double duration = 0.0;
+        /// The zones of the frame in the order in which they ended, so nested zones
+        /// precede the zone that contains them
+        std::vector<FrameZone> zones;
+    };
+
+    PerformanceManager();
+    ~PerformanceManager();
+
     static void CreateGlobalSharedMemory();
     static void DestroyGlobalSharedMemory();
 
@@ -71,9 +95,110 @@ public:
 
     PerformanceLayout* performanceData();
 
+    /**
+     * Sets whether the PerformanceMeasurement%s synchronize with the GPU by calling
+     * \c glFinish before and after the measured block. Without the synchronization, the
+     * measured times only contain the CPU time, but the measurements no longer stall the
+     * rendering pipeline. The synchronization is enabled by default.
+     */
+    void setGpuSynchronization(bool enabled);
+    bool isGpuSynchronizationEnabled() const;
+
+    /**
+     * Starts recording the TraceZone%s of all threads, discarding the events of a
+     * previous trace. Each thread records into its own buffer without taking a lock.
+     */
+    void startTracing();
+
+    /// Stops recording TraceZone%s. The recorded events remain until the next trace
+    void stopTracing();
+
+    bool isTracing() const;
+
+    /**
+     * Records an event into the trace buffer of the calling thread. If the buffer is
+     * full, the event is dropped. This function is called by the TraceZone.
+     */
+    void storeTraceEvent(const char* name, std::chrono::steady_clock::time_point begin,
+        std::chrono::steady_clock::time_point end);
+
+    /**
+     * Writes the events of the current trace to \p path in the Chrome trace event format,
+     * which can be opened in chrome://tracing, Perfetto, or Tracy's importer. The
+     * timestamps are wall-clock microseconds, so that the traces of several cluster
+     * nodes with synchronized clocks can be merged.
+     *
+     * \param path The path of the JSON file that is written
+     * \param processId The process id under which the events are shown
+     * \param processName The name that is shown for \p processId
+     * \return \c true if the file was written successfully
+     */
+    bool writeChromeTrace(const std::string& path, int processId,
+        const std::string& processName) const;
+
+    /**
+     * Starts recording the time spent in every TraceZone on the calling thread, which has
+     * to be the main thread, summed up per frame and per zone. In addition, the total
+     * duration of every frame and the GPU times reported through #storeGpuFrameTime are
+     * recorded. The frame times of a previous recording are discarded.
+     */
+    void startFrameTimeRecording();
+
+    /// Stops recording frame times. The recorded times remain until the next recording
+    void stopFrameTimeRecording();
+
+    bool isRecordingFrameTimes() const;
+
+    /**
+     * Returns \c true if the TraceZone%s should report their events, which is the case
+     * while tracing or while recording frame times.
+     */
+    bool isCollectingTraceEvents() const;
+
+    /**
+     * Ends the current frame of the frame time recording and begins the next one. This
+     * function has to be called once per frame on the main thread before any TraceZone of
+     * the new frame is entered.
+     */
+    void finishFrame();
+
+    /**
+     * Records the time in \p milliseconds that the GPU spent on rendering a frame. As the
+     * GPU results become available with a latency, the measurement does not have to
+     * belong to the current frame.
+     */
+    void storeGpuFrameTime(double milliseconds);
+
+    /**
+     * Returns the recorded frame times in milliseconds. The phases are named after their
+     * TraceZone, except for "Frame", which contains the duration of the entire frames,
+     * and "GPU", which contains the GPU times.
+     */
+    const std::map<std::string, std::vector<double>>& frameTimes() const;
+
+    /**
+     * Enables or disables the live frame times. While they are enabled, the TraceZone%s
+     * on the main thread are collected for every frame, but only the last completed
+     * frame is kept, see #lastFrame. This function has to be called on the main thread.
+     */
+    void setLiveFrameTimesEnabled(bool enabled);
+    bool isLiveFrameTimesEnabled() const;
+
+    /**
+     * Returns the TraceZone%s of the last frame that was completed while the live frame
+     * times were enabled. This function may only be called on the main thread.
+     */
+    const FrameSummary& lastFrame() const;
+
 private:
+    struct TraceBuffer;
+
+    /// Returns the trace buffer of the calling thread for the current trace
+    TraceBuffer& traceBuffer();
+
     bool _performanceMeasurementEnabled = false;
     bool _loggingEnabled = false;
+    std::atomic_bool _synchronizeGpu = true;
 
     std::string _logDir;
     std::string _prefix;
@@ -85,6 +210,28 @@ private:
 
     size_t _currentTick = 0;
 
+    std::atomic_bool _isTracing = false;
+    std::atomic_int _traceGeneration = 0;
+    std::chrono::steady_clock::time_point _traceStartTime;
+    std::chrono::system_clock::time_point _traceStartSystemTime;
+    mutable std::mutex _traceBufferMutex;
+    std::vector<std::unique_ptr<TraceBuffer>> _traceBuffers;
+
+    std::atomic_bool _isCollectingTraceEvents = false;
+    std::atomic_bool _isRecordingFrameTimes = false;
+    std::atomic_bool _isLiveFrameTimesEnabled = false;
+    std::atomic<std::thread::id> _frameTimeThread;
+    bool _hasFrameStart = false;
+    std::chrono::steady_clock::time_point _frameStartTime;
+    /// The time spent in each zone during the current frame, keyed by the zone's name
+    std::vector<std::pair<const char*, double>> _currentFrameTimes;
+    std::map<std::string, std::vector<double>> _frameTimes;
+    FrameSummary _currentFrame;
+    FrameSummary _lastFrame;
+
+    /// Updates #_isCollectingTraceEvents after one of its consumers has been disabled
+    void updateTraceEventCollection();
+
     void tick();
     bool createLogDir();
 };
@@ -40,6 +40,8 @@ public:
 private:
     std::string _identifier;
     std::chrono::high_resolution_clock::time_point _startTime;
+    /// Whether glFinish is called, see PerformanceManager::setGpuSynchronization
+    bool _synchronizeGpu;
 };
 
 #define __MERGE_PerfMeasure(a,b)  a##b
@@ -0,0 +1,67 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TRACEZONE___H__
+#define __OPENSPACE_CORE___TRACEZONE___H__
+
+#include <chrono>
+
+namespace openspace::performance {
+
+/**
+ * Records the time spent in the enclosing scope as one event in the trace of the
+ * PerformanceManager, if tracing is enabled (see PerformanceManager::startTracing).
+ * Zones that are nested on the same thread show up as a hierarchy in the exported
+ * timeline. While frame times are recorded (see
+ * PerformanceManager::startFrameTimeRecording), the zones on the main thread also add
+ * to the time of their phase in the current frame. Unlike the PerformanceMeasurement, a
+ * TraceZone does not synchronize with the GPU and can therefore stay in place
+ * permanently; while neither is enabled, it costs a single atomic load.
+ */
+class TraceZone {
+public:
+    /**
+     * \param name The name of the zone. The pointer is stored with the event, so it has
+     *        to stay valid until the trace has been written, which in practice means
+     *        that it has to be a string literal
+     */
+    explicit TraceZone(const char* name);
+    ~TraceZone();
+
+private:
+    const char* _name;
+    std::chrono::steady_clock::time_point _beginTime;
+    bool _isActive;
+};
+
+#define __MERGE_PerfTrace(a,b)  a##b
+#define __LABEL_PerfTrace(a) __MERGE_PerfTrace(unique_trace_, a)
+
+/// Declare a new variable for tracing the current block
+#define PerfTrace(name)                                                                  \
+    auto __LABEL_PerfTrace(__LINE__) = openspace::performance::TraceZone((name))
+
+} // namespace openspace::performance
+
+#endif // __OPENSPACE_CORE___TRACEZONE___H__
@@ -261,6 +261,32 @@ public:
      */
     OnChangeHandle onChange(std::function<void()> callback);
 
+    /**
+     * Starts a batch of changes. While a batch is active, the onChange callbacks of a
+     * changed Property are not called immediately. Instead, each changed Property is
+     * remembered and its callbacks are called once when the outermost batch is ended by
+     * a call to endChangeBatch, no matter how often its value changed in between.
+     * Batches can be nested and must only be used from the main thread.
+     */
+    static void beginChangeBatch();
+
+    /**
+     * Ends a batch of changes that was started with beginChangeBatch. If this ends the
+     * outermost batch, the onChange callbacks of all Propertys that have changed during
+     * the batch are called.
+     *
+     * \pre Every call must be preceded by a matching call to beginChangeBatch
+     */
+    static void endChangeBatch();
+
+    /**
+     * Returns the number of times that the value of any Property has changed since the
+     * start of the application. Comparing the returned values of two calls tells whether
+     * any Property has changed in between, which is cheaper than listening to all of
+     * them. This function is thread-safe.
+     */
+    static uint64_t changeCount();
+
     /**
     * This method registers a \p callback function that will be called when the property
     * is destructed.
@@ -538,6 +564,9 @@ private:
 
     OnChangeHandle _currentHandleValue = 0;
 
+    /// Whether this Property changed during the current change batch
+    bool _hasPendingNotification = false;
+
 #ifdef _DEBUG
     // These identifiers can be used for debugging. Each Property is assigned one unique
     // identifier.
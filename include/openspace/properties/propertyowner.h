@@ -26,9 +26,11 @@
 #define __OPENSPACE_CORE___PROPERTYOWNER___H__
 
 #include <openspace/documentation/documentationgenerator.h>
+#include <openspace/util/prefixtrie.h>
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace openspace::properties {
@@ -48,6 +50,9 @@ class Property;
  * Property::property method, providing an URI for the location of the property. If the
  * URI contains separators (<code>.</code>), the first name before the separator will be
  * used as a subOwner's name and the search will proceed recursively.
+ * The PropertyOwner at the top of an ownership hierarchy keeps a hash index of the URIs
+ * of all Propertys in its hierarchy, which is updated whenever a Property or sub-owner
+ * is added, removed, or renamed, so that a lookup does not have to walk the hierarchy.
  */
 class PropertyOwner : public DocumentationGenerator {
 public:
@@ -160,6 +165,15 @@ public:
      */
     bool hasProperty(const std::string& uri) const;
 
+    /**
+     * Returns the completions of the \p prefix among the URIs of all Propertys in this
+     * PropertyOwner and its sub-owners, relative to this PropertyOwner. The URIs are kept
+     * in a PrefixTrie next to the index of the root owner, so the cost of a completion
+     * does not depend on the number of Propertys in the hierarchy.
+     */
+    std::vector<PrefixTrie::Completion> propertyUriCompletions(
+        std::string_view prefix) const;
+
     /**
     * This method checks if a Property exists in this PropertyOwner.
     * \return <code>true</code> if the Property existed, <code>false</code> otherwise.
@@ -304,12 +318,32 @@ protected:
     std::string _description;
 
 private:
+    /// Returns the PropertyOwner at the top of the ownership hierarchy of this owner
+    PropertyOwner& rootOwner();
+    const PropertyOwner& rootOwner() const;
+
+    /**
+     * Returns the URI of this PropertyOwner relative to its root owner, including the
+     * trailing separator, or an empty string if this PropertyOwner is the root owner.
+     */
+    std::string uriPrefix() const;
+
+    /// Adds the URIs of all Propertys in this hierarchy, prefixed by \p prefix, to
+    /// \p uris
+    void collectUris(const std::string& prefix,
+        std::vector<std::pair<std::string, Property*>>& uris) const;
+
     /// The owner of this PropertyOwner
     PropertyOwner* _owner = nullptr;
     /// A list of all registered Property's
     std::vector<Property*> _properties;
     /// A list of all sub-owners
     std::vector<PropertyOwner*> _subOwners;
+    /// Maps the relative URIs of all Property's in this hierarchy to the Property. This
+    /// index is only used while this PropertyOwner is the root of its hierarchy
+    std::unordered_map<std::string, Property*> _uriIndex;
+    /// The same URIs as in the #_uriIndex, in a form that can be completed
+    PrefixTrie _uriTrie;
     /// The associations between group identifiers of Property's and human-readable names
     std::map<std::string, std::string> _groupNames;
     /// Collection of string tag(s) assigned to this property
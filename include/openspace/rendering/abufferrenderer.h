@@ -33,6 +33,7 @@
 #include <ghoul/glm.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
@@ -65,6 +66,7 @@ public:
     void setHDRExposure(float hdrExposure) override;
     void setHDRBackground(float hdrBackground) override;
     void setGamma(float gamma) override;
+    void setFragmentBufferBudget(int megabytes) override;
 
     float hdrBackground() const override;
     int nAaSamples() const override;
@@ -89,6 +91,9 @@ public:
 private:
     void clear();
     void updateResolution();
+    void updateFragmentCapacity(GLuint capacity);
+    void readBackFragmentCount();
+    void adaptFragmentCapacity();
     void updateRaycastData();
     void updateResolveDictionary();
     void updateMSAASamplingPattern();
@@ -101,6 +106,7 @@ private:
     bool _dirtyRendererData = true;
     bool _dirtyRaycastData = true;
     bool _dirtyResolveDictionary = true;
+    bool _dirtyFragmentBudget = false;
 
     std::unique_ptr<ghoul::opengl::ProgramObject> _resolveProgram = nullptr;
 
@@ -129,9 +135,36 @@ private:
     GLuint _atomicCounterBuffer;
     GLuint _fragmentBuffer;
     GLuint _fragmentTexture;
+    GLuint _overflowBuffer;
     GLuint _vertexPositionBuffer;
     int _nAaSamples;
 
+    /**
+     * The number of fragments that fit into the fragment buffer and the upper limit for
+     * it that is derived from the fragment buffer budget. The capacity is written next
+     * to the fragment counter in the atomic counter buffer, so changing it does not
+     * require the geometry shaders to be recompiled
+     */
+    GLuint _fragmentCapacity = 0;
+    GLuint _maxFragmentCapacity = 0;
+    size_t _fragmentBufferBudget = 512 * 1024 * 1024;
+
+    /**
+     * The atomic counter is copied into one of these buffers after the geometry has been
+     * rendered and read back a few frames later, once its fence has been signaled, to
+     * avoid stalling the pipeline
+     */
+    struct {
+        std::array<GLuint, 3> buffers = {};
+        std::array<GLsync, 3> fences = {};
+        int current = 0;
+    } _counterReadback;
+
+    /// The number of fragments that were requested in the last frame that was read back
+    GLuint _requestedFragments = 0;
+    bool _hasRequestedFragments = false;
+    int _framesBelowCapacity = 0;
+
     float _hdrExposure = 0.4f;
     float _hdrBackground = 2.8f;
     float _gamma = 2.2f;
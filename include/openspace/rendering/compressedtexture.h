@@ -0,0 +1,106 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___COMPRESSEDTEXTURE___H__
+#define __OPENSPACE_CORE___COMPRESSEDTEXTURE___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/texture.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openspace::rendering {
+
+/**
+ * The contents of a KTX2 file whose mipmap levels are stored in a format that can be
+ * uploaded to the GPU as-is. Reading a file only touches memory, so it can happen on a
+ * worker thread, while the texture has to be created on the thread that owns the OpenGL
+ * context.
+ */
+struct CompressedTextureData {
+    struct Level {
+        glm::uvec2 dimensions = glm::uvec2(0);
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    glm::uvec2 dimensions = glm::uvec2(0);
+    ghoul::opengl::Texture::Format format = ghoul::opengl::Texture::Format::RGBA;
+    GLenum internalFormat = GL_RGBA8;
+    /// Is \c false for plain 8-bit RGBA levels and \c true for block-compressed levels
+    bool isBlockCompressed = true;
+
+    /// The contents of the file, which the levels point into. Level 0 is the largest
+    std::vector<char> buffer;
+    std::vector<Level> levels;
+};
+
+/// Returns \c true if the file at \p path is read by #readCompressedTexture rather than
+/// by the ghoul::io::TextureReader, which is decided based on the extension of the file
+bool isCompressedTextureFile(const std::string& path);
+
+/**
+ * Reads the KTX2 file at \p path. Supported are files with a single 2D image whose levels
+ * are either BC1-BC7 block-compressed or 8-bit RGBA and that are not supercompressed.
+ * Files that have to be transcoded, such as Basis Universal files, are rejected.
+ *
+ * \throw ghoul::RuntimeError If the file cannot be read or its format is not supported
+ */
+CompressedTextureData readCompressedTexture(const std::string& path);
+
+/**
+ * Writes the \p data to a KTX2 file at \p path. The \p data has to use one of the formats
+ * that #readCompressedTexture supports.
+ *
+ * \throw ghoul::RuntimeError If the file cannot be written
+ */
+void writeCompressedTexture(const std::string& path, const CompressedTextureData& data);
+
+/**
+ * Creates a texture that contains all levels of the \p data. If the \p filter uses
+ * mipmaps, the stored levels are used instead of generating new ones. This function has
+ * to be called from the thread that owns the OpenGL context.
+ */
+std::unique_ptr<ghoul::opengl::Texture> createCompressedTexture(
+    const CompressedTextureData& data,
+    ghoul::opengl::Texture::FilterMode filter =
+        ghoul::opengl::Texture::FilterMode::LinearMipMap);
+
+/**
+ * Loads the image at \p path into an uploaded texture that uses the \p filter. Files for
+ * which #isCompressedTextureFile returns \c true are read with #readCompressedTexture,
+ * all other files are decoded by the ghoul::io::TextureReader. Returns \c nullptr if the
+ * reader could not decode the image.
+ *
+ * \throw ghoul::RuntimeError If the file cannot be read or its format is not supported
+ */
+std::unique_ptr<ghoul::opengl::Texture> loadTexture(const std::string& path,
+    ghoul::opengl::Texture::FilterMode filter =
+        ghoul::opengl::Texture::FilterMode::LinearMipMap);
+
+} // namespace openspace::rendering
+
+#endif // __OPENSPACE_CORE___COMPRESSEDTEXTURE___H__
@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_CORE___DEFERREDCASTER___H
 #define __OPENSPACE_CORE___DEFERREDCASTER___H
 
+#include <ghoul/glm.h>
 #include <string>
 
 namespace ghoul::opengl {
@@ -60,6 +61,21 @@ public:
 
     virtual void update(const UpdateData&) = 0;
 
+    /**
+     * Returns a conservative bounding rectangle, in normalized device coordinates, of
+     * the part of the screen that this deferredcaster can affect for the provided
+     * \p renderData. The xy components contain the lower left corner and the zw
+     * components contain the upper right corner. The renderer restricts the deferred
+     * pass to this rectangle and an empty rectangle means that no pixel is affected.
+     * The default implementation covers the entire screen.
+     *
+     * \param renderData The RenderData of the current frame
+     * \return The screen-space bounds as (minX, minY, maxX, maxY)
+     */
+    virtual glm::vec4 screenSpaceBounds(const RenderData& /*renderData*/) const {
+        return glm::vec4(-1.f, -1.f, 1.f, 1.f);
+    }
+
     /**
      * Return a path to a glsl file with helper functions required for the
      * transformation and raycast steps.
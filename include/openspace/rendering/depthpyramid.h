@@ -0,0 +1,145 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_CORE___DEPTHPYRAMID___H__
+#define __OPENSPACE_CORE___DEPTHPYRAMID___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/uniformcache.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace {
+
+class Camera;
+
+/**
+ * A hierarchical depth buffer that is used to cull objects that are hidden behind the
+ * opaque geometry of the previous frame. Every level of the pyramid stores the farthest
+ * depth of the texels below it, so an object is hidden if its nearest point is farther
+ * away than the farthest depth in the part of the screen that it covers. The pyramid is
+ * reduced on the GPU and its coarser levels are read back asynchronously, which means
+ * that the results that are used for culling are a few frames old. The tests account
+ * for this by rejecting objects outside of the view that the pyramid was built from and
+ * by widening the screen area of an object by the parallax of the camera movement since.
+ */
+class DepthPyramid {
+public:
+    DepthPyramid();
+    ~DepthPyramid();
+
+    void initializeGL();
+    void deinitializeGL();
+
+    /**
+     * Builds the pyramid from the multisampled \p depthTexture with \p nSamples samples,
+     * whose lower left \p resolution texels contain the scene as seen by the \p camera,
+     * and starts reading back its coarsest levels. Nothing is done while the previous
+     * readback has not finished. The framebuffer binding, viewport, depth test, and
+     * blending are restored afterwards.
+     */
+    void update(GLuint depthTexture, int nSamples, const glm::ivec2& resolution,
+        const Camera& camera);
+
+    /// Discards the results that have been read back, so that nothing is culled
+    void invalidate();
+
+    /// Returns \c true if there are results that objects can be tested against
+    bool isValid() const;
+
+    /**
+     * Returns \c true if the box whose \p corners are given in the model coordinates of
+     * the \p modelTransform was hidden by the geometry of the pyramid. The \p camera is
+     * the camera that the object is about to be rendered with.
+     */
+    bool isOccluded(const std::array<glm::dvec4, 8>& corners,
+        const glm::dmat4& modelTransform, const Camera& camera) const;
+
+    /**
+     * Returns \c true if the sphere at the \p center with the \p radius in world
+     * coordinates was hidden by the geometry of the pyramid. The \p camera is the camera
+     * that the object is about to be rendered with.
+     */
+    bool isOccluded(const glm::dvec3& center, double radius, const Camera& camera) const;
+
+private:
+    /**
+     * Tests the screen space bounds of the \p nPoints \p points in world coordinates,
+     * whose nearest depth is \p nearestDepth, against the levels that have been read
+     * back.
+     */
+    bool isOccluded(const glm::dvec3* points, size_t nPoints, double nearestDepth,
+        const Camera& camera) const;
+
+    /// Copies the finished readback into the CPU levels and builds the coarser levels
+    void finishReadback();
+
+    struct Level {
+        glm::ivec2 size = glm::ivec2(0);
+        /// The farthest depth of each texel in meters, stored row by row
+        std::vector<float> depths;
+    };
+
+    /// The state of the camera and screen that a set of levels was built for
+    struct View {
+        glm::dmat4 viewProjection = glm::dmat4(1.0);
+        glm::dvec3 cameraPosition = glm::dvec3(0.0);
+        /// The change in normalized device coordinates per radian at the screen center
+        glm::dvec2 projectionScale = glm::dvec2(1.0);
+        glm::ivec2 resolution = glm::ivec2(0);
+        /// The number of pixels in each dimension that a texel of the first level covers
+        int pixelsPerTexel = 1;
+    };
+
+    /// The GPU levels, where the first one has half of the resolution of the screen
+    std::vector<GLuint> _textures;
+    std::vector<glm::ivec2> _textureSizes;
+    glm::ivec2 _resolution = glm::ivec2(0);
+
+    GLuint _framebuffer = 0;
+    GLuint _quad = 0;
+    GLuint _vertexBuffer = 0;
+    GLuint _pixelBuffer = 0;
+    size_t _pixelBufferSize = 0;
+    GLsync _readbackFence = nullptr;
+    View _pendingView;
+    glm::ivec2 _pendingSize = glm::ivec2(0);
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _resolveProgram;
+    UniformCache(mainDepthTexture, nSamples, sourceSize) _resolveUniformCache;
+    std::unique_ptr<ghoul::opengl::ProgramObject> _reduceProgram;
+    UniformCache(sourceTexture, sourceSize) _reduceUniformCache;
+
+    /// The levels that have been read back, from the finest to a single texel
+    std::vector<Level> _levels;
+    View _view;
+    bool _isValid = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___DEPTHPYRAMID___H__
@@ -28,12 +28,14 @@
 #include <openspace/rendering/renderer.h>
 #include <openspace/rendering/raycasterlistener.h>
 #include <openspace/rendering/deferredcasterlistener.h>
+#include <openspace/rendering/depthpyramid.h>
 
 #include <ghoul/glm.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
 #include <map>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -53,6 +55,7 @@ struct DeferredcasterTask;
 struct RaycastData;
 struct RaycasterTask;
 class Scene;
+class SceneGraphNode;
 struct UpdateStructures;
 
 class FramebufferRenderer : public Renderer, public RaycasterListener,
@@ -80,18 +83,32 @@ public:
     void updateMSAASamplingPattern();
 
     void setResolution(glm::ivec2 res) override;
+    void setWindow(int windowId, glm::ivec2 resolution) override;
     void setNAaSamples(int nAaSamples) override;
     void setHDRExposure(float hdrExposure) override;
     void setHDRBackground(float hdrBackground) override;
     void setGamma(float gamma) override;
+    void setAdaptiveRaycastResolution(bool enabled) override;
+    void setRaycastMotionDownscale(float factor) override;
+    void setCombinedRaycasting(bool enabled) override;
+    void setResolvedDeferredShading(bool enabled) override;
+    void setPostProcessAntialiasing(bool enabled) override;
+    void setBackgroundCache(bool enabled) override;
+    void setBackgroundCacheResolution(int resolution) override;
+    void setBackgroundCacheDistance(float distance) override;
+    void setResolutionScale(float scale) override;
+    void setKeepLastFrame(bool enabled) override;
+    bool presentLastFrame() override;
+    void setOcclusionCulling(bool enabled) override;
+    const DepthPyramid* depthPyramid() const override;
 
     float hdrBackground() const override;
     int nAaSamples() const override;
     const std::vector<double>& mSSAPattern() const override;
 
     void update() override;
-    void performRaycasterTasks(const std::vector<RaycasterTask>& tasks);
-    void performDeferredTasks(const std::vector<DeferredcasterTask>& tasks,
+    void performRaycasterTasks(const std::pmr::vector<RaycasterTask>& tasks);
+    void performDeferredTasks(const std::pmr::vector<DeferredcasterTask>& tasks,
         float blackoutFactor);
     void render(Scene* scene, Camera* camera, float blackoutFactor) override;
 
@@ -107,10 +124,157 @@ public:
         DeferredcasterListener::IsAttached isAttached) override;
 
 private:
+    /**
+     * Upsamples the volume that was raycast into the downscaled framebuffer with the
+     * \p downscaleFactor into the main framebuffer. Samples whose geometry depth differs
+     * from the depth of the full resolution pixel are weighted down to avoid bleeding
+     * across the edges of occluding geometry.
+     */
+    void mergeDownscaledVolume(float downscaleFactor);
+
+    /**
+     * Runs the \p tasks on the G-buffer given by the \p color, \p position and
+     * \p normal textures, which are multisampled with \p nSamples samples. If the
+     * \p depthFunction is not \c GL_ALWAYS, the passes are depth tested against the
+     * mask that is written by performResolvedDeferredTasks.
+     */
+    void performDeferredTasks(const std::pmr::vector<DeferredcasterTask>& tasks,
+        float blackoutFactor, GLuint color, GLuint position, GLuint normal,
+        int nSamples, GLenum depthFunction);
+
+    /**
+     * Resolves the G-buffer into single sample textures and runs the deferred \p tasks
+     * once per pixel on them. Only the pixels on the edges of geometry, whose samples
+     * differ, are shaded from the multisampled G-buffer afterwards. The result is
+     * composed in the deferred framebuffer.
+     */
+    void performResolvedDeferredTasks(const std::pmr::vector<DeferredcasterTask>& tasks,
+        float blackoutFactor);
+
+    /**
+     * Draws the image from the deferred framebuffer into the currently bound
+     * framebuffer at the full resolution, while smoothing the edges in the image.
+     */
+    void postProcessAntialiasing();
+
+    /// Raycasts the volume of a single \p task into the main framebuffer
+    void performRaycasterTask(const RaycasterTask& task);
+
+    /**
+     * Raycasts the volumes of all \p tasks in a single pass, which composites
+     * overlapping volumes in the correct order. The entry and exit points of each volume
+     * are rendered into one layer of the combined raycasting textures first.
+     *
+     * \return \c false if one of the required programs could not be built, in which
+     *         case nothing has been rendered into the main framebuffer
+     */
+    bool performCombinedRaycasterTasks(const std::vector<const RaycasterTask*>& tasks);
+
+    /**
+     * Returns the program that raycasts all of the \p raycasters in a single pass,
+     * building it the first time that this combination of raycasters is used. Returns
+     * \c nullptr if the program could not be built.
+     */
+    ghoul::opengl::ProgramObject* combinedRaycastProgram(
+        const std::vector<VolumeRaycaster*>& raycasters);
+
+    /**
+     * Renders the background render bin of the \p scene into the six faces of the
+     * background cube map if the \p camera has moved too far since the last time or if
+     * the background nodes have changed. The faces are aligned with the world axes, so
+     * that the cube map stays valid while the camera is rotating.
+     *
+     * \return \c true if the cube map can be used instead of rendering the background
+     *         render bin, \c false if the background has to be rendered as usual, for
+     *         example because one of its nodes uses raycasting
+     */
+    bool updateBackgroundCache(Scene& scene, const Camera& camera,
+        bool doPerformanceMeasurements);
+
+    /// Draws the background cube map as seen by the \p camera into the main framebuffer
+    void drawBackgroundCache(const Camera& camera);
+
+    /**
+     * Returns the resolution at which the scene is rendered, which is the full resolution
+     * reduced by the resolution scale. The scaled image occupies the lower left part of
+     * all framebuffers.
+     */
+    glm::ivec2 scaledResolution() const;
+
+    /**
+     * Draws the scaled image from the deferred framebuffer into the currently bound
+     * framebuffer at the full resolution.
+     */
+    void upscale();
+
+    /**
+     * Copies the current viewport of the framebuffer \p framebuffer, which contains the
+     * finished frame, so that it can be presented again by presentLastFrame.
+     */
+    void storeLastFrame(GLint framebuffer);
+
+    /// The framebuffers and their attachments that each window owns separately
+    struct WindowFramebuffers {
+        glm::ivec2 resolution = glm::ivec2(0);
+
+        GLuint mainFramebuffer = 0;
+        GLuint mainColorTexture = 0;
+        GLuint mainPositionTexture = 0;
+        GLuint mainNormalTexture = 0;
+        GLuint mainDepthTexture = 0;
+        GLuint exitFramebuffer = 0;
+        GLuint exitColorTexture = 0;
+        GLuint exitDepthTexture = 0;
+        GLuint deferredFramebuffer = 0;
+        GLuint deferredColorTexture = 0;
+        GLuint downscaleFramebuffer = 0;
+        GLuint downscaleColorTexture = 0;
+
+        GLuint lastFrameFramebuffer = 0;
+        GLuint lastFrameColorTexture = 0;
+        bool isLastFrameValid = false;
+        glm::ivec4 lastFrameViewport = glm::ivec4(0);
+        glm::ivec2 lastFrameTextureSize = glm::ivec2(0);
+
+        GLuint combinedRaycastingFramebuffer = 0;
+        GLuint combinedRaycastingEntryTexture = 0;
+        GLuint combinedRaycastingExitTexture = 0;
+        GLuint combinedRaycastingDepthBuffer = 0;
+        int combinedRaycastingLayers = 0;
+        glm::ivec2 combinedRaycastingTextureSize = glm::ivec2(0);
+
+        GLuint resolvedFramebuffer = 0;
+        GLuint resolvedColorTexture = 0;
+        GLuint resolvedPositionTexture = 0;
+        GLuint resolvedNormalTexture = 0;
+        GLuint resolvedDepthBuffer = 0;
+        glm::ivec2 resolvedTextureSize = glm::ivec2(0);
+
+        /// The depth pyramid is built from the depth of a single window
+        std::unique_ptr<DepthPyramid> depthPyramid;
+    };
+
+    /**
+     * Creates the framebuffers of the active window at the current resolution. The
+     * framebuffers that are only used by some of the rendering options are created
+     * empty and allocated on first use.
+     */
+    void createWindowFramebuffers();
+
+    /// Deletes the framebuffers of the active window
+    void deleteWindowFramebuffers();
+
+    /**
+     * Exchanges the framebuffers of the active window with the ones stored in
+     * \p framebuffers.
+     */
+    void swapWindowFramebuffers(WindowFramebuffers& framebuffers);
+
     std::map<VolumeRaycaster*, RaycastData> _raycastData;
     RaycasterProgObjMap _exitPrograms;
     RaycasterProgObjMap _raycastPrograms;
     RaycasterProgObjMap _insideRaycastPrograms;
+    RaycasterProgObjMap _boundsPrograms;
 
     std::map<Deferredcaster*, DeferredcastData> _deferredcastData;
     DeferredcasterProgObjMap _deferredcastPrograms;
@@ -119,6 +283,109 @@ private:
     std::unique_ptr<ghoul::opengl::ProgramObject> _resolveProgram;
     UniformCache(mainColorTexture, blackoutFactor, nAaSamples) _uniformCache;
 
+    struct {
+        GLuint framebuffer;
+        GLuint colorTexture;
+        std::unique_ptr<ghoul::opengl::ProgramObject> mergeProgram;
+        UniformCache(downscaledVolume, mainDepthTexture, downscaleFactor,
+            downscaledSize) uniformCache;
+    } _downscaleVolumeRendering;
+
+    struct {
+        bool isEnabled = false;
+        int resolution = 1024;
+        float distance = 1e12f;
+
+        /// Whether the cube map contains the current background
+        bool isValid = false;
+        /// Whether the current background nodes can be cached at all
+        bool isCachable = true;
+        /// The resolution that the cube map was last allocated with
+        int textureResolution = 0;
+        glm::dvec3 cameraPosition = glm::dvec3(0.0);
+        std::vector<const SceneGraphNode*> nodes;
+
+        GLuint framebuffer;
+        GLuint cubeMap;
+        GLuint depthBuffer;
+        std::unique_ptr<ghoul::opengl::ProgramObject> program;
+        UniformCache(backgroundCubeMap, inverseViewProjection) uniformCache;
+    } _backgroundCache;
+
+    struct {
+        float scale = 1.f;
+        std::unique_ptr<ghoul::opengl::ProgramObject> program;
+        UniformCache(sourceTexture, sourceSize) uniformCache;
+    } _dynamicResolution;
+
+    struct {
+        bool isEnabled = false;
+        /// Whether the texture contains the last rendered frame
+        bool isValid = false;
+        /// The viewport of the default framebuffer that the frame was copied from
+        glm::ivec4 viewport = glm::ivec4(0);
+        /// The size that the texture was last allocated with
+        glm::ivec2 textureSize = glm::ivec2(0);
+
+        GLuint framebuffer;
+        GLuint colorTexture;
+    } _lastFrame;
+
+    struct {
+        bool isEnabled = true;
+        /// The number of layers that the textures were last allocated with
+        int nLayers = 0;
+        /// The size that the textures were last allocated with
+        glm::ivec2 textureSize = glm::ivec2(0);
+
+        GLuint framebuffer;
+        GLuint entryTexture;
+        GLuint exitTexture;
+        GLuint depthBuffer;
+        std::map<
+            std::vector<VolumeRaycaster*>,
+            std::unique_ptr<ghoul::opengl::ProgramObject>
+        > programs;
+    } _combinedRaycasting;
+
+    struct {
+        bool isEnabled = false;
+        /// The size that the textures were last allocated with
+        glm::ivec2 textureSize = glm::ivec2(0);
+
+        GLuint framebuffer;
+        GLuint colorTexture;
+        GLuint positionTexture;
+        GLuint normalTexture;
+        /// Shared with the deferred framebuffer, where it masks the edge pixels
+        GLuint depthBuffer;
+        std::unique_ptr<ghoul::opengl::ProgramObject> program;
+        UniformCache(mainColorTexture, mainPositionTexture, mainNormalTexture,
+            nAaSamples) uniformCache;
+    } _resolvedGBuffer;
+
+    struct {
+        bool isEnabled = false;
+        std::unique_ptr<ghoul::opengl::ProgramObject> program;
+        UniformCache(sourceTexture, sourceSize) uniformCache;
+    } _postProcessAntialiasing;
+
+    struct {
+        bool isEnabled = false;
+        std::unique_ptr<DepthPyramid> pyramid;
+    } _occlusionCulling;
+
+    /// The identifier of the window whose framebuffers are stored in the members, or -1
+    /// if the framebuffers that were created in initialize have not been used yet
+    int _activeWindow = -1;
+    /// The framebuffers of all other windows that have been rendered to
+    std::map<int, WindowFramebuffers> _windowFramebuffers;
+
+    bool _adaptiveRaycastResolution = false;
+    float _raycastMotionDownscale = 0.5f;
+    bool _isCameraMoving = false;
+    glm::dmat4 _previousViewMatrix = glm::dmat4(1.0);
+
     GLuint _screenQuad;
     GLuint _vertexPositionBuffer;
     GLuint _mainColorTexture;
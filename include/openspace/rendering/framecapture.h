@@ -0,0 +1,97 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___FRAMECAPTURE___H__
+#define __OPENSPACE_CORE___FRAMECAPTURE___H__
+
+#include <openspace/util/threadpool.h>
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace openspace {
+
+/**
+ * Captures the contents of the current window without stalling the rendering. The
+ * pixels of a frame are read back into one of a ring of pixel buffer objects, and a
+ * fence is inserted after the read. In the following frames, the buffers whose fences
+ * have signaled are copied out and handed to a pool of worker threads that encode and
+ * write the images. Only if all buffers of the ring are still in flight does a capture
+ * wait for the oldest one.
+ */
+class FrameCapture {
+public:
+    enum class Format {
+        Tga = 0,  ///< Uncompressed 32 bit Truevision TGA files
+        Pam       ///< Uncompressed Netpbm PAM files with 8 bit RGBA samples
+    };
+
+    FrameCapture();
+    ~FrameCapture();
+
+    void initializeGL();
+
+    /// Writes all outstanding captures and releases the pixel buffer objects
+    void deinitializeGL();
+
+    /**
+     * Starts the read back of the back buffer of the current window. The image is
+     * written to \p filename, with the file extension for the \p format appended, once
+     * the read back has finished.
+     */
+    void capture(std::string filename, Format format);
+
+    /// Hands all finished read backs to the worker threads. Called once per frame
+    void update();
+
+    /// Returns the number of images that are read back or waiting to be written
+    int nPendingCaptures() const;
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        size_t bufferSize = 0;
+        glm::ivec2 resolution = glm::ivec2(0);
+        std::string filename;
+        Format format = Format::Tga;
+    };
+
+    /// Copies the pixels of the \p slot out of its buffer and queues the writing
+    void finishCapture(Slot& slot);
+
+    static constexpr const size_t NumSlots = 3;
+    std::array<Slot, NumSlots> _slots;
+    /// The slot that is used by the next capture, which is also the oldest one in flight
+    size_t _nextSlot = 0;
+
+    ThreadPool _workers;
+    std::atomic<int> _nPendingWrites{ 0 };
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___FRAMECAPTURE___H__
@@ -81,6 +81,27 @@ public:
 
     virtual bool renderedWithDesiredData() const;
 
+    /**
+     * Returns whether this Renderable implements #releaseGLResources and
+     * #restoreGLResources, which lets the ResidencyManager free its GPU memory while it
+     * is not needed. The default implementation returns \c false.
+     */
+    virtual bool canReleaseGLResources() const;
+
+    /**
+     * Frees as much GPU memory as possible while keeping everything that is needed to
+     * recreate it in #restoreGLResources. The Renderable is not rendered or updated
+     * until #restoreGLResources has been called.
+     */
+    virtual void releaseGLResources();
+
+    /**
+     * Recreates the GPU resources that were freed in #releaseGLResources. The
+     * Renderable can finish loading them asynchronously, as long as #isReady returns
+     * \c false until it can be rendered again.
+     */
+    virtual void restoreGLResources();
+
     RenderBin renderBin() const;
     void setRenderBin(RenderBin bin);
     bool matchesRenderBinMask(int binMask);
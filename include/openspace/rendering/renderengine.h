@@ -33,6 +33,10 @@
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/vector/vec3property.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/performance/frametimeregression.h>
+#include <openspace/performance/gputimer.h>
+#include <ghoul/glm.h>
+#include <atomic>
 
 namespace ghoul {
     class Dictionary;
@@ -48,12 +52,15 @@ namespace scripting { struct LuaLibrary; }
 class Camera;
 class RaycasterManager;
 class DeferredcasterManager;
+class FrameCapture;
 class Renderer;
 class Scene;
 class SceneManager;
 class ScreenLog;
 class ScreenSpaceRenderable;
 struct ShutdownInformation;
+class ScreenSpaceBatcher;
+class TextBatcher;
 
 class RenderEngine : public properties::PropertyOwner {
 public:
@@ -74,6 +81,18 @@ public:
     Scene* scene();
     void updateScene();
 
+    /**
+     * Returns whether the transformations of the next frame should be prefetched on the
+     * worker threads while the current frame is being rendered.
+     */
+    bool isPipelinedSceneUpdateEnabled() const;
+
+    /**
+     * Starts prefetching the transformations of the scene for the next frame, which is
+     * expected to be at the simulation time \p nextTime. See Scene::prefetchTransforms.
+     */
+    void prefetchScene(double nextTime);
+
     const Renderer& renderer() const;
     RendererImplementation rendererImplementation() const;
 
@@ -86,6 +105,14 @@ public:
     bool mouseActivationCallback(const glm::dvec2& mousePosition) const;
 
     void renderOverlays(const ShutdownInformation& shutdownInfo);
+
+    /**
+     * Returns the batcher that collects the text of the screen space overlays. Text that
+     * is queued in it is drawn when it is flushed, which happens after all overlays have
+     * been rendered.
+     */
+    TextBatcher& textBatcher();
+    ScreenSpaceBatcher& screenSpaceBatcher();
     void renderEndscreen();
     void postDraw();
 
@@ -143,6 +170,14 @@ public:
      */
     void takeScreenShot();
 
+    /**
+     * Plays back a session recording at a fixed frame pace and measures the frame times
+     * of the playback (see performance::FrameTimeRegression).
+     *
+     * \return \c true if the playback was started
+     */
+    bool startFrameTimeRegression(performance::FrameTimeRegression::Settings settings);
+
     /**
      * Returns the Lua library that contains all Lua functions available to affect the
      * rendering.
@@ -158,6 +193,15 @@ public:
 
     uint64_t frameNumber() const;
 
+    /**
+     * Requests that the scene is rendered again, even if the on-demand rendering would
+     * otherwise present the last frame. This has to be called by everything that changes
+     * the rendered image without changing the camera, the simulation time, or a
+     * property, such as user input or asynchronously loaded data. This function is
+     * thread-safe.
+     */
+    void requestRedraw();
+
 private:
     void setRenderer(std::unique_ptr<Renderer> renderer);
     RendererImplementation rendererFromString(const std::string& renderingMethod) const;
@@ -168,6 +212,19 @@ private:
     void renderShutdownInformation(float timer, float fullTime);
     void renderDashboard();
 
+    /**
+     * Adjusts the resolution scale so that the GPU time of the scene rendering of the
+     * previous frames meets the target frame time. Called once per frame.
+     */
+    void updateResolutionScale();
+
+    /**
+     * Decides whether the on-demand rendering can present the last frame instead of
+     * rendering the scene in this frame, which is the case if nothing has changed for
+     * longer than the on-demand rendering delay. Called once per frame.
+     */
+    void updateIdleState(bool windowResized);
+
     Camera* _camera = nullptr;
     Scene* _scene = nullptr;
 
@@ -187,15 +244,39 @@ private:
     properties::TriggerProperty _takeScreenshot;
     bool _shouldTakeScreenshot = false;
     properties::BoolProperty _applyWarping;
+    properties::BoolProperty _asynchronousScreenshot;
+    properties::OptionProperty _screenshotFormat;
+    std::unique_ptr<FrameCapture> _frameCapture;
+    performance::FrameTimeRegression _frameTimeRegression;
+    std::unique_ptr<TextBatcher> _textBatcher;
+    std::unique_ptr<ScreenSpaceBatcher> _screenSpaceBatcher;
     properties::BoolProperty _showFrameNumber;
     properties::BoolProperty _disableMasterRendering;
+    properties::BoolProperty _sceneCulling;
+    properties::BoolProperty _occlusionCulling;
+    properties::BoolProperty _pipelinedSceneUpdate;
 
     properties::FloatProperty _globalBlackOutFactor;
     properties::IntProperty _nAaSamples;
     properties::FloatProperty _hdrExposure;
     properties::FloatProperty _hdrBackground;
     properties::FloatProperty _gamma;
+    properties::BoolProperty _adaptiveRaycastResolution;
+    properties::FloatProperty _raycastMotionDownscale;
+    properties::BoolProperty _combinedRaycasting;
+    properties::BoolProperty _resolvedDeferredShading;
+    properties::BoolProperty _postProcessAntialiasing;
+    properties::BoolProperty _backgroundCache;
+    properties::IntProperty _backgroundCacheResolution;
+    properties::FloatProperty _backgroundCacheDistance;
+    properties::FloatProperty _resolutionScale;
+    properties::BoolProperty _dynamicResolution;
+    properties::FloatProperty _targetFrameTime;
+    properties::FloatProperty _minimumResolutionScale;
+    properties::IntProperty _fragmentBufferBudget;
     properties::FloatProperty _horizFieldOfView;
+    properties::BoolProperty _onDemandRendering;
+    properties::FloatProperty _onDemandRenderingDelay;
 
     properties::Vec3Property _globalRotation;
     properties::Vec3Property _screenSpaceRotation;
@@ -203,6 +284,33 @@ private:
 
     uint64_t _frameNumber = 0;
 
+    struct {
+        /// Measures the renderer in one window, as queries are not shared between them
+        performance::GpuTimer timer;
+        int windowId = -1;
+        /// The number of views rendered in the measured window during this frame
+        int nViews = 0;
+        /// The number of timer results at the last update, to detect new results
+        unsigned long long nResults = 0;
+        double smoothedTime = 0.0;
+        int framesSinceChange = 0;
+    } _resolutionController;
+
+    struct {
+        std::atomic_bool isRedrawRequested = true;
+        /// Whether the last frame is presented instead of rendering the scene
+        bool isIdle = false;
+        /// The number of views rendered during this frame
+        int nViews = 0;
+        /// Stereo or multiple windows would present the same copy in every view
+        bool hasMultipleViews = false;
+        double lastChangeTime = 0.0;
+        glm::dvec3 cameraPosition = glm::dvec3(0.0);
+        glm::dquat cameraRotation = glm::dquat(1.0, 0.0, 0.0, 0.0);
+        double time = 0.0;
+        uint64_t propertyChangeCount = 0;
+    } _idleDetection;
+
     std::vector<ghoul::opengl::ProgramObject*> _programs;
 
     std::shared_ptr<ghoul::fontrendering::Font> _fontBig;
@@ -39,6 +39,7 @@ namespace openspace {
 
 class RenderableVolume;
 class Camera;
+class DepthPyramid;
 class Scene;
 
 class Renderer {
@@ -49,11 +50,111 @@ public:
     virtual void deinitialize() = 0;
 
     virtual void setResolution(glm::ivec2 res) = 0;
+
+    /**
+     * Selects the window with the identifier \p windowId, whose framebuffers have the
+     * \p resolution, as the target of the following calls. All windows share a single
+     * OpenGL context group, so that the programs and the resources of the scene are
+     * only allocated once, but each window keeps its own resolution-dependent
+     * framebuffers. Renderers that do not support it use the same framebuffers for all
+     * windows.
+     */
+    virtual void setWindow(int /*windowId*/, glm::ivec2 /*resolution*/) {};
     virtual void setNAaSamples(int nAaSamples) = 0;
     virtual void setHDRExposure(float hdrExposure) = 0;
     virtual void setHDRBackground(float hdrBackground) = 0;
     virtual void setGamma(float gamma) = 0;
 
+    /**
+     * Enables or disables the automatic reduction of the raycasting resolution while
+     * the camera is moving. Renderers that do not support it ignore the setting.
+     */
+    virtual void setAdaptiveRaycastResolution(bool /*enabled*/) {};
+
+    /**
+     * Sets the factor by which the raycasting resolution is reduced while the camera is
+     * moving, if the adaptive raycasting resolution is enabled.
+     */
+    virtual void setRaycastMotionDownscale(float /*factor*/) {};
+
+    /**
+     * Enables or disables raycasting all volumes of a frame in a single pass, so that
+     * overlapping volumes are composited correctly. Renderers that do not support it
+     * ignore the setting.
+     */
+    virtual void setCombinedRaycasting(bool /*enabled*/) {};
+
+    /**
+     * Enables or disables resolving the multisampled geometry buffers before running the
+     * deferred casters, so that only the pixels on the edges of geometry are shaded per
+     * sample. Renderers that do not support it ignore the setting.
+     */
+    virtual void setResolvedDeferredShading(bool /*enabled*/) {};
+
+    /**
+     * Enables or disables an antialiasing filter that is applied to the final image.
+     * Renderers that do not support it ignore the setting.
+     */
+    virtual void setPostProcessAntialiasing(bool /*enabled*/) {};
+
+    /**
+     * Enables or disables caching the background render bin in a cube map that is only
+     * rendered again when the camera has moved. Renderers that do not support it ignore
+     * the setting.
+     */
+    virtual void setBackgroundCache(bool /*enabled*/) {};
+
+    /// Sets the resolution of each face of the background cube map
+    virtual void setBackgroundCacheResolution(int /*resolution*/) {};
+
+    /**
+     * Sets the distance in meters that the camera has to move before the background
+     * cube map is rendered again.
+     */
+    virtual void setBackgroundCacheDistance(float /*distance*/) {};
+
+    /**
+     * Sets the fraction of the resolution in each dimension at which the scene is
+     * rendered before being upscaled to the full resolution. Renderers that do not
+     * support it always render at the full resolution.
+     */
+    virtual void setResolutionScale(float /*scale*/) {};
+
+    /**
+     * Sets the maximum amount of memory in megabytes that the renderer may use to store
+     * the fragments of transparent geometry. Only renderers that store per-pixel
+     * fragment lists make use of this.
+     */
+    virtual void setFragmentBufferBudget(int /*megabytes*/) {};
+
+    /**
+     * Enables or disables keeping a copy of each rendered frame, which is required by
+     * presentLastFrame. Renderers that do not support it ignore the setting.
+     */
+    virtual void setKeepLastFrame(bool /*enabled*/) {};
+
+    /**
+     * Draws the copy of the last rendered frame into the currently bound framebuffer
+     * instead of rendering the scene again.
+     *
+     * \return \c true if the last frame was presented, \c false if there is no valid
+     *         copy, for example because the resolution has changed since
+     */
+    virtual bool presentLastFrame() { return false; };
+
+    /**
+     * Enables or disables building a depth pyramid from the opaque geometry of each
+     * frame, which is used to cull objects that are hidden behind it in the following
+     * frames. Renderers that do not support it ignore the setting.
+     */
+    virtual void setOcclusionCulling(bool /*enabled*/) {};
+
+    /**
+     * Returns the depth pyramid that objects can be tested against, or \c nullptr if
+     * occlusion culling is disabled or not supported.
+     */
+    virtual const DepthPyramid* depthPyramid() const { return nullptr; };
+
     virtual float hdrBackground() const = 0;
     virtual int nAaSamples() const = 0;
     virtual const std::vector<double>& mSSAPattern() const = 0;
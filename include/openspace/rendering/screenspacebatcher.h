@@ -0,0 +1,89 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SCREENSPACEBATCHER___H__
+#define __OPENSPACE_CORE___SCREENSPACEBATCHER___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace {
+
+class ScreenSpaceRenderable;
+
+/**
+ * Collects the quads of the ScreenSpaceRenderable%s during a frame and composites them
+ * with a single program and as few instanced draw calls as possible. Up to
+ * #MaxBatchSize quads are drawn per call, each with its texture bound to a separate
+ * texture unit. The quads are drawn in the order in which they were queued, so
+ * queueing them from back to front preserves their blending order.
+ */
+class ScreenSpaceBatcher {
+public:
+    /// The number of quads that are drawn with one draw call. Has to match the value in
+    /// the screenspace_vs.glsl and screenspace_fs.glsl shaders
+    static constexpr const int MaxBatchSize = 16;
+
+    ScreenSpaceBatcher();
+    ~ScreenSpaceBatcher();
+
+    void initializeGL();
+    void deinitializeGL();
+
+    /**
+     * Queues the quad of the \p renderable with the \p modelTransform and \p alpha. The
+     * texture of the \p renderable is bound when the quad is drawn in #flush, so it has
+     * to stay valid until then.
+     */
+    void queue(ScreenSpaceRenderable& renderable, const glm::mat4& modelTransform,
+        float alpha);
+
+    /// Draws all quads that have been queued since the last call with the
+    /// \p viewProjection matrix into the current framebuffer and clears the queue
+    void flush(const glm::mat4& viewProjection);
+
+private:
+    struct Item {
+        ScreenSpaceRenderable* renderable;
+        glm::mat4 modelTransform;
+        float alpha;
+    };
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _program;
+    GLint _viewProjectionLocation = -1;
+    std::array<GLint, MaxBatchSize> _modelTransformLocations;
+    std::array<GLint, MaxBatchSize> _alphaLocations;
+    std::array<GLint, MaxBatchSize> _textureLocations;
+
+    std::vector<Item> _items;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___SCREENSPACEBATCHER___H__
@@ -32,11 +32,8 @@
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/vector/vec3property.h>
 #include <ghoul/opengl/ghoul_gl.h>
-#include <ghoul/opengl/uniformcache.h>
 #include <memory>
 
-namespace ghoul::opengl { class ProgramObject; }
-
 namespace openspace {
 
 namespace documentation { struct Documentation; }
@@ -49,6 +46,8 @@ namespace documentation { struct Documentation; }
  * interface that its children need to implement.
  */
 class ScreenSpaceRenderable : public properties::PropertyOwner {
+    friend class ScreenSpaceBatcher;
+
 public:
     static std::unique_ptr<ScreenSpaceRenderable> createFromDictionary(
         const ghoul::Dictionary& dictionary);
@@ -74,12 +73,15 @@ public:
     static documentation::Documentation Documentation();
 
 protected:
-    void createShaders();
     glm::mat4 scaleMatrix();
     glm::mat4 globalRotationMatrix();
     glm::mat4 translationMatrix();
     glm::mat4 localRotationMatrix();
 
+    /**
+     * Queues the plane with the \p modelTransform in the ScreenSpaceBatcher, which binds
+     * the texture of this renderable through #bindTexture once the batch is drawn.
+     */
     void draw(glm::mat4 modelTransform);
 
     virtual void bindTexture();
@@ -106,8 +108,6 @@ protected:
     properties::TriggerProperty _delete;
 
     glm::ivec2 _objectSize;
-    UniformCache(occlusionDepth, alpha, modelTransform, viewProj, texture) _uniformCache;
-    std::unique_ptr<ghoul::opengl::ProgramObject> _shader;
 
     glm::vec2 _originalViewportSize;
 };
@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___STARSPLATTER___H__
+#define __OPENSPACE_CORE___STARSPLATTER___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/bufferbinding.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/uniformcache.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace {
+
+struct RenderData;
+
+/**
+ * Renders large numbers of stars with compute shaders instead of one billboard per star.
+ * The first pass projects all stars and accumulates the light of every star that is too
+ * faint for its point spread function to be visible additively into a per-pixel HDR
+ * buffer. The remaining bright stars are binned into the screen tiles that their point
+ * spread function overlaps. The second pass processes one tile per work group, adds the
+ * point spread functions of the bright stars of the tile to the accumulated light and
+ * writes the result into a texture that is finally composited into the current
+ * framebuffer. The cost of a faint star is thus a single atomic addition, independent
+ * of the resolution, and there is no overdraw.
+ *
+ * The stars are read by a compute shader that is provided by the user of this class and
+ * that implements the functions declared in
+ * <code>${SHADERS}/starsplatter/splatstar.glsl</code>. It is linked into the program of
+ * the first pass, whose uniforms and storage buffer bindings the user sets in the
+ * callback that is passed to #render.
+ */
+class StarSplatter {
+public:
+    struct Settings {
+        /// The factor from the flux of a star to the intensity of its pixels
+        float exposure = 1.f;
+
+        /// Stars whose intensity lies above this value are drawn with the PSF
+        float brightStarThreshold = 1.f;
+
+        /// The radius in pixels of the PSF of a star at the brightStarThreshold
+        float psfRadius = 2.f;
+
+        /// The range of the color values of the stars that is mapped onto the texture
+        glm::vec2 colorRange = glm::vec2(0.f, 1.f);
+
+        /// The 1D texture that the color values are looked up in
+        GLuint colorTexture = 0;
+
+        /// The 2D texture of the point spread function, whose alpha is used as weight
+        GLuint psfTexture = 0;
+    };
+
+    /**
+     * Creates a splatter whose stars are read by the compute shader at the
+     * \p sourceShaderPath, for which the \p name is used in log messages.
+     */
+    StarSplatter(std::string name, std::string sourceShaderPath);
+    ~StarSplatter();
+
+    void initializeGL();
+    void deinitializeGL();
+
+    /// Rebuilds the programs if any of the shader files has changed on disk
+    void update();
+
+    /**
+     * Splats \p nStars stars, whose positions are given in the model coordinates of the
+     * \p modelTransform, into the current viewport as seen by the camera of \p data.
+     * The \p setSourceUniforms callback is called with the active program of the first
+     * pass and has to set everything that the star source shader needs.
+     */
+    void render(const RenderData& data, const glm::dmat4& modelTransform,
+        unsigned int nStars, const Settings& settings,
+        const std::function<void(ghoul::opengl::ProgramObject&)>& setSourceUniforms);
+
+private:
+    /// Recreates the buffers and the output texture for the \p resolution
+    void createResources(const glm::ivec2& resolution);
+    void destroyResources();
+
+    /// Binds the storage blocks of the \p program to the bindings of the buffers
+    void setBlockBindings(ghoul::opengl::ProgramObject& program) const;
+
+    const std::string _name;
+    const std::string _sourceShaderPath;
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _splatProgram;
+    UniformCache(modelViewTransform, projectionTransform, resolution, tileCount,
+        exposure, brightStarThreshold, psfRadius, colorRange, colorTexture,
+        nStars) _splatUniformCache;
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _resolveProgram;
+    UniformCache(resolution, tileCount, psfTexture, outputImage) _resolveUniformCache;
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _compositeProgram;
+    UniformCache(splatTexture, viewportOffset) _compositeUniformCache;
+
+    using SsboBinding =
+        ghoul::opengl::BufferBinding<ghoul::opengl::bufferbinding::Buffer::ShaderStorage>;
+
+    /// Three fixed-point color channels per pixel that the faint stars are added to
+    GLuint _accumulationBuffer = 0;
+    std::unique_ptr<SsboBinding> _accumulationBinding;
+    /// The number of bright stars in each tile followed by their indices
+    GLuint _tileBuffer = 0;
+    std::unique_ptr<SsboBinding> _tileBinding;
+    /// The number of bright stars followed by their screen positions and colors
+    GLuint _brightStarBuffer = 0;
+    std::unique_ptr<SsboBinding> _brightStarBinding;
+
+    GLuint _outputTexture = 0;
+    GLuint _vao = 0;
+    GLuint _vertexBuffer = 0;
+    glm::ivec2 _resolution = glm::ivec2(0);
+    glm::ivec2 _tileCount = glm::ivec2(0);
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___STARSPLATTER___H__
@@ -0,0 +1,143 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TEXTBATCHER___H__
+#define __OPENSPACE_CORE___TEXTBATCHER___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/font/fontrenderer.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/uniformcache.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ghoul::opengl {
+    class ProgramObject;
+    class TextureAtlas;
+} // namespace ghoul::opengl
+
+namespace openspace {
+
+/**
+ * Collects the text of the screen space overlays during a frame and draws all of it with
+ * a single draw call per font atlas, instead of one draw call per string. The metrics of
+ * each glyph are cached the first time a character is used with a font, so laying out
+ * the text only needs the font again for new characters. Text is placed in the same
+ * coordinate system as the default ghoul::fontrendering::FontRenderer uses, so queueing
+ * a string behaves the same as rendering it through \c RenderFont, apart from kerning,
+ * which is not applied.
+ */
+class TextBatcher {
+public:
+    TextBatcher();
+    ~TextBatcher();
+
+    void initializeGL();
+    void deinitializeGL();
+
+    /// Sets the size of the coordinate system in which the text positions are specified
+    void setFramebufferSize(glm::vec2 size);
+
+    /**
+     * Queues the \p text to be drawn with the \p font and \p color once #flush is called.
+     * The baseline of the last line of the \p text is placed at the \p position.
+     */
+    void queue(ghoul::fontrendering::Font& font, const glm::vec2& position,
+        const std::string& text, const glm::vec4& color = glm::vec4(1.f));
+
+    /**
+     * Queues the \p text at the \p penPosition like the other #queue method and moves
+     * the \p penPosition below the text if the \p direction is \c CrDirection::Down.
+     */
+    void queue(ghoul::fontrendering::Font& font, glm::vec2& penPosition,
+        const std::string& text, const glm::vec4& color,
+        ghoul::fontrendering::CrDirection direction);
+
+    /// Draws all text that has been queued since the last call into the current
+    /// framebuffer and clears the queue
+    void flush();
+
+    /// Clears the queue without drawing any of the text in it
+    void discard();
+
+    /**
+     * Returns a checksum of the fonts, positions, strings, and colors that have been
+     * queued since the last #flush or #discard. Two identical sequences of calls to
+     * #queue result in the same checksum, which lets the owner of an offscreen
+     * framebuffer detect whether its text has changed without drawing it.
+     */
+    uint64_t checksum() const;
+
+private:
+    struct GlyphMetrics {
+        glm::vec2 bearing = glm::vec2(0.f);
+        glm::vec2 size = glm::vec2(0.f);
+        glm::vec2 texCoordsTopLeft = glm::vec2(0.f);
+        glm::vec2 texCoordsBottomRight = glm::vec2(0.f);
+        float advance = 0.f;
+    };
+
+    struct FontMetrics {
+        ghoul::fontrendering::Font* font = nullptr;
+        ghoul::opengl::TextureAtlas* atlas = nullptr;
+        float height = 0.f;
+        std::unordered_map<wchar_t, GlyphMetrics> glyphs;
+    };
+
+    struct Vertex {
+        GLfloat position[2];
+        GLfloat texCoords[2];
+        GLfloat color[4];
+    };
+
+    FontMetrics& fontMetrics(ghoul::fontrendering::Font& font);
+    const GlyphMetrics* glyphMetrics(FontMetrics& metrics, wchar_t character);
+    void updateChecksum(const void* data, size_t size);
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _program;
+    UniformCache(projection, atlas) _uniformCache;
+
+    GLuint _vao = 0;
+    GLuint _vbo = 0;
+    GLuint _ibo = 0;
+    size_t _vboCapacity = 0;
+    size_t _iboCapacity = 0;
+
+    glm::vec2 _framebufferSize = glm::vec2(0.f);
+
+    std::map<ghoul::fontrendering::Font*, FontMetrics> _fontMetrics;
+
+    /// The quads of all queued text, sorted by the atlas that contains their glyphs
+    std::map<ghoul::opengl::TextureAtlas*, std::vector<Vertex>> _batches;
+    std::vector<GLuint> _indices;
+
+    uint64_t _checksum;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___TEXTBATCHER___H__
@@ -31,7 +31,10 @@
 #include <string>
 
 namespace ghoul::filesystem { class File; }
-namespace ghoul::opengl { class Texture; }
+namespace ghoul::opengl {
+    class ProgramObject;
+    class Texture;
+} // namespace ghoul::opengl
 
 namespace openspace {
 
@@ -47,6 +50,18 @@ public:
 
     void setPath(const std::string& filepath);
     ghoul::opengl::Texture& texture();
+
+    /**
+     * Returns the pre-integrated table of this transfer function, in which the texel
+     * (x, y) is the average of the transfer function between the value x at the front
+     * and the value y at the back of a ray segment. Raycasters that look up the values
+     * of two consecutive samples in this table do not miss features that are narrower
+     * than a step and can therefore use larger steps. The table is computed on the GPU
+     * whenever the transfer function has changed, so this function has to be called
+     * with an active OpenGL context.
+     */
+    ghoul::opengl::Texture& preintegratedTexture();
+
     void bind();
     void update();
     glm::vec4 sample(size_t offset);
@@ -60,11 +75,15 @@ private:
     }
     void setTextureFromImage();
     void uploadTexture();
+    void updatePreintegratedTexture();
 
     std::string _filepath;
     std::unique_ptr<ghoul::filesystem::File> _file;
     std::shared_ptr<ghoul::opengl::Texture> _texture;
     bool _needsUpdate = false;
+    std::unique_ptr<ghoul::opengl::ProgramObject> _preintegrationProgram;
+    std::unique_ptr<ghoul::opengl::Texture> _preintegratedTexture;
+    bool _preintegrationIsDirty = true;
     TfChangedCallback _tfChangedCallback;
 };
 
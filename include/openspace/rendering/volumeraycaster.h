@@ -128,6 +128,22 @@ public:
      * helper file) which should be a prefix to all symbols defined by the helper
      */
     virtual std::string helperPath() const = 0;
+
+    /**
+     * Returns the factor in (0, 1] by which the resolution of the raycasting of this
+     * volume is reduced relative to the framebuffer. The result is upsampled to the full
+     * resolution afterwards.
+     */
+    float downscaleRender() const;
+
+    /**
+     * Sets the factor in (0, 1] by which the resolution of the raycasting of this
+     * volume is reduced relative to the framebuffer.
+     */
+    void setDownscaleRender(float value);
+
+private:
+    float _downscaleRenderConst = 1.f;
 };
 
 } // namespace openspace
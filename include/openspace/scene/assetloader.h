@@ -30,6 +30,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 struct lua_State;
 
@@ -137,6 +138,15 @@ public:
      */
     void callOnDependencyDeinitialize(Asset* asset, Asset* dependant);
 
+    /**
+     * Enable skipping the specification tests for dictionaries that are created while
+     * initializing an asset that has previously been initialized successfully. An asset
+     * counts as unchanged if the hash of its path and file contents is stored in the
+     * file at `path`, which is updated whenever an asset passes initialization with the
+     * tests enabled. Passing an empty `path` disables the skipping
+     */
+    void setValidatedAssetsFile(std::string path);
+
     /**
      * Generate the absolute path for an asset specified as `path`
      * relative to `baseDirectory`
@@ -215,6 +225,11 @@ private:
     std::string _assetRootDirectory;
     ghoul::lua::LuaState* _luaState;
 
+    // Hashes of successfully validated assets and the file they are persisted in
+    std::string _validatedAssetsFile;
+    std::unordered_set<size_t> _validatedAssetHashes;
+    std::unordered_map<Asset*, size_t> _assetHashes;
+
     // State change listeners
     std::vector<AssetListener*> _assetListeners;
 
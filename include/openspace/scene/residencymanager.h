@@ -0,0 +1,80 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___RESIDENCYMANAGER___H__
+#define __OPENSPACE_CORE___RESIDENCYMANAGER___H__
+
+#include <openspace/properties/propertyowner.h>
+
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <ghoul/glm.h>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace {
+
+class SceneGraphNode;
+class Time;
+
+/**
+ * Frees the GPU resources of the Renderable%s that are not needed for a while and
+ * restores them once they are needed again. A node is not needed if its Renderable is
+ * disabled, if its time frame is not active, or if the camera is farther away from it
+ * than a multiple of its bounding sphere. Only Renderable%s that support it (see
+ * Renderable::canReleaseGLResources) are released, and restoring them is spread over
+ * multiple frames.
+ */
+class ResidencyManager : public properties::PropertyOwner {
+public:
+    ResidencyManager();
+
+    /**
+     * Releases the nodes in \p nodes that have not been needed for longer than the
+     * release delay and restores the released nodes that are needed again for the
+     * \p cameraPosition and \p time.
+     */
+    void update(const std::vector<SceneGraphNode*>& nodes,
+        const glm::dvec3& cameraPosition, const Time& time);
+
+    /// Forgets about the \p node, which has to be called before it is destroyed
+    void removeNode(const SceneGraphNode* node);
+
+private:
+    bool isNeeded(const SceneGraphNode& node, const glm::dvec3& cameraPosition,
+        const Time& time) const;
+
+    properties::BoolProperty _enabled;
+    properties::FloatProperty _releaseDelay;
+    properties::FloatProperty _releaseDistance;
+
+    /// The time at which each node that is resident but not needed was last needed
+    std::unordered_map<const SceneGraphNode*, std::chrono::steady_clock::time_point>
+        _unneededSince;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___RESIDENCYMANAGER___H__
@@ -52,6 +52,29 @@ public:
     virtual double scaleValue(const UpdateData& data) const = 0;
     virtual void update(const UpdateData& data);
 
+    // Computes the scale for a future frame on a worker thread while the current frame
+    // is rendered. The following call to update uses this value instead of computing it
+    // again if it is for the same time and no parameters were changed in the meantime.
+    // Must only be called if isThreadSafe returns true
+    void prefetch(const UpdateData& data);
+
+    // Returns whether update(const UpdateData&) can be called on a worker thread while
+    // other scene graph nodes are updated concurrently. The default is false, as, for
+    // example, SPICE and the Lua state are not thread-safe
+    virtual bool isThreadSafe() const;
+
+    // The scale is only recomputed by update if one of the inputs it depends on has
+    // changed. Any change of a property of this scale counts as such, as does a call to
+    // requireUpdate. In addition, the scale depends on the simulation time if this
+    // function returns true, which is the default. Time-independent scales return false
+    // here, so that they are not evaluated again when the time changes
+    virtual bool dependsOnTime() const;
+
+    // Returns whether the scale depends on state other than the simulation time and the
+    // properties, for example on the positions of other scene graph nodes. If so, it is
+    // recomputed every frame. The default is false
+    virtual bool dependsOnExternalState() const;
+
     static documentation::Documentation Documentation();
 
 protected:
@@ -61,6 +84,8 @@ private:
     bool _needsUpdate = true;
     double _cachedTime = -std::numeric_limits<double>::max();
     double _cachedScale = 1.0;
+    double _prefetchedTime = -std::numeric_limits<double>::max();
+    double _prefetchedScale = 1.0;
 };
 
 }  // namespace openspace
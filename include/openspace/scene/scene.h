@@ -27,10 +27,14 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <openspace/scene/residencymanager.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scene/scenelicense.h>
 #include <ghoul/misc/easing.h>
 #include <ghoul/misc/exception.h>
+#include <array>
+#include <chrono>
+#include <deque>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -44,6 +48,7 @@ namespace openspace {
 namespace documentation { struct Documentation; }
 namespace scripting { struct LuaLibrary; }
 
+class DepthPyramid;
 class SceneInitializer;
 
 // Notifications:
@@ -104,9 +109,52 @@ public:
     void update(const UpdateData& data);
 
     /**
-     * Render visible SceneGraphNodes using the provided camera.
+     * Starts computing the transformations of all nodes that can be updated concurrently
+     * for the time in \p data on the worker threads, while the current frame is being
+     * rendered. The #update for that time then uses these results instead of computing
+     * them again; if the time turns out to be different, the results are discarded. The
+     * scene graph must not be modified until #finishTransformPrefetch has been called.
      */
-    void render(const RenderData& data, RendererTasks& tasks);
+    void prefetchTransforms(const UpdateData& data);
+
+    /**
+     * Waits for a transform prefetch that was started with #prefetchTransforms. This is
+     * the hand-off point after which the scene graph may be changed again; prefetches
+     * that have not started yet are dropped.
+     */
+    void finishTransformPrefetch();
+
+    /**
+     * Determines which SceneGraphNodes are potentially visible from the \p camera and
+     * sorts them into lists for each Renderable::RenderBin that are used by the
+     * following calls to #render. A node is culled if the bounding sphere of its
+     * Renderable lies completely outside the view frustum, and entire subtrees are
+     * skipped if the sphere enclosing all of their nodes is outside. Nodes without a
+     * bounding sphere are never culled. If a \p depthPyramid is passed, nodes and
+     * subtrees whose spheres were hidden behind opaque geometry are culled in the same
+     * way. Nodes that would not be rendered anyway, for example because they are outside
+     * of their time frame, are left out of the lists.
+     * The opaque nodes are sorted front-to-back and the transparent nodes back-to-front.
+     * This function has to be called after #update and before #render for every camera
+     * that the scene is rendered with.
+     *
+     * \param camera The camera whose position is used for sorting and whose view frustum
+     *        is used for culling, or \c nullptr to only sort the nodes into the render
+     *        bins in topological order
+     * \param useFrustumCulling If \c false, no nodes are culled
+     * \param depthPyramid The depth of the previous frames that is used for occlusion
+     *        culling, or \c nullptr to only cull the nodes outside of the view frustum
+     */
+    void cull(const Camera* camera, bool useFrustumCulling = true,
+        const DepthPyramid* depthPyramid = nullptr);
+
+    /**
+     * Render visible SceneGraphNodes using the provided camera. If #cull has been called
+     * before and \p useCulling is \c true, only the nodes that have not been culled are
+     * visited. Otherwise all nodes are checked, which is needed when rendering with a
+     * different camera than the one that was used for culling.
+     */
+    void render(const RenderData& data, RendererTasks& tasks, bool useCulling = true);
 
     /**
      * Return the root SceneGraphNode.
@@ -174,6 +222,14 @@ public:
      */
     bool isInitializing() const;
 
+    /**
+     * Calls initializeGL on the nodes that have finished their initialization, until
+     * \p budget has been used up. This is called by #update every frame and can be
+     * called while the loading screen is shown, so that the OpenGL initialization of
+     * the first nodes overlaps with the initialization of the remaining ones.
+     */
+    void initializePendingNodesGL(std::chrono::milliseconds budget);
+
     /**
      * Adds an interpolation request for the passed \p prop that will run for
      * \p durationSeconds seconds. Every time the #updateInterpolations method is called
@@ -251,13 +307,38 @@ private:
 
     void sortTopologically();
 
+    /**
+     * Updates the transformations of all nodes in \p level, distributing the nodes whose
+     * transformations can be updated concurrently over the update thread pool, and then
+     * updates their Renderables on the calling thread.
+     */
+    void updateLevel(const std::vector<SceneGraphNode*>& level, const UpdateData& data);
+
     std::unique_ptr<Camera> _camera;
     std::vector<SceneGraphNode*> _topologicallySortedNodes;
     std::vector<SceneGraphNode*> _circularNodes;
+    // The topologically sorted nodes partitioned into levels, where the parent and all
+    // dependencies of a node are in earlier levels than the node itself
+    std::vector<std::vector<SceneGraphNode*>> _updateLevels;
+    int _nUpdateThreads = 0;
+
+    struct TransformPrefetch;
+    std::shared_ptr<TransformPrefetch> _transformPrefetch;
+
+    // The index of each node in _topologicallySortedNodes
+    std::unordered_map<const SceneGraphNode*, size_t> _nodeIndices;
+    // The radius of the sphere around each node that encloses its entire subtree
+    std::vector<double> _subtreeBoundingSpheres;
+    // The potentially visible nodes for each render bin in drawing order
+    std::array<std::vector<SceneGraphNode*>, 4> _visibleNodes;
+    bool _hasCullingResults = false;
     std::unordered_map<std::string, SceneGraphNode*> _nodesByIdentifier;
     bool _dirtyNodeRegistry = false;
     SceneGraphNode _rootDummy;
     std::unique_ptr<SceneInitializer> _initializer;
+    // Initialized nodes whose initializeGL did not fit into the budget of past frames
+    std::deque<SceneGraphNode*> _pendingGLInitialization;
+    ResidencyManager _residencyManager;
 
     std::vector<InterestingTime> _interestingTimes;
 
@@ -27,6 +27,7 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <openspace/performance/gputimer.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <ghoul/glm.h>
@@ -68,7 +69,8 @@ public:
     BooleanType(UpdateScene);
 
     struct PerformanceRecord {
-        long long renderTime;  // time in ns
+        long long renderTime;  // CPU time in ns
+        long long renderTimeGpu;  // GPU time in ns, reported a few frames late
         long long updateTimeRenderable;  // time in ns
         long long updateTimeTranslation; // time in ns
         long long updateTimeRotation;  // time in ns
@@ -92,11 +94,70 @@ public:
     void deinitialize();
     void deinitializeGL();
 
+    State state() const;
+
+    /**
+     * Frees the GPU resources of the Renderable through
+     * Renderable::releaseGLResources, if it supports that. The node is not rendered
+     * until #restoreGL is called, but its transformation is still updated.
+     */
+    void releaseGL();
+
+    /// Recreates the GPU resources that have been freed by #releaseGL
+    void restoreGL();
+
+    /// Returns \c true if the GPU resources of the Renderable are released
+    bool isGLReleased() const;
+
     void traversePreOrder(const std::function<void(SceneGraphNode*)>& fn);
     void traversePostOrder(const std::function<void(SceneGraphNode*)>& fn);
     void update(const UpdateData& data);
+
+    /**
+     * Updates the translation, rotation, and scale of this node and recomputes the cached
+     * world transformation. If #canUpdateTransformConcurrently returns \c true, this
+     * function can be called on a worker thread while other nodes that do not depend on
+     * this node are updated, provided that the parent and all dependencies of this node
+     * have already been updated.
+     */
+    void updateTransform(const UpdateData& data);
+
+    /**
+     * Updates the Renderable of this node with the world transformation computed in the
+     * last call to #updateTransform. This function must be called on the main thread.
+     */
+    void updateRenderable(const UpdateData& data);
+
+    /**
+     * Returns whether #updateTransform can be called on a worker thread, which is the
+     * case if the Translation, Rotation, and Scale of this node are all thread-safe.
+     */
+    bool canUpdateTransformConcurrently() const;
+
+    /**
+     * Computes the local translation, rotation, and scale of this node for the time of a
+     * future frame, which are picked up by the #updateTransform of that frame. This must
+     * only be called if #canUpdateTransformConcurrently returns \c true and while this
+     * node is not updated on another thread.
+     */
+    void prefetchTransform(const UpdateData& data);
+
     void render(const RenderData& data, RendererTasks& tasks);
 
+    /**
+     * Returns \c true if this node has an initialized Renderable that is visible, ready
+     * and enabled and if this node's time frame contains \p time. These are the checks
+     * that #render performs regardless of the render bin.
+     */
+    bool shouldRender(const Time& time) const;
+
+    /**
+     * Renders the Renderable of this node without checking #shouldRender or the render
+     * bin mask. The Scene uses this for the nodes it has already sorted into the render
+     * bins in Scene::cull.
+     */
+    void renderUnchecked(const RenderData& data, RendererTasks& tasks);
+
     void attachChild(std::unique_ptr<SceneGraphNode> child);
     std::unique_ptr<SceneGraphNode> detachChild(SceneGraphNode& child);
     void clearChildren();
@@ -151,6 +212,7 @@ private:
     double calculateWorldScale() const;
 
     std::atomic<State> _state = State::Loaded;
+    bool _isGLReleased = false;
     std::vector<std::unique_ptr<SceneGraphNode>> _children;
     SceneGraphNode* _parent = nullptr;
     std::vector<SceneGraphNode*> _dependencies;
@@ -161,7 +223,8 @@ private:
     // might be a node that is not very interesting (for example barycenters)
     properties::BoolProperty _guiHidden;
 
-    PerformanceRecord _performanceRecord = { 0, 0, 0, 0, 0 };
+    PerformanceRecord _performanceRecord = { 0, 0, 0, 0, 0, 0 };
+    performance::GpuTimer _renderTimer;
 
     std::unique_ptr<Renderable> _renderable;
 
@@ -182,6 +245,16 @@ private:
     glm::dmat3 _worldRotationCached;
     double _worldScaleCached = 1.0;
 
+    // The local transform and the parent that the cached world transform was computed
+    // from. The version is incremented whenever the world transform changes, which lets
+    // the children detect that their parent moved
+    glm::dvec3 _localPositionCached = glm::dvec3(0.0);
+    glm::dmat3 _localRotationCached = glm::dmat3(1.0);
+    double _localScaleCached = 1.0;
+    const SceneGraphNode* _worldTransformParent = nullptr;
+    uint64_t _parentWorldTransformVersion = 0;
+    uint64_t _worldTransformVersion = 0;
+
     float _fixedBoundingSphere = 0.f;
 
     glm::dmat4 _modelTransformCached;
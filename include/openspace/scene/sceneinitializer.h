@@ -26,6 +26,10 @@
 #define __OPENSPACE_CORE___SCENEINITIALIZER___H__
 
 #include <openspace/util/threadpool.h>
+#include <chrono>
+#include <queue>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -35,10 +39,24 @@ class SceneGraphNode;
 
 class SceneInitializer {
 public:
+    /// The duration of the initialization of nodes, keyed by their identifier
+    using Durations = std::unordered_map<std::string, std::chrono::microseconds>;
+
     virtual ~SceneInitializer() = default;
     virtual void initializeNode(SceneGraphNode* node) = 0;
     virtual std::vector<SceneGraphNode*> takeInitializedNodes() = 0;
     virtual bool isInitializing() const = 0;
+
+    /// Returns how long the initialization of each node that has finished took
+    virtual Durations initializationTimes() const = 0;
+
+    /**
+     * Provides the initialization times that were measured during an earlier start.
+     * Initializers that run multiple nodes at the same time start with the nodes that
+     * are expected to take the longest, so that these do not end up delaying the end of
+     * the initialization. Nodes without an entry are started in the order they arrive.
+     */
+    virtual void setExpectedInitializationTimes(Durations times);
 };
 
 class SingleThreadedSceneInitializer : public SceneInitializer {
@@ -46,9 +64,11 @@ public:
     void initializeNode(SceneGraphNode* node) override;
     std::vector<SceneGraphNode*> takeInitializedNodes() override;
     bool isInitializing() const override;
+    Durations initializationTimes() const override;
 
 private:
     std::vector<SceneGraphNode*> _initializedNodes;
+    Durations _initializationTimes;
 };
 
 class MultiThreadedSceneInitializer : public SceneInitializer {
@@ -58,10 +78,28 @@ public:
     void initializeNode(SceneGraphNode* node) override;
     std::vector<SceneGraphNode*> takeInitializedNodes() override;
     bool isInitializing() const override;
+    Durations initializationTimes() const override;
+    void setExpectedInitializationTimes(Durations times) override;
 
 private:
+    struct PendingNode {
+        std::chrono::microseconds expectedTime;
+        size_t arrival;
+        SceneGraphNode* node;
+
+        /// Returns \c true if this node should be started after \p rhs
+        bool operator<(const PendingNode& rhs) const;
+    };
+
+    /// Initializes the pending node with the longest expected initialization time
+    void initializeNextNode();
+
     std::vector<SceneGraphNode*> _initializedNodes;
     std::unordered_set<SceneGraphNode*> _initializingNodes;
+    std::priority_queue<PendingNode> _pendingNodes;
+    size_t _nArrivedNodes = 0;
+    Durations _expectedTimes;
+    Durations _initializationTimes;
     ThreadPool _threadPool;
     mutable std::mutex _mutex;
 };
@@ -0,0 +1,77 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SCENESNAPSHOT___H__
+#define __OPENSPACE_CORE___SCENESNAPSHOT___H__
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A snapshot records how the scene of an asset was loaded, together with fingerprints of
+ * all files that the scene was created from. When the same asset is loaded again and
+ * none of these files has changed, the snapshot predicts how long each node will take
+ * to initialize, so that the slowest nodes can be started first.
+ */
+class SceneSnapshot {
+public:
+    struct Dependency {
+        std::string path;
+        size_t size = 0;
+        size_t hash = 0;
+    };
+
+    struct Node {
+        std::string identifier;
+        std::chrono::microseconds initializationTime = std::chrono::microseconds(0);
+    };
+
+    /// Returns the location of the snapshot for the asset at \p assetPath
+    static std::string file(const std::string& assetPath);
+
+    /// Returns the fingerprint of the current content of the file at \p path
+    static Dependency dependency(std::string path);
+
+    /**
+     * Reads the snapshot at \p path. Returns \c false if the file does not exist or if
+     * it was written by a different build of OpenSpace.
+     */
+    bool read(const std::string& path);
+
+    /// Writes this snapshot to \p path and returns whether that was successful
+    bool write(const std::string& path) const;
+
+    /// Returns \c true if none of the dependencies has changed since they were recorded
+    bool isCurrent() const;
+
+    std::vector<Dependency> dependencies;
+    std::vector<Node> nodes;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___SCENESNAPSHOT___H__
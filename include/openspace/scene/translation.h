@@ -52,8 +52,32 @@ public:
     glm::dvec3 position() const;
     void update(const UpdateData& data);
 
+    // Computes the position for a future frame on a worker thread while the current frame
+    // is rendered. The following call to update uses this value instead of computing it
+    // again if it is for the same time and no parameters were changed in the meantime.
+    // Must only be called if isThreadSafe returns true
+    void prefetch(const UpdateData& data);
+
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
 
+    // Returns whether position(const UpdateData&) can be called concurrently from
+    // multiple threads, after it has been called once, for example to sample trails in
+    // parallel. This also allows the Scene to update this translation on a worker thread.
+    // The default is false, as, for example, SPICE is not thread-safe
+    virtual bool isThreadSafe() const;
+
+    // The position is only recomputed by update if one of the inputs it depends on has
+    // changed. Any change of a property of this translation counts as such, as does a
+    // call to requireUpdate. In addition, the position depends on the simulation time if
+    // this function returns true, which is the default. Time-independent translations
+    // return false here, so that they are not evaluated again when the time changes
+    virtual bool dependsOnTime() const;
+
+    // Returns whether the position depends on state other than the simulation time and
+    // the properties, for example on the positions of other scene graph nodes. If so, it
+    // is recomputed every frame. The default is false
+    virtual bool dependsOnExternalState() const;
+
     // Registers a callback that gets called when a significant change has been made that
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
@@ -68,6 +92,8 @@ private:
     bool _needsUpdate = true;
     double _cachedTime = -std::numeric_limits<double>::max();
     glm::dvec3 _cachedPosition = glm::dvec3(0.0);
+    double _prefetchedTime = -std::numeric_limits<double>::max();
+    glm::dvec3 _prefetchedPosition = glm::dvec3(0.0);
     std::function<void()> _onParameterChangeCallback;
 };
 
@@ -29,12 +29,16 @@
 #include <openspace/documentation/documentationgenerator.h>
 
 #include <openspace/scripting/lualibrary.h>
+#include <openspace/util/prefixtrie.h>
 #include <ghoul/lua/luastate.h>
 #include <ghoul/misc/boolean.h>
+#include <list>
 #include <mutex>
 #include <queue>
 #include <optional>
 #include <functional>
+#include <string_view>
+#include <unordered_map>
 
 namespace openspace { class SyncBuffer; }
 
@@ -96,6 +100,14 @@ public:
 
     std::vector<std::string> allLuaFunctions() const;
 
+    /**
+     * Returns the completions of \p prefix among the fully qualified names of all Lua
+     * functions, which are the same names that #allLuaFunctions returns. The names are
+     * kept in a PrefixTrie that is updated whenever a library is added or registered.
+     */
+    std::vector<PrefixTrie::Completion> luaFunctionCompletions(
+        std::string_view prefix) const;
+
     std::string generateJson() const override;
 
 private:
@@ -106,11 +118,48 @@ private:
 
     bool isLibraryNameAllowed(lua_State* state, const std::string& name);
 
+    /// Adds the functions and documented script functions of the \p library to the
+    /// #_functionIndex
+    void indexLibraryFunctions(const LuaLibrary& library);
+
     void addBaseLibrary();
     void remapPrintFunction();
 
+    /**
+     * Applies the \p script without going through the Lua VM if it consists of a single
+     * <code>openspace.setPropertyValueSingle</code> call with a literal number, boolean,
+     * or string value for a property URI without wildcards. Returns \c false if the
+     * \p script does not have that form or cannot be applied that way, in which case it
+     * has to be executed normally.
+     */
+    bool applyPropertyAssignment(const std::string& script);
+
+    /**
+     * Executes the \p script in the Lua state. The compiled chunks of the most recently
+     * executed scripts are kept in the registry, so that the many identical scripts that
+     * are sent by the GUI, recordings, and parallel connections are only compiled once.
+     * Returns \c false and logs the error if the \p script fails to compile or to run.
+     */
+    bool runCompiledScript(const std::string& script);
+
+    /// Releases all compiled chunks that are kept for #runCompiledScript
+    void clearCompiledScripts();
+
     ghoul::lua::LuaState _state;
     std::vector<LuaLibrary> _registeredLibraries;
+    /// The fully qualified names of all functions in the #_registeredLibraries
+    PrefixTrie _functionIndex;
+
+    struct CompiledScript {
+        std::string source;
+        /// The reference of the compiled chunk in the Lua registry
+        int reference;
+    };
+    /// The compiled scripts ordered from most to least recently used
+    std::list<CompiledScript> _compiledScripts;
+    /// Maps the source of a compiled script to its entry in _compiledScripts
+    std::unordered_map<std::string_view, std::list<CompiledScript>::iterator>
+        _compiledScriptIndex;
 
     std::queue<QueueItem> _incomingScripts;
 
@@ -103,6 +103,14 @@ public:
      */
 //    std::queue<std::string> progressTo(const std::string& timeStr);
 
+    /**
+     * Progresses the script scheduler to \p newTime and returns the range of scripts
+     * that have to be executed, in order, for passing from the previous time to
+     * \p newTime. The range refers to the storage of the scheduler and remains valid
+     * until the next time scripts are loaded or cleared. Finding the range is
+     * logarithmic in the number of scripts that were passed, so small steps are cheap
+     * and large jumps in either direction do not scan the schedule.
+     */
     using ScriptIt = std::vector<std::string>::const_iterator;
     std::pair<ScriptIt, ScriptIt> progressTo(double newTime);
 
@@ -143,11 +151,14 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    // Sorted by time
     std::vector<double> _timings;
     std::vector<std::string> _forwardScripts;
+    // Stored in reverse order of the timings, so that the scripts passed when moving
+    // backwards in time form a contiguous range as well
     std::vector<std::string> _backwardScripts;
 
-    int _currentIndex = 0;
+    size_t _currentIndex = 0;
     double _currentTime = 0;
     bool _playbackModeEnabled = false;
 
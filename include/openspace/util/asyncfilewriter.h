@@ -0,0 +1,134 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_CORE___ASYNCFILEWRITER___H__
+#define __OPENSPACE_CORE___ASYNCFILEWRITER___H__
+
+#include <openspace/util/lockfreequeue.h>
+#include <ghoul/misc/boolean.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The AsyncFileWriter writes data to a file on a background thread, so that the thread
+ * producing the data never waits for the disk. The data passed to #write is pushed into
+ * a LockFreeQueue that the writer thread drains and flushes to the file at least every
+ * few hundred milliseconds. If the queue is full, the data is written synchronously
+ * instead, so no data is ever lost. #close, which is also called by the destructor,
+ * writes all remaining data before it returns.
+ *
+ * If the writer is created with compression, everything that is written after the
+ * uncompressed header is stored as a sequence of LZ4 blocks, each of which is prefixed
+ * with its uncompressed and its compressed size as \c uint32_t. Such a file can be
+ * restored with #decompress.
+ */
+class AsyncFileWriter {
+public:
+    BooleanType(Compress);
+
+    /**
+     * Opens the file at \p path for writing and writes the \p header to it. The header is
+     * never compressed, so it can be used to identify the file. Whether the file could be
+     * opened can be checked with #isOpen.
+     */
+    AsyncFileWriter(const std::string& path, const std::string& header,
+        Compress compress = Compress::No, size_t capacity = 1024);
+
+    /// Writes all remaining data and closes the file
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /// Returns \c true if the file was opened successfully and has not been closed yet
+    bool isOpen() const;
+
+    /// Queues the \p data to be written to the file. Must not be called after #close
+    void write(std::string data);
+
+    /// Queues the \p size bytes at \p data to be written to the file
+    void write(const char* data, size_t size);
+
+    /**
+     * Returns the number of bytes, including the header, that have been queued so far.
+     * For an uncompressed file, this is the position at which the next data ends up.
+     */
+    uint64_t position() const;
+
+    /// Writes all queued data, closes the file, and stops the writer thread
+    void close();
+
+    /**
+     * Restores the file at \p source, which was written with compression and a header of
+     * \p headerSize bytes, into the file at \p destination.
+     *
+     * \return \c true if the whole file could be restored
+     */
+    static bool decompress(const std::string& source, const std::string& destination,
+        size_t headerSize);
+
+private:
+    /// The main loop of the writer thread
+    void writeQueuedData();
+
+    /// Writes all data of the queue to the file. Must only be called with the
+    /// #_fileMutex locked
+    bool drainQueue();
+
+    /// Writes \p data to the file or, with compression, to the pending block. Must only
+    /// be called with the #_fileMutex locked
+    void writeToFile(const std::string& data);
+
+    /// Compresses the pending block and writes it to the file. Must only be called with
+    /// the #_fileMutex locked
+    void writeBlock();
+
+    std::ofstream _file;
+    LockFreeQueue<std::string> _queue;
+    const bool _compress;
+
+    /// Guards the file between the writer thread, the synchronous fallback of #write,
+    /// and #close
+    std::mutex _fileMutex;
+    std::string _block;
+    std::vector<char> _compressedBlock;
+
+    uint64_t _position = 0;
+
+    std::atomic_bool _isRunning = true;
+    std::mutex _wakeUpMutex;
+    std::condition_variable _wakeUp;
+    std::thread _writer;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___ASYNCFILEWRITER___H__
@@ -0,0 +1,107 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_CORE___ASYNCLOG___H__
+#define __OPENSPACE_CORE___ASYNCLOG___H__
+
+#include <ghoul/logging/log.h>
+
+#include <openspace/util/lockfreequeue.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace openspace {
+
+/**
+ * The AsyncLog is a ghoul::logging::Log that moves the writing of log messages off the
+ * calling thread. Each incoming message (#log) is pushed into a LockFreeQueue that is
+ * drained by a background thread into the wrapped Log, so a burst of warnings in the
+ * middle of a frame does not stall the frame on file I/O. If the queue overflows, the
+ * surplus messages are discarded and their number is reported by the writer thread once
+ * the queue has room again; errors and fatal messages are never discarded but are
+ * written synchronously instead. As the time stamps are created by the wrapped Log, they
+ * denote the time at which a message was written, which trails the time at which it was
+ * logged by at most the writer thread's wake-up interval.
+ *
+ * Flushing the AsyncLog only wakes up the writer thread rather than waiting for it, so
+ * the LogManager's immediate flushing makes messages appear in the wrapped Log as soon as
+ * the writer thread gets to them without stalling the thread that logged them.
+ */
+class AsyncLog : public ghoul::logging::Log {
+public:
+    /**
+     * Creates an AsyncLog that passes all messages on to the \p log. The queue between
+     * the calling threads and the writer thread holds at least \p capacity messages.
+     *
+     * \pre \p log must not be \c nullptr
+     */
+    explicit AsyncLog(std::unique_ptr<ghoul::logging::Log> log, size_t capacity = 4096);
+
+    /// Writes all remaining messages into the wrapped Log before returning
+    ~AsyncLog();
+
+    void log(ghoul::logging::LogLevel level, const std::string& category,
+        const std::string& message) override;
+
+    /// Wakes up the writer thread to write all queued messages and flush the wrapped Log
+    void flush() override;
+
+private:
+    struct Entry {
+        ghoul::logging::LogLevel level = ghoul::logging::LogLevel::Info;
+        std::string category;
+        std::string message;
+    };
+
+    /// The main loop of the writer thread
+    void writeMessages();
+
+    /// Makes the writer thread write the queued messages without waiting for the interval
+    void wakeUpWriter();
+
+    /// Writes all messages that are currently in the queue. Returns whether there were
+    /// any messages. Must only be called with the #_writeMutex locked
+    bool drainQueue();
+
+    std::unique_ptr<ghoul::logging::Log> _log;
+    LockFreeQueue<Entry> _queue;
+    std::atomic<unsigned int> _nDiscarded = 0;
+
+    /// Serializes the access to the wrapped Log between the writer thread and the
+    /// synchronous fallback for messages that cannot be queued
+    std::mutex _writeMutex;
+
+    std::atomic_bool _isRunning = true;
+    std::atomic_bool _isWakeUpRequested = false;
+    std::mutex _wakeUpMutex;
+    std::condition_variable _wakeUp;
+    std::thread _writer;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___ASYNCLOG___H__
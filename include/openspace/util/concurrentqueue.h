@@ -25,22 +25,37 @@
 #ifndef __OPENSPACE_CORE___CONCURRENT_QUEUE___H__
 #define __OPENSPACE_CORE___CONCURRENT_QUEUE___H__
 
+#include <openspace/util/lockfreequeue.h>
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <mutex>
-#include <queue>
 
 namespace openspace {
 
 /**
- * Templated thread-safe queue based on std::thread and std::queue
+ * Templated thread-safe, unbounded FIFO queue. Items are passed through a LockFreeQueue,
+ * so pushing and popping does not take a lock as long as the ring buffer has room. Only
+ * when a burst of pushes overflows the ring buffer are the surplus items parked in a
+ * mutex-guarded list, and only a consumer that has to wait for an item sleeps on a
+ * condition variable.
  */
 template <typename T>
 class ConcurrentQueue {
 public:
+    /// Blocks until an item is available and returns it
     T pop();
 
+    /// Blocks until an item is available and moves it into \p item
     void pop(T& item);
 
+    /**
+     * Moves the oldest item into \p item if there is one. Returns \c false without
+     * blocking if the queue is empty.
+     */
+    bool tryPop(T& item);
+
     void push(const T& item);
 
     void push(T&& item);
@@ -50,9 +65,18 @@ public:
     bool empty() const;
 
 private:
-    std::queue<T> _queue;
+    static constexpr size_t RingCapacity = 1024;
+
+    LockFreeQueue<T> _ring = LockFreeQueue<T>(RingCapacity);
+
+    std::deque<T> _overflow;
+    std::atomic<size_t> _nOverflow = 0;
+
+    // Signed, as a consumer might take an item before its producer got to count it
+    std::atomic<std::ptrdiff_t> _size = 0;
+    std::atomic<int> _nWaiting = 0;
     mutable std::mutex _mutex;
-    mutable std::condition_variable _cond;
+    std::condition_variable _cond;
 };
 
 } // namespace openspace
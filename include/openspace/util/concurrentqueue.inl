@@ -26,48 +26,70 @@ namespace openspace {
 
 template <typename T>
 T ConcurrentQueue<T>::pop() {
-    std::unique_lock<std::mutex> mlock(_mutex);
-    while (_queue.empty()) {
-        _cond.wait(mlock);
-    }
-    auto item = _queue.front();
-    _queue.pop();
+    T item;
+    pop(item);
     return item;
 }
 
 template <typename T>
 void ConcurrentQueue<T>::pop(T& item) {
-    std::unique_lock<std::mutex> mlock(_mutex);
-    while (_queue.empty()) {
-        _cond.wait(mlock);
+    while (!tryPop(item)) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        ++_nWaiting;
+        _cond.wait(lock, [this]() { return _size > 0; });
+        --_nWaiting;
     }
-    item = _queue.front();
-    _queue.pop();
+}
+
+template <typename T>
+bool ConcurrentQueue<T>::tryPop(T& item) {
+    if (_ring.tryPop(item)) {
+        --_size;
+        return true;
+    }
+
+    if (_nOverflow > 0) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_overflow.empty()) {
+            item = std::move(_overflow.front());
+            _overflow.pop_front();
+            --_nOverflow;
+            --_size;
+            return true;
+        }
+    }
+    return false;
 }
 
 template <typename T>
 void ConcurrentQueue<T>::push(const T& item) {
-    std::unique_lock<std::mutex> mlock(_mutex);
-    _queue.push(item);
-    mlock.unlock();
-    _cond.notify_one();
+    T copy = item;
+    push(std::move(copy));
 }
 
 template <typename T>
 void ConcurrentQueue<T>::push(T&& item) {
-    std::unique_lock<std::mutex> mlock(_mutex);
-    _queue.push(std::move(item));
-    mlock.unlock();
-    _cond.notify_one();
+    // As long as older items are waiting in the overflow list, new items have to queue
+    // up behind them to keep the order of items from a single producer
+    if (_nOverflow > 0 || !_ring.tryPush(std::move(item))) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _overflow.push_back(std::move(item));
+        ++_nOverflow;
+    }
+
+    // The counter has to be increased before the waiting consumers are checked, as the
+    // consumers register themselves before looking at the counter
+    ++_size;
+    if (_nWaiting > 0) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cond.notify_one();
+    }
 }
 
 template <typename T>
 size_t ConcurrentQueue<T>::size() const {
-    std::unique_lock<std::mutex> mlock(_mutex);
-    size_t s = _queue.size();
-    mlock.unlock();
-    _cond.notify_one();
-    return s;
+    const std::ptrdiff_t s = _size;
+    return s > 0 ? static_cast<size_t>(s) : 0;
 }
 
 template <typename T>
@@ -75,5 +97,4 @@ bool ConcurrentQueue<T>::empty() const {
     return size() == 0;
 }
 
-
 } // namespace openspace
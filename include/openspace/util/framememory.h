@@ -0,0 +1,84 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___FRAMEMEMORY___H__
+#define __OPENSPACE_CORE___FRAMEMEMORY___H__
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace openspace {
+
+/**
+ * A linear allocator for the temporary containers that are created while updating and
+ * rendering a frame. Allocations only bump a pointer into a single buffer and are never
+ * freed individually; instead, all of them are released at once by #reset at the end of
+ * the frame. Anything that is allocated from the #resource must therefore be destroyed
+ * before the frame ends.
+ *
+ * If a frame needs more memory than the buffer provides, the remainder is allocated from
+ * the heap and the buffer is enlarged on the next #reset, so that the allocations of a
+ * steady workload do not touch the heap at all.
+ *
+ * The FrameMemory is not thread-safe and must only be used from the main thread.
+ */
+class FrameMemory {
+public:
+    explicit FrameMemory(size_t initialCapacity = 1024 * 1024);
+
+    /// Returns the memory resource that the containers of the current frame allocate from
+    std::pmr::memory_resource* resource();
+
+    /**
+     * Releases all allocations of the current frame. This must be called once per frame
+     * after everything that was allocated from the #resource has been destroyed.
+     */
+    void reset();
+
+    /// Returns the size of the buffer in bytes
+    size_t capacity() const;
+
+private:
+    /// Allocates from the heap and records the number of bytes that overflowed the buffer
+    class OverflowResource : public std::pmr::memory_resource {
+    public:
+        size_t nAllocatedBytes = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    std::unique_ptr<std::byte[]> _buffer;
+    size_t _capacity;
+    OverflowResource _overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> _arena;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___FRAMEMEMORY___H__
@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_CORE___HISTOGRAM___H__
 #define __OPENSPACE_CORE___HISTOGRAM___H__
 
+#include <cstddef>
 #include <vector>
 
 namespace openspace {
@@ -33,10 +34,10 @@ class Histogram {
 public:
     Histogram() = default;
     Histogram(float minValue, float maxValue, int numBins, float* data = nullptr);
-    Histogram(Histogram&& other) = default;
+    Histogram(Histogram&& other);
     ~Histogram();
 
-    Histogram& operator=(Histogram&& other) = default;
+    Histogram& operator=(Histogram&& other);
 
     int numBins() const;
     float minValue() const;
@@ -54,6 +55,20 @@ public:
      * @return Returns true if succesful insertion, otherwise return false
      */
     bool add(float value, float repeat = 1.0f);
+
+    /**
+     * Enters all \p nValues \p values into the histogram, each of them once. Values that
+     * are outside of the histogram's range are skipped. The bins are computed in blocks
+     * that the compiler can vectorize, and large inputs are split into partial
+     * histograms on the TaskScheduler that are merged at the end.
+     *
+     * \param values The values to insert into the histogram
+     * \param nValues The number of values pointed to by \p values
+     *
+     * \return The number of values that were inside the range of the histogram
+     */
+    size_t add(const float* values, size_t nValues);
+
     bool add(const Histogram& histogram);
     bool addRectangle(float lowBin, float highBin, float value);
 
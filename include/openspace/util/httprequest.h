@@ -97,6 +97,13 @@ public:
 
     struct RequestOptions {
         int requestTimeoutSeconds; // 0 for no timeout
+        // Number of bytes at the beginning of the resource that are skipped by sending
+        // a ranged request. The request fails if the server ignores the range
+        size_t resumeFromByte = 0;
+        // Number of bytes starting at resumeFromByte that are requested, 0 to request
+        // the rest of the resource. The request fails if the server ignores the range
+        size_t rangeLength = 0;
+        size_t maxBytesPerSecond = 0; // 0 for no limit
     };
 
     HttpRequest(std::string url);
@@ -148,6 +155,9 @@ public:
     bool hasFailed() const;
     bool hasSucceeded() const;
 
+    // Number of bytes that were already present before the download was started
+    virtual size_t resumeOffset() const;
+
 protected:
     virtual size_t handleData(HttpRequest::Data d) = 0;
     virtual bool initDownload() = 0;
@@ -204,13 +214,16 @@ private:
 class HttpFileDownload : public virtual HttpDownload {
 public:
     BooleanType(Overwrite);
+    BooleanType(Resume);
 
     HttpFileDownload() = default;
-    HttpFileDownload(std::string destination, Overwrite = Overwrite::No);
+    HttpFileDownload(std::string destination, Overwrite = Overwrite::No,
+        Resume = Resume::No);
     HttpFileDownload(HttpFileDownload&& d) = default;
     virtual ~HttpFileDownload() = default;
 
     const std::string& destination() const;
+    size_t resumeOffset() const override;
 
 protected:
     bool initDownload() override;
@@ -223,6 +236,8 @@ protected:
 private:
     std::string _destination;
     bool _overwrite;
+    bool _resume = false;
+    size_t _resumeOffset = 0;
     std::ofstream _file;
 
     static const int MaxFilehandles = 35;
@@ -258,7 +273,8 @@ public:
     SyncHttpFileDownload(
         std::string url,
         std::string destinationPath,
-        HttpFileDownload::Overwrite = Overwrite::No
+        HttpFileDownload::Overwrite = Overwrite::No,
+        HttpFileDownload::Resume = Resume::No
     );
     virtual ~SyncHttpFileDownload() = default;
 };
@@ -276,7 +292,8 @@ public:
     AsyncHttpFileDownload(
         std::string url,
         std::string destinationPath,
-        HttpFileDownload::Overwrite = Overwrite::No
+        HttpFileDownload::Overwrite = Overwrite::No,
+        HttpFileDownload::Resume = Resume::No
     );
     virtual ~AsyncHttpFileDownload() = default;
 };
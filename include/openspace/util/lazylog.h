@@ -0,0 +1,65 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_CORE___LAZYLOG___H__
+#define __OPENSPACE_CORE___LAZYLOG___H__
+
+#include <ghoul/logging/logmanager.h>
+
+namespace openspace {
+
+/**
+ * Returns whether a message of the provided \p level would be passed on to the logs by
+ * the LogManager. The check is cheap enough to be used in front of every message whose
+ * construction is expensive, which is what the *_LAZY macros below are doing.
+ */
+inline bool isLogLevelActive(ghoul::logging::LogLevel level) {
+    return ghoul::logging::LogManager::isInitialized() && level >= LogMgr.logLevel();
+}
+
+} // namespace openspace
+
+/**
+ * Logs the message \p __msg__ with the \p __level__ and \p __category__ but only creates
+ * the message if the LogManager is going to pass it on. This makes it possible to put
+ * messages that concatenate strings into loops that run for every scene graph node every
+ * frame without paying for the concatenation when they are filtered out anyway.
+ */
+#define LLAZYC(__level__, __category__, __msg__)                                         \
+    do {                                                                                 \
+        if (openspace::isLogLevelActive(__level__)) {                                    \
+            LogMgr.logMessage(__level__, __category__, __msg__);                         \
+        }                                                                                \
+    } while (false)
+
+// Trace messages are only supported if Ghoul was compiled with them, otherwise the
+// message does not even get compiled into the binary
+#ifdef GHOUL_LOGGING_ENABLE_TRACE
+#define LTRACE_LAZY(__msg__) LLAZYC(ghoul::logging::LogLevel::Trace, _loggerCat, __msg__)
+#else
+#define LTRACE_LAZY(__msg__) do {} while (false)
+#endif // GHOUL_LOGGING_ENABLE_TRACE
+
+#define LDEBUG_LAZY(__msg__) LLAZYC(ghoul::logging::LogLevel::Debug, _loggerCat, __msg__)
+
+#endif // __OPENSPACE_CORE___LAZYLOG___H__
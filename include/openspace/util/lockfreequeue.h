@@ -0,0 +1,92 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___LOCK_FREE_QUEUE___H__
+#define __OPENSPACE_CORE___LOCK_FREE_QUEUE___H__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace openspace {
+
+/**
+ * A bounded multi-producer, multi-consumer queue that never takes a lock. Every slot of
+ * the ring buffer carries a sequence number that tells producers and consumers whether
+ * the slot is free to be written or ready to be read, so that a push or a pop only has
+ * to win a single compare-and-swap on the respective end of the queue. The algorithm is
+ * the one described by Dmitry Vyukov at
+ * http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * The queue does not block; #tryPush fails if the queue is full and #tryPop fails if it
+ * is empty. The ConcurrentQueue builds the blocking and unbounded behavior on top of it.
+ */
+template <typename T>
+class LockFreeQueue {
+public:
+    /**
+     * Creates a queue that can hold at least \p capacity items. The capacity is rounded
+     * up to the next power of two.
+     */
+    explicit LockFreeQueue(size_t capacity);
+    ~LockFreeQueue();
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    /**
+     * Moves the \p item into the queue. If the queue is full, \c false is returned and
+     * the \p item is left untouched.
+     */
+    bool tryPush(T&& item);
+
+    /**
+     * Moves the oldest item of the queue into \p item. If the queue is empty, \c false is
+     * returned and \p item is left untouched.
+     */
+    bool tryPop(T& item);
+
+    size_t capacity() const;
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // Producers and consumers hammer on different ends of the queue, so the two
+    // positions are kept on separate cache lines
+    static constexpr size_t CacheLineSize = 64;
+
+    std::unique_ptr<Cell[]> _cells;
+    size_t _mask;
+    alignas(CacheLineSize) std::atomic<size_t> _enqueuePosition = 0;
+    alignas(CacheLineSize) std::atomic<size_t> _dequeuePosition = 0;
+};
+
+} // namespace openspace
+
+#include "lockfreequeue.inl"
+
+#endif // __OPENSPACE_CORE___LOCK_FREE_QUEUE___H__
@@ -0,0 +1,139 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/assert.h>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace openspace {
+
+template <typename T>
+LockFreeQueue<T>::LockFreeQueue(size_t capacity) {
+    ghoul_assert(capacity > 0, "Capacity must be positive");
+
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    _mask = size - 1;
+
+    _cells = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+LockFreeQueue<T>::~LockFreeQueue() {
+    // No other thread can access the queue anymore, so all items between the two
+    // positions are fully written and only have to be destroyed
+    const size_t end = _enqueuePosition.load(std::memory_order_relaxed);
+    for (size_t i = _dequeuePosition.load(std::memory_order_relaxed); i != end; ++i) {
+        Cell& cell = _cells[i & _mask];
+        reinterpret_cast<T*>(&cell.storage)->~T();
+    }
+}
+
+template <typename T>
+bool LockFreeQueue<T>::tryPush(T&& item) {
+    Cell* cell;
+    size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &_cells[position & _mask];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff =
+            static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (diff == 0) {
+            // The cell is free; try to claim it before another producer does
+            if (_enqueuePosition.compare_exchange_weak(
+                    position,
+                    position + 1,
+                    std::memory_order_relaxed
+                ))
+            {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // The cell still holds an item from the previous lap, so the queue is full
+            return false;
+        }
+        else {
+            // Another producer has claimed the cell in the meantime
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    new (&cell->storage) T(std::move(item));
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool LockFreeQueue<T>::tryPop(T& item) {
+    Cell* cell;
+    size_t position = _dequeuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &_cells[position & _mask];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff =
+            static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+        if (diff == 0) {
+            // The cell is filled; try to claim it before another consumer does
+            if (_dequeuePosition.compare_exchange_weak(
+                    position,
+                    position + 1,
+                    std::memory_order_relaxed
+                ))
+            {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // The producer for this cell has not finished yet, so the queue is empty
+            return false;
+        }
+        else {
+            // Another consumer has claimed the cell in the meantime
+            position = _dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    T* value = reinterpret_cast<T*>(&cell->storage);
+    item = std::move(*value);
+    value->~T();
+    // Mark the cell as free for the producer that comes around on the next lap
+    cell->sequence.store(position + _mask + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+size_t LockFreeQueue<T>::capacity() const {
+    return _mask + 1;
+}
+
+} // namespace openspace
@@ -0,0 +1,142 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___MEMORYBUDGET___H__
+#define __OPENSPACE_CORE___MEMORYBUDGET___H__
+
+#include <openspace/properties/propertyowner.h>
+
+#include <openspace/properties/scalar/intproperty.h>
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace openspace {
+
+/**
+ * The MemoryBudget keeps track of the CPU and GPU memory that the caches of the
+ * different modules use, so that they share common budgets instead of each being tuned
+ * separately. Each cache registers itself as a client with a priority and regularly
+ * reports its usage through #setUsage. A client asks for its #allowance before it grows;
+ * the allowance is the budget minus the usage of all other clients of the same or a
+ * higher priority, so that higher priority clients are served first.
+ *
+ * If the total usage exceeds a budget, #update asks clients to shrink, starting with the
+ * lowest priority and, within a priority, with the largest client, until the excess is
+ * covered. The usage of each client is available as a property.
+ *
+ * All functions except #setUsage and #allowance must be called from the main thread.
+ */
+class MemoryBudget : public properties::PropertyOwner {
+public:
+    enum class Resource {
+        Cpu = 0,
+        Gpu
+    };
+
+    /// Common client priorities. Any other value can be used as well
+    static constexpr const int LowPriority = 0;
+    static constexpr const int NormalPriority = 1;
+    static constexpr const int HighPriority = 2;
+
+    using ClientId = int;
+
+    /**
+     * The callback that asks a client to reduce its usage of the \c resource to at most
+     * \c allowance bytes. It is called from #update on the main thread. The client
+     * should free what it can and report its new usage with #setUsage.
+     */
+    using ShrinkCallback = std::function<void(Resource resource, size_t allowance)>;
+
+    MemoryBudget();
+    ~MemoryBudget();
+
+    /**
+     * Sets the default CPU budget based on the installed main memory. This must be
+     * called after the system capabilities have been detected.
+     */
+    void initialize();
+
+    /**
+     * Registers a new client that reports its memory usage to this MemoryBudget.
+     *
+     * \param name The name of the client, which is used as the identifier of the
+     *        property owner that shows its usage
+     * \param priority The priority of the client, where higher values are served first
+     * \param shrink The function that is called when this client should free memory
+     * \return The identifier that is passed to all other functions for this client
+     */
+    ClientId registerClient(std::string name, int priority, ShrinkCallback shrink);
+
+    /// Removes the client \p id, whose usage is no longer counted
+    void unregisterClient(ClientId id);
+
+    /// Sets the number of bytes of the \p resource that the client \p id is using
+    void setUsage(ClientId id, Resource resource, size_t bytes);
+
+    /**
+     * Returns the number of bytes of the \p resource that the client \p id may use in
+     * total, or \c std::numeric_limits<size_t>::max() if the \p resource has no budget.
+     */
+    size_t allowance(ClientId id, Resource resource) const;
+
+    /// Returns the budget for the \p resource in bytes, or 0 if it is unlimited
+    size_t budget(Resource resource) const;
+
+    /// Returns the total number of bytes of the \p resource used by all clients
+    size_t usage(Resource resource) const;
+
+    /**
+     * Asks the clients to shrink if a budget is exceeded and updates the usage
+     * properties. This is called once per frame.
+     */
+    void update();
+
+private:
+    struct Client {
+        std::string name;
+        int priority = NormalPriority;
+        ShrinkCallback shrink;
+        std::array<size_t, 2> usage = { 0, 0 };
+        std::unique_ptr<properties::PropertyOwner> owner;
+        std::unique_ptr<properties::IntProperty> cpuUsage;
+        std::unique_ptr<properties::IntProperty> gpuUsage;
+    };
+
+    properties::IntProperty _cpuBudget;
+    properties::IntProperty _gpuBudget;
+    properties::IntProperty _cpuUsage;
+    properties::IntProperty _gpuUsage;
+
+    mutable std::mutex _mutex;
+    std::map<ClientId, Client> _clients;
+    ClientId _nextClientId = 1;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___MEMORYBUDGET___H__
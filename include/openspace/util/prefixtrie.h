@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___PREFIXTRIE___H__
+#define __OPENSPACE_CORE___PREFIXTRIE___H__
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A trie of entries that consist of segments with a separator between them, such as the
+ * URIs of properties or the names of Lua functions. Every node of the trie is one
+ * segment, so that the entries that share a parent, for example all properties of one
+ * PropertyOwner, share the nodes of that parent. Entries can be added and removed
+ * incrementally, and completing a prefix only visits the nodes along the prefix and the
+ * children of its last node, independent of the total number of entries.
+ */
+class PrefixTrie {
+public:
+    struct Completion {
+        /// The completed prefix, which ends either at the end of an entry or with the
+        /// separator after a segment that has further entries below it
+        std::string value;
+        /// Is \c true if the #value is an entry and \c false if it ends with a separator
+        bool isEntry;
+    };
+
+    explicit PrefixTrie(char separator = '.');
+
+    /// Adds the \p entry to the trie. Adding an entry that is already present does
+    /// nothing
+    void insert(std::string_view entry);
+
+    /// Removes the \p entry from the trie. Removing an entry that is not present does
+    /// nothing
+    void erase(std::string_view entry);
+
+    bool contains(std::string_view entry) const;
+
+    /// Returns the number of entries in the trie
+    size_t size() const;
+
+    void clear();
+
+    /**
+     * Returns all completions of the \p prefix in lexicographical order. Each completion
+     * continues the \p prefix until either the end of an entry or the next separator, so
+     * that a segment that has many entries below it is only returned once. The
+     * comparison is case-insensitive and the completions use the case of the entries.
+     */
+    std::vector<Completion> completions(std::string_view prefix) const;
+
+private:
+    struct Node {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+        /// The number of entries in this node and all of its children
+        size_t nEntries = 0;
+        /// Is \c true if an entry ends in this node
+        bool isEntry = false;
+    };
+
+    /// Returns the child of the \p node with the \p segment, preferring a child with the
+    /// exact segment over one that only matches when ignoring the case
+    const Node* child(const Node& node, std::string_view segment,
+        std::string* childSegment) const;
+
+    const char _separator;
+    Node _root;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___PREFIXTRIE___H__
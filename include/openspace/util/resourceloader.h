@@ -0,0 +1,146 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_CORE___RESOURCE_LOADER___H__
+#define __OPENSPACE_CORE___RESOURCE_LOADER___H__
+
+#include <openspace/properties/propertyowner.h>
+
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/util/taskscheduler.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace openspace {
+
+/**
+ * The ResourceLoader moves the loading of data that is needed by renderables or other
+ * parts of the engine out of their (blocking) initialization. A loading job consists of
+ * three steps:
+ *   1. A \c decode function that reads and prepares the data on one of the worker
+ *      threads of the engine-wide TaskScheduler. It must not access OpenGL and must not
+ *      reference the object that requested the job, as it might still be running after
+ *      the job was cancelled
+ *   2. An optional \c upload function that is executed on the main thread and transfers
+ *      the decoded data to the GPU. It is called repeatedly, one chunk at a time, until
+ *      it returns \c true. The uploads of all jobs share a per-frame time budget so that
+ *      large datasets are spread over several frames instead of stalling a single one
+ *   3. An optional \c ready function that is executed on the main thread once the
+ *      upload has finished and that usually takes ownership of the decoded data
+ *
+ * Uploads and ready callbacks are executed in #update, which the engine calls once per
+ * frame before the scene is updated. A job can be cancelled through its Handle at any
+ * time; its remaining steps are then skipped. Owners of jobs have to cancel them before
+ * they are destroyed.
+ */
+class ResourceLoader : public properties::PropertyOwner {
+public:
+    /**
+     * A handle to a loading job that is returned by ResourceLoader::load. Copies of a
+     * handle refer to the same job.
+     */
+    class Handle {
+    public:
+        Handle();
+
+        /// Prevents all steps of the job that have not started yet from running
+        void cancel();
+
+        /// Returns \c true if the upload of the job has finished and its ready
+        /// callback has been called
+        bool isFinished() const;
+
+    private:
+        friend class ResourceLoader;
+
+        TaskScheduler::CancellationToken _token;
+        std::shared_ptr<std::atomic<bool>> _isFinished;
+    };
+
+    ResourceLoader();
+
+    /**
+     * Creates a loading job that calls \p decode on a worker thread, then calls
+     * \p upload on the main thread until it returns \c true, and finally calls \p ready
+     * on the main thread. Both \p upload and \p ready receive the value that was
+     * returned by \p decode and may be empty. If \p decode throws an exception, the error
+     * is logged and neither \p upload nor \p ready are called.
+     *
+     * \param decode The function that creates the data on a worker thread
+     * \param upload The function that uploads one chunk of the data and returns whether
+     *        all chunks have been uploaded
+     * \param ready The function that is called once all data has been uploaded
+     * \param priority The priority with which the \p decode function is scheduled
+     * \return The handle with which the job can be cancelled or queried
+     */
+    template <typename T>
+    Handle load(std::function<T()> decode, std::function<bool(T&)> upload,
+        std::function<void(T&)> ready,
+        TaskScheduler::Priority priority = TaskScheduler::Priority::Normal);
+
+    /**
+     * Executes the uploads of all jobs whose data has been decoded, until the upload
+     * budget for this frame is used up, and calls the ready callbacks of the jobs whose
+     * upload has finished. Must be called from the main thread.
+     */
+    void update();
+
+    /**
+     * Drops all jobs that are still waiting to be uploaded and prevents jobs whose
+     * decoding finishes afterwards from being queued.
+     */
+    void deinitialize();
+
+private:
+    struct Job {
+        std::function<bool()> upload;
+        std::function<void()> ready;
+        TaskScheduler::CancellationToken token;
+        std::shared_ptr<std::atomic<bool>> isFinished;
+    };
+
+    void submit(TaskScheduler::Task task, const Handle& handle,
+        TaskScheduler::Priority priority);
+    void enqueue(Job job);
+
+    properties::IntProperty _uploadBudget;
+    properties::IntProperty _nPendingUploads;
+
+    std::atomic<bool> _isRunning = true;
+
+    // Jobs whose decoding has finished, filled from the worker threads
+    std::mutex _decodedMutex;
+    std::deque<Job> _decoded;
+
+    // Jobs that are being uploaded, only accessed from the main thread
+    std::deque<Job> _uploading;
+};
+
+} // namespace openspace
+
+#include "resourceloader.inl"
+
+#endif // __OPENSPACE_CORE___RESOURCE_LOADER___H__
@@ -0,0 +1,65 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <utility>
+
+namespace openspace {
+
+template <typename T>
+ResourceLoader::Handle ResourceLoader::load(std::function<T()> decode,
+                                            std::function<bool(T&)> upload,
+                                            std::function<void(T&)> ready,
+                                            TaskScheduler::Priority priority)
+{
+    Handle handle;
+    submit(
+        [this, decode = std::move(decode), upload = std::move(upload),
+         ready = std::move(ready), handle]() mutable
+        {
+            if (!_isRunning || handle._token.isCancelled()) {
+                return;
+            }
+
+            // The data is shared between the upload and the ready step
+            std::shared_ptr<T> data = std::make_shared<T>(decode());
+
+            Job job;
+            if (upload) {
+                job.upload = [upload = std::move(upload), data]() {
+                    return upload(*data);
+                };
+            }
+            if (ready) {
+                job.ready = [ready = std::move(ready), data]() { ready(*data); };
+            }
+            job.token = handle._token;
+            job.isFinished = handle._isFinished;
+            enqueue(std::move(job));
+        },
+        handle,
+        priority
+    );
+    return handle;
+}
+
+} // namespace openspace
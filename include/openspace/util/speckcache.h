@@ -0,0 +1,78 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SPECKCACHE___H__
+#define __OPENSPACE_CORE___SPECKCACHE___H__
+
+#include <ghoul/glm.h>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace openspace::speckcache {
+
+/**
+ * The contents of a cached speck dataset. The values of all objects are stored after
+ * each other in \c data, with \c nValuesPerObject values per object.
+ */
+struct Dataset {
+    int nValuesPerObject = 0;
+    std::vector<float> data;
+
+    /// The names of the columns, can be empty or contain one name per value of an object
+    std::vector<std::string> columnNames;
+
+    /// The minimum and maximum value of each column. Computed when the file is saved
+    std::vector<glm::vec2> columnRanges;
+
+    /// Additional named integers that the renderable needs to restore its state, for
+    /// example the position of a datavar or a mapping into a color map
+    std::map<std::string, int> metadata;
+};
+
+/**
+ * Saves the \p data, with \p nValuesPerObject values per object, into the cache
+ * \p file. The file starts with a header that describes all columns, using the
+ * optional \p columnNames, and the \p metadata, followed by the data of all objects.
+ * The data is aligned so that the file can be memory mapped and the data used without
+ * any copy.
+ *
+ * \return \c true if the file was written successfully
+ */
+bool saveCachedFile(const std::string& file, const std::vector<float>& data,
+    int nValuesPerObject, const std::vector<std::string>& columnNames = {},
+    const std::map<std::string, int>& metadata = {});
+
+/**
+ * Loads a dataset from the cache \p file that was written by saveCachedFile. If the
+ * file was written with a different version of the format, it is deleted.
+ *
+ * \return The loaded dataset or an empty optional if the file could not be loaded
+ */
+std::optional<Dataset> loadCachedFile(const std::string& file);
+
+} // namespace openspace::speckcache
+
+#endif // __OPENSPACE_CORE___SPECKCACHE___H__
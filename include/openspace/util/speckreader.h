@@ -0,0 +1,56 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SPECKREADER___H__
+#define __OPENSPACE_CORE___SPECKREADER___H__
+
+#include <fstream>
+#include <vector>
+
+namespace openspace::speckreader {
+
+struct DataRows {
+    /// The values of all rows that were kept, \c nValuesPerRow values per row
+    std::vector<float> values;
+
+    /// The number of rows that were skipped because all of their values were zero
+    size_t nNullRows = 0;
+};
+
+/**
+ * Reads all data rows from the current position of \p file until the end of the file.
+ * The first \p nValuesPerRow whitespace separated numbers of each line are read, any
+ * values after that, such as comments or texture references, are ignored. If a line
+ * contains fewer numbers, the remaining values are set to 0. Empty lines are always
+ * skipped, and if \p skipNullRows is \c true, rows in which all values are 0 are skipped
+ * as well.
+ *
+ * The file is read in one go and split into chunks at line boundaries that are parsed in
+ * parallel. The rows are returned in the same order as they appear in the file.
+ */
+DataRows readDataRows(std::ifstream& file, int nValuesPerRow, bool skipNullRows);
+
+} // namespace openspace::speckreader
+
+#endif // __OPENSPACE_CORE___SPECKREADER___H__
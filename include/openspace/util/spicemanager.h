@@ -31,6 +31,7 @@
 #include <array>
 #include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <set>
 
@@ -174,6 +175,23 @@ public:
      */
     KernelHandle loadKernel(std::string filePath);
 
+    /**
+     * Loads all of the provided SPICE kernels in the order in which they are provided,
+     * which has the same effect as calling #loadKernel for each of the \p filePaths. The
+     * coverage of binary CK and SPK kernels is cached on disk, keyed by the path and the
+     * modification date of the kernel, and validated against the kernel's size and
+     * content hash. Reading and validating these caches is done on worker threads while
+     * the kernels are loaded, but all calls into SPICE are done on the calling thread.
+     *
+     * \param filePaths The paths to the kernels that should be loaded
+     * \return The loaded kernels' unique identifiers in the order of \p filePaths
+     *
+     * \throw SpiceException If the loading of any of the kernels failed. The kernels that
+     *        precede the failing kernel remain loaded in that case
+     * \pre Each of the \p filePaths must fulfill the preconditions of #loadKernel
+     */
+    std::vector<KernelHandle> loadKernels(std::vector<std::string> filePaths);
+
     /**
      * Unloads a SPICE kernel identified by the \p kernelId which was returned by the
      * loading call to #loadKernel. The unloading is done by calling the
@@ -220,6 +238,20 @@ public:
      */
     bool hasSpkCoverage(const std::string& target, double et) const;
 
+    /**
+     * Returns the intervals in which the loaded binary SPK kernels cover the \p target,
+     * as they were found by #findSpkCoverage when the kernels were loaded.
+     *
+     * \param target The body to be examined. The target has to name a valid SPICE object
+     *        with respect to the kernels that have been loaded
+     * \return The pairs of start and end ephemeris times of the coverage intervals, or
+     *         an empty list if there is no coverage for the \p target
+     *
+     * \throw SpiceException If \p target does not name a valid SPICE object
+     * \pre \p target must not be empty.
+     */
+    std::vector<std::pair<double, double>> spkCoverage(const std::string& target) const;
+
     /**
      * Returns whether a given \p frame has a CK kernel covering it at the designated
      * \p et ephemeris time.
@@ -542,6 +574,30 @@ public:
         const std::string& observer, const std::string& referenceFrame,
         AberrationCorrection aberrationCorrection, double ephemerisTime) const;
 
+    /**
+     * Returns the positions of all \p targets relative to the same \p observer in the
+     * \p referenceFrame at the same \p ephemerisTime. The result is the same as calling
+     * #targetPosition for each of the \p targets, but the entries are shared with the
+     * position cache, see #clearCache.
+     *
+     * \param targets The target body names or NAIF IDs
+     * \param observer The observing body name or the observing body's NAIF ID
+     * \param referenceFrame The reference frame of the output position vectors
+     * \param aberrationCorrection The aberration correction used for the position
+     *        calculation
+     * \param ephemerisTime The time at which the positions are to be queried
+     * \return The positions of the \p targets in the same order as the \p targets
+     *
+     * \throw SpiceException Under the same conditions as #targetPosition for any of the
+     *        \p targets
+     * \pre None of the \p targets must be empty.
+     * \pre \p observer must not be empty.
+     * \pre \p referenceFrame must not be empty.
+     */
+    std::vector<glm::dvec3> targetPositions(const std::vector<std::string>& targets,
+        const std::string& observer, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection, double ephemerisTime) const;
+
     /**
      * This method returns the transformation matrix that defines the transformation from
      * the reference frame \p from to the reference frame \p to. As both reference frames
@@ -939,6 +995,15 @@ public:
      */
     UseException exceptionHandling() const;
 
+    /**
+     * Removes all results of #targetPosition and #positionTransformMatrix from the cache.
+     * Within a frame, many components request the same position or orientation for the
+     * same ephemeris time, so these are only computed once until the cache is cleared.
+     * The cache is cleared at the beginning of every frame and whenever a kernel is
+     * loaded or unloaded.
+     */
+    void clearCache();
+
     static scripting::LuaLibrary luaLibrary();
 
 private:
@@ -958,35 +1023,41 @@ private:
     /// Default destructor that resets the SPICE settings
     ~SpiceManager();
 
+    /// Map: id, vector of pairs. Pair: Start time, end time
+    using KernelCoverage = std::map<int, std::vector<std::pair<double, double>>>;
+
     /**
-     * Function to find and store the intervals covered by a ck file, this is done
-     * by using mainly the \c ckcov_c and \c ckobj_c functions.
+     * Function to find the intervals covered by a ck file, this is done by using mainly
+     * the \c ckcov_c and \c ckobj_c functions.
      *
      * \param path The path to the kernel that should be examined
-     * \return true if the operation was successful
+     * \return The intervals covered by the kernel for each frame
      *
+     * \throw SpiceException If the coverage could not be determined
      * \pre \p path must be nonempty and be an existing file
-     * \post Coverage times are stored only if loading was successful
      *
      * \sa http://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/cspice/ckobj_c.html
      * \sa http://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/cspice/ckcov_c.html
      */
-    void findCkCoverage(const std::string& path);
+    KernelCoverage findCkCoverage(const std::string& path) const;
 
     /**
-     * Function to find and store the intervals covered by a spk file, this is done
-     * by using mainly the \c spkcov_c and \c spkobj_c functions.
+     * Function to find the intervals covered by a spk file, this is done by using mainly
+     * the \c spkcov_c and \c spkobj_c functions.
      *
      * \param path The path to the kernel that should be examined
-     * \return true if the operation was successful
+     * \return The intervals covered by the kernel for each object
      *
+     * \throw SpiceException If the coverage could not be determined
      * \pre \p path must be nonempty and be an existing file
-     * \post Coverage times are stored only if loading was successful
      *
      * \sa http://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/cspice/spkobj_c.html
      * \sa http://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/cspice/spkcov_c.html
      */
-    void findSpkCoverage(const std::string& path);
+    KernelCoverage findSpkCoverage(const std::string& path) const;
+
+    /// Adds the \p coverage of a ck kernel (\p isCk) or spk kernel to the intervals
+    void storeCoverage(const KernelCoverage& coverage, bool isCk);
 
     /**
      * If a position is requested for an uncovered time in the SPK kernels, this function
@@ -1040,6 +1111,16 @@ private:
     glm::dmat3 getEstimatedTransformMatrix(const std::string& fromFrame,
         const std::string& toFrame, double time) const;
 
+    /// The uncached implementation of #targetPosition
+    glm::dvec3 computeTargetPosition(const std::string& target,
+        const std::string& observer, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection, double ephemerisTime,
+        double& lightTime) const;
+
+    /// The uncached implementation of #positionTransformMatrix
+    glm::dmat3 computePositionTransformMatrix(const std::string& sourceFrame,
+        const std::string& destinationFrame, double ephemerisTime) const;
+
     /// A list of all loaded kernels
     std::vector<KernelInformation> _loadedKernels;
 
@@ -1051,6 +1132,18 @@ private:
     // Vector of pairs: Body, Frame
     std::vector<std::pair<std::string, std::string>> _frameByBody;
 
+    // Tuple: Target, Observer, Reference frame, Aberration type, Aberration direction,
+    // Ephemeris time
+    using PositionCacheKey = std::tuple<
+        std::string, std::string, std::string,
+        AberrationCorrection::Type, AberrationCorrection::Direction, double
+    >;
+    // Pair: Position, Light time
+    mutable std::map<PositionCacheKey, std::pair<glm::dvec3, double>> _positionCache;
+    // Tuple: Source frame, Destination frame, Ephemeris time
+    using TransformCacheKey = std::tuple<std::string, std::string, double>;
+    mutable std::map<TransformCacheKey, glm::dmat3> _transformCache;
+
     /// Stores whether the SpiceManager throws exceptions (Yes) or fails silently (No)
     UseException _useExceptions = UseException::Yes;
 
@@ -27,10 +27,16 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace openspace {
 
+/**
+ * A buffer into which Syncables encode their state. The buffer starts out with the
+ * capacity passed to the constructor and grows geometrically whenever an encoding does
+ * not fit. The memory is kept between frames, so a steady state does not allocate.
+ */
 class SyncBuffer {
 public:
     SyncBuffer(size_t n);
@@ -42,8 +48,17 @@ public:
     template <typename T>
     void encode(const T& v);
 
+    /// Appends the \p size raw bytes at \p data to the encoded bytes
+    void encodeBytes(const char* data, size_t size);
+
     std::string decode();
 
+    /**
+     * Decodes a string without copying it. The returned view points into this buffer
+     * and is only valid until the next call to setData or reset
+     */
+    std::string_view decodeStringView();
+
     template <typename T>
     T decode();
 
@@ -60,7 +75,17 @@ public:
     void setData(std::vector<char> data);
     std::vector<char> data();
 
+    /// Returns the bytes that have been encoded since the last call to reset. The
+    /// pointer is only valid until the next call to encode or reset
+    const char* encodedData() const;
+
+    /// Returns the number of bytes that have been encoded since the last call to reset
+    size_t encodedSize() const;
+
 private:
+    /// Makes sure that \p size more bytes can be encoded, growing the buffer if needed
+    void ensureCapacity(size_t size);
+
     size_t _n;
     size_t _encodeOffset = 0;
     size_t _decodeOffset = 0;
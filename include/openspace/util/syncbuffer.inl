@@ -30,7 +30,7 @@ namespace openspace {
 template <typename T>
 void SyncBuffer::encode(const T& v) {
     const size_t size = sizeof(T);
-    ghoul_assert(_encodeOffset + size < _n, "");
+    ensureCapacity(size);
 
     memcpy(_dataStream.data() + _encodeOffset, &v, size);
     _encodeOffset += size;
@@ -39,7 +39,7 @@ void SyncBuffer::encode(const T& v) {
 template <typename T>
 T SyncBuffer::decode() {
     const size_t size = sizeof(T);
-    ghoul_assert(_decodeOffset + size < _n, "");
+    ghoul_assert(_decodeOffset + size <= _dataStream.size(), "");
     T value;
     memcpy(&value, _dataStream.data() + _decodeOffset, size);
     _decodeOffset += size;
@@ -49,7 +49,7 @@ T SyncBuffer::decode() {
 template <typename T>
 void SyncBuffer::decode(T& value) {
     const size_t size = sizeof(T);
-    ghoul_assert(_decodeOffset + size < _n, "");
+    ghoul_assert(_decodeOffset + size <= _dataStream.size(), "");
     memcpy(&value, _dataStream.data() + _decodeOffset, size);
     _decodeOffset += size;
 }
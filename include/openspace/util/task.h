@@ -27,6 +27,8 @@
 
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 
@@ -46,7 +48,23 @@ public:
         const ghoul::Dictionary& dictionary
     );
 
+    /**
+     * Returns the identifier of this Task that other Tasks can use to refer to it in
+     * their list of dependencies. If no identifier was specified, this is empty.
+     */
+    const std::string& identifier() const;
+
+    /**
+     * Returns the identifiers of all Tasks that have to finish successfully before this
+     * Task can be performed.
+     */
+    const std::vector<std::string>& dependencies() const;
+
     static documentation::Documentation documentation();
+
+private:
+    std::string _identifier;
+    std::vector<std::string> _dependencies;
 };
 
 } // namespace openspace
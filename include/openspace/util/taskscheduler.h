@@ -0,0 +1,199 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TASK_SCHEDULER___H__
+#define __OPENSPACE_CORE___TASK_SCHEDULER___H__
+
+#include <openspace/util/concurrentqueue.h>
+#include <openspace/util/lockfreequeue.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The engine-wide pool of worker threads that all asynchronous work of the engine and
+ * its modules is executed on. Having one shared set of workers, instead of every
+ * subsystem spawning its own threads, keeps the number of threads in line with the
+ * number of cores.
+ *
+ * Each worker owns a LockFreeQueue of tasks; work that is submitted from a worker thread
+ * stays on that worker, and idle workers steal from the queues of their busy siblings.
+ * Tasks are submitted with a Priority: \c High tasks are picked up before any other
+ * work, \c Low tasks only when there is nothing else to do. A task can be tied to a
+ * CancellationToken, in which case it is dropped without being executed if the token was
+ * cancelled before a worker got to it.
+ *
+ * The worker threads are started lazily when the first task is submitted and are joined
+ * in #deinitialize after all remaining tasks have been executed.
+ */
+class TaskScheduler {
+public:
+    enum class Priority {
+        High = 0,
+        Normal,
+        Low
+    };
+
+    /**
+     * A move-only callable that stores the function object it is constructed from inline,
+     * so that queueing a task does not allocate memory. Only functions objects that are
+     * larger than #InlineSize bytes, or that cannot be moved without throwing, are
+     * allocated on the heap instead.
+     */
+    class Task {
+    public:
+        static constexpr size_t InlineSize = 64;
+
+        Task() = default;
+
+        template <typename F, typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, Task>
+        >>
+        Task(F&& function);
+
+        Task(Task&& other) noexcept;
+        Task& operator=(Task&& other) noexcept;
+        ~Task();
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        void operator()();
+
+        explicit operator bool() const;
+
+    private:
+        struct Operations {
+            void (*invoke)(void* storage);
+            void (*move)(void* from, void* to);
+            void (*destroy)(void* storage);
+        };
+
+        template <typename F> struct InlineOperations;
+        template <typename F> struct HeapOperations;
+
+        void reset();
+
+        alignas(std::max_align_t) unsigned char _storage[InlineSize];
+        const Operations* _operations = nullptr;
+    };
+
+    /**
+     * A handle that can be shared between the submitter of tasks and the tasks
+     * themselves. Cancelling the token prevents all tasks that were submitted with it
+     * and have not started yet from being executed, and allows long-running tasks to
+     * check whether they should exit early. Copies of a token refer to the same state.
+     */
+    class CancellationToken {
+    public:
+        CancellationToken();
+
+        void cancel();
+        bool isCancelled() const;
+
+    private:
+        friend class TaskScheduler;
+        std::shared_ptr<std::atomic<bool>> _isCancelled;
+    };
+
+    /**
+     * Creates the scheduler with \p nThreads worker threads. If \p nThreads is 0, one
+     * worker is used for each hardware thread that is not occupied by the main thread.
+     */
+    explicit TaskScheduler(size_t nThreads = 0);
+    ~TaskScheduler();
+
+    /**
+     * Executes the \p task on one of the worker threads. The tasks of each priority are
+     * started in roughly the order in which they were submitted.
+     */
+    void submit(Task task, Priority priority = Priority::Normal);
+
+    /**
+     * Executes the \p task on one of the worker threads, unless the \p token has been
+     * cancelled before a worker thread could start the \p task.
+     */
+    void submit(Task task, const CancellationToken& token,
+        Priority priority = Priority::Normal);
+
+    /**
+     * Executes all tasks that are still queued and joins the worker threads. Submitting a
+     * new task afterwards restarts the workers.
+     */
+    void deinitialize();
+
+    /// Returns the number of worker threads that are used to execute the tasks
+    size_t numberOfThreads() const;
+
+    /// Returns \c true if the calling thread is one of the worker threads
+    bool isWorkerThread() const;
+
+private:
+    struct Entry {
+        Task task;
+        std::shared_ptr<std::atomic<bool>> isCancelled;
+    };
+
+    struct Worker {
+        Worker();
+
+        std::thread thread;
+        LockFreeQueue<Entry> tasks;
+    };
+
+    void submit(Entry entry, Priority priority);
+    void ensureWorkersRunning();
+    void workerLoop(size_t index);
+    bool findTask(size_t index, Entry& entry);
+
+    const size_t _nThreads;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::array<ConcurrentQueue<Entry>, 3> _queues;
+    std::atomic<size_t> _nextWorker = 0;
+
+    std::atomic<bool> _isRunning = false;
+    std::atomic<bool> _shouldStop = false;
+    std::mutex _startMutex;
+
+    // Signed, as a worker might take a task before its submitter got to count it
+    std::atomic<std::ptrdiff_t> _nQueued = 0;
+    std::atomic<int> _nSleeping = 0;
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeUp;
+};
+
+} // namespace openspace
+
+#include "taskscheduler.inl"
+
+#endif // __OPENSPACE_CORE___TASK_SCHEDULER___H__
@@ -0,0 +1,85 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <new>
+#include <utility>
+
+namespace openspace {
+
+template <typename F>
+struct TaskScheduler::Task::InlineOperations {
+    static void invoke(void* storage) {
+        (*static_cast<F*>(storage))();
+    }
+
+    static void move(void* from, void* to) {
+        F* source = static_cast<F*>(from);
+        new (to) F(std::move(*source));
+        source->~F();
+    }
+
+    static void destroy(void* storage) {
+        static_cast<F*>(storage)->~F();
+    }
+
+    static constexpr Operations Table = { &invoke, &move, &destroy };
+};
+
+template <typename F>
+struct TaskScheduler::Task::HeapOperations {
+    static void invoke(void* storage) {
+        (**static_cast<F**>(storage))();
+    }
+
+    static void move(void* from, void* to) {
+        *static_cast<F**>(to) = *static_cast<F**>(from);
+    }
+
+    static void destroy(void* storage) {
+        delete *static_cast<F**>(storage);
+    }
+
+    static constexpr Operations Table = { &invoke, &move, &destroy };
+};
+
+template <typename F, typename>
+TaskScheduler::Task::Task(F&& function) {
+    using Function = std::decay_t<F>;
+
+    constexpr bool FitsInline = sizeof(Function) <= InlineSize &&
+        alignof(Function) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<Function>;
+
+    if constexpr (FitsInline) {
+        new (&_storage) Function(std::forward<F>(function));
+        _operations = &InlineOperations<Function>::Table;
+    }
+    else {
+        *reinterpret_cast<Function**>(&_storage) =
+            new Function(std::forward<F>(function));
+        _operations = &HeapOperations<Function>::Table;
+    }
+}
+
+} // namespace openspace
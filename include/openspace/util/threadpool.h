@@ -25,48 +25,40 @@
 #ifndef __OPENSPACE_CORE___THREAD_POOL___H__
 #define __OPENSPACE_CORE___THREAD_POOL___H__
 
-#include <condition_variable>
-#include <functional>
-#include <mutex>
-#include <queue>
-#include <thread>
-#include <vector>
-
-// Implementation based on http://progsch.net/wordpress/?p=81
+#include <openspace/util/taskscheduler.h>
+#include <memory>
 
 namespace openspace {
 
-class ThreadPool;
-
-class Worker {
-public:
-    Worker(ThreadPool& p);
-    void operator()();
-
-private:
-    ThreadPool& pool;
-};
-
+/**
+ * A queue of tasks that are executed on the engine-wide TaskScheduler, with at most the
+ * given number of tasks running at the same time. The ThreadPool does not own any
+ * threads itself, so creating one is cheap and many pools do not oversubscribe the
+ * cores. Destroying the pool discards the tasks that have not started yet and waits for
+ * the ones that are currently running.
+ */
 class ThreadPool {
 public:
-    ThreadPool(size_t numThreads);
+    ThreadPool(size_t numThreads,
+        TaskScheduler::Priority priority = TaskScheduler::Priority::Normal);
     ThreadPool(const ThreadPool& toCopy);
     ~ThreadPool();
 
-    void enqueue(std::function<void()> f);
+    void enqueue(TaskScheduler::Task task);
     void clearTasks();
 
 private:
-    friend class Worker;
-
-    std::vector<std::thread> workers;
+    struct State;
 
-    std::deque<std::function<void()>> tasks;
+    /// Hands one more task to the scheduler, unless the concurrency limit is reached
+    static void schedule(const std::shared_ptr<State>& state);
 
-    std::mutex queue_mutex;
-    std::condition_variable condition;
+    /// Runs the next queued task on a worker thread of the scheduler
+    static void runNext(const std::shared_ptr<State>& state);
 
-    bool stop;
+    // The tasks handed to the scheduler keep the state alive, as they might only start
+    // after the pool has been destroyed
+    std::shared_ptr<State> _state;
 };
 
 } // namespace openspace
@@ -26,8 +26,9 @@
 #define __OPENSPACE_CORE___TIMELINE___H__
 
 #include <algorithm>
-#include <deque>
 #include <cstddef>
+#include <utility>
+#include <vector>
 
 namespace openspace {
 
@@ -49,7 +50,33 @@ struct Keyframe : public KeyframeBase {
 };
 
 /**
-* Templated class for timelines
+* A view of the consecutive, sorted keyframes of a Timeline. The iterators are pointers,
+* so the view can be used with the algorithms of the standard library. The view is
+* invalidated by any change to the Timeline it was created from.
+*/
+template <typename T>
+class KeyframeSpan {
+public:
+    KeyframeSpan(const Keyframe<T>* begin, const Keyframe<T>* end);
+
+    const Keyframe<T>* begin() const;
+    const Keyframe<T>* end() const;
+    size_t size() const;
+    bool empty() const;
+    const Keyframe<T>& operator[](size_t index) const;
+
+private:
+    const Keyframe<T>* _begin;
+    const Keyframe<T>* _end;
+};
+
+/**
+* Templated class for timelines. The keyframes are stored sorted by their timestamp in
+* contiguous memory, so looking up the keyframes surrounding a timestamp is a binary
+* search. Removing keyframes from the beginning only moves a start offset, and the
+* storage is compacted once more than half of it is unused. The last lookup is
+* remembered, so querying timestamps that increase slowly, which is the common case when
+* playing back keyframes, only has to step forward a few keyframes from there.
 */
 template <typename T>
 class Timeline {
@@ -57,6 +84,15 @@ public:
     virtual ~Timeline() = default;
 
     void addKeyframe(double time, T data);
+
+    /**
+    * Adds all \p keyframes, given as pairs of timestamp and data, at once. This is
+    * considerably faster than adding them one by one if there are many of them, for
+    * example when loading a recording, and is fastest if the \p keyframes are already
+    * sorted and come after the existing ones.
+    */
+    void addKeyframes(std::vector<std::pair<double, T>> keyframes);
+
     void clearKeyframes();
     void removeKeyframe(size_t id);
     void removeKeyframesBefore(double timestamp, bool inclusive = false);
@@ -66,11 +102,27 @@ public:
     size_t nKeyframes() const;
     const Keyframe<T>* firstKeyframeAfter(double timestamp, bool inclusive = false) const;
     const Keyframe<T>* lastKeyframeBefore(double timestamp, bool inclusive = false) const;
-    const std::deque<Keyframe<T>>& keyframes() const;
+    KeyframeSpan<T> keyframes() const;
 
 private:
+    /**
+    * Returns the index of the first keyframe whose timestamp is larger than the
+    * \p timestamp if \p upper is \c true, or larger than or equal to it otherwise.
+    * Starts the search at the result of the previous call.
+    */
+    size_t boundIndex(double timestamp, bool upper) const;
+
+    /// Removes the keyframes with indices in the range [\p begin, \p end)
+    void erase(size_t begin, size_t end);
+
     size_t _nextKeyframeId = 1;
-    std::deque<Keyframe<T>> _keyframes;
+
+    /// All keyframes before _firstKeyframe have been removed but not yet compacted
+    std::vector<Keyframe<T>> _keyframes;
+    size_t _firstKeyframe = 0;
+
+    /// The result of the last call to boundIndex
+    mutable size_t _cursor = 0;
 };
 
 /**
@@ -30,120 +30,192 @@ Keyframe<T>::Keyframe(size_t i, double t, T p)
     , data(p)
 {}
 
+template <typename T>
+KeyframeSpan<T>::KeyframeSpan(const Keyframe<T>* begin, const Keyframe<T>* end)
+    : _begin(begin)
+    , _end(end)
+{}
+
+template <typename T>
+const Keyframe<T>* KeyframeSpan<T>::begin() const {
+    return _begin;
+}
+
+template <typename T>
+const Keyframe<T>* KeyframeSpan<T>::end() const {
+    return _end;
+}
+
+template <typename T>
+size_t KeyframeSpan<T>::size() const {
+    return static_cast<size_t>(_end - _begin);
+}
+
+template <typename T>
+bool KeyframeSpan<T>::empty() const {
+    return _begin == _end;
+}
+
+template <typename T>
+const Keyframe<T>& KeyframeSpan<T>::operator[](size_t index) const {
+    return _begin[index];
+}
+
 template <typename T>
 void Timeline<T>::addKeyframe(double timestamp, T data) {
-    Keyframe<T> keyframe(++_nextKeyframeId, timestamp, data);
+    Keyframe<T> keyframe(++_nextKeyframeId, timestamp, std::move(data));
+
+    // Keyframes are almost always added in order, in which case they are just appended
+    if (_keyframes.size() == _firstKeyframe || _keyframes.back().timestamp <= timestamp)
+    {
+        _keyframes.push_back(std::move(keyframe));
+        return;
+    }
+
     const auto iter = std::upper_bound(
-        _keyframes.cbegin(),
+        _keyframes.cbegin() + _firstKeyframe,
         _keyframes.cend(),
         keyframe,
         &compareKeyframeTimes
     );
-    _keyframes.insert(iter, keyframe);
+    _keyframes.insert(iter, std::move(keyframe));
 }
 
 template <typename T>
-void Timeline<T>::removeKeyframesAfter(double timestamp, bool inclusive) {
-    typename std::deque<Keyframe<T>>::const_iterator iter;
-    if (inclusive) {
-        iter = std::lower_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            timestamp,
-            &compareKeyframeTimeWithTime
-        );
+void Timeline<T>::addKeyframes(std::vector<std::pair<double, T>> keyframes) {
+    if (keyframes.empty()) {
+        return;
     }
-    else {
-        iter = std::upper_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            timestamp,
-            &compareTimeWithKeyframeTime
-        );
+
+    // Get rid of the removed keyframes first, as all keyframes might have to be merged
+    _keyframes.erase(_keyframes.begin(), _keyframes.begin() + _firstKeyframe);
+    _firstKeyframe = 0;
+
+    const size_t nExisting = _keyframes.size();
+    _keyframes.reserve(nExisting + keyframes.size());
+    for (std::pair<double, T>& kf : keyframes) {
+        _keyframes.emplace_back(++_nextKeyframeId, kf.first, std::move(kf.second));
     }
 
-    _keyframes.erase(iter, _keyframes.end());
+    const auto mid = _keyframes.begin() + nExisting;
+    // The sort is stable, so keyframes with the same timestamp keep the order in which
+    // they were passed, the same as when they were added one by one
+    if (!std::is_sorted(mid, _keyframes.end(), &compareKeyframeTimes)) {
+        std::stable_sort(mid, _keyframes.end(), &compareKeyframeTimes);
+    }
+    if (nExisting > 0 && mid->timestamp < (mid - 1)->timestamp) {
+        std::inplace_merge(
+            _keyframes.begin(),
+            mid,
+            _keyframes.end(),
+            &compareKeyframeTimes
+        );
+    }
 }
 
 template <typename T>
-void Timeline<T>::removeKeyframesBefore(double timestamp, bool inclusive) {
-    typename std::deque<Keyframe<T>>::const_iterator iter;
-    if (inclusive) {
-        iter = std::upper_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            timestamp,
-            &compareTimeWithKeyframeTime
-        );
+size_t Timeline<T>::boundIndex(double timestamp, bool upper) const {
+    // The number of keyframes that a lookup steps forward from the result of the
+    // previous lookup before it falls back to a binary search
+    constexpr const size_t MaxCursorSteps = 8;
+
+    // Returns whether the keyframe with index i comes before the bound
+    auto isBefore = [this, timestamp, upper](size_t i) {
+        return upper ?
+            _keyframes[i].timestamp <= timestamp :
+            _keyframes[i].timestamp < timestamp;
+    };
+
+    const size_t end = _keyframes.size();
+    size_t c = std::clamp(_cursor, _firstKeyframe, end);
+
+    size_t first = _firstKeyframe;
+    size_t last = end;
+    if (c > _firstKeyframe && !isBefore(c - 1)) {
+        // The bound is before the previous result
+        last = c;
     }
     else {
-        iter = std::lower_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            timestamp,
-            &compareKeyframeTimeWithTime
-        );
+        for (size_t step = 0; step < MaxCursorSteps && c < end && isBefore(c); ++step) {
+            ++c;
+        }
+        if (c == end || !isBefore(c)) {
+            _cursor = c;
+            return c;
+        }
+        first = c;
     }
 
-    _keyframes.erase(_keyframes.begin(), iter);
+    // Binary search in the remaining range [first, last)
+    while (first < last) {
+        const size_t middle = first + (last - first) / 2;
+        if (isBefore(middle)) {
+            first = middle + 1;
+        }
+        else {
+            last = middle;
+        }
+    }
+    _cursor = first;
+    return first;
 }
 
 template <typename T>
-void Timeline<T>::removeKeyframesBetween(double begin, double end, bool inclusiveBegin,
-                                         bool inclusiveEnd)
-{
-    typename std::deque<Keyframe<T>>::const_iterator beginIter;
-    if (inclusiveBegin) {
-        beginIter = std::lower_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            begin,
-            &compareKeyframeTimeWithTime
-        );
+void Timeline<T>::erase(size_t begin, size_t end) {
+    if (begin >= end) {
+        return;
     }
-    else {
-        beginIter = std::upper_bound(
-            _keyframes.cbegin(),
-            _keyframes.cend(),
-            begin,
-            &compareTimeWithKeyframeTime
-        );
-    }
-
 
-    typename std::deque<Keyframe<T>>::const_iterator endIter;
-    if (inclusiveEnd) {
-        endIter = std::upper_bound(
-            beginIter,
-            _keyframes.cend(),
-            end,
-            &compareTimeWithKeyframeTime
-        );
+    if (end == _keyframes.size() && begin == _firstKeyframe) {
+        _keyframes.clear();
+        _firstKeyframe = 0;
+    }
+    else if (begin == _firstKeyframe) {
+        // Removing from the front only moves the start, until more than half of the
+        // storage is unused
+        _firstKeyframe = end;
+        if (_firstKeyframe > _keyframes.size() / 2) {
+            _keyframes.erase(_keyframes.begin(), _keyframes.begin() + _firstKeyframe);
+            _firstKeyframe = 0;
+        }
     }
     else {
-        endIter = std::lower_bound(
-            beginIter,
-            _keyframes.cend(),
-            end,
-            &compareKeyframeTimeWithTime
-        );
+        _keyframes.erase(_keyframes.begin() + begin, _keyframes.begin() + end);
     }
+}
+
+template <typename T>
+void Timeline<T>::removeKeyframesAfter(double timestamp, bool inclusive) {
+    erase(boundIndex(timestamp, !inclusive), _keyframes.size());
+}
+
+template <typename T>
+void Timeline<T>::removeKeyframesBefore(double timestamp, bool inclusive) {
+    erase(_firstKeyframe, boundIndex(timestamp, inclusive));
+}
 
-    _keyframes.erase(beginIter, endIter);
+template <typename T>
+void Timeline<T>::removeKeyframesBetween(double begin, double end, bool inclusiveBegin,
+                                         bool inclusiveEnd)
+{
+    const size_t beginIndex = boundIndex(begin, !inclusiveBegin);
+    const size_t endIndex = boundIndex(end, inclusiveEnd);
+    erase(beginIndex, std::max(beginIndex, endIndex));
 }
 
 template <typename T>
 void Timeline<T>::clearKeyframes() {
     _keyframes.clear();
+    _firstKeyframe = 0;
 }
 
 template <typename T>
 void Timeline<T>::removeKeyframe(size_t id) {
     _keyframes.erase(
         std::remove_if(
-            _keyframes.begin(),
+            _keyframes.begin() + _firstKeyframe,
             _keyframes.end(),
-            [id] (Keyframe<T> keyframe) { return keyframe.id == id; }
+            [id] (const Keyframe<T>& keyframe) { return keyframe.id == id; }
         ),
         _keyframes.end()
     );
@@ -151,67 +223,33 @@ void Timeline<T>::removeKeyframe(size_t id) {
 
 template <typename T>
 size_t Timeline<T>::nKeyframes() const {
-    return _keyframes.size();
+    return _keyframes.size() - _firstKeyframe;
 }
 
 template <typename T>
 const Keyframe<T>* Timeline<T>::firstKeyframeAfter(double timestamp, bool inclusive) const
 {
-    typename std::deque<Keyframe<T>>::const_iterator it;
-    if (inclusive) {
-        it = std::lower_bound(
-            _keyframes.begin(),
-            _keyframes.end(),
-            timestamp,
-            &compareKeyframeTimeWithTime
-        );
-    }
-    else {
-        it = std::upper_bound(
-            _keyframes.begin(),
-            _keyframes.end(),
-            timestamp,
-            &compareTimeWithKeyframeTime
-        );
-    }
-
-    if (it == _keyframes.end()) {
+    const size_t i = boundIndex(timestamp, !inclusive);
+    if (i == _keyframes.size()) {
         return nullptr;
     }
-    return &(*it);
+    return &_keyframes[i];
 }
 
 template <typename T>
 const Keyframe<T>* Timeline<T>::lastKeyframeBefore(double timestamp, bool inclusive) const
 {
-    typename std::deque<Keyframe<T>>::const_iterator it;
-    if (inclusive) {
-        it = std::upper_bound(
-            _keyframes.begin(),
-            _keyframes.end(),
-            timestamp,
-            &compareTimeWithKeyframeTime
-        );
-    }
-    else {
-        it = std::lower_bound(
-            _keyframes.begin(),
-            _keyframes.end(),
-            timestamp,
-            &compareKeyframeTimeWithTime
-        );
-    }
-
-    if (it == _keyframes.begin()) {
+    const size_t i = boundIndex(timestamp, inclusive);
+    if (i == _firstKeyframe) {
         return nullptr;
     }
-    it--;
-    return &(*it);
+    return &_keyframes[i - 1];
 }
 
 template<typename T>
-const std::deque<Keyframe<T>>& Timeline<T>::keyframes() const {
-    return _keyframes;
+KeyframeSpan<T> Timeline<T>::keyframes() const {
+    const Keyframe<T>* data = _keyframes.data();
+    return KeyframeSpan<T>(data + _firstKeyframe, data + _keyframes.size());
 }
 
 }  // namespace openspace
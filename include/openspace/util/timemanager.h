@@ -29,6 +29,7 @@
 #include <openspace/util/time.h>
 #include <openspace/util/timeline.h>
 #include <functional>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -80,6 +81,14 @@ public:
     double deltaTime() const;
     bool isPaused() const;
 
+    /**
+     * Returns the time that the next call to #preSynchronization with the same \p dt
+     * will advance to, or \c std::nullopt if that cannot be known in advance, for
+     * example because the time is paused, interpolated, or has been set explicitly. The
+     * prediction is exact, so that values computed for the predicted time can be reused.
+     */
+    std::optional<double> predictedTime(double dt) const;
+
     float defaultTimeInterpolationDuration() const;
     float defaultDeltaTimeInterpolationDuration() const;
     float defaultPauseInterpolationDuration() const;
@@ -91,6 +100,7 @@ public:
     void interpolatePause(bool pause, double durationSeconds);
 
     void addKeyframe(double timestamp, TimeKeyframeData kf);
+    void addKeyframes(std::vector<std::pair<double, TimeKeyframeData>> keyframes);
     void removeKeyframesBefore(double timestamp, bool inclusive = false);
     void removeKeyframesAfter(double timestamp, bool inclusive = false);
 
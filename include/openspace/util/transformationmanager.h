@@ -26,9 +26,13 @@
 #define __OPENSPACE_CORE___TRANSFORMATIONMANAGER___H__
 
 #include <ghoul/glm.h>
+#include <glm/gtc/quaternion.hpp>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <tuple>
 
 namespace ccmc { class Kameleon; }
 
@@ -45,19 +49,46 @@ public:
     static TransformationManager& ref();
 
 
+    /**
+     * Returns the transformation matrix from the frame \p from to the frame \p to at
+     * the \p ephemerisTime. The transformations are remembered, as the same frames are
+     * usually requested by many renderables at the same time. This function can be
+     * called from multiple threads.
+     */
     glm::dmat3 frameTransformationMatrix(const std::string& from, const std::string& to,
         double ephemerisTime) const;
 
 private:
+    glm::dmat3 computeFrameTransformationMatrix(const std::string& from,
+        const std::string& to, double ephemerisTime) const;
+
+    /**
+     * Interpolates the Kameleon transformation between the samples that bracket the
+     * \p ephemerisTime. The geophysical frames only change slowly, so the samples are
+     * shared by all requests of the same frames in the sample interval.
+     */
     glm::dmat3 kameleonTransformationMatrix(const std::string& from,
         const std::string& to, double ephemerisTime) const;
 
+    glm::dquat kameleonSample(const std::string& from, const std::string& to,
+        long long sampleIndex) const;
+
+    glm::dmat3 exactKameleonTransformationMatrix(const std::string& from,
+        const std::string& to, double ephemerisTime) const;
+
 //#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
     std::shared_ptr<ccmc::Kameleon> _kameleon;
 //#endif
     std::set<std::string> _kameleonFrames;
     std::set<std::string> _dipoleFrames;
 
+    // Guards the caches and serializes the calls into the global state of Kameleon
+    mutable std::mutex _mutex;
+    mutable std::map<std::tuple<std::string, std::string, double>, glm::dmat3>
+        _transformationCache;
+    mutable std::map<std::tuple<std::string, std::string, long long>, glm::dquat>
+        _kameleonSamples;
+
     static TransformationManager* _instance;
 };
 
@@ -28,10 +28,14 @@
 #include <openspace/util/camera.h>
 #include <openspace/util/powerscaledcoordinate.h>
 #include <openspace/util/time.h>
+#include <functional>
+#include <memory_resource>
+#include <vector>
 
 namespace openspace {
 
 class Deferredcaster;
+class DepthPyramid;
 class VolumeRaycaster;
 
 struct InitializeData {};
@@ -47,6 +51,9 @@ struct UpdateData {
     const Time time;
     const Time previousFrameTime;
     const bool doPerformanceMeasurement;
+    /// Memory for temporary containers that is released at the end of the frame, see
+    /// FrameMemory. This is the heap instead if the nodes are updated on multiple threads
+    std::pmr::memory_resource* frameMemory = std::pmr::get_default_resource();
 };
 
 struct RenderData {
@@ -55,6 +62,12 @@ struct RenderData {
     bool doPerformanceMeasurement;
     int renderBinMask;
     TransformData modelTransform;
+    /// Memory for temporary containers that is released at the end of the frame, see
+    /// FrameMemory
+    std::pmr::memory_resource* frameMemory = std::pmr::get_default_resource();
+    /// The depth of the previous frame that objects can be tested against to skip the
+    /// parts that are hidden, or \c nullptr if occlusion culling is disabled
+    const DepthPyramid* depthPyramid = nullptr;
 };
 
 struct RaycasterTask {
@@ -68,8 +81,20 @@ struct DeferredcasterTask {
 };
 
 struct RendererTasks {
-    std::vector<RaycasterTask> raycasterTasks;
-    std::vector<DeferredcasterTask> deferredcasterTasks;
+    explicit RendererTasks(
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : raycasterTasks(memory)
+        , deferredcasterTasks(memory)
+        , batchedDrawTasks(memory)
+    {}
+
+    std::pmr::vector<RaycasterTask> raycasterTasks;
+    std::pmr::vector<DeferredcasterTask> deferredcasterTasks;
+
+    /// Draw calls that renderables have collected across multiple scene graph nodes,
+    /// for example instanced draws. These are executed after all nodes of the current
+    /// Scene::render call have been rendered
+    std::pmr::vector<std::function<void()>> batchedDrawTasks;
 };
 
 struct RaycastData {
@@ -34,6 +34,10 @@ namespace openspace {
 
 AtmosphereModule::AtmosphereModule() : OpenSpaceModule(Name) {}
 
+MergedAtmosphereDeferredcaster& AtmosphereModule::mergedDeferredcaster() {
+    return _mergedDeferredcaster;
+}
+
 void AtmosphereModule::internalInitialize(const ghoul::Dictionary&) {
     auto fRenderable = FactoryManager::ref().factory<Renderable>();
     ghoul_assert(fRenderable, "No renderable factory existed");
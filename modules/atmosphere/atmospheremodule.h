@@ -27,6 +27,8 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/atmosphere/rendering/mergedatmospheredeferredcaster.h>
+
 namespace openspace {
 
 class AtmosphereModule : public OpenSpaceModule {
@@ -35,8 +37,13 @@ public:
 
     AtmosphereModule();
 
+    /// The deferredcaster that renders all atmospheres in a single pass
+    MergedAtmosphereDeferredcaster& mergedDeferredcaster();
+
 private:
     void internalInitialize(const ghoul::Dictionary&) override;
+
+    MergedAtmosphereDeferredcaster _mergedDeferredcaster;
 };
 
 } // namespace openspace
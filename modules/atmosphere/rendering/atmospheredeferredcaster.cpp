@@ -60,13 +60,14 @@
 #include <modules/atmosphere/rendering/atmospheredeferredcaster.h>
 
 #include <modules/atmosphere/rendering/renderableatmosphere.h>
+#include <openspace/engine/globals.h>
 #include <openspace/util/powerscaledcoordinate.h>
 #include <openspace/util/updatestructures.h>
-#include <openspace/util/spicemanager.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/rendering/renderer.h>
 #include <ghoul/glm.h>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/ghoul_gl.h>
@@ -80,6 +81,7 @@
 #include <glm/gtc/quaternion.hpp>
 #include <sstream>
 #include <fstream>
+#include <limits>
 
 #ifdef WIN32
 #define _USE_MATH_DEFINES
@@ -90,28 +92,15 @@
 namespace {
     constexpr const char* _loggerCat = "AtmosphereDeferredcaster";
 
-    constexpr const std::array<const char*, 17> UniformNames1 = {
-        "cullAtmosphere", "Rg", "Rt", "groundRadianceEmittion", "HR", "betaRayleigh",
-        "HM", "betaMieExtinction", "mieG", "sunRadiance", "ozoneLayerEnabled", "HO",
-        "betaOzoneExtinction", "SAMPLES_R", "SAMPLES_MU", "SAMPLES_MU_S", "SAMPLES_NU"
-    };
-
-    constexpr const std::array<const char*, 10> UniformNames2 = {
-        "dInverseModelTransformMatrix", "dModelTransformMatrix",
-        "dSgctProjectionToModelTransformMatrix", "dSGCTViewToWorldMatrix", "dCamPosObj",
-        "sunDirectionObj", "hardShadows", "transmittanceTexture", "irradianceTexture",
-        "inscatterTexture"
-    };
-
-    constexpr const char* GlslDeferredcastPath =
-        "${MODULES}/atmosphere/shaders/atmosphere_deferred_fs.glsl";
-    constexpr const char* GlslDeferredcastFSPath =
-        "${MODULES}/atmosphere/shaders/atmosphere_deferred_fs.glsl";
-    constexpr const char* GlslDeferredcastVsPath =
-        "${MODULES}/atmosphere/shaders/atmosphere_deferred_vs.glsl";
-
     constexpr const float ATM_EPS = 2.f;
     constexpr const float KM_TO_M = 1000.f;
+
+    // Atmospheres with a smaller radius on the screen (in pixels) are culled
+    constexpr const double MinScreenSpaceRadius = 2.0;
+
+    // Has to be increased whenever the precalculation shaders change the contents of
+    // the transmittance, irradiance, or inscattering textures
+    constexpr const int8_t CurrentCacheVersion = 1;
 } // namespace
 
 namespace openspace {
@@ -195,284 +184,143 @@ void AtmosphereDeferredcaster::deinitialize() {
     glDeleteTextures(1, &_atmosphereTexture);
 }
 
-void AtmosphereDeferredcaster::preRaycast(const RenderData& renderData,
-                                          const DeferredcastData&,
-                                          ghoul::opengl::ProgramObject& program)
+AtmosphereData AtmosphereDeferredcaster::atmosphereData(
+                                                            const RenderData& renderData,
+                                       const ShadowCasterTable& shadowCasters) const
 {
-    // Atmosphere Frustum Culling
-    glm::dvec3 tPlanetPosWorld = glm::dvec3(
-        _modelTransform * glm::dvec4(0.0, 0.0, 0.0, 1.0)
+    AtmosphereData data = {};
+    data.screenSpaceBounds = screenSpaceBounds(renderData);
+    data.radii = glm::vec4(
+        _atmospherePlanetRadius,
+        _atmosphereRadius,
+        _planetGroundRadianceEmittion,
+        _sunRadianceIntensity
     );
-
-    const double distance = glm::distance(
-        tPlanetPosWorld,
-        renderData.camera.eyePositionVec3()
+    data.rayleigh = glm::vec4(_rayleighScatteringCoeff, _rayleighHeightScale);
+    data.mie = glm::vec4(_mieExtinctionCoeff, _mieHeightScale);
+    data.ozone = glm::vec4(_ozoneExtinctionCoeff, _ozoneHeightScale);
+    data.flags = glm::vec4(
+        _miePhaseConstant,
+        _ozoneEnabled ? 1.f : 0.f,
+        _hardShadowsEnabled ? 1.f : 0.f,
+        0.f
     );
+    data.samples = glm::ivec4(_r_samples, _mu_samples, _mu_s_samples, _nu_samples);
 
-    // Radius is in KM
-    const double scaledRadius = glm::length(
-        glm::dmat3(_modelTransform) * glm::dvec3(1000.0 * _atmosphereRadius, 0.0, 0.0)
+    // Object Space
+    glm::dmat4 inverseModelMatrix = glm::inverse(_modelTransform);
+    data.inverseModelTransform = inverseModelMatrix;
+    data.modelTransform = _modelTransform;
+
+    glm::dmat4 dSGCTViewToWorldMatrix = glm::inverse(
+        renderData.camera.combinedViewMatrix()
     );
 
-    if (distance > scaledRadius * DISTANCE_CULLING_RADII) {
-        program.setUniform(_uniformCache.cullAtmosphere, 1);
-    }
-    else {
-        glm::dmat4 MV = glm::dmat4(
-            renderData.camera.sgctInternal.projectionMatrix()
-        ) * renderData.camera.combinedViewMatrix();
-
-        if (!isAtmosphereInFrustum(
-            MV,
-            tPlanetPosWorld,
-            (_atmosphereRadius + ATM_EPS)*KM_TO_M)
-            )
-        {
-            program.setUniform(_uniformCache.cullAtmosphere, 1);
-        }
-        else {
-            program.setUniform(_uniformCache.cullAtmosphere, 0);
-            program.setUniform(_uniformCache.Rg, _atmospherePlanetRadius);
-            program.setUniform(_uniformCache.Rt, _atmosphereRadius);
-            program.setUniform(
-                _uniformCache.groundRadianceEmittion,
-                _planetGroundRadianceEmittion
-            );
-            program.setUniform(_uniformCache.HR, _rayleighHeightScale);
-            program.setUniform(_uniformCache.betaRayleigh, _rayleighScatteringCoeff);
-            program.setUniform(_uniformCache.HM, _mieHeightScale);
-            program.setUniform(_uniformCache.betaMieExtinction, _mieExtinctionCoeff);
-            program.setUniform(_uniformCache.mieG, _miePhaseConstant);
-            program.setUniform(_uniformCache.sunRadiance, _sunRadianceIntensity);
-            program.setUniform(_uniformCache.ozoneLayerEnabled, _ozoneEnabled);
-            program.setUniform(_uniformCache.HO, _ozoneHeightScale);
-            program.setUniform(_uniformCache.betaOzoneExtinction, _ozoneExtinctionCoeff);
-            program.setUniform(_uniformCache.SAMPLES_R, _r_samples);
-            program.setUniform(_uniformCache.SAMPLES_MU, _mu_samples);
-            program.setUniform(_uniformCache.SAMPLES_MU_S, _mu_s_samples);
-            program.setUniform(_uniformCache.SAMPLES_NU, _nu_samples);
-
-            // Object Space
-            glm::dmat4 inverseModelMatrix = glm::inverse(_modelTransform);
-            program.setUniform(
-                _uniformCache2.dInverseModelTransformMatrix,
-                inverseModelMatrix
-            );
-            program.setUniform(_uniformCache2.dModelTransformMatrix, _modelTransform);
+    // SGCT Projection to SGCT Eye Space
+    glm::dmat4 dInverseProjection = glm::inverse(
+        glm::dmat4(renderData.camera.projectionMatrix()));
 
-            // Eye Space in SGCT to Eye Space in OS (SGCT View to OS Camera Rig)
-            glm::dmat4 dSgctEye2OSEye = glm::inverse(
-                glm::dmat4(renderData.camera.viewMatrix()));
+    data.projectionToModelTransform =
+        inverseModelMatrix *
+        dSGCTViewToWorldMatrix *
+        dInverseProjection;
 
-            glm::dmat4 dSGCTViewToWorldMatrix = glm::inverse(
-                renderData.camera.combinedViewMatrix()
-            );
+    data.cameraPosition = inverseModelMatrix *
+                          glm::dvec4(renderData.camera.eyePositionVec3(), 1.0);
 
-            // Eye Space in SGCT to OS World Space
-            program.setUniform(_uniformCache2.dSGCTViewToWorldMatrix,
-                dSGCTViewToWorldMatrix);
-
-            // SGCT Projection to SGCT Eye Space
-            glm::dmat4 dInverseProjection = glm::inverse(
-                glm::dmat4(renderData.camera.projectionMatrix()));
-
-            glm::dmat4 inverseWholeMatrixPipeline =
-                inverseModelMatrix *
-                dSGCTViewToWorldMatrix *
-                dInverseProjection;
-
-            program.setUniform(_uniformCache2.dSgctProjectionToModelTransformMatrix,
-                inverseWholeMatrixPipeline);
-
-            glm::dvec4 camPosObjCoords = inverseModelMatrix *
-                                     glm::dvec4(renderData.camera.eyePositionVec3(), 1.0);
-            program.setUniform(_uniformCache2.dCamPosObj, camPosObjCoords);
-
-            double lt;
-            glm::dvec3 sunPosWorld = SpiceManager::ref().targetPosition(
-                "SUN",
-                "SUN",
-                "GALACTIC",
-                {},
-                _time,
-                lt
-            );
-            glm::dvec4 sunPosObj = glm::dvec4(0.0);
+    const glm::dvec3 sunPosWorld = shadowCasters.at("SUN");
+    glm::dvec4 sunPosObj = glm::dvec4(0.0);
 
-            // Sun following camera position
-            if (_sunFollowingCameraEnabled) {
-                sunPosObj = inverseModelMatrix * glm::dvec4(
-                    renderData.camera.eyePositionVec3(),
-                    1.0
-                );
-            }
-            else {
-                sunPosObj = inverseModelMatrix *
-                    glm::dvec4(sunPosWorld - renderData.modelTransform.translation, 1.0);
-            }
+    // Sun following camera position
+    if (_sunFollowingCameraEnabled) {
+        sunPosObj = inverseModelMatrix * glm::dvec4(
+            renderData.camera.eyePositionVec3(),
+            1.0
+        );
+    }
+    else {
+        sunPosObj = inverseModelMatrix *
+            glm::dvec4(sunPosWorld - renderData.modelTransform.translation, 1.0);
+    }
 
-            // Sun Position in Object Space
-            program.setUniform(
-                _uniformCache2.sunDirectionObj,
-                glm::normalize(glm::dvec3(sunPosObj))
-            );
+    // Sun Position in Object Space
+    data.sunDirection = glm::dvec4(glm::normalize(glm::dvec3(sunPosObj)), 0.0);
+
+    // Shadow calculations. The deferred pass only supports a single shadow caster
+    if (!_shadowConfArray.empty()) {
+        const ShadowConfiguration& shadowConf = _shadowConfArray.front();
+
+        // TO REMEMBER: all distances and lengths in world coordinates are in
+        // meters!!! We need to move this to view space...
+        const glm::dvec3 sourcePos = shadowCasters.at(shadowConf.source.first);
+        const glm::dvec3 casterPos = shadowCasters.at(shadowConf.caster.first);
+
+        // First we determine if the caster is shadowing the current planet
+        // (all calculations in World Coordinates):
+        glm::dvec3 planetCasterVec = casterPos - renderData.modelTransform.translation;
+        glm::dvec3 sourceCasterVec = casterPos - sourcePos;
+        double sc_length = glm::length(sourceCasterVec);
+        glm::dvec3 planetCaster_proj = (
+            glm::dot(planetCasterVec, sourceCasterVec) /
+            (sc_length*sc_length)) * sourceCasterVec;
+        double d_test = glm::length(planetCasterVec - planetCaster_proj);
+        double xp_test = shadowConf.caster.second *
+            sc_length / (shadowConf.source.second + shadowConf.caster.second);
+        double rp_test = shadowConf.caster.second *
+            (glm::length(planetCaster_proj) + xp_test) / xp_test;
+
+        double casterDistSun = glm::length(casterPos - sunPosWorld);
+        double planetDistSun = glm::length(
+            renderData.modelTransform.translation - sunPosWorld
+        );
 
-            // Shadow calculations..
-            if (!_shadowConfArray.empty()) {
-                std::vector<ShadowRenderingStruct> shadowDataArray;
-                shadowDataArray.reserve(_shadowConfArray.size());
-
-                for (const ShadowConfiguration & shadowConf : _shadowConfArray) {
-                    // TO REMEMBER: all distances and lengths in world coordinates are in
-                    // meters!!! We need to move this to view space...
-                    // Getting source and caster:
-                    glm::dvec3 sourcePos = SpiceManager::ref().targetPosition(
-                        shadowConf.source.first,
-                        "SUN", "GALACTIC",
-                        {},
-                        _time,
-                        lt
-                    );
-                    sourcePos *= KM_TO_M; // converting to meters
-                    glm::dvec3 casterPos = SpiceManager::ref().targetPosition(
-                        shadowConf.caster.first,
-                        "SUN", "GALACTIC",
-                        {},
-                        _time,
-                        lt
-                    );
-                    casterPos *= KM_TO_M; // converting to meters
-
-                    // First we determine if the caster is shadowing the current planet
-                    // (all calculations in World Coordinates):
-                    glm::dvec3 planetCasterVec =
-                        casterPos - renderData.modelTransform.translation;
-                    glm::dvec3 sourceCasterVec = casterPos - sourcePos;
-                    double sc_length = glm::length(sourceCasterVec);
-                    glm::dvec3 planetCaster_proj = (
-                        glm::dot(planetCasterVec, sourceCasterVec) /
-                        (sc_length*sc_length)) * sourceCasterVec;
-                    double d_test = glm::length(planetCasterVec - planetCaster_proj);
-                    double xp_test = shadowConf.caster.second *
-                        sc_length / (shadowConf.source.second + shadowConf.caster.second);
-                    double rp_test = shadowConf.caster.second *
-                        (glm::length(planetCaster_proj) + xp_test) / xp_test;
-
-                    double casterDistSun = glm::length(casterPos - sunPosWorld);
-                    double planetDistSun = glm::length(
-                        renderData.modelTransform.translation - sunPosWorld
-                    );
-
-                    ShadowRenderingStruct shadowData;
-                    shadowData.isShadowing = false;
-
-                    if (((d_test - rp_test) < (_atmospherePlanetRadius * KM_TO_M)) &&
-                    //if (((d_test - rp_test) < (_atmosphereRadius * KM_TO_M)) &&
-                        (casterDistSun < planetDistSun)) {
-                        // The current caster is shadowing the current planet
-                        shadowData.isShadowing = true;
-                        shadowData.rs = shadowConf.source.second;
-                        shadowData.rc = shadowConf.caster.second;
-                        shadowData.sourceCasterVec = glm::normalize(sourceCasterVec);
-                        shadowData.xp = xp_test;
-                        shadowData.xu = shadowData.rc * sc_length /
-                                        (shadowData.rs - shadowData.rc);
-                        shadowData.casterPositionVec = casterPos;
-                    }
-                    shadowDataArray.push_back(shadowData);
-                }
-
-                const std::string uniformVarName("shadowDataArray[");
-                unsigned int counter = 0;
-                for (const ShadowRenderingStruct & sd : shadowDataArray) {
-                    std::stringstream ss;
-                    ss << uniformVarName << counter << "].isShadowing";
-                    program.setUniform(ss.str(), sd.isShadowing);
-                    if (sd.isShadowing) {
-                        ss.str(std::string());
-                        ss << uniformVarName << counter << "].xp";
-                        program.setUniform(ss.str(), sd.xp);
-                        ss.str(std::string());
-                        ss << uniformVarName << counter << "].xu";
-                        program.setUniform(ss.str(), sd.xu);
-                        // ss.str(std::string());
-                        // ss << uniformVarName << counter << "].rs";
-                        // program.setUniform(ss.str(), sd.rs);
-                        ss.str(std::string());
-                        ss << uniformVarName << counter << "].rc";
-                        program.setUniform(ss.str(), sd.rc);
-                        ss.str(std::string());
-                        ss << uniformVarName << counter << "].sourceCasterVec";
-                        program.setUniform(ss.str(), sd.sourceCasterVec);
-                        ss.str(std::string());
-                        ss << uniformVarName << counter << "].casterPositionVec";
-                        program.setUniform(ss.str(), sd.casterPositionVec);
-                    }
-                    counter++;
-                }
-                program.setUniform(_uniformCache2.hardShadows, _hardShadowsEnabled);
-            }
+        if (((d_test - rp_test) < (_atmospherePlanetRadius * KM_TO_M)) &&
+            (casterDistSun < planetDistSun))
+        {
+            // The current caster is shadowing the current planet
+            const double rs = shadowConf.source.second;
+            const double rc = shadowConf.caster.second;
+            data.shadowParameters = glm::dvec4(
+                rc * sc_length / (rs - rc),
+                xp_test,
+                rc,
+                1.0
+            );
+            data.shadowSourceCasterDirection = glm::dvec4(
+                glm::normalize(sourceCasterVec),
+                0.0
+            );
+            data.shadowCasterPosition = glm::dvec4(casterPos, 1.0);
         }
     }
-    _transmittanceTableTextureUnit.activate();
-    glBindTexture(GL_TEXTURE_2D, _transmittanceTableTexture);
-    program.setUniform(
-        _uniformCache2.transmittanceTexture,
-        _transmittanceTableTextureUnit
-    );
-
-    _irradianceTableTextureUnit.activate();
-    glBindTexture(GL_TEXTURE_2D, _irradianceTableTexture);
-    program.setUniform(_uniformCache2.irradianceTexture, _irradianceTableTextureUnit);
 
-    _inScatteringTableTextureUnit.activate();
-    glBindTexture(GL_TEXTURE_3D, _inScatteringTableTexture);
-    program.setUniform(_uniformCache2.inscatterTexture, _inScatteringTableTextureUnit);
-}
-
-void AtmosphereDeferredcaster::postRaycast(const RenderData&,
-                                           const DeferredcastData&,
-                                           ghoul::opengl::ProgramObject&)
-{
-    // Deactivate the texture units
-    _transmittanceTableTextureUnit.deactivate();
-    _irradianceTableTextureUnit.deactivate();
-    _inScatteringTableTextureUnit.deactivate();
+    return data;
 }
 
-std::string AtmosphereDeferredcaster::deferredcastPath() const {
-    return GlslDeferredcastPath;
+void AtmosphereDeferredcaster::addShadowCasters(ShadowCasterTable& shadowCasters) const {
+    shadowCasters.emplace("SUN", glm::dvec3(0.0));
+    if (!_shadowConfArray.empty()) {
+        shadowCasters.emplace(_shadowConfArray.front().source.first, glm::dvec3(0.0));
+        shadowCasters.emplace(_shadowConfArray.front().caster.first, glm::dvec3(0.0));
+    }
 }
 
-std::string AtmosphereDeferredcaster::deferredcastFSPath() const {
-    return GlslDeferredcastFSPath;
+GLuint AtmosphereDeferredcaster::transmittanceTableTexture() const {
+    return _transmittanceTableTexture;
 }
 
-std::string AtmosphereDeferredcaster::deferredcastVSPath() const {
-    return GlslDeferredcastVsPath;
+GLuint AtmosphereDeferredcaster::irradianceTableTexture() const {
+    return _irradianceTableTexture;
 }
 
-std::string AtmosphereDeferredcaster::helperPath() const {
-    return ""; // no helper file
+GLuint AtmosphereDeferredcaster::inScatteringTableTexture() const {
+    return _inScatteringTableTexture;
 }
 
-void AtmosphereDeferredcaster::initializeCachedVariables(
-                                                    ghoul::opengl::ProgramObject& program)
-{
-    ghoul::opengl::updateUniformLocations(program, _uniformCache, UniformNames1);
-    ghoul::opengl::updateUniformLocations(program, _uniformCache2, UniformNames2);
-}
-
-void AtmosphereDeferredcaster::update(const UpdateData&) {}
-
 void AtmosphereDeferredcaster::setModelTransform(const glm::dmat4& transform) {
     _modelTransform = transform;
 }
 
-void AtmosphereDeferredcaster::setTime(double time) {
-    _time = time;
-}
-
 void AtmosphereDeferredcaster::setAtmosphereRadius(float atmRadius) {
     _atmosphereRadius = atmRadius;
 }
@@ -1210,14 +1058,34 @@ void AtmosphereDeferredcaster::executeCalculations(GLuint quadCalcVAO,
 
 void AtmosphereDeferredcaster::preCalculateAtmosphereParam() {
     //==========================================================
-    //========= Load Shader Programs for Calculations ==========
+    //============ Create Textures for Calculations ============
     //==========================================================
-    loadComputationPrograms();
+    createComputationTextures();
+
+    // The cache file name is derived from all parameters that affect the textures, so
+    // changing any of them leads to a different file
+    const std::string cacheFile = FileSys.cacheManager()->cachedFilename(
+        "atmosphere",
+        cacheInformation(),
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+    // The calculations always have to run if the intermediate textures are requested
+    if (!_saveCalculationTextures && FileSys.fileExists(cacheFile)) {
+        if (loadCachedTextures(cacheFile)) {
+            LDEBUG(fmt::format(
+                "Loaded precalculated atmosphere textures from '{}'", cacheFile
+            ));
+            deleteUnusedComputationTextures();
+            return;
+        }
+        LINFO(fmt::format("Removing invalid atmosphere cache file '{}'", cacheFile));
+        FileSys.deleteFile(cacheFile);
+    }
 
     //==========================================================
-    //============ Create Textures for Calculations ============
+    //========= Load Shader Programs for Calculations ==========
     //==========================================================
-    createComputationTextures();
+    loadComputationPrograms();
 
     // Saves current FBO first
     GLint defaultFBO;
@@ -1246,6 +1114,8 @@ void AtmosphereDeferredcaster::preCalculateAtmosphereParam() {
     //==========================================================
     executeCalculations(quadCalcVAO, drawBuffers, 6);
 
+    saveCachedTextures(cacheFile);
+
     deleteUnusedComputationTextures();
 
     // Restores system state
@@ -1263,6 +1133,122 @@ void AtmosphereDeferredcaster::preCalculateAtmosphereParam() {
     LDEBUG("Ended precalculations for Atmosphere effects...");
 }
 
+std::string AtmosphereDeferredcaster::cacheInformation() const {
+    return fmt::format(
+        "{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|"
+        "{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}",
+        static_cast<int>(CurrentCacheVersion),
+        _atmospherePlanetRadius, _atmosphereRadius, _planetAverageGroundReflectance,
+        _planetGroundRadianceEmittion, _rayleighHeightScale,
+        _rayleighScatteringCoeff.x, _rayleighScatteringCoeff.y,
+        _rayleighScatteringCoeff.z, _ozoneEnabled, _ozoneHeightScale,
+        _ozoneExtinctionCoeff.x, _ozoneExtinctionCoeff.y, _ozoneExtinctionCoeff.z,
+        _mieHeightScale, _mieScatteringCoeff.x, _mieScatteringCoeff.y,
+        _mieScatteringCoeff.z, _mieExtinctionCoeff.x, _mieExtinctionCoeff.y,
+        _mieExtinctionCoeff.z, _miePhaseConstant, _sunRadianceIntensity,
+        _transmittance_table_width, _transmittance_table_height,
+        _irradiance_table_width, _irradiance_table_height, _delta_e_table_width,
+        _delta_e_table_height, _r_samples, _mu_samples, _mu_s_samples, _nu_samples
+    );
+}
+
+bool AtmosphereDeferredcaster::loadCachedTextures(const std::string& file) {
+    std::ifstream fileStream(file, std::ifstream::binary);
+    if (!fileStream.good()) {
+        return false;
+    }
+
+    int8_t version = 0;
+    fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (version != CurrentCacheVersion) {
+        LINFO("The format of the cached atmosphere textures has changed");
+        return false;
+    }
+
+    std::vector<float> transmittance(
+        3 * _transmittance_table_width * _transmittance_table_height
+    );
+    std::vector<float> irradiance(
+        3 * _irradiance_table_width * _irradiance_table_height
+    );
+    std::vector<float> inScattering(
+        4 * _mu_s_samples * _nu_samples * _mu_samples * _r_samples
+    );
+    fileStream.read(
+        reinterpret_cast<char*>(transmittance.data()),
+        transmittance.size() * sizeof(float)
+    );
+    fileStream.read(
+        reinterpret_cast<char*>(irradiance.data()),
+        irradiance.size() * sizeof(float)
+    );
+    fileStream.read(
+        reinterpret_cast<char*>(inScattering.data()),
+        inScattering.size() * sizeof(float)
+    );
+    if (!fileStream.good()) {
+        return false;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, _transmittanceTableTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _transmittance_table_width,
+        _transmittance_table_height, GL_RGB, GL_FLOAT, transmittance.data());
+
+    glBindTexture(GL_TEXTURE_2D, _irradianceTableTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _irradiance_table_width,
+        _irradiance_table_height, GL_RGB, GL_FLOAT, irradiance.data());
+
+    glBindTexture(GL_TEXTURE_3D, _inScatteringTableTexture);
+    glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, _mu_s_samples * _nu_samples,
+        _mu_samples, _r_samples, GL_RGBA, GL_FLOAT, inScattering.data());
+
+    return true;
+}
+
+void AtmosphereDeferredcaster::saveCachedTextures(const std::string& file) const {
+    std::vector<float> transmittance(
+        3 * _transmittance_table_width * _transmittance_table_height
+    );
+    std::vector<float> irradiance(
+        3 * _irradiance_table_width * _irradiance_table_height
+    );
+    std::vector<float> inScattering(
+        4 * _mu_s_samples * _nu_samples * _mu_samples * _r_samples
+    );
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, _transmittanceTableTexture);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_FLOAT, transmittance.data());
+    glBindTexture(GL_TEXTURE_2D, _irradianceTableTexture);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_FLOAT, irradiance.data());
+    glBindTexture(GL_TEXTURE_3D, _inScatteringTableTexture);
+    glGetTexImage(GL_TEXTURE_3D, 0, GL_RGBA, GL_FLOAT, inScattering.data());
+
+    std::ofstream fileStream(file, std::ofstream::binary);
+    if (!fileStream.good()) {
+        LERROR(fmt::format("Error opening file '{}' for saving cache file", file));
+        return;
+    }
+
+    fileStream.write(
+        reinterpret_cast<const char*>(&CurrentCacheVersion),
+        sizeof(int8_t)
+    );
+    fileStream.write(
+        reinterpret_cast<const char*>(transmittance.data()),
+        transmittance.size() * sizeof(float)
+    );
+    fileStream.write(
+        reinterpret_cast<const char*>(irradiance.data()),
+        irradiance.size() * sizeof(float)
+    );
+    fileStream.write(
+        reinterpret_cast<const char*>(inScattering.data()),
+        inScattering.size() * sizeof(float)
+    );
+}
+
 void AtmosphereDeferredcaster::createRenderQuad(GLuint* vao, GLuint* vbo, GLfloat size) {
     glGenVertexArrays(1, vao);
     glGenBuffers(1, vbo);
@@ -1472,6 +1458,94 @@ void AtmosphereDeferredcaster::saveTextureToPPMFile(GLenum color_buffer_attachme
     }
 }
 
+bool AtmosphereDeferredcaster::isAtmosphereCulled(const RenderData& renderData) const {
+    // Atmosphere Frustum Culling
+    const glm::dvec3 tPlanetPosWorld = glm::dvec3(
+        _modelTransform * glm::dvec4(0.0, 0.0, 0.0, 1.0)
+    );
+
+    const double distance = glm::distance(
+        tPlanetPosWorld,
+        renderData.camera.eyePositionVec3()
+    );
+
+    // Radius is in KM
+    const double scaledRadius = glm::length(
+        glm::dmat3(_modelTransform) * glm::dvec3(1000.0 * _atmosphereRadius, 0.0, 0.0)
+    );
+
+    if (distance > scaledRadius * DISTANCE_CULLING_RADII) {
+        return true;
+    }
+
+    // Atmospheres that only cover a few pixels on the screen barely contribute to the
+    // image but would still cost a full-screen pass
+    const double projectedRadius = scaledRadius / distance *
+        renderData.camera.sgctInternal.projectionMatrix()[1][1] * 0.5 *
+        global::renderEngine.renderingResolution().y;
+    if (projectedRadius < MinScreenSpaceRadius) {
+        return true;
+    }
+
+    const glm::dmat4 MV = glm::dmat4(
+        renderData.camera.sgctInternal.projectionMatrix()
+    ) * renderData.camera.combinedViewMatrix();
+
+    return !isAtmosphereInFrustum(
+        MV,
+        tPlanetPosWorld,
+        (_atmosphereRadius + ATM_EPS) * KM_TO_M
+    );
+}
+
+glm::vec4 AtmosphereDeferredcaster::screenSpaceBounds(const RenderData& renderData) const
+{
+    if (isAtmosphereCulled(renderData)) {
+        return glm::vec4(0.f);
+    }
+
+    const glm::dvec3 center = glm::dvec3(
+        _modelTransform * glm::dvec4(0.0, 0.0, 0.0, 1.0)
+    );
+    const double radius = glm::length(
+        glm::dmat3(_modelTransform) *
+        glm::dvec3((_atmosphereRadius + ATM_EPS) * KM_TO_M, 0.0, 0.0)
+    );
+
+    // If the camera is inside, or close to, the atmosphere, the projected bounds would
+    // be unreliable, so we fall back to the entire screen
+    if (glm::distance(center, renderData.camera.eyePositionVec3()) < 2.0 * radius) {
+        return glm::vec4(-1.f, -1.f, 1.f, 1.f);
+    }
+
+    const glm::dmat4 viewProjection = glm::dmat4(
+        renderData.camera.sgctInternal.projectionMatrix()
+    ) * renderData.camera.combinedViewMatrix();
+
+    // Project the corners of the atmosphere's bounding box
+    glm::dvec2 minimum = glm::dvec2(std::numeric_limits<double>::max());
+    glm::dvec2 maximum = glm::dvec2(-std::numeric_limits<double>::max());
+    for (int i = 0; i < 8; ++i) {
+        const glm::dvec3 corner = center + radius * glm::dvec3(
+            (i & 1) ? 1.0 : -1.0,
+            (i & 2) ? 1.0 : -1.0,
+            (i & 4) ? 1.0 : -1.0
+        );
+        const glm::dvec4 clip = viewProjection * glm::dvec4(corner, 1.0);
+        if (clip.w <= 0.0) {
+            // A corner behind the camera would project to the wrong side of the screen
+            return glm::vec4(-1.f, -1.f, 1.f, 1.f);
+        }
+        const glm::dvec2 ndc = glm::dvec2(clip) / clip.w;
+        minimum = glm::min(minimum, ndc);
+        maximum = glm::max(maximum, ndc);
+    }
+
+    minimum = glm::clamp(minimum, glm::dvec2(-1.0), glm::dvec2(1.0));
+    maximum = glm::clamp(maximum, glm::dvec2(-1.0), glm::dvec2(1.0));
+    return glm::vec4(minimum.x, minimum.y, maximum.x, maximum.y);
+}
+
 bool AtmosphereDeferredcaster::isAtmosphereInFrustum(const glm::dmat4& MVMatrix,
                                                      const glm::dvec3& position,
                                                      double radius) const
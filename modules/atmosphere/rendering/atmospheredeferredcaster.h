@@ -25,12 +25,10 @@
 #ifndef __OPENSPACE_MODULE_ATMOSPHERE___ATMOSPHEREDEFERREDCASTER___H__
 #define __OPENSPACE_MODULE_ATMOSPHERE___ATMOSPHEREDEFERREDCASTER___H__
 
-#include <openspace/rendering/deferredcaster.h>
-
 #include <ghoul/glm.h>
-#include <ghoul/opengl/textureunit.h>
-#include <ghoul/opengl/uniformcache.h>
+#include <ghoul/opengl/ghoul_gl.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -42,34 +40,86 @@ namespace ghoul::opengl {
 namespace openspace {
 
 struct RenderData;
-struct DeferredcastData;
 struct ShadowConfiguration;
 
-class AtmosphereDeferredcaster : public Deferredcaster {
+/**
+ * The parameters of a single atmosphere in the uniform buffer of the merged deferred
+ * pass. The layout follows the std140 rules and must correspond to the AtmosphereData
+ * struct in atmosphere_deferred_fs.glsl.
+ */
+struct AtmosphereData {
+    glm::dmat4 inverseModelTransform;
+    glm::dmat4 modelTransform;
+    glm::dmat4 projectionToModelTransform;
+    glm::dvec4 cameraPosition;
+    glm::dvec4 sunDirection;
+    glm::dvec4 shadowCasterPosition;
+    glm::dvec4 shadowSourceCasterDirection;
+    // xu, xp, rc, isShadowing
+    glm::dvec4 shadowParameters;
+    glm::vec4 screenSpaceBounds;
+    // Rg, Rt, groundRadianceEmittion, sunRadiance
+    glm::vec4 radii;
+    // betaRayleigh, HR
+    glm::vec4 rayleigh;
+    // betaMieExtinction, HM
+    glm::vec4 mie;
+    // betaOzoneExtinction, HO
+    glm::vec4 ozone;
+    // mieG, ozoneLayerEnabled, hardShadows, unused
+    glm::vec4 flags;
+    glm::ivec4 samples;
+    // Pads the struct to a multiple of the 32 byte alignment of its double members
+    glm::ivec4 padding;
+};
+static_assert(sizeof(AtmosphereData) == 672, "AtmosphereData must follow std140");
+
+/// World space positions, in meters, of the bodies that are named in the shadow
+/// configurations of all atmospheres, looked up once per frame
+using ShadowCasterTable = std::map<std::string, glm::dvec3>;
+
+/**
+ * Precalculates the scattering tables of a single atmosphere and provides the parameters
+ * that are needed to render it. The atmospheres themselves are rendered by the
+ * MergedAtmosphereDeferredcaster, which evaluates all of them in a single pass.
+ */
+class AtmosphereDeferredcaster {
 public:
     AtmosphereDeferredcaster();
     virtual ~AtmosphereDeferredcaster() = default;
 
     void initialize();
     void deinitialize();
-    void preRaycast(const RenderData& renderData, const DeferredcastData& deferredData,
-                    ghoul::opengl::ProgramObject& program) override;
-    void postRaycast(const RenderData& renderData, const DeferredcastData& deferredData,
-                     ghoul::opengl::ProgramObject& program) override;
 
-    std::string deferredcastPath() const override;
-    std::string deferredcastVSPath() const override;
-    std::string deferredcastFSPath() const override;
-    std::string helperPath() const override;
+    /**
+     * Returns the parameters of this atmosphere for the frame described by
+     * \p renderData. The positions of the Sun and of the sources and casters of the
+     * shadow configurations are taken from the \p shadowCasters table.
+     */
+    AtmosphereData atmosphereData(const RenderData& renderData,
+        const ShadowCasterTable& shadowCasters) const;
+
+    /// Adds the names of all bodies that this atmosphere needs the positions of to the
+    /// \p shadowCasters table
+    void addShadowCasters(ShadowCasterTable& shadowCasters) const;
 
-    void initializeCachedVariables(ghoul::opengl::ProgramObject&) override;
+    GLuint transmittanceTableTexture() const;
+    GLuint irradianceTableTexture() const;
+    GLuint inScatteringTableTexture() const;
 
-    void update(const UpdateData&) override;
+    /**
+     * Returns a conservative bounding rectangle, in normalized device coordinates, of the
+     * part of the screen that this atmosphere can affect. The xy components contain the
+     * lower left corner and the zw components the upper right corner. The rectangle is
+     * empty if the atmosphere is culled.
+     */
+    glm::vec4 screenSpaceBounds(const RenderData& renderData) const;
+
+    bool isAtmosphereCulled(const RenderData& renderData) const;
 
     void preCalculateAtmosphereParam();
 
     void setModelTransform(const glm::dmat4 &transform);
-    void setTime(double time);
     void setAtmosphereRadius(float atmRadius);
     void setPlanetRadius(float planetRadius);
     void setPlanetAverageGroundReflectance(float averageGReflectance);
@@ -98,6 +148,9 @@ private:
     void createComputationTextures();
     void deleteComputationTextures();
     void deleteUnusedComputationTextures();
+    std::string cacheInformation() const;
+    bool loadCachedTextures(const std::string& file);
+    void saveCachedTextures(const std::string& file) const;
     void executeCalculations(GLuint quadCalcVAO, GLenum drawBuffers[1],
         GLsizei vertexSize);
     void createRenderQuad(GLuint* vao, GLuint* vbo, GLfloat size);
@@ -129,17 +182,6 @@ private:
     std::unique_ptr<ghoul::opengl::ProgramObject> _atmosphereProgramObject;
     std::unique_ptr<ghoul::opengl::ProgramObject> _deferredAtmosphereProgramObject;
 
-    UniformCache(cullAtmosphere, Rg, Rt,
-        groundRadianceEmittion, HR, betaRayleigh, HM,
-        betaMieExtinction, mieG, sunRadiance, ozoneLayerEnabled,
-        HO, betaOzoneExtinction, SAMPLES_R,
-        SAMPLES_MU, SAMPLES_MU_S, SAMPLES_NU) _uniformCache;
-    UniformCache(dInverseModelTransformMatrix, dModelTransformMatrix,
-        dSgctProjectionToModelTransformMatrix,
-        dSGCTViewToWorldMatrix, dCamPosObj, sunDirectionObj,
-        hardShadows, transmittanceTexture, irradianceTexture,
-        inscatterTexture) _uniformCache2;
-
     GLuint _transmittanceTableTexture;
     GLuint _irradianceTableTexture;
     GLuint _inScatteringTableTexture;
@@ -149,10 +191,6 @@ private:
     GLuint _deltaJTableTexture;
     GLuint _atmosphereTexture;
 
-    ghoul::opengl::TextureUnit _transmittanceTableTextureUnit;
-    ghoul::opengl::TextureUnit _irradianceTableTextureUnit;
-    ghoul::opengl::TextureUnit _inScatteringTableTextureUnit;
-
     // Atmosphere Data
     bool _atmosphereCalculated;
     bool _ozoneEnabled;
@@ -186,7 +224,6 @@ private:
     int _nu_samples;
 
     glm::dmat4 _modelTransform;
-    double _time = 0.0;
 
     // Eclipse Shadows
     std::vector<ShadowConfiguration> _shadowConfArray;
@@ -0,0 +1,295 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/atmosphere/rendering/mergedatmospheredeferredcaster.h>
+
+#include <modules/atmosphere/rendering/atmospheredeferredcaster.h>
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/deferredcastermanager.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/util/spicemanager.h>
+#include <ghoul/opengl/programobject.h>
+#include <algorithm>
+
+namespace {
+    constexpr const std::array<const char*, 2> UniformNames = {
+        "nAtmospheres", "dSGCTViewToWorldMatrix"
+    };
+
+    constexpr const std::array<const char*, 4> TransmittanceTextureNames = {
+        "transmittanceTextures[0]", "transmittanceTextures[1]",
+        "transmittanceTextures[2]", "transmittanceTextures[3]"
+    };
+    constexpr const std::array<const char*, 4> IrradianceTextureNames = {
+        "irradianceTextures[0]", "irradianceTextures[1]",
+        "irradianceTextures[2]", "irradianceTextures[3]"
+    };
+    constexpr const std::array<const char*, 4> InscatterTextureNames = {
+        "inscatterTextures[0]", "inscatterTextures[1]",
+        "inscatterTextures[2]", "inscatterTextures[3]"
+    };
+
+    constexpr const char* GlslDeferredcastPath =
+        "${MODULES}/atmosphere/shaders/atmosphere_deferred_fs.glsl";
+    constexpr const char* GlslDeferredcastFSPath =
+        "${MODULES}/atmosphere/shaders/atmosphere_deferred_fs.glsl";
+    constexpr const char* GlslDeferredcastVsPath =
+        "${MODULES}/atmosphere/shaders/atmosphere_deferred_vs.glsl";
+
+    // Must correspond to the binding of the Atmospheres block in
+    // atmosphere_deferred_fs.glsl
+    constexpr const GLuint UniformBufferBinding = 0;
+
+    constexpr const double KM_TO_M = 1000.0;
+} // namespace
+
+namespace openspace {
+
+static_assert(
+    MergedAtmosphereDeferredcaster::MaxAtmospheres == TransmittanceTextureNames.size(),
+    "There must be one texture name for each atmosphere"
+);
+
+void MergedAtmosphereDeferredcaster::addAtmosphere(AtmosphereDeferredcaster& atmosphere) {
+    if (_atmospheres.empty()) {
+        glGenBuffers(1, &_uniformBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, _uniformBuffer);
+        glBufferData(
+            GL_UNIFORM_BUFFER,
+            MaxAtmospheres * sizeof(AtmosphereData),
+            nullptr,
+            GL_DYNAMIC_DRAW
+        );
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        global::deferredcasterManager.attachDeferredcaster(*this);
+    }
+    _atmospheres.push_back(&atmosphere);
+}
+
+void MergedAtmosphereDeferredcaster::removeAtmosphere(
+                                                    AtmosphereDeferredcaster& atmosphere)
+{
+    _atmospheres.erase(
+        std::remove(_atmospheres.begin(), _atmospheres.end(), &atmosphere),
+        _atmospheres.end()
+    );
+    // The atmosphere might still be referenced from the current frame
+    _frameAtmospheres.clear();
+
+    if (_atmospheres.empty()) {
+        global::deferredcasterManager.detachDeferredcaster(*this);
+
+        glDeleteBuffers(1, &_uniformBuffer);
+        _uniformBuffer = 0;
+    }
+}
+
+void MergedAtmosphereDeferredcaster::render(AtmosphereDeferredcaster& atmosphere,
+                                            const RenderData& renderData,
+                                            RendererTasks& tasks)
+{
+    // Atmospheres left over from a frame in which the deferred pass did not run
+    const uint64_t frameNumber = global::renderEngine.frameNumber();
+    if (frameNumber != _frameNumber) {
+        _frameAtmospheres.clear();
+        _frameNumber = frameNumber;
+    }
+    _frameAtmospheres.push_back({ &atmosphere, renderData });
+
+    const bool hasTask = std::any_of(
+        tasks.deferredcasterTasks.begin(),
+        tasks.deferredcasterTasks.end(),
+        [this](const DeferredcasterTask& task) { return task.deferredcaster == this; }
+    );
+    if (!hasTask) {
+        tasks.deferredcasterTasks.push_back({ this, renderData });
+    }
+}
+
+void MergedAtmosphereDeferredcaster::preRaycast(const RenderData& renderData,
+                                                const DeferredcastData&,
+                                                ghoul::opengl::ProgramObject& program)
+{
+    const glm::dvec3 cameraPosition = renderData.camera.eyePositionVec3();
+
+    std::vector<const FrameAtmosphere*> visible;
+    for (const FrameAtmosphere& a : _frameAtmospheres) {
+        if (!a.atmosphere->isAtmosphereCulled(a.renderData)) {
+            visible.push_back(&a);
+        }
+    }
+    std::sort(
+        visible.begin(),
+        visible.end(),
+        [&cameraPosition](const FrameAtmosphere* lhs, const FrameAtmosphere* rhs) {
+            const glm::dvec3& l = lhs->renderData.modelTransform.translation;
+            const glm::dvec3& r = rhs->renderData.modelTransform.translation;
+            return glm::distance(l, cameraPosition) < glm::distance(r, cameraPosition);
+        }
+    );
+    if (visible.size() > MaxAtmospheres) {
+        visible.resize(MaxAtmospheres);
+    }
+
+    // Atmospheres often share their shadow casters (and all of them need the Sun), so
+    // each body is only looked up once
+    ShadowCasterTable shadowCasters;
+    for (const FrameAtmosphere* a : visible) {
+        a->atmosphere->addShadowCasters(shadowCasters);
+    }
+    const double time = renderData.time.j2000Seconds();
+    for (std::pair<const std::string, glm::dvec3>& body : shadowCasters) {
+        double lt;
+        body.second = SpiceManager::ref().targetPosition(
+            body.first,
+            "SUN",
+            "GALACTIC",
+            {},
+            time,
+            lt
+        ) * KM_TO_M;
+    }
+
+    std::array<AtmosphereData, MaxAtmospheres> data;
+    for (size_t i = 0; i < visible.size(); ++i) {
+        data[i] = visible[i]->atmosphere->atmosphereData(
+            visible[i]->renderData,
+            shadowCasters
+        );
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, _uniformBuffer);
+    glBufferSubData(
+        GL_UNIFORM_BUFFER,
+        0,
+        visible.size() * sizeof(AtmosphereData),
+        data.data()
+    );
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, UniformBufferBinding, _uniformBuffer);
+
+    program.setUniform(_uniformCache.nAtmospheres, static_cast<int>(visible.size()));
+
+    // Eye Space in SGCT to OS World Space
+    program.setUniform(
+        _uniformCache.dSGCTViewToWorldMatrix,
+        glm::inverse(renderData.camera.combinedViewMatrix())
+    );
+
+    // Samplers of different types must not share a texture unit, even if they are not
+    // used, so the unused elements of the arrays refer to the first atmosphere
+    for (size_t i = 0; i < MaxAtmospheres; ++i) {
+        const size_t index = (i < visible.size()) ? i : 0;
+        ghoul::opengl::TextureUnit& transmittanceUnit = _textureUnits[3 * index];
+        ghoul::opengl::TextureUnit& irradianceUnit = _textureUnits[3 * index + 1];
+        ghoul::opengl::TextureUnit& inscatterUnit = _textureUnits[3 * index + 2];
+
+        if (i == index) {
+            const AtmosphereDeferredcaster* atmosphere =
+                visible.empty() ? nullptr : visible[i]->atmosphere;
+
+            transmittanceUnit.activate();
+            glBindTexture(
+                GL_TEXTURE_2D,
+                atmosphere ? atmosphere->transmittanceTableTexture() : 0
+            );
+            irradianceUnit.activate();
+            glBindTexture(
+                GL_TEXTURE_2D,
+                atmosphere ? atmosphere->irradianceTableTexture() : 0
+            );
+            inscatterUnit.activate();
+            glBindTexture(
+                GL_TEXTURE_3D,
+                atmosphere ? atmosphere->inScatteringTableTexture() : 0
+            );
+        }
+
+        program.setUniform(TransmittanceTextureNames[i], transmittanceUnit);
+        program.setUniform(IrradianceTextureNames[i], irradianceUnit);
+        program.setUniform(InscatterTextureNames[i], inscatterUnit);
+    }
+}
+
+void MergedAtmosphereDeferredcaster::postRaycast(const RenderData&,
+                                                 const DeferredcastData&,
+                                                 ghoul::opengl::ProgramObject&)
+{
+    for (ghoul::opengl::TextureUnit& unit : _textureUnits) {
+        unit.deactivate();
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, UniformBufferBinding, 0);
+
+    // The next eye or frame records its own atmospheres
+    _frameAtmospheres.clear();
+}
+
+std::string MergedAtmosphereDeferredcaster::deferredcastPath() const {
+    return GlslDeferredcastPath;
+}
+
+std::string MergedAtmosphereDeferredcaster::deferredcastFSPath() const {
+    return GlslDeferredcastFSPath;
+}
+
+std::string MergedAtmosphereDeferredcaster::deferredcastVSPath() const {
+    return GlslDeferredcastVsPath;
+}
+
+std::string MergedAtmosphereDeferredcaster::helperPath() const {
+    return ""; // no helper file
+}
+
+void MergedAtmosphereDeferredcaster::initializeCachedVariables(
+                                                    ghoul::opengl::ProgramObject& program)
+{
+    ghoul::opengl::updateUniformLocations(program, _uniformCache, UniformNames);
+}
+
+void MergedAtmosphereDeferredcaster::update(const UpdateData&) {}
+
+glm::vec4 MergedAtmosphereDeferredcaster::screenSpaceBounds(const RenderData&) const {
+    glm::vec4 bounds = glm::vec4(0.f);
+    bool isEmpty = true;
+    for (const FrameAtmosphere& a : _frameAtmospheres) {
+        const glm::vec4 b = a.atmosphere->screenSpaceBounds(a.renderData);
+        if (b.x >= b.z || b.y >= b.w) {
+            continue;
+        }
+
+        if (isEmpty) {
+            bounds = b;
+            isEmpty = false;
+        }
+        else {
+            bounds = glm::vec4(
+                glm::min(glm::vec2(bounds.x, bounds.y), glm::vec2(b.x, b.y)),
+                glm::max(glm::vec2(bounds.z, bounds.w), glm::vec2(b.z, b.w))
+            );
+        }
+    }
+    return bounds;
+}
+
+} // namespace openspace
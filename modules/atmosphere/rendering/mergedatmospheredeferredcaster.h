@@ -0,0 +1,108 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_ATMOSPHERE___MERGEDATMOSPHEREDEFERREDCASTER___H__
+#define __OPENSPACE_MODULE_ATMOSPHERE___MERGEDATMOSPHEREDEFERREDCASTER___H__
+
+#include <openspace/rendering/deferredcaster.h>
+
+#include <openspace/util/updatestructures.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/textureunit.h>
+#include <ghoul/opengl/uniformcache.h>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+class AtmosphereDeferredcaster;
+
+/**
+ * Renders all atmospheres that are visible in a frame in a single deferred pass, instead
+ * of one full-screen pass for each of them. The parameters of each atmosphere are stored
+ * in a uniform buffer and the positions of the shadow casters are looked up once per
+ * frame for all of them. Each fragment is shaded by the closest atmosphere that its view
+ * ray enters.
+ */
+class MergedAtmosphereDeferredcaster : public Deferredcaster {
+public:
+    /// The largest number of atmospheres that are rendered in a frame. If more are
+    /// visible, the ones closest to the camera are rendered. Must correspond to
+    /// MaxAtmospheres in atmosphere_deferred_fs.glsl
+    static constexpr const int MaxAtmospheres = 4;
+
+    /// Adds the \p atmosphere to the ones that can be rendered. Has to be called with an
+    /// active OpenGL context
+    void addAtmosphere(AtmosphereDeferredcaster& atmosphere);
+
+    /// Removes the \p atmosphere that was previously added with addAtmosphere
+    void removeAtmosphere(AtmosphereDeferredcaster& atmosphere);
+
+    /**
+     * Renders the \p atmosphere with \p renderData in the deferred pass of the current
+     * frame and adds that pass to \p tasks if it was not already added by another
+     * atmosphere.
+     */
+    void render(AtmosphereDeferredcaster& atmosphere, const RenderData& renderData,
+        RendererTasks& tasks);
+
+    void preRaycast(const RenderData& renderData, const DeferredcastData& deferredData,
+        ghoul::opengl::ProgramObject& program) override;
+    void postRaycast(const RenderData& renderData, const DeferredcastData& deferredData,
+        ghoul::opengl::ProgramObject& program) override;
+
+    std::string deferredcastPath() const override;
+    std::string deferredcastVSPath() const override;
+    std::string deferredcastFSPath() const override;
+    std::string helperPath() const override;
+
+    void initializeCachedVariables(ghoul::opengl::ProgramObject& program) override;
+
+    void update(const UpdateData&) override;
+
+    glm::vec4 screenSpaceBounds(const RenderData& renderData) const override;
+
+private:
+    struct FrameAtmosphere {
+        AtmosphereDeferredcaster* atmosphere;
+        RenderData renderData;
+    };
+
+    std::vector<AtmosphereDeferredcaster*> _atmospheres;
+
+    // The atmospheres that are rendered in the current frame
+    std::vector<FrameAtmosphere> _frameAtmospheres;
+    uint64_t _frameNumber = 0;
+
+    GLuint _uniformBuffer = 0;
+    // The transmittance, irradiance, and inscattering textures of each atmosphere
+    std::array<ghoul::opengl::TextureUnit, 3 * MaxAtmospheres> _textureUnits;
+
+    UniformCache(nAtmospheres, dSGCTViewToWorldMatrix) _uniformCache;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_ATMOSPHERE___MERGEDATMOSPHEREDEFERREDCASTER___H__
@@ -24,12 +24,14 @@
 
 #include <modules/atmosphere/rendering/renderableatmosphere.h>
 
+#include <modules/atmosphere/atmospheremodule.h>
 #include <modules/atmosphere/rendering/atmospheredeferredcaster.h>
+#include <modules/atmosphere/rendering/mergedatmospheredeferredcaster.h>
 #include <modules/space/rendering/planetgeometry.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
-#include <openspace/rendering/deferredcastermanager.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/rendering/renderer.h>
 #include <openspace/scene/scenegraphnode.h>
@@ -656,7 +658,8 @@ RenderableAtmosphere::RenderableAtmosphere(const ghoul::Dictionary& dictionary)
 
 void RenderableAtmosphere::deinitializeGL() {
     if (_deferredcaster) {
-        global::deferredcasterManager.detachDeferredcaster(*_deferredcaster);
+        global::moduleEngine.module<AtmosphereModule>()->mergedDeferredcaster()
+            .removeAtmosphere(*_deferredcaster);
         _deferredcaster = nullptr;
     }
 }
@@ -699,7 +702,8 @@ void RenderableAtmosphere::initializeGL() {
             _deferredcaster->initialize();
         }
 
-        global::deferredcasterManager.attachDeferredcaster(*_deferredcaster);
+        global::moduleEngine.module<AtmosphereModule>()->mergedDeferredcaster()
+            .addAtmosphere(*_deferredcaster);
     }
 
     return;
@@ -722,8 +726,11 @@ glm::dmat4 RenderableAtmosphere::computeModelTransformMatrix(
 
 void RenderableAtmosphere::render(const RenderData& data, RendererTasks& renderTask) {
     if (_atmosphereEnabled) {
-        DeferredcasterTask task{ _deferredcaster.get(), data };
-        renderTask.deferredcasterTasks.push_back(task);
+        global::moduleEngine.module<AtmosphereModule>()->mergedDeferredcaster().render(
+            *_deferredcaster,
+            data,
+            renderTask
+        );
     }
 }
 
@@ -731,10 +738,8 @@ void RenderableAtmosphere::update(const UpdateData& data) {
     _stateMatrix = data.modelTransform.rotation;
 
     if (_deferredcaster) {
-        _deferredcaster->setTime(data.time.j2000Seconds());
         glm::dmat4 modelTransform = computeModelTransformMatrix(data.modelTransform);
         _deferredcaster->setModelTransform(modelTransform);
-        _deferredcaster->update(data);
     }
 }
 
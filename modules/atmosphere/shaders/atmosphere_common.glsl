@@ -58,33 +58,40 @@
  */
 
 
+// The deferred pass evaluates several atmospheres in one draw call. It defines
+// ATMOSPHERE_PARAMETER as empty so that the parameters become regular variables that it
+// assigns for each atmosphere, followed by a call to updateDerivedParameters
+#ifndef ATMOSPHERE_PARAMETER
+#define ATMOSPHERE_PARAMETER uniform
+#endif
+
 // Atmosphere Rendering Parameters 
-uniform float Rg;
-uniform float Rt;
-uniform float AverageGroundReflectance;
-uniform float groundRadianceEmittion;
-uniform float HR;
-uniform vec3 betaRayleigh;
-uniform float HO;
-uniform vec3 betaOzoneExtinction;
-uniform float HM;
-uniform vec3 betaMieScattering;
-uniform vec3 betaMieExtinction;
-uniform float mieG;
-uniform float sunRadiance;
-
-uniform bool ozoneLayerEnabled;
-
-uniform int TRANSMITTANCE_W;
-uniform int TRANSMITTANCE_H;
-uniform int SKY_W;
-uniform int SKY_H;
-uniform int OTHER_TEXTURES_W;
-uniform int OTHER_TEXTURES_H;
-uniform int SAMPLES_R;
-uniform int SAMPLES_MU;
-uniform int SAMPLES_MU_S;
-uniform int SAMPLES_NU;
+ATMOSPHERE_PARAMETER float Rg;
+ATMOSPHERE_PARAMETER float Rt;
+ATMOSPHERE_PARAMETER float AverageGroundReflectance;
+ATMOSPHERE_PARAMETER float groundRadianceEmittion;
+ATMOSPHERE_PARAMETER float HR;
+ATMOSPHERE_PARAMETER vec3 betaRayleigh;
+ATMOSPHERE_PARAMETER float HO;
+ATMOSPHERE_PARAMETER vec3 betaOzoneExtinction;
+ATMOSPHERE_PARAMETER float HM;
+ATMOSPHERE_PARAMETER vec3 betaMieScattering;
+ATMOSPHERE_PARAMETER vec3 betaMieExtinction;
+ATMOSPHERE_PARAMETER float mieG;
+ATMOSPHERE_PARAMETER float sunRadiance;
+
+ATMOSPHERE_PARAMETER bool ozoneLayerEnabled;
+
+ATMOSPHERE_PARAMETER int TRANSMITTANCE_W;
+ATMOSPHERE_PARAMETER int TRANSMITTANCE_H;
+ATMOSPHERE_PARAMETER int SKY_W;
+ATMOSPHERE_PARAMETER int SKY_H;
+ATMOSPHERE_PARAMETER int OTHER_TEXTURES_W;
+ATMOSPHERE_PARAMETER int OTHER_TEXTURES_H;
+ATMOSPHERE_PARAMETER int SAMPLES_R;
+ATMOSPHERE_PARAMETER int SAMPLES_MU;
+ATMOSPHERE_PARAMETER int SAMPLES_MU_S;
+ATMOSPHERE_PARAMETER int SAMPLES_NU;
 
 const float ATM_EPSILON = 1.0;
 
@@ -96,7 +103,10 @@ const int INSCATTER_SPHERICAL_INTEGRAL_SAMPLES = 16;
 
 const float M_PI = 3.141592657;
 
+// The deferred pass defines transmittanceTexture as an element of its texture array
+#ifndef transmittanceTexture
 uniform sampler2D transmittanceTexture;
+#endif
 
 float Rg2    = Rg * Rg;
 float Rt2    = Rt * Rt;
@@ -109,6 +119,20 @@ float invSamplesNu = 1.0f / float(SAMPLES_NU);
 float RtMinusRg = float(Rt - Rg);
 float invRtMinusRg = 1.0f / RtMinusRg;
 
+// Has to be called whenever the parameters above are changed inside the shader
+void updateDerivedParameters() {
+  Rg2 = Rg * Rg;
+  Rt2 = Rt * Rt;
+  H = sqrt(Rt2 - Rg2);
+  H2 = Rt2 - Rg2;
+  invSamplesMu = 1.0f / float(SAMPLES_MU);
+  invSamplesR = 1.0f / float(SAMPLES_R);
+  invSamplesMuS = 1.0f / float(SAMPLES_MU_S);
+  invSamplesNu = 1.0f / float(SAMPLES_NU);
+  RtMinusRg = float(Rt - Rg);
+  invRtMinusRg = 1.0f / RtMinusRg;
+}
+
 float opticalDepth(const float localH, const float r, const float mu, const float d) {
   float invH = 1.0/localH;
   float a    = sqrt((0.5 * invH)*r);
@@ -59,6 +59,24 @@
 
 #version __CONTEXT__
 
+// Must correspond to MaxAtmospheres in mergedatmospheredeferredcaster.h
+const int MaxAtmospheres = 4;
+
+// The parameters of the atmosphere that is currently evaluated are copied into the
+// variables of atmosphere_common.glsl by selectAtmosphere
+#define ATMOSPHERE_PARAMETER
+#define transmittanceTexture transmittanceTextures[atmosphereIndex]
+#define irradianceTexture irradianceTextures[atmosphereIndex]
+#define inscatterTexture inscatterTextures[atmosphereIndex]
+
+uniform sampler2D transmittanceTextures[MaxAtmospheres];
+uniform sampler2D irradianceTextures[MaxAtmospheres];
+uniform sampler3D inscatterTextures[MaxAtmospheres];
+
+// Only ever assigned the index of a loop over all atmospheres, so that the texture
+// arrays are indexed with a dynamically uniform value
+int atmosphereIndex = 0;
+
 #include "floatoperations.glsl"
 
 #include "hdr.glsl"
@@ -69,7 +87,6 @@ in vec3 interpolatedNDCPos;
 
 uniform int nAaSamples;
 uniform double msaaSamplePatter[48];
-uniform int cullAtmosphere;
 
 // The following uniforms are
 // set into the current Renderer
@@ -78,22 +95,58 @@ uniform float backgroundConstant;
 uniform bool firstPaint;
 uniform float atmExposure;
 
-uniform sampler2D irradianceTexture;
-uniform sampler3D inscatterTexture;
 uniform sampler2DMS mainPositionTexture;
 uniform sampler2DMS mainNormalTexture;
 uniform sampler2DMS mainColorTexture;
 
-uniform dmat4 dInverseModelTransformMatrix; 
-uniform dmat4 dModelTransformMatrix;
 uniform dmat4 dSGCTViewToWorldMatrix;
-uniform dmat4 dSgctProjectionToModelTransformMatrix;
-
-uniform dvec4 dCamPosObj;
-uniform dvec3 sunDirectionObj;
 
 uniform float blackoutFactor;
 
+// Must correspond to the AtmosphereData struct in atmospheredeferredcaster.h
+struct AtmosphereData {
+    dmat4 inverseModelTransform;
+    dmat4 modelTransform;
+    dmat4 projectionToModelTransform;
+    // Camera position in object space, in meters
+    dvec4 cameraPosition;
+    // Sun direction in object space
+    dvec4 sunDirection;
+    // World space position of the shadow caster, in meters
+    dvec4 shadowCasterPosition;
+    dvec4 shadowSourceCasterDirection;
+    // xu, xp, rc, isShadowing
+    dvec4 shadowParameters;
+    // Normalized device coordinates (minX, minY, maxX, maxY) of the atmosphere
+    vec4 screenSpaceBounds;
+    // Rg, Rt, groundRadianceEmittion, sunRadiance
+    vec4 radii;
+    // betaRayleigh, HR
+    vec4 rayleigh;
+    // betaMieExtinction, HM
+    vec4 mie;
+    // betaOzoneExtinction, HO
+    vec4 ozone;
+    // mieG, ozoneLayerEnabled, hardShadows, unused
+    vec4 flags;
+    // SAMPLES_R, SAMPLES_MU, SAMPLES_MU_S, SAMPLES_NU
+    ivec4 samples;
+    ivec4 padding;
+};
+
+layout(std140, binding = 0) uniform Atmospheres {
+    AtmosphereData atmospheres[MaxAtmospheres];
+};
+
+uniform int nAtmospheres;
+
+dmat4 dInverseModelTransformMatrix;
+dmat4 dModelTransformMatrix;
+dmat4 dSgctProjectionToModelTransformMatrix;
+
+dvec4 dCamPosObj;
+dvec3 sunDirectionObj;
+
 /*******************************************************************************
  ***** ALL CALCULATIONS FOR ECLIPSE ARE IN METERS AND IN WORLD SPACE SYSTEM ****
  *******************************************************************************/
@@ -112,9 +165,45 @@ struct ShadowRenderingStruct {
 // Eclipse shadow data
 // JCC: Remove and use dictionary to 
 // decides the number of shadows
-uniform ShadowRenderingStruct shadowDataArray[numberOfShadows];
-uniform int shadows;
-uniform bool hardShadows;
+ShadowRenderingStruct shadowDataArray[numberOfShadows];
+bool hardShadows;
+
+void selectAtmosphere(int index) {
+    atmosphereIndex = index;
+    AtmosphereData atm = atmospheres[index];
+
+    Rg = atm.radii.x;
+    Rt = atm.radii.y;
+    groundRadianceEmittion = atm.radii.z;
+    sunRadiance = atm.radii.w;
+    betaRayleigh = atm.rayleigh.xyz;
+    HR = atm.rayleigh.w;
+    betaMieExtinction = atm.mie.xyz;
+    HM = atm.mie.w;
+    betaOzoneExtinction = atm.ozone.xyz;
+    HO = atm.ozone.w;
+    mieG = atm.flags.x;
+    ozoneLayerEnabled = atm.flags.y > 0.5;
+    hardShadows = atm.flags.z > 0.5;
+    SAMPLES_R = atm.samples.x;
+    SAMPLES_MU = atm.samples.y;
+    SAMPLES_MU_S = atm.samples.z;
+    SAMPLES_NU = atm.samples.w;
+    updateDerivedParameters();
+
+    dInverseModelTransformMatrix = atm.inverseModelTransform;
+    dModelTransformMatrix = atm.modelTransform;
+    dSgctProjectionToModelTransformMatrix = atm.projectionToModelTransform;
+    dCamPosObj = atm.cameraPosition;
+    sunDirectionObj = atm.sunDirection.xyz;
+
+    shadowDataArray[0].xu = atm.shadowParameters.x;
+    shadowDataArray[0].xp = atm.shadowParameters.y;
+    shadowDataArray[0].rc = atm.shadowParameters.z;
+    shadowDataArray[0].isShadowing = atm.shadowParameters.w > 0.5;
+    shadowDataArray[0].sourceCasterVec = atm.shadowSourceCasterDirection.xyz;
+    shadowDataArray[0].casterPositionVec = atm.shadowCasterPosition.xyz;
+}
 
 vec4 butterworthFunc(const float d, const float r, const float n) {
     return vec4(vec3(sqrt(r/(r + pow(d, 2*n)))), 1.0);    
@@ -541,180 +630,228 @@ vec3 sunColor(const vec3 x, const float t, const vec3 v, const vec3 s, const flo
     return transmittance * sunFinalColor;      
 }
 
-void main() {
-    ivec2 fragCoords = ivec2(gl_FragCoord);
+/*
+ * Returns the distance, in Km, at which the view ray of the current fragment enters the
+ * selected atmosphere, or a negative value if the ray misses the atmosphere.
+ */
+double atmosphereEntryDistance() {
+    dRay ray;
+    dvec4 planetPositionObjectCoords = dvec4(0.0);
+    dvec4 cameraPositionInObject     = dvec4(0.0);
+    dCalculateRayRenderableGlobe(0, ray, planetPositionObjectCoords,
+                                 cameraPositionInObject);
+
+    bool insideATM   = false;
+    double offset    = 0.0;
+    double maxLength = 0.0;
+    bool intersectATM = dAtmosphereIntersection(planetPositionObjectCoords.xyz, ray,
+                                                Rt - (ATM_EPSILON * 0.001), insideATM,
+                                                offset, maxLength);
+    return intersectATM ? offset : -1.0;
+}
 
-    if (cullAtmosphere == 0) {
-        vec4 atmosphereFinalColor = vec4(0.0f);
-        int nSamples = 1;
-        
-        // First we determine if the pixel is complex (different fragments on it)
-        bool complex = false;
-        vec4 oldColor, currentColor;
-        vec4 colorArray[16];
+/*
+ * Calculates the final color of the current fragment with the selected atmosphere.
+ */
+vec4 atmosphereColor(const ivec2 fragCoords) {
+    vec4 atmosphereFinalColor = vec4(0.0f);
+    int nSamples = 1;
+    
+    // First we determine if the pixel is complex (different fragments on it)
+    bool complex = false;
+    vec4 oldColor, currentColor;
+    vec4 colorArray[16];
+    
+    colorArray[0] = texelFetch(mainColorTexture, fragCoords, 0);        
+    for (int i = 1; i < nAaSamples; i++) {
+        colorArray[i]  = texelFetch(mainColorTexture, fragCoords, i);
+        if (colorArray[i] != colorArray[i-1]) {
+            complex = true;           
+        } 
+    }
+    nSamples = complex ? nAaSamples / 2 : 1;
+    
+    // Performance variables:
+    //float Rt2 = Rt * Rt; // in Km
+    //float Rg2 = Rg * Rg; // in Km
+
+
+    for (int i = 0; i < nSamples; i++) {
+        // Color from G-Buffer
+        //vec4 color = texelFetch(mainColorTexture, fragCoords, i);
+        vec4 color = colorArray[i];
         
-        colorArray[0] = texelFetch(mainColorTexture, fragCoords, 0);        
-        for (int i = 1; i < nAaSamples; i++) {
-            colorArray[i]  = texelFetch(mainColorTexture, fragCoords, i);
-            if (colorArray[i] != colorArray[i-1]) {
-                complex = true;           
-            } 
-        }
-        nSamples = complex ? nAaSamples / 2 : 1;
+        // Ray in object space
+        dRay ray;
+        dvec4 planetPositionObjectCoords = dvec4(0.0);
+        dvec4 cameraPositionInObject     = dvec4(0.0);        
         
-        // Performance variables:
-        //float Rt2 = Rt * Rt; // in Km
-        //float Rg2 = Rg * Rg; // in Km
+        // Get the ray from camera to atm in object space
+        dCalculateRayRenderableGlobe(i * 3, ray, planetPositionObjectCoords, 
+                                     cameraPositionInObject);
+      
+        bool  insideATM    = false;
+        double offset      = 0.0;   // in Km
+        double maxLength   = 0.0;   // in Km  
+
+        bool  intersectATM = false;
+
+        intersectATM = dAtmosphereIntersection(planetPositionObjectCoords.xyz, ray,  
+                                              Rt - (ATM_EPSILON * 0.001), insideATM, offset, maxLength);
+           
+        if ( intersectATM ) {
+            // Now we check is if the atmosphere is occluded, i.e., if the distance to the pixel 
+            // in the G-Buffer positions is less than the distance to the atmosphere then the atmosphere
+            // is occluded
+            // Fragments positions into G-Buffer are written in SGCT Eye Space (View plus Camera Rig Coords)
+            // when using their positions later, one must convert them to the planet's coords
+            
+            // Get data from G-Buffer
+            vec4 normal   = texelFetch(mainNormalTexture, fragCoords, i);
+            // Data in the mainPositionTexture are written in view space (view plus camera rig)
+            vec4 position = texelFetch(mainPositionTexture, fragCoords, i);
+
+            // OS Eye to World coords                
+            dvec4 positionWorldCoords = dSGCTViewToWorldMatrix * position;
 
+            // World to Object (Normal and Position in meters)
+            dvec4 positionObjectsCoords = dInverseModelTransformMatrix * positionWorldCoords;
 
-        for (int i = 0; i < nSamples; i++) {
-            // Color from G-Buffer
-            //vec4 color = texelFetch(mainColorTexture, fragCoords, i);
-            vec4 color = colorArray[i];
             
-            // Ray in object space
-            dRay ray;
-            dvec4 planetPositionObjectCoords = dvec4(0.0);
-            dvec4 cameraPositionInObject     = dvec4(0.0);        
+            // Distance of the pixel in the gBuffer to the observer
+            // JCC (12/12/2017): AMD distance function is buggy.
+            //double pixelDepth = distance(cameraPositionInObject.xyz, positionObjectsCoords.xyz);
+            double pixelDepth = length(cameraPositionInObject.xyz - positionObjectsCoords.xyz);
             
-            // Get the ray from camera to atm in object space
-            dCalculateRayRenderableGlobe(i * 3, ray, planetPositionObjectCoords, 
-                                         cameraPositionInObject);
-          
-            bool  insideATM    = false;
-            double offset      = 0.0;   // in Km
-            double maxLength   = 0.0;   // in Km  
-
-            bool  intersectATM = false;
-
-            intersectATM = dAtmosphereIntersection(planetPositionObjectCoords.xyz, ray,  
-                                                  Rt - (ATM_EPSILON * 0.001), insideATM, offset, maxLength);
-               
-            if ( intersectATM ) {
-                // Now we check is if the atmosphere is occluded, i.e., if the distance to the pixel 
-                // in the G-Buffer positions is less than the distance to the atmosphere then the atmosphere
-                // is occluded
-                // Fragments positions into G-Buffer are written in SGCT Eye Space (View plus Camera Rig Coords)
-                // when using their positions later, one must convert them to the planet's coords
-                
-                // Get data from G-Buffer
-                vec4 normal   = texelFetch(mainNormalTexture, fragCoords, i);
-                // Data in the mainPositionTexture are written in view space (view plus camera rig)
-                vec4 position = texelFetch(mainPositionTexture, fragCoords, i);
-
-                // OS Eye to World coords                
-                dvec4 positionWorldCoords = dSGCTViewToWorldMatrix * position;
-
-                // World to Object (Normal and Position in meters)
-                dvec4 positionObjectsCoords = dInverseModelTransformMatrix * positionWorldCoords;
+            // JCC (12/13/2017): Trick to remove floating error in texture.
+            // We see a squared noise on planet's surface when seeing the planet
+            // from far away.
+            float dC = float(length(cameraPositionInObject.xyz));
+            float x1 = 1e8;
+            if (dC > x1) {
+                pixelDepth     += 1000.0;
+                float alpha     = 1000.0;
+                float beta      = 1000000.0;
+                float x2        = 1e9; 
+                float diffGreek = beta - alpha;
+                float diffDist  = x2 - x1;
+                float varA      = diffGreek/diffDist;
+                float varB      = (alpha - varA * x1);
+                pixelDepth     += double(varA * dC + varB); 
+            }
 
+            // All calculations are done in Km:
+            pixelDepth                *= 0.001;
+            positionObjectsCoords.xyz *= 0.001;
+            
+            if (position.xyz != vec3(0.0) && (pixelDepth < offset)) {
+                // ATM Occluded - Something in fron of ATM.
+                atmosphereFinalColor += vec4(HDR(color.xyz * backgroundConstant, atmExposure), color.a);                  
+            } else {
+                // Following paper nomenclature      
+                double t = offset;                  
+                vec3 attenuation;     
+
+                // Moving observer from camera location to top atmosphere
+                // If the observer is already inside the atm, offset = 0.0
+                // and no changes at all.
+                vec3  x  = vec3(ray.origin.xyz + t*ray.direction.xyz);
+                float r  = 0.0f;//length(x);
+                vec3  v  = vec3(ray.direction.xyz);
+                float mu = 0.0f;//dot(x, v) / r;
+                vec3  s  = vec3(sunDirectionObj);
+                float tF = float(maxLength - t);
+
+                // Because we may move the camera origin to the top of atmosphere 
+                // we also need to adjust the pixelDepth for tdCalculateRayRenderableGlobe' offset so the
+                // next comparison with the planet's ground make sense:
+                pixelDepth -= offset;
                 
-                // Distance of the pixel in the gBuffer to the observer
-                // JCC (12/12/2017): AMD distance function is buggy.
-                //double pixelDepth = distance(cameraPositionInObject.xyz, positionObjectsCoords.xyz);
-                double pixelDepth = length(cameraPositionInObject.xyz - positionObjectsCoords.xyz);
+                dvec4 onATMPos           = dModelTransformMatrix * dvec4(x * 1000.0, 1.0);
+                vec4 eclipseShadowATM    = calcShadow(shadowDataArray, onATMPos.xyz, false);            
+                float sunIntensityInscatter = sunRadiance * eclipseShadowATM.x;
+
+                float irradianceFactor = 0.0;
+
+                bool groundHit = false;
+                vec3 inscatterColor = inscatterRadiance(x, tF, irradianceFactor, v,
+                                                        s, r, mu, attenuation, 
+                                                        vec3(positionObjectsCoords.xyz),
+                                                        groundHit, maxLength, pixelDepth,
+                                                        color, sunIntensityInscatter); 
+                vec3 groundColorV = vec3(0.0);
+                vec3 sunColorV = vec3(0.0);                                                
+                if (groundHit) {
+                    vec4 eclipseShadowPlanet = calcShadow(shadowDataArray, positionWorldCoords.xyz, true);
+                    float sunIntensityGround = sunRadiance * eclipseShadowPlanet.x;
+                    groundColorV = groundColor(x, tF, v, s, r, mu, attenuation,
+                                               color, normal.xyz, irradianceFactor, 
+                                               normal.a, sunIntensityGround);
+                } else {
+                    // In order to get better performance, we are not tracing
+                    // multiple rays per pixel when the ray doesn't intersect
+                    // the ground.
+                    sunColorV = sunColor(x, tF, v, s, r, mu, irradianceFactor); 
+                } 
                 
-                // JCC (12/13/2017): Trick to remove floating error in texture.
-                // We see a squared noise on planet's surface when seeing the planet
-                // from far away.
-                float dC = float(length(cameraPositionInObject.xyz));
-                float x1 = 1e8;
-                if (dC > x1) {
-                    pixelDepth     += 1000.0;
-                    float alpha     = 1000.0;
-                    float beta      = 1000000.0;
-                    float x2        = 1e9; 
-                    float diffGreek = beta - alpha;
-                    float diffDist  = x2 - x1;
-                    float varA      = diffGreek/diffDist;
-                    float varB      = (alpha - varA * x1);
-                    pixelDepth     += double(varA * dC + varB); 
-                }
-
-                // All calculations are done in Km:
-                pixelDepth                *= 0.001;
-                positionObjectsCoords.xyz *= 0.001;
+                // Final Color of ATM plus terrain:
+                vec4 finalRadiance = vec4(HDR(inscatterColor + groundColorV + sunColorV, atmExposure), 1.0);
                 
-                if (position.xyz != vec3(0.0) && (pixelDepth < offset)) {
-                    // ATM Occluded - Something in fron of ATM.
-                    atmosphereFinalColor += vec4(HDR(color.xyz * backgroundConstant, atmExposure), color.a);                  
-                } else {
-                    // Following paper nomenclature      
-                    double t = offset;                  
-                    vec3 attenuation;     
-
-                    // Moving observer from camera location to top atmosphere
-                    // If the observer is already inside the atm, offset = 0.0
-                    // and no changes at all.
-                    vec3  x  = vec3(ray.origin.xyz + t*ray.direction.xyz);
-                    float r  = 0.0f;//length(x);
-                    vec3  v  = vec3(ray.direction.xyz);
-                    float mu = 0.0f;//dot(x, v) / r;
-                    vec3  s  = vec3(sunDirectionObj);
-                    float tF = float(maxLength - t);
-
-                    // Because we may move the camera origin to the top of atmosphere 
-                    // we also need to adjust the pixelDepth for tdCalculateRayRenderableGlobe' offset so the
-                    // next comparison with the planet's ground make sense:
-                    pixelDepth -= offset;
-                    
-                    dvec4 onATMPos           = dModelTransformMatrix * dvec4(x * 1000.0, 1.0);
-                    vec4 eclipseShadowATM    = calcShadow(shadowDataArray, onATMPos.xyz, false);            
-                    float sunIntensityInscatter = sunRadiance * eclipseShadowATM.x;
-
-                    float irradianceFactor = 0.0;
-
-                    bool groundHit = false;
-                    vec3 inscatterColor = inscatterRadiance(x, tF, irradianceFactor, v,
-                                                            s, r, mu, attenuation, 
-                                                            vec3(positionObjectsCoords.xyz),
-                                                            groundHit, maxLength, pixelDepth,
-                                                            color, sunIntensityInscatter); 
-                    vec3 groundColorV = vec3(0.0);
-                    vec3 sunColorV = vec3(0.0);                                                
-                    if (groundHit) {
-                        vec4 eclipseShadowPlanet = calcShadow(shadowDataArray, positionWorldCoords.xyz, true);
-                        float sunIntensityGround = sunRadiance * eclipseShadowPlanet.x;
-                        groundColorV = groundColor(x, tF, v, s, r, mu, attenuation,
-                                                   color, normal.xyz, irradianceFactor, 
-                                                   normal.a, sunIntensityGround);
-                    } else {
-                        // In order to get better performance, we are not tracing
-                        // multiple rays per pixel when the ray doesn't intersect
-                        // the ground.
-                        sunColorV = sunColor(x, tF, v, s, r, mu, irradianceFactor); 
-                    } 
-                    
-                    // Final Color of ATM plus terrain:
-                    vec4 finalRadiance = vec4(HDR(inscatterColor + groundColorV + sunColorV, atmExposure), 1.0);
-                    
-                    atmosphereFinalColor += finalRadiance;
-                }
-            } 
-            else { // no intersection
-                atmosphereFinalColor += vec4(HDR(color.xyz * backgroundConstant, atmExposure), color.a);
-            }           
-        }  
-
-        renderTarget = atmosphereFinalColor / float(nSamples);        
-        renderTarget.a *= blackoutFactor;
-        // if (complex)
-        //     renderTarget = vec4(1.0, 0.0, 0.0, 1.0);
-    } 
-    else { // culling
-        if (firstPaint) {
-            vec4 bColor = vec4(0.0f);
-            for (int f = 0; f < nAaSamples; f++) {
-                bColor += texelFetch(mainColorTexture, fragCoords, f);
+                atmosphereFinalColor += finalRadiance;
             }
-            bColor /= float(nAaSamples);
-            renderTarget = vec4(HDR(bColor.xyz * backgroundConstant, atmExposure), bColor.a * blackoutFactor);
         } 
-        else {
-            discard;
+        else { // no intersection
+            atmosphereFinalColor += vec4(HDR(color.xyz * backgroundConstant, atmExposure), color.a);
+        }           
+    }  
+
+    vec4 finalColor = atmosphereFinalColor / float(nSamples);
+    finalColor.a *= blackoutFactor;
+    return finalColor;
+}
+
+void main() {
+    ivec2 fragCoords = ivec2(gl_FragCoord);
+
+    // Of all atmospheres that the view ray enters, only the one closest to the camera is
+    // evaluated, as it covers the ones behind it
+    int closestAtmosphere = -1;
+    double closestEntry = 0.0;
+    for (int i = 0; i < nAtmospheres; i++) {
+        vec4 bounds = atmospheres[i].screenSpaceBounds;
+        bool insideBounds = all(greaterThanEqual(interpolatedNDCPos.xy, bounds.xy)) &&
+                            all(lessThanEqual(interpolatedNDCPos.xy, bounds.zw));
+        if (!insideBounds) {
+            continue;
+        }
+
+        selectAtmosphere(i);
+        double entry = atmosphereEntryDistance();
+        if (entry >= 0.0 && (closestAtmosphere == -1 || entry < closestEntry)) {
+            closestAtmosphere = i;
+            closestEntry = entry;
         }
-        //renderTarget = vec4(1.0, 0.0, 0.0, 1.0);
-        
     }
-}
 
+    if (closestAtmosphere != -1) {
+        // Looping again, instead of selecting closestAtmosphere directly, keeps the index
+        // into the texture arrays dynamically uniform
+        for (int i = 0; i < nAtmospheres; i++) {
+            if (i == closestAtmosphere) {
+                selectAtmosphere(i);
+                renderTarget = atmosphereColor(fragCoords);
+            }
+        }
+    }
+    else if (firstPaint) {
+        vec4 bColor = vec4(0.0f);
+        for (int f = 0; f < nAaSamples; f++) {
+            bColor += texelFetch(mainColorTexture, fragCoords, f);
+        }
+        bColor /= float(nAaSamples);
+        renderTarget = vec4(HDR(bColor.xyz * backgroundConstant, atmExposure), bColor.a * blackoutFactor);
+    }
+    else {
+        discard;
+    }
+}
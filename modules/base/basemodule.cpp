@@ -58,15 +58,18 @@
 #include <modules/base/scale/luascale.h>
 #include <modules/base/scale/staticscale.h>
 #include <modules/base/scale/timedependentscale.h>
+#include <modules/base/tasks/converttexturetask.h>
 #include <modules/base/translation/luatranslation.h>
 #include <modules/base/translation/statictranslation.h>
 #include <modules/base/timeframe/timeframeinterval.h>
 #include <modules/base/timeframe/timeframeunion.h>
 #include <openspace/documentation/documentation.h>
+#include <openspace/engine/globalscallbacks.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -74,6 +77,8 @@ namespace openspace {
 
 ghoul::opengl::ProgramObjectManager BaseModule::ProgramObjectManager;
 ghoul::opengl::TextureManager BaseModule::TextureManager;
+OnlineImageCache BaseModule::OnlineImages;
+TrailBuffer BaseModule::Trails;
 
 BaseModule::BaseModule() : OpenSpaceModule(BaseModule::Name) {}
 
@@ -164,11 +169,18 @@ void BaseModule::internalInitialize(const ghoul::Dictionary&) {
     auto fGeometry = FactoryManager::ref().factory<modelgeometry::ModelGeometry>();
     ghoul_assert(fGeometry, "Model geometry factory was not created");
     fGeometry->registerClass<modelgeometry::MultiModelGeometry>("MultiModelGeometry");
+
+    auto fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "No task factory existed");
+    fTask->registerClass<ConvertTextureTask>("ConvertTextureTask");
+
+    global::callback::render.emplace_back([]() { OnlineImages.update(); });
 }
 
 void BaseModule::internalDeinitializeGL() {
     ProgramObjectManager.releaseAll(ghoul::opengl::ProgramObjectManager::Warnings::Yes);
     TextureManager.releaseAll(ghoul::opengl::TextureManager::Warnings::Yes);
+    OnlineImages.deinitializeGL();
 }
 
 std::vector<documentation::Documentation> BaseModule::documentations() const {
@@ -213,6 +225,8 @@ std::vector<documentation::Documentation> BaseModule::documentations() const {
         CameraLightSource::Documentation(),
 
         modelgeometry::ModelGeometry::Documentation(),
+
+        ConvertTextureTask::documentation()
     };
 }
 
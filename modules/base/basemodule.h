@@ -27,6 +27,8 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/base/rendering/onlineimagecache.h>
+#include <modules/base/rendering/trailbuffer.h>
 #include <ghoul/opengl/programobjectmanager.h>
 #include <ghoul/opengl/texturemanager.h>
 
@@ -44,6 +46,9 @@ public:
 
     static ghoul::opengl::ProgramObjectManager ProgramObjectManager;
     static ghoul::opengl::TextureManager TextureManager;
+    static OnlineImageCache OnlineImages;
+    /// The vertices of all trails, which are drawn together
+    static TrailBuffer Trails;
 
 protected:
     void internalInitialize(const ghoul::Dictionary&) override;
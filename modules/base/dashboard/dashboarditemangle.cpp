@@ -30,6 +30,7 @@
 #include <openspace/interaction/navigationhandler.h>
 #include <openspace/interaction/orbitalnavigator.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scene/scene.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/util/camera.h>
@@ -400,7 +401,7 @@ void DashboardItemAngle::render(glm::vec2& penPosition) {
 
     if (glm::length(a) == 0.0 || glm::length(b) == 0) {
         penPosition.y -= _font->height();
-        RenderFont(
+        global::renderEngine.textBatcher().queue(
             *_font,
             penPosition,
             fmt::format(
@@ -415,7 +416,7 @@ void DashboardItemAngle::render(glm::vec2& penPosition) {
         );
 
         penPosition.y -= _font->height();
-        RenderFont(
+        global::renderEngine.textBatcher().queue(
             *_font,
             penPosition,
             fmt::format(
@@ -27,6 +27,8 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/font/font.h>
 #include <ghoul/font/fontmanager.h>
@@ -111,7 +113,7 @@ DashboardItemDate::DashboardItemDate(const ghoul::Dictionary& dictionary)
 
 void DashboardItemDate::render(glm::vec2& penPosition) {
     penPosition.y -= _font->height();
-    RenderFont(
+    global::renderEngine.textBatcher().queue(
         *_font,
         penPosition,
         fmt::format("Date: {} UTC", global::timeManager.time().UTC())
@@ -30,6 +30,7 @@
 #include <openspace/interaction/navigationhandler.h>
 #include <openspace/interaction/orbitalnavigator.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scene/scene.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/util/camera.h>
@@ -440,7 +441,7 @@ void DashboardItemDistance::render(glm::vec2& penPosition) {
     }
 
     penPosition.y -= _font->height();
-    RenderFont(
+    global::renderEngine.textBatcher().queue(
         *_font,
         penPosition,
         fmt::format(
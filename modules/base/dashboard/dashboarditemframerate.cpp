@@ -28,6 +28,8 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <ghoul/font/font.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
@@ -293,7 +295,7 @@ void DashboardItemFramerate::render(glm::vec2& penPosition) {
 
     penPosition.y -= _font->height() * static_cast<float>(nLines);
 
-    ghoul::fontrendering::FontRenderer::defaultRenderer().render(
+    global::renderEngine.textBatcher().queue(
         *_font,
         penPosition,
         output
@@ -29,6 +29,8 @@
 #include <openspace/engine/globals.h>
 #include <openspace/mission/mission.h>
 #include <openspace/mission/missionmanager.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/font/font.h>
 #include <ghoul/font/fontmanager.h>
@@ -132,6 +134,7 @@ void DashboardItemMission::render(glm::vec2& penPosition) {
     if (!global::missionManager.hasCurrentMission()) {
         return;
     }
+    TextBatcher& batcher = global::renderEngine.textBatcher();
     double currentTime = global::timeManager.time().j2000Seconds();
     const Mission& mission = global::missionManager.currentMission();
 
@@ -144,7 +147,7 @@ void DashboardItemMission::render(glm::vec2& penPosition) {
     static const glm::vec4 nonCurrentMissionColor(0.3f, 0.3f, 0.3f, 1.f);
 
     // Add spacing
-    RenderFont(
+    batcher.queue(
         *_font,
         penPosition,
         " ",
@@ -158,14 +161,14 @@ void DashboardItemMission::render(glm::vec2& penPosition) {
         const MissionPhase& phase = phaseTrace.back().get();
         const std::string title = "Current Mission Phase: " + phase.name();
         penPosition.y -= _font->height();
-        RenderFont(*_font, penPosition, title, missionProgressColor);
+        batcher.queue(*_font, penPosition, title, missionProgressColor);
         double remaining = phase.timeRange().end - currentTime;
         float t = static_cast<float>(
             1.0 - remaining / phase.timeRange().duration()
         );
         std::string progress = progressToStr(25, t);
         penPosition.y -= _font->height();
-        RenderFont(
+        batcher.queue(
             *_font,
             penPosition,
             fmt::format("{:.0f} s {:s} {:.1f} %", remaining, progress, t * 100),
@@ -174,10 +177,10 @@ void DashboardItemMission::render(glm::vec2& penPosition) {
     }
     else {
         penPosition.y -= _font->height();
-        RenderFont(*_font, penPosition, "Next Mission:", nextMissionColor);
+        batcher.queue(*_font, penPosition, "Next Mission:", nextMissionColor);
         const double remaining = mission.timeRange().start - currentTime;
         penPosition.y -= _font->height();
-        RenderFont(
+        batcher.queue(
             *_font,
             penPosition,
             fmt::format("{:.0f} s", remaining),
@@ -207,7 +210,7 @@ void DashboardItemMission::render(glm::vec2& penPosition) {
             );
             const std::string progress = progressToStr(25, t);
             penPosition.y -= _font->height();
-            RenderFont(
+            batcher.queue(
                 *_font,
                 penPosition,
                 fmt::format(
@@ -220,7 +223,7 @@ void DashboardItemMission::render(glm::vec2& penPosition) {
         else {
             if (!phase->name().empty()) {
                 penPosition.y -= _font->height();
-                RenderFont(
+                batcher.queue(
                     *_font,
                     penPosition,
                     phase->name(),
@@ -29,6 +29,8 @@
 #include <openspace/engine/globals.h>
 #include <openspace/network/parallelconnection.h>
 #include <openspace/network/parallelpeer.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/util/distanceconversion.h>
 #include <ghoul/font/font.h>
@@ -159,7 +161,7 @@ void DashboardItemParallelConnection::render(glm::vec2& penPosition) {
 
     if (!connectionInfo.empty()) {
         penPosition.y -= _font->height();
-        RenderFont(*_font, penPosition, connectionInfo);
+        global::renderEngine.textBatcher().queue(*_font, penPosition, connectionInfo);
     }
 }
 
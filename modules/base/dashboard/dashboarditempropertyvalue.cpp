@@ -28,6 +28,8 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/query/query.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/font/font.h>
 #include <ghoul/font/fontmanager.h>
@@ -161,7 +163,11 @@ void DashboardItemPropertyValue::render(glm::vec2& penPosition) {
         _property->getStringValue(value);
 
         penPosition.y -= _font->height();
-        RenderFont(*_font, penPosition, fmt::format(_displayString.value(), value));
+        global::renderEngine.textBatcher().queue(
+            *_font,
+            penPosition,
+            fmt::format(_displayString.value(), value)
+        );
     }
 }
 
@@ -27,6 +27,8 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/util/timeconversion.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/font/font.h>
@@ -203,7 +205,7 @@ void DashboardItemSimulationIncrement::render(glm::vec2& penPosition) {
     penPosition.y -= _font->height();
     if (targetDt != currentDt && !global::timeManager.isPaused()) {
         // We are in the middle of a transition
-        RenderFont(
+        global::renderEngine.textBatcher().queue(
             *_font,
             penPosition,
             fmt::format(
@@ -215,7 +217,7 @@ void DashboardItemSimulationIncrement::render(glm::vec2& penPosition) {
         );
     }
     else {
-        RenderFont(
+        global::renderEngine.textBatcher().queue(
             *_font,
             penPosition,
             fmt::format(
@@ -30,6 +30,7 @@
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/interaction/navigationhandler.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scene/scene.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/util/camera.h>
@@ -206,7 +207,7 @@ void DashboardItemVelocity::render(glm::vec2& penPosition) {
     }
 
     penPosition.y -= _font->height();
-    RenderFont(
+    global::renderEngine.textBatcher().queue(
         *_font,
         penPosition,
         fmt::format(
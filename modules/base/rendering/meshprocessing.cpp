@@ -0,0 +1,275 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <modules/base/rendering/meshprocessing.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+    // The size of the simulated vertex cache and the weights of the scoring function as
+    // suggested by Tom Forsyth in "Linear-Speed Vertex Cache Optimisation"
+    constexpr const int CacheSize = 32;
+    constexpr const float LastTriangleScore = 0.75f;
+    constexpr const float CacheDecayPower = 1.5f;
+    constexpr const float ValenceBoostScale = 2.f;
+    constexpr const float ValenceBoostPower = 0.5f;
+
+    // The finest grid that is tried when simplifying a mesh, per axis
+    constexpr const uint64_t MaxGridResolution = 1024;
+
+    using Vertex = openspace::modelgeometry::ModelGeometry::Vertex;
+
+    float vertexScore(int cachePosition, int nActiveTriangles) {
+        if (nActiveTriangles == 0) {
+            // This vertex is not used by any remaining triangle
+            return -1.f;
+        }
+
+        float score = 0.f;
+        if (cachePosition >= 3) {
+            const float scaler = 1.f / (CacheSize - 3);
+            score = std::pow(1.f - (cachePosition - 3) * scaler, CacheDecayPower);
+        }
+        else if (cachePosition >= 0) {
+            // The vertices of the last triangle get a fixed score so that the next
+            // triangle does not simply continue a strip in the same direction
+            score = LastTriangleScore;
+        }
+
+        const float valenceBoost = std::pow(
+            static_cast<float>(nActiveTriangles),
+            -ValenceBoostPower
+        );
+        return score + ValenceBoostScale * valenceBoost;
+    }
+
+    // Returns the indices of the triangles in the grid with the given resolution
+    std::vector<int> clusterVertices(const std::vector<Vertex>& vertices,
+                                     const std::vector<int>& indices,
+                                     const glm::vec3& minimum, float cellSize,
+                                     uint64_t resolution)
+    {
+        auto cell = [&](float value, float min) {
+            const uint64_t c = static_cast<uint64_t>((value - min) / cellSize);
+            return std::min(c, resolution - 1);
+        };
+        auto cellIndex = [&](const float* l) {
+            const uint64_t x = cell(l[0], minimum.x);
+            const uint64_t y = cell(l[1], minimum.y);
+            const uint64_t z = cell(l[2], minimum.z);
+            return (x * resolution + y) * resolution + z;
+        };
+
+        // The first vertex that falls into a cell represents all vertices of that cell
+        std::unordered_map<uint64_t, int> representatives;
+        std::vector<int> remap(vertices.size(), -1);
+        std::vector<int> result;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            int triangle[3];
+            for (size_t k = 0; k < 3; ++k) {
+                const int v = indices[i + k];
+                if (remap[v] == -1) {
+                    const uint64_t c = cellIndex(vertices[v].location);
+                    remap[v] = representatives.emplace(c, v).first->second;
+                }
+                triangle[k] = remap[v];
+            }
+
+            // Triangles whose vertices collapsed into the same cell are dropped
+            if (triangle[0] != triangle[1] && triangle[1] != triangle[2] &&
+                triangle[0] != triangle[2])
+            {
+                result.insert(result.end(), triangle, triangle + 3);
+            }
+        }
+        return result;
+    }
+} // namespace
+
+namespace openspace::modelgeometry {
+
+void optimizeVertexCache(std::vector<int>& indices, size_t nVertices) {
+    const size_t nTriangles = indices.size() / 3;
+    if (nTriangles == 0) {
+        return;
+    }
+
+    // For each vertex, the list of triangles that use it and that have not been emitted
+    std::vector<int> nActive(nVertices, 0);
+    for (int i : indices) {
+        nActive[i]++;
+    }
+    std::vector<size_t> offsets(nVertices + 1, 0);
+    std::partial_sum(nActive.begin(), nActive.end(), offsets.begin() + 1);
+    std::vector<int> adjacency(indices.size());
+    {
+        std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < nTriangles; ++t) {
+            for (size_t k = 0; k < 3; ++k) {
+                adjacency[fill[indices[3 * t + k]]++] = static_cast<int>(t);
+            }
+        }
+    }
+
+    std::vector<int> cachePosition(nVertices, -1);
+    std::vector<float> vertexScores(nVertices);
+    for (size_t v = 0; v < nVertices; ++v) {
+        vertexScores[v] = vertexScore(-1, nActive[v]);
+    }
+
+    std::vector<float> triangleScores(nTriangles);
+    std::vector<bool> isEmitted(nTriangles, false);
+    int bestTriangle = 0;
+    for (size_t t = 0; t < nTriangles; ++t) {
+        triangleScores[t] = vertexScores[indices[3 * t]] +
+            vertexScores[indices[3 * t + 1]] + vertexScores[indices[3 * t + 2]];
+        if (triangleScores[t] > triangleScores[bestTriangle]) {
+            bestTriangle = static_cast<int>(t);
+        }
+    }
+
+    std::vector<int> cache;
+    cache.reserve(CacheSize + 3);
+    std::vector<int> newCache;
+    newCache.reserve(CacheSize + 3);
+
+    std::vector<int> result;
+    result.reserve(indices.size());
+    size_t nextUnemitted = 0;
+    while (result.size() < indices.size()) {
+        if (bestTriangle == -1) {
+            // None of the triangles touching the cache is left, so we continue with
+            // the next triangle in the original order
+            while (isEmitted[nextUnemitted]) {
+                nextUnemitted++;
+            }
+            bestTriangle = static_cast<int>(nextUnemitted);
+        }
+
+        const int* triangle = &indices[3 * bestTriangle];
+        isEmitted[bestTriangle] = true;
+        result.insert(result.end(), triangle, triangle + 3);
+
+        // Remove the emitted triangle from the active lists of its vertices
+        for (size_t k = 0; k < 3; ++k) {
+            const int v = triangle[k];
+            int* begin = &adjacency[offsets[v]];
+            int* end = begin + nActive[v];
+            std::iter_swap(std::find(begin, end, bestTriangle), end - 1);
+            nActive[v]--;
+        }
+
+        // The vertices of the emitted triangle move to the front of the cache
+        newCache.assign(triangle, triangle + 3);
+        for (int v : cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                newCache.push_back(v);
+            }
+        }
+        for (size_t i = CacheSize; i < newCache.size(); ++i) {
+            cachePosition[newCache[i]] = -1;
+            vertexScores[newCache[i]] = vertexScore(-1, nActive[newCache[i]]);
+        }
+        newCache.resize(std::min<size_t>(newCache.size(), CacheSize));
+        std::swap(cache, newCache);
+
+        for (size_t i = 0; i < cache.size(); ++i) {
+            cachePosition[cache[i]] = static_cast<int>(i);
+            vertexScores[cache[i]] = vertexScore(static_cast<int>(i), nActive[cache[i]]);
+        }
+
+        // Only the triangles of vertices in the cache changed their score, so the next
+        // triangle is the best among them
+        bestTriangle = -1;
+        float bestScore = -1.f;
+        for (int v : cache) {
+            for (int i = 0; i < nActive[v]; ++i) {
+                const int t = adjacency[offsets[v] + i];
+                triangleScores[t] = vertexScores[indices[3 * t]] +
+                    vertexScores[indices[3 * t + 1]] + vertexScores[indices[3 * t + 2]];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+    }
+
+    indices = std::move(result);
+}
+
+std::vector<int> simplifyMesh(const std::vector<Vertex>& vertices,
+                              const std::vector<int>& indices, size_t targetIndices,
+                              float& error)
+{
+    if (vertices.empty() || indices.size() <= targetIndices) {
+        return std::vector<int>();
+    }
+
+    glm::vec3 minimum = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 maximum = glm::vec3(-std::numeric_limits<float>::max());
+    for (const Vertex& v : vertices) {
+        const glm::vec3 p = glm::vec3(v.location[0], v.location[1], v.location[2]);
+        minimum = glm::min(minimum, p);
+        maximum = glm::max(maximum, p);
+    }
+    const glm::vec3 size = maximum - minimum;
+    const float extent = std::max({ size.x, size.y, size.z });
+    if (extent <= 0.f) {
+        return std::vector<int>();
+    }
+
+    // The number of triangles shrinks together with the grid resolution, so we search
+    // for the finest grid whose result still fits into the target
+    std::vector<int> result;
+    uint64_t low = 1;
+    uint64_t high = MaxGridResolution;
+    while (low <= high) {
+        const uint64_t resolution = (low + high) / 2;
+        const float cellSize = extent / resolution;
+        std::vector<int> r = clusterVertices(
+            vertices,
+            indices,
+            minimum,
+            cellSize,
+            resolution
+        );
+        if (r.size() <= targetIndices) {
+            result = std::move(r);
+            // Vertices can move anywhere within their cell
+            error = cellSize * std::sqrt(3.f);
+            low = resolution + 1;
+        }
+        else {
+            high = resolution - 1;
+        }
+    }
+    return result;
+}
+
+} // namespace openspace::modelgeometry
@@ -0,0 +1,61 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_MODULE_BASE___MESHPROCESSING___H__
+#define __OPENSPACE_MODULE_BASE___MESHPROCESSING___H__
+
+#include <modules/base/rendering/modelgeometry.h>
+
+#include <vector>
+
+namespace openspace::modelgeometry {
+
+/**
+ * Reorders the triangles in \p indices so that consecutive triangles reuse the vertices
+ * that are still in the post-transform vertex cache of the GPU. The triangles themselves
+ * are not modified. This uses the linear-speed algorithm described by Tom Forsyth.
+ *
+ * \param indices The triangle list that is reordered in place
+ * \param nVertices The number of vertices that \p indices refers to
+ */
+void optimizeVertexCache(std::vector<int>& indices, size_t nVertices);
+
+/**
+ * Creates a simplified version of the triangle list \p indices that contains at most
+ * \p targetIndices indices by merging all vertices that fall into the same cell of a
+ * uniform grid. The resulting triangles only refer to vertices in \p vertices, so all
+ * levels of detail of a mesh can share the same vertex buffer.
+ *
+ * \param vertices The vertices of the mesh
+ * \param indices The triangle list that should be simplified
+ * \param targetIndices The maximum number of indices of the simplified triangle list
+ * \param error Returns the largest distance that any vertex was moved, in model space
+ * \return The simplified triangle list, which is empty if no simplification with at
+ *         most \p targetIndices indices could be found
+ */
+std::vector<int> simplifyMesh(const std::vector<ModelGeometry::Vertex>& vertices,
+    const std::vector<int>& indices, size_t targetIndices, float& error);
+
+} // namespace openspace::modelgeometry
+
+#endif // __OPENSPACE_MODULE_BASE___MESHPROCESSING___H__
@@ -21,12 +21,14 @@
  * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
-
 #include <modules/base/rendering/modelgeometry.h>
 
+#include <modules/base/rendering/meshprocessing.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/resourceloader.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -34,14 +36,376 @@
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/invariants.h>
 #include <ghoul/misc/templatefactory.h>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <map>
+#include <optional>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace openspace::modelgeometry {
+
+// The GPU resources of a model file, which are shared between all geometries using it
+struct SharedMesh {
+    struct LevelOfDetail {
+        uint32_t firstIndex;
+        uint32_t nIndices;
+        // The largest distance (in model space) that a vertex was moved by simplifying
+        float error;
+    };
+
+    GLuint vaoID = 0;
+    GLuint vbo = 0;
+    GLuint ibo = 0;
+    GLuint instanceVbo = 0;
+    std::vector<LevelOfDetail> levels;
+    double boundingRadius = 0.0;
+
+    bool isReady = false;
+    ResourceLoader::Handle loading;
+    std::vector<ModelGeometry*> users;
+};
+
+} // namespace openspace::modelgeometry
 
 namespace {
     constexpr const char* _loggerCat = "ModelGeometry";
 
     constexpr const char* KeyType = "Type";
     constexpr const char* KeyGeomModelFile = "GeometryFile";
-    constexpr const int8_t CurrentCacheVersion = 3;
+    constexpr const uint32_t CurrentCacheVersion = 4;
+
+    // Each level of detail has at most half the indices of the previous level, and we
+    // stop simplifying once a level would become smaller than this
+    constexpr const int MaxLevelsOfDetail = 4;
+    constexpr const size_t MinLevelOfDetailIndices = 3 * 256;
+
+    using ModelGeometry = openspace::modelgeometry::ModelGeometry;
+    using SharedMesh = openspace::modelgeometry::SharedMesh;
+    using LevelOfDetail = SharedMesh::LevelOfDetail;
+    using Vertex = ModelGeometry::Vertex;
+
+    // The cache file consists of this header, followed by the levels of detail, the
+    // vertices, and all indices of all levels
+    struct CacheHeader {
+        uint32_t version;
+        uint32_t nLevels;
+        uint64_t nVertices;
+        uint64_t nIndices;
+        double boundingRadius;
+    };
+    static_assert(sizeof(CacheHeader) == 32, "Unexpected padding in CacheHeader");
+    static_assert(sizeof(LevelOfDetail) == 12, "Unexpected padding in LevelOfDetail");
+
+    // The result of loading a model file on a worker thread
+    struct MeshData {
+        std::vector<Vertex> vertices;
+        std::vector<int> indices;
+        std::vector<LevelOfDetail> levels;
+        double boundingRadius = 0.0;
+    };
+
+    // The meshes of all initialized geometries, keyed by their model file. Many scene
+    // graph nodes can use the same model file and they all share one copy
+    std::map<std::string, SharedMesh> SharedMeshes;
+
+    // Maps the whole file into memory, read-only. The file is unmapped when the last
+    // copy of the returned pointer is destroyed
+    std::shared_ptr<const char> mapFile(const std::string& path, size_t& size) {
+#ifdef WIN32
+        HANDLE file = CreateFileA(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        // The view keeps references to the mapping and the file
+        CloseHandle(file);
+        if (!mapping) {
+            return nullptr;
+        }
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!data) {
+            return nullptr;
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        return std::shared_ptr<const char>(
+            reinterpret_cast<const char*>(data),
+            [](const char* p) { UnmapViewOfFile(p); }
+        );
+#else // WIN32
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file == -1) {
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(file, &info) == -1 || info.st_size == 0) {
+            close(file);
+            return nullptr;
+        }
+        void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+        // The mapping keeps a reference to the file, so the descriptor is not needed
+        close(file);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        size = static_cast<size_t>(info.st_size);
+        return std::shared_ptr<const char>(
+            reinterpret_cast<const char*>(data),
+            [size](const char* p) { munmap(const_cast<char*>(p), size); }
+        );
+#endif // WIN32
+    }
+
+    bool saveCachedFile(const std::string& filename, const MeshData& mesh) {
+        std::ofstream fileStream(filename, std::ofstream::binary);
+        if (!fileStream.good()) {
+            LERROR(fmt::format("Error opening file '{}' for save cache file", filename));
+            return false;
+        }
+
+        CacheHeader header;
+        header.version = CurrentCacheVersion;
+        header.nLevels = static_cast<uint32_t>(mesh.levels.size());
+        header.nVertices = mesh.vertices.size();
+        header.nIndices = mesh.indices.size();
+        header.boundingRadius = mesh.boundingRadius;
+        fileStream.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+
+        fileStream.write(
+            reinterpret_cast<const char*>(mesh.levels.data()),
+            sizeof(LevelOfDetail) * mesh.levels.size()
+        );
+        fileStream.write(
+            reinterpret_cast<const char*>(mesh.vertices.data()),
+            sizeof(Vertex) * mesh.vertices.size()
+        );
+        fileStream.write(
+            reinterpret_cast<const char*>(mesh.indices.data()),
+            sizeof(int) * mesh.indices.size()
+        );
+        return fileStream.good();
+    }
+
+    std::optional<MeshData> loadCachedFile(const std::string& filename) {
+        size_t size = 0;
+        std::shared_ptr<const char> file = mapFile(filename, size);
+        if (!file) {
+            LERROR(fmt::format(
+                "Error opening file '{}' for loading cache file", filename
+            ));
+            return std::nullopt;
+        }
+
+        CacheHeader header;
+        if (size < sizeof(CacheHeader)) {
+            return std::nullopt;
+        }
+        std::memcpy(&header, file.get(), sizeof(CacheHeader));
+        if (header.version != CurrentCacheVersion) {
+            LINFO("The format of the cached file has changed, deleting old cache");
+            return std::nullopt;
+        }
+
+        const size_t expectedSize = sizeof(CacheHeader) +
+            sizeof(LevelOfDetail) * header.nLevels + sizeof(Vertex) * header.nVertices +
+            sizeof(int) * header.nIndices;
+        if (header.nLevels == 0 || header.nVertices == 0 || size != expectedSize) {
+            LERROR(fmt::format(
+                "Error opening file '{}' for loading cache file", filename
+            ));
+            return std::nullopt;
+        }
+
+        MeshData mesh;
+        mesh.boundingRadius = header.boundingRadius;
+        mesh.levels.resize(header.nLevels);
+        mesh.vertices.resize(header.nVertices);
+        mesh.indices.resize(header.nIndices);
+
+        const char* data = file.get() + sizeof(CacheHeader);
+        std::memcpy(mesh.levels.data(), data, sizeof(LevelOfDetail) * header.nLevels);
+        data += sizeof(LevelOfDetail) * header.nLevels;
+        std::memcpy(mesh.vertices.data(), data, sizeof(Vertex) * header.nVertices);
+        data += sizeof(Vertex) * header.nVertices;
+        std::memcpy(mesh.indices.data(), data, sizeof(int) * header.nIndices);
+        return mesh;
+    }
+
+    // Optimizes the triangle order of the mesh for the vertex cache and appends the
+    // simplified levels of detail to its indices
+    void buildLevelsOfDetail(MeshData& mesh) {
+        std::vector<int>& indices = mesh.indices;
+        if (indices.size() % 3 != 0) {
+            // Not a triangle list, so we render the indices as they are
+            mesh.levels.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.f });
+            return;
+        }
+
+        using namespace openspace::modelgeometry;
+        optimizeVertexCache(indices, mesh.vertices.size());
+        mesh.levels.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.f });
+
+        const std::vector<int> original = indices;
+        for (int i = 1; i < MaxLevelsOfDetail; ++i) {
+            const size_t target = mesh.levels.back().nIndices / 6 * 3;
+            if (target < MinLevelOfDetailIndices) {
+                break;
+            }
+
+            float error = 0.f;
+            std::vector<int> level = simplifyMesh(mesh.vertices, original, target, error);
+            if (level.empty()) {
+                break;
+            }
+            optimizeVertexCache(level, mesh.vertices.size());
+
+            mesh.levels.push_back({
+                static_cast<uint32_t>(indices.size()),
+                static_cast<uint32_t>(level.size()),
+                error
+            });
+            indices.insert(indices.end(), level.begin(), level.end());
+        }
+    }
+
+    // Executed on a worker thread of the ResourceLoader
+    MeshData loadMeshData(const std::string& filename,
+                          const ModelGeometry::ModelReader& reader)
+    {
+        const std::string& cachedFile = FileSys.cacheManager()->cachedFilename(
+            filename,
+            ghoul::filesystem::CacheManager::Persistent::Yes
+        );
+
+        const bool hasCachedFile = FileSys.fileExists(cachedFile);
+        if (hasCachedFile) {
+            LINFO(fmt::format(
+                "Cached file '{}' used for file '{}", cachedFile, filename
+            ));
+
+            std::optional<MeshData> mesh = loadCachedFile(cachedFile);
+            if (mesh) {
+                return std::move(*mesh);
+            }
+            else {
+                FileSys.cacheManager()->removeCacheFile(filename);
+            }
+        }
+        else {
+            LINFO(fmt::format(
+                "Cached file '{}' for file '{}' not found",
+                cachedFile,
+                filename
+            ));
+        }
+
+        LINFO(fmt::format("Loading Model file '{}'", filename));
+        MeshData mesh;
+        const bool modelSuccess = reader(filename, mesh.vertices, mesh.indices);
+        if (!modelSuccess || mesh.vertices.empty()) {
+            return MeshData();
+        }
+
+        float maximumDistanceSquared = 0;
+        for (const Vertex& v : mesh.vertices) {
+            maximumDistanceSquared = glm::max(
+                glm::pow(v.location[0], 2.f) +
+                glm::pow(v.location[1], 2.f) +
+                glm::pow(v.location[2], 2.f), maximumDistanceSquared);
+        }
+        mesh.boundingRadius = glm::sqrt(maximumDistanceSquared);
+
+        buildLevelsOfDetail(mesh);
+
+        LINFO("Saving cache");
+        saveCachedFile(cachedFile, mesh);
+        return mesh;
+    }
+
+    void createMesh(SharedMesh& mesh, const MeshData& data) {
+        mesh.levels = data.levels;
+        mesh.boundingRadius = data.boundingRadius;
+
+        glGenVertexArrays(1, &mesh.vaoID);
+        glGenBuffers(1, &mesh.vbo);
+        glGenBuffers(1, &mesh.ibo);
+        glGenBuffers(1, &mesh.instanceVbo);
+
+        glBindVertexArray(mesh.vaoID);
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            data.vertices.size() * sizeof(Vertex),
+            data.vertices.data(),
+            GL_STATIC_DRAW
+        );
+
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
+        glVertexAttribPointer(
+            1,
+            2,
+            GL_FLOAT,
+            GL_FALSE,
+            sizeof(Vertex),
+            reinterpret_cast<const GLvoid*>(offsetof(Vertex, tex)) // NOLINT
+        );
+        glVertexAttribPointer(
+            2,
+            3,
+            GL_FLOAT,
+            GL_FALSE,
+            sizeof(Vertex),
+            reinterpret_cast<const GLvoid*>(offsetof(Vertex, normal)) // NOLINT
+        );
+
+        // The per-instance model view transform uses one attribute location per column
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVbo);
+        for (GLuint i = 0; i < 4; ++i) {
+            glEnableVertexAttribArray(3 + i);
+            glVertexAttribPointer(
+                3 + i,
+                4,
+                GL_FLOAT,
+                GL_FALSE,
+                sizeof(glm::mat4),
+                reinterpret_cast<const GLvoid*>(i * sizeof(glm::vec4)) // NOLINT
+            );
+            glVertexAttribDivisor(3 + i, 1);
+        }
+
+        // The indices of all levels of detail are stored in the same buffer
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            data.indices.size() * sizeof(int),
+            data.indices.data(),
+            GL_STATIC_DRAW
+        );
+
+        glBindVertexArray(0);
+    }
 } // namespace
 
 namespace openspace::modelgeometry {
@@ -96,204 +460,150 @@ ModelGeometry::ModelGeometry(const ghoul::Dictionary& dictionary)
     _file = absPath(dictionary.value<std::string>(KeyGeomModelFile));
 }
 
+
 double ModelGeometry::boundingRadius() const {
-    return _boundingRadius;
+    return _mesh ? _mesh->boundingRadius : 0.0;
 }
 
-void ModelGeometry::render() {
-    glBindVertexArray(_vaoID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
-    glDrawElements(
-        _mode,
-        static_cast<GLsizei>(_indices.size()),
-        GL_UNSIGNED_INT,
-        nullptr
-    );
-    glBindVertexArray(0);
+bool ModelGeometry::isReady() const {
+    return _mesh && _mesh->isReady;
 }
 
-void ModelGeometry::changeRenderMode(GLenum mode) {
-    _mode = mode;
+void ModelGeometry::render(int levelOfDetail) {
+    draw(levelOfDetail, 0);
 }
 
-bool ModelGeometry::initialize(Renderable* parent) {
-    float maximumDistanceSquared = 0;
-    for (const Vertex& v : _vertices) {
-        maximumDistanceSquared = glm::max(
-            glm::pow(v.location[0], 2.f) +
-            glm::pow(v.location[1], 2.f) +
-            glm::pow(v.location[2], 2.f), maximumDistanceSquared);
-    }
-    _boundingRadius = maximumDistanceSquared;
-    parent->setBoundingSphere(glm::sqrt(maximumDistanceSquared));
-
-    if (_vertices.empty()) {
-        return false;
+void ModelGeometry::renderInstanced(const std::vector<glm::mat4>& modelViewTransforms,
+                                    int levelOfDetail)
+{
+    if (!isReady()) {
+        return;
     }
 
-    glGenVertexArrays(1, &_vaoID);
-    glGenBuffers(1, &_vbo);
-    glGenBuffers(1, &_ibo);
-
-    glBindVertexArray(_vaoID);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, _mesh->instanceVbo);
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertices.size() * sizeof(Vertex),
-        _vertices.data(),
-        GL_STATIC_DRAW
-    );
-
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
-    glVertexAttribPointer(
-        1,
-        2,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        reinterpret_cast<const GLvoid*>(offsetof(Vertex, tex)) // NOLINT
-    );
-    glVertexAttribPointer(
-        2,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        reinterpret_cast<const GLvoid*>(offsetof(Vertex, normal)) // NOLINT
-    );
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
-    glBufferData(
-        GL_ELEMENT_ARRAY_BUFFER,
-        _indices.size() * sizeof(int),
-        _indices.data(),
-        GL_STATIC_DRAW
+        modelViewTransforms.size() * sizeof(glm::mat4),
+        modelViewTransforms.data(),
+        GL_STREAM_DRAW
     );
-
-    glBindVertexArray(0);
-
-    return true;
+    draw(levelOfDetail, static_cast<GLsizei>(modelViewTransforms.size()));
 }
 
-void ModelGeometry::deinitialize() {
-    glDeleteBuffers(1, &_vbo);
-    glDeleteVertexArrays(1, &_vaoID);
-    glDeleteBuffers(1, &_ibo);
-}
+void ModelGeometry::draw(int levelOfDetail, GLsizei nInstances) {
+    if (!isReady()) {
+        return;
+    }
 
-bool ModelGeometry::loadObj(const std::string& filename) {
-    const std::string& cachedFile = FileSys.cacheManager()->cachedFilename(
-        filename,
-        ghoul::filesystem::CacheManager::Persistent::Yes
+    const size_t level = std::min<size_t>(levelOfDetail, _mesh->levels.size() - 1);
+    const SharedMesh::LevelOfDetail& lod = _mesh->levels[level];
+    const GLsizei nIndices = static_cast<GLsizei>(lod.nIndices);
+    const GLvoid* offset = reinterpret_cast<const GLvoid*>( // NOLINT
+        lod.firstIndex * sizeof(int)
     );
 
-    const bool hasCachedFile = FileSys.fileExists(cachedFile);
-    if (hasCachedFile) {
-        LINFO(fmt::format("Cached file '{}' used for file '{}", cachedFile, filename));
-
-        const bool success = loadCachedFile(cachedFile);
-        if (success) {
-            return true;
-        }
-        else {
-            FileSys.cacheManager()->removeCacheFile(filename);
-        }
+    glBindVertexArray(_mesh->vaoID);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _mesh->ibo);
+    if (nInstances == 0) {
+        glDrawElements(_mode, nIndices, GL_UNSIGNED_INT, offset);
     }
     else {
-        LINFO(fmt::format(
-            "Cached file '{}' for file '{}' not found",
-            cachedFile,
-            filename
-        ));
+        glDrawElementsInstanced(_mode, nIndices, GL_UNSIGNED_INT, offset, nInstances);
     }
+    glBindVertexArray(0);
+}
 
-    LINFO(fmt::format("Loading Model file '{}'", filename));
-    const bool modelSuccess = loadModel(filename);
+bool ModelGeometry::sharesMeshWith(const ModelGeometry& other) const {
+    return isReady() && _mesh == other._mesh && _mode == other._mode;
+}
 
-    if (!modelSuccess) {
-        return false;
+int ModelGeometry::levelOfDetail(float pixelsPerUnit, float threshold) const {
+    if (!isReady()) {
+        return 0;
     }
 
-    LINFO("Saving cache");
-    const bool cacheSuccess = saveCachedFile(cachedFile);
-
-    return cacheSuccess;
+    // The error grows with every level, so the first level that is too coarse ends it
+    int result = 0;
+    for (size_t i = 1; i < _mesh->levels.size(); ++i) {
+        if (_mesh->levels[i].error * pixelsPerUnit > threshold) {
+            break;
+        }
+        result = static_cast<int>(i);
+    }
+    return result;
 }
 
-bool ModelGeometry::saveCachedFile(const std::string& filename) {
-    std::ofstream fileStream(filename, std::ofstream::binary);
-    if (fileStream.good()) {
-        fileStream.write(
-            reinterpret_cast<const char*>(&CurrentCacheVersion),
-            sizeof(int8_t)
-        );
-
-        const int64_t vSize = _vertices.size();
-        fileStream.write(reinterpret_cast<const char*>(&vSize), sizeof(int64_t));
-        const int64_t iSize = _indices.size();
-        fileStream.write(reinterpret_cast<const char*>(&iSize), sizeof(int64_t));
+void ModelGeometry::changeRenderMode(GLenum mode) {
+    _mode = mode;
+}
 
-        fileStream.write(
-            reinterpret_cast<const char*>(_vertices.data()),
-            sizeof(Vertex) * vSize
-        );
-        fileStream.write(
-            reinterpret_cast<const char*>(_indices.data()),
-            sizeof(int) * iSize
+bool ModelGeometry::initialize(Renderable* parent) {
+    _parent = parent;
+
+    auto it = SharedMeshes.find(_file);
+    if (it == SharedMeshes.end()) {
+        it = SharedMeshes.emplace(_file, SharedMesh()).first;
+        SharedMesh* mesh = &it->second;
+
+        // The model is read and processed on a worker thread and only uploaded on the
+        // main thread, so that large models do not stall the initialization
+        std::function<MeshData()> decode = [file = _file, reader = modelReader()]() {
+            return loadMeshData(file, reader);
+        };
+        std::function<bool(MeshData&)> upload = [mesh](MeshData& data) {
+            if (!data.vertices.empty()) {
+                createMesh(*mesh, data);
+            }
+            return true;
+        };
+        std::function<void(MeshData&)> ready = [mesh, file = _file](MeshData& data) {
+            if (data.vertices.empty()) {
+                LERROR(fmt::format("Failed to load model file '{}'", file));
+                return;
+            }
+            mesh->isReady = true;
+            for (ModelGeometry* geometry : mesh->users) {
+                if (geometry->_parent) {
+                    geometry->_parent->setBoundingSphere(mesh->boundingRadius);
+                }
+            }
+        };
+        mesh->loading = global::resourceLoader.load(
+            std::move(decode),
+            std::move(upload),
+            std::move(ready)
         );
-
-        return fileStream.good();
     }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", filename));
-        return false;
+
+    _mesh = &it->second;
+    _mesh->users.push_back(this);
+    if (_parent && _mesh->isReady) {
+        _parent->setBoundingSphere(_mesh->boundingRadius);
     }
-}
 
-bool ModelGeometry::loadCachedFile(const std::string& filename) {
-    std::ifstream fileStream(filename, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed, deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(filename);
-            return false;
-        }
+    return true;
+}
 
-        int64_t vSize;
-        fileStream.read(reinterpret_cast<char*>(&vSize), sizeof(int64_t));
-        int64_t iSize;
-        fileStream.read(reinterpret_cast<char*>(&iSize), sizeof(int64_t));
+void ModelGeometry::deinitialize() {
+    if (!_mesh) {
+        return;
+    }
 
-        if (vSize == 0 || iSize == 0) {
-            LERROR(
-                fmt::format("Error opening file '{}' for loading cache file", filename)
-            );
-            return false;
+    std::vector<ModelGeometry*>& users = _mesh->users;
+    users.erase(std::remove(users.begin(), users.end(), this), users.end());
+    if (users.empty()) {
+        _mesh->loading.cancel();
+        if (_mesh->vaoID != 0) {
+            glDeleteBuffers(1, &_mesh->vbo);
+            glDeleteVertexArrays(1, &_mesh->vaoID);
+            glDeleteBuffers(1, &_mesh->ibo);
+            glDeleteBuffers(1, &_mesh->instanceVbo);
         }
-
-        _vertices.resize(vSize);
-        _indices.resize(iSize);
-
-        fileStream.read(
-            reinterpret_cast<char*>(_vertices.data()), sizeof(Vertex) * vSize
-        );
-        fileStream.read(reinterpret_cast<char*>(_indices.data()), sizeof(int) * iSize);
-
-        return fileStream.good();
-    }
-    else {
-        LERROR(fmt::format(
-            "Error opening file '{}' for loading cache file",
-            filename
-        ));
-        return false;
+        SharedMeshes.erase(_file);
     }
+
+    _mesh = nullptr;
+    _parent = nullptr;
 }
 
 void ModelGeometry::setUniforms(ghoul::opengl::ProgramObject&) {}
@@ -27,8 +27,11 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 namespace ghoul::opengl { class ProgramObject; }
@@ -38,6 +41,8 @@ namespace openspace::documentation { struct Documentation; }
 
 namespace openspace::modelgeometry {
 
+struct SharedMesh;
+
 class ModelGeometry : public properties::PropertyOwner {
 public:
     struct Vertex {
@@ -46,6 +51,10 @@ public:
         GLfloat normal[3];
     };
 
+    /// Reads the vertices and the triangle list of the model \p filename
+    using ModelReader = std::function<bool(const std::string& filename,
+        std::vector<Vertex>& vertices, std::vector<int>& indices)>;
+
     static std::unique_ptr<ModelGeometry> createFromDictionary(
         const ghoul::Dictionary& dictionary
     );
@@ -53,14 +62,47 @@ public:
     ModelGeometry(const ghoul::Dictionary& dictionary);
     virtual ~ModelGeometry() = default;
 
+    /**
+     * Starts loading the model file on a worker thread, unless another geometry already
+     * uses the same file. The geometry is not rendered until #isReady returns \c true,
+     * at which point the bounding sphere of the \p parent is updated, unless \p parent
+     * is \c nullptr.
+     */
     virtual bool initialize(Renderable* parent);
     virtual void deinitialize();
-    void render();
 
-    virtual bool loadModel(const std::string& filename) = 0;
+    /// Returns \c true if the mesh of this geometry has been uploaded to the GPU
+    bool isReady() const;
+
+    void render(int levelOfDetail = 0);
+
+    /**
+     * Renders \p modelViewTransforms.size() instances of this geometry with a single
+     * draw call. The model view transforms are provided to the vertex shader as the
+     * per-instance attribute in locations 3-6.
+     */
+    void renderInstanced(const std::vector<glm::mat4>& modelViewTransforms,
+        int levelOfDetail = 0);
+
+    /**
+     * Returns \c true if this geometry and \p other render the same GPU mesh in the
+     * same mode, meaning that both can be drawn as instances of a single draw call.
+     */
+    bool sharesMeshWith(const ModelGeometry& other) const;
+
+    /**
+     * Returns the coarsest level of detail whose simplification error stays below
+     * \p threshold pixels if one unit in model space covers \p pixelsPerUnit pixels on
+     * the screen. Level 0 is the original mesh.
+     */
+    int levelOfDetail(float pixelsPerUnit, float threshold) const;
+
+    /**
+     * Returns the function that reads the model files of this geometry type. The
+     * function is executed on a worker thread and must not refer to this geometry.
+     */
+    virtual ModelReader modelReader() const = 0;
     void changeRenderMode(const GLenum mode);
-    //bool getVertices(std::vector<Vertex>* vertexList);
-    //bool getIndices(std::vector<int>* indexList);
 
     double boundingRadius() const;
 
@@ -69,20 +111,14 @@ public:
     static documentation::Documentation Documentation();
 
 protected:
-    bool loadObj(const std::string& filename);
-    bool loadCachedFile(const std::string& filename);
-    bool saveCachedFile(const std::string& filename);
-
-    GLuint _vaoID = 0;
-    GLuint _vbo = 0;
-    GLuint _ibo = 0 ;
     GLenum _mode = GL_TRIANGLES;
+    std::string _file;
 
-    double _boundingRadius = 0.0;
+private:
+    void draw(int levelOfDetail, GLsizei nInstances);
 
-    std::vector<Vertex> _vertices;
-    std::vector<int> _indices;
-    std::string _file;
+    SharedMesh* _mesh = nullptr;
+    Renderable* _parent = nullptr;
 };
 
 }  // namespace openspace::modelgeometry
@@ -31,30 +31,26 @@ namespace openspace::modelgeometry {
 
 MultiModelGeometry::MultiModelGeometry(const ghoul::Dictionary& dictionary)
     : ModelGeometry(dictionary)
-{
-    loadObj(_file);
-}
-
-bool MultiModelGeometry::loadModel(const std::string& filename) {
-    std::vector<ghoul::io::ModelReaderBase::Vertex> vertices;
-    std::vector<int> indices;
-    ghoul::io::ModelReaderMultiFormat().loadModel(filename, vertices, indices);
-
-    _vertices.reserve(vertices.size());
-    for (const ghoul::io::ModelReaderBase::Vertex& v : vertices) {
-        Vertex vv {};
-        memcpy(vv.location, v.location, sizeof(GLfloat) * 3);
-        vv.location[3] = 1.0;
-        //memcpy(vv.location, glm::value_ptr(p.vec4()), sizeof(GLfloat) * 4);
-        memcpy(vv.tex, v.tex, sizeof(GLfloat) * 2);
-        memcpy(vv.normal, v.normal, sizeof(GLfloat) * 3);
-        _vertices.push_back(vv);
-    }
-
-    _indices.resize(indices.size());
-    std::copy(indices.begin(), indices.end(), _indices.begin());
-
-    return true;
+{}
+
+ModelGeometry::ModelReader MultiModelGeometry::modelReader() const {
+    return [](const std::string& filename, std::vector<Vertex>& result,
+              std::vector<int>& indices)
+    {
+        std::vector<ghoul::io::ModelReaderBase::Vertex> vertices;
+        ghoul::io::ModelReaderMultiFormat().loadModel(filename, vertices, indices);
+
+        result.reserve(vertices.size());
+        for (const ghoul::io::ModelReaderBase::Vertex& v : vertices) {
+            Vertex vv {};
+            memcpy(vv.location, v.location, sizeof(GLfloat) * 3);
+            vv.location[3] = 1.0;
+            memcpy(vv.tex, v.tex, sizeof(GLfloat) * 2);
+            memcpy(vv.normal, v.normal, sizeof(GLfloat) * 3);
+            result.push_back(vv);
+        }
+        return true;
+    };
 }
 
 }  // namespace openspace::modelgeometry
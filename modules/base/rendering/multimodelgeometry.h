@@ -39,7 +39,7 @@ public:
     MultiModelGeometry(const ghoul::Dictionary& dictionary);
 
 private:
-    virtual bool loadModel(const std::string& filename) override;
+    virtual ModelReader modelReader() const override;
 };
 
 }  // namespace openspace::modelgeometry
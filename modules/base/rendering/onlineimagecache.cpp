@@ -0,0 +1,410 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/base/rendering/onlineimagecache.h>
+
+#include <openspace/engine/globals.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <stb_image.h>
+
+namespace {
+    constexpr const char* _loggerCat = "OnlineImageCache";
+
+    constexpr const char* CacheName = "onlineimage";
+
+    // All images are expanded to 8 bit RGBA when they are decoded
+    constexpr const int NChannels = 4;
+
+    // The number of bytes that are uploaded per frame. The level that is uploaded when
+    // the budget is exceeded is always completed, so at least one level gets resident
+    // each frame
+    constexpr const size_t UploadBudget = 16 * 1024 * 1024;
+
+    int maxConcurrentDecodes() {
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+    }
+
+    glm::ivec2 encodedSize(const std::vector<unsigned char>& data) {
+        int x = 0;
+        int y = 0;
+        int comp = 0;
+        const int success = stbi_info_from_memory(
+            data.data(),
+            static_cast<int>(data.size()),
+            &x,
+            &y,
+            &comp
+        );
+        return success ? glm::ivec2(x, y) : glm::ivec2(0);
+    }
+
+    // Averages 2x2 blocks of the source level into the destination level. Levels with an
+    // odd size reuse the last row or column
+    void downsample(const unsigned char* src, const glm::ivec2& srcSize,
+                    unsigned char* dst, const glm::ivec2& dstSize)
+    {
+        for (int y = 0; y < dstSize.y; ++y) {
+            const int y0 = std::min(2 * y, srcSize.y - 1);
+            const int y1 = std::min(2 * y + 1, srcSize.y - 1);
+            for (int x = 0; x < dstSize.x; ++x) {
+                const int x0 = std::min(2 * x, srcSize.x - 1);
+                const int x1 = std::min(2 * x + 1, srcSize.x - 1);
+
+                const unsigned char* p00 = src + (y0 * srcSize.x + x0) * NChannels;
+                const unsigned char* p01 = src + (y0 * srcSize.x + x1) * NChannels;
+                const unsigned char* p10 = src + (y1 * srcSize.x + x0) * NChannels;
+                const unsigned char* p11 = src + (y1 * srcSize.x + x1) * NChannels;
+                unsigned char* d = dst + (y * dstSize.x + x) * NChannels;
+                for (int c = 0; c < NChannels; ++c) {
+                    d[c] = static_cast<unsigned char>(
+                        (p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4
+                    );
+                }
+            }
+        }
+    }
+} // namespace
+
+namespace openspace {
+
+OnlineImageCache::~OnlineImageCache() {
+    // The worker threads might still be writing into mapped buffers
+    for (std::pair<const std::string, Entry>& p : _entries) {
+        if (p.second.decode.valid()) {
+            p.second.decode.wait();
+        }
+    }
+}
+
+std::shared_ptr<const OnlineImageCache::Image> OnlineImageCache::request(
+                                                                   const std::string& url)
+{
+    auto it = _entries.find(url);
+    if (it != _entries.end()) {
+        return it->second.image;
+    }
+
+    Entry entry;
+    entry.url = url;
+    entry.image = std::make_shared<Image>();
+
+    const std::string cacheFile = FileSys.cacheManager()->cachedFilename(
+        CacheName,
+        url,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+    if (FileSys.fileExists(cacheFile)) {
+        LDEBUG(fmt::format("Loading image '{}' from cache '{}'", url, cacheFile));
+        entry.state = Entry::State::Reading;
+        entry.read = std::async(std::launch::async, [cacheFile]() {
+            EncodedImage result;
+            std::ifstream file(cacheFile, std::ifstream::binary | std::ifstream::ate);
+            const std::streamsize size = file.tellg();
+            if (size <= 0) {
+                return result;
+            }
+            file.seekg(0);
+            result.data.resize(static_cast<size_t>(size));
+            file.read(reinterpret_cast<char*>(result.data.data()), size);
+            result.size = encodedSize(result.data);
+            return result;
+        });
+    }
+    else {
+        entry.state = Entry::State::Downloading;
+        entry.download = global::downloadManager.fetchFile(
+            url,
+            DownloadManager::SuccessCallback(),
+            [url](const std::string& err) {
+                LDEBUG(fmt::format("Download of image '{}' failed: {}", url, err));
+            }
+        );
+    }
+
+    std::shared_ptr<const Image> image = entry.image;
+    _entries.emplace(url, std::move(entry));
+    return image;
+}
+
+void OnlineImageCache::update() {
+    size_t budget = UploadBudget;
+
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        Entry& e = it->second;
+
+        // Nobody is using this image anymore. If it is requested again, it is read from
+        // the file cache instead of being downloaded. Running worker threads are allowed
+        // to finish first, as waiting for them here would stall the frame
+        const bool isWorking =
+            e.state == Entry::State::Reading || e.state == Entry::State::Decoding;
+        if (e.image.use_count() == 1 && !isWorking) {
+            releaseEntry(e);
+            it = _entries.erase(it);
+            continue;
+        }
+
+        switch (e.state) {
+            case Entry::State::Downloading:
+                if (e.download.valid() && DownloadManager::futureReady(e.download)) {
+                    DownloadManager::MemoryFile file = e.download.get();
+                    if (file.corrupted) {
+                        LERROR(fmt::format("Error loading image from URL '{}'", e.url));
+                        free(file.buffer);
+                        e.state = Entry::State::Failed;
+                        e.image->isFailed = true;
+                        break;
+                    }
+
+                    const std::string cacheFile = FileSys.cacheManager()->cachedFilename(
+                        CacheName,
+                        e.url,
+                        ghoul::filesystem::CacheManager::Persistent::Yes
+                    );
+                    e.state = Entry::State::Reading;
+                    e.read = std::async(std::launch::async, [file, cacheFile]() {
+                        EncodedImage result;
+                        result.data.assign(file.buffer, file.buffer + file.size);
+                        free(file.buffer);
+                        result.size = encodedSize(result.data);
+                        if (result.size.x > 0) {
+                            std::ofstream f(cacheFile, std::ofstream::binary);
+                            f.write(
+                                reinterpret_cast<const char*>(result.data.data()),
+                                result.data.size()
+                            );
+                        }
+                        return result;
+                    });
+                }
+                break;
+            case Entry::State::Reading:
+                if (_nDecoding < maxConcurrentDecodes() &&
+                    DownloadManager::futureReady(e.read))
+                {
+                    e.encoded = e.read.get();
+                    if (e.encoded.size.x <= 0 || e.encoded.size.y <= 0) {
+                        LERROR(fmt::format("Error decoding image from URL '{}'", e.url));
+                        e.state = Entry::State::Failed;
+                        e.image->isFailed = true;
+                        break;
+                    }
+                    startDecoding(e);
+                }
+                break;
+            case Entry::State::Decoding:
+                if (DownloadManager::futureReady(e.decode)) {
+                    --_nDecoding;
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, e.pbo);
+                    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    e.encoded = EncodedImage();
+
+                    if (!e.decode.get()) {
+                        LERROR(fmt::format("Error decoding image from URL '{}'", e.url));
+                        releaseEntry(e);
+                        e.state = Entry::State::Failed;
+                        e.image->isFailed = true;
+                        break;
+                    }
+                    e.state = Entry::State::Uploading;
+                    e.nextLevel = static_cast<int>(e.levels.size()) - 1;
+                }
+                break;
+            case Entry::State::Uploading:
+                if (budget > 0) {
+                    const size_t uploaded = uploadLevels(e, budget);
+                    budget -= std::min(uploaded, budget);
+                }
+                break;
+            case Entry::State::Done:
+            case Entry::State::Failed:
+                break;
+        }
+        ++it;
+    }
+}
+
+void OnlineImageCache::startDecoding(Entry& entry) {
+    const glm::ivec2 size = entry.encoded.size;
+    entry.image->dimensions = size;
+
+    const int nLevels = 1 + static_cast<int>(
+        std::floor(std::log2(static_cast<float>(std::max(size.x, size.y))))
+    );
+    size_t totalSize = 0;
+    entry.levels.clear();
+    for (int l = 0; l < nLevels; ++l) {
+        const glm::ivec2 s = glm::max(glm::ivec2(size.x >> l, size.y >> l), 1);
+        entry.levels.push_back({ totalSize, s });
+        totalSize += static_cast<size_t>(s.x) * s.y * NChannels;
+    }
+
+    glGenBuffers(1, &entry.pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, entry.pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+    unsigned char* buffer = reinterpret_cast<unsigned char*>(glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER,
+        0,
+        totalSize,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+    ));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!buffer) {
+        LERROR(fmt::format("Could not map buffer for image from URL '{}'", entry.url));
+        releaseEntry(entry);
+        entry.encoded = EncodedImage();
+        entry.state = Entry::State::Failed;
+        entry.image->isFailed = true;
+        return;
+    }
+    entry.state = Entry::State::Decoding;
+    ++_nDecoding;
+
+    // The encoded data and the levels are not touched by the main thread until the
+    // decoding is finished
+    const EncodedImage* encoded = &entry.encoded;
+    const std::vector<MipLevel>* levels = &entry.levels;
+    entry.decode = std::async(std::launch::async, [encoded, levels, buffer]() {
+        int x = 0;
+        int y = 0;
+        int n = 0;
+        unsigned char* pixels = stbi_load_from_memory(
+            encoded->data.data(),
+            static_cast<int>(encoded->data.size()),
+            &x,
+            &y,
+            &n,
+            NChannels
+        );
+        if (!pixels) {
+            return false;
+        }
+        const glm::ivec2 size = (*levels)[0].size;
+        if (x != size.x || y != size.y) {
+            stbi_image_free(pixels);
+            return false;
+        }
+
+        // The image is stored top row first, but OpenGL expects the bottom row first,
+        // which is the same orientation that the TextureReader produces
+        const size_t rowSize = static_cast<size_t>(size.x) * NChannels;
+        for (int row = 0; row < size.y; ++row) {
+            std::memcpy(
+                buffer + row * rowSize,
+                pixels + (size.y - 1 - row) * rowSize,
+                rowSize
+            );
+        }
+        stbi_image_free(pixels);
+
+        for (size_t l = 1; l < levels->size(); ++l) {
+            const MipLevel& src = (*levels)[l - 1];
+            const MipLevel& dst = (*levels)[l];
+            downsample(buffer + src.offset, src.size, buffer + dst.offset, dst.size);
+        }
+        return true;
+    });
+}
+
+size_t OnlineImageCache::uploadLevels(Entry& entry, size_t budget) {
+    Image& image = *entry.image;
+    const int nLevels = static_cast<int>(entry.levels.size());
+    if (image.texture == 0) {
+        glGenTextures(1, &image.texture);
+        glBindTexture(GL_TEXTURE_2D, image.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, nLevels - 1);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, image.texture);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, entry.pbo);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    size_t uploaded = 0;
+    while (entry.nextLevel >= 0 && uploaded < budget) {
+        const MipLevel& level = entry.levels[entry.nextLevel];
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            entry.nextLevel,
+            GL_RGBA8,
+            level.size.x,
+            level.size.y,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            reinterpret_cast<void*>(level.offset) // NOLINT
+        );
+        uploaded += static_cast<size_t>(level.size.x) * level.size.y * NChannels;
+
+        // All levels from this one to the smallest are defined, so the texture is
+        // complete when sampling starts at this level
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, entry.nextLevel);
+        --entry.nextLevel;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (entry.nextLevel < 0) {
+        glDeleteBuffers(1, &entry.pbo);
+        entry.pbo = 0;
+        entry.levels.clear();
+        entry.state = Entry::State::Done;
+    }
+    return uploaded;
+}
+
+void OnlineImageCache::releaseEntry(Entry& entry) {
+    if (entry.pbo != 0) {
+        glDeleteBuffers(1, &entry.pbo);
+        entry.pbo = 0;
+    }
+    if (entry.image->texture != 0) {
+        glDeleteTextures(1, &entry.image->texture);
+        entry.image->texture = 0;
+    }
+}
+
+void OnlineImageCache::deinitializeGL() {
+    for (std::pair<const std::string, Entry>& p : _entries) {
+        if (p.second.decode.valid()) {
+            p.second.decode.wait();
+        }
+        releaseEntry(p.second);
+    }
+    _entries.clear();
+    _nDecoding = 0;
+}
+
+} // namespace openspace
@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_BASE___ONLINEIMAGECACHE___H__
+#define __OPENSPACE_MODULE_BASE___ONLINEIMAGECACHE___H__
+
+#include <openspace/engine/downloadmanager.h>
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A cache of images that are loaded from URLs and shared between all renderables that
+ * show the same URL. The downloaded files are also persisted in the CacheManager, so that
+ * an image is only downloaded once even across multiple runs. Decoding the images and
+ * computing their mipmap levels happens on worker threads directly into a pixel buffer
+ * object. The levels are then uploaded over the following frames, starting with the
+ * smallest one, so that an image is shown at a low resolution almost immediately and
+ * becomes sharper as the larger levels become resident.
+ */
+class OnlineImageCache {
+public:
+    struct Image {
+        /// The OpenGL name of the texture, which is \c 0 until the first level is
+        /// resident
+        GLuint texture = 0;
+
+        /// The size of the full resolution image, which is known before any of the
+        /// levels are resident
+        glm::ivec2 dimensions = glm::ivec2(0);
+
+        /// Is \c true if the image could not be downloaded or decoded
+        bool isFailed = false;
+    };
+
+    ~OnlineImageCache();
+
+    /**
+     * Returns the image that is loaded from the \p url, starting the download if the
+     * \p url has not been requested before. The image stays in the cache as long as any
+     * of the returned pointers are alive.
+     */
+    std::shared_ptr<const Image> request(const std::string& url);
+
+    /// Advances the downloads, decodes, and uploads of all images. This has to be called
+    /// once per frame from the thread that owns the OpenGL context
+    void update();
+
+    void deinitializeGL();
+
+private:
+    struct MipLevel {
+        size_t offset;
+        glm::ivec2 size;
+    };
+
+    struct EncodedImage {
+        std::vector<unsigned char> data;
+        glm::ivec2 size = glm::ivec2(0);
+    };
+
+    struct Entry {
+        enum class State {
+            Downloading,
+            Reading,
+            Decoding,
+            Uploading,
+            Done,
+            Failed
+        };
+
+        std::string url;
+        std::shared_ptr<Image> image;
+        State state = State::Downloading;
+
+        std::future<DownloadManager::MemoryFile> download;
+        std::future<EncodedImage> read;
+        std::future<bool> decode;
+
+        EncodedImage encoded;
+        std::vector<MipLevel> levels;
+        GLuint pbo = 0;
+        int nextLevel = 0;
+    };
+
+    /// Maps a pixel buffer object that is large enough for all levels of the \p entry
+    /// and starts decoding the image into it on a worker thread
+    void startDecoding(Entry& entry);
+
+    /// Uploads the next levels of the \p entry and returns the number of uploaded bytes
+    size_t uploadLevels(Entry& entry, size_t budget);
+
+    void releaseEntry(Entry& entry);
+
+    std::map<std::string, Entry> _entries;
+    int _nDecoding = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_BASE___ONLINEIMAGECACHE___H__
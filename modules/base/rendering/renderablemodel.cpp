@@ -29,6 +29,7 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/rendering/compressedtexture.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
@@ -36,23 +37,35 @@
 #include <openspace/scene/lightsource.h>
 
 #include <ghoul/filesystem/filesystem.h>
-#include <ghoul/io/texture/texturereader.h>
 #include <ghoul/misc/invariants.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 
 namespace {
     constexpr const char* ProgramName = "ModelProgram";
     constexpr const char* KeyGeometry = "Geometry";
 
-    constexpr const std::array<const char*, 11> UniformNames = {
+    constexpr const std::array<const char*, 10> UniformNames = {
         "opacity", "nLightSources", "lightDirectionsViewSpace", "lightIntensities",
-        "modelViewTransform", "projectionTransform", "performShading", "texture1",
-        "ambientIntensity", "diffuseIntensity", "specularIntensity"
+        "projectionTransform", "performShading", "texture1", "ambientIntensity",
+        "diffuseIntensity", "specularIntensity"
     };
 
+    // Light directions that differ by less than this are considered to be the same when
+    // deciding whether two models can be drawn in the same instanced batch
+    constexpr const float LightDirectionEpsilon = 1e-4f;
+
+    // All models that use the same geometry, texture and shading state are collected
+    // during a Scene::render call and drawn with a single instanced draw call afterwards
+    struct InstanceBatch {
+        openspace::RenderableModel* leader = nullptr;
+        std::vector<glm::mat4> modelViewTransforms;
+    };
+    std::vector<std::unique_ptr<InstanceBatch>> InstanceBatches;
+
     constexpr openspace::properties::Property::PropertyInfo TextureInfo = {
         "ColorTexture",
         "Color Texture",
@@ -104,6 +117,15 @@ namespace {
         "Rotation Vector using degrees"
     };
 
+    constexpr openspace::properties::Property::PropertyInfo LodThresholdInfo = {
+        "LodThreshold",
+        "Level of detail threshold (pixels)",
+        "This value determines the largest error (in pixels on the screen) that a "
+        "simplified level of detail of the model can have. Models that are far away "
+        "are rendered with a coarser mesh as long as its error stays below this value. "
+        "A value of 0 always renders the full mesh."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo LightSourcesInfo = {
         "LightSources",
         "Light Sources",
@@ -173,6 +195,12 @@ documentation::Documentation RenderableModel::Documentation() {
                 Optional::Yes,
                 RotationVecInfo.description
             },
+            {
+                LodThresholdInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                LodThresholdInfo.description
+            },
             {
                 LightSourcesInfo.identifier,
                 new TableVerifier({
@@ -204,6 +232,7 @@ RenderableModel::RenderableModel(const ghoul::Dictionary& dictionary)
         glm::dmat3(1.0)
     )
     , _rotationVec(RotationVecInfo, glm::dvec3(0.0), glm::dvec3(0.0), glm::dvec3(360.0))
+    , _lodThreshold(LodThresholdInfo, 1.f, 0.f, 20.f)
     , _lightSourcePropertyOwner({ "LightSources", "Light Sources" })
 {
     documentation::testSpecificationAndThrow(
@@ -249,6 +278,12 @@ RenderableModel::RenderableModel(const ghoul::Dictionary& dictionary)
         _disableFaceCulling = dictionary.value<bool>(DisableFaceCullingInfo.identifier);
     }
 
+    if (dictionary.hasKey(LodThresholdInfo.identifier)) {
+        _lodThreshold = static_cast<float>(
+            dictionary.value<double>(LodThresholdInfo.identifier)
+        );
+    }
+
     if (dictionary.hasKey(LightSourcesInfo.identifier)) {
         const ghoul::Dictionary& lsDictionary =
             dictionary.value<ghoul::Dictionary>(LightSourcesInfo.identifier);
@@ -276,6 +311,7 @@ RenderableModel::RenderableModel(const ghoul::Dictionary& dictionary)
     addProperty(_disableFaceCulling);
     addProperty(_modelTransform);
     addProperty(_rotationVec);
+    addProperty(_lodThreshold);
 
     _rotationVec.onChange([this]() {
         glm::vec3 degreeVector = _rotationVec;
@@ -289,7 +325,7 @@ RenderableModel::RenderableModel(const ghoul::Dictionary& dictionary)
 }
 
 bool RenderableModel::isReady() const {
-    return _program && _texture;
+    return _program && _texture && _geometry && _geometry->isReady();
 }
 
 void RenderableModel::initialize() {
@@ -318,11 +354,8 @@ void RenderableModel::initializeGL() {
 }
 
 void RenderableModel::deinitializeGL() {
-    if (_geometry) {
-        _geometry->deinitialize();
-        _geometry = nullptr;
-    }
-    _texture = nullptr;
+    releaseGLResources();
+    _geometry = nullptr;
 
     BaseModule::ProgramObjectManager.release(
         ProgramName,
@@ -333,11 +366,37 @@ void RenderableModel::deinitializeGL() {
     _program = nullptr;
 }
 
-void RenderableModel::render(const RenderData& data, RendererTasks&) {
-    _program->activate();
+bool RenderableModel::canReleaseGLResources() const {
+    return true;
+}
 
-    _program->setUniform(_uniformCache.opacity, _opacity);
+void RenderableModel::releaseGLResources() {
+    for (const std::unique_ptr<InstanceBatch>& batch : InstanceBatches) {
+        if (batch->leader == this) {
+            batch->leader = nullptr;
+            batch->modelViewTransforms.clear();
+        }
+    }
+
+    // The program is shared between all models and is kept, but the mesh and texture
+    // are only kept alive by the models that are still using them
+    if (_geometry) {
+        _geometry->deinitialize();
+    }
+    if (_texture) {
+        BaseModule::TextureManager.release(_texture);
+        _texture = nullptr;
+    }
+}
+
+void RenderableModel::restoreGLResources() {
+    loadTexture();
+    // The mesh is loaded on a worker thread and the model is not ready until it has been
+    // uploaded
+    _geometry->initialize(this);
+}
 
+void RenderableModel::render(const RenderData& data, RendererTasks& rendererTask) {
     // Model transform and view transform needs to be in double precision
     const glm::dmat4 modelTransform =
         glm::translate(glm::dmat4(1.0), data.modelTransform.translation) * // Translation
@@ -348,41 +407,128 @@ void RenderableModel::render(const RenderData& data, RendererTasks&) {
     const glm::dmat4 modelViewTransform = data.camera.combinedViewMatrix() *
                                           modelTransform;
 
-    int nLightSources = 0;
+    // Use the coarsest level of detail whose error is not visible at this distance
+    _levelOfDetail = 0;
+    const double distance = glm::length(glm::dvec3(modelViewTransform[3]));
+    if (_lodThreshold > 0.f && distance > 0.0) {
+        const double unitsToView = glm::length(glm::dvec3(modelViewTransform[0]));
+        const double viewToPixels = data.camera.projectionMatrix()[1][1] *
+            global::renderEngine.renderingResolution().y / 2.0;
+        const double pixelsPerUnit = unitsToView * viewToPixels / distance;
+        _levelOfDetail = _geometry->levelOfDetail(
+            static_cast<float>(pixelsPerUnit),
+            _lodThreshold
+        );
+    }
+
+    _nLightSources = 0;
     _lightIntensitiesBuffer.resize(_lightSources.size());
     _lightDirectionsViewSpaceBuffer.resize(_lightSources.size());
     for (const std::unique_ptr<LightSource>& lightSource : _lightSources) {
         if (!lightSource->isEnabled()) {
             continue;
         }
-        _lightIntensitiesBuffer[nLightSources] = lightSource->intensity();
-        _lightDirectionsViewSpaceBuffer[nLightSources] =
+        _lightIntensitiesBuffer[_nLightSources] = lightSource->intensity();
+        _lightDirectionsViewSpaceBuffer[_nLightSources] =
             lightSource->directionViewSpace(data);
 
-        ++nLightSources;
+        ++_nLightSources;
+    }
+
+    // Join an existing batch of identical models if there is one, or start a new batch
+    // that is drawn once all scene graph nodes have been rendered
+    InstanceBatch* batch = nullptr;
+    for (const std::unique_ptr<InstanceBatch>& b : InstanceBatches) {
+        if (!b->modelViewTransforms.empty() && b->leader->canBatchWith(*this)) {
+            batch = b.get();
+            break;
+        }
+    }
+    if (!batch) {
+        auto it = std::find_if(
+            InstanceBatches.begin(),
+            InstanceBatches.end(),
+            [](const std::unique_ptr<InstanceBatch>& b) {
+                return b->modelViewTransforms.empty();
+            }
+        );
+        if (it == InstanceBatches.end()) {
+            InstanceBatches.push_back(std::make_unique<InstanceBatch>());
+            it = InstanceBatches.end() - 1;
+        }
+        batch = it->get();
+        batch->leader = this;
+
+        rendererTask.batchedDrawTasks.push_back(
+            [batch, projection = data.camera.projectionMatrix()]() {
+                if (batch->leader) {
+                    batch->leader->renderInstances(
+                        projection,
+                        batch->modelViewTransforms
+                    );
+                }
+                batch->modelViewTransforms.clear();
+            }
+        );
+    }
+    batch->modelViewTransforms.push_back(glm::mat4(modelViewTransform));
+}
+
+bool RenderableModel::canBatchWith(const RenderableModel& other) const {
+    if (!_geometry->sharesMeshWith(*other._geometry) || _texture != other._texture ||
+        _levelOfDetail != other._levelOfDetail)
+    {
+        return false;
+    }
+
+    const bool sameState = _opacity.value() == other._opacity.value() &&
+        _ambientIntensity.value() == other._ambientIntensity.value() &&
+        _diffuseIntensity.value() == other._diffuseIntensity.value() &&
+        _specularIntensity.value() == other._specularIntensity.value() &&
+        _performShading.value() == other._performShading.value() &&
+        _disableFaceCulling.value() == other._disableFaceCulling.value() &&
+        _nLightSources == other._nLightSources;
+    if (!sameState) {
+        return false;
     }
 
+    for (int i = 0; i < _nLightSources; ++i) {
+        const bool sameLight =
+            _lightIntensitiesBuffer[i] == other._lightIntensitiesBuffer[i] &&
+            glm::length(
+                _lightDirectionsViewSpaceBuffer[i] -
+                other._lightDirectionsViewSpaceBuffer[i]
+            ) < LightDirectionEpsilon;
+        if (!sameLight) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RenderableModel::renderInstances(const glm::mat4& projectionTransform,
+                                      const std::vector<glm::mat4>& modelViewTransforms)
+{
+    _program->activate();
+
+    _program->setUniform(_uniformCache.opacity, _opacity);
     _program->setUniform(
         _uniformCache.nLightSources,
-        nLightSources
+        _nLightSources
     );
     _program->setUniform(
         _uniformCache.lightIntensities,
         _lightIntensitiesBuffer.data(),
-        nLightSources
+        _nLightSources
     );
     _program->setUniform(
         _uniformCache.lightDirectionsViewSpace,
         _lightDirectionsViewSpaceBuffer.data(),
-        nLightSources
-    );
-    _program->setUniform(
-        _uniformCache.modelViewTransform,
-        glm::mat4(modelViewTransform)
+        _nLightSources
     );
     _program->setUniform(
         _uniformCache.projectionTransform,
-        data.camera.projectionMatrix()
+        projectionTransform
     );
     _program->setUniform(
         _uniformCache.ambientIntensity,
@@ -413,7 +559,7 @@ void RenderableModel::render(const RenderData& data, RendererTasks&) {
         glDisable(GL_CULL_FACE);
     }
 
-    _geometry->render();
+    _geometry->renderInstanced(modelViewTransforms, _levelOfDetail);
 
     if (_disableFaceCulling) {
         glEnable(GL_CULL_FACE);
@@ -430,19 +576,33 @@ void RenderableModel::update(const UpdateData&) {
 }
 
 void RenderableModel::loadTexture() {
+    // Textures are shared between all models that use the same file, which also lets
+    // those models be drawn in the same instanced batch
+    ghoul::opengl::Texture* t = _texture;
     _texture = nullptr;
     if (!_colorTexturePath.value().empty()) {
-        _texture = ghoul::io::TextureReader::ref().loadTexture(
-            absPath(_colorTexturePath)
+        _texture = BaseModule::TextureManager.request(
+            absPath(_colorTexturePath),
+            [path = absPath(_colorTexturePath)]()
+                -> std::unique_ptr<ghoul::opengl::Texture>
+            {
+                std::unique_ptr<ghoul::opengl::Texture> texture =
+                    rendering::loadTexture(
+                        path,
+                        ghoul::opengl::Texture::FilterMode::AnisotropicMipMap
+                    );
+                if (texture) {
+                    LDEBUGC(
+                        "RenderableModel",
+                        fmt::format("Loaded texture from '{}'", path)
+                    );
+                }
+                return texture;
+            }
         );
-        if (_texture) {
-            LDEBUGC(
-                "RenderableModel",
-                fmt::format("Loaded texture from '{}'", absPath(_colorTexturePath))
-            );
-            _texture->uploadTexture();
-            _texture->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
-        }
+    }
+    if (t) {
+        BaseModule::TextureManager.release(t);
     }
 }
 
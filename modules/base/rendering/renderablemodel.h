@@ -63,6 +63,10 @@ public:
 
     bool isReady() const override;
 
+    bool canReleaseGLResources() const override;
+    void releaseGLResources() override;
+    void restoreGLResources() override;
+
     void render(const RenderData& data, RendererTasks& rendererTask) override;
     void update(const UpdateData& data) override;
 
@@ -72,6 +76,17 @@ protected:
     void loadTexture();
 
 private:
+    /**
+     * Returns \c true if this model and \p other use the same geometry, texture, and
+     * shading state for the current frame, so that both can be drawn as instances of a
+     * single draw call.
+     */
+    bool canBatchWith(const RenderableModel& other) const;
+
+    /// Draws all \p modelViewTransforms with this model's state as one instanced call
+    void renderInstances(const glm::mat4& projectionTransform,
+        const std::vector<glm::mat4>& modelViewTransforms);
+
     std::unique_ptr<modelgeometry::ModelGeometry> _geometry;
 
     properties::StringProperty _colorTexturePath;
@@ -85,16 +100,21 @@ private:
     properties::BoolProperty _disableFaceCulling;
     properties::DMat4Property _modelTransform;
     properties::Vec3Property _rotationVec;
+    properties::FloatProperty _lodThreshold;
+
+    // The level of detail of the geometry that is used in the current frame
+    int _levelOfDetail = 0;
 
     ghoul::opengl::ProgramObject* _program = nullptr;
     UniformCache(opacity, nLightSources, lightDirectionsViewSpace, lightIntensities,
-        modelViewTransform, projectionTransform, performShading, texture,
-        ambientIntensity, diffuseIntensity, specularIntensity) _uniformCache;
+        projectionTransform, performShading, texture, ambientIntensity,
+        diffuseIntensity, specularIntensity) _uniformCache;
 
-    std::unique_ptr<ghoul::opengl::Texture> _texture;
+    ghoul::opengl::Texture* _texture = nullptr;
     std::vector<std::unique_ptr<LightSource>> _lightSources;
 
     // Buffers for uniform uploading
+    int _nLightSources = 0;
     std::vector<float> _lightIntensitiesBuffer;
     std::vector<glm::vec3> _lightDirectionsViewSpaceBuffer;
 
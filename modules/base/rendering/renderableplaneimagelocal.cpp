@@ -27,9 +27,9 @@
 #include <modules/base/basemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/rendering/compressedtexture.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
-#include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/crc32.h>
 #include <ghoul/opengl/texture.h>
@@ -155,15 +155,12 @@ void RenderablePlaneImageLocal::loadTexture() {
             std::to_string(hash),
             [path = _texturePath]() -> std::unique_ptr<ghoul::opengl::Texture> {
                 std::unique_ptr<ghoul::opengl::Texture> texture =
-                    ghoul::io::TextureReader::ref().loadTexture(absPath(path));
+                    rendering::loadTexture(absPath(path));
 
                 LDEBUGC(
                     "RenderablePlaneImageLocal",
                     fmt::format("Loaded texture from '{}'", absPath(path))
                 );
-                texture->uploadTexture();
-
-                texture->setFilter(ghoul::opengl::Texture::FilterMode::LinearMipMap);
 
                 return texture;
             }
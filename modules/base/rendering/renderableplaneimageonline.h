@@ -27,10 +27,7 @@
 
 #include <modules/base/rendering/renderableplane.h>
 
-#include <openspace/engine/downloadmanager.h>
-
-namespace ghoul::filesystem { class File; }
-namespace ghoul::opengl { class Texture; }
+#include <modules/base/rendering/onlineimagecache.h>
 
 namespace openspace {
 
@@ -53,13 +50,9 @@ protected:
     virtual void bindTexture() override;
 
 private:
-    std::future<DownloadManager::MemoryFile> downloadImageToMemory(
-        const std::string& url);
-
     properties::StringProperty _texturePath;
 
-    std::future<DownloadManager::MemoryFile> _imageFuture;
-    std::unique_ptr<ghoul::opengl::Texture> _texture;
+    std::shared_ptr<const OnlineImageCache::Image> _image;
     bool _textureIsDirty = false;
 };
 
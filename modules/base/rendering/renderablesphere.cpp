@@ -28,6 +28,7 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/rendering/compressedtexture.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/powerscaledsphere.h>
 #include <openspace/util/updatestructures.h>
@@ -35,6 +36,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/io/texture/texturereader.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 #include <ghoul/opengl/programobject.h>
@@ -464,6 +466,21 @@ void RenderableSphere::update(const UpdateData&) {
         ghoul::opengl::updateUniformLocations(*_shader, _uniformCache, UniformNames);
     }
 
+    if (_compressedTexture.valid() &&
+        _compressedTexture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        try {
+            _texture = rendering::createCompressedTexture(_compressedTexture.get());
+            LDEBUGC(
+                "RenderableSphere",
+                fmt::format("Loaded texture from '{}'", absPath(_texturePath))
+            );
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC("RenderableSphere", e.message);
+        }
+    }
+
     if (_sphereIsDirty) {
         _sphere = std::make_unique<PowerScaledSphere>(_size, _segments);
         _sphere->initialize();
@@ -472,7 +489,19 @@ void RenderableSphere::update(const UpdateData&) {
 }
 
 void RenderableSphere::loadTexture() {
-    if (!_texturePath.value().empty()) {
+    if (!_texturePath.value().empty() &&
+        rendering::isCompressedTextureFile(_texturePath))
+    {
+        // Planet textures can be large enough that reading them would stall the
+        // rendering, so the previous texture is kept until the new one has been read
+        _compressedTexture = std::async(
+            std::launch::async,
+            [path = absPath(_texturePath)]() {
+                return rendering::readCompressedTexture(path);
+            }
+        );
+    }
+    else if (!_texturePath.value().empty()) {
         std::unique_ptr<ghoul::opengl::Texture> texture =
             ghoul::io::TextureReader::ref().loadTexture(_texturePath);
 
@@ -31,7 +31,9 @@
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/rendering/compressedtexture.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <future>
 
 namespace ghoul::opengl {
     class ProgramObject;
@@ -79,6 +81,9 @@ private:
 
     ghoul::opengl::ProgramObject* _shader = nullptr;
     std::unique_ptr<ghoul::opengl::Texture> _texture;
+    /// Compressed textures are read on a worker thread and created in the next update
+    /// after they have been read
+    std::future<rendering::CompressedTextureData> _compressedTexture;
 
     std::unique_ptr<PowerScaledSphere> _sphere;
 
@@ -27,23 +27,15 @@
 #include <modules/base/basemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
-#include <openspace/engine/globals.h>
-#include <openspace/rendering/renderengine.h>
 #include <openspace/scene/translation.h>
 #include <openspace/util/updatestructures.h>
-#include <ghoul/filesystem/filesystem.h>
-#include <ghoul/opengl/programobject.h>
+#include <algorithm>
+#include <future>
+#include <thread>
 
 namespace {
-    constexpr const char* ProgramName = "EphemerisProgram";
     constexpr const char* KeyTranslation = "Translation";
 
-    constexpr const std::array<const char*, 12> UniformNames = {
-        "opacity", "modelViewTransform", "projectionTransform", "color", "useLineFade",
-        "lineFade", "vertexSortingMethod", "idOffset", "nVertices", "stride", "pointSize",
-        "renderPhase"
-    };
-
     // The possible values for the _renderingModes property
     enum RenderingMode {
         RenderingModeLines = 0,
@@ -231,51 +223,23 @@ RenderableTrail::RenderableTrail(const ghoul::Dictionary& dictionary)
 }
 
 void RenderableTrail::initializeGL() {
-    _programObject = BaseModule::ProgramObjectManager.request(
-        ProgramName,
-        []() -> std::unique_ptr<ghoul::opengl::ProgramObject> {
-            return global::renderEngine.buildRenderProgram(
-                ProgramName,
-                absPath("${MODULE_BASE}/shaders/renderabletrail_vs.glsl"),
-                absPath("${MODULE_BASE}/shaders/renderabletrail_fs.glsl")
-            );
-        }
-    );
-
-    ghoul::opengl::updateUniformLocations(*_programObject, _uniformCache, UniformNames);
+    BaseModule::Trails.initializeGL();
 }
 
 void RenderableTrail::deinitializeGL() {
-    BaseModule::ProgramObjectManager.release(
-        ProgramName,
-        [](ghoul::opengl::ProgramObject* p) {
-            global::renderEngine.removeRenderProgram(p);
-        }
-    );
-    _programObject = nullptr;
+    BaseModule::Trails.deinitializeGL();
 }
 
 bool RenderableTrail::isReady() const {
-    return _programObject != nullptr;
+    return BaseModule::Trails.isReady();
 }
 
-void RenderableTrail::render(const RenderData& data, RendererTasks&) {
-    _programObject->activate();
-    _programObject->setUniform(_uniformCache.opacity, _opacity);
-
+void RenderableTrail::render(const RenderData& data, RendererTasks& rendererTask) {
     glm::dmat4 modelTransform =
         glm::translate(glm::dmat4(1.0), data.modelTransform.translation) *
         glm::dmat4(data.modelTransform.rotation) *
         glm::scale(glm::dmat4(1.0), glm::dvec3(data.modelTransform.scale));
 
-    _programObject->setUniform(_uniformCache.projection, data.camera.projectionMatrix());
-
-    _programObject->setUniform(_uniformCache.color, _lineColor);
-    _programObject->setUniform(_uniformCache.useLineFade, _useLineFade);
-    if (_useLineFade) {
-        _programObject->setUniform(_uniformCache.lineFade, _lineFade);
-    }
-
     static std::map<RenderInformation::VertexSorting, int> SortingMapping = {
         // Fragile! Keep in sync with shader
         { RenderInformation::VertexSorting::NewestFirst, 0 },
@@ -283,139 +247,119 @@ void RenderableTrail::render(const RenderData& data, RendererTasks&) {
         { RenderInformation::VertexSorting::NoSorting, 2}
     };
 
-    const bool usingFramebufferRenderer =
-        global::renderEngine.rendererImplementation() ==
-        RenderEngine::RendererImplementation::Framebuffer;
-
-    if (usingFramebufferRenderer) {
-        glDepthMask(false);
-        //glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    }
-
-    const bool renderLines = (_renderingModes == RenderingModeLines) |
-                             (_renderingModes == RenderingModeLinesPoints);
+    TrailBuffer::Draw draw;
+    draw.color = _lineColor;
+    draw.opacity = _opacity;
+    draw.useLineFade = _useLineFade;
+    draw.lineFade = _lineFade;
+    draw.pointSize = _pointSize;
+    draw.lineWidth = _lineWidth;
+    draw.renderLines = (_renderingModes == RenderingModeLines) |
+                       (_renderingModes == RenderingModeLinesPoints);
+    draw.renderPoints = (_renderingModes == RenderingModePoints) |
+                        (_renderingModes == RenderingModeLinesPoints);
 
-    const bool renderPoints = (_renderingModes == RenderingModePoints) |
-                              (_renderingModes == RenderingModeLinesPoints);
+    // The combined size of vertices; -1 because we duplicate the penultimate point
+    draw.nVertices = _primaryRenderInformation.count +
+                     _floatingRenderInformation.count - 1;
 
-    if (renderLines) {
-        glLineWidth(_lineWidth);
-    }
-    if (renderPoints) {
-        glEnable(GL_PROGRAM_POINT_SIZE);
-    }
+    auto submit = [&](const RenderInformation& info, int offset) {
+        if (!info._allocation.isValid() || info.count == 0) {
+            return;
+        }
+        draw.allocation = info._allocation;
+        draw.first = info.first;
+        draw.count = info.count;
 
-    auto render = [renderLines, renderPoints, p = _programObject, &data,
-                   &modelTransform, pointSize = _pointSize.value(), c = _uniformCache]
-                  (RenderInformation& info, int nVertices, int offset)
-    {
         // We pass in the model view transformation matrix as double in order to maintain
         // high precision for vertices; especially for the trails, a high vertex precision
         // is necessary as they are usually far away from their reference
-        p->setUniform(
-            c.modelView,
-            data.camera.combinedViewMatrix() * modelTransform * info._localTransform
-        );
+        draw.modelViewTransform =
+            data.camera.combinedViewMatrix() * modelTransform * info._localTransform;
 
         // The vertex sorting method is used to tweak the fading along the trajectory
-        p->setUniform(c.vertexSorting, SortingMapping[info.sorting]);
+        draw.vertexSorting = SortingMapping[info.sorting];
 
         // This value is subtracted from the vertex id in the case of a potential ring
         // buffer (as used in RenderableTrailOrbit) to keep the first vertex at its
         // brightest
-        p->setUniform(c.idOffset, offset);
-
-        p->setUniform(c.nVertices, nVertices);
-
-        if (renderPoints) {
-            // The stride parameter determines the distance between larger points and
-            // smaller ones
-            p->setUniform(c.stride, info.stride);
-            p->setUniform(c.pointSize, pointSize);
+        draw.idOffset = offset;
+
+        // The stride parameter determines the distance between larger points and
+        // smaller ones
+        draw.stride = info.stride;
+
+        // The first trail that is submitted after the last flush schedules the next one,
+        // which draws all trails that were submitted until then
+        if (BaseModule::Trails.submit(draw)) {
+            rendererTask.batchedDrawTasks.push_back(
+                [projection = data.camera.projectionMatrix()]() {
+                    BaseModule::Trails.flush(projection);
+                }
+            );
         }
+    };
 
-        // Fragile! Keep in sync with fragment shader
-        enum RenderPhase {
-            RenderPhaseLines = 0,
-            RenderPhasePoints
-        };
-
-        glBindVertexArray(info._vaoID);
-        if (renderLines) {
-            p->setUniform(c.renderPhase, RenderPhaseLines);
-            // Subclasses of this renderer might be using the index array or might now be
-            // so we check if there is data available and if there isn't, we use the
-            // glDrawArrays draw call; otherwise the glDrawElements
-            if (info._iBufferID == 0) {
-                glDrawArrays(
-                    GL_LINE_STRIP,
-                    info.first,
-                    info.count
-                );
-            }
-            else {
-                glDrawElements(
-                    GL_LINE_STRIP,
-                    info.count,
-                    GL_UNSIGNED_INT,
-                    reinterpret_cast<void*>(info.first * sizeof(unsigned int))
-                );
-            }
-        }
-        if (renderPoints) {
-            // Subclasses of this renderer might be using the index array or might now be
-            // so we check if there is data available and if there isn't, we use the
-            // glDrawArrays draw call; otherwise the glDrawElements
-            p->setUniform(c.renderPhase, RenderPhasePoints);
-            if (info._iBufferID == 0) {
-                glDrawArrays(GL_POINTS, info.first, info.count);
-            }
-            else {
-                glDrawElements(
-                    GL_POINTS,
-                    info.count,
-                    GL_UNSIGNED_INT,
-                    reinterpret_cast<void*>(info.first * sizeof(unsigned int))
-                );
-            }
+    // The primary information might be a ring buffer, so we might need to start at an
+    // offset
+    const int primaryOffset = _primaryRenderInformation._allocation.isRingBuffer ?
+        _primaryRenderInformation.first :
+        0;
+
+    // Submit the primary batch of vertices
+    submit(_primaryRenderInformation, primaryOffset);
+
+    // The secondary batch is optional and is skipped if it doesn't contain any data
+    submit(
+        _floatingRenderInformation,
+        // -1 because we duplicate the penultimate point between the vertices
+        -(primaryOffset + _primaryRenderInformation.count - 1)
+    );
+}
+
+void RenderableTrail::samplePositions(TrailVBOLayout* positions, int nPoints,
+                                      double startTime, double timeStep) const
+{
+    auto sample = [this, positions, startTime, timeStep](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const glm::vec3 p = _translation->position({
+                {},
+                startTime + i * timeStep,
+                0.0,
+                false
+            });
+            positions[i] = { p.x, p.y, p.z };
         }
     };
 
-    // The combined size of vertices; -1 because we duplicate the penultimate point
-    const int totalNumber = _primaryRenderInformation.count +
-                            _floatingRenderInformation.count - 1;
-
-    // The primary information might use an index buffer, so we might need to start at an
-    // offset
-    const int primaryOffset = (_primaryRenderInformation._iBufferID == 0) ?
-        0 :
-        _primaryRenderInformation.first;
-
-    // Render the primary batch of vertices
-    render(_primaryRenderInformation, totalNumber, primaryOffset);
-
-    // The secondary batch is optional, so we need to check whether we have any data here
-    if (_floatingRenderInformation._vaoID != 0 && _floatingRenderInformation.count != 0) {
-        render(
-            _floatingRenderInformation,
-            totalNumber,
-            // -1 because we duplicate the penultimate point between the vertices
-            -(primaryOffset + _primaryRenderInformation.count - 1)
-        );
+    // Small sweeps are not worth the overhead of starting threads
+    constexpr const int MinPointsPerThread = 256;
+    const int nThreads = std::min(
+        static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)),
+        nPoints / MinPointsPerThread
+    );
+    if (!_translation->isThreadSafe() || nThreads <= 1) {
+        sample(0, nPoints);
+        return;
     }
 
-    if (renderPoints) {
-        glDisable(GL_PROGRAM_POINT_SIZE);
+    // The first position is computed up front as the Translation may lazily initialize
+    // some of its state on the first call
+    sample(0, 1);
+
+    const int chunkSize = (nPoints - 1 + nThreads - 1) / nThreads;
+    std::vector<std::future<void>> futures;
+    for (int begin = 1; begin < nPoints; begin += chunkSize) {
+        futures.push_back(std::async(
+            std::launch::async,
+            sample,
+            begin,
+            std::min(begin + chunkSize, nPoints)
+        ));
     }
-
-    glBindVertexArray(0);
-
-    if (usingFramebufferRenderer) {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDepthMask(true);
+    for (std::future<void>& f : futures) {
+        f.get();
     }
-
-    _programObject->deactivate();
 }
 
 } // namespace openspace
@@ -27,6 +27,7 @@
 
 #include <openspace/rendering/renderable.h>
 
+#include <modules/base/rendering/trailbuffer.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
@@ -34,12 +35,6 @@
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/vector/vec3property.h>
 #include <ghoul/opengl/ghoul_gl.h>
-#include <ghoul/opengl/uniformcache.h>
-
-namespace ghoul::opengl {
-    class ProgramObject;
-    class Texture;
-} // namespace ghoul::opengl
 
 namespace openspace {
 
@@ -54,9 +49,12 @@ class Translation;
  * The main difference between two subclasses is that RenderableTrailOrbit updates itself
  * continously, whereas RenderableTrailTrajectory precomputes the entire trail in advance.
  *
- * This class is responsible for the rendering of the vertex buffer objects which are
- * filled by the subclasses. The buffers contain a list of TrailVBOLayout objects that is
- * the three dimensional position for each point along the line.
+ * This class is responsible for the rendering of the vertices which are written by the
+ * subclasses into their allocations in the TrailBuffer of the BaseModule, which is shared
+ * by all trails. The allocations contain a list of TrailVBOLayout objects that is the
+ * three dimensional position for each point along the line. Instead of drawing directly,
+ * each trail submits its draws to the TrailBuffer, which draws all trails together once
+ * all scene graph nodes have been rendered.
  *
  * Trails can be rendered either as lines, as points, or a combination of both with
  * varying colors, line thicknesses, or fading settings. If trails are rendered as points,
@@ -79,9 +77,9 @@ public:
     bool isReady() const override;
 
     /**
-     * The render method will set up the shader information and then render first the
-     * information contained in the the \c _primaryRenderInformation, then the optional
-     * \c _floatingRenderInformation using the provided \p data
+     * The render method will submit the draws of first the information contained in the
+     * \c _primaryRenderInformation, then the optional \c _floatingRenderInformation
+     * using the provided \p data to the TrailBuffer
      * \param data The data that is necessary to render this Renderable
      */
     void render(const RenderData& data, RendererTasks& rendererTask) override;
@@ -92,19 +90,26 @@ protected:
     /// Returns the documentation entries that the con
     static documentation::Documentation Documentation();
 
-    /// The layout of the VBOs
-    struct TrailVBOLayout {
-        float x, y, z;
-    };
+    /// The layout of the vertices in the TrailBuffer
+    using TrailVBOLayout = TrailBuffer::Vertex;
+
+    /**
+     * Writes the positions of the Translation at \p nPoints equidistant times, beginning
+     * with \p startTime and spaced \p timeStep seconds apart, into \p positions. If the
+     * Translation is thread-safe, the positions are computed on multiple threads.
+     *
+     * \param positions The destination, which must have room for \p nPoints values
+     * \param nPoints The number of positions to compute
+     * \param startTime The time of the first position
+     * \param timeStep The time between two positions, which can be negative
+     */
+    void samplePositions(TrailVBOLayout* positions, int nPoints, double startTime,
+        double timeStep) const;
 
     /// The backend storage for the vertex buffer object containing all points for this
     /// trail.
     std::vector<TrailVBOLayout> _vertexArray;
 
-    /// The index array that is potentially used in the draw call. If this is empty, no
-    /// element draw call is used.
-    std::vector<unsigned int> _indexArray;
-
     /// The Translation object that provides the position of the individual trail points
     std::unique_ptr<Translation> _translation;
 
@@ -116,7 +121,8 @@ protected:
             OldestFirst,        ///< Older vertices have a lower index than newer ones
             NoSorting           ///< No ordering in the vertices; no fading applied
         };
-        /// The first element in the vertex buffer to be rendered
+        /// The first element in the allocation to be rendered. For a ring buffer
+        /// allocation, the rendered range wraps around the end of the allocation
         GLint first = 0;
         /// The number of values to be rendered
         GLsizei count = 0;
@@ -128,12 +134,9 @@ protected:
         /// Local model matrix transformation, used for rendering in camera space
         glm::dmat4 _localTransform = glm::dmat4(1.0);
 
-        /// The vertex array object for this RenderInformation
-        GLuint _vaoID = 0;
-        /// The main vertex buffer object
-        GLuint _vBufferID = 0;
-        /// The optional index buffer object
-        GLuint _iBufferID = 0;
+        /// The range in the TrailBuffer that contains the vertices of this
+        /// RenderInformation
+        TrailBuffer::Allocation _allocation;
     };
 
     /// Primary set of information about the main rendering parts
@@ -155,12 +158,6 @@ private:
     properties::IntProperty _pointSize;
     /// The option determining which rendering method to use
     properties::OptionProperty _renderingModes;
-
-    /// Program object used to render the data stored in RenderInformation
-    ghoul::opengl::ProgramObject* _programObject = nullptr;
-
-    UniformCache(opacity, modelView, projection, color, useLineFade, lineFade,
-        vertexSorting, idOffset, nVertices, stride, pointSize, renderPhase) _uniformCache;
 };
 
 } // namespace openspace
@@ -24,12 +24,11 @@
 
 #include <modules/base/rendering/renderabletrailorbit.h>
 
+#include <modules/base/basemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/scene/translation.h>
 #include <openspace/util/updatestructures.h>
-#include <ghoul/opengl/programobject.h>
-#include <numeric>
 
 // This class is using a VBO ring buffer + a constantly updated point as follows:
 // Structure of the array with a _resolution of 16. FF denotes the floating position that
@@ -59,20 +58,19 @@
 // towards the upper areas of the array instead.
 // In both cases, only the values that have been changed will be uploaded to the GPU.
 //
-// For the rendering, this is achieved by using an index buffer that is twice the size of
-// the vertex buffer containing identical two sequences indexing the vertex array.
-// In an example of size 8:
-// ---------------------------------------------------------------------------------------
-// |0|1|2|3|4|5|6|7|8|9|10|11|12|13|14|15| 0| 1| 2| 3| 4| 5| 6| 7| 8| 9|10|11|12|13|14|15|
-// ---------------------------------------------------------------------------------------
-//  0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31
+// For the rendering, the vertices are stored in a ring buffer allocation of the shared
+// TrailBuffer, which keeps a copy of element 0 behind the last element:
+// ---------------------------------------------------------------------------------
+// | 0| 1| 2| 3| 4| 5| 6| 7| 8| 9|10|11|12|13|14|15| 0|
+// ---------------------------------------------------------------------------------
 //
 // The rendering step needs to know only the offset into the array (denoted by FF as the
-// floating position above) and use the index array from the position. Since the indices
-// in this array wrap around, so will the rendering of the vertices. Example:
+// floating position above). If the rendered range wraps around the end of the array, the
+// TrailBuffer splits it into two draw commands. The first one ends with the copy of
+// element 0, at which the second one starts, so the line stays connected. Example:
 // FF := 10
-// Rendering 16 elements will 'generate' the index buffer:
-// 10 11 12 13 14 15 00 01 02 03 04 05 06 07 08 09
+// Rendering 16 elements will generate the two commands:
+// 10 11 12 13 14 15 00   and   00 01 02 03 04 05 06 07 08 09
 //
 //
 // NB: This method was implemented without a ring buffer before by manually shifting the
@@ -153,7 +151,7 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
     , _resolution(ResolutionInfo, 10000, 1, 1000000)
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "RenderableTrailOrbit"
     );
@@ -164,11 +162,11 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
     using namespace std::chrono;
     const long long sph = duration_cast<seconds>(hours(24)).count();
     _period = dictionary.value<double>(PeriodInfo.identifier) * sph;
-    _period.onChange([&] { _needsFullSweep = true; _indexBufferDirty = true; });
+    _period.onChange([&] { _needsFullSweep = true; });
     addProperty(_period);
 
     _resolution = static_cast<int>(dictionary.value<double>(ResolutionInfo.identifier));
-    _resolution.onChange([&] { _needsFullSweep = true; _indexBufferDirty = true; });
+    _resolution.onChange([&] { _needsFullSweep = true; });
     addProperty(_resolution);
 
     // We store the vertices with (excluding the wrapping) decending temporal order
@@ -199,15 +197,13 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
 void RenderableTrailOrbit::initializeGL() {
     RenderableTrail::initializeGL();
 
-    glGenVertexArrays(1, &_primaryRenderInformation._vaoID);
-    glGenBuffers(1, &_primaryRenderInformation._vBufferID);
-    glGenBuffers(1, &_primaryRenderInformation._iBufferID);
+    // The allocation in the trail buffer is created by the first full sweep, which
+    // determines the number of vertices
+    _needsFullSweep = true;
 }
 
 void RenderableTrailOrbit::deinitializeGL() {
-    glDeleteVertexArrays(1, &_primaryRenderInformation._vaoID);
-    glDeleteBuffers(1, &_primaryRenderInformation._vBufferID);
-    glDeleteBuffers(1, &_primaryRenderInformation._iBufferID);
+    BaseModule::Trails.free(_primaryRenderInformation._allocation);
 
     RenderableTrail::deinitializeGL();
 }
@@ -239,62 +235,36 @@ void RenderableTrailOrbit::update(const UpdateData& data) {
     });
     _vertexArray[_primaryRenderInformation.first] = { p.x, p.y, p.z };
 
-    glBindVertexArray(_primaryRenderInformation._vaoID);
-    glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
+    // The lambda expression that will upload parts of the array starting at begin and
+    // containing length number of elements into the allocation in the trail buffer
+    TrailBuffer::Allocation& allocation = _primaryRenderInformation._allocation;
+    auto upload = [this, &allocation](int begin, int length) {
+        BaseModule::Trails.write(allocation, begin, length, _vertexArray.data() + begin);
+    };
 
     // 3
     if (!report.permanentPointsNeedUpdate) {
         if (report.floatingPointNeedsUpdate) {
             // If no other values have been touched, we only need to upload the
             // floating value
-            glBufferSubData(
-                GL_ARRAY_BUFFER,
-                _primaryRenderInformation.first * sizeof(TrailVBOLayout),
-                sizeof(TrailVBOLayout),
-                _vertexArray.data() + _primaryRenderInformation.first
-            );
+            upload(_primaryRenderInformation.first, 1);
         }
     }
     else {
         // Otherwise we need to check how many values have been changed
         if (report.nUpdated == UpdateReport::All) {
             // If all of the values have been invalidated, we need to upload the entire
-            // array
-            glBufferData(
-                GL_ARRAY_BUFFER,
-                _vertexArray.size() * sizeof(TrailVBOLayout),
-                _vertexArray.data(),
-                GL_STREAM_DRAW
-            );
-
-            if (_indexBufferDirty) {
-                // We only need to upload the index buffer if it has been invalidated
-                // by changing the number of values we want to represent
-                glBindBuffer(
-                    GL_ELEMENT_ARRAY_BUFFER,
-                    _primaryRenderInformation._iBufferID
-                );
-                glBufferData(
-                    GL_ELEMENT_ARRAY_BUFFER,
-                    _indexArray.size() * sizeof(unsigned int),
-                    _indexArray.data(),
-                    GL_STATIC_DRAW
-                );
-                _indexBufferDirty = false;
+            // array. The allocation only has to be replaced if the number of values we
+            // want to represent has changed. It is a ring buffer, so that the vertices
+            // can be drawn starting at the floating position without reordering them
+            const GLsizei size = static_cast<GLsizei>(_vertexArray.size());
+            if (allocation.size != size) {
+                BaseModule::Trails.free(allocation);
+                allocation = BaseModule::Trails.allocate(size, true);
             }
+            upload(0, size);
         }
         else {
-            // The lambda expression that will upload parts of the array starting at
-            // begin and containing length number of elements
-            auto upload = [this](int begin, int length) {
-                glBufferSubData(
-                    GL_ARRAY_BUFFER,
-                    begin * sizeof(TrailVBOLayout),
-                    sizeof(TrailVBOLayout) * length,
-                    _vertexArray.data() + begin
-                );
-            };
-
             // Only update the changed ones
             // Since we are using a ring buffer, the number of updated needed might be
             // bigger than our current points, which means we have to split the upload
@@ -351,11 +321,6 @@ void RenderableTrailOrbit::update(const UpdateData& data) {
             }
         }
     }
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-
-    glBindVertexArray(0);
 }
 
 RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
@@ -482,25 +447,12 @@ void RenderableTrailOrbit::fullSweep(double time) {
     _vertexArray.clear();
     _vertexArray.resize(_resolution);
 
-    // The index buffer stays constant until we change the size of the array
-    if (_indexBufferDirty) {
-        // Create the index buffer and fill it with two ranges for [0, _resolution)
-        _indexArray.clear();
-        _indexArray.resize(_resolution * 2);
-        std::iota(_indexArray.begin(), _indexArray.begin() + _resolution, 0);
-        std::iota(_indexArray.begin() + _resolution, _indexArray.end(), 0);
-    }
-
     _lastPointTime = time;
 
     const double secondsPerPoint = _period / (_resolution - 1);
     // starting at 1 because the first position is a floating current one
-    for (int i = 1; i < _resolution; ++i) {
-        const glm::vec3 p = _translation->position({ {}, time, 0.0, false });
-        _vertexArray[i] = { p.x, p.y, p.z };
-
-        time -= secondsPerPoint;
-    }
+    samplePositions(&_vertexArray[1], _resolution - 1, time, -secondsPerPoint);
+    time -= (_resolution - 1) * secondsPerPoint;
 
     _primaryRenderInformation.first = 0;
     _primaryRenderInformation.count = _resolution;
@@ -92,9 +92,6 @@ private:
     /// A dirty flag that determines whether a full sweep (recomputing of all values)
     /// is necessary
     bool _needsFullSweep = true;
-    /// A dirty flag to determine whether the index buffer needs to be regenerated and
-    /// then reuploaded
-    bool _indexBufferDirty = true;
 
     /// The time stamp of the oldest point in the array
     double _firstPointTime = 0.0;
@@ -24,16 +24,18 @@
 
 #include <modules/base/rendering/renderabletrailtrajectory.h>
 
+#include <modules/base/basemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/scene/translation.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/updatestructures.h>
+#include <algorithm>
 
 // This class creates the entire trajectory at once and keeps it in memory the entire
 // time. This means that there is no need for updating the trail at runtime, but also that
 // the whole trail has to fit in memory.
-// Opposed to the RenderableTrailOrbit, no index buffer is needed as the vertex can be
+// Opposed to the RenderableTrailOrbit, no ring buffer is needed as the vertex can be
 // written into the vertex buffer object continuously and then selected by using the
 // count variable from the RenderInformation struct to toggle rendering of the entire path
 // or subpath.
@@ -43,6 +45,10 @@
 // _endTime. This buffer is updated every frame.
 
 namespace {
+    // The number of vertices that are computed per frame for Translations that can't be
+    // sampled in parallel
+    constexpr const int MaxSamplesPerFrame = 2048;
+
     constexpr openspace::properties::Property::PropertyInfo StartTimeInfo = {
         "StartTime",
         "Start Time",
@@ -147,7 +153,7 @@ RenderableTrailTrajectory::RenderableTrailTrajectory(const ghoul::Dictionary& di
     , _renderFullTrail(RenderFullPathInfo, false)
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "RenderableTrailTrajectory"
     );
@@ -186,23 +192,21 @@ RenderableTrailTrajectory::RenderableTrailTrajectory(const ghoul::Dictionary& di
 void RenderableTrailTrajectory::initializeGL() {
     RenderableTrail::initializeGL();
 
-    // We don't need an index buffer, so we keep it at the default value of 0
-    glGenVertexArrays(1, &_primaryRenderInformation._vaoID);
-    glGenBuffers(1, &_primaryRenderInformation._vBufferID);
+    // The allocation for the primary render information is created by the full sweep,
+    // once the number of vertices is known
+    _needsFullSweep = true;
 
     // We do need an additional render information bucket for the additional line from the
     // last shown permanent line to the current position of the object
-    glGenVertexArrays(1, &_floatingRenderInformation._vaoID);
-    glGenBuffers(1, &_floatingRenderInformation._vBufferID);
+    _floatingRenderInformation._allocation = BaseModule::Trails.allocate(
+        static_cast<GLsizei>(_auxiliaryVboData.size())
+    );
     _floatingRenderInformation.sorting = RenderInformation::VertexSorting::OldestFirst;
 }
 
 void RenderableTrailTrajectory::deinitializeGL() {
-    glDeleteVertexArrays(1, &_primaryRenderInformation._vaoID);
-    glDeleteBuffers(1, &_primaryRenderInformation._vBufferID);
-
-    glDeleteVertexArrays(1, &_floatingRenderInformation._vaoID);
-    glDeleteBuffers(1, &_floatingRenderInformation._vBufferID);
+    BaseModule::Trails.free(_primaryRenderInformation._allocation);
+    BaseModule::Trails.free(_floatingRenderInformation._allocation);
 
     RenderableTrail::deinitializeGL();
 }
@@ -221,37 +225,45 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
         // Make space for the vertices
         _vertexArray.clear();
         _vertexArray.resize(nValues);
-
-        // ... fill all of the values
-        for (int i = 0; i < nValues; ++i) {
-            const glm::vec3 p = _translation->position({
-                {},
-                _start + i * totalSampleInterval,
-                0.0,
-                false
-            });
-            _vertexArray[i] = { p.x, p.y, p.z };
+        _nSampledPoints = 0;
+
+        // ... and in the trail buffer
+        TrailBuffer::Allocation& allocation = _primaryRenderInformation._allocation;
+        if (allocation.size != nValues) {
+            BaseModule::Trails.free(allocation);
+            if (nValues > 0) {
+                allocation = BaseModule::Trails.allocate(nValues);
+            }
         }
 
-        // ... and upload them to the GPU
-        glBindVertexArray(_primaryRenderInformation._vaoID);
-        glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            _vertexArray.size() * sizeof(TrailVBOLayout),
-            _vertexArray.data(),
-            GL_STATIC_DRAW
-        );
+        _subsamplingIsDirty = true;
+        _needsFullSweep = false;
+    }
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    const int nValues = static_cast<int>(_vertexArray.size());
+    if (_nSampledPoints < nValues) {
+        // Thread-safe translations are sampled in parallel in one go, others are
+        // sampled a bit every frame to not block the rendering
+        const int nNewPoints = _translation->isThreadSafe() ?
+            nValues - _nSampledPoints :
+            std::min(nValues - _nSampledPoints, MaxSamplesPerFrame);
 
-        // We clear the indexArray just in case. The base class will take care not to use
-        // it if it is empty
-        _indexArray.clear();
+        const double totalSampleInterval = _sampleInterval / _timeStampSubsamplingFactor;
+        samplePositions(
+            &_vertexArray[_nSampledPoints],
+            nNewPoints,
+            _start + _nSampledPoints * totalSampleInterval,
+            totalSampleInterval
+        );
 
-        _subsamplingIsDirty = true;
-        _needsFullSweep = false;
+        // ... and upload the new values to the GPU
+        BaseModule::Trails.write(
+            _primaryRenderInformation._allocation,
+            _nSampledPoints,
+            nNewPoints,
+            &_vertexArray[_nSampledPoints]
+        );
+        _nSampledPoints += nNewPoints;
     }
 
     // This has to be done every update step;
@@ -259,7 +271,7 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
         // If the full trail should be rendered at all times, we can directly render the
         // entire set
         _primaryRenderInformation.first = 0;
-        _primaryRenderInformation.count = static_cast<GLsizei>(_vertexArray.size());
+        _primaryRenderInformation.count = static_cast<GLsizei>(_nSampledPoints);
     }
     else {
         // If only trail so far should be rendered, we need to find the corresponding time
@@ -269,16 +281,20 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
             0.0,
             (data.time.j2000Seconds() - _start) / (_end - _start)
         );
-        _primaryRenderInformation.count = std::min(
+        _primaryRenderInformation.count = std::min({
             static_cast<GLsizei>(ceil(_vertexArray.size() * t)),
-            static_cast<GLsizei>(_vertexArray.size() - 1)
-        );
+            static_cast<GLsizei>(_vertexArray.size() - 1),
+            static_cast<GLsizei>(_nSampledPoints)
+        });
     }
 
     // If we are inside the valid time, we additionally want to draw a line from the last
-    // correct point to the current location of the object
+    // correct point to the current location of the object. While the trail is still
+    // being sampled, the last correct point might not be the one preceding the object
+    const bool isSampled = _nSampledPoints == static_cast<int>(_vertexArray.size());
     if (data.time.j2000Seconds() >= _start &&
-        data.time.j2000Seconds() <= _end && !_renderFullTrail)
+        data.time.j2000Seconds() <= _end && !_renderFullTrail &&
+        isSampled && _primaryRenderInformation.count > 0)
     {
         // Copy the last valid location
         glm::dvec3 v0(
@@ -306,17 +322,12 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
 
         _floatingRenderInformation._localTransform = glm::translate(glm::dmat4(1.0), v1);
 
-        glBindVertexArray(_floatingRenderInformation._vaoID);
-        glBindBuffer(GL_ARRAY_BUFFER, _floatingRenderInformation._vBufferID);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            _auxiliaryVboData.size() * sizeof(TrailVBOLayout),
-            _auxiliaryVboData.data(),
-            GL_DYNAMIC_DRAW
+        BaseModule::Trails.write(
+            _floatingRenderInformation._allocation,
+            0,
+            static_cast<GLsizei>(_auxiliaryVboData.size()),
+            _auxiliaryVboData.data()
         );
-
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
     }
     else {
         // if we are outside of the valid range, we don't render anything
@@ -331,8 +342,6 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
         _floatingRenderInformation.stride = _timeStampSubsamplingFactor;
         _subsamplingIsDirty = false;
     }
-
-    glBindVertexArray(0);
 }
 
 } // namespace openspace
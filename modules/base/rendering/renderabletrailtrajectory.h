@@ -75,6 +75,11 @@ private:
     /// Dirty flag that determines whether the full vertex buffer needs to be resampled
     bool _needsFullSweep = true;
 
+    /// The number of vertices at the beginning of the _vertexArray that have been
+    /// computed so far. If the Translation is not thread-safe, the sweep is spread out
+    /// over multiple frames
+    int _nSampledPoints = 0;
+
     /// Dirty flag to determine whether the stride information needs to be changed
     bool _subsamplingIsDirty = true;
 
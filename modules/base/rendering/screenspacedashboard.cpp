@@ -30,6 +30,7 @@
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/rendering/dashboarditem.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scripting/lualibrary.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
@@ -182,17 +183,44 @@ ScreenSpaceDashboard::ScreenSpaceDashboard(const ghoul::Dictionary& dictionary)
 bool ScreenSpaceDashboard::initializeGL() {
     ScreenSpaceFramebuffer::initializeGL();
 
-    addRenderFunction([this]() {
-        glm::vec2 penPosition = glm::vec2(10.f, _size.value().w );
-
-        if (_useMainDashboard) {
-            global::dashboard.render(penPosition);
-        }
-        else {
-            _dashboard.render(penPosition);
-        }
+    addRenderFunction([]() {
+        // The text was already queued by needsRerender and has to end up in this
+        // framebuffer rather than in the main overlay
+        global::renderEngine.textBatcher().flush();
     });
+    _hasRenderedContent = false;
+
+    return true;
+}
+
+void ScreenSpaceDashboard::layoutDashboard() {
+    glm::vec2 penPosition = glm::vec2(10.f, _size.value().w);
+
+    if (_useMainDashboard) {
+        global::dashboard.render(penPosition);
+    }
+    else {
+        _dashboard.render(penPosition);
+    }
+}
+
+bool ScreenSpaceDashboard::needsRerender() {
+    // Laying out the text is cheap compared to drawing it, so the dashboard items are
+    // queued every frame and the checksum of their text serves as their revision. Only
+    // if any of the items changed, moved, or was toggled is the framebuffer redrawn
+    TextBatcher& batcher = global::renderEngine.textBatcher();
+    layoutDashboard();
+    const uint64_t checksum = batcher.checksum();
+
+    const bool isSameSize = _size.value() == _renderedSize;
+    if (_hasRenderedContent && isSameSize && checksum == _renderedChecksum) {
+        batcher.discard();
+        return false;
+    }
 
+    _renderedChecksum = checksum;
+    _renderedSize = _size.value();
+    _hasRenderedContent = true;
     return true;
 }
 
@@ -214,6 +242,7 @@ void ScreenSpaceDashboard::update() {
         _size = { 0.f, 0.f, size.x, size.y };
         _originalViewportSize = size;
         createFramebuffer();
+        _hasRenderedContent = false;
     }
 }
 
@@ -58,9 +58,20 @@ public:
 
     static documentation::Documentation Documentation();
 
+protected:
+    bool needsRerender() override;
+
 private:
+    /// Queues the text of the dashboard that is shown into the TextBatcher
+    void layoutDashboard();
+
     Dashboard _dashboard;
     properties::BoolProperty _useMainDashboard;
+
+    /// The TextBatcher checksum of the text currently in the framebuffer
+    uint64_t _renderedChecksum = 0;
+    glm::vec4 _renderedSize = glm::vec4(0.f);
+    bool _hasRenderedContent = false;
     //std::unique_ptr<ghoul::fontrendering::FontRenderer> _fontRenderer;
 
     //std::shared_ptr<ghoul::fontrendering::Font> _fontDate;
@@ -110,29 +110,31 @@ void ScreenSpaceFramebuffer::render() {
     const float yratio = _originalViewportSize.y / (size.w - size.y);;
 
     if (!_renderFunctions.empty()) {
-        glViewport(
-            static_cast<GLint>(-size.x * xratio),
-            static_cast<GLint>(-size.y * yratio),
-            static_cast<GLsizei>(_originalViewportSize.x * xratio),
-            static_cast<GLsizei>(_originalViewportSize.y * yratio)
-        );
-        GLint defaultFBO = _framebuffer->getActiveObject();
-        _framebuffer->activate();
-
-        glClearColor(0.f, 0.f, 0.f, 0.f);
-        glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        for (const RenderFunction& renderFunction : _renderFunctions) {
-            renderFunction();
+        if (needsRerender()) {
+            glViewport(
+                static_cast<GLint>(-size.x * xratio),
+                static_cast<GLint>(-size.y * yratio),
+                static_cast<GLsizei>(_originalViewportSize.x * xratio),
+                static_cast<GLsizei>(_originalViewportSize.y * yratio)
+            );
+            GLint defaultFBO = _framebuffer->getActiveObject();
+            _framebuffer->activate();
+
+            glClearColor(0.f, 0.f, 0.f, 0.f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            for (const RenderFunction& renderFunction : _renderFunctions) {
+                renderFunction();
+            }
+            _framebuffer->deactivate();
+
+            glBindFramebuffer(GL_FRAMEBUFFER, defaultFBO);
+            glViewport(
+                0,
+                0,
+                static_cast<GLsizei>(resolution.x),
+                static_cast<GLsizei>(resolution.y)
+            );
         }
-        _framebuffer->deactivate();
-
-        glBindFramebuffer(GL_FRAMEBUFFER, defaultFBO);
-        glViewport(
-            0,
-            0,
-            static_cast<GLsizei>(resolution.x),
-            static_cast<GLsizei>(resolution.y)
-        );
 
         const glm::mat4 globalRotation = globalRotationMatrix();
         const glm::mat4 translation = translationMatrix();
@@ -147,20 +149,17 @@ void ScreenSpaceFramebuffer::render() {
 }
 
 bool ScreenSpaceFramebuffer::isReady() const {
-    bool ready = true;
-    if (!_shader) {
-        ready &= false;
-    }
-    if (!_texture) {
-        ready &= false;
-    }
-    return ready;
+    return _texture != nullptr;
 }
 
 void ScreenSpaceFramebuffer::setSize(glm::vec4 size) {
     _size = std::move(size);
 }
 
+bool ScreenSpaceFramebuffer::needsRerender() {
+    return true;
+}
+
 void ScreenSpaceFramebuffer::addRenderFunction(std::function<void()> renderFunction) {
     _renderFunctions.push_back(std::move(renderFunction));
 }
@@ -66,6 +66,15 @@ public:
 
 protected:
     void createFramebuffer();
+
+    /**
+     * Returns whether the render functions have to be called again this frame. If this
+     * returns \c false, the contents of the framebuffer from the previous frame are
+     * reused for the screen space plane. The default implementation always returns
+     * \c true.
+     */
+    virtual bool needsRerender();
+
     properties::Vec4Property _size;
 
 private:
@@ -26,8 +26,8 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/rendering/compressedtexture.h>
 #include <ghoul/filesystem/filesystem.h>
-#include <ghoul/io/texture/texturereader.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureconversion.h>
@@ -112,20 +112,16 @@ bool ScreenSpaceImageLocal::deinitializeGL() {
 
 void ScreenSpaceImageLocal::update() {
     if (_textureIsDirty && !_texturePath.value().empty()) {
-        std::unique_ptr<ghoul::opengl::Texture> texture =
-            ghoul::io::TextureReader::ref().loadTexture(absPath(_texturePath));
+        // Images don't need to start on 4-byte boundaries, for example if the image is
+        // only RGB
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-        if (texture) {
-            // Images don't need to start on 4-byte boundaries, for example if the
-            // image is only RGB
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-            texture->uploadTexture();
-
-            // Textures of planets looks much smoother with AnisotropicMipMap rather than
-            // linear
-            texture->setFilter(ghoul::opengl::Texture::FilterMode::LinearMipMap);
+        std::unique_ptr<ghoul::opengl::Texture> texture = rendering::loadTexture(
+            absPath(_texturePath),
+            ghoul::opengl::Texture::FilterMode::LinearMipMap
+        );
 
+        if (texture) {
             _texture = std::move(texture);
             _objectSize = _texture->dimensions();
             _textureIsDirty = false;
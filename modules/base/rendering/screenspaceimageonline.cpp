@@ -24,14 +24,9 @@
 
 #include <modules/base/rendering/screenspaceimageonline.h>
 
+#include <modules/base/basemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
-#include <openspace/engine/globals.h>
-#include <openspace/engine/downloadmanager.h>
-#include <ghoul/filesystem/filesystem.h>
-#include <ghoul/io/texture/texturereader.h>
-#include <ghoul/logging/logmanager.h>
-#include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/programobject.h>
 
 namespace {
@@ -111,83 +106,30 @@ ScreenSpaceImageOnline::ScreenSpaceImageOnline(const ghoul::Dictionary& dictiona
 ScreenSpaceImageOnline::~ScreenSpaceImageOnline() {} // NOLINT
 
 bool ScreenSpaceImageOnline::deinitializeGL() {
-    _texture = nullptr;
+    _image = nullptr;
 
     return ScreenSpaceRenderable::deinitializeGL();
 }
 
 void ScreenSpaceImageOnline::update() {
     if (_textureIsDirty) {
-        if (!_imageFuture.valid()) {
-            std::future<DownloadManager::MemoryFile> future = downloadImageToMemory(
-                _texturePath
-            );
-            if (future.valid()) {
-                _imageFuture = std::move(future);
-            }
-        }
-
-        if (_imageFuture.valid() && DownloadManager::futureReady(_imageFuture)) {
-            DownloadManager::MemoryFile imageFile = _imageFuture.get();
-
-            if (imageFile.corrupted) {
-                LERRORC(
-                    "ScreenSpaceImageOnline",
-                    fmt::format("Error loading image from URL '{}'", _texturePath)
-                );
-                return;
-            }
-
-            std::unique_ptr<ghoul::opengl::Texture> texture =
-                ghoul::io::TextureReader::ref().loadTexture(
-                    reinterpret_cast<void*>(imageFile.buffer),
-                    imageFile.size,
-                    imageFile.format
-                );
-
-            if (texture) {
-                // Images don't need to start on 4-byte boundaries, for example if the
-                // image is only RGB
-                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-                texture->uploadTexture();
-
-                // Textures of planets looks much smoother with AnisotropicMipMap rather
-                // than linear
-                texture->setFilter(ghoul::opengl::Texture::FilterMode::LinearMipMap);
-
-                _texture = std::move(texture);
-                _objectSize = _texture->dimensions();
-                _textureIsDirty = false;
-            }
-        }
+        // The image is shared with all other renderables showing the same URL and is
+        // downloaded, decoded, and uploaded by the cache over the next frames
+        _image = BaseModule::OnlineImages.request(_texturePath);
+        _hasImageSize = false;
+        _textureIsDirty = false;
     }
-}
 
-std::future<DownloadManager::MemoryFile> ScreenSpaceImageOnline::downloadImageToMemory(
-                                                                   const std::string& url)
-{
-    return global::downloadManager.fetchFile(
-        url,
-        [url](const DownloadManager::MemoryFile&) {
-            LDEBUGC(
-                "ScreenSpaceImageOnline",
-                "Download to memory finished for screen space image"
-            );
-        },
-        [url](const std::string& err) {
-            LDEBUGC(
-                "ScreenSpaceImageOnline",
-                "Download to memory failer for screen space image: " + err
-            );
-        }
-    );
+    // The size is known as soon as the image header has been read, which is before any
+    // of the pixels are resident
+    if (_image && !_hasImageSize && _image->dimensions.x > 0) {
+        _objectSize = _image->dimensions;
+        _hasImageSize = true;
+    }
 }
 
 void ScreenSpaceImageOnline::bindTexture() {
-    if (_texture) {
-        _texture->bind();
-    }
+    glBindTexture(GL_TEXTURE_2D, _image ? _image->texture : 0);
 }
 
 } // namespace openspace
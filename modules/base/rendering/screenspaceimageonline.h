@@ -27,11 +27,9 @@
 
 #include <openspace/rendering/screenspacerenderable.h>
 
-#include <openspace/engine/downloadmanager.h>
+#include <modules/base/rendering/onlineimagecache.h>
 #include <openspace/properties/stringproperty.h>
 
-namespace ghoul::opengl { class Texture; }
-
 namespace openspace {
 
 namespace documentation { struct Documentation; }
@@ -50,16 +48,13 @@ public:
 protected:
     bool _downloadImage = false;
     bool _textureIsDirty;
-    std::future<DownloadManager::MemoryFile> _imageFuture;
     properties::StringProperty _texturePath;
 
 private:
     void bindTexture() override;
 
-    std::future<DownloadManager::MemoryFile> downloadImageToMemory(
-        const std::string& url);
-
-    std::unique_ptr<ghoul::opengl::Texture> _texture;
+    std::shared_ptr<const OnlineImageCache::Image> _image;
+    bool _hasImageSize = false;
 };
 
 } // namespace openspace
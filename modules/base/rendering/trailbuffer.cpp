@@ -0,0 +1,458 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <modules/base/rendering/trailbuffer.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/opengl/programobject.h>
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace {
+    constexpr const char* ProgramName = "EphemerisProgram";
+
+    constexpr const std::array<const char*, 2> UniformNames = {
+        "projectionTransform", "renderPhase"
+    };
+
+    // The number of vertices the buffer starts with, which is enough for a few dozen
+    // trails before it has to grow
+    constexpr const GLsizei InitialCapacity = 1 << 16;
+
+    // Fragile! Keep in sync with fragment shader
+    enum RenderPhase {
+        RenderPhaseLines = 0,
+        RenderPhasePoints
+    };
+} // namespace
+
+namespace openspace {
+
+static_assert(
+    sizeof(TrailBuffer::Vertex) == 3 * sizeof(float),
+    "The vertex attribute specification expects tightly packed vertices"
+);
+
+bool TrailBuffer::Allocation::isValid() const {
+    return offset >= 0;
+}
+
+void TrailBuffer::initializeGL() {
+    ++_nUsers;
+    if (_nUsers > 1) {
+        return;
+    }
+
+    static_assert(sizeof(DrawData) % sizeof(glm::dmat4) == 0, "std430 array stride");
+
+    _program = global::renderEngine.buildRenderProgram(
+        ProgramName,
+        absPath("${MODULE_BASE}/shaders/renderabletrail_vs.glsl"),
+        absPath("${MODULE_BASE}/shaders/renderabletrail_fs.glsl")
+    );
+    ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+
+    _drawDataBinding = std::make_unique<ghoul::opengl::BufferBinding<
+        ghoul::opengl::bufferbinding::Buffer::ShaderStorage>
+    >();
+
+    glGenVertexArrays(1, &_vao);
+    glGenBuffers(1, &_drawIndexBuffer);
+    glGenBuffers(1, &_drawDataBuffer);
+    glGenBuffers(1, &_commandBuffer);
+
+    grow(InitialCapacity);
+}
+
+void TrailBuffer::deinitializeGL() {
+    ghoul_assert(_nUsers > 0, "More deinitializations than initializations");
+    --_nUsers;
+    if (_nUsers > 0) {
+        return;
+    }
+
+    glDeleteVertexArrays(1, &_vao);
+    _vao = 0;
+    glDeleteBuffers(1, &_vertexBuffer);
+    _vertexBuffer = 0;
+    glDeleteBuffers(1, &_drawIndexBuffer);
+    _drawIndexBuffer = 0;
+    glDeleteBuffers(1, &_drawDataBuffer);
+    _drawDataBuffer = 0;
+    glDeleteBuffers(1, &_commandBuffer);
+    _commandBuffer = 0;
+
+    _capacity = 0;
+    _drawIndexCapacity = 0;
+    _freeRanges.clear();
+    _draws.clear();
+    _drawDataBinding = nullptr;
+
+    global::renderEngine.removeRenderProgram(_program.get());
+    _program = nullptr;
+}
+
+bool TrailBuffer::isReady() const {
+    return _program != nullptr;
+}
+
+TrailBuffer::Allocation TrailBuffer::allocate(GLsizei nVertices, bool isRingBuffer) {
+    ghoul_assert(nVertices > 0, "Allocation must not be empty");
+
+    // Ring buffers store a copy of their first vertex after their last one
+    const GLsizei size = isRingBuffer ? nVertices + 1 : nVertices;
+
+    auto it = std::find_if(
+        _freeRanges.begin(),
+        _freeRanges.end(),
+        [size](const FreeRange& range) { return range.size >= size; }
+    );
+    if (it == _freeRanges.end()) {
+        grow(_capacity + size);
+        // Growing extends the last free range, which is now big enough
+        it = _freeRanges.end() - 1;
+    }
+
+    Allocation allocation;
+    allocation.offset = it->offset;
+    allocation.size = nVertices;
+    allocation.isRingBuffer = isRingBuffer;
+
+    it->offset += size;
+    it->size -= size;
+    if (it->size == 0) {
+        _freeRanges.erase(it);
+    }
+    return allocation;
+}
+
+void TrailBuffer::free(Allocation& allocation) {
+    if (!allocation.isValid()) {
+        return;
+    }
+
+    FreeRange range = {
+        allocation.offset,
+        allocation.isRingBuffer ? allocation.size + 1 : allocation.size
+    };
+    allocation = Allocation();
+
+    // The free ranges are sorted by their offset, so we only have to check the direct
+    // neighbors for a merge
+    auto next = std::lower_bound(
+        _freeRanges.begin(),
+        _freeRanges.end(),
+        range,
+        [](const FreeRange& lhs, const FreeRange& rhs) { return lhs.offset < rhs.offset; }
+    );
+    if (next != _freeRanges.end() && range.offset + range.size == next->offset) {
+        range.size += next->size;
+        next = _freeRanges.erase(next);
+    }
+    if (next != _freeRanges.begin()) {
+        auto prev = next - 1;
+        if (prev->offset + prev->size == range.offset) {
+            prev->size += range.size;
+            return;
+        }
+    }
+    _freeRanges.insert(next, range);
+}
+
+void TrailBuffer::write(const Allocation& allocation, GLint first, GLsizei count,
+                        const Vertex* vertices)
+{
+    ghoul_assert(allocation.isValid(), "Invalid allocation");
+    ghoul_assert(first >= 0 && first + count <= allocation.size, "Write out of range");
+
+    if (count == 0) {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glBufferSubData(
+        GL_ARRAY_BUFFER,
+        (allocation.offset + first) * sizeof(Vertex),
+        count * sizeof(Vertex),
+        vertices
+    );
+    if (allocation.isRingBuffer && first == 0) {
+        // Keep the copy of the first vertex behind the last one up to date
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            (allocation.offset + allocation.size) * sizeof(Vertex),
+            sizeof(Vertex),
+            vertices
+        );
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool TrailBuffer::submit(const Draw& draw) {
+    ghoul_assert(draw.allocation.isValid(), "Invalid allocation");
+
+    _draws.push_back(draw);
+    return _draws.size() == 1;
+}
+
+void TrailBuffer::flush(const glm::mat4& projectionTransform) {
+    if (_draws.empty()) {
+        return;
+    }
+
+    // The per-draw values that are read by the vertex shader through the draw index
+    _drawData.clear();
+    _drawData.reserve(_draws.size());
+    for (const Draw& draw : _draws) {
+        DrawData d;
+        d.modelViewTransform = draw.modelViewTransform;
+        d.colorOpacity = glm::vec4(draw.color, draw.opacity);
+        d.vertexSorting = draw.vertexSorting;
+        d.idOffset = draw.idOffset;
+        d.nVertices = draw.nVertices;
+        d.stride = draw.stride;
+        d.pointSize = draw.pointSize;
+        d.useLineFade = draw.useLineFade ? 1 : 0;
+        d.lineFade = draw.lineFade;
+        d.baseVertex = draw.allocation.offset;
+        d.ringSize = draw.allocation.isRingBuffer ? draw.allocation.size : 0;
+        std::fill(std::begin(d.padding), std::end(d.padding), 0);
+        _drawData.push_back(d);
+    }
+
+    // The line width is not part of the commands, so the lines are drawn in one call for
+    // each line width that is used. The points vary their size in the vertex shader
+    std::vector<GLuint> lineDraws;
+    for (GLuint i = 0; i < static_cast<GLuint>(_draws.size()); ++i) {
+        if (_draws[i].renderLines) {
+            lineDraws.push_back(i);
+        }
+    }
+    std::stable_sort(
+        lineDraws.begin(),
+        lineDraws.end(),
+        [this](GLuint lhs, GLuint rhs) {
+            return _draws[lhs].lineWidth < _draws[rhs].lineWidth;
+        }
+    );
+
+    struct LineGroup {
+        float lineWidth;
+        size_t firstCommand;
+        size_t nCommands;
+    };
+    std::vector<LineGroup> lineGroups;
+    _commands.clear();
+    for (GLuint i : lineDraws) {
+        if (lineGroups.empty() || lineGroups.back().lineWidth != _draws[i].lineWidth) {
+            lineGroups.push_back({ _draws[i].lineWidth, _commands.size(), 0 });
+        }
+        addCommands(_draws[i], i, true, _commands);
+        lineGroups.back().nCommands = _commands.size() - lineGroups.back().firstCommand;
+    }
+
+    const size_t firstPointCommand = _commands.size();
+    for (GLuint i = 0; i < static_cast<GLuint>(_draws.size()); ++i) {
+        if (_draws[i].renderPoints) {
+            addCommands(_draws[i], i, false, _commands);
+        }
+    }
+    const size_t nPointCommands = _commands.size() - firstPointCommand;
+
+    // Upload the draw index for every draw, which only changes when more draws are used
+    // than ever before
+    const GLsizei nDraws = static_cast<GLsizei>(_draws.size());
+    if (nDraws > _drawIndexCapacity) {
+        _drawIndexCapacity = std::max(nDraws, 2 * _drawIndexCapacity);
+        std::vector<GLuint> indices(_drawIndexCapacity);
+        std::iota(indices.begin(), indices.end(), 0);
+        glBindBuffer(GL_ARRAY_BUFFER, _drawIndexBuffer);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            indices.size() * sizeof(GLuint),
+            indices.data(),
+            GL_STATIC_DRAW
+        );
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _drawDataBuffer);
+    glBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        _drawData.size() * sizeof(DrawData),
+        _drawData.data(),
+        GL_STREAM_DRAW
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        _drawDataBinding->bindingNumber(),
+        _drawDataBuffer
+    );
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer);
+    glBufferData(
+        GL_DRAW_INDIRECT_BUFFER,
+        _commands.size() * sizeof(DrawCommand),
+        _commands.data(),
+        GL_STREAM_DRAW
+    );
+
+    _program->activate();
+    // The block binding is lost whenever the render engine relinks the program
+    _program->setSsboBinding("TrailDraws", _drawDataBinding->bindingNumber());
+    _program->setUniform(_uniformCache.projectionTransform, projectionTransform);
+
+    const bool usingFramebufferRenderer =
+        global::renderEngine.rendererImplementation() ==
+        RenderEngine::RendererImplementation::Framebuffer;
+
+    if (usingFramebufferRenderer) {
+        glDepthMask(false);
+    }
+
+    glBindVertexArray(_vao);
+
+    _program->setUniform(_uniformCache.renderPhase, RenderPhaseLines);
+    for (const LineGroup& group : lineGroups) {
+        glLineWidth(group.lineWidth);
+        glMultiDrawArraysIndirect(
+            GL_LINE_STRIP,
+            reinterpret_cast<void*>(group.firstCommand * sizeof(DrawCommand)), // NOLINT
+            static_cast<GLsizei>(group.nCommands),
+            0
+        );
+    }
+
+    if (nPointCommands > 0) {
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        _program->setUniform(_uniformCache.renderPhase, RenderPhasePoints);
+        glMultiDrawArraysIndirect(
+            GL_POINTS,
+            reinterpret_cast<void*>(firstPointCommand * sizeof(DrawCommand)), // NOLINT
+            static_cast<GLsizei>(nPointCommands),
+            0
+        );
+        glDisable(GL_PROGRAM_POINT_SIZE);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    if (usingFramebufferRenderer) {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(true);
+    }
+
+    _program->deactivate();
+
+    _draws.clear();
+}
+
+void TrailBuffer::grow(GLsizei nVertices) {
+    const GLsizei oldCapacity = _capacity;
+    _capacity = std::max(nVertices, 2 * oldCapacity);
+
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, _capacity * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // The allocations keep their offsets, so the old vertices are copied to the front
+    if (_vertexBuffer != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, _vertexBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glCopyBufferSubData(
+            GL_COPY_READ_BUFFER,
+            GL_COPY_WRITE_BUFFER,
+            0,
+            0,
+            oldCapacity * sizeof(Vertex)
+        );
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &_vertexBuffer);
+    }
+    _vertexBuffer = buffer;
+
+    if (!_freeRanges.empty() &&
+        _freeRanges.back().offset + _freeRanges.back().size == oldCapacity)
+    {
+        _freeRanges.back().size += _capacity - oldCapacity;
+    }
+    else {
+        _freeRanges.push_back({ oldCapacity, _capacity - oldCapacity });
+    }
+
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // The draw index advances once per instance, and every command draws a single
+    // instance whose base instance is the index of its draw
+    glBindBuffer(GL_ARRAY_BUFFER, _drawIndexBuffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, 0, nullptr);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TrailBuffer::addCommands(const Draw& draw, GLuint drawIndex, bool isLineStrip,
+                              std::vector<DrawCommand>& commands) const
+{
+    const Allocation& a = draw.allocation;
+    const GLuint count = static_cast<GLuint>(std::min(draw.count, a.size));
+    if (count == 0) {
+        return;
+    }
+
+    const GLuint first = static_cast<GLuint>(draw.first);
+    const GLuint size = static_cast<GLuint>(a.size);
+    const GLuint offset = static_cast<GLuint>(a.offset);
+    if (!a.isRingBuffer || first + count <= size) {
+        commands.push_back({ count, 1, offset + first, drawIndex });
+        return;
+    }
+
+    // The range wraps around the end of the ring buffer and is split in two. A line
+    // strip also draws the copy of the first vertex, which closes the gap between the
+    // two parts
+    const GLuint nFirstPart = size - first;
+    commands.push_back({
+        isLineStrip ? nFirstPart + 1 : nFirstPart,
+        1,
+        offset + first,
+        drawIndex
+    });
+    commands.push_back({ count - nFirstPart, 1, offset, drawIndex });
+}
+
+} // namespace openspace
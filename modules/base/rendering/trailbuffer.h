@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_MODULE_BASE___TRAILBUFFER___H__
+#define __OPENSPACE_MODULE_BASE___TRAILBUFFER___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/bufferbinding.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/uniformcache.h>
+#include <memory>
+#include <vector>
+
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace {
+
+/**
+ * The TrailBuffer stores the vertices of all RenderableTrail%s in a single vertex buffer
+ * and draws them all at once. Each trail owns one or more Allocation%s in the buffer
+ * that it writes its vertices into. Every frame, the trails submit a Draw for the ranges
+ * they want to show, together with their transformation and appearance. These values
+ * are collected into a storage buffer and flush draws all lines that share a line width
+ * and all points with a single \c glMultiDrawArraysIndirect call each.
+ *
+ * The buffer is created by the first call to initializeGL and destroyed by the matching
+ * last call to deinitializeGL, so each trail has to call both exactly once.
+ */
+class TrailBuffer {
+public:
+    /// The layout of a single vertex in the buffer
+    struct Vertex {
+        float x, y, z;
+    };
+
+    /// A contiguous range of vertices in the buffer that belongs to one trail
+    struct Allocation {
+        /// The index of the first vertex of this allocation in the buffer
+        GLint offset = -1;
+        /// The number of vertices that can be written into the allocation
+        GLsizei size = 0;
+        /// If this is \c true, draws of this allocation can wrap around its end. These
+        /// allocations keep a copy of their first vertex after the last one so that a
+        /// wrapping line strip stays connected
+        bool isRingBuffer = false;
+
+        bool isValid() const;
+    };
+
+    /// The information to draw one range of an allocation
+    struct Draw {
+        Allocation allocation;
+        /// The first vertex to draw, relative to the beginning of the allocation
+        GLint first = 0;
+        /// The number of vertices to draw. For a ring buffer allocation, the range may
+        /// wrap around the end of the allocation
+        GLsizei count = 0;
+
+        glm::dmat4 modelViewTransform = glm::dmat4(1.0);
+        glm::vec3 color = glm::vec3(1.f);
+        float opacity = 1.f;
+        bool useLineFade = false;
+        float lineFade = 1.f;
+        /// The value of RenderableTrail::RenderInformation::VertexSorting
+        int vertexSorting = 0;
+        /// The value that is subtracted from the vertex index to compute the fading
+        int idOffset = 0;
+        /// The number of vertices that the fading is distributed over
+        int nVertices = 0;
+        /// The stride between 'major' points
+        int stride = 1;
+        int pointSize = 1;
+
+        bool renderLines = true;
+        float lineWidth = 1.f;
+        bool renderPoints = false;
+    };
+
+    void initializeGL();
+    void deinitializeGL();
+
+    bool isReady() const;
+
+    /**
+     * Reserves room for \p nVertices vertices, growing the buffer if necessary. The
+     * returned allocation stays valid until it is passed to #free.
+     */
+    Allocation allocate(GLsizei nVertices, bool isRingBuffer = false);
+
+    /// Returns the vertices of the \p allocation to the buffer and invalidates it
+    void free(Allocation& allocation);
+
+    /**
+     * Writes the \p count \p vertices into the \p allocation, starting with its vertex
+     * \p first.
+     */
+    void write(const Allocation& allocation, GLint first, GLsizei count,
+        const Vertex* vertices);
+
+    /**
+     * Adds the \p draw to the draws of the next #flush.
+     *
+     * \return \c true if this was the first draw since the last flush, in which case the
+     *         caller is responsible for scheduling the flush
+     */
+    bool submit(const Draw& draw);
+
+    /// Draws all submitted draws with the \p projectionTransform and clears them
+    void flush(const glm::mat4& projectionTransform);
+
+private:
+    /// A range of unused vertices in the buffer
+    struct FreeRange {
+        GLint offset;
+        GLsizei size;
+    };
+
+    /// The per-draw values as they are laid out in the storage buffer
+    struct DrawData {
+        glm::dmat4 modelViewTransform;
+        glm::vec4 colorOpacity;
+        GLint vertexSorting;
+        GLint idOffset;
+        GLint nVertices;
+        GLint stride;
+        GLint pointSize;
+        GLint useLineFade;
+        GLfloat lineFade;
+        GLint baseVertex;
+        /// The size of a ring buffer allocation, or 0, to fold its copied first vertex
+        GLint ringSize;
+        // The std430 layout aligns the array elements to the alignment of the dmat4
+        GLint padding[3];
+    };
+
+    /// The layout of the commands of glMultiDrawArraysIndirect
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+
+    /// Resizes the vertex buffer so that it can hold at least \p nVertices vertices
+    void grow(GLsizei nVertices);
+
+    /// Adds the commands drawing the \p draw with index \p drawIndex to \p commands
+    void addCommands(const Draw& draw, GLuint drawIndex, bool isLineStrip,
+        std::vector<DrawCommand>& commands) const;
+
+    int _nUsers = 0;
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _program;
+    UniformCache(projectionTransform, renderPhase) _uniformCache;
+
+    GLuint _vao = 0;
+    GLuint _vertexBuffer = 0;
+    GLsizei _capacity = 0;
+    std::vector<FreeRange> _freeRanges;
+
+    /// The draw index of each instance, which is selected by the base instance of the
+    /// commands as the drawIndex attribute
+    GLuint _drawIndexBuffer = 0;
+    GLsizei _drawIndexCapacity = 0;
+    GLuint _drawDataBuffer = 0;
+    std::unique_ptr<ghoul::opengl::BufferBinding<
+        ghoul::opengl::bufferbinding::Buffer::ShaderStorage>> _drawDataBinding;
+    GLuint _commandBuffer = 0;
+
+    std::vector<Draw> _draws;
+    std::vector<DrawData> _drawData;
+    std::vector<DrawCommand> _commands;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_BASE___TRAILBUFFER___H__
@@ -95,9 +95,14 @@ ConstantRotation::ConstantRotation(const ghoul::Dictionary& dictionary)
     }
 }
 
+bool ConstantRotation::isThreadSafe() const {
+    return true;
+}
+
 glm::dmat3 ConstantRotation::matrix(const UpdateData& data) const {
     if (data.time.j2000Seconds() == data.previousFrameTime.j2000Seconds()) {
-        return glm::dmat3();
+        // Time did not advance, but the axis might have changed
+        return glm::toMat3(glm::angleAxis(_accumulatedRotation, _rotationAxis.value()));
     }
 
     const double rotPerSec = _rotationRate;
@@ -332,7 +332,7 @@ FixedRotation::FixedRotation(const ghoul::Dictionary& dictionary)
     , _attachedObject(AttachedInfo, "")
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "FixedRotation"
     );
@@ -549,6 +549,11 @@ bool FixedRotation::initialize() {
     return res;
 }
 
+bool FixedRotation::dependsOnExternalState() const {
+    // The axes are computed from the positions of other scene graph nodes
+    return true;
+}
+
 glm::dmat3 FixedRotation::matrix(const UpdateData&) const {
     if (!_enabled) {
         return glm::dmat3();
@@ -48,6 +48,7 @@ public:
     static documentation::Documentation Documentation();
 
     glm::dmat3 matrix(const UpdateData& data) const override;
+    bool dependsOnExternalState() const override;
 
 private:
     glm::vec3 xAxis() const;
@@ -32,6 +32,7 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/defer.h>
 #include <chrono>
 
 namespace {
@@ -77,9 +78,11 @@ LuaRotation::LuaRotation()
     addProperty(_luaScriptFile);
 
     _luaScriptFile.onChange([&]() {
+        _needsReload = true;
         requireUpdate();
         _fileHandle = std::make_unique<ghoul::filesystem::File>(_luaScriptFile);
         _fileHandle->setCallback([&](const ghoul::filesystem::File&) {
+            _needsReload = true;
             requireUpdate();
         });
     });
@@ -87,7 +90,7 @@ LuaRotation::LuaRotation()
 
 LuaRotation::LuaRotation(const ghoul::Dictionary& dictionary) : LuaRotation() {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "LuaRotation"
     );
@@ -95,20 +98,59 @@ LuaRotation::LuaRotation(const ghoul::Dictionary& dictionary) : LuaRotation() {
     _luaScriptFile = absPath(dictionary.value<std::string>(ScriptInfo.identifier));
 }
 
-glm::dmat3 LuaRotation::matrix(const UpdateData& data) const {
-    ghoul::lua::runScriptFile(_state, _luaScriptFile);
+bool LuaRotation::isThreadSafe() const {
+    // Every LuaRotation owns its Lua state and all accesses to it are serialized
+    return true;
+}
+
+void LuaRotation::loadScript() const {
+    if (_functionReference != LUA_NOREF) {
+        luaL_unref(_state, LUA_REGISTRYINDEX, _functionReference);
+        _functionReference = LUA_NOREF;
+    }
+    _needsReload = false;
+
+    try {
+        ghoul::lua::runScriptFile(_state, _luaScriptFile);
+    }
+    catch (const ghoul::lua::LuaLoadingException& e) {
+        LERRORC(e.component, e.message);
+        return;
+    }
+    catch (const ghoul::lua::LuaExecutionException& e) {
+        LERRORC(e.component, e.message);
+        return;
+    }
 
-    // Get the scaling function
     lua_getglobal(_state, "rotation");
-    const bool isFunction = lua_isfunction(_state, -1);
-    if (!isFunction) {
+    if (!lua_isfunction(_state, -1)) {
+        lua_pop(_state, 1);
         LERRORC(
             "LuaRotation",
-            fmt::format("Script '{}' does nto have a function 'rotation'", _luaScriptFile)
+            fmt::format("Script '{}' does not have a function 'rotation'", _luaScriptFile)
         );
+        return;
+    }
+    _functionReference = luaL_ref(_state, LUA_REGISTRYINDEX);
+}
+
+glm::dmat3 LuaRotation::dmat3 LuaRotation(const UpdateData& data) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // The script is only executed once to define the function and again when the file
+    // changes, instead of being parsed for every evaluation
+    if (_needsReload) {
+        loadScript();
+    }
+    if (_functionReference == LUA_NOREF) {
         return glm::dmat3(1.0);
     }
 
+    const int top = lua_gettop(_state);
+    defer { lua_settop(_state, top); };
+
+    lua_rawgeti(_state, LUA_REGISTRYINDEX, _functionReference);
+
     // First argument is the number of seconds past the J2000 epoch in ingame time
     ghoul::lua::push(_state, data.time.j2000Seconds());
 
@@ -117,21 +159,22 @@ glm::dmat3 LuaRotation::matrix(const UpdateData& data) const {
 
     // Third argument is the number of milliseconds past the J2000 epoch in wallclock
     using namespace std::chrono;
-    auto now = high_resolution_clock::now();
+    const auto now = high_resolution_clock::now();
     ghoul::lua::push(_state, duration_cast<milliseconds>(now.time_since_epoch()).count());
 
-    // Execute the scaling function
-    int success = lua_pcall(_state, 2, 9, 0);
+    // Execute the rotation function
+    const int success = lua_pcall(_state, 3, 9, 0);
     if (success != 0) {
         LERRORC(
-            "LuaScale",
+            "LuaRotation",
             fmt::format("Error executing 'rotation': {}", lua_tostring(_state, -1))
         );
+        return glm::dmat3(1.0);
     }
 
     double values[9];
     for (int i = 0; i < 9; ++i) {
-        values[i] = luaL_checknumber(_state, -1 - i);
+        values[i] = lua_tonumber(_state, top + 1 + i);
     }
 
     return glm::make_mat3(values);
@@ -29,7 +29,10 @@
 
 #include <openspace/properties/stringproperty.h>
 
+#include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/luastate.h>
+#include <atomic>
+#include <mutex>
 
 namespace ghoul::filesystem { class File; }
 
@@ -43,13 +46,21 @@ public:
     LuaRotation(const ghoul::Dictionary& dictionary);
 
     glm::dmat3 matrix(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
 
     static documentation::Documentation Documentation();
 
 private:
+    /// Runs the script file and keeps a reference to its \c rotation function
+    void loadScript() const;
+
     properties::StringProperty _luaScriptFile;
     std::unique_ptr<ghoul::filesystem::File> _fileHandle;
     ghoul::lua::LuaState _state;
+
+    mutable std::mutex _mutex;
+    mutable int _functionReference = LUA_NOREF;
+    mutable std::atomic_bool _needsReload = true;
 };
 
 } // namespace openspace
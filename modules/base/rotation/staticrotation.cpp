@@ -99,7 +99,7 @@ StaticRotation::StaticRotation()
 
 StaticRotation::StaticRotation(const ghoul::Dictionary& dictionary) : StaticRotation() {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "StaticRotation"
     );
@@ -127,6 +127,14 @@ StaticRotation::StaticRotation(const ghoul::Dictionary& dictionary) : StaticRota
     });
 }
 
+bool StaticRotation::isThreadSafe() const {
+    return true;
+}
+
+bool StaticRotation::dependsOnTime() const {
+    return false;
+}
+
 glm::dmat3 StaticRotation::matrix(const UpdateData&) const {
     if (_matrixIsDirty) {
         _cachedMatrix = glm::mat3_cast(glm::quat(_eulerRotation.value()));
@@ -39,6 +39,8 @@ public:
     StaticRotation(const ghoul::Dictionary& dictionary);
 
     glm::dmat3 matrix(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
+    bool dependsOnTime() const override;
 
     static documentation::Documentation Documentation();
 
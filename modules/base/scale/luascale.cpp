@@ -32,6 +32,7 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/defer.h>
 
 #include <chrono>
 
@@ -72,55 +73,97 @@ LuaScale::LuaScale()
     addProperty(_luaScriptFile);
 
     _luaScriptFile.onChange([&]() {
+        _needsReload = true;
         requireUpdate();
         _fileHandle = std::make_unique<ghoul::filesystem::File>(_luaScriptFile);
         _fileHandle->setCallback([&](const ghoul::filesystem::File&) {
+            _needsReload = true;
             requireUpdate();
         });
     });
 }
 
 LuaScale::LuaScale(const ghoul::Dictionary& dictionary) : LuaScale() {
-    documentation::testSpecificationAndThrow(Documentation(), dictionary, "LuaScale");
+    documentation::testSpecificationAndThrow(Documentation, dictionary, "LuaScale");
 
     _luaScriptFile = absPath(dictionary.value<std::string>(ScriptInfo.identifier));
 }
 
-double LuaScale::scaleValue(const UpdateData& data) const {
-    ghoul::lua::runScriptFile(_state, _luaScriptFile);
+bool LuaScale::isThreadSafe() const {
+    // Every LuaScale owns its Lua state and all accesses to it are serialized
+    return true;
+}
+
+void LuaScale::loadScript() const {
+    if (_functionReference != LUA_NOREF) {
+        luaL_unref(_state, LUA_REGISTRYINDEX, _functionReference);
+        _functionReference = LUA_NOREF;
+    }
+    _needsReload = false;
+
+    try {
+        ghoul::lua::runScriptFile(_state, _luaScriptFile);
+    }
+    catch (const ghoul::lua::LuaLoadingException& e) {
+        LERRORC(e.component, e.message);
+        return;
+    }
+    catch (const ghoul::lua::LuaExecutionException& e) {
+        LERRORC(e.component, e.message);
+        return;
+    }
 
-    // Get the scaling function
     lua_getglobal(_state, "scale");
-    const bool isFunction = lua_isfunction(_state, -1);
-    if (!isFunction) {
+    if (!lua_isfunction(_state, -1)) {
+        lua_pop(_state, 1);
         LERRORC(
             "LuaScale",
             fmt::format("Script '{}' does not have a function 'scale'", _luaScriptFile)
         );
+        return;
+    }
+    _functionReference = luaL_ref(_state, LUA_REGISTRYINDEX);
+}
+
+double LuaScale::scaleValue(const UpdateData& data) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // The script is only executed once to define the function and again when the file
+    // changes, instead of being parsed for every evaluation
+    if (_needsReload) {
+        loadScript();
+    }
+    if (_functionReference == LUA_NOREF) {
         return 0.0;
     }
 
+    const int top = lua_gettop(_state);
+    defer { lua_settop(_state, top); };
+
+    lua_rawgeti(_state, LUA_REGISTRYINDEX, _functionReference);
+
     // First argument is the number of seconds past the J2000 epoch in ingame time
     ghoul::lua::push(_state, data.time.j2000Seconds());
 
-    // Second argument is the number of seconds past the J2000 epoch of last frame
+    // Second argument is the number of seconds past the J2000 epoch of the last frame
     ghoul::lua::push(_state, data.previousFrameTime.j2000Seconds());
 
-    // Second argument is the number of milliseconds past the J2000 epoch in wallclock
+    // Third argument is the number of milliseconds past the J2000 epoch in wallclock
     using namespace std::chrono;
-    const auto now = std::chrono::high_resolution_clock::now();
+    const auto now = high_resolution_clock::now();
     ghoul::lua::push(_state, duration_cast<milliseconds>(now.time_since_epoch()).count());
 
-    // Execute the scaling function
-    const int success = lua_pcall(_state, 2, 1, 0);
+    // Execute the scale function
+    const int success = lua_pcall(_state, 3, 1, 0);
     if (success != 0) {
         LERRORC(
             "LuaScale",
             fmt::format("Error executing 'scale': {}", lua_tostring(_state, -1))
         );
+        return 0.0;
     }
 
-    return luaL_checknumber(_state, -1);
+    return lua_tonumber(_state, -1);
 }
 
 } // namespace openspace
@@ -28,7 +28,10 @@
 #include <openspace/scene/scale.h>
 
 #include <openspace/properties/stringproperty.h>
+#include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/luastate.h>
+#include <atomic>
+#include <mutex>
 
 namespace ghoul::filesystem { class File; }
 
@@ -42,13 +45,21 @@ public:
     LuaScale(const ghoul::Dictionary& dictionary);
 
     double scaleValue(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
 
     static documentation::Documentation Documentation();
 
 private:
+    /// Runs the script file and keeps a reference to its \c scale function
+    void loadScript() const;
+
     properties::StringProperty _luaScriptFile;
     std::unique_ptr<ghoul::filesystem::File> _fileHandle;
     ghoul::lua::LuaState _state;
+
+    mutable std::mutex _mutex;
+    mutable int _functionReference = LUA_NOREF;
+    mutable std::atomic_bool _needsReload = true;
 };
 
 } // namespace openspace
@@ -54,6 +54,14 @@ documentation::Documentation StaticScale::Documentation() {
     };
 }
 
+bool StaticScale::isThreadSafe() const {
+    return true;
+}
+
+bool StaticScale::dependsOnTime() const {
+    return false;
+}
+
 double StaticScale::scaleValue(const UpdateData&) const {
     return _scaleValue;
 }
@@ -67,7 +75,7 @@ StaticScale::StaticScale() : _scaleValue(ScaleInfo, 1.0, 1.0, 1e6) {
 }
 
 StaticScale::StaticScale(const ghoul::Dictionary& dictionary) : StaticScale() {
-    documentation::testSpecificationAndThrow(Documentation(), dictionary, "StaticScale");
+    documentation::testSpecificationAndThrow(Documentation, dictionary, "StaticScale");
 
     _scaleValue = static_cast<float>(dictionary.value<double>(ScaleInfo.identifier));
 }
@@ -38,6 +38,8 @@ public:
     StaticScale();
     StaticScale(const ghoul::Dictionary& dictionary);
     double scaleValue(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
+    bool dependsOnTime() const override;
 
     static documentation::Documentation Documentation();
 
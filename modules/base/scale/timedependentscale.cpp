@@ -91,7 +91,7 @@ TimeDependentScale::TimeDependentScale(const ghoul::Dictionary& dictionary)
     , _clampToPositive(ClampToPositiveInfo, true)
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "TimeDependentScale"
     );
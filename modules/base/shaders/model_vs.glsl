@@ -29,18 +29,18 @@
 layout(location = 0) in vec4 in_position;
 layout(location = 1) in vec2 in_st;
 layout(location = 2) in vec3 in_normal;
+layout(location = 3) in mat4 in_modelViewTransform;
 
 out vec2 vs_st;
 out vec3 vs_normalViewSpace;
 out float vs_screenSpaceDepth;
 out vec4 vs_positionCameraSpace;
 
-uniform mat4 modelViewTransform;
 uniform mat4 projectionTransform;
 
 
 void main() {
-    vs_positionCameraSpace = modelViewTransform * in_position;
+    vs_positionCameraSpace = in_modelViewTransform * in_position;
     vec4 positionClipSpace = projectionTransform * vs_positionCameraSpace;
     vec4 positionScreenSpace = z_normalization(positionClipSpace);
 
@@ -49,5 +49,5 @@ void main() {
     vs_screenSpaceDepth = positionScreenSpace.w;
     
     // The normal transform should be the transposed inverse of the model transform?
-    vs_normalViewSpace = normalize(mat3(modelViewTransform) * in_normal);
+    vs_normalViewSpace = normalize(mat3(in_modelViewTransform) * in_normal);
 }
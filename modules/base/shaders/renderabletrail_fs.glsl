@@ -28,12 +28,11 @@ in vec4 vs_positionScreenSpace;
 in vec4 vs_gPosition;
 in float fade;
 in float v_pointSize;
+flat in vec4 vs_colorOpacity;
 
-uniform vec3 color;
 uniform int renderPhase;
-uniform float opacity = 1.0;
 
-// Fragile! Keep in sync with RenderableTrail::render::RenderPhase 
+// Fragile! Keep in sync with TrailBuffer.cpp RenderPhase
 #define RenderPhaseLines 0
 #define RenderPhasePoints 1
 
@@ -42,7 +41,7 @@ uniform float opacity = 1.0;
 
 Fragment getFragment() {
     Fragment frag;
-    frag.color = vec4(color * fade, fade * opacity);
+    frag.color = vec4(vs_colorOpacity.rgb * fade, fade * vs_colorOpacity.a);
     frag.depth = vs_positionScreenSpace.w;
     frag.blend = BLEND_MODE_ADDITIVE;
 
@@ -27,21 +27,38 @@
 #include "PowerScaling/powerScaling_vs.hglsl"
 
 layout(location = 0) in vec3 in_point_position;
+// The index of the draw in the TrailDraws buffer, selected by the base instance
+layout(location = 1) in uint in_drawIndex;
 
 out vec4 vs_positionScreenSpace;
 out vec4 vs_gPosition;
 out float fade;
 out float v_pointSize;
+flat out vec4 vs_colorOpacity;
+
+// Fragile! Keep in sync with TrailBuffer::DrawData
+struct TrailDraw {
+    dmat4 modelViewTransform;
+    vec4 colorOpacity;
+    int vertexSortingMethod;
+    int idOffset;
+    int nVertices;
+    int stride;
+    int pointSize;
+    int useLineFade;
+    float lineFade;
+    int baseVertex;
+    int ringSize;
+    int padding0;
+    int padding1;
+    int padding2;
+};
+
+layout(std430) readonly buffer TrailDraws {
+    TrailDraw draws[];
+};
 
-uniform dmat4 modelViewTransform;
 uniform mat4 projectionTransform;
-uniform int idOffset;
-uniform int nVertices;
-uniform bool useLineFade;
-uniform float lineFade;
-uniform int vertexSortingMethod;
-uniform int pointSize;
-uniform int stride;
 
 // Fragile! Keep in sync with RenderableTrail::render
 #define VERTEX_SORTING_NEWESTFIRST 0
@@ -50,32 +67,45 @@ uniform int stride;
 
 
 void main() {
-    int modId = gl_VertexID;
+    TrailDraw draw = draws[in_drawIndex];
+
+    // The vertices of all trails share one buffer, so the index is made relative to the
+    // trail. Ring buffers repeat their first vertex after their last one
+    int vertexId = gl_VertexID - draw.baseVertex;
+    if (draw.ringSize > 0 && vertexId >= draw.ringSize) {
+        vertexId -= draw.ringSize;
+    }
+    int modId = vertexId;
 
-    if ((vertexSortingMethod != VERTEX_SORTING_NOSORTING) && useLineFade) {
+    if ((draw.vertexSortingMethod != VERTEX_SORTING_NOSORTING) &&
+        draw.useLineFade != 0)
+    {
         // Account for a potential rolling buffer
-        modId = gl_VertexID - idOffset;
+        modId = vertexId - draw.idOffset;
         if (modId < 0) {
-            modId += nVertices;
+            modId += draw.nVertices;
         }
 
         // Convert the index to a [0,1] ranger
-        float id = float(modId) / float(nVertices);
+        float id = float(modId) / float(draw.nVertices);
 
-        if (vertexSortingMethod == VERTEX_SORTING_NEWESTFIRST) {
+        if (draw.vertexSortingMethod == VERTEX_SORTING_NEWESTFIRST) {
             id = 1.0 - id;
         }
 
-        fade = clamp(id * lineFade, 0.0, 1.0); 
+        fade = clamp(id * draw.lineFade, 0.0, 1.0); 
     }
     else {
         fade = 1.0;
     }
 
-    vs_gPosition = vec4(modelViewTransform * dvec4(in_point_position, 1));
+    vs_colorOpacity = draw.colorOpacity;
+    vs_gPosition = vec4(draw.modelViewTransform * dvec4(in_point_position, 1));
     vs_positionScreenSpace = z_normalization(projectionTransform * vs_gPosition);
 
-    gl_PointSize = (stride == 1 || int(modId) % stride == 0) ? float(pointSize) : float(pointSize) / 2;
+    gl_PointSize = (draw.stride == 1 || int(modId) % draw.stride == 0) ?
+        float(draw.pointSize) :
+        float(draw.pointSize) / 2;
     v_pointSize  = gl_PointSize;
     gl_Position  = vs_positionScreenSpace;
 }
@@ -25,19 +25,48 @@
 #include "fragment.glsl"
 #include "PowerScaling/powerScaling_fs.hglsl"
 
+// Has to match ScreenSpaceBatcher::MaxBatchSize
+const int MaxBatchSize = 16;
+
 in vec2 vs_st;
 in vec4 vs_position;
+flat in int vs_item;
+
+uniform sampler2D Textures[MaxBatchSize];
+uniform float Alphas[MaxBatchSize];
+
+// An array of samplers may only be indexed with a dynamically uniform expression, which
+// the instance is not within a draw call, so each texture uses a constant index instead
+#define SAMPLE_ITEM(i) case i: return texture(Textures[i], st)
 
-uniform sampler2D texture1;
-uniform float OcclusionDepth;
-uniform float Alpha;
+vec4 sampleItem(int item, vec2 st) {
+    switch (item) {
+        SAMPLE_ITEM(0);
+        SAMPLE_ITEM(1);
+        SAMPLE_ITEM(2);
+        SAMPLE_ITEM(3);
+        SAMPLE_ITEM(4);
+        SAMPLE_ITEM(5);
+        SAMPLE_ITEM(6);
+        SAMPLE_ITEM(7);
+        SAMPLE_ITEM(8);
+        SAMPLE_ITEM(9);
+        SAMPLE_ITEM(10);
+        SAMPLE_ITEM(11);
+        SAMPLE_ITEM(12);
+        SAMPLE_ITEM(13);
+        SAMPLE_ITEM(14);
+        SAMPLE_ITEM(15);
+    }
+    return vec4(0.0);
+}
 
 
 Fragment getFragment() {
     Fragment frag;
 
-    frag.color = texture(texture1, vs_st);
-    frag.color.a = Alpha * frag.color.a;
+    frag.color = sampleItem(vs_item, vs_st);
+    frag.color.a = Alphas[vs_item] * frag.color.a;
     if (frag.color.a == 0.0) {
         discard;
     }
@@ -24,18 +24,24 @@
 
 #version __CONTEXT__
 
+// Has to match ScreenSpaceBatcher::MaxBatchSize
+const int MaxBatchSize = 16;
+
 layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec2 in_st;
 
 out vec2 vs_st;
 out vec4 vs_position;
+flat out int vs_item;
 
-uniform mat4 ModelTransform;
+uniform mat4 ModelTransforms[MaxBatchSize];
 uniform mat4 ViewProjectionMatrix;
 
 
 void main() {
     vs_st = in_st;
-    vs_position = ViewProjectionMatrix * ModelTransform * vec4(in_position, 1.0);
+    vs_item = gl_InstanceID;
+    vs_position = ViewProjectionMatrix * ModelTransforms[gl_InstanceID] *
+                  vec4(in_position, 1.0);
     gl_Position = vec4(vs_position);
 }
@@ -0,0 +1,356 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/base/tasks/converttexturetask.h>
+
+#include <openspace/documentation/verifier.h>
+#include <openspace/rendering/compressedtexture.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/io/texture/texturereader.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    constexpr const char* KeyInput = "Input";
+    constexpr const char* KeyOutput = "Output";
+    constexpr const char* KeyFormat = "Format";
+
+    using Block = std::array<glm::u8vec4, 16>;
+
+    struct Image {
+        glm::uvec2 dimensions = glm::uvec2(0);
+        std::vector<glm::u8vec4> texels;
+    };
+
+    // Creates the next smaller mipmap level by averaging 2x2 texels, where the last row
+    // or column of an image with an odd size is used twice
+    Image downsample(const Image& image) {
+        Image res;
+        res.dimensions = glm::max(image.dimensions / 2u, glm::uvec2(1));
+        res.texels.resize(static_cast<size_t>(res.dimensions.x) * res.dimensions.y);
+
+        const glm::uvec2 max = image.dimensions - 1u;
+        for (unsigned int y = 0; y < res.dimensions.y; ++y) {
+            for (unsigned int x = 0; x < res.dimensions.x; ++x) {
+                const unsigned int x0 = std::min(2 * x, max.x);
+                const unsigned int x1 = std::min(2 * x + 1, max.x);
+                const unsigned int y0 = std::min(2 * y, max.y);
+                const unsigned int y1 = std::min(2 * y + 1, max.y);
+
+                const glm::uvec4 sum =
+                    glm::uvec4(image.texels[y0 * image.dimensions.x + x0]) +
+                    glm::uvec4(image.texels[y0 * image.dimensions.x + x1]) +
+                    glm::uvec4(image.texels[y1 * image.dimensions.x + x0]) +
+                    glm::uvec4(image.texels[y1 * image.dimensions.x + x1]);
+                res.texels[y * res.dimensions.x + x] = glm::u8vec4((sum + 2u) / 4u);
+            }
+        }
+        return res;
+    }
+
+    // Returns the 4x4 block with the lower left corner at (4 * bx, 4 * by), where texels
+    // outside of the image repeat the closest edge texel
+    Block block(const Image& image, unsigned int bx, unsigned int by) {
+        Block res;
+        for (unsigned int y = 0; y < 4; ++y) {
+            for (unsigned int x = 0; x < 4; ++x) {
+                const unsigned int ix = std::min(4 * bx + x, image.dimensions.x - 1);
+                const unsigned int iy = std::min(4 * by + y, image.dimensions.y - 1);
+                res[y * 4 + x] = image.texels[iy * image.dimensions.x + ix];
+            }
+        }
+        return res;
+    }
+
+    uint16_t toRgb565(const glm::ivec3& c) {
+        return static_cast<uint16_t>(
+            ((c.r * 31 + 127) / 255) << 11 |
+            ((c.g * 63 + 127) / 255) << 5 |
+            ((c.b * 31 + 127) / 255)
+        );
+    }
+
+    glm::ivec3 fromRgb565(uint16_t c) {
+        const int r = (c >> 11) & 31;
+        const int g = (c >> 5) & 63;
+        const int b = c & 31;
+        return glm::ivec3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+    }
+
+    // Encodes the colors of the block with the endpoints at the corners of their bounding
+    // box, which is inset slightly as the extreme colors are rarely the best endpoints.
+    // The block is always encoded in the four color mode, which BC3 requires
+    void encodeColorBlock(const Block& block, char* out) {
+        glm::ivec3 min = glm::ivec3(255);
+        glm::ivec3 max = glm::ivec3(0);
+        for (const glm::u8vec4& t : block) {
+            min = glm::min(min, glm::ivec3(t));
+            max = glm::max(max, glm::ivec3(t));
+        }
+        const glm::ivec3 inset = (max - min) / 16;
+        uint16_t c0 = toRgb565(glm::clamp(max - inset, 0, 255));
+        uint16_t c1 = toRgb565(glm::clamp(min + inset, 0, 255));
+        if (c0 < c1) {
+            std::swap(c0, c1);
+        }
+
+        uint32_t indices = 0;
+        if (c0 != c1) {
+            const glm::ivec3 p0 = fromRgb565(c0);
+            const glm::ivec3 p1 = fromRgb565(c1);
+            const std::array<glm::ivec3, 4> palette = {
+                p0, p1, (2 * p0 + p1) / 3, (p0 + 2 * p1) / 3
+            };
+
+            for (int i = 0; i < 16; ++i) {
+                const glm::ivec3 color = glm::ivec3(block[i]);
+                uint32_t best = 0;
+                int bestDistance = std::numeric_limits<int>::max();
+                for (uint32_t j = 0; j < 4; ++j) {
+                    const glm::ivec3 d = color - palette[j];
+                    const int distance = d.r * d.r + d.g * d.g + d.b * d.b;
+                    if (distance < bestDistance) {
+                        best = j;
+                        bestDistance = distance;
+                    }
+                }
+                indices |= best << (2 * i);
+            }
+        }
+
+        std::memcpy(out, &c0, sizeof(uint16_t));
+        std::memcpy(out + 2, &c1, sizeof(uint16_t));
+        std::memcpy(out + 4, &indices, sizeof(uint32_t));
+    }
+
+    // Encodes the alpha values of the block with the minimum and maximum alpha as
+    // endpoints, which uses the mode with six interpolated values
+    void encodeAlphaBlock(const Block& block, char* out) {
+        int min = 255;
+        int max = 0;
+        for (const glm::u8vec4& t : block) {
+            min = std::min(min, static_cast<int>(t.a));
+            max = std::max(max, static_cast<int>(t.a));
+        }
+
+        uint64_t indices = 0;
+        if (min != max) {
+            std::array<int, 8> palette = { max, min };
+            for (int i = 1; i < 7; ++i) {
+                palette[i + 1] = ((7 - i) * max + i * min) / 7;
+            }
+
+            for (int i = 0; i < 16; ++i) {
+                uint64_t best = 0;
+                int bestDistance = std::numeric_limits<int>::max();
+                for (uint64_t j = 0; j < 8; ++j) {
+                    const int distance = std::abs(block[i].a - palette[j]);
+                    if (distance < bestDistance) {
+                        best = j;
+                        bestDistance = distance;
+                    }
+                }
+                indices |= best << (3 * i);
+            }
+        }
+
+        out[0] = static_cast<char>(max);
+        out[1] = static_cast<char>(min);
+        for (int i = 0; i < 6; ++i) {
+            out[2 + i] = static_cast<char>((indices >> (8 * i)) & 0xFF);
+        }
+    }
+
+    // Appends the encoded \p image to the buffer of the \p data as a new level
+    void appendLevel(openspace::rendering::CompressedTextureData& data,
+                     const Image& image, GLenum internalFormat)
+    {
+        openspace::rendering::CompressedTextureData::Level level;
+        level.dimensions = image.dimensions;
+        level.offset = data.buffer.size();
+
+        if (internalFormat == GL_RGBA8) {
+            level.size = image.texels.size() * sizeof(glm::u8vec4);
+            data.buffer.resize(level.offset + level.size);
+            std::memcpy(
+                data.buffer.data() + level.offset,
+                image.texels.data(),
+                level.size
+            );
+        }
+        else {
+            const bool hasAlpha = internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            const size_t blockSize = hasAlpha ? 16 : 8;
+            const glm::uvec2 nBlocks = (image.dimensions + 3u) / 4u;
+            level.size = static_cast<size_t>(nBlocks.x) * nBlocks.y * blockSize;
+            data.buffer.resize(level.offset + level.size);
+
+            char* out = data.buffer.data() + level.offset;
+            for (unsigned int by = 0; by < nBlocks.y; ++by) {
+                for (unsigned int bx = 0; bx < nBlocks.x; ++bx) {
+                    const Block b = block(image, bx, by);
+                    if (hasAlpha) {
+                        encodeAlphaBlock(b, out);
+                        out += 8;
+                    }
+                    encodeColorBlock(b, out);
+                    out += 8;
+                }
+            }
+        }
+
+        data.levels.push_back(level);
+    }
+} // namespace
+
+namespace openspace {
+
+ConvertTextureTask::ConvertTextureTask(const ghoul::Dictionary& dictionary) {
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "ConvertTextureTask"
+    );
+
+    _inputPath = absPath(dictionary.value<std::string>(KeyInput));
+    _outputPath = absPath(dictionary.value<std::string>(KeyOutput));
+    if (dictionary.hasKey(KeyFormat)) {
+        _format = dictionary.value<std::string>(KeyFormat);
+    }
+}
+
+std::string ConvertTextureTask::description() {
+    return fmt::format(
+        "Convert the image {} into a {} KTX2 file with mipmaps at {}",
+        _inputPath, _format.empty() ? "BC1 or BC3" : _format, _outputPath
+    );
+}
+
+void ConvertTextureTask::perform(const Task::ProgressCallback& progressCallback) {
+    std::unique_ptr<ghoul::opengl::Texture> texture =
+        ghoul::io::TextureReader::ref().loadTexture(_inputPath);
+    if (!texture) {
+        throw ghoul::RuntimeError(fmt::format("Could not read '{}'", _inputPath));
+    }
+
+    Image image;
+    image.dimensions = glm::uvec2(texture->dimensions());
+    image.texels.reserve(static_cast<size_t>(image.dimensions.x) * image.dimensions.y);
+    bool hasAlpha = false;
+    for (unsigned int y = 0; y < image.dimensions.y; ++y) {
+        for (unsigned int x = 0; x < image.dimensions.x; ++x) {
+            const glm::vec4 texel = glm::clamp(
+                texture->texelAsFloat(glm::uvec2(x, y)),
+                0.f,
+                1.f
+            );
+            image.texels.push_back(glm::u8vec4(texel * 255.f + 0.5f));
+            hasAlpha |= image.texels.back().a < 255;
+        }
+    }
+    texture = nullptr;
+    progressCallback(0.2f);
+
+    std::string format = _format;
+    if (format.empty()) {
+        format = hasAlpha ? "BC3" : "BC1";
+    }
+
+    rendering::CompressedTextureData data;
+    data.dimensions = image.dimensions;
+    if (format == "RGBA") {
+        data.format = ghoul::opengl::Texture::Format::RGBA;
+        data.internalFormat = GL_RGBA8;
+        data.isBlockCompressed = false;
+    }
+    else if (format == "BC1") {
+        data.format = ghoul::opengl::Texture::Format::RGB;
+        data.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+    else {
+        data.format = ghoul::opengl::Texture::Format::RGBA;
+        data.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    }
+
+    const int nLevels = 1 + static_cast<int>(
+        std::log2(std::max(image.dimensions.x, image.dimensions.y))
+    );
+    for (int i = 0; i < nLevels; ++i) {
+        if (i > 0) {
+            image = downsample(image);
+        }
+        appendLevel(data, image, data.internalFormat);
+        progressCallback(0.2f + 0.7f * static_cast<float>(i + 1) / nLevels);
+    }
+
+    rendering::writeCompressedTexture(_outputPath, data);
+    progressCallback(1.f);
+}
+
+documentation::Documentation ConvertTextureTask::documentation() {
+    using namespace documentation;
+    return {
+        "ConvertTextureTask",
+        "convert_texture_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("ConvertTextureTask"),
+                Optional::No,
+                "The type of this task",
+            },
+            {
+                KeyInput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The image file that is converted",
+            },
+            {
+                KeyOutput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The KTX2 file that the converted image is written to. The file should "
+                "have the 'ktx2' extension to be loaded as a compressed texture",
+            },
+            {
+                KeyFormat,
+                new StringInListVerifier({ "BC1", "BC3", "RGBA" }),
+                Optional::Yes,
+                "The format of the mipmap levels. BC1 stores opaque images in 4 bits "
+                "per texel, BC3 stores images with transparency in 8 bits per texel, "
+                "and RGBA stores the texels uncompressed. If this value is not "
+                "specified, BC3 is used for images with transparent texels and BC1 for "
+                "all other images",
+            }
+        }
+    };
+}
+
+} // namespace openspace
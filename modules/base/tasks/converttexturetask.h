@@ -0,0 +1,58 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_BASE___CONVERTTEXTURETASK___H__
+#define __OPENSPACE_MODULE_BASE___CONVERTTEXTURETASK___H__
+
+#include <openspace/util/task.h>
+
+#include <string>
+
+namespace openspace {
+
+/**
+ * Converts an image that can be read by the ghoul::io::TextureReader into a KTX2 file
+ * that contains all of its mipmap levels, so that the image can be uploaded without any
+ * decoding or mipmap generation at runtime. The levels are either BC1 or BC3
+ * block-compressed, which reduces the memory of the texture to an eighth or a quarter,
+ * or stored as uncompressed 8-bit RGBA for images that do not tolerate the compression.
+ */
+class ConvertTextureTask : public Task {
+public:
+    ConvertTextureTask(const ghoul::Dictionary& dictionary);
+    std::string description() override;
+    void perform(const Task::ProgressCallback& progressCallback) override;
+    static documentation::Documentation documentation();
+
+private:
+    std::string _inputPath;
+    std::string _outputPath;
+    /// One of \c BC1, \c BC3, or \c RGBA, or empty if it is chosen based on whether the
+    /// image has transparent texels
+    std::string _format;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_BASE___CONVERTTEXTURETASK___H__
@@ -33,7 +33,7 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/lua_helper.h>
-
+#include <ghoul/misc/defer.h>
 #include <chrono>
 
 namespace {
@@ -42,7 +42,7 @@ namespace {
         "Script",
         "This value is the path to the Lua script that will be executed to compute the "
         "translation for this transformation. The script needs to define a function "
-        "'translate' that takes the current simulation time in seconds past the J2000 "
+        "'translation' that takes the current simulation time in seconds past the J2000 "
         "epoch as the first argument, the current wall time as milliseconds past the "
         "J2000 epoch as the second argument and computes the translation."
     };
@@ -79,42 +79,82 @@ LuaTranslation::LuaTranslation()
     addProperty(_luaScriptFile);
 
     _luaScriptFile.onChange([&]() {
+        _needsReload = true;
         requireUpdate();
         _fileHandle = std::make_unique<ghoul::filesystem::File>(_luaScriptFile);
         _fileHandle->setCallback([&](const ghoul::filesystem::File&) {
-             requireUpdate();
-             notifyObservers();
-         });
+            _needsReload = true;
+            requireUpdate();
+            notifyObservers();
+        });
     });
 }
 
 LuaTranslation::LuaTranslation(const ghoul::Dictionary& dictionary) : LuaTranslation() {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
-        "StaticTranslation"
+        "LuaTranslation"
     );
 
     _luaScriptFile = absPath(dictionary.value<std::string>(ScriptInfo.identifier));
 }
 
-glm::dvec3 LuaTranslation::position(const UpdateData& data) const {
-    ghoul::lua::runScriptFile(_state, _luaScriptFile);
+bool LuaTranslation::isThreadSafe() const {
+    // Every LuaTranslation owns its Lua state and all accesses to it are serialized
+    return true;
+}
+
+void LuaTranslation::loadScript() const {
+    if (_functionReference != LUA_NOREF) {
+        luaL_unref(_state, LUA_REGISTRYINDEX, _functionReference);
+        _functionReference = LUA_NOREF;
+    }
+    _needsReload = false;
+
+    try {
+        ghoul::lua::runScriptFile(_state, _luaScriptFile);
+    }
+    catch (const ghoul::lua::LuaLoadingException& e) {
+        LERRORC(e.component, e.message);
+        return;
+    }
+    catch (const ghoul::lua::LuaExecutionException& e) {
+        LERRORC(e.component, e.message);
+        return;
+    }
 
-    // Get the scaling function
     lua_getglobal(_state, "translation");
-    const bool isFunction = lua_isfunction(_state, -1);
-    if (!isFunction) {
+    if (!lua_isfunction(_state, -1)) {
+        lua_pop(_state, 1);
         LERRORC(
-            "LuaScale",
+            "LuaTranslation",
             fmt::format(
-                "Script '{}' does not have a function 'translation'",
-                _luaScriptFile
+                "Script '{}' does not have a function 'translation'", _luaScriptFile
             )
         );
+        return;
+    }
+    _functionReference = luaL_ref(_state, LUA_REGISTRYINDEX);
+}
+
+glm::dvec3 LuaTranslation::position(const UpdateData& data) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // The script is only executed once to define the function and again when the file
+    // changes, instead of being parsed for every evaluation
+    if (_needsReload) {
+        loadScript();
+    }
+    if (_functionReference == LUA_NOREF) {
         return glm::dvec3(0.0);
     }
 
+    const int top = lua_gettop(_state);
+    defer { lua_settop(_state, top); };
+
+    lua_rawgeti(_state, LUA_REGISTRYINDEX, _functionReference);
+
     // First argument is the number of seconds past the J2000 epoch in ingame time
     ghoul::lua::push(_state, data.time.j2000Seconds());
 
@@ -126,18 +166,19 @@ glm::dvec3 LuaTranslation::position(const UpdateData& data) const {
     const auto now = high_resolution_clock::now();
     ghoul::lua::push(_state, duration_cast<milliseconds>(now.time_since_epoch()).count());
 
-    // Execute the scaling function
-    const int success = lua_pcall(_state, 2, 3, 0);
+    // Execute the translation function
+    const int success = lua_pcall(_state, 3, 3, 0);
     if (success != 0) {
         LERRORC(
-            "LuaScale",
+            "LuaTranslation",
             fmt::format("Error executing 'translation': {}", lua_tostring(_state, -1))
         );
+        return glm::dvec3(0.0);
     }
 
     double values[3];
-    for (int i = 1; i <= 3; ++i) {
-        values[i] = ghoul::lua::value<double>(_state, i);
+    for (int i = 0; i < 3; ++i) {
+        values[i] = lua_tonumber(_state, top + 1 + i);
     }
 
     return glm::make_vec3(values);
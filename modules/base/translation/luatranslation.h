@@ -28,8 +28,11 @@
 #include <openspace/scene/translation.h>
 
 #include <openspace/properties/stringproperty.h>
+#include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/luastate.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 namespace ghoul::filesystem { class File; }
 
@@ -43,13 +46,21 @@ public:
     LuaTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
 
     static documentation::Documentation Documentation();
 
 private:
+    /// Runs the script file and keeps a reference to its \c translation function
+    void loadScript() const;
+
     properties::StringProperty _luaScriptFile;
     std::unique_ptr<ghoul::filesystem::File> _fileHandle;
     ghoul::lua::LuaState _state;
+
+    mutable std::mutex _mutex;
+    mutable int _functionReference = LUA_NOREF;
+    mutable std::atomic_bool _needsReload = true;
 };
 
 } // namespace openspace
@@ -80,7 +80,7 @@ StaticTranslation::StaticTranslation(const ghoul::Dictionary& dictionary)
     : StaticTranslation()
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "StaticTranslation"
     );
@@ -88,6 +88,14 @@ StaticTranslation::StaticTranslation(const ghoul::Dictionary& dictionary)
     _position = dictionary.value<glm::dvec3>(PositionInfo.identifier);
 }
 
+bool StaticTranslation::isThreadSafe() const {
+    return true;
+}
+
+bool StaticTranslation::dependsOnTime() const {
+    return false;
+}
+
 glm::dvec3 StaticTranslation::position(const UpdateData&) const {
     return _position;
 }
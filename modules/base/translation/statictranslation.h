@@ -41,6 +41,8 @@ public:
     StaticTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
+    bool dependsOnTime() const override;
     static documentation::Documentation Documentation();
 
 private:
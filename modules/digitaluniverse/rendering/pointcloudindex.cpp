@@ -0,0 +1,221 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/digitaluniverse/rendering/pointcloudindex.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+namespace {
+    // Nodes with fewer points are not split any further. Larger nodes mean fewer nodes
+    // to test each frame at the cost of rendering more points outside the frustum
+    constexpr const uint32_t MaxPointsPerNode = 512;
+
+    // Guards against infinite splitting for many points at the same location
+    constexpr const int MaxDepth = 20;
+} // namespace
+
+namespace openspace {
+
+std::vector<size_t> PointCloudIndex::build(const std::vector<glm::vec3>& positions) {
+    _nodes.clear();
+
+    std::vector<size_t> order(positions.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (positions.empty()) {
+        return order;
+    }
+
+    Node root;
+    root.count = static_cast<uint32_t>(positions.size());
+    _nodes.push_back(root);
+    buildNode(0, positions, order, 0);
+
+    return order;
+}
+
+void PointCloudIndex::clear() {
+    _nodes.clear();
+}
+
+bool PointCloudIndex::isEmpty() const {
+    return _nodes.empty();
+}
+
+void PointCloudIndex::buildNode(int32_t nodeIndex,
+                                const std::vector<glm::vec3>& positions,
+                                std::vector<size_t>& order, int depth)
+{
+    // _nodes might be reallocated further down, so we can't keep a reference around
+    const uint32_t first = _nodes[nodeIndex].first;
+    const uint32_t count = _nodes[nodeIndex].count;
+
+    glm::vec3 boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+    for (uint32_t i = first; i < first + count; ++i) {
+        boundsMin = glm::min(boundsMin, positions[order[i]]);
+        boundsMax = glm::max(boundsMax, positions[order[i]]);
+    }
+    _nodes[nodeIndex].boundsMin = boundsMin;
+    _nodes[nodeIndex].boundsMax = boundsMax;
+
+    if (count <= MaxPointsPerNode || depth >= MaxDepth) {
+        return;
+    }
+
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    auto octant = [&](size_t i) {
+        const glm::vec3& p = positions[i];
+        return (p.x >= center.x ? 1 : 0) | (p.y >= center.y ? 2 : 0) |
+               (p.z >= center.z ? 4 : 0);
+    };
+
+    std::array<uint32_t, 8> octantCounts = {};
+    for (uint32_t i = first; i < first + count; ++i) {
+        ++octantCounts[octant(order[i])];
+    }
+    if (std::find(octantCounts.begin(), octantCounts.end(), count) != octantCounts.end())
+    {
+        // All points fall into the same octant, so splitting doesn't help
+        return;
+    }
+
+    // Sort the points of this node by octant so that each child is contiguous
+    std::array<uint32_t, 8> offsets;
+    offsets[0] = 0;
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] = offsets[i - 1] + octantCounts[i - 1];
+    }
+    std::vector<size_t> sorted(count);
+    for (uint32_t i = first; i < first + count; ++i) {
+        sorted[offsets[octant(order[i])]++] = order[i];
+    }
+    std::copy(sorted.begin(), sorted.end(), order.begin() + first);
+
+    const int32_t firstChild = static_cast<int32_t>(_nodes.size());
+    uint8_t nChildren = 0;
+    uint32_t childFirst = first;
+    for (uint32_t c : octantCounts) {
+        if (c == 0) {
+            continue;
+        }
+        Node child;
+        child.first = childFirst;
+        child.count = c;
+        _nodes.push_back(child);
+        childFirst += c;
+        ++nChildren;
+    }
+    _nodes[nodeIndex].firstChild = firstChild;
+    _nodes[nodeIndex].nChildren = nChildren;
+
+    for (uint8_t i = 0; i < nChildren; ++i) {
+        buildNode(firstChild + i, positions, order, depth + 1);
+    }
+}
+
+void PointCloudIndex::findVisibleRanges(const glm::dmat4& modelViewProjection,
+                                        const glm::dvec3& cameraPosition,
+                                        double pointSize, double pixelScale,
+                                        float minPixelSize, std::vector<GLint>& firsts,
+                                        std::vector<GLsizei>& counts) const
+{
+    firsts.clear();
+    counts.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+
+    auto appendRange = [&](uint32_t first, uint32_t count) {
+        if (!firsts.empty() &&
+            static_cast<uint32_t>(firsts.back() + counts.back()) == first)
+        {
+            counts.back() += static_cast<GLsizei>(count);
+        }
+        else {
+            firsts.push_back(static_cast<GLint>(first));
+            counts.push_back(static_cast<GLsizei>(count));
+        }
+    };
+
+    const double padding = pointSize * 0.5;
+    const bool useLod = minPixelSize > 0.f;
+
+    std::vector<int32_t> stack = { 0 };
+    while (!stack.empty()) {
+        const Node& node = _nodes[stack.back()];
+        stack.pop_back();
+
+        const glm::dvec3 boundsMin = glm::dvec3(node.boundsMin) - padding;
+        const glm::dvec3 boundsMax = glm::dvec3(node.boundsMax) + padding;
+
+        // Count the corners that are outside of each of the left, right, bottom, and top
+        // clipping planes. We don't test against the near and far planes as the depth
+        // is remapped in the shaders
+        std::array<int, 4> nOutside = {};
+        for (int c = 0; c < 8; ++c) {
+            const glm::dvec4 corner = modelViewProjection * glm::dvec4(
+                (c & 1) ? boundsMax.x : boundsMin.x,
+                (c & 2) ? boundsMax.y : boundsMin.y,
+                (c & 4) ? boundsMax.z : boundsMin.z,
+                1.0
+            );
+            nOutside[0] += corner.x < -corner.w ? 1 : 0;
+            nOutside[1] += corner.x > corner.w ? 1 : 0;
+            nOutside[2] += corner.y < -corner.w ? 1 : 0;
+            nOutside[3] += corner.y > corner.w ? 1 : 0;
+        }
+        if (std::find(nOutside.begin(), nOutside.end(), 8) != nOutside.end()) {
+            continue;
+        }
+
+        if (useLod) {
+            const glm::dvec3 closest = glm::clamp(cameraPosition, boundsMin, boundsMax);
+            const double distance = glm::distance(cameraPosition, closest);
+            if (distance > 0.0 && pointSize / distance * pixelScale < minPixelSize) {
+                continue;
+            }
+        }
+
+        const bool isFullyInside = std::all_of(
+            nOutside.begin(),
+            nOutside.end(),
+            [](int n) { return n == 0; }
+        );
+        if (node.firstChild == -1 || (isFullyInside && !useLod)) {
+            appendRange(node.first, node.count);
+            continue;
+        }
+
+        // Push in reverse so that the children are visited in storage order, which
+        // lets appendRange merge neighboring children into a single range
+        for (int i = node.nChildren - 1; i >= 0; --i) {
+            stack.push_back(node.firstChild + i);
+        }
+    }
+}
+
+} // namespace openspace
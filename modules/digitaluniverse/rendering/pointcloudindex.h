@@ -0,0 +1,103 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_DIGITALUNIVERSE___POINTCLOUDINDEX___H__
+#define __OPENSPACE_MODULE_DIGITALUNIVERSE___POINTCLOUDINDEX___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <cstdint>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A bounding volume hierarchy over the points of a point cloud that is used to skip the
+ * points that are outside the view frustum or too small to be seen. The index does not
+ * store the points itself. Instead, building the index returns the order in which the
+ * points have to be stored so that the points of each node are contiguous, which means
+ * that the visible parts of the cloud can be rendered as a list of ranges.
+ */
+class PointCloudIndex {
+public:
+    /**
+     * Builds the index for the provided \p positions.
+     *
+     * \param positions The positions of all points in the coordinate system of the index
+     * \return The indices into \p positions in the order in which the points have to be
+     *         stored for the ranges returned by #findVisibleRanges to be valid
+     */
+    std::vector<size_t> build(const std::vector<glm::vec3>& positions);
+
+    /// Removes all nodes from the index
+    void clear();
+
+    /// Returns \c true if the index has not been built or contains no points
+    bool isEmpty() const;
+
+    /**
+     * Collects the ranges of all points that might be visible. A node is skipped when
+     * its bounding box, extended by half of the \p pointSize, is completely outside the
+     * view frustum, or when a point of size \p pointSize at the closest distance of the
+     * node would appear smaller than \p minPixelSize on the screen. Adjacent ranges are
+     * merged so that \p firsts and \p counts can be passed directly to
+     * <code>glMultiDrawArrays</code>.
+     *
+     * \param modelViewProjection The matrix that transforms from the coordinate system
+     *        of the index into clip space
+     * \param cameraPosition The camera position in the coordinate system of the index
+     * \param pointSize The largest extent of a single point in the coordinate system of
+     *        the index
+     * \param pixelScale The factor that converts the ratio between size and distance
+     *        into pixels, for example the vertical focal length times half the viewport
+     * \param minPixelSize The smallest size in pixels that should still be rendered, a
+     *        value of 0 disables the level-of-detail test
+     * \param firsts Receives the first point of each visible range
+     * \param counts Receives the number of points of each visible range
+     */
+    void findVisibleRanges(const glm::dmat4& modelViewProjection,
+        const glm::dvec3& cameraPosition, double pointSize, double pixelScale,
+        float minPixelSize, std::vector<GLint>& firsts,
+        std::vector<GLsizei>& counts) const;
+
+private:
+    struct Node {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        uint32_t first = 0;
+        uint32_t count = 0;
+        // The children of a node are stored consecutively, -1 for leaf nodes
+        int32_t firstChild = -1;
+        uint8_t nChildren = 0;
+    };
+
+    void buildNode(int32_t nodeIndex, const std::vector<glm::vec3>& positions,
+        std::vector<size_t>& order, int depth);
+
+    std::vector<Node> _nodes;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_DIGITALUNIVERSE___POINTCLOUDINDEX___H__
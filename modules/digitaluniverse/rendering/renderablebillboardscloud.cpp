@@ -29,13 +29,15 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
+#include <openspace/util/speckcache.h>
+#include <openspace/util/speckreader.h>
 #include <openspace/util/updatestructures.h>
+#include <openspace/rendering/compressedtexture.h>
 #include <openspace/rendering/renderengine.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/crc32.h>
 #include <ghoul/misc/templatefactory.h>
-#include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
@@ -45,7 +47,9 @@
 #include <ghoul/font/fontrenderer.h>
 #include <ghoul/glm.h>
 #include <glm/gtx/string_cast.hpp>
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <fstream>
 #include <cstdint>
 #include <locale>
@@ -75,7 +79,6 @@ namespace {
     constexpr const char* GigaparsecUnit = "Gpc";
     constexpr const char* GigalightyearUnit = "Gly";
 
-    constexpr int8_t CurrentCacheVersion = 1;
     constexpr double PARSEC = 0.308567756E17;
 
     constexpr const int RenderOptionViewDirection = 0;
@@ -229,6 +232,22 @@ namespace {
         "Enable pixel size control.",
         "Enable pixel size control for rectangular projections."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo FrustumCullingInfo = {
+        "EnableFrustumCulling",
+        "Enable Frustum Culling",
+        "If this value is enabled, the astronomical objects and labels that are outside "
+        "of the view frustum are not rendered. The spatial index used for this is built "
+        "when the data is loaded."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo LodMinPixelSizeInfo = {
+        "LodMinPixelSize",
+        "LOD Minimum Pixel Size",
+        "Groups of astronomical objects or labels that would be smaller than this value "
+        "(in pixels) on the screen are not rendered. This only has an effect if the "
+        "frustum culling is enabled. A value of 0 disables this level of detail cutoff."
+    };
 }  // namespace
 
 namespace openspace {
@@ -376,6 +395,18 @@ documentation::Documentation RenderableBillboardsCloud::Documentation() {
                 new BoolVerifier,
                 Optional::Yes,
                 PixelSizeControlInfo.description
+            },
+            {
+                FrustumCullingInfo.identifier,
+                new BoolVerifier,
+                Optional::Yes,
+                FrustumCullingInfo.description
+            },
+            {
+                LodMinPixelSizeInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                LodMinPixelSizeInfo.description
             }
         }
     };
@@ -415,6 +446,8 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
     , _billboardMinSize(BillboardMinSizeInfo, 0.f, 0.f, 100.f)
     , _correctionSizeEndDistance(CorrectionSizeEndDistanceInfo, 17.f, 12.f, 25.f)
     , _correctionSizeFactor(CorrectionSizeFactorInfo, 8.f, 0.f, 20.f)
+    , _enableFrustumCulling(FrustumCullingInfo, true)
+    , _lodMinPixelSize(LodMinPixelSizeInfo, 0.f, 0.f, 50.f)
     , _renderOption(RenderOptionInfo, properties::OptionProperty::DisplayType::Dropdown)
 {
     documentation::testSpecificationAndThrow(
@@ -624,6 +657,18 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
         _pixelSizeControl = dictionary.value<bool>(PixelSizeControlInfo.identifier);
     }
     addProperty(_pixelSizeControl);
+
+    if (dictionary.hasKey(FrustumCullingInfo.identifier)) {
+        _enableFrustumCulling = dictionary.value<bool>(FrustumCullingInfo.identifier);
+    }
+    addProperty(_enableFrustumCulling);
+
+    if (dictionary.hasKey(LodMinPixelSizeInfo.identifier)) {
+        _lodMinPixelSize = static_cast<float>(
+            dictionary.value<double>(LodMinPixelSizeInfo.identifier)
+        );
+    }
+    addProperty(_lodMinPixelSize);
 }
 
 bool RenderableBillboardsCloud::isReady() const {
@@ -719,7 +764,7 @@ void RenderableBillboardsCloud::renderBillboards(const RenderData& data,
                                                  const glm::dmat4& modelMatrix,
                                                  const glm::dvec3& orthoRight,
                                                  const glm::dvec3& orthoUp,
-                                                 float fadeInVariable)
+                                                 float fadeInVariable, float unitScale)
 {
     glDepthMask(false);
     glEnable(GL_DEPTH_TEST);
@@ -800,10 +845,30 @@ void RenderableBillboardsCloud::renderBillboards(const RenderData& data,
     _program->setUniform(_uniformCache.hasColormap, _hasColorMapFile);
 
     glBindVertexArray(_vao);
-    const GLsizei nAstronomicalObjects = static_cast<GLsizei>(
-        _fullData.size() / _nValuesPerAstronomicalObject
-    );
-    glDrawArrays(GL_POINTS, 0, nAstronomicalObjects);
+    if (_enableFrustumCulling && !_pointIndex.isEmpty()) {
+        // The billboards are exp(scaleFactor * 0.1) meters wide, see billboard_gs.glsl
+        findVisibleRanges(
+            _pointIndex,
+            data,
+            modelMatrix,
+            unitScale,
+            std::exp(_scaleFactor.value() * 0.1)
+        );
+        if (!_visibleFirsts.empty()) {
+            glMultiDrawArrays(
+                GL_POINTS,
+                _visibleFirsts.data(),
+                _visibleCounts.data(),
+                static_cast<GLsizei>(_visibleFirsts.size())
+            );
+        }
+    }
+    else {
+        const GLsizei nAstronomicalObjects = static_cast<GLsizei>(
+            _fullData.size() / _nValuesPerAstronomicalObject
+        );
+        glDrawArrays(GL_POINTS, 0, nAstronomicalObjects);
+    }
 
     glBindVertexArray(0);
     _program->deactivate();
@@ -868,7 +933,7 @@ void RenderableBillboardsCloud::renderLabels(const RenderData& data,
     labelInfo.enableDepth = true;
     labelInfo.enableFalseDepth = false;
 
-    for (const std::pair<glm::vec3, std::string>& pair : _labelData) {
+    auto renderLabel = [&](const std::pair<glm::vec3, std::string>& pair) {
         //glm::vec3 scaledPos(_transformationMatrix * glm::dvec4(pair.first, 1.0));
         glm::vec3 scaledPos(pair.first);
         scaledPos *= scale;
@@ -879,9 +944,67 @@ void RenderableBillboardsCloud::renderLabels(const RenderData& data,
             textColor,
             labelInfo
         );
+    };
+
+    if (_enableFrustumCulling && !_labelIndex.isEmpty()) {
+        // The labels start at their position, so the padding has to cover the longest
+        // label in each direction
+        const glm::dmat4 modelMatrix =
+            glm::translate(glm::dmat4(1.0), data.modelTransform.translation) *
+            glm::dmat4(data.modelTransform.rotation) *
+            glm::scale(glm::dmat4(1.0), glm::dvec3(data.modelTransform.scale));
+        findVisibleRanges(
+            _labelIndex,
+            data,
+            modelMatrix,
+            scale,
+            2.0 * labelInfo.scale * static_cast<double>(_longestLabelLength)
+        );
+        for (size_t i = 0; i < _visibleFirsts.size(); ++i) {
+            const size_t first = static_cast<size_t>(_visibleFirsts[i]);
+            const size_t last = first + static_cast<size_t>(_visibleCounts[i]);
+            for (size_t j = first; j < last; ++j) {
+                renderLabel(_labelData[j]);
+            }
+        }
+    }
+    else {
+        for (const std::pair<glm::vec3, std::string>& pair : _labelData) {
+            renderLabel(pair);
+        }
     }
 }
 
+void RenderableBillboardsCloud::findVisibleRanges(const PointCloudIndex& index,
+                                                  const RenderData& data,
+                                                  const glm::dmat4& modelMatrix,
+                                                  double unitScale, double pointSize)
+{
+    // The index is built from the positions in the unit of the dataset
+    const glm::dmat4 indexToWorld =
+        modelMatrix * glm::scale(glm::dmat4(1.0), glm::dvec3(unitScale));
+    const glm::dmat4 modelViewProjection = glm::dmat4(data.camera.projectionMatrix()) *
+        data.camera.combinedViewMatrix() * indexToWorld;
+    const glm::dvec3 cameraPosition = glm::dvec3(
+        glm::inverse(indexToWorld) * glm::dvec4(data.camera.positionVec3(), 1.0)
+    );
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const double pixelScale =
+        static_cast<double>(data.camera.projectionMatrix()[1][1]) * viewport[3] * 0.5;
+
+    index.findVisibleRanges(
+        modelViewProjection,
+        cameraPosition,
+        pointSize / (unitScale * data.modelTransform.scale),
+        pixelScale,
+        _lodMinPixelSize,
+        _visibleFirsts,
+        _visibleCounts
+    );
+}
+
 void RenderableBillboardsCloud::render(const RenderData& data, RendererTasks&) {
     float scale = 0.f;
     switch (_unit) {
@@ -953,7 +1076,8 @@ void RenderableBillboardsCloud::render(const RenderData& data, RendererTasks&) {
             modelMatrix,
             orthoRight,
             orthoUp,
-            fadeInVariable
+            fadeInVariable,
+            scale
         );
     }
 
@@ -1049,11 +1173,10 @@ void RenderableBillboardsCloud::update(const UpdateData&) {
             std::to_string(hash),
             [path = _spriteTexturePath]() -> std::unique_ptr<ghoul::opengl::Texture> {
                 LINFO(fmt::format("Loaded texture from '{}'", absPath(path)));
-                std::unique_ptr<ghoul::opengl::Texture> t =
-                    ghoul::io::TextureReader::ref().loadTexture(absPath(path));
-                t->uploadTexture();
-                t->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
-                return t;
+                return rendering::loadTexture(
+                    absPath(path),
+                    ghoul::opengl::Texture::FilterMode::AnisotropicMipMap
+                );
             }
         );
 
@@ -1158,6 +1281,22 @@ bool RenderableBillboardsCloud::loadLabelData() {
         }
     }
 
+    // Sort the labels in the order of the spatial index so that they can be culled
+    std::vector<glm::vec3> positions;
+    positions.reserve(_labelData.size());
+    _longestLabelLength = 0;
+    for (const std::pair<glm::vec3, std::string>& pair : _labelData) {
+        positions.push_back(pair.first);
+        _longestLabelLength = std::max(_longestLabelLength, pair.second.size());
+    }
+    const std::vector<size_t> order = _labelIndex.build(positions);
+    std::vector<std::pair<glm::vec3, std::string>> sortedLabels;
+    sortedLabels.reserve(_labelData.size());
+    for (size_t i : order) {
+        sortedLabels.push_back(std::move(_labelData[i]));
+    }
+    _labelData = std::move(sortedLabels);
+
     return success;
 }
 
@@ -1223,29 +1362,11 @@ bool RenderableBillboardsCloud::readSpeckFile() {
 
     _nValuesPerAstronomicalObject += 3; // X Y Z are not counted in the Speck file indices
 
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
-        }
-
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-    } while (!file.eof());
+    _fullData = speckreader::readDataRows(
+        file,
+        _nValuesPerAstronomicalObject,
+        false
+    ).values;
 
     return true;
 }
@@ -1392,95 +1513,36 @@ bool RenderableBillboardsCloud::readLabelFile() {
 }
 
 bool RenderableBillboardsCloud::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
-        return false;
-    }
-    int8_t version = 0;
-    fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-    if (version != CurrentCacheVersion) {
-        LINFO("The format of the cached file has changed: deleting old cache");
-        fileStream.close();
-        FileSys.deleteFile(file);
+    std::optional<speckcache::Dataset> dataset = speckcache::loadCachedFile(file);
+    if (!dataset) {
         return false;
     }
 
-    int32_t nValues = 0;
-    fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-    fileStream.read(
-        reinterpret_cast<char*>(&_nValuesPerAstronomicalObject),
-        sizeof(int32_t)
-    );
-
-    _fullData.resize(nValues);
-    fileStream.read(
-        reinterpret_cast<char*>(&_fullData[0]),
-        nValues * sizeof(_fullData[0])
-    );
+    _nValuesPerAstronomicalObject = dataset->nValuesPerObject;
+    _fullData = std::move(dataset->data);
 
     if (_hasColorMapFile) {
-        int32_t nItems = 0;
-        fileStream.read(reinterpret_cast<char*>(&nItems), sizeof(int32_t));
-
-        for (int i = 0; i < nItems; ++i) {
-            int32_t keySize = 0;
-            fileStream.read(reinterpret_cast<char*>(&keySize), sizeof(int32_t));
-            std::vector<char> buffer(keySize);
-            fileStream.read(buffer.data(), keySize);
-
-            std::string key(buffer.begin(), buffer.end());
-            int32_t value = 0;
-            fileStream.read(reinterpret_cast<char*>(&value), sizeof(int32_t));
-
-            _variableDataPositionMap.insert({ key, value });
-        }
+        _variableDataPositionMap.insert(
+            dataset->metadata.begin(),
+            dataset->metadata.end()
+        );
     }
-
-    bool success = fileStream.good();
-    return success;
+    return true;
 }
 
 bool RenderableBillboardsCloud::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
-        return false;
-    }
-    fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
-
-    int32_t nValues = static_cast<int32_t>(_fullData.size());
-    if (nValues == 0) {
-        LERROR("Error writing cache: No values were loaded");
-        return false;
-    }
-    fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
-
-    int32_t nValuesPerAstronomicalObject = static_cast<int32_t>(
-        _nValuesPerAstronomicalObject
+    // The position of each datavar is stored as metadata
+    const std::map<std::string, int> metadata(
+        _variableDataPositionMap.begin(),
+        _variableDataPositionMap.end()
     );
-    fileStream.write(
-        reinterpret_cast<const char*>(&nValuesPerAstronomicalObject),
-        sizeof(int32_t)
+    return speckcache::saveCachedFile(
+        file,
+        _fullData,
+        _nValuesPerAstronomicalObject,
+        {},
+        metadata
     );
-
-    size_t nBytes = nValues * sizeof(_fullData[0]);
-    fileStream.write(reinterpret_cast<const char*>(&_fullData[0]), nBytes);
-
-    if (_hasColorMapFile) {
-        int32_t nItems = static_cast<int32_t>(_variableDataPositionMap.size());
-        fileStream.write(reinterpret_cast<const char*>(&nItems), sizeof(int32_t));
-
-        for (const std::pair<const std::string, int>& pair : _variableDataPositionMap) {
-            int32_t keySize = static_cast<int32_t>(pair.first.size());
-            fileStream.write(reinterpret_cast<const char*>(&keySize), sizeof(int32_t));
-            fileStream.write(pair.first.data(), keySize);
-            int32_t value = static_cast<int32_t>(pair.second);
-            fileStream.write(reinterpret_cast<const char*>(&value), sizeof(int32_t));
-        }
-    }
-
-    return fileStream.good();
 }
 
 void RenderableBillboardsCloud::createDataSlice() {
@@ -1507,7 +1569,8 @@ void RenderableBillboardsCloud::createDataSlice() {
         }
     }
 
-    float biggestCoord = -1.0f;
+    std::vector<glm::vec3> positions;
+    positions.reserve(_fullData.size() / _nValuesPerAstronomicalObject);
     for (size_t i = 0; i < _fullData.size(); i += _nValuesPerAstronomicalObject) {
         glm::dvec4 transformedPos = _transformationMatrix * glm::dvec4(
             _fullData[i + 0],
@@ -1515,7 +1578,17 @@ void RenderableBillboardsCloud::createDataSlice() {
             _fullData[i + 2],
             1.0
         );
-        glm::vec4 position(glm::vec3(transformedPos), static_cast<float>(_unit));
+        positions.emplace_back(transformedPos);
+    }
+
+    // The sliced data is stored in the order of the spatial index so that the visible
+    // objects can be rendered as ranges
+    const std::vector<size_t> order = _pointIndex.build(positions);
+
+    float biggestCoord = -1.0f;
+    for (size_t object : order) {
+        const size_t i = object * _nValuesPerAstronomicalObject;
+        glm::vec4 position(positions[object], static_cast<float>(_unit));
 
         if (_hasColorMapFile) {
             for (int j = 0; j < 4; ++j) {
@@ -27,6 +27,7 @@
 
 #include <openspace/rendering/renderable.h>
 
+#include <modules/digitaluniverse/rendering/pointcloudindex.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
@@ -84,9 +85,12 @@ private:
     void loadPolygonGeometryForRendering();
     void renderPolygonGeometry(GLuint vao);
     void renderBillboards(const RenderData& data, const glm::dmat4& modelMatrix,
-        const glm::dvec3& orthoRight, const glm::dvec3& orthoUp, float fadeInVariable);
+        const glm::dvec3& orthoRight, const glm::dvec3& orthoUp, float fadeInVariable,
+        float unitScale);
     void renderLabels(const RenderData& data, const glm::dmat4& modelViewProjectionMatrix,
         const glm::dvec3& orthoRight, const glm::dvec3& orthoUp, float fadeInVariable);
+    void findVisibleRanges(const PointCloudIndex& index, const RenderData& data,
+        const glm::dmat4& modelMatrix, double unitScale, double pointSize);
 
     bool loadData();
     bool loadSpeckData();
@@ -127,6 +131,8 @@ private:
     properties::FloatProperty _billboardMinSize;
     properties::FloatProperty _correctionSizeEndDistance;
     properties::FloatProperty _correctionSizeFactor;
+    properties::BoolProperty _enableFrustumCulling;
+    properties::FloatProperty _lodMinPixelSize;
 
     // DEBUG:
     properties::OptionProperty _renderOption;
@@ -158,6 +164,13 @@ private:
     std::unordered_map<int, std::string> _optionConversionMap;
     std::vector<glm::vec2> _colorRangeData;
 
+    // The points in _slicedData and the labels in _labelData are sorted by these
+    PointCloudIndex _pointIndex;
+    PointCloudIndex _labelIndex;
+    size_t _longestLabelLength = 0;
+    std::vector<GLint> _visibleFirsts;
+    std::vector<GLsizei> _visibleCounts;
+
     int _nValuesPerAstronomicalObject = 0;
 
     glm::dmat4 _transformationMatrix = glm::dmat4(1.0);
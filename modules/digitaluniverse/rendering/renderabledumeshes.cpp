@@ -27,6 +27,7 @@
 #include <modules/digitaluniverse/digitaluniversemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/speckcache.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
@@ -42,15 +43,21 @@
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 #include <array>
-#include <fstream>
+#include <cstddef>
 #include <cstdint>
+#include <fstream>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableDUMeshes";
     constexpr const char* ProgramObjectName = "RenderableDUMeshes";
 
-    constexpr const std::array<const char*, 4> UniformNames = {
-        "modelViewTransform", "projectionTransform", "alphaValue", "color"
+    constexpr const std::array<const char*, 3> UniformNames = {
+        "modelViewTransform", "projectionTransform", "alphaValue"
+    };
+
+    struct MeshVertex {
+        glm::vec3 position;
+        glm::vec3 color;
     };
 
     constexpr const char* KeyFile = "File";
@@ -67,7 +74,6 @@ namespace {
     constexpr const int RenderOptionViewDirection = 0;
     constexpr const int RenderOptionPositionNormal = 1;
 
-    constexpr const int8_t CurrentCacheVersion = 1;
     constexpr const double PARSEC = 0.308567756E17;
 
     constexpr openspace::properties::Property::PropertyInfo TransparencyInfo = {
@@ -427,12 +433,10 @@ void RenderableDUMeshes::initializeGL() {
 }
 
 void RenderableDUMeshes::deinitializeGL() {
-    for (const std::pair<int, RenderingMesh>& pair : _renderingMeshesMap) {
-        for (int i = 0; i < pair.second.numU; ++i) {
-            glDeleteVertexArrays(1, &pair.second.vaoArray[i]);
-            glDeleteBuffers(1, &pair.second.vboArray[i]);
-        }
-    }
+    glDeleteVertexArrays(1, &_vao);
+    _vao = 0;
+    glDeleteBuffers(1, &_vbo);
+    _vbo = 0;
 
     DigitalUniverseModule::ProgramObjectManager.release(
         ProgramObjectName,
@@ -483,25 +487,26 @@ void RenderableDUMeshes::renderMeshes(const RenderData&,
     _program->setUniform(_uniformCache.alphaValue, _alphaValue);
     //_program->setUniform(_uniformCache.scaleFactor, _scaleFactor);
 
-    for (const std::pair<int, RenderingMesh>& pair : _renderingMeshesMap) {
-        _program->setUniform(_uniformCache.color, _meshColorMap[pair.second.colorIndex]);
-        for (size_t i = 0; i < pair.second.vaoArray.size(); ++i) {
-            glBindVertexArray(pair.second.vaoArray[i]);
-            switch (pair.second.style) {
-                case Solid:
-                    break;
-                case Wire:
-                    glLineWidth(2.0);
-                    glDrawArrays(GL_LINE_STRIP, 0, pair.second.numV);
-                    glLineWidth(lineWidth);
-                    break;
-                case Point:
-                    glDrawArrays(GL_POINTS, 0, pair.second.numV);
-                    break;
-                default:
-                    break;
-            }
-        }
+    // The colors are part of the vertices, so all meshes of the same style are drawn
+    // with a single call, independent of the number of meshes
+    glBindVertexArray(_vao);
+    if (!_lineStripFirsts.empty()) {
+        glLineWidth(2.0);
+        glMultiDrawArrays(
+            GL_LINE_STRIP,
+            _lineStripFirsts.data(),
+            _lineStripCounts.data(),
+            static_cast<GLsizei>(_lineStripFirsts.size())
+        );
+        glLineWidth(lineWidth);
+    }
+    if (!_pointFirsts.empty()) {
+        glMultiDrawArrays(
+            GL_POINTS,
+            _pointFirsts.data(),
+            _pointCounts.data(),
+            static_cast<GLsizei>(_pointFirsts.size())
+        );
     }
 
     glBindVertexArray(0);
@@ -904,70 +909,18 @@ bool RenderableDUMeshes::readLabelFile() {
 }
 
 bool RenderableDUMeshes::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
-        return false;
-    }
-
-    int8_t version = 0;
-    fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-    if (version != CurrentCacheVersion) {
-        LINFO("The format of the cached file has changed: deleting old cache");
-        fileStream.close();
-        FileSys.deleteFile(file);
+    std::optional<speckcache::Dataset> dataset = speckcache::loadCachedFile(file);
+    if (!dataset) {
         return false;
     }
 
-    int32_t nValues = 0;
-    fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-    fileStream.read(
-        reinterpret_cast<char*>(&_nValuesPerAstronomicalObject),
-        sizeof(int32_t)
-    );
-
-    _fullData.resize(nValues);
-    fileStream.read(
-        reinterpret_cast<char*>(&_fullData[0]),
-        nValues * sizeof(_fullData[0])
-    );
-
-    bool success = fileStream.good();
-    return success;
+    _nValuesPerAstronomicalObject = dataset->nValuesPerObject;
+    _fullData = std::move(dataset->data);
+    return true;
 }
 
 bool RenderableDUMeshes::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
-        return false;
-    }
-
-    fileStream.write(
-        reinterpret_cast<const char*>(&CurrentCacheVersion),
-        sizeof(int8_t)
-    );
-
-    const int32_t nValues = static_cast<int32_t>(_fullData.size());
-    if (nValues == 0) {
-        LERROR("Error writing cache: No values were loaded");
-        return false;
-    }
-    fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
-
-    const int32_t nValuesPerAstronomicalObject = static_cast<int32_t>(
-        _nValuesPerAstronomicalObject
-    );
-    fileStream.write(
-        reinterpret_cast<const char*>(&nValuesPerAstronomicalObject),
-        sizeof(int32_t)
-    );
-
-    const size_t nBytes = nValues * sizeof(_fullData[0]);
-    fileStream.write(reinterpret_cast<const char*>(&_fullData[0]), nBytes);
-
-    const bool success = fileStream.good();
-    return success;
+    return speckcache::saveCachedFile(file, _fullData, _nValuesPerAstronomicalObject);
 }
 
 void RenderableDUMeshes::createMeshes() {
@@ -976,147 +929,129 @@ void RenderableDUMeshes::createMeshes() {
     }
     LDEBUG("Creating planes");
 
-    for (std::pair<const int, RenderingMesh>& p : _renderingMeshesMap) {
-        float scale = 0.f;
-        switch (_unit) {
-            case Meter:
-                scale = 1.f;
-                break;
-            case Kilometer:
-                scale = 1e3f;
-                break;
-            case Parsec:
-                scale = static_cast<float>(PARSEC);
-                break;
-            case Kiloparsec:
-                scale = static_cast<float>(1e3 * PARSEC);
-                break;
-            case Megaparsec:
-                scale = static_cast<float>(1e6 * PARSEC);
-                break;
-            case Gigaparsec:
-                scale = static_cast<float>(1e9 * PARSEC);
-                break;
-            case GigalightYears:
-                scale = static_cast<float>(306391534.73091 * PARSEC);
-                break;
+    float scale = 0.f;
+    switch (_unit) {
+        case Meter:
+            scale = 1.f;
+            break;
+        case Kilometer:
+            scale = 1e3f;
+            break;
+        case Parsec:
+            scale = static_cast<float>(PARSEC);
+            break;
+        case Kiloparsec:
+            scale = static_cast<float>(1e3 * PARSEC);
+            break;
+        case Megaparsec:
+            scale = static_cast<float>(1e6 * PARSEC);
+            break;
+        case Gigaparsec:
+            scale = static_cast<float>(1e9 * PARSEC);
+            break;
+        case GigalightYears:
+            scale = static_cast<float>(306391534.73091 * PARSEC);
+            break;
+    }
+
+    // All meshes share a single vertex buffer. Each row of a mesh and, for grids, each
+    // column is stored as its own line strip so that all wires can be drawn with one
+    // glMultiDrawArrays call
+    std::vector<MeshVertex> vertices;
+    _lineStripFirsts.clear();
+    _lineStripCounts.clear();
+    _pointFirsts.clear();
+    _pointCounts.clear();
+
+    for (const std::pair<const int, RenderingMesh>& p : _renderingMeshesMap) {
+        const RenderingMesh& mesh = p.second;
+        if ((mesh.style != Wire && mesh.style != Point) || mesh.numU * mesh.numV == 0) {
+            continue;
         }
 
-        for (GLfloat& v : p.second.vertices) {
-            v *= scale;
+        // U and V may not be given by the user
+        const size_t nValuesPerVertex = mesh.vertices.size() / (mesh.numU * mesh.numV);
+        if (nValuesPerVertex < 3) {
+            continue;
         }
 
-        for (int i = 0; i < p.second.numU; ++i) {
-            GLuint vao;
-            glGenVertexArrays(1, &vao);
-            p.second.vaoArray.push_back(vao);
-
-            GLuint vbo;
-            glGenBuffers(1, &vbo);
-            p.second.vboArray.push_back(vbo);
-
-            glBindVertexArray(vao);
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            //glBufferData(GL_ARRAY_BUFFER, it->second.numV * sizeof(GLfloat),
-            glBufferData(
-                GL_ARRAY_BUFFER,
-                p.second.vertices.size() * sizeof(GLfloat),
-                &p.second.vertices[0],
-                GL_STATIC_DRAW
-            );
-            // in_position
-            glEnableVertexAttribArray(0);
-            // U and V may not be given by the user
-            if (p.second.vertices.size() / (p.second.numU * p.second.numV) > 3) {
-                glVertexAttribPointer(
-                    0,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    sizeof(GLfloat) * 5,
-                    reinterpret_cast<GLvoid*>(sizeof(GLfloat) * i * p.second.numV)
-                );
-
-                // texture coords
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(
-                    1,
-                    2,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    sizeof(GLfloat) * 7,
-                    reinterpret_cast<GLvoid*>(sizeof(GLfloat) * 3 * i * p.second.numV)
-                );
+        const auto color = _meshColorMap.find(mesh.colorIndex);
+        const glm::vec3 meshColor =
+            color != _meshColorMap.end() ? color->second : glm::vec3(0.f);
+
+        auto addVertex = [&](int u, int v) {
+            const size_t i = (u * mesh.numV + v) * nValuesPerVertex;
+            vertices.push_back({
+                glm::vec3(
+                    mesh.vertices[i] * scale,
+                    mesh.vertices[i + 1] * scale,
+                    mesh.vertices[i + 2] * scale
+                ),
+                meshColor
+            });
+        };
+
+        for (int u = 0; u < mesh.numU; ++u) {
+            const GLint first = static_cast<GLint>(vertices.size());
+            for (int v = 0; v < mesh.numV; ++v) {
+                addVertex(u, v);
             }
-            else { // no U and V:
-                glVertexAttribPointer(
-                    0,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    0,
-                    reinterpret_cast<GLvoid*>(sizeof(GLfloat) * 3 * i * p.second.numV)
-                );
+            if (mesh.style == Wire) {
+                _lineStripFirsts.push_back(first);
+                _lineStripCounts.push_back(mesh.numV);
+            }
+            else {
+                _pointFirsts.push_back(first);
+                _pointCounts.push_back(mesh.numV);
             }
         }
 
         // Grid: we need columns
-        if (p.second.numU > 1) {
-            for (int i = 0; i < p.second.numV; ++i) {
-                GLuint cvao;
-                glGenVertexArrays(1, &cvao);
-                p.second.vaoArray.push_back(cvao);
-
-                GLuint cvbo;
-                glGenBuffers(1, &cvbo);
-                p.second.vboArray.push_back(cvbo);
-
-                glBindVertexArray(cvao);
-                glBindBuffer(GL_ARRAY_BUFFER, cvbo);
-                glBufferData(
-                    GL_ARRAY_BUFFER,
-                    p.second.vertices.size() * sizeof(GLfloat),
-                    &p.second.vertices[0],
-                    GL_STATIC_DRAW
-                );
-                // in_position
-                glEnableVertexAttribArray(0);
-                // U and V may not be given by the user
-                if (p.second.vertices.size() / (p.second.numU * p.second.numV) > 3) {
-                    glVertexAttribPointer(
-                        0,
-                        3,
-                        GL_FLOAT,
-                        GL_FALSE,
-                        p.second.numV * sizeof(GLfloat) * 5,
-                        reinterpret_cast<GLvoid*>(sizeof(GLfloat) * i)
-                    );
-
-                    // texture coords
-                    glEnableVertexAttribArray(1);
-                    glVertexAttribPointer(
-                        1,
-                        2,
-                        GL_FLOAT,
-                        GL_FALSE,
-                        p.second.numV * sizeof(GLfloat) * 7,
-                        reinterpret_cast<GLvoid*>(sizeof(GLfloat) * 3 * i)
-                    );
-                }
-                else { // no U and V:
-                    glVertexAttribPointer(
-                        0,
-                        3,
-                        GL_FLOAT,
-                        GL_FALSE,
-                        p.second.numV * sizeof(GLfloat) * 3,
-                        reinterpret_cast<GLvoid*>(sizeof(GLfloat) * 3 * i)
-                    );
+        if (mesh.style == Wire && mesh.numU > 1) {
+            for (int v = 0; v < mesh.numV; ++v) {
+                _lineStripFirsts.push_back(static_cast<GLint>(vertices.size()));
+                _lineStripCounts.push_back(mesh.numU);
+                for (int u = 0; u < mesh.numU; ++u) {
+                    addVertex(u, v);
                 }
             }
         }
     }
 
+    if (_vao == 0) {
+        glGenVertexArrays(1, &_vao);
+        glGenBuffers(1, &_vbo);
+    }
+
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        vertices.size() * sizeof(MeshVertex),
+        vertices.data(),
+        GL_STATIC_DRAW
+    );
+    // in_position
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        0,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(MeshVertex),
+        reinterpret_cast<GLvoid*>(offsetof(MeshVertex, position))
+    );
+    // in_color
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(
+        1,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(MeshVertex),
+        reinterpret_cast<GLvoid*>(offsetof(MeshVertex, color))
+    );
+
     glBindVertexArray(0);
 
     _dataIsDirty = false;
@@ -36,6 +36,7 @@
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
 #include <unordered_map>
+#include <vector>
 
 namespace ghoul::filesystem { class File; }
 namespace ghoul::fontrendering { class Font; }
@@ -96,8 +97,6 @@ private:
         int numU;
         int numV;
         MeshType style;
-        std::vector<GLuint> vaoArray;
-        std::vector<GLuint> vboArray;
         std::vector<GLfloat> vertices;
     };
 
@@ -133,8 +132,7 @@ private:
     properties::OptionProperty _renderOption;
 
     ghoul::opengl::ProgramObject* _program = nullptr;
-    UniformCache(modelViewTransform, projectionTransform, alphaValue,
-        color) _uniformCache;
+    UniformCache(modelViewTransform, projectionTransform, alphaValue) _uniformCache;
     std::shared_ptr<ghoul::fontrendering::Font> _font = nullptr;
 
     std::string _speckFile;
@@ -150,6 +148,16 @@ private:
 
     std::unordered_map<int, glm::vec3> _meshColorMap;
     std::unordered_map<int, RenderingMesh> _renderingMeshesMap;
+
+    /// Contains the vertices of all meshes
+    GLuint _vao = 0;
+    GLuint _vbo = 0;
+    /// The ranges of the line strips of all wire meshes in the vertex buffer
+    std::vector<GLint> _lineStripFirsts;
+    std::vector<GLsizei> _lineStripCounts;
+    /// The ranges of the rows of all point meshes in the vertex buffer
+    std::vector<GLint> _pointFirsts;
+    std::vector<GLsizei> _pointCounts;
 };
 } // namespace openspace
 
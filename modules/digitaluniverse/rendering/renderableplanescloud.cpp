@@ -28,29 +28,34 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/rendering/compressedtexture.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/speckcache.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
-#include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 #include <array>
+#include <chrono>
+#include <cstddef>
 #include <fstream>
 #include <string>
 
 namespace {
     constexpr const char* _loggerCat = "RenderablePlanesCloud";
     constexpr const char* ProgramObjectName = "RenderablePlanesCloud";
+    constexpr const char* ArrayProgramObjectName = "RenderablePlanesCloudArray";
 
     constexpr std::array<const char*, 4> UniformNames = {
         "modelViewProjectionTransform", "alphaValue", "fadeInValue", "galaxyTexture"
     };
 
     constexpr const char* KeyFile = "File";
+    constexpr const char* KeyUseTextureArray = "UseTextureArray";
     constexpr const char* keyUnit = "Unit";
     constexpr const char* MeterUnit = "m";
     constexpr const char* KilometerUnit = "Km";
@@ -60,7 +65,6 @@ namespace {
     constexpr const char* GigaparsecUnit = "Gpc";
     constexpr const char* GigalightyearUnit = "Gly";
 
-    constexpr int8_t CurrentCacheVersion = 2;
     constexpr double PARSEC = 0.308567756E17;
 
     enum BlendMode {
@@ -290,6 +294,15 @@ documentation::Documentation RenderablePlanesCloud::Documentation() {
                 Optional::Yes,
                 PlaneMinSizeInfo.description
             },
+            {
+                KeyUseTextureArray,
+                new BoolVerifier,
+                Optional::Yes,
+                "If this value is 'true', all textures are packed into a single texture "
+                "array and all planes are drawn with a single instanced draw call, "
+                "rather than one draw call per texture. The textures are scaled to the "
+                "size of the largest texture. The default value is 'false'."
+            },
         }
     };
 }
@@ -477,6 +490,10 @@ RenderablePlanesCloud::RenderablePlanesCloud(const ghoul::Dictionary& dictionary
         );
         addProperty(_planeMinSize);
     }
+
+    if (dictionary.hasKey(KeyUseTextureArray)) {
+        _useTextureArray = dictionary.value<bool>(KeyUseTextureArray);
+    }
 }
 
 bool RenderablePlanesCloud::isReady() const {
@@ -491,23 +508,42 @@ void RenderablePlanesCloud::initialize() {
 }
 
 void RenderablePlanesCloud::initializeGL() {
-    _program = DigitalUniverseModule::ProgramObjectManager.request(
-        ProgramObjectName,
-        []() -> std::unique_ptr<ghoul::opengl::ProgramObject> {
-            return global::renderEngine.buildRenderProgram(
-                "RenderablePlanesCloud",
-                absPath("${MODULE_DIGITALUNIVERSE}/shaders/plane_vs.glsl"),
-                absPath("${MODULE_DIGITALUNIVERSE}/shaders/plane_fs.glsl")
-            );
-        }
-    );
+    // The texture layers have to be known before the planes are created
+    loadTextures();
+    if (_useTextureArray && !packTextureArray()) {
+        LWARNING("Falling back to drawing the planes one texture at a time");
+        _useTextureArray = false;
+    }
+
+    if (_useTextureArray) {
+        _program = DigitalUniverseModule::ProgramObjectManager.request(
+            ArrayProgramObjectName,
+            []() -> std::unique_ptr<ghoul::opengl::ProgramObject> {
+                return global::renderEngine.buildRenderProgram(
+                    "RenderablePlanesCloudArray",
+                    absPath("${MODULE_DIGITALUNIVERSE}/shaders/plane_array_vs.glsl"),
+                    absPath("${MODULE_DIGITALUNIVERSE}/shaders/plane_array_fs.glsl")
+                );
+            }
+        );
+    }
+    else {
+        _program = DigitalUniverseModule::ProgramObjectManager.request(
+            ProgramObjectName,
+            []() -> std::unique_ptr<ghoul::opengl::ProgramObject> {
+                return global::renderEngine.buildRenderProgram(
+                    "RenderablePlanesCloud",
+                    absPath("${MODULE_DIGITALUNIVERSE}/shaders/plane_vs.glsl"),
+                    absPath("${MODULE_DIGITALUNIVERSE}/shaders/plane_fs.glsl")
+                );
+            }
+        );
+    }
 
     ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
 
     createPlanes();
 
-    loadTextures();
-
     if (_hasLabel) {
         if (!_font) {
             constexpr const int FontSize = 30;
@@ -529,13 +565,25 @@ void RenderablePlanesCloud::deleteDataGPUAndCPU() {
         pAMapItem.second.planesCoordinates.clear();
     }
     _planesMap.clear();
+
+    glDeleteBuffers(1, &_instancesVbo);
+    _instancesVbo = 0;
+    glDeleteVertexArrays(1, &_instancesVao);
+    _instancesVao = 0;
+    _nInstances = 0;
 }
 
 void RenderablePlanesCloud::deinitializeGL() {
+    if (_planesFuture.valid()) {
+        _planesFuture.wait();
+    }
     deleteDataGPUAndCPU();
 
+    glDeleteTextures(1, &_textureArray);
+    _textureArray = 0;
+
     DigitalUniverseModule::ProgramObjectManager.release(
-        ProgramObjectName,
+        _useTextureArray ? ArrayProgramObjectName : ProgramObjectName,
         [](ghoul::opengl::ProgramObject* p) {
             global::renderEngine.removeRenderProgram(p);
         }
@@ -589,21 +637,29 @@ void RenderablePlanesCloud::renderPlanes(const RenderData&,
     ghoul::opengl::TextureUnit unit;
     unit.activate();
     _program->setUniform(_uniformCache.galaxyTexture, unit);
-    int currentTextureIndex = -1;
 
-    for (std::unordered_map<int, PlaneAggregate>::reference pAMapItem : _planesMap)
-    {
-        // For planes with undefined textures references
-        if (pAMapItem.first == 30) {
-            continue;
-        }
+    if (_useTextureArray) {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, _textureArray);
+        glBindVertexArray(_instancesVao);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, _nInstances);
+    }
+    else {
+        int currentTextureIndex = -1;
+
+        for (std::unordered_map<int, PlaneAggregate>::reference pAMapItem : _planesMap)
+        {
+            // For planes with undefined textures references
+            if (pAMapItem.first == 30) {
+                continue;
+            }
 
-        if (currentTextureIndex != pAMapItem.first) {
-            _textureMap[pAMapItem.first]->bind();
-            currentTextureIndex = pAMapItem.first;
+            if (currentTextureIndex != pAMapItem.first) {
+                _textureMap[pAMapItem.first]->bind();
+                currentTextureIndex = pAMapItem.first;
+            }
+            glBindVertexArray(pAMapItem.second.vao);
+            glDrawArrays(GL_TRIANGLES, 0, 6 * pAMapItem.second.numberOfPlanes);
         }
-        glBindVertexArray(pAMapItem.second.vao);
-        glDrawArrays(GL_TRIANGLES, 0, 6 * pAMapItem.second.numberOfPlanes);
     }
 
     glBindVertexArray(0);
@@ -756,10 +812,18 @@ void RenderablePlanesCloud::render(const RenderData& data, RendererTasks&) {
 }
 
 void RenderablePlanesCloud::update(const UpdateData&) {
-    if (_dataIsDirty  && _hasSpeckFile) {
+    // The previous planes are drawn until the new ones have been generated
+    if (_planesFuture.valid() &&
+        _planesFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
         deleteDataGPUAndCPU();
+        uploadPlanes(_planesFuture.get());
+    }
+
+    // A change of the scale factor while the planes are generated is picked up once
+    // the generation has finished
+    if (_dataIsDirty && _hasSpeckFile && !_planesFuture.valid()) {
         createPlanes();
-        _dataIsDirty = false;
     }
 
     if (_program->isDirty()) {
@@ -847,17 +911,13 @@ bool RenderablePlanesCloud::loadTextures() {
         for (const std::pair<int, std::string>& pair : _textureFileMap) {
             const auto& p = _textureMap.insert(std::make_pair(
                 pair.first,
-                ghoul::io::TextureReader::ref().loadTexture(pair.second)
+                rendering::loadTexture(pair.second)
             ));
             if (p.second) {
                 LINFOC(
                     "RenderablePlanesCloud",
                     fmt::format("Loaded texture from '{}'", pair.second)
                 );
-                p.first->second->uploadTexture();
-                p.first->second->setFilter(
-                    ghoul::opengl::Texture::FilterMode::LinearMipMap
-                );
             }
         }
     }
@@ -1139,157 +1199,141 @@ bool RenderablePlanesCloud::readLabelFile() {
 }
 
 bool RenderablePlanesCloud::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed: deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(file);
-            return false;
-        }
+    std::optional<speckcache::Dataset> dataset = speckcache::loadCachedFile(file);
+    if (!dataset) {
+        return false;
+    }
 
-        int32_t nValues = 0;
-        fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(
-            &_nValuesPerAstronomicalObject),
-            sizeof(int32_t)
-        );
+    _nValuesPerAstronomicalObject = dataset->nValuesPerObject;
+    _fullData = std::move(dataset->data);
+    return true;
+}
 
-        _fullData.resize(nValues);
-        fileStream.read(reinterpret_cast<char*>(&_fullData[0]),
-            nValues * sizeof(_fullData[0]));
+bool RenderablePlanesCloud::saveCachedFile(const std::string& file) const {
+    return speckcache::saveCachedFile(file, _fullData, _nValuesPerAstronomicalObject);
+}
 
-        bool success = fileStream.good();
-        return success;
+void RenderablePlanesCloud::createPlanes() {
+    if (_dataIsDirty && _hasSpeckFile) {
+        LDEBUG("Creating planes...");
+        // The plane generation only reads data that does not change after loading, so
+        // it can run on a worker thread; the planes are uploaded in the next update
+        // after it has finished
+        const float scaleFactor = _scaleFactor;
+        _planesFuture = std::async(std::launch::async, [this, scaleFactor]() {
+            return generatePlanes(scaleFactor);
+        });
+        _dataIsDirty = false;
     }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
-        return false;
+
+    if (_hasLabel && _labelDataIsDirty) {
+        _labelDataIsDirty = false;
     }
 }
 
-bool RenderablePlanesCloud::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
-    if (fileStream.good()) {
-        fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion),
-            sizeof(int8_t));
-
-        const int32_t nValues = static_cast<int32_t>(_fullData.size());
-        if (nValues == 0) {
-            LERROR("Error writing cache: No values were loaded");
-            return false;
-        }
-        fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
+RenderablePlanesCloud::PlanesData RenderablePlanesCloud::generatePlanes(
+                                                                float scaleFactor) const
+{
+    float scale = 0.f;
+    switch (_unit) {
+        case Meter:
+            scale = 1.f;
+            break;
+        case Kilometer:
+            scale = 1e3f;
+            break;
+        case Parsec:
+            scale = static_cast<float>(PARSEC);
+            break;
+        case Kiloparsec:
+            scale = static_cast<float>(1e3 * PARSEC);
+            break;
+        case Megaparsec:
+            scale = static_cast<float>(1e6 * PARSEC);
+            break;
+        case Gigaparsec:
+            scale = static_cast<float>(1e9 * PARSEC);
+            break;
+        case GigalightYears:
+            scale = static_cast<float>(306391534.73091 * PARSEC);
+            break;
+    }
 
-        const int32_t nValuesPerAstronomicalObject = static_cast<int32_t>(
-            _nValuesPerAstronomicalObject
-        );
-        fileStream.write(reinterpret_cast<const char*>(
-            &nValuesPerAstronomicalObject),
-            sizeof(int32_t)
+    const auto luminosityPosition = _variableDataPositionMap.find(_luminosityVar);
+
+    PlanesData data;
+    for (size_t p = 0; p < _fullData.size(); p += _nValuesPerAstronomicalObject) {
+        const glm::vec4 transformedPos = glm::vec4(
+            _transformationMatrix *
+            glm::dvec4(_fullData[p + 0], _fullData[p + 1], _fullData[p + 2], 1.0)
         );
 
-        const size_t nBytes = nValues * sizeof(_fullData[0]);
-        fileStream.write(reinterpret_cast<const char*>(&_fullData[0]), nBytes);
+        // Plane vectors u and v
+        glm::vec4 u = glm::vec4(
+            _transformationMatrix *
+            glm::dvec4(
+                _fullData[p + _planeStartingIndexPos + 0],
+                _fullData[p + _planeStartingIndexPos + 1],
+                _fullData[p + _planeStartingIndexPos + 2],
+                1.f
+            )
+        );
+        u /= 2.f;
+        u.w = 0.f;
+
+        glm::vec4 v = glm::vec4(
+            _transformationMatrix *
+            glm::dvec4(
+                _fullData[p + _planeStartingIndexPos + 3],
+                _fullData[p + _planeStartingIndexPos + 4],
+                _fullData[p + _planeStartingIndexPos + 5],
+                1.f
+            )
+        );
+        v /= 2.f;
+        v.w = 0.f;
 
-        bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
-        return false;
-    }
-}
+        if (luminosityPosition != _variableDataPositionMap.end()) {
+            float lumS = _fullData[p + luminosityPosition->second] * _sluminosity;
+            u *= lumS;
+            v *= lumS;
+        }
 
-void RenderablePlanesCloud::createPlanes() {
-    if (_dataIsDirty && _hasSpeckFile) {
-        LDEBUG("Creating planes...");
-        float maxSize = 0.f;
-        for (size_t p = 0; p < _fullData.size(); p += _nValuesPerAstronomicalObject) {
-            const glm::vec4 transformedPos = glm::vec4(
-                _transformationMatrix *
-                glm::dvec4(_fullData[p + 0], _fullData[p + 1], _fullData[p + 2], 1.0)
-            );
+        u *= scaleFactor;
+        v *= scaleFactor;
 
-            // Plane vectors u and v
-            glm::vec4 u = glm::vec4(
-                _transformationMatrix *
-                glm::dvec4(
-                    _fullData[p + _planeStartingIndexPos + 0],
-                    _fullData[p + _planeStartingIndexPos + 1],
-                    _fullData[p + _planeStartingIndexPos + 2],
-                    1.f
-                )
-            );
-            u /= 2.f;
-            u.w = 0.f;
-
-            glm::vec4 v = glm::vec4(
-                _transformationMatrix *
-                glm::dvec4(
-                    _fullData[p + _planeStartingIndexPos + 3],
-                    _fullData[p + _planeStartingIndexPos + 4],
-                    _fullData[p + _planeStartingIndexPos + 5],
-                    1.f
-                )
-            );
-            v /= 2.f;
-            v.w = 0.f;
-
-            if (!_luminosityVar.empty()) {
-                float lumS = _fullData[p + _variableDataPositionMap[_luminosityVar]] *
-                             _sluminosity;
-                u *= lumS;
-                v *= lumS;
-            }
+        glm::vec4 vertex0 = transformedPos - u - v; // same as 3
+        glm::vec4 vertex1 = transformedPos + u + v; // same as 5
+        glm::vec4 vertex2 = transformedPos - u + v;
+        glm::vec4 vertex4 = transformedPos + u - v;
 
-            u *= _scaleFactor;
-            v *= _scaleFactor;
-
-            glm::vec4 vertex0 = transformedPos - u - v; // same as 3
-            glm::vec4 vertex1 = transformedPos + u + v; // same as 5
-            glm::vec4 vertex2 = transformedPos - u + v;
-            glm::vec4 vertex4 = transformedPos + u - v;
-
-            float scale = 0.f;
-            switch (_unit) {
-                case Meter:
-                    scale = 1.f;
-                    break;
-                case Kilometer:
-                    scale = 1e3f;
-                    break;
-                case Parsec:
-                    scale = static_cast<float>(PARSEC);
-                    break;
-                case Kiloparsec:
-                    scale = static_cast<float>(1e3 * PARSEC);
-                    break;
-                case Megaparsec:
-                    scale = static_cast<float>(1e6 * PARSEC);
-                    break;
-                case Gigaparsec:
-                    scale = static_cast<float>(1e9 * PARSEC);
-                    break;
-                case GigalightYears:
-                    scale = static_cast<float>(306391534.73091 * PARSEC);
-                    break;
-            }
+        for (int i = 0; i < 3; ++i) {
+            data.maxSize = std::max(data.maxSize, vertex0[i]);
+            data.maxSize = std::max(data.maxSize, vertex1[i]);
+            data.maxSize = std::max(data.maxSize, vertex2[i]);
+            data.maxSize = std::max(data.maxSize, vertex4[i]);
+        }
 
-            for (int i = 0; i < 3; ++i) {
-                maxSize = std::max(maxSize, vertex0[i]);
-                maxSize = std::max(maxSize, vertex1[i]);
-                maxSize = std::max(maxSize, vertex2[i]);
-                maxSize = std::max(maxSize, vertex4[i]);
+        vertex0 *= scale;
+        vertex1 *= scale;
+        vertex2 *= scale;
+        vertex4 *= scale;
+
+        const int textureIndex = static_cast<int>(_fullData[p + _textureVariableIndex]);
+        if (_useTextureArray) {
+            // Planes without a texture layer would not be drawn anyway
+            const auto layer = _textureLayers.find(textureIndex);
+            if (layer == _textureLayers.end()) {
+                continue;
             }
 
-            vertex0 *= scale;
-            vertex1 *= scale;
-            vertex2 *= scale;
-            vertex4 *= scale;
-
+            data.instances.push_back({
+                { glm::vec3(vertex0), glm::vec3(vertex1), glm::vec3(vertex2),
+                  glm::vec3(vertex4) },
+                static_cast<float>(layer->second)
+            });
+        }
+        else {
             GLfloat vertexData[] = {
                 //  x          y          z       w    s    t
                 vertex0.x, vertex0.y, vertex0.z, 1.f, 0.f, 0.f,
@@ -1300,37 +1344,80 @@ void RenderablePlanesCloud::createPlanes() {
                 vertex1.x, vertex1.y, vertex1.z, 1.f, 1.f, 1.f,
             };
 
-            int textureIndex = static_cast<int>(_fullData[p + _textureVariableIndex]);
-            std::unordered_map<int, PlaneAggregate>::iterator found =
-                _planesMap.find(textureIndex);
-            if (found != _planesMap.end()) {
-                for (int i = 0; i < PLANES_VERTEX_DATA_SIZE; ++i) {
-                    found->second.planesCoordinates.push_back(vertexData[i]);
-                }
-                found->second.numberOfPlanes++;
-            }
-            else {
-                PlaneAggregate pA;
-                pA.textureIndex = textureIndex;
-                glGenVertexArrays(1, &pA.vao);
-                glGenBuffers(1, &pA.vbo);
-                pA.numberOfPlanes = 1;
-                for (int i = 0; i < PLANES_VERTEX_DATA_SIZE; ++i) {
-                    pA.planesCoordinates.push_back(vertexData[i]);
-                }
-                _planesMap.insert(std::pair<int, PlaneAggregate>(textureIndex, pA));
-            }
+            std::vector<GLfloat>& coordinates = data.planesCoordinates[textureIndex];
+            coordinates.insert(
+                coordinates.end(),
+                vertexData,
+                vertexData + PLANES_VERTEX_DATA_SIZE
+            );
         }
+    }
+    return data;
+}
 
-        // Send data to GPU
-        for (const std::pair<const int, PlaneAggregate>& pAMapItem : _planesMap) {
-            glBindVertexArray(pAMapItem.second.vao);
-            glBindBuffer(GL_ARRAY_BUFFER, pAMapItem.second.vbo);
+void RenderablePlanesCloud::uploadPlanes(PlanesData data) {
+    if (_useTextureArray) {
+        glGenVertexArrays(1, &_instancesVao);
+        glGenBuffers(1, &_instancesVbo);
+
+        glBindVertexArray(_instancesVao);
+        glBindBuffer(GL_ARRAY_BUFFER, _instancesVbo);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            data.instances.size() * sizeof(PlaneInstance),
+            data.instances.data(),
+            GL_STATIC_DRAW
+        );
+
+        // All attributes are per plane, the vertices are generated from gl_VertexID
+        constexpr const GLsizei Stride = sizeof(PlaneInstance);
+        for (GLuint i = 0; i < 4; ++i) {
+            glEnableVertexAttribArray(i);
+            glVertexAttribPointer(
+                i,
+                3,
+                GL_FLOAT,
+                GL_FALSE,
+                Stride,
+                reinterpret_cast<const void*>(
+                    offsetof(PlaneInstance, corners) + i * sizeof(glm::vec3)
+                )
+            );
+            glVertexAttribDivisor(i, 1);
+        }
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(
+            4,
+            1,
+            GL_FLOAT,
+            GL_FALSE,
+            Stride,
+            reinterpret_cast<const void*>(offsetof(PlaneInstance, textureLayer))
+        );
+        glVertexAttribDivisor(4, 1);
+
+        glBindVertexArray(0);
+        _nInstances = static_cast<GLsizei>(data.instances.size());
+    }
+    else {
+        for (std::pair<const int, std::vector<GLfloat>>& coordinates :
+             data.planesCoordinates)
+        {
+            PlaneAggregate pA;
+            pA.textureIndex = coordinates.first;
+            pA.numberOfPlanes = static_cast<int>(
+                coordinates.second.size() / PLANES_VERTEX_DATA_SIZE
+            );
+            pA.planesCoordinates = std::move(coordinates.second);
+            glGenVertexArrays(1, &pA.vao);
+            glGenBuffers(1, &pA.vbo);
+
+            glBindVertexArray(pA.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, pA.vbo);
             glBufferData(
                 GL_ARRAY_BUFFER,
-                sizeof(GLfloat) * PLANES_VERTEX_DATA_SIZE *
-                    pAMapItem.second.numberOfPlanes,
-                pAMapItem.second.planesCoordinates.data(),
+                sizeof(GLfloat) * PLANES_VERTEX_DATA_SIZE * pA.numberOfPlanes,
+                pA.planesCoordinates.data(),
                 GL_STATIC_DRAW
             );
             // in_position
@@ -1356,16 +1443,114 @@ void RenderablePlanesCloud::createPlanes() {
             );
 
             glBindVertexArray(0);
+
+            _planesMap.insert(std::pair<int, PlaneAggregate>(pA.textureIndex, pA));
         }
+    }
 
-        _dataIsDirty = false;
+    _fadeInDistance.setMaxValue(glm::vec2(10.f * data.maxSize));
+}
 
-        _fadeInDistance.setMaxValue(glm::vec2(10.f * maxSize));
+bool RenderablePlanesCloud::packTextureArray() {
+    // All layers of a texture array have the same size, so each texture is scaled to
+    // the size of the largest texture when it is copied into its layer
+    glm::ivec2 size = glm::ivec2(0);
+    std::vector<std::pair<int, const ghoul::opengl::Texture*>> textures;
+    for (const std::pair<const int, std::unique_ptr<ghoul::opengl::Texture>>& p :
+         _textureMap)
+    {
+        // For planes with undefined textures references
+        if (p.first == 30 || !p.second) {
+            continue;
+        }
+        textures.emplace_back(p.first, p.second.get());
+        size = glm::max(size, glm::ivec2(p.second->dimensions()));
     }
 
-    if (_hasLabel && _labelDataIsDirty) {
-        _labelDataIsDirty = false;
+    if (textures.empty()) {
+        return false;
+    }
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (static_cast<GLint>(textures.size()) > maxLayers) {
+        LWARNING(fmt::format(
+            "The {} textures exceed the maximum of {} texture array layers",
+            textures.size(), maxLayers
+        ));
+        return false;
     }
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    size = glm::min(size, glm::ivec2(maxSize));
+
+    glGenTextures(1, &_textureArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, _textureArray);
+    glTexImage3D(
+        GL_TEXTURE_2D_ARRAY,
+        0,
+        GL_RGBA8,
+        size.x,
+        size.y,
+        static_cast<GLsizei>(textures.size()),
+        0,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        nullptr
+    );
+
+    // The layers are filled on the GPU by blitting each texture into its layer
+    GLint readFramebuffer = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    GLint drawFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+
+    GLuint framebuffers[2];
+    glGenFramebuffers(2, framebuffers);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+    for (size_t i = 0; i < textures.size(); ++i) {
+        const ghoul::opengl::Texture& texture = *textures[i].second;
+        glFramebufferTexture2D(
+            GL_READ_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D,
+            static_cast<GLuint>(texture),
+            0
+        );
+        glFramebufferTextureLayer(
+            GL_DRAW_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            _textureArray,
+            0,
+            static_cast<GLint>(i)
+        );
+        glBlitFramebuffer(
+            0,
+            0,
+            static_cast<GLint>(texture.width()),
+            static_cast<GLint>(texture.height()),
+            0,
+            0,
+            size.x,
+            size.y,
+            GL_COLOR_BUFFER_BIT,
+            GL_LINEAR
+        );
+        _textureLayers[textures[i].first] = static_cast<int>(i);
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+    glDeleteFramebuffers(2, framebuffers);
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // The individual textures are only needed to draw the planes one texture at a time
+    _textureMap.clear();
+    return true;
 }
 
 } // namespace openspace
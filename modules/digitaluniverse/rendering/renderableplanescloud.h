@@ -39,7 +39,9 @@
 #include <ghoul/opengl/uniformcache.h>
 
 #include <functional>
+#include <future>
 #include <unordered_map>
+#include <vector>
 
 namespace ghoul::filesystem { class File; }
 namespace ghoul::fontrendering { class Font; }
@@ -90,8 +92,28 @@ private:
         std::vector<GLfloat> planesCoordinates;
     };
 
+    /// A plane that is drawn as a single instance when the textures are packed into
+    /// a texture array
+    struct PlaneInstance {
+        /// The corners at the (s,t) coordinates (0,0), (1,1), (0,1), and (1,0)
+        glm::vec3 corners[4];
+        float textureLayer;
+    };
+
+    /// The result of the plane generation, which only contains CPU-side data so that it
+    /// can be created outside the main thread
+    struct PlanesData {
+        /// The vertices of the planes for each texture index
+        std::unordered_map<int, std::vector<GLfloat>> planesCoordinates;
+        std::vector<PlaneInstance> instances;
+        float maxSize = 0.f;
+    };
+
     void deleteDataGPUAndCPU();
     void createPlanes();
+    PlanesData generatePlanes(float scaleFactor) const;
+    void uploadPlanes(PlanesData data);
+    bool packTextureArray();
     void renderPlanes(const RenderData& data, const glm::dmat4& modelViewMatrix,
         const glm::dmat4& projectionMatrix, float fadeInVariable);
     void renderLabels(const RenderData& data,
@@ -137,6 +159,18 @@ private:
     std::unordered_map<int, std::string> _textureFileMap;
     std::unordered_map<int, PlaneAggregate> _planesMap;
 
+    /// If this is \c true, all textures are packed into a single texture array and all
+    /// planes are drawn with a single instanced draw call
+    bool _useTextureArray = false;
+    GLuint _textureArray = 0;
+    /// The layer in the texture array for each texture index
+    std::unordered_map<int, int> _textureLayers;
+    GLuint _instancesVao = 0;
+    GLuint _instancesVbo = 0;
+    GLsizei _nInstances = 0;
+
+    std::future<PlanesData> _planesFuture;
+
     std::string _speckFile;
     std::string _labelFile;
     std::string _texturesPath;
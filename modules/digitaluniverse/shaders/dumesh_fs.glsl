@@ -26,8 +26,8 @@
 
 in float vs_screenSpaceDepth;
 in vec4 vs_positionViewSpace;
+in vec3 vs_color;
 
-uniform vec3 color;
 uniform float alphaValue;
 
 Fragment getFragment() {
@@ -37,7 +37,7 @@ Fragment getFragment() {
         discard;
     }
 
-    frag.color = vec4(color, alphaValue);
+    frag.color = vec4(vs_color, alphaValue);
     frag.depth = vs_screenSpaceDepth;
 
     // JCC: Need to change the position to camera space
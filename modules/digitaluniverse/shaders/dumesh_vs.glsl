@@ -26,13 +26,15 @@
 
 #include "PowerScaling/powerScaling_vs.hglsl"
 
-in vec3 in_position;
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_color;
 
 uniform dmat4 modelViewTransform;
 uniform dmat4 projectionTransform;
 
 out float vs_screenSpaceDepth;
 out vec4 vs_positionViewSpace;
+out vec3 vs_color;
 
 void main() {
     dvec4 positionViewSpace  = modelViewTransform * dvec4(in_position, 1.0);
@@ -41,6 +43,7 @@ void main() {
 
     vs_screenSpaceDepth  = positionScreenSpace.w;
     vs_positionViewSpace = vec4(positionViewSpace);
+    vs_color             = in_color;
 
     gl_Position = positionScreenSpace;
 }
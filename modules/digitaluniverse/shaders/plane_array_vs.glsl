@@ -0,0 +1,63 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#version __CONTEXT__
+
+#include "PowerScaling/powerScaling_vs.hglsl"
+
+// The four corners of the plane, the six vertices are generated from gl_VertexID
+layout(location = 0) in vec3 in_corner0;
+layout(location = 1) in vec3 in_corner1;
+layout(location = 2) in vec3 in_corner2;
+layout(location = 3) in vec3 in_corner3;
+layout(location = 4) in float in_textureLayer;
+
+out vec2 vs_st;
+flat out float vs_textureLayer;
+out float vs_screenSpaceDepth;
+
+uniform dmat4 modelViewProjectionTransform;
+
+const int Corners[6] = int[6](0, 1, 2, 0, 3, 1);
+const vec2 TexCoords[4] = vec2[4](
+    vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0), vec2(1.0, 0.0)
+);
+
+
+void main() {
+    int corner = Corners[gl_VertexID];
+    vec3 corners[4] = vec3[4](in_corner0, in_corner1, in_corner2, in_corner3);
+
+    vs_st = TexCoords[corner];
+    vs_textureLayer = in_textureLayer;
+
+    vec4 positionClipSpace = vec4(
+        modelViewProjectionTransform * dvec4(corners[corner], 1.0)
+    );
+    vec4 positionScreenSpace = z_normalization(positionClipSpace);
+
+    vs_screenSpaceDepth = positionScreenSpace.w;
+    gl_Position = positionScreenSpace;
+}
@@ -32,13 +32,17 @@
 #include <openspace/interaction/orbitalnavigator.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scene.h>
+#include <openspace/util/job.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <thread>
 
 namespace {
@@ -47,6 +51,7 @@ namespace {
     constexpr const GLuint VaPosition = 0; // MUST CORRESPOND TO THE SHADER PROGRAM
     constexpr const GLuint VaColor    = 1; // MUST CORRESPOND TO THE SHADER PROGRAM
     constexpr const GLuint VaMasking  = 2; // MUST CORRESPOND TO THE SHADER PROGRAM
+    constexpr const GLuint VaNextPosition = 3; // MUST CORRESPOND TO THE SHADER PROGRAM
 
     // ----- KEYS POSSIBLE IN MODFILE. EXPECTED DATA TYPE OF VALUE IN [BRACKETS]  ----- //
     // ---------------------------- MANDATORY MODFILE KEYS ---------------------------- //
@@ -66,10 +71,15 @@ namespace {
     constexpr const char* KeyCdfExtraVariables = "ExtraVariables";
     // [STRING]
     constexpr const char* KeyCdfTracingVariable = "TracingVariable";
+    // [INT] Number of threads used to trace the field lines. Defaults to the number of
+    // hardware threads
+    constexpr const char* KeyCdfTracingThreads = "TracingThreads";
     // [STRING]
     constexpr const char* KeyJsonScalingFactor = "ScaleToMeters";
     // [BOOLEAN] If value False => Load in initializing step and store in RAM
     constexpr const char* KeyOslfsLoadAtRuntime = "LoadAtRuntime";
+    // [INT] Number of states that are decoded ahead of time if loading at runtime
+    constexpr const char* KeyOslfsPrefetchCount = "PrefetchCount";
 
     // ---------------------------- OPTIONAL MODFILE KEYS  ---------------------------- //
     // [STRING ARRAY] Values should be paths to .txt files
@@ -81,12 +91,40 @@ namespace {
     // [STRING] Value should be path to folder where states are saved (JSON/CDF input
     // => osfls output & oslfs input => JSON output)
     constexpr const char* KeyOutputFolder = "OutputFolder";
+    // [BOOLEAN] If True, the .osfls files written to the OutputFolder store the vertex
+    // positions as half floats
+    constexpr const char* KeyOutputHalfFloatPositions = "OutputHalfFloatPositions";
+    // [BOOLEAN] If True, all states are kept on the GPU and the lines are interpolated
+    // between consecutive states. Ignored if LoadAtRuntime is True
+    constexpr const char* KeyGpuResidentStates = "GpuResidentStates";
 
     // ------------- POSSIBLE STRING VALUES FOR CORRESPONDING MODFILE KEY ------------- //
     constexpr const char* ValueInputFileTypeCdf = "cdf";
     constexpr const char* ValueInputFileTypeJson = "json";
     constexpr const char* ValueInputFileTypeOsfls = "osfls";
 
+    using LoadedState = openspace::RenderableFieldlinesSequence::LoadedState;
+
+    // Decodes a single .osfls file on the loader thread
+    struct StateLoadJob : public openspace::Job<LoadedState> {
+        StateLoadJob(int index, std::string filePath)
+            : _filePath(std::move(filePath))
+        {
+            _loadedState.index = index;
+        }
+
+        void execute() override {
+            _loadedState.isSuccessful = _loadedState.state.loadStateFromOsfls(_filePath);
+        }
+
+        LoadedState product() override {
+            return std::move(_loadedState);
+        }
+
+        std::string _filePath;
+        LoadedState _loadedState;
+    };
+
     // --------------------------------- Property Info -------------------------------- //
     constexpr openspace::properties::Property::PropertyInfo ColorMethodInfo = {
         "colorMethod",
@@ -213,6 +251,12 @@ namespace {
         "Jump to Start Of Sequence",
         "Performs a time jump to the start of the sequence."
     };
+    constexpr openspace::properties::Property::PropertyInfo InterpolateStatesInfo = {
+        "interpolateStates",
+        "Interpolate States",
+        "If enabled, the lines are smoothly blended between consecutive states that "
+        "consist of the same lines instead of switching when the next state begins."
+    };
 
     enum class SourceFileType : int {
         Cdf = 0,
@@ -280,6 +324,8 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
     , _pMaskingQuantity(MaskingQuantityInfo, OptionProperty::DisplayType::Dropdown)
     , _pFocusOnOriginBtn(OriginButtonInfo)
     , _pJumpToStartBtn(TimeJumpButtonInfo)
+    , _pInterpolateStates(InterpolateStatesInfo, true)
+    , _stateLoader(ThreadPool(1))
 {
     _dictionary = std::make_unique<ghoul::Dictionary>(dictionary);
 }
@@ -335,6 +381,13 @@ void RenderableFieldlinesSequence::initializeGL() {
     if (!_loadingStatesDynamically) {
         _sourceFiles.clear();
     }
+    else if (_isGpuResident) {
+        LWARNING(fmt::format(
+            "{}: {} is ignored as the states are loaded at runtime",
+            _identifier, KeyGpuResidentStates
+        ));
+        _isGpuResident = false;
+    }
 
     // At this point there should be at least one state loaded into memory!
     if (_states.empty()) {
@@ -360,6 +413,10 @@ void RenderableFieldlinesSequence::initializeGL() {
     glGenBuffers(1, &_vertexColorBuffer);
     glGenBuffers(1, &_vertexMaskingBuffer);
 
+    if (_isGpuResident) {
+        uploadResidentStates();
+    }
+
     // Needed for additive blending
     setRenderBin(Renderable::RenderBin::Overlay);
 }
@@ -481,6 +538,16 @@ void RenderableFieldlinesSequence::extractOptionalInfoFromDictionary(
         }
     }
 
+    bool halfFloatPositions;
+    if (_dictionary->getValue(KeyOutputHalfFloatPositions, halfFloatPositions)) {
+        _saveHalfFloatPositions = halfFloatPositions;
+    }
+
+    bool gpuResidentStates;
+    if (_dictionary->getValue(KeyGpuResidentStates, gpuResidentStates)) {
+        _isGpuResident = gpuResidentStates;
+    }
+
     ghoul::Dictionary colorTablesPathsDictionary;
     if (_dictionary->getValue(KeyColorTablePaths, colorTablesPathsDictionary)) {
         const size_t nProvidedPaths = colorTablesPathsDictionary.size();
@@ -570,7 +637,7 @@ bool RenderableFieldlinesSequence::loadJsonStatesIntoRAM(const std::string& outp
         if (loadedSuccessfully) {
             addStateToSequence(newState);
             if (!outputFolder.empty()) {
-                newState.saveStateToOsfls(outputFolder);
+                newState.saveStateToOsfls(outputFolder, _saveHalfFloatPositions);
             }
         }
     }
@@ -587,6 +654,8 @@ bool RenderableFieldlinesSequence::prepareForOsflsStreaming() {
     _states.push_back(newState);
     _nStates = _startTimes.size();
     _activeStateIndex = 0;
+    // One slot for the active state and one for each prefetched state
+    _stateRing.resize(static_cast<size_t>(_nPrefetchedStates) + 1);
     return true;
 }
 
@@ -619,6 +688,11 @@ void RenderableFieldlinesSequence::extractOsflsInfoFromDictionary() {
             _identifier, KeyOslfsLoadAtRuntime
         ));
     }
+
+    float prefetchCount;
+    if (_dictionary->getValue(KeyOslfsPrefetchCount, prefetchCount)) {
+        _nPrefetchedStates = std::max(static_cast<int>(prefetchCount), 0);
+    }
 }
 
 void RenderableFieldlinesSequence::setupProperties() {
@@ -633,6 +707,9 @@ void RenderableFieldlinesSequence::setupProperties() {
     }
     addProperty(_pFocusOnOriginBtn);
     addProperty(_pJumpToStartBtn);
+    if (_isGpuResident) {
+        addProperty(_pInterpolateStates);
+    }
 
     // ----------------------------- Add Property Groups ----------------------------- //
     addPropertySubOwner(_pColorGroup);
@@ -879,23 +956,56 @@ bool RenderableFieldlinesSequence::getStatesFromCdfFiles(const std::string& outp
     std::vector<std::string> extraMagVars;
     extractMagnitudeVarsFromStrings(extraVars, extraMagVars);
 
-    // Load states into RAM!
-    for (const std::string& cdfPath : _sourceFiles) {
-        FieldlinesState newState;
-        bool isSuccessful = fls::convertCdfToFieldlinesState(
-            newState,
-            cdfPath,
-            seedPoints,
-            tracingVar,
-            extraVars,
-            extraMagVars
-        );
+    unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    double tracingThreads;
+    if (_dictionary->getValue(KeyCdfTracingThreads, tracingThreads)) {
+        nThreads = static_cast<unsigned int>(std::max(tracingThreads, 1.0));
+    }
 
-        if (isSuccessful) {
-            addStateToSequence(newState);
+    // The files are traced concurrently, and the remaining threads are spent on tracing
+    // the seed points within each file
+    const unsigned int nFileThreads = std::max(
+        std::min(nThreads, static_cast<unsigned int>(_sourceFiles.size())),
+        1u
+    );
+    const unsigned int nSeedThreads = std::max(nThreads / nFileThreads, 1u);
+
+    std::vector<FieldlinesState> newStates(_sourceFiles.size());
+    std::vector<char> isSuccessful(_sourceFiles.size(), 0);
+    std::atomic<size_t> nextFile(0);
+    auto traceFiles = [&]() {
+        for (size_t i = nextFile++; i < _sourceFiles.size(); i = nextFile++) {
+            // The conversion removes the variables that don't exist in the file
+            std::vector<std::string> fileExtraVars = extraVars;
+            std::vector<std::string> fileExtraMagVars = extraMagVars;
+            isSuccessful[i] = fls::convertCdfToFieldlinesState(
+                newStates[i],
+                _sourceFiles[i],
+                seedPoints,
+                tracingVar,
+                fileExtraVars,
+                fileExtraMagVars,
+                nSeedThreads
+            );
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    for (unsigned int i = 1; i < nFileThreads; ++i) {
+        futures.push_back(std::async(std::launch::async, traceFiles));
+    }
+    traceFiles();
+    for (std::future<void>& f : futures) {
+        f.get();
+    }
+
+    // Load states into RAM in the order of the source files!
+    for (size_t i = 0; i < newStates.size(); ++i) {
+        if (isSuccessful[i]) {
             if (!outputFolder.empty()) {
-                newState.saveStateToOsfls(outputFolder);
+                newStates[i].saveStateToOsfls(outputFolder, _saveHalfFloatPositions);
             }
+            addStateToSequence(newStates[i]);
         }
     }
     return true;
@@ -1031,15 +1141,10 @@ void RenderableFieldlinesSequence::deinitializeGL() {
         _shaderProgram = nullptr;
     }
 
-    // Stall main thread until thread that's loading states is done!
-    bool printedWarning = false;
-    while (_isLoadingStateFromDisk) {
-        if (!printedWarning) {
-            LWARNING("Trying to destroy class when an active thread is still using it");
-            printedWarning = true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    }
+    // The state that is currently being decoded only references its own job, so it is
+    // enough to drop the ones that haven't started yet
+    _stateLoader.clearEnqueuedJobs();
+    _stateRing.clear();
 }
 
 bool RenderableFieldlinesSequence::isReady() const {
@@ -1061,6 +1166,12 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
         _shaderProgram->setUniform("modelViewProjection",
                 data.camera.sgctInternal.projectionMatrix() * glm::mat4(modelViewMat));
 
+        // 'GPU-resident-states' are always uploaded as floats in meters
+        _shaderProgram->setUniform(
+            "positionScale",
+            _isGpuResident ? 1.f : _states[_activeStateIndex].vertexPositionScale()
+        );
+        _shaderProgram->setUniform("stateBlend", _stateBlend);
         _shaderProgram->setUniform("colorMethod",  _pColorMethod);
         _shaderProgram->setUniform("lineColor",    _pColorUniform);
         _shaderProgram->setUniform("usingDomain",  _pDomainEnabled);
@@ -1157,6 +1268,9 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
 
             if (_loadingStatesDynamically) {
                 _mustLoadNewStateFromDisk = true;
+            } else if (_isGpuResident) {
+                _shouldUpdateResidentAttributes = true;
+                _activeStateIndex = _activeTriggerTimeIndex;
             } else {
                 _needsUpdate = true;
                 _activeStateIndex = _activeTriggerTimeIndex;
@@ -1167,25 +1281,37 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
         _activeTriggerTimeIndex   = -1;
         _mustLoadNewStateFromDisk = false;
         _needsUpdate              = false;
+        _shouldUpdateResidentAttributes = false;
     }
 
-    if (_mustLoadNewStateFromDisk) {
-        if (!_isLoadingStateFromDisk && !_newStateIsReady) {
-            _isLoadingStateFromDisk    = true;
-            _mustLoadNewStateFromDisk  = false;
-            std::string filePath = _sourceFiles[_activeTriggerTimeIndex];
-            std::thread readBinaryThread([this, f = std::move(filePath)] {
-                readNewState(f);
-            });
-            readBinaryThread.detach();
+    if (_isGpuResident && _activeTriggerTimeIndex != -1) {
+        updateStateBlend(currentTime);
+        if (_shouldUpdateResidentAttributes) {
+            updateResidentAttributes();
+            _shouldUpdateResidentAttributes = false;
         }
     }
 
-    if (_needsUpdate || _newStateIsReady) {
-        if (_loadingStatesDynamically) {
-            _states[0] = std::move(*_newState);
+    if (_loadingStatesDynamically) {
+        collectLoadedStates();
+
+        if (_activeTriggerTimeIndex != -1) {
+            prefetchStates(global::timeManager.deltaTime() >= 0.0);
         }
 
+        if (_mustLoadNewStateFromDisk) {
+            StateSlot& slot = _stateRing[_activeTriggerTimeIndex % _stateRing.size()];
+            if (slot.index == _activeTriggerTimeIndex && slot.isLoaded) {
+                // Until the new state is decoded, the previous one is still shown
+                _states[0] = std::move(slot.state);
+                slot = StateSlot();
+                _mustLoadNewStateFromDisk = false;
+                _newStateIsReady = true;
+            }
+        }
+    }
+
+    if (_needsUpdate || _newStateIsReady) {
         updateVertexPositionBuffer();
 
         if (_states[_activeStateIndex].nExtraQuantities() > 0) {
@@ -1226,13 +1352,88 @@ void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTi
     }
 }
 
-// Reading state from disk. Must be thread safe!
-void RenderableFieldlinesSequence::readNewState(const std::string& filePath) {
-    _newState = std::make_unique<FieldlinesState>();
-    if (_newState->loadStateFromOsfls(filePath)) {
-        _newStateIsReady = true;
+// Used for 'GPU-resident-states'. The next state is only blended in if its lines are
+// traced from the same seed points as the active one, which is the case if the lines
+// have the same number of vertices
+void RenderableFieldlinesSequence::updateStateBlend(double currentTime) {
+    const size_t nextIdx = _activeStateIndex + 1;
+    if (!_pInterpolateStates || nextIdx >= _nStates ||
+        !_canBlendWithNextState[_activeStateIndex])
+    {
+        _stateBlend = 0.f;
+        return;
+    }
+
+    const double start = _startTimes[_activeStateIndex];
+    const double duration = _startTimes[nextIdx] - start;
+    _stateBlend = static_cast<float>(
+        glm::clamp((currentTime - start) / duration, 0.0, 1.0)
+    );
+}
+
+// Moves the states that the loader thread has decoded since the last frame into the ring
+void RenderableFieldlinesSequence::collectLoadedStates() {
+    while (_stateLoader.numFinishedJobs() > 0) {
+        LoadedState loaded = _stateLoader.popFinishedJob()->product();
+
+        StateSlot& slot = _stateRing[loaded.index % _stateRing.size()];
+        if (slot.index != loaded.index || slot.isLoaded) {
+            // The slot has been reassigned to another state while this one was decoded
+            continue;
+        }
+
+        if (!loaded.isSuccessful) {
+            // The slot stays assigned so that the file isn't requested again every frame
+            LWARNING(fmt::format(
+                "Failed to load state from: {}", _sourceFiles[loaded.index]
+            ));
+            continue;
+        }
+
+        slot.state = std::move(loaded.state);
+        slot.isLoaded = true;
+    }
+}
+
+// Requests the active state and the _nPrefetchedStates following it in the playback
+// direction from the loader thread
+void RenderableFieldlinesSequence::prefetchStates(bool isForward) {
+    const bool isContinuous = (isForward == _isPrefetchingForward) &&
+        (std::abs(_activeTriggerTimeIndex - _prefetchedTriggerTimeIndex) <= 1);
+    if (!isContinuous) {
+        // Time jumped or changed direction, so the queued states will not be needed next
+        _stateLoader.clearEnqueuedJobs();
+        for (StateSlot& slot : _stateRing) {
+            if (!slot.isLoaded) {
+                slot = StateSlot();
+            }
+        }
+    }
+    _isPrefetchingForward = isForward;
+    _prefetchedTriggerTimeIndex = _activeTriggerTimeIndex;
+
+    const int direction = isForward ? 1 : -1;
+    for (int i = 0; i <= _nPrefetchedStates; ++i) {
+        const int index = _activeTriggerTimeIndex + direction * i;
+        if (index < 0 || index >= static_cast<int>(_nStates)) {
+            break;
+        }
+        if (i == 0 && !_mustLoadNewStateFromDisk) {
+            // The active state is already shown
+            continue;
+        }
+
+        StateSlot& slot = _stateRing[index % _stateRing.size()];
+        if (slot.index == index) {
+            continue;
+        }
+        // Reuse the slot, which belongs to a state that is no longer ahead of us
+        slot = StateSlot();
+        slot.index = index;
+        _stateLoader.enqueueJob(
+            std::make_shared<StateLoadJob>(index, _sourceFiles[index])
+        );
     }
-    _isLoadingStateFromDisk = false;
 }
 
 // Unbind buffers and arrays
@@ -1241,21 +1442,140 @@ inline void unbindGL() {
     glBindVertexArray(0);
 }
 
-void RenderableFieldlinesSequence::updateVertexPositionBuffer() {
-    glBindVertexArray(_vertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
-
-    const std::vector<glm::vec3>& vertPos = _states[_activeStateIndex].vertexPositions();
+// Used for 'GPU-resident-states'. Copies the positions of all states, in meters, into a
+// single vertex buffer. The extra quantities are uploaded for the whole sequence when
+// the color and masking quantities are selected, see updateVertexColorBuffer
+void RenderableFieldlinesSequence::uploadResidentStates() {
+    _residentVertexOffsets.clear();
+    _canBlendWithNextState.clear();
+
+    GLint nVertices = 0;
+    for (size_t i = 0; i < _nStates; ++i) {
+        _residentVertexOffsets.push_back(nVertices);
+        nVertices += static_cast<GLint>(_states[i].nVertices());
+
+        const bool hasNext = (i + 1 < _nStates);
+        _canBlendWithNextState.push_back(
+            hasNext && _states[i].lineCount() == _states[i + 1].lineCount()
+        );
+    }
 
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
     glBufferData(
         GL_ARRAY_BUFFER,
-        vertPos.size() * sizeof(glm::vec3),
-        vertPos.data(),
+        nVertices * sizeof(glm::vec3),
+        nullptr,
         GL_STATIC_DRAW
     );
+    for (size_t i = 0; i < _nStates; ++i) {
+        const FieldlinesState& state = _states[i];
+        const bool isRawFloat = state.vertexPositionType() == GL_FLOAT &&
+                                state.vertexPositionScale() == 1.f;
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            _residentVertexOffsets[i] * sizeof(glm::vec3),
+            state.nVertices() * sizeof(glm::vec3),
+            isRawFloat ? state.vertexPositionData() : state.vertexPositions().data()
+        );
+    }
+
+    unbindGL();
+    _shouldUpdateResidentAttributes = true;
+    if (_states[0].nExtraQuantities() > 0) {
+        _shouldUpdateColorBuffer = true;
+        _shouldUpdateMaskingBuffer = true;
+    }
+}
 
+// Used for 'GPU-resident-states'. Points the vertex attributes to the active state and,
+// for the blended positions, to the next state
+void RenderableFieldlinesSequence::updateResidentAttributes() {
+    const GLint offset = _residentVertexOffsets[_activeStateIndex];
+    const GLint nextOffset = _canBlendWithNextState[_activeStateIndex] ?
+        _residentVertexOffsets[_activeStateIndex + 1] :
+        offset;
+
+    glBindVertexArray(_vertexArrayObject);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
     glEnableVertexAttribArray(VaPosition);
-    glVertexAttribPointer(VaPosition, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    glVertexAttribPointer(
+        VaPosition,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        0,
+        reinterpret_cast<const void*>(offset * sizeof(glm::vec3))
+    );
+    glEnableVertexAttribArray(VaNextPosition);
+    glVertexAttribPointer(
+        VaNextPosition,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        0,
+        reinterpret_cast<const void*>(nextOffset * sizeof(glm::vec3))
+    );
+
+    if (_states[_activeStateIndex].nExtraQuantities() > 0) {
+        const void* quantityOffset = reinterpret_cast<const void*>(
+            offset * sizeof(float)
+        );
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
+        glEnableVertexAttribArray(VaColor);
+        glVertexAttribPointer(VaColor, 1, GL_FLOAT, GL_FALSE, 0, quantityOffset);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexMaskingBuffer);
+        glEnableVertexAttribArray(VaMasking);
+        glVertexAttribPointer(VaMasking, 1, GL_FLOAT, GL_FALSE, 0, quantityOffset);
+    }
+
+    unbindGL();
+}
+
+// Used for 'GPU-resident-states'. Uploads the quantity with the provided index of all
+// states into the bound array buffer
+inline void uploadResidentQuantity(const std::vector<FieldlinesState>& states,
+                                   const std::vector<GLint>& offsets, size_t index)
+{
+    const size_t nVertices = offsets.back() + states.back().nVertices();
+    glBufferData(GL_ARRAY_BUFFER, nVertices * sizeof(float), nullptr, GL_STATIC_DRAW);
+    for (size_t i = 0; i < states.size(); ++i) {
+        const float* quantities = states[i].extraQuantityData(index);
+        if (quantities) {
+            glBufferSubData(
+                GL_ARRAY_BUFFER,
+                offsets[i] * sizeof(float),
+                states[i].nVertices() * sizeof(float),
+                quantities
+            );
+        }
+    }
+}
+
+// Uploads data into the bound array buffer. For states loaded from version 1 .osfls
+// files, data points directly into the memory-mapped file. The storage of the buffer is
+// reused if it already has the right size
+inline void uploadArrayBuffer(const void* data, size_t size) {
+    GLint currentSize = 0;
+    glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &currentSize);
+    if (static_cast<size_t>(currentSize) == size) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+    }
+}
+
+void RenderableFieldlinesSequence::updateVertexPositionBuffer() {
+    glBindVertexArray(_vertexArrayObject);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
+
+    const FieldlinesState& state = _states[_activeStateIndex];
+    uploadArrayBuffer(state.vertexPositionData(), state.vertexPositionDataSize());
+
+    glEnableVertexAttribArray(VaPosition);
+    glVertexAttribPointer(VaPosition, 3, state.vertexPositionType(), GL_FALSE, 0, 0);
 
     unbindGL();
 }
@@ -1264,19 +1584,18 @@ void RenderableFieldlinesSequence::updateVertexColorBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
 
-    bool isSuccessful;
-    const std::vector<float>& quantities = _states[_activeStateIndex].extraQuantity(
-        _pColorQuantity,
-        isSuccessful
-    );
+    if (_isGpuResident) {
+        uploadResidentQuantity(_states, _residentVertexOffsets, _pColorQuantity);
+        unbindGL();
+        _shouldUpdateResidentAttributes = true;
+        return;
+    }
 
-    if (isSuccessful) {
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            quantities.size() * sizeof(float),
-            quantities.data(),
-            GL_STATIC_DRAW
-        );
+    const FieldlinesState& state = _states[_activeStateIndex];
+    const float* quantities = state.extraQuantityData(_pColorQuantity);
+
+    if (quantities) {
+        uploadArrayBuffer(quantities, state.nVertices() * sizeof(float));
 
         glEnableVertexAttribArray(VaColor);
         glVertexAttribPointer(VaColor, 1, GL_FLOAT, GL_FALSE, 0, 0);
@@ -1289,19 +1608,18 @@ void RenderableFieldlinesSequence::updateVertexMaskingBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexMaskingBuffer);
 
-    bool isSuccessful;
-    const std::vector<float>& maskings = _states[_activeStateIndex].extraQuantity(
-        _pMaskingQuantity,
-        isSuccessful
-    );
+    if (_isGpuResident) {
+        uploadResidentQuantity(_states, _residentVertexOffsets, _pMaskingQuantity);
+        unbindGL();
+        _shouldUpdateResidentAttributes = true;
+        return;
+    }
 
-    if (isSuccessful) {
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            maskings.size() * sizeof(float),
-            maskings.data(),
-            GL_STATIC_DRAW
-        );
+    const FieldlinesState& state = _states[_activeStateIndex];
+    const float* maskings = state.extraQuantityData(_pMaskingQuantity);
+
+    if (maskings) {
+        uploadArrayBuffer(maskings, state.nVertices() * sizeof(float));
 
         glEnableVertexAttribArray(VaMasking);
         glVertexAttribPointer(VaMasking, 1, GL_FLOAT, GL_FALSE, 0, 0);
@@ -31,11 +31,12 @@
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
-#include <atomic>
+#include <openspace/util/concurrentjobmanager.h>
 
 namespace { enum class SourceFileType; }
 
@@ -53,6 +54,13 @@ public:
     void render(const RenderData& data, RendererTasks& rendererTask) override;
     void update(const UpdateData& data) override;
 
+    // The result of decoding a single .osfls file on the loader thread
+    struct LoadedState {
+        int index = -1;
+        bool isSuccessful = false;
+        FieldlinesState state;
+    };
+
 private:
     // ------------------------------------- ENUMS -------------------------------------//
     // Used to determine if lines should be colored UNIFORMLY or by an extraQuantity
@@ -64,10 +72,17 @@ private:
     // ------------------------------------ STRINGS ------------------------------------//
     std::string _identifier;                               // Name of the Node!
 
+    // ------------------------------------ STRUCTS ------------------------------------//
+    // Used for 'runtime-states'. A slot in the ring of prefetched states. The state with
+    // index i can only be stored in slot i % _stateRing.size()
+    struct StateSlot {
+        // Index of the state that is loaded or being loaded into this slot, -1 if empty
+        int index = -1;
+        bool isLoaded = false;
+        FieldlinesState state;
+    };
+
     // ------------------------------------- FLAGS -------------------------------------//
-    // Used for 'runtime-states'. True when loading a new state from disk on another
-    // thread.
-    std::atomic_bool _isLoadingStateFromDisk = false;
     // False => states are stored in RAM (using 'in-RAM-states'), True => states are
     // loaded from disk during runtime (using 'runtime-states')
     bool _loadingStatesDynamically  = false;
@@ -77,14 +92,25 @@ private:
     // Used for 'in-RAM-states' : True if new 'in-RAM-state'  must be loaded.
     // False => the previous frame's state should still be shown
     bool _needsUpdate = false;
-    // Used for 'runtime-states'. True when finished loading a new state from disk on
-    // another thread.
-    std::atomic_bool _newStateIsReady = false;
+    // Used for 'runtime-states'. True when the state of the active trigger time has
+    // been moved into _states[0] and its buffers have to be updated
+    bool _newStateIsReady = false;
+    // Used for 'runtime-states'. The playback direction of the last prefetch request
+    bool _isPrefetchingForward = true;
     // True when new state is loaded or user change which quantity to color the lines by
     bool _shouldUpdateColorBuffer   = false;
     // True when new state is loaded or user change which quantity used for masking out
     // line segments
     bool _shouldUpdateMaskingBuffer = false;
+    // True if the .osfls files written to the output folder should store half float
+    // vertex positions
+    bool _saveHalfFloatPositions = false;
+    // Used for 'in-RAM-states'. True if all states are uploaded to the GPU once, after
+    // which changing the active state only moves the vertex attribute offsets
+    bool _isGpuResident = false;
+    // Used for 'GPU-resident-states'. True when the vertex attributes have to point to
+    // another pair of states
+    bool _shouldUpdateResidentAttributes = false;
 
     // --------------------------------- NUMERICALS ----------------------------------- //
     // Active index of _states. If(==-1)=>no state available for current time. Always the
@@ -95,11 +121,19 @@ private:
     int _activeTriggerTimeIndex = -1;
     // Number of states in the sequence
     size_t _nStates = 0;
+    // Used for 'runtime-states'. Number of states following the active one in the
+    // playback direction that are decoded ahead of time
+    int _nPrefetchedStates = 3;
+    // Used for 'runtime-states'. The trigger time index of the last prefetch request
+    int _prefetchedTriggerTimeIndex = -1;
     // In setup it is used to scale JSON coordinates. During runtime it is used to scale
     // domain limits.
     float _scalingFactor = 1.f;
     // Estimated end of sequence.
     double _sequenceEndTime;
+    // Used for 'GPU-resident-states'. How far, in [0,1], the current time has progressed
+    // from the active state towards the next one
+    float _stateBlend = 0.f;
     // OpenGL Vertex Array Object
     GLuint _vertexArrayObject = 0;
     // OpenGL Vertex Buffer Object containing the extraQuantity values used for coloring
@@ -114,8 +148,6 @@ private:
     // ----------------------------------- POINTERS ------------------------------------//
     // The Lua-Modfile-Dictionary used during initialization
     std::unique_ptr<ghoul::Dictionary> _dictionary;
-    // Used for 'runtime-states' when switching out current state to a new state
-    std::unique_ptr<FieldlinesState> _newState;
     std::unique_ptr<ghoul::opengl::ProgramObject> _shaderProgram;
     // Transfer function used to color lines when _pColorMethod is set to BY_QUANTITY
     std::unique_ptr<TransferFunction> _transferFunction;
@@ -134,6 +166,14 @@ private:
     std::vector<double> _startTimes;
     // Stores the FieldlineStates
     std::vector<FieldlinesState> _states;
+    // Used for 'runtime-states'. The ring of prefetched states, filled by _stateLoader
+    std::vector<StateSlot> _stateRing;
+    // Used for 'GPU-resident-states'. Index of the first vertex of each state in the
+    // vertex buffers
+    std::vector<GLint> _residentVertexOffsets;
+    // Used for 'GPU-resident-states'. True if the state consists of the same lines as
+    // the next one, so that the vertices can be blended one to one
+    std::vector<bool> _canBlendWithNextState;
 
     // ---------------------------------- Properties ---------------------------------- //
     // Group to hold the color properties
@@ -196,6 +236,11 @@ private:
     properties::TriggerProperty _pFocusOnOriginBtn;
     // Button which executes a time jump to start of sequence
     properties::TriggerProperty _pJumpToStartBtn;
+    // Whether or not to blend between consecutive 'GPU-resident-states'
+    properties::BoolProperty _pInterpolateStates;
+
+    // Used for 'runtime-states'. Decodes the .osfls files on a persistent thread
+    ConcurrentJobManager<LoadedState> _stateLoader;
 
     // --------------------- FUNCTIONS USED DURING INITIALIZATION --------------------- //
     void addStateToSequence(FieldlinesState& STATE);
@@ -218,10 +263,14 @@ private:
     void setModelDependentConstants();
     void setupProperties();
     bool prepareForOsflsStreaming();
+    void uploadResidentStates();
 
     // ------------------------- FUNCTIONS USED DURING RUNTIME ------------------------ //
-    void readNewState(const std::string& filePath);
+    void collectLoadedStates();
+    void prefetchStates(bool isForward);
     void updateActiveTriggerTimeIndex(double currentTime);
+    void updateResidentAttributes();
+    void updateStateBlend(double currentTime);
     void updateVertexPositionBuffer();
     void updateVertexColorBuffer();
     void updateVertexMaskingBuffer();
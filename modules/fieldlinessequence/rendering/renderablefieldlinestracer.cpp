@@ -0,0 +1,518 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/fieldlinessequence/rendering/renderablefieldlinestracer.h>
+
+#include <modules/fieldlinessequence/util/commons.h>
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/filesystem/file.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/shaderobject.h>
+#include <ghoul/opengl/texture.h>
+#include <ghoul/opengl/textureunit.h>
+
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+#include <modules/kameleon/include/kameleonwrapper.h>
+#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
+
+namespace {
+    constexpr const char* _loggerCat = "RenderableFieldlinesTracer";
+
+    constexpr const GLuint VaPosition = 0; // MUST CORRESPOND TO THE SHADER PROGRAM
+    // Must correspond to the local_size_x of fieldlinestracer_cs.glsl
+    constexpr const int WorkGroupSize = 64;
+
+    constexpr const char* KeySourceFile = "SourceFile";
+    constexpr const char* KeyTracingVariable = "TracingVariable";
+    constexpr const char* KeyDimensions = "Dimensions";
+    constexpr const char* KeySeedRegionCenter = "SeedRegionCenter";
+    constexpr const char* KeySeedRegionSize = "SeedRegionSize";
+    constexpr const char* KeyNumberOfLines = "NumberOfLines";
+    constexpr const char* KeyMaxSteps = "MaxSteps";
+    constexpr const char* KeyStepSize = "StepSize";
+    constexpr const char* KeyTolerance = "Tolerance";
+    constexpr const char* KeyColor = "Color";
+
+    constexpr openspace::properties::Property::PropertyInfo SourceFileInfo = {
+        "SourceFile",
+        "Source File",
+        "The CDF file that contains the vector field that the lines are traced through."
+    };
+    constexpr openspace::properties::Property::PropertyInfo TracingVariableInfo = {
+        "TracingVariable",
+        "Tracing Variable",
+        "The vector quantity that the lines follow, for example 'b' for magnetic field "
+        "lines or 'u' for velocity flow lines. The components are read from the "
+        "variables with the suffixes 'x', 'y', and 'z'."
+    };
+    constexpr openspace::properties::Property::PropertyInfo DimensionsInfo = {
+        "Dimensions",
+        "Dimensions",
+        "The number of samples along each axis of the grid that the vector field is "
+        "resampled to before it is uploaded to the GPU."
+    };
+    constexpr openspace::properties::Property::PropertyInfo SeedRegionCenterInfo = {
+        "SeedRegionCenter",
+        "Seed Region Center",
+        "The center of the box that the seed points are spread in, in the units of the "
+        "source file."
+    };
+    constexpr openspace::properties::Property::PropertyInfo SeedRegionSizeInfo = {
+        "SeedRegionSize",
+        "Seed Region Size",
+        "The extent of the box that the seed points are spread in, in the units of the "
+        "source file."
+    };
+    constexpr openspace::properties::Property::PropertyInfo NumberOfLinesInfo = {
+        "NumberOfLines",
+        "Number of Lines",
+        "The number of seed points that lines are traced from. Each line reserves "
+        "memory for 2 * MaxSteps + 1 vertices on the GPU."
+    };
+    constexpr openspace::properties::Property::PropertyInfo MaxStepsInfo = {
+        "MaxSteps",
+        "Max Steps",
+        "The maximum number of steps that each line is traced in each direction from "
+        "its seed point."
+    };
+    constexpr openspace::properties::Property::PropertyInfo StepSizeInfo = {
+        "StepSize",
+        "Step Size",
+        "The initial length of each tracing step, in the units of the source file. The "
+        "steps are adapted to the curvature of the field, between 1/64 and 8 times this "
+        "length."
+    };
+    constexpr openspace::properties::Property::PropertyInfo ToleranceInfo = {
+        "Tolerance",
+        "Tolerance",
+        "The largest error of a single tracing step that is accepted, in the units of "
+        "the source file. Smaller values make the steps shorter in strongly curved "
+        "regions of the field."
+    };
+    constexpr openspace::properties::Property::PropertyInfo ColorInfo = {
+        "Color",
+        "Color",
+        "The color of the lines."
+    };
+} // namespace
+
+namespace openspace {
+
+RenderableFieldlinesTracer::RenderableFieldlinesTracer(
+                                                      const ghoul::Dictionary& dictionary)
+    : Renderable(dictionary)
+    , _sourcePath(SourceFileInfo)
+    , _tracingVariable(TracingVariableInfo, "b")
+    , _dimensions(
+        DimensionsInfo,
+        glm::uvec3(64),
+        glm::uvec3(8),
+        glm::uvec3(512)
+    )
+    , _seedRegionCenter(
+        SeedRegionCenterInfo,
+        glm::vec3(0.f),
+        glm::vec3(-1000.f),
+        glm::vec3(1000.f)
+    )
+    , _seedRegionSize(
+        SeedRegionSizeInfo,
+        glm::vec3(10.f),
+        glm::vec3(0.f),
+        glm::vec3(1000.f)
+    )
+    , _nLines(NumberOfLinesInfo, 2000, 1, 20000)
+    , _maxSteps(MaxStepsInfo, 250, 1, 2000)
+    , _stepSize(StepSizeInfo, 0.1f, 0.001f, 10.f)
+    , _tolerance(ToleranceInfo, 0.001f, 0.000001f, 1.f)
+    , _lineColor(
+        ColorInfo,
+        glm::vec4(0.75f, 0.5f, 0.0f, 0.5f),
+        glm::vec4(0.f),
+        glm::vec4(1.f)
+    )
+{
+    if (dictionary.hasKeyAndValue<std::string>(KeySourceFile)) {
+        _sourcePath = absPath(dictionary.value<std::string>(KeySourceFile));
+    }
+    else {
+        LERROR(fmt::format("{} must be specified", KeySourceFile));
+    }
+
+    if (dictionary.hasKeyAndValue<std::string>(KeyTracingVariable)) {
+        _tracingVariable = dictionary.value<std::string>(KeyTracingVariable);
+    }
+
+    if (dictionary.hasKeyAndValue<glm::vec3>(KeyDimensions)) {
+        _dimensions = dictionary.value<glm::vec3>(KeyDimensions);
+    }
+
+    if (dictionary.hasKeyAndValue<glm::vec3>(KeySeedRegionCenter)) {
+        _seedRegionCenter = dictionary.value<glm::vec3>(KeySeedRegionCenter);
+    }
+
+    if (dictionary.hasKeyAndValue<glm::vec3>(KeySeedRegionSize)) {
+        _seedRegionSize = dictionary.value<glm::vec3>(KeySeedRegionSize);
+    }
+
+    if (dictionary.hasKeyAndValue<double>(KeyNumberOfLines)) {
+        _nLines = static_cast<int>(dictionary.value<double>(KeyNumberOfLines));
+    }
+
+    if (dictionary.hasKeyAndValue<double>(KeyMaxSteps)) {
+        _maxSteps = static_cast<int>(dictionary.value<double>(KeyMaxSteps));
+    }
+
+    if (dictionary.hasKeyAndValue<double>(KeyStepSize)) {
+        _stepSize = static_cast<float>(dictionary.value<double>(KeyStepSize));
+    }
+
+    if (dictionary.hasKeyAndValue<double>(KeyTolerance)) {
+        _tolerance = static_cast<float>(dictionary.value<double>(KeyTolerance));
+    }
+
+    if (dictionary.hasKeyAndValue<glm::vec4>(KeyColor)) {
+        _lineColor = dictionary.value<glm::vec4>(KeyColor);
+    }
+
+    // Changing the seeding only requires a new dispatch, which is cheap enough to be done
+    // every frame while a property is dragged
+    auto retrace = [this]() { _shouldTrace = true; };
+    _seedRegionCenter.onChange(retrace);
+    _seedRegionSize.onChange(retrace);
+    _nLines.onChange(retrace);
+    _maxSteps.onChange(retrace);
+    _stepSize.onChange(retrace);
+    _tolerance.onChange(retrace);
+
+    // The first field is loaded in initializeGL
+    auto reload = [this]() {
+        if (_program) {
+            loadField();
+        }
+    };
+    _sourcePath.onChange(reload);
+    _tracingVariable.onChange(reload);
+    _dimensions.onChange(reload);
+
+    addProperty(_sourcePath);
+    addProperty(_tracingVariable);
+    addProperty(_dimensions);
+    addProperty(_seedRegionCenter);
+    addProperty(_seedRegionSize);
+    addProperty(_nLines);
+    addProperty(_maxSteps);
+    addProperty(_stepSize);
+    addProperty(_tolerance);
+    _lineColor.setViewOption(properties::Property::ViewOptions::Color);
+    addProperty(_lineColor);
+}
+
+void RenderableFieldlinesTracer::initializeGL() {
+    _program = global::renderEngine.buildRenderProgram(
+        "FieldlinesTracer",
+        absPath("${MODULE_FIELDLINESSEQUENCE}/shaders/fieldlinestracer_vs.glsl"),
+        absPath("${MODULE_FIELDLINESSEQUENCE}/shaders/fieldlinessequence_fs.glsl")
+    );
+
+    _tracerProgram = std::make_unique<ghoul::opengl::ProgramObject>(
+        "FieldlinesTracerCompute"
+    );
+    _tracerProgram->attachObject(std::make_shared<ghoul::opengl::ShaderObject>(
+        ghoul::opengl::ShaderObject::ShaderType::Compute,
+        absPath("${MODULE_FIELDLINESSEQUENCE}/shaders/fieldlinestracer_cs.glsl"),
+        "FieldlinesTracerCompute"
+    ));
+    _tracerProgram->compileShaderObjects();
+    _tracerProgram->linkProgramObject();
+
+    glGenVertexArrays(1, &_vertexArrayObject);
+    glGenBuffers(1, &_vertexBuffer);
+    glGenBuffers(1, &_commandBuffer);
+
+    // The attribute only refers to the buffer object, so it stays valid when the buffer
+    // is reallocated for a different number of lines
+    glBindVertexArray(_vertexArrayObject);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glEnableVertexAttribArray(VaPosition);
+    glVertexAttribPointer(VaPosition, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    loadField();
+}
+
+void RenderableFieldlinesTracer::deinitializeGL() {
+    _loadingHandle.cancel();
+
+    glDeleteVertexArrays(1, &_vertexArrayObject);
+    _vertexArrayObject = 0;
+
+    glDeleteBuffers(1, &_vertexBuffer);
+    _vertexBuffer = 0;
+
+    glDeleteBuffers(1, &_commandBuffer);
+    _commandBuffer = 0;
+
+    _allocatedLines = 0;
+    _allocatedSteps = 0;
+    _fieldTexture = nullptr;
+    _tracerProgram = nullptr;
+
+    if (_program) {
+        global::renderEngine.removeRenderProgram(_program.get());
+        _program = nullptr;
+    }
+}
+
+bool RenderableFieldlinesTracer::isReady() const {
+    return _program && _tracerProgram;
+}
+
+void RenderableFieldlinesTracer::render(const RenderData& data, RendererTasks&) {
+    if (!_fieldTexture || _allocatedLines == 0) {
+        return;
+    }
+
+    _program->activate();
+
+    const glm::dmat4 modelMat =
+        glm::translate(glm::dmat4(1.0), data.modelTransform.translation) *
+        glm::dmat4(data.modelTransform.rotation) *
+        glm::dmat4(glm::scale(glm::dmat4(1), glm::dvec3(data.modelTransform.scale)));
+    const glm::dmat4 modelViewMat = data.camera.combinedViewMatrix() * modelMat;
+
+    _program->setUniform(
+        "modelViewProjection",
+        data.camera.sgctInternal.projectionMatrix() * glm::mat4(modelViewMat)
+    );
+    _program->setUniform("positionScale", _scaleToMeters);
+    _program->setUniform("lineColor", _lineColor);
+    _program->setUniform("usingAdditiveBlending", false);
+
+    glBindVertexArray(_vertexArrayObject);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer);
+    glMultiDrawArraysIndirect(GL_LINE_STRIP, nullptr, _allocatedLines, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+
+    _program->deactivate();
+}
+
+void RenderableFieldlinesTracer::update(const UpdateData&) {
+    if (_program->isDirty()) {
+        _program->rebuildFromFile();
+    }
+
+    if (_tracerProgram->isDirty()) {
+        _tracerProgram->rebuildFromFile();
+        _shouldTrace = true;
+    }
+
+    if (_shouldTrace && _fieldTexture) {
+        traceLines();
+        _shouldTrace = false;
+    }
+}
+
+void RenderableFieldlinesTracer::loadField() {
+    // A field that is still being sampled would replace the new one when it is done
+    _loadingHandle.cancel();
+
+    if (!FileSys.fileExists(ghoul::filesystem::File(_sourcePath))) {
+        LERROR(fmt::format("File '{}' does not exist", _sourcePath.value()));
+        return;
+    }
+
+    std::function<SampledField()> decode =
+        [path = _sourcePath.value(), variable = _tracingVariable.value(),
+         dimensions = _dimensions.value()]()
+        {
+            return sampleField(path, variable, dimensions);
+        };
+    std::function<void(SampledField&)> ready = [this](SampledField& field) {
+        applyField(field);
+    };
+
+    _loadingHandle = global::resourceLoader.load(
+        std::move(decode),
+        std::function<bool(SampledField&)>(),
+        std::move(ready)
+    );
+}
+
+void RenderableFieldlinesTracer::applyField(SampledField& field) {
+    if (field.vectors.empty()) {
+        // The error has already been logged while sampling
+        return;
+    }
+
+    _fieldTexture = std::make_unique<ghoul::opengl::Texture>(
+        field.dimensions,
+        ghoul::opengl::Texture::Format::RGBA,
+        GL_RGBA32F,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::ClampToEdge
+    );
+    _fieldTexture->setPixelData(
+        reinterpret_cast<void*>(field.vectors.data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    _fieldTexture->uploadTexture();
+    // The texture keeps its own copy on the GPU
+    _fieldTexture->setPixelData(nullptr, ghoul::opengl::Texture::TakeOwnership::No);
+
+    _domainMin = field.domainMin;
+    _domainMax = field.domainMax;
+    _innerBoundary = field.innerBoundary;
+    _scaleToMeters = field.scaleToMeters;
+    _shouldTrace = true;
+}
+
+void RenderableFieldlinesTracer::allocateLineBuffers() {
+    if (_nLines == _allocatedLines && _maxSteps == _allocatedSteps) {
+        return;
+    }
+
+    const GLsizeiptr nVertices = static_cast<GLsizeiptr>(_nLines) * (2 * _maxSteps + 1);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        nVertices * sizeof(glm::vec4),
+        nullptr,
+        GL_DYNAMIC_COPY
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // count, instanceCount, first, baseInstance
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer);
+    glBufferData(
+        GL_DRAW_INDIRECT_BUFFER,
+        _nLines * 4 * sizeof(GLuint),
+        nullptr,
+        GL_DYNAMIC_COPY
+    );
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    _allocatedLines = _nLines;
+    _allocatedSteps = _maxSteps;
+}
+
+void RenderableFieldlinesTracer::traceLines() {
+    allocateLineBuffers();
+
+    _tracerProgram->activate();
+
+    ghoul::opengl::TextureUnit unit;
+    unit.activate();
+    _fieldTexture->bind();
+    _tracerProgram->setUniform("field", unit);
+    _tracerProgram->setUniform("domainMin", _domainMin);
+    _tracerProgram->setUniform("domainMax", _domainMax);
+    _tracerProgram->setUniform(
+        "texelOffset",
+        0.5f / glm::vec3(_fieldTexture->dimensions())
+    );
+    _tracerProgram->setUniform("innerBoundary", _innerBoundary);
+    _tracerProgram->setUniform("seedRegionCenter", _seedRegionCenter);
+    _tracerProgram->setUniform("seedRegionSize", _seedRegionSize);
+    _tracerProgram->setUniform("nLines", _allocatedLines);
+    _tracerProgram->setUniform("maxSteps", _allocatedSteps);
+    _tracerProgram->setUniform("stepSize", _stepSize);
+    _tracerProgram->setUniform("tolerance", _tolerance);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _vertexBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _commandBuffer);
+
+    const GLuint nGroups = static_cast<GLuint>(
+        (_allocatedLines + WorkGroupSize - 1) / WorkGroupSize
+    );
+    glDispatchCompute(nGroups, 1, 1);
+
+    // The lines are read as vertices and draw commands by the next render call
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+
+    _tracerProgram->deactivate();
+}
+
+RenderableFieldlinesTracer::SampledField RenderableFieldlinesTracer::sampleField(
+                                                            const std::string& sourcePath,
+                                                              const std::string& variable,
+                                                          const glm::uvec3& dimensions)
+{
+    SampledField field;
+
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+    KameleonWrapper kameleon(sourcePath);
+    if (kameleon.gridType() != KameleonWrapper::GridType::Cartesian) {
+        LERROR(fmt::format(
+            "Can't trace lines in '{}'. Only cartesian grids are supported", sourcePath
+        ));
+        return field;
+    }
+
+    // The tracing only needs the direction of the field, so the components must not be
+    // normalized independently of each other
+    float* data = kameleon.uniformSampledVectorValues(
+        variable + "x",
+        variable + "y",
+        variable + "z",
+        glm::size3_t(dimensions),
+        KameleonWrapper::ProgressCallback(),
+        false
+    );
+    const size_t nValues = 4 * static_cast<size_t>(dimensions.x) * dimensions.y *
+                           dimensions.z;
+    field.vectors.assign(data, data + nValues);
+    delete[] data;
+
+    field.dimensions = dimensions;
+    field.domainMin = kameleon.gridMin();
+    field.domainMax = kameleon.gridMax();
+
+    if (kameleon.model() == KameleonWrapper::Model::BATSRUS) {
+        // BATSRUS grids are in Earth radii and the lines end at the Earth's surface
+        field.innerBoundary = 1.f;
+        field.scaleToMeters = fls::ReToMeter;
+    }
+#else // OPENSPACE_MODULE_KAMELEON_ENABLED
+    (void)variable;
+    (void)dimensions;
+    LERROR(fmt::format(
+        "Can't sample field from '{}'. The Kameleon module is not enabled", sourcePath
+    ));
+#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
+
+    return field;
+}
+
+} // namespace openspace
@@ -0,0 +1,130 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___RENDERABLEFIELDLINESTRACER___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___RENDERABLEFIELDLINESTRACER___H__
+
+#include <openspace/rendering/renderable.h>
+
+#include <openspace/properties/stringproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/properties/vector/uvec3property.h>
+#include <openspace/properties/vector/vec3property.h>
+#include <openspace/properties/vector/vec4property.h>
+#include <openspace/util/resourceloader.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <memory>
+#include <vector>
+
+namespace ghoul::opengl {
+    class ProgramObject;
+    class Texture;
+} // namespace ghoul::opengl
+
+namespace openspace {
+
+/**
+ * Traces field lines through a vector field that is sampled from a CDF file on a uniform
+ * grid. The tracing is done in a compute shader that writes the lines directly into the
+ * vertex buffer they are rendered from, which makes it fast enough to retrace thousands
+ * of lines every time the seed region is changed.
+ */
+class RenderableFieldlinesTracer : public Renderable {
+public:
+    RenderableFieldlinesTracer(const ghoul::Dictionary& dictionary);
+
+    void initializeGL() override;
+    void deinitializeGL() override;
+
+    bool isReady() const override;
+
+    void render(const RenderData& data, RendererTasks& rendererTask) override;
+    void update(const UpdateData& data) override;
+
+private:
+    /// The vector field resampled from a source file
+    struct SampledField {
+        /// Four floats per sample, the last of which is unused
+        std::vector<float> vectors;
+        glm::uvec3 dimensions;
+        /// The extent of the field in the units of the source file
+        glm::vec3 domainMin;
+        glm::vec3 domainMax;
+        /// Lines are stopped when they are closer than this to the origin
+        float innerBoundary = 0.f;
+        /// Converts the units of the source file to meters
+        float scaleToMeters = 1.f;
+    };
+
+    /// Starts resampling the field on a worker thread with the current properties
+    void loadField();
+    /// Uploads the \p field into the 3D texture that the lines are traced through
+    void applyField(SampledField& field);
+    /// (Re)allocates the vertex and command buffers if the number of lines or steps
+    /// has changed
+    void allocateLineBuffers();
+    /// Dispatches the compute shader that traces all lines into the vertex buffer
+    void traceLines();
+
+    static SampledField sampleField(const std::string& sourcePath,
+        const std::string& variable, const glm::uvec3& dimensions);
+
+    properties::StringProperty _sourcePath;
+    properties::StringProperty _tracingVariable;
+    properties::UVec3Property _dimensions;
+    properties::Vec3Property _seedRegionCenter;
+    properties::Vec3Property _seedRegionSize;
+    properties::IntProperty _nLines;
+    properties::IntProperty _maxSteps;
+    properties::FloatProperty _stepSize;
+    properties::FloatProperty _tolerance;
+    properties::Vec4Property _lineColor;
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _tracerProgram;
+    std::unique_ptr<ghoul::opengl::ProgramObject> _program;
+    std::unique_ptr<ghoul::opengl::Texture> _fieldTexture;
+    ResourceLoader::Handle _loadingHandle;
+
+    glm::vec3 _domainMin = glm::vec3(0.f);
+    glm::vec3 _domainMax = glm::vec3(0.f);
+    float _innerBoundary = 0.f;
+    float _scaleToMeters = 1.f;
+
+    GLuint _vertexArrayObject = 0;
+    // Written by the compute shader as a shader storage buffer and then read as the
+    // vertex buffer
+    GLuint _vertexBuffer = 0;
+    // One DrawArraysIndirectCommand per line
+    GLuint _commandBuffer = 0;
+    int _allocatedLines = 0;
+    int _allocatedSteps = 0;
+
+    // Set whenever a property changes that affects the traced lines
+    bool _shouldTrace = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___RENDERABLEFIELDLINESTRACER___H__
@@ -27,6 +27,10 @@
 // General Uniforms that's always needed
 uniform vec4      lineColor;
 uniform mat4      modelViewProjection;
+// Scales the (possibly half float) positions to meters
+uniform float     positionScale;
+// Blends from the active state towards the next one. 0 if the states are not GPU resident
+uniform float     stateBlend;
 
 // Uniforms needed to color by quantity
 uniform int       colorMethod;
@@ -53,9 +57,10 @@ uniform vec2      domainLimZ;
 uniform vec2      domainLimR;
 
 // Inputs
-layout(location = 0) in vec3 in_position;        // Should be provided in meters
+layout(location = 0) in vec3 in_position;        // In meters after multiplying by positionScale
 layout(location = 1) in float in_color_scalar;   // The extra value used to color lines. Location must correspond to _VA_COLOR in renderablefieldlinessequence.h
 layout(location = 2) in float in_masking_scalar; // The extra value used to mask out parts of lines. Location must correspond to _VA_MASKING in renderablefieldlinessequence.h
+layout(location = 3) in vec3 in_next_position;   // The same vertex in the next state. Location must correspond to VaNextPosition in renderablefieldlinessequence.cpp
 
 // These should correspond to the enum 'ColorMethod' in renderablefieldlinesequence.cpp
 const int uniformColor     = 0;
@@ -79,6 +84,7 @@ bool isPartOfParticle(const double time, const int vertexId, const int particleS
 }
 
 void main() {
+    vec3 position = mix(in_position, in_next_position, stateBlend) * positionScale;
 
     bool hasColor = true;
 
@@ -88,11 +94,11 @@ void main() {
     }
 
     if (usingDomain && hasColor) {
-        float radius = length(in_position);
+        float radius = length(position);
 
-        if (in_position.x < domainLimX.x || in_position.x > domainLimX.y ||
-            in_position.y < domainLimY.x || in_position.y > domainLimY.y ||
-            in_position.z < domainLimZ.x || in_position.z > domainLimZ.y ||
+        if (position.x < domainLimX.x || position.x > domainLimX.y ||
+            position.y < domainLimY.x || position.y > domainLimY.y ||
+            position.z < domainLimZ.x || position.z > domainLimZ.y ||
             radius        < domainLimR.x || radius        > domainLimR.y) {
 
             hasColor = false;
@@ -119,7 +125,7 @@ void main() {
         vs_color = vec4(0);
     }
 
-    vec4 position_in_meters = vec4(in_position, 1);
+    vec4 position_in_meters = vec4(position, 1);
     vec4 positionClipSpace = modelViewProjection * position_in_meters;
     //vs_gPosition = vec4(modelViewTransform * dvec4(in_point_position, 1));
     gl_Position = vec4(positionClipSpace.xy, 0, positionClipSpace.w);
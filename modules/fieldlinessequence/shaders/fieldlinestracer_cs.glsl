@@ -0,0 +1,163 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#version __CONTEXT__
+
+layout(local_size_x = 64) in;
+
+// Must correspond to the layout of the draw indirect buffer in
+// renderablefieldlinestracer.cpp
+struct DrawArraysCommand {
+    uint count;
+    uint instanceCount;
+    uint first;
+    uint baseInstance;
+};
+
+// Each line owns 2 * maxSteps + 1 vertices. The seed point is stored in the middle, the
+// points traced backwards before and the points traced forwards after it
+layout(std430, binding = 0) writeonly buffer LineVertices {
+    vec4 vertices[];
+};
+
+layout(std430, binding = 1) writeonly buffer LineCommands {
+    DrawArraysCommand commands[];
+};
+
+uniform sampler3D field;
+uniform vec3 domainMin;
+uniform vec3 domainMax;
+// Half a texel, as the samples of the field lie at the lower corner of each grid cell
+uniform vec3 texelOffset;
+uniform float innerBoundary;
+
+uniform vec3 seedRegionCenter;
+uniform vec3 seedRegionSize;
+uniform int nLines;
+uniform int maxSteps;
+uniform float stepSize;
+uniform float tolerance;
+
+// The largest and smallest step that the adaptive integration may take, relative to
+// the stepSize
+const float MaxStepFactor = 8.0;
+const float MinStepFactor = 1.0 / 64.0;
+const int MaxRetries = 8;
+
+bool isInsideDomain(vec3 p) {
+    return all(greaterThanEqual(p, domainMin)) && all(lessThanEqual(p, domainMax)) &&
+           length(p) > innerBoundary;
+}
+
+// Returns the direction of the field at p, or a zero vector where the field vanishes
+vec3 fieldDirection(vec3 p) {
+    vec3 uvw = (p - domainMin) / (domainMax - domainMin) + texelOffset;
+    vec3 v = texture(field, uvw).xyz;
+    float l = length(v);
+    return (l > 0.0) ? v / l : vec3(0.0);
+}
+
+vec3 rungeKutta4(vec3 p, float h) {
+    vec3 k1 = fieldDirection(p);
+    vec3 k2 = fieldDirection(p + 0.5 * h * k1);
+    vec3 k3 = fieldDirection(p + 0.5 * h * k2);
+    vec3 k4 = fieldDirection(p + h * k3);
+    return p + h / 6.0 * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+}
+
+// Points of the low-discrepancy R3 sequence are spread evenly in the unit cube, and the
+// first n points stay the same when n changes, so lines don't jump around while the
+// number of lines or the seed region is changed
+vec3 seedPoint(uint index) {
+    const uvec3 Alpha = uvec3(3518319154u, 2882110344u, 2360945575u);
+    uvec3 r = Alpha * (index + 1u) + uvec3(2147483648u);
+    vec3 unit = vec3(r) / 4294967296.0;
+    return seedRegionCenter + (unit - 0.5) * seedRegionSize;
+}
+
+// Traces from p in the direction given by the sign of 'direction' and writes each point
+// at 'first' + i * 'direction'. Returns the number of points that were written
+int trace(vec3 p, float direction, uint first) {
+    float h = stepSize;
+    int nPoints = 0;
+    while (nPoints < maxSteps) {
+        // Step doubling: the difference between one full step and two half steps
+        // estimates the error of the step
+        vec3 next;
+        for (int retry = 0; retry <= MaxRetries; ++retry) {
+            vec3 full = rungeKutta4(p, direction * h);
+            next = rungeKutta4(rungeKutta4(p, 0.5 * direction * h), 0.5 * direction * h);
+            float error = length(next - full);
+
+            float factor = (error > 0.0) ? 0.9 * pow(tolerance / error, 0.2) : 5.0;
+            float newH = clamp(
+                h * clamp(factor, 0.2, 5.0),
+                stepSize * MinStepFactor,
+                stepSize * MaxStepFactor
+            );
+
+            bool isAccepted = error <= tolerance || h <= stepSize * MinStepFactor;
+            h = newH;
+            if (isAccepted) {
+                break;
+            }
+        }
+
+        if (!isInsideDomain(next) || next == p) {
+            break;
+        }
+        p = next;
+        ++nPoints;
+        vertices[int(first) + int(direction) * nPoints] = vec4(p, 1.0);
+    }
+    return nPoints;
+}
+
+void main() {
+    uint line = gl_GlobalInvocationID.x;
+    if (line >= uint(nLines)) {
+        return;
+    }
+
+    uint base = line * uint(2 * maxSteps + 1);
+    uint seedIndex = base + uint(maxSteps);
+    vec3 seed = seedPoint(line);
+
+    if (!isInsideDomain(seed)) {
+        commands[line] = DrawArraysCommand(0u, 1u, seedIndex, 0u);
+        return;
+    }
+
+    vertices[seedIndex] = vec4(seed, 1.0);
+    int nBackward = trace(seed, -1.0, seedIndex);
+    int nForward = trace(seed, 1.0, seedIndex);
+
+    commands[line] = DrawArraysCommand(
+        uint(nBackward + nForward + 1),
+        1u,
+        seedIndex - uint(nBackward),
+        0u
+    );
+}
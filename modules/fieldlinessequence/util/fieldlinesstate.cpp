@@ -28,12 +28,121 @@
 #include <openspace/util/time.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtx/component_wise.hpp>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
 namespace {
     constexpr const char* _loggerCat = "FieldlinesState";
-    constexpr const int CurrentVersion = 0;
+    constexpr const int CurrentVersion = 1;
     using json = nlohmann::json;
+
+    // All data sections of a version 1 file start at a multiple of this many bytes, so
+    // that they can be used directly from the memory-mapped file
+    constexpr const uint64_t SectionAlignment = 64;
+
+    enum class PositionFormat : uint8_t {
+        Float = 0,
+        HalfFloat = 1
+    };
+
+    // The header of a version 1 .osfls file. The version is stored at the same location
+    // as in version 0 files
+    struct OsflsHeader {
+        int32_t version;
+        int32_t model;
+        double triggerTime;
+        uint8_t isMorphable;
+        PositionFormat positionFormat;
+        uint8_t padding[2];
+        // The stored positions multiplied by this factor are the positions in meters
+        float positionScale;
+        uint64_t nLines;
+        uint64_t nPoints;
+        uint64_t nExtras;
+        uint64_t byteSizeAllNames;
+        // Byte offsets of the sections from the beginning of the file
+        uint64_t lineStartOffset;
+        uint64_t lineCountOffset;
+        uint64_t positionOffset;
+        // nExtras contiguous arrays of nPoints floats
+        uint64_t extraQuantityOffset;
+        uint64_t namesOffset;
+    };
+    static_assert(sizeof(OsflsHeader) == 96, "Unexpected padding in OsflsHeader");
+
+    uint64_t alignedOffset(uint64_t offset) {
+        return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+    }
+
+    // Maps the whole file into memory, read-only. The file is unmapped when the last
+    // copy of the returned pointer is destroyed
+    std::shared_ptr<const char> mapFile(const std::string& path, size_t& size) {
+#ifdef WIN32
+        HANDLE file = CreateFileA(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        // The view keeps references to the mapping and the file
+        CloseHandle(file);
+        if (!mapping) {
+            return nullptr;
+        }
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!data) {
+            return nullptr;
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        return std::shared_ptr<const char>(
+            reinterpret_cast<const char*>(data),
+            [](const char* p) { UnmapViewOfFile(p); }
+        );
+#else // WIN32
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file == -1) {
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(file, &info) == -1 || info.st_size == 0) {
+            close(file);
+            return nullptr;
+        }
+        void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+        // The mapping keeps a reference to the file, so the descriptor is not needed
+        close(file);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        size = static_cast<size_t>(info.st_size);
+        return std::shared_ptr<const char>(
+            reinterpret_cast<const char*>(data),
+            [size](const char* p) { munmap(const_cast<char*>(p), size); }
+        );
+#endif // WIN32
+    }
 } // namespace
 
 namespace openspace {
@@ -44,6 +153,7 @@ namespace openspace {
  * expected to be in degrees. scale is an optional scaling factor.
  */
 void FieldlinesState::convertLatLonToCartesian(float scale) {
+    detachFromMappedFile();
     for (glm::vec3& p : _vertexPositions) {
         const float r = p.x * scale;
         const float lat = glm::radians(p.y);
@@ -55,6 +165,7 @@ void FieldlinesState::convertLatLonToCartesian(float scale) {
 }
 
 void FieldlinesState::scalePositions(float scale) {
+    detachFromMappedFile();
     for (glm::vec3& p : _vertexPositions) {
         p *= scale;
     }
@@ -72,13 +183,21 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
 
     switch (binFileVersion) {
         case 0:
-            // No need to put everything in this scope now, as only version 0 exists!
             break;
+        case 1:
+            ifs.close();
+            return loadMappedStateFromOsfls(pathToOsflsFile);
         default:
             LERROR("VERSION OF BINARY FILE WAS NOT RECOGNIZED!");
             return false;
     }
 
+    _mappedFile = nullptr;
+    _mappedPositions = nullptr;
+    _mappedExtraQuantities = nullptr;
+    _hasHalfFloatPositions = false;
+    _positionScale = 1.f;
+
     // Define tmp variables to store meta data in
     size_t nLines;
     size_t nPoints;
@@ -132,6 +251,126 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
     return true;
 }
 
+bool FieldlinesState::loadMappedStateFromOsfls(const std::string& pathToOsflsFile) {
+    size_t fileSize = 0;
+    std::shared_ptr<const char> file = mapFile(pathToOsflsFile, fileSize);
+    if (!file || fileSize < sizeof(OsflsHeader)) {
+        LERROR(fmt::format("Couldn't map file: {}", pathToOsflsFile));
+        return false;
+    }
+
+    OsflsHeader header;
+    std::memcpy(&header, file.get(), sizeof(OsflsHeader));
+
+    const uint64_t positionSize = header.nPoints * 3 *
+        (header.positionFormat == PositionFormat::HalfFloat ? sizeof(uint16_t) :
+                                                              sizeof(float));
+    auto fitsInFile = [fileSize](uint64_t offset, uint64_t size) {
+        return offset % SectionAlignment == 0 && offset <= fileSize &&
+               size <= fileSize - offset;
+    };
+    const bool isValid =
+        fitsInFile(header.lineStartOffset, header.nLines * sizeof(int32_t)) &&
+        fitsInFile(header.lineCountOffset, header.nLines * sizeof(int32_t)) &&
+        fitsInFile(header.positionOffset, positionSize) &&
+        fitsInFile(
+            header.extraQuantityOffset,
+            header.nExtras * header.nPoints * sizeof(float)
+        ) &&
+        fitsInFile(header.namesOffset, header.byteSizeAllNames);
+    if (!isValid) {
+        LERROR(fmt::format("File {} is corrupt", pathToOsflsFile));
+        return false;
+    }
+
+    _triggerTime = header.triggerTime;
+    _model = static_cast<fls::Model>(header.model);
+    _isMorphable = header.isMorphable != 0;
+
+    // The line offsets are small and are needed as vectors for glMultiDrawArrays
+    const char* data = file.get();
+    _lineStart.resize(header.nLines);
+    _lineCount.resize(header.nLines);
+    std::memcpy(
+        _lineStart.data(),
+        data + header.lineStartOffset,
+        header.nLines * sizeof(int32_t)
+    );
+    std::memcpy(
+        _lineCount.data(),
+        data + header.lineCountOffset,
+        header.nLines * sizeof(int32_t)
+    );
+
+    const std::string allNamesInOne(
+        data + header.namesOffset,
+        header.byteSizeAllNames
+    );
+    _extraQuantityNames.resize(header.nExtras);
+    size_t offset = 0;
+    for (size_t i = 0; i < header.nExtras; ++i) {
+        const size_t endOfVarName = allNamesInOne.find('\0', offset);
+        _extraQuantityNames[i] = allNamesInOne.substr(offset, endOfVarName - offset);
+        offset = endOfVarName + 1;
+    }
+
+    _vertexPositions.clear();
+    _extraQuantities.clear();
+    _mappedPositions = data + header.positionOffset;
+    _mappedExtraQuantities = reinterpret_cast<const float*>(
+        data + header.extraQuantityOffset
+    );
+    _nMappedPoints = header.nPoints;
+    _hasHalfFloatPositions = (header.positionFormat == PositionFormat::HalfFloat);
+    _positionScale = header.positionScale;
+    _isMappedDataDecoded = false;
+    _mappedFile = std::move(file);
+    return true;
+}
+
+void FieldlinesState::decodeMappedData() const {
+    if (!_mappedFile || _isMappedDataDecoded) {
+        return;
+    }
+
+    _vertexPositions.resize(_nMappedPoints);
+    if (_hasHalfFloatPositions) {
+        const uint16_t* in = reinterpret_cast<const uint16_t*>(_mappedPositions);
+        for (size_t i = 0; i < _nMappedPoints; ++i) {
+            _vertexPositions[i] = _positionScale * glm::vec3(
+                glm::unpackHalf1x16(in[3 * i]),
+                glm::unpackHalf1x16(in[3 * i + 1]),
+                glm::unpackHalf1x16(in[3 * i + 2])
+            );
+        }
+    }
+    else {
+        std::memcpy(
+            _vertexPositions.data(),
+            _mappedPositions,
+            _nMappedPoints * sizeof(glm::vec3)
+        );
+    }
+
+    _extraQuantities.resize(_extraQuantityNames.size());
+    for (size_t i = 0; i < _extraQuantities.size(); ++i) {
+        const float* begin = _mappedExtraQuantities + i * _nMappedPoints;
+        _extraQuantities[i].assign(begin, begin + _nMappedPoints);
+    }
+    _isMappedDataDecoded = true;
+}
+
+void FieldlinesState::detachFromMappedFile() {
+    decodeMappedData();
+    _mappedFile = nullptr;
+    _mappedPositions = nullptr;
+    _mappedExtraQuantities = nullptr;
+    _nMappedPoints = 0;
+    _hasHalfFloatPositions = false;
+    _positionScale = 1.f;
+    _isMappedDataDecoded = false;
+}
+
 bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
                                         fls::Model Model, float coordToMeters)
 {
@@ -148,6 +387,7 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
     ifs >> jFile;
     // -------------------------------------------------------------------------------- //
 
+    detachFromMappedFile();
     _model = Model;
 
     const char* sData  = "data";
@@ -219,30 +459,28 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
 /**
  * \param absPath must be the path to the file (incl. filename but excl. extension!)
  * Directory must exist! File is created (or overwritten if already existing).
- * File is structured like this: (for version 0)
- *  0. int                    - version number of binary state file! (in case something
+ * File is structured like this: (for version 1)
+ *  0. OsflsHeader            - version number of binary state file (in case something
  *                              needs to be altered in the future, then increase
- *                              CurrentVersion)
- *  1. double                 - _triggerTime
- *  2. int                    - _model
- *  3. bool                   - _isMorphable
- *  4. size_t                 - Number of lines in the state  == _lineStart.size()
- *                                                            == _lineCount.size()
- *  5. size_t                 - Total number of vertex points == _vertexPositions.size()
- *                                                           == _extraQuantities[i].size()
- *  6. size_t                 - Number of extra quantites     == _extraQuantities.size()
- *                                                           == _extraQuantityNames.size()
- *  7. site_t                 - Number of total bytes that ALL _extraQuantityNames
- *                              consists of (Each such name is stored as a c_str which
- *                              means it ends with the null char '\0' )
- *  7. std::vector<GLint>     - _lineStart
- *  8. std::vector<GLsizei>   - _lineCount
- *  9. std::vector<glm::vec3> - _vertexPositions
- * 10. std::vector<float>     - _extraQuantities
- * 11. array of c_str         - Strings naming the extra quantities (elements of
+ *                              CurrentVersion), the meta data of the state and the byte
+ *                              offsets of the following sections
+ *  1. std::vector<GLint>     - _lineStart
+ *  2. std::vector<GLsizei>   - _lineCount
+ *  3. std::vector<glm::vec3> - _vertexPositions, either as floats or as half floats
+ *                              divided by OsflsHeader::positionScale
+ *  4. std::vector<float>     - _extraQuantities, one array per quantity
+ *  5. array of c_str         - Strings naming the extra quantities (elements of
  *                              _extraQuantityNames). Each string ends with null char '\0'
+ * Each section starts at a multiple of SectionAlignment bytes, so that the vertex data
+ * can be handed to OpenGL directly from the memory-mapped file.
+ * Version 0 stored the same data without a header struct or any alignment.
+ *
+ * \param halfFloatPositions If true, the vertex positions are stored as half floats,
+ *        which halves their size at the cost of precision
  */
-void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
+void FieldlinesState::saveStateToOsfls(const std::string& absPath,
+                                       bool halfFloatPositions)
+{
     // ------------------------------- Create the file ------------------------------- //
     std::string pathSafeTimeString = Time(_triggerTime).ISO8601();
     pathSafeTimeString.replace(13, 1, "-");
@@ -264,37 +502,96 @@ void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
         allExtraQuantityNamesInOne += str + '\0'; // Add null char '\0' for easier reading
     }
 
-    const size_t nLines = _lineStart.size();
-    const size_t nPoints = _vertexPositions.size();
-    const size_t nExtras = _extraQuantities.size();
-    const size_t nStringBytes = allExtraQuantityNamesInOne.size();
+    const std::vector<glm::vec3>& positions = vertexPositions();
+    const std::vector<std::vector<float>>& extras = extraQuantities();
+
+    const uint64_t nLines = _lineStart.size();
+    const uint64_t nPoints = positions.size();
+    const uint64_t nExtras = extras.size();
+
+    OsflsHeader header = {};
+    header.version = CurrentVersion;
+    header.model = static_cast<int32_t>(_model);
+    header.triggerTime = _triggerTime;
+    header.isMorphable = _isMorphable ? 1 : 0;
+    header.positionFormat = halfFloatPositions ? PositionFormat::HalfFloat :
+                                                 PositionFormat::Float;
+    header.positionScale = 1.f;
+    header.nLines = nLines;
+    header.nPoints = nPoints;
+    header.nExtras = nExtras;
+    header.byteSizeAllNames = allExtraQuantityNamesInOne.size();
+
+    const uint64_t positionSize = nPoints * 3 *
+        (halfFloatPositions ? sizeof(uint16_t) : sizeof(float));
+    header.lineStartOffset = alignedOffset(sizeof(OsflsHeader));
+    header.lineCountOffset = alignedOffset(
+        header.lineStartOffset + nLines * sizeof(int32_t)
+    );
+    header.positionOffset = alignedOffset(
+        header.lineCountOffset + nLines * sizeof(int32_t)
+    );
+    header.extraQuantityOffset = alignedOffset(header.positionOffset + positionSize);
+    header.namesOffset = alignedOffset(
+        header.extraQuantityOffset + nExtras * nPoints * sizeof(float)
+    );
+
+    std::vector<uint16_t> halfPositions;
+    if (halfFloatPositions) {
+        // Half floats can't represent distances in meters, so the positions are stored
+        // relative to the largest coordinate
+        float maxCoordinate = 0.f;
+        for (const glm::vec3& p : positions) {
+            maxCoordinate = std::max(maxCoordinate, glm::compMax(glm::abs(p)));
+        }
+        header.positionScale = maxCoordinate > 0.f ? maxCoordinate : 1.f;
+
+        halfPositions.reserve(3 * nPoints);
+        for (const glm::vec3& p : positions) {
+            const glm::vec3 scaled = p / header.positionScale;
+            halfPositions.push_back(glm::packHalf1x16(scaled.x));
+            halfPositions.push_back(glm::packHalf1x16(scaled.y));
+            halfPositions.push_back(glm::packHalf1x16(scaled.z));
+        }
+    }
+
+    // Pads the file with zeros up to the beginning of the next section
+    auto seekSection = [&ofs](uint64_t offset) {
+        const uint64_t position = static_cast<uint64_t>(ofs.tellp());
+        const std::vector<char> padding(offset - position, 0);
+        ofs.write(padding.data(), padding.size());
+    };
 
     //----------------------------- WRITE EVERYTHING TO FILE -----------------------------
-    // VERSION OF BINARY FIELDLINES STATE FILE - IN CASE STRUCTURE CHANGES IN THE FUTURE
-    ofs.write(reinterpret_cast<const char*>(&CurrentVersion), sizeof(int));
-
-    //-------------------- WRITE META DATA FOR STATE --------------------------------
-    ofs.write(reinterpret_cast<const char*>(&_triggerTime), sizeof(_triggerTime));
-    ofs.write(reinterpret_cast<const char*>(&_model), sizeof(int32_t));
-    ofs.write(reinterpret_cast<const char*>(&_isMorphable), sizeof(bool));
-
-    ofs.write(reinterpret_cast<const char*>(&nLines), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nPoints), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nExtras), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nStringBytes), sizeof(uint64_t));
-
-    //---------------------- WRITE ALL ARRAYS OF DATA --------------------------------
-    ofs.write(reinterpret_cast<char*>(_lineStart.data()), sizeof(int32_t) * nLines);
-    ofs.write(reinterpret_cast<char*>(_lineCount.data()), sizeof(uint32_t) * nLines);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(OsflsHeader));
+
+    seekSection(header.lineStartOffset);
     ofs.write(
-        reinterpret_cast<char*>(_vertexPositions.data()),
-        3 * sizeof(float) * nPoints
+        reinterpret_cast<const char*>(_lineStart.data()),
+        sizeof(int32_t) * nLines
     );
+    seekSection(header.lineCountOffset);
+    ofs.write(
+        reinterpret_cast<const char*>(_lineCount.data()),
+        sizeof(int32_t) * nLines
+    );
+
+    seekSection(header.positionOffset);
+    if (halfFloatPositions) {
+        ofs.write(reinterpret_cast<const char*>(halfPositions.data()), positionSize);
+    }
+    else {
+        ofs.write(reinterpret_cast<const char*>(positions.data()), positionSize);
+    }
+
     // Write the data for each vector in _extraQuantities
-    for (std::vector<float>& vec : _extraQuantities) {
-        ofs.write(reinterpret_cast<char*>(vec.data()), sizeof(float) * nPoints);
+    seekSection(header.extraQuantityOffset);
+    for (const std::vector<float>& vec : extras) {
+        ofs.write(reinterpret_cast<const char*>(vec.data()), sizeof(float) * nPoints);
     }
-    ofs.write(allExtraQuantityNamesInOne.c_str(), nStringBytes);
+
+    seekSection(header.namesOffset);
+    ofs.write(allExtraQuantityNamesInOne.c_str(), header.byteSizeAllNames);
 }
 
 // TODO: This should probably be rewritten, but this is the way the files were structured
@@ -333,6 +630,9 @@ void FieldlinesState::saveStateToJson(const std::string& absPath) {
     }
     LINFO(fmt::format("Saving fieldline state to: {}{}", absPath, ext));
 
+    const std::vector<glm::vec3>& positions = vertexPositions();
+    const std::vector<std::vector<float>>& extras = extraQuantities();
+
     json jColumns = { "x", "y", "z" };
     for (const std::string& s : _extraQuantityNames) {
         jColumns.push_back(s);
@@ -343,17 +643,17 @@ void FieldlinesState::saveStateToJson(const std::string& absPath) {
     const std::string timeStr = Time(_triggerTime).ISO8601();
     const size_t nLines = _lineStart.size();
     // const size_t nPoints      = _vertexPositions.size();
-    const size_t nExtras = _extraQuantities.size();
+    const size_t nExtras = extras.size();
 
     size_t pointIndex = 0;
     for (size_t lineIndex = 0; lineIndex < nLines; ++lineIndex) {
         json jData = json::array();
         for (GLsizei i = 0; i < _lineCount[lineIndex]; i++, ++pointIndex) {
-            const glm::vec3 pos = _vertexPositions[pointIndex];
+            const glm::vec3 pos = positions[pointIndex];
             json jDataElement = { pos.x, pos.y, pos.z };
 
             for (size_t extraIndex = 0; extraIndex < nExtras; ++extraIndex) {
-                jDataElement.push_back(_extraQuantities[extraIndex][pointIndex]);
+                jDataElement.push_back(extras[extraIndex][pointIndex]);
             }
             jData.push_back(jDataElement);
         }
@@ -386,9 +686,9 @@ void FieldlinesState::setTriggerTime(double t) {
 // If index is out of scope an empty vector is returned and the referenced bool is false.
 std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessful) const
 {
-    if (index < _extraQuantities.size()) {
+    if (index < nExtraQuantities()) {
         isSuccessful = true;
-        return _extraQuantities[index];
+        return extraQuantities()[index];
     }
     else {
         isSuccessful = false;
@@ -401,6 +701,7 @@ std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessf
 // _lineStart & _lineCount accordingly.
 
 void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
+    detachFromMappedFile();
     const size_t nNewPoints = line.size();
     const size_t nOldPoints = _vertexPositions.size();
     _lineStart.push_back(static_cast<GLint>(nOldPoints));
@@ -415,15 +716,18 @@ void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
 }
 
 void FieldlinesState::appendToExtra(size_t idx, float val) {
+    detachFromMappedFile();
     _extraQuantities[idx].push_back(val);
 }
 
 void FieldlinesState::setExtraQuantityNames(std::vector<std::string> names) {
+    detachFromMappedFile();
     _extraQuantityNames = std::move(names);
     _extraQuantities.resize(_extraQuantityNames.size());
 }
 
 const std::vector<std::vector<float>>& FieldlinesState::extraQuantities() const {
+    decodeMappedData();
     return _extraQuantities;
 }
 
@@ -444,7 +748,7 @@ fls::Model FieldlinesState::FieldlinesState::model() const {
 }
 
 size_t FieldlinesState::nExtraQuantities() const {
-    return _extraQuantities.size();
+    return _mappedFile ? _extraQuantityNames.size() : _extraQuantities.size();
 }
 
 double FieldlinesState::triggerTime() const {
@@ -452,7 +756,38 @@ double FieldlinesState::triggerTime() const {
 }
 
 const std::vector<glm::vec3>& FieldlinesState::vertexPositions() const {
+    decodeMappedData();
     return _vertexPositions;
 }
 
+size_t FieldlinesState::nVertices() const {
+    return _mappedFile ? _nMappedPoints : _vertexPositions.size();
+}
+
+const void* FieldlinesState::vertexPositionData() const {
+    return _mappedFile ? _mappedPositions : _vertexPositions.data();
+}
+
+size_t FieldlinesState::vertexPositionDataSize() const {
+    const size_t componentSize = _hasHalfFloatPositions ? sizeof(uint16_t) :
+                                                          sizeof(float);
+    return nVertices() * 3 * componentSize;
+}
+
+GLenum FieldlinesState::vertexPositionType() const {
+    return _hasHalfFloatPositions ? GL_HALF_FLOAT : GL_FLOAT;
+}
+
+float FieldlinesState::vertexPositionScale() const {
+    return _positionScale;
+}
+
+const float* FieldlinesState::extraQuantityData(size_t index) const {
+    if (index >= nExtraQuantities()) {
+        return nullptr;
+    }
+    return _mappedFile ? _mappedExtraQuantities + index * _nMappedPoints :
+                         _extraQuantities[index].data();
+}
+
 } // namespace openspace
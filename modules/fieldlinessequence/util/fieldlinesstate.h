@@ -28,6 +28,7 @@
 #include <modules/fieldlinessequence/util/commons.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -39,7 +40,8 @@ public:
     void scalePositions(float scale);
 
     bool loadStateFromOsfls(const std::string& pathToOsflsFile);
-    void saveStateToOsfls(const std::string& pathToOsflsFile);
+    void saveStateToOsfls(const std::string& pathToOsflsFile,
+        bool halfFloatPositions = false);
 
     bool loadStateFromJson(const std::string& pathToJsonFile, fls::Model model,
         float coordToMeters);
@@ -55,6 +57,18 @@ public:
     double triggerTime() const;
     const std::vector<glm::vec3>& vertexPositions() const;
 
+    // Raw vertex data that can be handed to OpenGL directly. For states that were loaded
+    // from version 1 .osfls files, these point into the memory-mapped file
+    size_t nVertices() const;
+    const void* vertexPositionData() const;
+    size_t vertexPositionDataSize() const;
+    // GL_FLOAT or GL_HALF_FLOAT
+    GLenum vertexPositionType() const;
+    // The factor by which the positions in vertexPositionData have to be multiplied
+    float vertexPositionScale() const;
+    // Returns nVertices values or nullptr if the index is out of range
+    const float* extraQuantityData(size_t index) const;
+
     // Special getter. Returns extraQuantities[index].
     std::vector<float> extraQuantity(size_t index, bool& isSuccesful) const;
 
@@ -66,15 +80,32 @@ public:
     void appendToExtra(size_t idx, float val);
 
 private:
+    bool loadMappedStateFromOsfls(const std::string& pathToOsflsFile);
+    // Decodes the mapped vertex positions and extra quantities into the vectors
+    void decodeMappedData() const;
+    // Decodes the mapped data and releases the mapping, so that the state can be changed
+    void detachFromMappedFile();
+
     bool _isMorphable = false;
     double _triggerTime = -1.0;
     fls::Model _model;
 
-    std::vector<std::vector<float>> _extraQuantities;
+    // Mutable as they are filled lazily from _mappedFile
+    mutable std::vector<std::vector<float>> _extraQuantities;
     std::vector<std::string> _extraQuantityNames;
     std::vector<GLsizei> _lineCount;
     std::vector<GLint> _lineStart;
-    std::vector<glm::vec3> _vertexPositions;
+    mutable std::vector<glm::vec3> _vertexPositions;
+
+    // Set if the state was loaded from a version 1 .osfls file. The vertex positions and
+    // extra quantities are then read from the mapping until they are modified
+    std::shared_ptr<const char> _mappedFile;
+    const void* _mappedPositions = nullptr;
+    const float* _mappedExtraQuantities = nullptr;
+    size_t _nMappedPoints = 0;
+    bool _hasHalfFloatPositions = false;
+    float _positionScale = 1.f;
+    mutable bool _isMappedDataDecoded = false;
 };
 
 } // namespace openspace
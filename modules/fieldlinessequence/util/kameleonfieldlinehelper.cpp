@@ -28,7 +28,12 @@
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/defer.h>
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <memory>
+#include <mutex>
 
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 
@@ -55,6 +60,24 @@ namespace {
     constexpr const char* JParallelB  = "Current: mag(J||B)";
     // [nPa]/[amu/cm^3] * ToKelvin => Temperature in Kelvin
     constexpr const float ToKelvin = 72429735.6984f;
+
+    // The CDF library is not thread-safe, so opening files and loading variables is
+    // serialized. Tracing and interpolating only read data that is already in memory
+    std::mutex CdfAccessMutex;
+
+    // Runs the worker on nThreads threads (including the calling one) and rethrows the
+    // first exception that any of them threw
+    template <typename Func>
+    void runOnThreads(unsigned int nThreads, const Func& worker) {
+        std::vector<std::future<void>> futures;
+        for (unsigned int i = 1; i < nThreads; ++i) {
+            futures.push_back(std::async(std::launch::async, worker));
+        }
+        worker();
+        for (std::future<void>& f : futures) {
+            f.get();
+        }
+    }
 } // namespace
 
 namespace openspace::fls {
@@ -62,10 +85,10 @@ namespace openspace::fls {
 // -------------------- DECLARE FUNCTIONS USED (ONLY) IN THIS FILE -------------------- //
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
     bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seeds,
-        const std::string& tracingVar, FieldlinesState& state);
+        const std::string& tracingVar, FieldlinesState& state, unsigned int nThreads);
     void addExtraQuantities(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
-        FieldlinesState& state);
+        FieldlinesState& state, unsigned int nThreads);
     void prepareStateAndKameleonForExtras(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
         FieldlinesState& state);
@@ -86,31 +109,50 @@ namespace openspace::fls {
  * \param extraMagVars, variables which should be used for extracting magnitudes, must be
  *        a multiple of 3; e.g. "ux", "uy" & "uz" to get the magnitude of the velocity
  *        vector at each line vertex
+ * \param nThreads, number of threads that trace the seed points and extract the extra
+ *        quantities. Each thread uses its own interpolator. The function can be called
+ *        concurrently for different files
  */
 bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
                                  const std::vector<glm::vec3>& seedPoints,
                                  const std::string& tracingVar,
                                  std::vector<std::string>& extraVars,
-                                 std::vector<std::string>& extraMagVars)
+                                 std::vector<std::string>& extraMagVars,
+                                 unsigned int nThreads)
 {
 
 #ifndef OPENSPACE_MODULE_KAMELEON_ENABLED
     LERROR("CDF inputs provided but Kameleon module is deactivated");
     return false;
 #else // OPENSPACE_MODULE_KAMELEON_ENABLED
-    // Create Kameleon object and open CDF file!
-    std::unique_ptr<ccmc::Kameleon> kameleon = kameleonHelper::createKameleonObject(
-        cdfPath
-    );
+    nThreads = std::max(nThreads, 1u);
 
-    state.setModel(fls::stringToModel(kameleon->getModelName()));
-    state.setTriggerTime(kameleonHelper::getTime(kameleon.get()));
+    // Create Kameleon object and open CDF file!
+    std::unique_ptr<ccmc::Kameleon> kameleon;
+    {
+        std::lock_guard<std::mutex> lock(CdfAccessMutex);
+        kameleon = kameleonHelper::createKameleonObject(cdfPath);
+    }
+    if (!kameleon) {
+        return false;
+    }
+    // Closing the file has to be serialized as well
+    defer {
+        std::lock_guard<std::mutex> lock(CdfAccessMutex);
+        kameleon = nullptr;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(CdfAccessMutex);
+        state.setModel(fls::stringToModel(kameleon->getModelName()));
+        state.setTriggerTime(kameleonHelper::getTime(kameleon.get()));
+    }
 
-    if (addLinesToState(kameleon.get(), seedPoints, tracingVar, state)) {
+    if (addLinesToState(kameleon.get(), seedPoints, tracingVar, state, nThreads)) {
         // The line points are in their RAW format (unscaled & maybe spherical)
         // Before we scale to meters (and maybe cartesian) we must extract
         // the extraQuantites, as the iterpolator needs the unaltered positions
-        addExtraQuantities(kameleon.get(), extraVars, extraMagVars, state);
+        addExtraQuantities(kameleon.get(), extraVars, extraMagVars, state, nThreads);
         switch (state.model()) {
             case fls::Model::Batsrus:
                 state.scalePositions(fls::ReToMeter);
@@ -137,7 +179,9 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
  * Note that extraQuantities will NOT be set!
  */
 bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seedPoints,
-                     const std::string& tracingVar, FieldlinesState& state) {
+                     const std::string& tracingVar, FieldlinesState& state,
+                     unsigned int nThreads)
+{
 
     float innerBoundaryLimit;
 
@@ -157,40 +201,52 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
     }
 
     // ---------------------------- LOAD TRACING VARIABLE ---------------------------- //
-    if (!kameleon->loadVariable(tracingVar)) {
-        LERROR("Failed to load tracing variable: " + tracingVar);
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(CdfAccessMutex);
+        if (!kameleon->loadVariable(tracingVar)) {
+            LERROR("Failed to load tracing variable: " + tracingVar);
+            return false;
+        }
     }
 
-    bool success = false;
     LINFO("Tracing field lines!");
-    // LOOP THROUGH THE SEED POINTS, TRACE LINES, CONVERT POINTS TO glm::vec3 AND STORE //
-    for (const glm::vec3& seed : seedPoints) {
-        //--------------------------------------------------------------------------//
-        // We have to create a new tracer (or actually a new interpolator) for each //
-        // new line, otherwise some issues occur                                    //
-        //--------------------------------------------------------------------------//
-        std::unique_ptr<ccmc::Interpolator> interpolator =
-                std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
-        ccmc::Tracer tracer(kameleon, interpolator.get());
-        tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
-        ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
-            tracingVar,
-            seed.x,
-            seed.y,
-            seed.z
-        );
-        const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
-
-        const size_t nLinePoints = positions.size();
-
-        std::vector<glm::vec3> vertices;
-        vertices.reserve(nLinePoints);
-        for (const ccmc::Point3f& p : positions) {
-            vertices.emplace_back(p.component1, p.component2, p.component3);
+    // The lines are traced concurrently, but added to the state in the order of the seed
+    // points so that the result doesn't depend on the number of threads
+    std::vector<std::vector<glm::vec3>> lines(seedPoints.size());
+    std::atomic<size_t> nextSeed(0);
+    auto traceLines = [&]() {
+        // TRACE LINES AND CONVERT POINTS TO glm::vec3
+        for (size_t i = nextSeed++; i < seedPoints.size(); i = nextSeed++) {
+            const glm::vec3& seed = seedPoints[i];
+            //--------------------------------------------------------------------------//
+            // We have to create a new tracer (or actually a new interpolator) for each //
+            // new line, otherwise some issues occur                                    //
+            //--------------------------------------------------------------------------//
+            std::unique_ptr<ccmc::Interpolator> interpolator =
+                    std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
+            ccmc::Tracer tracer(kameleon, interpolator.get());
+            tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
+            ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
+                tracingVar,
+                seed.x,
+                seed.y,
+                seed.z
+            );
+            const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
+
+            std::vector<glm::vec3>& vertices = lines[i];
+            vertices.reserve(positions.size());
+            for (const ccmc::Point3f& p : positions) {
+                vertices.emplace_back(p.component1, p.component2, p.component3);
+            }
         }
+    };
+    runOnThreads(nThreads, traceLines);
+
+    bool success = false;
+    for (std::vector<glm::vec3>& vertices : lines) {
+        success |= !vertices.empty();
         state.addLine(vertices);
-        success |= (nLinePoints > 0);
     }
 
     return success;
@@ -216,59 +272,93 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
 void addExtraQuantities(ccmc::Kameleon* kameleon,
                         std::vector<std::string>& extraScalarVars,
                         std::vector<std::string>& extraMagVars,
-                        FieldlinesState& state)
+                        FieldlinesState& state, unsigned int nThreads)
 {
-
-    prepareStateAndKameleonForExtras(kameleon, extraScalarVars, extraMagVars, state);
+    {
+        std::lock_guard<std::mutex> lock(CdfAccessMutex);
+        prepareStateAndKameleonForExtras(kameleon, extraScalarVars, extraMagVars, state);
+    }
 
     const size_t nXtraScalars = extraScalarVars.size();
     const size_t nXtraMagnitudes = extraMagVars.size() / 3;
 
-    std::unique_ptr<ccmc::Interpolator> interpolator =
-            std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
+    const std::vector<glm::vec3>& positions = state.vertexPositions();
+    // The quantities are computed concurrently into this buffer and then appended to the
+    // state in order, as the state is not thread-safe
+    std::vector<std::vector<float>> extras(
+        nXtraScalars + nXtraMagnitudes,
+        std::vector<float>(positions.size())
+    );
 
-    // ------ Extract all the extraQuantities from kameleon and store in state! ------ //
-    for (const glm::vec3& p : state.vertexPositions()) {
-        // Load the scalars!
-        for (size_t i = 0; i < nXtraScalars; i++) {
-            float val;
-            if (extraScalarVars[i] == TAsPOverRho) {
-                val = interpolator->interpolate("p", p.x, p.y, p.z);
-                val *= ToKelvin;
-                val /= interpolator->interpolate("rho", p.x, p.y, p.z);
-            } else {
-                val = interpolator->interpolate(extraScalarVars[i], p.x, p.y, p.z);
+    // The vertices are distributed in blocks, so that consecutive vertices along a line,
+    // which are close in the grid, are interpolated by the same interpolator
+    constexpr const size_t BlockSize = 1024;
+    std::atomic<size_t> nextBlock(0);
+    auto extractQuantities = [&]() {
+        std::unique_ptr<ccmc::Interpolator> interpolator =
+            std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
 
-                // When measuring density in ENLIL CCMC multiply by the radius^2
-                if (extraScalarVars[i] == "rho" && state.model() == fls::Model::Enlil) {
-                    val *= std::pow(p.x * fls::AuToMeter, 2.0f);
+        for (size_t begin = BlockSize * nextBlock++; begin < positions.size();
+             begin = BlockSize * nextBlock++)
+        {
+            const size_t end = std::min(begin + BlockSize, positions.size());
+            for (size_t vertex = begin; vertex < end; ++vertex) {
+                const glm::vec3& p = positions[vertex];
+                // Load the scalars!
+                for (size_t i = 0; i < nXtraScalars; i++) {
+                    const std::string& var = extraScalarVars[i];
+                    float val;
+                    if (var == TAsPOverRho) {
+                        val = interpolator->interpolate("p", p.x, p.y, p.z);
+                        val *= ToKelvin;
+                        val /= interpolator->interpolate("rho", p.x, p.y, p.z);
+                    } else {
+                        val = interpolator->interpolate(var, p.x, p.y, p.z);
+
+                        // When measuring density in ENLIL CCMC multiply by the radius^2
+                        if (var == "rho" && state.model() == fls::Model::Enlil) {
+                            val *= std::pow(p.x * fls::AuToMeter, 2.0f);
+                        }
+                    }
+                    extras[i][vertex] = val;
+                }
+                // Calculate and store the magnitudes!
+                for (size_t i = 0; i < nXtraMagnitudes; ++i) {
+                    const size_t idx = i*3;
+
+                    const float x = interpolator->interpolate(extraMagVars[idx], p.x, p.y,
+                                                              p.z);
+                    const float y = interpolator->interpolate(extraMagVars[idx+1], p.x,
+                                                              p.y, p.z);
+                    const float z = interpolator->interpolate(extraMagVars[idx+2], p.x,
+                                                              p.y, p.z);
+                    float val;
+                    // When looking at the current's magnitude in Batsrus, CCMC staff are
+                    // only interested in the magnitude parallel to the magnetic field
+                    if (state.extraQuantityNames()[nXtraScalars + i] == JParallelB) {
+                        const glm::vec3 normMagnetic =  glm::normalize(glm::vec3(
+                                interpolator->interpolate("bx", p.x, p.y, p.z),
+                                interpolator->interpolate("by", p.x, p.y, p.z),
+                                interpolator->interpolate("bz", p.x, p.y, p.z)));
+                        // Magnitude of the part of the current vector that's parallel to
+                        // the magnetic field vector!
+                        val = glm::dot(glm::vec3(x,y,z), normMagnetic);
+
+                    } else {
+                        val = std::sqrt(x*x + y*y + z*z);
+                    }
+                    extras[nXtraScalars + i][vertex] = val;
                 }
             }
-            state.appendToExtra(i, val);
         }
-        // Calculate and store the magnitudes!
-        for (size_t i = 0; i < nXtraMagnitudes; ++i) {
-            const size_t idx = i*3;
-
-            const float x = interpolator->interpolate(extraMagVars[idx]  , p.x, p.y, p.z);
-            const float y = interpolator->interpolate(extraMagVars[idx+1], p.x, p.y, p.z);
-            const float z = interpolator->interpolate(extraMagVars[idx+2], p.x, p.y, p.z);
-            float val;
-            // When looking at the current's magnitude in Batsrus, CCMC staff are
-            // only interested in the magnitude parallel to the magnetic field
-            if (state.extraQuantityNames()[nXtraScalars + i] == JParallelB) {
-                const glm::vec3 normMagnetic =  glm::normalize(glm::vec3(
-                        interpolator->interpolate("bx", p.x, p.y, p.z),
-                        interpolator->interpolate("by", p.x, p.y, p.z),
-                        interpolator->interpolate("bz", p.x, p.y, p.z)));
-                // Magnitude of the part of the current vector that's parallel to
-                // the magnetic field vector!
-                val = glm::dot(glm::vec3(x,y,z), normMagnetic);
+    };
 
-            } else {
-                val = std::sqrt(x*x + y*y + z*z);
-            }
-            state.appendToExtra(i + nXtraScalars, val);
+    // ------ Extract all the extraQuantities from kameleon and store in state! ------ //
+    runOnThreads(nThreads, extractQuantities);
+
+    for (size_t i = 0; i < extras.size(); ++i) {
+        for (float val : extras[i]) {
+            state.appendToExtra(i, val);
         }
     }
 }
@@ -37,7 +37,8 @@ namespace fls {
 
 bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
     const std::vector<glm::vec3>& seedPoints, const std::string& tracingVar,
-    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars);
+    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars,
+    unsigned int nThreads = 1);
 
 } // namespace fls
 } // namespace openspace
@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_MODULE_FITSFILEREADER___FITSFILEREADER___H__
 #define __OPENSPACE_MODULE_FITSFILEREADER___FITSFILEREADER___H__
 
+#include <functional>
 #include <string>
 #include <memory>
 #include <mutex>
@@ -59,6 +60,9 @@ struct TableData {
 
 class FitsFileReader {
 public:
+    /// The default number of rows that are read per batch by readTableInBatches
+    static constexpr int DefaultBatchSize = 65536;
+
     FitsFileReader(bool verboseMode);
     ~FitsFileReader();
 
@@ -82,6 +86,23 @@ public:
         const std::vector<std::string>& columnNames, int startRow = 1, int endRow = 10,
         int hduIdx = 1, bool readAll = false);
 
+    /**
+     * Reads the rows [\p startRow, \p endRow] of the table columns \p columnNames in
+     * batches of at most \p batchSize rows, so that only one batch of the table has to
+     * be kept in memory. The values of column <code>i</code> are read into
+     * <code>columns[i]</code>, which has to provide one buffer per column name and keeps
+     * its capacity between the batches. \p processBatch is called with the number of
+     * rows in the buffers after every batch. Other threads may read from this reader
+     * while a batch is being processed. If \p endRow < \p startRow the rest of the
+     * table is read. \returns the total number of rows read, or -1 if the table could
+     * not be read.
+     */
+    template<typename T>
+    int readTableInBatches(const std::string& path,
+        const std::vector<std::string>& columnNames, std::vector<std::vector<T>>& columns,
+        const std::function<void(int nRows)>& processBatch, int startRow = 1,
+        int endRow = 0, int batchSize = DefaultBatchSize, int hduIdx = 1);
+
     /**
      * Reads a single FITS file with pre-defined columns (defined for Viennas TGAS-file).
      * Returns a vector with all read stars with <code>nValuesPerStar</code>.
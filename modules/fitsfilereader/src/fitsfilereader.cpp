@@ -27,8 +27,11 @@
 #include <openspace/util/distanceconversion.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/defer.h>
 #include <ghoul/misc/dictionary.h>
 #include <CCfits>
+#include <algorithm>
 #include <fstream>
 
 using namespace CCfits;
@@ -178,6 +181,62 @@ std::shared_ptr<TableData<T>> FitsFileReader::readTable(std::string& path,
     return nullptr;
 }
 
+template<typename T>
+int FitsFileReader::readTableInBatches(const std::string& path,
+                                       const std::vector<std::string>& columnNames,
+                                       std::vector<std::vector<T>>& columns,
+                                       const std::function<void(int nRows)>& processBatch,
+                                       int startRow, int endRow, int batchSize,
+                                       int hduIdx)
+{
+    ghoul_assert(columns.size() == columnNames.size(), "Needs one buffer per column");
+    ghoul_assert(batchSize > 0, "The batch size must be positive");
+
+    // We need to lock reading when using multithreads because CCfits can't handle
+    // multiple I/O drivers.
+    std::unique_lock lock(_mutex);
+
+    try {
+        // Only the header of the table is read when the file is opened, the values are
+        // read one batch at a time
+        FITS file(path, Read, hduIdx, false);
+        ExtHDU& table = file.extension(hduIdx);
+        const int nRowsInTable = static_cast<int>(table.rows());
+
+        std::vector<Column*> tableColumns;
+        tableColumns.reserve(columnNames.size());
+        for (const std::string& name : columnNames) {
+            tableColumns.push_back(&table.column(name));
+        }
+
+        const int firstRow = std::max(startRow, 1);
+        const int lastRow = (endRow < firstRow) ?
+            nRowsInTable :
+            std::min(endRow, nRowsInTable);
+
+        for (int row = firstRow; row <= lastRow; row += batchSize) {
+            const int batchEnd = std::min(row + batchSize - 1, lastRow);
+            for (size_t i = 0; i < tableColumns.size(); ++i) {
+                tableColumns[i]->read(columns[i], row, batchEnd);
+            }
+
+            // Let other threads read while this batch is being processed
+            lock.unlock();
+            {
+                defer { lock.lock(); };
+                processBatch(batchEnd - row + 1);
+            }
+        }
+        return std::max(lastRow - firstRow + 1, 0);
+    }
+    catch (FitsException& e) {
+        LERROR(fmt::format(
+            "Could not read FITS table from file '{}': {}", path, e.message()
+        ));
+    }
+    return -1;
+}
+
 std::vector<float> FitsFileReader::readFitsFile(std::string filePath, int& nValuesPerStar,
                                                 int firstRow, int lastRow,
                                                std::vector<std::string> filterColumnNames,
@@ -223,20 +282,6 @@ std::vector<float> FitsFileReader::readFitsFile(std::string filePath, int& nValu
     }
     LINFO(allNames);
 
-    // Read columns from FITS file. If rows aren't specified then full table will be read.
-    std::shared_ptr<TableData<float>> table = readTable<float>(
-        filePath,
-        allColumnNames,
-        firstRow,
-        lastRow
-    );
-
-    if (!table) {
-        throw ghoul::RuntimeError(fmt::format("Failed to open Fits file '{}'", filePath));
-    }
-
-    int nStars = table->readRows - firstRow + 1;
-
     int nNullArr = 0;
     int nColumnsRead = static_cast<int>(allColumnNames.size());
     int defaultCols = 17; // Number of columns that are copied by predefined code.
@@ -247,100 +292,119 @@ std::vector<float> FitsFileReader::readFitsFile(std::string filePath, int& nValu
     // Declare how many values to save per star
     nValuesPerStar = nColumnsRead + 1; // +1 for B-V color value.
 
-    // Copy columns to local variables.
-    std::unordered_map<std::string, std::vector<float>>& tableContent = table->contents;
+    // The columns are streamed in batches into these buffers, so only one batch of the
+    // table is kept in memory next to the constructed data.
+    std::vector<std::vector<float>> columns(allColumnNames.size());
 
     // Default render parameters!
-    std::vector<float> posXcol = std::move(tableContent[allColumnNames[0]]);
-    std::vector<float> posYcol = std::move(tableContent[allColumnNames[1]]);
-    std::vector<float> posZcol = std::move(tableContent[allColumnNames[2]]);
-    std::vector<float> velXcol = std::move(tableContent[allColumnNames[3]]);
-    std::vector<float> velYcol = std::move(tableContent[allColumnNames[4]]);
-    std::vector<float> velZcol = std::move(tableContent[allColumnNames[5]]);
-    std::vector<float> parallax = std::move(tableContent[allColumnNames[6]]);
-    std::vector<float> magCol = std::move(tableContent[allColumnNames[7]]);
-    std::vector<float> tycho_b = std::move(tableContent[allColumnNames[8]]);
-    std::vector<float> tycho_v = std::move(tableContent[allColumnNames[9]]);
+    std::vector<float>& posXcol = columns[0];
+    std::vector<float>& posYcol = columns[1];
+    std::vector<float>& posZcol = columns[2];
+    std::vector<float>& velXcol = columns[3];
+    std::vector<float>& velYcol = columns[4];
+    std::vector<float>& velZcol = columns[5];
+    std::vector<float>& parallax = columns[6];
+    std::vector<float>& magCol = columns[7];
+    std::vector<float>& tycho_b = columns[8];
+    std::vector<float>& tycho_v = columns[9];
 
     // Default filter parameters
     // Additional filter parameters are handled as well but slows down reading
-    std::vector<float> parallax_err = std::move(tableContent[allColumnNames[10]]);
-    std::vector<float> pr_mot_ra = std::move(tableContent[allColumnNames[11]]);
-    std::vector<float> pr_mot_ra_err = std::move(tableContent[allColumnNames[12]]);
-    std::vector<float> pr_mot_dec = std::move(tableContent[allColumnNames[13]]);
-    std::vector<float> pr_mot_dec_err = std::move(tableContent[allColumnNames[14]]);
-    std::vector<float> tycho_b_err = std::move(tableContent[allColumnNames[15]]);
-    std::vector<float> tycho_v_err = std::move(tableContent[allColumnNames[16]]);
+    std::vector<float>& parallax_err = columns[10];
+    std::vector<float>& pr_mot_ra = columns[11];
+    std::vector<float>& pr_mot_ra_err = columns[12];
+    std::vector<float>& pr_mot_dec = columns[13];
+    std::vector<float>& pr_mot_dec_err = columns[14];
+    std::vector<float>& tycho_b_err = columns[15];
+    std::vector<float>& tycho_v_err = columns[16];
+
+    std::vector<float> values(nValuesPerStar);
+    auto processBatch = [&](int nRows) {
+        // Construct data array. OBS: ORDERING IS IMPORTANT! This is where slicing
+        // happens.
+        for (int i = 0; i < nRows * multiplier; ++i) {
+            const int row = i % nRows;
+            size_t idx = 0;
 
-    // Construct data array. OBS: ORDERING IS IMPORTANT! This is where slicing happens.
-    for (int i = 0; i < nStars * multiplier; ++i) {
-        std::vector<float> values(nValuesPerStar);
-        size_t idx = 0;
-
-        // Default order for rendering:
-        // Position [X, Y, Z]
-        // Absolute Magnitude
-        // B-V Color
-        // Velocity [X, Y, Z]
+            // Default order for rendering:
+            // Position [X, Y, Z]
+            // Absolute Magnitude
+            // B-V Color
+            // Velocity [X, Y, Z]
 
-        // Store positions.
-        values[idx++] = posXcol[i % nStars];
-        values[idx++] = posYcol[i % nStars];
-        values[idx++] = posZcol[i % nStars];
+            // Store positions.
+            values[idx++] = posXcol[row];
+            values[idx++] = posYcol[row];
+            values[idx++] = posZcol[row];
 
-        // Return early if star doesn't have a measured position.
-        if (values[0] == -999 && values[1] == -999 && values[2] == -999) {
-            nNullArr++;
-            continue;
-        }
+            // Return early if star doesn't have a measured position.
+            if (values[0] == -999 && values[1] == -999 && values[2] == -999) {
+                nNullArr++;
+                continue;
+            }
 
-        // Store color values.
-        values[idx++] = magCol[i % nStars] == -999 ? 20.f : magCol[i % nStars];
-        values[idx++] = tycho_b[i % nStars] - tycho_v[i % nStars];
+            // Store color values.
+            values[idx++] = magCol[row] == -999 ? 20.f : magCol[row];
+            values[idx++] = tycho_b[row] - tycho_v[row];
+
+            // Store velocity. Convert it to m/s with help by parallax.
+            values[idx++] = convertMasPerYearToMeterPerSecond(
+                velXcol[row],
+                parallax[row]
+            );
+            values[idx++] = convertMasPerYearToMeterPerSecond(
+                velYcol[row],
+                parallax[row]
+            );
+            values[idx++] = convertMasPerYearToMeterPerSecond(
+                velZcol[row],
+                parallax[row]
+            );
+
+            // Store additional parameters to filter by.
+            values[idx++] = parallax[row];
+            values[idx++] = parallax_err[row];
+            values[idx++] = pr_mot_ra[row];
+            values[idx++] = pr_mot_ra_err[row];
+            values[idx++] = pr_mot_dec[row];
+            values[idx++] = pr_mot_dec_err[row];
+            values[idx++] = tycho_b[row];
+            values[idx++] = tycho_b_err[row];
+            values[idx++] = tycho_v[row];
+            values[idx++] = tycho_v_err[row];
+
+            // Read extra columns, if any. This will slow down the sorting tremendously!
+            for (int col = defaultCols; col < nColumnsRead; ++col) {
+                values[idx++] = columns[col][row];
+            }
 
-        // Store velocity. Convert it to m/s with help by parallax.
-        values[idx++] = convertMasPerYearToMeterPerSecond(
-            velXcol[i % nStars],
-            parallax[i % nStars]
-        );
-        values[idx++] = convertMasPerYearToMeterPerSecond(
-            velYcol[i % nStars],
-            parallax[i % nStars]
-        );
-        values[idx++] = convertMasPerYearToMeterPerSecond(
-            velZcol[i % nStars],
-            parallax[i % nStars]
-        );
+            for (int j = 0; j < nValuesPerStar; ++j) {
+                // The astronomers in Vienna use -999 as default value. Change it to 0.
+                if (values[j] == -999) {
+                    values[j] = 0.f;
+                }
+                else if (multiplier > 1) {
+                    values[j] *= static_cast<float>(rand()) /
+                                 static_cast<float>(RAND_MAX);
+                }
+            }
 
-        // Store additional parameters to filter by.
-        values[idx++] = parallax[i % nStars];
-        values[idx++] = parallax_err[i % nStars];
-        values[idx++] = pr_mot_ra[i % nStars];
-        values[idx++] = pr_mot_ra_err[i % nStars];
-        values[idx++] = pr_mot_dec[i % nStars];
-        values[idx++] = pr_mot_dec_err[i % nStars];
-        values[idx++] = tycho_b[i % nStars];
-        values[idx++] = tycho_b_err[i % nStars];
-        values[idx++] = tycho_v[i % nStars];
-        values[idx++] = tycho_v_err[i % nStars];
-
-        // Read extra columns, if any. This will slow down the sorting tremendously!
-        for (size_t col = defaultCols; col < nColumnsRead; ++col) {
-            std::vector<float> vecData = std::move(tableContent[allColumnNames[col]]);
-            values[idx++] = vecData[i];
+            fullData.insert(fullData.end(), values.begin(), values.end());
         }
+    };
 
-        for (int j = 0; j < nValuesPerStar; ++j) {
-            // The astronomers in Vienna use -999 as default value. Change it to 0.
-            if (values[j] == -999) {
-                values[j] = 0.f;
-            }
-            else if (multiplier > 1) {
-                values[j] *= static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-            }
-        }
+    // Read columns from FITS file. If rows aren't specified then full table will be read.
+    int nStars = readTableInBatches<float>(
+        filePath,
+        allColumnNames,
+        columns,
+        processBatch,
+        firstRow,
+        lastRow
+    );
 
-        fullData.insert(fullData.end(), values.begin(), values.end());
+    if (nStars < 0) {
+        throw ghoul::RuntimeError(fmt::format("Failed to open Fits file '{}'", filePath));
     }
 
     // Define what columns to read.
@@ -666,4 +730,14 @@ const std::shared_ptr<ImageData<T>> FitsFileReader::readImageInternal(PHDU& imag
     return nullptr;
 }
 
+// The tables are read from other modules, which can't instantiate the templates
+template std::shared_ptr<TableData<float>> FitsFileReader::readTable<float>(
+    std::string& path, const std::vector<std::string>& columnNames, int startRow,
+    int endRow, int hduIdx, bool readAll);
+
+template int FitsFileReader::readTableInBatches<float>(const std::string& path,
+    const std::vector<std::string>& columnNames, std::vector<std::vector<float>>& columns,
+    const std::function<void(int nRows)>& processBatch, int startRow, int endRow,
+    int batchSize, int hduIdx);
+
 } // namespace openspace
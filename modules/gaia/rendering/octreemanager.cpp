@@ -29,15 +29,57 @@
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <array>
 #include <fstream>
+#include <limits>
 #include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "OctreeManager";
+
+    // Number of threads that load and unload node files when streaming the Octree. The
+    // loading is limited by the disk, so more threads do not help much
+    constexpr const unsigned int NumIoThreads = 4;
+
+    // The number of calls to fetchSurroundingNodes that the camera movement is
+    // extrapolated by to find the nodes that should be prefetched
+    constexpr const double PrefetchLookahead = 60.0;
+
+    // Same tolerance as the filters in gaia_filter.glsl
+    constexpr const float FilterEps = 1e-5f;
+
+    // Reads nValues floats from the stream straight into the storage of the vector
+    void readValues(std::ifstream& inFileStream, std::vector<float>& values,
+                    size_t nValues)
+    {
+        values.resize(nValues);
+        if (nValues > 0) {
+            inFileStream.read(
+                reinterpret_cast<char*>(values.data()),
+                nValues * sizeof(values[0])
+            );
+        }
+    }
+
+    void writeValues(std::ofstream& outFileStream, const std::vector<float>& values) {
+        if (!values.empty()) {
+            outFileStream.write(
+                reinterpret_cast<const char*>(values.data()),
+                values.size() * sizeof(values[0])
+            );
+        }
+    }
 } // namespace
 
 namespace openspace {
 
+OctreeManager::~OctreeManager() {
+    stopIoThreads();
+}
+
 void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStarsPerNode) {
     if (_root) {
         LDEBUG("Clear existing Octree");
@@ -54,7 +96,16 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
     box.max = glm::vec3(1.f, 1.f, 1e2);
     _culler = std::make_unique<OctreeCuller>(box);
     _removedKeysInPrevCall = std::set<int>();
-    _leastRecentlyFetchedNodes = std::queue<unsigned long long>();
+    {
+        std::lock_guard g(_leastRecentlyFetchedNodesMutex);
+        _leastRecentlyFetchedNodes = std::queue<unsigned long long>();
+    }
+    {
+        // Requests that are already being executed keep their nodes alive
+        std::lock_guard g(_ioMutex);
+        _fetchRequests.clear();
+        _unloadRequests.clear();
+    }
 
     // Reset default values when rebuilding the Octree during runtime.
     _numInnerNodes = 0;
@@ -64,6 +115,8 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
     _maxCpuRamBudget = cpuRamBudget;
     _cpuRamBudget = cpuRamBudget;
     _parentNodeOfCamera = 8;
+    _predictedParentNodeOfCamera = 8;
+    _hasPreviousCameraPos = false;
 
     if (maxDist > 0) {
         MAX_DIST = static_cast<size_t>(maxDist);
@@ -72,13 +125,9 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
         MAX_STARS_PER_NODE = static_cast<size_t>(maxStarsPerNode);
     }
 
+    allocateNodeChildren(*_root);
     for (size_t i = 0; i < 8; ++i) {
         _numLeafNodes++;
-        _root->Children[i] = std::make_shared<OctreeNode>();
-        _root->Children[i]->posData = std::vector<float>();
-        _root->Children[i]->colData = std::vector<float>();
-        _root->Children[i]->velData = std::vector<float>();
-        _root->Children[i]->magOrder = std::vector<std::pair<float, size_t>>();
         _root->Children[i]->isLeaf = true;
         _root->Children[i]->isLoaded = false;
         _root->Children[i]->hasLoadedDescendant = false;
@@ -99,7 +148,7 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
 }
 
 void OctreeManager::initBufferIndexStack(long long maxNodes, bool useVBO,
-                                         bool datasetFitInMemory)
+                                         bool datasetFitInMemory, bool quantizeData)
 {
     // Clear stack if we've used it before.
     _biggestChunkIndexInUse = 0;
@@ -107,6 +156,7 @@ void OctreeManager::initBufferIndexStack(long long maxNodes, bool useVBO,
     _rebuildBuffer = true;
     _useVBO = useVBO;
     _datasetFitInMemory = datasetFitInMemory;
+    _quantizeData = quantizeData;
 
     // Build stack back-to-front.
     for (long long idx = maxNodes - 1; idx >= 0; --idx) {
@@ -127,7 +177,7 @@ void OctreeManager::sliceLodData(size_t branchIndex) {
         sliceNodeLodCache(*_root->Children[branchIndex]);
     }
     else {
-        for (int i = 0; i < 7; ++i) {
+        for (int i = 0; i < 8; ++i) {
             sliceNodeLodCache(*_root->Children[i]);
         }
     }
@@ -165,136 +215,286 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
                     continue;
                 }
 
-                // Use multithreading to load files and detach thread from main execution
-                // so it can execute independently. Thread will be destroyed when
-                // finished!
-                std::thread([this, n = _root->Children[i]]() {
-                    fetchChildrenNodes(*n, -1);
-                }).detach();
+                // Let the I/O threads load the branches, nodes will be rendered as soon
+                // as they have been made available
+                enqueueFetchRequest(_root->Children[i], -1, 0.f);
             }
             _parentNodeOfCamera = 0;
         }
         return;
     }
 
-    // Get leaf node in which the camera resides.
-    glm::vec3 fCameraPos = static_cast<glm::vec3>(
+    // Extrapolate the movement of the camera since the last call to find out where the
+    // camera is heading, so that those nodes can be loaded before they become visible.
+    const glm::dvec3 cameraMovement = _hasPreviousCameraPos ?
+        cameraPos - _previousCameraPos :
+        glm::dvec3(0.0);
+    _previousCameraPos = cameraPos;
+    _hasPreviousCameraPos = true;
+
+    const glm::vec3 fCameraPos = static_cast<glm::vec3>(
         cameraPos / (1000.0 * distanceconstants::Parsec)
     );
-    size_t idx = getChildIndex(fCameraPos.x, fCameraPos.y, fCameraPos.z);
-    std::shared_ptr<OctreeNode> node = _root->Children[idx];
+    const glm::vec3 fPredictedPos = static_cast<glm::vec3>(
+        (cameraPos + cameraMovement * PrefetchLookahead) /
+        (1000.0 * distanceconstants::Parsec)
+    );
 
-    while (!node->isLeaf) {
-        idx = getChildIndex(
-            fCameraPos.x,
-            fCameraPos.y,
-            fCameraPos.z,
-            node->originX,
-            node->originY,
-            node->originZ
-        );
-        node = node->Children[idx];
-    }
-    unsigned long long leafId = node->octreePositionIndex;
+    // Get leaf node in which the camera resides.
+    unsigned long long leafId = findLeafNode(fCameraPos).octreePositionIndex;
     unsigned long long firstParentId = leafId / 10;
-
-    // Return early if camera resides in the same first parent as before!
-    // Otherwise camera has moved and may need to load more nodes!
-    if (_parentNodeOfCamera == firstParentId) {
+    const unsigned long long predictedParentId =
+        findLeafNode(fPredictedPos).octreePositionIndex / 10;
+
+    // Return early if camera resides in the same first parent as before and is not
+    // heading into a new one. Otherwise we may need to load more nodes!
+    const bool cameraMoved = _parentNodeOfCamera != firstParentId;
+    const bool predictionMoved = predictedParentId != firstParentId &&
+        predictedParentId != _predictedParentNodeOfCamera;
+    if (!cameraMoved && !predictionMoved) {
         return;
     }
-    _parentNodeOfCamera = firstParentId;
-
-    // Each parent level may be root, make sure to propagate it in that case!
-    unsigned long long secondParentId = (firstParentId == 8) ? 8 : leafId / 100;
-    unsigned long long thirdParentId = (secondParentId == 8) ? 8 : leafId / 1000;
-    unsigned long long fourthParentId = (thirdParentId == 8) ? 8 : leafId / 10000;
-    unsigned long long fifthParentId = (fourthParentId == 8) ? 8 : leafId / 100000;
 
     // Get the number of levels to fetch from user input.
     int additionalLevelsToFetch = additionalNodes.y;
 
-    // Get more descendants when closer to root.
-    if (_parentNodeOfCamera < 80000) {
-        additionalLevelsToFetch++;
-    }
-
-    // Get the 3^3 closest parents and load all their (eventual) children.
-    for (int x = -1; x <= 1; x += 1) {
-        for (int y = -2; y <= 2; y += 2) {
-            for (int z = -4; z <= 4; z += 4) {
-                // Fetch all stars the 216 closest leaf nodes.
-                findAndFetchNeighborNode(
-                    firstParentId,
-                    x,
-                    y,
-                    z,
-                    additionalLevelsToFetch
-                );
-                // Fetch LOD stars from 208 parents one and two layer(s) up.
-                if (x != 0 || y != 0 || z != 0) {
-                    if (additionalNodes.x > 0) {
-                        findAndFetchNeighborNode(
-                            secondParentId,
-                            x,
-                            y,
-                            z,
-                            additionalLevelsToFetch
-                        );
-                    }
-                    if (additionalNodes.x > 1) {
-                        findAndFetchNeighborNode(
-                            thirdParentId,
-                            x,
-                            y,
-                            z,
-                            additionalLevelsToFetch
-                        );
-                    }
-                    if (additionalNodes.x > 2) {
-                        findAndFetchNeighborNode(
-                            fourthParentId,
-                            x,
-                            y,
-                            z,
-                            additionalLevelsToFetch
-                        );
-                    }
-                    if (additionalNodes.x > 3) {
-                        findAndFetchNeighborNode(
-                            fifthParentId,
-                            x,
-                            y,
-                            z,
-                            additionalLevelsToFetch
-                        );
+    if (cameraMoved) {
+        _parentNodeOfCamera = firstParentId;
+
+        // Nodes that were requested for the old position and that have not been
+        // loaded yet are superseded by the requests for the new position
+        {
+            std::lock_guard g(_ioMutex);
+            _fetchRequests.clear();
+        }
+
+        // Each parent level may be root, make sure to propagate it in that case!
+        unsigned long long secondParentId = (firstParentId == 8) ? 8 : leafId / 100;
+        unsigned long long thirdParentId = (secondParentId == 8) ? 8 : leafId / 1000;
+        unsigned long long fourthParentId = (thirdParentId == 8) ? 8 : leafId / 10000;
+        unsigned long long fifthParentId = (fourthParentId == 8) ? 8 : leafId / 100000;
+
+        // Get more descendants when closer to root.
+        if (_parentNodeOfCamera < 80000) {
+            additionalLevelsToFetch++;
+        }
+
+        // Get the 3^3 closest parents and load all their (eventual) children.
+        for (int x = -1; x <= 1; x += 1) {
+            for (int y = -2; y <= 2; y += 2) {
+                for (int z = -4; z <= 4; z += 4) {
+                    // Fetch all stars the 216 closest leaf nodes.
+                    findAndFetchNeighborNode(
+                        firstParentId,
+                        x,
+                        y,
+                        z,
+                        additionalLevelsToFetch,
+                        fCameraPos
+                    );
+                    // Fetch LOD stars from 208 parents one and two layer(s) up.
+                    if (x != 0 || y != 0 || z != 0) {
+                        if (additionalNodes.x > 0) {
+                            findAndFetchNeighborNode(
+                                secondParentId,
+                                x,
+                                y,
+                                z,
+                                additionalLevelsToFetch,
+                                fCameraPos
+                            );
+                        }
+                        if (additionalNodes.x > 1) {
+                            findAndFetchNeighborNode(
+                                thirdParentId,
+                                x,
+                                y,
+                                z,
+                                additionalLevelsToFetch,
+                                fCameraPos
+                            );
+                        }
+                        if (additionalNodes.x > 2) {
+                            findAndFetchNeighborNode(
+                                fourthParentId,
+                                x,
+                                y,
+                                z,
+                                additionalLevelsToFetch,
+                                fCameraPos
+                            );
+                        }
+                        if (additionalNodes.x > 3) {
+                            findAndFetchNeighborNode(
+                                fifthParentId,
+                                x,
+                                y,
+                                z,
+                                additionalLevelsToFetch,
+                                fCameraPos
+                            );
+                        }
                     }
                 }
             }
         }
     }
 
+    // Prefetch the closest parents around the predicted camera position. As the
+    // priorities are based on the distance to the current camera position, these
+    // requests are handled after the nodes surrounding the camera.
+    if (predictionMoved && predictedParentId != firstParentId) {
+        _predictedParentNodeOfCamera = predictedParentId;
+        for (int x = -1; x <= 1; x += 1) {
+            for (int y = -2; y <= 2; y += 2) {
+                for (int z = -4; z <= 4; z += 4) {
+                    findAndFetchNeighborNode(
+                        predictedParentId,
+                        x,
+                        y,
+                        z,
+                        additionalLevelsToFetch,
+                        fCameraPos
+                    );
+                }
+            }
+        }
+    }
+
     // Check if we should remove any nodes from RAM.
     long long tenthOfRamBudget = _maxCpuRamBudget / 10;
     if (_cpuRamBudget < tenthOfRamBudget) {
         long long bytesToTenthOfRam = tenthOfRamBudget - _cpuRamBudget;
         size_t nNodesToRemove = static_cast<size_t>(bytesToTenthOfRam / chunkSizeInBytes);
         std::vector<unsigned long long> nodesToRemove;
-        while (nNodesToRemove > 0) {
-            // Dequeue nodes that were least recently fetched by findAndFetchNeighborNode.
-            nodesToRemove.push_back(_leastRecentlyFetchedNodes.front());
-            _leastRecentlyFetchedNodes.pop();
-            nNodesToRemove--;
+        {
+            std::lock_guard g(_leastRecentlyFetchedNodesMutex);
+            while (nNodesToRemove > 0 && !_leastRecentlyFetchedNodes.empty()) {
+                // Dequeue nodes that were least recently fetched by
+                // findAndFetchNeighborNode.
+                nodesToRemove.push_back(_leastRecentlyFetchedNodes.front());
+                _leastRecentlyFetchedNodes.pop();
+                nNodesToRemove--;
+            }
         }
         // Use asynchronous removal.
         if (!nodesToRemove.empty()) {
-            std::thread(&OctreeManager::removeNodesFromRam, this, nodesToRemove).detach();
+            enqueueUnloadRequest(std::move(nodesToRemove));
+        }
+    }
+}
+
+OctreeManager::OctreeNode& OctreeManager::findLeafNode(const glm::vec3& position) const {
+    size_t idx = getChildIndex(position.x, position.y, position.z);
+    OctreeNode* node = _root->Children[idx].get();
+
+    while (!node->isLeaf) {
+        idx = getChildIndex(
+            position.x,
+            position.y,
+            position.z,
+            node->originX,
+            node->originY,
+            node->originZ
+        );
+        node = node->Children[idx].get();
+    }
+    return *node;
+}
+
+void OctreeManager::enqueueFetchRequest(std::shared_ptr<OctreeNode> node,
+                                        int additionalLevelsToFetch, float priority)
+{
+    startIoThreads();
+    {
+        std::lock_guard g(_ioMutex);
+        _fetchRequests.push_back({ std::move(node), additionalLevelsToFetch, priority });
+    }
+    _ioCondition.notify_one();
+}
+
+void OctreeManager::enqueueUnloadRequest(std::vector<unsigned long long> nodesToRemove) {
+    startIoThreads();
+    {
+        std::lock_guard g(_ioMutex);
+        _unloadRequests.push_back(std::move(nodesToRemove));
+    }
+    _ioCondition.notify_one();
+}
+
+void OctreeManager::startIoThreads() {
+    if (!_ioThreads.empty()) {
+        return;
+    }
+
+    _stopIoThreads = false;
+    for (unsigned int i = 0; i < NumIoThreads; ++i) {
+        _ioThreads.emplace_back([this]() { handleIoRequests(); });
+    }
+}
+
+void OctreeManager::stopIoThreads() {
+    {
+        std::lock_guard g(_ioMutex);
+        _stopIoThreads = true;
+        _fetchRequests.clear();
+        _unloadRequests.clear();
+    }
+    _ioCondition.notify_all();
+
+    for (std::thread& t : _ioThreads) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    _ioThreads.clear();
+}
+
+void OctreeManager::handleIoRequests() {
+    while (true) {
+        std::vector<unsigned long long> nodesToRemove;
+        FetchRequest request;
+        {
+            std::unique_lock lock(_ioMutex);
+            _ioCondition.wait(lock, [this]() {
+                return _stopIoThreads || !_unloadRequests.empty() ||
+                       !_fetchRequests.empty();
+            });
+
+            if (_stopIoThreads) {
+                return;
+            }
+
+            // Unloading first frees up the RAM budget that the fetches need
+            if (!_unloadRequests.empty()) {
+                nodesToRemove = std::move(_unloadRequests.front());
+                _unloadRequests.pop_front();
+            }
+            else {
+                auto it = std::max_element(
+                    _fetchRequests.begin(),
+                    _fetchRequests.end(),
+                    [](const FetchRequest& lhs, const FetchRequest& rhs) {
+                        return lhs.priority < rhs.priority;
+                    }
+                );
+                request = std::move(*it);
+                _fetchRequests.erase(it);
+            }
+        }
+
+        if (!nodesToRemove.empty()) {
+            removeNodesFromRam(nodesToRemove);
+        }
+        else {
+            fetchChildrenNodes(*request.node, request.additionalLevelsToFetch);
         }
     }
 }
 
 void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, int x,
-                                             int y, int z, int additionalLevelsToFetch)
+                                             int y, int z, int additionalLevelsToFetch,
+                                             const glm::vec3& cameraPos)
 {
     unsigned long long parentId = firstParentId;
     auto indexStack = std::stack<int>();
@@ -384,21 +584,33 @@ void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, i
         indexStack.pop();
     }
 
-    // Fetch all children nodes from found parent. Use multithreading to load files
-    // asynchronously! Detach thread from main execution so it can execute independently.
-    // Thread will then be destroyed when it has finished!
-    std::thread([this, node, additionalLevelsToFetch]() {
-        fetchChildrenNodes(*node, additionalLevelsToFetch);
-    }).detach();
+    // Fetch all children nodes from found parent on one of the I/O threads. Nodes that
+    // are closer to the camera are loaded first
+    const float priority = -glm::distance(
+        cameraPos,
+        glm::vec3(node->originX, node->originY, node->originZ)
+    );
+    enqueueFetchRequest(node, additionalLevelsToFetch, priority);
 }
 
-std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4& mvp,
+void OctreeManager::setFilterRanges(const glm::vec2& posX, const glm::vec2& posY,
+                                    const glm::vec2& posZ, const glm::vec2& distance,
+                                    const glm::vec2& parallax)
+{
+    _filterPosition = { posX, posY, posZ };
+    _filterDistance = distance;
+    _filterParallax = parallax;
+}
+
+std::pmr::map<int, std::vector<float>> OctreeManager::traverseData(
+                                                              const glm::dmat4& mvp,
                                                               const glm::vec2& screenSize,
                                                               int& deltaStars,
                                                               gaia::RenderOption option,
-                                                              float lodPixelThreshold)
+                                                              float lodPixelThreshold,
+                                                      std::pmr::memory_resource* memory)
 {
-    auto renderData = std::map<int, std::vector<float>>();
+    std::pmr::map<int, std::vector<float>> renderData(memory);
     bool innerRebuild = false;
     _minTotalPixelsLod = lodPixelThreshold;
 
@@ -430,12 +642,17 @@ std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4&
             _biggestChunkIndexInUse, _maxStackSize * 4 / 5, _freeSpotsInBuffer.size(),
             _maxStackSize * 5 / 6
         ));
-        initBufferIndexStack(_maxStackSize, _useVBO, _datasetFitInMemory);
+        initBufferIndexStack(
+            _maxStackSize,
+            _useVBO,
+            _datasetFitInMemory,
+            _quantizeData
+        );
         innerRebuild = true;
     }
 
     // Check if entire tree is too small to see, and if so remove it.
-    std::vector<glm::dvec4> corners(8);
+    std::array<glm::dvec4, 8> corners;
     float fMaxDist = static_cast<float>(MAX_DIST);
     for (int i = 0; i < 8; ++i) {
         float x = (i % 2 == 0) ? fMaxDist : -fMaxDist;
@@ -452,11 +669,7 @@ std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4&
     if (totalPixels < _minTotalPixelsLod * 2) {
         // Remove LOD from first layer of children.
         for (int i = 0; i < 8; ++i) {
-            std::map<int, std::vector<float>> tmpData = removeNodeFromCache(
-                *_root->Children[i],
-                deltaStars
-            );
-            renderData.insert(tmpData.begin(), tmpData.end());
+            removeNodeFromCache(*_root->Children[i], deltaStars, renderData);
         }
         return renderData;
     }
@@ -466,12 +679,16 @@ std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4&
             continue;
         }
 
-        std::map<int, std::vector<float>> tmpData = checkNodeIntersection(
+        // Observe that if there exists identical keys in renderData then the values of
+        // this branch will be ignored! Thus we store the removed keys until next render
+        // call!
+        checkNodeIntersection(
             *_root->Children[i],
             mvp,
             screenSize,
             deltaStars,
-            option
+            option,
+            renderData
         );
 
         // Avoid freezing when switching render mode for large datasets by only fetching
@@ -481,23 +698,16 @@ std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4&
             _traversedBranchesInRenderCall++;
             //break;
         }
-
-        // Observe that if there exists identical keys in renderData then those values in
-        // tmpData will be ignored! Thus we store the removed keys until next render call!
-        renderData.insert(tmpData.begin(), tmpData.end());
     }
 
     if (_rebuildBuffer) {
         if (_useVBO) {
             // We need to overwrite bigger indices that had data before! No need for SSBO.
-            std::map<int, std::vector<float>> idxToRemove;
-            for (int idx : _removedKeysInPrevCall) {
-                idxToRemove[idx] = std::vector<float>();
-            }
-
             // This will only insert indices that doesn't already exist in map
             // (i.e. > biggestIdx).
-            renderData.insert(idxToRemove.begin(), idxToRemove.end());
+            for (int idx : _removedKeysInPrevCall) {
+                renderData.try_emplace(idx);
+            }
         }
         if (innerRebuild) {
             deltaStars = 0;
@@ -566,18 +776,16 @@ void OctreeManager::writeNodeToFile(std::ofstream& outFileStream, const OctreeNo
     outFileStream.write(reinterpret_cast<const char*>(&isLeaf), sizeof(bool));
     outFileStream.write(reinterpret_cast<const char*>(&numStars), sizeof(int32_t));
 
-    // Write node data if specified
+    // Write node data if specified. The values are written one attribute after the
+    // other, which produces the same layout as concatenating them without the copy
     if (writeData) {
-        std::vector<float> nodeData = node.posData;
-        nodeData.insert(nodeData.end(), node.colData.begin(), node.colData.end());
-        nodeData.insert(nodeData.end(), node.velData.begin(), node.velData.end());
-        int32_t nDataSize = static_cast<int32_t>(nodeData.size());
-        size_t nBytes = nDataSize * sizeof(nodeData[0]);
-
+        int32_t nDataSize = static_cast<int32_t>(
+            node.posData.size() + node.colData.size() + node.velData.size()
+        );
         outFileStream.write(reinterpret_cast<const char*>(&nDataSize), sizeof(int32_t));
-        if (nDataSize > 0) {
-            outFileStream.write(reinterpret_cast<const char*>(nodeData.data()), nBytes);
-        }
+        writeValues(outFileStream, node.posData);
+        writeValues(outFileStream, node.colData);
+        writeValues(outFileStream, node.velData);
     }
 
     // Write children to file (in Morton order) if we're in an inner node.
@@ -656,18 +864,7 @@ int OctreeManager::readNodeFromFile(std::ifstream& inFileStream, OctreeNode& nod
         inFileStream.read(reinterpret_cast<char*>(&nDataSize), sizeof(int32_t));
 
         if (nDataSize > 0) {
-            std::vector<float> fetchedData(nDataSize, 0.0f);
-            size_t nBytes = nDataSize * sizeof(fetchedData[0]);
-
-            inFileStream.read(reinterpret_cast<char*>(&fetchedData[0]), nBytes);
-
-            int starsInNode = static_cast<int>(nDataSize / _valuesPerStar);
-            auto posEnd = fetchedData.begin() + (starsInNode * POS_SIZE);
-            auto colEnd = posEnd + (starsInNode * COL_SIZE);
-            auto velEnd = colEnd + (starsInNode * VEL_SIZE);
-            node.posData = std::vector<float>(fetchedData.begin(), posEnd);
-            node.colData = std::vector<float>(posEnd, colEnd);
-            node.velData = std::vector<float>(colEnd, velEnd);
+            readNodeData(inFileStream, node, nDataSize);
         }
     }
 
@@ -684,6 +881,23 @@ int OctreeManager::readNodeFromFile(std::ifstream& inFileStream, OctreeNode& nod
     return numStars;
 }
 
+void OctreeManager::readNodeData(std::ifstream& inFileStream, OctreeNode& node,
+                                 int32_t nDataSize)
+{
+    // The data is stored as all positions, followed by all colors and all velocities, so
+    // it can be read directly into the vectors of the node without a temporary buffer
+    const size_t starsInNode = static_cast<size_t>(nDataSize) / _valuesPerStar;
+    readValues(inFileStream, node.posData, starsInNode * POS_SIZE);
+    readValues(inFileStream, node.colData, starsInNode * COL_SIZE);
+    readValues(inFileStream, node.velData, starsInNode * VEL_SIZE);
+
+    // Skip any trailing values that do not make up an entire star
+    const size_t nReadValues = starsInNode * _valuesPerStar;
+    if (static_cast<size_t>(nDataSize) > nReadValues) {
+        inFileStream.ignore((nDataSize - nReadValues) * sizeof(float));
+    }
+}
+
 void OctreeManager::writeToMultipleFiles(const std::string& outFolderPath,
                                          size_t branchIndex)
 {
@@ -697,15 +911,21 @@ void OctreeManager::writeToMultipleFiles(const std::string& outFolderPath,
     clearNodeData(*_root->Children[branchIndex]);
 }
 
+void OctreeManager::writeBranchToFile(std::ofstream& outFileStream, size_t branchIndex) {
+    writeNodeToFile(outFileStream, *_root->Children[branchIndex], false);
+}
+
+int OctreeManager::readBranchFromFile(std::ifstream& inFileStream, size_t branchIndex) {
+    return readNodeFromFile(inFileStream, *_root->Children[branchIndex], false);
+}
+
 void OctreeManager::writeNodeToMultipleFiles(const std::string& outFilePrefix,
                                              OctreeNode& node, bool threadWrites)
 {
-    // Prepare node data, save nothing else.
-    std::vector<float> nodeData = node.posData;
-    nodeData.insert(nodeData.end(), node.colData.begin(), node.colData.end());
-    nodeData.insert(nodeData.end(), node.velData.begin(), node.velData.end());
-    int32_t nDataSize = static_cast<int32_t>(nodeData.size());
-    size_t nBytes = nDataSize * sizeof(nodeData[0]);
+    // Save node data only, nothing else.
+    int32_t nDataSize = static_cast<int32_t>(
+        node.posData.size() + node.colData.size() + node.velData.size()
+    );
 
     // Only open output stream if we have any values to write.
     if (nDataSize > 0) {
@@ -718,7 +938,9 @@ void OctreeManager::writeNodeToMultipleFiles(const std::string& outFilePrefix,
                 reinterpret_cast<const char*>(&nDataSize),
                 sizeof(int32_t)
             );
-            outFileStream.write(reinterpret_cast<const char*>(nodeData.data()), nBytes);
+            writeValues(outFileStream, node.posData);
+            writeValues(outFileStream, node.colData);
+            writeValues(outFileStream, node.velData);
 
             outFileStream.close();
         }
@@ -760,6 +982,10 @@ void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
     // Lock node to make sure nobody else are trying to load the same children.
     std::lock_guard lock(parentNode.loadingLock);
 
+    if (_stopIoThreads) {
+        return;
+    }
+
     for (int i = 0; i < 8; ++i) {
         // Fetch node data if we're streaming and it doesn't exist in RAM yet.
         // (As long as there is any RAM budget left and node actually has any data!)
@@ -794,20 +1020,8 @@ void OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
         // Octree knows if we have any data in this node = it exists.
         // Otherwise don't call this function!
         inFileStream.read(reinterpret_cast<char*>(&nDataSize), sizeof(int32_t));
-
-        std::vector<float> readData(nDataSize, 0.f);
-        int nBytes = nDataSize * sizeof(readData[0]);
-        if (nDataSize > 0) {
-            inFileStream.read(reinterpret_cast<char*>(&readData[0]), nBytes);
-        }
-
-        int starsInNode = static_cast<int>(nDataSize / _valuesPerStar);
-        auto posEnd = readData.begin() + (starsInNode * POS_SIZE);
-        auto colEnd = posEnd + (starsInNode * COL_SIZE);
-        auto velEnd = colEnd + (starsInNode * VEL_SIZE);
-        node.posData = std::vector<float>(readData.begin(), posEnd);
-        node.colData = std::vector<float>(posEnd, colEnd);
-        node.velData = std::vector<float>(colEnd, velEnd);
+        int nBytes = nDataSize * sizeof(float);
+        readNodeData(inFileStream, node, nDataSize);
 
         // Keep track of nodes that are loaded and update CPU RAM budget.
         node.isLoaded = true;
@@ -932,6 +1146,20 @@ size_t OctreeManager::numFreeSpotsInBuffer() const {
     return _freeSpotsInBuffer.size();
 }
 
+size_t OctreeManager::numNodesInRam() const {
+    std::lock_guard g(_leastRecentlyFetchedNodesMutex);
+    return _leastRecentlyFetchedNodes.size();
+}
+
+size_t OctreeManager::numNodesInBuffer() const {
+    return _maxStackSize - std::min(_freeSpotsInBuffer.size(), _maxStackSize);
+}
+
+size_t OctreeManager::numPendingFetchRequests() const {
+    std::lock_guard g(_ioMutex);
+    return _fetchRequests.size();
+}
+
 long long OctreeManager::cpuRamBudget() const {
     return _cpuRamBudget;
 }
@@ -963,9 +1191,12 @@ bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& sta
         // Node is a leaf and it's not yet full -> insert star.
         storeStarData(node, starValues);
 
-        if (depth > _totalDepth) {
-            _totalDepth = depth;
-        }
+        // Other branches may be inserted into concurrently
+        const size_t nodeDepth = static_cast<size_t>(depth);
+        size_t totalDepth = _totalDepth;
+        while (nodeDepth > totalDepth &&
+               !_totalDepth.compare_exchange_weak(totalDepth, nodeDepth))
+        {}
         return true;
     }
     else if (node.isLeaf) {
@@ -973,12 +1204,15 @@ bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& sta
         // Create children and clean up parent.
         createNodeChildren(node);
 
-        // Distribute stars from parent node into children.
+        // Distribute stars from parent node into children. The same buffer is reused
+        // for all stars to avoid one allocation per star.
+        std::vector<float> tmpValues;
+        tmpValues.reserve(POS_SIZE + COL_SIZE + VEL_SIZE);
         for (size_t n = 0; n < MAX_STARS_PER_NODE; ++n) {
             // Position data.
             auto posBegin = node.posData.begin() + n * POS_SIZE;
             auto posEnd = posBegin + POS_SIZE;
-            std::vector<float> tmpValues(posBegin, posEnd);
+            tmpValues.assign(posBegin, posEnd);
             // Color data.
             auto colBegin = node.colData.begin() + n * COL_SIZE;
             auto colEnd = colBegin + COL_SIZE;
@@ -1036,6 +1270,9 @@ void OctreeManager::sliceNodeLodCache(OctreeNode& node) {
         std::vector<float> tmpPos;
         std::vector<float> tmpCol;
         std::vector<float> tmpVel;
+        tmpPos.reserve(node.magOrder.size() * POS_SIZE);
+        tmpCol.reserve(node.magOrder.size() * COL_SIZE);
+        tmpVel.reserve(node.magOrder.size() * VEL_SIZE);
         // Ordered map contain the MAX_STARS_PER_NODE brightest stars in all children!
         for (auto const &[absMag, placement] : node.magOrder) {
             auto posBegin = node.posData.begin() + placement * POS_SIZE;
@@ -1098,17 +1335,15 @@ std::string OctreeManager::printStarsPerNode(const OctreeNode& node,
     }
 }
 
-std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNode& node,
-                                                                    const glm::dmat4& mvp,
-                                                              const glm::vec2& screenSize,
-                                                                          int& deltaStars,
-                                                                gaia::RenderOption option)
+void OctreeManager::checkNodeIntersection(OctreeNode& node, const glm::dmat4& mvp,
+                                          const glm::vec2& screenSize, int& deltaStars,
+                                          gaia::RenderOption option,
+                                      std::pmr::map<int, std::vector<float>>& fetchedData)
 {
-    std::map<int, std::vector<float>> fetchedData;
     //int depth  = static_cast<int>(log2( MAX_DIST / node->halfDimension ));
 
     // Calculate the corners of the node.
-    std::vector<glm::dvec4> corners(8);
+    std::array<glm::dvec4, 8> corners;
     for (int i = 0; i < 8; ++i) {
         const float x = (i % 2 == 0) ?
             node.originX + node.halfDimension :
@@ -1127,8 +1362,15 @@ std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNod
     if (!(_culler->isVisible(corners, mvp))) {
         // Check if this node or any of its children existed in cache previously.
         // If so, then remove them from cache and add those indices to stack.
-        fetchedData = removeNodeFromCache(node, deltaStars);
-        return fetchedData;
+        removeNodeFromCache(node, deltaStars, fetchedData);
+        return;
+    }
+
+    // Don't stream nodes in which every star would be discarded by the filters. Nodes
+    // that come back into the filter ranges are streamed again like any other node.
+    if (isFilteredOut(node, option)) {
+        removeNodeFromCache(node, deltaStars, fetchedData);
+        return;
     }
 
     // Remove node if it has been unloaded while still in view.
@@ -1136,8 +1378,8 @@ std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNod
     if (node.bufferIndex != DEFAULT_INDEX && !node.isLoaded && _streamOctree &&
         !_datasetFitInMemory)
     {
-        fetchedData = removeNodeFromCache(node, deltaStars);
-        return fetchedData;
+        removeNodeFromCache(node, deltaStars, fetchedData);
+        return;
     }
 
     // Take care of inner nodes.
@@ -1157,26 +1399,23 @@ std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNod
             if ((node.bufferIndex == DEFAULT_INDEX) || _rebuildBuffer) {
                 // Return empty if we couldn't claim a buffer stream index.
                 if (!updateBufferIndex(node)) {
-                    return fetchedData;
+                    return;
                 }
 
                 // We're in an inner node, remove indices from potential children in cache
                 for (int i = 0; i < 8; ++i) {
-                    std::map<int, std::vector<float>> tmpData = removeNodeFromCache(
-                        *node.Children[i],
-                        deltaStars
-                    );
-                    fetchedData.insert(tmpData.begin(), tmpData.end());
+                    removeNodeFromCache(*node.Children[i], deltaStars, fetchedData);
                 }
 
                 // Insert data and adjust stars added in this frame.
-                fetchedData[node.bufferIndex] = constructInsertData(
-                    node,
-                    option,
-                    deltaStars
+                fetchedData.try_emplace(
+                    node.bufferIndex,
+                    _quantizeData ?
+                        constructQuantizedInsertData(node, option, deltaStars) :
+                        constructInsertData(node, option, deltaStars)
                 );
             }
-            return fetchedData;
+            return;
         }
     }
     // Return node data if node is a leaf.
@@ -1185,47 +1424,103 @@ std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNod
         if ((node.bufferIndex == DEFAULT_INDEX) || _rebuildBuffer) {
             // Return empty if we couldn't claim a buffer stream index.
             if (!updateBufferIndex(node)) {
-                return fetchedData;
+                return;
             }
 
             // Insert data and adjust stars added in this frame.
-            fetchedData[node.bufferIndex] = constructInsertData(
-                node,
-                option,
-                deltaStars
+            fetchedData.try_emplace(
+                node.bufferIndex,
+                _quantizeData ?
+                    constructQuantizedInsertData(node, option, deltaStars) :
+                    constructInsertData(node, option, deltaStars)
             );
         }
-        return fetchedData;
+        return;
     }
 
     // We're in a big, visible inner node -> remove it from cache if it existed.
     // But not its children -> set recursive check to false.
-    fetchedData = removeNodeFromCache(node, deltaStars, false);
+    removeNodeFromCache(node, deltaStars, fetchedData, false);
 
     // Recursively check if children should be rendered.
     for (size_t i = 0; i < 8; ++i) {
-        // Observe that if there exists identical keys in fetchedData then those values in
-        // tmpData will be ignored! Thus we store the removed keys until next render call!
-        std::map<int, std::vector<float>> tmpData = checkNodeIntersection(
+        // Observe that if there exists identical keys in fetchedData then the values of
+        // the child will be ignored! Thus we store the removed keys until next render
+        // call!
+        checkNodeIntersection(
             *node.Children[i],
             mvp,
             screenSize,
             deltaStars,
-            option
+            option,
+            fetchedData
         );
-        fetchedData.insert(tmpData.begin(), tmpData.end());
     }
-    return fetchedData;
 }
 
-std::map<int, std::vector<float>> OctreeManager::removeNodeFromCache(OctreeNode& node,
-                                                                     int& deltaStars,
-                                                                     bool recursive)
+bool OctreeManager::isFilteredOut(const OctreeNode& node,
+                                  gaia::RenderOption option) const
 {
-    std::map<int, std::vector<float>> keysToRemove;
+    constexpr const float Inf = std::numeric_limits<float>::infinity();
+
+    // The nodes at the border of the Octree also contain the stars outside of it
+    const float border = static_cast<float>(MAX_DIST);
+    const glm::vec3 origin = glm::vec3(node.originX, node.originY, node.originZ);
+    glm::vec3 minCorner = origin - node.halfDimension;
+    glm::vec3 maxCorner = origin + node.halfDimension;
+    for (int i = 0; i < 3; ++i) {
+        if (minCorner[i] <= -border) {
+            minCorner[i] = -Inf;
+        }
+        if (maxCorner[i] >= border) {
+            maxCorner[i] = Inf;
+        }
+    }
 
+    // A bound that is 0 is unbounded
+    auto isOutside = [](float minValue, float maxValue, const glm::vec2& range) {
+        return (std::abs(range.x) > FilterEps && maxValue < range.x) ||
+               (std::abs(range.y) > FilterEps && minValue > range.y);
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        if (isOutside(minCorner[i], maxCorner[i], _filterPosition[i])) {
+            return true;
+        }
+    }
+
+    if (option == gaia::RenderOption::Motion) {
+        return false;
+    }
+
+    // Closest and farthest distance to the Sun of any point in the node
+    const glm::vec3 closest = glm::clamp(glm::vec3(0.f), minCorner, maxCorner);
+    const float minDist = glm::length(closest);
+    const float maxDist = glm::length(glm::max(glm::abs(minCorner), glm::abs(maxCorner)));
+
+    if (std::abs(_filterDistance.x - _filterDistance.y) > FilterEps &&
+        isOutside(minDist, maxDist, _filterDistance))
+    {
+        return true;
+    }
+
+    // The parallax [mas] is the inverse of the distance [kPc]
+    if (std::abs(_filterParallax.x - _filterParallax.y) > FilterEps) {
+        const float minParallax = 1.f / std::max(maxDist, FilterEps);
+        const float maxParallax = 1.f / std::max(minDist, FilterEps);
+        if (isOutside(minParallax, maxParallax, _filterParallax)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void OctreeManager::removeNodeFromCache(OctreeNode& node, int& deltaStars,
+                                     std::pmr::map<int, std::vector<float>>& keysToRemove,
+                                        bool recursive)
+{
     // If we're in rebuilding mode then there is no need to remove any nodes.
-    //if (_rebuildBuffer) return keysToRemove;
+    //if (_rebuildBuffer) return;
 
     // Check if this node was rendered == had a specified index.
     if (node.bufferIndex != DEFAULT_INDEX) {
@@ -1234,7 +1529,7 @@ std::map<int, std::vector<float>> OctreeManager::removeNodeFromCache(OctreeNode&
         _removedKeysInPrevCall.insert(node.bufferIndex);
 
         // Insert dummy node at offset index that should be removed from render.
-        keysToRemove[node.bufferIndex] = std::vector<float>();
+        keysToRemove.try_emplace(node.bufferIndex);
 
         // Reset index and adjust stars removed this frame.
         node.bufferIndex = DEFAULT_INDEX;
@@ -1244,14 +1539,9 @@ std::map<int, std::vector<float>> OctreeManager::removeNodeFromCache(OctreeNode&
     // Check children recursively if we're in an inner node.
     if (!(node.isLeaf) && recursive) {
         for (int i = 0; i < 8; ++i) {
-            std::map<int, std::vector<float>> tmpData = removeNodeFromCache(
-                *node.Children[i],
-                deltaStars
-            );
-            keysToRemove.insert(tmpData.begin(), tmpData.end());
+            removeNodeFromCache(*node.Children[i], deltaStars, keysToRemove);
         }
     }
-    return keysToRemove;
 }
 
 std::vector<float> OctreeManager::getNodeData(const OctreeNode& node,
@@ -1294,19 +1584,15 @@ void OctreeManager::clearNodeData(OctreeNode& node) {
 }
 
 void OctreeManager::createNodeChildren(OctreeNode& node) {
+    allocateNodeChildren(node);
     for (size_t i = 0; i < 8; ++i) {
         _numLeafNodes++;
-        node.Children[i] = std::make_shared<OctreeNode>();
         node.Children[i]->isLeaf = true;
         node.Children[i]->isLoaded = false;
         node.Children[i]->hasLoadedDescendant = false;
         node.Children[i]->bufferIndex = DEFAULT_INDEX;
         node.Children[i]->octreePositionIndex = (node.octreePositionIndex * 10) + i;
         node.Children[i]->numStars = 0;
-        node.Children[i]->posData = std::vector<float>();
-        node.Children[i]->colData = std::vector<float>();
-        node.Children[i]->velData = std::vector<float>();
-        node.Children[i]->magOrder = std::vector<std::pair<float, size_t>>();
         node.Children[i]->halfDimension = node.halfDimension / 2.f;
 
         // Calculate new origin.
@@ -1330,6 +1616,14 @@ void OctreeManager::createNodeChildren(OctreeNode& node) {
     _numInnerNodes++;
 }
 
+void OctreeManager::allocateNodeChildren(OctreeNode& node) {
+    std::shared_ptr<NodeBlock> block = std::make_shared<NodeBlock>();
+    for (size_t i = 0; i < 8; ++i) {
+        // Aliasing constructor, the child refers into the block but owns all of it
+        node.Children[i] = std::shared_ptr<OctreeNode>(block, &block->nodes[i]);
+    }
+}
+
 bool OctreeManager::updateBufferIndex(OctreeNode& node) {
     if (node.bufferIndex != DEFAULT_INDEX) {
         // If we're rebuilding Buffer Index Cache then store indices to overwrite later.
@@ -1396,4 +1690,75 @@ std::vector<float> OctreeManager::constructInsertData(const OctreeNode& node,
     return insertData;
 }
 
+std::vector<float> OctreeManager::constructQuantizedInsertData(const OctreeNode& node,
+                                                               gaia::RenderOption option,
+                                                               int& deltaStars)
+{
+    // Return early if node doesn't contain any stars!
+    if (node.numStars == 0) {
+        return std::vector<float>();
+    }
+
+    const size_t nStars = node.posData.size() / POS_SIZE;
+    const size_t nSlots = _useVBO ? MAX_STARS_PER_NODE : nStars;
+
+    // The border nodes swallow the stars that fall outside of the Octree, so the scale
+    // has to be widened to reach the farthest star of the node
+    const glm::vec3 origin = glm::vec3(node.originX, node.originY, node.originZ);
+    float scale = node.halfDimension;
+    for (size_t i = 0; i < nStars; ++i) {
+        const glm::vec3 offset = glm::abs(
+            glm::make_vec3(&node.posData[i * POS_SIZE]) - origin
+        );
+        scale = std::max({ scale, offset.x, offset.y, offset.z });
+    }
+
+    std::vector<float> insertData;
+    insertData.reserve(
+        QUANTIZED_BOUNDS_SIZE +
+        nSlots * (QUANTIZED_POS_SIZE + QUANTIZED_COL_SIZE + QUANTIZED_VEL_SIZE)
+    );
+    insertData.insert(insertData.end(), { origin.x, origin.y, origin.z, scale });
+
+    auto appendPacked = [&insertData](glm::uint value) {
+        insertData.push_back(glm::uintBitsToFloat(value));
+    };
+    // Fill chunk by appending zeroes so we overwrite possible earlier values, which also
+    // clears the flag of the positions in the empty slots
+    auto fillChunk = [&](size_t valuesPerStar) {
+        if (_useVBO) {
+            insertData.resize(insertData.size() + (nSlots - nStars) * valuesPerStar, 0.f);
+        }
+    };
+
+    for (size_t i = 0; i < nStars; ++i) {
+        const glm::vec3 pos =
+            (glm::make_vec3(&node.posData[i * POS_SIZE]) - origin) / scale;
+        appendPacked(glm::packSnorm2x16(glm::vec2(pos.x, pos.y)));
+        appendPacked(glm::packSnorm2x16(glm::vec2(pos.z, 1.f)));
+    }
+    fillChunk(QUANTIZED_POS_SIZE);
+
+    if (option != gaia::RenderOption::Static) {
+        for (size_t i = 0; i < nStars; ++i) {
+            appendPacked(glm::packHalf2x16(glm::make_vec2(&node.colData[i * COL_SIZE])));
+        }
+        fillChunk(QUANTIZED_COL_SIZE);
+
+        if (option == gaia::RenderOption::Motion) {
+            for (size_t i = 0; i < nStars; ++i) {
+                const glm::vec3 vel =
+                    glm::make_vec3(&node.velData[i * VEL_SIZE]) / 1000.f;
+                appendPacked(glm::packHalf2x16(glm::vec2(vel.x, vel.y)));
+                appendPacked(glm::packHalf2x16(glm::vec2(vel.z, 0.f)));
+            }
+            fillChunk(QUANTIZED_VEL_SIZE);
+        }
+    }
+
+    // Update deltaStars.
+    deltaStars += static_cast<int>(node.numStars);
+    return insertData;
+}
+
 }  // namespace openspace
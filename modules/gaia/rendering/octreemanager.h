@@ -28,10 +28,16 @@
 #include <modules/gaia/rendering/gaiaoptions.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <memory_resource>
 #include <mutex>
 #include <queue>
 #include <stack>
+#include <thread>
 #include <vector>
 
 namespace openspace {
@@ -60,7 +66,7 @@ public:
     };
 
     OctreeManager() = default;
-    ~OctreeManager() = default;
+    ~OctreeManager();
 
     /**
      * Initializes a one layer Octree with root and 8 children that covers all stars.
@@ -76,12 +82,16 @@ public:
      *
      * \param useVBO defines if VBO or SSBO is used as buffer(s)
      * \param datasetFitInMemory defines if streaming of nodes during runtime is used
+     * \param quantizeData defines if the chunks are packed into 16-bit values, see
+     *        <code>constructQuantizedInsertData()</code>
      */
-    void initBufferIndexStack(long long maxNodes, bool useVBO, bool datasetFitInMemory);
+    void initBufferIndexStack(long long maxNodes, bool useVBO, bool datasetFitInMemory,
+        bool quantizeData = false);
 
     /**
      * Inserts star values in correct position in Octree. Makes use of a recursive
      * traversal strategy. Internally calls <code>insertInNode()</code>
+     * Stars that belong to different branches may be inserted from different threads.
      */
     void insert(const std::vector<float>& starValues);
 
@@ -116,11 +126,21 @@ public:
      * The corresponding integer key is the index where chunk should be inserted into
      * streaming buffer. Calls <code>checkNodeIntersection()</code> for every branch.
      * \pdeltaStars keeps track of how many stars that were added/removed this render
-     * call.
+     * call. The nodes of the returned map are allocated from \p memory.
      */
-    std::map<int, std::vector<float>> traverseData(const glm::dmat4& mvp,
+    std::pmr::map<int, std::vector<float>> traverseData(const glm::dmat4& mvp,
         const glm::vec2& screenSize, int& deltaStars, gaia::RenderOption option,
-        float lodPixelThreshold);
+        float lodPixelThreshold,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * Sets the filter ranges that <code>traverseData()</code> uses to skip nodes whose
+     * stars would all be discarded by the filters in the shaders. \p posX, \p posY,
+     * \p posZ and \p distance are measured in kPc and \p parallax in mas. A bound that
+     * is 0 is unbounded, just as in gaia_filter.glsl.
+     */
+    void setFilterRanges(const glm::vec2& posX, const glm::vec2& posY,
+        const glm::vec2& posZ, const glm::vec2& distance, const glm::vec2& parallax);
 
     /**
      * Builds full render data structure by traversing all leaves in the Octree.
@@ -158,6 +178,20 @@ public:
      */
     void writeToMultipleFiles(const std::string& outFolderPath, size_t branchIndex);
 
+    /**
+     * Write the structure of the branch with index \param branchIndex to a binary file,
+     * without any data. Can be used to restore the branch with
+     * <code>readBranchFromFile()</code>.
+     */
+    void writeBranchToFile(std::ofstream& outFileStream, size_t branchIndex);
+
+    /**
+     * Read the structure of the branch with index \param branchIndex from a file that
+     * was written by <code>writeBranchToFile()</code>. The branch has to be empty.
+     * \returns the total number of stars in the branch.
+     */
+    int readBranchFromFile(std::ifstream& inFileStream, size_t branchIndex);
+
     /**
      * Getters.
      */
@@ -171,15 +205,41 @@ public:
     size_t numFreeSpotsInBuffer() const;
     bool isRebuildOngoing() const;
 
+    /**
+     * \returns the number of nodes whose data has been streamed into RAM and that have
+     * not been unloaded yet. Is always 0 if the dataset is not streamed.
+     */
+    size_t numNodesInRam() const;
+
+    /**
+     * \returns the number of nodes that currently occupy a chunk of the GPU buffer.
+     */
+    size_t numNodesInBuffer() const;
+
+    /**
+     * \returns the number of fetch requests that are waiting for an I/O thread.
+     */
+    size_t numPendingFetchRequests() const;
+
     /**
      * \returns current CPU RAM budget in bytes.
      */
     long long cpuRamBudget() const;
 
 private:
+    // Siblings are always created together and are visited together when traversing
+    // the Octree, so they are stored next to each other in a single allocation
+    struct NodeBlock {
+        OctreeNode nodes[8];
+    };
+
     const size_t POS_SIZE = 3;
     const size_t COL_SIZE = 2;
     const size_t VEL_SIZE = 3;
+    const size_t QUANTIZED_BOUNDS_SIZE = 4;
+    const size_t QUANTIZED_POS_SIZE = 2;
+    const size_t QUANTIZED_COL_SIZE = 1;
+    const size_t QUANTIZED_VEL_SIZE = 2;
 
     // MAX_DIST [kPc] - Determines the depth of Octree together with MAX_STARS_PER_NODE.
     // A smaller distance is better (i.e. a smaller total depth) and a smaller MAX_STARS
@@ -240,20 +300,29 @@ private:
      * nodes intersect with the view frustum (interpreted as an AABB) and decides if data
      * should be optimized away or not. Keeps track of which nodes that are visible and
      * loaded (if streaming). \param deltaStars keeps track of how many stars that were
-     * added/removed this render call.
+     * added/removed this render call. The data is added to \p fetchedData, in which
+     * already existing keys are not overwritten.
+     */
+    void checkNodeIntersection(OctreeNode& node, const glm::dmat4& mvp,
+        const glm::vec2& screenSize, int& deltaStars, gaia::RenderOption option,
+        std::pmr::map<int, std::vector<float>>& fetchedData);
+
+    /**
+     * \returns true if all stars in \p node lie outside of the filter ranges set by
+     * <code>setFilterRanges()</code>. The distance filters are evaluated on the moved
+     * positions of the stars in the shaders, so they are only used if \p option is not
+     * <code>gaia::RenderOption::Motion</code>.
      */
-    std::map<int, std::vector<float>> checkNodeIntersection(OctreeNode& node,
-        const glm::dmat4& mvp, const glm::vec2& screenSize, int& deltaStars,
-        gaia::RenderOption option);
+    bool isFilteredOut(const OctreeNode& node, gaia::RenderOption option) const;
 
     /**
      * Checks if specified node existed in cache, and removes it if that's the case.
      * If node is an inner node then all children will be checked recursively as well as
      * long as \param recursive is not set to false. \param deltaStars keeps track of how
-     * many stars that were removed.
+     * many stars that were removed. The removed keys are added to \p keysToRemove.
      */
-    std::map<int, std::vector<float>> removeNodeFromCache(OctreeNode& node,
-        int& deltaStars, bool recursive = true);
+    void removeNodeFromCache(OctreeNode& node, int& deltaStars,
+        std::pmr::map<int, std::vector<float>>& keysToRemove, bool recursive = true);
 
     /**
      * Get data in node and its descendants regardless if they are visible or not.
@@ -270,6 +339,12 @@ private:
      */
     void createNodeChildren(OctreeNode& node);
 
+    /**
+     * Allocates all eight children of \param node in one contiguous block. The children
+     * share ownership of the block, which is released when the last child is destroyed.
+     */
+    void allocateNodeChildren(OctreeNode& node);
+
     /**
      * Checks if node should be inserted into stream or not. \returns true if it should,
      * (i.e. it doesn't already exists, there is room for it in the buffer and node data
@@ -287,6 +362,20 @@ private:
     std::vector<float> constructInsertData(const OctreeNode& node,
         gaia::RenderOption option, int& deltaStars);
 
+    /**
+     * Same as <code>constructInsertData()</code>, but the star values are packed into
+     * 32-bit words that are stored bit for bit in the returned floats. The chunk starts
+     * with QUANTIZED_BOUNDS_SIZE floats with the origin and the scale of the node. The
+     * positions follow as normalized 16-bit offsets from that origin, with a fourth
+     * component that is 1 for every star so that zero-filled slots can be told apart.
+     * Magnitude and color are stored as two half floats and the velocity as half floats
+     * in km/s, as the values in m/s would overflow their range.
+     *
+     * \param deltaStars keeps track of how many stars that were added.
+     */
+    std::vector<float> constructQuantizedInsertData(const OctreeNode& node,
+        gaia::RenderOption option, int& deltaStars);
+
     /**
      * Write a node to outFileStream. \param writeData defines if data should be included
      * or if only structure should be written.
@@ -301,6 +390,12 @@ private:
      */
     int readNodeFromFile(std::ifstream& inFileStream, OctreeNode& node, bool readData);
 
+    /**
+     * Reads \p nDataSize values of star data from \p inFileStream directly into the
+     * data vectors of \p node, without going through an intermediate buffer.
+     */
+    void readNodeData(std::ifstream& inFileStream, OctreeNode& node, int32_t nDataSize);
+
     /**
      * Write node data to a file. \param outFilePrefix specifies the accumulated path
      * and name of the file. If \param threadWrites is set to true then one new thread
@@ -313,10 +408,46 @@ private:
      * Finds the neighboring node on the same level (or a higher level if there is no
      * corresponding level) in the specified direction. Also fetches data from found node
      * if it's not already loaded. \param additionalLevelsToFetch determines if any
-     * descendants of the found node should be fetched as well (if they exists).
+     * descendants of the found node should be fetched as well (if they exists). The
+     * fetch is queued on the I/O threads with a priority based on the distance between
+     * the found node and \param cameraPos (in kPc).
      */
     void findAndFetchNeighborNode(unsigned long long firstParentId, int x, int y, int z,
-        int additionalLevelsToFetch);
+        int additionalLevelsToFetch, const glm::vec3& cameraPos);
+
+    /**
+     * Returns the leaf node that contains \param position (in kPc).
+     */
+    OctreeNode& findLeafNode(const glm::vec3& position) const;
+
+    /**
+     * Queues the fetch of the children of \param node on the I/O threads. Requests with
+     * a higher \param priority are handled first.
+     */
+    void enqueueFetchRequest(std::shared_ptr<OctreeNode> node,
+        int additionalLevelsToFetch, float priority);
+
+    /**
+     * Queues the removal of \param nodesToRemove from RAM on the I/O threads. Removals
+     * are handled before any fetch requests.
+     */
+    void enqueueUnloadRequest(std::vector<unsigned long long> nodesToRemove);
+
+    /**
+     * Starts the I/O threads if they are not already running.
+     */
+    void startIoThreads();
+
+    /**
+     * Discards all queued requests and waits for the I/O threads to finish.
+     */
+    void stopIoThreads();
+
+    /**
+     * Loop executed by each I/O thread that handles queued requests until
+     * <code>stopIoThreads()</code> is called.
+     */
+    void handleIoRequests();
 
     /**
      * Fetches data from all children of \param parentNode, as long as it's not already
@@ -360,23 +491,44 @@ private:
     std::stack<int> _freeSpotsInBuffer;
     std::set<int> _removedKeysInPrevCall;
     std::queue<unsigned long long> _leastRecentlyFetchedNodes;
-    std::mutex _leastRecentlyFetchedNodesMutex;
+    mutable std::mutex _leastRecentlyFetchedNodesMutex;
 
-    size_t _totalDepth = 0;
-    size_t _numLeafNodes = 0;
-    size_t _numInnerNodes = 0;
+    struct FetchRequest {
+        std::shared_ptr<OctreeNode> node;
+        int additionalLevelsToFetch = 0;
+        float priority = 0.f;
+    };
+    std::vector<FetchRequest> _fetchRequests;
+    std::deque<std::vector<unsigned long long>> _unloadRequests;
+    mutable std::mutex _ioMutex;
+    std::condition_variable _ioCondition;
+    std::vector<std::thread> _ioThreads;
+    std::atomic_bool _stopIoThreads = false;
+
+    std::atomic<size_t> _totalDepth = 0;
+    std::atomic<size_t> _numLeafNodes = 0;
+    std::atomic<size_t> _numInnerNodes = 0;
     size_t _biggestChunkIndexInUse = 0;
     size_t _valuesPerStar = 0;
     float _minTotalPixelsLod = 0.f;
+    std::array<glm::vec2, 3> _filterPosition = {
+        glm::vec2(0.f), glm::vec2(0.f), glm::vec2(0.f)
+    };
+    glm::vec2 _filterDistance = glm::vec2(0.f);
+    glm::vec2 _filterParallax = glm::vec2(0.f);
 
     size_t _maxStackSize = 0;
     bool _rebuildBuffer = false;
     bool _useVBO = false;
+    bool _quantizeData = false;
     bool _streamOctree = false;
     bool _datasetFitInMemory = false;
-    long long _cpuRamBudget = 0;
+    std::atomic<long long> _cpuRamBudget = 0;
     long long _maxCpuRamBudget = 0;
     unsigned long long _parentNodeOfCamera = 8;
+    unsigned long long _predictedParentNodeOfCamera = 8;
+    glm::dvec3 _previousCameraPos = glm::dvec3(0.0);
+    bool _hasPreviousCameraPos = false;
     std::string _streamFolderPath;
     size_t _traversedBranchesInRenderCall = 0;
 
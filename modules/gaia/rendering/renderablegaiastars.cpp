@@ -54,6 +54,14 @@ namespace {
     constexpr size_t ColorSize = 2;
     constexpr size_t VelocitySize = 3;
 
+    // Number of 32-bit words per star in a quantized stream, see
+    // OctreeManager::constructQuantizedInsertData
+    constexpr size_t QuantizedPositionSize = 2;
+    constexpr size_t QuantizedColorSize = 1;
+    constexpr size_t QuantizedVelocitySize = 2;
+    // The origin and scale of the node that precede the values of a quantized chunk
+    constexpr size_t NodeBoundsSize = 4;
+
     constexpr openspace::properties::Property::PropertyInfo FilePathInfo = {
         "File",
         "File Path",
@@ -295,11 +303,60 @@ namespace {
         "if max is set to 0.0 it is read as +Inf). Measured in kParsec."
     };
 
+    constexpr openspace::properties::Property::PropertyInfo FilterParallaxInfo = {
+        "FilterParallax",
+        "Parallax Threshold",
+        "If defined then only stars with parallaxes between [min, max] will be "
+        "rendered (if min is set to 0.0 it is read as -Inf, if max is set to 0.0 it is "
+        "read as +Inf). The parallaxes are derived from the distances of the stars. "
+        "Measured in milliarcseconds."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo ReportGlErrorsInfo = {
         "ReportGlErrors",
         "Report GL Errors",
         "If set to true, any OpenGL errors will be reported if encountered"
     };
+
+    constexpr openspace::properties::Property::PropertyInfo QuantizeDataInfo = {
+        "QuantizeData",
+        "Quantize Data",
+        "If set to true, the stars are streamed to the GPU as 16-bit positions relative "
+        "to their octree node and half float magnitudes, colors and velocities. This "
+        "lowers the precision of the values, but reduces the GPU memory per star by "
+        "about 40 percent, which lets more stars fit into the stream budget."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo UseComputeSplattingInfo = {
+        "UseComputeSplatting",
+        "Use Compute Splatting",
+        "If set to true and one of the SSBO shader options is used, the stars are "
+        "rendered with compute shaders that add the light of faint stars directly into "
+        "the pixels and only draw the point spread function for bright stars. This is "
+        "not used for the 'Static' render option, as it has no magnitudes."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo SplatExposureInfo = {
+        "SplatExposure",
+        "Splat Exposure",
+        "The factor from the flux of a star, relative to a star with an apparent "
+        "magnitude of 0, to the intensity of its pixels when using compute splatting."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo BrightStarThresholdInfo = {
+        "SplatBrightStarThreshold",
+        "Splat Bright Star Threshold",
+        "Stars whose intensity is larger than this value are drawn with the point "
+        "spread function when using compute splatting, all others are added into the "
+        "pixels they cover."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo SplatPsfRadiusInfo = {
+        "SplatPsfRadius",
+        "Splat Point Spread Function Radius",
+        "The radius in pixels of the point spread function of a star whose intensity "
+        "is equal to the bright star threshold when using compute splatting."
+    };
 }  // namespace
 
 namespace openspace {
@@ -490,11 +547,29 @@ documentation::Documentation RenderableGaiaStars::Documentation() {
                 Optional::Yes,
                 FilterDistInfo.description
             },
+            {
+                FilterParallaxInfo.identifier,
+                new Vector2Verifier<double>,
+                Optional::Yes,
+                FilterParallaxInfo.description
+            },
             {
                 ReportGlErrorsInfo.identifier,
                 new BoolVerifier,
                 Optional::Yes,
                 ReportGlErrorsInfo.description
+            },
+            {
+                QuantizeDataInfo.identifier,
+                new BoolVerifier,
+                Optional::Yes,
+                QuantizeDataInfo.description
+            },
+            {
+                UseComputeSplattingInfo.identifier,
+                new BoolVerifier,
+                Optional::Yes,
+                UseComputeSplattingInfo.description
             }
         }
     };
@@ -530,6 +605,12 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     , _gMagThreshold(FilterGMagInfo, glm::vec2(20.f), glm::vec2(-10.f), glm::vec2(30.f))
     , _bpRpThreshold(FilterBpRpInfo, glm::vec2(0.f), glm::vec2(-10.f), glm::vec2(30.f))
     , _distThreshold(FilterDistInfo, glm::vec2(0.f), glm::vec2(0.f), glm::vec2(100.f))
+    , _parallaxThreshold(
+        FilterParallaxInfo,
+        glm::vec2(0.f),
+        glm::vec2(0.f),
+        glm::vec2(1000.f)
+    )
     , _firstRow(FirstRowInfo, 0, 0, 2539913) // DR1-max: 2539913
     , _lastRow(LastRowInfo, 0, 0, 2539913)
     , _columnNamesList(ColumnNamesInfo)
@@ -537,6 +618,12 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     , _cpuRamBudgetProperty(CpuRamBudgetInfo, 0.f, 0.f, 1.f)
     , _gpuStreamBudgetProperty(GpuStreamBudgetInfo, 0.f, 0.f, 1.f)
     , _reportGlErrors(ReportGlErrorsInfo, false)
+    , _quantizeData(QuantizeDataInfo, false)
+    , _useComputeSplatting(UseComputeSplattingInfo, false)
+    , _splatExposure(SplatExposureInfo, 1e3f, 1.f, 1e8f)
+    , _splatBrightStarThreshold(BrightStarThresholdInfo, 1.f, 0.01f, 100.f)
+    , _splatPsfRadius(SplatPsfRadiusInfo, 2.f, 1.f, 16.f)
+    , _splatter("RenderableGaiaStars", "${MODULE_GAIA}/shaders/gaia_splatsource_cs.glsl")
     , _accumulatedIndices(1, 0)
 {
     using File = ghoul::filesystem::File;
@@ -762,6 +849,7 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
         _gpuMemoryBudgetInBytes = dedicatedVidMem > 0 ?
             static_cast<long long>(dedicatedVidMem * _maxGpuMemoryPercent) :
             2147483648;
+        applyMemoryBudget();
         _buffersAreDirty = true;
         _maxStreamingBudgetInBytes = 0;
     });
@@ -778,7 +866,7 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     addProperty(_posXThreshold);
 
     if (dictionary.hasKey(FilterPosYInfo.identifier)) {
-        _posXThreshold = dictionary.value<glm::vec2>(FilterPosYInfo.identifier);
+        _posYThreshold = dictionary.value<glm::vec2>(FilterPosYInfo.identifier);
     }
     addProperty(_posYThreshold);
 
@@ -802,6 +890,11 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     }
     addProperty(_distThreshold);
 
+    if (dictionary.hasKey(FilterParallaxInfo.identifier)) {
+        _parallaxThreshold = dictionary.value<glm::vec2>(FilterParallaxInfo.identifier);
+    }
+    addProperty(_parallaxThreshold);
+
     // Only add properties correlated to fits files if we're reading from a fits file.
     if (_fileReaderOption == gaia::FileReaderOption::Fits) {
         if (dictionary.hasKey(FirstRowInfo.identifier)) {
@@ -848,6 +941,23 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     }
     addProperty(_reportGlErrors);
 
+    if (dictionary.hasKey(QuantizeDataInfo.identifier)) {
+        _quantizeData = dictionary.value<bool>(QuantizeDataInfo.identifier);
+    }
+    _quantizeData.onChange([&]() { _buffersAreDirty = true; });
+    addProperty(_quantizeData);
+
+    if (dictionary.hasKey(UseComputeSplattingInfo.identifier)) {
+        _useComputeSplatting = dictionary.value<bool>(
+            UseComputeSplattingInfo.identifier
+        );
+    }
+    addProperty(_useComputeSplatting);
+    _splatExposure.setExponent(10.f);
+    addProperty(_splatExposure);
+    addProperty(_splatBrightStarThreshold);
+    addProperty(_splatPsfRadius);
+
     // Add a read-only property for the number of rendered stars per frame.
     _nRenderedStars.setReadOnly(true);
     addProperty(_nRenderedStars);
@@ -863,6 +973,14 @@ bool RenderableGaiaStars::isReady() const {
     return _program && _programTM;
 }
 
+bool RenderableGaiaStars::renderedWithDesiredData() const {
+    return _hasStreamedAllNodes;
+}
+
+const OctreeManager& RenderableGaiaStars::octreeManager() const {
+    return _octreeManager;
+}
+
 void RenderableGaiaStars::initializeGL() {
     //using IgnoreError = ghoul::opengl::ProgramObject::IgnoreError;
     //_program->setIgnoreUniformLocationError(IgnoreError::Yes);
@@ -874,6 +992,11 @@ void RenderableGaiaStars::initializeGL() {
     addProperty(_lodPixelThreshold);
     addProperty(_maxGpuMemoryPercent);
 
+#ifndef __APPLE__
+    // The splatting uses compute shaders, which are not available on macOS
+    _splatter.initializeGL();
+#endif // !__APPLE__
+
     // Construct shader program depending on user-defined shader option.
     const int option = _shaderOption;
     switch (option) {
@@ -884,7 +1007,6 @@ void RenderableGaiaStars::initializeGL() {
                 absPath("${MODULE_GAIA}/shaders/gaia_point_fs.glsl"),
                 absPath("${MODULE_GAIA}/shaders/gaia_point_ge.glsl")
             );
-            _uniformCache.maxStarsPerNode = _program->uniformLocation("maxStarsPerNode");
             _uniformCache.valuesPerStar = _program->uniformLocation("valuesPerStar");
             _uniformCache.nChunksToRender = _program->uniformLocation("nChunksToRender");
 
@@ -946,7 +1068,6 @@ void RenderableGaiaStars::initializeGL() {
             );
             _uniformCache.psfTexture = _program->uniformLocation("psfTexture");
 
-            _uniformCache.maxStarsPerNode = _program->uniformLocation("maxStarsPerNode");
             _uniformCache.valuesPerStar = _program->uniformLocation("valuesPerStar");
             _uniformCache.nChunksToRender = _program->uniformLocation("nChunksToRender");
 
@@ -979,7 +1100,6 @@ void RenderableGaiaStars::initializeGL() {
             );
             _uniformCache.psfTexture = _program->uniformLocation("psfTexture");
 
-            _uniformCache.maxStarsPerNode = _program->uniformLocation("maxStarsPerNode");
             _uniformCache.valuesPerStar = _program->uniformLocation("valuesPerStar");
             _uniformCache.nChunksToRender = _program->uniformLocation("nChunksToRender");
 
@@ -1032,6 +1152,9 @@ void RenderableGaiaStars::initializeGL() {
         "luminosityMultiplier"
     );
     _uniformCache.colorTexture = _program->uniformLocation("colorTexture");
+    _uniformCache.maxStarsPerNode = _program->uniformLocation("maxStarsPerNode");
+    _uniformQuantizationCache.quantizedData = _program->uniformLocation("quantizedData");
+    _uniformQuantizationCache.nodeBounds = _program->uniformLocation("nodeBounds");
 
     _uniformFilterCache.posXThreshold = _program->uniformLocation("posXThreshold");
     _uniformFilterCache.posYThreshold = _program->uniformLocation("posYThreshold");
@@ -1039,6 +1162,9 @@ void RenderableGaiaStars::initializeGL() {
     _uniformFilterCache.gMagThreshold = _program->uniformLocation("gMagThreshold");
     _uniformFilterCache.bpRpThreshold = _program->uniformLocation("bpRpThreshold");
     _uniformFilterCache.distThreshold = _program->uniformLocation("distThreshold");
+    _uniformFilterCache.parallaxThreshold = _program->uniformLocation(
+        "parallaxThreshold"
+    );
 
     _uniformCacheTM.renderedTexture = _programTM->uniformLocation("renderedTexture");
 
@@ -1075,6 +1201,12 @@ void RenderableGaiaStars::initializeGL() {
     _cpuRamBudgetInBytes = installedRam > 0 ?
         static_cast<long long>(static_cast<float>(installedRam) * _maxCpuMemoryPercent) :
         4294967296;
+    _memoryBudgetClient = global::memoryBudget.registerClient(
+        "GaiaStars",
+        MemoryBudget::NormalPriority,
+        nullptr
+    );
+    applyMemoryBudget();
     _cpuRamBudgetProperty.setMaxValue(static_cast<float>(_cpuRamBudgetInBytes));
 
     LDEBUG(fmt::format(
@@ -1083,7 +1215,28 @@ void RenderableGaiaStars::initializeGL() {
     ));
 }
 
+void RenderableGaiaStars::applyMemoryBudget() {
+    if (_memoryBudgetClient == 0) {
+        return;
+    }
+
+    using Resource = MemoryBudget::Resource;
+    const size_t cpu = global::memoryBudget.allowance(_memoryBudgetClient, Resource::Cpu);
+    const size_t gpu = global::memoryBudget.allowance(_memoryBudgetClient, Resource::Gpu);
+    _cpuRamBudgetInBytes = static_cast<long long>(
+        std::min(static_cast<size_t>(_cpuRamBudgetInBytes), cpu)
+    );
+    _gpuMemoryBudgetInBytes = static_cast<long long>(
+        std::min(static_cast<size_t>(_gpuMemoryBudgetInBytes), gpu)
+    );
+}
+
 void RenderableGaiaStars::deinitializeGL() {
+    if (_memoryBudgetClient != 0) {
+        global::memoryBudget.unregisterClient(_memoryBudgetClient);
+        _memoryBudgetClient = 0;
+    }
+
     if (_vboPos != 0) {
         glDeleteBuffers(1, &_vboPos);
         _vboPos = 0;
@@ -1102,6 +1255,12 @@ void RenderableGaiaStars::deinitializeGL() {
         glDeleteBuffers(1, &_ssboData);
         _ssboData = 0;
     }
+    if (_nodeBoundsBuffer != 0) {
+        glDeleteTextures(1, &_nodeBoundsTexture);
+        _nodeBoundsTexture = 0;
+        glDeleteBuffers(1, &_nodeBoundsBuffer);
+        _nodeBoundsBuffer = 0;
+    }
     if (_vao != 0) {
         glDeleteVertexArrays(1, &_vao);
         _vao = 0;
@@ -1131,6 +1290,7 @@ void RenderableGaiaStars::deinitializeGL() {
         global::renderEngine.removeRenderProgram(_programTM.get());
         _programTM = nullptr;
     }
+    _splatter.deinitializeGL();
 }
 
 void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
@@ -1162,12 +1322,20 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
         _firstDrawCalls = false;
     }
 
+    // The right eye of a stereo viewport is rendered directly after the left eye, whose
+    // traversal has already streamed in the nodes that are visible from almost the same
+    // position, so the buffers are reused as they are
+    const bool reuseTraversal = global::windowDelegate.isRightEyeOfSingleViewport();
+
     // Update which nodes that are stored in memory as the camera moves around
     // (if streaming)
-    if (_fileReaderOption == gaia::FileReaderOption::StreamOctree) {
+    if (!reuseTraversal && _fileReaderOption == gaia::FileReaderOption::StreamOctree) {
         glm::dvec3 cameraPos = data.camera.positionVec3();
-        size_t chunkSizeBytes = _chunkSize * sizeof(GLfloat);
-        _octreeManager.fetchSurroundingNodes(cameraPos, chunkSizeBytes, _additionalNodes);
+        _octreeManager.fetchSurroundingNodes(
+            cameraPos,
+            _ramChunkSizeInBytes,
+            _additionalNodes
+        );
 
         // Update CPU Budget property.
         _cpuRamBudgetProperty = static_cast<float>(_octreeManager.cpuRamBudget());
@@ -1176,13 +1344,29 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
     // Traverse Octree and build a map with new nodes to render, uses mvp matrix to decide
     const int renderOption = _renderOption;
     int deltaStars = 0;
-    std::map<int, std::vector<float>> updateData = _octreeManager.traverseData(
-        modelViewProjMat,
-        screenSize,
-        deltaStars,
-        gaia::RenderOption(renderOption),
-        _lodPixelThreshold
-    );
+    std::pmr::map<int, std::vector<float>> updateData(data.frameMemory);
+    if (!reuseTraversal) {
+        // The filters are evaluated per star in the shaders, the Octree only uses them
+        // to skip the nodes that would be filtered away entirely
+        _octreeManager.setFilterRanges(
+            _posXThreshold,
+            _posYThreshold,
+            _posZThreshold,
+            _distThreshold,
+            _parallaxThreshold
+        );
+        updateData = _octreeManager.traverseData(
+            modelViewProjMat,
+            screenSize,
+            deltaStars,
+            gaia::RenderOption(renderOption),
+            _lodPixelThreshold,
+            data.frameMemory
+        );
+
+        // The view has all the nodes it needs once a traversal no longer adds any
+        _hasStreamedAllNodes = updateData.empty();
+    }
 
     // Update number of rendered stars.
     _nStarsToRender += deltaStars;
@@ -1195,6 +1379,27 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
     int maxStarsPerNode = static_cast<int>(_octreeManager.maxStarsPerNode());
     int valuesPerStar = static_cast<int>(_nRenderValuesPerStar);
 
+    // Quantized chunks start with the bounds of their node, which are written to a buffer
+    // of their own so that the streams only contain the star values. The chunks of
+    // removed nodes are empty and have no bounds
+    auto boundsSizeOf = [quantized = _useQuantizedData](const std::vector<float>& chunk) {
+        return (quantized && !chunk.empty()) ? NodeBoundsSize : 0;
+    };
+    if (_useQuantizedData && !updateData.empty()) {
+        glBindBuffer(GL_TEXTURE_BUFFER, _nodeBoundsBuffer);
+        for (const auto& [offset, subData] : updateData) {
+            if (!subData.empty()) {
+                glBufferSubData(
+                    GL_TEXTURE_BUFFER,
+                    offset * NodeBoundsSize * sizeof(GLfloat),
+                    NodeBoundsSize * sizeof(GLfloat),
+                    subData.data()
+                );
+            }
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
     // Switch rendering technique depending on user-defined shader option.
     const int shaderOption = _shaderOption;
     if (shaderOption == gaia::ShaderOption::Billboard_SSBO ||
@@ -1208,15 +1413,21 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
         int lastValue = _accumulatedIndices.back();
         _accumulatedIndices.resize(nChunksToRender + 1, lastValue);
 
-        // Update vector with accumulated indices.
-        for (const auto& [offset, subData] : updateData) {
-            int newValue = static_cast<int>(subData.size() / _nRenderValuesPerStar) +
-                           _accumulatedIndices[offset];
-            int changeInValue = newValue - _accumulatedIndices[offset + 1];
-            _accumulatedIndices[offset + 1] = newValue;
-            // Propagate change.
-            for (int i = offset + 1; i < nChunksToRender; ++i) {
+        // Update vector with accumulated indices. The keys in the map are sorted, so
+        // the changes of all updated chunks are propagated in a single pass.
+        if (!updateData.empty()) {
+            auto it = updateData.begin();
+            int changeInValue = 0;
+            for (int i = it->first; i < nChunksToRender; ++i) {
                 _accumulatedIndices[i + 1] += changeInValue;
+                if (it != updateData.end() && it->first == i) {
+                    const size_t nValues = it->second.size() - boundsSizeOf(it->second);
+                    const int newValue = _accumulatedIndices[i] +
+                        static_cast<int>(nValues / _nRenderValuesPerStar);
+                    changeInValue += newValue - _accumulatedIndices[i + 1];
+                    _accumulatedIndices[i + 1] = newValue;
+                    ++it;
+                }
             }
         }
 
@@ -1226,37 +1437,33 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
             _nRenderedStars = _nStarsToRender;
         }
 
-        size_t indexBufferSize = _accumulatedIndices.size() * sizeof(GLint);
-
-        // Update SSBO Index (stars per chunk).
-        glBufferData(
-            GL_SHADER_STORAGE_BUFFER,
-            indexBufferSize,
-            _accumulatedIndices.data(),
-            GL_STREAM_DRAW
-        );
+        // Update SSBO Index (stars per chunk), only if any chunk has changed.
+        if (!updateData.empty() || _accumulatedIndices.size() != _nUploadedIndices) {
+            _nUploadedIndices = _accumulatedIndices.size();
+            glBufferData(
+                GL_SHADER_STORAGE_BUFFER,
+                _nUploadedIndices * sizeof(GLint),
+                _accumulatedIndices.data(),
+                GL_STREAM_DRAW
+            );
+        }
 
-        // Use orphaning strategy for data SSBO.
+        // The data SSBO keeps the chunks of previous frames, so only the chunks of
+        // nodes that were inserted since the last frame have to be written.
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, _ssboData);
 
-        glBufferData(
-            GL_SHADER_STORAGE_BUFFER,
-            _maxStreamingBudgetInBytes,
-            nullptr,
-            GL_STREAM_DRAW
-        );
-
         // Update SSBO with one insert per chunk/node.
         // The key in map holds the offset index.
         for (const auto &[offset, subData] : updateData) {
             // We don't need to fill chunk with zeros for SSBOs!
             // Just check if we have any values to update.
             if (!subData.empty()) {
+                const size_t boundsSize = boundsSizeOf(subData);
                 glBufferSubData(
                     GL_SHADER_STORAGE_BUFFER,
                     offset * _chunkSize * sizeof(GLfloat),
-                    subData.size() * sizeof(GLfloat),
-                    subData.data()
+                    (subData.size() - boundsSize) * sizeof(GLfloat),
+                    subData.data() + boundsSize
                 );
             }
         }
@@ -1272,27 +1479,35 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
 
         // Always update Position VBO.
         glBindBuffer(GL_ARRAY_BUFFER, _vboPos);
-        float posMemoryShare = static_cast<float>(PositionSize) / _nRenderValuesPerStar;
-        size_t posChunkSize = maxStarsPerNode * PositionSize;
+        const size_t positionSize =
+            _useQuantizedData ? QuantizedPositionSize : PositionSize;
+        float posMemoryShare = static_cast<float>(positionSize) / _nRenderValuesPerStar;
+        size_t posChunkSize = maxStarsPerNode * positionSize;
         long long posStreamingBudget = static_cast<long long>(
             _maxStreamingBudgetInBytes * posMemoryShare
         );
 
-        // Use buffer orphaning to update a subset of total data.
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            posStreamingBudget,
-            nullptr,
-            GL_STREAM_DRAW
-        );
+        // The VBOs keep the chunks of previous frames, so only the chunks of nodes that
+        // were inserted or removed since the last frame have to be written.
+        // Only reallocate the storage if the streaming budget was changed.
+        if (posStreamingBudget != _posStreamingBudgetInUse) {
+            _posStreamingBudgetInUse = posStreamingBudget;
+            glBufferData(
+                GL_ARRAY_BUFFER,
+                posStreamingBudget,
+                nullptr,
+                GL_STREAM_DRAW
+            );
+        }
 
         // Update buffer with one insert per chunk/node.
         //The key in map holds the offset index.
+        std::vector<float> vectorData;
         for (const auto& [offset, subData] : updateData) {
             // Fill chunk by appending zeroes so we overwrite possible earlier values.
             // Only required when removing nodes because chunks are filled up in octree
             // fetch on add.
-            std::vector<float> vectorData(subData.begin(), subData.end());
+            vectorData.assign(subData.begin() + boundsSizeOf(subData), subData.end());
             vectorData.resize(posChunkSize, 0.f);
             glBufferSubData(
                 GL_ARRAY_BUFFER,
@@ -1305,25 +1520,28 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
         // Update Color VBO if render option is 'Color' or 'Motion'.
         if (renderOption != gaia::RenderOption::Static) {
             glBindBuffer(GL_ARRAY_BUFFER, _vboCol);
-            float colMemoryShare = static_cast<float>(ColorSize) / _nRenderValuesPerStar;
-            size_t colChunkSize = maxStarsPerNode * ColorSize;
+            const size_t colorSize = _useQuantizedData ? QuantizedColorSize : ColorSize;
+            float colMemoryShare = static_cast<float>(colorSize) / _nRenderValuesPerStar;
+            size_t colChunkSize = maxStarsPerNode * colorSize;
             long long colStreamingBudget = static_cast<long long>(
                 _maxStreamingBudgetInBytes * colMemoryShare
             );
 
-            // Use buffer orphaning to update a subset of total data.
-            glBufferData(
-                GL_ARRAY_BUFFER,
-                colStreamingBudget,
-                nullptr,
-                GL_STREAM_DRAW
-            );
+            if (colStreamingBudget != _colStreamingBudgetInUse) {
+                _colStreamingBudgetInUse = colStreamingBudget;
+                glBufferData(
+                    GL_ARRAY_BUFFER,
+                    colStreamingBudget,
+                    nullptr,
+                    GL_STREAM_DRAW
+                );
+            }
 
             // Update buffer with one insert per chunk/node.
             //The key in map holds the offset index.
             for (const auto& [offset, subData] : updateData) {
                 // Fill chunk by appending zeroes so we overwrite possible earlier values.
-                std::vector<float> vectorData(subData.begin(), subData.end());
+                vectorData.assign(subData.begin() + boundsSizeOf(subData), subData.end());
                 vectorData.resize(posChunkSize + colChunkSize, 0.f);
                 glBufferSubData(
                     GL_ARRAY_BUFFER,
@@ -1336,26 +1554,33 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
             // Update Velocity VBO if specified.
             if (renderOption == gaia::RenderOption::Motion) {
                 glBindBuffer(GL_ARRAY_BUFFER, _vboVel);
-                float velMemoryShare = static_cast<float>(VelocitySize) /
+                const size_t velocitySize =
+                    _useQuantizedData ? QuantizedVelocitySize : VelocitySize;
+                float velMemoryShare = static_cast<float>(velocitySize) /
                                        _nRenderValuesPerStar;
-                size_t velChunkSize = maxStarsPerNode * VelocitySize;
+                size_t velChunkSize = maxStarsPerNode * velocitySize;
                 long long velStreamingBudget = static_cast<long long>(
                     _maxStreamingBudgetInBytes * velMemoryShare
                 );
 
-                // Use buffer orphaning to update a subset of total data.
-                glBufferData(
-                    GL_ARRAY_BUFFER,
-                    velStreamingBudget,
-                    nullptr,
-                    GL_STREAM_DRAW
-                );
+                if (velStreamingBudget != _velStreamingBudgetInUse) {
+                    _velStreamingBudgetInUse = velStreamingBudget;
+                    glBufferData(
+                        GL_ARRAY_BUFFER,
+                        velStreamingBudget,
+                        nullptr,
+                        GL_STREAM_DRAW
+                    );
+                }
 
                 // Update buffer with one insert per chunk/node.
                 //The key in map holds the offset index.
                 for (const auto& [offset, subData] : updateData) {
                     // Fill chunk by appending zeroes.
-                    std::vector<float> vectorData(subData.begin(), subData.end());
+                    vectorData.assign(
+                        subData.begin() + boundsSizeOf(subData),
+                        subData.end()
+                    );
                     vectorData.resize(_chunkSize, 0.f);
                     glBufferSubData(
                         GL_ARRAY_BUFFER,
@@ -1373,6 +1598,20 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
 
     checkGlErrors("After buffer updates");
 
+#ifndef __APPLE__
+    const bool isSsboOption = shaderOption == gaia::ShaderOption::Billboard_SSBO ||
+        shaderOption == gaia::ShaderOption::Point_SSBO ||
+        shaderOption == gaia::ShaderOption::Billboard_SSBO_noFBO;
+    if (_useComputeSplatting && isSsboOption &&
+        renderOption != gaia::RenderOption::Static && _colorTexture &&
+        _pointSpreadFunctionTexture)
+    {
+        renderSplatted(data, model, nChunksToRender, maxStarsPerNode, valuesPerStar);
+        checkGlErrors("After render");
+        return;
+    }
+#endif // !__APPLE__
+
     // Activate shader program and send uniforms.
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     glDepthMask(false);
@@ -1397,6 +1636,16 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
     _program->setUniform(_uniformFilterCache.gMagThreshold, _gMagThreshold);
     _program->setUniform(_uniformFilterCache.bpRpThreshold, _bpRpThreshold);
     _program->setUniform(_uniformFilterCache.distThreshold, _distThreshold);
+    _program->setUniform(_uniformFilterCache.parallaxThreshold, _parallaxThreshold);
+
+    _program->setUniform(_uniformCache.maxStarsPerNode, maxStarsPerNode);
+    _program->setUniform(_uniformQuantizationCache.quantizedData, _useQuantizedData);
+    // The buffer sampler needs a unit of its own even if it is not read, as it must not
+    // share a unit with the samplers of another type
+    ghoul::opengl::TextureUnit nodeBoundsUnit;
+    nodeBoundsUnit.activate();
+    glBindTexture(GL_TEXTURE_BUFFER, _nodeBoundsTexture);
+    _program->setUniform(_uniformQuantizationCache.nodeBounds, nodeBoundsUnit);
 
     ghoul::opengl::TextureUnit colorUnit;
     if (_colorTexture) {
@@ -1411,7 +1660,6 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
     ghoul::opengl::TextureUnit psfUnit;
     switch (shaderOption) {
         case gaia::ShaderOption::Point_SSBO: {
-            _program->setUniform(_uniformCache.maxStarsPerNode, maxStarsPerNode);
             _program->setUniform(_uniformCache.valuesPerStar, valuesPerStar);
             _program->setUniform(_uniformCache.nChunksToRender, nChunksToRender);
             break;
@@ -1431,7 +1679,6 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
                 _uniformCache.cameraLookUp,
                 data.camera.lookUpVectorWorldSpace()
             );
-            _program->setUniform(_uniformCache.maxStarsPerNode, maxStarsPerNode);
             _program->setUniform(_uniformCache.valuesPerStar, valuesPerStar);
             _program->setUniform(_uniformCache.nChunksToRender, nChunksToRender);
 
@@ -1532,6 +1779,66 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
     checkGlErrors("After render");
 }
 
+void RenderableGaiaStars::renderSplatted(const RenderData& data,
+                                         const glm::dmat4& model, int nChunksToRender,
+                                         int maxStarsPerNode, int valuesPerStar)
+{
+    StarSplatter::Settings settings;
+    settings.exposure = _splatExposure;
+    settings.brightStarThreshold = _splatBrightStarThreshold;
+    settings.psfRadius = _splatPsfRadius;
+    // The range of the color values that is covered by the color map, as in the shaders
+    settings.colorRange = glm::vec2(-0.4f, 2.f);
+    settings.colorTexture = static_cast<GLuint>(*_colorTexture);
+    settings.psfTexture = static_cast<GLuint>(*_pointSpreadFunctionTexture);
+
+    // Another renderable might have used the binding points since the buffers were
+    // created, so they are bound again
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        _ssboIdxBinding->bindingNumber(),
+        _ssboIdx
+    );
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        _ssboDataBinding->bindingNumber(),
+        _ssboData
+    );
+
+    ghoul::opengl::TextureUnit nodeBoundsUnit;
+    nodeBoundsUnit.activate();
+    glBindTexture(GL_TEXTURE_BUFFER, _nodeBoundsTexture);
+
+    const int renderOption = _renderOption;
+    _splatter.render(
+        data,
+        model,
+        static_cast<unsigned int>(_nStarsToRender),
+        settings,
+        [&](ghoul::opengl::ProgramObject& program) {
+            program.setSsboBinding("ssbo_idx_data", _ssboIdxBinding->bindingNumber());
+            program.setSsboBinding("ssbo_comb_data", _ssboDataBinding->bindingNumber());
+            program.setUniform("time", static_cast<float>(data.time.j2000Seconds()));
+            program.setUniform("renderOption", renderOption);
+            program.setUniform("maxStarsPerNode", maxStarsPerNode);
+            program.setUniform("valuesPerStar", valuesPerStar);
+            program.setUniform("nChunksToRender", nChunksToRender);
+            program.setUniform("quantizedData", _useQuantizedData);
+            program.setUniform("nodeBounds", nodeBoundsUnit);
+
+            program.setUniform("posXThreshold", _posXThreshold.value());
+            program.setUniform("posYThreshold", _posYThreshold.value());
+            program.setUniform("posZThreshold", _posZThreshold.value());
+            program.setUniform("gMagThreshold", _gMagThreshold.value());
+            program.setUniform("bpRpThreshold", _bpRpThreshold.value());
+            program.setUniform("distThreshold", _distThreshold.value());
+            program.setUniform("parallaxThreshold", _parallaxThreshold.value());
+        }
+    );
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
 void RenderableGaiaStars::checkGlErrors(const std::string& identifier) const {
     if (_reportGlErrors) {
         GLenum error = glGetError();
@@ -1564,8 +1871,34 @@ void RenderableGaiaStars::update(const UpdateData&) {
     const int shaderOption = _shaderOption;
     const int renderOption = _renderOption;
 
+    _splatter.update();
+
+    if (_memoryBudgetClient != 0) {
+        // The octree manager counts down the remaining part of the CPU RAM budget
+        const bool isStreaming =
+            _fileReaderOption == gaia::FileReaderOption::StreamOctree;
+        const long long cpuInUse = isStreaming ?
+            _cpuRamBudgetInBytes - _octreeManager.cpuRamBudget() :
+            _totalDatasetSizeInBytes;
+        const long long gpuInUse = _posStreamingBudgetInUse + _colStreamingBudgetInUse +
+            _velStreamingBudgetInUse;
+        using Resource = MemoryBudget::Resource;
+        MemoryBudget& budget = global::memoryBudget;
+        budget.setUsage(
+            _memoryBudgetClient,
+            Resource::Cpu,
+            static_cast<size_t>(std::max(cpuInUse, 0LL))
+        );
+        budget.setUsage(
+            _memoryBudgetClient,
+            Resource::Gpu,
+            static_cast<size_t>(std::max(gpuInUse, 0LL))
+        );
+    }
+
     // Don't update anything if we are in the middle of a rebuild.
     if (_octreeManager.isRebuildOngoing()) {
+        _hasStreamedAllNodes = false;
         return;
     }
 
@@ -1597,9 +1930,6 @@ void RenderableGaiaStars::update(const UpdateData&) {
                 }
                 _program = std::move(program);
 
-                _uniformCache.maxStarsPerNode = _program->uniformLocation(
-                    "maxStarsPerNode"
-                );
                 _uniformCache.valuesPerStar = _program->uniformLocation(
                     "valuesPerStar"
                 );
@@ -1723,9 +2053,6 @@ void RenderableGaiaStars::update(const UpdateData&) {
                 );
                 _uniformCache.psfTexture = _program->uniformLocation("psfTexture");
 
-                _uniformCache.maxStarsPerNode = _program->uniformLocation(
-                    "maxStarsPerNode"
-                );
                 _uniformCache.valuesPerStar = _program->uniformLocation("valuesPerStar");
                 _uniformCache.nChunksToRender = _program->uniformLocation(
                     "nChunksToRender"
@@ -1837,6 +2164,11 @@ void RenderableGaiaStars::update(const UpdateData&) {
             "luminosityMultiplier"
         );
         _uniformCache.colorTexture = _program->uniformLocation("colorTexture");
+        _uniformCache.maxStarsPerNode = _program->uniformLocation("maxStarsPerNode");
+        _uniformQuantizationCache.quantizedData = _program->uniformLocation(
+            "quantizedData"
+        );
+        _uniformQuantizationCache.nodeBounds = _program->uniformLocation("nodeBounds");
         // Filter uniforms:
         _uniformFilterCache.posXThreshold = _program->uniformLocation("posXThreshold");
         _uniformFilterCache.posYThreshold = _program->uniformLocation("posYThreshold");
@@ -1844,6 +2176,9 @@ void RenderableGaiaStars::update(const UpdateData&) {
         _uniformFilterCache.gMagThreshold = _program->uniformLocation("gMagThreshold");
         _uniformFilterCache.bpRpThreshold = _program->uniformLocation("bpRpThreshold");
         _uniformFilterCache.distThreshold = _program->uniformLocation("distThreshold");
+        _uniformFilterCache.parallaxThreshold = _program->uniformLocation(
+            "parallaxThreshold"
+        );
     }
 
     if (_programTM->isDirty() || _shadersAreDirty) {
@@ -1897,17 +2232,30 @@ void RenderableGaiaStars::update(const UpdateData&) {
         LDEBUG("Regenerating buffers");
 
         // Set values per star slice depending on render option.
+        _useQuantizedData = _quantizeData;
+        size_t nRamValuesPerStar = 0;
         if (renderOption == gaia::RenderOption::Static) {
-            _nRenderValuesPerStar = PositionSize;
+            nRamValuesPerStar = PositionSize;
+            _nRenderValuesPerStar = _useQuantizedData ?
+                QuantizedPositionSize :
+                PositionSize;
         }
         else if (renderOption == gaia::RenderOption::Color) {
-            _nRenderValuesPerStar = PositionSize + ColorSize;
+            nRamValuesPerStar = PositionSize + ColorSize;
+            _nRenderValuesPerStar = _useQuantizedData ?
+                QuantizedPositionSize + QuantizedColorSize :
+                PositionSize + ColorSize;
         }
         else { // (renderOption == gaia::RenderOption::Motion)
-            _nRenderValuesPerStar = PositionSize + ColorSize + VelocitySize;
+            nRamValuesPerStar = PositionSize + ColorSize + VelocitySize;
+            _nRenderValuesPerStar = _useQuantizedData ?
+                QuantizedPositionSize + QuantizedColorSize + QuantizedVelocitySize :
+                PositionSize + ColorSize + VelocitySize;
         }
 
         // Calculate memory budgets.
+        _ramChunkSizeInBytes = _octreeManager.maxStarsPerNode() * nRamValuesPerStar *
+                               sizeof(GLfloat);
         _chunkSize = _octreeManager.maxStarsPerNode() * _nRenderValuesPerStar;
         long long totalChunkSizeInBytes = _octreeManager.totalNodes() *
                                           _chunkSize * sizeof(GLfloat);
@@ -1934,6 +2282,41 @@ void RenderableGaiaStars::update(const UpdateData&) {
             _chunkSize, _maxStreamingBudgetInBytes, maxNodesInStream
         ));
 
+        // The buffers are (re)allocated with the new streaming budget on the next
+        // update of the VBOs.
+        _posStreamingBudgetInUse = 0;
+        _colStreamingBudgetInUse = 0;
+        _velStreamingBudgetInUse = 0;
+
+        // The node bounds of a quantized stream are read by both the SSBO and the VBO
+        // shaders through a buffer texture with one texel per chunk.
+        if (_useQuantizedData) {
+            if (_nodeBoundsBuffer == 0) {
+                glGenBuffers(1, &_nodeBoundsBuffer);
+                glGenTextures(1, &_nodeBoundsTexture);
+                LDEBUG(fmt::format(
+                    "Generating Node Bounds Texture Buffer id '{}'", _nodeBoundsBuffer
+                ));
+            }
+            glBindBuffer(GL_TEXTURE_BUFFER, _nodeBoundsBuffer);
+            glBufferData(
+                GL_TEXTURE_BUFFER,
+                maxNodesInStream * NodeBoundsSize * sizeof(GLfloat),
+                nullptr,
+                GL_STREAM_DRAW
+            );
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+            glBindTexture(GL_TEXTURE_BUFFER, _nodeBoundsTexture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, _nodeBoundsBuffer);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+        }
+        else if (_nodeBoundsBuffer != 0) {
+            glBindBuffer(GL_TEXTURE_BUFFER, _nodeBoundsBuffer);
+            glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STREAM_DRAW);
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        }
+
         // ------------------ RENDER WITH SSBO -----------------------
         if (shaderOption == gaia::ShaderOption::Billboard_SSBO ||
             shaderOption == gaia::ShaderOption::Point_SSBO ||
@@ -1947,7 +2330,8 @@ void RenderableGaiaStars::update(const UpdateData&) {
             _octreeManager.initBufferIndexStack(
                 maxNodesInStream,
                 _useVBO,
-                datasetFitInMemory
+                datasetFitInMemory,
+                _useQuantizedData
             );
             _nStarsToRender = 0;
 
@@ -1983,8 +2367,16 @@ void RenderableGaiaStars::update(const UpdateData&) {
             );
             _program->setSsboBinding("ssbo_idx_data", _ssboIdxBinding->bindingNumber());
 
-            // Combined SSBO with all data.
+            // Combined SSBO with all data. The storage is only allocated here, every
+            // frame after that only writes the chunks that have changed.
             glBindBuffer(GL_SHADER_STORAGE_BUFFER, _ssboData);
+            glBufferData(
+                GL_SHADER_STORAGE_BUFFER,
+                _maxStreamingBudgetInBytes,
+                nullptr,
+                GL_STREAM_DRAW
+            );
+            _nUploadedIndices = 0;
 
             _ssboDataBinding = std::make_unique<ghoul::opengl::BufferBinding<
                 ghoul::opengl::bufferbinding::Buffer::ShaderStorage>
@@ -2037,7 +2429,8 @@ void RenderableGaiaStars::update(const UpdateData&) {
             _octreeManager.initBufferIndexStack(
                 maxNodesInStream,
                 _useVBO,
-                datasetFitInMemory
+                datasetFitInMemory,
+                _useQuantizedData
             );
             _nStarsToRender = 0;
 
@@ -2068,6 +2461,14 @@ void RenderableGaiaStars::update(const UpdateData&) {
             // Bind our different VBOs to our vertex array layout.
             glBindVertexArray(_vao);
 
+            // Quantized positions are normalized shorts with the flag of the slot in the
+            // fourth component, and the other values are stored as half floats.
+            const GLint positionComponents = _useQuantizedData ? 4 : PositionSize;
+            const GLenum positionType = _useQuantizedData ? GL_SHORT : GL_FLOAT;
+            const GLboolean positionNormalized = _useQuantizedData ? GL_TRUE : GL_FALSE;
+            const GLint velocityComponents = _useQuantizedData ? 4 : VelocitySize;
+            const GLenum valueType = _useQuantizedData ? GL_HALF_FLOAT : GL_FLOAT;
+
             switch (renderOption) {
                 case gaia::RenderOption::Static: {
                     glBindBuffer(GL_ARRAY_BUFFER, _vboPos);
@@ -2076,9 +2477,9 @@ void RenderableGaiaStars::update(const UpdateData&) {
 
                     glVertexAttribPointer(
                         positionAttrib,
-                        PositionSize,
-                        GL_FLOAT,
-                        GL_FALSE,
+                        positionComponents,
+                        positionType,
+                        positionNormalized,
                         0,
                         nullptr
                     );
@@ -2092,9 +2493,9 @@ void RenderableGaiaStars::update(const UpdateData&) {
 
                     glVertexAttribPointer(
                         positionAttrib,
-                        PositionSize,
-                        GL_FLOAT,
-                        GL_FALSE,
+                        positionComponents,
+                        positionType,
+                        positionNormalized,
                         0,
                         nullptr
                     );
@@ -2106,7 +2507,7 @@ void RenderableGaiaStars::update(const UpdateData&) {
                     glVertexAttribPointer(
                         brightnessAttrib,
                         ColorSize,
-                        GL_FLOAT,
+                        valueType,
                         GL_FALSE,
                         0,
                         nullptr
@@ -2120,9 +2521,9 @@ void RenderableGaiaStars::update(const UpdateData&) {
 
                     glVertexAttribPointer(
                         positionAttrib,
-                        PositionSize,
-                        GL_FLOAT,
-                        GL_FALSE,
+                        positionComponents,
+                        positionType,
+                        positionNormalized,
                         0,
                         nullptr
                     );
@@ -2134,7 +2535,7 @@ void RenderableGaiaStars::update(const UpdateData&) {
                     glVertexAttribPointer(
                         brightnessAttrib,
                         ColorSize,
-                        GL_FLOAT,
+                        valueType,
                         GL_FALSE,
                         0,
                         nullptr
@@ -2146,8 +2547,8 @@ void RenderableGaiaStars::update(const UpdateData&) {
 
                     glVertexAttribPointer(
                         velocityAttrib,
-                        VelocitySize,
-                        GL_FLOAT,
+                        velocityComponents,
+                        valueType,
                         GL_FALSE,
                         0,
                         nullptr
@@ -36,6 +36,8 @@
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/ivec2property.h>
+#include <openspace/rendering/starsplatter.h>
+#include <openspace/util/memorybudget.h>
 #include <ghoul/opengl/bufferbinding.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
@@ -59,12 +61,19 @@ public:
     void deinitializeGL() override;
 
     bool isReady() const override;
+    bool renderedWithDesiredData() const override;
 
     void render(const RenderData& data, RendererTasks& rendererTask) override;
     void update(const UpdateData& data) override;
 
     static documentation::Documentation Documentation();
 
+    /**
+     * \returns the OctreeManager that holds the stars, which is used to retrieve the
+     * state of the streaming, for example by the metrics of the server module
+     */
+    const OctreeManager& octreeManager() const;
+
 private:
     /**
      * Reads data file in format defined by FileReaderOption.
@@ -115,6 +124,20 @@ private:
      */
     void checkGlErrors(const std::string& identifier) const;
 
+    /**
+     * Limits the CPU RAM and GPU memory budgets to what the engine-wide MemoryBudget
+     * leaves for this renderable. The budgets are only applied when the octree and the
+     * streaming buffers are (re)built, so this renderable is never asked to shrink.
+     */
+    void applyMemoryBudget();
+
+    /**
+     * Renders the streamed stars of the SSBO shader options with the StarSplatter
+     * instead of the point or billboard shaders.
+     */
+    void renderSplatted(const RenderData& data, const glm::dmat4& model,
+        int nChunksToRender, int maxStarsPerNode, int valuesPerStar);
+
     properties::StringProperty _filePath;
     std::unique_ptr<ghoul::filesystem::File> _dataFile;
     bool _dataIsDirty = true;
@@ -149,6 +172,7 @@ private:
     properties::Vec2Property _gMagThreshold;
     properties::Vec2Property _bpRpThreshold;
     properties::Vec2Property _distThreshold;
+    properties::Vec2Property _parallaxThreshold;
 
     properties::IntProperty _firstRow;
     properties::IntProperty _lastRow;
@@ -165,6 +189,11 @@ private:
     properties::FloatProperty _maxCpuMemoryPercent;
 
     properties::BoolProperty _reportGlErrors;
+    properties::BoolProperty _quantizeData;
+    properties::BoolProperty _useComputeSplatting;
+    properties::FloatProperty _splatExposure;
+    properties::FloatProperty _splatBrightStarThreshold;
+    properties::FloatProperty _splatPsfRadius;
 
     std::unique_ptr<ghoul::opengl::ProgramObject> _program;
     UniformCache(model, view, cameraPos, cameraLookUp, viewScaling, projection,
@@ -174,13 +203,17 @@ private:
         _uniformCache;
 
     UniformCache(posXThreshold, posYThreshold, posZThreshold, gMagThreshold,
-        bpRpThreshold, distThreshold) _uniformFilterCache;
+        bpRpThreshold, distThreshold, parallaxThreshold) _uniformFilterCache;
+
+    UniformCache(quantizedData, nodeBounds) _uniformQuantizationCache;
 
     std::unique_ptr<ghoul::opengl::ProgramObject> _programTM;
     UniformCache(renderedTexture, screenSize, filterSize, sigma, pixelWeightThreshold,
         projection) _uniformCacheTM;
     std::unique_ptr<ghoul::opengl::Texture> _fboTexture;
 
+    StarSplatter _splatter;
+
     OctreeManager _octreeManager;
     std::unique_ptr<ghoul::opengl::BufferBinding<
         ghoul::opengl::bufferbinding::Buffer::ShaderStorage>> _ssboIdxBinding;
@@ -188,16 +221,26 @@ private:
         ghoul::opengl::bufferbinding::Buffer::ShaderStorage>> _ssboDataBinding;
 
     std::vector<int> _accumulatedIndices;
+    size_t _nUploadedIndices = 0;
+    long long _posStreamingBudgetInUse = 0;
+    long long _colStreamingBudgetInUse = 0;
+    long long _velStreamingBudgetInUse = 0;
     size_t _nRenderValuesPerStar = 0;
     int _nStarsToRender = 0;
     bool _firstDrawCalls = true;
+    // Whether the last traversal of the Octree did not have to stream in any new nodes
+    bool _hasStreamedAllNodes = false;
     glm::dquat _previousCameraRotation;
     bool _useVBO = false;
+    bool _useQuantizedData = false;
     long long _cpuRamBudgetInBytes = 0;
     long long _totalDatasetSizeInBytes = 0;
     long long _gpuMemoryBudgetInBytes = 0;
     long long _maxStreamingBudgetInBytes = 0;
+    MemoryBudget::ClientId _memoryBudgetClient = 0;
     size_t _chunkSize = 0;
+    // The nodes are kept in RAM with full precision even if the stream is quantized
+    size_t _ramChunkSizeInBytes = 0;
 
     GLuint _vao = 0;
     GLuint _vaoEmpty = 0;
@@ -206,6 +249,8 @@ private:
     GLuint _vboVel = 0;
     GLuint _ssboIdx = 0;
     GLuint _ssboData = 0;
+    GLuint _nodeBoundsBuffer = 0;
+    GLuint _nodeBoundsTexture = 0;
     GLuint _vaoQuad = 0;
     GLuint _vboQuad = 0;
     GLuint _fbo = 0;
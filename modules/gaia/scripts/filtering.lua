@@ -15,7 +15,7 @@ openspace.gaia.documentation = {
         Documentation = "Creates a clipping sphere for the Gaia renderable in the first argument"
     },
     {
-        Name = "removeClippingBox",
+        Name = "removeClippingSphere",
         Arguments = "",
         Documentation = ""
     }
@@ -51,9 +51,10 @@ openspace.gaia.addClippingBox = function (name, size, position)
 
     openspace.addSceneGraphNode(grid)
 
-    openspace.setPropertyValue('Scene.' .. name .. '.renderable.FilterPosX', { (position[1] - size[1] / 2) * kilo_parsec_in_meter, (position[1] + size[1] / 2) * kilo_parsec_in_meter })
-    openspace.setPropertyValue('Scene.' .. name .. '.renderable.FilterPosY', { (position[2] - size[2] / 2) * kilo_parsec_in_meter, (position[2] + size[2] / 2) * kilo_parsec_in_meter })
-    openspace.setPropertyValue('Scene.' .. name .. '.renderable.FilterPosZ', { (position[3] - size[3] / 2) * kilo_parsec_in_meter, (position[3] + size[3] / 2) * kilo_parsec_in_meter })
+    -- The filters are measured in kiloparsec and are applied without reloading any data
+    openspace.setPropertyValue('Scene.' .. name .. '.renderable.FilterPosX', { position[1] - size[1] / 2, position[1] + size[1] / 2 })
+    openspace.setPropertyValue('Scene.' .. name .. '.renderable.FilterPosY', { position[2] - size[2] / 2, position[2] + size[2] / 2 })
+    openspace.setPropertyValue('Scene.' .. name .. '.renderable.FilterPosZ', { position[3] - size[3] / 2, position[3] + size[3] / 2 })
 end
 
 openspace.gaia.removeClippingBox = function()
@@ -90,7 +91,7 @@ openspace.gaia.addClippingSphere = function (name, radius)
 
     openspace.addSceneGraphNode(grid)
 
-    openspace.setPropertyValue('Scene.' .. name .. '.renderable.FilterDist', radius * kilo_parsec_in_meter)
+    openspace.setPropertyValue('Scene.' .. name .. '.renderable.FilterDist', { 0.0, radius })
 end
 
 openspace.gaia.removeClippingSphere = function()
@@ -0,0 +1,84 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef _GAIA_FILTER_GLSL_
+#define _GAIA_FILTER_GLSL_
+
+// The filters of RenderableGaiaStars, which are evaluated per star against the values
+// that are already streamed to the GPU, so that they can be changed without rebuilding
+// any buffers. Positions and distances are measured in kiloparsec and parallaxes in
+// milliarcseconds. Keep in sync with OctreeManager::isFilteredOut
+
+uniform vec2 posXThreshold;
+uniform vec2 posYThreshold;
+uniform vec2 posZThreshold;
+uniform vec2 gMagThreshold;
+uniform vec2 bpRpThreshold;
+uniform vec2 distThreshold;
+uniform vec2 parallaxThreshold;
+
+const float FilterEps = 1e-5;
+
+// A bound that is 0 is read as -Inf (min) or +Inf (max)
+bool isOutside(float value, vec2 threshold) {
+  return (abs(threshold.x) > FilterEps && value < threshold.x) ||
+         (abs(threshold.y) > FilterEps && value > threshold.y);
+}
+
+// If min = max then all values equal to min|max are filtered away
+bool isExcluded(float value, vec2 threshold) {
+  return abs(threshold.x - threshold.y) < FilterEps &&
+         abs(value - threshold.x) < FilterEps;
+}
+
+// Filters the stars by their original position
+bool isFilteredByPosition(vec3 position) {
+  return isOutside(position.x, posXThreshold) ||
+         isOutside(position.y, posYThreshold) ||
+         isOutside(position.z, posZThreshold) ||
+         isExcluded(length(position), distThreshold);
+}
+
+// Filters the stars by their G magnitude and Bp-Rp color. For the magnitude, 20 is read
+// as an unbounded limit instead of 0
+bool isFilteredByBrightness(vec2 brightness) {
+  return isExcluded(brightness.x, gMagThreshold) ||
+         (abs(gMagThreshold.x - 20.0) > FilterEps && brightness.x < gMagThreshold.x) ||
+         (abs(gMagThreshold.y - 20.0) > FilterEps && brightness.x > gMagThreshold.y) ||
+         isExcluded(brightness.y, bpRpThreshold) ||
+         isOutside(brightness.y, bpRpThreshold);
+}
+
+// Filters the stars by their distance [kPc] after they have been moved along their
+// velocity, as well as by the parallax [mas] that corresponds to that distance
+bool isFilteredByDistance(float distance) {
+  bool outsideDistance = abs(distThreshold.x - distThreshold.y) > FilterEps &&
+                         isOutside(distance, distThreshold);
+  bool outsideParallax = abs(parallaxThreshold.x - parallaxThreshold.y) > FilterEps &&
+                         isOutside(1.0 / max(distance, FilterEps), parallaxThreshold);
+  return outsideDistance || outsideParallax;
+}
+
+#endif // _GAIA_FILTER_GLSL_
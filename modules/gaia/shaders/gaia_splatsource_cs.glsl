@@ -0,0 +1,152 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+#include "starsplatter/splatstar.glsl"
+#include "gaia_filter.glsl"
+
+// Provides the streamed stars of RenderableGaiaStars to the StarSplatter. The layout of
+// the buffers has to be kept in sync with gaia_ssbo_vs.glsl
+
+// Keep in sync with gaiaoptions.h:RenderOption enum
+const int RENDEROPTION_MOTION = 2;
+const float EPS = 1e-5;
+const float Parsec = 3.0856776e16;
+
+layout (std430) readonly buffer ssbo_idx_data {
+  int starsPerChunk[];
+};
+
+layout (std430) readonly buffer ssbo_comb_data {
+  float allData[];
+};
+
+uniform float time;
+uniform int renderOption;
+
+uniform int maxStarsPerNode;
+uniform int valuesPerStar;
+uniform int nChunksToRender;
+
+uniform bool quantizedData;
+uniform samplerBuffer nodeBounds;
+
+int findChunkId(int left, int right, int id) {
+  while (left <= right) {
+    int middle = (left + right) / 2;
+    int firstStarInChunk = starsPerChunk[middle];
+    if (left == right || (firstStarInChunk <= id && id < starsPerChunk[middle + 1])) {
+      return middle;
+    }
+    else if (id < firstStarInChunk) {
+      right = middle - 1;
+    }
+    else {
+      left = middle + 1;
+    }
+  }
+  return -1;
+}
+
+bool splatStar(uint index, out SplatStar star) {
+  int id = int(index);
+  int chunkId = findChunkId(0, nChunksToRender - 1, id);
+  if (chunkId == -1) {
+    return false;
+  }
+  int placeInChunk = id - starsPerChunk[chunkId];
+  int firstStarInChunk = valuesPerStar * maxStarsPerNode * chunkId;
+  int nStarsInChunk = starsPerChunk[chunkId + 1] - starsPerChunk[chunkId];
+  if (nStarsInChunk <= 0) {
+    return false;
+  }
+
+  vec3 position;
+  vec2 brightness;
+  vec3 velocity = vec3(0.0);
+  if (quantizedData) {
+    int startOfPos = firstStarInChunk + placeInChunk * 2;
+    vec4 offset = vec4(
+      unpackSnorm2x16(floatBitsToUint(allData[startOfPos])),
+      unpackSnorm2x16(floatBitsToUint(allData[startOfPos + 1]))
+    );
+    if (offset.w < 0.5) {
+      return false;
+    }
+    vec4 bounds = texelFetch(nodeBounds, chunkId);
+    position = bounds.xyz + offset.xyz * bounds.w;
+
+    int startOfCol = firstStarInChunk + nStarsInChunk * 2 + placeInChunk;
+    brightness = unpackHalf2x16(floatBitsToUint(allData[startOfCol]));
+
+    if (renderOption == RENDEROPTION_MOTION) {
+      // Quantized velocities are stored in [km/s]
+      int startOfVel = firstStarInChunk + nStarsInChunk * 3 + placeInChunk * 2;
+      velocity = 1000.0 * vec3(
+        unpackHalf2x16(floatBitsToUint(allData[startOfVel])),
+        unpackHalf2x16(floatBitsToUint(allData[startOfVel + 1])).x
+      );
+    }
+  }
+  else {
+    int startOfPos = firstStarInChunk + placeInChunk * 3;
+    position = vec3(
+      allData[startOfPos],
+      allData[startOfPos + 1],
+      allData[startOfPos + 2]
+    );
+    if (length(position) <= EPS) {
+      return false;
+    }
+
+    int startOfCol = firstStarInChunk + nStarsInChunk * 3 + placeInChunk * 2;
+    brightness = vec2(allData[startOfCol], allData[startOfCol + 1]);
+
+    if (renderOption == RENDEROPTION_MOTION) {
+      int startOfVel = firstStarInChunk + nStarsInChunk * 5 + placeInChunk * 3;
+      velocity = vec3(
+        allData[startOfVel],
+        allData[startOfVel + 1],
+        allData[startOfVel + 2]
+      );
+    }
+  }
+
+  if (isFilteredByPosition(position) || isFilteredByBrightness(brightness)) {
+    return false;
+  }
+
+  // Convert kiloParsec to meter and move the star along its velocity [m/s]
+  vec3 objectPosition = position * 1000.0 * Parsec + time * velocity;
+  float distance = length(objectPosition / (1000.0 * Parsec));
+  if (isFilteredByDistance(distance)) {
+    return false;
+  }
+
+  star.position = objectPosition;
+  star.absoluteMagnitude = brightness.x;
+  star.colorValue = brightness.y;
+  return true;
+}
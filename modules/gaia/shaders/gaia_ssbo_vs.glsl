@@ -25,6 +25,7 @@
 #version __CONTEXT__
 
 #include "floatoperations.glsl"
+#include "gaia_filter.glsl"
 
 // Keep in sync with gaiaoptions.h:RenderOption enum
 const int RENDEROPTION_STATIC = 0;
@@ -58,12 +59,10 @@ uniform int maxStarsPerNode;
 uniform int valuesPerStar;
 uniform int nChunksToRender;
 
-uniform vec2 posXThreshold;
-uniform vec2 posYThreshold;
-uniform vec2 posZThreshold;
-uniform vec2 gMagThreshold;
-uniform vec2 bpRpThreshold;
-uniform vec2 distThreshold;
+// If the data is quantized, the positions are stored as normalized offsets from the
+// origin of their node (xyz) scaled by its size (w), one texel per chunk
+uniform bool quantizedData;
+uniform samplerBuffer nodeBounds;
 
 // Use binary search to find the chunk containing our star ID.
 int findChunkId(int left, int right, int id) {
@@ -105,20 +104,28 @@ void main() {
         return;
     }
     
-    int startOfPos = firstStarInChunk + placeInChunk * 3;
-    vec3 in_position = vec3(allData[startOfPos], allData[startOfPos + 1], allData[startOfPos + 2]);
+    vec3 in_position;
+    bool hasPosition;
+    if (quantizedData) {
+        int startOfPos = firstStarInChunk + placeInChunk * 2;
+        vec4 offset = vec4(
+            unpackSnorm2x16(floatBitsToUint(allData[startOfPos])),
+            unpackSnorm2x16(floatBitsToUint(allData[startOfPos + 1]))
+        );
+        vec4 bounds = texelFetch(nodeBounds, chunkId);
+        in_position = bounds.xyz + offset.xyz * bounds.w;
+        hasPosition = offset.w > 0.5;
+    }
+    else {
+        int startOfPos = firstStarInChunk + placeInChunk * 3;
+        in_position = vec3(allData[startOfPos], allData[startOfPos + 1], allData[startOfPos + 2]);
+        hasPosition = length(in_position) > EPS;
+    }
     vec2 in_brightness = vec2(0.0);
     vec3 in_velocity = vec3(0.0);
 
     // Check if we should filter this star by position.
-    if ( (abs(posXThreshold.x) > EPS && in_position.x < posXThreshold.x) || 
-        (abs(posXThreshold.y) > EPS && in_position.x > posXThreshold.y) || 
-        (abs(posYThreshold.x) > EPS && in_position.y < posYThreshold.x) || 
-        (abs(posYThreshold.y) > EPS && in_position.y > posYThreshold.y) || 
-        (abs(posZThreshold.x) > EPS && in_position.z < posZThreshold.x) || 
-        (abs(posZThreshold.y) > EPS && in_position.z > posZThreshold.y) || 
-        (abs(distThreshold.x - distThreshold.y) < EPS 
-        && abs(length(in_position) - distThreshold.y) < EPS) ) {
+    if ( isFilteredByPosition(in_position) ) {
         // Discard star in geometry shader.
         vs_gPosition = vec4(0.0);    
         gl_Position = vec4(0.0);
@@ -127,16 +134,17 @@ void main() {
 
 
     if ( renderOption != RENDEROPTION_STATIC ) {
-        int startOfCol = firstStarInChunk + nStarsInChunk * 3 + placeInChunk * 2;
-        in_brightness = vec2(allData[startOfCol], allData[startOfCol + 1]);
+        if (quantizedData) {
+            int startOfCol = firstStarInChunk + nStarsInChunk * 2 + placeInChunk;
+            in_brightness = unpackHalf2x16(floatBitsToUint(allData[startOfCol]));
+        }
+        else {
+            int startOfCol = firstStarInChunk + nStarsInChunk * 3 + placeInChunk * 2;
+            in_brightness = vec2(allData[startOfCol], allData[startOfCol + 1]);
+        }
 
         // Check if we should filter this star by magnitude or color.
-        if ( (abs(gMagThreshold.x - gMagThreshold.y) < EPS && abs(gMagThreshold.x - in_brightness.x) < EPS) ||
-            (abs(gMagThreshold.x - 20.0f) > EPS && in_brightness.x < gMagThreshold.x) || 
-            (abs(gMagThreshold.y - 20.0f) > EPS && in_brightness.x > gMagThreshold.y) ||
-            (abs(bpRpThreshold.x - bpRpThreshold.y) < EPS && abs(bpRpThreshold.x - in_brightness.y) < EPS) ||
-            (abs(bpRpThreshold.x) > EPS && in_brightness.y < bpRpThreshold.x) || 
-            (abs(bpRpThreshold.y) > EPS && in_brightness.y > bpRpThreshold.y) ) {
+        if ( isFilteredByBrightness(in_brightness) ) {
             // Discard star in geometry shader.
             vs_gPosition = vec4(0.0);    
             gl_Position = vec4(0.0);
@@ -144,8 +152,18 @@ void main() {
         }
 
         if ( renderOption == RENDEROPTION_MOTION ) {
-            int startOfVel = firstStarInChunk + nStarsInChunk * 5 + placeInChunk * 3;
-            in_velocity = vec3(allData[startOfVel], allData[startOfVel + 1], allData[startOfVel + 2]);
+            if (quantizedData) {
+                // Quantized velocities are stored in [km/s].
+                int startOfVel = firstStarInChunk + nStarsInChunk * 3 + placeInChunk * 2;
+                in_velocity = 1000.0 * vec3(
+                    unpackHalf2x16(floatBitsToUint(allData[startOfVel])),
+                    unpackHalf2x16(floatBitsToUint(allData[startOfVel + 1])).x
+                );
+            }
+            else {
+                int startOfVel = firstStarInChunk + nStarsInChunk * 5 + placeInChunk * 3;
+                in_velocity = vec3(allData[startOfVel], allData[startOfVel + 1], allData[startOfVel + 2]);
+            }
         } 
     }
     vs_brightness = in_brightness;
@@ -158,9 +176,7 @@ void main() {
 
     // Thres moving stars by their new position.
     float distPosition = length(objectPosition.xyz / (1000.0 * Parsec) );
-    if ( (abs(distThreshold.x - distThreshold.y) > EPS && 
-        ((abs(distThreshold.x) > EPS && distPosition < distThreshold.x) || 
-        (abs(distThreshold.y) > EPS && distPosition > distThreshold.y))) ) {
+    if ( isFilteredByDistance(distPosition) ) {
         // Discard star in geometry shader.
         vs_gPosition = vec4(0.0);    
         gl_Position = vec4(0.0);
@@ -176,7 +192,7 @@ void main() {
 
     // Remove stars without position, happens when VBO chunk is stuffed with zeros.
     // Has to be done in Geometry shader because Vertices cannot be discarded here.
-    if ( length(in_position) > EPS ){
+    if ( hasPosition ){
         vs_gPosition = vec4(model * objectPosition);    
         gl_Position = vec4(projection * viewPosition);
     } else {
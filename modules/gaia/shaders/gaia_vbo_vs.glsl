@@ -25,6 +25,7 @@
 #version __CONTEXT__
 
 #include "floatoperations.glsl"
+#include "gaia_filter.glsl"
 
 // Keep in sync with gaiaoptions.h:RenderOption enum
 const int RENDEROPTION_STATIC = 0;
@@ -33,7 +34,7 @@ const int RENDEROPTION_MOTION = 2;
 const float EPS = 1e-5;
 const float Parsec = 3.0856776e16;
 
-in vec3 in_position;
+in vec4 in_position;
 in vec2 in_brightness;
 in vec3 in_velocity;
 
@@ -47,33 +48,28 @@ uniform dmat4 view;
 uniform dmat4 projection;
 uniform float time; 
 uniform int renderOption;
+uniform int maxStarsPerNode;
 
-uniform vec2 posXThreshold;
-uniform vec2 posYThreshold;
-uniform vec2 posZThreshold;
-uniform vec2 gMagThreshold;
-uniform vec2 bpRpThreshold;
-uniform vec2 distThreshold;
+// If the data is quantized, the positions are stored as normalized offsets from the
+// origin of their node (xyz) scaled by its size (w), one texel per chunk
+uniform bool quantizedData;
+uniform samplerBuffer nodeBounds;
 
 void main() {
     vs_brightness = in_brightness;
 
+    vec3 position = in_position.xyz;
+    bool hasPosition = length(position) > EPS;
+    if (quantizedData) {
+        // The fourth component flags the slots of the chunk that hold a star.
+        vec4 bounds = texelFetch(nodeBounds, gl_VertexID / maxStarsPerNode);
+        position = bounds.xyz + in_position.xyz * bounds.w;
+        hasPosition = in_position.w > 0.5;
+    }
+
     // Check if we should filter this star by position. Thres depending on original values.
-    if ( (abs(posXThreshold.x) > EPS && in_position.x < posXThreshold.x) || 
-        (abs(posXThreshold.y) > EPS && in_position.x > posXThreshold.y) || 
-        (abs(posYThreshold.x) > EPS && in_position.y < posYThreshold.x) || 
-        (abs(posYThreshold.y) > EPS && in_position.y > posYThreshold.y) || 
-        (abs(posZThreshold.x) > EPS && in_position.z < posZThreshold.x) || 
-        (abs(posZThreshold.y) > EPS && in_position.z > posZThreshold.y) || 
-        (abs(distThreshold.x - distThreshold.y) < EPS 
-        && abs(length(in_position) - distThreshold.y) < EPS) ||
-        ( renderOption != RENDEROPTION_STATIC && (
-        (abs(gMagThreshold.x - gMagThreshold.y) < EPS && abs(gMagThreshold.x - in_brightness.x) < EPS) ||
-        (abs(gMagThreshold.x - 20.0f) > EPS && in_brightness.x < gMagThreshold.x) || 
-        (abs(gMagThreshold.y - 20.0f) > EPS && in_brightness.x > gMagThreshold.y) ||
-        (abs(bpRpThreshold.x - bpRpThreshold.y) < EPS && abs(bpRpThreshold.x - in_brightness.y) < EPS) ||
-        (abs(bpRpThreshold.x) > EPS && in_brightness.y < bpRpThreshold.x) || 
-        (abs(bpRpThreshold.y) > EPS && in_brightness.y > bpRpThreshold.y))) ) {
+    if ( isFilteredByPosition(position) ||
+        (renderOption != RENDEROPTION_STATIC && isFilteredByBrightness(in_brightness)) ) {
         // Discard star in geometry shader.
         vs_gPosition = vec4(0.0);    
         gl_Position = vec4(0.0);
@@ -81,19 +77,18 @@ void main() {
     }
 
     // Convert kiloParsec to meter.
-    vec4 objectPosition = vec4(in_position * 1000 * Parsec, 1.0);
+    vec4 objectPosition = vec4(position * 1000 * Parsec, 1.0);
 
     // Add velocity if we've read any.
     if ( renderOption == RENDEROPTION_MOTION ) {
-        // Velocity is already in [m/s].
-        objectPosition.xyz += time * in_velocity;
+        // Velocity is already in [m/s], unless it has been quantized to [km/s].
+        vec3 velocity = quantizedData ? 1000.0 * in_velocity : in_velocity;
+        objectPosition.xyz += time * velocity;
     }
 
     // Thres moving stars by their new position.
     float distPosition = length(objectPosition.xyz / (1000.0 * Parsec) );
-    if ( (abs(distThreshold.x - distThreshold.y) > EPS && 
-        ((abs(distThreshold.x) > EPS && distPosition< distThreshold.x) || 
-        (abs(distThreshold.y) > EPS && distPosition > distThreshold.y))) ) {
+    if ( isFilteredByDistance(distPosition) ) {
         // Discard star in geometry shader.
         vs_gPosition = vec4(0.0);    
         gl_Position = vec4(0.0);
@@ -109,7 +104,7 @@ void main() {
 
     // Remove stars without position, happens when VBO chunk is stuffed with zeros.
     // Has to be done in Geometry shader because Vertices cannot be discarded here.
-    if ( length(in_position) > EPS ){
+    if ( hasPosition ){
         vs_gPosition = vec4(model * objectPosition);    
         gl_Position = vec4(projection * viewPosition);
     } else {
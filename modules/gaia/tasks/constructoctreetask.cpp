@@ -31,7 +31,11 @@
 #include <ghoul/filesystem/directory.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <fstream>
+#include <mutex>
 #include <thread>
 
 namespace {
@@ -40,6 +44,8 @@ namespace {
     constexpr const char* KeyMaxDist = "MaxDist";
     constexpr const char* KeyMaxStarsPerNode = "MaxStarsPerNode";
     constexpr const char* KeySingleFileInput = "SingleFileInput";
+    constexpr const char* KeyThreadsToUse = "ThreadsToUse";
+    constexpr const char* KeyResumeFromCheckpoint = "ResumeFromCheckpoint";
 
     constexpr const char* KeyFilterPosX = "FilterPosX";
     constexpr const char* KeyFilterPosY = "FilterPosY";
@@ -93,6 +99,20 @@ ConstructOctreeTask::ConstructOctreeTask(const ghoul::Dictionary& dictionary) {
         _singleFileInput = dictionary.value<bool>(KeySingleFileInput);
     }
 
+    if (dictionary.hasKey(KeyThreadsToUse)) {
+        _threadsToUse = static_cast<size_t>(dictionary.value<double>(KeyThreadsToUse));
+        if (_threadsToUse < 1) {
+            LINFO(fmt::format(
+                "User defined ThreadsToUse was: {}. Will be set to 1", _threadsToUse
+            ));
+            _threadsToUse = 1;
+        }
+    }
+
+    if (dictionary.hasKey(KeyResumeFromCheckpoint)) {
+        _resumeFromCheckpoint = dictionary.value<bool>(KeyResumeFromCheckpoint);
+    }
+
     _octreeManager = std::make_shared<OctreeManager>();
     _indexOctreeManager = std::make_shared<OctreeManager>();
 
@@ -334,153 +354,74 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
 void ConstructOctreeTask::constructOctreeFromFolder(
                                            const Task::ProgressCallback& progressCallback)
 {
-    int32_t nStars = 0;
-    int32_t nValuesPerStar = 0;
-    size_t nFilteredStars = 0;
-    //float maxRadius = 0.0;
-    //int starsOutside10 = 0;
-    //int starsOutside25 = 0;
-    //int starsOutside50 = 0;
-    //int starsOutside75 = 0;
-    //int starsOutside100 = 0;
-    //int starsOutside200 = 0;
-    //int starsOutside300 = 0;
-    //int starsOutside400 = 0;
-    //int starsOutside500 = 0;
-    //int starsOutside750 = 0;
-    //int starsOutside1000 = 0;
-    //int starsOutside1500 = 0;
-    //int starsOutside2000 = 0;
-    //int starsOutside5000 = 0;
-
     ghoul::filesystem::Directory currentDir(_inFileOrFolderPath);
     std::vector<std::string> allInputFiles = currentDir.readFiles();
-    std::vector<float> filterValues;
-    auto writeThreads = std::vector<std::thread>(8);
 
-    _indexOctreeManager->initOctree(0, _maxDist, _maxStarsPerNode);
+    // Every input file holds the stars of one branch of the Octree
+    if (allInputFiles.size() > 8) {
+        LWARNING(fmt::format(
+            "Found {} files in '{}' but only the first 8 will be read, one per branch",
+            allInputFiles.size(), _inFileOrFolderPath
+        ));
+        allInputFiles.resize(8);
+    }
 
-    float processOneFile = 1.f / allInputFiles.size();
+    _indexOctreeManager->initOctree(0, _maxDist, _maxStarsPerNode);
 
     LINFO(fmt::format(
         "MAX DIST: {} - MAX STARS PER NODE: {}",
         _indexOctreeManager->maxDist(), _indexOctreeManager->maxStarsPerNode()
     ));
 
-    for (size_t idx = 0; idx < allInputFiles.size(); ++idx) {
-        std::string inFilePath = allInputFiles[idx];
-        int nStarsInfile = 0;
-
-        LINFO("Reading data file: " + inFilePath);
-
-        std::ifstream inFileStream(inFilePath, std::ifstream::binary);
-        if (inFileStream.good()) {
-            inFileStream.read(reinterpret_cast<char*>(&nValuesPerStar), sizeof(int32_t));
-            filterValues.resize(nValuesPerStar, 0.f);
-
-            while (inFileStream.read(
-                reinterpret_cast<char*>(filterValues.data()),
-                nValuesPerStar * sizeof(filterValues[0])
-            ))
-            {
-                // Filter data by parameters.
-                if (checkAllFilters(filterValues)) {
-                    nFilteredStars++;
-                    continue;
-                }
-                // Generate a 50/12,5 dataset (gMag <=13/>13).
-                //if ((filterStar(glm::vec2(20.0), filterValues[3], 20.f)) ||
-                //    (filterStar(glm::vec2(0.0), filterValues[16])) ||
-                //    (filterValues[3] > 13.0 && filterValues[17] > 0.125) ||
-                //    (filterValues[3] <= 13.0 && filterValues[17] > 0.5)) {
-                //    nFilteredStars++;
-                //    continue;
-                //}
-
-                // If all filters passed then insert render values into Octree.
-                std::vector<float> renderValues(
-                    filterValues.begin(),
-                    filterValues.begin() + RENDER_VALUES
+    std::atomic<size_t> nextFile = 0;
+    std::atomic<int32_t> nStars = 0;
+    std::atomic<size_t> nFilteredStars = 0;
+    std::mutex progressMutex;
+    size_t nFinishedFiles = 0;
+
+    // Each thread constructs, slices and writes one branch at a time. Different
+    // branches don't share any nodes, so they can be inserted into concurrently.
+    auto constructBranches = [&]() {
+        for (size_t idx = nextFile++; idx < allInputFiles.size(); idx = nextFile++) {
+            int nStarsInBranch = 0;
+            if (_resumeFromCheckpoint && readBranchCheckpoint(idx, nStarsInBranch)) {
+                LINFO(fmt::format("Restored branch {} from checkpoint", idx));
+            }
+            else {
+                size_t nFilteredInBranch = 0;
+                nStarsInBranch = constructBranchFromFile(
+                    allInputFiles[idx],
+                    idx,
+                    nFilteredInBranch
                 );
-
-                _indexOctreeManager->insert(renderValues);
-                nStarsInfile++;
-
-                //float maxVal = fmax(fmax(fabs(renderValues[0]), fabs(renderValues[1])),
-                //    fabs(renderValues[2]));
-                //if (maxVal > maxRadius) maxRadius = maxVal;
-                //// Calculate how many stars are outside of different thresholds.
-                //if (maxVal > 10) starsOutside10++;
-                //if (maxVal > 25) starsOutside25++;
-                //if (maxVal > 50) starsOutside50++;
-                //if (maxVal > 75) starsOutside75++;
-                //if (maxVal > 100) starsOutside100++;
-                //if (maxVal > 200) starsOutside200++;
-                //if (maxVal > 300) starsOutside300++;
-                //if (maxVal > 400) starsOutside400++;
-                //if (maxVal > 500) starsOutside500++;
-                //if (maxVal > 750) starsOutside750++;
-                //if (maxVal > 1000) starsOutside1000++;
-                //if (maxVal > 1500) starsOutside1500++;
-                //if (maxVal > 2000) starsOutside2000++;
-                //if (maxVal > 5000) starsOutside5000++;
+                nFilteredStars += nFilteredInBranch;
+                writeBranchCheckpoint(idx);
             }
-            inFileStream.close();
-        }
-        else {
-            LERROR(fmt::format(
-                "Error opening file '{}' for loading preprocessed file!", inFilePath
-            ));
-        }
+            nStars += nStarsInBranch;
 
-        // Slice LOD data.
-        LINFO("Slicing LOD data!");
-        _indexOctreeManager->sliceLodData(idx);
-
-        progressCallback((idx + 1) * processOneFile);
-        nStars += nStarsInfile;
+            std::lock_guard g(progressMutex);
+            nFinishedFiles++;
+            progressCallback(static_cast<float>(nFinishedFiles) / allInputFiles.size());
+        }
+    };
 
-        LINFO(fmt::format("Writing {} stars to octree files!", nStarsInfile));
-        LINFO(fmt::format(
-            "Number leaf nodes: {}\n Number inner nodes: {}\n Total depth of tree: {}",
-            _indexOctreeManager->numLeafNodes(),
-            _indexOctreeManager->numInnerNodes(),
-            _indexOctreeManager->totalDepth()
-        ));
+    const size_t nThreads = std::min(_threadsToUse, allInputFiles.size());
+    std::vector<std::thread> constructThreads;
+    for (size_t i = 1; i < nThreads; ++i) {
+        constructThreads.emplace_back(constructBranches);
+    }
+    constructBranches();
 
-        // Write to 8 separate files in a separate thread. Data will be cleared after it
-        // has been written. Store joinable thread for later sync.
-        std::thread t(
-            &OctreeManager::writeToMultipleFiles,
-            _indexOctreeManager,
-            _outFileOrFolderPath,
-            idx
-        );
-        writeThreads[idx] = std::move(t);
+    // Make sure all threads are done.
+    for (std::thread& t : constructThreads) {
+        t.join();
     }
 
     LINFO(fmt::format(
         "A total of {} stars were read from files and distributed into {} total nodes",
-        nStars, _indexOctreeManager->totalNodes()
+        nStars.load(), _indexOctreeManager->totalNodes()
     ));
-    LINFO(std::to_string(nFilteredStars) + " stars were filtered");
-
-    //LINFO("Max radius of dataset is: " + std::to_string(maxRadius) +
-    //    "\n Number of stars outside of:" +
-    //    " - 10kPc is " + std::to_string(starsOutside10) + "\n" +
-    //    " - 25kPc is " + std::to_string(starsOutside25) + "\n" +
-    //    " - 50kPc is " + std::to_string(starsOutside50) + "\n" +
-    //    " - 75kPc is " + std::to_string(starsOutside75) + "\n" +
-    //    " - 100kPc is " + std::to_string(starsOutside100) + "\n" +
-    //    " - 200kPc is " + std::to_string(starsOutside200) + "\n" +
-    //    " - 300kPc is " + std::to_string(starsOutside300) + "\n" +
-    //    " - 400kPc is " + std::to_string(starsOutside400) + "\n" +
-    //    " - 500kPc is " + std::to_string(starsOutside500) + "\n" +
-    //    " - 750kPc is " + std::to_string(starsOutside750) + "\n" +
-    //    " - 1000kPc is " + std::to_string(starsOutside1000) + "\n" +
-    //    " - 1500kPc is " + std::to_string(starsOutside1500) + "\n" +
-    //    " - 2000kPc is " + std::to_string(starsOutside2000) + "\n" +
-    //    " - 5000kPc is " + std::to_string(starsOutside5000));
+    LINFO(std::to_string(nFilteredStars.load()) + " stars were filtered");
 
     // Write index file of Octree structure.
     std::string indexFileOutPath = _outFileOrFolderPath + "index.bin";
@@ -490,17 +431,130 @@ void ConstructOctreeTask::constructOctreeFromFolder(
         _indexOctreeManager->writeToFile(outFileStream, false);
 
         outFileStream.close();
+
+        // The construction is finished, the checkpoints are not needed anymore
+        for (size_t idx = 0; idx < allInputFiles.size(); ++idx) {
+            std::remove(branchCheckpointPath(idx).c_str());
+        }
     }
     else {
         LERROR(fmt::format(
             "Error opening file: {} as index output file.", indexFileOutPath
         ));
     }
+}
 
-    // Make sure all threads are done.
-    for (int i = 0; i < 8; ++i) {
-        writeThreads[i].join();
+int ConstructOctreeTask::constructBranchFromFile(const std::string& inFilePath,
+                                                 size_t branchIndex,
+                                                 size_t& nFilteredStars)
+{
+    int nStarsInfile = 0;
+    int32_t nValuesPerStar = 0;
+    std::vector<float> filterValues;
+    std::vector<float> renderValues(RENDER_VALUES);
+
+    LINFO("Reading data file: " + inFilePath);
+
+    std::ifstream inFileStream(inFilePath, std::ifstream::binary);
+    if (inFileStream.good()) {
+        inFileStream.read(reinterpret_cast<char*>(&nValuesPerStar), sizeof(int32_t));
+        filterValues.resize(nValuesPerStar, 0.f);
+
+        while (inFileStream.read(
+            reinterpret_cast<char*>(filterValues.data()),
+            nValuesPerStar * sizeof(filterValues[0])
+        ))
+        {
+            // Filter data by parameters.
+            if (checkAllFilters(filterValues)) {
+                nFilteredStars++;
+                continue;
+            }
+
+            // Other branches are constructed concurrently, so a star that is misplaced
+            // in this file must not be inserted into any of them
+            const size_t starBranch = (filterValues[0] < 0.f ? 1 : 0) +
+                (filterValues[1] < 0.f ? 2 : 0) + (filterValues[2] < 0.f ? 4 : 0);
+            if (starBranch != branchIndex) {
+                nFilteredStars++;
+                continue;
+            }
+
+            // If all filters passed then insert render values into Octree.
+            renderValues.assign(
+                filterValues.begin(),
+                filterValues.begin() + RENDER_VALUES
+            );
+
+            _indexOctreeManager->insert(renderValues);
+            nStarsInfile++;
+        }
+        inFileStream.close();
+    }
+    else {
+        LERROR(fmt::format(
+            "Error opening file '{}' for loading preprocessed file!", inFilePath
+        ));
+    }
+
+    // Slice LOD data.
+    LINFO(fmt::format("Slicing LOD data of branch {}!", branchIndex));
+    _indexOctreeManager->sliceLodData(branchIndex);
+
+    // Write to 8 separate files. Data will be cleared after it has been written.
+    LINFO(fmt::format("Writing {} stars to octree files!", nStarsInfile));
+    _indexOctreeManager->writeToMultipleFiles(_outFileOrFolderPath, branchIndex);
+
+    return nStarsInfile;
+}
+
+std::string ConstructOctreeTask::branchCheckpointPath(size_t branchIndex) const {
+    return fmt::format("{}checkpoint_{}.bin", _outFileOrFolderPath, branchIndex);
+}
+
+void ConstructOctreeTask::writeBranchCheckpoint(size_t branchIndex) {
+    std::string outPath = branchCheckpointPath(branchIndex);
+    std::ofstream outFileStream(outPath, std::ofstream::binary);
+    if (!outFileStream.good()) {
+        LERROR(fmt::format("Error opening file: {} as checkpoint file.", outPath));
+        return;
+    }
+
+    // Store the parameters of the construction to not resume a different Octree
+    const int32_t maxDist = static_cast<int32_t>(_indexOctreeManager->maxDist());
+    const int32_t maxStarsPerNode = static_cast<int32_t>(
+        _indexOctreeManager->maxStarsPerNode()
+    );
+    outFileStream.write(reinterpret_cast<const char*>(&maxDist), sizeof(int32_t));
+    outFileStream.write(
+        reinterpret_cast<const char*>(&maxStarsPerNode),
+        sizeof(int32_t)
+    );
+    _indexOctreeManager->writeBranchToFile(outFileStream, branchIndex);
+}
+
+bool ConstructOctreeTask::readBranchCheckpoint(size_t branchIndex, int& nStarsInBranch) {
+    std::ifstream inFileStream(branchCheckpointPath(branchIndex), std::ifstream::binary);
+    if (!inFileStream.good()) {
+        return false;
+    }
+
+    int32_t maxDist = 0;
+    int32_t maxStarsPerNode = 0;
+    inFileStream.read(reinterpret_cast<char*>(&maxDist), sizeof(int32_t));
+    inFileStream.read(reinterpret_cast<char*>(&maxStarsPerNode), sizeof(int32_t));
+    if (!inFileStream.good() ||
+        static_cast<size_t>(maxDist) != _indexOctreeManager->maxDist() ||
+        static_cast<size_t>(maxStarsPerNode) != _indexOctreeManager->maxStarsPerNode())
+    {
+        LWARNING(fmt::format(
+            "Checkpoint of branch {} was constructed with other parameters", branchIndex
+        ));
+        return false;
     }
+
+    nStarsInBranch = _indexOctreeManager->readBranchFromFile(inFileStream, branchIndex);
+    return true;
 }
 
 bool ConstructOctreeTask::checkAllFilters(const std::vector<float>& filterValues) {
@@ -590,6 +644,24 @@ documentation::Documentation ConstructOctreeTask::Documentation() {
                 "binary file with the full Octree. If false then task will read all "
                 "files in specified folder and output multiple files for the Octree."
             },
+            {
+                KeyThreadsToUse,
+                new IntVerifier,
+                Optional::Yes,
+                "Defines how many branches of the Octree that are constructed at the "
+                "same time when reading from multiple files. Every branch that is "
+                "constructed concurrently is kept in memory until it has been written. "
+                "Default is 1."
+            },
+            {
+                KeyResumeFromCheckpoint,
+                new BoolVerifier,
+                Optional::Yes,
+                "If true then branches that were completely written by an earlier, "
+                "interrupted, construction into the same output folder will be restored "
+                "from their checkpoint files instead of being constructed again. Only "
+                "used when reading from multiple files. Default is false."
+            },
             {
                 KeyFilterPosX,
                 new Vector2Verifier<double>,
@@ -62,6 +62,34 @@ private:
      */
     void constructOctreeFromFolder(const Task::ProgressCallback& progressCallback);
 
+    /**
+     * Reads binary star data from \param inFilePath and inserts the stars that pass all
+     * filters into the branch with index \param branchIndex. The branch is then sliced
+     * and written to one file per node, after which its data is cleared.
+     * \param nFilteredStars is increased with the number of stars that were filtered.
+     * \returns the number of stars that were inserted.
+     */
+    int constructBranchFromFile(const std::string& inFilePath, size_t branchIndex,
+        size_t& nFilteredStars);
+
+    /**
+     * \returns the path of the checkpoint file for the branch \param branchIndex.
+     */
+    std::string branchCheckpointPath(size_t branchIndex) const;
+
+    /**
+     * Writes the structure of a branch that has been written to files, so that a later
+     * construction can resume without constructing that branch again.
+     */
+    void writeBranchCheckpoint(size_t branchIndex);
+
+    /**
+     * Restores the structure of a branch from its checkpoint file. \returns false if
+     * there is no checkpoint that was constructed with the same parameters.
+     * \param nStarsInBranch is set to the number of stars in the restored branch.
+     */
+    bool readBranchCheckpoint(size_t branchIndex, int& nStarsInBranch);
+
     /**
      * Checks all defined filter ranges and \returns true if any of the corresponding
      * <code>filterValues</code> are outside of the defined range.
@@ -83,6 +111,8 @@ private:
     int _maxDist = 0;
     int _maxStarsPerNode = 0;
     bool _singleFileInput = false;
+    size_t _threadsToUse = 1;
+    bool _resumeFromCheckpoint = false;
 
     std::shared_ptr<OctreeManager> _octreeManager;
     std::shared_ptr<OctreeManager> _indexOctreeManager;
@@ -34,8 +34,10 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/fmt.h>
 
+#include <chrono>
 #include <fstream>
 #include <set>
+#include <thread>
 
 namespace {
     constexpr const char* KeyInFileOrFolderPath = "InFileOrFolderPath";
@@ -165,7 +167,7 @@ void ReadFitsTask::readSingleFitsFile(const Task::ProgressCallback& progressCall
     }
 }
 
-void ReadFitsTask::readAllFitsFilesFromFolder(const Task::ProgressCallback&) {
+void ReadFitsTask::readAllFitsFilesFromFolder(const Task::ProgressCallback& progress) {
     std::vector<std::vector<float>> octants(8);
     std::vector<bool> isFirstWrite(8, true);
     size_t finishedJobs = 0;
@@ -252,33 +254,43 @@ void ReadFitsTask::readAllFitsFilesFromFolder(const Task::ProgressCallback&) {
 
     // Check for finished jobs.
     while (finishedJobs < nInputFiles) {
-        if (jobManager.numFinishedJobs() > 0) {
-            std::vector<std::vector<float>> newOctant =
-                jobManager.popFinishedJob()->product();
+        if (jobManager.numFinishedJobs() == 0) {
+            // Don't keep a core busy that the reading threads could use
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        std::vector<std::vector<float>> newOctant =
+            jobManager.popFinishedJob()->product();
 
-            finishedJobs++;
+        finishedJobs++;
+        progress(static_cast<float>(finishedJobs) / nInputFiles);
 
-            for (int i = 0; i < 8; ++i) {
-                // Add read values to global octant and check if it's time to write!
+        for (int i = 0; i < 8; ++i) {
+            // Add read values to global octant and check if it's time to write!
+            if (octants[i].empty()) {
+                octants[i] = std::move(newOctant[i]);
+            }
+            else {
                 octants[i].insert(
                     octants[i].end(),
                     newOctant[i].begin(),
                     newOctant[i].end()
                 );
-                if ((octants[i].size() > MAX_SIZE_BEFORE_WRITE) ||
-                    (finishedJobs == nInputFiles))
-                {
-                    // Write to file!
-                    totalStars += writeOctantToFile(
-                        octants[i],
-                        i,
-                        isFirstWrite,
-                        nValuesPerStar
-                    );
-
-                    octants[i].clear();
-                    octants[i].shrink_to_fit();
-                }
+            }
+            if ((octants[i].size() > MAX_SIZE_BEFORE_WRITE) ||
+                (finishedJobs == nInputFiles))
+            {
+                // Write to file!
+                totalStars += writeOctantToFile(
+                    octants[i],
+                    i,
+                    isFirstWrite,
+                    nValuesPerStar
+                );
+
+                octants[i].clear();
+                octants[i].shrink_to_fit();
             }
         }
     }
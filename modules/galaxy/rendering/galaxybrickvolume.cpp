@@ -0,0 +1,487 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/galaxy/rendering/galaxybrickvolume.h>
+
+#include <openspace/util/job.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+    constexpr const char* _loggerCat = "GalaxyBrickVolume";
+
+    // The size of a brick in the atlas, including the border that makes the linear
+    // interpolation across the brick boundaries seamless
+    constexpr const int PaddedBrickSize = openspace::GalaxyBrickVolume::BrickSize + 2;
+
+    // Limits the number of bricks that are read ahead and uploaded in a single frame
+    constexpr const int MaxPendingBricks = 16;
+    constexpr const int MaxUploadsPerFrame = 8;
+
+    using Brick = openspace::GalaxyBrickVolume::Brick;
+
+    // Reads a brick and its border from the raw volume. Voxels outside the volume are
+    // replaced by the closest voxel on its boundary, which matches the clamped
+    // sampling of the base level
+    struct BrickReadJob : public openspace::Job<Brick> {
+        BrickReadJob(std::ifstream& file, glm::ivec3 dimensions, glm::ivec3 brick,
+                     int index)
+            : _file(file)
+            , _dimensions(dimensions)
+            , _brick(brick)
+        {
+            _product.index = index;
+        }
+
+        void execute() override {
+            constexpr const int P = PaddedBrickSize;
+            _product.data.resize(P * P * P);
+
+            const glm::ivec3 first = _brick * openspace::GalaxyBrickVolume::BrickSize -
+                                     glm::ivec3(1);
+            const int xBegin = std::max(first.x, 0);
+            const int xEnd = std::min(first.x + P, _dimensions.x);
+
+            for (int z = 0; z < P; ++z) {
+                const int vz = glm::clamp(first.z + z, 0, _dimensions.z - 1);
+                for (int y = 0; y < P; ++y) {
+                    const int vy = glm::clamp(first.y + y, 0, _dimensions.y - 1);
+                    glm::vec4* row = _product.data.data() + (z * P + y) * P;
+
+                    const int64_t offset =
+                        (static_cast<int64_t>(vz) * _dimensions.y + vy) * _dimensions.x +
+                        xBegin;
+                    _file.clear();
+                    _file.seekg(offset * sizeof(glm::vec4));
+                    _file.read(
+                        reinterpret_cast<char*>(row + (xBegin - first.x)),
+                        (xEnd - xBegin) * sizeof(glm::vec4)
+                    );
+
+                    std::fill(row, row + (xBegin - first.x), row[xBegin - first.x]);
+                    std::fill(row + (xEnd - first.x), row + P, row[xEnd - first.x - 1]);
+                }
+            }
+        }
+
+        Brick product() override {
+            return std::move(_product);
+        }
+
+        std::ifstream& _file;
+        glm::ivec3 _dimensions;
+        glm::ivec3 _brick;
+        Brick _product;
+    };
+
+    // Reads the raw volume slice by slice and averages each block of downscale^3 voxels
+    // into one voxel of the base level
+    std::vector<glm::vec4> readBaseLevel(const std::string& filename,
+                                         glm::ivec3 dimensions, int downscale)
+    {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        if (!file.good()) {
+            LERROR(fmt::format("Failed to open volume file '{}'", filename));
+            return {};
+        }
+
+        const size_t nSliceVoxels = static_cast<size_t>(dimensions.x) * dimensions.y;
+        if (downscale == 1) {
+            std::vector<glm::vec4> volume(nSliceVoxels * dimensions.z);
+            file.read(
+                reinterpret_cast<char*>(volume.data()),
+                volume.size() * sizeof(glm::vec4)
+            );
+            return volume;
+        }
+
+        const glm::ivec3 baseDims = (dimensions + downscale - 1) / downscale;
+        std::vector<glm::vec4> base(
+            static_cast<size_t>(baseDims.x) * baseDims.y * baseDims.z,
+            glm::vec4(0.f)
+        );
+        std::vector<float> weights(base.size(), 0.f);
+
+        std::vector<glm::vec4> slice(nSliceVoxels);
+        for (int z = 0; z < dimensions.z; ++z) {
+            file.read(
+                reinterpret_cast<char*>(slice.data()),
+                slice.size() * sizeof(glm::vec4)
+            );
+            const size_t baseSlice = static_cast<size_t>(z / downscale) * baseDims.y;
+            for (int y = 0; y < dimensions.y; ++y) {
+                const size_t baseRow = (baseSlice + y / downscale) * baseDims.x;
+                for (int x = 0; x < dimensions.x; ++x) {
+                    base[baseRow + x / downscale] += slice[y * dimensions.x + x];
+                    weights[baseRow + x / downscale] += 1.f;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < base.size(); ++i) {
+            base[i] /= weights[i];
+        }
+        return base;
+    }
+
+    float distanceToBox(const glm::vec3& p, const glm::vec3& lo, const glm::vec3& hi) {
+        return glm::length(glm::max(glm::max(lo - p, glm::vec3(0.f)), p - hi));
+    }
+} // namespace
+
+namespace openspace {
+
+GalaxyBrickVolume::GalaxyBrickVolume(std::string filename, glm::ivec3 dimensions,
+                                     int baseDownscale, int nResidentBricks)
+    : _filename(std::move(filename))
+    , _dimensions(dimensions)
+    , _baseDownscale(std::max(baseDownscale, 1))
+    , _nResidentBricks(std::max(nResidentBricks, 0))
+    , _jobManager(ThreadPool(1))
+{}
+
+void GalaxyBrickVolume::initialize() {
+    _baseLevelFuture = std::async(
+        std::launch::async,
+        readBaseLevel,
+        _filename,
+        _dimensions,
+        _baseDownscale
+    );
+
+    _brickGridSize = (_dimensions + BrickSize - 1) / BrickSize;
+    const int nBricks = _brickGridSize.x * _brickGridSize.y * _brickGridSize.z;
+
+    // The atlas is kept close to a cube so that it stays within the 3D texture limits
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE, &maxSize);
+    const int maxGridSize = std::min(maxSize / PaddedBrickSize, 255);
+    int nSlots = std::min(_nResidentBricks, nBricks);
+    const int side = static_cast<int>(std::ceil(std::cbrt(std::max(nSlots, 1))));
+    _atlasGridSize = glm::ivec3(std::min(side, maxGridSize));
+    const int nSlotsPerLayer = _atlasGridSize.x * _atlasGridSize.y;
+    _atlasGridSize.z = std::min(
+        (std::max(nSlots, 1) + nSlotsPerLayer - 1) / nSlotsPerLayer,
+        maxGridSize
+    );
+    if (nSlots > _atlasGridSize.x * _atlasGridSize.y * _atlasGridSize.z) {
+        nSlots = _atlasGridSize.x * _atlasGridSize.y * _atlasGridSize.z;
+        LWARNING(fmt::format("Limiting the number of resident bricks to {}", nSlots));
+    }
+
+    const glm::ivec3 atlasDims = atlasDimensions();
+    glGenTextures(1, &_brickAtlas);
+    glBindTexture(GL_TEXTURE_3D, _brickAtlas);
+    glTexImage3D(
+        GL_TEXTURE_3D,
+        0,
+        GL_RGBA32F,
+        atlasDims.x,
+        atlasDims.y,
+        atlasDims.z,
+        0,
+        GL_RGBA,
+        GL_FLOAT,
+        nullptr
+    );
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    _pageTableData = std::vector<glm::u8vec4>(nBricks, glm::u8vec4(0));
+    glGenTextures(1, &_pageTable);
+    glBindTexture(GL_TEXTURE_3D, _pageTable);
+    glTexImage3D(
+        GL_TEXTURE_3D,
+        0,
+        GL_RGBA8UI,
+        _brickGridSize.x,
+        _brickGridSize.y,
+        _brickGridSize.z,
+        0,
+        GL_RGBA_INTEGER,
+        GL_UNSIGNED_BYTE,
+        _pageTableData.data()
+    );
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    _slotOfBrick = std::vector<int>(nBricks, -1);
+    _isDesired = std::vector<bool>(nBricks, false);
+    _isRequested = std::vector<bool>(nBricks, false);
+    _brickInSlot = std::vector<int>(nSlots, -1);
+    _freeSlots.resize(nSlots);
+    // Reversed so that the slots are handed out in ascending order
+    std::iota(_freeSlots.rbegin(), _freeSlots.rend(), 0);
+
+    if (nSlots > 0) {
+        _file.open(_filename, std::ios::in | std::ios::binary);
+        _isStreaming = _file.good();
+        if (!_isStreaming) {
+            LERROR(fmt::format("Failed to open volume file '{}'", _filename));
+        }
+    }
+}
+
+void GalaxyBrickVolume::deinitialize() {
+    _jobManager.clearEnqueuedJobs();
+    if (_baseLevelFuture.valid()) {
+        _baseLevelFuture.wait();
+    }
+
+    _baseTexture = nullptr;
+    glDeleteTextures(1, &_brickAtlas);
+    _brickAtlas = 0;
+    glDeleteTextures(1, &_pageTable);
+    _pageTable = 0;
+}
+
+void GalaxyBrickVolume::update(const glm::vec3& cameraPosition) {
+    if (!_baseTexture) {
+        if (!_baseLevelFuture.valid() ||
+            _baseLevelFuture.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready)
+        {
+            return;
+        }
+        uploadBaseLevel();
+    }
+
+    if (!_isStreaming) {
+        return;
+    }
+
+    // The selection only changes noticeably once the camera has moved by a fraction
+    // of a brick, so it is not repeated every frame
+    const glm::vec3 cameraVoxel = cameraPosition * glm::vec3(_dimensions);
+    if (!_hasSelection ||
+        glm::distance(cameraVoxel, _selectionPosition) > BrickSize / 2.f)
+    {
+        selectBricks(cameraVoxel);
+    }
+
+    requestBricks();
+    uploadBricks();
+
+    if (_pageTableIsDirty) {
+        glBindTexture(GL_TEXTURE_3D, _pageTable);
+        glTexSubImage3D(
+            GL_TEXTURE_3D,
+            0,
+            0,
+            0,
+            0,
+            _brickGridSize.x,
+            _brickGridSize.y,
+            _brickGridSize.z,
+            GL_RGBA_INTEGER,
+            GL_UNSIGNED_BYTE,
+            _pageTableData.data()
+        );
+        glBindTexture(GL_TEXTURE_3D, 0);
+        _pageTableIsDirty = false;
+    }
+}
+
+bool GalaxyBrickVolume::isReady() const {
+    return _baseTexture != nullptr;
+}
+
+ghoul::opengl::Texture& GalaxyBrickVolume::baseTexture() {
+    ghoul_assert(_baseTexture, "Base level must have been uploaded");
+    return *_baseTexture;
+}
+
+GLuint GalaxyBrickVolume::brickAtlas() const {
+    return _brickAtlas;
+}
+
+GLuint GalaxyBrickVolume::pageTable() const {
+    return _pageTable;
+}
+
+glm::ivec3 GalaxyBrickVolume::dimensions() const {
+    return _dimensions;
+}
+
+glm::ivec3 GalaxyBrickVolume::atlasDimensions() const {
+    return _atlasGridSize * PaddedBrickSize;
+}
+
+void GalaxyBrickVolume::uploadBaseLevel() {
+    _baseLevel = _baseLevelFuture.get();
+    if (_baseLevel.empty()) {
+        return;
+    }
+
+    const glm::ivec3 baseDims = (_dimensions + _baseDownscale - 1) / _baseDownscale;
+    _baseTexture = std::make_unique<ghoul::opengl::Texture>(
+        glm::uvec3(baseDims),
+        ghoul::opengl::Texture::Format::RGBA,
+        GL_RGBA32F,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::Clamp
+    );
+    _baseTexture->setPixelData(
+        reinterpret_cast<char*>(_baseLevel.data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    _baseTexture->uploadTexture();
+}
+
+void GalaxyBrickVolume::selectBricks(const glm::vec3& cameraVoxel) {
+    const int nBricks = static_cast<int>(_slotOfBrick.size());
+    std::vector<std::pair<float, int>> distances(nBricks);
+    for (int z = 0; z < _brickGridSize.z; ++z) {
+        for (int y = 0; y < _brickGridSize.y; ++y) {
+            for (int x = 0; x < _brickGridSize.x; ++x) {
+                const int i = (z * _brickGridSize.y + y) * _brickGridSize.x + x;
+                const glm::vec3 lo = glm::vec3(glm::ivec3(x, y, z) * BrickSize);
+                const glm::vec3 hi = glm::min(
+                    lo + glm::vec3(BrickSize),
+                    glm::vec3(_dimensions)
+                );
+                distances[i] = { distanceToBox(cameraVoxel, lo, hi), i };
+            }
+        }
+    }
+
+    const int nDesired = static_cast<int>(_brickInSlot.size());
+    std::partial_sort(
+        distances.begin(),
+        distances.begin() + nDesired,
+        distances.end()
+    );
+
+    std::fill(_isDesired.begin(), _isDesired.end(), false);
+    _desiredBricks.resize(nDesired);
+    for (int i = 0; i < nDesired; ++i) {
+        _desiredBricks[i] = distances[i].second;
+        _isDesired[distances[i].second] = true;
+    }
+
+    _hasSelection = true;
+    _selectionPosition = cameraVoxel;
+}
+
+void GalaxyBrickVolume::requestBricks() {
+    for (int brick : _desiredBricks) {
+        if (_nPendingBricks >= MaxPendingBricks) {
+            break;
+        }
+        if (_slotOfBrick[brick] != -1 || _isRequested[brick]) {
+            continue;
+        }
+
+        const glm::ivec3 index = glm::ivec3(
+            brick % _brickGridSize.x,
+            (brick / _brickGridSize.x) % _brickGridSize.y,
+            brick / (_brickGridSize.x * _brickGridSize.y)
+        );
+        _jobManager.enqueueJob(
+            std::make_shared<BrickReadJob>(_file, _dimensions, index, brick)
+        );
+        _isRequested[brick] = true;
+        _nPendingBricks++;
+    }
+}
+
+void GalaxyBrickVolume::uploadBricks() {
+    for (int i = 0; i < MaxUploadsPerFrame && _jobManager.numFinishedJobs() > 0; ++i) {
+        Brick brick = _jobManager.popFinishedJob()->product();
+        _isRequested[brick.index] = false;
+        _nPendingBricks--;
+
+        // The camera might have moved on while the brick was read
+        if (!_isDesired[brick.index]) {
+            continue;
+        }
+        const int slot = acquireSlot();
+        if (slot == -1) {
+            continue;
+        }
+
+        const glm::ivec3 atlasBrick = glm::ivec3(
+            slot % _atlasGridSize.x,
+            (slot / _atlasGridSize.x) % _atlasGridSize.y,
+            slot / (_atlasGridSize.x * _atlasGridSize.y)
+        );
+        const glm::ivec3 offset = atlasBrick * PaddedBrickSize;
+        glBindTexture(GL_TEXTURE_3D, _brickAtlas);
+        glTexSubImage3D(
+            GL_TEXTURE_3D,
+            0,
+            offset.x,
+            offset.y,
+            offset.z,
+            PaddedBrickSize,
+            PaddedBrickSize,
+            PaddedBrickSize,
+            GL_RGBA,
+            GL_FLOAT,
+            brick.data.data()
+        );
+        glBindTexture(GL_TEXTURE_3D, 0);
+
+        _slotOfBrick[brick.index] = slot;
+        _brickInSlot[slot] = brick.index;
+        _pageTableData[brick.index] = glm::u8vec4(glm::u8vec3(atlasBrick), 255);
+        _pageTableIsDirty = true;
+    }
+}
+
+int GalaxyBrickVolume::acquireSlot() {
+    if (!_freeSlots.empty()) {
+        const int slot = _freeSlots.back();
+        _freeSlots.pop_back();
+        return slot;
+    }
+
+    // All slots are used, so a brick that is no longer among the closest ones is evicted
+    for (size_t slot = 0; slot < _brickInSlot.size(); ++slot) {
+        const int brick = _brickInSlot[slot];
+        if (!_isDesired[brick]) {
+            _slotOfBrick[brick] = -1;
+            _pageTableData[brick] = glm::u8vec4(0);
+            _pageTableIsDirty = true;
+            return static_cast<int>(slot);
+        }
+    }
+    return -1;
+}
+
+} // namespace openspace
@@ -0,0 +1,139 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GALAXY___GALAXYBRICKVOLUME___H__
+#define __OPENSPACE_MODULE_GALAXY___GALAXYBRICKVOLUME___H__
+
+#include <openspace/util/concurrentjobmanager.h>
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ghoul::opengl { class Texture; }
+
+namespace openspace {
+
+/**
+ * Provides the galaxy volume to the raycaster as two resolution levels. The base level
+ * is a downscaled version of the whole volume that is always resident. The full
+ * resolution is split into bricks of #BrickSize voxels, and only the bricks closest to
+ * the camera are kept in a fixed size brick atlas. A page table with one entry per brick
+ * stores where a brick is located in the atlas, or that it is not resident, in which
+ * case the raycaster falls back to the base level.
+ *
+ * The bricks are read from the raw RGBA float volume on a background thread, and the
+ * base level is created asynchronously as well, so the volume never blocks a frame on
+ * disk access. With a base level downscale of 1 and no resident bricks, the whole
+ * volume is provided at full resolution.
+ */
+class GalaxyBrickVolume {
+public:
+    /// The number of voxels along each side of a brick
+    static constexpr const int BrickSize = 32;
+
+    struct Brick {
+        int index;
+        /// The voxels of the brick with a border of one voxel on each side
+        std::vector<glm::vec4> data;
+    };
+
+    GalaxyBrickVolume(std::string filename, glm::ivec3 dimensions, int baseDownscale,
+        int nResidentBricks);
+
+    /// Creates the brick atlas and page table and starts reading the base level
+    void initialize();
+    void deinitialize();
+
+    /**
+     * Uploads the base level once it has been created, requests the bricks that are
+     * closest to the \p cameraPosition, which is given in normalized volume coordinates,
+     * and uploads the bricks that have been read since the last call.
+     */
+    void update(const glm::vec3& cameraPosition);
+
+    /// Returns \c true once the base level has been uploaded
+    bool isReady() const;
+
+    ghoul::opengl::Texture& baseTexture();
+    GLuint brickAtlas() const;
+    GLuint pageTable() const;
+    glm::ivec3 dimensions() const;
+    /// Returns the size of the brick atlas in voxels
+    glm::ivec3 atlasDimensions() const;
+
+private:
+    void uploadBaseLevel();
+    void selectBricks(const glm::vec3& cameraVoxel);
+    void requestBricks();
+    void uploadBricks();
+    int acquireSlot();
+
+    const std::string _filename;
+    const glm::ivec3 _dimensions;
+    const int _baseDownscale;
+    const int _nResidentBricks;
+
+    std::future<std::vector<glm::vec4>> _baseLevelFuture;
+    std::vector<glm::vec4> _baseLevel;
+    std::unique_ptr<ghoul::opengl::Texture> _baseTexture;
+
+    /// The number of bricks along each axis of the volume
+    glm::ivec3 _brickGridSize;
+    /// The number of bricks along each axis of the atlas
+    glm::ivec3 _atlasGridSize;
+    GLuint _brickAtlas = 0;
+    GLuint _pageTable = 0;
+    /// The atlas brick coordinates of each brick, the alpha channel is set if resident
+    std::vector<glm::u8vec4> _pageTableData;
+    bool _pageTableIsDirty = false;
+
+    /// The atlas slot of each brick or -1 if it is not resident
+    std::vector<int> _slotOfBrick;
+    /// The brick in each atlas slot or -1 if the slot is free
+    std::vector<int> _brickInSlot;
+    std::vector<int> _freeSlots;
+
+    /// The bricks that should be resident, ordered by their distance to the camera
+    std::vector<int> _desiredBricks;
+    std::vector<bool> _isDesired;
+    std::vector<bool> _isRequested;
+    int _nPendingBricks = 0;
+    /// Set if there are atlas slots and the volume file could be opened for the bricks
+    bool _isStreaming = false;
+    bool _hasSelection = false;
+    glm::vec3 _selectionPosition = glm::vec3(0.f);
+
+    // The stream has to outlive the job manager, whose destruction waits for the brick
+    // that is currently being read
+    std::ifstream _file;
+    ConcurrentJobManager<Brick> _jobManager;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_GALAXY___GALAXYBRICKVOLUME___H__
@@ -24,6 +24,7 @@
 
 #include <modules/galaxy/rendering/galaxyraycaster.h>
 
+#include <modules/galaxy/rendering/galaxybrickvolume.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/opengl/ghoul_gl.h>
@@ -42,9 +43,9 @@ namespace {
 
 namespace openspace {
 
-GalaxyRaycaster::GalaxyRaycaster(ghoul::opengl::Texture& texture)
+GalaxyRaycaster::GalaxyRaycaster(GalaxyBrickVolume& volume)
     : _boundingBox(glm::vec3(1.0))
-    , _texture(texture)
+    , _volume(volume)
     , _textureUnit(nullptr)
 {}
 
@@ -113,12 +114,30 @@ void GalaxyRaycaster::preRaycast(const RaycastData& data,
 
     _textureUnit = std::make_unique<ghoul::opengl::TextureUnit>();
     _textureUnit->activate();
-    _texture.bind();
+    _volume.baseTexture().bind();
     program.setUniform(galaxyTextureUniformName, *_textureUnit);
+
+    // The resident full resolution bricks and the page table that locates them
+    const std::string id = std::to_string(data.id);
+    _atlasUnit = std::make_unique<ghoul::opengl::TextureUnit>();
+    _atlasUnit->activate();
+    glBindTexture(GL_TEXTURE_3D, _volume.brickAtlas());
+    program.setUniform("brickAtlas" + id, *_atlasUnit);
+
+    _pageTableUnit = std::make_unique<ghoul::opengl::TextureUnit>();
+    _pageTableUnit->activate();
+    glBindTexture(GL_TEXTURE_3D, _volume.pageTable());
+    program.setUniform("pageTable" + id, *_pageTableUnit);
+
+    program.setUniform("volumeDimensions" + id, glm::vec3(_volume.dimensions()));
+    program.setUniform("atlasDimensions" + id, glm::vec3(_volume.atlasDimensions()));
 }
 
 void GalaxyRaycaster::postRaycast(const RaycastData&, ghoul::opengl::ProgramObject&) {
-    _textureUnit = nullptr; // release texture unit.
+    // release texture units.
+    _textureUnit = nullptr;
+    _atlasUnit = nullptr;
+    _pageTableUnit = nullptr;
 }
 
 bool GalaxyRaycaster::isCameraInside(const RenderData& data, glm::vec3& localPosition) {
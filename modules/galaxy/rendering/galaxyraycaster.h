@@ -40,12 +40,13 @@ namespace ghoul::opengl {
 
 namespace openspace {
 
+class GalaxyBrickVolume;
 struct RenderData;
 struct RaycastData;
 
 class GalaxyRaycaster : public VolumeRaycaster {
 public:
-    GalaxyRaycaster(ghoul::opengl::Texture& texture);
+    GalaxyRaycaster(GalaxyBrickVolume& volume);
 
     virtual ~GalaxyRaycaster() = default;
     void initialize();
@@ -79,8 +80,10 @@ private:
     glm::vec3 _aspect;
     double _time;
     float _opacityCoefficient;
-    ghoul::opengl::Texture& _texture;
+    GalaxyBrickVolume& _volume;
     std::unique_ptr<ghoul::opengl::TextureUnit> _textureUnit;
+    std::unique_ptr<ghoul::opengl::TextureUnit> _atlasUnit;
+    std::unique_ptr<ghoul::opengl::TextureUnit> _pageTableUnit;
 
 }; // GalaxyRaycaster
 
@@ -24,9 +24,8 @@
 
 #include <modules/galaxy/rendering/renderablegalaxy.h>
 
+#include <modules/galaxy/rendering/galaxybrickvolume.h>
 #include <modules/galaxy/rendering/galaxyraycaster.h>
-#include <modules/volume/rawvolume.h>
-#include <modules/volume/rawvolumereader.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/raycastermanager.h>
 #include <openspace/rendering/renderable.h>
@@ -42,6 +41,8 @@
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cstdint>
 #include <fstream>
 
 namespace {
@@ -50,12 +51,23 @@ namespace {
     constexpr const char* GlslBoundsFsPath = "${MODULES}/toyvolume/shaders/boundsFs.glsl";
     constexpr const char* _loggerCat       = "Renderable Galaxy";
 
+    // The downscale factor of the base level when the volume is streamed as bricks
+    constexpr const int BaseLevelDownscale = 4;
+
     constexpr openspace::properties::Property::PropertyInfo StepSizeInfo = {
         "StepSize",
         "Step Size",
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo DownscaleInfo = {
+        "Downscale",
+        "Downscale Factor",
+        "The factor by which the resolution at which this volume is raycast is reduced "
+        "relative to the rendering resolution. Lower values trade image quality for "
+        "rendering performance."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo PointStepSizeInfo = {
         "PointStepSize",
         "Point Step Size",
@@ -87,6 +99,7 @@ namespace openspace {
     : Renderable(dictionary)
     , _stepSize(StepSizeInfo, 0.012f, 0.0005f, 0.05f)
     , _pointStepSize(PointStepSizeInfo, 0.01f, 0.01f, 0.1f)
+    , _downscaleVolumeRendering(DownscaleInfo, 1.f, 0.1f, 1.f)
     , _translation(TranslationInfo, glm::vec3(0.f), glm::vec3(0.f), glm::vec3(10.f))
     , _rotation(RotationInfo, glm::vec3(0.f), glm::vec3(0.f), glm::vec3(6.28f))
     , _enabledPointsRatio(EnabledPointsRatioInfo, 0.2f, 0.f, 1.f)
@@ -120,6 +133,12 @@ namespace openspace {
     else {
         LERROR("No volume dimensions specified.");
     }
+    // The number of full resolution bricks that are kept on the GPU. Without it, the
+    // whole volume is uploaded at full resolution
+    double residentBricks = 0.0;
+    if (volumeDictionary.getValue("ResidentBricks", residentBricks)) {
+        _nResidentBricks = static_cast<int>(residentBricks);
+    }
 
     if (!dictionary.hasKeyAndValue<ghoul::Dictionary>("Points")) {
         LERROR("No points dictionary specified.");
@@ -140,34 +159,23 @@ void RenderableGalaxy::initializeGL() {
     _aspect = static_cast<glm::vec3>(_volumeDimensions);
     _aspect /= std::max(std::max(_aspect.x, _aspect.y), _aspect.z);
 
-    volume::RawVolumeReader<glm::tvec4<GLfloat>> reader(
+    // The volume and the points are read on background threads, the raycaster is only
+    // attached once the base level of the volume is available
+    _volume = std::make_unique<GalaxyBrickVolume>(
         _volumeFilename,
-        _volumeDimensions
-    );
-    _volume = reader.read();
-
-    _texture = std::make_unique<ghoul::opengl::Texture>(
         _volumeDimensions,
-        ghoul::opengl::Texture::Format::RGBA,
-        GL_RGBA32F,
-        GL_FLOAT,
-        ghoul::opengl::Texture::FilterMode::Linear,
-        ghoul::opengl::Texture::WrappingMode::Clamp);
-
-    _texture->setPixelData(reinterpret_cast<char*>(
-        _volume->data()),
-        ghoul::opengl::Texture::TakeOwnership::No
+        _nResidentBricks > 0 ? BaseLevelDownscale : 1,
+        _nResidentBricks
     );
+    _volume->initialize();
 
-    _texture->setDimensions(_volume->dimensions());
-    _texture->uploadTexture();
-
-    _raycaster = std::make_unique<GalaxyRaycaster>(*_texture);
+    _raycaster = std::make_unique<GalaxyRaycaster>(*_volume);
     _raycaster->initialize();
 
-    global::raycasterManager.attachRaycaster(*_raycaster);
-
     auto onChange = [&](bool enabled) {
+        if (!_volume->isReady()) {
+            return;
+        }
         if (enabled) {
             global::raycasterManager.attachRaycaster(*_raycaster);
         }
@@ -180,23 +188,34 @@ void RenderableGalaxy::initializeGL() {
 
     addProperty(_stepSize);
     addProperty(_pointStepSize);
+    addProperty(_downscaleVolumeRendering);
     addProperty(_translation);
     addProperty(_rotation);
     addProperty(_enabledPointsRatio);
 
-    // initialize points.
-    std::ifstream pointFile(_pointsFilename, std::ios::in | std::ios::binary);
+    _pointsFuture = std::async(std::launch::async, readPoints, _pointsFilename);
 
-    std::vector<glm::vec3> pointPositions;
-    std::vector<glm::vec3> pointColors;
+    _pointsProgram = global::renderEngine.buildRenderProgram(
+        "Galaxy points",
+        absPath("${MODULE_GALAXY}/shaders/points.vs"),
+        absPath("${MODULE_GALAXY}/shaders/points.fs")
+    );
+
+    _pointsProgram->setIgnoreUniformLocationError(
+        ghoul::opengl::ProgramObject::IgnoreError::Yes
+    );
+}
+
+RenderableGalaxy::PointData RenderableGalaxy::readPoints(const std::string& filename) {
+    std::ifstream pointFile(filename, std::ios::in | std::ios::binary);
+
+    PointData data;
 
     int64_t nPoints;
     pointFile.seekg(0, std::ios::beg); // read heder.
     pointFile.read(reinterpret_cast<char*>(&nPoints), sizeof(int64_t));
 
-    _nPoints = static_cast<size_t>(nPoints);
-
-    size_t nFloats = _nPoints * 7;
+    const size_t nFloats = static_cast<size_t>(nPoints) * 7;
 
     std::vector<float> pointData(nFloats);
     pointFile.seekg(sizeof(int64_t), std::ios::beg); // read past heder.
@@ -205,7 +224,9 @@ void RenderableGalaxy::initializeGL() {
 
     float maxdist = 0;
 
-    for (size_t i = 0; i < _nPoints; ++i) {
+    data.positions.reserve(static_cast<size_t>(nPoints));
+    data.colors.reserve(static_cast<size_t>(nPoints));
+    for (size_t i = 0; i < static_cast<size_t>(nPoints); ++i) {
         float x = pointData[i * 7 + 0];
         float y = pointData[i * 7 + 1];
         float z = pointData[i * 7 + 2];
@@ -215,11 +236,16 @@ void RenderableGalaxy::initializeGL() {
         maxdist = std::max(maxdist, glm::length(glm::vec3(x, y, z)));
         //float a = pointData[i * 7 + 6];  alpha is not used.
 
-        pointPositions.emplace_back(x, y, z);
-        pointColors.emplace_back(r, g, b);
+        data.positions.emplace_back(x, y, z);
+        data.colors.emplace_back(r, g, b);
     }
 
-    std::cout << maxdist << std::endl;
+    LDEBUG(fmt::format("Maximum point distance: {}", maxdist));
+    return data;
+}
+
+void RenderableGalaxy::uploadPoints(PointData data) {
+    _nPoints = data.positions.size();
 
     glGenVertexArrays(1, &_pointsVao);
     glGenBuffers(1, &_positionVbo);
@@ -228,28 +254,18 @@ void RenderableGalaxy::initializeGL() {
     glBindVertexArray(_pointsVao);
     glBindBuffer(GL_ARRAY_BUFFER, _positionVbo);
     glBufferData(GL_ARRAY_BUFFER,
-        pointPositions.size() * sizeof(glm::vec3),
-        pointPositions.data(),
+        data.positions.size() * sizeof(glm::vec3),
+        data.positions.data(),
         GL_STATIC_DRAW
     );
 
     glBindBuffer(GL_ARRAY_BUFFER, _colorVbo);
     glBufferData(GL_ARRAY_BUFFER,
-        pointColors.size() * sizeof(glm::vec3),
-        pointColors.data(),
+        data.colors.size() * sizeof(glm::vec3),
+        data.colors.data(),
         GL_STATIC_DRAW
     );
 
-    _pointsProgram = global::renderEngine.buildRenderProgram(
-        "Galaxy points",
-        absPath("${MODULE_GALAXY}/shaders/points.vs"),
-        absPath("${MODULE_GALAXY}/shaders/points.fs")
-    );
-
-    _pointsProgram->setIgnoreUniformLocationError(
-        ghoul::opengl::ProgramObject::IgnoreError::Yes
-    );
-
     GLint positionAttrib = _pointsProgram->attributeLocation("inPosition");
     GLint colorAttrib = _pointsProgram->attributeLocation("inColor");
 
@@ -267,9 +283,22 @@ void RenderableGalaxy::initializeGL() {
 
 void RenderableGalaxy::deinitializeGL() {
     if (_raycaster) {
-        global::raycasterManager.detachRaycaster(*_raycaster);
+        if (_volume->isReady()) {
+            global::raycasterManager.detachRaycaster(*_raycaster);
+        }
         _raycaster = nullptr;
     }
+    if (_volume) {
+        _volume->deinitialize();
+        _volume = nullptr;
+    }
+
+    if (_pointsFuture.valid()) {
+        _pointsFuture.wait();
+    }
+    glDeleteVertexArrays(1, &_pointsVao);
+    glDeleteBuffers(1, &_positionVbo);
+    glDeleteBuffers(1, &_colorVbo);
 }
 
 bool RenderableGalaxy::isReady() const {
@@ -277,6 +306,20 @@ bool RenderableGalaxy::isReady() const {
 }
 
 void RenderableGalaxy::update(const UpdateData& data) {
+    if (_pointsFuture.valid() &&
+        _pointsFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        uploadPoints(_pointsFuture.get());
+    }
+
+    if (_volume) {
+        const bool wasReady = _volume->isReady();
+        _volume->update(_cameraVolumePosition);
+        if (!wasReady && _volume->isReady() && isEnabled()) {
+            global::raycasterManager.attachRaycaster(*_raycaster);
+        }
+    }
+
     if (_raycaster) {
         //glm::mat4 transform = glm::translate(, static_cast<glm::vec3>(_translation));
         const glm::vec3 eulerRotation = static_cast<glm::vec3>(_rotation);
@@ -288,25 +331,39 @@ void RenderableGalaxy::update(const UpdateData& data) {
         transform = glm::rotate(transform, eulerRotation.y, glm::vec3(0, 1, 0));
         transform = glm::rotate(transform, eulerRotation.z,  glm::vec3(0, 0, 1));
 
-        glm::mat4 volumeTransform = glm::scale(transform, _volumeSize);
+        _volumeTransform = glm::scale(transform, _volumeSize);
         _pointTransform = glm::scale(transform, _pointScaling);
 
         const glm::vec4 translation = glm::vec4(_translation.value(), 0.0);
 
         // Todo: handle floating point overflow, to actually support translation.
 
-        volumeTransform[3] += translation;
+        _volumeTransform[3] += translation;
         _pointTransform[3] += translation;
 
         _raycaster->setStepSize(_stepSize);
+        _raycaster->setDownscaleRender(_downscaleVolumeRendering);
         _raycaster->setAspect(_aspect);
-        _raycaster->setModelTransform(volumeTransform);
+        _raycaster->setModelTransform(_volumeTransform);
         // @EMIL: is this correct? ---abock
         _raycaster->setTime(data.time.j2000Seconds());
     }
 }
 
 void RenderableGalaxy::render(const RenderData& data, RendererTasks& tasks) {
+    // The bricks closest to this position are streamed in the next update
+    const glm::dmat4 volumeModel = glm::translate(
+        glm::dmat4(_volumeTransform),
+        data.modelTransform.translation
+    );
+    _cameraVolumePosition = glm::vec3(
+        glm::inverse(volumeModel) * glm::dvec4(data.camera.positionVec3(), 1.0)
+    ) + glm::vec3(0.5f);
+
+    if (!_volume->isReady()) {
+        return;
+    }
+
     RaycasterTask task { _raycaster.get(), data };
 
     const glm::vec3 position = data.camera.positionVec3();
@@ -30,11 +30,12 @@
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/vector/vec3property.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <future>
+#include <vector>
 
 namespace openspace {
 
-namespace volume { template <typename T> class RawVolume; }
-
+class GalaxyBrickVolume;
 class GalaxyRaycaster;
 struct RenderData;
 
@@ -50,32 +51,46 @@ public:
     void update(const UpdateData& data) override;
 
 private:
+    struct PointData {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> colors;
+    };
+
     float safeLength(const glm::vec3& vector) const;
+    static PointData readPoints(const std::string& filename);
+    void uploadPoints(PointData data);
 
     glm::vec3 _volumeSize;
     glm::vec3 _pointScaling;
     properties::FloatProperty _stepSize;
     properties::FloatProperty _pointStepSize;
+    properties::FloatProperty _downscaleVolumeRendering;
     properties::Vec3Property _translation;
     properties::Vec3Property _rotation;
     properties::FloatProperty _enabledPointsRatio;
 
     std::string _volumeFilename;
     glm::ivec3 _volumeDimensions;
+    /// If this is larger than 0, the volume is streamed as bricks at full resolution
+    /// on top of a downscaled base level
+    int _nResidentBricks = 0;
     std::string _pointsFilename;
 
     std::unique_ptr<GalaxyRaycaster> _raycaster;
-    std::unique_ptr<volume::RawVolume<glm::tvec4<GLfloat>>> _volume;
-    std::unique_ptr<ghoul::opengl::Texture> _texture;
+    std::unique_ptr<GalaxyBrickVolume> _volume;
+    /// The camera position in normalized volume coordinates of the last render call
+    glm::vec3 _cameraVolumePosition = glm::vec3(0.5f);
+    glm::mat4 _volumeTransform;
     glm::mat4 _pointTransform;
     glm::vec3 _aspect;
     float _opacityCoefficient;
 
     std::unique_ptr<ghoul::opengl::ProgramObject> _pointsProgram;
-    size_t _nPoints;
-    GLuint _pointsVao;
-    GLuint _positionVbo;
-    GLuint _colorVbo;
+    std::future<PointData> _pointsFuture;
+    size_t _nPoints = 0;
+    GLuint _pointsVao = 0;
+    GLuint _positionVbo = 0;
+    GLuint _colorVbo = 0;
 };
 
 } // namespace openspace
@@ -27,6 +27,33 @@ uniform vec3 aspect#{id} = vec3(1.0);
 uniform float opacityCoefficient#{id} = 1.0; 
 
 uniform sampler3D galaxyTexture#{id};
+uniform sampler3D brickAtlas#{id};
+uniform usampler3D pageTable#{id};
+uniform vec3 volumeDimensions#{id};
+uniform vec3 atlasDimensions#{id};
+
+// Must match GalaxyBrickVolume::BrickSize
+const float BrickSize#{id} = 32.0;
+
+// Samples the full resolution brick that contains the sample position if it is resident
+// and the base level of the volume otherwise
+vec4 sampleVolume#{id}(vec3 samplePos) {
+    vec3 voxel = samplePos * volumeDimensions#{id};
+    ivec3 brick = clamp(
+        ivec3(voxel / BrickSize#{id}),
+        ivec3(0),
+        textureSize(pageTable#{id}, 0) - 1
+    );
+    uvec4 entry = texelFetch(pageTable#{id}, brick, 0);
+    if (entry.a == 0u) {
+        return texture(galaxyTexture#{id}, samplePos);
+    }
+
+    // Each brick is stored with a border of one voxel in the atlas
+    vec3 brickVoxel = voxel - vec3(brick) * BrickSize#{id};
+    vec3 atlasVoxel = vec3(entry.xyz) * (BrickSize#{id} + 2.0) + 1.0 + brickVoxel;
+    return texture(brickAtlas#{id}, atlasVoxel / atlasDimensions#{id});
+}
 
 void sample#{id}(vec3 samplePos,
                  vec3 dir,
@@ -38,7 +65,7 @@ void sample#{id}(vec3 samplePos,
     vec3 aspect = aspect#{id};
     maxStepSize = maxStepSize#{id} / length(dir / aspect);
     
-    vec4 sampledColor = texture(galaxyTexture#{id}, samplePos.xyz);
+    vec4 sampledColor = sampleVolume#{id}(samplePos.xyz);
 
     float STEP_SIZE = maxStepSize#{id};
 
@@ -24,23 +24,57 @@
 
 #include <modules/galaxy/tasks/milkywayconversiontask.h>
 
-#include <modules/volume/textureslicevolumereader.h>
-#include <modules/volume/rawvolumewriter.h>
 #include <modules/volume/volumesampler.h>
-#include <modules/volume/textureslicevolumereader.h>
-
-#include <modules/volume/rawvolumewriter.h>
 #include <openspace/documentation/documentation.h>
-
+#include <openspace/documentation/verifier.h>
+#include <ghoul/fmt.h>
+#include <ghoul/io/texture/texturereader.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <thread>
 
 namespace {
+    constexpr const char* _loggerCat = "MilkywayConversionTask";
+
     constexpr const char* KeyInFilenamePrefix = "InFilenamePrefix";
     constexpr const char* KeyInFilenameSuffix = "InFilenameSuffix";
     constexpr const char* KeyInFirstIndex = "InFirstIndex";
     constexpr const char* KeyInNSlices = "InNSlices";
     constexpr const char* KeyOutFilename = "OutFilename";
     constexpr const char* KeyOutDimensions = "OutDimensions";
+    constexpr const char* KeyThreadsToUse = "ThreadsToUse";
+    constexpr const char* KeyResume = "Resume";
+
+    using Voxel = glm::tvec4<GLfloat>;
+
+    /**
+     * The input slices that are needed for the output slices that are currently being
+     * computed. The slices are only read while the output slices are sampled, so the
+     * window can be shared between the threads without any synchronization. It has the
+     * interface that the VolumeSampler expects of a volume.
+     */
+    struct SliceWindow {
+        using VoxelType = Voxel;
+
+        Voxel get(const glm::ivec3& coordinates) const {
+            ghoul::opengl::Texture& slice = *slices[coordinates.z - firstSlice];
+            return slice.texel<Voxel>(glm::uvec2(coordinates.x, coordinates.y));
+        }
+
+        glm::ivec3 dimensions() const {
+            return dims;
+        }
+
+        glm::ivec3 dims = glm::ivec3(0);
+        int firstSlice = 0;
+        std::deque<std::unique_ptr<ghoul::opengl::Texture>> slices;
+    };
 } // namespace
 
 namespace openspace {
@@ -55,10 +89,27 @@ MilkywayConversionTask::MilkywayConversionTask(const ghoul::Dictionary& dictiona
     dictionary.getValue(KeyInNSlices, _inNSlices);
     dictionary.getValue(KeyOutFilename, _outFilename);
     dictionary.getValue(KeyOutDimensions, _outDimensions);
+
+    if (dictionary.hasKey(KeyThreadsToUse)) {
+        _threadsToUse = static_cast<size_t>(dictionary.value<double>(KeyThreadsToUse));
+        if (_threadsToUse < 1) {
+            LINFO(fmt::format(
+                "User defined ThreadsToUse was: {}. Will be set to 1", _threadsToUse
+            ));
+            _threadsToUse = 1;
+        }
+    }
+
+    if (dictionary.hasKey(KeyResume)) {
+        _resume = dictionary.value<bool>(KeyResume);
+    }
 }
 
 std::string MilkywayConversionTask::description() {
-    return std::string();
+    return fmt::format(
+        "Convert {} image slices starting with '{}' into the raw volume '{}'",
+        _inNSlices, _inFilenamePrefix, _outFilename
+    );
 }
 
 void MilkywayConversionTask::perform(const Task::ProgressCallback& onProgress) {
@@ -70,33 +121,196 @@ void MilkywayConversionTask::perform(const Task::ProgressCallback& onProgress) {
             _inFilenamePrefix + std::to_string(i + _inFirstIndex) + _inFilenameSuffix
         );
     }
+    if (filenames.empty()) {
+        throw ghoul::RuntimeError("No slices to convert", "MilkywayConversionTask");
+    }
+
+    SliceWindow window;
+    std::unique_ptr<ghoul::opengl::Texture> firstSlice =
+        ghoul::io::TextureReader::ref().loadTexture(filenames[0]);
+    window.dims = glm::ivec3(
+        glm::ivec2(glm::uvec2(firstSlice->dimensions())),
+        static_cast<int>(filenames.size())
+    );
+    window.slices.push_back(std::move(firstSlice));
+
+    const glm::ivec3 outDims = _outDimensions;
+    const glm::vec3 resolutionRatio = glm::vec3(window.dims) / glm::vec3(outDims);
+    VolumeSampler<SliceWindow> sampler(&window, resolutionRatio);
+
+    const size_t sliceSize = static_cast<size_t>(outDims.x) * outDims.y;
+    const size_t sliceBytes = sliceSize * sizeof(Voxel);
+
+    // The output file is written slice by slice, so all slices that fit completely in an
+    // existing file were finished by an earlier, interrupted, conversion
+    int firstOutSlice = 0;
+    if (_resume) {
+        std::ifstream existing(_outFilename, std::ios::binary | std::ios::ate);
+        if (existing.good()) {
+            const std::streamoff size = existing.tellg();
+            firstOutSlice = std::min(
+                static_cast<int>(static_cast<size_t>(size) / sliceBytes),
+                outDims.z
+            );
+            LINFO(fmt::format(
+                "Resuming conversion after {} of {} slices", firstOutSlice, outDims.z
+            ));
+        }
+    }
+
+    std::fstream file;
+    if (firstOutSlice > 0) {
+        file.open(_outFilename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(firstOutSlice * sliceBytes));
+    }
+    else {
+        file.open(_outFilename, std::ios::binary | std::ios::out | std::ios::trunc);
+    }
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open file '{}'", _outFilename),
+            "MilkywayConversionTask"
+        );
+    }
 
-    TextureSliceVolumeReader<glm::tvec4<GLfloat>> sliceReader(filenames, _inNSlices, 10);
-    sliceReader.initialize();
+    // Returns the first and the last input slice that the sampler reads for the output
+    // slice with index z
+    const int filterDepth = static_cast<int>(
+        (resolutionRatio.z - 1.f) * 0.5f
+    ) * 2 + 1;
+    auto inputRange = [&](int z) {
+        const float inZ = (z + 0.5f) * resolutionRatio.z - 0.5f;
+        const int first = static_cast<int>(std::floor(inZ)) - filterDepth / 2;
+        return glm::ivec2(
+            std::clamp(first, 0, window.dims.z - 1),
+            std::clamp(first + filterDepth, 0, window.dims.z - 1)
+        );
+    };
 
-    RawVolumeWriter<glm::tvec4<GLfloat>> rawWriter(_outFilename);
-    rawWriter.setDimensions(_outDimensions);
+    // Every thread computes one output slice of a batch. Only the input slices that are
+    // needed by the current batch are kept in memory
+    const int batchSize = static_cast<int>(_threadsToUse);
+    std::vector<std::vector<Voxel>> outSlices(batchSize, std::vector<Voxel>(sliceSize));
 
-    const glm::vec3 resolutionRatio = static_cast<glm::vec3>(sliceReader.dimensions()) /
-                                      static_cast<glm::vec3>(rawWriter.dimensions());
+    for (int batchStart = firstOutSlice; batchStart < outDims.z; batchStart += batchSize)
+    {
+        const int batchEnd = std::min(batchStart + batchSize, outDims.z);
+        const int first = inputRange(batchStart).x;
+        const int last = inputRange(batchEnd - 1).y;
 
-    VolumeSampler<TextureSliceVolumeReader<glm::tvec4<GLfloat>>> sampler(
-        &sliceReader,
-        resolutionRatio
-    );
-    std::function<glm::tvec4<GLfloat>(glm::ivec3)> sampleFunction =
-        [&](glm::ivec3 outCoord) {
-            const glm::vec3 inCoord = ((glm::vec3(outCoord) + glm::vec3(0.5)) *
-                                      resolutionRatio) - glm::vec3(0.5);
-            const glm::tvec4<GLfloat> value = sampler.sample(inCoord);
-            return value;
+        while (!window.slices.empty() && window.firstSlice < first) {
+            window.slices.pop_front();
+            ++window.firstSlice;
+        }
+        if (window.slices.empty()) {
+            window.firstSlice = first;
+        }
+        while (window.firstSlice + static_cast<int>(window.slices.size()) <= last) {
+            const size_t index = window.firstSlice + window.slices.size();
+            std::unique_ptr<ghoul::opengl::Texture> slice =
+                ghoul::io::TextureReader::ref().loadTexture(filenames[index]);
+            if (glm::ivec2(glm::uvec2(slice->dimensions())) != glm::ivec2(window.dims)) {
+                throw ghoul::RuntimeError(
+                    fmt::format("Dimensions of slice '{}' differ", filenames[index]),
+                    "MilkywayConversionTask"
+                );
+            }
+            window.slices.push_back(std::move(slice));
+        }
+
+        auto sampleSlice = [&](int z, std::vector<Voxel>& out) {
+            for (int y = 0; y < outDims.y; ++y) {
+                for (int x = 0; x < outDims.x; ++x) {
+                    const glm::vec3 inCoord = ((glm::vec3(x, y, z) + glm::vec3(0.5f)) *
+                                              resolutionRatio) - glm::vec3(0.5f);
+                    out[static_cast<size_t>(y) * outDims.x + x] = sampler.sample(inCoord);
+                }
+            }
         };
 
-    rawWriter.write(sampleFunction, onProgress);
+        std::vector<std::thread> threads;
+        for (int z = batchStart + 1; z < batchEnd; ++z) {
+            threads.emplace_back(sampleSlice, z, std::ref(outSlices[z - batchStart]));
+        }
+        sampleSlice(batchStart, outSlices[0]);
+        for (std::thread& t : threads) {
+            t.join();
+        }
+
+        for (int z = batchStart; z < batchEnd; ++z) {
+            file.write(
+                reinterpret_cast<const char*>(outSlices[z - batchStart].data()),
+                sliceBytes
+            );
+        }
+        // Make sure that the finished slices are on disk in case the conversion is
+        // interrupted and resumed later
+        file.flush();
+        onProgress(static_cast<float>(batchEnd) / outDims.z);
+    }
 }
 
 documentation::Documentation MilkywayConversionTask::documentation() {
-    return documentation::Documentation();
+    using namespace documentation;
+    return {
+        "MilkywayConversionTask",
+        "galaxy_milkywayconversiontask",
+        {
+            {
+                KeyInFilenamePrefix,
+                new StringVerifier,
+                Optional::No,
+                "The path to the input slices up to the slice index."
+            },
+            {
+                KeyInFilenameSuffix,
+                new StringVerifier,
+                Optional::No,
+                "The part of the input slice paths after the slice index."
+            },
+            {
+                KeyInFirstIndex,
+                new IntVerifier,
+                Optional::No,
+                "The index of the first input slice."
+            },
+            {
+                KeyInNSlices,
+                new IntVerifier,
+                Optional::No,
+                "The number of input slices."
+            },
+            {
+                KeyOutFilename,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The path of the raw volume that is created."
+            },
+            {
+                KeyOutDimensions,
+                new IntVector3Verifier,
+                Optional::No,
+                "The number of voxels of the raw volume along each axis."
+            },
+            {
+                KeyThreadsToUse,
+                new IntVerifier,
+                Optional::Yes,
+                "The number of output slices that are computed at the same time. The "
+                "input slices that are needed for all of them are kept in memory. "
+                "Default is the number of hardware threads."
+            },
+            {
+                KeyResume,
+                new BoolVerifier,
+                Optional::Yes,
+                "If true then the slices that an earlier, interrupted, conversion has "
+                "written to the output file are kept and the conversion continues after "
+                "them. The other parameters have to be the same as in the earlier "
+                "conversion. Default is false."
+            }
+        }
+    };
 }
 
 } // namespace openspace
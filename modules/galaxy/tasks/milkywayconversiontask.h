@@ -28,7 +28,9 @@
 #include <openspace/util/task.h>
 
 #include <ghoul/glm.h>
+#include <algorithm>
 #include <string>
+#include <thread>
 
 namespace openspace {
 
@@ -37,6 +39,8 @@ namespace documentation { struct Documentation; }
 /**
  * Converts a set of exr image slices to a raw volume
  * with floating point RGBA data (32 bit per channel).
+ * The output slices are computed in parallel and written to the file as soon as they
+ * are finished, so an interrupted conversion can be resumed.
  */
 class MilkywayConversionTask : public Task {
 public:
@@ -54,6 +58,8 @@ private:
     size_t _inNSlices;
     std::string _outFilename;
     glm::ivec3 _outDimensions;
+    size_t _threadsToUse = std::max(1u, std::thread::hardware_concurrency());
+    bool _resume = false;
 };
 
 } // namespace openspace
@@ -25,73 +25,223 @@
 #include <modules/galaxy/tasks/milkywaypointsconversiontask.h>
 
 #include <openspace/documentation/documentation.h>
-
+#include <openspace/documentation/verifier.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
-#include <iostream>
+#include <limits>
+#include <thread>
 #include <vector>
 
+namespace {
+    constexpr const char* _loggerCat = "MilkywayPointsConversionTask";
+
+    constexpr const char* KeyInFilename = "InFilename";
+    constexpr const char* KeyOutFilename = "OutFilename";
+    constexpr const char* KeyThreadsToUse = "ThreadsToUse";
+    constexpr const char* KeyResume = "Resume";
+
+    // x, y, z, r, g, b, a
+    constexpr const int NValuesPerPoint = 7;
+
+    // The number of points that are read, converted, and written at a time
+    constexpr const int64_t PointsPerChunk = 1 << 20;
+
+    // Parses the values of the lines [first, last) into the values array, which holds
+    // NValuesPerPoint values per line. Returns false if any line is malformed
+    bool parseLines(const std::vector<std::string>& lines, size_t first, size_t last,
+                    float* values)
+    {
+        for (size_t i = first; i < last; ++i) {
+            const char* p = lines[i].c_str();
+            for (int v = 0; v < NValuesPerPoint; ++v) {
+                char* end = nullptr;
+                values[i * NValuesPerPoint + v] = std::strtof(p, &end);
+                if (end == p) {
+                    return false;
+                }
+                p = end;
+            }
+        }
+        return true;
+    }
+} // namespace
+
 namespace openspace {
 
-/*MilkywayPointsConversionTask::MilkywayPointsConversionTask(
-    const std::string& inFilename,
-    const std::string& outFilename)
-    : _inFilename(inFilename)
-    , _outFilename(outFilename) {}*/
+MilkywayPointsConversionTask::MilkywayPointsConversionTask(
+                                                      const ghoul::Dictionary& dictionary)
+{
+    dictionary.getValue(KeyInFilename, _inFilename);
+    dictionary.getValue(KeyOutFilename, _outFilename);
+
+    if (dictionary.hasKey(KeyThreadsToUse)) {
+        _threadsToUse = static_cast<size_t>(dictionary.value<double>(KeyThreadsToUse));
+        if (_threadsToUse < 1) {
+            LINFO(fmt::format(
+                "User defined ThreadsToUse was: {}. Will be set to 1", _threadsToUse
+            ));
+            _threadsToUse = 1;
+        }
+    }
 
-MilkywayPointsConversionTask::MilkywayPointsConversionTask(const ghoul::Dictionary&) {}
+    if (dictionary.hasKey(KeyResume)) {
+        _resume = dictionary.value<bool>(KeyResume);
+    }
+}
 
 std::string MilkywayPointsConversionTask::description() {
-    return std::string();
+    return fmt::format(
+        "Convert the point data in '{}' into the binary file '{}'",
+        _inFilename, _outFilename
+    );
 }
 
 void MilkywayPointsConversionTask::perform(const Task::ProgressCallback& progressCallback)
 {
     std::ifstream in(_inFilename, std::ios::in);
-    std::ofstream out(_outFilename, std::ios::out | std::ios::binary);
+    if (!in.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open file '{}'", _inFilename),
+            "MilkywayPointsConversionTask"
+        );
+    }
 
     std::string format;
     int64_t nPoints;
     in >> format >> nPoints;
-
-    size_t nFloats = nPoints * 7;
-
-    std::vector<float> pointData(nFloats);
-
-    float x;
-    float y;
-    float z;
-    float r;
-    float g;
-    float b;
-    float a;
-
-    for (int64_t i = 0; i < nPoints; ++i) {
-        in >> x >> y >> z >> r >> g >> b >> a;
-        if (in.good()) {
-            pointData[i * 7 + 0] = x;
-            pointData[i * 7 + 1] = y;
-            pointData[i * 7 + 2] = z;
-            pointData[i * 7 + 3] = r;
-            pointData[i * 7 + 4] = g;
-            pointData[i * 7 + 5] = b;
-            pointData[i * 7 + 6] = a;
-            progressCallback(static_cast<float>(i + 1) / nPoints);
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    const size_t pointSize = NValuesPerPoint * sizeof(float);
+
+    // The points are appended to the output file chunk by chunk after the header, so
+    // all points that fit completely in an existing file were converted by an earlier,
+    // interrupted, conversion
+    int64_t firstPoint = 0;
+    if (_resume) {
+        std::ifstream existing(_outFilename, std::ios::binary);
+        int64_t existingNPoints = 0;
+        existing.read(reinterpret_cast<char*>(&existingNPoints), sizeof(int64_t));
+        if (existing.good() && existingNPoints == nPoints) {
+            existing.seekg(0, std::ios::end);
+            const int64_t size = static_cast<int64_t>(existing.tellg());
+            firstPoint = std::min<int64_t>(
+                (size - static_cast<int64_t>(sizeof(int64_t))) / pointSize,
+                nPoints
+            );
+            LINFO(fmt::format(
+                "Resuming conversion after {} of {} points", firstPoint, nPoints
+            ));
         }
-        else {
-            std::cout << "Failed to convert point data.";
-            return;
+    }
+
+    std::fstream out;
+    if (firstPoint > 0) {
+        out.open(_outFilename, std::ios::binary | std::ios::in | std::ios::out);
+        out.seekp(sizeof(int64_t) + firstPoint * pointSize);
+        for (int64_t i = 0; i < firstPoint; ++i) {
+            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
     }
+    else {
+        out.open(_outFilename, std::ios::binary | std::ios::out | std::ios::trunc);
+        out.write(reinterpret_cast<char*>(&nPoints), sizeof(int64_t));
+    }
+    if (!out.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open file '{}'", _outFilename),
+            "MilkywayPointsConversionTask"
+        );
+    }
 
-    out.write(reinterpret_cast<char*>(&nPoints), sizeof(int64_t));
-    out.write(reinterpret_cast<char*>(pointData.data()), nFloats * sizeof(float));
+    // Reading the lines has to happen in order, but parsing them is split between the
+    // threads. Only a single chunk of points is kept in memory at any time
+    std::vector<std::string> lines;
+    std::vector<float> pointData;
+    for (int64_t chunkStart = firstPoint; chunkStart < nPoints;
+         chunkStart += PointsPerChunk)
+    {
+        const int64_t nChunkPoints = std::min(PointsPerChunk, nPoints - chunkStart);
+        lines.resize(nChunkPoints);
+        for (int64_t i = 0; i < nChunkPoints; ++i) {
+            if (!std::getline(in, lines[i])) {
+                throw ghoul::RuntimeError(
+                    "Failed to convert point data", "MilkywayPointsConversionTask"
+                );
+            }
+        }
+        pointData.resize(nChunkPoints * NValuesPerPoint);
+
+        const size_t nThreads = std::min(_threadsToUse, lines.size());
+        const size_t linesPerThread = (lines.size() + nThreads - 1) / nThreads;
+        std::vector<char> results(nThreads, 0);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < nThreads; ++t) {
+            const size_t first = t * linesPerThread;
+            const size_t last = std::min(first + linesPerThread, lines.size());
+            threads.emplace_back([&lines, &pointData, &results, t, first, last]() {
+                results[t] = parseLines(lines, first, last, pointData.data());
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        if (std::find(results.begin(), results.end(), 0) != results.end()) {
+            throw ghoul::RuntimeError(
+                "Failed to convert point data", "MilkywayPointsConversionTask"
+            );
+        }
 
-    in.close();
-    out.close();
+        out.write(
+            reinterpret_cast<char*>(pointData.data()),
+            pointData.size() * sizeof(float)
+        );
+        // Make sure that the finished points are on disk in case the conversion is
+        // interrupted and resumed later
+        out.flush();
+        progressCallback(static_cast<float>(chunkStart + nChunkPoints) / nPoints);
+    }
 }
 
 documentation::Documentation MilkywayPointsConversionTask::documentation() {
-    return documentation::Documentation();
+    using namespace documentation;
+    return {
+        "MilkywayPointsConversionTask",
+        "galaxy_milkywaypointsconversiontask",
+        {
+            {
+                KeyInFilename,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The path of the ascii point file that is converted."
+            },
+            {
+                KeyOutFilename,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The path of the binary point file that is created."
+            },
+            {
+                KeyThreadsToUse,
+                new IntVerifier,
+                Optional::Yes,
+                "The number of threads that parse the points of a chunk. Default is the "
+                "number of hardware threads."
+            },
+            {
+                KeyResume,
+                new BoolVerifier,
+                Optional::Yes,
+                "If true then the points that an earlier, interrupted, conversion has "
+                "written to the output file are kept and the conversion continues after "
+                "them. Default is false."
+            }
+        }
+    };
 }
 
 } // namespace openspace
@@ -27,7 +27,9 @@
 
 #include <openspace/util/task.h>
 
+#include <algorithm>
 #include <string>
+#include <thread>
 
 namespace openspace {
 
@@ -52,6 +54,8 @@ public:
 private:
     std::string _inFilename;
     std::string _outFilename;
+    size_t _threadsToUse = std::max(1u, std::thread::hardware_concurrency());
+    bool _resume = false;
 };
 
 } // namespace openspace
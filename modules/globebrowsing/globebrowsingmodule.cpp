@@ -24,18 +24,24 @@
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
 
+#include <modules/globebrowsing/src/baketilepyramidtask.h>
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/dashboarditemglobelocation.h>
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/gdalwrapper.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/globetranslation.h>
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
+#include <modules/globebrowsing/src/tilebufferpool.h>
 #include <modules/globebrowsing/src/tileprovider.h>
+#include <modules/globebrowsing/src/tileservice.h>
 #include <openspace/interaction/navigationhandler.h>
 #include <openspace/interaction/orbitalnavigator.h>
 #include <openspace/engine/globalscallbacks.h>
+#include <openspace/engine/windowdelegate.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/templatefactory.h>
@@ -63,6 +69,14 @@ namespace {
     constexpr const char* _loggerCat = "GlobeBrowsingModule";
     constexpr const char* _factoryName = "TileProvider";
 
+    // The maximum number of bytes of unused tile buffers that are kept for reuse
+    constexpr const size_t TileBufferPoolSize = 256ULL * 1024ULL * 1024ULL;
+
+    constexpr const char* KeyTileService = "TileService";
+    constexpr const char* KeyTileServiceAddress = "Address";
+    constexpr const char* KeyTileServicePort = "Port";
+    constexpr const char* KeyTileServiceRole = "Role";
+
     constexpr const openspace::properties::Property::PropertyInfo WMSCacheEnabledInfo = {
         "WMSCacheEnabled",
         "WMS Cache Enabled",
@@ -100,6 +114,28 @@ namespace {
         "The maximum size of the MemoryAwareTileCache, on the CPU and GPU."
     };
 
+    constexpr const openspace::properties::Property::PropertyInfo DiskCacheEnabledInfo = {
+        "DiskTileCacheEnabled",
+        "Disk Tile Cache Enabled",
+        "Determines whether decoded tiles are stored in a persistent cache on disk, "
+        "which is used before reading a tile from its dataset. Changing the value of "
+        "this property will only take effect after a restart."
+    };
+
+    constexpr const openspace::properties::Property::PropertyInfo DiskCachePathInfo = {
+        "DiskTileCacheLocation",
+        "Disk Tile Cache Location",
+        "The location of the folder in which the disk tile cache is stored. Changing the "
+        "value of this property will only take effect after a restart."
+    };
+
+    constexpr const openspace::properties::Property::PropertyInfo DiskCacheSizeInfo = {
+        "DiskTileCacheSize",
+        "Disk Tile Cache Size",
+        "The maximum size (in MB) of the disk tile cache for all datasets combined. "
+        "Changing the value of this property will only take effect after a restart."
+    };
+
 
     openspace::GlobeBrowsingModule::Capabilities
     parseSubDatasets(char** subDatasets, int nSubdatasets)
@@ -162,12 +198,18 @@ GlobeBrowsingModule::GlobeBrowsingModule()
     , _wmsCacheLocation(WMSCacheLocationInfo, "${BASE}/cache_gdal")
     , _wmsCacheSizeMB(WMSCacheSizeInfo, 1024)
     , _tileCacheSizeMB(TileCacheSizeInfo, 1024)
+    , _diskTileCacheEnabled(DiskCacheEnabledInfo, false)
+    , _diskTileCacheLocation(DiskCachePathInfo, "${BASE}/cache_tiles")
+    , _diskTileCacheSizeMB(DiskCacheSizeInfo, 4096)
 {
     addProperty(_wmsCacheEnabled);
     addProperty(_offlineMode);
     addProperty(_wmsCacheLocation);
     addProperty(_wmsCacheSizeMB);
     addProperty(_tileCacheSizeMB);
+    addProperty(_diskTileCacheEnabled);
+    addProperty(_diskTileCacheLocation);
+    addProperty(_diskTileCacheSizeMB);
 }
 
 void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
@@ -192,6 +234,19 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
             dict.value<double>(TileCacheSizeInfo.identifier)
         );
     }
+    if (dict.hasKeyAndValue<bool>(DiskCacheEnabledInfo.identifier)) {
+        _diskTileCacheEnabled = dict.value<bool>(DiskCacheEnabledInfo.identifier);
+    }
+    if (dict.hasKeyAndValue<std::string>(DiskCachePathInfo.identifier)) {
+        _diskTileCacheLocation = dict.value<std::string>(
+            DiskCachePathInfo.identifier
+        );
+    }
+    if (dict.hasKeyAndValue<double>(DiskCacheSizeInfo.identifier)) {
+        _diskTileCacheSizeMB = static_cast<int>(
+            dict.value<double>(DiskCacheSizeInfo.identifier)
+        );
+    }
 
     // Sanity check
     const bool noWarning = dict.hasKeyAndValue<bool>("NoWarning") ?
@@ -209,10 +264,60 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
     }
 
 
+    if (_diskTileCacheEnabled) {
+        _diskTileCache = std::make_unique<globebrowsing::cache::DiskTileCache>(
+            absPath(_diskTileCacheLocation),
+            static_cast<size_t>(_diskTileCacheSizeMB) * 1024ULL * 1024ULL
+        );
+        addPropertySubOwner(*_diskTileCache);
+    }
+
+
+    _tileBufferPool = std::make_unique<globebrowsing::cache::TileBufferPool>(
+        TileBufferPoolSize
+    );
+
+    if (dict.hasKeyAndValue<ghoul::Dictionary>(KeyTileService)) {
+        // Only one node of a cluster reads and decodes the tiles, by default the master,
+        // and all other nodes receive the finished tiles from it
+        const ghoul::Dictionary service = dict.value<ghoul::Dictionary>(KeyTileService);
+        const int port = static_cast<int>(service.value<double>(KeyTileServicePort));
+
+        bool isServer = global::windowDelegate.isMaster();
+        if (service.hasKeyAndValue<std::string>(KeyTileServiceRole)) {
+            const std::string role = service.value<std::string>(KeyTileServiceRole);
+            if (role == "Server") {
+                isServer = true;
+            }
+            else if (role == "Client") {
+                isServer = false;
+            }
+            else {
+                LWARNING(fmt::format("Unknown tile service role '{}'", role));
+            }
+        }
+
+        if (isServer) {
+            _tileServer = std::make_unique<cache::TileServer>(
+                _diskTileCache.get(),
+                _tileBufferPool.get()
+            );
+            _tileServer->start(port);
+        }
+        else {
+            _tileServiceClient = std::make_unique<cache::TileServiceClient>(
+                service.value<std::string>(KeyTileServiceAddress),
+                port,
+                _tileBufferPool.get()
+            );
+        }
+    }
+
     // Initialize
     global::callback::initializeGL.emplace_back([&]() {
         _tileCache = std::make_unique<globebrowsing::cache::MemoryAwareTileCache>(
-            _tileCacheSizeMB
+            _tileCacheSizeMB,
+            _tileBufferPool.get()
         );
         addPropertySubOwner(*_tileCache);
 
@@ -232,10 +337,20 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
 
 
     // Render
-    global::callback::render.emplace_back([&]() { _tileCache->update(); });
+    global::callback::render.emplace_back([&]() {
+        _tileCache->update();
+        if (_diskTileCache) {
+            _diskTileCache->update();
+        }
+    });
 
     // Deinitialize
-    global::callback::deinitialize.emplace_back([&]() { GdalWrapper::destroy(); });
+    global::callback::deinitialize.emplace_back([&]() {
+        if (_tileServer) {
+            _tileServer->stop();
+        }
+        GdalWrapper::destroy();
+    });
 
     auto fRenderable = FactoryManager::ref().factory<Renderable>();
     ghoul_assert(fRenderable, "Renderable factory was not created");
@@ -284,6 +399,11 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
             layergroupid::TypeID::ByIndexTileLayer
         )]
     );
+    fTileProvider->registerClass<tileprovider::BakedTileProvider>(
+        layergroupid::LAYER_TYPE_NAMES[static_cast<int>(
+            layergroupid::TypeID::BakedTileLayer
+        )]
+    );
 
     FactoryManager::ref().addFactory(std::move(fTileProvider), _factoryName);
 
@@ -291,12 +411,32 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
     ghoul_assert(fDashboard, "Dashboard factory was not created");
 
     fDashboard->registerClass<DashboardItemGlobeLocation>("DashboardItemGlobeLocation");
+
+    auto fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "Task factory was not created");
+    fTask->registerClass<globebrowsing::BakeTilePyramidTask>("BakeTilePyramidTask");
 }
 
 globebrowsing::cache::MemoryAwareTileCache* GlobeBrowsingModule::tileCache() {
     return _tileCache.get();
 }
 
+globebrowsing::cache::DiskTileCache* GlobeBrowsingModule::diskTileCache() {
+    return _diskTileCache.get();
+}
+
+globebrowsing::cache::TileServer* GlobeBrowsingModule::tileServer() {
+    return _tileServer.get();
+}
+
+globebrowsing::cache::TileServiceClient* GlobeBrowsingModule::tileServiceClient() {
+    return _tileServiceClient.get();
+}
+
+globebrowsing::cache::TileBufferPool* GlobeBrowsingModule::tileBufferPool() {
+    return _tileBufferPool.get();
+}
+
 scripting::LuaLibrary GlobeBrowsingModule::luaLibrary() const {
     std::string listLayerGroups = layerGroupNamesList();
 
@@ -40,7 +40,13 @@ namespace openspace::globebrowsing {
     struct Geodetic2;
     struct Geodetic3;
 
-    namespace cache { class MemoryAwareTileCache; }
+    namespace cache {
+        class DiskTileCache;
+        class MemoryAwareTileCache;
+        class TileBufferPool;
+        class TileServer;
+        class TileServiceClient;
+    } // namespace cache
 } // namespace openspace::globebrowsing
 
 namespace openspace {
@@ -61,6 +67,28 @@ public:
         double latitude, double longitude, double altitude);
 
     globebrowsing::cache::MemoryAwareTileCache* tileCache();
+
+    /**
+     * \return The persistent disk tile cache or <code>nullptr</code> if the disk tile
+     *         cache is disabled
+     */
+    globebrowsing::cache::DiskTileCache* diskTileCache();
+
+    /**
+     * \return The server that provides the tiles of this node to the other nodes of the
+     *         cluster or <code>nullptr</code> if this node does not serve tiles
+     */
+    globebrowsing::cache::TileServer* tileServer();
+
+    /**
+     * \return The client that receives the tiles from the tile server of the cluster or
+     *         <code>nullptr</code> if this node reads its tiles itself
+     */
+    globebrowsing::cache::TileServiceClient* tileServiceClient();
+
+    /// \return The pool from which the image data buffers of the read tiles are taken
+    globebrowsing::cache::TileBufferPool* tileBufferPool();
+
     scripting::LuaLibrary luaLibrary() const override;
     const globebrowsing::RenderableGlobe* castFocusNodeRenderableToGlobe();
 
@@ -118,8 +146,15 @@ private:
     properties::StringProperty _wmsCacheLocation;
     properties::UIntProperty _wmsCacheSizeMB;
     properties::UIntProperty _tileCacheSizeMB;
+    properties::BoolProperty _diskTileCacheEnabled;
+    properties::StringProperty _diskTileCacheLocation;
+    properties::UIntProperty _diskTileCacheSizeMB;
 
     std::unique_ptr<globebrowsing::cache::MemoryAwareTileCache> _tileCache;
+    std::unique_ptr<globebrowsing::cache::DiskTileCache> _diskTileCache;
+    std::unique_ptr<globebrowsing::cache::TileBufferPool> _tileBufferPool;
+    std::unique_ptr<globebrowsing::cache::TileServer> _tileServer;
+    std::unique_ptr<globebrowsing::cache::TileServiceClient> _tileServiceClient;
 
     // name -> capabilities
     std::map<std::string, std::future<Capabilities>> _inFlightCapabilitiesMap;
@@ -25,9 +25,12 @@
 #include <modules/globebrowsing/src/asynctiledataprovider.h>
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
 #include <modules/globebrowsing/src/rawtiledatareader.h>
+#include <modules/globebrowsing/src/tilebufferpool.h>
 #include <modules/globebrowsing/src/tileloadjob.h>
+#include <modules/globebrowsing/src/tileservice.h>
 #include <openspace/engine/moduleengine.h>
 #include <openspace/engine/globals.h>
 #include <ghoul/logging/logmanager.h>
@@ -46,19 +49,40 @@ AsyncTileDataProvider::AsyncTileDataProvider(std::string name,
     , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(1, 10))
 {
     _globeBrowsingModule = global::moduleEngine.module<GlobeBrowsingModule>();
+    _datasetIdentifier = cache::DiskTileCache::datasetIdentifier(
+        _rawTileDataReader->datasetFilePath(),
+        _rawTileDataReader->tileTextureInitData(),
+        _rawTileDataReader->performsPreprocessing()
+    );
     performReset(ResetRawTileDataReader::No);
+
+    if (cache::TileServer* server = _globeBrowsingModule->tileServer()) {
+        server->addDataset(_datasetIdentifier, *_rawTileDataReader);
+    }
 }
 
-AsyncTileDataProvider::~AsyncTileDataProvider() {} // NOLINT
+AsyncTileDataProvider::~AsyncTileDataProvider() {
+    if (cache::TileServer* server = _globeBrowsingModule->tileServer()) {
+        server->removeDataset(_datasetIdentifier, *_rawTileDataReader);
+    }
+}
 
 const RawTileDataReader& AsyncTileDataProvider::rawTileDataReader() const {
     return *_rawTileDataReader;
 }
 
-bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
-    if (_resetMode == ResetMode::ShouldNotReset && satisfiesEnqueueCriteria(tileIndex)) {
-        auto job = std::make_unique<TileLoadJob>(*_rawTileDataReader, tileIndex);
-        _concurrentJobManager.enqueueJob(std::move(job), tileIndex.hashKey());
+bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex, float priority) {
+    if (_resetMode == ResetMode::ShouldNotReset &&
+        satisfiesEnqueueCriteria(tileIndex, priority))
+    {
+        auto job = std::make_unique<TileLoadJob>(
+            *_rawTileDataReader,
+            tileIndex,
+            _globeBrowsingModule->diskTileCache(),
+            _datasetIdentifier,
+            _globeBrowsingModule->tileServiceClient()
+        );
+        _concurrentJobManager.enqueueJob(std::move(job), tileIndex.hashKey(), priority);
         _enqueuedTileRequests.insert(tileIndex.hashKey());
         return true;
     }
@@ -82,7 +106,10 @@ std::optional<RawTile> AsyncTileDataProvider::popFinishedRawTile() {
         _enqueuedTileRequests.erase(key);
         // Pbo is still mapped. Set the id for the raw tile
         if (product.error != RawTile::ReadError::None) {
-            product.imageData = nullptr;
+            cache::TileBufferPool* pool = _globeBrowsingModule->tileBufferPool();
+            if (pool && product.textureInitData) {
+                pool->release(*product.textureInitData, std::move(product.imageData));
+            }
             return std::nullopt;
         }
 
@@ -93,9 +120,15 @@ std::optional<RawTile> AsyncTileDataProvider::popFinishedRawTile() {
     }
 }
 
-bool AsyncTileDataProvider::satisfiesEnqueueCriteria(const TileIndex& tileIndex) {
-    // Only satisfies if it is not already enqueued. Also bumps the request to the top.
-    const bool alreadyEnqueued = _concurrentJobManager.touch(tileIndex.hashKey());
+bool AsyncTileDataProvider::satisfiesEnqueueCriteria(const TileIndex& tileIndex,
+                                                     float priority)
+{
+    // Only satisfies if it is not already enqueued. Also bumps the request to the top
+    // and updates its priority
+    const bool alreadyEnqueued = _concurrentJobManager.touch(
+        tileIndex.hashKey(),
+        priority
+    );
     // Early out so we don't need to check the already enqueued requests
     if (alreadyEnqueued) {
         return false;
@@ -128,6 +161,9 @@ void AsyncTileDataProvider::endEnqueuedJobs() {
 }
 
 void AsyncTileDataProvider::update() {
+    // Tiles that were not requested since the last update have left the view, so there
+    // is no point in spending worker time on them
+    _concurrentJobManager.cancelStaleJobs();
     endUnfinishedJobs();
 
     // May reset
@@ -191,7 +227,15 @@ void AsyncTileDataProvider::performReset(ResetRawTileDataReader resetRawTileData
 
     // Reset raw tile data reader
     if (resetRawTileDataReader == ResetRawTileDataReader::Yes) {
+        // The tile server must not read from the dataset while it is reopened
+        cache::TileServer* server = _globeBrowsingModule->tileServer();
+        if (server) {
+            server->removeDataset(_datasetIdentifier, *_rawTileDataReader);
+        }
         _rawTileDataReader->reset();
+        if (server) {
+            server->addDataset(_datasetIdentifier, *_rawTileDataReader);
+        }
     }
 
     // Finished resetting
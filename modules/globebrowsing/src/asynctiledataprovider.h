@@ -55,9 +55,12 @@ public:
     ~AsyncTileDataProvider();
 
     /**
-     * Creates a job which asynchronously loads a raw tile. This job is enqueued.
+     * Creates a job which asynchronously loads a raw tile. This job is enqueued. If the
+     * job is already enqueued, its \p priority is updated instead. Jobs with higher
+     * priority are loaded first and jobs that were not requested in the previous frame
+     * are cancelled in the next call to #update.
      */
-    bool enqueueTileIO(const TileIndex& tileIndex);
+    bool enqueueTileIO(const TileIndex& tileIndex, float priority = 0.f);
 
     /**
      * Get one finished job.
@@ -86,7 +89,7 @@ protected:
     /**
      * \returns true if tile of index <code>tileIndex</code> is not already enqueued.
      */
-    bool satisfiesEnqueueCriteria(const TileIndex& tileIndex);
+    bool satisfiesEnqueueCriteria(const TileIndex& tileIndex, float priority);
 
     /**
      * An unfinished job is a load tile job that has been popped from the thread pool due
@@ -110,6 +113,9 @@ private:
     PrioritizingConcurrentJobManager<RawTile, TileIndex::TileHashKey>
         _concurrentJobManager;
 
+    /// Stable identifier of the dataset used as the key into the disk tile cache
+    unsigned int _datasetIdentifier = 0;
+
     std::set<TileIndex::TileHashKey> _enqueuedTileRequests;
 
     ResetMode _resetMode = ResetMode::ShouldResetAllButRawTileDataReader;
@@ -0,0 +1,307 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/baketilepyramidtask.h>
+
+#include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/src/rawtiledatareader.h>
+#include <modules/globebrowsing/src/tilebufferpool.h>
+#include <modules/globebrowsing/src/tilepyramid.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr const char* _loggerCat = "BakeTilePyramidTask";
+
+    constexpr const char* KeyFilePath = "FilePath";
+    constexpr const char* KeyOutputDirectory = "OutputDirectory";
+    constexpr const char* KeyLayerGroupID = "LayerGroupID";
+    constexpr const char* KeyMaxLevel = "MaxLevel";
+    constexpr const char* KeyTilePixelSize = "TilePixelSize";
+    constexpr const char* KeyPadTiles = "PadTiles";
+    constexpr const char* KeyPerformPreProcessing = "PerformPreProcessing";
+
+    // The root level of the chunk tree consists of the two hemispheres
+    constexpr const int MinLevel = 1;
+} // namespace
+
+namespace openspace::globebrowsing {
+
+BakeTilePyramidTask::BakeTilePyramidTask(const ghoul::Dictionary& dictionary) {
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "BakeTilePyramidTask"
+    );
+
+    _filePath = dictionary.value<std::string>(KeyFilePath);
+    if (FileSys.fileExists(absPath(_filePath))) {
+        // Otherwise this is a GDAL configuration string or a URL
+        _filePath = absPath(_filePath);
+    }
+    _outputDirectory = absPath(dictionary.value<std::string>(KeyOutputDirectory));
+    _layerGroupID = ghoul::from_string<layergroupid::GroupID>(
+        dictionary.value<std::string>(KeyLayerGroupID)
+    );
+    _maxLevel = static_cast<int>(dictionary.value<double>(KeyMaxLevel));
+
+    if (dictionary.hasKeyAndValue<double>(KeyTilePixelSize)) {
+        _tilePixelSize = static_cast<int>(dictionary.value<double>(KeyTilePixelSize));
+    }
+    if (dictionary.hasKeyAndValue<bool>(KeyPadTiles)) {
+        _padTiles = dictionary.value<bool>(KeyPadTiles);
+    }
+
+    // Same as for the DefaultTileProvider, only height layers are preprocessed by default
+    _performPreProcessing = _layerGroupID == layergroupid::GroupID::HeightLayers;
+    if (dictionary.hasKeyAndValue<bool>(KeyPerformPreProcessing)) {
+        _performPreProcessing = dictionary.value<bool>(KeyPerformPreProcessing);
+    }
+}
+
+std::string BakeTilePyramidTask::description() {
+    return fmt::format(
+        "Bake the tiles of {} for the layer group {} up to level {} into a tile pyramid "
+        "in {}",
+        _filePath, layergroupid::LAYER_GROUP_IDENTIFIERS[_layerGroupID], _maxLevel,
+        _outputDirectory
+    );
+}
+
+void BakeTilePyramidTask::perform(const Task::ProgressCallback& progressCallback) {
+    const TileTextureInitData initData = tileTextureInitData(
+        _layerGroupID,
+        _padTiles,
+        static_cast<size_t>(_tilePixelSize)
+    );
+    const RawTileDataReader reader(
+        _filePath,
+        initData,
+        RawTileDataReader::PerformPreprocessing(_performPreProcessing)
+    );
+
+    const int maxLevel = std::min(_maxLevel, reader.maxChunkLevel());
+    if (maxLevel < _maxLevel) {
+        LINFO(fmt::format(
+            "The dataset only provides data up to level {}, skipping the levels above",
+            maxLevel
+        ));
+    }
+
+    if (!FileSys.directoryExists(_outputDirectory)) {
+        FileSys.createDirectory(
+            _outputDirectory,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+    }
+
+    TilePyramidHeader header;
+    header.maxLevel = maxLevel;
+    header.layerGroupID = static_cast<int32_t>(_layerGroupID);
+    header.tilePixelSize = static_cast<int32_t>(initData.dimensions.x);
+    header.padTiles = _padTiles ? 1 : 0;
+    header.nMetaDataValues = _performPreProcessing ?
+        static_cast<int32_t>(initData.nRasters) :
+        0;
+    header.initDataHashKey = initData.hashKey;
+    header.nBytesPerTile = initData.totalNumBytes;
+    header.depthTransform = reader.depthTransform();
+    header.noDataValue = reader.noDataValueAsFloat();
+
+    size_t nTotalTiles = 0;
+    for (int level = MinLevel; level <= maxLevel; ++level) {
+        const glm::ivec2 n = tilepyramid::numTiles(level);
+        nTotalTiles += static_cast<size_t>(n.x) * n.y;
+    }
+
+    cache::TileBufferPool* pool =
+        global::moduleEngine.module<GlobeBrowsingModule>()->tileBufferPool();
+
+    // The tiles are read in batches by multiple threads, but have to be written in order
+    const size_t batchSize = std::max(std::thread::hardware_concurrency(), 1u);
+
+    size_t nProcessedTiles = 0;
+    for (int level = MinLevel; level <= maxLevel; ++level) {
+        header.level = level;
+        const glm::ivec2 nTiles = tilepyramid::numTiles(level);
+        const size_t nLevelTiles = static_cast<size_t>(nTiles.x) * nTiles.y;
+
+        const std::string path = tilepyramid::levelFilePath(_outputDirectory, level);
+        const std::string tmpPath = path + ".tmp";
+        std::ofstream file(tmpPath, std::ofstream::binary);
+        if (!file.good()) {
+            throw ghoul::RuntimeError(fmt::format("Could not create '{}'", tmpPath));
+        }
+
+        // The offsets are written once all tiles of the level have been written
+        std::vector<uint64_t> tileOffsets(nLevelTiles, 0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(TilePyramidHeader));
+        file.write(
+            reinterpret_cast<const char*>(tileOffsets.data()),
+            nLevelTiles * sizeof(uint64_t)
+        );
+        uint64_t offset = sizeof(TilePyramidHeader) + nLevelTiles * sizeof(uint64_t);
+
+        size_t nStoredTiles = 0;
+        for (size_t begin = 0; begin < nLevelTiles; begin += batchSize) {
+            const size_t end = std::min(begin + batchSize, nLevelTiles);
+
+            std::vector<std::future<RawTile>> reads;
+            for (size_t i = begin; i < end; ++i) {
+                const TileIndex tileIndex(
+                    static_cast<int>(i % nTiles.x),
+                    static_cast<int>(i / nTiles.x),
+                    level
+                );
+                reads.push_back(std::async(
+                    std::launch::async,
+                    [&reader, tileIndex]() { return reader.readTileData(tileIndex); }
+                ));
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                RawTile rawTile = reads[i - begin].get();
+                if (rawTile.error == RawTile::ReadError::None) {
+                    tilepyramid::writeTileRecord(file, header, rawTile);
+                    tileOffsets[i] = offset;
+                    offset += tilepyramid::tileRecordSize(header);
+                    ++nStoredTiles;
+                }
+                if (pool && rawTile.imageData) {
+                    pool->release(initData, std::move(rawTile.imageData));
+                }
+            }
+
+            nProcessedTiles += end - begin;
+            progressCallback(
+                static_cast<float>(nProcessedTiles) / static_cast<float>(nTotalTiles)
+            );
+        }
+
+        file.seekp(sizeof(TilePyramidHeader));
+        file.write(
+            reinterpret_cast<const char*>(tileOffsets.data()),
+            nLevelTiles * sizeof(uint64_t)
+        );
+        file.close();
+        if (!file) {
+            throw ghoul::RuntimeError(fmt::format("Error writing '{}'", tmpPath));
+        }
+
+        // A level file only appears under its final name once it is complete
+        std::remove(path.c_str());
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            throw ghoul::RuntimeError(fmt::format("Could not create '{}'", path));
+        }
+
+        LINFO(fmt::format(
+            "Level {}: stored {} of {} tiles", level, nStoredTiles, nLevelTiles
+        ));
+    }
+
+    progressCallback(1.f);
+}
+
+documentation::Documentation BakeTilePyramidTask::documentation() {
+    using namespace documentation;
+
+    std::vector<std::string> layerGroups;
+    for (const char* id : layergroupid::LAYER_GROUP_IDENTIFIERS) {
+        layerGroups.push_back(id);
+    }
+
+    return {
+        "BakeTilePyramidTask",
+        "globebrowsing_bake_tile_pyramid_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("BakeTilePyramidTask"),
+                Optional::No,
+                "The type of this task",
+            },
+            {
+                KeyFilePath,
+                new StringVerifier,
+                Optional::No,
+                "The GDAL dataset that is baked. This can be any dataset that can be "
+                "used as the FilePath of a DefaultTileLayer",
+            },
+            {
+                KeyOutputDirectory,
+                new StringAnnotationVerifier("A valid directory path"),
+                Optional::No,
+                "The directory into which the level files of the pyramid are written. "
+                "This directory is used as the FilePath of a BakedTileLayer",
+            },
+            {
+                KeyLayerGroupID,
+                new StringInListVerifier(layerGroups),
+                Optional::No,
+                "The layer group in which the baked layer will be used, which determines "
+                "the format of the tiles",
+            },
+            {
+                KeyMaxLevel,
+                new IntVerifier,
+                Optional::No,
+                "The highest level of the pyramid that is baked. Each level contains "
+                "four times as many tiles as the level before",
+            },
+            {
+                KeyTilePixelSize,
+                new IntVerifier,
+                Optional::Yes,
+                "The size of each tile in pixels. The default depends on the layer group",
+            },
+            {
+                KeyPadTiles,
+                new BoolVerifier,
+                Optional::Yes,
+                "Determines whether the tiles are padded. Defaults to 'true'",
+            },
+            {
+                KeyPerformPreProcessing,
+                new BoolVerifier,
+                Optional::Yes,
+                "Determines whether the tile meta data is calculated. The default is to "
+                "only calculate it for height layers",
+            }
+        }
+    };
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,60 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___BAKETILEPYRAMIDTASK___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___BAKETILEPYRAMIDTASK___H__
+
+#include <openspace/util/task.h>
+
+#include <modules/globebrowsing/src/layergroupid.h>
+#include <string>
+
+namespace openspace::globebrowsing {
+
+/**
+ * Reads all tiles of a GDAL dataset up to a maximum level and stores them as a baked
+ * tile pyramid (see TilePyramidHeader) that can be used with a BakedTileLayer. The tiles
+ * are stored exactly as the RawTileDataReader would provide them at runtime for the
+ * given layer group, including the padding and the tile meta data.
+ */
+class BakeTilePyramidTask : public Task {
+public:
+    BakeTilePyramidTask(const ghoul::Dictionary& dictionary);
+    std::string description() override;
+    void perform(const Task::ProgressCallback& progressCallback) override;
+    static documentation::Documentation documentation();
+
+private:
+    std::string _filePath;
+    std::string _outputDirectory;
+    layergroupid::GroupID _layerGroupID = layergroupid::GroupID::ColorLayers;
+    int _maxLevel = 0;
+    int _tilePixelSize = 0;
+    bool _padTiles = true;
+    bool _performPreProcessing = false;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___BAKETILEPYRAMIDTASK___H__
@@ -31,6 +31,8 @@
 #include <openspace/engine/globals.h>
 #include <openspace/interaction/navigationhandler.h>
 #include <openspace/interaction/orbitalnavigator.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/util/distanceconversion.h>
 #include <openspace/util/updatestructures.h>
@@ -181,7 +183,7 @@ void DashboardItemGlobeLocation::render(glm::vec2& penPosition) {
     penPosition.y -= _font->height();
     std::string d = std::to_string(_significantDigits);
     std::string f = "Position: {:03." + d + "f}{}, {:03." + d + "f}{}  Altitude: {} {}";
-    RenderFont(
+    global::renderEngine.textBatcher().queue(
         *_font,
         penPosition,
         fmt::format(f,
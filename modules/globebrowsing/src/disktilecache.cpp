@@ -0,0 +1,344 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/disktilecache.h>
+
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <ghoul/filesystem/directory.h>
+#include <ghoul/filesystem/file.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+    constexpr const char* _loggerCat = "DiskTileCache";
+
+    constexpr const int8_t CurrentCacheVersion = 1;
+    constexpr const char* TileFileExtension = ".tile";
+
+    constexpr openspace::properties::Property::PropertyInfo DiskAllocatedDataInfo = {
+        "DiskAllocatedTileData",
+        "Disk allocated tile data (MB)",
+        "This value denotes the amount of disk space (in MB) that this tile cache is "
+        "utilizing."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ClearDiskTileCacheInfo = {
+        "ClearDiskTileCache",
+        "Clear disk tile cache",
+        "Removes all tiles that are stored in the disk tile cache."
+    };
+
+    // 32 bit FNV-1a. We can't use std::hash here as the result has to be stable across
+    // different runs of the application
+    uint32_t fnv1a(const void* data, size_t size, uint32_t hash = 2166136261u) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+DiskTileCache::DiskTileCache(std::string location, size_t maximumSize)
+    : PropertyOwner({ "DiskTileCache" })
+    , _location(std::move(location))
+    , _maximumSize(maximumSize)
+    , _tileFiles(std::numeric_limits<size_t>::max())
+    , _diskAllocatedTileData(DiskAllocatedDataInfo, 0, 0, 1024 * 1024, 1)
+    , _clearDiskTileCache(ClearDiskTileCacheInfo)
+{
+    _diskAllocatedTileData.setReadOnly(true);
+    addProperty(_diskAllocatedTileData);
+
+    _clearDiskTileCache.onChange([&]() { clear(); });
+    addProperty(_clearDiskTileCache);
+
+    if (!FileSys.directoryExists(_location)) {
+        FileSys.createDirectory(
+            _location,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+    }
+    buildIndex();
+}
+
+unsigned int DiskTileCache::datasetIdentifier(const std::string& datasetPath,
+                                              const TileTextureInitData& initData,
+                                              bool performPreprocessing)
+{
+    uint32_t hash = fnv1a(datasetPath.data(), datasetPath.size());
+    hash = fnv1a(&initData.hashKey, sizeof(TileTextureInitData::HashKey), hash);
+    const uint8_t flags = (initData.padTiles ? 1 : 0) | (performPreprocessing ? 2 : 0);
+    hash = fnv1a(&flags, sizeof(uint8_t), hash);
+    return hash;
+}
+
+std::string DiskTileCache::tileFilePath(const ProviderTileKey& key) const {
+    return fmt::format(
+        "{}/{:08x}_{}_{}_{}{}",
+        _location, key.providerID, key.tileIndex.level, key.tileIndex.x,
+        key.tileIndex.y, TileFileExtension
+    );
+}
+
+void DiskTileCache::buildIndex() {
+    // The LRU order of the previous run is lost, but as all tiles that are found are
+    // equally old, the directory order is as good as any other
+    ghoul::filesystem::Directory directory(_location);
+    std::vector<std::string> files = directory.readFiles();
+    for (const std::string& file : files) {
+        const std::string filename = ghoul::filesystem::File(file).filename();
+        const std::string ext = TileFileExtension;
+        const bool isTileFile = filename.size() > ext.size() &&
+            filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0;
+        if (!isTileFile) {
+            // Either some other file or an interrupted write
+            continue;
+        }
+
+        unsigned int providerID = 0;
+        int level = 0;
+        int x = 0;
+        int y = 0;
+        const int nRead = sscanf(
+            filename.c_str(),
+            "%08x_%i_%i_%i.tile",
+            &providerID, &level, &x, &y
+        );
+        if (nRead != 4) {
+            continue;
+        }
+
+        std::ifstream f(file, std::ifstream::binary | std::ifstream::ate);
+        const size_t size = static_cast<size_t>(f.tellg());
+
+        _tileFiles.put({ TileIndex(x, y, level), providerID }, size);
+        _numBytesOnDisk += size;
+    }
+
+    evict(0);
+    LINFO(fmt::format(
+        "Found {} cached tiles ({} MB) in '{}'",
+        _tileFiles.size(), _numBytesOnDisk / (1024 * 1024), _location
+    ));
+}
+
+void DiskTileCache::evict(size_t requiredBytes) {
+    // This function has to be called with the _mutex locked
+    while (!_tileFiles.isEmpty() && _numBytesOnDisk + requiredBytes > _maximumSize) {
+        std::pair<ProviderTileKey, size_t> item = _tileFiles.popLRU();
+        _numBytesOnDisk -= item.second;
+        std::remove(tileFilePath(item.first).c_str());
+    }
+}
+
+std::optional<RawTile> DiskTileCache::get(const ProviderTileKey& key,
+                                          const TileTextureInitData& initData)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_tileFiles.touch(key)) {
+            return std::nullopt;
+        }
+    }
+
+    const std::string path = tileFilePath(key);
+    std::ifstream file(path, std::ifstream::binary);
+
+    auto invalidate = [&](const std::string& reason) -> std::optional<RawTile> {
+        LDEBUG(fmt::format("Removing cached tile '{}': {}", path, reason));
+        file.close();
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_tileFiles.exist(key)) {
+            _numBytesOnDisk -= _tileFiles.get(key);
+            // Pop the entry that we just bumped to the front with 'get'
+            _tileFiles.popMRU();
+        }
+        std::remove(path.c_str());
+        return std::nullopt;
+    };
+
+    if (!file.good()) {
+        return invalidate("File could not be opened");
+    }
+
+    int8_t version = 0;
+    file.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (version != CurrentCacheVersion) {
+        return invalidate("The format of the cached file has changed");
+    }
+
+    TileTextureInitData::HashKey hashKey = 0;
+    file.read(reinterpret_cast<char*>(&hashKey), sizeof(TileTextureInitData::HashKey));
+    if (hashKey != initData.hashKey) {
+        return invalidate("Tile layout does not match");
+    }
+
+    RawTile rawTile;
+
+    int32_t nValues = 0;
+    file.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
+    if (nValues < 0 || nValues > 4) {
+        return invalidate("Invalid meta data");
+    }
+    if (nValues > 0) {
+        TileMetaData& meta = rawTile.tileMetaData;
+        meta.maxValues.resize(nValues);
+        meta.minValues.resize(nValues);
+        const size_t nValueBytes = nValues * sizeof(float);
+        file.read(reinterpret_cast<char*>(meta.maxValues.data()), nValueBytes);
+        file.read(reinterpret_cast<char*>(meta.minValues.data()), nValueBytes);
+        std::vector<uint8_t> hasMissingData(nValues);
+        file.read(reinterpret_cast<char*>(hasMissingData.data()), nValues);
+        meta.hasMissingData = std::vector<bool>(
+            hasMissingData.begin(),
+            hasMissingData.end()
+        );
+    }
+
+    uint64_t nBytes = 0;
+    file.read(reinterpret_cast<char*>(&nBytes), sizeof(uint64_t));
+    if (nBytes != initData.totalNumBytes) {
+        return invalidate("Pixel data size is incorrect");
+    }
+
+    rawTile.imageData = std::unique_ptr<std::byte[]>(new std::byte[nBytes]);
+    file.read(reinterpret_cast<char*>(rawTile.imageData.get()), nBytes);
+    if (!file.good()) {
+        return invalidate("File is truncated");
+    }
+
+    rawTile.textureInitData = initData;
+    rawTile.tileIndex = key.tileIndex;
+    rawTile.error = RawTile::ReadError::None;
+    return rawTile;
+}
+
+void DiskTileCache::put(const ProviderTileKey& key, const RawTile& rawTile) {
+    if (rawTile.error != RawTile::ReadError::None || !rawTile.imageData ||
+        !rawTile.textureInitData)
+    {
+        return;
+    }
+
+    const TileTextureInitData& initData = *rawTile.textureInitData;
+    const TileMetaData& meta = rawTile.tileMetaData;
+    const int32_t nValues = static_cast<int32_t>(meta.maxValues.size());
+    const uint64_t nBytes = initData.totalNumBytes;
+
+    const size_t fileSize = sizeof(int8_t) + sizeof(TileTextureInitData::HashKey) +
+        sizeof(int32_t) + nValues * (2 * sizeof(float) + sizeof(uint8_t)) +
+        sizeof(uint64_t) + nBytes;
+    if (fileSize > _maximumSize) {
+        return;
+    }
+
+    // Write to a temporary file first so that concurrent readers or a crash can never
+    // observe a partially written tile
+    const std::string path = tileFilePath(key);
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ofstream::binary);
+        if (!file.good()) {
+            LERROR(fmt::format("Error opening file '{}' for writing tile", tmpPath));
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+        file.write(
+            reinterpret_cast<const char*>(&initData.hashKey),
+            sizeof(TileTextureInitData::HashKey)
+        );
+        file.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
+        if (nValues > 0) {
+            file.write(
+                reinterpret_cast<const char*>(meta.maxValues.data()),
+                nValues * sizeof(float)
+            );
+            file.write(
+                reinterpret_cast<const char*>(meta.minValues.data()),
+                nValues * sizeof(float)
+            );
+            std::vector<uint8_t> hasMissingData(
+                meta.hasMissingData.begin(),
+                meta.hasMissingData.end()
+            );
+            hasMissingData.resize(nValues, 0);
+            file.write(reinterpret_cast<const char*>(hasMissingData.data()), nValues);
+        }
+        file.write(reinterpret_cast<const char*>(&nBytes), sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(rawTile.imageData.get()), nBytes);
+
+        if (!file.good()) {
+            LERROR(fmt::format("Error writing tile to file '{}'", tmpPath));
+            file.close();
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_tileFiles.exist(key)) {
+        _numBytesOnDisk -= _tileFiles.get(key);
+    }
+    evict(fileSize);
+
+    // The rename does not replace existing files on all platforms
+    std::remove(path.c_str());
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return;
+    }
+    _tileFiles.put(key, fileSize);
+    _numBytesOnDisk += fileSize;
+}
+
+void DiskTileCache::clear() {
+    LINFO("Clearing disk tile cache");
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (!_tileFiles.isEmpty()) {
+        std::pair<ProviderTileKey, size_t> item = _tileFiles.popLRU();
+        std::remove(tileFilePath(item.first).c_str());
+    }
+    _numBytesOnDisk = 0;
+    LINFO("Disk tile cache cleared");
+}
+
+void DiskTileCache::update() {
+    constexpr const size_t ByteToMegaByte = 1024 * 1024;
+    _diskAllocatedTileData = static_cast<int>(diskAllocatedDataSize() / ByteToMegaByte);
+}
+
+size_t DiskTileCache::diskAllocatedDataSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _numBytesOnDisk;
+}
+
+} // namespace openspace::globebrowsing::cache
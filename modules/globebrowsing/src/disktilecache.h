@@ -0,0 +1,112 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+
+#include <modules/globebrowsing/src/lrucache.h>
+#include <modules/globebrowsing/src/memoryawaretilecache.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/properties/triggerproperty.h>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace openspace::globebrowsing {
+    struct RawTile;
+    class TileTextureInitData;
+} // namespace openspace::globebrowsing
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * A persistent cache tier that sits below the MemoryAwareTileCache. Decoded
+ * <code>RawTile</code>s are written to disk after they have been read by a
+ * RawTileDataReader, and are read back instead of going through GDAL the next time the
+ * same tile is requested, even across restarts. Each tile is stored in its own file in
+ * which the tile meta data is followed by the raw pixel payload so that the payload can
+ * be read into the tile buffer with a single read. The total size of the cache is
+ * limited to a byte budget and the least-recently-used tiles are evicted first.
+ *
+ * The <code>providerID</code> of the ProviderTileKey used with this cache must be stable
+ * across runs; see #datasetIdentifier. All methods are safe to call from the tile loading
+ * worker threads.
+ */
+class DiskTileCache : public properties::PropertyOwner {
+public:
+    /**
+     * \param location is the directory in which the cached tiles are stored
+     * \param maximumSize is the maximum number of bytes that the cache will use on disk
+     */
+    DiskTileCache(std::string location, size_t maximumSize);
+
+    /**
+     * Creates a stable identifier for a dataset that can be used as the
+     * <code>providerID</code> of a ProviderTileKey. The identifier only depends on the
+     * dataset path and the layout of the decoded tile data.
+     */
+    static unsigned int datasetIdentifier(const std::string& datasetPath,
+        const TileTextureInitData& initData, bool performPreprocessing);
+
+    /**
+     * Returns the cached tile for the \p key if it exists and its layout matches the
+     * \p initData. The returned tile is bumped to the front of the LRU queue.
+     */
+    std::optional<RawTile> get(const ProviderTileKey& key,
+        const TileTextureInitData& initData);
+
+    /**
+     * Writes the \p rawTile to disk, evicting least-recently-used tiles if the byte
+     * budget would be exceeded. Tiles with a read error are not stored.
+     */
+    void put(const ProviderTileKey& key, const RawTile& rawTile);
+
+    void clear();
+    void update();
+
+    size_t diskAllocatedDataSize() const;
+
+private:
+    std::string tileFilePath(const ProviderTileKey& key) const;
+    void buildIndex();
+    void evict(size_t requiredBytes);
+
+    using TileFileCache = LRUCache<ProviderTileKey, size_t, ProviderTileHasher>;
+
+    const std::string _location;
+    const size_t _maximumSize;
+
+    /// Stores the size of each tile file in bytes
+    TileFileCache _tileFiles;
+    size_t _numBytesOnDisk = 0;
+    mutable std::mutex _mutex;
+
+    properties::IntProperty _diskAllocatedTileData;
+    properties::TriggerProperty _clearDiskTileCache;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
@@ -40,6 +40,10 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/opengl/programobject.h>
+#include <glm/gtc/matrix_access.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <locale>
@@ -61,6 +65,11 @@ namespace {
 
     constexpr int8_t CurrentCacheVersion = 1;
 
+    // Size of the latitude/longitude cells, in degrees, that the labels are sorted into
+    constexpr const float LabelCellSize = 10.f;
+    constexpr const int NumLabelCellsLatitude = static_cast<int>(180.f / LabelCellSize);
+    constexpr const int NumLabelCellsLongitude = static_cast<int>(360.f / LabelCellSize);
+
     constexpr openspace::properties::Property::PropertyInfo LabelsInfo = {
         "Labels",
         "Labels Enabled",
@@ -152,11 +161,41 @@ namespace {
         "Labels culling distance from globe's center"
     };
 
+    constexpr openspace::properties::Property::PropertyInfo LabelsMinFeatureAngleInfo = {
+        "LabelsMinFeatureAngle",
+        "Labels Minimum Feature Angle",
+        "Features whose diameter covers a smaller angle (in degrees) than this value, as "
+        "seen from the camera, are not labeled. The larger features of a region are "
+        "considered first. A value of 0 labels all features regardless of their size."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo LabelAlignmentOptionInfo = {
         "LabelAlignmentOption",
         "Label Alignment Option",
         "Labels are aligned horizontally or circularly related to the planet."
     };
+
+    // Returns the normalized left, right, bottom, top, and near planes (normal in xyz
+    // and distance in w) of the frustum described by the \p viewProjection matrix. The
+    // far plane is not tested because the atmosphere has no depth
+    std::array<glm::dvec4, 5> frustumPlanes(const glm::dmat4& viewProjection) {
+        const glm::dvec4 col1 = glm::row(viewProjection, 0);
+        const glm::dvec4 col2 = glm::row(viewProjection, 1);
+        const glm::dvec4 col3 = glm::row(viewProjection, 2);
+        const glm::dvec4 col4 = glm::row(viewProjection, 3);
+
+        std::array<glm::dvec4, 5> planes = {
+            col4 + col1, // left
+            col4 - col1, // right
+            col4 + col2, // bottom
+            col4 - col2, // top
+            col4 + col3  // near
+        };
+        for (glm::dvec4& plane : planes) {
+            plane /= glm::length(glm::dvec3(plane));
+        }
+        return planes;
+    }
 } // namespace
 
 namespace openspace {
@@ -251,6 +290,12 @@ documentation::Documentation GlobeLabelsComponent::Documentation() {
                 Optional::Yes,
                 LabelsDistanceEPSInfo.description
             },
+            {
+                LabelsMinFeatureAngleInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                LabelsMinFeatureAngleInfo.description
+            },
             {
                 LabelAlignmentOptionInfo.identifier,
                 new StringVerifier,
@@ -281,6 +326,7 @@ GlobeLabelsComponent::GlobeLabelsComponent()
     , _labelsFadeOutEnabled(LabelsFadeOutEnabledInfo, false)
     , _labelsDisableCullingEnabled(LabelsDisableCullingEnabledInfo, false)
     , _labelsDistaneEPS(LabelsDistanceEPSInfo, 100000.f, 1000.f, 10000000.f)
+    , _labelsMinFeatureAngle(LabelsMinFeatureAngleInfo, 0.f, 0.f, 10.f)
     , _labelAlignmentOption(
         LabelAlignmentOptionInfo,
         properties::OptionProperty::DisplayType::Dropdown
@@ -299,6 +345,7 @@ GlobeLabelsComponent::GlobeLabelsComponent()
     addProperty(_labelsFadeOutEnabled);
     addProperty(_labelsDisableCullingEnabled);
     addProperty(_labelsDistaneEPS);
+    addProperty(_labelsMinFeatureAngle);
 
     _labelAlignmentOption.addOption(Horizontally, "Horizontally");
     _labelAlignmentOption.addOption(Circularly, "Circularly");
@@ -406,6 +453,12 @@ void GlobeLabelsComponent::initialize(const ghoul::Dictionary& dictionary,
         );
     }
 
+    if (dictionary.hasKey(LabelsMinFeatureAngleInfo.identifier)) {
+        _labelsMinFeatureAngle = static_cast<float>(
+            dictionary.value<double>(LabelsMinFeatureAngleInfo.identifier)
+        );
+    }
+
     if (dictionary.hasKey(LabelAlignmentOptionInfo.identifier)) {
         std::string alignment =
             dictionary.value<std::string>(LabelAlignmentOptionInfo.identifier);
@@ -445,6 +498,7 @@ bool GlobeLabelsComponent::loadLabelsData(const std::string& file) {
 
         const bool hasCache = loadCachedFile(cachedFile);
         if (hasCache) {
+            buildLabelCells();
             return true;
         }
         else {
@@ -461,10 +515,71 @@ bool GlobeLabelsComponent::loadLabelsData(const std::string& file) {
     bool success = readLabelsFile(file);
     if (success) {
         saveCachedFile(cachedFile);
+        buildLabelCells();
     }
     return success;
 }
 
+void GlobeLabelsComponent::buildLabelCells() {
+    auto cellIndex = [](const LabelEntry& entry) {
+        const float lat = glm::clamp(entry.latitude, -90.f, 90.f) + 90.f;
+        float lon = std::fmod(entry.longitude, 360.f);
+        if (lon < 0.f) {
+            lon += 360.f;
+        }
+        const int latIndex = std::min(
+            static_cast<int>(lat / LabelCellSize),
+            NumLabelCellsLatitude - 1
+        );
+        const int lonIndex = std::min(
+            static_cast<int>(lon / LabelCellSize),
+            NumLabelCellsLongitude - 1
+        );
+        return latIndex * NumLabelCellsLongitude + lonIndex;
+    };
+
+    // The labels of a cell are stored consecutively and ordered by decreasing size, so
+    // that the rendering can stop at the first feature in a cell that is too small
+    std::vector<LabelEntry>& labels = _labels.labelsArray;
+    std::stable_sort(
+        labels.begin(),
+        labels.end(),
+        [&cellIndex](const LabelEntry& lhs, const LabelEntry& rhs) {
+            const int lhsCell = cellIndex(lhs);
+            const int rhsCell = cellIndex(rhs);
+            return lhsCell != rhsCell ? lhsCell < rhsCell : lhs.diameter > rhs.diameter;
+        }
+    );
+
+    _labelCells.clear();
+    size_t first = 0;
+    while (first < labels.size()) {
+        const int index = cellIndex(labels[first]);
+        size_t last = first;
+        glm::dvec3 center = glm::dvec3(0.0);
+        while (last < labels.size() && cellIndex(labels[last]) == index) {
+            center += glm::dvec3(labels[last].geoPosition);
+            last++;
+        }
+
+        LabelCell cell;
+        cell.center = center / static_cast<double>(last - first);
+        cell.radius = 0.0;
+        for (size_t i = first; i < last; ++i) {
+            cell.radius = std::max(
+                cell.radius,
+                glm::distance(cell.center, glm::dvec3(labels[i].geoPosition))
+            );
+        }
+        cell.maxDiameter = labels[first].diameter;
+        cell.first = first;
+        cell.count = last - first;
+        _labelCells.push_back(cell);
+
+        first = last;
+    }
+}
+
 bool GlobeLabelsComponent::readLabelsFile(const std::string& file) {
     try {
         std::fstream csvLabelFile(file);
@@ -709,145 +824,140 @@ void GlobeLabelsComponent::renderLabels(const RenderData& data,
     }
     glm::dvec3 orthoUp = glm::normalize(glm::cross(orthoRight, cameraViewDirectionObj));
 
-    for (const LabelEntry& lEntry : _labels.labelsArray) {
+    // Everything except the orientation is the same for all labels, so the label
+    // information and the frustum planes are only computed once per frame
+    ghoul::fontrendering::FontRenderer::ProjectedLabelsInformation labelInfo;
+    labelInfo.orthoRight = orthoRight;
+    labelInfo.orthoUp = orthoUp;
+    labelInfo.minSize = _labelsMinSize;
+    labelInfo.maxSize = _labelsMaxSize;
+    labelInfo.cameraPos = data.camera.positionVec3();
+    labelInfo.cameraLookUp = data.camera.lookUpVectorWorldSpace();
+    labelInfo.renderType = 0;
+    labelInfo.mvpMatrix = modelViewProjectionMatrix;
+    labelInfo.scale = powf(2.f, _labelsSize);
+    labelInfo.enableDepth = true;
+    labelInfo.enableFalseDepth = true;
+    labelInfo.disableTransmittance = true;
+    labelInfo.modelViewMatrix = glm::dmat4(data.camera.combinedViewMatrix()) *
+                                _globe->modelTransform();
+    labelInfo.projectionMatrix = glm::dmat4(data.camera.sgctInternal.projectionMatrix());
+
+    const std::array<glm::dvec4, 5> planes = frustumPlanes(VP);
+    const glm::dmat4 modelTransform = _globe->modelTransform();
+    const glm::dvec3 cameraPositionObj = glm::dvec3(
+        invModelMatrix * glm::dvec4(data.camera.positionVec3(), 1.0)
+    );
+
+    auto renderLabel = [&](const LabelEntry& lEntry) {
         glm::vec3 position = lEntry.geoPosition;
-        glm::dvec3 locationPositionWorld =
-            glm::dvec3(_globe->modelTransform() * glm::dvec4(position, 1.0));
-        double distanceCameraToLabelWorld =
-            glm::length(locationPositionWorld - data.camera.positionVec3());
-
-        if (_labelsDisableCullingEnabled ||
-            ((distToCamera > (distanceCameraToLabelWorld + _labelsDistaneEPS)) &&
-            isLabelInFrustum(VP, locationPositionWorld)))
-        {
-            if (_labelAlignmentOption == Circularly) {
-                glm::dvec3 labelNormalObj = glm::dvec3(
-                    invModelMatrix * glm::dvec4(data.camera.positionVec3(), 1.0)
-                ) - glm::dvec3(position);
+        if (_labelAlignmentOption == Circularly) {
+            glm::dvec3 labelNormalObj = cameraPositionObj - glm::dvec3(position);
 
-                glm::dvec3 labelUpDirectionObj = glm::dvec3(position);
+            glm::dvec3 labelUpDirectionObj = glm::dvec3(position);
 
-                orthoRight = glm::normalize(
-                    glm::cross(labelUpDirectionObj, labelNormalObj)
+            orthoRight = glm::normalize(
+                glm::cross(labelUpDirectionObj, labelNormalObj)
+            );
+            if (orthoRight == glm::dvec3(0.0)) {
+                glm::dvec3 otherVector(
+                    labelUpDirectionObj.y,
+                    labelUpDirectionObj.x,
+                    labelUpDirectionObj.z
                 );
-                if (orthoRight == glm::dvec3(0.0)) {
-                    glm::dvec3 otherVector(
-                        labelUpDirectionObj.y,
-                        labelUpDirectionObj.x,
-                        labelUpDirectionObj.z
-                    );
-                    orthoRight = glm::normalize(glm::cross(otherVector, labelNormalObj));
-                }
-                orthoUp = glm::normalize(glm::cross(labelNormalObj, orthoRight));
+                orthoRight = glm::normalize(glm::cross(otherVector, labelNormalObj));
             }
+            orthoUp = glm::normalize(glm::cross(labelNormalObj, orthoRight));
 
-            position += _labelsMinHeight;
-
-            ghoul::fontrendering::FontRenderer::ProjectedLabelsInformation labelInfo;
             labelInfo.orthoRight = orthoRight;
             labelInfo.orthoUp = orthoUp;
-            labelInfo.minSize = _labelsMinSize;
-            labelInfo.maxSize = _labelsMaxSize;
-            labelInfo.cameraPos = data.camera.positionVec3();
-            labelInfo.cameraLookUp = data.camera.lookUpVectorWorldSpace();
-            labelInfo.renderType = 0;
-            labelInfo.mvpMatrix = modelViewProjectionMatrix;
-            labelInfo.scale = powf(2.f, _labelsSize);
-            labelInfo.enableDepth = true;
-            labelInfo.enableFalseDepth = true;
-            labelInfo.disableTransmittance = true;
-
-            // Testing
-            glm::dmat4 modelviewTransform = glm::dmat4(data.camera.combinedViewMatrix()) *
-                                            _globe->modelTransform();
-            labelInfo.modelViewMatrix = modelviewTransform;
-            labelInfo.projectionMatrix = glm::dmat4(
-                data.camera.sgctInternal.projectionMatrix()
-            );
+        }
 
-            ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
-                *_font,
-                position,
-                lEntry.feature,
-                textColor,
-                labelInfo
-            );
+        position += _labelsMinHeight;
+
+        ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
+            *_font,
+            position,
+            lEntry.feature,
+            textColor,
+            labelInfo
+        );
+    };
+
+    if (_labelsDisableCullingEnabled) {
+        for (const LabelEntry& lEntry : _labels.labelsArray) {
+            renderLabel(lEntry);
         }
+        return;
     }
-}
 
-bool GlobeLabelsComponent::isLabelInFrustum(const glm::dmat4& MVMatrix,
-                                            const glm::dvec3& position) const
-{
+    // The cells are culled with their bounding spheres first, so that only the labels of
+    // the visible part of the globe are tested individually
+    const double worldScale = std::max({
+        glm::length(glm::dvec3(modelTransform[0])),
+        glm::length(glm::dvec3(modelTransform[1])),
+        glm::length(glm::dvec3(modelTransform[2]))
+    });
+    const double minFeatureRatio = std::tan(
+        glm::radians(static_cast<double>(_labelsMinFeatureAngle))
+    );
 
-    // Frustum Planes
-    glm::dvec3 col1(MVMatrix[0][0], MVMatrix[1][0], MVMatrix[2][0]);
-    glm::dvec3 col2(MVMatrix[0][1], MVMatrix[1][1], MVMatrix[2][1]);
-    glm::dvec3 col3(MVMatrix[0][2], MVMatrix[1][2], MVMatrix[2][2]);
-    glm::dvec3 col4(MVMatrix[0][3], MVMatrix[1][3], MVMatrix[2][3]);
-
-    glm::dvec3 leftNormal = col4 + col1;
-    glm::dvec3 rightNormal = col4 - col1;
-    glm::dvec3 bottomNormal = col4 + col2;
-    glm::dvec3 topNormal = col4 - col2;
-    glm::dvec3 nearNormal = col3 + col4;
-    glm::dvec3 farNormal = col4 - col3;
-
-    // Plane Distances
-    double leftDistance = MVMatrix[3][3] + MVMatrix[3][0];
-    double rightDistance = MVMatrix[3][3] - MVMatrix[3][0];
-    double bottomDistance = MVMatrix[3][3] + MVMatrix[3][1];
-    double topDistance = MVMatrix[3][3] - MVMatrix[3][1];
-    double nearDistance = MVMatrix[3][3] + MVMatrix[3][2];
-    double farDistance = MVMatrix[3][3] - MVMatrix[3][2];
-
-    // Normalize Planes
-    const double invMagLeft = 1.0 / glm::length(leftNormal);
-    leftNormal *= invMagLeft;
-    leftDistance *= invMagLeft;
-
-    const double invMagRight = 1.0 / glm::length(rightNormal);
-    rightNormal *= invMagRight;
-    rightDistance *= invMagRight;
-
-    const double invMagBottom = 1.0 / glm::length(bottomNormal);
-    bottomNormal *= invMagBottom;
-    bottomDistance *= invMagBottom;
-
-    const double invMagTop = 1.0 / glm::length(topNormal);
-    topNormal *= invMagTop;
-    topDistance *= invMagTop;
-
-    const double invMagNear = 1.0 / glm::length(nearNormal);
-    nearNormal *= invMagNear;
-    nearDistance *= invMagNear;
-
-    const double invMagFar = 1.0 / glm::length(farNormal);
-    farNormal *= invMagFar;
-    farDistance *= invMagFar;
-
-    constexpr const float Radius = 1.0;
-
-    if ((glm::dot(leftNormal, position) + leftDistance) < -Radius) {
-        return false;
-    }
-    else if ((glm::dot(rightNormal, position) + rightDistance) < -Radius) {
-        return false;
-    }
-    else if ((glm::dot(bottomNormal, position) + bottomDistance) < -Radius) {
-        return false;
-    }
-    else if ((glm::dot(topNormal, position) + topDistance) < -Radius) {
-        return false;
-    }
-    else if ((glm::dot(nearNormal, position) + nearDistance) < -Radius) {
-        return false;
+    for (const LabelCell& cell : _labelCells) {
+        const glm::dvec3 cellCenterWorld =
+            glm::dvec3(modelTransform * glm::dvec4(cell.center, 1.0));
+        const double cellRadiusWorld = cell.radius * worldScale;
+        const double distanceCameraToCellWorld =
+            glm::length(cellCenterWorld - data.camera.positionVec3());
+
+        // None of the labels in the cell can be closer than the globe's center
+        if (distToCamera <=
+            (distanceCameraToCellWorld - cellRadiusWorld + _labelsDistaneEPS))
+        {
+            continue;
+        }
+        if (!isLabelInFrustum(planes, cellCenterWorld, cellRadiusWorld)) {
+            continue;
+        }
+
+        // The diameters are given in kilometers
+        const double minDiameter =
+            std::max(distanceCameraToCellWorld - cellRadiusWorld, 0.0) *
+            minFeatureRatio / 1000.0;
+        if (cell.maxDiameter < minDiameter) {
+            continue;
+        }
+
+        for (size_t i = cell.first; i < cell.first + cell.count; ++i) {
+            const LabelEntry& lEntry = _labels.labelsArray[i];
+            if (lEntry.diameter < minDiameter) {
+                // The remaining labels of the cell are even smaller
+                break;
+            }
+
+            glm::dvec3 locationPositionWorld =
+                glm::dvec3(modelTransform * glm::dvec4(lEntry.geoPosition, 1.0));
+            double distanceCameraToLabelWorld =
+                glm::length(locationPositionWorld - data.camera.positionVec3());
+
+            if ((distToCamera > (distanceCameraToLabelWorld + _labelsDistaneEPS)) &&
+                isLabelInFrustum(planes, locationPositionWorld, 1.0) &&
+                lEntry.diameter >= distanceCameraToLabelWorld * minFeatureRatio / 1000.0)
+            {
+                renderLabel(lEntry);
+            }
+        }
     }
-    // The far plane testing is disabled because the atm has no depth.
-    /*else if ((glm::dot(farNormal, position) + farDistance) < -Radius) {
-    return false;
-    }*/
+}
 
+bool GlobeLabelsComponent::isLabelInFrustum(const std::array<glm::dvec4, 5>& planes,
+                                            const glm::dvec3& position,
+                                            double radius) const
+{
+    for (const glm::dvec4& plane : planes) {
+        if (glm::dot(glm::dvec3(plane), position) + plane.w < -radius) {
+            return false;
+        }
+    }
     return true;
 }
 
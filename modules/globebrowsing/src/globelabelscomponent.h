@@ -34,6 +34,8 @@
 #include <openspace/properties/vector/vec4property.h>
 #include <ghoul/font/fontrenderer.h>
 #include <ghoul/glm.h>
+#include <array>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 namespace ghoul::opengl { class ProgramObject; }
@@ -64,9 +66,12 @@ private:
     bool readLabelsFile(const std::string& file);
     bool loadCachedFile(const std::string& file);
     bool saveCachedFile(const std::string& file) const;
+    /// Sorts the labels into cells of latitude and longitude that are culled as a whole
+    void buildLabelCells();
     void renderLabels(const RenderData& data, const glm::dmat4& modelViewProjectionMatrix,
         float distToCamera, float fadeInVariable);
-    bool isLabelInFrustum(const glm::dmat4& MVMatrix, const glm::dvec3& position) const;
+    bool isLabelInFrustum(const std::array<glm::dvec4, 5>& planes,
+        const glm::dvec3& position, double radius) const;
 
 private:
     // Labels Structures
@@ -78,6 +83,16 @@ private:
         glm::vec3 geoPosition;
     };
 
+    // A range of labels in the same latitude/longitude cell, ordered by decreasing
+    // diameter, and their bounding sphere in model space
+    struct LabelCell {
+        glm::dvec3 center;
+        double radius;
+        float maxDiameter;
+        size_t first;
+        size_t count;
+    };
+
     struct Labels {
         std::string filename;
         std::vector<LabelEntry> labelsArray;
@@ -96,10 +111,12 @@ private:
     properties::BoolProperty _labelsFadeOutEnabled;
     properties::BoolProperty _labelsDisableCullingEnabled;
     properties::FloatProperty _labelsDistaneEPS;
+    properties::FloatProperty _labelsMinFeatureAngle;
     properties::OptionProperty _labelAlignmentOption;
 
 private:
     Labels _labels;
+    std::vector<LabelCell> _labelCells;
 
     // Font
     std::shared_ptr<ghoul::fontrendering::Font> _font;
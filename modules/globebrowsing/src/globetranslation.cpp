@@ -178,6 +178,16 @@ void GlobeTranslation::fillAttachedNode() {
     }
 }
 
+bool GlobeTranslation::dependsOnTime() const {
+    return false;
+}
+
+bool GlobeTranslation::dependsOnExternalState() const {
+    // Without a fixed altitude the position follows the height map of the globe, which
+    // can change as more detailed tiles are loaded
+    return !_useFixedAltitude || !_attachedNode;
+}
+
 glm::dvec3 GlobeTranslation::position(const UpdateData&) const {
     if (!_attachedNode) {
         // @TODO(abock): The const cast should be removed on a redesign of the translation
@@ -209,7 +219,7 @@ glm::dvec3 GlobeTranslation::position(const UpdateData&) const {
 
     if (_useFixedAltitude) {
         _position = glm::dvec3(pos);
-        _positionIsDirty = true;
+        _positionIsDirty = false;
 
         return _position;
     }
@@ -40,6 +40,8 @@ public:
     GlobeTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    bool dependsOnTime() const override;
+    bool dependsOnExternalState() const override;
 
     static documentation::Documentation Documentation();
 
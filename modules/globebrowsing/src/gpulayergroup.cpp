@@ -32,7 +32,8 @@
 namespace openspace::globebrowsing {
 
 void GPULayerGroup::setValue(ghoul::opengl::ProgramObject& program,
-                             const LayerGroup& layerGroup, const TileIndex& tileIndex)
+                             const LayerGroup& layerGroup, const TileIndex& tileIndex,
+                             float priority, tileprovider::ChunkTileResolver* resolver)
 {
     ghoul_assert(
         layerGroup.activeLayers().size() == _gpuActiveLayers.size(),
@@ -69,20 +70,31 @@ void GPULayerGroup::setValue(ghoul::opengl::ProgramObject& program,
             case layergroupid::TypeID::TemporalTileLayer:
             case layergroupid::TypeID::TileIndexTileLayer:
             case layergroupid::TypeID::ByIndexTileLayer:
-            case layergroupid::TypeID::ByLevelTileLayer: {
+            case layergroupid::TypeID::ByLevelTileLayer:
+            case layergroupid::TypeID::BakedTileLayer: {
                 const ChunkTilePile& ctp = al.chunkTilePile(
                     tileIndex,
-                    layerGroup.pileSize()
+                    layerGroup.pileSize(),
+                    priority,
+                    resolver
                 );
                 for (size_t j = 0; j < _gpuActiveLayers[i].gpuChunkTiles.size(); ++j) {
                     GPULayer::GPUChunkTile& t = _gpuActiveLayers[i].gpuChunkTiles[j];
                     const ChunkTile& ct = ctp[j];
 
-                    t.texUnit.activate();
-                    if (ct.tile.texture) {
-                        ct.tile.texture->bind();
+                    // Neighboring chunks often share the same tiles, particularly for
+                    // the lower levels of the pile, so we only rebind on a change
+                    if (!t.isBound || ct.tile.texture != t.boundTexture) {
+                        t.texUnit.activate();
+                        if (ct.tile.texture) {
+                            ct.tile.texture->bind();
+                        }
+                        t.boundTexture = ct.tile.texture;
+                    }
+                    if (!t.isBound) {
+                        program.setUniform(t.uniformCache.texture, t.texUnit);
+                        t.isBound = true;
                     }
-                    program.setUniform(t.uniformCache.texture, t.texUnit);
 
                     program.setUniform(t.uniformCache.uvOffset, ct.uvTransform.uvOffset);
                     program.setUniform(t.uniformCache.uvScale, ct.uvTransform.uvScale);
@@ -148,7 +160,8 @@ void GPULayerGroup::bind(ghoul::opengl::ProgramObject& p,
             case layergroupid::TypeID::TemporalTileLayer:
             case layergroupid::TypeID::TileIndexTileLayer:
             case layergroupid::TypeID::ByIndexTileLayer:
-            case layergroupid::TypeID::ByLevelTileLayer: {
+            case layergroupid::TypeID::ByLevelTileLayer:
+            case layergroupid::TypeID::BakedTileLayer: {
                 gal.gpuChunkTiles.resize(pileSize);
                 for (size_t j = 0; j < gal.gpuChunkTiles.size(); ++j) {
                     GPULayer::GPUChunkTile& t = gal.gpuChunkTiles[j];
@@ -158,6 +171,8 @@ void GPULayerGroup::bind(ghoul::opengl::ProgramObject& p,
                     tuc.texture = p.uniformLocation(n + "textureSampler");
                     tuc.uvOffset = p.uniformLocation(n + "uvTransform.uvOffset");
                     tuc.uvScale = p.uniformLocation(n + "uvTransform.uvScale");
+                    // The sampler uniform of a (re)linked program has to be set again
+                    t.isBound = false;
                 }
 
                 galuc.paddingStartOffset = p.uniformLocation(
@@ -187,6 +202,8 @@ void GPULayerGroup::deactivate() {
     for (GPULayer& gal : _gpuActiveLayers) {
         for (GPULayer::GPUChunkTile& t : gal.gpuChunkTiles) {
             t.texUnit.deactivate();
+            t.boundTexture = nullptr;
+            t.isBound = false;
         }
     }
 }
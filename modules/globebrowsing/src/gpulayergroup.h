@@ -31,7 +31,10 @@
 #include <string>
 #include <vector>
 
-namespace ghoul::opengl { class ProgramObject; }
+namespace ghoul::opengl {
+    class ProgramObject;
+    class Texture;
+} // namespace ghoul::opengl
 
 namespace openspace::globebrowsing {
 
@@ -44,6 +47,8 @@ struct TileUvTransform;
 struct LayerGroup;
 struct TileIndex;
 
+namespace tileprovider { class ChunkTileResolver; }
+
 /**
  * Manages a GPU representation of a <code>LayerGroup</code>
  */
@@ -52,10 +57,15 @@ public:
     /**
      * Sets the value of <code>LayerGroup</code> to its corresponding
      * GPU struct. OBS! Users must ensure bind has been
-     * called before setting using this method.
+     * called before setting using this method. Tiles that are not yet loaded are
+     * requested with the provided \p priority. Texture units stay assigned between
+     * consecutive calls until #deactivate is called, so a tile texture that was already
+     * bound for the previous chunk is not bound again. If a \p resolver is provided,
+     * the chunk tiles are looked up through it.
      */
     void setValue(ghoul::opengl::ProgramObject& programObject,
-        const LayerGroup& layerGroup, const TileIndex& tileIndex);
+        const LayerGroup& layerGroup, const TileIndex& tileIndex, float priority = 0.f,
+        tileprovider::ChunkTileResolver* resolver = nullptr);
 
     /**
      * Binds this object with GLSL variables with identifiers starting
@@ -67,7 +77,8 @@ public:
 
     /**
     * Deactivates any <code>TextureUnit</code>s assigned by this object.
-    * This method should be called after the OpenGL draw call.
+    * This method should be called after the last OpenGL draw call that uses the
+    * values set by #setValue.
     */
     void deactivate();
 
@@ -76,6 +87,11 @@ private:
         struct GPUChunkTile {
             ghoul::opengl::TextureUnit texUnit;
             UniformCache(texture, uvOffset, uvScale) uniformCache;
+
+            /// The texture that is currently bound to the texUnit
+            const ghoul::opengl::Texture* boundTexture = nullptr;
+            /// Whether the texUnit is assigned and its sampler uniform has been set
+            bool isBound = false;
         };
         std::vector<GPUChunkTile> gpuChunkTiles;
 
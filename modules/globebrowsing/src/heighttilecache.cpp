@@ -0,0 +1,146 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/heighttilecache.h>
+
+#include <modules/globebrowsing/src/tileprovider.h>
+#include <ghoul/opengl/texture.h>
+#include <cmath>
+
+namespace {
+    // The number of frames after which an entry is checked against its tile provider
+    constexpr const uint64_t RevalidationInterval = 10;
+} // namespace
+
+namespace openspace::globebrowsing {
+
+std::optional<float> HeightTileCache::Entry::sample(const glm::vec2& uv,
+                                                    float noDataValue) const
+{
+    const glm::vec2 samplePos = uv * glm::vec2(dimensions);
+    const glm::uvec2 maxPos = dimensions - glm::uvec2(1);
+    const glm::uvec2 samplePos00 = glm::clamp(
+        glm::uvec2(samplePos),
+        glm::uvec2(0),
+        maxPos
+    );
+    const glm::vec2 samplePosFract = samplePos - glm::vec2(samplePos00);
+    const glm::uvec2 samplePos11 = glm::min(samplePos00 + glm::uvec2(1), maxPos);
+
+    const size_t row0 = static_cast<size_t>(samplePos00.y) * dimensions.x;
+    const size_t row1 = static_cast<size_t>(samplePos11.y) * dimensions.x;
+    const float sample00 = samples[row0 + samplePos00.x];
+    const float sample10 = samples[row0 + samplePos11.x];
+    const float sample01 = samples[row1 + samplePos00.x];
+    const float sample11 = samples[row1 + samplePos11.x];
+
+    // In case the texture has NaN or no data values don't use this height map
+    const bool anySampleIsNaN =
+        std::isnan(sample00) ||
+        std::isnan(sample01) ||
+        std::isnan(sample10) ||
+        std::isnan(sample11);
+
+    const bool anySampleIsNoData =
+        sample00 == noDataValue ||
+        sample01 == noDataValue ||
+        sample10 == noDataValue ||
+        sample11 == noDataValue;
+
+    if (anySampleIsNaN || anySampleIsNoData) {
+        return std::nullopt;
+    }
+
+    const float sample0 = sample00 * (1.f - samplePosFract.x) +
+        sample10 * samplePosFract.x;
+    const float sample1 = sample01 * (1.f - samplePosFract.x) +
+        sample11 * samplePosFract.x;
+
+    return sample0 * (1.f - samplePosFract.y) + sample1 * samplePosFract.y;
+}
+
+bool HeightTileCache::Key::operator==(const Key& rhs) const {
+    return tileProvider == rhs.tileProvider && tileIndex == rhs.tileIndex;
+}
+
+size_t HeightTileCache::KeyHasher::operator()(const Key& key) const {
+    const size_t h = std::hash<const void*>()(key.tileProvider);
+    return h ^ (std::hash<TileIndex::TileHashKey>()(key.tileIndex) + 0x9e3779b9 +
+        (h << 6) + (h >> 2));
+}
+
+HeightTileCache::HeightTileCache(size_t size)
+    : _entries(size)
+{}
+
+std::shared_ptr<const HeightTileCache::Entry> HeightTileCache::entry(
+                                                 tileprovider::TileProvider& tileProvider,
+                                                               const TileIndex& tileIndex,
+                                                                           uint64_t frame)
+{
+    const Key key = { &tileProvider, tileIndex.hashKey() };
+
+    std::shared_ptr<Entry> e;
+    if (_entries.exist(key)) {
+        e = _entries.get(key);
+        if (frame < e->validatedFrame + RevalidationInterval) {
+            return e;
+        }
+    }
+
+    const ChunkTile chunkTile = tileprovider::chunkTile(tileProvider, tileIndex);
+    const Tile& tile = chunkTile.tile;
+    if (tile.status != Tile::Status::OK || !tile.texture) {
+        return nullptr;
+    }
+
+    const bool isSameTile = e && e->texture == tile.texture &&
+        e->uvTransform.uvOffset == chunkTile.uvTransform.uvOffset &&
+        e->uvTransform.uvScale == chunkTile.uvTransform.uvScale;
+    if (!isSameTile) {
+        // Create a new entry rather than modifying the existing one, which might still
+        // be in use by a caller
+        e = std::make_shared<Entry>();
+        e->texture = tile.texture;
+        e->uvTransform = chunkTile.uvTransform;
+        e->depthTransform = tileprovider::depthTransform(tileProvider);
+        e->dimensions = glm::uvec2(tile.texture->dimensions());
+        e->samples.resize(static_cast<size_t>(e->dimensions.x) * e->dimensions.y);
+        for (unsigned int y = 0; y < e->dimensions.y; ++y) {
+            for (unsigned int x = 0; x < e->dimensions.x; ++x) {
+                e->samples[static_cast<size_t>(y) * e->dimensions.x + x] =
+                    tile.texture->texelAsFloat(glm::uvec2(x, y)).x;
+            }
+        }
+        _entries.put(key, e);
+    }
+    e->validatedFrame = frame;
+    return e;
+}
+
+void HeightTileCache::clear() {
+    _entries.clear();
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,106 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_TILE_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_TILE_CACHE___H__
+
+#include <modules/globebrowsing/src/basictypes.h>
+#include <modules/globebrowsing/src/lrucache.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <ghoul/glm.h>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace ghoul::opengl { class Texture; }
+
+namespace openspace::globebrowsing {
+
+namespace tileprovider { struct TileProvider; }
+
+/**
+ * A CPU-side copy of the height tiles that have recently been sampled on a globe. The
+ * first channel of each tile is stored as a compact array of floats, so that the height
+ * of a position can be sampled with a single hash lookup instead of going through the
+ * tile provider and reading the texels of the tile texture.
+ *
+ * The tile that a provider returns for a tile index can change, for example when a tile
+ * of a higher resolution finishes loading or when a temporal layer changes its time
+ * step, so each entry is revalidated against its tile provider every few frames. The
+ * samples are only copied again if the provider returned a different tile.
+ */
+class HeightTileCache {
+public:
+    struct Entry {
+        /**
+         * Samples the entry at the texture coordinates \p uv using bilinear
+         * interpolation. Returns an empty optional if any of the four samples is NaN or
+         * equal to the \p noDataValue.
+         */
+        std::optional<float> sample(const glm::vec2& uv, float noDataValue) const;
+
+        /// The texture from which the samples were copied
+        const ghoul::opengl::Texture* texture = nullptr;
+        TileUvTransform uvTransform;
+        TileDepthTransform depthTransform;
+        glm::uvec2 dimensions = glm::uvec2(0);
+        std::vector<float> samples;
+        uint64_t validatedFrame = 0;
+    };
+
+    /**
+     * \param size is the maximum number of tiles that are kept in the cache
+     */
+    explicit HeightTileCache(size_t size);
+
+    /**
+     * Returns the entry for the \p tileIndex of the \p tileProvider. The entry is created
+     * from the tile provider if it does not exist yet and revalidated if it has not been
+     * validated for a number of frames before the \p frame. Returns <code>nullptr</code>
+     * if the tile provider does not have a usable tile for the \p tileIndex.
+     */
+    std::shared_ptr<const Entry> entry(tileprovider::TileProvider& tileProvider,
+        const TileIndex& tileIndex, uint64_t frame);
+
+    /// Removes all entries from the cache
+    void clear();
+
+private:
+    struct Key {
+        const tileprovider::TileProvider* tileProvider;
+        TileIndex::TileHashKey tileIndex;
+
+        bool operator==(const Key& rhs) const;
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const;
+    };
+
+    cache::LRUCache<Key, std::shared_ptr<Entry>, KeyHasher> _entries;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHT_TILE_CACHE___H__
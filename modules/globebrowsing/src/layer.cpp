@@ -217,6 +217,7 @@ Layer::Layer(layergroupid::GroupID id, const ghoul::Dictionary& layerDict,
             case layergroupid::TypeID::TileIndexTileLayer:
             case layergroupid::TypeID::ByIndexTileLayer:
             case layergroupid::TypeID::ByLevelTileLayer:
+            case layergroupid::TypeID::BakedTileLayer:
                 if (_tileProvider) {
                     removePropertySubOwner(*_tileProvider);
                 }
@@ -277,9 +278,18 @@ void Layer::deinitialize() {
     }
 }
 
-ChunkTilePile Layer::chunkTilePile(const TileIndex& tileIndex, int pileSize) const {
+ChunkTilePile Layer::chunkTilePile(const TileIndex& tileIndex, int pileSize,
+                                   float priority,
+                                   tileprovider::ChunkTileResolver* resolver) const
+{
     if (_tileProvider) {
-        return tileprovider::chunkTilePile(*_tileProvider, tileIndex, pileSize);
+        return tileprovider::chunkTilePile(
+            *_tileProvider,
+            tileIndex,
+            pileSize,
+            priority,
+            resolver
+        );
     }
     else {
         ChunkTilePile chunkTilePile;
@@ -377,7 +387,8 @@ void Layer::initializeBasedOnType(layergroupid::TypeID id, ghoul::Dictionary ini
         case layergroupid::TypeID::TemporalTileLayer:
         case layergroupid::TypeID::TileIndexTileLayer:
         case layergroupid::TypeID::ByIndexTileLayer:
-        case layergroupid::TypeID::ByLevelTileLayer: {
+        case layergroupid::TypeID::ByLevelTileLayer:
+        case layergroupid::TypeID::BakedTileLayer: {
             // We add the id to the dictionary since it needs to be known by
             // the tile provider
             initDict.setValue(KeyLayerGroupID, _layerGroupId);
@@ -410,7 +421,8 @@ void Layer::addVisibleProperties() {
         case layergroupid::TypeID::TemporalTileLayer:
         case layergroupid::TypeID::TileIndexTileLayer:
         case layergroupid::TypeID::ByIndexTileLayer:
-        case layergroupid::TypeID::ByLevelTileLayer: {
+        case layergroupid::TypeID::ByLevelTileLayer:
+        case layergroupid::TypeID::BakedTileLayer: {
             if (_tileProvider) {
                 addPropertySubOwner(*_tileProvider);
             }
@@ -49,7 +49,8 @@ public:
     void initialize();
     void deinitialize();
 
-    ChunkTilePile chunkTilePile(const TileIndex& tileIndex, int pileSize) const;
+    ChunkTilePile chunkTilePile(const TileIndex& tileIndex, int pileSize,
+        float priority = 0.f, tileprovider::ChunkTileResolver* resolver = nullptr) const;
     Tile::Status tileStatus(const TileIndex& index) const;
 
     layergroupid::TypeID type() const;
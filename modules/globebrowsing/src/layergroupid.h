@@ -56,7 +56,7 @@ enum GroupID {
     Unknown,
 };
 
-static constexpr int NUM_LAYER_TYPES = 8;
+static constexpr int NUM_LAYER_TYPES = 9;
 static constexpr const char* LAYER_TYPE_NAMES[NUM_LAYER_TYPES] = {
     "DefaultTileLayer",
     "SingleImageTileLayer",
@@ -66,6 +66,7 @@ static constexpr const char* LAYER_TYPE_NAMES[NUM_LAYER_TYPES] = {
     "ByIndexTileLayer",
     "ByLevelTileLayer",
     "SolidColor",
+    "BakedTileLayer",
 };
 
 /**
@@ -81,6 +82,7 @@ enum class TypeID {
     ByIndexTileLayer = 5,
     ByLevelTileLayer = 6,
     SolidColor = 7,
+    BakedTileLayer = 8,
 };
 
 static constexpr int NUM_ADJUSTMENT_TYPES = 3;
@@ -25,8 +25,10 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 
-#include <list>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 namespace openspace::globebrowsing::cache {
@@ -34,12 +36,102 @@ namespace openspace::globebrowsing::cache {
 /**
  * Templated class implementing a Least-Recently-Used Cache.
  * <code>KeyType</code> needs to be an enumerable type.
+ *
+ * The items are stored contiguously in a single vector and are linked into the recency
+ * order through indices, rather than through separately allocated list nodes. They are
+ * found through an open-addressing hash table of item indices with linear probing.
+ * The hash value that <code>HasherType</code> produces for an item is stored with the
+ * item, so neither growing the table nor removing items calls the hasher again. For a
+ * bounded cache, the storage for all items is allocated up front, so that a cache that
+ * is full does not allocate at all.
  */
 template <typename KeyType, typename ValueType, typename HasherType>
 class LRUCache {
 public:
     using Item = std::pair<KeyType, ValueType>;
-    using Items = std::list<Item>;
+
+private:
+    using Index = uint32_t;
+    static constexpr const Index Nil = static_cast<Index>(-1);
+
+    /// Caches up to this size allocate the storage for all of their items up front
+    static constexpr const size_t MaxPreallocatedSize = 65536;
+
+    /// The smallest number of slots of the hash table
+    static constexpr const size_t MinTableSize = 16;
+
+    struct Node {
+        Item item;
+        uint64_t hash;
+        Index previous;
+        Index next;
+    };
+
+public:
+    /**
+     * A view of the items of the cache, ordered from the most recently to the least
+     * recently used item. It is invalidated by every modification of the cache.
+     */
+    class Items {
+    public:
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Item;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Item*;
+            using reference = const Item&;
+
+            const_iterator(const std::vector<Node>* nodes, Index index)
+                : _nodes(nodes)
+                , _index(index)
+            {}
+
+            reference operator*() const { return (*_nodes)[_index].item; }
+            pointer operator->() const { return &(*_nodes)[_index].item; }
+
+            const_iterator& operator++() {
+                _index = (*_nodes)[_index].next;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator it = *this;
+                ++(*this);
+                return it;
+            }
+
+            bool operator==(const const_iterator& rhs) const {
+                return _index == rhs._index;
+            }
+
+            bool operator!=(const const_iterator& rhs) const {
+                return _index != rhs._index;
+            }
+
+        private:
+            const std::vector<Node>* _nodes;
+            Index _index;
+        };
+
+        Items(const std::vector<Node>& nodes, Index head, Index tail)
+            : _nodes(nodes)
+            , _head(head)
+            , _tail(tail)
+        {}
+
+        const_iterator begin() const { return const_iterator(&_nodes, _head); }
+        const_iterator end() const { return const_iterator(&_nodes, Nil); }
+        const Item& front() const { return _nodes[_head].item; }
+        const Item& back() const { return _nodes[_tail].item; }
+        bool empty() const { return _head == Nil; }
+        size_t size() const { return _nodes.size(); }
+
+    private:
+        const std::vector<Node>& _nodes;
+        Index _head;
+        Index _tail;
+    };
 
     /**
      * \param size is the maximum size of the cache given in number of cached items.
@@ -71,14 +163,45 @@ public:
     size_t size() const;
     size_t maximumCacheSize() const;
 
+    /**
+     * \returns all items in the cache, ordered from the most recently to the least
+     *          recently used item.
+     */
+    Items items() const;
+
 private:
     void putWithoutCleaning(KeyType key, ValueType value);
     void clean();
 
     std::vector<Item> cleanAndFetchPopped();
 
-    Items _itemList;
-    std::unordered_map<KeyType, typename Items::const_iterator, HasherType> _itemMap;
+    /// Returns the slot of the table that holds the item with the \p key, or the empty
+    /// slot at which the item would be inserted
+    size_t findSlot(const KeyType& key, uint64_t hash) const;
+
+    /// Returns the slot of the table that holds the item at \p index
+    size_t slotOfIndex(Index index) const;
+
+    /// Returns the first slot that is probed for items with the \p hash
+    size_t homeSlot(uint64_t hash) const;
+
+    /// Empties the \p slot, moving items of the same probe sequence back into the gap
+    void eraseSlot(size_t slot);
+
+    /// Doubles the size of the table and reinserts all items with their stored hashes
+    void growTable();
+
+    void unlink(Index index);
+    void linkFront(Index index);
+
+    /// Removes the item at \p index and moves the last item of the vector into its place
+    Item removeNode(Index index);
+
+    std::vector<Node> _nodes;
+    std::vector<Index> _table;
+    int _tableShift = 0;
+    Index _head = Nil;
+    Index _tail = Nil;
 
     size_t _maximumCacheSize;
 };
@@ -23,18 +23,37 @@
  ****************************************************************************************/
 
 #include <ghoul/misc/assert.h>
+#include <algorithm>
 
 namespace openspace::globebrowsing::cache {
 
 template<typename KeyType, typename ValueType, typename HasherType>
 LRUCache<KeyType, ValueType, HasherType>::LRUCache(size_t size)
     : _maximumCacheSize(size)
-{}
+{
+    size_t tableSize = MinTableSize;
+    if (size <= MaxPreallocatedSize) {
+        _nodes.reserve(size);
+        // Keep the load factor of a full cache at or below one half
+        while (tableSize < 2 * size) {
+            tableSize *= 2;
+        }
+    }
+    _table.assign(tableSize, Nil);
+
+    _tableShift = 64;
+    while (tableSize > 1) {
+        tableSize /= 2;
+        _tableShift--;
+    }
+}
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clear() {
-    _itemList.clear();
-    _itemMap.clear();
+    _nodes.clear();
+    std::fill(_table.begin(), _table.end(), Nil);
+    _head = Nil;
+    _tail = Nil;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -53,21 +72,18 @@ LRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(KeyType key, ValueTy
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::exist(const KeyType& key) const {
-    return (_itemMap.count(key) > 0);
+    const size_t slot = findSlot(key, HasherType()(key));
+    return _table[slot] != Nil;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) { // Found in cache
-        ValueType value = it->second->second;
-        // Remove from current position
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
+    const size_t slot = findSlot(key, HasherType()(key));
+    const Index index = _table[slot];
+    if (index != Nil) { // Found in cache
         // Bump to front
-        _itemList.emplace_front(key, value);
-        _itemMap.emplace(key, _itemList.begin());
-
+        unlink(index);
+        linkFront(index);
         return true;
     } else {
         return false;
@@ -76,44 +92,34 @@ bool LRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::isEmpty() const {
-    return (_itemMap.size() == 0);
+    return _nodes.empty();
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 ValueType LRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
-    //ghoul_assert(exist(key), "Key " << key << " must exist");
-    const auto it = _itemMap.find(key);
-    // Move list iterator pointing to value
-    _itemList.splice(_itemList.begin(), _itemList, it->second);
-    return it->second->second;
+    const size_t slot = findSlot(key, HasherType()(key));
+    const Index index = _table[slot];
+    ghoul_assert(index != Nil, "Key must exist");
+    unlink(index);
+    linkFront(index);
+    return _nodes[index].item.second;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popMRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
-
-    auto first_it = _itemList.begin();
-    _itemMap.erase(first_it->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.front();
-    _itemList.pop_front();
-    return toReturn;
+    ghoul_assert(!_nodes.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
+    return removeNode(_head);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popLRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
-
-    auto lastIt = _itemList.end();
-    lastIt--;
-    _itemMap.erase(lastIt->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.back();
-    _itemList.pop_back();
-    return toReturn;
+    ghoul_assert(!_nodes.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
+    return removeNode(_tail);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 size_t LRUCache<KeyType, ValueType, HasherType>::size() const {
-    return _itemMap.size();
+    return _nodes.size();
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -121,26 +127,42 @@ size_t LRUCache<KeyType, ValueType, HasherType>::maximumCacheSize() const {
     return _maximumCacheSize;
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+typename LRUCache<KeyType, ValueType, HasherType>::Items
+LRUCache<KeyType, ValueType, HasherType>::items() const
+{
+    return Items(_nodes, _head, _tail);
+}
+
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::putWithoutCleaning(KeyType key,
                                                                   ValueType value)
 {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) {
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
+    const uint64_t hash = HasherType()(key);
+    size_t slot = findSlot(key, hash);
+    if (_table[slot] != Nil) {
+        const Index index = _table[slot];
+        _nodes[index].item.second = std::move(value);
+        unlink(index);
+        linkFront(index);
+        return;
+    }
+
+    if (2 * (_nodes.size() + 1) > _table.size()) {
+        growTable();
+        slot = findSlot(key, hash);
     }
-    _itemList.emplace_front(key, std::move(value));
-    _itemMap.emplace(std::move(key), _itemList.begin());
+
+    const Index index = static_cast<Index>(_nodes.size());
+    _nodes.push_back({ Item(std::move(key), std::move(value)), hash, Nil, Nil });
+    _table[slot] = index;
+    linkFront(index);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clean() {
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        _itemList.pop_back();
+    while (_nodes.size() > _maximumCacheSize) {
+        removeNode(_tail);
     }
 }
 
@@ -149,14 +171,146 @@ std::vector<std::pair<KeyType, ValueType>>
 LRUCache<KeyType, ValueType, HasherType>::cleanAndFetchPopped()
 {
     std::vector<std::pair<KeyType, ValueType>> toReturn;
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        toReturn.push_back(_itemList.back());
-        _itemList.pop_back();
+    while (_nodes.size() > _maximumCacheSize) {
+        toReturn.push_back(removeNode(_tail));
     }
     return toReturn;
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::findSlot(const KeyType& key,
+                                                        uint64_t hash) const
+{
+    const size_t mask = _table.size() - 1;
+    size_t slot = homeSlot(hash);
+    while (_table[slot] != Nil) {
+        const Node& node = _nodes[_table[slot]];
+        if (node.hash == hash && node.item.first == key) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::slotOfIndex(Index index) const {
+    const size_t mask = _table.size() - 1;
+    size_t slot = homeSlot(_nodes[index].hash);
+    while (_table[slot] != index) {
+        ghoul_assert(_table[slot] != Nil, "Item must be in the table");
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::homeSlot(uint64_t hash) const {
+    // Fibonacci hashing spreads hash values whose low bits are similar, such as those of
+    // neighboring tiles, over the whole table
+    return static_cast<size_t>((hash * 11400714819323198485ULL) >> _tableShift);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::eraseSlot(size_t slot) {
+    const size_t mask = _table.size() - 1;
+    size_t hole = slot;
+    size_t next = (slot + 1) & mask;
+    while (_table[next] != Nil) {
+        // An item can move into the hole if the hole lies between its home slot and its
+        // current slot, as it would otherwise no longer be found
+        const size_t home = homeSlot(_nodes[_table[next]].hash);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            _table[hole] = _table[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    _table[hole] = Nil;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::growTable() {
+    std::fill(_table.begin(), _table.end(), Nil);
+    _table.resize(2 * _table.size(), Nil);
+    _tableShift--;
+
+    const size_t mask = _table.size() - 1;
+    for (Index i = 0; i < static_cast<Index>(_nodes.size()); ++i) {
+        size_t slot = homeSlot(_nodes[i].hash);
+        while (_table[slot] != Nil) {
+            slot = (slot + 1) & mask;
+        }
+        _table[slot] = i;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::unlink(Index index) {
+    Node& node = _nodes[index];
+    if (node.previous != Nil) {
+        _nodes[node.previous].next = node.next;
+    }
+    else {
+        _head = node.next;
+    }
+
+    if (node.next != Nil) {
+        _nodes[node.next].previous = node.previous;
+    }
+    else {
+        _tail = node.previous;
+    }
+    node.previous = Nil;
+    node.next = Nil;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::linkFront(Index index) {
+    Node& node = _nodes[index];
+    node.previous = Nil;
+    node.next = _head;
+    if (_head != Nil) {
+        _nodes[_head].previous = index;
+    }
+    _head = index;
+    if (_tail == Nil) {
+        _tail = index;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType>
+LRUCache<KeyType, ValueType, HasherType>::removeNode(Index index)
+{
+    eraseSlot(slotOfIndex(index));
+    unlink(index);
+    Item item = std::move(_nodes[index].item);
+
+    // Fill the gap with the last item to keep the items contiguous
+    const Index last = static_cast<Index>(_nodes.size() - 1);
+    if (index != last) {
+        const size_t lastSlot = slotOfIndex(last);
+        _nodes[index] = std::move(_nodes[last]);
+        _table[lastSlot] = index;
+
+        Node& node = _nodes[index];
+        if (node.previous != Nil) {
+            _nodes[node.previous].next = index;
+        }
+        else {
+            _head = index;
+        }
+
+        if (node.next != Nil) {
+            _nodes[node.next].previous = index;
+        }
+        else {
+            _tail = index;
+        }
+    }
+    _nodes.pop_back();
+    return item;
+}
+
 } // namespace openspace::globebrowsing::cache
@@ -26,28 +26,15 @@
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_THREAD_POOL___H__
 
 #include <modules/globebrowsing/src/lrucache.h>
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <mutex>
-#include <thread>
 #include <vector>
 
-// Implementation based on http://progsch.net/wordpress/?p=81
-
 namespace openspace::globebrowsing {
 
-template<typename KeyType> class LRUThreadPool;
-
-template<typename KeyType>
-class LRUThreadPoolWorker {
-public:
-    LRUThreadPoolWorker(LRUThreadPool<KeyType>& pool);
-    void operator()();
-
-private:
-    LRUThreadPool<KeyType>& _pool;
-};
-
 /**
  * The <code>LRUThreadPool</code> will only enqueue a certain number of tasks. The most
  * recently enqueued task is the one that will be executed first. This class is templated
@@ -57,6 +44,15 @@ private:
  * outcome to a second enqueued task with the same key. This is because a second enqueued
  * task with the same key will simply be bumped and prioritised before other enqueued
  * tasks. The given task will be ignored.
+ *
+ * In addition, every task has a priority. Tasks with a higher priority are executed
+ * before tasks with a lower priority, and if the queue is full, the task with the lowest
+ * priority is the one that is removed. Among tasks with equal priority the most recently
+ * used task is executed first. Tasks that have not been touched (or enqueued) between two
+ * calls to #removeStaleTasks are removed as they are no longer requested.
+ *
+ * The tasks are executed on the engine-wide TaskScheduler, with at most the number of
+ * tasks passed to the constructor running at the same time.
  */
 template<typename KeyType>
 class LRUThreadPool {
@@ -65,25 +61,69 @@ public:
     LRUThreadPool(const LRUThreadPool& toCopy);
     ~LRUThreadPool();
 
-    void enqueue(std::function<void()> f, KeyType key);
-    bool touch(KeyType key);
+    void enqueue(std::function<void()> f, KeyType key, float priority = 0.f);
+
+    /**
+     * Bumps the task with the \p key and sets its \p priority. If the task has
+     * already been touched since the last call to #removeStaleTasks, the highest of the
+     * priorities is kept.
+     */
+    bool touch(KeyType key, float priority = 0.f);
+
+    /**
+     * Removes all tasks that have not been enqueued or touched since the last time this
+     * function was called. The keys of the removed tasks are reported through
+     * #getUnqueuedTasksKeys.
+     */
+    void removeStaleTasks();
+
     std::vector<KeyType> getQueuedTasksKeys();
     std::vector<KeyType> getUnqueuedTasksKeys();
     void clearEnqueuedTasks();
 
+    /// Returns the number of tasks that are queued in all LRUThreadPools of this type
+    static size_t totalQueuedTasks();
+
 private:
+    struct QueuedTask {
+        std::function<void()> function;
+        float priority = 0.f;
+        /// The value of _generation the last time this task was enqueued or touched
+        uint64_t generation = 0;
+    };
+    using Item = std::pair<KeyType, QueuedTask>;
+
+    /// This function has to be called with the _queueMutex locked
+    Item popHighestPriorityTask();
+
+    /// This function has to be called with the _queueMutex locked
+    void removeTask(const KeyType& key);
+
+    /// Executes the highest priority task on the current worker of the scheduler
+    void runNextTask();
+
+    /// Adds the change of the queue size since the last call to the total number of
+    /// queued tasks. This function has to be called with the _queueMutex locked
+    void updateTotalQueuedTasks();
+
     struct DefaultHasher {
         unsigned long long operator()(const KeyType& key) const {
             return static_cast<unsigned long long>(key);
         }
     };
-    friend class LRUThreadPoolWorker<KeyType>;
 
-    std::vector<std::thread> _workers;
-    cache::LRUCache<KeyType, std::function<void()>, DefaultHasher> _queuedTasks;
+    const size_t _numThreads;
+    /// The number of tasks that have been handed to the scheduler and not finished yet
+    size_t _nActiveWorkers = 0;
+    cache::LRUCache<KeyType, QueuedTask, DefaultHasher> _queuedTasks;
     std::vector<KeyType> _unqueuedTasks;
     std::mutex _queueMutex;
     std::condition_variable _condition;
+    uint64_t _generation = 0;
+
+    /// The size of _queuedTasks that is included in _totalQueuedTasks
+    size_t _nReportedQueuedTasks = 0;
+    inline static std::atomic<size_t> _totalQueuedTasks = 0;
 
     bool _stop = false;
 };
@@ -22,104 +22,189 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-namespace openspace::globebrowsing {
+#include <openspace/engine/globals.h>
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
 
-template<typename KeyType>
-LRUThreadPoolWorker<KeyType>::LRUThreadPoolWorker(LRUThreadPool<KeyType>& pool)
-    : _pool(pool)
-{}
+namespace openspace::globebrowsing {
 
 template<typename KeyType>
-void LRUThreadPoolWorker<KeyType>::operator()() {
+void LRUThreadPool<KeyType>::runNextTask() {
     std::function<void()> task;
-    while (true) {
-        // acquire lock
-        {
-            std::unique_lock lock(_pool._queueMutex);
-
-            // look for a work item
-            while (!_pool._stop && _pool._queuedTasks.isEmpty()) {
-                // if there are none wait for notification
-                _pool._condition.wait(lock);
-            }
-
-            if (_pool._stop) { // exit if the pool is stopped
-                return;
-            }
+    {
+        std::unique_lock lock(_queueMutex);
+        if (_stop || _queuedTasks.isEmpty()) {
+            // Notifying while holding the lock, as the destructor might destroy the
+            // condition variable as soon as it sees the last worker finish
+            --_nActiveWorkers;
+            _condition.notify_all();
+            return;
+        }
+        task = std::move(popHighestPriorityTask().second.function);
+        updateTotalQueuedTasks();
+    }
 
-            // get the task from the queue
-            task = _pool._queuedTasks.popMRU().second;
+    task();
 
-        }// release lock
+    // Rather than looping here, the worker goes back to the scheduler after each task so
+    // that a long queue of tiles does not monopolize a shared worker thread. The worker
+    // is still counted as active, so the pool is guaranteed to be alive
+    global::taskScheduler.submit([this]() { runNextTask(); });
+}
 
-        // execute the task
-        task();
+template<typename KeyType>
+typename LRUThreadPool<KeyType>::Item LRUThreadPool<KeyType>::popHighestPriorityTask() {
+    ghoul_assert(!_queuedTasks.isEmpty(), "Queue must not be empty");
+
+    // The items are ordered from most to least recently used, so by only replacing the
+    // candidate on a strictly higher priority, ties are resolved in LRU order
+    const typename cache::LRUCache<KeyType, QueuedTask, DefaultHasher>::Items& items =
+        _queuedTasks.items();
+    auto best = items.begin();
+    for (auto it = items.begin(); it != items.end(); ++it) {
+        if (it->second.priority > best->second.priority) {
+            best = it;
+        }
     }
+
+    const KeyType key = best->first;
+    // Bump the chosen task to the front so that it can be popped
+    _queuedTasks.touch(key);
+    return _queuedTasks.popMRU();
 }
 
 template<typename KeyType>
-LRUThreadPool<KeyType>::LRUThreadPool(size_t numThreads, size_t queueSize)
-    : _queuedTasks(queueSize)
-{
-    for (size_t i = 0; i < numThreads; ++i) {
-        _workers.push_back(std::thread(LRUThreadPoolWorker<KeyType>(*this)));
+void LRUThreadPool<KeyType>::removeTask(const KeyType& key) {
+    if (_queuedTasks.touch(key)) {
+        _queuedTasks.popMRU();
     }
 }
 
+template<typename KeyType>
+void LRUThreadPool<KeyType>::updateTotalQueuedTasks() {
+    // The difference might be negative, which the unsigned arithmetic handles correctly
+    const size_t nQueuedTasks = _queuedTasks.size();
+    _totalQueuedTasks += nQueuedTasks - _nReportedQueuedTasks;
+    _nReportedQueuedTasks = nQueuedTasks;
+}
+
+template<typename KeyType>
+size_t LRUThreadPool<KeyType>::totalQueuedTasks() {
+    return _totalQueuedTasks;
+}
+
+template<typename KeyType>
+LRUThreadPool<KeyType>::LRUThreadPool(size_t numThreads, size_t queueSize)
+    : _numThreads(std::max(numThreads, size_t(1)))
+    , _queuedTasks(queueSize)
+{}
+
 template<typename KeyType>
 LRUThreadPool<KeyType>::LRUThreadPool(const LRUThreadPool& toCopy)
-    : LRUThreadPool(toCopy._workers.size(), toCopy._queuedTasks.maximumCacheSize())
+    : LRUThreadPool(toCopy._numThreads, toCopy._queuedTasks.maximumCacheSize())
 {}
 
-// the destructor joins all threads
+// the destructor waits for all workers that have been handed to the scheduler
 template<typename KeyType>
 LRUThreadPool<KeyType>::~LRUThreadPool() {
-    {
-        std::unique_lock lock(_queueMutex);
-        _stop = true;
-    }
-    _condition.notify_all();
-
-    // join them
-    for (size_t i = 0; i < _workers.size(); ++i) {
-        _workers[i].join();
-    }
+    std::unique_lock lock(_queueMutex);
+    _stop = true;
+    _queuedTasks.clear();
+    updateTotalQueuedTasks();
+    _condition.wait(lock, [this]() { return _nActiveWorkers == 0; });
 }
 
 // add new work item to the pool
 template<typename KeyType>
-void LRUThreadPool<KeyType>::enqueue(std::function<void()> f, KeyType key) {
+void LRUThreadPool<KeyType>::enqueue(std::function<void()> f, KeyType key,
+                                     float priority)
+{
+    bool needsWorker = false;
     {
         std::unique_lock<std::mutex> lock(_queueMutex);
 
-        // add the task
-        //_queuedTasks.put(key, f);
-        const std::vector<std::pair<KeyType, std::function<void()>>>& unfinishedTasks =
-            _queuedTasks.putAndFetchPopped(key, f);
-        for (const std::pair<KeyType, std::function<void()>>& unfinishedTask :
-             unfinishedTasks)
-        {
-            _unqueuedTasks.push_back(unfinishedTask.first);
+        const bool isFull = _queuedTasks.size() >= _queuedTasks.maximumCacheSize();
+        if (isFull && !_queuedTasks.exist(key)) {
+            // Find the task with the lowest priority, preferring the least recently used
+            // one in case of a tie
+            const auto& items = _queuedTasks.items();
+            auto lowest = items.begin();
+            for (auto it = items.begin(); it != items.end(); ++it) {
+                if (it->second.priority <= lowest->second.priority) {
+                    lowest = it;
+                }
+            }
+
+            if (lowest->second.priority > priority) {
+                // The new task is less important than everything that is already queued
+                _unqueuedTasks.push_back(key);
+                return;
+            }
+
+            const KeyType lowestKey = lowest->first;
+            removeTask(lowestKey);
+            _unqueuedTasks.push_back(lowestKey);
+        }
+
+        _queuedTasks.put(key, QueuedTask{ std::move(f), priority, _generation });
+        updateTotalQueuedTasks();
+
+        needsWorker = _nActiveWorkers < _numThreads;
+        if (needsWorker) {
+            ++_nActiveWorkers;
         }
     }
 
-    // wake up one thread
-    _condition.notify_one();
+    if (needsWorker) {
+        global::taskScheduler.submit([this]() { runNextTask(); });
+    }
 }
 
 template<typename KeyType>
-bool LRUThreadPool<KeyType>::touch(KeyType key) {
+bool LRUThreadPool<KeyType>::touch(KeyType key, float priority) {
     std::unique_lock<std::mutex> lock(_queueMutex);
-    return _queuedTasks.touch(key);
+    if (!_queuedTasks.exist(key)) {
+        return false;
+    }
+
+    QueuedTask task = _queuedTasks.get(key);
+    if (task.generation == _generation) {
+        task.priority = std::max(task.priority, priority);
+    }
+    else {
+        task.priority = priority;
+        task.generation = _generation;
+    }
+    _queuedTasks.put(key, std::move(task));
+    return true;
 }
 
 template<typename KeyType>
-std::vector<KeyType> LRUThreadPool<KeyType>::getUnqueuedTasksKeys() {
-    std::vector<KeyType> toReturn = _unqueuedTasks;
-    {
-        std::unique_lock<std::mutex> lock(_queueMutex);
-        _unqueuedTasks.clear();
+void LRUThreadPool<KeyType>::removeStaleTasks() {
+    std::unique_lock<std::mutex> lock(_queueMutex);
+
+    std::vector<KeyType> staleTasks;
+    for (const Item& item : _queuedTasks.items()) {
+        if (item.second.generation != _generation) {
+            staleTasks.push_back(item.first);
+        }
     }
+
+    for (const KeyType& key : staleTasks) {
+        removeTask(key);
+        _unqueuedTasks.push_back(key);
+    }
+    updateTotalQueuedTasks();
+
+    ++_generation;
+}
+
+template<typename KeyType>
+std::vector<KeyType> LRUThreadPool<KeyType>::getUnqueuedTasksKeys() {
+    std::unique_lock<std::mutex> lock(_queueMutex);
+    std::vector<KeyType> toReturn = std::move(_unqueuedTasks);
+    _unqueuedTasks.clear();
     return toReturn;
 }
 
@@ -131,6 +216,7 @@ std::vector<KeyType> LRUThreadPool<KeyType>::getQueuedTasksKeys() {
         while (!_queuedTasks.isEmpty()) {
             queuedTasks.push_back(_queuedTasks.popMRU().first);
         }
+        updateTotalQueuedTasks();
     }
     return queuedTasks;
 }
@@ -139,6 +225,7 @@ template<typename KeyType>
 void LRUThreadPool<KeyType>::clearEnqueuedTasks() {
     std::unique_lock<std::mutex> lock(_queueMutex);
     _queuedTasks.clear();
+    updateTotalQueuedTasks();
 }
 
 } // namespace openspace::globebrowsing
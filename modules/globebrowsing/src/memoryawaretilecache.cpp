@@ -27,8 +27,16 @@
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/layermanager.h>
 #include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tilebufferpool.h>
+#include <openspace/engine/globals.h>
+#include <openspace/performance/tracezone.h>
+#include <openspace/rendering/renderengine.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
+#include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <numeric>
 
 namespace {
@@ -51,7 +59,10 @@ namespace {
     constexpr openspace::properties::Property::PropertyInfo TileCacheSizeInfo = {
         "TileCacheSize",
         "Tile cache size",
-        "" // @TODO Missing documentation
+        "This value is the amount of GPU memory (in MB) that the textures of all cached "
+        "tiles share. Once it is used up, the least recently used tile is evicted, "
+        "regardless of the layer it belongs to. The value is applied by triggering the "
+        "'ApplyTileCacheSize' property."
     };
 
     constexpr openspace::properties::Property::PropertyInfo ApplyTileCacheInfo = {
@@ -66,6 +77,30 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo UploadBudgetInfo = {
+        "TileUploadBudget",
+        "Tile upload budget (KB)",
+        "This value denotes the maximum amount of tile data (in KB) that is uploaded to "
+        "the GPU in a single frame. Tiles that do not fit are uploaded in one of the "
+        "following frames, but at least one tile is uploaded every frame. A value of 0 "
+        "disables the budget and all finished tiles are uploaded immediately."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo UploadQueueDepthInfo = {
+        "TileUploadQueueDepth",
+        "Tile upload queue depth",
+        "This value denotes the number of tiles that have finished loading, but that "
+        "are still waiting to be uploaded to the GPU due to the tile upload budget."
+    };
+
+    // The maximum time (in nanoseconds) we are willing to wait for the GPU to finish
+    // reading from a segment of the upload buffer before writing to it again
+    constexpr const GLuint64 UploadFenceTimeout = 10000000;
+
+    // Tile data in the upload buffer starts at offsets that are a multiple of this value
+    // to satisfy the alignment requirements of all pixel data types
+    constexpr const size_t UploadDataAlignment = 16;
+
     GLenum toGlTextureFormat(GLenum glType, ghoul::opengl::Texture::Format format) {
         switch (format) {
             case ghoul::opengl::Texture::Format::Red:
@@ -182,6 +217,37 @@ namespace {
         }
     }
 
+    GLenum toCompressedGlTextureFormat(
+                   openspace::globebrowsing::TileTextureInitData::Compression compression)
+    {
+        using Compression = openspace::globebrowsing::TileTextureInitData::Compression;
+        switch (compression) {
+            case Compression::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            case Compression::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            default:
+                ghoul_assert(false, "Tile is not compressed");
+                throw ghoul::MissingCaseException();
+        }
+    }
+
+    // Uploads the compressed blocks of a tile into the bound texture. The data is either
+    // a pointer to client memory or an offset into the bound pixel unpack buffer
+    void uploadCompressedTile(const openspace::globebrowsing::TileTextureInitData& init,
+                              const void* data)
+    {
+        glCompressedTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            0,
+            init.dimensions.x,
+            init.dimensions.y,
+            toCompressedGlTextureFormat(init.compression),
+            static_cast<GLsizei>(init.textureNumBytes),
+            data
+        );
+    }
+
 
 } // namespace
 
@@ -190,51 +256,54 @@ namespace openspace::globebrowsing::cache {
 //
 // TextureContainer
 //
-MemoryAwareTileCache::TextureContainer::TextureContainer(TileTextureInitData initData,
-                                                         size_t numTextures)
+MemoryAwareTileCache::TextureContainer::TextureContainer(TileTextureInitData initData)
     : _initData(std::move(initData))
-    , _numTextures(numTextures)
-{
-    reset();
-}
+{}
 
 void MemoryAwareTileCache::TextureContainer::reset() {
     _textures.clear();
-    _freeTexture = 0;
-    for (size_t i = 0; i < _numTextures; ++i) {
-        using namespace ghoul::opengl;
-        std::unique_ptr<Texture> tex = std::make_unique<Texture>(
-            _initData.dimensions,
-            _initData.ghoulTextureFormat,
-            toGlTextureFormat(_initData.glType, _initData.ghoulTextureFormat),
-            _initData.glType,
-            Texture::FilterMode::Linear,
-            Texture::WrappingMode::ClampToEdge,
-            Texture::AllocateData(_initData.shouldAllocateDataOnCPU)
-        );
+}
 
-        tex->setDataOwnership(Texture::TakeOwnership::Yes);
-        tex->uploadTexture();
-        tex->setFilter(Texture::FilterMode::Linear);
+ghoul::opengl::Texture* MemoryAwareTileCache::TextureContainer::allocateTexture() {
+    using namespace ghoul::opengl;
+    const GLenum internalFormat =
+        _initData.compression == TileTextureInitData::Compression::None ?
+        toGlTextureFormat(_initData.glType, _initData.ghoulTextureFormat) :
+        toCompressedGlTextureFormat(_initData.compression);
+    std::unique_ptr<Texture> tex = std::make_unique<Texture>(
+        _initData.dimensions,
+        _initData.ghoulTextureFormat,
+        internalFormat,
+        _initData.glType,
+        Texture::FilterMode::Linear,
+        Texture::WrappingMode::ClampToEdge,
+        Texture::AllocateData(_initData.shouldAllocateDataOnCPU)
+    );
 
-        _textures.push_back(std::move(tex));
-    }
-}
+    tex->setDataOwnership(Texture::TakeOwnership::Yes);
+    tex->uploadTexture();
+    tex->setFilter(Texture::FilterMode::Linear);
 
-void MemoryAwareTileCache::TextureContainer::reset(size_t numTextures) {
-    _numTextures = numTextures;
-    reset();
+    _textures.push_back(std::move(tex));
+    return _textures.back().get();
 }
 
-ghoul::opengl::Texture* MemoryAwareTileCache::TextureContainer::getTextureIfFree() {
-    if (_freeTexture < _textures.size()) {
-        ghoul::opengl::Texture* texture = _textures[_freeTexture].get();
-        _freeTexture++;
-        return texture;
-    }
-    else {
-        return nullptr;
-    }
+void MemoryAwareTileCache::TextureContainer::deallocateTexture(
+                                                          ghoul::opengl::Texture* texture)
+{
+    const auto it = std::find_if(
+        _textures.begin(),
+        _textures.end(),
+        [texture](const std::unique_ptr<ghoul::opengl::Texture>& t) {
+            return t.get() == texture;
+        }
+    );
+    ghoul_assert(it != _textures.end(), "Texture must belong to this container");
+
+    // The order of the textures is irrelevant, so the last texture takes the place of
+    // the deleted one
+    std::swap(*it, _textures.back());
+    _textures.pop_back();
 }
 
 const TileTextureInitData&
@@ -251,14 +320,18 @@ size_t MemoryAwareTileCache::TextureContainer::size() const {
 // MemoryAwareTileCache
 //
 
-MemoryAwareTileCache::MemoryAwareTileCache(int tileCacheSize)
+MemoryAwareTileCache::MemoryAwareTileCache(int tileCacheSize,
+                                           TileBufferPool* tileBufferPool)
     : PropertyOwner({ "TileCache" })
     , _numTextureBytesAllocatedOnCPU(0)
+    , _tileBufferPool(tileBufferPool)
     , _cpuAllocatedTileData(CpuAllocatedDataInfo, tileCacheSize, 128, 16384, 1)
     , _gpuAllocatedTileData(GpuAllocatedDataInfo, tileCacheSize, 128, 16384, 1)
     , _tileCacheSize(TileCacheSizeInfo, tileCacheSize, 128, 16384, 1)
     , _applyTileCacheSize(ApplyTileCacheInfo)
     , _clearTileCache(ClearTileCacheInfo)
+    , _uploadBudget(UploadBudgetInfo, 8192, 0, 262144)
+    , _uploadQueueDepth(UploadQueueDepthInfo, 0, 0, std::numeric_limits<int>::max())
 {
     createDefaultTextureContainers();
 
@@ -287,12 +360,37 @@ MemoryAwareTileCache::MemoryAwareTileCache(int tileCacheSize)
     );
     addProperty(_tileCacheSize);
 
+    _uploadBudget.onChange([&]() { _uploadBuffer.isDirty = true; });
+    addProperty(_uploadBudget);
+
+    _uploadQueueDepth.setReadOnly(true);
+    addProperty(_uploadQueueDepth);
+
     setSizeEstimated(uint64_t(_tileCacheSize) * 1024ul * 1024ul);
+
+    // The globes are what the camera navigates on, so the tiles are the last to go if
+    // the caches of all modules together exceed the memory budget
+    _memoryBudgetClient = global::memoryBudget.registerClient(
+        "TileCache",
+        MemoryBudget::HighPriority,
+        [this](MemoryBudget::Resource resource, size_t allowance) {
+            shrink(resource, allowance);
+        }
+    );
+}
+
+MemoryAwareTileCache::~MemoryAwareTileCache() {
+    global::memoryBudget.unregisterClient(_memoryBudgetClient);
+    destroyUploadBuffer();
 }
 
 void MemoryAwareTileCache::clear() {
     LINFO("Clearing tile cache");
     _numTextureBytesAllocatedOnCPU = 0;
+    _uploadQueue.clear();
+    _pendingUploads.clear();
+    _uploadQueueDepth = 0;
+    _lastUsedFrame.clear();
     using K = TileTextureInitData::HashKey;
     using V = TextureContainerTileCache;
     for (std::pair<const K, V>& p : _textureContainerMap) {
@@ -317,10 +415,9 @@ void MemoryAwareTileCache::assureTextureContainerExists(
 {
     TileTextureInitData::HashKey initDataKey = initData.hashKey;
     if (_textureContainerMap.find(initDataKey) == _textureContainerMap.end()) {
-        // For now create 500 textures of this type
         _textureContainerMap.emplace(initDataKey,
             TextureContainerTileCache(
-                std::make_unique<TextureContainer>(initData, 500),
+                std::make_unique<TextureContainer>(initData),
                 std::make_unique<TileCache>(std::numeric_limits<std::size_t>::max())
             )
         );
@@ -329,39 +426,11 @@ void MemoryAwareTileCache::assureTextureContainerExists(
 
 void MemoryAwareTileCache::setSizeEstimated(size_t estimatedSize) {
     LDEBUG("Resetting tile cache size");
-    ghoul_assert(!_textureContainerMap.empty(), "Texture containers must exist.");
-
-    const size_t sumTextureTypeSize = std::accumulate(
-        _textureContainerMap.cbegin(),
-        _textureContainerMap.cend(),
-        size_t(0),
-        [](size_t s, const std::pair<const TileTextureInitData::HashKey,
-                                     TextureContainerTileCache>& p)
-        {
-            return s + p.second.first->tileTextureInitData().totalNumBytes;
-        }
-    );
-
-    if (sumTextureTypeSize > 0) {
-        const size_t numTexturesPerType = estimatedSize / sumTextureTypeSize;
-        resetTextureContainerSize(numTexturesPerType);
-    }
-    else {
-        resetTextureContainerSize(0);
-    }
+    _budget = estimatedSize;
+    clear();
     LINFO("Tile cache size was reset");
 }
 
-void MemoryAwareTileCache::resetTextureContainerSize(size_t numTexturesPerTextureType) {
-    _numTextureBytesAllocatedOnCPU = 0;
-    for (std::pair<const TileTextureInitData::HashKey,
-        TextureContainerTileCache>& p : _textureContainerMap)
-    {
-        p.second.first->reset(numTexturesPerTextureType);
-        p.second.second->clear();
-    }
-}
-
 bool MemoryAwareTileCache::exist(const ProviderTileKey& key) const {
     const TextureContainerMap::const_iterator result = std::find_if(
         _textureContainerMap.cbegin(),
@@ -386,9 +455,12 @@ Tile MemoryAwareTileCache::get(const ProviderTileKey& key) {
         }
     );
     if (it != _textureContainerMap.cend()) {
+        _lastUsedFrame[key] = _frame;
+        _statistics[key.providerID].nHits++;
         return it->second.second->get(key);
     }
     else {
+        _statistics[key.providerID].nMisses++;
         return Tile();
     }
 }
@@ -398,25 +470,84 @@ ghoul::opengl::Texture* MemoryAwareTileCache::texture(
 {
     // if this texture type does not exist among the texture containers
     // it needs to be created
-    TileTextureInitData::HashKey initDataKey = initData.hashKey;
     assureTextureContainerExists(initData);
-    // Now we know that the texture container exists,
-    // check if there are any unused textures
-    ghoul::opengl::Texture* texture =
-        _textureContainerMap[initDataKey].first->getTextureIfFree();
-    // Second option. No more textures available. Pop from the LRU cache
-    if (!texture) {
-        Tile oldTile = _textureContainerMap[initDataKey].second->popLRU().second;
-        // Use the old tile's texture
-        texture = oldTile.texture;
+    TextureContainerTileCache& target = _textureContainerMap[initData.hashKey];
+
+    // A new texture is created as long as it fits into the budget. Otherwise, the least
+    // recently used tile is evicted and its texture is either reused if it is of the
+    // requested type, or deleted to make room for a new texture
+    const size_t budget = std::min(_budget, _memoryAllowance);
+    while (gpuAllocatedDataSize() + initData.textureNumBytes > budget) {
+        TextureContainerTileCache* victim = leastRecentlyUsedCache();
+        if (!victim) {
+            // All tiles are in use. Instead of growing beyond the budget, we recycle the
+            // tiles of the requested type, if there are any
+            if (target.second->isEmpty()) {
+                break;
+            }
+            victim = &target;
+        }
+
+        ghoul::opengl::Texture* texture = evictLeastRecentlyUsed(*victim);
+        if (victim == &target) {
+            return texture;
+        }
+        reclaimPixelData(*texture, victim->first->tileTextureInitData());
+        victim->first->deallocateTexture(texture);
     }
-    return texture;
+    return target.first->allocateTexture();
+}
+
+MemoryAwareTileCache::TextureContainerTileCache*
+MemoryAwareTileCache::leastRecentlyUsedCache()
+{
+    TextureContainerTileCache* result = nullptr;
+    uint64_t oldestFrame = std::numeric_limits<uint64_t>::max();
+    for (std::pair<const TileTextureInitData::HashKey,
+                   TextureContainerTileCache>& p : _textureContainerMap)
+    {
+        const TileCache& cache = *p.second.second;
+        if (cache.isEmpty()) {
+            continue;
+        }
+
+        // The tiles of each cache are ordered by their last use, so only the last tile
+        // of each cache has to be compared
+        const ProviderTileKey& key = cache.items().back().first;
+        const auto it = _lastUsedFrame.find(key);
+        const uint64_t frame = it != _lastUsedFrame.end() ? it->second : 0;
+        if (!isPinned(key) && frame < oldestFrame) {
+            oldestFrame = frame;
+            result = &p.second;
+        }
+    }
+    return result;
+}
+
+ghoul::opengl::Texture* MemoryAwareTileCache::evictLeastRecentlyUsed(
+                                                         TextureContainerTileCache& cache)
+{
+    std::pair<ProviderTileKey, Tile> item = cache.second->popLRU();
+    _lastUsedFrame.erase(item.first);
+    _statistics[item.first.providerID].nEvictions++;
+    return item.second.texture;
+}
+
+bool MemoryAwareTileCache::isPinned(const ProviderTileKey& key) const {
+    const auto it = _lastUsedFrame.find(key);
+    return it != _lastUsedFrame.end() && it->second + 1 >= _frame;
 }
 
 void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key, RawTile rawTile) {
     using ghoul::opengl::Texture;
 
     if (rawTile.error != RawTile::ReadError::None) {
+        if (_tileBufferPool && rawTile.textureInitData) {
+            _tileBufferPool->release(
+                *rawTile.textureInitData,
+                std::move(rawTile.imageData)
+            );
+        }
         return;
     }
     else {
@@ -430,11 +561,11 @@ void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key, RawTile rawTile
                 if (!tex->dataOwnership()) {
                     _numTextureBytesAllocatedOnCPU += initData.totalNumBytes;
                 }
-                tex->setPixelData(
-                    rawTile.imageData.release(),
-                    Texture::TakeOwnership::Yes
-                );
-                rawTile.imageData = nullptr;
+                swapPixelData(*tex, rawTile);
+            }
+            else if (_tileBufferPool) {
+                // The image data is no longer needed once it is in the pixel buffer
+                _tileBufferPool->release(initData, std::move(rawTile.imageData));
             }
         }
         else {
@@ -443,29 +574,237 @@ void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key, RawTile rawTile
                 tex->dataOwnership(),
                 "Texture must have ownership of old data to avoid leaks"
             );
-            tex->setPixelData(rawTile.imageData.release(), Texture::TakeOwnership::Yes);
-            rawTile.imageData = nullptr;
+            swapPixelData(*tex, rawTile);
             [[ maybe_unused ]] size_t expectedDataSize = tex->expectedPixelDataSize();
             const size_t numBytes = rawTile.textureInitData->totalNumBytes;
             ghoul_assert(expectedDataSize == numBytes, "Pixel data size is incorrect");
             _numTextureBytesAllocatedOnCPU += numBytes - previousExpectedDataSize;
-            tex->reUploadTexture();
+            if (!uploadThroughPixelBuffer(*tex, initData)) {
+                if (initData.compression == TileTextureInitData::Compression::None) {
+                    tex->reUploadTexture();
+                }
+                else {
+                    tex->bind();
+                    uploadCompressedTile(initData, tex->pixelData());
+                }
+            }
+        }
+        // Mipmaps cannot be generated for compressed textures, so those keep the linear
+        // filtering they were created with
+        if (initData.compression == TileTextureInitData::Compression::None) {
+            tex->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
         }
-        tex->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
         Tile tile{ tex, std::move(rawTile.tileMetaData), Tile::Status::OK };
-        TileTextureInitData::HashKey initDataKey = initData.hashKey;
-        _textureContainerMap[initDataKey].second->put(std::move(key), std::move(tile));
+        put(key, initData.hashKey, std::move(tile));
     }
 }
 
+void MemoryAwareTileCache::enqueueTileUpload(ProviderTileKey key, RawTile rawTile) {
+    if (rawTile.error != RawTile::ReadError::None) {
+        return;
+    }
+
+    _pendingUploads.insert(key);
+    _uploadQueue.emplace_back(std::move(key), std::move(rawTile));
+    _uploadQueueDepth = static_cast<int>(_uploadQueue.size());
+}
+
+bool MemoryAwareTileCache::isUploadPending(const ProviderTileKey& key) const {
+    return _pendingUploads.find(key) != _pendingUploads.end();
+}
+
 void MemoryAwareTileCache::put(const ProviderTileKey& key,
                                const TileTextureInitData::HashKey& initDataKey,
                                Tile tile)
 {
+    _lastUsedFrame[key] = _frame;
     _textureContainerMap[initDataKey].second->put(key, std::move(tile));
 }
 
+void MemoryAwareTileCache::createUploadBuffer() {
+    destroyUploadBuffer();
+    _uploadBuffer.isDirty = false;
+
+    using Version = ghoul::systemcapabilities::Version;
+    const size_t segmentSize = static_cast<size_t>(_uploadBudget) * 1024;
+    if (segmentSize == 0 || OpenGLCap.openGLVersion() < Version{ 4, 4, 0 }) {
+        // Without a budget or persistent mapping, the tiles are uploaded directly from
+        // the pixel data of their textures
+        return;
+    }
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(segmentSize * NumUploadSegments);
+    glGenBuffers(1, &_uploadBuffer.pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _uploadBuffer.pbo);
+    glBufferStorage(
+        GL_PIXEL_UNPACK_BUFFER,
+        size,
+        nullptr,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+    );
+    _uploadBuffer.mappedData = reinterpret_cast<std::byte*>(glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER,
+        0,
+        size,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+    ));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!_uploadBuffer.mappedData) {
+        LWARNING("Could not map the tile upload buffer. Uploading tiles directly");
+        destroyUploadBuffer();
+        return;
+    }
+    _uploadBuffer.segmentSize = segmentSize;
+}
+
+void MemoryAwareTileCache::destroyUploadBuffer() {
+    for (GLsync& fence : _uploadBuffer.fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (_uploadBuffer.pbo != 0) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _uploadBuffer.pbo);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &_uploadBuffer.pbo);
+        _uploadBuffer.pbo = 0;
+    }
+    _uploadBuffer.mappedData = nullptr;
+    _uploadBuffer.segmentSize = 0;
+    _uploadBuffer.currentSegment = 0;
+    _uploadBuffer.segmentOffset = 0;
+}
+
+void MemoryAwareTileCache::swapPixelData(ghoul::opengl::Texture& texture,
+                                         RawTile& rawTile)
+{
+    using ghoul::opengl::Texture;
+
+    // Taking the ownership of the previous data away from the texture prevents it from
+    // being freed when the new data is set
+    reclaimPixelData(texture, *rawTile.textureInitData);
+    texture.setPixelData(rawTile.imageData.release(), Texture::TakeOwnership::Yes);
+}
+
+void MemoryAwareTileCache::reclaimPixelData(ghoul::opengl::Texture& texture,
+                                            const TileTextureInitData& initData)
+{
+    using ghoul::opengl::Texture;
+
+    if (_tileBufferPool && texture.dataOwnership() && texture.pixelData() &&
+        texture.expectedPixelDataSize() == initData.totalNumBytes)
+    {
+        std::byte* data = static_cast<std::byte*>(const_cast<void*>(texture.pixelData()));
+        texture.setDataOwnership(Texture::TakeOwnership::No);
+        _tileBufferPool->release(initData, std::unique_ptr<std::byte[]>(data));
+    }
+}
+
+bool MemoryAwareTileCache::uploadThroughPixelBuffer(ghoul::opengl::Texture& texture,
+                                                    const TileTextureInitData& initData)
+{
+    const size_t nBytes = initData.textureNumBytes;
+    if (!_uploadBuffer.mappedData ||
+        _uploadBuffer.segmentOffset + nBytes > _uploadBuffer.segmentSize)
+    {
+        return false;
+    }
+
+    const size_t offset = _uploadBuffer.currentSegment * _uploadBuffer.segmentSize +
+        _uploadBuffer.segmentOffset;
+    std::memcpy(_uploadBuffer.mappedData + offset, texture.pixelData(), nBytes);
+    _uploadBuffer.segmentOffset +=
+        (nBytes + UploadDataAlignment - 1) / UploadDataAlignment * UploadDataAlignment;
+
+    // The buffer is coherently mapped, so the copy is visible to the following upload,
+    // which is sourced from the buffer rather than from client memory
+    texture.bind();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _uploadBuffer.pbo);
+    if (initData.compression == TileTextureInitData::Compression::None) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            0,
+            initData.dimensions.x,
+            initData.dimensions.y,
+            static_cast<GLenum>(initData.ghoulTextureFormat),
+            initData.glType,
+            reinterpret_cast<const void*>(offset)
+        );
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    else {
+        uploadCompressedTile(initData, reinterpret_cast<const void*>(offset));
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return true;
+}
+
+void MemoryAwareTileCache::uploadQueuedTiles() {
+    PerfTrace("MemoryAwareTileCache::uploadQueuedTiles");
+
+    if (_uploadBuffer.isDirty) {
+        createUploadBuffer();
+    }
+
+    if (_uploadBuffer.pbo != 0) {
+        // The segment we are about to write into was last used NumUploadSegments frames
+        // ago, so the GPU should be done with it already and this wait is a safeguard
+        GLsync& fence = _uploadBuffer.fences[_uploadBuffer.currentSegment];
+        if (fence) {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, UploadFenceTimeout);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+        _uploadBuffer.segmentOffset = 0;
+    }
+
+    const size_t budget = static_cast<size_t>(_uploadBudget) * 1024;
+    size_t nUploadedBytes = 0;
+    while (!_uploadQueue.empty()) {
+        const RawTile& next = _uploadQueue.front().second;
+        const size_t nBytes =
+            next.textureInitData ? next.textureInitData->textureNumBytes : 0;
+        // Always upload at least one tile to prevent a tile that is larger than the
+        // budget from blocking the queue
+        if (budget > 0 && nUploadedBytes > 0 && nUploadedBytes + nBytes > budget) {
+            break;
+        }
+
+        std::pair<ProviderTileKey, RawTile> p = std::move(_uploadQueue.front());
+        _uploadQueue.pop_front();
+        _pendingUploads.erase(p.first);
+        createTileAndPut(std::move(p.first), std::move(p.second));
+        nUploadedBytes += nBytes;
+    }
+
+    if (_uploadBuffer.pbo != 0) {
+        if (_uploadBuffer.segmentOffset > 0) {
+            _uploadBuffer.fences[_uploadBuffer.currentSegment] = glFenceSync(
+                GL_SYNC_GPU_COMMANDS_COMPLETE,
+                GL_NONE_BIT
+            );
+        }
+        _uploadBuffer.currentSegment =
+            (_uploadBuffer.currentSegment + 1) % NumUploadSegments;
+    }
+
+    _uploadQueueDepth = static_cast<int>(_uploadQueue.size());
+}
+
 void MemoryAwareTileCache::update() {
+    if (nQueuedUploads() > 0) {
+        // The arriving tiles refine the globes even if nothing else changes
+        global::renderEngine.requestRedraw();
+    }
+    uploadQueuedTiles();
+
     const size_t dataSizeCPU = cpuAllocatedDataSize();
     const size_t dataSizeGPU = gpuAllocatedDataSize();
 
@@ -473,6 +812,78 @@ void MemoryAwareTileCache::update() {
 
     _cpuAllocatedTileData = static_cast<int>(dataSizeCPU / ByteToMegaByte);
     _gpuAllocatedTileData = static_cast<int>(dataSizeGPU / ByteToMegaByte);
+
+    using Resource = MemoryBudget::Resource;
+    global::memoryBudget.setUsage(_memoryBudgetClient, Resource::Cpu, dataSizeCPU);
+    global::memoryBudget.setUsage(_memoryBudgetClient, Resource::Gpu, dataSizeGPU);
+    _memoryAllowance = global::memoryBudget.allowance(_memoryBudgetClient, Resource::Gpu);
+
+    _frame++;
+}
+
+void MemoryAwareTileCache::shrink(MemoryBudget::Resource resource, size_t allowance) {
+    auto usage = [this, resource]() {
+        return resource == MemoryBudget::Resource::Cpu ?
+            cpuAllocatedDataSize() :
+            gpuAllocatedDataSize();
+    };
+
+    while (usage() > allowance) {
+        TextureContainerTileCache* victim = leastRecentlyUsedCache();
+        if (!victim) {
+            // Only the tiles that are currently rendered are left
+            break;
+        }
+        ghoul::opengl::Texture* texture = evictLeastRecentlyUsed(*victim);
+        reclaimPixelData(*texture, victim->first->tileTextureInitData());
+        victim->first->deallocateTexture(texture);
+    }
+
+    global::memoryBudget.setUsage(_memoryBudgetClient, resource, usage());
+}
+
+float MemoryAwareTileCache::occupancy() const {
+    if (_budget == 0) {
+        return 1.f;
+    }
+
+    size_t nPinnedBytes = 0;
+    for (const std::pair<const TileTextureInitData::HashKey,
+                         TextureContainerTileCache>& p : _textureContainerMap)
+    {
+        // The pinned tiles are the most recently used ones at the front of each cache
+        const size_t nBytes = p.second.first->tileTextureInitData().textureNumBytes;
+        for (const TileCache::Item& item : p.second.second->items()) {
+            if (!isPinned(item.first)) {
+                break;
+            }
+            nPinnedBytes += nBytes;
+        }
+    }
+    const float pinnedFraction =
+        static_cast<float>(nPinnedBytes) / static_cast<float>(_budget);
+    return std::min(pinnedFraction, 1.f);
+}
+
+MemoryAwareTileCache::ProviderStatistics MemoryAwareTileCache::statistics(
+                                                            unsigned int providerID) const
+{
+    const auto it = _statistics.find(providerID);
+    return it != _statistics.end() ? it->second : ProviderStatistics();
+}
+
+MemoryAwareTileCache::ProviderStatistics MemoryAwareTileCache::totalStatistics() const {
+    ProviderStatistics total;
+    for (const std::pair<const unsigned int, ProviderStatistics>& p : _statistics) {
+        total.nHits += p.second.nHits;
+        total.nMisses += p.second.nMisses;
+        total.nEvictions += p.second.nEvictions;
+    }
+    return total;
+}
+
+size_t MemoryAwareTileCache::nQueuedUploads() const {
+    return _uploadQueue.size();
 }
 
 size_t MemoryAwareTileCache::gpuAllocatedDataSize() const {
@@ -484,7 +895,8 @@ size_t MemoryAwareTileCache::gpuAllocatedDataSize() const {
         TextureContainerTileCache>& p)
         {
             const TextureContainer& textureContainer = *p.second.first;
-            const size_t nBytes = textureContainer.tileTextureInitData().totalNumBytes;
+            const size_t nBytes =
+                textureContainer.tileTextureInitData().textureNumBytes;
             return s + nBytes * textureContainer.size();
         }
     );
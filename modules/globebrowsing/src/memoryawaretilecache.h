@@ -26,23 +26,30 @@
 #define __OPENSPACE_MODULE_GLOBEBROWSING___MEMORY_AWARE_TILE_CACHE___H__
 
 #include <modules/globebrowsing/src/lrucache.h>
+#include <modules/globebrowsing/src/rawtile.h>
 #include <modules/globebrowsing/src/tileindex.h>
 #include <modules/globebrowsing/src/tiletextureinitdata.h>
 #include <openspace/properties/propertyowner.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/util/memorybudget.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <limits>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-namespace openspace::globebrowsing {
-    struct RawTile;
-    class Tile;
-} // namespace openspace::globebrowsing
+namespace openspace::globebrowsing { class Tile; }
 
 namespace openspace::globebrowsing::cache {
 
+class TileBufferPool;
+
 struct ProviderTileKey {
     TileIndex tileIndex;
     unsigned int providerID;
@@ -83,47 +90,134 @@ struct ProviderTileHasher {
     }
 };
 
+/**
+ * Caches the textures of the tiles of all tile providers within a single budget of GPU
+ * memory. The textures are created on demand for each texture type and once the budget
+ * is exhausted, the least recently used tile among all texture types is evicted. Tiles
+ * that have been used in the current or the previous frame are pinned and only evicted
+ * if no other tile can make room for a new tile.
+ */
 class MemoryAwareTileCache : public properties::PropertyOwner {
 public:
-    MemoryAwareTileCache(int tileCacheSize = 1024);
+    /**
+     * The cache usage of a single tile provider
+     */
+    struct ProviderStatistics {
+        uint64_t nHits = 0;
+        uint64_t nMisses = 0;
+        uint64_t nEvictions = 0;
+    };
+
+    /**
+     * \param tileCacheSize is the size of the cache in megabytes
+     * \param tileBufferPool receives the image data buffers of the tiles once they are
+     *        no longer needed, if it is not <code>nullptr</code>
+     */
+    MemoryAwareTileCache(int tileCacheSize = 1024,
+        TileBufferPool* tileBufferPool = nullptr);
+    ~MemoryAwareTileCache();
 
     void clear();
+
+    /**
+     * Sets the budget of GPU memory for the textures of all cached tiles to
+     * \p estimatedSize bytes and clears the cache.
+     */
     void setSizeEstimated(size_t estimatedSize);
     bool exist(const ProviderTileKey& key) const;
     Tile get(const ProviderTileKey& key);
     ghoul::opengl::Texture* texture(const TileTextureInitData& initData);
     void createTileAndPut(ProviderTileKey key, RawTile rawTile);
+
+    /**
+     * Queues the \p rawTile for being uploaded to the GPU. The queued tiles are uploaded
+     * in the order in which they were enqueued in subsequent calls to #update. Each call
+     * uploads at most as many bytes as the upload budget allows, but always at least one
+     * tile, so that a burst of finished tiles is spread out over multiple frames.
+     */
+    void enqueueTileUpload(ProviderTileKey key, RawTile rawTile);
+
+    /**
+     * \return <code>true</code> if the tile with the provided \p key has been enqueued
+     *         using #enqueueTileUpload, but has not been uploaded yet
+     */
+    bool isUploadPending(const ProviderTileKey& key) const;
+
     void put(const ProviderTileKey& key,
         const TileTextureInitData::HashKey& initDataKey, Tile tile);
+
+    /**
+     * Uploads the queued tiles that fit within the upload budget and updates the
+     * properties of this cache. Has to be called from the thread that owns the OpenGL
+     * context once every frame.
+     */
     void update();
 
     size_t gpuAllocatedDataSize() const;
     size_t cpuAllocatedDataSize() const;
 
+    /**
+     * \return The fraction of the budget that is used by the textures of the pinned
+     *         tiles, between 0 and 1. New tiles only evict other tiles as long as this
+     *         value is below 1
+     */
+    float occupancy() const;
+
+    /**
+     * Evicts the least recently used tiles that are not pinned until the usage of the
+     * \p resource is at most \p allowance bytes or only pinned tiles are left. This is
+     * called by the MemoryBudget if the caches of all modules exceed their budget.
+     */
+    void shrink(MemoryBudget::Resource resource, size_t allowance);
+
+    /**
+     * \return The number of cache hits, cache misses, and evicted tiles of the tile
+     *         provider with the provided \p providerID
+     */
+    ProviderStatistics statistics(unsigned int providerID) const;
+
+    /**
+     * \return The number of cache hits, cache misses, and evicted tiles summed over all
+     *         tile providers
+     */
+    ProviderStatistics totalStatistics() const;
+
+    /**
+     * \return The number of tiles that have been enqueued using #enqueueTileUpload and
+     *         are waiting for their upload to the GPU
+     */
+    size_t nQueuedUploads() const;
+
 private:
     /**
-     * Owner of texture data used for tiles. Instead of dynamically allocating textures
-     * one by one, they are created once and reused.
+     * Owner of texture data used for tiles of a single texture type. The textures are
+     * created when they are first needed and are reused for other tiles of the same type
+     * once their tile is evicted.
      */
     class TextureContainer {
     public:
         /**
          * \param initData is the description of the texture type.
-         * \param numTextures is the number of textures to allocate.
          */
-        TextureContainer(TileTextureInitData initData, size_t numTextures);
+        TextureContainer(TileTextureInitData initData);
 
         ~TextureContainer() = default;
 
+        /**
+         * Deletes all textures of this container.
+         */
         void reset();
-        void reset(size_t numTextures);
 
         /**
-         * \return A pointer to a texture if there is one texture never used before. If
-         *         there are no textures left, nullptr is returned. TextureContainer still
-         *         owns the texture so no delete should be called on the raw pointer.
+         * Creates a new texture of the type of this container. TextureContainer owns the
+         * texture so no delete should be called on the raw pointer.
          */
-        ghoul::opengl::Texture* getTextureIfFree();
+        ghoul::opengl::Texture* allocateTexture();
+
+        /**
+         * Deletes the \p texture, which must have been created by #allocateTexture.
+         */
+        void deallocateTexture(ghoul::opengl::Texture* texture);
 
         const TileTextureInitData& tileTextureInitData() const;
 
@@ -136,14 +230,44 @@ private:
         std::vector<std::unique_ptr<ghoul::opengl::Texture>> _textures;
 
         const TileTextureInitData _initData;
-        size_t _freeTexture = 0;
-        size_t _numTextures;
     };
 
 
+    /**
+     * Creates the persistently mapped pixel buffer that is used to stream the tile data
+     * to the GPU. The buffer is split into one segment per frame in flight, each large
+     * enough to hold the upload budget of one frame. If the OpenGL version does not
+     * support persistently mapped buffers, the tiles are uploaded directly instead.
+     */
+    void createUploadBuffer();
+    void destroyUploadBuffer();
+
+    /**
+     * Uploads the pixel data of the \p texture through the current segment of the
+     * upload buffer.
+     * \return <code>false</code> if the upload buffer is not available or the current
+     *         segment has no space left, in which case nothing was uploaded
+     */
+    bool uploadThroughPixelBuffer(ghoul::opengl::Texture& texture,
+        const TileTextureInitData& initData);
+
+    void uploadQueuedTiles();
+
+    /**
+     * Replaces the pixel data of the \p texture with the image data of the \p rawTile
+     * and returns the previous pixel data of the \p texture to the tile buffer pool.
+     */
+    void swapPixelData(ghoul::opengl::Texture& texture, RawTile& rawTile);
+
+    /**
+     * Takes the pixel data away from the \p texture and returns it to the tile buffer
+     * pool, if the texture owns pixel data of the size described by \p initData.
+     */
+    void reclaimPixelData(ghoul::opengl::Texture& texture,
+        const TileTextureInitData& initData);
+
     void createDefaultTextureContainers();
     void assureTextureContainerExists(const TileTextureInitData& initData);
-    void resetTextureContainerSize(size_t numTexturesPerTextureType);
 
     using TileCache = LRUCache<ProviderTileKey, Tile, ProviderTileHasher>;
     using TextureContainerTileCache = std::pair<
@@ -155,8 +279,50 @@ private:
         TextureContainerTileCache
     >;
 
+    /**
+     * \return The texture type whose least recently used tile is the least recently
+     *         used tile of all unpinned tiles, or <code>nullptr</code> if all tiles are
+     *         pinned
+     */
+    TextureContainerTileCache* leastRecentlyUsedCache();
+
+    /**
+     * Removes the least recently used tile of the \p cache and returns its texture.
+     */
+    ghoul::opengl::Texture* evictLeastRecentlyUsed(TextureContainerTileCache& cache);
+
+    bool isPinned(const ProviderTileKey& key) const;
+
     TextureContainerMap _textureContainerMap;
     size_t _numTextureBytesAllocatedOnCPU;
+    TileBufferPool* _tileBufferPool;
+
+    /// The maximum number of bytes used by the textures of all texture containers
+    size_t _budget = 0;
+
+    MemoryBudget::ClientId _memoryBudgetClient = 0;
+    /// The number of GPU bytes that the engine-wide MemoryBudget leaves for this cache
+    size_t _memoryAllowance = std::numeric_limits<size_t>::max();
+
+    /// Incremented with every call to #update and used to determine which tiles are
+    /// pinned
+    uint64_t _frame = 0;
+    std::unordered_map<ProviderTileKey, uint64_t, ProviderTileHasher> _lastUsedFrame;
+    std::unordered_map<unsigned int, ProviderStatistics> _statistics;
+
+    std::deque<std::pair<ProviderTileKey, RawTile>> _uploadQueue;
+    std::unordered_set<ProviderTileKey, ProviderTileHasher> _pendingUploads;
+
+    static constexpr const int NumUploadSegments = 3;
+    struct {
+        GLuint pbo = 0;
+        std::byte* mappedData = nullptr;
+        size_t segmentSize = 0;
+        int currentSegment = 0;
+        size_t segmentOffset = 0;
+        std::array<GLsync, NumUploadSegments> fences = {};
+        bool isDirty = true;
+    } _uploadBuffer;
 
     // Properties
     properties::IntProperty _cpuAllocatedTileData;
@@ -164,6 +330,8 @@ private:
     properties::IntProperty _tileCacheSize;
     properties::TriggerProperty _applyTileCacheSize;
     properties::TriggerProperty _clearTileCache;
+    properties::IntProperty _uploadBudget;
+    properties::IntProperty _uploadQueueDepth;
 };
 
 } // namespace openspace::globebrowsing::cache
@@ -45,9 +45,10 @@ public:
     PrioritizingConcurrentJobManager(LRUThreadPool<KeyType> pool);
 
     /**
-     * Enqueues a job which is identified using a given key
+     * Enqueues a job which is identified using a given key. Jobs with a higher
+     * \p priority are executed before jobs with a lower priority.
      */
-    void enqueueJob(std::shared_ptr<Job<P>> job, KeyType key);
+    void enqueueJob(std::shared_ptr<Job<P>> job, KeyType key, float priority = 0.f);
 
     /**
      * The keys returned by this function have been popped from the queue and corresponds
@@ -60,13 +61,20 @@ public:
     std::vector<KeyType> keysToEnqueuedJobs();
 
     /**
-     * Bumps the job identified with <code>key</code> to the beginning of the queue.
-     * In case the job was not already enqueued the function simply returns false and
-     * no state is changed.
+     * Bumps the job identified with <code>key</code> to the beginning of the queue and
+     * updates its priority. In case the job was not already enqueued the function
+     * simply returns false and no state is changed.
      * \param key is the identifier of the job to bump.
+     * \param priority is the new priority of the job
      * \returns true if the job was found, else returns false.
      */
-    bool touch(KeyType key);
+    bool touch(KeyType key, float priority = 0.f);
+
+    /**
+     * Removes all enqueued jobs that have neither been enqueued nor touched since the
+     * last call to this function. The removed jobs are reported as unfinished jobs.
+     */
+    void cancelStaleJobs();
 
     /**
      * Clear all enqueued jobs. Can not end jobs that workers are currently handling.
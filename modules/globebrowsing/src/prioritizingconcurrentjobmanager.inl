@@ -34,13 +34,13 @@ PrioritizingConcurrentJobManager<P, KeyType>::PrioritizingConcurrentJobManager(
 
 template <typename P, typename KeyType>
 void PrioritizingConcurrentJobManager<P, KeyType>::enqueueJob(std::shared_ptr<Job<P>> job,
-                                                              KeyType key)
+                                                              KeyType key, float priority)
 {
     _threadPool.enqueue([this, job]() {
         job->execute();
         std::lock_guard lock(_finishedJobsMutex);
         _finishedJobs.push(job);
-    }, key);
+    }, key, priority);
 }
 
 template <typename P, typename KeyType>
@@ -56,8 +56,13 @@ PrioritizingConcurrentJobManager<P, KeyType>::keysToEnqueuedJobs() {
 }
 
 template <typename P, typename KeyType>
-bool PrioritizingConcurrentJobManager<P, KeyType>::touch(KeyType key) {
-    return _threadPool.touch(key);
+bool PrioritizingConcurrentJobManager<P, KeyType>::touch(KeyType key, float priority) {
+    return _threadPool.touch(key, priority);
+}
+
+template <typename P, typename KeyType>
+void PrioritizingConcurrentJobManager<P, KeyType>::cancelStaleJobs() {
+    _threadPool.removeStaleTasks();
 }
 
 template <typename P, typename KeyType>
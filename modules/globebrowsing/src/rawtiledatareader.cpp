@@ -26,6 +26,7 @@
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
+#include <modules/globebrowsing/src/tilebufferpool.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/moduleengine.h>
 #include <ghoul/fmt.h>
@@ -52,6 +53,8 @@
 
 #include <algorithm>
 #include <fstream>
+#include <string_view>
+#include <thread>
 
 namespace openspace::globebrowsing {
 
@@ -121,28 +124,69 @@ enum class Side {
     Bottom
 };
 
-float interpretFloat(GLenum glType, const std::byte* src) {
-    switch (glType) {
-        case GL_UNSIGNED_BYTE:
-            return static_cast<float>(*reinterpret_cast<const GLubyte*>(src));
-        case GL_UNSIGNED_SHORT:
-            return static_cast<float>(*reinterpret_cast<const GLushort*>(src));
-        case GL_SHORT:
-            return static_cast<float>(*reinterpret_cast<const GLshort*>(src));
-        case GL_UNSIGNED_INT:
-            return static_cast<float>(*reinterpret_cast<const GLuint*>(src));
-        case GL_INT:
-            return static_cast<float>(*reinterpret_cast<const GLint*>(src));
-        case GL_HALF_FLOAT:
-            return static_cast<float>(*reinterpret_cast<const GLhalf*>(src));
-        case GL_FLOAT:
-            return static_cast<float>(*reinterpret_cast<const GLfloat*>(src));
-        case GL_DOUBLE:
-            return static_cast<float>(*reinterpret_cast<const GLdouble*>(src));
-        default:
-            ghoul_assert(false, "Unknown data type");
-            throw ghoul::MissingCaseException();
+// Computes the minimum and maximum value of one raster in a row of \p nPixels pixels,
+// each of which consists of \p stride values. Values that are equal to the
+// \p noDataValue or that are NaN are ignored. The loop contains no branches, so that the
+// compiler can vectorize it. Returns the number of values that are not missing
+template <typename T>
+int scanRasterRow(const T* row, int nPixels, size_t stride, float noDataValue,
+                   float& minValue, float& maxValue)
+{
+    float mn = minValue;
+    float mx = maxValue;
+    int nValid = 0;
+    for (int x = 0; x < nPixels; ++x) {
+        const float v = static_cast<float>(row[x * stride]);
+        const bool isValid = (v != noDataValue) & (v == v);
+        const float lo = isValid ? v : FLT_MAX;
+        const float hi = isValid ? v : -FLT_MAX;
+        mn = lo < mn ? lo : mn;
+        mx = hi > mx ? hi : mx;
+        nValid += isValid;
     }
+    minValue = mn;
+    maxValue = mx;
+    return nValid;
+}
+
+// Overwrites all missing values of one raster in a row with the lowest value of \p T
+template <typename T>
+void markMissingValues(T* row, int nPixels, size_t stride, float noDataValue) {
+    for (int x = 0; x < nPixels; ++x) {
+        const float v = static_cast<float>(row[x * stride]);
+        if (v == noDataValue || v != v) {
+            row[x * stride] = std::numeric_limits<T>::lowest();
+        }
+    }
+}
+
+// Computes the tile meta data in a single pass over each row of the tile and returns
+// whether any of the values in the tile were not missing
+template <typename T>
+bool scanTileMetaData(std::byte* data, const PixelRegion& region, size_t nRasters,
+                      size_t bytesPerLine, float noDataValue, TileMetaData& metaData)
+{
+    const int nPixels = region.numPixels.x;
+    bool hasValidValue = false;
+    for (int y = 0; y < region.numPixels.y; ++y) {
+        T* row = reinterpret_cast<T*>(data + y * bytesPerLine);
+        for (size_t raster = 0; raster < nRasters; ++raster) {
+            const int nValid = scanRasterRow(
+                row + raster,
+                nPixels,
+                nRasters,
+                noDataValue,
+                metaData.minValues[raster],
+                metaData.maxValues[raster]
+            );
+            hasValidValue |= (nValid > 0);
+            if (nValid != nPixels) {
+                metaData.hasMissingData[raster] = true;
+                markMissingValues(row + raster, nPixels, nRasters, noDataValue);
+            }
+        }
+    }
+    return hasValidValue;
 }
 
 GDALDataType toGDALDataType(GLenum glType) {
@@ -430,11 +474,7 @@ RawTileDataReader::RawTileDataReader(std::string filePath,
 }
 
 RawTileDataReader::~RawTileDataReader() {
-    std::lock_guard lockGuard(_datasetLock);
-    if (_dataset) {
-        GDALClose(_dataset);
-        _dataset = nullptr;
-    }
+    closeDatasetHandles();
 }
 
 void RawTileDataReader::initialize() {
@@ -443,6 +483,7 @@ void RawTileDataReader::initialize() {
     }
 
     GlobeBrowsingModule& module = *global::moduleEngine.module<GlobeBrowsingModule>();
+    _tileBufferPool = module.tileBufferPool();
 
     std::string content = _datasetFilePath;
     if (module.isWMSCachingEnabled()) {
@@ -519,6 +560,22 @@ void RawTileDataReader::initialize() {
         throw ghoul::RuntimeError("Failed to load dataset: " + _datasetFilePath);
     }
 
+    {
+        std::lock_guard lockGuard(_datasetLock);
+        _datasetOpenString = std::move(content);
+        _freeDatasetHandles = { _dataset };
+        _nDatasetHandles = 1;
+
+        // The WMS driver already requests multiple tiles in parallel and every handle
+        // would get its own connections and access to the same cache files, so only
+        // datasets that are read from disk get one handle per concurrent tile read
+        const char* driver = GDALGetDriverShortName(GDALGetDatasetDriver(_dataset));
+        const bool isWms = driver && std::string_view(driver) == "WMS";
+        _maxDatasetHandles = isWms ?
+            1 :
+            std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+
     // Assume all raster bands have the same data type
     _rasterCount = _dataset->GetRasterCount();
 
@@ -569,16 +626,73 @@ void RawTileDataReader::initialize() {
 }
 
 void RawTileDataReader::reset() {
-    std::lock_guard lockGuard(_datasetLock);
+    closeDatasetHandles();
     _maxChunkLevel = -1;
-    if (_dataset) {
-        GDALClose(_dataset);
-        _dataset = nullptr;
-    }
     initialize();
 }
 
-RawTile::ReadError RawTileDataReader::rasterRead(int rasterBand,
+GDALDataset* RawTileDataReader::acquireDatasetHandle() const {
+    std::unique_lock lock(_datasetLock);
+    _datasetHandleReleased.wait(lock, [this]() {
+        return !_freeDatasetHandles.empty() || _nDatasetHandles < _maxDatasetHandles;
+    });
+
+    if (!_freeDatasetHandles.empty()) {
+        GDALDataset* dataset = _freeDatasetHandles.back();
+        _freeDatasetHandles.pop_back();
+        return dataset;
+    }
+
+    // Reserve the new handle before opening the dataset outside of the lock, as that
+    // might take a while
+    ++_nDatasetHandles;
+    const std::string openString = _datasetOpenString;
+    lock.unlock();
+
+    GDALDataset* dataset = static_cast<GDALDataset*>(
+        GDALOpen(openString.c_str(), GA_ReadOnly)
+    );
+    if (dataset) {
+        return dataset;
+    }
+
+    // If the dataset cannot be opened again, we have to make do with the handles that
+    // we already have
+    LWARNINGC(_datasetFilePath, "Failed to open an additional handle to the dataset");
+    lock.lock();
+    --_nDatasetHandles;
+    _maxDatasetHandles = _nDatasetHandles;
+    _datasetHandleReleased.notify_all();
+    _datasetHandleReleased.wait(lock, [this]() { return !_freeDatasetHandles.empty(); });
+    GDALDataset* fallback = _freeDatasetHandles.back();
+    _freeDatasetHandles.pop_back();
+    return fallback;
+}
+
+void RawTileDataReader::releaseDatasetHandle(GDALDataset* dataset) const {
+    {
+        std::lock_guard lockGuard(_datasetLock);
+        _freeDatasetHandles.push_back(dataset);
+    }
+    // Both tile reads and closing all handles are waiting for released handles
+    _datasetHandleReleased.notify_all();
+}
+
+void RawTileDataReader::closeDatasetHandles() {
+    std::unique_lock lock(_datasetLock);
+    _datasetHandleReleased.wait(lock, [this]() {
+        return static_cast<int>(_freeDatasetHandles.size()) == _nDatasetHandles;
+    });
+
+    for (GDALDataset* dataset : _freeDatasetHandles) {
+        GDALClose(dataset);
+    }
+    _freeDatasetHandles.clear();
+    _nDatasetHandles = 0;
+    _dataset = nullptr;
+}
+
+RawTile::ReadError RawTileDataReader::rasterRead(GDALDataset& dataset, int rasterBand,
                                                  const IODescription& io,
                                                  char* dataDestination) const
 {
@@ -605,7 +719,7 @@ RawTile::ReadError RawTileDataReader::rasterRead(int rasterBand,
     dataDest -= io.write.region.start.y * io.write.bytesPerLine;
     dataDest += io.write.region.start.x * _initData.bytesPerPixel;
 
-    GDALRasterBand* gdalRasterBand = _dataset->GetRasterBand(rasterBand);
+    GDALRasterBand* gdalRasterBand = dataset.GetRasterBand(rasterBand);
     CPLErr readError = CE_Failure;
     readError = gdalRasterBand->RasterIO(
         GF_Read,
@@ -632,16 +746,46 @@ RawTile::ReadError RawTileDataReader::rasterRead(int rasterBand,
     }
 }
 
+const std::string& RawTileDataReader::datasetFilePath() const {
+    return _datasetFilePath;
+}
+
+const TileTextureInitData& RawTileDataReader::tileTextureInitData() const {
+    return _initData;
+}
+
+bool RawTileDataReader::performsPreprocessing() const {
+    return static_cast<bool>(_preprocess);
+}
+
 RawTile RawTileDataReader::readTileData(TileIndex tileIndex) const {
     size_t numBytes = _initData.totalNumBytes;
 
+    IODescription io = ioDescription(tileIndex);
+
     RawTile rawTile;
-    rawTile.imageData = std::unique_ptr<std::byte[]>(new std::byte[numBytes]);
-    memset(rawTile.imageData.get(), 0xFF, numBytes);
+    rawTile.imageData = _tileBufferPool ?
+        _tileBufferPool->acquire(_initData) :
+        std::unique_ptr<std::byte[]>(new std::byte[numBytes]);
+    if (!coversEntireTile(io)) {
+        // Parts of the tile that are not read from the dataset remain white
+        memset(rawTile.imageData.get(), 0xFF, numBytes);
+    }
 
-    IODescription io = ioDescription(tileIndex);
     RawTile::ReadError worstError = RawTile::ReadError::None;
-    readImageData(io, worstError, reinterpret_cast<char*>(rawTile.imageData.get()));
+    {
+        const auto release = [this](GDALDataset* d) { releaseDatasetHandle(d); };
+        std::unique_ptr<GDALDataset, decltype(release)> dataset(
+            acquireDatasetHandle(),
+            release
+        );
+        readImageData(
+            *dataset,
+            io,
+            worstError,
+            reinterpret_cast<char*>(rawTile.imageData.get())
+        );
+    }
 
     for (const MemoryLocation& ml : NoDataAvailableData) {
         std::byte* ptr = rawTile.imageData.get();
@@ -669,7 +813,49 @@ RawTile RawTileDataReader::readTileData(TileIndex tileIndex) const {
     return rawTile;
 }
 
-void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& worstError,
+bool RawTileDataReader::coversEntireTile(const IODescription& io) const {
+    // Reads that wrap around or are clamped at the edges of the dataset only write parts
+    // of the tile
+    if (!isInside(io.read.region, io.read.fullRegion)) {
+        return false;
+    }
+
+    // There must not be any padding between the pixels or the lines
+    const size_t nChannels = _initData.nRasters;
+    if (_initData.bytesPerPixel != nChannels * _initData.bytesPerDatum ||
+        _initData.bytesPerLine !=
+            static_cast<size_t>(_initData.dimensions.x) * _initData.bytesPerPixel)
+    {
+        return false;
+    }
+
+    // The number of channels that are written by readImageData
+    const int nRastersToRead = std::min(_rasterCount, static_cast<int>(nChannels));
+    size_t nWrittenChannels = 0;
+    switch (_initData.ghoulTextureFormat) {
+        case ghoul::opengl::Texture::Format::Red:
+            nWrittenChannels = 1;
+            break;
+        case ghoul::opengl::Texture::Format::RG:
+        case ghoul::opengl::Texture::Format::RGB:
+        case ghoul::opengl::Texture::Format::RGBA:
+            nWrittenChannels = nRastersToRead == 1 ? 3 :
+                nRastersToRead == 2 ? 4 : static_cast<size_t>(nRastersToRead);
+            break;
+        case ghoul::opengl::Texture::Format::BGR:
+        case ghoul::opengl::Texture::Format::BGRA:
+            nWrittenChannels = nRastersToRead == 1 ? 3 :
+                nRastersToRead == 2 ? 4 :
+                nRastersToRead > 3 ? 4 : 3;
+            break;
+        default:
+            return false;
+    }
+    return nWrittenChannels == nChannels;
+}
+
+void RawTileDataReader::readImageData(GDALDataset& dataset, IODescription& io,
+                                      RawTile::ReadError& worstError,
                                       char* imageDataDest) const
 {
     // Only read the minimum number of rasters
@@ -678,7 +864,7 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
     switch (_initData.ghoulTextureFormat) {
         case ghoul::opengl::Texture::Format::Red: {
             char* dest = imageDataDest;
-            const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+            const RawTile::ReadError err = repeatedRasterRead(dataset, 1, io, dest);
             worstError = std::max(worstError, err);
             break;
         }
@@ -690,7 +876,12 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
             }
@@ -699,12 +890,17 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = repeatedRasterRead(2, io, dest);
+                const RawTile::ReadError err = repeatedRasterRead(dataset, 2, io, dest);
                 worstError = std::max(worstError, err);
             }
             else { // Three or more rasters
@@ -712,7 +908,12 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(i + 1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        i + 1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
             }
@@ -725,7 +926,12 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
             }
@@ -734,12 +940,17 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = repeatedRasterRead(2, io, dest);
+                const RawTile::ReadError err = repeatedRasterRead(dataset, 2, io, dest);
                 worstError = std::max(worstError, err);
             }
             else { // Three or more rasters
@@ -747,14 +958,19 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(3 - i, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        3 - i,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
             }
             if (nRastersToRead > 3) { // Alpha channel exists
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = repeatedRasterRead(4, io, dest);
+                const RawTile::ReadError err = repeatedRasterRead(dataset, 4, io, dest);
                 worstError = std::max(worstError, err);
             }
             break;
@@ -814,7 +1030,8 @@ glm::ivec2 RawTileDataReader::fullPixelSize() const {
     return geodeticToPixel(Geodetic2{ 90.0, 180.0 }, _padfTransform);
 }
 
-RawTile::ReadError RawTileDataReader::repeatedRasterRead(int rasterBand,
+RawTile::ReadError RawTileDataReader::repeatedRasterRead(GDALDataset& dataset,
+                                                         int rasterBand,
                                                          const IODescription& fullIO,
                                                          char* dataDestination,
                                                          int depth) const
@@ -911,6 +1128,7 @@ RawTile::ReadError RawTileDataReader::repeatedRasterRead(int rasterBand,
                 // as we can see in this example, it still has a top part outside the
                 // defined gdal region. This is handled through recursion.
                 const RawTile::ReadError err = repeatedRasterRead(
+                    dataset,
                     rasterBand,
                     cutoff,
                     dataDestination,
@@ -922,7 +1140,7 @@ RawTile::ReadError RawTileDataReader::repeatedRasterRead(int rasterBand,
         }
     }
 
-    const RawTile::ReadError err = rasterRead(rasterBand, io, dataDestination);
+    const RawTile::ReadError err = rasterRead(dataset, rasterBand, io, dataDestination);
 
     // The return error from a repeated rasterRead is ONLY based on the main region,
     // which in the usual case will cover the main area of the patch anyway
@@ -939,49 +1157,59 @@ TileMetaData RawTileDataReader::tileMetaData(RawTile& rawTile,
     preprocessData.minValues.resize(_initData.nRasters);
     preprocessData.hasMissingData.resize(_initData.nRasters);
 
-    std::vector<float> noDataValues(_initData.nRasters);
     for (size_t raster = 0; raster < _initData.nRasters; ++raster) {
         preprocessData.maxValues[raster] = -FLT_MAX;
         preprocessData.minValues[raster] = FLT_MAX;
         preprocessData.hasMissingData[raster] = false;
-        noDataValues[raster] = noDataValueAsFloat();
     }
 
-    bool allIsMissing = true;
-    for (int y = 0; y < region.numPixels.y; ++y) {
-        const size_t yi = (region.numPixels.y - 1 - y) * bytesPerLine;
-        size_t i = 0;
-        for (int x = 0; x < region.numPixels.x; ++x) {
-            for (size_t raster = 0; raster < _initData.nRasters; ++raster) {
-                const float noDataValue = noDataValueAsFloat();
-                const float val = interpretFloat(
-                    _initData.glType,
-                    &(rawTile.imageData.get()[yi + i])
-                );
-                if (val != noDataValue && val == val) {
-                    preprocessData.maxValues[raster] = std::max(
-                        val,
-                        preprocessData.maxValues[raster]
-                    );
-                    preprocessData.minValues[raster] = std::min(
-                        val,
-                        preprocessData.minValues[raster]
-                    );
-                    allIsMissing = false;
-                }
-                else {
-                    preprocessData.hasMissingData[raster] = true;
-                    float& floatToRewrite = reinterpret_cast<float&>(
-                        rawTile.imageData[yi + i]
-                    );
-                    floatToRewrite = -std::numeric_limits<float>::max();
-                }
-                i += _initData.bytesPerDatum;
-            }
-        }
+    std::byte* data = rawTile.imageData.get();
+    const size_t nRasters = _initData.nRasters;
+    const float noData = noDataValueAsFloat();
+    bool hasValidValue = false;
+    switch (_initData.glType) {
+        case GL_UNSIGNED_BYTE:
+            hasValidValue = scanTileMetaData<GLubyte>(
+                data, region, nRasters, bytesPerLine, noData, preprocessData
+            );
+            break;
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+            hasValidValue = scanTileMetaData<GLushort>(
+                data, region, nRasters, bytesPerLine, noData, preprocessData
+            );
+            break;
+        case GL_SHORT:
+            hasValidValue = scanTileMetaData<GLshort>(
+                data, region, nRasters, bytesPerLine, noData, preprocessData
+            );
+            break;
+        case GL_UNSIGNED_INT:
+            hasValidValue = scanTileMetaData<GLuint>(
+                data, region, nRasters, bytesPerLine, noData, preprocessData
+            );
+            break;
+        case GL_INT:
+            hasValidValue = scanTileMetaData<GLint>(
+                data, region, nRasters, bytesPerLine, noData, preprocessData
+            );
+            break;
+        case GL_FLOAT:
+            hasValidValue = scanTileMetaData<GLfloat>(
+                data, region, nRasters, bytesPerLine, noData, preprocessData
+            );
+            break;
+        case GL_DOUBLE:
+            hasValidValue = scanTileMetaData<GLdouble>(
+                data, region, nRasters, bytesPerLine, noData, preprocessData
+            );
+            break;
+        default:
+            ghoul_assert(false, "Unknown data type");
+            throw ghoul::MissingCaseException();
     }
 
-    if (allIsMissing) {
+    if (!hasValidValue) {
         rawTile.error = RawTile::ReadError::Failure;
     }
 
@@ -29,8 +29,10 @@
 #include <modules/globebrowsing/src/rawtile.h>
 #include <modules/globebrowsing/src/tiletextureinitdata.h>
 #include <ghoul/misc/boolean.h>
+#include <condition_variable>
 #include <string>
 #include <mutex>
+#include <vector>
 #include <gdal.h>
 
 class GDALDataset;
@@ -38,6 +40,7 @@ class GDALRasterBand;
 
 namespace openspace::globebrowsing {
 
+namespace cache { class TileBufferPool; }
 class GeodeticPatch;
 
 class RawTileDataReader {
@@ -64,14 +67,31 @@ public:
     const TileDepthTransform& depthTransform() const;
     glm::ivec2 fullPixelSize() const;
 
+    const std::string& datasetFilePath() const;
+    const TileTextureInitData& tileTextureInitData() const;
+    bool performsPreprocessing() const;
+
 private:
     void initialize();
 
-    RawTile::ReadError rasterRead(int rasterBand, const IODescription& io,
-        char* dataDestination) const;
+    /**
+     * Returns a handle to the dataset that is not used by any other tile read and that
+     * has to be returned with #releaseDatasetHandle. New handles are opened lazily up to
+     * the maximum number of handles, so that each worker thread that reads tiles
+     * concurrently ends up with its own handle. If all handles are in use, this function
+     * blocks until one of them is released.
+     */
+    GDALDataset* acquireDatasetHandle() const;
+    void releaseDatasetHandle(GDALDataset* dataset) const;
+
+    /// Waits for all handles to be released and closes them
+    void closeDatasetHandles();
+
+    RawTile::ReadError rasterRead(GDALDataset& dataset, int rasterBand,
+        const IODescription& io, char* dataDestination) const;
 
-    void readImageData(IODescription& io, RawTile::ReadError& worstError,
-        char* imageDataDest) const;
+    void readImageData(GDALDataset& dataset, IODescription& io,
+        RawTile::ReadError& worstError, char* imageDataDest) const;
 
     IODescription ioDescription(const TileIndex& tileIndex) const;
 
@@ -79,14 +99,31 @@ private:
      * A recursive function that is able to perform wrapping in case the read region of
      * the given IODescription is outside of the given write region.
      */
-    RawTile::ReadError repeatedRasterRead(int rasterBand, const IODescription& fullIO,
-        char* dataDestination, int depth = 0) const;
+    RawTile::ReadError repeatedRasterRead(GDALDataset& dataset, int rasterBand,
+        const IODescription& fullIO, char* dataDestination, int depth = 0) const;
 
     TileMetaData tileMetaData(RawTile& rawTile, const PixelRegion& region) const;
 
+    /**
+     * Returns whether reading the tile described by \p io writes every byte of the tile
+     * buffer, in which case the buffer does not have to be cleared before the read
+     */
+    bool coversEntireTile(const IODescription& io) const;
+
     const std::string _datasetFilePath;
+
+    /// The string that is passed to GDAL to open a handle, including the WMS cache tags
+    std::string _datasetOpenString;
+
+    /// The first handle that is opened, which is used to read the dataset parameters
     GDALDataset* _dataset = nullptr;
 
+    /// The opened handles that are currently not used for any tile read
+    mutable std::vector<GDALDataset*> _freeDatasetHandles;
+    mutable int _nDatasetHandles = 0;
+    mutable int _maxDatasetHandles = 1;
+    mutable std::condition_variable _datasetHandleReleased;
+
     // Dataset parameters
     int _rasterCount;
     int _rasterXSize;
@@ -100,6 +137,8 @@ private:
     const PerformPreprocessing _preprocess;
     TileDepthTransform _depthTransform = { 0.f, 0.f };
 
+    cache::TileBufferPool* _tileBufferPool = nullptr;
+
     mutable std::mutex _datasetLock;
 };
 
@@ -34,6 +34,7 @@
 #include <openspace/engine/globals.h>
 #include <openspace/performance/performancemanager.h>
 #include <openspace/performance/performancemeasurement.h>
+#include <openspace/rendering/depthpyramid.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/time.h>
@@ -44,14 +45,28 @@
 #include <ghoul/opengl/textureunit.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
+#include <future>
+#include <memory_resource>
 #include <numeric>
+#include <optional>
 #include <queue>
+#include <thread>
 
 namespace {
     // Global flags to modify the RenderableGlobe
     constexpr const bool LimitLevelByAvailableData = true;
     constexpr const bool PerformFrustumCulling = true;
     constexpr const bool PreformHorizonCulling = true;
+    // Only applies if the renderer provides a depth pyramid, see RenderData
+    constexpr const bool PerformOcclusionCulling = true;
+
+    // The number of inactive layer configurations per globe whose programs are kept
+    constexpr const size_t MaxCachedShaderPermutations = 8;
+
+    // The number of height tiles per globe whose samples are kept on the CPU for height
+    // queries
+    constexpr const size_t HeightTileCacheSize = 256;
 
     // Shadow structure
     struct ShadowRenderingStruct {
@@ -84,7 +99,16 @@ namespace {
     // raycaster. We tried a simple solution that uses two grids and switches between
     // them at a cutoff level, and I think this might still be the best solution for the
     // time being.  --abock  2018-10-30
-    constexpr const int DefaultSkirtedGridSegments = 64;
+    // The coarser grids are therefore only used if AdaptiveGridResolution is enabled
+    constexpr const int DefaultSkirtedGridSegments =
+        openspace::globebrowsing::ChunkGridSegments[
+            openspace::globebrowsing::DefaultChunkGridLevel
+        ];
+
+    // A chunk that switched to a finer grid only switches back once the number of
+    // segments it needs is this fraction below the next coarser grid, which prevents
+    // chunks at the boundary from toggling between the two grids every frame
+    constexpr const double GridLevelHysteresis = 0.75;
     constexpr const int UnknownDesiredLevel = -1;
 
     const openspace::globebrowsing::GeodeticPatch Coverage =
@@ -175,6 +199,23 @@ namespace {
         "Enables the rendering of eclipse shadows using hard shadows"
     };
 
+    constexpr openspace::properties::Property::PropertyInfo AdaptiveGridResolutionInfo = {
+        "AdaptiveGridResolution",
+        "Adaptive Grid Resolution",
+        "If this value is enabled, the number of vertices of each chunk is chosen based "
+        "on its size on screen and the range of its heights, rather than using the same "
+        "grid for all chunks. Flat chunks are drawn with fewer vertices and chunks close "
+        "to the camera with more."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PixelsPerGridSegmentInfo = {
+        "PixelsPerGridSegment",
+        "Pixels per Grid Segment",
+        "If the adaptive grid resolution is enabled, this is the number of pixels that "
+        "a segment of the grid of a chunk should cover on screen. Smaller values result "
+        "in more vertices."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo TargetLodScaleFactorInfo = {
         "TargetLodScaleFactorInfo",
         "Target Level of Detail Scale Factor",
@@ -235,14 +276,31 @@ const Chunk& findChunkNode(const Chunk& node, const Geodetic2& location) {
     return *n;
 }
 
-std::vector<std::pair<ChunkTile, const LayerRenderSettings*>>
-tilesAndSettingsUnsorted(const LayerGroup& layerGroup, const TileIndex& tileIndex)
+// The tile lists are only needed while a single chunk is evaluated. As the chunks are
+// updated from several threads, the lists cannot live in the frame memory and are
+// instead placed in a small buffer on the stack of the calling function
+constexpr const size_t TileListBufferSize = 4096;
+
+std::pmr::vector<std::pair<ChunkTile, const LayerRenderSettings*>>
+tilesAndSettingsUnsorted(const LayerGroup& layerGroup, const TileIndex& tileIndex,
+                         float priority, tileprovider::ChunkTileResolver& resolver,
+                         std::pmr::memory_resource* memory)
 {
-    std::vector<std::pair<ChunkTile, const LayerRenderSettings*>> tilesAndSettings;
+    std::pmr::vector<std::pair<ChunkTile, const LayerRenderSettings*>> tilesAndSettings(
+        memory
+    );
+    tilesAndSettings.reserve(layerGroup.activeLayers().size());
     for (Layer* layer : layerGroup.activeLayers()) {
         if (layer->tileProvider()) {
             tilesAndSettings.emplace_back(
-                tileprovider::chunkTile(*layer->tileProvider(), tileIndex),
+                tileprovider::chunkTile(
+                    *layer->tileProvider(),
+                    tileIndex,
+                    0,
+                    1337,
+                    priority,
+                    &resolver
+                ),
                 &layer->renderSettings()
             );
         }
@@ -251,20 +309,28 @@ tilesAndSettingsUnsorted(const LayerGroup& layerGroup, const TileIndex& tileInde
     return tilesAndSettings;
 }
 
-BoundingHeights boundingHeightsForChunk(const Chunk& chunk, const LayerManager& lm) {
+BoundingHeights boundingHeightsForChunk(const Chunk& chunk, const LayerManager& lm,
+                                        tileprovider::ChunkTileResolver& resolver)
+{
     using ChunkTileSettingsPair = std::pair<ChunkTile, const LayerRenderSettings*>;
 
-    BoundingHeights boundingHeights { 0.f, 0.f, false, true };
+    BoundingHeights boundingHeights { 0.f, 0.f, false, true, true };
 
     // The raster of a height map is the first one. We assume that the height map is
     // a single raster image. If it is not we will just use the first raster
     // (that is channel 0).
     const size_t HeightChannel = 0;
     const LayerGroup& heightmaps = lm.layerGroup(layergroupid::GroupID::HeightLayers);
-    std::vector<ChunkTileSettingsPair> chunkTileSettingPairs = tilesAndSettingsUnsorted(
-        heightmaps,
-        chunk.tileIndex
-    );
+    std::array<std::byte, TileListBufferSize> buffer;
+    std::pmr::monotonic_buffer_resource memory(buffer.data(), buffer.size());
+    std::pmr::vector<ChunkTileSettingsPair> chunkTileSettingPairs =
+        tilesAndSettingsUnsorted(
+            heightmaps,
+            chunk.tileIndex,
+            chunk.tilePriority,
+            resolver,
+            &memory
+        );
 
     bool lastHadMissingData = true;
     for (const ChunkTileSettingsPair& chunkTileSettingsPair : chunkTileSettingPairs) {
@@ -273,6 +339,13 @@ BoundingHeights boundingHeightsForChunk(const Chunk& chunk, const LayerManager&
         const bool goodTile = (chunkTile.tile.status == Tile::Status::OK);
         const bool hasTileMetaData = chunkTile.tile.metaData.has_value();
 
+        // Heights that are based on a tile of a parent chunk will become more accurate
+        // once the tile of this chunk has been loaded
+        const bool isOwnTile = chunkTile.uvTransform.uvScale == glm::vec2(1.f);
+        if (!goodTile || !hasTileMetaData || !isOwnTile) {
+            boundingHeights.isFinal = false;
+        }
+
         if (goodTile && hasTileMetaData) {
             const TileMetaData& tileMetaData = chunkTile.tile.metaData.value();
 
@@ -313,13 +386,21 @@ BoundingHeights boundingHeightsForChunk(const Chunk& chunk, const LayerManager&
     return boundingHeights;
 }
 
-bool colorAvailableForChunk(const Chunk& chunk, const LayerManager& lm) {
+bool colorAvailableForChunk(const Chunk& chunk, const LayerManager& lm,
+                            tileprovider::ChunkTileResolver& resolver)
+{
     using ChunkTileSettingsPair = std::pair<ChunkTile, const LayerRenderSettings*>;
     const LayerGroup& colormaps = lm.layerGroup(layergroupid::GroupID::ColorLayers);
-    std::vector<ChunkTileSettingsPair> chunkTileSettingPairs = tilesAndSettingsUnsorted(
-        colormaps,
-        chunk.tileIndex
-    );
+    std::array<std::byte, TileListBufferSize> buffer;
+    std::pmr::monotonic_buffer_resource memory(buffer.data(), buffer.size());
+    std::pmr::vector<ChunkTileSettingsPair> chunkTileSettingPairs =
+        tilesAndSettingsUnsorted(
+            colormaps,
+            chunk.tileIndex,
+            chunk.tilePriority,
+            resolver,
+            &memory
+        );
 
     for (const ChunkTileSettingsPair& chunkTileSettingsPair : chunkTileSettingPairs) {
         const ChunkTile& chunkTile = chunkTileSettingsPair.first;
@@ -435,6 +516,8 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
         BoolProperty(AccurateNormalsInfo, false),
         BoolProperty(EclipseInfo, false),
         BoolProperty(EclipseHardShadowsInfo, false),
+        BoolProperty(AdaptiveGridResolutionInfo, false),
+        FloatProperty(PixelsPerGridSegmentInfo, 8.f, 1.f, 64.f),
         FloatProperty(TargetLodScaleFactorInfo, 15.f, 1.f, 50.f),
         FloatProperty(CurrentLodScaleFactorInfo, 15.f, 1.f, 50.f),
         FloatProperty(CameraMinHeightInfo, 100.f, 0.f, 1000.f),
@@ -442,9 +525,15 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
         IntProperty(NActiveLayersInfo, 0, 0, OpenGLCap.maxTextureUnits() / 3)
     })
     , _debugPropertyOwner({ "Debug" })
-    , _grid(DefaultSkirtedGridSegments, DefaultSkirtedGridSegments)
+    , _grids({
+        SkirtedGrid(ChunkGridSegments[0], ChunkGridSegments[0]),
+        SkirtedGrid(ChunkGridSegments[1], ChunkGridSegments[1]),
+        SkirtedGrid(ChunkGridSegments[2], ChunkGridSegments[2]),
+        SkirtedGrid(ChunkGridSegments[3], ChunkGridSegments[3])
+    })
     , _leftRoot(Chunk(LeftHemisphereIndex))
     , _rightRoot(Chunk(RightHemisphereIndex))
+    , _heightTileCache(HeightTileCacheSize)
 {
     _generalProperties.currentLodScaleFactor.setReadOnly(true);
 
@@ -475,6 +564,8 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
     addProperty(_generalProperties.useAccurateNormals);
     addProperty(_generalProperties.eclipseShadowsEnabled);
     addProperty(_generalProperties.eclipseHardShadows);
+    addProperty(_generalProperties.adaptiveGridResolution);
+    addProperty(_generalProperties.pixelsPerGridSegment);
     _generalProperties.targetLodScaleFactor.onChange([this]() {
         float sf = _generalProperties.targetLodScaleFactor;
         _generalProperties.currentLodScaleFactor = sf;
@@ -511,8 +602,11 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
     _layerManager.onChange([&](Layer* l) {
         _shadersNeedRecompilation = true;
         _chunkCornersDirty = true;
+        _chunkHeightsDirty = true;
         _nLayersIsDirty = true;
         _lastChangedLayer = l;
+        // The tile providers of removed layers might be reused for new layers
+        _heightTileCache.clear();
     });
 
     addPropertySubOwner(_debugPropertyOwner);
@@ -606,7 +700,9 @@ void RenderableGlobe::initializeGL() {
 
     _layerManager.update();
 
-    _grid.initializeGL();
+    for (SkirtedGrid& grid : _grids) {
+        grid.initializeGL();
+    }
     // Recompile the shaders directly so that it is not done the first time the render
     // function is called.
     recompileShaders();
@@ -617,6 +713,13 @@ void RenderableGlobe::deinitialize() {
 }
 
 void RenderableGlobe::deinitializeGL() {
+    for (ShaderPermutation& p : _shaderPermutations) {
+        global::renderEngine.removeRenderProgram(p.localProgram.get());
+        global::renderEngine.removeRenderProgram(p.globalProgram.get());
+    }
+    _shaderPermutations.clear();
+    _currentPermutationKey.clear();
+
     if (_localRenderer.program) {
         global::renderEngine.removeRenderProgram(_localRenderer.program.get());
         _localRenderer.program = nullptr;
@@ -627,7 +730,9 @@ void RenderableGlobe::deinitializeGL() {
         _globalRenderer.program = nullptr;
     }
 
-    _grid.deinitializeGL();
+    for (SkirtedGrid& grid : _grids) {
+        grid.deinitializeGL();
+    }
 }
 
 bool RenderableGlobe::isReady() const {
@@ -683,37 +788,28 @@ void RenderableGlobe::render(const RenderData& data, RendererTasks& rendererTask
 }
 
 void RenderableGlobe::update(const UpdateData& data) {
+    _chunkTreeNeedsUpdate = true;
+
     if (_localRenderer.program && _localRenderer.program->isDirty()) {
         _localRenderer.program->rebuildFromFile();
 
-        _localRenderer.program->setUniform("xSegments", _grid.xSegments);
-
-        if (_debugProperties.showHeightResolution) {
-            _localRenderer.program->setUniform(
-                "vertexResolution",
-                glm::vec2(_grid.xSegments, _grid.ySegments)
-            );
-        }
-
         ghoul::opengl::updateUniformLocations(
             *_localRenderer.program,
             _localRenderer.uniformCache,
             { "skirtLength", "p01", "p11", "p00", "p10", "patchNormalModelSpace",
               "patchNormalCameraSpace" }
         );
+        ghoul::opengl::updateUniformLocations(
+            *_localRenderer.program,
+            _localRenderer.commonUniformCache.locations,
+            { "chunkLevel", "deltaTheta0", "deltaTheta1", "deltaPhi0", "deltaPhi1",
+              "tileDelta", "heightScale", "xSegments" }
+        );
     }
 
     if (_globalRenderer.program && _globalRenderer.program->isDirty()) {
         _globalRenderer.program->rebuildFromFile();
 
-        _globalRenderer.program->setUniform("xSegments", _grid.xSegments);
-
-        if (_debugProperties.showHeightResolution) {
-            _globalRenderer.program->setUniform(
-                "vertexResolution",
-                glm::vec2(_grid.xSegments, _grid.ySegments)
-            );
-        }
         // Ellipsoid Radius (Model Space)
         _globalRenderer.program->setUniform(
             "radiiSquared",
@@ -725,6 +821,12 @@ void RenderableGlobe::update(const UpdateData& data) {
             _globalRenderer.uniformCache,
             { "skirtLength", "minLatLon", "lonLatScalingFactor" }
         );
+        ghoul::opengl::updateUniformLocations(
+            *_globalRenderer.program,
+            _globalRenderer.commonUniformCache.locations,
+            { "chunkLevel", "deltaTheta0", "deltaTheta1", "deltaPhi0", "deltaPhi1",
+              "tileDelta", "heightScale", "xSegments" }
+        );
     }
 
     setBoundingSphere(static_cast<float>(
@@ -855,14 +957,26 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&) {
         _localRenderer.updatedSinceLastCall = false;
     }
 
-    _allChunksAvailable = true;
-    updateChunkTree(_leftRoot, data);
-    updateChunkTree(_rightRoot, data);
-    _chunkCornersDirty = false;
-    _iterationsOfAvailableData =
-        (_allChunksAvailable ? _iterationsOfAvailableData + 1 : 0);
-    _iterationsOfUnavailableData =
-        (_allChunksAvailable ? 0 : _iterationsOfUnavailableData + 1);
+    // Stereo eyes, additional viewports, and the faces of a fisheye rendering are all
+    // rendered from the same camera position in a frame, so only the first of them has
+    // to evaluate the tree; the others only need their own visibility
+    _renderingResolution = global::renderEngine.renderingResolution();
+    if (_chunkTreeNeedsUpdate) {
+        // The tiles of the previous frame might have been uploaded or evicted since
+        _tileResolver.clear();
+        _allChunksAvailable = true;
+        updateChunkTree(data);
+        _chunkCornersDirty = false;
+        _chunkHeightsDirty = false;
+        _iterationsOfAvailableData =
+            (_allChunksAvailable ? _iterationsOfAvailableData + 1 : 0);
+        _iterationsOfUnavailableData =
+            (_allChunksAvailable ? 0 : _iterationsOfUnavailableData + 1);
+        _chunkTreeNeedsUpdate = false;
+    }
+    else {
+        updateChunkVisibility(data);
+    }
 
     // Calculate the MVP matrix
     const glm::dmat4& viewTransform = data.camera.combinedViewMatrix();
@@ -984,10 +1098,10 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&) {
     std::array<const Chunk*, ChunkBufferSize> local;
     int localCount = 0;
 
-    auto traversal = [&global, &globalCount, &local, &localCount,
+    auto traversal = [&global, &globalCount, &local, &localCount, &data,
           cutoff = _debugProperties.modelSpaceRenderingCutoffLevel](const Chunk& node)
     {
-        std::vector<const Chunk*> Q;
+        std::pmr::vector<const Chunk*> Q(data.frameMemory);
         Q.reserve(256);
 
         // Loop through nodes in breadths first order
@@ -1019,18 +1133,57 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&) {
     traversal(_leftRoot);
     traversal(_rightRoot);
 
+    // The state and uniforms that do not depend on the chunk are only set once for each
+    // renderer, so that the per-chunk work is restricted to what is really changing
+    const glm::dmat4 modelViewTransform =
+        glm::dmat4(data.camera.combinedViewMatrix()) * _cachedModelTransform;
+    const bool hasHeightLayers =
+        !_layerManager.layerGroup(layergroupid::HeightLayers).activeLayers().empty();
+    const bool useAccurateNormals =
+        _generalProperties.useAccurateNormals && hasHeightLayers;
+    constexpr const float TileDelta = 1.f / DefaultSkirtedGridSegments;
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+
     // Render all chunks that want to be rendered globally
     _globalRenderer.program->activate();
+    if (useAccurateNormals) {
+        _globalRenderer.program->setUniform(
+            _globalRenderer.commonUniformCache.locations.tileDelta,
+            TileDelta
+        );
+    }
     for (int i = 0; i < std::min(globalCount, ChunkBufferSize); ++i) {
-        renderChunkGlobally(*global[i], data);
+        renderChunkGlobally(*global[i], data, modelViewTransform);
+    }
+    for (GPULayerGroup& l : _globalRenderer.gpuLayerGroups) {
+        l.deactivate();
     }
     _globalRenderer.program->deactivate();
 
 
     // Render all chunks that need to be rendered locally
     _localRenderer.program->activate();
+    if (hasHeightLayers) {
+        // Apply an extra scaling to the height if the object is scaled
+        _localRenderer.program->setUniform(
+            _localRenderer.commonUniformCache.locations.heightScale,
+            static_cast<float>(data.modelTransform.scale * data.camera.scaling())
+        );
+    }
+    if (useAccurateNormals) {
+        _localRenderer.program->setUniform(
+            _localRenderer.commonUniformCache.locations.tileDelta,
+            TileDelta
+        );
+    }
     for (int i = 0; i < std::min(localCount, ChunkBufferSize); ++i) {
-        renderChunkLocally(*local[i], data);
+        renderChunkLocally(*local[i], data, modelViewTransform);
+    }
+    for (GPULayerGroup& l : _localRenderer.gpuLayerGroups) {
+        l.deactivate();
     }
     _localRenderer.program->deactivate();
 
@@ -1079,7 +1232,9 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&) {
     }
 }
 
-void RenderableGlobe::renderChunkGlobally(const Chunk& chunk, const RenderData& data) {
+void RenderableGlobe::renderChunkGlobally(const Chunk& chunk, const RenderData& data,
+                                          const glm::dmat4& modelViewTransform)
+{
     //PerfMeasure("globally");
     const TileIndex& tileIndex = chunk.tileIndex;
     ghoul::opengl::ProgramObject& program = *_globalRenderer.program;
@@ -1087,7 +1242,13 @@ void RenderableGlobe::renderChunkGlobally(const Chunk& chunk, const RenderData&
     const std::array<LayerGroup*, LayerManager::NumLayerGroups>& layerGroups =
         _layerManager.layerGroups();
     for (size_t i = 0; i < layerGroups.size(); ++i) {
-        _globalRenderer.gpuLayerGroups[i].setValue(program, *layerGroups[i], tileIndex);
+        _globalRenderer.gpuLayerGroups[i].setValue(
+            program,
+            *layerGroups[i],
+            tileIndex,
+            chunk.tilePriority,
+            &_tileResolver
+        );
     }
 
     // The length of the skirts is proportional to its size
@@ -1102,7 +1263,10 @@ void RenderableGlobe::renderChunkGlobally(const Chunk& chunk, const RenderData&
     );
 
     if (_layerManager.hasAnyBlendingLayersEnabled()) {
-        program.setUniform("chunkLevel", chunk.tileIndex.level);
+        program.setUniform(
+            _globalRenderer.commonUniformCache.locations.chunkLevel,
+            chunk.tileIndex.level
+        );
     }
 
     // Calculate other uniform variables needed for rendering
@@ -1118,7 +1282,12 @@ void RenderableGlobe::renderChunkGlobally(const Chunk& chunk, const RenderData&
         glm::vec2(patchSize.lon, patchSize.lat)
     );
 
-    setCommonUniforms(program, chunk, data);
+    setCommonUniforms(
+        program,
+        _globalRenderer.commonUniformCache,
+        chunk,
+        modelViewTransform
+    );
 
     if (_generalProperties.eclipseShadowsEnabled &&
         !_ellipsoid.shadowConfigurationArray().empty())
@@ -1126,17 +1295,12 @@ void RenderableGlobe::renderChunkGlobally(const Chunk& chunk, const RenderData&
         calculateEclipseShadows(program, data, ShadowCompType::GLOBAL_SHADOW);
     }
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
-    _grid.drawUsingActiveProgram();
-    for (GPULayerGroup& l : _globalRenderer.gpuLayerGroups) {
-        l.deactivate();
-    }
+    _grids[chunk.gridLevel].drawUsingActiveProgram();
 }
 
-void RenderableGlobe::renderChunkLocally(const Chunk& chunk, const RenderData& data) {
+void RenderableGlobe::renderChunkLocally(const Chunk& chunk, const RenderData& data,
+                                         const glm::dmat4& modelViewTransform)
+{
     //PerfMeasure("locally");
     const TileIndex& tileIndex = chunk.tileIndex;
     ghoul::opengl::ProgramObject& program = *_localRenderer.program;
@@ -1144,7 +1308,13 @@ void RenderableGlobe::renderChunkLocally(const Chunk& chunk, const RenderData& d
     const std::array<LayerGroup*, LayerManager::NumLayerGroups>& layerGroups =
         _layerManager.layerGroups();
     for (size_t i = 0; i < layerGroups.size(); ++i) {
-        _localRenderer.gpuLayerGroups[i].setValue(program, *layerGroups[i], tileIndex);
+        _localRenderer.gpuLayerGroups[i].setValue(
+            program,
+            *layerGroups[i],
+            tileIndex,
+            chunk.tilePriority,
+            &_tileResolver
+        );
     }
 
     // The length of the skirts is proportional to its size
@@ -1159,15 +1329,13 @@ void RenderableGlobe::renderChunkLocally(const Chunk& chunk, const RenderData& d
     );
 
     if (_layerManager.hasAnyBlendingLayersEnabled()) {
-        program.setUniform("chunkLevel", chunk.tileIndex.level);
+        program.setUniform(
+            _localRenderer.commonUniformCache.locations.chunkLevel,
+            chunk.tileIndex.level
+        );
     }
 
     // Calculate other uniform variables needed for rendering
-    // Send the matrix inverse to the fragment for the global and local shader (JCC)
-    const glm::dmat4 viewTransform = data.camera.combinedViewMatrix();
-    const glm::dmat4 modelViewTransform = viewTransform * _cachedModelTransform;
-
-
     std::array<glm::dvec3, 4> cornersCameraSpace;
     std::array<glm::dvec3, 4> cornersModelSpace;
     for (int i = 0; i < 4; ++i) {
@@ -1224,15 +1392,12 @@ void RenderableGlobe::renderChunkLocally(const Chunk& chunk, const RenderData& d
         patchNormalCameraSpace
     );
 
-    if (!_layerManager.layerGroup(layergroupid::HeightLayers).activeLayers().empty()) {
-        // Apply an extra scaling to the height if the object is scaled
-        program.setUniform(
-            "heightScale",
-            static_cast<float>(data.modelTransform.scale * data.camera.scaling())
-        );
-    }
-
-    setCommonUniforms(program, chunk, data);
+    setCommonUniforms(
+        program,
+        _localRenderer.commonUniformCache,
+        chunk,
+        modelViewTransform
+    );
 
     if (_generalProperties.eclipseShadowsEnabled &&
         !_ellipsoid.shadowConfigurationArray().empty())
@@ -1240,15 +1405,7 @@ void RenderableGlobe::renderChunkLocally(const Chunk& chunk, const RenderData& d
         calculateEclipseShadows(program, data, ShadowCompType::LOCAL_SHADOW);
     }
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
-    _grid.drawUsingActiveProgram();
-
-    for (GPULayerGroup& l : _localRenderer.gpuLayerGroups) {
-        l.deactivate();
-    }
+    _grids[chunk.gridLevel].drawUsingActiveProgram();
 }
 
 void RenderableGlobe::debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp,
@@ -1291,8 +1448,19 @@ void RenderableGlobe::debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp
 //////////////////////////////////////////////////////////////////////////////////////////
 
 void RenderableGlobe::setCommonUniforms(ghoul::opengl::ProgramObject& programObject,
-    const Chunk& chunk, const RenderData& data)
+                                        const CommonUniformCache& uniformCache,
+                                        const Chunk& chunk,
+                                        const glm::dmat4& modelViewTransform)
 {
+    const SkirtedGrid& grid = _grids[chunk.gridLevel];
+    programObject.setUniform(uniformCache.locations.xSegments, grid.xSegments);
+    if (_debugProperties.showHeightResolution) {
+        programObject.setUniform(
+            "vertexResolution",
+            glm::vec2(grid.xSegments, grid.ySegments)
+        );
+    }
+
     if (_generalProperties.useAccurateNormals &&
         !_layerManager.layerGroup(layergroupid::HeightLayers).activeLayers().empty())
     {
@@ -1309,11 +1477,7 @@ void RenderableGlobe::setCommonUniforms(ghoul::opengl::ProgramObject& programObj
             chunk.surfacePatch.corner(Quad::NORTH_EAST)
         );
 
-        const glm::mat4 modelViewTransform = glm::mat4(
-            data.camera.combinedViewMatrix() * _cachedModelTransform
-        );
-
-        const glm::mat3& modelViewTransformMat3 = glm::mat3(modelViewTransform);
+        const glm::mat3 modelViewTransformMat3 = glm::mat3(modelViewTransform);
 
         // This is an assumption that the height tile has a resolution of 64 * 64
         // If it does not it will still produce "correct" normals. If the resolution is
@@ -1329,12 +1493,12 @@ void RenderableGlobe::setCommonUniforms(ghoul::opengl::ProgramObject& programObj
         const glm::vec3 deltaPhi1 = modelViewTransformMat3 *
             (glm::vec3(corner11 - corner10) * TileDelta);
 
-        // Upload uniforms
-        programObject.setUniform("deltaTheta0", glm::length(deltaTheta0));
-        programObject.setUniform("deltaTheta1", glm::length(deltaTheta1));
-        programObject.setUniform("deltaPhi0", glm::length(deltaPhi0));
-        programObject.setUniform("deltaPhi1", glm::length(deltaPhi1));
-        programObject.setUniform("tileDelta", TileDelta);
+        // Upload uniforms. The tileDelta is constant and set once for all chunks
+        const auto& uc = uniformCache.locations;
+        programObject.setUniform(uc.deltaTheta0, glm::length(deltaTheta0));
+        programObject.setUniform(uc.deltaTheta1, glm::length(deltaTheta1));
+        programObject.setUniform(uc.deltaPhi0, glm::length(deltaPhi0));
+        programObject.setUniform(uc.deltaPhi1, glm::length(deltaPhi1));
     }
 }
 
@@ -1499,26 +1663,71 @@ void RenderableGlobe::recompileShaders() {
     }
 
     //
-    // Create local shader
+    // Reuse the programs of an earlier layer configuration if possible
     //
-    global::renderEngine.removeRenderProgram(_localRenderer.program.get());
-    _localRenderer.program = global::renderEngine.buildRenderProgram(
-        "LocalChunkedLodPatch",
-        absPath("${MODULE_GLOBEBROWSING}/shaders/localrenderer_vs.glsl"),
-        absPath("${MODULE_GLOBEBROWSING}/shaders/renderer_fs.glsl"),
-        shaderDictionary
+
+    // The key contains everything that the shader dictionary depends on
+    std::string key;
+    for (const LayerShaderPreprocessingData::LayerGroupPreprocessingData& info :
+         preprocessingData.layeredTextureInfo)
+    {
+        key += fmt::format("{}|{}", info.lastLayerIdx, info.layerBlendingEnabled);
+        for (size_t j = 0; j < info.layerType.size(); ++j) {
+            key += fmt::format(
+                "|{},{},{}",
+                static_cast<int>(info.layerType[j]),
+                static_cast<int>(info.blendMode[j]),
+                static_cast<int>(info.layerAdjustmentType[j])
+            );
+        }
+        key += ';';
+    }
+    for (const std::pair<std::string, std::string>& p : preprocessingData.keyValuePairs)
+    {
+        key += p.first + '=' + p.second + ';';
+    }
+
+    if (_localRenderer.program && _globalRenderer.program) {
+        _shaderPermutations.push_front({
+            std::move(_currentPermutationKey),
+            std::move(_localRenderer.program),
+            std::move(_globalRenderer.program)
+        });
+    }
+
+    const auto cached = std::find_if(
+        _shaderPermutations.begin(),
+        _shaderPermutations.end(),
+        [&key](const ShaderPermutation& p) { return p.key == key; }
     );
-    ghoul_assert(_localRenderer.program, "Failed to initialize programObject!");
-    _localRenderer.updatedSinceLastCall = true;
+    if (cached != _shaderPermutations.end()) {
+        _localRenderer.program = std::move(cached->localProgram);
+        _globalRenderer.program = std::move(cached->globalProgram);
+        _shaderPermutations.erase(cached);
+    }
 
-    _localRenderer.program->setUniform("xSegments", _grid.xSegments);
+    while (_shaderPermutations.size() > MaxCachedShaderPermutations) {
+        ShaderPermutation& p = _shaderPermutations.back();
+        global::renderEngine.removeRenderProgram(p.localProgram.get());
+        global::renderEngine.removeRenderProgram(p.globalProgram.get());
+        _shaderPermutations.pop_back();
+    }
+    _currentPermutationKey = std::move(key);
 
-    if (_debugProperties.showHeightResolution) {
-        _localRenderer.program->setUniform(
-            "vertexResolution",
-            glm::vec2(_grid.xSegments, _grid.ySegments)
+    //
+    // Create local shader
+    //
+    if (!_localRenderer.program) {
+        _localRenderer.program = global::renderEngine.buildRenderProgram(
+            "LocalChunkedLodPatch",
+            absPath("${MODULE_GLOBEBROWSING}/shaders/localrenderer_vs.glsl"),
+            absPath("${MODULE_GLOBEBROWSING}/shaders/renderer_fs.glsl"),
+            shaderDictionary
         );
     }
+    ghoul_assert(_localRenderer.program, "Failed to initialize programObject!");
+    _localRenderer.updatedSinceLastCall = true;
+
 
     ghoul::opengl::updateUniformLocations(
         *_localRenderer.program,
@@ -1526,28 +1735,27 @@ void RenderableGlobe::recompileShaders() {
         { "skirtLength", "p01", "p11", "p00", "p10", "patchNormalModelSpace",
           "patchNormalCameraSpace" }
     );
+    ghoul::opengl::updateUniformLocations(
+        *_localRenderer.program,
+        _localRenderer.commonUniformCache.locations,
+        { "chunkLevel", "deltaTheta0", "deltaTheta1", "deltaPhi0", "deltaPhi1",
+          "tileDelta", "heightScale", "xSegments" }
+    );
 
 
     //
     // Create global shader
     //
-    global::renderEngine.removeRenderProgram(_globalRenderer.program.get());
-    _globalRenderer.program = global::renderEngine.buildRenderProgram(
-        "GlobalChunkedLodPatch",
-        absPath("${MODULE_GLOBEBROWSING}/shaders/globalrenderer_vs.glsl"),
-        absPath("${MODULE_GLOBEBROWSING}/shaders/renderer_fs.glsl"),
-        shaderDictionary
-    );
-    ghoul_assert(_globalRenderer.program, "Failed to initialize programObject!");
-
-    _globalRenderer.program->setUniform("xSegments", _grid.xSegments);
-
-    if (_debugProperties.showHeightResolution) {
-        _globalRenderer.program->setUniform(
-            "vertexResolution",
-            glm::vec2(_grid.xSegments, _grid.ySegments)
+    if (!_globalRenderer.program) {
+        _globalRenderer.program = global::renderEngine.buildRenderProgram(
+            "GlobalChunkedLodPatch",
+            absPath("${MODULE_GLOBEBROWSING}/shaders/globalrenderer_vs.glsl"),
+            absPath("${MODULE_GLOBEBROWSING}/shaders/renderer_fs.glsl"),
+            shaderDictionary
         );
     }
+    ghoul_assert(_globalRenderer.program, "Failed to initialize programObject!");
+
     // Ellipsoid Radius (Model Space)
     _globalRenderer.program->setUniform(
         "radiiSquared",
@@ -1559,6 +1767,12 @@ void RenderableGlobe::recompileShaders() {
         _globalRenderer.uniformCache,
         { "skirtLength", "minLatLon", "lonLatScalingFactor" }
     );
+    ghoul::opengl::updateUniformLocations(
+        *_globalRenderer.program,
+        _globalRenderer.commonUniformCache.locations,
+        { "chunkLevel", "deltaTheta0", "deltaTheta1", "deltaPhi0", "deltaPhi1",
+          "tileDelta", "heightScale", "xSegments" }
+    );
 
     _globalRenderer.updatedSinceLastCall = true;
     _shadersNeedRecompilation = false;
@@ -1566,6 +1780,30 @@ void RenderableGlobe::recompileShaders() {
 
 SurfacePositionHandle RenderableGlobe::calculateSurfacePositionHandle(
                                                  const glm::dvec3& targetModelSpace) const
+{
+    return surfacePositionHandle(targetModelSpace, getHeight(targetModelSpace));
+}
+
+std::vector<SurfacePositionHandle> RenderableGlobe::calculateSurfacePositionHandles(
+                                  const std::vector<glm::dvec3>& targetsModelSpace) const
+{
+    const std::vector<Layer*>& heightLayers =
+        _layerManager.layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
+    const uint64_t frame = global::renderEngine.frameNumber();
+
+    std::vector<SurfacePositionHandle> handles;
+    handles.reserve(targetsModelSpace.size());
+    for (const glm::dvec3& target : targetsModelSpace) {
+        handles.push_back(
+            surfacePositionHandle(target, getHeight(target, heightLayers, frame))
+        );
+    }
+    return handles;
+}
+
+SurfacePositionHandle RenderableGlobe::surfacePositionHandle(
+                                                       const glm::dvec3& targetModelSpace,
+                                                        double heightToSurface) const
 {
     glm::dvec3 centerToEllipsoidSurface =
         _ellipsoid.geodeticSurfaceProjection(targetModelSpace);
@@ -1578,7 +1816,6 @@ SurfacePositionHandle RenderableGlobe::calculateSurfacePositionHandle(
         ellipsoidSurfaceOutDirection *= -1.0;
     }
 
-    double heightToSurface = getHeight(targetModelSpace);
     heightToSurface = glm::isnan(heightToSurface) ? 0.0 : heightToSurface;
     centerToEllipsoidSurface = glm::isnan(glm::length(centerToEllipsoidSurface)) ?
         (glm::dvec3(0.0, 1.0, 0.0) * static_cast<double>(boundingSphere())) :
@@ -1607,7 +1844,7 @@ int RenderableGlobe::desiredLevel(const Chunk& chunk, const RenderData& renderDa
     const int desiredLevel = _debugProperties.levelByProjectedAreaElseDistance ?
         desiredLevelByProjectedArea(chunk, renderData, heights) :
         desiredLevelByDistance(chunk, renderData, heights);
-    const int levelByAvailableData = desiredLevelByAvailableTileData(chunk);
+    const int levelByAvailableData = chunk.levelByAvailableData;
 
     if (LimitLevelByAvailableData && (levelByAvailableData != UnknownDesiredLevel)) {
         const int l = glm::min(desiredLevel, levelByAvailableData);
@@ -1619,6 +1856,15 @@ int RenderableGlobe::desiredLevel(const Chunk& chunk, const RenderData& renderDa
 }
 
 float RenderableGlobe::getHeight(const glm::dvec3& position) const {
+    const std::vector<Layer*>& heightLayers =
+        _layerManager.layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
+    return getHeight(position, heightLayers, global::renderEngine.frameNumber());
+}
+
+float RenderableGlobe::getHeight(const glm::dvec3& position,
+                                 const std::vector<Layer*>& heightLayers,
+                                 uint64_t frame) const
+{
     float height = 0;
 
     // Get the uv coordinates to sample from
@@ -1661,94 +1907,36 @@ float RenderableGlobe::getHeight(const glm::dvec3& position) const {
         geoDiffPoint.lat / geoDiffPatch.lat
     );
 
-    // Get the tile providers for the height maps
-    const std::vector<Layer*>& heightMapLayers =
-        _layerManager.layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
-
-    for (Layer* layer : heightMapLayers) {
+    for (Layer* layer : heightLayers) {
         tileprovider::TileProvider* tileProvider = layer->tileProvider();
         if (!tileProvider) {
             continue;
         }
-        // Transform the uv coordinates to the current tile texture
-        const ChunkTile chunkTile = tileprovider::chunkTile(*tileProvider, tileIndex);
-        const Tile& tile = chunkTile.tile;
-        const TileUvTransform& uvTransform = chunkTile.uvTransform;
-        const TileDepthTransform& depthTransform =
-            tileprovider::depthTransform(*tileProvider);
-        if (tile.status != Tile::Status::OK) {
-            return 0;
-        }
-
-        ghoul::opengl::Texture* tileTexture = tile.texture;
-        if (!tileTexture) {
+        std::shared_ptr<const HeightTileCache::Entry> entry = _heightTileCache.entry(
+            *tileProvider,
+            tileIndex,
+            frame
+        );
+        if (!entry) {
             return 0;
         }
 
-        glm::vec2 transformedUv = layer->tileUvToTextureSamplePosition(
-            uvTransform,
+        // Transform the uv coordinates to the current tile texture
+        const glm::vec2 transformedUv = layer->tileUvToTextureSamplePosition(
+            entry->uvTransform,
             patchUV,
-            glm::uvec2(tileTexture->dimensions())
+            entry->dimensions
         );
 
-        // Sample and do linear interpolation
-        // (could possibly be moved as a function in ghoul texture)
-        // Suggestion: a function in ghoul::opengl::Texture that takes uv coordinates
-        // in range [0,1] and uses the set interpolation method and clamping.
-
-        const glm::uvec3 dimensions = tileTexture->dimensions();
-
-        const glm::vec2 samplePos = transformedUv * glm::vec2(dimensions);
-        glm::uvec2 samplePos00 = samplePos;
-        samplePos00 = glm::clamp(
-            samplePos00,
-            glm::uvec2(0, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::vec2 samplePosFract = samplePos - glm::vec2(samplePos00);
-
-        const glm::uvec2 samplePos10 = glm::min(
-            samplePos00 + glm::uvec2(1, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::uvec2 samplePos01 = glm::min(
-            samplePos00 + glm::uvec2(0, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
+        const std::optional<float> s = entry->sample(
+            transformedUv,
+            tileprovider::noDataValueAsFloat(*tileProvider)
         );
-        const glm::uvec2 samplePos11 = glm::min(
-            samplePos00 + glm::uvec2(1, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-
-        const float sample00 = tileTexture->texelAsFloat(samplePos00).x;
-        const float sample10 = tileTexture->texelAsFloat(samplePos10).x;
-        const float sample01 = tileTexture->texelAsFloat(samplePos01).x;
-        const float sample11 = tileTexture->texelAsFloat(samplePos11).x;
-
-        // In case the texture has NaN or no data values don't use this height map.
-        const bool anySampleIsNaN =
-            std::isnan(sample00) ||
-            std::isnan(sample01) ||
-            std::isnan(sample10) ||
-            std::isnan(sample11);
-
-        const bool anySampleIsNoData =
-            sample00 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample01 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample10 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample11 == tileprovider::noDataValueAsFloat(*tileProvider);
-
-        if (anySampleIsNaN || anySampleIsNoData) {
+        if (!s) {
             continue;
         }
-
-        const float sample0 = sample00 * (1.f - samplePosFract.x) +
-            sample10 * samplePosFract.x;
-        const float sample1 = sample01 * (1.f - samplePosFract.x) +
-            sample11 * samplePosFract.x;
-
-        const float sample = sample0 * (1.f - samplePosFract.y) +
-            sample1 * samplePosFract.y;
+        const float sample = *s;
+        const TileDepthTransform& depthTransform = entry->depthTransform;
 
         // Same as is used in the shader. This is not a perfect solution but
         // if the sample is actually a no-data-value (min_float) the interpolated
@@ -2040,6 +2228,46 @@ int RenderableGlobe::desiredLevelByAvailableTileData(const Chunk& chunk) const {
     return currLevel - 1;
 }
 
+float RenderableGlobe::tilePriority(const Chunk& chunk, const RenderData& data) const {
+    const glm::dmat4 modelViewProjectionTransform =
+        glm::dmat4(data.camera.sgctInternal.projectionMatrix()) *
+        glm::dmat4(data.camera.combinedViewMatrix()) * _cachedModelTransform;
+
+    // Calculations are done in the reference frame of the globe (model space). Hence,
+    // the camera position needs to be transformed with the inverse model matrix
+    const glm::dvec3 cameraPosition = glm::dvec3(
+        _cachedInverseModelTransform * glm::dvec4(data.camera.positionVec3(), 1.0)
+    );
+
+    AABB3 bounds; // in screen space
+    double distance = std::numeric_limits<double>::max();
+    for (const glm::dvec4& corner : chunk.corners) {
+        const glm::dvec4 cornerClippingSpace = modelViewProjectionTransform * corner;
+        const glm::dvec3 ndc = glm::dvec3(
+            (1.0 / glm::abs(cornerClippingSpace.w)) * cornerClippingSpace
+        );
+        expand(bounds, ndc);
+        distance = std::min(distance, glm::distance(glm::dvec3(corner), cameraPosition));
+    }
+
+    // Fraction of the viewport that is covered by the screen space bounding box
+    const glm::vec2 lower = glm::max(glm::vec2(bounds.min), glm::vec2(-1.f));
+    const glm::vec2 upper = glm::min(glm::vec2(bounds.max), glm::vec2(1.f));
+    const glm::vec2 extent = glm::max(upper - lower, glm::vec2(0.f));
+    const float coverage = (extent.x * extent.y) / 4.f;
+
+    // The geometric error of a chunk is proportional to its size, so the angular size
+    // of the chunk as seen from the camera is used as its screen space error. The
+    // diagonal between the north west and the south east corner is used as the size
+    const double size = glm::distance(
+        glm::dvec3(chunk.corners[NORTH_WEST]),
+        glm::dvec3(chunk.corners[SOUTH_EAST])
+    );
+    const double screenSpaceError = size / std::max(distance, 1.0);
+
+    return static_cast<float>(screenSpaceError) * (1.f + coverage);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //  Culling
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2068,6 +2296,19 @@ bool RenderableGlobe::isCullableByFrustum(const Chunk& chunk,
     return !(intersects(CullingFrustum, bounds));
 }
 
+bool RenderableGlobe::isCullableByOcclusion(const Chunk& chunk,
+                                            const RenderData& renderData) const
+{
+    if (!PerformOcclusionCulling || !renderData.depthPyramid) {
+        return false;
+    }
+    return renderData.depthPyramid->isOccluded(
+        chunk.corners,
+        _cachedModelTransform,
+        renderData.camera
+    );
+}
+
 bool RenderableGlobe::isCullableByHorizon(const Chunk& chunk,
                                           const RenderData& renderData,
                                           const BoundingHeights& heights) const
@@ -2149,15 +2390,18 @@ void RenderableGlobe::splitChunkNode(Chunk& cn, int depth) {
             cn.children[i] = new (memory[i]) Chunk(
                 cn.tileIndex.child(static_cast<Quad>(i))
             );
-            const BoundingHeights& heights = boundingHeightsForChunk(
+            cn.children[i]->heights = boundingHeightsForChunk(
                 *(cn.children[i]),
-                _layerManager
+                _layerManager,
+                _tileResolver
             );
             cn.children[i]->corners = boundingCornersForChunk(
                 *cn.children[i],
                 _ellipsoid,
-                heights
+                cn.children[i]->heights
             );
+            // The children are drawn before they are evaluated for the first time
+            cn.children[i]->gridLevel = cn.gridLevel;
         }
     }
 
@@ -2188,67 +2432,217 @@ void RenderableGlobe::mergeChunkNode(Chunk& cn) {
     cn.children.fill(nullptr);
 }
 
-bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data) {
-    // abock:  I tried turning this into a queue and use iteration, rather than recursion
-    //         but that made the code harder to understand as the breadth-first traversal
-    //         requires parents to be passed through the pipe twice (first to add the
-    //         children and then again it self to be processed after the children finish).
-    //         In addition, this didn't even improve performance ---  2018-10-04
-    if (isLeaf(cn)) {
-        updateChunk(cn, data);
-
-        if (cn.status == Chunk::Status::WantSplit) {
-            splitChunkNode(cn, 1);
-        }
-        else if (cn.status == Chunk::Status::DoNothing && (!cn.colorTileOK)) {
-            // Checking cn.heightTileOK caused always not avaiable for certain HiRISE data
-            _allChunksAvailable = false;
+template <typename Func>
+void RenderableGlobe::parallelForEachChunk(Func&& function) {
+    // Below this number of chunks, the overhead of starting the tasks outweighs the time
+    // that is saved by evaluating the chunks concurrently
+    constexpr const size_t MinChunksPerTask = 256;
+
+    const size_t nChunks = _chunkList.size();
+    const size_t nTasks = std::min<size_t>(
+        std::max(std::thread::hardware_concurrency(), 1u),
+        nChunks / MinChunksPerTask
+    );
+
+    if (nTasks <= 1) {
+        for (Chunk* chunk : _chunkList) {
+            function(*chunk);
         }
+        return;
+    }
+
+    const size_t chunksPerTask = (nChunks + nTasks - 1) / nTasks;
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(nTasks - 1);
+    // The calling thread is working on the first range itself
+    for (size_t t = 1; t < nTasks; ++t) {
+        const size_t begin = t * chunksPerTask;
+        const size_t end = std::min(begin + chunksPerTask, nChunks);
+        tasks.push_back(std::async(std::launch::async, [this, &function, begin, end]() {
+            for (size_t i = begin; i < end; ++i) {
+                function(*_chunkList[i]);
+            }
+        }));
+    }
+    for (size_t i = 0; i < std::min(chunksPerTask, nChunks); ++i) {
+        function(*_chunkList[i]);
+    }
+    for (std::future<void>& task : tasks) {
+        task.get();
+    }
+}
 
-        return cn.status == Chunk::Status::WantMerge;
+void RenderableGlobe::updateChunkTree(const RenderData& data) {
+    // The bounding heights depend on the render settings of the height layers, which
+    // do not notify us when they change, so we check whether they caused a change
+    std::vector<float> fingerprint;
+    const LayerGroup& heightLayers = _layerManager.layerGroup(layergroupid::HeightLayers);
+    for (const Layer* layer : heightLayers.activeLayers()) {
+        fingerprint.push_back(layer->renderSettings().performLayerSettings(0.f));
+        fingerprint.push_back(layer->renderSettings().performLayerSettings(1.f));
+    }
+    if (fingerprint != _heightSettingsFingerprint) {
+        _heightSettingsFingerprint = std::move(fingerprint);
+        _chunkHeightsDirty = true;
     }
-    else {
-        char requestedMergeMask = 0;
-        for (int i = 0; i < 4; ++i) {
-            if (updateChunkTree(*cn.children[i], data)) {
-                requestedMergeMask |= (1 << i);
-            }
-        }
 
-        const bool allChildrenWantsMerge = requestedMergeMask == 0xf;
-        updateChunk(cn, data);
+    flattenChunkTree();
 
-        if (allChildrenWantsMerge && (cn.status != Chunk::Status::WantSplit)) {
-            mergeChunkNode(cn);
+    // The tile priority has to be known before the layer data is updated as that
+    // already requests the tiles. The corners and visibility from the previous frame
+    // are a good enough approximation for this
+    parallelForEachChunk([this, &data](Chunk& chunk) {
+        chunk.tilePriority = chunk.isVisible ? tilePriority(chunk, data) : 0.f;
+    });
+
+    for (Chunk* chunk : _chunkList) {
+        updateChunkLayerData(*chunk);
+    }
+
+    parallelForEachChunk([this, &data](Chunk& chunk) { evaluateChunk(chunk, data); });
+
+    // Reverse level order guarantees that all children have been handled before their
+    // parent, which matches the previous depth-first recursion
+    for (auto it = _chunkList.rbegin(); it != _chunkList.rend(); ++it) {
+        Chunk& cn = **it;
+        if (isLeaf(cn)) {
+            if (cn.status == Chunk::Status::WantSplit) {
+                splitChunkNode(cn, 1);
+            }
+            else if (cn.status == Chunk::Status::DoNothing && (!cn.colorTileOK)) {
+                // Checking cn.heightTileOK caused always not avaiable for certain HiRISE
+                // data
+                _allChunksAvailable = false;
+            }
         }
-        else if (cn.status == Chunk::Status::WantSplit) {
-            splitChunkNode(cn, 1);
+        else {
+            const bool allChildrenWantsMerge = std::all_of(
+                cn.children.begin(),
+                cn.children.end(),
+                [](const Chunk* c) { return c->requestsMerge; }
+            );
+
+            if (allChildrenWantsMerge && (cn.status != Chunk::Status::WantSplit)) {
+                mergeChunkNode(cn);
+            }
+            else if (cn.status == Chunk::Status::DoNothing && (!cn.colorTileOK)) {
+                _allChunksAvailable = false;
+            }
         }
-        else if (cn.status == Chunk::Status::DoNothing && (!cn.colorTileOK)) {
-            _allChunksAvailable = false;
+    }
+}
+
+int RenderableGlobe::gridLevel(const Chunk& chunk, const RenderData& data) const {
+    if (!_generalProperties.adaptiveGridResolution) {
+        return DefaultChunkGridLevel;
+    }
+
+    const glm::dmat4 mvp = glm::dmat4(data.camera.sgctInternal.projectionMatrix()) *
+        glm::dmat4(data.camera.combinedViewMatrix()) * _cachedModelTransform;
+
+    // The extent of the chunk on screen is estimated from its bounding box. Parts that
+    // are outside of the view do not need any vertices
+    glm::dvec2 ndcMin = glm::dvec2(1.0);
+    glm::dvec2 ndcMax = glm::dvec2(-1.0);
+    for (const glm::dvec4& corner : chunk.corners) {
+        const glm::dvec4 clip = mvp * corner;
+        const glm::dvec2 ndc = glm::clamp(
+            glm::dvec2(clip) / glm::abs(clip.w),
+            glm::dvec2(-1.0),
+            glm::dvec2(1.0)
+        );
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+    const glm::dvec2 pixels = 0.5 * (ndcMax - ndcMin) * glm::dvec2(_renderingResolution);
+    const double screenSize = std::max(pixels.x, pixels.y);
+    double segments = screenSize / _generalProperties.pixelsPerGridSegment;
+
+    const double radius = _ellipsoid.minimumRadius();
+    const double chunkSize = 2.0 * chunk.surfacePatch.halfSize().lat * radius;
+    const double pixelsPerMeter = screenSize / chunkSize;
+    const BoundingHeights& heights = chunk.heights;
+    const double heightRange = static_cast<double>(heights.max - heights.min);
+    if (heights.available &&
+        heightRange * pixelsPerMeter < _generalProperties.pixelsPerGridSegment)
+    {
+        // A segment of length l deviates by l^2 / (8r) from the surface of a sphere with
+        // radius r, which should stay below a pixel for the atmosphere to not cut into
+        // the terrain
+        const double curvatureSegments = chunkSize * std::sqrt(
+            pixelsPerMeter / (8.0 * radius)
+        );
+        segments = std::min(segments, curvatureSegments);
+    }
+
+    int level = 0;
+    while (level < static_cast<int>(ChunkGridSegments.size()) - 1 &&
+           ChunkGridSegments[level] < segments)
+    {
+        ++level;
+    }
+    if (level < chunk.gridLevel &&
+        segments > GridLevelHysteresis * ChunkGridSegments[level])
+    {
+        ++level;
+    }
+    return level;
+}
+
+void RenderableGlobe::updateChunkVisibility(const RenderData& data) {
+    // The previous view might have split or merged chunks, so the list is out of date
+    flattenChunkTree();
+    parallelForEachChunk([this, &data](Chunk& chunk) {
+        chunk.isVisible = !testIfCullable(chunk, data, chunk.heights) &&
+                          !isCullableByOcclusion(chunk, data);
+        if (chunk.isVisible) {
+            chunk.gridLevel = gridLevel(chunk, data);
         }
+    });
+}
 
-        return false;
+void RenderableGlobe::flattenChunkTree() {
+    // The children of every chunk are located after it in the list
+    _chunkList.clear();
+    _chunkList.push_back(&_leftRoot);
+    _chunkList.push_back(&_rightRoot);
+    for (size_t i = 0; i < _chunkList.size(); ++i) {
+        const Chunk& cn = *_chunkList[i];
+        if (!isLeaf(cn)) {
+            _chunkList.insert(_chunkList.end(), cn.children.begin(), cn.children.end());
+        }
     }
 }
 
-void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data) const {
-    const BoundingHeights& heights = boundingHeightsForChunk(chunk, _layerManager);
-    chunk.heightTileOK = heights.tileOK;
-    chunk.colorTileOK = colorAvailableForChunk(chunk, _layerManager);
+void RenderableGlobe::updateChunkLayerData(Chunk& chunk) {
+    if (_chunkHeightsDirty || _chunkCornersDirty || !chunk.heights.isFinal) {
+        chunk.heights = boundingHeightsForChunk(chunk, _layerManager, _tileResolver);
+    }
+    chunk.heightTileOK = chunk.heights.tileOK;
+    chunk.colorTileOK = colorAvailableForChunk(chunk, _layerManager, _tileResolver);
+    chunk.levelByAvailableData = desiredLevelByAvailableTileData(chunk);
 
     if (_chunkCornersDirty) {
-        chunk.corners = boundingCornersForChunk(chunk, _ellipsoid, heights);
+        chunk.corners = boundingCornersForChunk(chunk, _ellipsoid, chunk.heights);
 
         // The flag gets set to false globally after the updateChunkTree calls
     }
+}
+
+void RenderableGlobe::evaluateChunk(Chunk& chunk, const RenderData& data) const {
+    const BoundingHeights& heights = chunk.heights;
 
     if (testIfCullable(chunk, data, heights)) {
         chunk.isVisible = false;
         chunk.status = Chunk::Status::WantMerge;
     }
     else {
-        chunk.isVisible = true;
+        // Hidden chunks keep their level of detail, as they might be revealed by the
+        // next camera movement, and are only dropped from the draws
+        chunk.isVisible = !isCullableByOcclusion(chunk, data);
+        if (chunk.isVisible) {
+            chunk.gridLevel = gridLevel(chunk, data);
+        }
     }
 
     const int dl = desiredLevel(chunk, data, heights);
@@ -2262,6 +2656,8 @@ void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data) const {
     else {
         chunk.status = Chunk::Status::DoNothing;
     }
+
+    chunk.requestsMerge = isLeaf(chunk) && (chunk.status == Chunk::Status::WantMerge);
 }
 
 } // namespace openspace::globebrowsing
@@ -31,15 +31,20 @@
 #include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/globelabelscomponent.h>
 #include <modules/globebrowsing/src/gpulayergroup.h>
+#include <modules/globebrowsing/src/heighttilecache.h>
 #include <modules/globebrowsing/src/layermanager.h>
 #include <modules/globebrowsing/src/skirtedgrid.h>
 #include <modules/globebrowsing/src/tileindex.h>
+#include <modules/globebrowsing/src/tileprovider.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <ghoul/misc/memorypool.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <array>
 #include <cstddef>
+#include <list>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
@@ -52,11 +57,20 @@ struct BoundingHeights {
     float max;
     bool available;
     bool tileOK;
+    /// Whether all height tiles these heights are based on were loaded at the level of
+    /// the chunk, in which case the heights will not change until the layers change
+    bool isFinal;
 };
 
 namespace chunklevelevaluator { class Evaluator; }
 namespace culling { class ChunkCuller; }
 
+/// The number of segments of the grids that chunks can be drawn with, from the coarsest
+/// to the finest one
+constexpr const std::array<int, 4> ChunkGridSegments = { 16, 32, 64, 128 };
+/// The grid that all chunks are drawn with if the resolution is not adapted per chunk
+constexpr const int DefaultChunkGridLevel = 2;
+
 struct Chunk {
     enum class Status : uint8_t {
         DoNothing,
@@ -73,7 +87,19 @@ struct Chunk {
 
     bool isVisible = true;
     bool colorTileOK = false;
+    /// The priority with which missing tiles for this chunk are requested
+    float tilePriority = 0.f;
     bool heightTileOK = false;
+    /// Whether this chunk was a leaf that wanted to be merged in the last evaluation
+    bool requestsMerge = false;
+
+    /// Cached bounding heights that are only recalculated until they are final
+    BoundingHeights heights = { 0.f, 0.f, false, true, false };
+    /// Cached level that is supported by the available tile data
+    int levelByAvailableData = 0;
+
+    /// The index into ChunkGridSegments of the grid that this chunk is drawn with
+    int gridLevel = DefaultChunkGridLevel;
 
     std::array<glm::dvec4, 8> corners;
     std::array<Chunk*, 4> children = { { nullptr, nullptr, nullptr, nullptr } };
@@ -104,6 +130,15 @@ public:
     SurfacePositionHandle calculateSurfacePositionHandle(
         const glm::dvec3& targetModelSpace) const override;
 
+    /**
+     * Calculates the surface position handles for all \p targetsModelSpace. The result
+     * is the same as calling #calculateSurfacePositionHandle for each of the targets,
+     * but the height layers are only looked up once for all targets, which makes this
+     * the preferred way to place many objects on the surface of the globe.
+     */
+    std::vector<SurfacePositionHandle> calculateSurfacePositionHandles(
+        const std::vector<glm::dvec3>& targetsModelSpace) const;
+
     bool renderedWithDesiredData() const override;
 
     const Ellipsoid& ellipsoid() const;
@@ -132,6 +167,8 @@ private:
         properties::BoolProperty useAccurateNormals;
         properties::BoolProperty eclipseShadowsEnabled;
         properties::BoolProperty eclipseHardShadows;
+        properties::BoolProperty adaptiveGridResolution;
+        properties::FloatProperty pixelsPerGridSegment;
         properties::FloatProperty targetLodScaleFactor;
         properties::FloatProperty currentLodScaleFactor;
         properties::FloatProperty cameraMinHeight;
@@ -177,6 +214,14 @@ private:
      */
     float getHeight(const glm::dvec3& position) const;
 
+    /// Same as #getHeight but with the active \p heightLayers already looked up
+    float getHeight(const glm::dvec3& position, const std::vector<Layer*>& heightLayers,
+        uint64_t frame) const;
+
+    /// Creates the handle for the \p targetModelSpace with the height \p heightToSurface
+    SurfacePositionHandle surfacePositionHandle(const glm::dvec3& targetModelSpace,
+        double heightToSurface) const;
+
     void renderChunks(const RenderData& data, RendererTasks& rendererTask);
 
     /**
@@ -186,8 +231,12 @@ private:
      * coordinates of the chunk to model space coordinates. We can only achieve floating
      * point precision by doing this which means that the camera too close to a global
      * tile will lead to jagging. We only render global chunks for lower chunk levels.
+     * The OpenGL state and uniforms that are shared by all chunks of a frame have to be
+     * set up by the caller, \p modelViewTransform is the combined view and model
+     * transform of that frame.
      */
-    void renderChunkGlobally(const Chunk& chunk, const RenderData& data);
+    void renderChunkGlobally(const Chunk& chunk, const RenderData& data,
+        const glm::dmat4& modelViewTransform);
 
     /**
      * Local rendering of chunks are done using linear interpolation in camera space.
@@ -198,14 +247,24 @@ private:
      * corner points to get the resulting chunk. This means that there will be an error
      * due to the curvature of the globe. The smaller the patch is (with higher chunk
      * levels) the better the approximation becomes. This is why we only render local
-     * chunks for higher chunk levels.
+     * chunks for higher chunk levels. As for the global rendering, the shared state has
+     * to be set up by the caller.
      */
-    void renderChunkLocally(const Chunk& chunk, const RenderData& data);
+    void renderChunkLocally(const Chunk& chunk, const RenderData& data,
+        const glm::dmat4& modelViewTransform);
 
     void debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp,
         bool renderBounds, bool renderAABB) const;
 
     bool isCullableByFrustum(const Chunk& chunk, const RenderData& renderData) const;
+
+    /**
+     * Returns \c true if the bounding box of the \p chunk was hidden behind opaque
+     * geometry in the depth pyramid of the \p renderData, which can be other terrain of
+     * this globe or other objects. Unlike the other tests, this does not affect the
+     * level of detail of the chunk.
+     */
+    bool isCullableByOcclusion(const Chunk& chunk, const RenderData& renderData) const;
     bool isCullableByHorizon(const Chunk& chunk, const RenderData& renderData,
         const BoundingHeights& heights) const;
 
@@ -215,12 +274,32 @@ private:
         const BoundingHeights& heights) const;
     int desiredLevelByAvailableTileData(const Chunk& chunk) const;
 
+    /**
+     * Calculates the priority with which tiles for the <code>chunk</code> should be
+     * loaded. The priority is based on the screen space error of the chunk, which is
+     * approximated by its angular size as seen from the camera, and is weighted by the
+     * fraction of the screen that the chunk covers. Chunks that are close to the camera
+     * and large on screen are loaded first.
+     */
+    float tilePriority(const Chunk& chunk, const RenderData& data) const;
+
+    /**
+     * Selects the grid that the \p chunk is drawn with from the ChunkGridSegments. The
+     * number of segments is chosen such that a segment covers about
+     * <code>PixelsPerGridSegment</code> pixels of the projected chunk. Chunks whose
+     * height range covers less than a segment on screen are considered flat and only
+     * get as many segments as are needed to follow the curvature of the ellipsoid.
+     */
+    int gridLevel(const Chunk& chunk, const RenderData& data) const;
+
 
     void calculateEclipseShadows(ghoul::opengl::ProgramObject& programObject,
         const RenderData& data, ShadowCompType stype);
 
+    struct CommonUniformCache;
     void setCommonUniforms(ghoul::opengl::ProgramObject& programObject,
-        const Chunk& chunk, const RenderData& data);
+        const CommonUniformCache& uniformCache, const Chunk& chunk,
+        const glm::dmat4& modelViewTransform);
 
 
     void recompileShaders();
@@ -228,13 +307,57 @@ private:
 
     void splitChunkNode(Chunk& cn, int depth);
     void mergeChunkNode(Chunk& cn);
-    bool updateChunkTree(Chunk& cn, const RenderData& data);
-    void updateChunk(Chunk& chunk, const RenderData& data) const;
     void freeChunkNode(Chunk* n);
 
+    /**
+     * Evaluates all chunks of the tree and splits or merges them according to their
+     * desired level. The tree is first flattened into a level-ordered list. The data
+     * that depends on the layers is updated serially, as the tile providers are not
+     * thread-safe, whereas the culling and level selection is performed in parallel.
+     * Finally, the chunks are split and merged in reverse level order so that the
+     * children are always handled before their parents.
+     */
+    void updateChunkTree(const RenderData& data);
+
+    /**
+     * Only updates the visibility of the chunks of the current tree for the view in
+     * \p data without splitting or merging any of them. This is used for all but the
+     * first view that is rendered in a frame, as the desired level of the chunks only
+     * depends on the camera position, which is shared between all viewports and eyes.
+     */
+    void updateChunkVisibility(const RenderData& data);
+
+    /// Flattens the chunk tree into <code>_chunkList</code> in level order
+    void flattenChunkTree();
+
+    /**
+     * Calls the \p function for every chunk in the <code>_chunkList</code>. If there
+     * are enough chunks, they are distributed over multiple threads.
+     */
+    template <typename Func>
+    void parallelForEachChunk(Func&& function);
+
+    /**
+     * Updates the cached data of the \p chunk that has to be requested from the layers.
+     * The bounding heights and corners are only recalculated if they are not final yet
+     * or if the height layers have changed.
+     */
+    void updateChunkLayerData(Chunk& chunk);
+
+    /**
+     * Determines the visibility of the \p chunk and whether it wants to be split or
+     * merged based on its cached data. This function is safe to be called concurrently
+     * for different chunks.
+     */
+    void evaluateChunk(Chunk& chunk, const RenderData& data) const;
+
     Ellipsoid _ellipsoid;
-    SkirtedGrid _grid;
+    std::array<SkirtedGrid, ChunkGridSegments.size()> _grids;
+    /// The resolution of the view whose chunks are evaluated, used by #gridLevel
+    glm::ivec2 _renderingResolution = glm::ivec2(0);
     LayerManager _layerManager;
+    /// Shares the tile lookups between all chunks and layers of a frame
+    tileprovider::ChunkTileResolver _tileResolver;
 
     glm::dmat4 _cachedModelTransform;
     glm::dmat4 _cachedInverseModelTransform;
@@ -244,11 +367,18 @@ private:
     Chunk _leftRoot;  // Covers all negative longitudes
     Chunk _rightRoot; // Covers all positive longitudes
 
+    // Per-chunk uniforms that the global and the local renderer have in common
+    struct CommonUniformCache {
+        UniformCache(chunkLevel, deltaTheta0, deltaTheta1, deltaPhi0, deltaPhi1,
+            tileDelta, heightScale, xSegments) locations;
+    };
+
     // Two different shader programs. One for global and one for local rendering.
     struct {
         std::unique_ptr<ghoul::opengl::ProgramObject> program;
         bool updatedSinceLastCall = false;
         UniformCache(skirtLength, minLatLon, lonLatScalingFactor) uniformCache;
+        CommonUniformCache commonUniformCache;
 
         std::array<GPULayerGroup, LayerManager::NumLayerGroups> gpuLayerGroups;
     } _globalRenderer;
@@ -258,19 +388,42 @@ private:
         bool updatedSinceLastCall = false;
         UniformCache(skirtLength, p01, p11, p00, p10, patchNormalModelSpace,
             patchNormalCameraSpace) uniformCache;
+        CommonUniformCache commonUniformCache;
 
         std::array<GPULayerGroup, LayerManager::NumLayerGroups> gpuLayerGroups;
     } _localRenderer;
 
+    // The programs for a layer configuration that is not active at the moment. They are
+    // kept so that switching back to that configuration does not require a recompilation
+    struct ShaderPermutation {
+        std::string key;
+        std::unique_ptr<ghoul::opengl::ProgramObject> localProgram;
+        std::unique_ptr<ghoul::opengl::ProgramObject> globalProgram;
+    };
+    /// The inactive permutations, the most recently used one first
+    std::list<ShaderPermutation> _shaderPermutations;
+    /// The key of the layer configuration that the current programs were built for
+    std::string _currentPermutationKey;
+
     bool _shadersNeedRecompilation = true;
     bool _lodScaleFactorDirty = true;
     bool _chunkCornersDirty = true;
+    bool _chunkHeightsDirty = true;
+    /// Set in every update and cleared by the first view that evaluates the chunk tree
+    bool _chunkTreeNeedsUpdate = true;
+    /// Used to detect changes to the render settings of the height layers
+    std::vector<float> _heightSettingsFingerprint;
+    /// The chunks of the last tree evaluation in level order. Reused between frames
+    std::vector<Chunk*> _chunkList;
     bool _nLayersIsDirty = true;
     bool _allChunksAvailable = true;
     size_t _iterationsOfAvailableData = 0;
     size_t _iterationsOfUnavailableData = 0;
     Layer* _lastChangedLayer = nullptr;
 
+    /// CPU-side copies of the height tiles that were recently sampled by #getHeight
+    mutable HeightTileCache _heightTileCache;
+
     // Labels
     GlobeLabelsComponent _globeLabelsComponent;
     ghoul::Dictionary _labelsDictionary;
@@ -0,0 +1,77 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/tilebufferpool.h>
+
+namespace openspace::globebrowsing::cache {
+
+TileBufferPool::TileBufferPool(size_t maximumSize)
+    : _maximumSize(maximumSize)
+{}
+
+std::unique_ptr<std::byte[]> TileBufferPool::acquire(const TileTextureInitData& initData)
+{
+    {
+        std::lock_guard lock(_mutex);
+        const auto it = _slabs.find(initData.hashKey);
+        if (it != _slabs.end() && !it->second.empty()) {
+            std::unique_ptr<std::byte[]> buffer = std::move(it->second.back());
+            it->second.pop_back();
+            _size -= initData.totalNumBytes;
+            return buffer;
+        }
+    }
+
+    return std::unique_ptr<std::byte[]>(new std::byte[initData.totalNumBytes]);
+}
+
+void TileBufferPool::release(const TileTextureInitData& initData,
+                             std::unique_ptr<std::byte[]> buffer)
+{
+    if (!buffer) {
+        return;
+    }
+
+    std::lock_guard lock(_mutex);
+    if (_size + initData.totalNumBytes > _maximumSize) {
+        // The buffer is freed when it goes out of scope
+        return;
+    }
+
+    _slabs[initData.hashKey].push_back(std::move(buffer));
+    _size += initData.totalNumBytes;
+}
+
+void TileBufferPool::clear() {
+    std::lock_guard lock(_mutex);
+    _slabs.clear();
+    _size = 0;
+}
+
+size_t TileBufferPool::size() const {
+    std::lock_guard lock(_mutex);
+    return _size;
+}
+
+} // namespace openspace::globebrowsing::cache
@@ -0,0 +1,83 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_BUFFER_POOL___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_BUFFER_POOL___H__
+
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * A pool of the image data buffers of <code>RawTile</code>s. The buffers are kept in one
+ * slab per TileTextureInitData, so that the RawTileDataReader can reuse the buffer of a
+ * tile that has been uploaded instead of allocating a new buffer for every tile it reads.
+ * The total number of bytes held in the pool is limited and buffers that are released
+ * while the pool is full are freed. All methods are safe to call from the tile loading
+ * worker threads.
+ */
+class TileBufferPool {
+public:
+    /**
+     * \param maximumSize is the maximum number of bytes that the pooled buffers can use
+     */
+    explicit TileBufferPool(size_t maximumSize);
+
+    /**
+     * Returns a buffer of <code>initData.totalNumBytes</code> bytes. The buffer is taken
+     * from the slab of the \p initData if one is available and newly allocated otherwise.
+     * The contents of the returned buffer are undefined.
+     */
+    std::unique_ptr<std::byte[]> acquire(const TileTextureInitData& initData);
+
+    /**
+     * Returns the \p buffer, which has to have been created for tiles of the
+     * \p initData, to the pool. If the pool is full, the \p buffer is freed instead.
+     */
+    void release(const TileTextureInitData& initData,
+        std::unique_ptr<std::byte[]> buffer);
+
+    /// Frees all buffers that are currently held in the pool
+    void clear();
+
+    /// Returns the number of bytes that are currently held in the pool
+    size_t size() const;
+
+private:
+    const size_t _maximumSize;
+
+    mutable std::mutex _mutex;
+    size_t _size = 0;
+    std::map<TileTextureInitData::HashKey, std::vector<std::unique_ptr<std::byte[]>>>
+        _slabs;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_BUFFER_POOL___H__
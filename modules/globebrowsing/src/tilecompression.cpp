@@ -0,0 +1,251 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/tilecompression.h>
+
+#include <modules/globebrowsing/src/rawtile.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+    // The end points of a block are moved towards each other by this fraction (as a
+    // power of two) of the extent of the block colors so that outliers do not pull the
+    // interpolated colors away from the bulk of the pixels
+    constexpr const int InsetShift = 4;
+
+    // Pixels whose alpha is below this value are encoded as transparent in BC1 blocks
+    constexpr const int AlphaThreshold = 128;
+
+    using Color = std::array<int, 3>;
+
+    struct Block {
+        // The RGBA values of the 16 pixels of a 4x4 block in row-major order
+        std::array<std::array<int, 4>, 16> pixels;
+    };
+
+    uint16_t toRgb565(const Color& c) {
+        return static_cast<uint16_t>(
+            ((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3)
+        );
+    }
+
+    Color fromRgb565(uint16_t c) {
+        const int r = (c >> 11) & 31;
+        const int g = (c >> 5) & 63;
+        const int b = c & 31;
+        return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+    }
+
+    int squaredDistance(const Color& c, const std::array<int, 4>& p) {
+        const int dr = c[0] - p[0];
+        const int dg = c[1] - p[1];
+        const int db = c[2] - p[2];
+        return dr * dr + dg * dg + db * db;
+    }
+
+    void writeLittleEndian(uint64_t value, int nBytes, std::byte* out) {
+        for (int i = 0; i < nBytes; ++i) {
+            out[i] = static_cast<std::byte>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    // Writes the 8 byte color part of a BC1 or BC3 block. If transparency is allowed,
+    // pixels below the alpha threshold are encoded with BC1's transparent index
+    void writeColorBlock(const Block& block, bool allowTransparency, std::byte* out) {
+        Color minColor = { 255, 255, 255 };
+        Color maxColor = { 0, 0, 0 };
+        bool hasTransparency = false;
+        bool hasOpaque = false;
+        for (const std::array<int, 4>& p : block.pixels) {
+            if (allowTransparency && p[3] < AlphaThreshold) {
+                hasTransparency = true;
+                continue;
+            }
+            hasOpaque = true;
+            for (int c = 0; c < 3; ++c) {
+                minColor[c] = std::min(minColor[c], p[c]);
+                maxColor[c] = std::max(maxColor[c], p[c]);
+            }
+        }
+        if (!hasOpaque) {
+            minColor = { 0, 0, 0 };
+            maxColor = { 0, 0, 0 };
+        }
+        for (int c = 0; c < 3; ++c) {
+            const int inset = (maxColor[c] - minColor[c]) >> InsetShift;
+            minColor[c] += inset;
+            maxColor[c] -= inset;
+        }
+
+        // The order of the end points selects the mode of the block: c0 > c1 is the
+        // four color mode, c0 <= c1 the three color mode with a transparent index
+        uint16_t c0 = toRgb565(maxColor);
+        uint16_t c1 = toRgb565(minColor);
+        if (hasTransparency ? (c0 > c1) : (c0 < c1)) {
+            std::swap(c0, c1);
+        }
+
+        const Color e0 = fromRgb565(c0);
+        const Color e1 = fromRgb565(c1);
+        std::array<Color, 4> palette = { e0, e1, e0, e1 };
+        int nColors = 0;
+        if (c0 > c1) {
+            for (int c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * e0[c] + e1[c]) / 3;
+                palette[3][c] = (e0[c] + 2 * e1[c]) / 3;
+            }
+            nColors = 4;
+        }
+        else {
+            // Also used for blocks of a single color in the four color mode, as the two
+            // interpolated colors are equal to the end points in that case
+            for (int c = 0; c < 3; ++c) {
+                palette[2][c] = (e0[c] + e1[c]) / 2;
+            }
+            nColors = 3;
+        }
+
+        uint32_t indices = 0;
+        for (int i = 0; i < 16; ++i) {
+            const std::array<int, 4>& p = block.pixels[i];
+            int index = 3;
+            if (!hasTransparency || p[3] >= AlphaThreshold) {
+                index = 0;
+                int bestDistance = squaredDistance(palette[0], p);
+                for (int j = 1; j < nColors; ++j) {
+                    const int d = squaredDistance(palette[j], p);
+                    if (d < bestDistance) {
+                        bestDistance = d;
+                        index = j;
+                    }
+                }
+            }
+            indices |= static_cast<uint32_t>(index) << (2 * i);
+        }
+
+        writeLittleEndian(c0, 2, out);
+        writeLittleEndian(c1, 2, out + 2);
+        writeLittleEndian(indices, 4, out + 4);
+    }
+
+    // Writes the 8 byte alpha part of a BC3 block
+    void writeAlphaBlock(const Block& block, std::byte* out) {
+        int minAlpha = 255;
+        int maxAlpha = 0;
+        for (const std::array<int, 4>& p : block.pixels) {
+            minAlpha = std::min(minAlpha, p[3]);
+            maxAlpha = std::max(maxAlpha, p[3]);
+        }
+
+        // With a0 > a1 the six remaining alpha values are interpolated between the end
+        // points. If all pixels have the same alpha, index 0 is used for all of them
+        std::array<int, 8> palette = {};
+        palette[0] = maxAlpha;
+        palette[1] = minAlpha;
+        for (int k = 1; k < 7; ++k) {
+            palette[k + 1] = ((7 - k) * maxAlpha + k * minAlpha) / 7;
+        }
+        const int nValues = maxAlpha > minAlpha ? 8 : 1;
+
+        uint64_t indices = 0;
+        for (int i = 0; i < 16; ++i) {
+            const int a = block.pixels[i][3];
+            int index = 0;
+            int bestDistance = std::abs(palette[0] - a);
+            for (int j = 1; j < nValues; ++j) {
+                const int d = std::abs(palette[j] - a);
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    index = j;
+                }
+            }
+            indices |= static_cast<uint64_t>(index) << (3 * i);
+        }
+
+        out[0] = static_cast<std::byte>(maxAlpha);
+        out[1] = static_cast<std::byte>(minAlpha);
+        writeLittleEndian(indices, 6, out + 2);
+    }
+} // namespace
+
+namespace openspace::globebrowsing {
+
+void compressTile(RawTile& rawTile) {
+    using Compression = TileTextureInitData::Compression;
+
+    if (!rawTile.textureInitData || !rawTile.imageData ||
+        rawTile.error != RawTile::ReadError::None)
+    {
+        return;
+    }
+
+    const TileTextureInitData& initData = *rawTile.textureInitData;
+    if (initData.compression == Compression::None) {
+        return;
+    }
+    ghoul_assert(initData.bytesPerPixel == 4, "Only four channel bytes are compressed");
+
+    using Format = ghoul::opengl::Texture::Format;
+    const bool isBgra = initData.ghoulTextureFormat == Format::BGRA;
+    const size_t red = isBgra ? 2 : 0;
+    const size_t blue = isBgra ? 0 : 2;
+    const size_t blockSize = initData.compression == Compression::BC1 ? 8 : 16;
+
+    // The blocks are written in row-major order into the same buffer they are read from.
+    // This is safe as the output for a row of blocks never reaches past the first line
+    // of pixels of that row, and each block is read completely before it is written
+    std::byte* data = rawTile.imageData.get();
+    std::byte* out = data;
+    for (int by = 0; by < initData.dimensions.y / 4; ++by) {
+        for (int bx = 0; bx < initData.dimensions.x / 4; ++bx) {
+            Block block;
+            for (int y = 0; y < 4; ++y) {
+                const std::byte* line = data + (by * 4 + y) * initData.bytesPerLine;
+                for (int x = 0; x < 4; ++x) {
+                    const std::byte* p = line + (bx * 4 + x) * initData.bytesPerPixel;
+                    block.pixels[y * 4 + x] = {
+                        std::to_integer<int>(p[red]),
+                        std::to_integer<int>(p[1]),
+                        std::to_integer<int>(p[blue]),
+                        std::to_integer<int>(p[3])
+                    };
+                }
+            }
+
+            if (initData.compression == Compression::BC1) {
+                writeColorBlock(block, true, out);
+            }
+            else {
+                writeAlphaBlock(block, out);
+                writeColorBlock(block, false, out + 8);
+            }
+            out += blockSize;
+        }
+    }
+}
+
+} // namespace openspace::globebrowsing
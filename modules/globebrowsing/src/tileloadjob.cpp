@@ -24,13 +24,21 @@
 
 #include <modules/globebrowsing/src/tileloadjob.h>
 
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/rawtiledatareader.h>
+#include <modules/globebrowsing/src/tilecompression.h>
+#include <modules/globebrowsing/src/tileservice.h>
 
 namespace openspace::globebrowsing {
 
-TileLoadJob::TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex)
+TileLoadJob::TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex,
+                         cache::DiskTileCache* diskCache, unsigned int datasetIdentifier,
+                         cache::TileServiceClient* tileService)
     : _rawTileDataReader(rawTileDataReader)
     , _chunkIndex(std::move(tileIndex))
+    , _diskCache(diskCache)
+    , _tileService(tileService)
+    , _datasetIdentifier(datasetIdentifier)
 {}
 
 TileLoadJob::~TileLoadJob() {
@@ -40,7 +48,40 @@ TileLoadJob::~TileLoadJob() {
 }
 
 void TileLoadJob::execute() {
-    _rawTile = _rawTileDataReader.readTileData(_chunkIndex);
+    if (_tileService) {
+        std::optional<RawTile> served = _tileService->get(
+            _datasetIdentifier,
+            _chunkIndex,
+            _rawTileDataReader.tileTextureInitData()
+        );
+        if (served) {
+            // The server has already compressed the tile
+            _rawTile = std::move(*served);
+            _hasTile = true;
+            return;
+        }
+    }
+
+    if (_diskCache) {
+        const cache::ProviderTileKey key = { _chunkIndex, _datasetIdentifier };
+        std::optional<RawTile> cached = _diskCache->get(
+            key,
+            _rawTileDataReader.tileTextureInitData()
+        );
+        if (cached) {
+            _rawTile = std::move(*cached);
+        }
+        else {
+            _rawTile = _rawTileDataReader.readTileData(_chunkIndex);
+            _diskCache->put(key, _rawTile);
+        }
+    }
+    else {
+        _rawTile = _rawTileDataReader.readTileData(_chunkIndex);
+    }
+
+    // The disk cache stores the uncompressed tiles, so the compression is done last
+    compressTile(_rawTile);
     _hasTile = true;
 }
 
@@ -33,6 +33,10 @@
 namespace openspace::globebrowsing {
 
 class RawTileDataReader;
+namespace cache {
+    class DiskTileCache;
+    class TileServiceClient;
+} // namespace cache
 
 struct TileLoadJob : public Job<RawTile> {
     /**
@@ -40,8 +44,18 @@ struct TileLoadJob : public Job<RawTile> {
      * ownership of this data will be released. If <code>product()</code> has not been
      * called before the TileLoadJob is finished, the data will be deleted as it has not
      * been exposed outside of this object.
+     *
+     * If a \p diskCache is provided, the tile is first looked up in the cache using
+     * the \p datasetIdentifier and only read from the \p rawTileDataReader if it
+     * is not found. Tiles that had to be read are then written to the cache.
+     *
+     * If a \p tileService is provided, the finished tile is requested from the tile
+     * server of the cluster first and the \p diskCache and \p rawTileDataReader are
+     * only used if the server is not reachable.
      */
-    TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex);
+    TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex,
+        cache::DiskTileCache* diskCache = nullptr, unsigned int datasetIdentifier = 0,
+        cache::TileServiceClient* tileService = nullptr);
 
     /**
      * Destroys the allocated data pointer if it has been allocated and the TileLoadJob
@@ -67,6 +81,9 @@ protected:
     RawTileDataReader& _rawTileDataReader;
     RawTile _rawTile;
     const TileIndex _chunkIndex;
+    cache::DiskTileCache* _diskCache;
+    cache::TileServiceClient* _tileService;
+    const unsigned int _datasetIdentifier;
     bool _hasTile = false;
 };
 
@@ -30,6 +30,7 @@
 #include <modules/globebrowsing/src/layermanager.h>
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
 #include <modules/globebrowsing/src/rawtiledatareader.h>
+#include <modules/globebrowsing/src/tilebufferpool.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/moduleengine.h>
 #include <openspace/util/factorymanager.h>
@@ -40,7 +41,11 @@
 #include <ghoul/font/fontrenderer.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include "cpl_minixml.h"
 
 namespace ghoul {
@@ -84,6 +89,10 @@ namespace defaultprovider {
     constexpr const char* KeyPerformPreProcessing = "PerformPreProcessing";
     constexpr const char* KeyTilePixelSize = "TilePixelSize";
     constexpr const char* KeyPadTiles = "PadTiles";
+    constexpr const char* KeyTextureCompression = "TextureCompression";
+
+    // The extension that provides the BC1 and BC3 texture formats
+    constexpr const char* CompressionExtension = "GL_EXT_texture_compression_s3tc";
 
     constexpr openspace::properties::Property::PropertyInfo FilePathInfo = {
         "FilePath",
@@ -100,6 +109,20 @@ namespace defaultprovider {
         "(smaller images). The tile pixel size has to be smaller than the size of the "
         "complete image if a single image is used."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo CacheHitRateInfo = {
+        "CacheHitRate",
+        "Cache Hit Rate",
+        "This value is the fraction of the requests for tiles of this layer that were "
+        "answered by the tile cache. It is updated every frame."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo CacheEvictionsInfo = {
+        "CacheEvictions",
+        "Cache Evictions",
+        "This value is the number of tiles of this layer that have been evicted from "
+        "the tile cache to make room for other tiles."
+    };
 } // namespace defaultprovider
 
 namespace singleimageprovider {
@@ -129,6 +152,21 @@ namespace bylevelprovider {
     constexpr const char* KeyLayerGroupID = "LayerGroupID";
 } // namespace bylevelprovider
 
+namespace bakedprovider {
+    constexpr openspace::properties::Property::PropertyInfo FilePathInfo = {
+        "FilePath",
+        "File Path",
+        "The directory that contains the level files of the baked tile pyramid."
+    };
+
+    // The highest level for which a level file is looked for
+    constexpr const int MaxLevel = 22;
+
+    // The number of tiles that are read from disk each frame. The uploads of the tiles
+    // are spread out further by the upload budget of the tile cache
+    constexpr const size_t MaxTileReadsPerFrame = 16;
+} // namespace bakedprovider
+
 namespace temporal {
     constexpr const char* KeyBasePath = "BasePath";
 
@@ -144,6 +182,26 @@ namespace temporal {
         "This is the path to the XML configuration file that describes the temporal tile "
         "information."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchTimeStepsInfo = {
+        "PrefetchTimeSteps",
+        "Prefetched Time Steps",
+        "The number of upcoming time steps, in the direction of the simulation time, for "
+        "which the tiles are loaded ahead of time so that the layer does not go blank "
+        "when the time step changes. Set to 0 to disable prefetching."
+    };
+
+    // Prefetching is paused while the tiles on screen take up more than this fraction of
+    // the tile cache, so that the prefetched tiles don't compete with them for space
+    constexpr const float PrefetchCacheOccupancyLimit = 0.75f;
+
+    // The prefetched tiles are requested with a lower priority than the current tiles
+    constexpr const float PrefetchPriorityScale = 0.5f;
+
+    // The wall clock time in seconds that it takes to load the tiles of a time step.
+    // If the simulation time passes more than one time step in this time, the
+    // intermediate time steps would never be shown and are not prefetched
+    constexpr const double PrefetchLoadTime = 1.0;
 } // namespace temporal
 
 
@@ -168,7 +226,11 @@ void initTexturesFromLoadedData(DefaultTileProvider& t) {
         if (tile) {
             const cache::ProviderTileKey key = { tile->tileIndex, t.uniqueIdentifier };
             ghoul_assert(!t.tileCache->exist(key), "Tile must not be existing in cache");
-            t.tileCache->createTileAndPut(key, std::move(tile.value()));
+            ghoul_assert(
+                !t.tileCache->isUploadPending(key),
+                "Tile must not be waiting for upload"
+            );
+            t.tileCache->enqueueTileUpload(key, std::move(tile.value()));
         }
     }
 }
@@ -253,6 +315,121 @@ TileProvider* levelProvider(TileProviderByLevel& t, int level) {
 }
 
 
+//
+// BakedTileProvider
+//
+
+void openLevels(BakedTileProvider& t) {
+    t.levels.clear();
+    t.initData = std::nullopt;
+    t.requestedTiles.clear();
+
+    const std::string directory = absPath(t.filePath);
+    for (int level = 0; level <= bakedprovider::MaxLevel; ++level) {
+        const std::string path = tilepyramid::levelFilePath(directory, level);
+        if (!FileSys.fileExists(path)) {
+            continue;
+        }
+
+        std::unique_ptr<TilePyramidLevel> l;
+        try {
+            l = std::make_unique<TilePyramidLevel>(path);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC("BakedTileProvider", e.message);
+            continue;
+        }
+
+        const TilePyramidHeader& header = l->header();
+        if (!t.initData) {
+            t.initData = tileTextureInitData(
+                t.layerGroupID,
+                header.padTiles != 0,
+                static_cast<size_t>(header.tilePixelSize)
+            );
+            t.depthTransform = header.depthTransform;
+            t.noDataValue = header.noDataValue;
+        }
+        if (header.initDataHashKey != t.initData->hashKey) {
+            LERRORC("BakedTileProvider", fmt::format(
+                "The tiles in '{}' do not match the layer group of this layer or the "
+                "other levels of the pyramid", path
+            ));
+            continue;
+        }
+
+        t.levels.resize(level + 1);
+        t.levels[level] = std::move(l);
+    }
+
+    if (t.levels.empty()) {
+        LERRORC(
+            "BakedTileProvider",
+            fmt::format("No tile pyramid found in '{}'", directory)
+        );
+    }
+}
+
+const TilePyramidLevel* pyramidLevel(const BakedTileProvider& t, const TileIndex& index) {
+    const int nLevels = static_cast<int>(t.levels.size());
+    if (!t.initData || index.level < 0 || index.level >= nLevels) {
+        return nullptr;
+    }
+    return t.levels[index.level].get();
+}
+
+void readRequestedTiles(BakedTileProvider& t) {
+    if (t.requestedTiles.empty()) {
+        return;
+    }
+
+    // Tiles that are not read this frame will be requested again in the next one if
+    // they are still needed
+    using Request = std::pair<TileIndex, float>;
+    std::vector<Request> requests;
+    requests.reserve(t.requestedTiles.size());
+    for (const std::pair<const TileIndex::TileHashKey, Request>& r : t.requestedTiles) {
+        requests.push_back(r.second);
+    }
+    t.requestedTiles.clear();
+
+    const size_t nReads = std::min(requests.size(), bakedprovider::MaxTileReadsPerFrame);
+    std::partial_sort(
+        requests.begin(),
+        requests.begin() + nReads,
+        requests.end(),
+        [](const Request& lhs, const Request& rhs) { return lhs.second > rhs.second; }
+    );
+
+    cache::TileBufferPool* pool =
+        global::moduleEngine.module<GlobeBrowsingModule>()->tileBufferPool();
+    for (size_t i = 0; i < nReads; ++i) {
+        const TileIndex& index = requests[i].first;
+        const TilePyramidLevel* level = pyramidLevel(t, index);
+        if (!level) {
+            continue;
+        }
+
+        std::optional<RawTile> rawTile = level->readTile(index, *t.initData, pool);
+        if (!rawTile) {
+            LERRORC("BakedTileProvider", fmt::format(
+                "Could not read tile {}/{}/{} from '{}'",
+                index.level, index.x, index.y, t.filePath.value()
+            ));
+            continue;
+        }
+
+        const cache::ProviderTileKey key = { index, t.uniqueIdentifier };
+        if (!t.tileCache->exist(key) && !t.tileCache->isUploadPending(key)) {
+            t.tileCache->enqueueTileUpload(key, std::move(*rawTile));
+        }
+        else if (pool) {
+            pool->release(*t.initData, std::move(rawTile->imageData));
+        }
+    }
+}
+
+
 //
 // TemporalTileProvider
 //
@@ -351,6 +528,66 @@ TileProvider* getTileProvider(TemporalTileProvider& t, const Time& time) {
     return nullptr;
 }
 
+float cacheOccupancy(TileProvider& tp) {
+    if (tp.type != Type::DefaultTileProvider) {
+        return 0.f;
+    }
+    DefaultTileProvider& t = static_cast<DefaultTileProvider&>(tp);
+    return t.tileCache->occupancy();
+}
+
+void updatePrefetchTileProviders(TemporalTileProvider& t) {
+    t.prefetchTileProviders.clear();
+
+    const double deltaTime = global::timeManager.deltaTime();
+    if (t.prefetchTimeSteps == 0 || deltaTime == 0.0 || !t.currentTileProvider) {
+        return;
+    }
+    if (cacheOccupancy(*t.currentTileProvider) > temporal::PrefetchCacheOccupancyLimit) {
+        return;
+    }
+
+    Time current = global::timeManager.time();
+    if (!t.timeQuantizer.quantize(current, false)) {
+        return;
+    }
+
+    const double resolution = t.timeQuantizer.resolution();
+    const double stride = std::max(
+        std::ceil(std::abs(deltaTime) * temporal::PrefetchLoadTime / resolution),
+        1.0
+    );
+    const double step = std::copysign(stride * resolution, deltaTime);
+
+    for (int i = 1; i <= t.prefetchTimeSteps; ++i) {
+        // Aim for the middle of the time step to be robust against rounding errors
+        Time time(current.j2000Seconds() + i * step + resolution / 2.0);
+        if (!t.timeQuantizer.quantize(time, false)) {
+            break;
+        }
+
+        const TemporalTileProvider::TimeKey key = timeStringify(t.timeFormat, time);
+        // Creating a tile provider opens the dataset, which can take a while. To not
+        // stall the rendering, at most one provider is created each frame
+        const bool isCreated = t.tileProviderMap.find(key) == t.tileProviderMap.end();
+        TileProvider* provider = nullptr;
+        try {
+            provider = getTileProvider(t, key);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC("TemporalTileProvider", e.message);
+        }
+
+        if (provider && provider != t.currentTileProvider) {
+            update(*provider);
+            t.prefetchTileProviders.push_back(provider);
+        }
+        if (isCreated) {
+            break;
+        }
+    }
+}
+
 void ensureUpdated(TemporalTileProvider& t) {
     if (!t.currentTileProvider) {
         update(t);
@@ -495,6 +732,13 @@ TileProvider::TileProvider() : properties::PropertyOwner({ "tileProvider" }) {}
 DefaultTileProvider::DefaultTileProvider(const ghoul::Dictionary& dictionary)
     : filePath(defaultprovider::FilePathInfo, "")
     , tilePixelSize(defaultprovider::TilePixelSizeInfo, 32, 32, 2048)
+    , cacheHitRate(defaultprovider::CacheHitRateInfo, 0.f, 0.f, 1.f)
+    , cacheEvictions(
+        defaultprovider::CacheEvictionsInfo,
+        0,
+        0,
+        std::numeric_limits<int>::max()
+    )
 {
     type = Type::DefaultTileProvider;
 
@@ -523,8 +767,33 @@ DefaultTileProvider::DefaultTileProvider(const ghoul::Dictionary& dictionary)
         padTiles = dictionary.value<bool>(defaultprovider::KeyPadTiles);
     }
 
+    if (dictionary.hasKeyAndValue<std::string>(defaultprovider::KeyTextureCompression)) {
+        using Compression = TileTextureInitData::Compression;
+        const std::string c = dictionary.value<std::string>(
+            defaultprovider::KeyTextureCompression
+        );
+        if (c == "BC1") {
+            compression = Compression::BC1;
+        }
+        else if (c == "BC3") {
+            compression = Compression::BC3;
+        }
+        else if (c != "None") {
+            LWARNING(fmt::format("Unknown texture compression '{}'", c));
+        }
+
+        if (compression != Compression::None &&
+            !OpenGLCap.isExtensionSupported(defaultprovider::CompressionExtension))
+        {
+            LWARNING(fmt::format(
+                "Texture compression requires {}", defaultprovider::CompressionExtension
+            ));
+            compression = Compression::None;
+        }
+    }
+
     TileTextureInitData initData(
-        tileTextureInitData(layerGroupID, padTiles, pixelSize)
+        tileTextureInitData(layerGroupID, padTiles, pixelSize, compression)
     );
     tilePixelSize = initData.dimensions.x;
 
@@ -548,6 +817,28 @@ DefaultTileProvider::DefaultTileProvider(const ghoul::Dictionary& dictionary)
 
     addProperty(filePath);
     addProperty(tilePixelSize);
+
+    cacheHitRate.setReadOnly(true);
+    addProperty(cacheHitRate);
+    cacheEvictions.setReadOnly(true);
+    addProperty(cacheEvictions);
+}
+
+
+
+
+
+BakedTileProvider::BakedTileProvider(const ghoul::Dictionary& dictionary)
+    : filePath(bakedprovider::FilePathInfo)
+{
+    type = Type::BakedTileProvider;
+
+    tileCache = global::moduleEngine.module<GlobeBrowsingModule>()->tileCache();
+    filePath = dictionary.value<std::string>(KeyFilePath);
+    layerGroupID = dictionary.value<layergroupid::GroupID>("LayerGroupID");
+    addProperty(filePath);
+
+    openLevels(*this);
 }
 
 
@@ -750,11 +1041,13 @@ TileProviderByLevel::TileProviderByLevel(const ghoul::Dictionary& dictionary) {
 TemporalTileProvider::TemporalTileProvider(const ghoul::Dictionary& dictionary)
     : initDict(dictionary)
     , filePath(temporal::FilePathInfo)
+    , prefetchTimeSteps(temporal::PrefetchTimeStepsInfo, 2, 0, 8)
 {
     type = Type::TemporalTileProvider;
 
     filePath = dictionary.value<std::string>(KeyFilePath);
     addProperty(filePath);
+    addProperty(prefetchTimeSteps);
 
     successfulInitialization = readFilePath(*this);
 
@@ -806,6 +1099,8 @@ bool initialize(TileProvider& tp) {
         }
         case Type::TemporalTileProvider:
             break;
+        case Type::BakedTileProvider:
+            break;
         default:
             throw ghoul::MissingCaseException();
     }
@@ -846,6 +1141,8 @@ bool deinitialize(TileProvider& tp) {
         }
         case Type::TemporalTileProvider:
             break;
+        case Type::BakedTileProvider:
+            break;
         default:
             throw ghoul::MissingCaseException();
     }
@@ -857,7 +1154,7 @@ bool deinitialize(TileProvider& tp) {
 
 
 
-Tile tile(TileProvider& tp, const TileIndex& tileIndex) {
+Tile tile(TileProvider& tp, const TileIndex& tileIndex, float priority) {
     switch (tp.type) {
         case Type::DefaultTileProvider: {
             DefaultTileProvider& t = static_cast<DefaultTileProvider&>(tp);
@@ -868,8 +1165,9 @@ Tile tile(TileProvider& tp, const TileIndex& tileIndex) {
                 const cache::ProviderTileKey key = { tileIndex, t.uniqueIdentifier };
                 const Tile tile = t.tileCache->get(key);
 
-                if (!tile.texture) {
-                    t.asyncTextureDataProvider->enqueueTileIO(tileIndex);
+                // Tiles that are waiting for their upload will be available shortly
+                if (!tile.texture && !t.tileCache->isUploadPending(key)) {
+                    t.asyncTextureDataProvider->enqueueTileIO(tileIndex, priority);
                 }
 
                 return tile;
@@ -940,13 +1238,13 @@ Tile tile(TileProvider& tp, const TileIndex& tileIndex) {
             TileProviderByIndex& t = static_cast<TileProviderByIndex&>(tp);
             const auto it = t.tileProviderMap.find(tileIndex.hashKey());
             const bool hasProvider = it != t.tileProviderMap.end();
-            return hasProvider ? tile(*it->second, tileIndex) : Tile();
+            return hasProvider ? tile(*it->second, tileIndex, priority) : Tile();
         }
         case Type::ByLevelTileProvider: {
             TileProviderByLevel& t = static_cast<TileProviderByLevel&>(tp);
             TileProvider* provider = levelProvider(t, tileIndex.level);
             if (provider) {
-                return tile(*provider, tileIndex);
+                return tile(*provider, tileIndex, priority);
             }
             else {
                 return Tile();
@@ -956,12 +1254,47 @@ Tile tile(TileProvider& tp, const TileIndex& tileIndex) {
             TemporalTileProvider& t = static_cast<TemporalTileProvider&>(tp);
             if (t.successfulInitialization) {
                 ensureUpdated(t);
-                return tile(*t.currentTileProvider, tileIndex);
+                Tile res = tile(*t.currentTileProvider, tileIndex, priority);
+
+                // Chunks that are not visible have a priority of 0 and should not cause
+                // any tiles in the upcoming time steps to be loaded
+                if (priority > 0.f) {
+                    float prefetchPriority = priority;
+                    for (TileProvider* provider : t.prefetchTileProviders) {
+                        prefetchPriority *= temporal::PrefetchPriorityScale;
+                        tile(*provider, tileIndex, prefetchPriority);
+                    }
+                }
+                return res;
             }
             else {
                 return Tile();
             }
         }
+        case Type::BakedTileProvider: {
+            BakedTileProvider& t = static_cast<BakedTileProvider&>(tp);
+            if (tileIndex.level > maxLevel(t)) {
+                return Tile{ nullptr, std::nullopt, Tile::Status::OutOfRange };
+            }
+            const TilePyramidLevel* level = pyramidLevel(t, tileIndex);
+            if (!level || !level->hasTile(tileIndex)) {
+                return Tile{ nullptr, std::nullopt, Tile::Status::Unavailable };
+            }
+
+            const cache::ProviderTileKey key = { tileIndex, t.uniqueIdentifier };
+            Tile tile = t.tileCache->get(key);
+            if (!tile.texture && !t.tileCache->isUploadPending(key)) {
+                const auto [it, isNew] = t.requestedTiles.try_emplace(
+                    tileIndex.hashKey(),
+                    tileIndex,
+                    priority
+                );
+                if (!isNew) {
+                    it->second.second = std::max(it->second.second, priority);
+                }
+            }
+            return tile;
+        }
         default:
             throw ghoul::MissingCaseException();
     }
@@ -1020,6 +1353,18 @@ Tile::Status tileStatus(TileProvider& tp, const TileIndex& index) {
                 return Tile::Status::Unavailable;
             }
         }
+        case Type::BakedTileProvider: {
+            BakedTileProvider& t = static_cast<BakedTileProvider&>(tp);
+            if (index.level > maxLevel(t)) {
+                return Tile::Status::OutOfRange;
+            }
+            const TilePyramidLevel* level = pyramidLevel(t, index);
+            if (!level || !level->hasTile(index)) {
+                return Tile::Status::Unavailable;
+            }
+            const cache::ProviderTileKey key = { index, t.uniqueIdentifier };
+            return t.tileCache->get(key).status;
+        }
         default:
             throw ghoul::MissingCaseException();
     }
@@ -1063,6 +1408,10 @@ TileDepthTransform depthTransform(TileProvider& tp) {
                 return { 1.f, 0.f };
             }
         }
+        case Type::BakedTileProvider: {
+            BakedTileProvider& t = static_cast<BakedTileProvider&>(tp);
+            return t.depthTransform;
+        }
         default:
             throw ghoul::MissingCaseException();
     }
@@ -1077,6 +1426,17 @@ void update(TileProvider& tp) {
     switch (tp.type) {
         case Type::DefaultTileProvider: {
             DefaultTileProvider& t = static_cast<DefaultTileProvider&>(tp);
+            const cache::MemoryAwareTileCache::ProviderStatistics stats =
+                t.tileCache->statistics(t.uniqueIdentifier);
+            const uint64_t nRequests = stats.nHits + stats.nMisses;
+            if (nRequests > 0) {
+                t.cacheHitRate = static_cast<float>(stats.nHits) / nRequests;
+            }
+            t.cacheEvictions = static_cast<int>(std::min<uint64_t>(
+                stats.nEvictions,
+                std::numeric_limits<int>::max()
+            ));
+
             if (!t.asyncTextureDataProvider) {
                 break;
             }
@@ -1088,7 +1448,12 @@ void update(TileProvider& tp) {
                 t.asyncTextureDataProvider = nullptr;
                 initAsyncTileDataReader(
                     t,
-                    tileTextureInitData(t.layerGroupID, t.padTiles, t.tilePixelSize)
+                    tileTextureInitData(
+                        t.layerGroupID,
+                        t.padTiles,
+                        t.tilePixelSize,
+                        t.compression
+                    )
                 );
             }
             break;
@@ -1124,9 +1489,15 @@ void update(TileProvider& tp) {
                     t.currentTileProvider = newCurrent;
                 }
                 update(*t.currentTileProvider);
+                updatePrefetchTileProviders(t);
             }
             break;
         }
+        case Type::BakedTileProvider: {
+            BakedTileProvider& t = static_cast<BakedTileProvider&>(tp);
+            readRequestedTiles(t);
+            break;
+        }
         default:
             throw ghoul::MissingCaseException();
     }
@@ -1148,7 +1519,12 @@ void reset(TileProvider& tp) {
             else {
                 initAsyncTileDataReader(
                     t,
-                    tileTextureInitData(t.layerGroupID, t.padTiles, t.tilePixelSize)
+                    tileTextureInitData(
+                        t.layerGroupID,
+                        t.padTiles,
+                        t.tilePixelSize,
+                        t.compression
+                    )
                 );
             }
             break;
@@ -1213,6 +1589,11 @@ void reset(TileProvider& tp) {
             }
             break;
         }
+        case Type::BakedTileProvider: {
+            BakedTileProvider& t = static_cast<BakedTileProvider&>(tp);
+            openLevels(t);
+            break;
+        }
         default:
             throw ghoul::MissingCaseException();
     }
@@ -1258,6 +1639,10 @@ int maxLevel(TileProvider& tp) {
                 return 0;
             }
         }
+        case Type::BakedTileProvider: {
+            BakedTileProvider& t = static_cast<BakedTileProvider&>(tp);
+            return std::max(static_cast<int>(t.levels.size()) - 1, 0);
+        }
         default:
             throw ghoul::MissingCaseException();
     }
@@ -1289,6 +1674,10 @@ float noDataValueAsFloat(TileProvider& tp) {
             return std::numeric_limits<float>::min();
         case Type::TemporalTileProvider:
             return std::numeric_limits<float>::min();
+        case Type::BakedTileProvider: {
+            BakedTileProvider& t = static_cast<BakedTileProvider&>(tp);
+            return t.noDataValue;
+        }
         default:
             throw ghoul::MissingCaseException();
     }
@@ -1298,7 +1687,9 @@ float noDataValueAsFloat(TileProvider& tp) {
 
 
 
-ChunkTile chunkTile(TileProvider& tp, TileIndex tileIndex, int parents, int maxParents) {
+ChunkTile chunkTile(TileProvider& tp, TileIndex tileIndex, int parents, int maxParents,
+                    float priority, ChunkTileResolver* resolver)
+{
     ghoul_assert(tp.isInitialized, "TileProvider was not initialized.");
 
     auto ascendToParent = [](TileIndex& tileIndex, TileUvTransform& uv) {
@@ -1322,7 +1713,7 @@ ChunkTile chunkTile(TileProvider& tp, TileIndex tileIndex, int parents, int maxP
 
     // Step 2. Traverse 0 or more parents up the chunkTree to make sure we're inside
     //         the range of defined data.
-    int maximumLevel = maxLevel(tp);
+    int maximumLevel = resolver ? resolver->maxLevel(tp) : maxLevel(tp);
     while (tileIndex.level > maximumLevel) {
         ascendToParent(tileIndex, uvTransform);
         maxParents--;
@@ -1334,7 +1725,9 @@ ChunkTile chunkTile(TileProvider& tp, TileIndex tileIndex, int parents, int maxP
     // Step 3. Traverse 0 or more parents up the chunkTree until we find a chunk that
     //         has a loaded tile ready to use.
     while (tileIndex.level > 1) {
-        Tile t = tile(tp, tileIndex);
+        Tile t = resolver ?
+            resolver->tile(tp, tileIndex, priority) :
+            tile(tp, tileIndex, priority);
         if (t.status != Tile::Status::OK) {
             if (--maxParents < 0) {
                 return ChunkTile{ Tile(), uvTransform, TileDepthTransform() };
@@ -1354,13 +1747,15 @@ ChunkTile chunkTile(TileProvider& tp, TileIndex tileIndex, int parents, int maxP
 
 
 
-ChunkTilePile chunkTilePile(TileProvider& tp, TileIndex tileIndex, int pileSize) {
+ChunkTilePile chunkTilePile(TileProvider& tp, TileIndex tileIndex, int pileSize,
+                            float priority, ChunkTileResolver* resolver)
+{
     ghoul_assert(tp.isInitialized, "TileProvider was not initialized.");
     ghoul_assert(pileSize >= 0, "pileSize must be positive");
 
     ChunkTilePile chunkTilePile(pileSize);
     for (int i = 0; i < pileSize; ++i) {
-        chunkTilePile[i] = chunkTile(tp, tileIndex, i);
+        chunkTilePile[i] = chunkTile(tp, tileIndex, i, 1337, priority, resolver);
         if (chunkTilePile[i].tile.status == Tile::Status::Unavailable) {
             if (i > 0) {
                 // First iteration
@@ -1380,4 +1775,47 @@ ChunkTilePile chunkTilePile(TileProvider& tp, TileIndex tileIndex, int pileSize)
     return chunkTilePile;
 }
 
+bool ChunkTileResolver::Key::operator==(const Key& rhs) const {
+    return tileProvider == rhs.tileProvider && tileIndex == rhs.tileIndex;
+}
+
+size_t ChunkTileResolver::KeyHasher::operator()(const Key& key) const {
+    const size_t h = std::hash<const TileProvider*>()(key.tileProvider);
+    return h ^ (std::hash<TileIndex::TileHashKey>()(key.tileIndex) + (h << 6));
+}
+
+void ChunkTileResolver::clear() {
+    _tiles.clear();
+    _maxLevels.clear();
+}
+
+const Tile& ChunkTileResolver::tile(TileProvider& tp, const TileIndex& tileIndex,
+                                    float priority)
+{
+    const Key key = { &tp, tileIndex.hashKey() };
+    const auto it = _tiles.find(key);
+    if (it == _tiles.end()) {
+        Entry entry = { tileprovider::tile(tp, tileIndex, priority), priority };
+        return _tiles.emplace(key, std::move(entry)).first->second.tile;
+    }
+
+    Entry& entry = it->second;
+    if (entry.tile.status != Tile::Status::OK && priority > entry.priority) {
+        // The tile is needed by a more important chunk than before, so the request is
+        // repeated to raise its priority
+        entry = { tileprovider::tile(tp, tileIndex, priority), priority };
+    }
+    return entry.tile;
+}
+
+int ChunkTileResolver::maxLevel(TileProvider& tp) {
+    const auto it = _maxLevels.find(&tp);
+    if (it != _maxLevels.end()) {
+        return it->second;
+    }
+    const int level = tileprovider::maxLevel(tp);
+    _maxLevels[&tp] = level;
+    return level;
+}
+
 } // namespace openspace::globebrowsing::tileprovider
@@ -31,10 +31,13 @@
 #include <modules/globebrowsing/src/ellipsoid.h>
 #include <modules/globebrowsing/src/layergroupid.h>
 #include <modules/globebrowsing/src/tileindex.h>
+#include <modules/globebrowsing/src/tilepyramid.h>
 #include <modules/globebrowsing/src/tiletextureinitdata.h>
 #include <modules/globebrowsing/src/timequantizer.h>
 #include <openspace/properties/stringproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
+#include <optional>
 #include <unordered_map>
 
 struct CPLXMLNode;
@@ -62,7 +65,8 @@ enum class Type {
     TemporalTileProvider,
     TileIndexTileProvider,
     ByIndexTileProvider,
-    ByLevelTileProvider
+    ByLevelTileProvider,
+    BakedTileProvider
 };
 
 
@@ -89,9 +93,13 @@ struct DefaultTileProvider : public TileProvider {
 
     properties::StringProperty filePath;
     properties::IntProperty tilePixelSize;
+    properties::FloatProperty cacheHitRate;
+    properties::IntProperty cacheEvictions;
     layergroupid::GroupID layerGroupID = layergroupid::GroupID::Unknown;
     bool performPreProcessing = false;
     bool padTiles = true;
+    TileTextureInitData::Compression compression =
+        TileTextureInitData::Compression::None;
 };
 
 struct SingleImageProvider : public TileProvider {
@@ -180,6 +188,10 @@ struct TemporalTileProvider : public TileProvider {
 
     TileProvider* currentTileProvider = nullptr;
 
+    /// The tile providers of the upcoming time steps, ordered by their distance in time
+    std::vector<TileProvider*> prefetchTileProviders;
+    properties::IntProperty prefetchTimeSteps;
+
     TimeFormatType timeFormat;
     TimeQuantizer timeQuantizer;
 
@@ -188,6 +200,73 @@ struct TemporalTileProvider : public TileProvider {
 
 
 
+/**
+ * Provides the tiles of a tile pyramid that was created by the BakeTilePyramidTask. The
+ * tiles are read from the level files of the pyramid directly into the tile cache
+ * without going through GDAL, so baked layers neither require network access nor
+ * depend on the performance of the reprojection at runtime.
+ */
+struct BakedTileProvider : public TileProvider {
+    BakedTileProvider(const ghoul::Dictionary& dictionary);
+
+    properties::StringProperty filePath;
+    layergroupid::GroupID layerGroupID = layergroupid::GroupID::Unknown;
+
+    /// The levels of the pyramid, the level i is stored at index i if it exists
+    std::vector<std::unique_ptr<TilePyramidLevel>> levels;
+    std::optional<TileTextureInitData> initData;
+    TileDepthTransform depthTransform = { 1.f, 0.f };
+    float noDataValue = 0.f;
+
+    /// The tiles that have been requested since the last update with their priority
+    std::unordered_map<
+        TileIndex::TileHashKey, std::pair<TileIndex, float>
+    > requestedTiles;
+
+    cache::MemoryAwareTileCache* tileCache = nullptr;
+};
+
+/**
+ * Memoizes the tiles and maximum levels of the tile providers that are looked up while
+ * the chunk tiles of all chunks of a frame are resolved. Neighboring chunks fall back to
+ * the same parent tiles and the levels of a chunk tile pile walk the same ancestors, so
+ * without the memoization each of these tiles would be looked up many times per frame.
+ * The memoized tiles only stay valid as long as no tiles are uploaded or evicted, so
+ * #clear must be called at the beginning of every frame.
+ */
+class ChunkTileResolver {
+public:
+    void clear();
+
+    /**
+     * Returns the tile of the \p tp for the \p tileIndex like the <code>tile</code>
+     * function. A tile that is not available yet is only requested again if the
+     * \p priority is higher than that of any previous request in this frame.
+     */
+    const Tile& tile(TileProvider& tp, const TileIndex& tileIndex, float priority);
+    int maxLevel(TileProvider& tp);
+
+private:
+    struct Key {
+        const TileProvider* tileProvider;
+        TileIndex::TileHashKey tileIndex;
+
+        bool operator==(const Key& rhs) const;
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Tile tile;
+        float priority;
+    };
+
+    std::unordered_map<Key, Entry, KeyHasher> _tiles;
+    std::unordered_map<const TileProvider*, int> _maxLevels;
+};
+
 void initializeDefaultTile();
 void deinitializeDefaultTile();
 
@@ -197,12 +276,23 @@ std::unique_ptr<TileProvider> createFromDictionary(layergroupid::TypeID layerTyp
 bool initialize(TileProvider& tp);
 bool deinitialize(TileProvider& tp);
 
-Tile tile(TileProvider& tp, const TileIndex& tileIndex);
+/**
+ * Returns the tile for the \p tileIndex. If the tile is not available yet, it is
+ * requested with the provided \p priority. Requests with a higher priority are loaded
+ * first, and requests that are not repeated in the following frame are cancelled.
+ */
+Tile tile(TileProvider& tp, const TileIndex& tileIndex, float priority = 0.f);
 
+/**
+ * Returns the tile for the \p tileIndex, or for the closest of its ancestors that has a
+ * tile available, together with the transformation of the texture coordinates into
+ * that tile. If a \p resolver is provided, the tiles are looked up through it.
+ */
 ChunkTile chunkTile(TileProvider& tp, TileIndex tileIndex, int parents = 0,
-    int maxParents = 1337);
+    int maxParents = 1337, float priority = 0.f, ChunkTileResolver* resolver = nullptr);
 
-ChunkTilePile chunkTilePile(TileProvider& tp, TileIndex tileIndex, int pileSize);
+ChunkTilePile chunkTilePile(TileProvider& tp, TileIndex tileIndex, int pileSize,
+    float priority = 0.f, ChunkTileResolver* resolver = nullptr);
 
 /**
  * Returns the status of a <code>Tile</code>. The <code>Tile::Status</code>
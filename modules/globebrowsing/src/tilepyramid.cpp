@@ -0,0 +1,279 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/tilepyramid.h>
+
+#include <modules/globebrowsing/src/tilebufferpool.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    constexpr const char* LevelFileExtension = ".tiles";
+
+    // The maximum number of values in the TileMetaData, one per raster
+    constexpr const int32_t MaxMetaDataValues = 4;
+} // namespace
+
+namespace openspace::globebrowsing {
+
+static_assert(
+    std::is_trivially_copyable_v<TilePyramidHeader> && sizeof(TilePyramidHeader) == 64,
+    "The header is written to and read from the level files as is"
+);
+
+namespace tilepyramid {
+
+std::string levelFilePath(const std::string& directory, int level) {
+    return fmt::format("{}/{}{}", directory, level, LevelFileExtension);
+}
+
+glm::ivec2 numTiles(int level) {
+    // The western and the eastern hemisphere are the two tiles on level 1
+    return glm::ivec2(1 << level, std::max((1 << level) / 2, 1));
+}
+
+uint64_t tileRecordSize(const TilePyramidHeader& header) {
+    const uint64_t nValues = static_cast<uint64_t>(header.nMetaDataValues);
+    return nValues * (2 * sizeof(float) + sizeof(uint8_t)) + header.nBytesPerTile;
+}
+
+void writeTileRecord(std::ostream& stream, const TilePyramidHeader& header,
+                     const RawTile& rawTile)
+{
+    ghoul_assert(rawTile.error == RawTile::ReadError::None, "Tile must be valid");
+    ghoul_assert(rawTile.imageData, "Tile must have image data");
+
+    if (header.nMetaDataValues > 0) {
+        const size_t nValues = static_cast<size_t>(header.nMetaDataValues);
+        const TileMetaData& meta = rawTile.tileMetaData;
+
+        std::vector<float> maxValues = meta.maxValues;
+        maxValues.resize(nValues, 0.f);
+        std::vector<float> minValues = meta.minValues;
+        minValues.resize(nValues, 0.f);
+        std::vector<uint8_t> hasMissingData(
+            meta.hasMissingData.begin(),
+            meta.hasMissingData.end()
+        );
+        hasMissingData.resize(nValues, 0);
+
+        stream.write(
+            reinterpret_cast<const char*>(maxValues.data()),
+            nValues * sizeof(float)
+        );
+        stream.write(
+            reinterpret_cast<const char*>(minValues.data()),
+            nValues * sizeof(float)
+        );
+        stream.write(reinterpret_cast<const char*>(hasMissingData.data()), nValues);
+    }
+
+    stream.write(
+        reinterpret_cast<const char*>(rawTile.imageData.get()),
+        header.nBytesPerTile
+    );
+}
+
+} // namespace tilepyramid
+
+TilePyramidLevel::TilePyramidLevel(std::string path)
+    : _path(std::move(path))
+{
+#ifdef WIN32
+    HANDLE file = CreateFileA(
+        _path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_RANDOM_ACCESS,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        throw ghoul::RuntimeError(fmt::format("Could not open '{}'", _path));
+    }
+    _fileHandle = file;
+#else // WIN32
+    _fileDescriptor = open(_path.c_str(), O_RDONLY);
+    if (_fileDescriptor == -1) {
+        throw ghoul::RuntimeError(fmt::format("Could not open '{}'", _path));
+    }
+#endif // WIN32
+
+    const bool hasHeader = readAt(0, sizeof(TilePyramidHeader), &_header);
+    if (!hasHeader || _header.magic != TilePyramidHeader::Magic) {
+        throw ghoul::RuntimeError(fmt::format("'{}' is not a tile pyramid", _path));
+    }
+    if (_header.version != TilePyramidHeader::CurrentVersion) {
+        throw ghoul::RuntimeError(fmt::format(
+            "'{}' has version {}, expected {}",
+            _path, _header.version, TilePyramidHeader::CurrentVersion
+        ));
+    }
+    if (_header.nMetaDataValues < 0 || _header.nMetaDataValues > MaxMetaDataValues) {
+        throw ghoul::RuntimeError(fmt::format("'{}' has invalid meta data", _path));
+    }
+
+    _numTiles = tilepyramid::numTiles(_header.level);
+    _tileOffsets.resize(static_cast<size_t>(_numTiles.x) * _numTiles.y);
+    const bool hasOffsets = readAt(
+        sizeof(TilePyramidHeader),
+        _tileOffsets.size() * sizeof(uint64_t),
+        _tileOffsets.data()
+    );
+    if (!hasOffsets) {
+        throw ghoul::RuntimeError(fmt::format("'{}' is truncated", _path));
+    }
+}
+
+TilePyramidLevel::~TilePyramidLevel() {
+#ifdef WIN32
+    if (_fileHandle) {
+        CloseHandle(_fileHandle);
+    }
+#else // WIN32
+    if (_fileDescriptor != -1) {
+        close(_fileDescriptor);
+    }
+#endif // WIN32
+}
+
+const TilePyramidHeader& TilePyramidLevel::header() const {
+    return _header;
+}
+
+bool TilePyramidLevel::hasTile(const TileIndex& tileIndex) const {
+    if (tileIndex.level != _header.level || tileIndex.x < 0 || tileIndex.y < 0 ||
+        tileIndex.x >= _numTiles.x || tileIndex.y >= _numTiles.y)
+    {
+        return false;
+    }
+    const size_t i = static_cast<size_t>(tileIndex.y) * _numTiles.x + tileIndex.x;
+    return _tileOffsets[i] != 0;
+}
+
+std::optional<RawTile> TilePyramidLevel::readTile(const TileIndex& tileIndex,
+                                                  const TileTextureInitData& initData,
+                                          cache::TileBufferPool* tileBufferPool) const
+{
+    if (!hasTile(tileIndex) || initData.hashKey != _header.initDataHashKey ||
+        initData.totalNumBytes != _header.nBytesPerTile)
+    {
+        return std::nullopt;
+    }
+
+    const size_t i = static_cast<size_t>(tileIndex.y) * _numTiles.x + tileIndex.x;
+    uint64_t offset = _tileOffsets[i];
+
+    RawTile rawTile;
+    if (_header.nMetaDataValues > 0) {
+        // The meta data is small enough to be read in one go before the pixel data
+        const size_t nValues = static_cast<size_t>(_header.nMetaDataValues);
+        std::array<std::byte, MaxMetaDataValues * (2 * sizeof(float) + 1)> buffer;
+        const size_t nMetaDataBytes = nValues * (2 * sizeof(float) + sizeof(uint8_t));
+        if (!readAt(offset, nMetaDataBytes, buffer.data())) {
+            return std::nullopt;
+        }
+        offset += nMetaDataBytes;
+
+        TileMetaData& meta = rawTile.tileMetaData;
+        meta.maxValues.resize(nValues);
+        meta.minValues.resize(nValues);
+        std::memcpy(meta.maxValues.data(), buffer.data(), nValues * sizeof(float));
+        std::memcpy(
+            meta.minValues.data(),
+            buffer.data() + nValues * sizeof(float),
+            nValues * sizeof(float)
+        );
+        const std::byte* missing = buffer.data() + 2 * nValues * sizeof(float);
+        meta.hasMissingData.resize(nValues);
+        for (size_t j = 0; j < nValues; ++j) {
+            meta.hasMissingData[j] = missing[j] != std::byte(0);
+        }
+    }
+
+    rawTile.imageData = tileBufferPool ?
+        tileBufferPool->acquire(initData) :
+        std::unique_ptr<std::byte[]>(new std::byte[initData.totalNumBytes]);
+    if (!readAt(offset, initData.totalNumBytes, rawTile.imageData.get())) {
+        if (tileBufferPool) {
+            tileBufferPool->release(initData, std::move(rawTile.imageData));
+        }
+        return std::nullopt;
+    }
+
+    rawTile.textureInitData = initData;
+    rawTile.tileIndex = tileIndex;
+    rawTile.error = RawTile::ReadError::None;
+    return rawTile;
+}
+
+bool TilePyramidLevel::readAt(uint64_t offset, size_t size, void* destination) const {
+    char* dest = reinterpret_cast<char*>(destination);
+    while (size > 0) {
+#ifdef WIN32
+        // ReadFile takes a 32 bit size and reads at the offset given in the overlapped
+        // structure without moving a shared file pointer
+        const DWORD nBytes = static_cast<DWORD>(
+            std::min<size_t>(size, std::numeric_limits<DWORD>::max())
+        );
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD nRead = 0;
+        if (!ReadFile(_fileHandle, dest, nBytes, &nRead, &overlapped) || nRead == 0) {
+            return false;
+        }
+#else // WIN32
+        const ssize_t nRead = pread(
+            _fileDescriptor,
+            dest,
+            size,
+            static_cast<off_t>(offset)
+        );
+        if (nRead <= 0) {
+            return false;
+        }
+#endif // WIN32
+        dest += nRead;
+        offset += static_cast<uint64_t>(nRead);
+        size -= static_cast<size_t>(nRead);
+    }
+    return true;
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,141 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILEPYRAMID___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILEPYRAMID___H__
+
+#include <modules/globebrowsing/src/basictypes.h>
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace openspace::globebrowsing {
+
+namespace cache { class TileBufferPool; }
+class TileTextureInitData;
+
+/**
+ * A baked tile pyramid stores the decoded tiles of a layer on disk so that they can be
+ * served without GDAL. Each level of the pyramid is stored in its own file that starts
+ * with a TilePyramidHeader, followed by one file offset for every tile of the level and
+ * the tile records. The offset is 0 for tiles that could not be read when the pyramid
+ * was baked. Each tile record consists of the TileMetaData of the tile followed by its
+ * pixel data, laid out exactly as described by the TileTextureInitData of the pyramid,
+ * so that it can be read into a tile buffer without any conversion.
+ */
+struct TilePyramidHeader {
+    static constexpr const uint32_t Magic = 0x5054534f; // 'OSTP'
+    static constexpr const int32_t CurrentVersion = 1;
+
+    uint32_t magic = Magic;
+    int32_t version = CurrentVersion;
+    int32_t level = 0;
+    int32_t maxLevel = 0;
+    int32_t layerGroupID = 0;
+    int32_t tilePixelSize = 0;
+    uint32_t padTiles = 0;
+    /// The number of values of the TileMetaData; 0 if the tiles were not preprocessed
+    int32_t nMetaDataValues = 0;
+    uint64_t initDataHashKey = 0;
+    uint64_t nBytesPerTile = 0;
+    TileDepthTransform depthTransform = { 1.f, 0.f };
+    float noDataValue = 0.f;
+    uint32_t reserved = 0;
+};
+
+namespace tilepyramid {
+
+/// Returns the path of the file in the \p directory that stores the tiles of \p level
+std::string levelFilePath(const std::string& directory, int level);
+
+/// Returns the number of tiles in x and y direction on the \p level
+glm::ivec2 numTiles(int level);
+
+/// Returns the number of bytes that a tile record occupies in a level file
+uint64_t tileRecordSize(const TilePyramidHeader& header);
+
+/**
+ * Writes the tile record for the \p rawTile, which must not have a read error, to the
+ * \p stream. The meta data is only written if the \p header requires it.
+ */
+void writeTileRecord(std::ostream& stream, const TilePyramidHeader& header,
+    const RawTile& rawTile);
+
+} // namespace tilepyramid
+
+/**
+ * Provides random access to the tiles of one level file of a baked tile pyramid. The
+ * tiles are read with positional reads, so this class can be used from multiple threads
+ * at the same time.
+ */
+class TilePyramidLevel {
+public:
+    /**
+     * Opens the level file at \p path and reads its header and tile offsets.
+     *
+     * \throw ghoul::RuntimeError If the file cannot be opened or is not a level file of
+     *        the current version
+     */
+    explicit TilePyramidLevel(std::string path);
+    ~TilePyramidLevel();
+
+    TilePyramidLevel(const TilePyramidLevel&) = delete;
+    TilePyramidLevel& operator=(const TilePyramidLevel&) = delete;
+
+    const TilePyramidHeader& header() const;
+
+    /// Returns whether the tile with the \p tileIndex was stored when baking the level
+    bool hasTile(const TileIndex& tileIndex) const;
+
+    /**
+     * Reads the tile with the \p tileIndex, which has to belong to this level, into a
+     * buffer of the \p tileBufferPool, if it is not <code>nullptr</code>. Returns
+     * <code>std::nullopt</code> if the tile is not stored or could not be read.
+     */
+    std::optional<RawTile> readTile(const TileIndex& tileIndex,
+        const TileTextureInitData& initData, cache::TileBufferPool* tileBufferPool) const;
+
+private:
+    bool readAt(uint64_t offset, size_t size, void* destination) const;
+
+    const std::string _path;
+    TilePyramidHeader _header;
+    std::vector<uint64_t> _tileOffsets;
+    glm::ivec2 _numTiles = glm::ivec2(0);
+
+#ifdef WIN32
+    void* _fileHandle = nullptr;
+#else // WIN32
+    int _fileDescriptor = -1;
+#endif // WIN32
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILEPYRAMID___H__
@@ -0,0 +1,391 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/tileservice.h>
+
+#include <modules/globebrowsing/src/rawtiledatareader.h>
+#include <modules/globebrowsing/src/tilebufferpool.h>
+#include <modules/globebrowsing/src/tileloadjob.h>
+#include <ghoul/fmt.h>
+#include <ghoul/io/socket/tcpsocket.h>
+#include <ghoul/io/socket/tcpsocketserver.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+
+namespace {
+    constexpr const char* _loggerCat = "TileService";
+
+    constexpr const std::chrono::milliseconds AcceptPollInterval(100);
+    constexpr const std::chrono::seconds ReconnectInterval(5);
+
+    // The meta data never has more values than the number of rasters of a texture
+    constexpr const int32_t MaxMetaDataValues = 4;
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+TileServer::TileServer(DiskTileCache* diskCache, TileBufferPool* pool)
+    : _diskCache(diskCache)
+    , _pool(pool)
+{}
+
+TileServer::~TileServer() {
+    stop();
+}
+
+void TileServer::start(int port) {
+    if (_isRunning) {
+        return;
+    }
+    _server = std::make_unique<ghoul::io::TcpSocketServer>();
+    _server->listen(port);
+    _isRunning = true;
+    _acceptThread = std::thread([this]() { acceptClients(); });
+    LINFO(fmt::format("Serving tiles on port {}", port));
+}
+
+void TileServer::stop() {
+    if (!_isRunning) {
+        return;
+    }
+    _isRunning = false;
+    if (_acceptThread.joinable()) {
+        _acceptThread.join();
+    }
+    _server->close();
+
+    std::lock_guard<std::mutex> guard(_clientMutex);
+    for (std::unique_ptr<Client>& client : _clients) {
+        client->socket->disconnect();
+        if (client->thread.joinable()) {
+            client->thread.join();
+        }
+    }
+    _clients.clear();
+}
+
+bool TileServer::isRunning() const {
+    return _isRunning;
+}
+
+void TileServer::addDataset(unsigned int datasetIdentifier, RawTileDataReader& reader) {
+    std::unique_lock lock(_datasetMutex);
+    _datasets.emplace(datasetIdentifier, &reader);
+}
+
+void TileServer::removeDataset(unsigned int datasetIdentifier, RawTileDataReader& reader)
+{
+    std::unique_lock lock(_datasetMutex);
+    auto range = _datasets.equal_range(datasetIdentifier);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == &reader) {
+            _datasets.erase(it);
+            return;
+        }
+    }
+}
+
+void TileServer::acceptClients() {
+    while (_isRunning) {
+        std::unique_ptr<ghoul::io::TcpSocket> socket = _server->nextPendingTcpSocket();
+        if (!socket) {
+            std::this_thread::sleep_for(AcceptPollInterval);
+            continue;
+        }
+        socket->startStreams();
+        LDEBUG(fmt::format("Accepted connection from {}", socket->address()));
+
+        std::lock_guard<std::mutex> guard(_clientMutex);
+        for (std::unique_ptr<Client>& client : _clients) {
+            if (client->isFinished && client->thread.joinable()) {
+                client->thread.join();
+            }
+        }
+        _clients.erase(
+            std::remove_if(
+                _clients.begin(),
+                _clients.end(),
+                [](const std::unique_ptr<Client>& c) { return c->isFinished.load(); }
+            ),
+            _clients.end()
+        );
+
+        std::unique_ptr<Client> client = std::make_unique<Client>();
+        client->socket = std::move(socket);
+        Client* c = client.get();
+        c->thread = std::thread([this, c]() {
+            handleClient(*c);
+            c->isFinished = true;
+        });
+        _clients.push_back(std::move(client));
+    }
+}
+
+void TileServer::handleClient(Client& client) {
+    ghoul::io::TcpSocket& socket = *client.socket;
+
+    tileservice::Request request;
+    while (_isRunning &&
+           socket.get<char>(reinterpret_cast<char*>(&request), sizeof(request)))
+    {
+        if (request.magic != tileservice::Magic) {
+            LERROR(fmt::format("Invalid request from {}", socket.address()));
+            socket.disconnect();
+            return;
+        }
+        if (!sendTile(socket, request)) {
+            // The client cannot make sense of the rest of the stream anymore
+            socket.disconnect();
+            return;
+        }
+    }
+}
+
+bool TileServer::sendTile(ghoul::io::TcpSocket& socket,
+                          const tileservice::Request& request)
+{
+    tileservice::Response response;
+
+    std::optional<RawTile> rawTile;
+    {
+        std::shared_lock lock(_datasetMutex);
+        auto it = _datasets.find(request.datasetIdentifier);
+        if (it != _datasets.end() &&
+            it->second->tileTextureInitData().hashKey == request.initDataHashKey)
+        {
+            // The job reads the tile through the same tiers as the tiles of this node,
+            // including the block compression
+            TileLoadJob job(
+                *it->second,
+                TileIndex(request.x, request.y, request.level),
+                _diskCache,
+                request.datasetIdentifier
+            );
+            job.execute();
+            rawTile = job.product();
+        }
+    }
+
+    if (!rawTile) {
+        response.status = tileservice::Status::UnknownDataset;
+    }
+    else if (rawTile->error != RawTile::ReadError::None || !rawTile->imageData ||
+             !rawTile->textureInitData)
+    {
+        response.status = tileservice::Status::ReadError;
+    }
+    if (response.status != tileservice::Status::Ok) {
+        if (rawTile && rawTile->textureInitData && _pool) {
+            _pool->release(*rawTile->textureInitData, std::move(rawTile->imageData));
+        }
+        return socket.put<char>(
+            reinterpret_cast<const char*>(&response),
+            sizeof(response)
+        );
+    }
+
+    const TileTextureInitData& initData = *rawTile->textureInitData;
+    const TileMetaData& meta = rawTile->tileMetaData;
+    response.nValues = static_cast<int32_t>(meta.maxValues.size());
+    response.nBytes = initData.textureNumBytes;
+    std::vector<uint8_t> hasMissingData(
+        meta.hasMissingData.begin(),
+        meta.hasMissingData.end()
+    );
+    hasMissingData.resize(response.nValues, 0);
+
+    const size_t nValueBytes = response.nValues * sizeof(float);
+    // The image data is sent straight out of the tile buffer
+    const bool success =
+        socket.put<char>(reinterpret_cast<const char*>(&response), sizeof(response)) &&
+        socket.put<char>(
+            reinterpret_cast<const char*>(meta.maxValues.data()),
+            nValueBytes
+        ) &&
+        socket.put<char>(
+            reinterpret_cast<const char*>(meta.minValues.data()),
+            nValueBytes
+        ) &&
+        socket.put<char>(
+            reinterpret_cast<const char*>(hasMissingData.data()),
+            hasMissingData.size()
+        ) &&
+        socket.put<char>(
+            reinterpret_cast<const char*>(rawTile->imageData.get()),
+            response.nBytes
+        );
+
+    if (_pool) {
+        _pool->release(initData, std::move(rawTile->imageData));
+    }
+    return success;
+}
+
+TileServiceClient::TileServiceClient(std::string address, int port, TileBufferPool* pool)
+    : _address(std::move(address))
+    , _port(port)
+    , _pool(pool)
+{}
+
+TileServiceClient::~TileServiceClient() {
+    std::lock_guard<std::mutex> lock(_connectionMutex);
+    for (std::unique_ptr<ghoul::io::TcpSocket>& socket : _idleConnections) {
+        socket->disconnect();
+    }
+}
+
+std::optional<RawTile> TileServiceClient::get(unsigned int datasetIdentifier,
+                                              const TileIndex& tileIndex,
+                                              const TileTextureInitData& initData)
+{
+    std::unique_ptr<ghoul::io::TcpSocket> socket = acquireConnection();
+    if (!socket) {
+        return std::nullopt;
+    }
+
+    tileservice::Request request;
+    request.datasetIdentifier = datasetIdentifier;
+    request.x = tileIndex.x;
+    request.y = tileIndex.y;
+    request.level = tileIndex.level;
+    request.initDataHashKey = initData.hashKey;
+
+    tileservice::Response response;
+    const bool hasResponse =
+        socket->put<char>(reinterpret_cast<const char*>(&request), sizeof(request)) &&
+        socket->get<char>(reinterpret_cast<char*>(&response), sizeof(response));
+    if (!hasResponse || response.magic != tileservice::Magic) {
+        LWARNING(fmt::format("Lost connection to the tile server {}", _address));
+        return std::nullopt;
+    }
+
+    RawTile rawTile;
+    rawTile.tileIndex = tileIndex;
+    rawTile.textureInitData = initData;
+    if (response.status != tileservice::Status::Ok) {
+        // The tile is requested again once the tile provider notices the error. This
+        // happens while the serving node is still loading the layer
+        rawTile.error = RawTile::ReadError::Failure;
+        releaseConnection(std::move(socket));
+        return rawTile;
+    }
+
+    if (response.nValues < 0 || response.nValues > MaxMetaDataValues ||
+        response.nBytes != initData.textureNumBytes)
+    {
+        LERROR(fmt::format(
+            "Tile {}/{}/{} of dataset {:08x} does not match the local layout",
+            tileIndex.level, tileIndex.x, tileIndex.y, datasetIdentifier
+        ));
+        return std::nullopt;
+    }
+
+    TileMetaData& meta = rawTile.tileMetaData;
+    meta.maxValues.resize(response.nValues);
+    meta.minValues.resize(response.nValues);
+    std::vector<uint8_t> hasMissingData(response.nValues);
+    const size_t nValueBytes = response.nValues * sizeof(float);
+
+    // The buffer has the full size of a tile so that it can be reused by the pool later
+    rawTile.imageData = _pool ?
+        _pool->acquire(initData) :
+        std::unique_ptr<std::byte[]>(new std::byte[initData.totalNumBytes]);
+
+    const bool success =
+        socket->get<char>(reinterpret_cast<char*>(meta.maxValues.data()), nValueBytes) &&
+        socket->get<char>(reinterpret_cast<char*>(meta.minValues.data()), nValueBytes) &&
+        socket->get<char>(
+            reinterpret_cast<char*>(hasMissingData.data()),
+            hasMissingData.size()
+        ) &&
+        socket->get<char>(
+            reinterpret_cast<char*>(rawTile.imageData.get()),
+            response.nBytes
+        );
+    if (!success) {
+        LWARNING(fmt::format("Lost connection to the tile server {}", _address));
+        if (_pool) {
+            _pool->release(initData, std::move(rawTile.imageData));
+        }
+        return std::nullopt;
+    }
+    meta.hasMissingData = std::vector<bool>(hasMissingData.begin(), hasMissingData.end());
+
+    releaseConnection(std::move(socket));
+    rawTile.error = RawTile::ReadError::None;
+    return rawTile;
+}
+
+std::unique_ptr<ghoul::io::TcpSocket> TileServiceClient::acquireConnection() {
+    using namespace std::chrono;
+    {
+        std::lock_guard<std::mutex> lock(_connectionMutex);
+        if (!_idleConnections.empty()) {
+            std::unique_ptr<ghoul::io::TcpSocket> socket =
+                std::move(_idleConnections.back());
+            _idleConnections.pop_back();
+            return socket;
+        }
+        if (_hasConnectionFailed &&
+            steady_clock::now() - _lastConnectionFailure < ReconnectInterval)
+        {
+            return nullptr;
+        }
+    }
+
+    auto socket = std::make_unique<ghoul::io::TcpSocket>(_address, _port);
+    try {
+        socket->connect();
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+    }
+
+    std::lock_guard<std::mutex> lock(_connectionMutex);
+    if (!socket->isConnected()) {
+        if (!_hasConnectionFailed) {
+            LWARNING(fmt::format(
+                "Could not connect to the tile server {}:{}, reading tiles locally",
+                _address, _port
+            ));
+        }
+        _hasConnectionFailed = true;
+        _lastConnectionFailure = steady_clock::now();
+        return nullptr;
+    }
+    if (_hasConnectionFailed) {
+        LINFO(fmt::format("Connected to the tile server {}:{}", _address, _port));
+        _hasConnectionFailed = false;
+    }
+    return socket;
+}
+
+void TileServiceClient::releaseConnection(std::unique_ptr<ghoul::io::TcpSocket> socket)
+{
+    std::lock_guard<std::mutex> lock(_connectionMutex);
+    _idleConnections.push_back(std::move(socket));
+}
+
+} // namespace openspace::globebrowsing::cache
@@ -0,0 +1,194 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_SERVICE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_SERVICE___H__
+
+#include <modules/globebrowsing/src/rawtile.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ghoul::io {
+    class TcpSocket;
+    class TcpSocketServer;
+} // namespace ghoul::io
+
+namespace openspace::globebrowsing { class RawTileDataReader; }
+
+namespace openspace::globebrowsing::cache {
+
+class DiskTileCache;
+class TileBufferPool;
+
+/**
+ * The binary protocol that is spoken between the TileServer and the TileServiceClient.
+ * All values are sent in the native byte order, as all nodes of a cluster share the same
+ * architecture. Each request is answered with exactly one response before the next
+ * request is sent on the same connection.
+ */
+namespace tileservice {
+    constexpr const uint32_t Magic = 0x4F535431; // 'OST1'
+
+    struct Request {
+        uint32_t magic = Magic;
+        uint32_t datasetIdentifier = 0;
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t level = 0;
+        uint32_t padding = 0;
+        TileTextureInitData::HashKey initDataHashKey = 0;
+    };
+
+    enum class Status : uint32_t {
+        /// The tile follows the response header
+        Ok = 0,
+        /// The serving node has not loaded the dataset (yet)
+        UnknownDataset,
+        /// The tile could not be read from the dataset
+        ReadError
+    };
+
+    /**
+     * Followed by \c nValues maximum values, \c nValues minimum values, \c nValues bytes
+     * of missing data flags, and \c nBytes bytes of finished, possibly block compressed,
+     * image data if the status is Status::Ok.
+     */
+    struct Response {
+        uint32_t magic = Magic;
+        Status status = Status::Ok;
+        int32_t nValues = 0;
+        uint32_t padding = 0;
+        uint64_t nBytes = 0;
+    };
+} // namespace tileservice
+
+/**
+ * The TileServer runs on the node of a cluster that reads the tiles for all nodes, by
+ * default the master, and serves the finished tiles to the TileServiceClient%s of the
+ * other nodes. A tile is read through the same tiers as the local tiles, that is the
+ * DiskTileCache and the RawTileDataReader of the dataset, and is block compressed before
+ * it is sent, so that the receiving nodes only have to upload it to the GPU. The
+ * datasets are identified by their DiskTileCache::datasetIdentifier, so the serving node
+ * can only serve the datasets of the layers that it has loaded itself. Each client
+ * connection is handled on its own thread.
+ */
+class TileServer {
+public:
+    /**
+     * \param diskCache is the cache that is used for the served tiles, may be
+     *        <code>nullptr</code>
+     * \param pool receives the image data buffers of the tiles after they were sent
+     */
+    TileServer(DiskTileCache* diskCache, TileBufferPool* pool);
+    ~TileServer();
+
+    void start(int port);
+    void stop();
+    bool isRunning() const;
+
+    /**
+     * Makes the tiles of the \p reader available to the clients. The \p reader has to
+     * stay valid until it is removed with #removeDataset.
+     */
+    void addDataset(unsigned int datasetIdentifier, RawTileDataReader& reader);
+
+    /// Removes the \p reader and waits for the tile reads that are using it to finish
+    void removeDataset(unsigned int datasetIdentifier, RawTileDataReader& reader);
+
+private:
+    struct Client {
+        std::unique_ptr<ghoul::io::TcpSocket> socket;
+        std::thread thread;
+        std::atomic_bool isFinished = false;
+    };
+
+    void acceptClients();
+    void handleClient(Client& client);
+    bool sendTile(ghoul::io::TcpSocket& socket, const tileservice::Request& request);
+
+    DiskTileCache* _diskCache;
+    TileBufferPool* _pool;
+    std::unique_ptr<ghoul::io::TcpSocketServer> _server;
+    std::thread _acceptThread;
+    std::atomic_bool _isRunning = false;
+
+    std::mutex _clientMutex;
+    std::vector<std::unique_ptr<Client>> _clients;
+
+    // Tile reads hold a shared lock for as long as they are using one of the readers
+    std::shared_mutex _datasetMutex;
+    std::multimap<unsigned int, RawTileDataReader*> _datasets;
+};
+
+/**
+ * The TileServiceClient requests finished tiles from the TileServer of a cluster
+ * instead of reading them from the datasets. It is used by the tile loading worker
+ * threads, each of which uses its own connection to the server so that the tiles of
+ * different layers are requested concurrently. The received image data is read directly
+ * into a buffer of the TileBufferPool that is then uploaded as is.
+ */
+class TileServiceClient {
+public:
+    TileServiceClient(std::string address, int port, TileBufferPool* pool);
+    ~TileServiceClient();
+
+    /**
+     * Requests the tile at \p tileIndex of the dataset with the \p datasetIdentifier,
+     * whose tiles have the layout of \p initData, from the server. A tile that the
+     * server could not provide is returned with a read error, so that it is requested
+     * again later.
+     *
+     * \return The finished tile or <code>std::nullopt</code> if the server is not
+     *         reachable, in which case the tile should be read locally
+     */
+    std::optional<RawTile> get(unsigned int datasetIdentifier, const TileIndex& tileIndex,
+        const TileTextureInitData& initData);
+
+private:
+    /// Returns an idle connection to the server or \c nullptr if none can be opened
+    std::unique_ptr<ghoul::io::TcpSocket> acquireConnection();
+    void releaseConnection(std::unique_ptr<ghoul::io::TcpSocket> socket);
+
+    const std::string _address;
+    const int _port;
+    TileBufferPool* _pool;
+
+    std::mutex _connectionMutex;
+    std::vector<std::unique_ptr<ghoul::io::TcpSocket>> _idleConnections;
+    /// Failed connection attempts are not repeated for every tile
+    std::chrono::steady_clock::time_point _lastConnectionFailure;
+    bool _hasConnectionFailed = false;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_SERVICE___H__
@@ -78,10 +78,40 @@ unsigned int uniqueIdForTextureFormat(ghoul::opengl::Texture::Format textureForm
     }
 }
 
+openspace::globebrowsing::TileTextureInitData::Compression supportedCompression(
+                   openspace::globebrowsing::TileTextureInitData::Compression compression,
+                                                             const glm::ivec3& dimensions,
+                                                                            GLenum glType,
+                                                    ghoul::opengl::Texture::Format format)
+{
+    using Compression = openspace::globebrowsing::TileTextureInitData::Compression;
+
+    const bool isCompressible = glType == GL_UNSIGNED_BYTE &&
+        (format == ghoul::opengl::Texture::Format::RGBA ||
+         format == ghoul::opengl::Texture::Format::BGRA) &&
+        dimensions.x % 4 == 0 && dimensions.y % 4 == 0;
+    return isCompressible ? compression : Compression::None;
+}
+
+size_t textureNumBytes(openspace::globebrowsing::TileTextureInitData::Compression c,
+                       const glm::ivec3& dimensions, size_t totalNumBytes)
+{
+    using Compression = openspace::globebrowsing::TileTextureInitData::Compression;
+
+    const size_t nBlocks = static_cast<size_t>(dimensions.x / 4) * (dimensions.y / 4);
+    switch (c) {
+        case Compression::None: return totalNumBytes;
+        case Compression::BC1:  return nBlocks * 8;
+        case Compression::BC3:  return nBlocks * 16;
+        default:                throw ghoul::MissingCaseException();
+    }
+}
+
 openspace::globebrowsing::TileTextureInitData::HashKey calculateHashKey(
                                                              const glm::ivec3& dimensions,
                                              const ghoul::opengl::Texture::Format& format,
-                                                                     const GLenum& glType)
+                                                                     const GLenum& glType,
+                   openspace::globebrowsing::TileTextureInitData::Compression compression)
 {
     ghoul_assert(dimensions.x > 0, "Incorrect dimension");
     ghoul_assert(dimensions.y > 0, "Incorrect dimension");
@@ -97,6 +127,9 @@ openspace::globebrowsing::TileTextureInitData::HashKey calculateHashKey(
     res |= dimensions.y << 10;
     res |= static_cast<std::underlying_type_t<GLenum>>(glType) << (10 + 16);
     res |= formatId << (10 + 16 + 4);
+    res |= static_cast<openspace::globebrowsing::TileTextureInitData::HashKey>(
+        compression
+    ) << 48;
 
     return res;
 }
@@ -106,7 +139,7 @@ openspace::globebrowsing::TileTextureInitData::HashKey calculateHashKey(
 namespace openspace::globebrowsing {
 
 TileTextureInitData tileTextureInitData(layergroupid::GroupID id, bool shouldPadTiles,
-    size_t preferredTileSize)
+    size_t preferredTileSize, TileTextureInitData::Compression compression)
 {
     switch (id) {
         case layergroupid::GroupID::HeightLayers: {
@@ -127,7 +160,9 @@ TileTextureInitData tileTextureInitData(layergroupid::GroupID id, bool shouldPad
                 tileSize,
                 GL_UNSIGNED_BYTE,
                 ghoul::opengl::Texture::Format::BGRA,
-                TileTextureInitData::PadTiles(shouldPadTiles)
+                TileTextureInitData::PadTiles(shouldPadTiles),
+                TileTextureInitData::ShouldAllocateDataOnCPU::No,
+                compression
             );
         }
         case layergroupid::GroupID::Overlays: {
@@ -137,7 +172,9 @@ TileTextureInitData tileTextureInitData(layergroupid::GroupID id, bool shouldPad
                 tileSize,
                 GL_UNSIGNED_BYTE,
                 ghoul::opengl::Texture::Format::BGRA,
-                TileTextureInitData::PadTiles(shouldPadTiles)
+                TileTextureInitData::PadTiles(shouldPadTiles),
+                TileTextureInitData::ShouldAllocateDataOnCPU::No,
+                compression
             );
         }
         case layergroupid::GroupID::NightLayers: {
@@ -147,7 +184,9 @@ TileTextureInitData tileTextureInitData(layergroupid::GroupID id, bool shouldPad
                 tileSize,
                 GL_UNSIGNED_BYTE,
                 ghoul::opengl::Texture::Format::BGRA,
-                TileTextureInitData::PadTiles(shouldPadTiles)
+                TileTextureInitData::PadTiles(shouldPadTiles),
+                TileTextureInitData::ShouldAllocateDataOnCPU::No,
+                compression
             );
         }
         case layergroupid::GroupID::WaterMasks: {
@@ -168,7 +207,8 @@ TileTextureInitData tileTextureInitData(layergroupid::GroupID id, bool shouldPad
 
 TileTextureInitData::TileTextureInitData(size_t width, size_t height, GLenum type,
                                          ghoul::opengl::Texture::Format textureFormat,
-                                         PadTiles pad, ShouldAllocateDataOnCPU allocCpu)
+                                         PadTiles pad, ShouldAllocateDataOnCPU allocCpu,
+                                         Compression textureCompression)
     : dimensions(width, height, 1)
     , tilePixelStartOffset(pad ? TilePixelStartOffset : glm::ivec2(0))
     , tilePixelSizeDifference(pad ? TilePixelSizeDifference : glm::ivec2(0))
@@ -181,7 +221,11 @@ TileTextureInitData::TileTextureInitData(size_t width, size_t height, GLenum typ
     , totalNumBytes(bytesPerLine * height)
     , shouldAllocateDataOnCPU(allocCpu)
     , padTiles(pad)
-    , hashKey(calculateHashKey(dimensions, ghoulTextureFormat, glType))
+    , compression(
+        supportedCompression(textureCompression, dimensions, glType, ghoulTextureFormat)
+    )
+    , textureNumBytes(::textureNumBytes(compression, dimensions, totalNumBytes))
+    , hashKey(calculateHashKey(dimensions, ghoulTextureFormat, glType, compression))
 {}
 
 TileTextureInitData TileTextureInitData::operator=(const TileTextureInitData& rhs) {
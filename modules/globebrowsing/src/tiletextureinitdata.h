@@ -42,9 +42,23 @@ public:
     BooleanType(ShouldAllocateDataOnCPU);
     BooleanType(PadTiles);
 
+    /**
+     * The block compression that is applied to the tiles before they are uploaded to
+     * the GPU. \c BC1 encodes 4x4 pixels in 8 bytes with a single bit of alpha, \c BC3
+     * uses 16 bytes and keeps a full alpha channel. Compression is only available for
+     * four channel byte formats whose dimensions are a multiple of four and is ignored
+     * for all other formats.
+     */
+    enum class Compression {
+        None = 0,
+        BC1,
+        BC3
+    };
+
     TileTextureInitData(size_t width, size_t height, GLenum type,
         ghoul::opengl::Texture::Format textureFormat, PadTiles pad,
-        ShouldAllocateDataOnCPU allocCpu = ShouldAllocateDataOnCPU::No);
+        ShouldAllocateDataOnCPU allocCpu = ShouldAllocateDataOnCPU::No,
+        Compression compression = Compression::None);
 
     TileTextureInitData(const TileTextureInitData& original) = default;
     TileTextureInitData(TileTextureInitData&& original) = default;
@@ -66,11 +80,17 @@ public:
     const size_t totalNumBytes;
     const bool shouldAllocateDataOnCPU;
     const bool padTiles;
+    const Compression compression;
+    /// The number of bytes of a tile in its texture; this is smaller than
+    /// \c totalNumBytes if the tile is compressed
+    const size_t textureNumBytes;
     const HashKey hashKey;
 };
 
 TileTextureInitData tileTextureInitData(layergroupid::GroupID id,
-    bool shouldPadTiles, size_t preferredTileSize = 0);
+    bool shouldPadTiles, size_t preferredTileSize = 0,
+    TileTextureInitData::Compression compression =
+        TileTextureInitData::Compression::None);
 
 } // namespace openspace::globebrowsing
 
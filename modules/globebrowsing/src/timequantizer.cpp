@@ -102,6 +102,10 @@ bool TimeQuantizer::quantize(Time& t, bool clamp) const {
     }
 }
 
+double TimeQuantizer::resolution() const {
+    return _resolution;
+}
+
 std::vector<Time> TimeQuantizer::quantized(const Time& start, const Time& end) const {
     Time s = start;
     quantize(s, true);
@@ -73,6 +73,12 @@ struct TimeQuantizer {
     */
     std::vector<Time> quantized(const Time& start, const Time& end) const;
 
+    /**
+     * \return The time resolution, that is the length of each quantized time step, in
+     *         seconds
+     */
+    double resolution() const;
+
 private:
     TimeRange _timerange;
     double _resolution;
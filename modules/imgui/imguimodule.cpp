@@ -36,6 +36,7 @@
 #include <openspace/rendering/luaconsole.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scene.h>
+#include <openspace/util/resourceloader.h>
 #include <ghoul/logging/logmanager.h>
 
 namespace openspace {
@@ -54,6 +55,8 @@ ImGUIModule::ImGUIModule() : OpenSpaceModule(Name) {
                 &global::sessionRecording,
                 &global::timeManager,
                 &global::renderEngine,
+                &global::resourceLoader,
+                &global::memoryBudget,
                 &global::parallelPeer,
                 &global::luaConsole,
                 &global::dashboard
@@ -27,11 +27,18 @@
 
 #include <modules/imgui/include/guicomponent.h>
 
+#include <openspace/performance/performancemanager.h>
 #include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
+#include <array>
+#include <deque>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace ghoul { class SharedMemory; }
+namespace openspace { class SceneGraphNode; }
 
 namespace openspace::gui {
 
@@ -40,9 +47,45 @@ public:
     GuiPerformanceComponent();
     ~GuiPerformanceComponent();
 
+    void deinitialize() override;
     void render() override;
 
 protected:
+    /// The number of render bins for which the GPU times are shown separately
+    static constexpr const int NRenderBins = 4;
+
+    struct FrameSample {
+        double timestamp;
+        float cpuTime;
+        float gpuTime;
+    };
+
+    struct NodeSample {
+        const SceneGraphNode* node;
+        double updateTime;
+        double renderTime;
+        double renderTimeGpu;
+    };
+
+    struct HotNode {
+        std::string identifier;
+        float updateTime;
+        float renderTime;
+        float renderTimeGpu;
+    };
+
+    /**
+     * Collects the frame and node times of the last frame. This only reads values that
+     * have been measured already, so that it does not add any work to the measured
+     * frames themselves.
+     */
+    void collectSamples();
+
+    void renderFrameTimes();
+    void renderFrameZones();
+    void renderGpuPasses();
+    void renderHotNodes();
+
     std::unique_ptr<ghoul::SharedMemory> _performanceMemory;
 
     properties::IntProperty _sortingSelection;
@@ -50,6 +93,21 @@ protected:
     properties::BoolProperty _sceneGraphIsEnabled;
     properties::BoolProperty _functionsIsEnabled;
     properties::BoolProperty _outputLogs;
+    properties::FloatProperty _historyLength;
+    properties::FloatProperty _rankingInterval;
+
+    std::deque<FrameSample> _frameHistory;
+    performance::PerformanceManager::FrameSummary _shownFrame;
+    bool _isFramePaused = false;
+
+    /// The GPU time of the last frame in milliseconds, indexed by the render bin
+    std::array<double, NRenderBins> _gpuPassTimes = {};
+    std::array<double, NRenderBins> _smoothedGpuPassTimes = {};
+
+    std::vector<NodeSample> _nodeSamples;
+    int _nSampledFrames = 0;
+    double _lastRankingTime = 0.0;
+    std::vector<HotNode> _hotNodes;
 };
 
 } // namespace openspace::gui
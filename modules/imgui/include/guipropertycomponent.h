@@ -31,7 +31,9 @@
 #include <openspace/properties/scalar/boolproperty.h>
 #include <ghoul/misc/boolean.h>
 #include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace openspace::properties {
@@ -41,6 +43,8 @@ namespace openspace::properties {
 
 namespace openspace::gui {
 
+struct TreeNode;
+
 class GuiPropertyComponent : public GuiComponent {
 public:
     using SourceFunction = std::function<std::vector<properties::PropertyOwner*>()>;
@@ -50,6 +54,7 @@ public:
 
     GuiPropertyComponent(std::string identifier, std::string guiName = "",
         UseTreeLayout useTree = UseTreeLayout::No);
+    ~GuiPropertyComponent();
 
     // This is the function that evaluates to the list of Propertyowners that this
     // component should render
@@ -64,6 +69,14 @@ protected:
     void renderPropertyOwner(properties::PropertyOwner* owner);
     void renderProperty(properties::Property* prop, properties::PropertyOwner* owner);
 
+    /**
+     * Calls \p renderFunction to render the row that is identified by \p key, unless
+     * the row has been rendered in a previous frame and its height is outside of the
+     * visible part of the window. In that case, only the space for the row is reserved
+     * so that the scrolling range of the window does not change.
+     */
+    void renderRow(const void* key, const std::function<void()>& renderFunction);
+
     properties::Property::Visibility _visibility = properties::Property::Visibility::User;
 
     SourceFunction _function;
@@ -75,6 +88,31 @@ protected:
     properties::BoolProperty _useTreeLayout;
     properties::StringListProperty _treeOrdering;
     properties::BoolProperty _ignoreHiddenHint;
+
+private:
+    /// Sorts the owners that were returned by the source function and rebuilds the
+    /// search index for them
+    void updateOwners();
+    /// Selects the owners that match the current filter and rebuilds the tree layout
+    void applyFilter();
+
+    // The owners as they were returned by the source function in the last frame. The
+    // sorted owners, the tree, and the search index are only rebuilt if they change
+    std::vector<properties::PropertyOwner*> _sourceOwners;
+    std::vector<properties::PropertyOwner*> _sortedOwners;
+    bool _ownersAreDirty = true;
+
+    // For each sorted owner the lower case names of the owner and of all of its
+    // properties, which is searched for the filter
+    std::vector<std::string> _searchIndex;
+    std::string _filter;
+
+    // The owners that match the filter and the tree layout that is built from them
+    std::vector<properties::PropertyOwner*> _owners;
+    std::unique_ptr<TreeNode> _tree;
+
+    // The height of every row that has been rendered, used to skip invisible rows
+    std::unordered_map<const void*, float> _rowHeights;
 };
 
 } // namespace openspace::gui
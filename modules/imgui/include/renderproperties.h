@@ -39,6 +39,13 @@ BooleanType(ShowToolTip);
 void executeScript(const std::string& id, const std::string& value,
     IsRegularProperty isRegular = IsRegularProperty::Yes);
 
+/**
+ * Removes the cached text of all properties whose values are expensive to format, and
+ * the callbacks that keep the cache up to date. This has to be called before the GUI
+ * is destroyed.
+ */
+void clearFormattedValues();
+
 void renderBoolProperty(properties::Property* prop, const std::string& ownerName,
     IsRegularProperty isRegular = IsRegularProperty::Yes,
     ShowToolTip showTooltip = ShowToolTip::Yes, double tooltipDelay = 1.0);
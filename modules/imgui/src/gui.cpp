@@ -26,6 +26,7 @@
 
 #include <modules/imgui/imguimodule.h>
 #include <modules/imgui/include/imgui_include.h>
+#include <modules/imgui/include/renderproperties.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/mission/missionmanager.h>
@@ -169,6 +170,8 @@ void GUI::deinitialize() {
         comp->deinitialize();
     }
 
+    clearFormattedValues();
+
     delete iniFileBuffer;
 }
 
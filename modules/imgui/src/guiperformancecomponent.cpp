@@ -28,10 +28,16 @@
 #include <openspace/engine/globals.h>
 #include <openspace/performance/performancelayout.h>
 #include <openspace/performance/performancemanager.h>
+#include <openspace/rendering/renderable.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/scene/scene.h>
+#include <openspace/scene/scenegraphnode.h>
 #include <ghoul/misc/sharedmemory.h>
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <numeric>
+#include <string_view>
 
 namespace {
     enum Sorting {
@@ -41,7 +47,8 @@ namespace {
         UpdateScaling = 2,
         UpdateRender = 3,
         Render = 4,
-        Total = 5
+        RenderGpu = 5,
+        Total = 6
     };
 
     constexpr openspace::properties::Property::PropertyInfo SortingSelectionInfo = {
@@ -70,26 +77,412 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo HistoryLengthInfo = {
+        "HistoryLength",
+        "History Length",
+        "The number of seconds of frame times that are shown in the frame time "
+        "histograms."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo RankingIntervalInfo = {
+        "RankingInterval",
+        "Ranking Interval",
+        "The number of seconds between two updates of the ranking of the slowest scene "
+        "graph nodes. The times of the nodes are averaged over this interval."
+    };
+
+    constexpr const char* RenderBinNames[] = {
+        "Background", "Opaque", "Transparent", "Overlay"
+    };
+
+    // The number of nodes that are shown in the ranking of the slowest nodes
+    constexpr const size_t NHotNodes = 20;
+
+    // The number of buckets in the distribution of the frame times
+    constexpr const int NHistogramBuckets = 40;
+
+    // Converts the render bin, which is a bit in the render bin mask, into an index
+    int renderBinIndex(openspace::Renderable::RenderBin bin) {
+        switch (bin) {
+            case openspace::Renderable::RenderBin::Background:  return 0;
+            case openspace::Renderable::RenderBin::Opaque:      return 1;
+            case openspace::Renderable::RenderBin::Transparent: return 2;
+            case openspace::Renderable::RenderBin::Overlay:     return 3;
+            default:                                            return 1;
+        }
+    }
+
+    double currentTime() {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Returns a color that stays the same for a zone across frames
+    ImU32 zoneColor(const char* name) {
+        const size_t hash = std::hash<std::string_view>()(std::string_view(name));
+        const float hue = static_cast<float>(hash % 360) / 360.f;
+        return ImColor::HSV(hue, 0.45f, 0.75f);
+    }
+
+    float percentile(std::vector<float> values, float p) {
+        if (values.empty()) {
+            return 0.f;
+        }
+        const size_t n = static_cast<size_t>(p * (values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + n, values.end());
+        return values[n];
+    }
+
 } // namespace
 
 namespace openspace::gui {
 
 GuiPerformanceComponent::GuiPerformanceComponent()
     : GuiComponent("PerformanceComponent", "Performance Component")
-    , _sortingSelection(SortingSelectionInfo, -1, -1, 6)
+    , _sortingSelection(SortingSelectionInfo, -1, -1, 7)
     , _sceneGraphIsEnabled(SceneGraphEnabledInfo, false)
     , _functionsIsEnabled(FunctionsEnabledInfo, false)
     , _outputLogs(OutputLogsInfo, false)
+    , _historyLength(HistoryLengthInfo, 10.f, 1.f, 120.f)
+    , _rankingInterval(RankingIntervalInfo, 1.f, 0.1f, 10.f)
 {
     addProperty(_sortingSelection);
 
     addProperty(_sceneGraphIsEnabled);
     addProperty(_functionsIsEnabled);
     addProperty(_outputLogs);
+    addProperty(_historyLength);
+    addProperty(_rankingInterval);
+
+    _isEnabled.onChange([this]() {
+        if (!_isEnabled) {
+            global::performanceManager.setLiveFrameTimesEnabled(false);
+            _frameHistory.clear();
+            _nodeSamples.clear();
+            _hotNodes.clear();
+        }
+    });
 }
 
 GuiPerformanceComponent::~GuiPerformanceComponent() {} // NOLINT
 
+void GuiPerformanceComponent::deinitialize() {
+    global::performanceManager.setLiveFrameTimesEnabled(false);
+    global::performanceManager.setGpuSynchronization(true);
+}
+
+void GuiPerformanceComponent::collectSamples() {
+    using namespace performance;
+
+    // The live frame times only take effect from the next frame onwards
+    global::performanceManager.setLiveFrameTimesEnabled(true);
+    const PerformanceManager::FrameSummary& frame =
+        global::performanceManager.lastFrame();
+
+    const double now = currentTime();
+    _gpuPassTimes.fill(0.0);
+
+    static const std::vector<SceneGraphNode*> NoNodes;
+    Scene* scene = global::renderEngine.scene();
+    const std::vector<SceneGraphNode*>& nodes =
+        scene ? scene->allSceneGraphNodes() : NoNodes;
+
+    // The samples are accumulated by position, so they are restarted whenever the
+    // scene graph changes
+    const bool isSameScene = _nodeSamples.size() == nodes.size() &&
+        std::equal(
+            nodes.begin(), nodes.end(),
+            _nodeSamples.begin(),
+            [](const SceneGraphNode* n, const NodeSample& s) { return n == s.node; }
+        );
+    if (!isSameScene) {
+        _nodeSamples.clear();
+        _nodeSamples.reserve(nodes.size());
+        for (const SceneGraphNode* n : nodes) {
+            _nodeSamples.push_back({ n, 0.0, 0.0, 0.0 });
+        }
+        _nSampledFrames = 0;
+        _lastRankingTime = now;
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const SceneGraphNode::PerformanceRecord& r = nodes[i]->performanceRecord();
+        // All times in the record are in nanoseconds
+        const double gpu = r.renderTimeGpu / 1e6;
+        NodeSample& s = _nodeSamples[i];
+        s.updateTime += (r.updateTimeTranslation + r.updateTimeRotation +
+                         r.updateTimeScaling + r.updateTimeRenderable) / 1e6;
+        s.renderTime += r.renderTime / 1e6;
+        s.renderTimeGpu += gpu;
+
+        if (nodes[i]->renderable()) {
+            _gpuPassTimes[renderBinIndex(nodes[i]->renderable()->renderBin())] += gpu;
+        }
+    }
+    ++_nSampledFrames;
+
+    for (int i = 0; i < NRenderBins; ++i) {
+        _smoothedGpuPassTimes[i] =
+            0.9 * _smoothedGpuPassTimes[i] + 0.1 * _gpuPassTimes[i];
+    }
+
+    if (frame.duration > 0.0) {
+        const double gpu =
+            std::accumulate(_gpuPassTimes.begin(), _gpuPassTimes.end(), 0.0);
+        _frameHistory.push_back({
+            now,
+            static_cast<float>(frame.duration),
+            static_cast<float>(gpu)
+        });
+    }
+    const double oldest = now - _historyLength;
+    while (!_frameHistory.empty() && _frameHistory.front().timestamp < oldest) {
+        _frameHistory.pop_front();
+    }
+
+    if (!_isFramePaused) {
+        _shownFrame.duration = frame.duration;
+        _shownFrame.zones.assign(frame.zones.begin(), frame.zones.end());
+    }
+
+    if (now - _lastRankingTime < _rankingInterval || _nSampledFrames == 0) {
+        return;
+    }
+
+    // The ranking is only rebuilt at a low frequency, so that it is readable and so that
+    // sorting the nodes does not show up in the frame times itself
+    std::vector<size_t> indices(_nodeSamples.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    // A node is limited by whichever of its CPU and GPU time is larger, as they overlap
+    auto cost = [this](size_t i) {
+        const NodeSample& s = _nodeSamples[i];
+        return std::max(s.updateTime + s.renderTime, s.renderTimeGpu);
+    };
+    const size_t nShown = std::min(NHotNodes, indices.size());
+    std::partial_sort(
+        indices.begin(),
+        indices.begin() + nShown,
+        indices.end(),
+        [&cost](size_t a, size_t b) { return cost(a) > cost(b); }
+    );
+
+    _hotNodes.clear();
+    const float n = static_cast<float>(_nSampledFrames);
+    for (size_t i = 0; i < nShown; ++i) {
+        const NodeSample& s = _nodeSamples[indices[i]];
+        _hotNodes.push_back({
+            s.node->identifier(),
+            static_cast<float>(s.updateTime) / n,
+            static_cast<float>(s.renderTime) / n,
+            static_cast<float>(s.renderTimeGpu) / n
+        });
+    }
+
+    for (NodeSample& s : _nodeSamples) {
+        s.updateTime = 0.0;
+        s.renderTime = 0.0;
+        s.renderTimeGpu = 0.0;
+    }
+    _nSampledFrames = 0;
+    _lastRankingTime = now;
+}
+
+void GuiPerformanceComponent::renderFrameTimes() {
+    if (_frameHistory.empty()) {
+        ImGui::Text("No frames have been measured yet");
+        return;
+    }
+
+    std::vector<float> cpu;
+    std::vector<float> gpu;
+    cpu.reserve(_frameHistory.size());
+    gpu.reserve(_frameHistory.size());
+    for (const FrameSample& s : _frameHistory) {
+        cpu.push_back(s.cpuTime);
+        gpu.push_back(s.gpuTime);
+    }
+
+    const float maxCpu = *std::max_element(cpu.begin(), cpu.end());
+    const float avgCpu = std::accumulate(cpu.begin(), cpu.end(), 0.f) / cpu.size();
+    const float avgGpu = std::accumulate(gpu.begin(), gpu.end(), 0.f) / gpu.size();
+    const double span = _frameHistory.back().timestamp - _frameHistory.front().timestamp;
+
+    ImGui::Text(
+        "%.1f fps   Average: %.2f ms   95%%: %.2f ms   99%%: %.2f ms   Max: %.2f ms",
+        span > 0.0 ? (_frameHistory.size() - 1) / span : 0.0,
+        avgCpu,
+        percentile(cpu, 0.95f),
+        percentile(cpu, 0.99f),
+        maxCpu
+    );
+    ImGui::PlotHistogram(
+        "Frame",
+        cpu.data(),
+        static_cast<int>(cpu.size()),
+        0,
+        nullptr,
+        0.f,
+        maxCpu,
+        ImVec2(0, 60)
+    );
+    ImGui::PlotHistogram(
+        fmt::format("GPU\nAverage: {:.2f} ms", avgGpu).c_str(),
+        gpu.data(),
+        static_cast<int>(gpu.size()),
+        0,
+        nullptr,
+        0.f,
+        maxCpu,
+        ImVec2(0, 60)
+    );
+
+    // The distribution of the frame times shows whether slow frames are outliers or
+    // whether the frame times are spread out
+    std::array<float, NHistogramBuckets> buckets = {};
+    for (float t : cpu) {
+        const int i = static_cast<int>(t / maxCpu * (NHistogramBuckets - 1));
+        buckets[std::clamp(i, 0, NHistogramBuckets - 1)] += 1.f;
+    }
+    ImGui::PlotHistogram(
+        fmt::format("Distribution\n0 - {:.1f} ms", maxCpu).c_str(),
+        buckets.data(),
+        NHistogramBuckets,
+        0,
+        nullptr,
+        0.f,
+        FLT_MAX,
+        ImVec2(0, 60)
+    );
+}
+
+void GuiPerformanceComponent::renderFrameZones() {
+    ImGui::Checkbox("Pause", &_isFramePaused);
+    if (_shownFrame.duration <= 0.0) {
+        ImGui::Text("No frames have been measured yet");
+        return;
+    }
+    ImGui::SameLine();
+    ImGui::Text("Frame: %.2f ms", _shownFrame.duration);
+
+    using Zone = performance::PerformanceManager::FrameZone;
+    std::vector<const Zone*> zones;
+    zones.reserve(_shownFrame.zones.size());
+    for (const Zone& z : _shownFrame.zones) {
+        zones.push_back(&z);
+    }
+    // Zones that begin at the same time are nested inside the longer one
+    std::sort(
+        zones.begin(),
+        zones.end(),
+        [](const Zone* a, const Zone* b) {
+            return a->begin != b->begin ? a->begin < b->begin : a->duration > b->duration;
+        }
+    );
+
+    const float width = std::max(ImGui::GetContentRegionAvailWidth(), 1.f);
+    const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+    const float scale = width / static_cast<float>(_shownFrame.duration);
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+    // The nesting depth of a zone is the number of enclosing zones that have not ended
+    std::vector<double> openZones;
+    const Zone* hovered = nullptr;
+    int maxDepth = 0;
+    for (const Zone* z : zones) {
+        while (!openZones.empty() && openZones.back() <= z->begin) {
+            openZones.pop_back();
+        }
+        const int depth = static_cast<int>(openZones.size());
+        openZones.push_back(z->begin + z->duration);
+        maxDepth = std::max(maxDepth, depth);
+
+        const ImVec2 min = ImVec2(
+            origin.x + static_cast<float>(z->begin) * scale,
+            origin.y + depth * rowHeight
+        );
+        const ImVec2 max = ImVec2(
+            std::max(min.x + static_cast<float>(z->duration) * scale, min.x + 1.f),
+            min.y + rowHeight - 1.f
+        );
+        drawList->AddRectFilled(min, max, zoneColor(z->name));
+        drawList->PushClipRect(min, max, true);
+        drawList->AddText(
+            ImVec2(min.x + 2.f, min.y),
+            IM_COL32(0, 0, 0, 255),
+            z->name
+        );
+        drawList->PopClipRect();
+
+        if (ImGui::IsMouseHoveringRect(min, max)) {
+            hovered = z;
+        }
+    }
+    ImGui::Dummy(ImVec2(width, (maxDepth + 1) * rowHeight));
+
+    if (hovered) {
+        ImGui::SetTooltip(
+            "%s\n%.3f ms (%.1f%%)",
+            hovered->name,
+            hovered->duration,
+            hovered->duration / _shownFrame.duration * 100.0
+        );
+    }
+}
+
+void GuiPerformanceComponent::renderGpuPasses() {
+    const double total = std::accumulate(
+        _smoothedGpuPassTimes.begin(),
+        _smoothedGpuPassTimes.end(),
+        0.0
+    );
+    ImGui::Text("Scene graph nodes: %.2f ms", total);
+    for (int i = 0; i < NRenderBins; ++i) {
+        const float fraction = total > 0.0 ?
+            static_cast<float>(_smoothedGpuPassTimes[i] / total) :
+            0.f;
+        ImGui::ProgressBar(
+            fraction,
+            ImVec2(ImGui::GetContentRegionAvailWidth() * 0.6f, 0.f),
+            fmt::format("{:.2f} ms", _smoothedGpuPassTimes[i]).c_str()
+        );
+        ImGui::SameLine();
+        ImGui::Text("%s", RenderBinNames[i]);
+    }
+}
+
+void GuiPerformanceComponent::renderHotNodes() {
+    if (_hotNodes.empty()) {
+        ImGui::Text(
+            "The ranking is updated every %.1f seconds",
+            _rankingInterval.value()
+        );
+        return;
+    }
+
+    ImGui::Columns(4, "HotNodes");
+    ImGui::Text("Node");
+    ImGui::NextColumn();
+    ImGui::Text("Update (ms)");
+    ImGui::NextColumn();
+    ImGui::Text("Render (ms)");
+    ImGui::NextColumn();
+    ImGui::Text("GPU (ms)");
+    ImGui::NextColumn();
+    ImGui::Separator();
+    for (const HotNode& node : _hotNodes) {
+        ImGui::Text("%s", node.identifier.c_str());
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", node.updateTime);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", node.renderTime);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", node.renderTimeGpu);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
 void GuiPerformanceComponent::render() {
     if (!global::performanceManager.isEnabled()) {
         return;
@@ -119,12 +512,33 @@ void GuiPerformanceComponent::render() {
     v = global::performanceManager.loggingEnabled();
     _outputLogs = v;
 
+    // Only the function measurements need to wait for the GPU, so the rendering is only
+    // stalled while someone is actually looking at them
+    global::performanceManager.setGpuSynchronization(
+        _functionsIsEnabled || _outputLogs
+    );
+
     ImGui::Spacing();
 
     if (ImGui::Button("Reset measurements")) {
         global::performanceManager.resetPerformanceMeasurements();
     }
 
+    collectSamples();
+
+    if (ImGui::CollapsingHeader("Frame Times")) {
+        renderFrameTimes();
+    }
+    if (ImGui::CollapsingHeader("Frame Zones")) {
+        renderFrameZones();
+    }
+    if (ImGui::CollapsingHeader("GPU Passes")) {
+        renderGpuPasses();
+    }
+    if (ImGui::CollapsingHeader("Slowest Nodes")) {
+        renderHotNodes();
+    }
+
     if (_sceneGraphIsEnabled) {
         bool sge = _sceneGraphIsEnabled;
         ImGui::Begin("SceneGraph", &sge);
@@ -139,6 +553,7 @@ void GuiPerformanceComponent::render() {
         ImGui::RadioButton("UpdateScaling",     &sorting, Sorting::UpdateScaling);
         ImGui::RadioButton("UpdateRender",      &sorting, Sorting::UpdateRender);
         ImGui::RadioButton("RenderTime",        &sorting, Sorting::Render);
+        ImGui::RadioButton("RenderTimeGpu",     &sorting, Sorting::RenderGpu);
         ImGui::RadioButton("TotalTime",         &sorting, Sorting::Total);
         _sortingSelection = sorting;
 
@@ -153,12 +568,13 @@ void GuiPerformanceComponent::render() {
         // updateScaling
         // UpdateRender
         // RenderTime
-        std::vector<std::array<float, 5>> averages(
+        // RenderTimeGpu
+        std::vector<std::array<float, 6>> averages(
             layout->nScaleGraphEntries,
-            { 0.f, 0.f, 0.f, 0.f, 0.f }
+            { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f }
         );
 
-        std::vector<std::array<std::pair<float, float>, 5>> minMax(
+        std::vector<std::array<std::pair<float, float>, 6>> minMax(
             layout->nScaleGraphEntries
         );
 
@@ -166,7 +582,7 @@ void GuiPerformanceComponent::render() {
             const PerformanceLayout::SceneGraphPerformanceLayout& entry =
                 layout->sceneGraphEntries[i];
 
-            int nValues[5] = { 0, 0, 0, 0, 0 };
+            int nValues[6] = { 0, 0, 0, 0, 0, 0 };
 
             // Compute the averages and count the number of values so we don't divide
             // by 0 later
@@ -191,6 +607,10 @@ void GuiPerformanceComponent::render() {
                 if (entry.renderTime[j] != 0.f) {
                     ++(nValues[4]);
                 }
+                averages[i][5] += entry.renderTimeGpu[j];
+                if (entry.renderTimeGpu[j] != 0.f) {
+                    ++(nValues[5]);
+                }
             }
 
             if (nValues[0] != 0) {
@@ -208,6 +628,9 @@ void GuiPerformanceComponent::render() {
             if (nValues[4] != 0) {
                 averages[i][4] /= static_cast<float>(nValues[4]);
             }
+            if (nValues[5] != 0) {
+                averages[i][5] /= static_cast<float>(nValues[5]);
+            }
 
             // Get the minimum/maximum values for each of the components so that we
             // can scale the plot by these numbers
@@ -255,6 +678,15 @@ void GuiPerformanceComponent::render() {
                 *(minmaxRendering.first),
                 *(minmaxRendering.second)
             );
+
+            auto minmaxRenderingGpu = std::minmax_element(
+                std::begin(entry.renderTimeGpu),
+                std::end(entry.renderTimeGpu)
+            );
+            minMax[i][5] = std::make_pair(
+                *(minmaxRenderingGpu.first),
+                *(minmaxRenderingGpu.second)
+            );
         }
 
         // If we don't want to sort, we will leave the indices list alone, thus
@@ -265,17 +697,18 @@ void GuiPerformanceComponent::render() {
 
             if (selection == Sorting::Total) {
                 // If we do want to sort totally, we need to sum all the averages and
-                // use that as the criterion
+                // use that as the criterion. The GPU time overlaps with the CPU time, so
+                // only the CPU times are summed
                 sortFunc = [&averages](size_t a, size_t b) {
                     const float sumA = std::accumulate(
                         std::begin(averages[a]),
-                        std::end(averages[a]),
+                        std::next(std::begin(averages[a]), Sorting::RenderGpu),
                         0.f
                     );
 
                     const float sumB = std::accumulate(
                         std::begin(averages[b]),
-                        std::end(averages[b]),
+                        std::next(std::begin(averages[b]), Sorting::RenderGpu),
                         0.f
                     );
 
@@ -401,6 +834,24 @@ void GuiPerformanceComponent::render() {
                     minMax[indices[i]][4].second,
                     ImVec2(0, 40)
                 );
+
+                const std::string& renderTimeGpu = std::to_string(
+                    entry.renderTimeGpu[PerformanceLayout::NumberValues - 1]
+                ) + "us";
+
+                ImGui::PlotLines(
+                    fmt::format(
+                        "RenderTimeGpu\nAverage: {}us",
+                        averages[indices[i]][5]
+                    ).c_str(),
+                    &entry.renderTimeGpu[0],
+                    PerformanceLayout::NumberValues,
+                    0,
+                    renderTimeGpu.c_str(),
+                    minMax[indices[i]][5].first,
+                    minMax[indices[i]][5].second,
+                    ImVec2(0, 40)
+                );
             }
         }
         ImGui::End();
@@ -29,9 +29,39 @@
 #include <openspace/scene/scenegraphnode.h>
 #include <ghoul/misc/misc.h>
 #include <algorithm>
+#include <cctype>
+#include <cstring>
 
 //#define Debugging_ImGui_TreeNode_Indices
 
+namespace openspace::gui {
+
+struct TreeNode {
+    TreeNode(std::string p)
+        : path(std::move(p))
+#ifdef Debugging_ImGui_TreeNode_Indices
+        , index(nextIndex++)
+#endif // Debugging_ImGui_TreeNode_Indices
+    {}
+
+    std::string path;
+    std::vector<std::unique_ptr<TreeNode>> children;
+    std::vector<SceneGraphNode*> nodes;
+#ifdef Debugging_ImGui_TreeNode_Indices
+    int index = 0;
+    static int nextIndex;
+#endif // Debugging_ImGui_TreeNode_Indices
+
+};
+
+#ifdef Debugging_ImGui_TreeNode_Indices
+
+int TreeNode::nextIndex = 0;
+
+#endif // Debugging_ImGui_TreeNode_Indices
+
+} // namespace openspace::gui
+
 namespace {
     const ImVec2 Size = ImVec2(350, 500);
 
@@ -59,6 +89,19 @@ namespace {
         "the hidden hints are followed."
     };
 
+    constexpr const int FilterBufferSize = 256;
+
+    using TreeNode = openspace::gui::TreeNode;
+    using RowFunction = std::function<void(const void*, const std::function<void()>&)>;
+
+    bool isVisible(const openspace::properties::Property* p,
+                   openspace::properties::Property::Visibility visibility)
+    {
+        using V = openspace::properties::Property::Visibility;
+        return static_cast<std::underlying_type_t<V>>(visibility) >=
+               static_cast<std::underlying_type_t<V>>(p->visibility());
+    }
+
     int nVisibleProperties(const std::vector<openspace::properties::Property*>& props,
         openspace::properties::Property::Visibility visibility)
     {
@@ -66,13 +109,49 @@ namespace {
             props.begin(),
             props.end(),
             [visibility](openspace::properties::Property* p) {
-                using V = openspace::properties::Property::Visibility;
-                return static_cast<std::underlying_type_t<V>>(visibility) >=
-                       static_cast<std::underlying_type_t<V>>(p->visibility());
+                return isVisible(p, visibility);
             }
         ));
     }
 
+    // Returns whether the owner or any of its sub owners has a visible property. This
+    // stops at the first visible property instead of collecting all properties first
+    bool hasVisibleProperties(const openspace::properties::PropertyOwner* owner,
+                              openspace::properties::Property::Visibility visibility)
+    {
+        const std::vector<openspace::properties::Property*>& props = owner->properties();
+        const bool hasVisible = std::any_of(
+            props.begin(),
+            props.end(),
+            [visibility](openspace::properties::Property* p) {
+                return isVisible(p, visibility);
+            }
+        );
+        if (hasVisible) {
+            return true;
+        }
+
+        const std::vector<openspace::properties::PropertyOwner*>& subOwners =
+            owner->propertySubOwners();
+        return std::any_of(
+            subOwners.begin(),
+            subOwners.end(),
+            [visibility](openspace::properties::PropertyOwner* o) {
+                return hasVisibleProperties(o, visibility);
+            }
+        );
+    }
+
+    std::string toLower(std::string s) {
+        std::transform(
+            s.begin(),
+            s.end(),
+            s.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); }
+        );
+        return s;
+    }
+
     void renderTooltip(openspace::properties::PropertyOwner* propOwner) {
         const bool shouldDisplay = ImGui::IsItemHovered() &&
                                    (!propOwner->description().empty());
@@ -82,30 +161,6 @@ namespace {
         }
     }
 
-    struct TreeNode {
-        TreeNode(std::string p)
-            : path(std::move(p))
-#ifdef Debugging_ImGui_TreeNode_Indices
-            , index(nextIndex++)
-#endif // Debugging_ImGui_TreeNode_Indices
-        {}
-
-        std::string path;
-        std::vector<std::unique_ptr<TreeNode>> children;
-        std::vector<openspace::SceneGraphNode*> nodes;
-#ifdef Debugging_ImGui_TreeNode_Indices
-        int index = 0;
-        static int nextIndex;
-#endif // Debugging_ImGui_TreeNode_Indices
-
-    };
-
-#ifdef Debugging_ImGui_TreeNode_Indices
-
-    int TreeNode::nextIndex = 0;
-
-#endif // Debugging_ImGui_TreeNode_Indices
-
     void addPathToTree(TreeNode& node, const std::vector<std::string>& path,
                        openspace::SceneGraphNode* owner)
     {
@@ -162,15 +217,16 @@ namespace {
     }
 
     void renderTree(const TreeNode& node,
-            const std::function<void (openspace::properties::PropertyOwner*)>& renderFunc)
+            const std::function<void (openspace::properties::PropertyOwner*)>& renderFunc,
+                    const RowFunction& row)
     {
         if (node.path.empty() || ImGui::TreeNode(node.path.c_str())) {
             for (const std::unique_ptr<TreeNode>& c : node.children) {
-                renderTree(*c, renderFunc);
+                row(c.get(), [&]() { renderTree(*c, renderFunc, row); });
             }
 
             for (openspace::SceneGraphNode* n : node.nodes) {
-                renderFunc(n);
+                row(n, [&]() { renderFunc(n); });
             }
 
             if (!node.path.empty()) {
@@ -190,10 +246,15 @@ GuiPropertyComponent::GuiPropertyComponent(std::string identifier, std::string g
     , _ignoreHiddenHint(IgnoreHiddenInfo)
 {
     addProperty(_useTreeLayout);
+    _useTreeLayout.onChange([this]() { _ownersAreDirty = true; });
     addProperty(_treeOrdering);
+    _treeOrdering.onChange([this]() { _ownersAreDirty = true; });
     addProperty(_ignoreHiddenHint);
+    _ignoreHiddenHint.onChange([this]() { _ownersAreDirty = true; });
 }
 
+GuiPropertyComponent::~GuiPropertyComponent() {} // NOLINT
+
 void GuiPropertyComponent::setSource(SourceFunction function) {
     _function = std::move(function);
 }
@@ -206,10 +267,28 @@ void GuiPropertyComponent::setHasRegularProperties(bool hasOnlyRegularProperties
     _hasOnlyRegularProperties = hasOnlyRegularProperties;
 }
 
+void GuiPropertyComponent::renderRow(const void* key,
+                                     const std::function<void()>& renderFunction)
+{
+    const float spacing = ImGui::GetStyle().ItemSpacing.y;
+    auto it = _rowHeights.find(key);
+    if (it != _rowHeights.end() && it->second > spacing &&
+        !ImGui::IsRectVisible(ImVec2(1.f, it->second)))
+    {
+        // The dummy item adds the item spacing itself
+        ImGui::Dummy(ImVec2(0.f, it->second - spacing));
+        return;
+    }
+
+    const float start = ImGui::GetCursorPosY();
+    renderFunction();
+    _rowHeights[key] = ImGui::GetCursorPosY() - start;
+}
+
 void GuiPropertyComponent::renderPropertyOwner(properties::PropertyOwner* owner) {
     using namespace properties;
 
-    if (owner->propertiesRecursive().empty()) {
+    if (!hasVisibleProperties(owner, _visibility)) {
         return;
     }
 
@@ -217,21 +296,21 @@ void GuiPropertyComponent::renderPropertyOwner(properties::PropertyOwner* owner)
     ImGui::PushID(owner->identifier().c_str());
     const std::vector<PropertyOwner*>& subOwners = owner->propertySubOwners();
     for (PropertyOwner* subOwner : subOwners) {
-        const std::vector<Property*>& properties = subOwner->propertiesRecursive();
-        int count = nVisibleProperties(properties, _visibility);
-        if (count == 0) {
+        if (!hasVisibleProperties(subOwner, _visibility)) {
             continue;
         }
         if (subOwners.size() == 1 && (nThisProperty == 0)) {
             renderPropertyOwner(subOwner);
         }
         else {
-            const bool opened = ImGui::TreeNode(subOwner->guiName().c_str());
-            renderTooltip(subOwner);
-            if (opened) {
-                renderPropertyOwner(subOwner);
-                ImGui::TreePop();
-            }
+            renderRow(subOwner, [&]() {
+                const bool opened = ImGui::TreeNode(subOwner->guiName().c_str());
+                renderTooltip(subOwner);
+                if (opened) {
+                    renderPropertyOwner(subOwner);
+                    ImGui::TreePop();
+                }
+            });
         }
     }
 
@@ -269,122 +348,203 @@ void GuiPropertyComponent::renderPropertyOwner(properties::PropertyOwner* owner)
     }
 
     for (properties::Property* prop : remainingProperies) {
-        renderProperty(prop, owner);
+        if (isVisible(prop, _visibility)) {
+            renderRow(prop, [&]() { renderProperty(prop, owner); });
+        }
     }
     ImGui::PopID();
 }
 
-void GuiPropertyComponent::render() {
-    ImGui::SetNextWindowCollapsed(_isCollapsed);
-
-    bool v = _isEnabled;
-    ImGui::Begin(guiName().c_str(), &v, Size, 0.75f);
-    _isEnabled = v;
-
-    _isCollapsed = ImGui::IsWindowCollapsed();
+void GuiPropertyComponent::updateOwners() {
     using namespace properties;
 
-    if (_function) {
-        std::vector<properties::PropertyOwner*> owners = _function();
+    _sortedOwners = _sourceOwners;
+    std::sort(
+        _sortedOwners.begin(),
+        _sortedOwners.end(),
+        [](properties::PropertyOwner* lhs, properties::PropertyOwner* rhs) {
+            return lhs->guiName() < rhs->guiName();
+        }
+    );
 
-        std::sort(
-            owners.begin(),
-            owners.end(),
-            [](properties::PropertyOwner* lhs, properties::PropertyOwner* rhs) {
-                return lhs->guiName() < rhs->guiName();
-            }
-        );
+    if (_useTreeLayout) {
+        for (properties::PropertyOwner* owner : _sortedOwners) {
+            ghoul_assert(
+                dynamic_cast<SceneGraphNode*>(owner),
+                "When using the tree layout, all owners must be SceneGraphNodes"
+            );
+            (void)owner; // using [[maybe_unused]] in the for loop gives an error
+        }
 
-        if (_useTreeLayout) {
-            for (properties::PropertyOwner* owner : owners) {
-                ghoul_assert(
-                    dynamic_cast<SceneGraphNode*>(owner),
-                    "When using the tree layout, all owners must be SceneGraphNodes"
-                );
-                (void)owner; // using [[maybe_unused]] in the for loop gives an error
-            }
+        // Sort:
+        // if guigrouping, sort by name and shortest first, but respect the user
+        // specified ordering
+        // then all w/o guigroup
+        const std::vector<std::string>& ordering = _treeOrdering;
+        std::stable_sort(
+            _sortedOwners.begin(),
+            _sortedOwners.end(),
+            [&ordering](PropertyOwner* lhs, PropertyOwner* rhs) {
+                std::string lhsGroup = dynamic_cast<SceneGraphNode*>(lhs)->guiPath();
+                std::string rhsGroup = dynamic_cast<SceneGraphNode*>(rhs)->guiPath();
+
+                if (lhsGroup.empty()) {
+                    return false;
+                }
+                if (rhsGroup.empty()) {
+                    return true;
+                }
 
-            // Sort:
-            // if guigrouping, sort by name and shortest first, but respect the user
-            // specified ordering
-            // then all w/o guigroup
-            const std::vector<std::string>& ordering = _treeOrdering;
-            std::stable_sort(
-                owners.begin(),
-                owners.end(),
-                [&ordering](PropertyOwner* lhs, PropertyOwner* rhs) {
-                    std::string lhsGroup = dynamic_cast<SceneGraphNode*>(lhs)->guiPath();
-                    std::string rhsGroup = dynamic_cast<SceneGraphNode*>(rhs)->guiPath();
-
-                    if (lhsGroup.empty()) {
-                        return false;
-                    }
-                    if (rhsGroup.empty()) {
-                        return true;
-                    }
+                if (ordering.empty()) {
+                    return lhsGroup < rhsGroup;
+                }
 
-                    if (ordering.empty()) {
-                        return lhsGroup < rhsGroup;
-                    }
+                std::vector<std::string> lhsToken = ghoul::tokenizeString(
+                    lhsGroup,
+                    '/'
+                );
+                // The first token is always empty
+                auto lhsIt = std::find(ordering.begin(), ordering.end(), lhsToken[1]);
 
-                    std::vector<std::string> lhsToken = ghoul::tokenizeString(
-                        lhsGroup,
-                        '/'
-                    );
-                    // The first token is always empty
-                    auto lhsIt = std::find(ordering.begin(), ordering.end(), lhsToken[1]);
-
-                    std::vector<std::string> rhsToken = ghoul::tokenizeString(
-                        rhsGroup,
-                        '/'
-                    );
-                    // The first token is always empty
-                    auto rhsIt = std::find(ordering.begin(), ordering.end(), rhsToken[1]);
-
-                    if (lhsIt != ordering.end() && rhsIt != ordering.end()) {
-                        if (lhsToken[1] != rhsToken[1]) {
-                            // If both top-level groups are in the ordering list, the
-                            // order of the iterators gives us the order of the groups
-                            return lhsIt < rhsIt;
-                        }
-                        else {
-                            return lhsGroup < rhsGroup;
-                        }
-                    }
-                    else if (lhsIt != ordering.end() && rhsIt == ordering.end()) {
-                        // If only one of them is in the list, we have a sorting
-                        return true;
-                    }
-                    else if (lhsIt == ordering.end() && rhsIt != ordering.end()) {
-                        return false;
+                std::vector<std::string> rhsToken = ghoul::tokenizeString(
+                    rhsGroup,
+                    '/'
+                );
+                // The first token is always empty
+                auto rhsIt = std::find(ordering.begin(), ordering.end(), rhsToken[1]);
+
+                if (lhsIt != ordering.end() && rhsIt != ordering.end()) {
+                    if (lhsToken[1] != rhsToken[1]) {
+                        // If both top-level groups are in the ordering list, the
+                        // order of the iterators gives us the order of the groups
+                        return lhsIt < rhsIt;
                     }
                     else {
                         return lhsGroup < rhsGroup;
                     }
                 }
-            );
+                else if (lhsIt != ordering.end() && rhsIt == ordering.end()) {
+                    // If only one of them is in the list, we have a sorting
+                    return true;
+                }
+                else if (lhsIt == ordering.end() && rhsIt != ordering.end()) {
+                    return false;
+                }
+                else {
+                    return lhsGroup < rhsGroup;
+                }
+            }
+        );
+    }
+
+    if (!_ignoreHiddenHint) {
+        // Remove all of the nodes that we want hidden first
+        _sortedOwners.erase(
+            std::remove_if(
+                _sortedOwners.begin(),
+                _sortedOwners.end(),
+                [](properties::PropertyOwner* p) {
+                    SceneGraphNode* s = dynamic_cast<SceneGraphNode*>(p);
+                    return s && s->hasGuiHintHidden();
+                }
+            ),
+            _sortedOwners.end()
+        );
+    }
+
+    _searchIndex.clear();
+    _searchIndex.reserve(_sortedOwners.size());
+    for (properties::PropertyOwner* owner : _sortedOwners) {
+        std::string entry = owner->guiName() + '\n' + owner->identifier();
+        for (properties::Property* p : owner->propertiesRecursive()) {
+            entry += '\n' + p->guiName() + '\n' + p->identifier();
         }
+        _searchIndex.push_back(toLower(std::move(entry)));
+    }
 
-        // If the owners list is empty, we wnat to do the normal thing (-> nothing)
-        // Otherwise, check if the first owner has a GUI group
-        // This makes the assumption that the tree layout is only used if the owners are
-        // SceenGraphNodes (checked above)
-        const bool noGuiGroups = owners.empty() ||
-                                 (dynamic_cast<SceneGraphNode*>(*owners.begin()) &&
-                       dynamic_cast<SceneGraphNode*>(*owners.begin())->guiPath().empty());
+    _rowHeights.clear();
+    _ownersAreDirty = false;
+}
 
-        auto renderProp = [&](properties::PropertyOwner* pOwner) {
-            const int count = nVisibleProperties(
-                pOwner->propertiesRecursive(),
-                _visibility
+void GuiPropertyComponent::applyFilter() {
+    _owners.clear();
+    const std::string filter = toLower(_filter);
+    for (size_t i = 0; i < _sortedOwners.size(); ++i) {
+        if (filter.empty() || _searchIndex[i].find(filter) != std::string::npos) {
+            _owners.push_back(_sortedOwners[i]);
+        }
+    }
+
+    // If the owners list is empty, we wnat to do the normal thing (-> nothing)
+    // Otherwise, check if the first owner has a GUI group
+    // This makes the assumption that the tree layout is only used if the owners are
+    // SceenGraphNodes (checked in updateOwners)
+    const bool noGuiGroups = _owners.empty() ||
+                             (dynamic_cast<SceneGraphNode*>(*_owners.begin()) &&
+                     dynamic_cast<SceneGraphNode*>(*_owners.begin())->guiPath().empty());
+
+    _tree = nullptr;
+    if (_useTreeLayout && !noGuiGroups) {
+        _tree = std::make_unique<TreeNode>("");
+
+        for (properties::PropertyOwner* pOwner : _owners) {
+            // We checked above that pOwner is a SceneGraphNode
+            SceneGraphNode* nOwner = static_cast<SceneGraphNode*>(pOwner);
+            const std::string guiPath = nOwner->guiPath();
+            if (guiPath.empty()) {
+                // We know that we are done now since we stable_sort:ed them above
+                break;
+            }
+            std::vector<std::string> paths = ghoul::tokenizeString(
+                guiPath.substr(1),
+                '/'
             );
 
-            if (count == 0) {
+            addPathToTree(*_tree, paths, nOwner);
+        }
+
+        simplifyTree(*_tree);
+    }
+}
+
+void GuiPropertyComponent::render() {
+    ImGui::SetNextWindowCollapsed(_isCollapsed);
+
+    bool v = _isEnabled;
+    const bool isWindowVisible = ImGui::Begin(guiName().c_str(), &v, Size, 0.75f);
+    _isEnabled = v;
+
+    _isCollapsed = ImGui::IsWindowCollapsed();
+    using namespace properties;
+
+    if (_function && isWindowVisible) {
+        std::vector<properties::PropertyOwner*> owners = _function();
+        if (_ownersAreDirty || owners != _sourceOwners) {
+            _sourceOwners = std::move(owners);
+            updateOwners();
+            applyFilter();
+        }
+
+        if (_sourceOwners.size() > 1) {
+            static char filterBuffer[FilterBufferSize];
+#ifdef _MSC_VER
+            strcpy_s(filterBuffer, _filter.length() + 1, _filter.c_str());
+#else
+            strcpy(filterBuffer, _filter.c_str());
+#endif
+            if (ImGui::InputText("Filter", filterBuffer, FilterBufferSize)) {
+                _filter = filterBuffer;
+                applyFilter();
+            }
+        }
+
+        auto renderProp = [&](properties::PropertyOwner* pOwner) {
+            if (!hasVisibleProperties(pOwner, _visibility)) {
                 return;
             }
 
             auto header = [&]() -> bool {
-                if (owners.size() > 1) {
+                if (_sourceOwners.size() > 1) {
                     // Create a header in case we have multiple owners
                     return ImGui::CollapsingHeader(pOwner->guiName().c_str());
                 }
@@ -405,52 +565,21 @@ void GuiPropertyComponent::render() {
             }
         };
 
-        if (!_useTreeLayout || noGuiGroups) {
-            if (!_ignoreHiddenHint) {
-                // Remove all of the nodes that we want hidden first
-                owners.erase(
-                    std::remove_if(
-                        owners.begin(),
-                        owners.end(),
-                        [](properties::PropertyOwner* p) {
-                            SceneGraphNode* s = dynamic_cast<SceneGraphNode*>(p);
-                            return s && s->hasGuiHintHidden();
-                        }
-                    ),
-                    owners.end()
-                );
+        RowFunction row = [this](const void* key, const std::function<void()>& f) {
+            renderRow(key, f);
+        };
+
+        if (!_tree) {
+            for (properties::PropertyOwner* pOwner : _owners) {
+                row(pOwner, [&]() { renderProp(pOwner); });
             }
-            std::for_each(owners.begin(), owners.end(), renderProp);
         }
         else { // _useTreeLayout && gui groups exist
-            TreeNode root("");
-
-            for (properties::PropertyOwner* pOwner : owners) {
-                // We checked above that pOwner is a SceneGraphNode
-                SceneGraphNode* nOwner = static_cast<SceneGraphNode*>(pOwner);
-                if (!_ignoreHiddenHint && nOwner->hasGuiHintHidden()) {
-                    continue;
-                }
-                const std::string guiPath = nOwner->guiPath();
-                if (guiPath.empty()) {
-                    // We know that we are done now since we stable_sort:ed them above
-                    break;
-                }
-                std::vector<std::string> paths = ghoul::tokenizeString(
-                    guiPath.substr(1),
-                    '/'
-                );
-
-                addPathToTree(root, paths, nOwner);
-            }
-
-            simplifyTree(root);
-
-            renderTree(root, renderProp);
+            renderTree(*_tree, renderProp, row);
 
             ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 20.f);
 
-            for (properties::PropertyOwner* pOwner : owners) {
+            for (properties::PropertyOwner* pOwner : _owners) {
                 // We checked above that pOwner is a SceneGraphNode
                 SceneGraphNode* nOwner = static_cast<SceneGraphNode*>(pOwner);
 
@@ -458,7 +587,7 @@ void GuiPropertyComponent::render() {
                     continue;
                 }
 
-                renderProp(pOwner);
+                row(pOwner, [&]() { renderProp(pOwner); });
             }
         }
     }
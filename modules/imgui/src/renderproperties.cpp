@@ -48,11 +48,49 @@
 #include <openspace/scripting/scriptengine.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/misc.h>
+#include <unordered_map>
+
+namespace {
+    // The text that is shown for properties whose values are expensive to format. An
+    // entry is invalidated when the value of its property changes and is removed when
+    // the property is destroyed
+    struct FormattedValue {
+        std::string text;
+        size_t nOptions = 0;
+        bool isValid = false;
+        openspace::properties::Property::OnChangeHandle onChangeHandle;
+        openspace::properties::Property::OnDeleteHandle onDeleteHandle;
+    };
+    std::unordered_map<openspace::properties::Property*, FormattedValue> FormattedValues;
+
+    FormattedValue& formattedValue(openspace::properties::Property* prop) {
+        auto it = FormattedValues.find(prop);
+        if (it == FormattedValues.end()) {
+            FormattedValue value;
+            value.onChangeHandle = prop->onChange([prop]() {
+                FormattedValues[prop].isValid = false;
+            });
+            value.onDeleteHandle = prop->onDelete([prop]() {
+                FormattedValues.erase(prop);
+            });
+            it = FormattedValues.emplace(prop, std::move(value)).first;
+        }
+        return it->second;
+    }
+} // namespace
 
 namespace openspace {
 
 using namespace properties;
 
+void clearFormattedValues() {
+    for (std::pair<Property* const, FormattedValue>& p : FormattedValues) {
+        p.first->removeOnChange(p.second.onChangeHandle);
+        p.first->removeOnDelete(p.second.onDeleteHandle);
+    }
+    FormattedValues.clear();
+}
+
 void renderTooltip(Property* prop, double delay) {
     if (ImGui::IsItemHovered() && (GImGui->HoveredIdTimer > delay)) {
         ImGui::BeginTooltip();
@@ -144,12 +182,18 @@ void renderOptionProperty(Property* prop, const std::string& ownerName,
     }
     case OptionProperty::DisplayType::Dropdown: {
         // The order of the options does not have to correspond with the value of the
-        // option
-        std::string nodeNames;
-        for (const OptionProperty::Option& o : options) {
-            nodeNames += o.description + '\0';
+        // option. Options can be added without changing the value of the property, so
+        // we also have to check the number of options
+        FormattedValue& nodeNames = formattedValue(prop);
+        if (!nodeNames.isValid || nodeNames.nOptions != options.size()) {
+            nodeNames.text.clear();
+            for (const OptionProperty::Option& o : options) {
+                nodeNames.text += o.description + '\0';
+            }
+            nodeNames.text += '\0';
+            nodeNames.nOptions = options.size();
+            nodeNames.isValid = true;
         }
-        nodeNames += '\0';
 
         int idx = static_cast<int>(std::distance(
             options.begin(),
@@ -159,7 +203,11 @@ void renderOptionProperty(Property* prop, const std::string& ownerName,
                 [value](const OptionProperty::Option& o) { return o.value == value; }
         )));
 
-        const bool hasChanged = ImGui::Combo(name.c_str(), &idx, nodeNames.c_str());
+        const bool hasChanged = ImGui::Combo(
+            name.c_str(),
+            &idx,
+            nodeNames.text.c_str()
+        );
         if (showTooltip) {
             renderTooltip(prop, tooltipDelay);
         }
@@ -269,9 +317,12 @@ void renderStringListProperty(Property* prop, const std::string& ownerName,
     const std::string& name = p->guiName();
     ImGui::PushID((ownerName + "." + name).c_str());
 
-    std::string value;
-    p->getStringValue(value);
-    // const std::string value = p->value();
+    FormattedValue& formatted = formattedValue(prop);
+    if (!formatted.isValid) {
+        p->getStringValue(formatted.text);
+        formatted.isValid = true;
+    }
+    const std::string& value = formatted.text;
 
     static const int bufferSize = 512;
     static char buffer[bufferSize];
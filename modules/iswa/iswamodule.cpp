@@ -47,7 +47,10 @@
 namespace openspace {
 
 IswaModule::IswaModule() : OpenSpaceModule(Name) {
-    global::callback::initialize.push_back([]() { IswaManager::initialize(); });
+    global::callback::initialize.push_back([this]() {
+        IswaManager::initialize();
+        addPropertySubOwner(IswaManager::ref());
+    });
 }
 
 void IswaModule::internalInitialize(const ghoul::Dictionary&) {
@@ -28,6 +28,7 @@
 #include <modules/iswa/util/dataprocessor.h>
 #include <modules/iswa/util/iswamanager.h>
 #include <openspace/rendering/transferfunction.h>
+#include <openspace/util/threadpool.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
@@ -105,23 +106,101 @@ DataCygnet::DataCygnet(const ghoul::Dictionary& dictionary)
     registerProperties();
 }
 
-DataCygnet::~DataCygnet() {}
+DataCygnet::~DataCygnet() {
+    // The processing job only works on copies, but the textures it produces are ours
+    if (_textureDataJob.valid()) {
+        try {
+            for (float* values : _textureDataJob.get()) {
+                delete[] values;
+            }
+        }
+        catch (const std::exception&) {}
+    }
+}
+
+void DataCygnet::update(const UpdateData& data) {
+    IswaCygnet::update(data);
+
+    if (!_textureDataJob.valid() || !DownloadManager::futureReady(_textureDataJob)) {
+        return;
+    }
+
+    try {
+        uploadTextures(_textureDataJob.get());
+    }
+    catch (const std::exception& e) {
+        LERROR(fmt::format("Processing data of '{}' failed: {}", identifier(), e.what()));
+    }
+
+    if (_updateFilterValues) {
+        _updateFilterValues = false;
+        if (_autoFilter) {
+            _backgroundValues = _dataProcessor->filterValues();
+        }
+    }
+
+    if (_textureDataOutdated) {
+        _textureDataOutdated = false;
+        updateTexture();
+    }
+}
 
 bool DataCygnet::updateTexture() {
-    const std::vector<float*>& data = textureData();
+    // if the buffer in the datafile is empty, do not proceed
+    if (_dataBuffer.empty()) {
+        return false;
+    }
 
-    if (data.empty()) {
+    if (_dataOptions.options().empty()) { // load options for value selection
+        fillOptions(_dataBuffer);
+        _dataProcessor->addDataValues(_dataBuffer, _dataOptions);
+
+        // if this datacygnet has added new values then reload texture
+        // for the whole group, including this datacygnet, and return after.
+        if (_group) {
+            _group->updateGroup();
+            return false;
+        }
+    }
+
+    if (_textureDataJob.valid()) {
+        // Only one job at a time; the newest state is picked up once it is finished
+        _textureDataOutdated = true;
         return false;
     }
 
+    // The job only works on copies, so neither a new _dataBuffer nor a changed selection
+    // can interfere with it
+    auto job = std::make_shared<std::promise<std::vector<float*>>>();
+    _textureDataJob = job->get_future();
+    IswaManager::ref().processingThreads().enqueue(
+        [processor = _dataProcessor, data = _dataBuffer,
+         selection = DataProcessor::Selection(_dataOptions),
+         dimensions = _textureDimensions, job]()
+        {
+            try {
+                job->set_value(processor->processData(data, selection, dimensions));
+            }
+            catch (...) {
+                job->set_exception(std::current_exception());
+            }
+        }
+    );
+    return false;
+}
+
+bool DataCygnet::uploadTextures(const std::vector<float*>& data) {
     bool texturesReady = false;
-    const std::vector<int>& selectedOptions = _dataOptions.value();
 
-    for (int option : selectedOptions) {
+    for (size_t option = 0; option < data.size(); ++option) {
         float* values = data[option];
         if (!values) {
             continue;
         }
+        if (option >= _textures.size()) {
+            delete[] values;
+            continue;
+        }
 
         if (!_textures[option]) {
             using namespace ghoul::opengl;
@@ -149,34 +228,14 @@ bool DataCygnet::updateTexture() {
     return texturesReady;
 }
 
-bool DataCygnet::downloadTextureResource(double timestamp) {
-    if (_futureObject.valid()) {
-        return false;
-    }
-
-    std::future<DownloadManager::MemoryFile> future = IswaManager::ref().fetchDataCygnet(
-        _data.id,
-        timestamp
-    );
-
-    if (future.valid()) {
-        _futureObject = std::move(future);
-        return true;
-    }
-
-    return false;
+std::future<DownloadManager::MemoryFile> DataCygnet::downloadTextureResource(
+                                                                       double timestamp)
+{
+    return IswaManager::ref().fetchDataCygnet(_data.id, timestamp);
 }
 
-bool DataCygnet::updateTextureResource() {
-    DownloadManager::MemoryFile dataFile = _futureObject.get();
-
-    if (dataFile.corrupted) {
-        return false;
-    }
-
-    _dataBuffer = std::string(dataFile.buffer, dataFile.size);
-    delete[] dataFile.buffer;
-
+bool DataCygnet::updateTextureResource(const DownloadManager::MemoryFile& file) {
+    _dataBuffer = std::string(file.buffer, file.size);
     return true;
 }
 
@@ -302,10 +361,9 @@ void DataCygnet::setPropertyCallbacks() {
 
     _useHistogram.onChange([this]() {
         _dataProcessor->useHistogram(_useHistogram);
+        // The filter values are only valid after the data has been processed again
+        _updateFilterValues = true;
         updateTexture();
-        if (_autoFilter) {
-            _backgroundValues = _dataProcessor->filterValues();
-        }
     });
 
     _dataOptions.onChange([this]() {
@@ -31,6 +31,8 @@
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/vector/vec2property.h>
 #include <glm/gtx/std_based_type.hpp>
+#include <future>
+#include <vector>
 
 namespace openspace {
 
@@ -46,8 +48,25 @@ public:
     DataCygnet(const ghoul::Dictionary& dictionary);
     ~DataCygnet();
 
+    void update(const UpdateData& data) override;
+
 protected:
+    /**
+     * Starts processing _dataBuffer with the _dataProcessor on the IswaManager's
+     * processing threads. The resulting textures are uploaded in the first update after
+     * the processing has finished.
+     */
     bool updateTexture() override;
+
+    /**
+     * Uploads the data for each option, for which data is not a <code>nullptr</code>, and
+     * takes ownership of the data.
+     *
+     * \param data The texture data, one entry per data option
+     * \return <code>true</code> if any texture was uploaded
+     */
+    bool uploadTextures(const std::vector<float*>& data);
+
     void fillOptions(const std::string& source);
 
     /**
@@ -75,11 +94,11 @@ protected:
 
     /**
      * Optional interface method. this has an implementation in datacygnet.cpp, but needs
-     * to be overriden for kameleonplane
+     * to be overriden for kameleonplane, which reads its data from disk
      */
-    virtual bool updateTextureResource() override;
-
-    virtual std::vector<float*> textureData() = 0;
+    std::future<DownloadManager::MemoryFile> downloadTextureResource(
+        double timestamp) override;
+    bool updateTextureResource(const DownloadManager::MemoryFile& file) override;
 
     properties::SelectionProperty _dataOptions;
     properties::StringProperty _transferFunctionsFile;
@@ -93,9 +112,14 @@ protected:
     std::string _dataBuffer;
     glm::size3_t _textureDimensions;
 
+    std::future<std::vector<float*>> _textureDataJob;
+    // Set if the options or normalization changed while _textureDataJob was running
+    bool _textureDataOutdated = false;
+    // Set if the filter values have to be applied once _textureDataJob is finished
+    bool _updateFilterValues = false;
+
 private:
     bool readyToRender() const override;
-    bool downloadTextureResource(double timestamp) override;
 };
 
 } //namespace openspace
@@ -52,7 +52,6 @@ private:
     bool destroyGeometry() override;
     void renderGeometry() const override;
     void setUniforms() override;
-    std::vector<float*> textureData() override;
 
     GLuint _quad;
     GLuint _vertexPositionBuffer;
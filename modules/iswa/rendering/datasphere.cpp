@@ -104,27 +104,6 @@ void DataSphere::renderGeometry() const {
     _sphere->render();
 }
 
-std::vector<float*> DataSphere::textureData() {
-    // if the buffer in the datafile is empty, do not proceed
-    if (_dataBuffer.empty()) {
-        return std::vector<float*>();
-    }
-
-    if (!_dataOptions.options().empty()) { // load options for value selection
-        fillOptions(_dataBuffer);
-        _dataProcessor->addDataValues(_dataBuffer, _dataOptions);
-
-        // if this datacygnet has added new values then reload texture
-        // for the whole group, including this datacygnet, and return after.
-        if (_group) {
-            _group->updateGroup();
-            return std::vector<float*>();
-        }
-    }
-    // _textureDimensions = _dataProcessor->setDimensions();
-    return _dataProcessor->processData(_dataBuffer, _dataOptions, _textureDimensions);
-}
-
 void DataSphere::setUniforms() {
     // set both data texture and transfer function texture
     setTextureUniforms();
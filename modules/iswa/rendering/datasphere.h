@@ -51,7 +51,6 @@ protected:
     bool destroyGeometry() override;
     void renderGeometry() const override;
     void setUniforms() override;
-    std::vector<float*> textureData() override;
 
     std::unique_ptr<PowerScaledSphere> _sphere;
     float _radius;
@@ -39,6 +39,9 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 namespace {
     constexpr const char* _loggerCat = "IswaCygnet";
@@ -53,6 +56,21 @@ namespace {
         "Alpha",
         "" // @TODO Missing documentation
     };
+    constexpr openspace::properties::Property::PropertyInfo PrefetchFramesInfo = {
+        "PrefetchFrames",
+        "Prefetch Frames",
+        "The maximum number of frames that are downloaded ahead of the current time in "
+        "the direction in which the time passes. How many of these are requested "
+        "depends on how fast the time passes."
+    };
+
+    // The number of seconds of playback for which frames are prefetched
+    constexpr const double PrefetchDuration = 2.0;
+    // Limits the number of downloads per cygnet, so that scrubbing does not flood the
+    // download manager with requests for frames that are already out of date
+    constexpr const size_t MaxPendingFrames = 4;
+    // Frames that could not be downloaded are not requested again for this long (in ms)
+    constexpr const long long FailedFrameRetryInterval = 5000;
 } // namespace
 
 namespace openspace {
@@ -61,6 +79,7 @@ IswaCygnet::IswaCygnet(const ghoul::Dictionary& dictionary)
     : Renderable(dictionary)
     , _alpha(AlphaInfo, 0.9f, 0.f, 1.f)
     , _delete(DeleteInfo)
+    , _prefetchFrames(PrefetchFramesInfo, 8, 1, 64)
 {
     // This changed from setIdentifier to setGuiName, 2018-03-14 ---abock
     std::string name;
@@ -102,9 +121,12 @@ IswaCygnet::IswaCygnet(const ghoul::Dictionary& dictionary)
 
     addProperty(_alpha);
     addProperty(_delete);
+    addProperty(_prefetchFrames);
 }
 
-IswaCygnet::~IswaCygnet() {}
+IswaCygnet::~IswaCygnet() {
+    clearFrames();
+}
 
 void IswaCygnet::initializeGL() {
     _textures.push_back(nullptr);
@@ -123,7 +145,7 @@ void IswaCygnet::initializeGL() {
 
     initializeTime();
     createGeometry();
-    downloadTextureResource(global::timeManager.time().j2000Seconds());
+    prefetchFrames(frameIndex(_openSpaceTime), global::timeManager.deltaTime());
 }
 
 void IswaCygnet::deinitializeGL() {
@@ -133,6 +155,7 @@ void IswaCygnet::deinitializeGL() {
 
     unregisterProperties();
     destroyGeometry();
+    clearFrames();
 
     if (_shader) {
         global::renderEngine.removeRenderProgram(_shader.get());
@@ -202,25 +225,28 @@ void IswaCygnet::update(const UpdateData&) {
         _openSpaceTime
     );
 
-    const bool timeToUpdate =
-        (fabs(_openSpaceTime - _lastUpdateOpenSpaceTime) >= _data.updateTime &&
-        (_realTime.count() - _lastUpdateRealTime.count()) > _minRealTimeUpdateInterval);
+    collectFrames();
 
-    if (_futureObject.valid() && DownloadManager::futureReady(_futureObject)) {
-        const bool success = updateTextureResource();
-        if (success) {
-            _textureDirty = true;
+    const bool timeToUpdate =
+        (_realTime.count() - _lastUpdateRealTime.count()) > _minRealTimeUpdateInterval;
+
+    if (timeToUpdate) {
+        const double deltaTime = global::timeManager.deltaTime();
+        const long long frame = frameIndex(_openSpaceTime);
+
+        // Until the frame for the current time has arrived, the previous one is shown
+        const auto it = _frames.find(frame);
+        if (it != _frames.end() && (!_hasCurrentFrame || frame != _currentFrame)) {
+            if (updateTextureResource(it->second)) {
+                updateTexture();
+            }
+            _currentFrame = frame;
+            _hasCurrentFrame = true;
         }
-    }
 
-    if (_textureDirty && _data.updateTime != 0 && timeToUpdate) {
-        updateTexture();
-        _textureDirty = false;
-
-        double clockwiseSign = (global::timeManager.deltaTime() > 0) ? 1.0 : -1.0;
-        downloadTextureResource(_openSpaceTime + clockwiseSign * _data.updateTime);
+        prefetchFrames(frame, deltaTime);
+        evictFrames(frame, deltaTime);
         _lastUpdateRealTime = _realTime;
-        _lastUpdateOpenSpaceTime = _openSpaceTime;
     }
 
     if (!_transferFunctions.empty()) {
@@ -240,7 +266,6 @@ void IswaCygnet::unregisterProperties() {}
 
 void IswaCygnet::initializeTime() {
     _openSpaceTime = global::timeManager.time().j2000Seconds();
-    _lastUpdateOpenSpaceTime = 0.0;
 
     _realTime = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()
@@ -250,6 +275,124 @@ void IswaCygnet::initializeTime() {
     _minRealTimeUpdateInterval = 100;
 }
 
+long long IswaCygnet::frameIndex(double time) const {
+    // Cygnets without an update time only ever show a single frame
+    if (_data.updateTime <= 0) {
+        return 0;
+    }
+    return static_cast<long long>(std::floor(time / _data.updateTime));
+}
+
+void IswaCygnet::collectFrames() {
+    for (auto it = _pendingFrames.begin(); it != _pendingFrames.end();) {
+        if (!DownloadManager::futureReady(it->second)) {
+            ++it;
+            continue;
+        }
+
+        DownloadManager::MemoryFile file = it->second.get();
+        if (file.corrupted) {
+            // The DownloadManager allocates the buffers with realloc
+            free(file.buffer);
+            _failedFrames[it->first] = _realTime;
+        }
+        else {
+            IswaManager::ref().addCachedFrame(file.size);
+            _frames[it->first] = file;
+            _failedFrames.erase(it->first);
+        }
+        it = _pendingFrames.erase(it);
+    }
+}
+
+void IswaCygnet::prefetchFrames(long long frame, double deltaTime) {
+    const long long direction = (deltaTime < 0.0) ? -1 : 1;
+
+    // The current frame is always needed, the following ones only if the time passes
+    // fast enough to reach them during the prefetch duration
+    int nFrames = 1;
+    if (_data.updateTime > 0) {
+        const double framesPerSecond = std::abs(deltaTime) / _data.updateTime;
+        const double nPassing = std::min(
+            std::ceil(framesPerSecond * PrefetchDuration),
+            static_cast<double>(_prefetchFrames.value() - 1)
+        );
+        nFrames = static_cast<int>(nPassing) + 1;
+    }
+
+    for (int i = 0; i < nFrames && _pendingFrames.size() < MaxPendingFrames; ++i) {
+        const long long f = frame + direction * i;
+        if (_frames.find(f) != _frames.end() ||
+            _pendingFrames.find(f) != _pendingFrames.end())
+        {
+            continue;
+        }
+
+        const auto failed = _failedFrames.find(f);
+        if (failed != _failedFrames.end() &&
+            (_realTime - failed->second).count() < FailedFrameRetryInterval)
+        {
+            continue;
+        }
+
+        const double timestamp = (_data.updateTime > 0) ?
+            static_cast<double>(f) * _data.updateTime :
+            _openSpaceTime;
+        std::future<DownloadManager::MemoryFile> future =
+            downloadTextureResource(timestamp);
+        if (!future.valid()) {
+            // This cygnet does not download its resources, or the request failed
+            return;
+        }
+        _pendingFrames[f] = std::move(future);
+    }
+}
+
+void IswaCygnet::evictFrames(long long frame, double deltaTime) {
+    const long long direction = (deltaTime < 0.0) ? -1 : 1;
+    auto cost = [frame, direction](long long f) {
+        const long long distance = (f - frame) * direction;
+        return (distance < 0) ? -2 * distance : distance;
+    };
+
+    IswaManager& manager = IswaManager::ref();
+    while (_frames.size() > 1 && manager.isFrameCacheFull()) {
+        const auto farthest = std::max_element(
+            _frames.begin(),
+            _frames.end(),
+            [&cost](const auto& lhs, const auto& rhs) {
+                return cost(lhs.first) < cost(rhs.first);
+            }
+        );
+
+        manager.removeCachedFrame(farthest->second.size);
+        free(farthest->second.buffer);
+        _frames.erase(farthest);
+    }
+}
+
+void IswaCygnet::clearFrames() {
+    for (std::pair<const long long, DownloadManager::MemoryFile>& f : _frames) {
+        if (IswaManager::isInitialized()) {
+            IswaManager::ref().removeCachedFrame(f.second.size);
+        }
+        free(f.second.buffer);
+    }
+    _frames.clear();
+    _failedFrames.clear();
+    _hasCurrentFrame = false;
+
+    // Downloads that are still running are finished by the DownloadManager regardless
+    for (std::pair<const long long, std::future<DownloadManager::MemoryFile>>& f :
+         _pendingFrames)
+    {
+        if (DownloadManager::futureReady(f.second)) {
+            free(f.second.get().buffer);
+        }
+    }
+    _pendingFrames.clear();
+}
+
 void IswaCygnet::initializeGroup() {
     _group = IswaManager::ref().iswaGroup(_data.groupName);
 
@@ -29,10 +29,12 @@
 
 #include <openspace/engine/downloadmanager.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
 #include <openspace/rendering/transferfunction.h>
 #include <ghoul/glm.h>
 #include <chrono>
 #include <future>
+#include <map>
 #include <string>
 
 namespace openspace {
@@ -94,20 +96,23 @@ protected:
      */
     virtual bool updateTexture() = 0;
     /**
-     * Is called before updateTexture. For IswaCygnets getting data from a HTTP request,
-     * this function should get the dataFile from the future object.
+     * Is called before updateTexture with the frame that should be shown for the current
+     * time. The \p file stays in the frame cache, so everything that is needed to create
+     * the texture has to be copied.
      *
      * \return \c true if update was successful
      */
-    virtual bool updateTextureResource() = 0;
+    virtual bool updateTextureResource(const DownloadManager::MemoryFile& file) = 0;
     /**
      * Should send a HTTP request to get the resource it needs to create a texture. For
      * Texture cygnets, this should be an image. For DataCygnets, this should be the data
      * file.
      *
-     * \return \c true if update was successful
+     * \return The future of the download, or an invalid future if this cygnet does not
+     *         download its resources
      */
-    virtual bool downloadTextureResource(double timestamp) = 0;
+    virtual std::future<DownloadManager::MemoryFile> downloadTextureResource(
+        double timestamp) = 0;
 
     virtual bool readyToRender() const = 0;
 
@@ -121,10 +126,8 @@ protected:
 
     std::unique_ptr<ghoul::opengl::ProgramObject> _shader;
     std::vector<std::unique_ptr<ghoul::opengl::Texture>> _textures;
-    bool _textureDirty = false;
 
     std::vector<TransferFunction> _transferFunctions;
-    std::future<DownloadManager::MemoryFile> _futureObject;
 
     IswaBaseGroup* _group = nullptr;
 
@@ -134,10 +137,38 @@ protected:
     glm::mat4 _rotation = glm::mat4(1.f);
 
 private:
+    /// Returns the index of the frame that is shown at \p time
+    long long frameIndex(double time) const;
+
+    /// Moves all finished downloads into the frame cache
+    void collectFrames();
+
+    /**
+     * Requests the frames following \p frame in the direction of time. The faster the
+     * time passes, the more frames are requested, up to _prefetchFrames.
+     */
+    void prefetchFrames(long long frame, double deltaTime);
+
+    /**
+     * Removes the frames that are farthest away from \p frame until the frame cache
+     * budget in the IswaManager is met. The frames behind the direction of time are
+     * removed before the frames ahead of it.
+     */
+    void evictFrames(long long frame, double deltaTime);
+    void clearFrames();
+
+    properties::IntProperty _prefetchFrames;
+
+    std::map<long long, DownloadManager::MemoryFile> _frames;
+    std::map<long long, std::future<DownloadManager::MemoryFile>> _pendingFrames;
+    // Frames that could not be downloaded and the real time at which that happened
+    std::map<long long, std::chrono::milliseconds> _failedFrames;
+    long long _currentFrame = 0;
+    bool _hasCurrentFrame = false;
+
     glm::dmat3 _stateMatrix;
 
     double _openSpaceTime;
-    double _lastUpdateOpenSpaceTime;
 
     std::chrono::milliseconds _realTime;
     std::chrono::milliseconds _lastUpdateRealTime;
@@ -163,12 +163,12 @@ void KameleonPlane::initializeGL() {
             _textures[i] = nullptr;
         }
 
-        updateTextureResource();
+        updateSlice();
         setDimensions();
 
     });
 
-    _slice.onChange([this]() { updateTextureResource(); });
+    _slice.onChange([this]() { updateSlice(); });
 
     _fieldlines.onChange([this]() { updateFieldlineSeeds(); });
 
@@ -181,7 +181,7 @@ void KameleonPlane::initializeGL() {
     if (_group) {
         _group->updateGroup();
     }
-    updateTextureResource();
+    updateSlice();
 }
 
 bool KameleonPlane::createGeometry() {
@@ -241,17 +241,24 @@ void KameleonPlane::renderGeometry() const {
     glDrawArrays(GL_TRIANGLES, 0, 6);
 }
 
+bool KameleonPlane::updateTexture() {
+    return uploadTextures(textureData());
+}
+
 std::vector<float*> KameleonPlane::textureData() {
     DataProcessorKameleon* p = dynamic_cast<DataProcessorKameleon*>(_dataProcessor.get());
     p->setSlice(_slice);
-    return p->processData(_kwPath, _dataOptions, _dimensions);
+    return p->processData(_kwPath, DataProcessor::Selection(_dataOptions), _dimensions);
+}
+
+std::future<DownloadManager::MemoryFile> KameleonPlane::downloadTextureResource(double)
+{
+    return std::future<DownloadManager::MemoryFile>();
 }
 
-bool KameleonPlane::updateTextureResource() {
+void KameleonPlane::updateSlice() {
     _data.offset[_cut] = _slice * _scale + _data.gridMin[_cut];
-    // _textureDirty = true;
     updateTexture();
-    return true;
 }
 
 void KameleonPlane::setUniforms() {
@@ -53,10 +53,26 @@ private:
      */
     bool createGeometry() override;
     bool destroyGeometry() override;
-    bool updateTextureResource() override;
     void renderGeometry() const override;
+
+    /**
+     * The data is read from a local CDF file, so nothing is downloaded
+     */
+    std::future<DownloadManager::MemoryFile> downloadTextureResource(
+        double timestamp) override;
+
+    /**
+     * Moves the plane to the current _slice and slices the data from the CDF file again
+     */
+    void updateSlice();
     void setUniforms() override;
-    std::vector<float*> textureData() override;
+
+    /**
+     * Kameleon planes slice their data from a local CDF file through the non thread-safe
+     * KameleonWrapper, so their textures are created on the main thread
+     */
+    bool updateTexture() override;
+    std::vector<float*> textureData();
 
     void setDimensions();
 
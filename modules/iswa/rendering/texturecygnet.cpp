@@ -45,9 +45,9 @@ bool TextureCygnet::updateTexture() {
     using namespace ghoul;
 
     std::unique_ptr<opengl::Texture> texture = io::TextureReader::ref().loadTexture(
-        reinterpret_cast<void*>(_imageFile.buffer),
-        _imageFile.size,
-        _imageFile.format
+        reinterpret_cast<void*>(_imageBuffer.data()),
+        _imageBuffer.size(),
+        _imageFormat
     );
 
     if (texture) {
@@ -63,44 +63,20 @@ bool TextureCygnet::updateTexture() {
     return false;
 }
 
-bool TextureCygnet::downloadTextureResource(double timestamp) {
-    if (_futureObject.valid()) {
-        return false;
-    }
-
+std::future<DownloadManager::MemoryFile> TextureCygnet::downloadTextureResource(
+                                                                       double timestamp)
+{
     if (_textures.empty()) {
         _textures.push_back(nullptr);
     }
 
-    std::future<DownloadManager::MemoryFile> future = IswaManager::ref().fetchImageCygnet(
-        _data.id,
-        timestamp
-    );
-
-    if (future.valid()) {
-        _futureObject = std::move(future);
-        return true;
-    }
-
-    return false;
+    return IswaManager::ref().fetchImageCygnet(_data.id, timestamp);
 }
 
-bool TextureCygnet::updateTextureResource() {
-    // if The future is done then get the new imageFile
-    DownloadManager::MemoryFile imageFile;
-    if (_futureObject.valid() && DownloadManager::futureReady(_futureObject)) {
-        imageFile = _futureObject.get();
-
-        if (imageFile.corrupted) {
-            delete[] imageFile.buffer;
-            return false;
-        } else {
-            _imageFile = imageFile;
-        }
-    } else {
-        return false;
-    }
-
+bool TextureCygnet::updateTextureResource(const DownloadManager::MemoryFile& file) {
+    // The file belongs to the frame cache and might be evicted before the next update
+    _imageBuffer.assign(file.buffer, file.buffer + file.size);
+    _imageFormat = file.format;
     return true;
 }
 
@@ -27,6 +27,9 @@
 
 #include <modules/iswa/rendering/iswacygnet.h>
 
+#include <string>
+#include <vector>
+
 namespace openspace {
 
 /**
@@ -42,12 +45,14 @@ public:
 
 protected:
     bool updateTexture() override;
-    bool downloadTextureResource(double timestamp) override;
+    std::future<DownloadManager::MemoryFile> downloadTextureResource(
+        double timestamp) override;
     bool readyToRender() const override;
-    bool updateTextureResource() override;
+    bool updateTextureResource(const DownloadManager::MemoryFile& file) override;
 
 private:
-    DownloadManager::MemoryFile _imageFile;
+    std::vector<char> _imageBuffer;
+    std::string _imageFormat;
 };
 } //namespace openspace
 
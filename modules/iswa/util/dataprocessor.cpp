@@ -24,34 +24,120 @@
 
 #include <modules/iswa/util/dataprocessor.h>
 
+#include <openspace/properties/selectionproperty.h>
 #include <openspace/util/histogram.h>
 #include <algorithm>
+#include <array>
 #include <fstream>
+#include <limits>
 #include <numeric>
 
+namespace {
+    struct ValueStatistics {
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+        float sum = 0.f;
+        // Sum of the squared differences to the mean
+        float squaredDeviations = 0.f;
+    };
+
+    // The values are reduced into this many independent accumulators, which removes the
+    // dependency between consecutive iterations and lets the compiler vectorize the loops
+    constexpr const size_t Lanes = 8;
+
+    ValueStatistics valueStatistics(const std::vector<float>& values) {
+        ValueStatistics res;
+        const size_t n = values.size();
+        if (n == 0) {
+            return res;
+        }
+
+        const float* v = values.data();
+        const size_t nBlocked = n - n % Lanes;
+
+        std::array<float, Lanes> mins;
+        std::array<float, Lanes> maxs;
+        std::array<float, Lanes> sums;
+        mins.fill(res.min);
+        maxs.fill(res.max);
+        sums.fill(0.f);
+        for (size_t i = 0; i < nBlocked; i += Lanes) {
+            for (size_t l = 0; l < Lanes; ++l) {
+                const float x = v[i + l];
+                mins[l] = (x < mins[l]) ? x : mins[l];
+                maxs[l] = (x > maxs[l]) ? x : maxs[l];
+                sums[l] += x;
+            }
+        }
+        for (size_t i = nBlocked; i < n; ++i) {
+            mins[0] = std::min(mins[0], v[i]);
+            maxs[0] = std::max(maxs[0], v[i]);
+            sums[0] += v[i];
+        }
+        for (size_t l = 0; l < Lanes; ++l) {
+            res.min = std::min(res.min, mins[l]);
+            res.max = std::max(res.max, maxs[l]);
+            res.sum += sums[l];
+        }
+
+        const float mean = res.sum / n;
+        std::array<float, Lanes> squares;
+        squares.fill(0.f);
+        for (size_t i = 0; i < nBlocked; i += Lanes) {
+            for (size_t l = 0; l < Lanes; ++l) {
+                const float d = v[i + l] - mean;
+                squares[l] += d * d;
+            }
+        }
+        for (size_t i = nBlocked; i < n; ++i) {
+            const float d = v[i] - mean;
+            squares[0] += d * d;
+        }
+        res.squaredDeviations = std::accumulate(squares.begin(), squares.end(), 0.f);
+        return res;
+    }
+} // namespace
+
 namespace openspace {
 
+DataProcessor::Selection::Selection(const properties::SelectionProperty& dataOptions)
+    : selected(dataOptions.value())
+{
+    const std::vector<properties::SelectionProperty::Option>& opts =
+        dataOptions.options();
+    options.reserve(opts.size());
+    for (const properties::SelectionProperty::Option& o : opts) {
+        options.push_back(o.description);
+    }
+}
+
 void DataProcessor::useLog(bool useLog) {
+    std::lock_guard<std::mutex> lock(_mutex);
     _useLog = useLog;
 }
 
 void DataProcessor::useHistogram(bool useHistogram) {
+    std::lock_guard<std::mutex> lock(_mutex);
     _useHistogram = useHistogram;
 }
 
 void DataProcessor::normValues(glm::vec2 normValues) {
+    std::lock_guard<std::mutex> lock(_mutex);
     _normValues = normValues;
 }
 
 glm::size3_t DataProcessor::dimensions() const {
+    std::lock_guard<std::mutex> lock(_mutex);
     return _dimensions;
 }
 
 glm::vec2 DataProcessor::filterValues() const {
+    std::lock_guard<std::mutex> lock(_mutex);
     return _filterValues;
 }
 
 void DataProcessor::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
     _min.clear();
     _max.clear();
     _sum.clear();
@@ -77,6 +163,29 @@ float DataProcessor::processDataPoint(float value, int option) {
     }
 }
 
+void DataProcessor::processDataPoints(float* values, size_t numValues, int option) {
+    if (_numValues.empty()) {
+        std::fill(values, values + numValues, 0.f);
+        return;
+    }
+    const float mean = (1.f / _numValues[option]) * _sum[option];
+    const float sd = _standardDeviation[option];
+
+    if (_useHistogram) {
+        const Histogram& histogram = *_histograms[option];
+        for (size_t i = 0; i < numValues; ++i) {
+            values[i] = histogram.equalize(
+                normalizeWithStandardScore(values[i], mean, sd, _histNormValues)
+            ) / 512.f;
+        }
+    }
+    else {
+        for (size_t i = 0; i < numValues; ++i) {
+            values[i] = normalizeWithStandardScore(values[i], mean, sd, _normValues);
+        }
+    }
+}
+
 float DataProcessor::normalizeWithStandardScore(float value, float mean, float sd,
                                                 const glm::vec2& normalizationValues)
 {
@@ -166,28 +275,24 @@ void DataProcessor::calculateFilterValues(const std::vector<int>& selectedOption
     }
 }
 
-void DataProcessor::add(const std::vector<std::vector<float>>& optionValues,
-                        const std::vector<float>& sum)
-{
+void DataProcessor::add(const std::vector<std::vector<float>>& optionValues) {
     const int numOptions = static_cast<int>(optionValues.size());
 
     for (int i = 0; i < numOptions; ++i) {
         const std::vector<float>& values = optionValues[i];
         const int numValues = static_cast<int>(values.size());
 
-        const float mean = sum[i] / numValues;
-        const float variance = std::accumulate(
-            values.begin(),
-            values.end(),
-            0.f,
-            [mean](float l, float r) { return l + pow(r - mean, 2); }
-        );
-        const float standardDeviation = sqrt(variance / numValues);
+        const ValueStatistics stats = valueStatistics(values);
+        _min[i] = std::min(_min[i], stats.min);
+        _max[i] = std::max(_max[i], stats.max);
+
+        const float mean = stats.sum / numValues;
+        const float standardDeviation = sqrt(stats.squaredDeviations / numValues);
 
         const float oldStandardDeviation = _standardDeviation[i];
         const float oldMean = (1.f / _numValues[i]) * _sum[i];
 
-        _sum[i] += sum[i];
+        _sum[i] += stats.sum;
         _standardDeviation[i] = sqrt(pow(standardDeviation, 2) +
                                 pow(_standardDeviation[i], 2));
         _numValues[i] += numValues;
@@ -28,6 +28,7 @@
 #include <ghoul/glm.h>
 #include <glm/gtx/std_based_type.hpp>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -38,10 +39,26 @@ namespace properties { class SelectionProperty; }
 
 class Histogram;
 
+/**
+ * Converts the raw data of a cygnet into normalized texture data. A DataProcessor can be
+ * shared by all cygnets in a group and its functions can be called from any thread;
+ * processData is called on the IswaManager's processing threads.
+ */
 class DataProcessor {
     //friend class IswaBaseGroup;
 
 public:
+    /**
+     * A copy of the options and the current selection of a data options property, so
+     * that the data can be processed without accessing the property.
+     */
+    struct Selection {
+        explicit Selection(const properties::SelectionProperty& dataOptions);
+
+        std::vector<std::string> options;
+        std::vector<int> selected;
+    };
+
     DataProcessor() = default;
     virtual ~DataProcessor() = default;
 
@@ -52,7 +69,7 @@ public:
         properties::SelectionProperty& dataOptions) = 0;
 
     virtual std::vector<float*> processData(const std::string& data,
-        properties::SelectionProperty& dataOptions, glm::size3_t& dimensions) = 0;
+        const Selection& selection, const glm::size3_t& dimensions) = 0;
 
     void useLog(bool useLog);
     void useHistogram(bool useHistogram);
@@ -65,6 +82,9 @@ public:
 protected:
     float processDataPoint(float value, int option);
 
+    /// Normalizes all numValues values in place; requires _mutex to be locked
+    void processDataPoints(float* values, size_t numValues, int option);
+
     float normalizeWithStandardScore(float value, float mean, float sd,
         const glm::vec2& normalizationValues = glm::vec2(1.f, 1.f));
 
@@ -73,8 +93,10 @@ protected:
 
     void initializeVectors(int numOptions);
     void calculateFilterValues(const std::vector<int>& selectedOptions);
-    void add(const std::vector<std::vector<float>>& optionValues,
-        const std::vector<float>& sum);
+    void add(const std::vector<std::vector<float>>& optionValues);
+
+    /// Guards all members, as a processor is shared between cygnets and threads
+    mutable std::mutex _mutex;
 
     glm::size3_t _dimensions;
     bool _useLog = false;
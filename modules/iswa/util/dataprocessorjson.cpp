@@ -64,6 +64,8 @@ std::vector<std::string> DataProcessorJson::readMetadata(const std::string& data
 void DataProcessorJson::addDataValues(const std::string& data,
                                       properties::SelectionProperty& dataOptions)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     int numOptions = static_cast<int>(dataOptions.options().size());
     initializeVectors(numOptions);
 
@@ -71,7 +73,6 @@ void DataProcessorJson::addDataValues(const std::string& data,
         const json& j = json::parse(data);
         json variables = j["variables"];
 
-        std::vector<float> sum(numOptions, 0.f);
         std::vector<std::vector<float>> optionValues(numOptions, std::vector<float>());
         const std::vector<properties::SelectionProperty::Option>& options =
             dataOptions.options();
@@ -85,56 +86,55 @@ void DataProcessorJson::addDataValues(const std::string& data,
                 const int colsize = static_cast<int>(col.size());
 
                 for (int x = 0; x < colsize; ++x) {
-                    const float value = col.at(x);
-                    optionValues[i].push_back(value);
-                    _min[i] = std::min(_min[i], value);
-                    _max[i] = std::max(_max[i], value);
-                    sum[i] += value;
+                    optionValues[i].push_back(col.at(x));
                 }
             }
         }
 
-        add(optionValues, sum);
+        add(optionValues);
     }
 }
 
 std::vector<float*> DataProcessorJson::processData(const std::string& data,
-                                                properties::SelectionProperty& optionProp,
-                                                                 glm::size3_t& dimensions)
+                                                   const Selection& selection,
+                                                   const glm::size3_t& dimensions)
 {
     if (data.empty()) {
         return std::vector<float*>();
     }
-    const json& j = json::parse(data);
-    json variables = j["variables"];
-
-    const std::vector<int>& selectedOptions = optionProp;
+    json j = json::parse(data);
+    json& variables = j["variables"];
 
-    const std::vector<properties::SelectionProperty::Option>& options =
-                                                                     optionProp.options();
+    const std::vector<int>& selectedOptions = selection.selected;
 
-    std::vector<float*> dataOptions(options.size(), nullptr);
+    std::vector<float*> dataOptions(selection.options.size(), nullptr);
+    std::vector<size_t> numParsed(selection.options.size(), 0);
     for (int option : selectedOptions) {
         // @CLEANUP: This memory is very easy to lose and should be replaced by some
         //           other mechanism (std::vector<float> most likely)
         dataOptions[option] = new float[dimensions.x * dimensions.y] { 0.f };
 
-        json row = variables[options[option].description];
+        const json& row = variables[selection.options[option]];
         const int rowsize = static_cast<int>(row.size());
 
         for (int y = 0; y < rowsize; ++y) {
-            json col = row.at(y);
+            const json& col = row.at(y);
             const int colsize = static_cast<int>(col.size());
 
             for (int x = 0; x < colsize; ++x) {
-                const float value = col.at(x);
                 const int i = x + y * colsize;
-
-                dataOptions[option][i] = processDataPoint(value, option);
+                dataOptions[option][i] = col.at(x);
             }
+            numParsed[option] += colsize;
         }
     }
 
+    // Parsing above does not touch any shared state, so only the normalization has to
+    // be done while holding the lock
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (int option : selectedOptions) {
+        processDataPoints(dataOptions[option], numParsed[option], option);
+    }
     calculateFilterValues(selectedOptions);
     return dataOptions;
 }
@@ -41,6 +41,8 @@ DataProcessorKameleon::~DataProcessorKameleon() {}
 std::vector<std::string> DataProcessorKameleon::readMetadata(const std::string& path,
                                                              glm::size3_t&)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     if (path.empty()) {
         return std::vector<std::string>();
     }
@@ -67,6 +69,8 @@ std::vector<std::string> DataProcessorKameleon::readMetadata(const std::string&
 void DataProcessorKameleon::addDataValues(const std::string& path,
                                           properties::SelectionProperty& dataOptions)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     int numOptions = static_cast<int>(dataOptions.options().size());
     initializeVectors(numOptions);
 
@@ -78,7 +82,6 @@ void DataProcessorKameleon::addDataValues(const std::string& path,
         initializeKameleonWrapper(path);
     }
 
-    std::vector<float> sum(numOptions, 0.f);
     std::vector<std::vector<float>> optionValues(numOptions, std::vector<float>());
     const std::vector<properties::SelectionProperty::Option>& options =
                                                                     dataOptions.options();
@@ -93,24 +96,21 @@ void DataProcessorKameleon::addDataValues(const std::string& path,
             0.5f
         );
 
-        for (int j=0; j<numValues; j++) {
-            const float value = values[j];
-
-            optionValues[i].push_back(value);
-            _min[i] = std::min(_min[i], value);
-            _max[i] = std::max(_max[i], value);
-            sum[i] += value;
-        }
+        optionValues[i].assign(values, values + numValues);
+        delete[] values;
     }
 
-    add(optionValues, sum);
+    add(optionValues);
 }
 
 std::vector<float*> DataProcessorKameleon::processData(const std::string& path,
-                                                properties::SelectionProperty& optionProp,
-                                                                 glm::size3_t& dimensions)
+                                                       const Selection& selection,
+                                                       const glm::size3_t& dimensions)
 {
-    const int numOptions = static_cast<int>(optionProp.options().size());
+    // The KameleonWrapper is not thread-safe, so the lock is held for the whole function
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const int numOptions = static_cast<int>(selection.options.size());
 
     if (path.empty()) {
         return std::vector<float*>(numOptions, nullptr);
@@ -120,25 +120,18 @@ std::vector<float*> DataProcessorKameleon::processData(const std::string& path,
         initializeKameleonWrapper(path);
     }
 
-    const std::vector<int>& selectedOptions = optionProp;
+    const std::vector<int>& selectedOptions = selection.selected;
 
-    const std::vector<properties::SelectionProperty::Option>& options =
-        optionProp.options();
-
-    const int numValues = static_cast<int>(glm::compMul(dimensions));
+    const size_t numValues = glm::compMul(dimensions);
 
     std::vector<float*> dataOptions(numOptions, nullptr);
     for (int option : selectedOptions) {
         dataOptions[option] = _kw->uniformSliceValues(
-            options[option].description,
+            selection.options[option],
             dimensions,
             _slice
         );
-
-        for (int i = 0; i < numValues; i++) {
-            const float value = dataOptions[option][i];
-            dataOptions[option][i] = processDataPoint(value, option);
-        }
+        processDataPoints(dataOptions[option], numValues, option);
     }
 
     calculateFilterValues(selectedOptions);
@@ -146,10 +139,12 @@ std::vector<float*> DataProcessorKameleon::processData(const std::string& path,
 }
 
 void DataProcessorKameleon::setSlice(float slice) {
+    std::lock_guard<std::mutex> lock(_mutex);
     _slice = slice;
 }
 
 void DataProcessorKameleon::setDimensions(glm::size3_t dimensions) {
+    std::lock_guard<std::mutex> lock(_mutex);
     _dimensions = std::move(dimensions);
 }
 
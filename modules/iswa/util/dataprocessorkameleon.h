@@ -43,7 +43,7 @@ public:
         properties::SelectionProperty& dataOptions) override;
 
     virtual std::vector<float*> processData(const std::string& path,
-        properties::SelectionProperty& dataOptions, glm::size3_t& dimensions) override;
+        const Selection& selection, const glm::size3_t& dimensions) override;
 
     void setSlice(float slice);
 
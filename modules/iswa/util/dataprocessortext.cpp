@@ -83,6 +83,8 @@ std::vector<std::string> DataProcessorText::readMetadata(const std::string& data
 void DataProcessorText::addDataValues(const std::string& data,
                                       properties::SelectionProperty& dataOptions)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     int numOptions = static_cast<int>(dataOptions.options().size());
     initializeVectors(numOptions);
 
@@ -93,8 +95,6 @@ void DataProcessorText::addDataValues(const std::string& data,
     std::string line;
     std::stringstream memorystream(data);
 
-    // for standard diviation in the add() function
-    std::vector<float> sum(numOptions, 0.f);
     std::vector<std::vector<float>> optionValues(numOptions);
 
     // for each data point
@@ -117,7 +117,7 @@ void DataProcessorText::addDataValues(const std::string& data,
 
             float v = std::stof(val);
             // Some values are "NaN", use 0 instead
-            values.push_back(std::isnan(v) ? v : 0.f);
+            values.push_back(std::isnan(v) ? 0.f : v);
             val.clear();
         }
 
@@ -126,21 +126,16 @@ void DataProcessorText::addDataValues(const std::string& data,
         }
 
         for (int i = 0; i < numOptions; ++i) {
-            const float value = values[i];
-
-            optionValues[i].push_back(value);
-            _min[i] = std::min(_min[i], value);
-            _max[i] = std::max(_max[i], value);
-            sum[i] += value;
+            optionValues[i].push_back(values[i]);
         }
     }
 
-    add(optionValues, sum);
+    add(optionValues);
 }
 
 std::vector<float*> DataProcessorText::processData(const std::string& data,
-                                                   properties::SelectionProperty& options,
-                                                                 glm::size3_t& dimensions)
+                                                   const Selection& selection,
+                                                   const glm::size3_t& dimensions)
 {
     if (data.empty()) {
         return std::vector<float*>();
@@ -149,11 +144,12 @@ std::vector<float*> DataProcessorText::processData(const std::string& data,
     std::string line;
     std::stringstream memorystream(data);
 
-    const std::vector<int>& selectedOptions = options.value();
+    const std::vector<int>& selectedOptions = selection.selected;
+    const size_t numPoints = dimensions.x * dimensions.y;
 
-    std::vector<float*> dataOptions(options.options().size(), nullptr);
+    std::vector<float*> dataOptions(selection.options.size(), nullptr);
     for (int o : selectedOptions) {
-        dataOptions[o] = new float[dimensions.x * dimensions.y] { 0.f };
+        dataOptions[o] = new float[numPoints] { 0.f };
     }
 
     int numValues = 0;
@@ -177,8 +173,7 @@ std::vector<float*> DataProcessorText::processData(const std::string& data,
                 option
             );
             if (option >= 0 && it != selectedOptions.end()) {
-                const float value = std::stof(line.substr(first, last));
-                dataOptions[option][numValues] = processDataPoint(value, option);
+                dataOptions[option][numValues] = std::stof(line.substr(first, last));
             }
 
             option++;
@@ -187,6 +182,13 @@ std::vector<float*> DataProcessorText::processData(const std::string& data,
         numValues++;
     }
 
+    // Parsing above does not touch any shared state, so only the normalization has to
+    // be done while holding the lock
+    std::lock_guard<std::mutex> lock(_mutex);
+    const size_t numParsed = std::min(static_cast<size_t>(numValues), numPoints);
+    for (int o : selectedOptions) {
+        processDataPoints(dataOptions[o], numParsed, o);
+    }
     calculateFilterValues(selectedOptions);
 
     return dataOptions;
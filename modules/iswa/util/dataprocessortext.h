@@ -41,7 +41,7 @@ public:
         properties::SelectionProperty& dataOptions) override;
 
     virtual std::vector<float*> processData(const std::string& data,
-        properties::SelectionProperty& dataOptions, glm::size3_t& dimensions) override;
+        const Selection& selection, const glm::size3_t& dimensions) override;
 };
 
 } // namespace openspace
@@ -38,10 +38,12 @@
 #include <openspace/scene/scene.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/threadpool.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/constexpr.h>
+#include <algorithm>
 #include <fstream>
 
 #include "iswamanager_lua.inl"
@@ -82,6 +84,14 @@ namespace {
     using json = nlohmann::json;
     constexpr const char* _loggerCat = "IswaManager";
 
+    constexpr openspace::properties::Property::PropertyInfo FrameCacheBudgetInfo = {
+        "FrameCacheBudget",
+        "Frame Cache Budget (MB)",
+        "The amount of memory that all cygnets combined may use to keep downloaded "
+        "frames around, so that they do not have to be downloaded again when the time "
+        "is scrubbed or played back faster than real time."
+    };
+
     void createScreenSpace(int id) {
         std::string idStr = std::to_string(id);
         openspace::global::scriptEngine.queueScript(
@@ -99,7 +109,10 @@ IswaManager* IswaManager::_instance = nullptr;
 IswaManager::IswaManager()
     : properties::PropertyOwner({ "IswaManager" })
     , _baseUrl("https://iswa-demo-server.herokuapp.com/")
+    , _frameCacheBudget(FrameCacheBudgetInfo, 512, 0, 8192)
 {
+    addProperty(_frameCacheBudget);
+
     _type[CygnetType::Texture] = "Texture";
     _type[CygnetType::Data] = "Data";
     _type[CygnetType::Kameleon] = "Kameleon";
@@ -107,6 +120,9 @@ IswaManager::IswaManager()
     _geom[CygnetGeometry::Plane] = "Plane";
     _geom[CygnetGeometry::Sphere] = "Sphere";
 
+    const unsigned int nThreads = std::thread::hardware_concurrency();
+    _processingThreads = std::make_unique<ThreadPool>(std::max(nThreads / 2, 1u));
+
     global::downloadManager.fetchFile(
         "http://iswa3.ccmc.gsfc.nasa.gov/IswaSystemWebApp/CygnetHealthServlet",
         [this](const DownloadManager::MemoryFile& file) {
@@ -116,6 +132,7 @@ IswaManager::IswaManager()
 }
 
 IswaManager::~IswaManager() {
+    _processingThreads = nullptr;
     _groups.clear();
     _cygnetInformation.clear();
 }
@@ -251,6 +268,24 @@ std::future<DownloadManager::MemoryFile> IswaManager::fetchDataCygnet(int id,
         );
 }
 
+ThreadPool& IswaManager::processingThreads() {
+    return *_processingThreads;
+}
+
+void IswaManager::addCachedFrame(size_t bytes) {
+    _frameCacheSize += bytes;
+}
+
+void IswaManager::removeCachedFrame(size_t bytes) {
+    ghoul_assert(bytes <= _frameCacheSize, "Removing more than was added");
+    _frameCacheSize -= bytes;
+}
+
+bool IswaManager::isFrameCacheFull() const {
+    const size_t budget = static_cast<size_t>(_frameCacheBudget) * 1024 * 1024;
+    return _frameCacheSize > budget;
+}
+
 std::string IswaManager::iswaUrl(int id, double timestamp, const std::string& type) {
     std::string url;
     if (id < 0) {
@@ -28,8 +28,10 @@
 #include <openspace/properties/propertyowner.h>
 
 #include <openspace/engine/downloadmanager.h>
+#include <openspace/properties/scalar/intproperty.h>
 #include <ghoul/designpattern/event.h>
 #include <future>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -41,6 +43,7 @@ namespace scripting { struct LuaLibrary; }
 
 class IswaBaseGroup;
 class IswaCygnet;
+class ThreadPool;
 
 struct CdfInfo {
     std::string name;
@@ -87,6 +90,21 @@ public:
 
     std::future<DownloadManager::MemoryFile> fetchImageCygnet(int id, double timestamp);
     std::future<DownloadManager::MemoryFile> fetchDataCygnet(int id, double timestamp);
+
+    /**
+     * Returns the worker threads on which the downloaded data of cygnets is decoded and
+     * normalized, so that only the texture upload is left for the main thread.
+     */
+    ThreadPool& processingThreads();
+
+    /**
+     * Accounts for \p bytes of downloaded frames that are kept in the frame cache of a
+     * cygnet. All cygnets share the budget given by the FrameCacheBudget property.
+     */
+    void addCachedFrame(size_t bytes);
+    void removeCachedFrame(size_t bytes);
+    bool isFrameCacheFull() const;
+
     std::string iswaUrl(int id, double timestamp, const std::string& type = "image");
 
     IswaBaseGroup* iswaGroup(const std::string& name);
@@ -129,6 +147,11 @@ private:
 
     std::string _baseUrl;
 
+    std::unique_ptr<ThreadPool> _processingThreads;
+
+    properties::IntProperty _frameCacheBudget;
+    size_t _frameCacheSize = 0;
+
     static IswaManager* _instance;
 };
 
@@ -25,10 +25,17 @@
 #ifndef __OPENSPACE_MODULE_KAMELEON___KAMELEONHELPER___H__
 #define __OPENSPACE_MODULE_KAMELEON___KAMELEONHELPER___H__
 
+#include <ghoul/glm.h>
+#include <glm/gtx/std_based_type.hpp>
+#include <functional>
 #include <memory>
 #include <string>
 
-namespace ccmc { class Kameleon; }
+namespace ccmc {
+    class Interpolator;
+    class Kameleon;
+    class Model;
+} // namespace ccmc
 
 namespace openspace::kameleonHelper {
 
@@ -41,6 +48,22 @@ namespace openspace::kameleonHelper {
 std::unique_ptr<ccmc::Kameleon> createKameleonObject(const std::string& cdfFilePath);
 double getTime(ccmc::Kameleon* kameleon);
 
+/**
+ * Samples each cell of a uniform grid with the provided \p dimensions. The grid is split
+ * into tiles that are distributed over all hardware threads. As interpolators cache
+ * state between calls, each thread uses its own interpolator created from the
+ * \p model. All variables that are sampled have to be loaded into the \p model
+ * beforehand, as loading is not thread-safe.
+ *
+ * \param sample Called once for each cell with the interpolator of the calling thread
+ *        and the coordinates of the cell. Calls for different cells happen concurrently
+ * \param onProgress Called on the calling thread with the fraction of the grid that has
+ *        been sampled so far. Can be empty
+ */
+void sampleUniformGrid(ccmc::Model& model, const glm::size3_t& dimensions,
+    const std::function<void(ccmc::Interpolator&, const glm::size3_t&)>& sample,
+    const std::function<void(float)>& onProgress = std::function<void(float)>());
+
 } //namespace openspace::kameleonHelper
 
 #endif // __OPENSPACE_MODULE_KAMELEON___KAMELEONHELPER___H__
@@ -28,6 +28,7 @@
 #include <ghoul/glm.h>
 #include <glm/gtx/std_based_type.hpp>
 #include <array>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -84,14 +85,31 @@ public:
     bool open(const std::string& filename);
     void close();
 
+    /// Called with the fraction of the samples that have been computed so far
+    using ProgressCallback = std::function<void(float)>;
+
+    /**
+     * The uniform sampling methods sample the model in parallel on all hardware threads
+     * and report their progress through the optional \p onProgress callback.
+     */
     float* uniformSampledValues(const std::string& var,
-        const glm::size3_t& outDimensions) const;
+        const glm::size3_t& outDimensions,
+        const ProgressCallback& onProgress = ProgressCallback()) const;
 
     float* uniformSliceValues(const std::string& var, const glm::size3_t& outDimensions,
-        const float& zSlice) const;
-
+        const float& zSlice,
+        const ProgressCallback& onProgress = ProgressCallback()) const;
+
+    /**
+     * Samples the vector field made up of \p xVar, \p yVar, and \p zVar on a uniform
+     * grid with \p outDimensions and returns four floats per sample, the last of which
+     * is always 1. If \p isNormalized is \c true, each component is scaled to [0,1] by
+     * the range of its variable, otherwise the interpolated values are returned as-is.
+     */
     float* uniformSampledVectorValues(const std::string& xVar, const std::string& yVar,
-        const std::string& zVar, const glm::size3_t& outDimensions) const;
+        const std::string& zVar, const glm::size3_t& outDimensions,
+        const ProgressCallback& onProgress = ProgressCallback(),
+        bool isNormalized = true) const;
 
     Fieldlines classifiedFieldLines(const std::string& xVar, const std::string& yVar,
         const std::string& zVar, const std::vector<glm::vec3>& seedPoints,
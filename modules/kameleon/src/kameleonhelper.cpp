@@ -27,6 +27,12 @@
 #include <openspace/util/time.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning (push)
@@ -35,6 +41,8 @@
 #endif // _MSC_VER
 
 #include <ccmc/Kameleon.h>
+#include <ccmc/Interpolator.h>
+#include <ccmc/Model.h>
 
 #ifdef _MSC_VER
 #pragma warning (pop)
@@ -43,6 +51,15 @@
 
 namespace {
     constexpr const char* _loggerCat = "KameleonHelper";
+
+    // The edge length of the tiles that are distributed to the threads when sampling a
+    // uniform grid. Neighboring cells are sampled by the same thread, which keeps the
+    // cell cache of its interpolator warm
+    constexpr const size_t SampleTileSize = 16;
+
+    constexpr const std::chrono::milliseconds ProgressInterval(100);
+
+    using GridSampler = std::function<void(ccmc::Interpolator&, const glm::size3_t&)>;
 } // namespace
 
 namespace openspace::kameleonHelper {
@@ -156,4 +173,67 @@ double getTime(ccmc::Kameleon* kameleon) {
     return seqStartDbl + stateStartOffset;
 }
 
+void sampleUniformGrid(ccmc::Model& model, const glm::size3_t& dimensions,
+                       const GridSampler& sample,
+                       const std::function<void(float)>& onProgress)
+{
+    const glm::size3_t nTiles = (dimensions + glm::size3_t(SampleTileSize - 1)) /
+                                SampleTileSize;
+    const size_t totalTiles = nTiles.x * nTiles.y * nTiles.z;
+    if (totalTiles == 0) {
+        return;
+    }
+
+    std::atomic<size_t> nextTile(0);
+    std::atomic<size_t> finishedTiles(0);
+    auto sampleTiles = [&]() {
+        std::unique_ptr<ccmc::Interpolator> interpolator(model.createNewInterpolator());
+
+        for (size_t tile = nextTile++; tile < totalTiles; tile = nextTile++) {
+            const glm::size3_t tileCoords = glm::size3_t(
+                tile % nTiles.x,
+                (tile / nTiles.x) % nTiles.y,
+                tile / (nTiles.x * nTiles.y)
+            );
+            const glm::size3_t begin = tileCoords * SampleTileSize;
+            const glm::size3_t end = glm::min(
+                begin + glm::size3_t(SampleTileSize),
+                dimensions
+            );
+
+            for (size_t z = begin.z; z < end.z; ++z) {
+                for (size_t y = begin.y; y < end.y; ++y) {
+                    for (size_t x = begin.x; x < end.x; ++x) {
+                        sample(*interpolator, glm::size3_t(x, y, z));
+                    }
+                }
+            }
+            ++finishedTiles;
+        }
+    };
+
+    const size_t nThreads = std::min(
+        static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u)),
+        totalTiles
+    );
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0; i < nThreads; ++i) {
+        futures.push_back(std::async(std::launch::async, sampleTiles));
+    }
+
+    for (std::future<void>& f : futures) {
+        while (f.wait_for(ProgressInterval) != std::future_status::ready) {
+            if (onProgress) {
+                onProgress(static_cast<float>(finishedTiles) / totalTiles);
+            }
+        }
+        // Rethrows any exception that was thrown while sampling
+        f.get();
+    }
+
+    if (onProgress) {
+        onProgress(1.f);
+    }
+}
+
 } // namespace openspace::kameleonHelper {
@@ -24,6 +24,8 @@
 
 #include <modules/kameleon/include/kameleonwrapper.h>
 
+#include <modules/kameleon/include/kameleonhelper.h>
+
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
@@ -180,7 +182,8 @@ void KameleonWrapper::close() {
 
 // This method returns new'd memory,  turn into std::vector<float> instead?
 float* KameleonWrapper::uniformSampledValues(const std::string& var,
-                                             const glm::size3_t& outDimensions) const
+                                             const glm::size3_t& outDimensions,
+                                             const ProgressCallback& onProgress) const
 {
     ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
 
@@ -190,6 +193,8 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
     float* data = new float[size];
     std::vector<double> doubleData(size);
 
+    // Loading the variable is not thread-safe, so it has to happen before sampling
+    _model->loadVariable(var);
 
     const double varMin =
         _model->getVariableAttribute(var, "actual_min").getAttributeFloat();
@@ -198,6 +203,85 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
         _model->getVariableAttribute(var, "actual_max").getAttributeFloat();
     LDEBUG(fmt::format("{} Max: {}", var, varMax));
 
+    auto sample = [&](ccmc::Interpolator& interpolator, const glm::size3_t& cell) {
+        const size_t x = cell.x;
+        const size_t y = cell.y;
+        const size_t z = cell.z;
+        const size_t index = x + y * outDimensions.x +
+                             z * outDimensions.x * outDimensions.y;
+
+        if (_gridType == GridType::Spherical) {
+            // Put r in the [0..sqrt(3)] range
+            const double rNorm = glm::root_three<double>() * x / outDimensions.x - 1;
+
+            // Put theta in the [0..PI] range
+            const double thetaNorm = glm::pi<double>() * y / outDimensions.y - 1;
+
+            // Put phi in the [0..2PI] range
+            const double phiNorm = glm::two_pi<double>() * z / outDimensions.z - 1;
+
+            // Go to physical coordinates before sampling
+            const double rPh = _min.x + rNorm * (_max.x - _min.x);
+            const double thetaPh = thetaNorm;
+            // phi range needs to be mapped to the slightly different model
+            // range to avoid gaps in the data Subtract a small term to
+            // avoid rounding errors when comparing to phiMax.
+            const double phiPh = _min.z + phiNorm /
+                                 glm::two_pi<double>() * (_max.z - _min.z - 0.000001);
+
+            double value = 0.0;
+            // See if sample point is inside domain
+            if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
+                thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
+            {
+                if (phiPh > _max.z) {
+                    LWARNING("Warning: There might be a gap in the data");
+                }
+                // Leave values at zero if outside domain
+            } else { // if inside
+                // ENLIL CDF specific hacks!
+                // Convert from meters to AU for interpolator
+                const double localRPh = rPh / ccmc::constants::AU_in_meters;
+                // Convert from colatitude [0, pi] rad to latitude [-90, 90] deg
+                const double localThetaPh = -thetaPh * 180.f /
+                                            glm::pi<double>() + 90.f;
+                // Convert from [0, 2pi] rad to [0, 360] degrees
+                const double localPhiPh = phiPh * 180.f / glm::pi<double>();
+                // Sample
+                value = interpolator.interpolate(
+                    var,
+                    static_cast<float>(localRPh),
+                    static_cast<float>(localThetaPh),
+                    static_cast<float>(localPhiPh)
+                );
+            }
+
+            doubleData[index] = value;
+        } else {
+            // Assume cartesian for fallback purpose
+            const double stepX = (_max.x - _min.x) /
+                                 (static_cast<double>(outDimensions.x));
+            const double stepY = (_max.y - _min.y) /
+                                 (static_cast<double>(outDimensions.y));
+            const double stepZ = (_max.z - _min.z) /
+                                 (static_cast<double>(outDimensions.z));
+
+            const double xPos = _min.x + stepX * x;
+            const double yPos = _min.y + stepY * y;
+            const double zPos = _min.z + stepZ * z;
+
+            // get interpolated data value for (xPos, yPos, zPos)
+            // swap yPos and zPos because model has Z as up
+            doubleData[index] = interpolator.interpolate(
+                var,
+                static_cast<float>(xPos),
+                static_cast<float>(zPos),
+                static_cast<float>(yPos)
+            );
+        }
+    };
+    kameleonHelper::sampleUniformGrid(*_model, outDimensions, sample, onProgress);
+
     // HISTOGRAM
     constexpr const int NBins = 200;
     std::vector<int> histogram(NBins, 0);
@@ -210,91 +294,8 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
 
         return glm::clamp(izerotoone, 0, NBins - 1);
     };
-
-    // ProgressBar pb(static_cast<int>(outDimensions.x));
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-                const size_t index = x + y * outDimensions.x +
-                                     z * outDimensions.x * outDimensions.y;
-
-                if (_gridType == GridType::Spherical) {
-                    // Put r in the [0..sqrt(3)] range
-                    const double rNorm = glm::root_three<double>() * x /
-                                         outDimensions.x - 1;
-
-                    // Put theta in the [0..PI] range
-                    const double thetaNorm = glm::pi<double>() * y / outDimensions.y - 1;
-
-                    // Put phi in the [0..2PI] range
-                    const double phiNorm = glm::two_pi<double>() * z /
-                                           outDimensions.z - 1;
-
-                    // Go to physical coordinates before sampling
-                    const double rPh = _min.x + rNorm * (_max.x - _min.x);
-                    const double thetaPh = thetaNorm;
-                    // phi range needs to be mapped to the slightly different model
-                    // range to avoid gaps in the data Subtract a small term to
-                    // avoid rounding errors when comparing to phiMax.
-                    const double phiPh = _min.z + phiNorm /
-                                    glm::two_pi<double>() * (_max.z - _min.z - 0.000001);
-
-                    double value = 0.0;
-                    // See if sample point is inside domain
-                    if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
-                        thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
-                    {
-                        if (phiPh > _max.z) {
-                            LWARNING("Warning: There might be a gap in the data");
-                        }
-                        // Leave values at zero if outside domain
-                    } else { // if inside
-                        // ENLIL CDF specific hacks!
-                        // Convert from meters to AU for interpolator
-                        const double localRPh = rPh / ccmc::constants::AU_in_meters;
-                        // Convert from colatitude [0, pi] rad to latitude [-90, 90] deg
-                        const double localThetaPh = -thetaPh * 180.f /
-                                                    glm::pi<double>() + 90.f;
-                        // Convert from [0, 2pi] rad to [0, 360] degrees
-                        const double localPhiPh = phiPh * 180.f / glm::pi<double>();
-                        // Sample
-                        value = _interpolator->interpolate(
-                            var,
-                            static_cast<float>(localRPh),
-                            static_cast<float>(localThetaPh),
-                            static_cast<float>(localPhiPh)
-                        );
-                    }
-
-                    doubleData[index] = value;
-                    histogram[mapToHistogram(value)]++;
-
-                } else {
-                    // Assume cartesian for fallback purpose
-                    const double stepX = (_max.x - _min.x) /
-                                         (static_cast<double>(outDimensions.x));
-                    const double stepY = (_max.y - _min.y) /
-                                         (static_cast<double>(outDimensions.y));
-                    const double stepZ = (_max.z - _min.z) /
-                                         (static_cast<double>(outDimensions.z));
-
-                    const double xPos = _min.x + stepX * x;
-                    const double yPos = _min.y + stepY * y;
-                    const double zPos = _min.z + stepZ * z;
-
-                    // get interpolated data value for (xPos, yPos, zPos)
-                    // swap yPos and zPos because model has Z as up
-                    double value = _interpolator->interpolate(
-                        var,
-                        static_cast<float>(xPos),
-                        static_cast<float>(zPos),
-                        static_cast<float>(yPos)
-                    );
-                    doubleData[index] = value;
-                    histogram[mapToHistogram(value)]++;
-                }
-            }
-        }
+    for (double value : doubleData) {
+        histogram[mapToHistogram(value)]++;
     }
 
     int sum = 0;
@@ -330,7 +331,8 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
 // This method returns new'd memory,  turn into std::vector<float> instead?
 float* KameleonWrapper::uniformSliceValues(const std::string& var,
                                            const glm::size3_t& outDimensions,
-                                           const float& slice) const
+                                           const float& slice,
+                                           const ProgressCallback& onProgress) const
 {
     ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
     LINFO(fmt::format(
@@ -340,7 +342,6 @@ float* KameleonWrapper::uniformSliceValues(const std::string& var,
 
     const size_t size = outDimensions.x * outDimensions.y * outDimensions.z;
     float* data = new float[size];
-    std::vector<double> doubleData(size);
 
     _model->loadVariable(var);
 
@@ -364,91 +365,77 @@ float* KameleonWrapper::uniformSliceValues(const std::string& var,
     LDEBUG(fmt::format("{} min: {}", var, varMin));
     LDEBUG(fmt::format("{} max: {}", var, varMax));
 
-    //double maxValue = 0.0;
-    //double minValue = std::numeric_limits<double>::max();
-
-    float missingValue = _model->getMissingValue();
-
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for(size_t z = 0; z < outDimensions.z; ++z){
-
-                const float xi = (hasXSlice) ? slice : x;
-                const float yi = (hasYSlice) ? slice : y;
-                const float zi = (hasZSlice) ? slice : z;
-
-                double value = 0;
-                const size_t index = x + y * outDimensions.x +
-                                     z * outDimensions.x * outDimensions.y;
-                if (_gridType == GridType::Spherical) {
-                        // int z = zSlice;
-                        // Put r in the [0..sqrt(3)] range
-                        const double rNorm = glm::root_three<double>() * xi / xDim;
-
-                        // Put theta in the [0..PI] range
-                        const double thetaNorm = glm::pi<double>() * yi / yDim;
-
-                        // Put phi in the [0..2PI] range
-                        const double phiNorm = glm::two_pi<double>() * zi / zDim;
-
-                        // Go to physical coordinates before sampling
-                        const double rPh = _min.x + rNorm * (_max.x - _min.x);
-                        const double thetaPh = thetaNorm;
-                        // phi range needs to be mapped to the slightly different model
-                        // range to avoid gaps in the data Subtract a small term to
-                        // avoid rounding errors when comparing to phiMax.
-                        const double phiPh = _min.z + phiNorm / glm::two_pi<double>() *
-                                             (_max.z - _min.z - 0.000001);
-
-                        // See if sample point is inside domain
-                        if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
-                            thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
-                        {
-                            if (phiPh > _max.z) {
-                                LWARNING("Warning: There might be a gap in the data");
-                            }
-                            // Leave values at zero if outside domain
-                        } else { // if inside
-                            // ENLIL CDF specific hacks!
-                            // Convert from meters to AU for interpolator
-                            const double localRPh = rPh / ccmc::constants::AU_in_meters;
-                            // Convert from colatitude [0, pi] rad to [-90, 90] deg
-                            const double localThetaPh = -thetaPh * 180.f /
-                                                        glm::pi<double>() + 90.f;
-                            // Convert from [0, 2pi] rad to [0, 360] degrees
-                            const double localPhiPh = phiPh * 180.f / glm::pi<double>();
-                            // Sample
-                            value = _interpolator->interpolate(
-                                var,
-                                static_cast<float>(localRPh),
-                                static_cast<float>(localPhiPh),
-                                static_cast<float>(localThetaPh)
-                            );
-                        }
-
-                } else {
-                    const double xPos = _min.x + stepX * xi;
-                    const double yPos = _min.y + stepY * yi;
-                    const double zPos = _min.z + stepZ * zi;
-
-                    // std::cout << zPos << ", " << zpos << std::endl;
-                    // Should y and z be flipped?
-                    value = _interpolator->interpolate(
-                        var,
-                        static_cast<float>(xPos),
-                        static_cast<float>(zPos),
-                        static_cast<float>(yPos));
-                }
-
-                if (value != missingValue) {
-                    doubleData[index] = value;
-                    data[index] = static_cast<float>(value);
-                } else {
-                    doubleData[index] = 0;
+    const float missingValue = _model->getMissingValue();
+
+    auto sample = [&](ccmc::Interpolator& interpolator, const glm::size3_t& cell) {
+        const float xi = (hasXSlice) ? slice : cell.x;
+        const float yi = (hasYSlice) ? slice : cell.y;
+        const float zi = (hasZSlice) ? slice : cell.z;
+
+        double value = 0;
+        const size_t index = cell.x + cell.y * outDimensions.x +
+                             cell.z * outDimensions.x * outDimensions.y;
+        if (_gridType == GridType::Spherical) {
+            // Put r in the [0..sqrt(3)] range
+            const double rNorm = glm::root_three<double>() * xi / xDim;
+
+            // Put theta in the [0..PI] range
+            const double thetaNorm = glm::pi<double>() * yi / yDim;
+
+            // Put phi in the [0..2PI] range
+            const double phiNorm = glm::two_pi<double>() * zi / zDim;
+
+            // Go to physical coordinates before sampling
+            const double rPh = _min.x + rNorm * (_max.x - _min.x);
+            const double thetaPh = thetaNorm;
+            // phi range needs to be mapped to the slightly different model
+            // range to avoid gaps in the data Subtract a small term to
+            // avoid rounding errors when comparing to phiMax.
+            const double phiPh = _min.z + phiNorm / glm::two_pi<double>() *
+                                 (_max.z - _min.z - 0.000001);
+
+            // See if sample point is inside domain
+            if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
+                thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
+            {
+                if (phiPh > _max.z) {
+                    LWARNING("Warning: There might be a gap in the data");
                 }
+                // Leave values at zero if outside domain
+            } else { // if inside
+                // ENLIL CDF specific hacks!
+                // Convert from meters to AU for interpolator
+                const double localRPh = rPh / ccmc::constants::AU_in_meters;
+                // Convert from colatitude [0, pi] rad to [-90, 90] deg
+                const double localThetaPh = -thetaPh * 180.f /
+                                            glm::pi<double>() + 90.f;
+                // Convert from [0, 2pi] rad to [0, 360] degrees
+                const double localPhiPh = phiPh * 180.f / glm::pi<double>();
+                // Sample
+                value = interpolator.interpolate(
+                    var,
+                    static_cast<float>(localRPh),
+                    static_cast<float>(localPhiPh),
+                    static_cast<float>(localThetaPh)
+                );
             }
+
+        } else {
+            const double xPos = _min.x + stepX * xi;
+            const double yPos = _min.y + stepY * yi;
+            const double zPos = _min.z + stepZ * zi;
+
+            // Should y and z be flipped?
+            value = interpolator.interpolate(
+                var,
+                static_cast<float>(xPos),
+                static_cast<float>(zPos),
+                static_cast<float>(yPos));
         }
-    }
+
+        data[index] = (value != missingValue) ? static_cast<float>(value) : 0.f;
+    };
+    kameleonHelper::sampleUniformGrid(*_model, outDimensions, sample, onProgress);
 
     return data;
 }
@@ -456,7 +443,9 @@ float* KameleonWrapper::uniformSliceValues(const std::string& var,
 float* KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
                                                    const std::string& yVar,
                                                    const std::string& zVar,
-                                                  const glm::size3_t& outDimensions) const
+                                                  const glm::size3_t& outDimensions,
+                                                const ProgressCallback& onProgress,
+                                                                 bool isNormalized) const
 {
     ghoul_assert(_model && _interpolator, "Model and interpolator must exist");
 
@@ -471,6 +460,15 @@ float* KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
     const size_t size = NumChannels * outDimensions.x * outDimensions.y * outDimensions.z;
     float* data = new float[size];
 
+    if (_gridType != GridType::Cartesian) {
+        LERROR("Only cartesian grid supported for uniformSampledVectorValues (for now)");
+        return data;
+    }
+
+    _model->loadVariable(xVar);
+    _model->loadVariable(yVar);
+    _model->loadVariable(zVar);
+
     float varXMin = _model->getVariableAttribute(xVar, "actual_min").getAttributeFloat();
     float varXMax = _model->getVariableAttribute(xVar, "actual_max").getAttributeFloat();
     float varYMin = _model->getVariableAttribute(yVar, "actual_min").getAttributeFloat();
@@ -482,47 +480,35 @@ float* KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
     const float stepY = (_max.y - _min.y) / (static_cast<float>(outDimensions.y));
     const float stepZ = (_max.z - _min.z) / (static_cast<float>(outDimensions.z));
 
-    //LDEBUG(xVar << "Min: " << varXMin);
-    //LDEBUG(xVar << "Max: " << varXMax);
-    //LDEBUG(yVar << "Min: " << varYMin);
-    //LDEBUG(yVar << "Max: " << varYMax);
-    //LDEBUG(zVar << "Min: " << varZMin);
-    //LDEBUG(zVar << "Max: " << varZMax);
-
-    //ProgressBar pb(static_cast<int>(outDimensions.x));
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        //pb.print(x);
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-                const size_t index = x * NumChannels + y * NumChannels * outDimensions.x +
-                                     z * NumChannels * outDimensions.x * outDimensions.y;
-
-                if (_gridType == GridType::Cartesian) {
-                    const float xPos = _min.x + stepX * x;
-                    const float yPos = _min.y + stepY * y;
-                    const float zPos = _min.z + stepZ * z;
-
-                    // get interpolated data value for (xPos, yPos, zPos)
-                    const float xVal = _interpolator->interpolate(xVar, xPos, yPos, zPos);
-                    const float yVal = _interpolator->interpolate(yVar, xPos, yPos, zPos);
-                    const float zVal = _interpolator->interpolate(zVar, xPos, yPos, zPos);
-
-                    // scale to [0,1]
-                    data[index]     = (xVal - varXMin) / (varXMax - varXMin); // R
-                    data[index + 1] = (yVal - varYMin) / (varYMax - varYMin); // G
-                    data[index + 2] = (zVal - varZMin) / (varZMax - varZMin); // B
-                    // GL_RGB refuses to work. Workaround doing a GL_RGBA  hardcoded alpha
-                    data[index + 3] = 1.f;
-                } else {
-                    LERROR(
-                        "Only cartesian grid supported for "
-                        "uniformSampledVectorValues (for now)"
-                    );
-                    return data;
-                }
-            }
+    auto sample = [&](ccmc::Interpolator& interpolator, const glm::size3_t& cell) {
+        const size_t index = cell.x * NumChannels +
+                             cell.y * NumChannels * outDimensions.x +
+                             cell.z * NumChannels * outDimensions.x * outDimensions.y;
+
+        const float xPos = _min.x + stepX * cell.x;
+        const float yPos = _min.y + stepY * cell.y;
+        const float zPos = _min.z + stepZ * cell.z;
+
+        // get interpolated data value for (xPos, yPos, zPos)
+        const float xVal = interpolator.interpolate(xVar, xPos, yPos, zPos);
+        const float yVal = interpolator.interpolate(yVar, xPos, yPos, zPos);
+        const float zVal = interpolator.interpolate(zVar, xPos, yPos, zPos);
+
+        if (isNormalized) {
+            // scale to [0,1]
+            data[index]     = (xVal - varXMin) / (varXMax - varXMin); // R
+            data[index + 1] = (yVal - varYMin) / (varYMax - varYMin); // G
+            data[index + 2] = (zVal - varZMin) / (varZMax - varZMin); // B
         }
-    }
+        else {
+            data[index]     = xVal;
+            data[index + 1] = yVal;
+            data[index + 2] = zVal;
+        }
+        // GL_RGB refuses to work. Workaround doing a GL_RGBA  hardcoded alpha
+        data[index + 3] = 1.f;
+    };
+    kameleonHelper::sampleUniformGrid(*_model, outDimensions, sample, onProgress);
 
     return data;
 }
@@ -24,6 +24,7 @@
 
 #include <modules/kameleonvolume/kameleonvolumereader.h>
 
+#include <modules/kameleon/include/kameleonhelper.h>
 #include <modules/kameleon/include/kameleonwrapper.h>
 #include <modules/volume/rawvolume.h>
 #include <ghoul/fmt.h>
@@ -94,7 +95,8 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                             const glm::uvec3 & dimensions,
                                                               const std::string& variable,
                                                         const glm::vec3& lowerDomainBound,
-                                                  const glm::vec3& upperDomainBound) const
+                                                        const glm::vec3& upperDomainBound,
+                                                 const ProgressCallback& onProgress) const
 {
     float min, max;
     return readFloatVolume(
@@ -103,7 +105,8 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
         lowerDomainBound,
         upperDomainBound,
         min,
-        max
+        max,
+        onProgress
     );
 }
 
@@ -113,7 +116,8 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                               const glm::vec3& lowerBound,
                                                               const glm::vec3& upperBound,
                                                                           float& minValue,
-                                                                    float& maxValue) const
+                                                                          float& maxValue,
+                                                 const ProgressCallback& onProgress) const
 {
     minValue = std::numeric_limits<float>::max();
     maxValue = -std::numeric_limits<float>::max();
@@ -124,18 +128,29 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
     const glm::vec3 dims = volume->dimensions();
     const glm::vec3 diff = upperBound - lowerBound;
 
-    auto interpolate = [this](const std::string& var, const glm::vec3& coords) {
-        return _interpolator->interpolate(var, coords[0], coords[1], coords[2]);
-    };
+    // Loading the variable is not thread-safe, so it has to happen before sampling
+    _kameleon.model->loadVariable(variable);
 
     float* data = volume->data();
-    for (size_t index = 0; index < volume->nCells(); ++index) {
-        const glm::vec3 coords = volume->indexToCoords(index);
-        const glm::vec3 coordsZeroToOne = coords / dims;
+    auto sample = [&](ccmc::Interpolator& interpolator, const glm::size3_t& cell) {
+        const glm::vec3 coordsZeroToOne = glm::vec3(cell) / dims;
         const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
 
-        data[index] = interpolate(variable, volumeCoords);
+        data[volume->coordsToIndex(glm::uvec3(cell))] = interpolator.interpolate(
+            variable,
+            volumeCoords[0],
+            volumeCoords[1],
+            volumeCoords[2]
+        );
+    };
+    kameleonHelper::sampleUniformGrid(
+        *_kameleon.model,
+        glm::size3_t(dimensions),
+        sample,
+        onProgress
+    );
 
+    for (size_t index = 0; index < volume->nCells(); ++index) {
         minValue = glm::min(minValue, data[index]);
         maxValue = glm::max(maxValue, data[index]);
     }
@@ -170,7 +185,7 @@ std::array<std::string, 3> KameleonVolumeReader::gridVariableNames() const {
 }
 
 void KameleonVolumeReader::addAttributeToDictionary(ghoul::Dictionary& dictionary,
-                                                    const std::string& key,
+                                                                   const std::string& key,
                                                     ccmc::Attribute& attr)
 {
     ccmc::Attribute::AttributeType type = attr.getAttributeType();
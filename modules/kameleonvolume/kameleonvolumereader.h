@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_KAMELEONVOLUME___KAMELEONVOLUMEREADER___H__
 
 #include <ghoul/glm.h>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -51,16 +52,24 @@ namespace openspace::kameleonvolume {
 
 class KameleonVolumeReader {
 public:
+    /// Called with the fraction of the volume that has been sampled so far
+    using ProgressCallback = std::function<void(float)>;
+
     KameleonVolumeReader(std::string path);
 
+    /**
+     * Samples the \p variable on a uniform grid with the \p dimensions that spans the
+     * provided domain. The sampling is distributed over all hardware threads.
+     */
     std::unique_ptr<volume::RawVolume<float>> readFloatVolume(
         const glm::uvec3& dimensions, const std::string& variable,
-        const glm::vec3& lowerDomainBound, const glm::vec3& upperDomainBound) const;
+        const glm::vec3& lowerDomainBound, const glm::vec3& upperDomainBound,
+        const ProgressCallback& onProgress = ProgressCallback()) const;
 
     std::unique_ptr<volume::RawVolume<float>> readFloatVolume(
         const glm::uvec3& dimensions, const std::string& variable,
         const glm::vec3& lowerBound, const glm::vec3& upperBound, float& minValue,
-        float& maxValue) const;
+        float& maxValue, const ProgressCallback& onProgress = ProgressCallback()) const;
 
     ghoul::Dictionary readMetaData() const;
 
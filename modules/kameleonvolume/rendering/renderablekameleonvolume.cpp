@@ -32,6 +32,7 @@
 #include <modules/volume/rendering/volumeclipplanes.h>
 #include <modules/volume/transferfunctionhandler.h>
 #include <modules/volume/volumegridtype.h>
+#include <modules/volume/volumeutils.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/rendering/raycastermanager.h>
@@ -41,6 +42,8 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <array>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableKameleonVolume";
@@ -58,6 +61,7 @@ namespace {
     constexpr const char* KeyClipPlanes = "ClipPlanes";
     constexpr const char* KeyCache = "Cache";
     constexpr const char* KeyGridType = "GridType";
+    constexpr const char* KeyTextureBitsPerVoxel = "TextureBitsPerVoxel";
     constexpr const char* ValueSphericalGridType = "Spherical";
 
     constexpr openspace::properties::Property::PropertyInfo DimensionsInfo = {
@@ -108,6 +112,14 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo DownscaleInfo = {
+        "Downscale",
+        "Downscale Factor",
+        "The factor by which the resolution at which this volume is raycast is reduced "
+        "relative to the rendering resolution. Lower values trade image quality for "
+        "rendering performance."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo StepSizeInfo = {
         "StepSize",
         "Step Size",
@@ -129,8 +141,18 @@ namespace {
     constexpr openspace::properties::Property::PropertyInfo CacheInfo = {
         "Cache",
         "Cache",
-        "" // @TODO Missing documentation
+        "If this value is enabled, the resampled volume is stored in the persistent "
+        "cache for each combination of source file, variable, dimensions, and domain "
+        "bounds, so that it does not have to be resampled when it is used again."
     };
+
+    // The factors by which the dimensions are reduced for the successive previews of a
+    // volume that is resampled from a CDF file. The last level has the full dimensions
+    constexpr const std::array<unsigned int, 3> DownscaleLevels = { 4, 2, 1 };
+
+    glm::uvec3 levelDimensions(const glm::uvec3& dimensions, size_t level) {
+        return glm::max(dimensions / DownscaleLevels[level], glm::uvec3(1));
+    }
 } // namespace
 
 namespace openspace::kameleonvolume {
@@ -146,9 +168,10 @@ RenderableKameleonVolume::RenderableKameleonVolume(const ghoul::Dictionary& dict
     , _upperValueBound(UpperValueBoundInfo, 1.f, 0.01f, 1.f)
     , _gridType(GridTypeInfo, properties::OptionProperty::DisplayType::Dropdown)
     , _stepSize(StepSizeInfo, 0.02f, 0.01f, 1.f)
+    , _downscaleVolumeRendering(DownscaleInfo, 1.f, 0.1f, 1.f)
     , _sourcePath(SourcePathInfo)
     , _transferFunctionPath(TransferFunctionInfo)
-    , _cache(CacheInfo)
+    , _cache(CacheInfo, true)
 {
     if (dictionary.hasKeyAndValue<glm::vec3>(KeyDimensions)) {
         _dimensions = dictionary.value<glm::vec3>(KeyDimensions);
@@ -217,6 +240,20 @@ RenderableKameleonVolume::RenderableKameleonVolume(const ghoul::Dictionary& dict
         _cache = dictionary.value<bool>(KeyCache);
     }
 
+    if (dictionary.hasKeyAndValue<double>(KeyTextureBitsPerVoxel)) {
+        const int bits = static_cast<int>(
+            dictionary.value<double>(KeyTextureBitsPerVoxel)
+        );
+        if (bits == 8 || bits == 16 || bits == 32) {
+            _textureBitsPerVoxel = bits;
+        }
+        else {
+            LWARNING(fmt::format(
+                "Unsupported texture bits per voxel {}, falling back to 32", bits
+            ));
+        }
+    }
+
     _gridType.addOption(
         static_cast<int>(volume::VolumeGridType::Cartesian),
         "Cartesian grid"
@@ -241,10 +278,6 @@ RenderableKameleonVolume::RenderableKameleonVolume(const ghoul::Dictionary& dict
 RenderableKameleonVolume::~RenderableKameleonVolume() {}
 
 void RenderableKameleonVolume::initializeGL() {
-    load();
-
-    _volumeTexture->uploadTexture();
-
     _raycaster = std::make_unique<volume::BasicVolumeRaycaster>(
         _volumeTexture,
         _transferFunction,
@@ -259,8 +292,17 @@ void RenderableKameleonVolume::initializeGL() {
     });
 
     updateRaycasterModelTransform();
-    _lowerDomainBound.onChange([this]() { updateRaycasterModelTransform(); });
-    _upperDomainBound.onChange([this]() { updateRaycasterModelTransform(); });
+    _lowerDomainBound.onChange([this]() {
+        updateRaycasterModelTransform();
+        loadVolume();
+    });
+    _upperDomainBound.onChange([this]() {
+        updateRaycasterModelTransform();
+        loadVolume();
+    });
+    _dimensions.onChange([this]() { loadVolume(); });
+    _variable.onChange([this]() { loadVolume(); });
+    _sourcePath.onChange([this]() { loadVolume(); });
 
     _raycaster->initialize();
 
@@ -281,6 +323,7 @@ void RenderableKameleonVolume::initializeGL() {
 
     addProperty(_dimensions);
     addProperty(_stepSize);
+    addProperty(_downscaleVolumeRendering);
     addProperty(_transferFunctionPath);
     addProperty(_sourcePath);
     addProperty(_variable);
@@ -292,6 +335,8 @@ void RenderableKameleonVolume::initializeGL() {
     addProperty(_gridType);
     addProperty(_cache);
     addPropertySubOwner(_clipPlanes.get());
+
+    loadVolume();
 }
 
 void RenderableKameleonVolume::updateRaycasterModelTransform() {
@@ -312,129 +357,241 @@ bool RenderableKameleonVolume::isCachingEnabled() const {
     return _cache;
 }
 
-void RenderableKameleonVolume::load() {
-    if (!FileSys.fileExists(ghoul::filesystem::File(_sourcePath))) {
-        LERROR(fmt::format("File '{}' does not exist", _sourcePath.value()));
+void RenderableKameleonVolume::loadVolume() {
+    if (_isApplyingVolume) {
         return;
     }
-    if (!isCachingEnabled()) {
-        loadFromPath(_sourcePath);
+    // The results of a previous request would overwrite the new volume otherwise
+    _loadingHandle.cancel();
+
+    if (!FileSys.fileExists(ghoul::filesystem::File(_sourcePath))) {
+        LERROR(fmt::format("File '{}' does not exist", _sourcePath.value()));
         return;
     }
-    ghoul::filesystem::File sourceFile(_sourcePath);
-    std::string cachePath = FileSys.cacheManager()->cachedFilename(
-        sourceFile.baseName(),
-        cacheSuffix(),
-        ghoul::filesystem::CacheManager::Persistent::Yes
-    );
-    if (FileSys.fileExists(cachePath)) {
-        loadRaw(cachePath);
-    } else {
-        loadFromPath(_sourcePath);
-        storeRaw(cachePath);
-    }
-}
 
-std::string RenderableKameleonVolume::cacheSuffix() const {
-    glm::uvec3 dims = _dimensions;
-    return fmt::format(".{}.{}x{}x{}", _variable, dims[0], dims[1], dims[2]);
+    VolumeRequest request;
+    request.sourcePath = _sourcePath;
+    request.variable = _variable;
+    request.dimensions = _dimensions;
+    request.lowerDomainBound = _lowerDomainBound;
+    request.upperDomainBound = _upperDomainBound;
+    request.lowerValueBound = _lowerValueBound;
+    request.upperValueBound = _upperValueBound;
+    request.autoDomainBounds = _autoDomainBounds;
+    request.autoValueBounds = _autoValueBounds;
+    request.autoGridType = _autoGridType;
+    request.isCachingEnabled = isCachingEnabled();
+    request.textureBitsPerVoxel = _textureBitsPerVoxel;
+    loadLevel(std::move(request), 0);
 }
 
-void RenderableKameleonVolume::loadFromPath(const std::string& path) {
-    ghoul::filesystem::File file(path);
-    std::string extension = file.fileExtension();
-    std::transform(
-        extension.begin(),
-        extension.end(),
-        extension.begin(),
-        [](char v) { return static_cast<char>(tolower(v)); }
-    );
-    if (extension == "cdf") {
-        loadCdf(path);
-    } else {
-        loadRaw(path);
+void RenderableKameleonVolume::loadLevel(VolumeRequest request, size_t level) {
+    // Levels that would not be finer than the next one are skipped
+    while (level + 1 < DownscaleLevels.size() &&
+           levelDimensions(request.dimensions, level) ==
+           levelDimensions(request.dimensions, level + 1))
+    {
+        ++level;
     }
-}
 
-void RenderableKameleonVolume::loadRaw(const std::string& path) {
-    volume::RawVolumeReader<float> reader(path, _dimensions);
-    _rawVolume = reader.read();
-    updateTextureFromVolume();
+    std::function<LoadedVolume()> decode = [request, level]() {
+        return readVolume(request, level);
+    };
+    std::function<void(LoadedVolume&)> ready = [this](LoadedVolume& loaded) {
+        applyVolume(loaded);
+    };
+
+    // Previews are scheduled before other loads, as they are cheap and visible right away
+    _loadingHandle = global::resourceLoader.load(
+        std::move(decode),
+        std::function<bool(LoadedVolume&)>(),
+        std::move(ready),
+        (level + 1 < DownscaleLevels.size()) ?
+            TaskScheduler::Priority::High :
+            TaskScheduler::Priority::Normal
+    );
 }
 
-void RenderableKameleonVolume::loadCdf(const std::string& path) {
-    KameleonVolumeReader reader(path);
+void RenderableKameleonVolume::applyVolume(LoadedVolume& loaded) {
+    if (loaded.voxelData.empty()) {
+        // The error has already been logged while reading
+        return;
+    }
 
+    // The bounds that were determined from the file are the starting point for all
+    // following changes, which must not start another read
+    _isApplyingVolume = true;
+    if (_autoDomainBounds) {
+        _lowerDomainBound = loaded.request.lowerDomainBound;
+        _upperDomainBound = loaded.request.upperDomainBound;
+        _autoDomainBounds = false;
+    }
     if (_autoValueBounds) {
-        _lowerValueBound = static_cast<float>(reader.minValue(_variable));
-        _upperValueBound = static_cast<float>(reader.maxValue(_variable));
+        _lowerValueBound = loaded.request.lowerValueBound;
+        _upperValueBound = loaded.request.upperValueBound;
+        _autoValueBounds = false;
+    }
+    if (_autoGridType && loaded.gridType.has_value()) {
+        _gridType.setValue(static_cast<int>(*loaded.gridType));
+        _autoGridType = false;
     }
+    _isApplyingVolume = false;
 
-    std::array<std::string, 3> variables = reader.gridVariableNames();
+    _voxelData = std::move(loaded.voxelData);
+    const std::pair<GLenum, GLenum> format = volume::voxelTextureFormat(
+        _textureBitsPerVoxel
+    );
+    _volumeTexture = std::make_shared<ghoul::opengl::Texture>(
+        loaded.dimensions,
+        ghoul::opengl::Texture::Format::Red,
+        format.first,
+        format.second,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::Repeat
+    );
+    void* data = reinterpret_cast<void*>(_voxelData.data());
+    _volumeTexture->setPixelData(data, ghoul::opengl::Texture::TakeOwnership::No);
+    _volumeTexture->uploadTexture();
 
-    if (_autoDomainBounds) {
-        _lowerDomainBound = glm::vec3(
-            reader.minValue(variables[0]),
-            reader.minValue(variables[1]),
-            reader.minValue(variables[2])
-        );
+    _raycaster->setVolumeTexture(_volumeTexture);
+    updateRaycasterModelTransform();
 
-        _upperDomainBound = glm::vec3(
-            reader.maxValue(variables[0]),
-            reader.maxValue(variables[1]),
-            reader.maxValue(variables[2])
-        );
+    if (!loaded.isFinal) {
+        loadLevel(std::move(loaded.request), loaded.level + 1);
     }
+}
 
-    if (_autoGridType) {
-        if (variables[0] == "r" && variables[0] == "theta" && variables[0] == "phi") {
-            _gridType.setValue(static_cast<int>(volume::VolumeGridType::Spherical));
+RenderableKameleonVolume::LoadedVolume RenderableKameleonVolume::readVolume(
+                                                                    VolumeRequest request,
+                                                                             size_t level)
+{
+    LoadedVolume result;
+    result.level = level;
+
+    std::unique_ptr<volume::RawVolume<float>> rawVolume;
+    ghoul::filesystem::File file(request.sourcePath);
+    std::string extension = file.fileExtension();
+    std::transform(
+        extension.begin(),
+        extension.end(),
+        extension.begin(),
+        [](char v) { return static_cast<char>(tolower(v)); }
+    );
+
+    try {
+        if (extension == "cdf") {
+            KameleonVolumeReader reader(request.sourcePath);
+
+            if (request.autoValueBounds) {
+                request.lowerValueBound = static_cast<float>(
+                    reader.minValue(request.variable)
+                );
+                request.upperValueBound = static_cast<float>(
+                    reader.maxValue(request.variable)
+                );
+                request.autoValueBounds = false;
+            }
+
+            std::array<std::string, 3> variables = reader.gridVariableNames();
+
+            if (request.autoDomainBounds) {
+                request.lowerDomainBound = glm::vec3(
+                    reader.minValue(variables[0]),
+                    reader.minValue(variables[1]),
+                    reader.minValue(variables[2])
+                );
+
+                request.upperDomainBound = glm::vec3(
+                    reader.maxValue(variables[0]),
+                    reader.maxValue(variables[1]),
+                    reader.maxValue(variables[2])
+                );
+                request.autoDomainBounds = false;
+            }
+
+            if (request.autoGridType) {
+                if (variables[0] == "r" && variables[0] == "theta" &&
+                    variables[0] == "phi")
+                {
+                    result.gridType = volume::VolumeGridType::Spherical;
+                }
+                else {
+                    result.gridType = volume::VolumeGridType::Cartesian;
+                }
+            }
+
+            // Only the full dimensions are cached, so that a cached volume replaces all
+            // of the previews
+            const std::string cachePath = request.isCachingEnabled ?
+                FileSys.cacheManager()->cachedFilename(
+                    file.baseName(),
+                    cacheSuffix(request),
+                    ghoul::filesystem::CacheManager::Persistent::Yes
+                ) :
+                "";
+            if (!cachePath.empty() && FileSys.fileExists(cachePath)) {
+                volume::RawVolumeReader<float> cacheReader(cachePath, request.dimensions);
+                rawVolume = cacheReader.read();
+                result.isFinal = true;
+            }
+            else {
+                rawVolume = reader.readFloatVolume(
+                    levelDimensions(request.dimensions, level),
+                    request.variable,
+                    request.lowerDomainBound,
+                    request.upperDomainBound
+                );
+                result.isFinal = (level + 1 == DownscaleLevels.size());
+                if (result.isFinal && !cachePath.empty()) {
+                    volume::RawVolumeWriter<float> writer(cachePath);
+                    writer.write(*rawVolume);
+                }
+            }
         }
         else {
-            _gridType.setValue(static_cast<int>(volume::VolumeGridType::Cartesian));
+            // Raw volumes are read as they are, without previews
+            volume::RawVolumeReader<float> reader(request.sourcePath, request.dimensions);
+            rawVolume = reader.read();
+            result.isFinal = true;
         }
     }
-
-    ghoul::Dictionary dict = reader.readMetaData();
-    _rawVolume = reader.readFloatVolume(
-        _dimensions,
-        _variable,
-        _lowerDomainBound,
-        _upperDomainBound
-    );
-    updateTextureFromVolume();
-}
-
-void RenderableKameleonVolume::updateTextureFromVolume() {
-    _normalizedVolume = std::make_unique<volume::RawVolume<GLfloat>>(_dimensions);
-    float* in = _rawVolume->data();
-    GLfloat* out = _normalizedVolume->data();
-    float min = _lowerValueBound;
-    float diff = _upperValueBound - _lowerValueBound;
-
-    for (size_t i = 0; i < _normalizedVolume->nCells(); ++i) {
-        out[i] = glm::clamp((in[i] - min) / diff, 0.f, 1.f);
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+        result.isFinal = true;
+        return result;
     }
 
-    _volumeTexture = std::make_shared<ghoul::opengl::Texture>(
-        _dimensions,
-        ghoul::opengl::Texture::Format::Red,
-        GL_RED,
-        GL_FLOAT,
-        ghoul::opengl::Texture::FilterMode::Linear,
-        ghoul::opengl::Texture::WrappingMode::Repeat
+    std::vector<float> normalized(rawVolume->nCells());
+    const float* in = rawVolume->data();
+    const float min = request.lowerValueBound;
+    const float diff = request.upperValueBound - request.lowerValueBound;
+    for (size_t i = 0; i < normalized.size(); ++i) {
+        normalized[i] = glm::clamp((in[i] - min) / diff, 0.f, 1.f);
+    }
+    result.voxelData = volume::encodeNormalizedVoxels(
+        normalized.data(),
+        normalized.size(),
+        request.textureBitsPerVoxel
     );
-
-    void* data = reinterpret_cast<void*>(_normalizedVolume->data());
-    _volumeTexture->setPixelData(data, ghoul::opengl::Texture::TakeOwnership::No);
+    result.dimensions = rawVolume->dimensions();
+    result.request = std::move(request);
+    return result;
 }
 
-void RenderableKameleonVolume::storeRaw(const std::string& path) {
-    volume::RawVolumeWriter<float> writer(path);
-    writer.write(*_rawVolume);
+std::string RenderableKameleonVolume::cacheSuffix(const VolumeRequest& request) {
+    const glm::uvec3& dims = request.dimensions;
+    const glm::vec3& lower = request.lowerDomainBound;
+    const glm::vec3& upper = request.upperDomainBound;
+    return fmt::format(
+        ".{}.{}x{}x{}.{}_{}_{}.{}_{}_{}",
+        request.variable, dims[0], dims[1], dims[2],
+        lower[0], lower[1], lower[2], upper[0], upper[1], upper[2]
+    );
 }
 
 void RenderableKameleonVolume::deinitializeGL() {
+    _loadingHandle.cancel();
+
     if (_raycaster) {
         global::raycasterManager.detachRaycaster(*_raycaster.get());
         _raycaster = nullptr;
@@ -448,11 +605,15 @@ bool RenderableKameleonVolume::isReady() const {
 void RenderableKameleonVolume::update(const UpdateData&) {
     if (_raycaster) {
         _raycaster->setStepSize(_stepSize);
+        _raycaster->setDownscaleRender(_downscaleVolumeRendering);
     }
 }
 
 void RenderableKameleonVolume::render(const RenderData& data, RendererTasks& tasks) {
-    tasks.raycasterTasks.push_back({ _raycaster.get(), data });
+    // Nothing is shown until the first preview of the volume has been read
+    if (_volumeTexture) {
+        tasks.raycasterTasks.push_back({ _raycaster.get(), data });
+    }
 }
 
 }  // openspace::kameleonvolume
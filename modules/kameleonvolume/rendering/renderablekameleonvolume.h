@@ -30,12 +30,16 @@
 #include <modules/kameleon/include/kameleonwrapper.h>
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rendering/basicvolumeraycaster.h>
+#include <modules/volume/volumegridtype.h>
 
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/vector/uvec3property.h>
 #include <openspace/properties/vector/vec3property.h>
+#include <openspace/util/resourceloader.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <optional>
+#include <vector>
 
 namespace openspace { struct RenderData; }
 
@@ -61,14 +65,59 @@ public:
     bool isCachingEnabled() const;
 
 private:
-    void load();
-    void loadFromPath(const std::string& path);
-    void loadRaw(const std::string& path);
-    void loadCdf(const std::string& path);
-    void storeRaw(const std::string& path);
-
-    std::string cacheSuffix() const;
-    void updateTextureFromVolume();
+    /// The parameters that a volume is read and resampled with
+    struct VolumeRequest {
+        std::string sourcePath;
+        std::string variable;
+        glm::uvec3 dimensions;
+        glm::vec3 lowerDomainBound;
+        glm::vec3 upperDomainBound;
+        float lowerValueBound;
+        float upperValueBound;
+        bool autoDomainBounds;
+        bool autoValueBounds;
+        bool autoGridType;
+        bool isCachingEnabled;
+        int textureBitsPerVoxel;
+    };
+
+    /// A volume that has been read on a worker thread, ready to be uploaded
+    struct LoadedVolume {
+        /// The request with the automatic bounds replaced by the values from the file
+        VolumeRequest request;
+        /// The index into the levels of detail that this volume was sampled at
+        size_t level = 0;
+        /// Whether this volume has the full dimensions of the request
+        bool isFinal = false;
+        glm::uvec3 dimensions = glm::uvec3(0);
+        /// The normalized voxels encoded with the texture bits per voxel of the request
+        std::vector<unsigned char> voxelData;
+        std::optional<volume::VolumeGridType> gridType;
+    };
+
+    /**
+     * Starts reading the volume for the current values of the properties on a worker
+     * thread, which replaces any read that is still in progress. A coarse preview is
+     * shown first and then refined until the volume has the requested dimensions.
+     */
+    void loadVolume();
+
+    /// Reads the \p level of detail of the \p request through the ResourceLoader
+    void loadLevel(VolumeRequest request, size_t level);
+
+    /// Uploads the \p loaded volume and starts reading the next level of detail
+    void applyVolume(LoadedVolume& loaded);
+
+    /**
+     * Reads the \p request at the \p level of detail. If caching is enabled, the
+     * volume with the full dimensions is read from the cache if it exists or is stored in
+     * the cache after it has been sampled. This function is executed on a worker thread.
+     */
+    static LoadedVolume readVolume(VolumeRequest request, size_t level);
+
+    /// Returns the suffix of the cache file that is unique for the \p request
+    static std::string cacheSuffix(const VolumeRequest& request);
+
     void updateRaycasterModelTransform();
 
     properties::UVec3Property _dimensions;
@@ -88,13 +137,18 @@ private:
     std::shared_ptr<volume::VolumeClipPlanes> _clipPlanes;
 
     properties::FloatProperty _stepSize;
+    properties::FloatProperty _downscaleVolumeRendering;
     properties::StringProperty _sourcePath;
     properties::StringProperty _transferFunctionPath;
     properties::BoolProperty _cache;
 
+    ResourceLoader::Handle _loadingHandle;
+    /// Set while a loaded volume writes its bounds into the properties
+    bool _isApplyingVolume = false;
 
-    std::unique_ptr<volume::RawVolume<float>> _rawVolume;
-    std::unique_ptr<volume::RawVolume<GLfloat>> _normalizedVolume;
+    /// The normalized voxels encoded with _textureBitsPerVoxel bits
+    std::vector<unsigned char> _voxelData;
+    int _textureBitsPerVoxel = 32;
     std::unique_ptr<volume::BasicVolumeRaycaster> _raycaster;
 
     std::shared_ptr<ghoul::opengl::Texture> _volumeTexture;
@@ -168,7 +168,8 @@ void KameleonVolumeToRawTask::perform(const Task::ProgressCallback& progressCall
         _dimensions,
         _variable,
         _lowerDomainBound,
-        _upperDomainBound
+        _upperDomainBound,
+        [&progressCallback](float progress) { progressCallback(0.5f * progress); }
     );
 
     progressCallback(0.5f);
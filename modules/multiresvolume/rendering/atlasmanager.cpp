@@ -25,13 +25,62 @@
 #include <modules/multiresvolume/rendering/atlasmanager.h>
 
 #include <modules/multiresvolume/rendering/tsp.h>
+#include <openspace/util/job.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
 #include <cstring>
 
+namespace {
+    void setBit(std::vector<uint64_t>& bits, int index) {
+        bits[index / 64] |= (uint64_t(1) << (index % 64));
+    }
+
+    void clearBit(std::vector<uint64_t>& bits, int index) {
+        bits[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+
+    bool testBit(const std::vector<uint64_t>& bits, int index) {
+        return (bits[index / 64] & (uint64_t(1) << (index % 64))) != 0;
+    }
+
+    using BrickSequence = openspace::AtlasManager::BrickSequence;
+
+    // Reads a sequence of bricks from the TSP file into its staging buffer
+    struct BrickReadJob : public openspace::Job<BrickSequence> {
+        BrickReadJob(std::ifstream& file, BrickSequence sequence, unsigned int brickSize)
+            : _file(file)
+            , _sequence(std::move(sequence))
+            , _brickSize(brickSize)
+        {}
+
+        void execute() override {
+            const long long offset = openspace::TSP::dataPosition() +
+                static_cast<long long>(_sequence.firstBrick) *
+                static_cast<long long>(_brickSize);
+            _file.clear();
+            _file.seekg(offset);
+            _file.read(
+                reinterpret_cast<char*>(_sequence.data.data()),
+                _sequence.data.size() * sizeof(float)
+            );
+        }
+
+        BrickSequence product() override {
+            return std::move(_sequence);
+        }
+
+        std::ifstream& _file;
+        BrickSequence _sequence;
+        unsigned int _brickSize;
+    };
+} // namespace
+
 namespace openspace {
 
-AtlasManager::AtlasManager(TSP* tsp) : _tsp(tsp) {}
+AtlasManager::AtlasManager(TSP* tsp)
+    : _tsp(tsp)
+    , _jobManager(ThreadPool(1))
+{}
 
 bool AtlasManager::initialize() {
     TSP::Header header = _tsp->header();
@@ -51,10 +100,23 @@ bool AtlasManager::initialize() {
 
     _freeAtlasCoords = std::vector<unsigned int>(_nBricksInAtlas, 0);
 
+    // The bricks are streamed through a separate stream so that the reader thread never
+    // interferes with other users of the TSP's file
+    _file.open(_tsp->filename(), std::ios::in | std::ios::binary);
+    if (!_file.good()) {
+        LERRORC("AtlasManager", "Failed to open " + _tsp->filename());
+        return false;
+    }
+
     for (unsigned int i = 0; i < _nBricksInAtlas; i++) {
         _freeAtlasCoords[i] = i;
     }
 
+    const unsigned int nTotalBricks = _tsp->numTotalNodes();
+    _brickMap = std::vector<unsigned int>(nTotalBricks, NotUsedIndex);
+    _requiredBricks = std::vector<uint64_t>((nTotalBricks + 63) / 64, 0);
+    _prevRequiredBricks = _requiredBricks;
+
     _textureAtlas = new ghoul::opengl::Texture(
         glm::size3_t(_atlasDim, _atlasDim, _atlasDim),
         ghoul::opengl::Texture::Format::RGBA,
@@ -86,64 +148,151 @@ unsigned int AtlasManager::atlasMapBuffer() const {
     return _atlasMapBuffer;
 }
 
-void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickIndices) {
-    size_t nBrickIndices = brickIndices.size();
+void AtlasManager::updateAtlas(const std::vector<int>& brickIndices) {
+    // Stats
+    _nStreamedBricks = 0;
+    _nDiskReads = 0;
 
-    _requiredBricks.clear();
-    for (size_t i = 0; i < nBrickIndices; i++) {
-        _requiredBricks.insert(brickIndices[i]);
+    // Collect the bricks that the reader thread has finished since the last frame
+    while (_jobManager.numFinishedJobs() > 0) {
+        std::shared_ptr<Job<BrickSequence>> job = _jobManager.popFinishedJob();
+        _stagedSequences.push_back(job->product());
+        _nPendingJobs--;
     }
 
-    for (unsigned int it : _prevRequiredBricks) {
-        if (!_requiredBricks.count(it)) {
-            removeFromAtlas(it);
-        }
+    if (_nPendingJobs > 0) {
+        // The previous request is still being read, so we keep rendering the bricks
+        // that are currently in the atlas
+        return;
     }
 
-    // Stats
-    _nUsedBricks = static_cast<unsigned int>(_requiredBricks.size());
-    _nStreamedBricks = 0;
-    _nDiskReads = 0;
+    if (!_pendingBrickIndices.empty()) {
+        commitBricks();
+    }
 
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, _volumeSize, nullptr, GL_STREAM_DRAW);
-    float* mappedBuffer = reinterpret_cast<float*>(
-        glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY)
-    );
+    if (brickIndices != _committedBrickIndices) {
+        requestBricks(brickIndices);
+        if (_nPendingJobs == 0) {
+            // All bricks were already resident or have been read synchronously
+            commitBricks();
+        }
+    }
+}
 
-    if (!mappedBuffer) {
-        LERRORC("AtlasManager", "Failed to map PBO");
-        return;
+void AtlasManager::requestBricks(const std::vector<int>& brickIndices) {
+    _pendingBrickIndices = brickIndices;
+
+    for (int brick : brickIndices) {
+        setBit(_requiredBricks, brick);
     }
 
-    for (auto itStart = _requiredBricks.begin(); itStart != _requiredBricks.end();) {
-        int firstBrick = *itStart;
-        int lastBrick = firstBrick;
-
-        auto itEnd = itStart;
-        for (itEnd++;
-            itEnd != _requiredBricks.end() &&
-            *itEnd == static_cast<unsigned int>(lastBrick) + 1;
-            itEnd++)
-        {
-            lastBrick = *itEnd;
+    // Walk the requested bricks in ascending order and group consecutive missing bricks
+    // so that they can be read in one go
+    BrickSequence sequence;
+    bool hasSequence = false;
+    for (size_t word = 0; word < _requiredBricks.size(); ++word) {
+        for (uint64_t bits = _requiredBricks[word]; bits != 0; bits &= bits - 1) {
+            const int brick = static_cast<int>(word * 64 + glm::findLSB(bits));
+            if (_brickMap[brick] != NotUsedIndex) {
+                continue;
+            }
+
+            if (hasSequence && brick == sequence.lastBrick + 1) {
+                sequence.lastBrick = brick;
+            }
+            else {
+                if (hasSequence) {
+                    readSequence(std::move(sequence));
+                }
+                sequence = BrickSequence();
+                sequence.firstBrick = brick;
+                sequence.lastBrick = brick;
+                hasSequence = true;
+            }
         }
+    }
+    if (hasSequence) {
+        readSequence(std::move(sequence));
+    }
 
-        addToAtlas(firstBrick, lastBrick, mappedBuffer);
+    for (int brick : brickIndices) {
+        clearBit(_requiredBricks, brick);
+    }
+}
 
-        itStart = itEnd;
+void AtlasManager::readSequence(BrickSequence sequence) {
+    if (!_stagingBuffers.empty()) {
+        sequence.data = std::move(_stagingBuffers.back());
+        _stagingBuffers.pop_back();
     }
+    const int sequenceLength = sequence.lastBrick - sequence.firstBrick + 1;
+    sequence.data.resize(static_cast<size_t>(sequenceLength) * _nBrickVals);
 
-    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    auto job = std::make_shared<BrickReadJob>(_file, std::move(sequence), _brickSize);
+    if (_hasCommitted) {
+        _jobManager.enqueueJob(job);
+        _nPendingJobs++;
+    }
+    else {
+        // We don't have anything to show until the first request has been loaded, so
+        // there is no point in deferring it
+        job->execute();
+        _stagedSequences.push_back(job->product());
+    }
+    _nDiskReads++;
+}
 
-    for (size_t i = 0; i < nBrickIndices; i++) {
-        _atlasMap[i] = _brickMap[brickIndices[i]];
+void AtlasManager::commitBricks() {
+    // Stats
+    _nUsedBricks = 0;
+    for (int brick : _pendingBrickIndices) {
+        if (!testBit(_requiredBricks, brick)) {
+            setBit(_requiredBricks, brick);
+            _nUsedBricks++;
+        }
     }
 
-    std::swap(_prevRequiredBricks, _requiredBricks);
+    // Evict the bricks that were required by the previous request but not anymore
+    for (size_t word = 0; word < _requiredBricks.size(); ++word) {
+        uint64_t removed = _prevRequiredBricks[word] & ~_requiredBricks[word];
+        for (; removed != 0; removed &= removed - 1) {
+            removeFromAtlas(static_cast<int>(word * 64 + glm::findLSB(removed)));
+        }
+    }
+
+    if (!_stagedSequences.empty()) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[EVEN]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, _volumeSize, nullptr, GL_STREAM_DRAW);
+        float* mappedBuffer = reinterpret_cast<float*>(
+            glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY)
+        );
+
+        if (!mappedBuffer) {
+            LERRORC("AtlasManager", "Failed to map PBO");
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return;
+        }
+
+        for (const BrickSequence& sequence : _stagedSequences) {
+            addToAtlas(sequence, mappedBuffer);
+        }
 
-    pboToAtlas(bufferIndex);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        pboToAtlas(EVEN);
+    }
+
+    for (size_t i = 0; i < _pendingBrickIndices.size(); i++) {
+        _atlasMap[i] = _brickMap[_pendingBrickIndices[i]];
+    }
+
+    // The scratch bitset now contains the previous request, which is cleared through
+    // the indices that were used to build it
+    std::swap(_prevRequiredBricks, _requiredBricks);
+    for (int brick : _committedBrickIndices) {
+        clearBit(_requiredBricks, brick);
+    }
 
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _atlasMapBuffer);
     GLint* to = reinterpret_cast<GLint*>(
@@ -152,33 +301,24 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
     memcpy(to, _atlasMap.data(), sizeof(GLint)*_atlasMap.size());
     glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-}
 
-void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex,
-                              float* mappedBuffer)
-{
-    while (_brickMap.count(firstBrickIndex) && firstBrickIndex <= lastBrickIndex) {
-        firstBrickIndex++;
+    // Return the staging memory to the pool for the next request
+    for (BrickSequence& sequence : _stagedSequences) {
+        _stagingBuffers.push_back(std::move(sequence.data));
     }
-    while (_brickMap.count(lastBrickIndex) && lastBrickIndex >= firstBrickIndex) {
-        lastBrickIndex--;
-    }
-    if (lastBrickIndex < firstBrickIndex) {
-        return;
-    }
-
-    int sequenceLength = lastBrickIndex - firstBrickIndex + 1;
-    float* sequenceBuffer = new float[sequenceLength*_nBrickVals];
-    size_t bufferSize = sequenceLength * _brickSize;
+    _stagedSequences.clear();
 
-    long long offset = TSP::dataPosition() + static_cast<long long>(firstBrickIndex) *
-                       static_cast<long long>(_brickSize);
-    _tsp->file().seekg(offset);
-    _tsp->file().read(reinterpret_cast<char*>(sequenceBuffer), bufferSize);
-    _nDiskReads++;
+    _committedBrickIndices = std::move(_pendingBrickIndices);
+    _pendingBrickIndices.clear();
+    _hasCommitted = true;
+}
 
-    for (int brickIndex = firstBrickIndex; brickIndex <= lastBrickIndex; brickIndex++) {
-        if (!_brickMap.count(brickIndex)) {
+void AtlasManager::addToAtlas(const BrickSequence& sequence, float* mappedBuffer) {
+    for (int brickIndex = sequence.firstBrick;
+         brickIndex <= sequence.lastBrick;
+         brickIndex++)
+    {
+        if (_brickMap[brickIndex] == NotUsedIndex) {
             unsigned int atlasCoords = _freeAtlasCoords.back();
             _freeAtlasCoords.pop_back();
             int level = _nOtLevels - static_cast<int>(
@@ -186,27 +326,27 @@ void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex,
             );
             ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
             unsigned int atlasData = (level << 28) + atlasCoords;
-            _brickMap.emplace(brickIndex, atlasData);
+            _brickMap[brickIndex] = atlasData;
             _nStreamedBricks++;
             fillVolume(
-                &sequenceBuffer[_nBrickVals*(brickIndex - firstBrickIndex)],
+                &sequence.data[_nBrickVals * (brickIndex - sequence.firstBrick)],
                 mappedBuffer,
                 atlasCoords
             );
         }
     }
-
-    delete[] sequenceBuffer;
 }
 
 void AtlasManager::removeFromAtlas(int brickIndex) {
     unsigned int atlasData = _brickMap[brickIndex];
     unsigned int atlasCoords = atlasData & 0x0FFFFFFF;
-    _brickMap.erase(brickIndex);
+    _brickMap[brickIndex] = NotUsedIndex;
     _freeAtlasCoords.push_back(atlasCoords);
 }
 
-void AtlasManager::fillVolume(float* in, float* out, unsigned int linearAtlasCoords) {
+void AtlasManager::fillVolume(const float* in, float* out,
+                              unsigned int linearAtlasCoords)
+{
     int x = linearAtlasCoords % _nBricksPerDim;
     int y = (linearAtlasCoords / _nBricksPerDim) % _nBricksPerDim;
     int z = linearAtlasCoords / _nBricksPerDim / _nBricksPerDim;
@@ -25,10 +25,11 @@
 #ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___ATLASMANAGER___H__
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___ATLASMANAGER___H__
 
+#include <openspace/util/concurrentjobmanager.h>
 #include <ghoul/glm.h>
 #include <glm/gtx/std_based_type.hpp>
-#include <map>
-#include <set>
+#include <cstdint>
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -45,11 +46,24 @@ public:
         ODD = 1
     };
 
+    /// A contiguous range of bricks as they are stored in the TSP file
+    struct BrickSequence {
+        int firstBrick = 0;
+        int lastBrick = 0;
+        std::vector<float> data;
+    };
+
     AtlasManager(TSP* tsp);
     ~AtlasManager() = default;
 
-    void updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickIndices);
-    void addToAtlas(int firstBrickIndex, int lastBrickIndex, float* mappedBuffer);
+    /**
+     * Requests the bricks in \p brickIndices to be made resident in the atlas. Missing
+     * bricks are read from disk on a background thread and the atlas keeps showing the
+     * previously completed set of bricks until all of them have arrived, so this
+     * function does not wait for disk reads, except for the very first request.
+     */
+    void updateAtlas(const std::vector<int>& brickIndices);
+    void addToAtlas(const BrickSequence& sequence, float* mappedBuffer);
     void removeFromAtlas(int brickIndex);
     bool initialize();
     const std::vector<unsigned int>& atlasMap() const;
@@ -72,10 +86,13 @@ private:
     unsigned int _atlasMapBuffer;
 
     std::vector<unsigned int> _atlasMap;
-    std::map<unsigned int, unsigned int> _brickMap;
+    // Atlas data for each brick in the TSP, NotUsedIndex for bricks not in the atlas
+    std::vector<unsigned int> _brickMap;
     std::vector<unsigned int> _freeAtlasCoords;
-    std::set<unsigned int> _requiredBricks;
-    std::set<unsigned int> _prevRequiredBricks;
+    // Bitsets over all bricks in the TSP. _requiredBricks is only used as scratch
+    // space and is cleared again after each use
+    std::vector<uint64_t> _requiredBricks;
+    std::vector<uint64_t> _prevRequiredBricks;
 
     ghoul::opengl::Texture* _textureAtlas;
 
@@ -96,7 +113,21 @@ private:
     unsigned int _nBricksInMap;
     unsigned int _atlasDim;
 
-    void fillVolume(float* in, float* out, unsigned int linearAtlasCoords);
+    // Streaming. The file stream is only ever accessed by the single reader thread of
+    // the job manager once the first request has been made
+    std::ifstream _file;
+    ConcurrentJobManager<BrickSequence> _jobManager;
+    std::vector<BrickSequence> _stagedSequences;
+    std::vector<std::vector<float>> _stagingBuffers;
+    std::vector<int> _pendingBrickIndices;
+    std::vector<int> _committedBrickIndices;
+    size_t _nPendingJobs = 0;
+    bool _hasCommitted = false;
+
+    void requestBricks(const std::vector<int>& brickIndices);
+    void readSequence(BrickSequence sequence);
+    void commitBricks();
+    void fillVolume(const float* in, float* out, unsigned int linearAtlasCoords);
 };
 
 } // namespace openspace
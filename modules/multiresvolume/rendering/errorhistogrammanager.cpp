@@ -26,20 +26,37 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 #include <openspace/util/progressbar.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/fmt.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <thread>
+
+namespace {
+    constexpr const char* _loggerCat = "ErrorHistogramManager";
+
+    // Number of consecutive leaves that are handled by one task. Neighboring leaves
+    // share most of their ancestors, so larger batches keep the thread-local
+    // accumulators small relative to the work they save
+    constexpr const unsigned int LeavesPerTask = 64;
+
+    // Minimum time between two checkpoints of a histogram build
+    constexpr const std::chrono::seconds CheckpointInterval = std::chrono::seconds(60);
+} // namespace
 
 namespace openspace {
 
 ErrorHistogramManager::ErrorHistogramManager(TSP* tsp) : _tsp(tsp) {}
 
-bool ErrorHistogramManager::buildHistograms(int numBins) {
+bool ErrorHistogramManager::buildHistograms(int numBins,
+                                            const std::string& checkpointFile)
+{
     _numBins = numBins;
 
-    _file = &(_tsp->file());
-    if (!_file->is_open()) {
-        return false;
-    }
     _minBin = 0.f; // Should be calculated from tsp file
     _maxBin = 1.f; // Should be calculated from tsp file as (maxValue - minValue)
 
@@ -51,10 +68,10 @@ bool ErrorHistogramManager::buildHistograms(int numBins) {
 
     _numInnerNodes = _tsp->numTotalNodes() - numOtLeaves * numBstLeaves;
     _histograms = std::vector<Histogram>(_numInnerNodes);
-    LINFOC(
-        "ErrorHistogramManager",
-        fmt::format("Build {} histograms with {} bins each", _numInnerNodes, numBins)
-    );
+    for (unsigned int i = 0; i < _numInnerNodes; i++) {
+        _histograms[i] = Histogram(_minBin, _maxBin, _numBins);
+    }
+    LINFO(fmt::format("Build {} histograms with {} bins each", _numInnerNodes, numBins));
 
     // All TSP Leaves
     int numOtNodes = _tsp->numOTNodes();
@@ -63,25 +80,110 @@ bool ErrorHistogramManager::buildHistograms(int numBins) {
     int numBstNodes = _tsp->numBSTNodes();
     int bstOffset = numBstNodes / 2;
 
-    int numberOfLeaves = (numBstNodes - bstOffset) * (numOtNodes - otOffset);
+    const unsigned int numberOfLeaves = (numBstNodes - bstOffset) *
+                                        (numOtNodes - otOffset);
+
+    unsigned int processedLeaves = 0;
+    if (!checkpointFile.empty() && loadCheckpoint(checkpointFile, processedLeaves)) {
+        LINFO(fmt::format(
+            "Resuming histogram build at leaf {} of {}", processedLeaves, numberOfLeaves
+        ));
+    }
+
     ProgressBar pb(numberOfLeaves);
-    int processedLeaves = 0;
-    bool success = true;
-    for (int bst = bstOffset; bst < numBstNodes; bst++) {
-        for (int ot = otOffset; ot < numOtNodes; ot++) {
-            success &= buildFromLeaf(bst, ot);
-            if (!success) {
-                return false;
-            }
-            pb.print(++processedLeaves);
+    pb.print(processedLeaves);
+
+    // Each round hands out one batch of consecutive leaves to every thread. The leaves
+    // before the end of a finished round are fully accounted for in the histograms,
+    // which is what makes it safe to checkpoint between rounds
+    const unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::chrono::steady_clock::time_point lastCheckpoint =
+        std::chrono::steady_clock::now();
+    while (processedLeaves < numberOfLeaves) {
+        const unsigned int roundEnd = std::min(
+            processedLeaves + nThreads * LeavesPerTask,
+            numberOfLeaves
+        );
+
+        std::vector<std::future<bool>> tasks;
+        for (unsigned int first = processedLeaves; first < roundEnd;
+             first += LeavesPerTask)
+        {
+            const unsigned int last = std::min(first + LeavesPerTask, roundEnd);
+            tasks.push_back(std::async(
+                std::launch::async,
+                &ErrorHistogramManager::buildFromLeaves, this, first, last
+            ));
+        }
+        bool success = true;
+        for (std::future<bool>& task : tasks) {
+            success &= task.get();
+        }
+        if (!success) {
+            return false;
+        }
+
+        processedLeaves = roundEnd;
+        pb.print(processedLeaves);
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (!checkpointFile.empty() && processedLeaves < numberOfLeaves &&
+            now - lastCheckpoint > CheckpointInterval)
+        {
+            saveCheckpoint(checkpointFile, processedLeaves);
+            lastCheckpoint = now;
         }
     }
 
-    return success;
+    if (!checkpointFile.empty() && FileSys.fileExists(checkpointFile)) {
+        FileSys.deleteFile(checkpointFile);
+    }
+
+    return true;
 }
 
-bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
-                                          unsigned int octreeOffset)
+bool ErrorHistogramManager::buildFromLeaves(unsigned int firstLeaf,
+                                            unsigned int lastLeaf)
+{
+    // Every task reads through its own stream so that the tasks don't have to
+    // synchronize their file access
+    std::ifstream file(_tsp->filename(), std::ios::in | std::ios::binary);
+    if (!file.good()) {
+        LERROR(fmt::format("Could not open {}", _tsp->filename()));
+        return false;
+    }
+
+    const unsigned int numOtNodes = _tsp->numOTNodes();
+    const unsigned int numOtLevels = _tsp->numOTLevels();
+    const unsigned int otOffset = static_cast<unsigned int>(
+        (pow(8, numOtLevels - 1) - 1) / 7
+    );
+    const unsigned int bstOffset = _tsp->numBSTNodes() / 2;
+    const unsigned int numOtLeaves = numOtNodes - otOffset;
+
+    // The errors are accumulated into thread-local histograms first and only merged
+    // into the shared histograms once per batch
+    HistogramMap histograms;
+    VoxelCache voxelCache;
+    for (unsigned int leaf = firstLeaf; leaf < lastLeaf; leaf++) {
+        const unsigned int bst = bstOffset + leaf / numOtLeaves;
+        const unsigned int ot = otOffset + leaf % numOtLeaves;
+        if (!buildFromLeaf(file, bst, ot, histograms, voxelCache)) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_histogramMutex);
+    for (const std::pair<const unsigned int, Histogram>& h : histograms) {
+        _histograms[h.first].add(h.second);
+    }
+    return true;
+}
+
+bool ErrorHistogramManager::buildFromLeaf(std::ifstream& file, unsigned int bstOffset,
+                                          unsigned int octreeOffset,
+                                          HistogramMap& histograms,
+                                          VoxelCache& voxelCache) const
 {
     // Traverse all ancestors of leaf and add errors to their histograms
 
@@ -91,7 +193,7 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
 
     int numOtNodes = _tsp->numOTNodes();
     unsigned int leafIndex = bstOffset * numOtNodes + octreeOffset;
-    std::vector<float> leafValues = readValues(leafIndex);
+    std::vector<float> leafValues = readValues(file, leafIndex);
 //    int numVoxels = leafValues.size();
 
     int bstNode = bstOffset;
@@ -108,18 +210,23 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
             if (bstNode != static_cast<int>(bstOffset) || octreeNode != octreeOffset) {
                 // Is actually an ancestor
 
-                std::vector<float> ancestorVoxels;
                 unsigned int ancestorBrickIndex = bstNode * numOtNodes + octreeNode;
                 unsigned int innerNodeIndex = brickToInnerNodeIndex(ancestorBrickIndex);
-                auto it = _voxelCache.find(innerNodeIndex);
-                if (it == _voxelCache.end()) {
-                    // First visit
-                    _histograms[innerNodeIndex] = Histogram(_minBin, _maxBin, _numBins);
-                    ancestorVoxels = readValues(ancestorBrickIndex);
-                    _voxelCache[innerNodeIndex] = ancestorVoxels;
-                } else {
-                    ancestorVoxels = it->second;
+                auto it = voxelCache.find(innerNodeIndex);
+                if (it == voxelCache.end()) {
+                    // First visit within this batch of leaves
+                    it = voxelCache.emplace(
+                        innerNodeIndex,
+                        readValues(file, ancestorBrickIndex)
+                    ).first;
                 }
+                const std::vector<float>& ancestorVoxels = it->second;
+                Histogram& histogram = histograms.try_emplace(
+                    innerNodeIndex,
+                    _minBin,
+                    _maxBin,
+                    _numBins
+                ).first->second;
 
                 float voxelScale = static_cast<float>(pow(2.f, octreeLevel));
                 float invVoxelScale = 1.f / voxelScale;
@@ -141,7 +248,7 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
                                 ancestorVoxels
                             );
 
-                            _histograms[innerNodeIndex].addRectangle(
+                            histogram.addRectangle(
                                 leafValue,
                                 ancestorValue,
                                 std::abs(leafValue - ancestorValue)
@@ -151,7 +258,7 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
                 }
 
                 if (bstRightOnly && octreeLastOnly) {
-                    _voxelCache.erase(innerNodeIndex);
+                    voxelCache.erase(innerNodeIndex);
                 }
             }
 
@@ -178,6 +285,73 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
     return true;
 }
 
+bool ErrorHistogramManager::loadCheckpoint(const std::string& filename,
+                                           unsigned int& processedLeaves)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    unsigned int numInnerNodes = 0;
+    int numBins = 0;
+    file.read(reinterpret_cast<char*>(&numInnerNodes), sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(&numBins), sizeof(int));
+    file.read(reinterpret_cast<char*>(&processedLeaves), sizeof(unsigned int));
+    if (!file.good() || numInnerNodes != _numInnerNodes || numBins != _numBins) {
+        LWARNING(fmt::format("Ignoring mismatching checkpoint {}", filename));
+        processedLeaves = 0;
+        return false;
+    }
+
+    for (unsigned int i = 0; i < _numInnerNodes; ++i) {
+        // No need to deallocate histogram data, since histograms take ownership.
+        float* data = new float[_numBins];
+        file.read(reinterpret_cast<char*>(data), sizeof(float) * _numBins);
+        _histograms[i] = Histogram(_minBin, _maxBin, _numBins, data);
+    }
+
+    if (!file.good()) {
+        LWARNING(fmt::format("Ignoring truncated checkpoint {}", filename));
+        for (unsigned int i = 0; i < _numInnerNodes; ++i) {
+            _histograms[i] = Histogram(_minBin, _maxBin, _numBins);
+        }
+        processedLeaves = 0;
+        return false;
+    }
+    return true;
+}
+
+bool ErrorHistogramManager::saveCheckpoint(const std::string& filename,
+                                           unsigned int processedLeaves) const
+{
+    // Write to a temporary file first so that an interruption while writing never
+    // destroys the previous checkpoint
+    const std::string tmpFilename = filename + ".tmp";
+    {
+        std::ofstream file(tmpFilename, std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&_numInnerNodes), sizeof(unsigned int));
+        file.write(reinterpret_cast<const char*>(&_numBins), sizeof(int));
+        file.write(reinterpret_cast<const char*>(&processedLeaves), sizeof(unsigned int));
+        for (const Histogram& histogram : _histograms) {
+            file.write(
+                reinterpret_cast<const char*>(histogram.data()),
+                sizeof(float) * _numBins
+            );
+        }
+        if (!file.good()) {
+            return false;
+        }
+    }
+
+    std::remove(filename.c_str());
+    return std::rename(tmpFilename.c_str(), filename.c_str()) == 0;
+}
+
 bool ErrorHistogramManager::loadFromFile(const std::string& filename) {
     std::ifstream file(filename, std::ios::in | std::ios::binary);
     if (!file.is_open()) {
@@ -314,16 +488,18 @@ int ErrorHistogramManager::parentOffset(int offset, int base) const {
     return parentOffset;
 }
 
-std::vector<float> ErrorHistogramManager::readValues(unsigned int brickIndex) const {
+std::vector<float> ErrorHistogramManager::readValues(std::ifstream& file,
+                                                     unsigned int brickIndex) const
+{
     const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
     const unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
     std::vector<float> voxelValues(numBrickVals);
 
     std::streampos offset = _tsp->dataPosition() +
         static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    _file->seekg(offset);
+    file.seekg(offset);
 
-    _file->read(
+    file.read(
         reinterpret_cast<char*>(voxelValues.data()),
         static_cast<size_t>(numBrickVals)*sizeof(float)
     );
@@ -29,6 +29,9 @@
 #include <ghoul/glm.h>
 #include <iosfwd>
 #include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace openspace {
 
@@ -39,26 +42,39 @@ public:
     ErrorHistogramManager(TSP* tsp);
     ~ErrorHistogramManager() = default;
 
-    bool buildHistograms(int numBins);
+    /**
+     * Builds the error histograms from the TSP file using all hardware threads. If a
+     * \p checkpointFile is provided, the partial result is regularly written to it and
+     * a build that was interrupted is resumed from there. The checkpoint is removed once
+     * the build has finished.
+     */
+    bool buildHistograms(int numBins, const std::string& checkpointFile = "");
     const Histogram* histogram(unsigned int brickIndex) const;
 
     bool loadFromFile(const std::string& filename);
     bool saveToFile(const std::string& filename);
 
 private:
+    using VoxelCache = std::map<unsigned int, std::vector<float>>;
+    using HistogramMap = std::map<unsigned int, Histogram>;
+
     TSP* _tsp;
-    std::ifstream* _file;
 
     std::vector<Histogram> _histograms;
+    std::mutex _histogramMutex;
     unsigned int _numInnerNodes;
     float _minBin;
     float _maxBin;
     int _numBins;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
+    bool buildFromLeaves(unsigned int firstLeaf, unsigned int lastLeaf);
+    bool buildFromLeaf(std::ifstream& file, unsigned int bstOffset,
+        unsigned int octreeOffset, HistogramMap& histograms,
+        VoxelCache& voxelCache) const;
+    std::vector<float> readValues(std::ifstream& file, unsigned int brickIndex) const;
 
-    bool buildFromLeaf(unsigned int bstOffset, unsigned int octreeOffset);
-    std::vector<float> readValues(unsigned int brickIndex) const;
+    bool loadCheckpoint(const std::string& filename, unsigned int& processedLeaves);
+    bool saveCheckpoint(const std::string& filename, unsigned int processedLeaves) const;
 
     int parentOffset(int offset, int base) const;
 
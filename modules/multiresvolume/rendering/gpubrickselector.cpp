@@ -0,0 +1,299 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/multiresvolume/rendering/gpubrickselector.h>
+
+#include <modules/multiresvolume/rendering/tsp.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/shaderobject.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr const char* ProgramName = "BrickSelection";
+    constexpr const char* ShaderPath =
+        "${MODULES}/multiresvolume/shaders/brickselection.comp";
+
+    // Has to match the MaxCandidates constant in the shader
+    constexpr const int NumCandidates = 16;
+    constexpr const int WorkGroupSize = 64;
+
+    enum BufferBinding {
+        TspData = 0,
+        Selection,
+        UsedBricks,
+        BrickCounts,
+        Changes
+    };
+} // namespace
+
+namespace openspace {
+
+GpuBrickSelector::GpuBrickSelector(TSP* tsp, int memoryBudget)
+    : _tsp(tsp)
+    , _memoryBudget(memoryBudget)
+{}
+
+GpuBrickSelector::~GpuBrickSelector() {
+    if (_readbackFence) {
+        glDeleteSync(_readbackFence);
+    }
+    glDeleteBuffers(1, &_selectionBuffer);
+    glDeleteBuffers(1, &_usedBricksBuffer);
+    glDeleteBuffers(1, &_brickCountsBuffer);
+    glDeleteBuffers(1, &_changesBuffer);
+}
+
+bool GpuBrickSelector::initialize() {
+    if (_program) {
+        return true;
+    }
+
+    // The candidates halve the tolerances, relative to the largest errors in the tree,
+    // from a value that only selects the root down to zero which selects the finest
+    // bricks for the timestep
+    float maxSpatialError = 0.f;
+    float maxTemporalError = 0.f;
+    for (unsigned int i = 0; i < _tsp->numTotalNodes(); ++i) {
+        maxSpatialError = std::max(maxSpatialError, _tsp->spatialError(i));
+        maxTemporalError = std::max(maxTemporalError, _tsp->temporalError(i));
+    }
+
+    _spatialTolerances.resize(NumCandidates);
+    _temporalTolerances.resize(NumCandidates);
+    for (int i = 0; i < NumCandidates; ++i) {
+        const float factor = (i == NumCandidates - 1) ? 0.f : std::pow(0.5f, i);
+        _spatialTolerances[i] = factor * maxSpatialError;
+        _temporalTolerances[i] = factor * maxTemporalError;
+    }
+
+    _program = std::make_unique<ghoul::opengl::ProgramObject>(ProgramName);
+    _program->attachObject(std::make_shared<ghoul::opengl::ShaderObject>(
+        ghoul::opengl::ShaderObject::ShaderType::Compute,
+        absPath(ShaderPath),
+        ProgramName
+    ));
+    _program->compileShaderObjects();
+    _program->linkProgramObject();
+
+    const unsigned int nCells = _tsp->numBricksPerAxis() * _tsp->numBricksPerAxis() *
+                                _tsp->numBricksPerAxis();
+    _nWordsPerCandidate = (_tsp->numTotalNodes() + 31) / 32;
+    _selection.assign(nCells, 0);
+
+    // No brick has been selected for any cell so that the first selection reports all of
+    // them as changed
+    const std::vector<GLint> initialSelection(nCells, -1);
+    glGenBuffers(1, &_selectionBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _selectionBuffer);
+    glBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        nCells * sizeof(GLint),
+        initialSelection.data(),
+        GL_DYNAMIC_COPY
+    );
+
+    glGenBuffers(1, &_usedBricksBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _usedBricksBuffer);
+    glBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        NumCandidates * _nWordsPerCandidate * sizeof(GLuint),
+        nullptr,
+        GL_DYNAMIC_COPY
+    );
+
+    glGenBuffers(1, &_brickCountsBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _brickCountsBuffer);
+    glBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        NumCandidates * sizeof(GLuint),
+        nullptr,
+        GL_DYNAMIC_COPY
+    );
+
+    // The number of changes followed by pairs of cell and brick index
+    glGenBuffers(1, &_changesBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _changesBuffer);
+    glBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        (1 + 2 * nCells) * sizeof(GLuint),
+        nullptr,
+        GL_DYNAMIC_READ
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    return true;
+}
+
+void GpuBrickSelector::setMemoryBudget(int memoryBudget) {
+    _memoryBudget = memoryBudget;
+}
+
+void GpuBrickSelector::selectBricks(int timestep, std::vector<int>& bricks) {
+    if (!_program) {
+        return;
+    }
+
+    if (_readbackFence) {
+        const GLenum status = glClientWaitSync(_readbackFence, 0, 0);
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+            finishReadback();
+        }
+    }
+
+    // Only one selection is in flight at a time; a newer timestep or budget is picked up
+    // as soon as the previous selection has been read back
+    if (!_readbackFence &&
+        (timestep != _selectedTimestep || _memoryBudget != _selectedMemoryBudget))
+    {
+        dispatchSelection(timestep);
+    }
+
+    // The brick list is shared between the selectors, so it is refreshed from the last
+    // selection that has arrived from the GPU
+    std::copy(_selection.begin(), _selection.end(), bricks.begin());
+}
+
+void GpuBrickSelector::dispatchSelection(int timestep) {
+    const GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _usedBricksBuffer);
+    glClearBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        GL_R32UI,
+        GL_RED_INTEGER,
+        GL_UNSIGNED_INT,
+        &zero
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _brickCountsBuffer);
+    glClearBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        GL_R32UI,
+        GL_RED_INTEGER,
+        GL_UNSIGNED_INT,
+        &zero
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _changesBuffer);
+    glClearBufferSubData(
+        GL_SHADER_STORAGE_BUFFER,
+        GL_R32UI,
+        0,
+        sizeof(GLuint),
+        GL_RED_INTEGER,
+        GL_UNSIGNED_INT,
+        &zero
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BufferBinding::TspData, _tsp->ssbo());
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        BufferBinding::Selection,
+        _selectionBuffer
+    );
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        BufferBinding::UsedBricks,
+        _usedBricksBuffer
+    );
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        BufferBinding::BrickCounts,
+        _brickCountsBuffer
+    );
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BufferBinding::Changes, _changesBuffer);
+
+    _program->activate();
+    _program->setUniform("timestep", timestep);
+    _program->setUniform("memoryBudget", static_cast<unsigned int>(_memoryBudget));
+    _program->setUniform("numOTNodes", _tsp->numOTNodes());
+    _program->setUniform("numOTLevels", _tsp->numOTLevels());
+    _program->setUniform("numBSTNodes", _tsp->numBSTNodes());
+    _program->setUniform("numBricksPerAxis", _tsp->numBricksPerAxis());
+    _program->setUniform(
+        "numTimesteps",
+        static_cast<int>(_tsp->header().numTimesteps)
+    );
+    _program->setUniform("nWordsPerCandidate", _nWordsPerCandidate);
+    _program->setUniform("nCandidates", NumCandidates);
+    _program->setUniform(
+        "spatialTolerances",
+        _spatialTolerances.data(),
+        NumCandidates
+    );
+    _program->setUniform(
+        "temporalTolerances",
+        _temporalTolerances.data(),
+        NumCandidates
+    );
+
+    const GLuint nGroups = static_cast<GLuint>(
+        (_selection.size() + WorkGroupSize - 1) / WorkGroupSize
+    );
+
+    // First count the bricks that every candidate would use ...
+    _program->setUniform("countBricks", true);
+    glDispatchCompute(nGroups, NumCandidates, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // ... and then select the bricks of the finest candidate that fits into the budget
+    _program->setUniform("countBricks", false);
+    glDispatchCompute(nGroups, 1, 1);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    _program->deactivate();
+    for (int i = BufferBinding::TspData; i <= BufferBinding::Changes; ++i) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0);
+    }
+
+    _readbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    _selectedTimestep = timestep;
+    _selectedMemoryBudget = _memoryBudget;
+}
+
+void GpuBrickSelector::finishReadback() {
+    glDeleteSync(_readbackFence);
+    _readbackFence = nullptr;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _changesBuffer);
+    GLuint nChanges = 0;
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &nChanges);
+    if (nChanges > 0) {
+        std::vector<GLuint> changes(2 * nChanges);
+        glGetBufferSubData(
+            GL_SHADER_STORAGE_BUFFER,
+            sizeof(GLuint),
+            changes.size() * sizeof(GLuint),
+            changes.data()
+        );
+        for (GLuint i = 0; i < nChanges; ++i) {
+            _selection[changes[2 * i]] = static_cast<int>(changes[2 * i + 1]);
+        }
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+} // namespace openspace
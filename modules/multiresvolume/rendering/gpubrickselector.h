@@ -0,0 +1,85 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___GPUBRICKSELECTOR___H__
+#define __OPENSPACE_MODULE_MULTIRESVOLUME___GPUBRICKSELECTOR___H__
+
+#include <modules/multiresvolume/rendering/brickselector.h>
+
+#include <ghoul/opengl/ghoul_gl.h>
+#include <memory>
+#include <vector>
+
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace {
+
+class TSP;
+
+/**
+ * Selects the bricks in a compute shader that traverses the TSP structure, whose spatial
+ * and temporal errors are already resident on the GPU. A number of candidate tolerances
+ * are evaluated at once and the finest one whose bricks fit into the memory budget is
+ * used. The selection stays on the GPU and only the cells whose brick has changed are
+ * read back, one or more frames later, without stalling the pipeline.
+ */
+class GpuBrickSelector : public BrickSelector {
+public:
+    GpuBrickSelector(TSP* tsp, int memoryBudget);
+    ~GpuBrickSelector();
+
+    bool initialize() override;
+    void selectBricks(int timestep, std::vector<int>& bricks) override;
+    void setMemoryBudget(int memoryBudget);
+
+private:
+    void dispatchSelection(int timestep);
+    void finishReadback();
+
+    TSP* _tsp;
+    int _memoryBudget;
+
+    std::unique_ptr<ghoul::opengl::ProgramObject> _program;
+    std::vector<float> _spatialTolerances;
+    std::vector<float> _temporalTolerances;
+    unsigned int _nWordsPerCandidate = 0;
+
+    // The last selection that has been read back from the GPU
+    std::vector<int> _selection;
+
+    GLuint _selectionBuffer = 0;
+    GLuint _usedBricksBuffer = 0;
+    GLuint _brickCountsBuffer = 0;
+    GLuint _changesBuffer = 0;
+    GLsync _readbackFence = nullptr;
+
+    // The timestep and budget of the last dispatch, so that the selection only runs when
+    // either of them has changed
+    int _selectedTimestep = -1;
+    int _selectedMemoryBudget = -1;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_MULTIRESVOLUME___GPUBRICKSELECTOR___H__
@@ -59,11 +59,7 @@ bool HistogramManager::buildHistogram(TSP* tsp, unsigned int brickIndex) {
     if (isBstLeaf && isOctreeLeaf) {
         // TSP leaf, read from file and build histogram
         std::vector<float> voxelValues = readValues(tsp, brickIndex);
-        size_t numVoxels = voxelValues.size();
-
-        for (size_t v = 0; v < numVoxels; ++v) {
-            histogram.add(voxelValues[v], 1.0);
-        }
+        histogram.add(voxelValues.data(), voxelValues.size());
     } else {
         // Has children
         std::vector<unsigned int> children;
@@ -27,24 +27,33 @@
 #include <modules/multiresvolume/rendering/tsp.h>
 #include <openspace/util/progressbar.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/fmt.h>
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "LocalErrorHistogramManager";
+
+    // Number of consecutive inner nodes that are handled by one task
+    constexpr const unsigned int NodesPerTask = 64;
+
+    // The checkpoint starts with the number of inner nodes and bins
+    constexpr const size_t CheckpointHeaderSize = sizeof(unsigned int) + sizeof(int);
 } // namespace
 
 namespace openspace {
 
 LocalErrorHistogramManager::LocalErrorHistogramManager(TSP* tsp) : _tsp(tsp) {}
 
-bool LocalErrorHistogramManager::buildHistograms(int numBins) {
+bool LocalErrorHistogramManager::buildHistograms(int numBins,
+                                                 const std::string& checkpointFile)
+{
     LINFO(fmt::format("Build histograms with {} bins each", numBins));
     _numBins = numBins;
 
-    _file = &(_tsp->file());
-    if (!_file->is_open()) {
-        return false;
-    }
     _minBin = 0.f; // Should be calculated from tsp file
     _maxBin = 1.f; // Should be calculated from tsp file as (maxValue - minValue)
 
@@ -63,242 +72,242 @@ bool LocalErrorHistogramManager::buildHistograms(int numBins) {
         _temporalHistograms[i] = Histogram(_minBin, _maxBin, numBins);
     }
 
-    // All TSP Leaves
-    const int numOtNodes = _tsp->numOTNodes();
-    const int otOffset = static_cast<int>((pow(8, numOtLevels - 1) - 1) / 7);
-
-    const int numBstNodes = _tsp->numBSTNodes();
-    const int bstOffset = numBstNodes / 2;
-
-    const int numberOfLeaves = numOtLeaves * numBstLeaves;
-
-    LINFO("Building spatial histograms");
-    ProgressBar pb1(numberOfLeaves);
-    int processedLeaves = 0;
-    pb1.print(processedLeaves);
-    bool success = true;
-    for (int bst = bstOffset; bst < numBstNodes; bst++) {
-        for (int ot = otOffset; ot < numOtNodes; ot++) {
-            success &= buildFromOctreeChild(bst, ot);
-            if (!success) {
-                LERROR("Failed in buildFromOctreeChild");
-            }
-            if (!success) {
-                return false;
-            }
-            pb1.print(processedLeaves++);
+    unsigned int processedNodes = 0;
+    if (!checkpointFile.empty()) {
+        processedNodes = loadCheckpoint(checkpointFile);
+        if (processedNodes > 0) {
+            LINFO(fmt::format(
+                "Resuming histogram build at node {} of {}",
+                processedNodes, _numInnerNodes
+            ));
         }
     }
 
-    LINFO("Building temporal histograms");
-    ProgressBar pb2(numberOfLeaves);
-    processedLeaves = 0;
-    pb2.print(processedLeaves);
-    for (int ot = otOffset; ot < numOtNodes; ot++) {
-        for (int bst = bstOffset; bst < numBstNodes; bst++) {
-            success &= buildFromBstChild(bst, ot);
-            if (!success) {
-                LERROR("Failed in buildFromBstChild");
-            }
-            if (!success) {
-                return false;
-            }
-            pb2.print(processedLeaves++);
+    // Each histogram only depends on the inner node and its direct children, so the
+    // inner nodes can be processed independently of each other
+    ProgressBar pb(_numInnerNodes);
+    pb.print(processedNodes);
+    const unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    while (processedNodes < _numInnerNodes) {
+        const unsigned int roundEnd = std::min(
+            processedNodes + nThreads * NodesPerTask,
+            _numInnerNodes
+        );
+
+        std::vector<std::future<bool>> tasks;
+        for (unsigned int first = processedNodes; first < roundEnd;
+             first += NodesPerTask)
+        {
+            const unsigned int last = std::min(first + NodesPerTask, roundEnd);
+            tasks.push_back(std::async(
+                std::launch::async,
+                &LocalErrorHistogramManager::buildInnerNodes, this, first, last
+            ));
+        }
+        bool success = true;
+        for (std::future<bool>& task : tasks) {
+            success &= task.get();
+        }
+        if (!success) {
+            return false;
+        }
+
+        if (!checkpointFile.empty()) {
+            appendCheckpoint(checkpointFile, processedNodes, roundEnd);
         }
+        processedNodes = roundEnd;
+        pb.print(processedNodes);
     }
 
-    return success;
+    if (!checkpointFile.empty() && FileSys.fileExists(checkpointFile)) {
+        FileSys.deleteFile(checkpointFile);
+    }
+
+    return true;
 }
 
-bool LocalErrorHistogramManager::buildFromOctreeChild(unsigned int bstOffset,
-                                                      unsigned int octreeOffset)
+bool LocalErrorHistogramManager::buildInnerNodes(unsigned int firstNode,
+                                                 unsigned int lastNode)
 {
-    // Add errors to octree parent histogram
-    const int numOtNodes = _tsp->numOTNodes();
-    const unsigned int childIndex = bstOffset * numOtNodes + octreeOffset;
-    const bool isOctreeLeaf = _tsp->isOctreeLeaf(childIndex);
-
-    if (octreeOffset > 0) {
-        // Not octree root
-        std::vector<float> childValues;
-        std::vector<float> parentValues;
-
-        const int octreeParent = parentOffset(octreeOffset, 8);
-        const unsigned int parentIndex = bstOffset * numOtNodes + octreeParent;
-        const unsigned int parentInnerNodeIndex = brickToInnerNodeIndex(parentIndex);
-
-        if (isOctreeLeaf) {
-            childValues = readValues(childIndex);
-        } else {
-            const unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-            auto it = _voxelCache.find(childInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                childValues = it->second;
-            } else {
-                LERROR(fmt::format(
-                    "Child {} visited without cache, {}, {}",
-                    childIndex,
-                    bstOffset,
-                    octreeOffset
-                ));
-                return false;
-            }
-        }
+    // Every task reads through its own stream so that the tasks don't have to
+    // synchronize their file access
+    std::ifstream file(_tsp->filename(), std::ios::in | std::ios::binary);
+    if (!file.good()) {
+        LERROR(fmt::format("Could not open {}", _tsp->filename()));
+        return false;
+    }
 
-        const int octreeChildIndex = (octreeOffset - 1) % 8;
-        if (octreeChildIndex == 0) {
-            parentValues = readValues(parentIndex);
-            _voxelCache[parentInnerNodeIndex] = parentValues;
-        } else {
-            auto it = _voxelCache.find(parentInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                parentValues = it->second;
-            } else {
-                LERROR(fmt::format("Parent {} visited without cache", parentIndex));
-                return false;
-            }
+    for (unsigned int node = firstNode; node < lastNode; node++) {
+        const unsigned int brickIndex = innerNodeToBrickIndex(node);
+        const bool isOctreeLeaf = _tsp->isOctreeLeaf(brickIndex);
+        const bool isBstLeaf = _tsp->isBstLeaf(brickIndex);
+        if (isOctreeLeaf && isBstLeaf) {
+            continue;
         }
 
-        // Compare values and add errors to parent histogram
-        const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-        const int brickDim = static_cast<int>(_tsp->brickDim());
-        const unsigned int padding = (paddedBrickDim - brickDim) / 2;
-
-        glm::vec3 parentOffset = glm::vec3(
-            octreeChildIndex % 2,
-            (octreeChildIndex / 2) % 2,
-            octreeChildIndex / 4
-        ) * (brickDim / 2.f);
-
-        for (int z = 0; z < brickDim; z++) {
-            for (int y = 0; y < brickDim; y++) {
-                for (int x = 0; x < brickDim; x++) {
-                    glm::ivec3 childSamplePoint = glm::ivec3(x, y, z) +
-                                                  glm::ivec3(padding);
-                    glm::vec3 parentSamplePoint = parentOffset +
-                                           glm::vec3(x + 0.5f, y + 0.5f, z + 0.5f) * 0.5f;
-                    float childValue = childValues[linearCoords(childSamplePoint)];
-                    float parentValue = interpolate(parentSamplePoint, parentValues);
-
-                    // Divide by number of child voxels that will be taken into account
-                    float rectangleHeight = std::abs(childValue - parentValue) / 8.f;
-                    _spatialHistograms[parentInnerNodeIndex].addRectangle(
-                        childValue,
-                        parentValue,
-                        rectangleHeight
-                    );
-                }
+        const std::vector<float> parentValues = readValues(file, brickIndex);
+
+        // Add errors of the octree children to the spatial histogram
+        if (!isOctreeLeaf) {
+            const unsigned int firstChild = _tsp->firstOctreeChild(brickIndex);
+            for (int i = 0; i < 8; i++) {
+                addSpatialErrors(
+                    _spatialHistograms[node],
+                    readValues(file, firstChild + i),
+                    parentValues,
+                    i
+                );
             }
         }
 
-        const bool isLastOctreeChild = octreeOffset > 0 && octreeChildIndex == 7;
-        if (isLastOctreeChild) {
-            buildFromOctreeChild(bstOffset, octreeParent);
+        // Add errors of the BST children to the temporal histogram
+        if (!isBstLeaf) {
+            addTemporalErrors(
+                _temporalHistograms[node],
+                readValues(file, _tsp->bstLeft(brickIndex)),
+                parentValues
+            );
+            addTemporalErrors(
+                _temporalHistograms[node],
+                readValues(file, _tsp->bstRight(brickIndex)),
+                parentValues
+            );
         }
     }
-
-    if (!isOctreeLeaf) {
-        const unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-        _voxelCache.erase(childInnerNodeIndex);
-    }
-
-    const int bstChildIndex = bstOffset % 2;
-    const bool isLastBstChild = bstOffset > 0 && bstChildIndex == 0;
-    if (isOctreeLeaf && isLastBstChild) {
-        const int bstParent = parentOffset(bstOffset, 2);
-        buildFromOctreeChild(bstParent, octreeOffset);
-    }
-
     return true;
 }
 
-bool LocalErrorHistogramManager::buildFromBstChild(unsigned int bstOffset,
-                                                   unsigned int octreeOffset)
+void LocalErrorHistogramManager::addSpatialErrors(Histogram& histogram,
+                                               const std::vector<float>& childValues,
+                                              const std::vector<float>& parentValues,
+                                                  int octreeChildIndex) const
 {
-    // Add errors to bst parent histogram
-    const int numOtNodes = _tsp->numOTNodes();
-    const unsigned int childIndex = bstOffset * numOtNodes + octreeOffset;
-    const bool isBstLeaf = _tsp->isBstLeaf(childIndex);
-
-    if (bstOffset > 0) {
-        // Not BST root
-        std::vector<float> childValues;
-        std::vector<float> parentValues;
-
-        const int bstParent = parentOffset(bstOffset, 2);
-        const unsigned int parentIndex = bstParent * numOtNodes + octreeOffset;
-        const unsigned int parentInnerNodeIndex = brickToInnerNodeIndex(parentIndex);
-
-        if (isBstLeaf) {
-            childValues = readValues(childIndex);
-        } else {
-            unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-            auto it = _voxelCache.find(childInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                childValues = it->second;
-            } else {
-                LERROR(fmt::format("Child {} visited without cache", childIndex));
-                return false;
+    // Compare values and add errors to parent histogram
+    const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
+    const int brickDim = static_cast<int>(_tsp->brickDim());
+    const unsigned int padding = (paddedBrickDim - brickDim) / 2;
+
+    glm::vec3 parentOffset = glm::vec3(
+        octreeChildIndex % 2,
+        (octreeChildIndex / 2) % 2,
+        octreeChildIndex / 4
+    ) * (brickDim / 2.f);
+
+    for (int z = 0; z < brickDim; z++) {
+        for (int y = 0; y < brickDim; y++) {
+            for (int x = 0; x < brickDim; x++) {
+                glm::ivec3 childSamplePoint = glm::ivec3(x, y, z) + glm::ivec3(padding);
+                glm::vec3 parentSamplePoint = parentOffset +
+                                       glm::vec3(x + 0.5f, y + 0.5f, z + 0.5f) * 0.5f;
+                float childValue = childValues[linearCoords(childSamplePoint)];
+                float parentValue = interpolate(parentSamplePoint, parentValues);
+
+                // Divide by number of child voxels that will be taken into account
+                float rectangleHeight = std::abs(childValue - parentValue) / 8.f;
+                histogram.addRectangle(childValue, parentValue, rectangleHeight);
             }
         }
+    }
+}
 
-        const int bstChildIndex = bstOffset % 2;
-        if (bstChildIndex == 1) {
-            parentValues = readValues(parentIndex);
-            _voxelCache[parentInnerNodeIndex] = parentValues;
-        } else {
-            auto it = _voxelCache.find(parentInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                parentValues = it->second;
-            } else {
-                LERROR(fmt::format("Parent {} visited without cache", parentIndex));
-                return false;
+void LocalErrorHistogramManager::addTemporalErrors(Histogram& histogram,
+                                               const std::vector<float>& childValues,
+                                        const std::vector<float>& parentValues) const
+{
+    // Compare values and add errors to parent histogram
+    const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
+    const int brickDim = static_cast<int>(_tsp->brickDim());
+    const unsigned int padding = (paddedBrickDim - brickDim) / 2;
+
+    for (int z = 0; z < brickDim; z++) {
+        for (int y = 0; y < brickDim; y++) {
+            for (int x = 0; x < brickDim; x++) {
+                glm::ivec3 samplePoint = glm::ivec3(x, y, z) + glm::ivec3(padding);
+                unsigned int linearSamplePoint = linearCoords(samplePoint);
+                float childValue = childValues[linearSamplePoint];
+                float parentValue = parentValues[linearSamplePoint];
+
+                // Divide by number of child voxels that will be taken into account
+                float rectangleHeight = std::abs(childValue - parentValue) / 2.f;
+                histogram.addRectangle(childValue, parentValue, rectangleHeight);
             }
         }
+    }
+}
 
-        // Compare values and add errors to parent histogram
-        const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-        const int brickDim = static_cast<int>(_tsp->brickDim());
-        const unsigned int padding = (paddedBrickDim - brickDim) / 2;
-
-        for (int z = 0; z < brickDim; z++) {
-            for (int y = 0; y < brickDim; y++) {
-                for (int x = 0; x < brickDim; x++) {
-                    glm::ivec3 samplePoint = glm::ivec3(x, y, z) + glm::ivec3(padding);
-                    unsigned int linearSamplePoint = linearCoords(samplePoint);
-                    float childValue = childValues[linearSamplePoint];
-                    float parentValue = parentValues[linearSamplePoint];
-
-                    // Divide by number of child voxels that will be taken into account
-                    float rectangleHeight = std::abs(childValue - parentValue) / 2.f;
-                    _temporalHistograms[parentInnerNodeIndex].addRectangle(
-                        childValue,
-                        parentValue,
-                        rectangleHeight
-                    );
-                }
-            }
-        }
+unsigned int LocalErrorHistogramManager::loadCheckpoint(const std::string& filename) {
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
 
-        const bool isLastBstChild = bstOffset > 0 && bstChildIndex == 0;
-        if (isLastBstChild) {
-            buildFromBstChild(bstParent, octreeOffset);
-        }
+    unsigned int numInnerNodes = 0;
+    int numBins = 0;
+    file.read(reinterpret_cast<char*>(&numInnerNodes), sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(&numBins), sizeof(int));
+    if (!file.good() || numInnerNodes != _numInnerNodes || numBins != _numBins) {
+        LWARNING(fmt::format("Ignoring mismatching checkpoint {}", filename));
+        file.close();
+        FileSys.deleteFile(filename);
+        return 0;
     }
 
-    if (!isBstLeaf) {
-        const unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-        _voxelCache.erase(childInnerNodeIndex);
+    // Only use the nodes that were written completely
+    unsigned int processedNodes = 0;
+    while (processedNodes < _numInnerNodes) {
+        float* spatial = new float[_numBins];
+        float* temporal = new float[_numBins];
+        file.read(reinterpret_cast<char*>(spatial), sizeof(float) * _numBins);
+        file.read(reinterpret_cast<char*>(temporal), sizeof(float) * _numBins);
+        if (!file.good()) {
+            delete[] spatial;
+            delete[] temporal;
+            break;
+        }
+        // No need to deallocate histogram data, since histograms take ownership.
+        _spatialHistograms[processedNodes] = Histogram(
+            _minBin, _maxBin, _numBins, spatial
+        );
+        _temporalHistograms[processedNodes] = Histogram(
+            _minBin, _maxBin, _numBins, temporal
+        );
+        processedNodes++;
     }
+    return processedNodes;
+}
+
+bool LocalErrorHistogramManager::appendCheckpoint(const std::string& filename,
+                                                  unsigned int firstNode,
+                                                  unsigned int lastNode) const
+{
+    const size_t nodeSize = 2 * sizeof(float) * _numBins;
 
-    const int octreeChildIndex = (octreeOffset - 1) % 8;
-    const bool isLastOctreeChild = octreeOffset > 0 && octreeChildIndex == 7;
-    if (isBstLeaf && isLastOctreeChild) {
-        const int octreeParent = parentOffset(octreeOffset, 8);
-        buildFromBstChild(bstOffset, octreeParent);
+    std::fstream file;
+    if (firstNode == 0) {
+        file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&_numInnerNodes), sizeof(unsigned int));
+        file.write(reinterpret_cast<const char*>(&_numBins), sizeof(int));
+    }
+    else {
+        // Overwrite any incomplete node that an interrupted build might have left
+        file.open(filename, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(CheckpointHeaderSize + firstNode * nodeSize);
+    }
+    if (!file.is_open()) {
+        return false;
     }
 
-    return true;
+    for (unsigned int i = firstNode; i < lastNode; ++i) {
+        file.write(
+            reinterpret_cast<const char*>(_spatialHistograms[i].data()),
+            sizeof(float) * _numBins
+        );
+        file.write(
+            reinterpret_cast<const char*>(_temporalHistograms[i].data()),
+            sizeof(float) * _numBins
+        );
+    }
+    return file.good();
 }
 
 bool LocalErrorHistogramManager::loadFromFile(const std::string& filename) {
@@ -469,16 +478,18 @@ int LocalErrorHistogramManager::parentOffset(int offset, int base) const {
     return parentOffset;
 }
 
-std::vector<float> LocalErrorHistogramManager::readValues(unsigned int brickIndex) const {
+std::vector<float> LocalErrorHistogramManager::readValues(std::ifstream& file,
+                                                          unsigned int brickIndex) const
+{
     const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
     const unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
     std::vector<float> voxelValues(numBrickVals);
 
     std::streampos offset = _tsp->dataPosition() +
                             static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    _file->seekg(offset);
+    file.seekg(offset);
 
-    _file->read(
+    file.read(
         reinterpret_cast<char*>(voxelValues.data()),
         static_cast<size_t>(numBrickVals)*sizeof(float)
     );
@@ -28,7 +28,8 @@
 #include <openspace/util/histogram.h>
 #include <ghoul/glm.h>
 #include <iosfwd>
-#include <map>
+#include <string>
+#include <vector>
 
 namespace openspace {
 
@@ -38,7 +39,13 @@ class LocalErrorHistogramManager {
 public:
     LocalErrorHistogramManager(TSP* tsp);
 
-    bool buildHistograms(int numBins);
+    /**
+     * Builds the spatial and temporal error histograms from the TSP file using all
+     * hardware threads. If a \p checkpointFile is provided, the finished histograms
+     * are appended to it as the build progresses and a build that was interrupted is
+     * resumed from there. The checkpoint is removed once the build has finished.
+     */
+    bool buildHistograms(int numBins, const std::string& checkpointFile = "");
     const Histogram* spatialHistogram(unsigned int brickIndex) const;
     const Histogram* temporalHistogram(unsigned int brickIndex) const;
 
@@ -47,7 +54,6 @@ public:
 
 private:
     TSP* _tsp = nullptr;
-    std::ifstream* _file;
 
     std::vector<Histogram> _spatialHistograms;
     std::vector<Histogram> _temporalHistograms;
@@ -56,12 +62,17 @@ private:
     float _maxBin = 0.f;
     int _numBins = 0;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
+    bool buildInnerNodes(unsigned int firstNode, unsigned int lastNode);
+    void addSpatialErrors(Histogram& histogram, const std::vector<float>& childValues,
+        const std::vector<float>& parentValues, int octreeChildIndex) const;
+    void addTemporalErrors(Histogram& histogram, const std::vector<float>& childValues,
+        const std::vector<float>& parentValues) const;
 
-    bool buildFromOctreeChild(unsigned int bstOffset, unsigned int octreeOffset);
-    bool buildFromBstChild(unsigned int bstOffset, unsigned int octreeOffset);
+    std::vector<float> readValues(std::ifstream& file, unsigned int brickIndex) const;
 
-    std::vector<float> readValues(unsigned int brickIndex) const;
+    unsigned int loadCheckpoint(const std::string& filename);
+    bool appendCheckpoint(const std::string& filename, unsigned int firstNode,
+        unsigned int lastNode) const;
 
     int parentOffset(int offset, int base) const;
 
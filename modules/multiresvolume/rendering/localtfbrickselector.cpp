@@ -28,6 +28,7 @@
 #include <modules/multiresvolume/rendering/localerrorhistogrammanager.h>
 #include <openspace/rendering/transferfunction.h>
 #include <ghoul/misc/assert.h>
+#include <algorithm>
 
 namespace {
     bool compareSplitPoints(const openspace::BrickSelection& a,
@@ -35,6 +36,14 @@ namespace {
     {
         return a.splitPoints < b.splitPoints;
     }
+
+    // Time per frame that is spent on refreshing brick errors after the transfer
+    // function has changed
+    constexpr const std::chrono::microseconds ErrorUpdateBudget =
+        std::chrono::milliseconds(4);
+
+    // Number of bricks that are updated between checks of the elapsed time
+    constexpr const unsigned int ErrorUpdateBatchSize = 256;
 } // namespace
 
 namespace openspace {
@@ -54,14 +63,27 @@ bool LocalTfBrickSelector::initialize() {
 }
 
 void LocalTfBrickSelector::setMemoryBudget(int memoryBudget) {
+    _selectionIsDirty |= (memoryBudget != _memoryBudget);
     _memoryBudget = memoryBudget;
 }
 
 void LocalTfBrickSelector::setStreamingBudget(int streamingBudget) {
+    _selectionIsDirty |= (streamingBudget != _streamingBudget);
     _streamingBudget = streamingBudget;
 }
 
 void LocalTfBrickSelector::selectBricks(int timestep, std::vector<int>& bricks) {
+    if (_nOutdatedBricks > 0) {
+        updateBrickErrors(ErrorUpdateBudget);
+    }
+
+    if (!_selectionIsDirty && timestep == _previousTimestep &&
+        bricks.size() == _previousSelection.size())
+    {
+        std::copy(_previousSelection.begin(), _previousSelection.end(), bricks.begin());
+        return;
+    }
+
     const int numTimeSteps = _tsp->header().numTimesteps;
     const int numBricksPerDim = _tsp->header().xNumBricks;
 
@@ -289,6 +311,10 @@ void LocalTfBrickSelector::selectBricks(int timestep, std::vector<int>& bricks)
     for (const BrickSelection& bs : leafSelections) {
         writeSelection(bs, bricks);
     }
+
+    _previousSelection = bricks;
+    _previousTimestep = timestep;
+    _selectionIsDirty = false;
 }
 
 float LocalTfBrickSelector::temporalSplitPoints(unsigned int brickIndex) const {
@@ -326,7 +352,7 @@ float LocalTfBrickSelector::splitPoints(unsigned int brickIndex,
     return splitPoints;
 }
 
-bool LocalTfBrickSelector::calculateBrickErrors() {
+bool LocalTfBrickSelector::calculateGradients() {
     TransferFunction* tf = _transferFunction;
     if (!tf) {
         return false;
@@ -337,57 +363,93 @@ bool LocalTfBrickSelector::calculateBrickErrors() {
         return false;
     }
 
-    std::vector<float> gradients(tfWidth - 1);
+    _gradients.resize(tfWidth - 1);
     for (size_t offset = 0; offset < tfWidth - 1; offset++) {
         const glm::vec4 prevRgba = tf->sample(offset);
-        const         glm::vec4 nextRgba = tf->sample(offset + 1);
+        const glm::vec4 nextRgba = tf->sample(offset + 1);
 
         const float colorDifference = glm::distance(prevRgba, nextRgba);
         const float alpha = (prevRgba.w + nextRgba.w) * 0.5f;
 
-        gradients[offset] = colorDifference*alpha;
+        _gradients[offset] = colorDifference*alpha;
+    }
+    return true;
+}
+
+bool LocalTfBrickSelector::calculateBrickErrors() {
+    if (!calculateGradients()) {
+        return false;
     }
 
     const unsigned int nHistograms = _tsp->numTotalNodes();
     _brickErrors = std::vector<Error>(nHistograms);
-
     for (unsigned int brickIndex = 0; brickIndex < nHistograms; brickIndex++) {
-        if (_tsp->isOctreeLeaf(brickIndex)) {
-            _brickErrors[brickIndex].spatial = 0.0;
-        } else {
-            const Histogram* histogram = _histogramManager->spatialHistogram(
-                brickIndex
-            );
-            float error = 0;
-            for (size_t i = 0; i < gradients.size(); i++) {
-                float x = (i + 0.5f) / tfWidth;
-                float sample = histogram->interpolate(x);
-                ghoul_assert(sample >= 0, "@MISSING");
-                ghoul_assert(gradients[i] >= 0, "@MISSING");
-                error += sample * gradients[i];
-            }
-            _brickErrors[brickIndex].spatial = error;
+        _brickErrors[brickIndex] = brickError(brickIndex);
+    }
+
+    _nOutdatedBricks = 0;
+    _selectionIsDirty = true;
+    return true;
+}
+
+void LocalTfBrickSelector::invalidateBrickErrors() {
+    if (_brickErrors.size() != _tsp->numTotalNodes()) {
+        // There are no previous errors that could be used in the meantime
+        calculateBrickErrors();
+        return;
+    }
+
+    if (!calculateGradients()) {
+        return;
+    }
+
+    // Start over at the current position so that a transfer function that changes
+    // every frame still refreshes all bricks eventually
+    _nOutdatedBricks = _tsp->numTotalNodes();
+}
+
+void LocalTfBrickSelector::updateBrickErrors(std::chrono::microseconds budget) {
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const unsigned int nHistograms = _tsp->numTotalNodes();
+
+    while (_nOutdatedBricks > 0) {
+        const unsigned int nBricks = std::min(_nOutdatedBricks, ErrorUpdateBatchSize);
+        for (unsigned int i = 0; i < nBricks; ++i) {
+            _brickErrors[_nextOutdatedBrick] = brickError(_nextOutdatedBrick);
+            _nextOutdatedBrick = (_nextOutdatedBrick + 1) % nHistograms;
         }
+        _nOutdatedBricks -= nBricks;
 
-        if (_tsp->isBstLeaf(brickIndex)) {
-            _brickErrors[brickIndex].temporal = 0.0;
-        } else {
-            const Histogram* histogram = _histogramManager->temporalHistogram(
-                brickIndex
-            );
-            float error = 0;
-            for (size_t i = 0; i < gradients.size(); i++) {
-                float x = (i + 0.5f) / tfWidth;
-                float sample = histogram->interpolate(x);
-                ghoul_assert(sample >= 0, "@MISSING");
-                ghoul_assert(gradients[i] >= 0, "@MISSING");
-                error += sample * gradients[i];
-            }
-            _brickErrors[brickIndex].temporal = error;
+        if (std::chrono::steady_clock::now() - start > budget) {
+            break;
         }
     }
+    _selectionIsDirty = true;
+}
 
-    return true;
+Error LocalTfBrickSelector::brickError(unsigned int brickIndex) const {
+    const float tfWidth = static_cast<float>(_gradients.size() + 1);
+    auto weightedError = [this, tfWidth](const Histogram* histogram) {
+        float error = 0;
+        for (size_t i = 0; i < _gradients.size(); i++) {
+            float x = (i + 0.5f) / tfWidth;
+            float sample = histogram->interpolate(x);
+            ghoul_assert(sample >= 0, "@MISSING");
+            ghoul_assert(_gradients[i] >= 0, "@MISSING");
+            error += sample * _gradients[i];
+        }
+        return error;
+    };
+
+    Error error;
+    error.spatial = _tsp->isOctreeLeaf(brickIndex) ?
+        0.f :
+        weightedError(_histogramManager->spatialHistogram(brickIndex));
+    error.temporal = _tsp->isBstLeaf(brickIndex) ?
+        0.f :
+        weightedError(_histogramManager->temporalHistogram(brickIndex));
+    return error;
 }
 
 int LocalTfBrickSelector::linearCoordinates(int x, int y, int z) const {
@@ -28,6 +28,7 @@
 #include <modules/multiresvolume/rendering/brickselector.h>
 
 #include <modules/multiresvolume/rendering/brickselection.h>
+#include <chrono>
 #include <vector>
 
 namespace openspace {
@@ -53,6 +54,13 @@ public:
     void setMemoryBudget(int memoryBudget);
     void setStreamingBudget(int streamingBudget);
     bool calculateBrickErrors();
+    /**
+     * Starts refreshing the brick errors after the transfer function has changed.
+     * Instead of recomputing all errors at once, each call to selectBricks updates as
+     * many bricks as fit in its time budget, so that the selection converges towards
+     * the new transfer function over a few frames without stalling a single frame.
+     */
+    void invalidateBrickErrors();
 
 private:
     TSP* _tsp;
@@ -67,8 +75,23 @@ private:
     int linearCoordinates(int x, int y, int z) const;
     void writeSelection(BrickSelection coveredBricks, std::vector<int>& bricks);
 
+    bool calculateGradients();
+    Error brickError(unsigned int brickIndex) const;
+    void updateBrickErrors(std::chrono::microseconds budget);
+
     int _memoryBudget;
     int _streamingBudget;
+
+    // Transfer function gradients used by brickError
+    std::vector<float> _gradients;
+    // Bricks whose error still has to be refreshed, starting at _nextOutdatedBrick
+    unsigned int _nOutdatedBricks = 0;
+    unsigned int _nextOutdatedBrick = 0;
+
+    // The previous selection is reused as long as nothing affecting it has changed
+    std::vector<int> _previousSelection;
+    int _previousTimestep = -1;
+    bool _selectionIsDirty = true;
 };
 
 } // namespace openspace
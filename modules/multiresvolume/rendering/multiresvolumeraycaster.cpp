@@ -108,6 +108,17 @@ void MultiresVolumeRaycaster::preRaycast(const RaycastData& data,
     _transferFunction->texture().bind();
     program.setUniform("transferFunction_" + id, _tfUnit->unitNumber());
 
+    _preintegrationUnit = std::make_unique<ghoul::opengl::TextureUnit>();
+    if (_usePreintegration) {
+        _preintegrationUnit->activate();
+        _transferFunction->preintegratedTexture().bind();
+    }
+    program.setUniform(
+        "preintegrationTable_" + id,
+        _preintegrationUnit->unitNumber()
+    );
+    program.setUniform("usePreintegration_" + id, _usePreintegration);
+
     _atlasUnit = std::make_unique<ghoul::opengl::TextureUnit>();
     _atlasUnit->activate();
     _atlasManager->textureAtlas().bind();
@@ -169,6 +180,7 @@ void MultiresVolumeRaycaster::postRaycast(const RaycastData&,
 {
     _atlasUnit = nullptr;
     _tfUnit = nullptr;
+    _preintegrationUnit = nullptr;
 }
 
 std::string MultiresVolumeRaycaster::boundsVertexShaderPath() const {
@@ -195,4 +207,8 @@ void MultiresVolumeRaycaster::setStepSizeCoefficient(float stepSizeCoefficient)
     _stepSizeCoefficient = stepSizeCoefficient;
 }
 
+void MultiresVolumeRaycaster::setUsePreintegration(bool usePreintegration) {
+    _usePreintegration = usePreintegration;
+}
+
 } // namespace openspace
@@ -75,16 +75,26 @@ public:
     //void setTime(double time);
     void setStepSizeCoefficient(float coefficient);
 
+    /**
+     * If \p usePreintegration is true, the color of each segment of a ray is looked up in
+     * the pre-integrated table of the transfer function from the values at both of its
+     * ends, which allows for larger step sizes without banding for sharp transfer
+     * functions.
+     */
+    void setUsePreintegration(bool usePreintegration);
+
 private:
     BoxGeometry _boundingBox;
     glm::mat4 _modelTransform;
     float _stepSizeCoefficient;
+    bool _usePreintegration = false;
 
     std::shared_ptr<TSP> _tsp;
     std::shared_ptr<AtlasManager> _atlasManager;
     std::shared_ptr<TransferFunction> _transferFunction;
 
     std::unique_ptr<ghoul::opengl::TextureUnit> _tfUnit;
+    std::unique_ptr<ghoul::opengl::TextureUnit> _preintegrationUnit;
     std::unique_ptr<ghoul::opengl::TextureUnit> _atlasUnit;
     std::unique_ptr<
         ghoul::opengl::BufferBinding<ghoul::opengl::bufferbinding::Buffer::ShaderStorage>
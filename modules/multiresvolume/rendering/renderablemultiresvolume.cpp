@@ -27,6 +27,7 @@
 #include <modules/kameleon/include/kameleonwrapper.h>
 #include <modules/multiresvolume/rendering/atlasmanager.h>
 #include <modules/multiresvolume/rendering/errorhistogrammanager.h>
+#include <modules/multiresvolume/rendering/gpubrickselector.h>
 #include <modules/multiresvolume/rendering/histogrammanager.h>
 #include <modules/multiresvolume/rendering/localerrorhistogrammanager.h>
 #include <modules/multiresvolume/rendering/localtfbrickselector.h>
@@ -75,12 +76,29 @@ namespace {
     constexpr const char* GlslHeaderPath =
         "${MODULES}/multiresvolume/shaders/header.glsl";
 
+    constexpr openspace::properties::Property::PropertyInfo DownscaleInfo = {
+        "Downscale",
+        "Downscale Factor",
+        "The factor by which the resolution at which this volume is raycast is reduced "
+        "relative to the rendering resolution. Lower values trade image quality for "
+        "rendering performance."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo StepSizeCoefficientInfo = {
         "StepSizeCoefficient",
         "Stepsize Coefficient",
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo PreintegrationInfo = {
+        "Preintegration",
+        "Pre-integration",
+        "If enabled, the transfer function is integrated between the intensities of "
+        "two consecutive samples of a ray instead of being evaluated at single "
+        "samples. This avoids banding for sharp transfer functions, so that a larger "
+        "step size coefficient gives the same image quality."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo CurrentTimeInfo = {
         "CurrentTime",
         "Current Time",
@@ -164,6 +182,8 @@ RenderableMultiresVolume::RenderableMultiresVolume(const ghoul::Dictionary& dict
     , _memoryBudget(MemoryBudgetInfo, 0, 0, 0)
     , _streamingBudget(StreamingBudgetInfo, 0, 0, 0)
     , _stepSizeCoefficient(StepSizeCoefficientInfo, 1.f, 0.01f, 10.f)
+    , _usePreintegration(PreintegrationInfo, true)
+    , _downscaleVolumeRendering(DownscaleInfo, 1.f, 0.1f, 1.f)
     , _selectorName(SelectorNameInfo, "tf")
     , _statsToFile(StatsToFileInfo, false)
     , _statsToFileName(StatsToFileNameInfo)
@@ -196,6 +216,10 @@ RenderableMultiresVolume::RenderableMultiresVolume(const ghoul::Dictionary& dict
         );
     }
 
+    if (dictionary.hasKeyAndValue<bool>(PreintegrationInfo.identifier)) {
+        _usePreintegration = dictionary.value<bool>(PreintegrationInfo.identifier);
+    }
+
     if (dictionary.hasKeyAndValue<glm::vec3>("Scaling")) {
         _scaling = dictionary.value<glm::vec3>("Scaling");
     }
@@ -265,6 +289,8 @@ RenderableMultiresVolume::RenderableMultiresVolume(const ghoul::Dictionary& dict
         _selector = Selector::SIMPLE;
     } else if (selectorName == "local") {
         _selector = Selector::LOCAL;
+    } else if (selectorName == "gpu") {
+        _selector = Selector::GPU;
     } else {
         _selector = Selector::TF;
     }
@@ -277,6 +303,8 @@ RenderableMultiresVolume::RenderableMultiresVolume(const ghoul::Dictionary& dict
             s = Selector::SIMPLE;
         } else if (newSelectorName == "local") {
             s = Selector::LOCAL;
+        } else if (newSelectorName == "gpu") {
+            s = Selector::GPU;
         } else if (newSelectorName == "tf") {
             s = Selector::TF;
         } else {
@@ -286,6 +314,8 @@ RenderableMultiresVolume::RenderableMultiresVolume(const ghoul::Dictionary& dict
     });
 
     addProperty(_stepSizeCoefficient);
+    addProperty(_usePreintegration);
+    addProperty(_downscaleVolumeRendering);
     addProperty(_useGlobalTime);
     addProperty(_loop);
     addProperty(_statsToFile);
@@ -316,7 +346,7 @@ void RenderableMultiresVolume::setSelectorType(Selector selector) {
                     _streamingBudget
                 );
                 _transferFunction->setCallback([this](const TransferFunction&) {
-                    _tfBrickSelector->calculateBrickErrors();
+                    _tfBrickSelector->invalidateBrickErrors();
                 });
                 if (initializeSelector()) {
                     _tfBrickSelector->calculateBrickErrors();
@@ -357,7 +387,7 @@ void RenderableMultiresVolume::setSelectorType(Selector selector) {
                     _streamingBudget
                 );
                 _transferFunction->setCallback([this](const TransferFunction&) {
-                    _localTfBrickSelector->calculateBrickErrors();
+                    _localTfBrickSelector->invalidateBrickErrors();
                 });
                 if (initializeSelector()) {
                     _localTfBrickSelector->calculateBrickErrors();
@@ -365,6 +395,16 @@ void RenderableMultiresVolume::setSelectorType(Selector selector) {
                 }
             }
             break;
+
+        case Selector::GPU:
+            if (!_gpuBrickSelector) {
+                _gpuBrickSelector = std::make_unique<GpuBrickSelector>(
+                    _tsp.get(),
+                    _memoryBudget
+                );
+                initializeSelector();
+            }
+            break;
     }
 }
 
@@ -478,7 +518,10 @@ bool RenderableMultiresVolume::initializeSelector() {
                 } else {
                     // Build histograms from tsp file.
                     LWARNING(fmt::format("Failed to open {}", cacheFilename));
-                    success &= _errorHistogramManager->buildHistograms(nHistograms);
+                    success &= _errorHistogramManager->buildHistograms(
+                        nHistograms,
+                        cacheFilename + ".partial"
+                    );
                     if (success) {
                         LINFO(fmt::format("Writing cache to {}", cacheFilename));
                         _errorHistogramManager->saveToFile(cacheFilename);
@@ -539,7 +582,10 @@ bool RenderableMultiresVolume::initializeSelector() {
                 } else {
                     // Build histograms from tsp file.
                     LWARNING(fmt::format("Failed to open {}", cacheFilename));
-                    success &= _localErrorHistogramManager->buildHistograms(nHistograms);
+                    success &= _localErrorHistogramManager->buildHistograms(
+                        nHistograms,
+                        cacheFilename + ".partial"
+                    );
                     if (success) {
                         LINFO(fmt::format("Writing cache to {}", cacheFilename));
                         _localErrorHistogramManager->saveToFile(cacheFilename);
@@ -548,6 +594,12 @@ bool RenderableMultiresVolume::initializeSelector() {
                 success &= _localTfBrickSelector && _localTfBrickSelector->initialize();
             }
             break;
+
+        case Selector::GPU:
+            // The selection only depends on the errors in the TSP structure, which are
+            // already resident on the GPU, so there are no histograms to prepare
+            success &= _gpuBrickSelector && _gpuBrickSelector->initialize();
+            break;
     }
 
     return success;
@@ -690,6 +742,12 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
                     _localTfBrickSelector->selectBricks(currentTimestep, _brickIndices);
                 }
                 break;
+            case Selector::GPU:
+                if (_gpuBrickSelector) {
+                    _gpuBrickSelector->setMemoryBudget(_memoryBudget);
+                    _gpuBrickSelector->selectBricks(currentTimestep, _brickIndices);
+                }
+                break;
         }
 
         std::chrono::system_clock::time_point uploadStart;
@@ -700,7 +758,7 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             uploadStart = selectionEnd;
         }
 
-        _atlasManager->updateAtlas(AtlasManager::EVEN, _brickIndices);
+        _atlasManager->updateAtlas(_brickIndices);
 
         if (_gatheringStats) {
             std::chrono::system_clock::time_point uploadEnd =
@@ -729,6 +787,8 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
         );
 
         _raycaster->setStepSizeCoefficient(_stepSizeCoefficient);
+        _raycaster->setUsePreintegration(_usePreintegration);
+        _raycaster->setDownscaleRender(_downscaleVolumeRendering);
         _raycaster->setModelTransform(transform);
         //_raycaster->setTime(data.time);
     }
@@ -46,6 +46,7 @@ namespace openspace {
 class AtlasManager;
 class BrickSelector;
 class ErrorHistogramManager;
+class GpuBrickSelector;
 class HistogramManager;
 class LocalErrorHistogramManager;
 class LocalTfBrickSelector;
@@ -63,7 +64,8 @@ public:
     enum Selector {
         TF,
         SIMPLE,
-        LOCAL
+        LOCAL,
+        GPU
     };
 
     void setSelectorType(Selector selector);
@@ -91,6 +93,8 @@ private:
     properties::IntProperty _memoryBudget;
     properties::IntProperty _streamingBudget;
     properties::FloatProperty _stepSizeCoefficient;
+    properties::BoolProperty _usePreintegration;
+    properties::FloatProperty _downscaleVolumeRendering;
     properties::StringProperty _selectorName;
     properties::BoolProperty _statsToFile;
     properties::StringProperty _statsToFileName;
@@ -140,6 +144,7 @@ private:
     std::unique_ptr<TfBrickSelector> _tfBrickSelector;
     std::unique_ptr<SimpleTfBrickSelector> _simpleTfBrickSelector;
     std::unique_ptr<LocalTfBrickSelector> _localTfBrickSelector;
+    std::unique_ptr<GpuBrickSelector> _gpuBrickSelector;
 
     Selector _selector;
 
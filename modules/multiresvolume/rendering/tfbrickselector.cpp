@@ -29,6 +29,7 @@
 #include <openspace/rendering/transferfunction.h>
 #include <openspace/util/histogram.h>
 #include <ghoul/misc/assert.h>
+#include <algorithm>
 
 namespace {
     bool compareSplitPoints(const openspace::BrickSelection& a,
@@ -36,6 +37,14 @@ namespace {
     {
         return a.splitPoints < b.splitPoints;
     }
+
+    // Time per frame that is spent on refreshing brick errors after the transfer
+    // function has changed
+    constexpr const std::chrono::microseconds ErrorUpdateBudget =
+        std::chrono::milliseconds(4);
+
+    // Number of bricks that are updated between checks of the elapsed time
+    constexpr const unsigned int ErrorUpdateBatchSize = 256;
 } // namespace
 
 namespace openspace {
@@ -55,14 +64,27 @@ bool TfBrickSelector::initialize() {
 }
 
 void TfBrickSelector::setMemoryBudget(int memoryBudget) {
+    _selectionIsDirty |= (memoryBudget != _memoryBudget);
     _memoryBudget = memoryBudget;
 }
 
 void TfBrickSelector::setStreamingBudget(int streamingBudget) {
+    _selectionIsDirty |= (streamingBudget != _streamingBudget);
     _streamingBudget = streamingBudget;
 }
 
 void TfBrickSelector::selectBricks(int timestep, std::vector<int>& bricks) {
+    if (_nOutdatedBricks > 0) {
+        updateBrickErrors(ErrorUpdateBudget);
+    }
+
+    if (!_selectionIsDirty && timestep == _previousTimestep &&
+        bricks.size() == _previousSelection.size())
+    {
+        std::copy(_previousSelection.begin(), _previousSelection.end(), bricks.begin());
+        return;
+    }
+
     int numTimeSteps = _tsp->header().numTimesteps;
     int numBricksPerDim = _tsp->header().xNumBricks;
 
@@ -305,6 +327,10 @@ void TfBrickSelector::selectBricks(int timestep, std::vector<int>& bricks) {
     for (const BrickSelection& bs : leafSelections) {
         writeSelection(bs, bricks);
     }
+
+    _previousSelection = bricks;
+    _previousTimestep = timestep;
+    _selectionIsDirty = false;
 }
 
 float TfBrickSelector::temporalSplitPoints(unsigned int brickIndex) {
@@ -368,8 +394,8 @@ float TfBrickSelector::splitPoints(unsigned int brickIndex,
 }
 
 
-bool TfBrickSelector::calculateBrickErrors() {
-    TransferFunction *tf = _transferFunction;
+bool TfBrickSelector::calculateGradients() {
+    TransferFunction* tf = _transferFunction;
     if (!tf) {
         return false;
     }
@@ -379,40 +405,89 @@ bool TfBrickSelector::calculateBrickErrors() {
         return false;
     }
 
-    std::vector<float> gradients(tfWidth - 1);
+    _gradients.resize(tfWidth - 1);
     for (size_t offset = 0; offset < tfWidth - 1; offset++) {
-        glm::vec4 prevRgba = tf->sample(offset);
-        glm::vec4 nextRgba = tf->sample(offset + 1);
+        const glm::vec4 prevRgba = tf->sample(offset);
+        const glm::vec4 nextRgba = tf->sample(offset + 1);
 
-        float colorDifference = glm::distance(prevRgba, nextRgba);
-        float alpha = (prevRgba.w + nextRgba.w) * 0.5f;
+        const float colorDifference = glm::distance(prevRgba, nextRgba);
+        const float alpha = (prevRgba.w + nextRgba.w) * 0.5f;
 
-        gradients[offset] = colorDifference*alpha;
+        _gradients[offset] = colorDifference*alpha;
     }
+    return true;
+}
 
-    unsigned int nHistograms = _tsp->numTotalNodes();
-    _brickErrors = std::vector<float>(nHistograms);
+bool TfBrickSelector::calculateBrickErrors() {
+    if (!calculateGradients()) {
+        return false;
+    }
 
+    const unsigned int nHistograms = _tsp->numTotalNodes();
+    _brickErrors = std::vector<float>(nHistograms);
     for (unsigned int brickIndex = 0; brickIndex < nHistograms; brickIndex++) {
-        if (_tsp->isBstLeaf(brickIndex) && _tsp->isOctreeLeaf(brickIndex)) {
-            _brickErrors[brickIndex] = 0;
-        } else {
-            const Histogram* histogram = _histogramManager->histogram(brickIndex);
-            float error = 0;
-            for (size_t i = 0; i < gradients.size(); i++) {
-                float x = (i + 0.5f) / tfWidth;
-                float sample = histogram->interpolate(x);
-                ghoul_assert(sample >= 0, "@MISSING");
-                ghoul_assert(gradients[i] >= 0, "@MISSING");
-                error += sample * gradients[i];
-            }
-            _brickErrors[brickIndex] = error;
-        }
+        _brickErrors[brickIndex] = brickError(brickIndex);
     }
 
+    _nOutdatedBricks = 0;
+    _selectionIsDirty = true;
     return true;
 }
 
+void TfBrickSelector::invalidateBrickErrors() {
+    if (_brickErrors.size() != _tsp->numTotalNodes()) {
+        // There are no previous errors that could be used in the meantime
+        calculateBrickErrors();
+        return;
+    }
+
+    if (!calculateGradients()) {
+        return;
+    }
+
+    // Start over at the current position so that a transfer function that changes
+    // every frame still refreshes all bricks eventually
+    _nOutdatedBricks = _tsp->numTotalNodes();
+}
+
+void TfBrickSelector::updateBrickErrors(std::chrono::microseconds budget) {
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const unsigned int nHistograms = _tsp->numTotalNodes();
+
+    while (_nOutdatedBricks > 0) {
+        const unsigned int nBricks = std::min(_nOutdatedBricks, ErrorUpdateBatchSize);
+        for (unsigned int i = 0; i < nBricks; ++i) {
+            _brickErrors[_nextOutdatedBrick] = brickError(_nextOutdatedBrick);
+            _nextOutdatedBrick = (_nextOutdatedBrick + 1) % nHistograms;
+        }
+        _nOutdatedBricks -= nBricks;
+
+        if (std::chrono::steady_clock::now() - start > budget) {
+            break;
+        }
+    }
+    _selectionIsDirty = true;
+}
+
+float TfBrickSelector::brickError(unsigned int brickIndex) const {
+    if (_tsp->isBstLeaf(brickIndex) && _tsp->isOctreeLeaf(brickIndex)) {
+        return 0.f;
+    }
+
+    const float tfWidth = static_cast<float>(_gradients.size() + 1);
+    const Histogram* histogram = _histogramManager->histogram(brickIndex);
+    float error = 0;
+    for (size_t i = 0; i < _gradients.size(); i++) {
+        float x = (i + 0.5f) / tfWidth;
+        float sample = histogram->interpolate(x);
+        ghoul_assert(sample >= 0, "@MISSING");
+        ghoul_assert(_gradients[i] >= 0, "@MISSING");
+        error += sample * _gradients[i];
+    }
+    return error;
+}
+
 int TfBrickSelector::linearCoords(int x, int y, int z) const {
     const TSP::Header &header = _tsp->header();
     return x + (header.xNumBricks * y) + (header.xNumBricks * header.yNumBricks * z);
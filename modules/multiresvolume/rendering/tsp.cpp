@@ -30,11 +30,49 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cstring>
+#include <future>
 #include <numeric>
 #include <queue>
+#include <thread>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
 
 namespace {
     constexpr const char* _loggerCat = "TSP";
+
+    // Version of the error metric cache file. Increment this whenever the layout of
+    // the cache or the way the errors are computed changes
+    constexpr const int8_t CurrentCacheVersion = 1;
+
+    // Calls the function for each index in [0, n), distributed over all hardware
+    // threads
+    template <typename Func>
+    void parallelFor(unsigned int n, const Func& func) {
+        const unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        const unsigned int chunkSize = (n + nThreads - 1) / nThreads;
+
+        std::vector<std::future<void>> futures;
+        for (unsigned int begin = 0; begin < n; begin += chunkSize) {
+            const unsigned int end = std::min(begin + chunkSize, n);
+            futures.push_back(std::async(std::launch::async, [&func, begin, end]() {
+                for (unsigned int i = begin; i < end; ++i) {
+                    func(i);
+                }
+            }));
+        }
+        for (std::future<void>& f : futures) {
+            f.get();
+        }
+    }
 } // namespace
 
 namespace openspace {
@@ -46,6 +84,7 @@ TSP::TSP(const std::string& filename)
 }
 
 TSP::~TSP() {
+    unmapFile();
     if (_file.is_open()) {
         _file.close();
     }
@@ -66,19 +105,19 @@ bool TSP::load() {
             return false;
         }
 
-        if (false) {
-            if (!calculateSpatialError()) {
-                LERROR("Could not calculate spatial error");
-                return false;
-            }
-            if (!calculateTemporalError()) {
-                LERROR("Could not calculate temporal error");
-                return false;
-            }
-            if (!writeCache()) {
-                LERROR("Could not write cache");
-                return false;
-            }
+        if (!mapFile()) {
+            LERROR("Could not map data file");
+            return false;
+        }
+        const bool success = calculateSpatialError() && calculateTemporalError();
+        unmapFile();
+        if (!success) {
+            LERROR("Could not calculate errors");
+            return false;
+        }
+        if (!writeCache()) {
+            LERROR("Could not write cache");
+            return false;
         }
     }
     initalizeSSO();
@@ -221,6 +260,10 @@ long long TSP::dataPosition() {
     return sizeof(Header);
 }
 
+const std::string& TSP::filename() const {
+    return _filename;
+}
+
 std::ifstream& TSP::file() {
     return _file;
 }
@@ -268,45 +311,30 @@ GLuint TSP::ssbo() const {
 bool TSP::calculateSpatialError() {
     unsigned int numBrickVals = _paddedBrickDim*_paddedBrickDim*_paddedBrickDim;
 
-    if (!_file.is_open()) {
+    if (!_mappedFile) {
         return false;
     }
 
-    std::vector<float> buffer(numBrickVals);
     std::vector<float> averages(_numTotalNodes);
     std::vector<float> stdDevs(_numTotalNodes);
 
     // First pass: Calculate average color for each brick
     LDEBUG("Calculating spatial error, first pass");
-    for (unsigned int brick = 0; brick<_numTotalNodes; ++brick) {
-        // Offset in file
-        std::streampos offset = dataPosition() +
-                                static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(
-            reinterpret_cast<char*>(&buffer[0]),
-            static_cast<size_t>(numBrickVals) * sizeof(float)
-        );
-
+    parallelFor(_numTotalNodes, [&](unsigned int brick) {
+        const float* data = brickData(brick);
         double average = std::accumulate(
-            buffer.begin(),
-            buffer.end(),
+            data,
+            data + numBrickVals,
             0.0,
             [](double a, float b) { return a + static_cast<double>(b); }
         );
         averages[brick] = static_cast<float>(average / static_cast<double>(numBrickVals));
-    }
-
-    // Spatial SNR stats
-    float minError = 1e20f;
-    float maxError = 0.f;
-    std::vector<float> medianArray(_numTotalNodes);
+    });
 
     // Second pass: For each brick, compare the covered leaf voxels with
     // the brick average
     LDEBUG("Calculating spatial error, second pass");
-    for (unsigned int brick = 0; brick < _numTotalNodes; ++brick) {
+    parallelFor(_numTotalNodes, [&](unsigned int brick) {
         // Fetch mean intensity
         float brickAvg = averages[brick];
 
@@ -323,21 +351,11 @@ bool TSP::calculateSpatialError() {
             stdDev = -0.1f;
         }
         else {
-
             // Calculate "standard deviation" corresponding to leaves
-            for (auto lb = leafBricksCovered.begin(); lb != leafBricksCovered.end(); ++lb)
-            {
-                // Read brick
-                std::streampos offset = dataPosition() +
-                                 static_cast<long long>((*lb)*numBrickVals*sizeof(float));
-                _file.seekg(offset);
-
-                _file.read(reinterpret_cast<char*>(&buffer[0]),
-                    static_cast<size_t>(numBrickVals)*sizeof(float));
-
-                // Add to sum
-                for (auto v = buffer.begin(); v != buffer.end(); ++v) {
-                    stdDev += pow(*v - brickAvg, 2.f);
+            for (unsigned int leafBrick : leafBricksCovered) {
+                const float* data = brickData(leafBrick);
+                for (unsigned int v = 0; v < numBrickVals; ++v) {
+                    stdDev += pow(data[v] - brickAvg, 2.f);
                 }
             }
 
@@ -345,19 +363,8 @@ bool TSP::calculateSpatialError() {
             stdDev = sqrt(stdDev);
         } // if not leaf
 
-        if (stdDev < minError) {
-            minError = stdDev;
-        }
-        else if (stdDev > maxError) {
-            maxError = stdDev;
-        }
-
         stdDevs[brick] = stdDev;
-        medianArray[brick] = stdDev;
-    }
-
-    std::sort(medianArray.begin(), medianArray.end());
-    //float medError = medianArray[medianArray.size()/2];
+    });
 
     // "Normalize" errors
     float minNorm = 1e20f;
@@ -392,39 +399,23 @@ bool TSP::calculateSpatialError() {
 }
 
 bool TSP::calculateTemporalError() {
-    if (!_file.is_open()) {
+    if (!_mappedFile) {
         return false;
     }
 
     LDEBUG("Calculating temporal error");
 
-    // Statistics
-    //float minErr = 1e20f;
-    //float maxErr = 0.f;
-    std::vector<float> meanArray(_numTotalNodes);
-
     // Save errors
     std::vector<float> errors(_numTotalNodes);
 
     // Calculate temporal error for one brick at a time
-    for (unsigned int brick = 0; brick<_numTotalNodes; ++brick) {
+    parallelFor(_numTotalNodes, [&](unsigned int brick) {
         unsigned int numBrickVals = _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
 
-        // Save the individual voxel's average over timesteps. Because the
-        // BSTs are built by averaging leaf nodes, we only need to sample
-        // the brick at the correct coordinate.
-        std::vector<float> voxelAverages(numBrickVals);
-        std::vector<float> voxelStdDevs(numBrickVals);
-
-        // Read the whole brick to fill the averages
-        std::streampos offset = dataPosition() +
-                                static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(
-            reinterpret_cast<char*>(voxelAverages.data()),
-            static_cast<size_t>(numBrickVals)*sizeof(float)
-        );
+        // The individual voxel's average over timesteps. Because the BSTs are built by
+        // averaging leaf nodes, we only need to sample the brick at the correct
+        // coordinate.
+        const float* voxelAverages = brickData(brick);
 
         // Build a list of the BST leaf bricks (within the same octree level) that
         // this brick covers
@@ -437,24 +428,19 @@ bool TSP::calculateTemporalError() {
         if (coveredBricks.size() == 1) {
             errors[brick] = -0.1f;
         } else {
+            std::vector<const float*> leaves;
+            leaves.reserve(coveredBricks.size());
+            for (unsigned int leaf : coveredBricks) {
+                leaves.push_back(brickData(leaf));
+            }
+
             // Calculate standard deviation per voxel, average over brick
             float avgStdDev = 0.f;
             for (unsigned int voxel = 0; voxel<numBrickVals; ++voxel) {
                 float stdDev = 0.f;
-                for (auto leaf = coveredBricks.begin();
-                    leaf != coveredBricks.end(); ++leaf)
-                {
+                for (const float* leaf : leaves) {
                     // Sample the leaves at the corresponding voxel position
-                    _file.seekg(dataPosition() +
-                        static_cast<long long>(
-                            (*leaf * numBrickVals + voxel) * sizeof(float)
-                        )
-                    );
-
-                    float sample;
-                    _file.read(reinterpret_cast<char*>(&sample), sizeof(float));
-
-                    stdDev += pow(sample - voxelAverages[voxel], 2.f);
+                    stdDev += pow(leaf[voxel] - voxelAverages[voxel], 2.f);
                 }
                 stdDev /= static_cast<float>(coveredBricks.size());
                 stdDev = sqrt(stdDev);
@@ -463,13 +449,9 @@ bool TSP::calculateTemporalError() {
             } // for voxel
 
             avgStdDev /= static_cast<float>(numBrickVals);
-            meanArray[brick] = avgStdDev;
             errors[brick] = avgStdDev;
         }
-    } // for all bricks
-
-    std::sort(meanArray.begin(), meanArray.end());
-    //float medErr = meanArray[meanArray.size()/2];
+    }); // for all bricks
 
     // Adjust errors using user-provided exponents
     float minNorm = 1e20f;
@@ -518,6 +500,27 @@ bool TSP::readCache() {
         return false;
     }
 
+    // Validate the cache against the data file before reading the payload
+    int8_t version = 0;
+    file.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (version != CurrentCacheVersion) {
+        LINFO(fmt::format("Cache {} has an outdated version", cacheFilename));
+        return false;
+    }
+
+    Header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(Header));
+    uint64_t dataFileSize = 0;
+    file.read(reinterpret_cast<char*>(&dataFileSize), sizeof(uint64_t));
+    _file.clear();
+    _file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(_file.tellg());
+    if (!file.good() || std::memcmp(&header, &_header, sizeof(Header)) != 0 ||
+        dataFileSize != fileSize)
+    {
+        LINFO(fmt::format("Cache {} does not match {}", cacheFilename, _filename));
+        return false;
+    }
 
     file.read(reinterpret_cast<char*>(&_minSpatialError), sizeof(float));
     file.read(reinterpret_cast<char*>(&_maxSpatialError), sizeof(float));
@@ -559,6 +562,13 @@ bool TSP::writeCache() {
     }
     LINFO(fmt::format("Writing cache to {}", cacheFilename));
 
+    file.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+    file.write(reinterpret_cast<const char*>(&_header), sizeof(Header));
+    _file.clear();
+    _file.seekg(0, std::ios::end);
+    const uint64_t dataFileSize = static_cast<uint64_t>(_file.tellg());
+    file.write(reinterpret_cast<const char*>(&dataFileSize), sizeof(uint64_t));
+
     file.write(reinterpret_cast<char*>(&_minSpatialError), sizeof(float));
     file.write(reinterpret_cast<char*>(&_maxSpatialError), sizeof(float));
     file.write(reinterpret_cast<char*>(&_medianSpatialError), sizeof(float));
@@ -572,6 +582,97 @@ bool TSP::writeCache() {
     return true;
 }
 
+bool TSP::mapFile() {
+    unmapFile();
+
+#ifdef WIN32
+    HANDLE file = CreateFileA(
+        _filename.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    _fileHandle = file;
+    _mappingHandle = mapping;
+    _mappedFileSize = static_cast<size_t>(size.QuadPart);
+#else // WIN32
+    const int file = open(_filename.c_str(), O_RDONLY);
+    if (file == -1) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) == -1) {
+        close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    // The mapping keeps a reference to the file, so the descriptor is not needed
+    close(file);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    _mappedFileSize = static_cast<size_t>(info.st_size);
+#endif // WIN32
+    _mappedFile = reinterpret_cast<const char*>(data);
+
+    const size_t nBrickVals = _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
+    const size_t requiredSize = dataPosition() +
+        static_cast<size_t>(_numTotalNodes) * nBrickVals * sizeof(float);
+    if (_mappedFileSize < requiredSize) {
+        LERROR(fmt::format(
+            "{} is too small: expected {} bytes, got {}",
+            _filename, requiredSize, _mappedFileSize
+        ));
+        unmapFile();
+        return false;
+    }
+    return true;
+}
+
+void TSP::unmapFile() {
+    if (!_mappedFile) {
+        return;
+    }
+
+#ifdef WIN32
+    UnmapViewOfFile(_mappedFile);
+    CloseHandle(_mappingHandle);
+    CloseHandle(_fileHandle);
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+#else // WIN32
+    munmap(const_cast<char*>(_mappedFile), _mappedFileSize);
+#endif // WIN32
+    _mappedFile = nullptr;
+    _mappedFileSize = 0;
+}
+
+const float* TSP::brickData(unsigned int brickIndex) const {
+    ghoul_assert(_mappedFile, "Data file must be mapped");
+    const size_t nBrickVals = _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
+    return reinterpret_cast<const float*>(_mappedFile + dataPosition()) +
+        static_cast<size_t>(brickIndex) * nBrickVals;
+}
+
 float TSP::spatialError(unsigned int brickIndex) const {
     return reinterpret_cast<const float&>(_data[brickIndex*NUM_DATA + SPATIAL_ERR]);
 }
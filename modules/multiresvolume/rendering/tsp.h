@@ -70,6 +70,7 @@ public:
 
     const Header& header() const;
     static long long dataPosition();
+    const std::string& filename() const;
     std::ifstream& file();
     unsigned int numTotalNodes() const;
     unsigned int numValuesPerNode() const;
@@ -108,10 +109,23 @@ private:
     // Return a list of eight children brick incices given a brick index
     std::list<unsigned int> childBricks(unsigned int brickIndex);
 
+    // Maps the data file into memory so that the error metrics can be computed from
+    // multiple threads without having to seek through the file stream
+    bool mapFile();
+    void unmapFile();
+    const float* brickData(unsigned int brickIndex) const;
+
     std::string _filename;
     std::ifstream _file;
     std::streampos _dataOffset;
 
+    const char* _mappedFile = nullptr;
+    size_t _mappedFileSize = 0;
+#ifdef WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif // WIN32
+
     // Holds the actual structure
     std::vector<int> _data;
     GLuint _dataSSBO = 0;
@@ -36,6 +36,14 @@ uniform ivec3 nBricksInAtlas_#{id};
 uniform ivec3 atlasSize_#{id};
 uniform float stepSizeCoefficient_#{id} = 1.0;
 
+// The pre-integrated transfer function, which is indexed by the intensities at the front
+// and the back of a ray segment
+uniform bool usePreintegration_#{id} = false;
+uniform sampler2D preintegrationTable_#{id};
+
+// The intensity of the previous sample, or a negative number for the first sample
+float previousIntensity#{id} = -1.0;
+
 void atlasMapDataFunction_#{id}(ivec3 brickCoords, inout uint atlasIntCoord,
                                 inout uint level)
 {
@@ -95,7 +103,16 @@ void sample#{id}(vec3 samplePos, vec3 dir, inout vec3 accumulatedColor,
         //intensity = sampleCoords;
         maxStepSize = stepSizeCoefficient_#{id}/float(maxNumBricksPerAxis_#{id})/float(paddedBrickDim_#{id});
         //return vec4(vec3(intensity), 1.0);
-        vec4 contribution = texture(transferFunction_#{id}, intensity);
+        vec4 contribution;
+        if (usePreintegration_#{id} && previousIntensity#{id} >= 0.0) {
+            contribution = texture(
+                preintegrationTable_#{id},
+                vec2(previousIntensity#{id}, intensity)
+            );
+        } else {
+            contribution = texture(transferFunction_#{id}, intensity);
+        }
+        previousIntensity#{id} = clamp(intensity, 0.0, 1.0);
         contribution.a = 1.0 - pow(1.0 - contribution.a, maxStepSize);
         //contribution = vec4(sampleCoords, 1.0);
         //vec4 contribution = vec4(vec3(intensity), 1.0);
@@ -27,6 +27,7 @@
 
 #include <ghoul/misc/templatefactory.h>
 #include <openspace/json.h>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <thread>
@@ -41,6 +42,13 @@ class Topic;
 
 class Connection {
 public:
+    /// The encoding of the messages that are exchanged with the client
+    enum class Format {
+        Json = 0,
+        MessagePack,
+        Cbor
+    };
+
     Connection(
         std::unique_ptr<ghoul::io::Socket> s,
         std::string address,
@@ -52,10 +60,34 @@ public:
     void sendMessage(const std::string& message);
     void handleJson(const nlohmann::json& json);
     void sendJson(const nlohmann::json& json);
+
+    /// Encodes the \p json in the current #format of this connection
+    std::string encodeJson(const nlohmann::json& json) const;
+
+    /**
+     * Sends the \p message on behalf of the topic \p topicId and remembers when it was
+     * sent, which is used by #isThrottled
+     */
+    void sendTopicMessage(TopicId topicId, const std::string& message);
+
+    /**
+     * Returns \c true if the last message for the topic \p topicId was sent using
+     * #sendTopicMessage less than \p interval ago
+     */
+    bool isThrottled(TopicId topicId, std::chrono::milliseconds interval) const;
+
+    void sendPendingUpdates();
     void setAuthorized(bool status);
 
     bool isAuthorized() const;
 
+    /**
+     * Sets the format of all messages that are sent to, and expected from, the client.
+     * Incoming JSON text messages are accepted regardless of the format
+     */
+    void setFormat(Format format);
+    Format format() const;
+
     ghoul::io::Socket* socket();
     std::thread& thread();
     void setThread(std::thread&& thread);
@@ -68,6 +100,7 @@ private:
 
     std::string _address;
     bool _isAuthorized = false;
+    Format _format = Format::Json;
     std::map<TopicId, std::string> _messageQueue;
     std::map<TopicId, std::chrono::system_clock::time_point> _sentMessages;
 };
@@ -0,0 +1,103 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_MODULE_SERVER___METRICSCOLLECTOR___H__
+#define __OPENSPACE_MODULE_SERVER___METRICSCOLLECTOR___H__
+
+#include <openspace/properties/propertyowner.h>
+
+#include <openspace/json.h>
+#include <openspace/properties/scalar/boolproperty.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The MetricsCollector gathers the performance data that is exported through the
+ * MetricsTopic, so that show machines can be monitored remotely. The frame times, and
+ * optionally the time spent in each TraceZone, are sampled every frame by #update, which
+ * only stores a few numbers. Everything else is only read from the engine and the
+ * modules when the metrics are requested, so the collection is cheap enough to be left
+ * running during a show.
+ */
+class MetricsCollector : public properties::PropertyOwner {
+public:
+    MetricsCollector();
+    ~MetricsCollector();
+
+    /// Samples the metrics of the last frame. Has to be called once per frame on the
+    /// main thread
+    void update();
+
+    /**
+     * Returns the current metrics in the OpenMetrics text format, which can be ingested
+     * by Prometheus and other monitoring systems.
+     */
+    std::string openMetrics() const;
+
+    /**
+     * Returns the current metrics as a JSON object that contains one entry per metric
+     * family with its type and all of its samples.
+     */
+    nlohmann::json json() const;
+
+private:
+    struct Sample {
+        /// Appended to the name of the family, for example "_sum" or "_total"
+        std::string suffix;
+        std::vector<std::pair<std::string, std::string>> labels;
+        double value = 0.0;
+    };
+
+    struct Family {
+        std::string name;
+        std::string type;
+        std::string help;
+        std::vector<Sample> samples;
+    };
+
+    /// Gathers all metrics that are currently known and passes them to \p callback
+    void collect(const std::function<void(const Family&)>& callback) const;
+
+    /// The frame times in milliseconds of the last frames, used as a ring buffer
+    std::vector<double> _frameTimes;
+    size_t _nextFrameTime = 0;
+    double _frameTimeSum = 0.0;
+    uint64_t _nFrames = 0;
+
+    struct PhaseTiming {
+        double sum = 0.0;
+        uint64_t count = 0;
+    };
+    std::map<std::string, PhaseTiming, std::less<>> _phaseTimings;
+
+    properties::BoolProperty _collectPhaseTimings;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___METRICSCOLLECTOR___H__
@@ -0,0 +1,56 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_MODULE_SERVER___METRICS_TOPIC___H__
+#define __OPENSPACE_MODULE_SERVER___METRICS_TOPIC___H__
+
+#include <modules/server/include/topics/topic.h>
+#include <chrono>
+
+namespace openspace {
+
+/**
+ * Exports the metrics of the MetricsCollector, either once or, with a subscription,
+ * periodically with the requested interval. The metrics are either sent in the
+ * OpenMetrics text format, so that they can be forwarded to Prometheus as they are, or
+ * as a JSON object.
+ */
+class MetricsTopic : public Topic {
+public:
+    virtual ~MetricsTopic() = default;
+
+    void handleJson(const nlohmann::json& json) override;
+    bool isDone() const override;
+    void sendPendingUpdates() override;
+
+private:
+    void sendMetrics();
+
+    bool _isDone = false;
+    bool _isOpenMetrics = true;
+    std::chrono::milliseconds _interval = std::chrono::milliseconds(1000);
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___METRICS_TOPIC___H__
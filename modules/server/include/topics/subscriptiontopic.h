@@ -27,6 +27,8 @@
 
 #include <modules/server/include/topics/topic.h>
 
+#include <chrono>
+
 namespace openspace::properties { class Property; }
 
 namespace openspace {
@@ -38,17 +40,24 @@ public:
 
     void handleJson(const nlohmann::json& json) override;
     bool isDone() const override;
+    void sendPendingUpdates() override;
 
 private:
     void resetCallbacks();
+    void sendValue();
 
     const int UnsetCallbackHandle = -1;
 
     bool _requestedResourceIsSubscribable = false;
     bool _isSubscribedTo = false;
+    bool _hasPendingUpdate = false;
     int _onChangeHandle = UnsetCallbackHandle;
     int _onDeleteHandle = UnsetCallbackHandle;
     properties::Property* _prop = nullptr;
+
+    // Updates to this topic are sent at most once per this interval, as requested by
+    // the client. The last value is always sent once the interval has passed
+    std::chrono::milliseconds _throttleInterval = std::chrono::milliseconds(0);
 };
 
 } // namespace openspace
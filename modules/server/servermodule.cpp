@@ -30,6 +30,7 @@
 #include <openspace/engine/globalscallbacks.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
+#include <openspace/rendering/renderengine.h>
 #include <ghoul/fmt.h>
 #include <ghoul/io/socket/socket.h>
 #include <ghoul/io/socket/tcpsocketserver.h>
@@ -49,6 +50,7 @@ ServerModule::ServerModule()
     , _interfaceOwner({"Interfaces", "Interfaces", "Server Interfaces"})
 {
     addPropertySubOwner(_interfaceOwner);
+    addPropertySubOwner(_metricsCollector);
 }
 
 ServerModule::~ServerModule() {
@@ -71,6 +73,10 @@ ServerInterface* ServerModule::serverInterfaceByIdentifier(const std::string& id
     return si->get();
 }
 
+const MetricsCollector& ServerModule::metricsCollector() const {
+    return _metricsCollector;
+}
+
 void ServerModule::internalInitialize(const ghoul::Dictionary& configuration) {
     global::callback::preSync.emplace_back([this]() { preSync(); });
 
@@ -103,6 +109,8 @@ void ServerModule::preSync() {
         return;
     }
 
+    _metricsCollector.update();
+
     // Set up new connections.
     for (std::unique_ptr<ServerInterface>& serverInterface : _interfaces) {
         if (!serverInterface->isEnabled()) {
@@ -142,6 +150,14 @@ void ServerModule::preSync() {
     // Consume all messages put into the message queue by the socket threads.
     consumeMessages();
 
+    // Send the updates that the topics have collected since the last frame.
+    for (ConnectionData& connectionData : _connections) {
+        Connection& connection = *connectionData.connection;
+        if (connection.socket() && connection.socket()->isConnected()) {
+            connection.sendPendingUpdates();
+        }
+    }
+
     // Join threads for sockets that disconnected.
     cleanUpFinishedThreads();
 }
@@ -192,6 +208,11 @@ void ServerModule::handleConnection(std::shared_ptr<Connection> connection) {
 
 void ServerModule::consumeMessages() {
     std::lock_guard<std::mutex> lock(_messageQueueMutex);
+    if (!_messageQueue.empty()) {
+        // The messages might change the rendered image in ways that are not reflected
+        // in a property, for example by moving the camera of a paused simulation
+        global::renderEngine.requestRedraw();
+    }
     while (!_messageQueue.empty()) {
         const Message& m = _messageQueue.front();
         if (std::shared_ptr<Connection> c = m.connection.lock()) {
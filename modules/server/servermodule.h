@@ -27,6 +27,7 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/server/include/metricscollector.h>
 #include <modules/server/include/serverinterface.h>
 
 #include <deque>
@@ -55,6 +56,8 @@ public:
 
     ServerInterface* serverInterfaceByIdentifier(const std::string& identifier);
 
+    const MetricsCollector& metricsCollector() const;
+
 protected:
     void internalInitialize(const ghoul::Dictionary& configuration) override;
 
@@ -76,6 +79,7 @@ private:
     std::vector<ConnectionData> _connections;
     std::vector<std::unique_ptr<ServerInterface>> _interfaces;
     properties::PropertyOwner _interfaceOwner;
+    MetricsCollector _metricsCollector;
 };
 
 } // namespace openspace
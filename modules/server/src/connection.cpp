@@ -27,8 +27,10 @@
 #include <modules/server/include/topics/authorizationtopic.h>
 #include <modules/server/include/topics/bouncetopic.h>
 #include <modules/server/include/topics/documentationtopic.h>
+#include <modules/server/include/topics/formattopic.h>
 #include <modules/server/include/topics/getpropertytopic.h>
 #include <modules/server/include/topics/luascripttopic.h>
+#include <modules/server/include/topics/metricstopic.h>
 #include <modules/server/include/topics/sessionrecordingtopic.h>
 #include <modules/server/include/topics/setpropertytopic.h>
 #include <modules/server/include/topics/shortcuttopic.h>
@@ -43,6 +45,7 @@
 #include <ghoul/io/socket/tcpsocketserver.h>
 #include <ghoul/io/socket/websocketserver.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <fmt/format.h>
 
 namespace {
@@ -55,8 +58,10 @@ namespace {
     constexpr const char* VersionTopicKey = "version";
     constexpr const char* AuthenticationTopicKey = "authorize";
     constexpr const char* DocumentationTopicKey = "documentation";
+    constexpr const char* FormatTopicKey = "format";
     constexpr const char* GetPropertyTopicKey = "get";
     constexpr const char* LuaScriptTopicKey = "luascript";
+    constexpr const char* MetricsTopicKey = "metrics";
     constexpr const char* SessionRecordingTopicKey = "sessionRecording";
     constexpr const char* SetPropertyTopicKey = "set";
     constexpr const char* ShortcutTopicKey = "shortcuts";
@@ -64,6 +69,23 @@ namespace {
     constexpr const char* TimeTopicKey = "time";
     constexpr const char* TriggerPropertyTopicKey = "trigger";
     constexpr const char* BounceTopicKey = "bounce";
+
+    nlohmann::json parseMessage(const std::string& message,
+                                openspace::Connection::Format format)
+    {
+        using Format = openspace::Connection::Format;
+
+        // A top-level message is always an object, and no object in MessagePack or CBOR
+        // starts with '{', so JSON text can be told apart from the binary formats
+        if (format == Format::Json || (!message.empty() && message.front() == '{')) {
+            return nlohmann::json::parse(message.c_str());
+        }
+
+        const std::vector<uint8_t> bytes(message.begin(), message.end());
+        return format == Format::MessagePack ?
+            nlohmann::json::from_msgpack(bytes) :
+            nlohmann::json::from_cbor(bytes);
+    }
 } // namespace
 
 namespace openspace {
@@ -86,8 +108,10 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s,
     );
 
     _topicFactory.registerClass<DocumentationTopic>(DocumentationTopicKey);
+    _topicFactory.registerClass<FormatTopic>(FormatTopicKey);
     _topicFactory.registerClass<GetPropertyTopic>(GetPropertyTopicKey);
     _topicFactory.registerClass<LuaScriptTopic>(LuaScriptTopicKey);
+    _topicFactory.registerClass<MetricsTopic>(MetricsTopicKey);
     _topicFactory.registerClass<SessionRecordingTopic>(SessionRecordingTopicKey);
     _topicFactory.registerClass<SetPropertyTopic>(SetPropertyTopicKey);
     _topicFactory.registerClass<ShortcutTopic>(ShortcutTopicKey);
@@ -100,7 +124,7 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s,
 
 void Connection::handleMessage(const std::string& message) {
     try {
-        nlohmann::json j = nlohmann::json::parse(message.c_str());
+        nlohmann::json j = parseMessage(message, _format);
         try {
             handleJson(j);
         } catch (const std::domain_error& e) {
@@ -186,6 +210,7 @@ void Connection::handleJson(const nlohmann::json& json) {
         topic.handleJson(*payloadJson);
         if (topic.isDone()) {
             _topics.erase(topicIt);
+            _sentMessages.erase(topicId);
         }
     }
 }
@@ -195,13 +220,58 @@ void Connection::sendMessage(const std::string& message) {
 }
 
 void Connection::sendJson(const nlohmann::json& json) {
-    sendMessage(json.dump());
+    sendMessage(encodeJson(json));
+}
+
+std::string Connection::encodeJson(const nlohmann::json& json) const {
+    switch (_format) {
+        case Format::Json:
+            return json.dump();
+        case Format::MessagePack: {
+            const std::vector<uint8_t> bytes = nlohmann::json::to_msgpack(json);
+            return std::string(bytes.begin(), bytes.end());
+        }
+        case Format::Cbor: {
+            const std::vector<uint8_t> bytes = nlohmann::json::to_cbor(json);
+            return std::string(bytes.begin(), bytes.end());
+        }
+        default:
+            throw ghoul::MissingCaseException();
+    }
+}
+
+void Connection::sendTopicMessage(TopicId topicId, const std::string& message) {
+    sendMessage(message);
+    _sentMessages[topicId] = std::chrono::system_clock::now();
+}
+
+bool Connection::isThrottled(TopicId topicId, std::chrono::milliseconds interval) const {
+    if (interval.count() <= 0) {
+        return false;
+    }
+    auto it = _sentMessages.find(topicId);
+    return it != _sentMessages.end() &&
+           std::chrono::system_clock::now() - it->second < interval;
+}
+
+void Connection::sendPendingUpdates() {
+    for (const std::pair<const TopicId, std::unique_ptr<Topic>>& topic : _topics) {
+        topic.second->sendPendingUpdates();
+    }
 }
 
 bool Connection::isAuthorized() const {
     return _isAuthorized;
 }
 
+void Connection::setFormat(Format format) {
+    _format = format;
+}
+
+Connection::Format Connection::format() const {
+    return _format;
+}
+
 void Connection::setThread(std::thread&& thread) {
     _thread = std::move(thread);
 }
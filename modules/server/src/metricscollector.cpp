@@ -0,0 +1,402 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <modules/server/include/metricscollector.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/engine/syncengine.h>
+#include <openspace/engine/windowdelegate.h>
+#include <openspace/performance/performancemanager.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/scene/scene.h>
+#include <openspace/scene/scenegraphnode.h>
+#include <openspace/util/memorybudget.h>
+#include <ghoul/fmt.h>
+#include <algorithm>
+#include <numeric>
+
+#ifdef OPENSPACE_MODULE_GAIA_ENABLED
+#include <modules/gaia/rendering/renderablegaiastars.h>
+#endif // OPENSPACE_MODULE_GAIA_ENABLED
+
+#ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
+#include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/src/lruthreadpool.h>
+#include <modules/globebrowsing/src/memoryawaretilecache.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <openspace/engine/moduleengine.h>
+#endif // OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
+
+namespace {
+    // The frame time percentiles are computed over this many of the most recent frames
+    constexpr const size_t NumFrameTimes = 1000;
+
+    constexpr const double Quantiles[] = { 0.5, 0.9, 0.99 };
+
+    constexpr openspace::properties::Property::PropertyInfo CollectPhaseTimingsInfo = {
+        "CollectPhaseTimings",
+        "Collect Phase Timings",
+        "If this value is enabled, the time spent in each traced phase of the main "
+        "thread is summed up every frame and exported as part of the metrics. The "
+        "collection of the phases makes the traced zones a bit more expensive, so it is "
+        "disabled by default."
+    };
+
+    std::string escapeLabelValue(const std::string& value) {
+        std::string result;
+        result.reserve(value.size());
+        for (char c : value) {
+            switch (c) {
+                case '\\': result += "\\\\"; break;
+                case '"':  result += "\\\""; break;
+                case '\n': result += "\\n";  break;
+                default:   result += c;      break;
+            }
+        }
+        return result;
+    }
+} // namespace
+
+namespace openspace {
+
+MetricsCollector::MetricsCollector()
+    : properties::PropertyOwner({ "Metrics" })
+    , _collectPhaseTimings(CollectPhaseTimingsInfo, false)
+{
+    _frameTimes.reserve(NumFrameTimes);
+
+    _collectPhaseTimings.onChange([this]() {
+        if (!_collectPhaseTimings) {
+            global::performanceManager.setLiveFrameTimesEnabled(false);
+        }
+        _phaseTimings.clear();
+    });
+    addProperty(_collectPhaseTimings);
+}
+
+MetricsCollector::~MetricsCollector() {} // NOLINT
+
+void MetricsCollector::update() {
+    const double frameTime = global::windowDelegate.deltaTime() * 1000.0;
+    if (_frameTimes.size() < NumFrameTimes) {
+        _frameTimes.push_back(frameTime);
+    }
+    else {
+        _frameTimes[_nextFrameTime] = frameTime;
+    }
+    _nextFrameTime = (_nextFrameTime + 1) % NumFrameTimes;
+    _frameTimeSum += frameTime;
+    ++_nFrames;
+
+    if (_collectPhaseTimings) {
+        // Someone else might have disabled the live frame times in the meantime. They
+        // only take effect from the next frame onwards
+        global::performanceManager.setLiveFrameTimesEnabled(true);
+
+        using FrameZone = performance::PerformanceManager::FrameZone;
+        for (const FrameZone& zone : global::performanceManager.lastFrame().zones) {
+            auto it = _phaseTimings.find(zone.name);
+            if (it == _phaseTimings.end()) {
+                it = _phaseTimings.emplace(zone.name, PhaseTiming()).first;
+            }
+            it->second.sum += zone.duration;
+            ++it->second.count;
+        }
+    }
+}
+
+void MetricsCollector::collect(const std::function<void(const Family&)>& callback) const
+{
+    {
+        Family frameTime = {
+            "openspace_frame_time_milliseconds",
+            "summary",
+            "The duration of the frames on the master node",
+            {}
+        };
+
+        std::vector<double> times = _frameTimes;
+        for (double q : Quantiles) {
+            if (times.empty()) {
+                break;
+            }
+            const size_t n = std::min(
+                static_cast<size_t>(q * times.size()),
+                times.size() - 1
+            );
+            std::nth_element(times.begin(), times.begin() + n, times.end());
+            frameTime.samples.push_back(
+                { "", { { "quantile", fmt::format("{}", q) } }, times[n] }
+            );
+        }
+        frameTime.samples.push_back({ "_sum", {}, _frameTimeSum });
+        frameTime.samples.push_back({ "_count", {}, static_cast<double>(_nFrames) });
+        callback(frameTime);
+    }
+
+    if (!_phaseTimings.empty()) {
+        Family phases = {
+            "openspace_phase_time_milliseconds",
+            "summary",
+            "The time spent in the traced phases of the main thread",
+            {}
+        };
+        for (const std::pair<const std::string, PhaseTiming>& p : _phaseTimings) {
+            phases.samples.push_back({ "_sum", { { "phase", p.first } }, p.second.sum });
+            phases.samples.push_back({
+                "_count",
+                { { "phase", p.first } },
+                static_cast<double>(p.second.count)
+            });
+        }
+        callback(phases);
+    }
+
+    {
+        Family usage = {
+            "openspace_memory_usage_bytes",
+            "gauge",
+            "The memory that is used by the caches registered with the memory budget",
+            {}
+        };
+        Family budget = {
+            "openspace_memory_budget_bytes",
+            "gauge",
+            "The memory budget of the caches, 0 if the budget is unlimited",
+            {}
+        };
+        using Resource = MemoryBudget::Resource;
+        for (Resource r : { Resource::Cpu, Resource::Gpu }) {
+            const std::string resource = (r == Resource::Cpu) ? "cpu" : "gpu";
+            usage.samples.push_back({
+                "",
+                { { "resource", resource } },
+                static_cast<double>(global::memoryBudget.usage(r))
+            });
+            budget.samples.push_back({
+                "",
+                { { "resource", resource } },
+                static_cast<double>(global::memoryBudget.budget(r))
+            });
+        }
+        callback(usage);
+        callback(budget);
+    }
+
+    {
+        const std::vector<size_t> sizes = global::syncEngine.encodedSizes();
+        const size_t encodedSize = std::accumulate(sizes.begin(), sizes.end(), size_t(0));
+        callback({
+            "openspace_sync_frame_bytes",
+            "gauge",
+            "The size of the last synchronization frame sent to the cluster nodes",
+            { { "", {}, static_cast<double>(global::syncEngine.frameSize()) } }
+        });
+        callback({
+            "openspace_sync_encoded_bytes",
+            "gauge",
+            "The size of the encoded state of all synchronized objects before the "
+            "changes and the compression are taken into account",
+            { { "", {}, static_cast<double>(encodedSize) } }
+        });
+    }
+
+#ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
+    {
+        using namespace globebrowsing;
+
+        GlobeBrowsingModule* module = global::moduleEngine.module<GlobeBrowsingModule>();
+        const cache::MemoryAwareTileCache* tileCache = module->tileCache();
+        if (tileCache) {
+            const cache::MemoryAwareTileCache::ProviderStatistics stats =
+                tileCache->totalStatistics();
+            callback({
+                "openspace_tile_cache_hits",
+                "counter",
+                "The number of tiles that were found in the tile cache",
+                { { "_total", {}, static_cast<double>(stats.nHits) } }
+            });
+            callback({
+                "openspace_tile_cache_misses",
+                "counter",
+                "The number of tiles that were not found in the tile cache",
+                { { "_total", {}, static_cast<double>(stats.nMisses) } }
+            });
+            callback({
+                "openspace_tile_cache_evictions",
+                "counter",
+                "The number of tiles that were evicted from the tile cache",
+                { { "_total", {}, static_cast<double>(stats.nEvictions) } }
+            });
+            callback({
+                "openspace_tile_cache_bytes",
+                "gauge",
+                "The memory that is allocated by the tile cache",
+                {
+                    {
+                        "",
+                        { { "resource", "cpu" } },
+                        static_cast<double>(tileCache->cpuAllocatedDataSize())
+                    },
+                    {
+                        "",
+                        { { "resource", "gpu" } },
+                        static_cast<double>(tileCache->gpuAllocatedDataSize())
+                    }
+                }
+            });
+            callback({
+                "openspace_tile_upload_queue_depth",
+                "gauge",
+                "The number of tiles that are waiting to be uploaded to the GPU",
+                { { "", {}, static_cast<double>(tileCache->nQueuedUploads()) } }
+            });
+        }
+
+        callback({
+            "openspace_tile_request_queue_depth",
+            "gauge",
+            "The number of tile requests that are waiting to be read",
+            { {
+                "",
+                {},
+                static_cast<double>(
+                    LRUThreadPool<TileIndex::TileHashKey>::totalQueuedTasks()
+                )
+            } }
+        });
+    }
+#endif // OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
+
+#ifdef OPENSPACE_MODULE_GAIA_ENABLED
+    {
+        Family inRam = {
+            "openspace_gaia_nodes_in_ram",
+            "gauge",
+            "The number of octree nodes that have been streamed into RAM",
+            {}
+        };
+        Family inBuffer = {
+            "openspace_gaia_nodes_in_buffer",
+            "gauge",
+            "The number of octree nodes that are uploaded to the GPU",
+            {}
+        };
+        Family pendingFetches = {
+            "openspace_gaia_pending_fetches",
+            "gauge",
+            "The number of octree nodes that are waiting to be streamed from disk",
+            {}
+        };
+
+        const Scene* scene = global::renderEngine.scene();
+        if (scene) {
+            for (const SceneGraphNode* node : scene->allSceneGraphNodes()) {
+                const RenderableGaiaStars* gaia =
+                    dynamic_cast<const RenderableGaiaStars*>(node->renderable());
+                if (!gaia) {
+                    continue;
+                }
+
+                const OctreeManager& octree = gaia->octreeManager();
+                const std::vector<std::pair<std::string, std::string>> labels = {
+                    { "node", node->identifier() }
+                };
+                inRam.samples.push_back({
+                    "",
+                    labels,
+                    static_cast<double>(octree.numNodesInRam())
+                });
+                inBuffer.samples.push_back({
+                    "",
+                    labels,
+                    static_cast<double>(octree.numNodesInBuffer())
+                });
+                pendingFetches.samples.push_back({
+                    "",
+                    labels,
+                    static_cast<double>(octree.numPendingFetchRequests())
+                });
+            }
+        }
+
+        if (!inRam.samples.empty()) {
+            callback(inRam);
+            callback(inBuffer);
+            callback(pendingFetches);
+        }
+    }
+#endif // OPENSPACE_MODULE_GAIA_ENABLED
+}
+
+std::string MetricsCollector::openMetrics() const {
+    std::string result;
+    collect([&result](const Family& family) {
+        result += fmt::format("# TYPE {} {}\n", family.name, family.type);
+        result += fmt::format("# HELP {} {}\n", family.name, family.help);
+        for (const Sample& sample : family.samples) {
+            result += family.name + sample.suffix;
+            if (!sample.labels.empty()) {
+                result += '{';
+                for (size_t i = 0; i < sample.labels.size(); ++i) {
+                    result += fmt::format(
+                        "{}{}=\"{}\"",
+                        i > 0 ? "," : "",
+                        sample.labels[i].first,
+                        escapeLabelValue(sample.labels[i].second)
+                    );
+                }
+                result += '}';
+            }
+            result += fmt::format(" {}\n", sample.value);
+        }
+    });
+    result += "# EOF\n";
+    return result;
+}
+
+nlohmann::json MetricsCollector::json() const {
+    nlohmann::json result = nlohmann::json::object();
+    collect([&result](const Family& family) {
+        nlohmann::json samples = nlohmann::json::array();
+        for (const Sample& sample : family.samples) {
+            nlohmann::json labels = nlohmann::json::object();
+            for (const std::pair<std::string, std::string>& label : sample.labels) {
+                labels[label.first] = label.second;
+            }
+            samples.push_back({
+                { "name", family.name + sample.suffix },
+                { "labels", labels },
+                { "value", sample.value }
+            });
+        }
+        result[family.name] = {
+            { "type", family.type },
+            { "help", family.help },
+            { "samples", samples }
+        };
+    });
+    return result;
+}
+
+} // namespace openspace
@@ -0,0 +1,83 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/include/topics/formattopic.h>
+
+#include <modules/server/include/connection.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+
+namespace {
+    constexpr const char* _loggerCat = "FormatTopic";
+
+    constexpr const char* KeyFormat = "format";
+    constexpr const char* FormatJson = "json";
+    constexpr const char* FormatMessagePack = "msgpack";
+    constexpr const char* FormatCbor = "cbor";
+} // namespace
+
+namespace openspace {
+
+bool FormatTopic::isDone() const {
+    return true;
+}
+
+void FormatTopic::handleJson(const nlohmann::json& json) {
+    auto formatJson = json.find(KeyFormat);
+    if (formatJson == json.end() || !formatJson->is_string()) {
+        _connection->sendJson(wrappedError(
+            fmt::format("A format must be specified (`{}`) as a string", KeyFormat),
+            400
+        ));
+        return;
+    }
+
+    const std::string format = *formatJson;
+    Connection::Format f;
+    if (format == FormatJson) {
+        f = Connection::Format::Json;
+    }
+    else if (format == FormatMessagePack) {
+        f = Connection::Format::MessagePack;
+    }
+    else if (format == FormatCbor) {
+        f = Connection::Format::Cbor;
+    }
+    else {
+        LERROR(fmt::format("Unknown format '{}'", format));
+        _connection->sendJson(wrappedError(
+            fmt::format(
+                "Unknown format '{}'. Expected '{}', '{}', or '{}'",
+                format, FormatJson, FormatMessagePack, FormatCbor
+            ),
+            400
+        ));
+        return;
+    }
+
+    _connection->sendJson(wrappedPayload({ KeyFormat, format }));
+    _connection->setFormat(f);
+}
+
+} // namespace openspace
@@ -0,0 +1,117 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <modules/server/include/topics/metricstopic.h>
+
+#include <modules/server/servermodule.h>
+#include <modules/server/include/connection.h>
+#include <modules/server/include/metricscollector.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+
+namespace {
+    constexpr const char* _loggerCat = "MetricsTopic";
+
+    constexpr const char* EventKey = "event";
+    constexpr const char* FormatKey = "format";
+    constexpr const char* IntervalKey = "interval";
+
+    constexpr const char* GetEvent = "get";
+    constexpr const char* SubscribeEvent = "start_subscription";
+    constexpr const char* UnsubscribeEvent = "stop_subscription";
+
+    constexpr const char* OpenMetricsFormat = "openmetrics";
+    constexpr const char* JsonFormat = "json";
+
+    // Prevents a client from making the master collect the metrics every frame
+    constexpr const std::chrono::milliseconds MinimumInterval(100);
+} // namespace
+
+using nlohmann::json;
+
+namespace openspace {
+
+bool MetricsTopic::isDone() const {
+    return _isDone;
+}
+
+void MetricsTopic::handleJson(const nlohmann::json& json) {
+    const std::string event = json.value(EventKey, GetEvent);
+    if (event == UnsubscribeEvent) {
+        _isDone = true;
+        return;
+    }
+
+    const std::string format = json.value(FormatKey, OpenMetricsFormat);
+    if (format != OpenMetricsFormat && format != JsonFormat) {
+        LERROR(fmt::format("Unknown metrics format '{}'", format));
+        _connection->sendJson(wrappedError(fmt::format("Unknown format '{}'", format)));
+        _isDone = true;
+        return;
+    }
+    _isOpenMetrics = format == OpenMetricsFormat;
+
+    if (json.find(IntervalKey) != json.end()) {
+        _interval = std::max(
+            std::chrono::milliseconds(json.at(IntervalKey).get<int>()),
+            MinimumInterval
+        );
+    }
+
+    sendMetrics();
+
+    if (event != SubscribeEvent) {
+        _isDone = true;
+    }
+}
+
+void MetricsTopic::sendPendingUpdates() {
+    if (_isDone || _connection->isThrottled(_topicId, _interval)) {
+        return;
+    }
+    sendMetrics();
+}
+
+void MetricsTopic::sendMetrics() {
+    const MetricsCollector& collector =
+        global::moduleEngine.module<ServerModule>()->metricsCollector();
+
+    const nlohmann::json payload = _isOpenMetrics ?
+        nlohmann::json({
+            { FormatKey, OpenMetricsFormat },
+            { "metrics", collector.openMetrics() }
+        }) :
+        nlohmann::json({
+            { FormatKey, JsonFormat },
+            { "metrics", collector.json() }
+        });
+    _connection->sendTopicMessage(
+        _topicId,
+        _connection->encodeJson(wrappedPayload(payload))
+    );
+}
+
+} // namespace openspace
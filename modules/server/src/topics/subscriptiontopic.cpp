@@ -31,14 +31,93 @@
 #include <openspace/util/timemanager.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <array>
+#include <unordered_map>
 
 namespace {
     constexpr const char* _loggerCat = "SubscriptionTopic";
     constexpr const char* PropertyKey = "property";
     constexpr const char* EventKey = "event";
+    constexpr const char* ThrottleKey = "throttle";
 
     constexpr const char* StartSubscription = "start_subscription";
     constexpr const char* StopSubscription = "stop_subscription";
+
+    using Format = openspace::Connection::Format;
+
+    // The serialized values of the subscribed properties, one per wire format. A value
+    // is serialized once after each change and then shared by all subscribers of the
+    // same property
+    struct SerializedValue {
+        nlohmann::json value;
+        std::array<std::string, 3> encoded;
+    };
+    std::unordered_map<const openspace::properties::Property*, SerializedValue>
+        SerializedValues;
+
+    const std::string& serializedValue(const openspace::properties::Property* prop,
+                                       Format format)
+    {
+        auto it = SerializedValues.find(prop);
+        if (it == SerializedValues.end()) {
+            it = SerializedValues.emplace(prop, SerializedValue{ prop, {} }).first;
+        }
+
+        std::string& encoded = it->second.encoded[static_cast<int>(format)];
+        if (encoded.empty()) {
+            std::vector<uint8_t> bytes;
+            switch (format) {
+                case Format::Json:
+                    encoded = it->second.value.dump();
+                    return encoded;
+                case Format::MessagePack:
+                    bytes = nlohmann::json::to_msgpack(it->second.value);
+                    break;
+                case Format::Cbor:
+                    bytes = nlohmann::json::to_cbor(it->second.value);
+                    break;
+                default:
+                    throw ghoul::MissingCaseException();
+            }
+            encoded.assign(bytes.begin(), bytes.end());
+        }
+        return encoded;
+    }
+
+    // Produces the same message as encoding the {"payload":...,"topic":...} object, but
+    // splices in the already encoded payload rather than encoding it again
+    std::string wrappedValue(const std::string& payload, openspace::TopicId topicId,
+                             Format format)
+    {
+        if (format == Format::Json) {
+            return fmt::format(R"({{"payload":{},"topic":{}}})", payload, topicId);
+        }
+
+        const nlohmann::json topic = topicId;
+        const std::vector<uint8_t> id = format == Format::MessagePack ?
+            nlohmann::json::to_msgpack(topic) :
+            nlohmann::json::to_cbor(topic);
+
+        // A map with two entries and the two keys as short strings; the map and string
+        // headers are the same size in both formats
+        constexpr const char MessagePackHeader[] = { '\x82', '\xa7', '\xa5' };
+        constexpr const char CborHeader[] = { '\xa2', '\x67', '\x65' };
+        const char* header = format == Format::MessagePack ?
+            MessagePackHeader :
+            CborHeader;
+
+        std::string result;
+        result.reserve(payload.size() + id.size() + 15);
+        result += header[0];
+        result += header[1];
+        result += "payload";
+        result += payload;
+        result += header[2];
+        result += "topic";
+        result.append(id.begin(), id.end());
+        return result;
+    }
 } // namespace
 
 using nlohmann::json;
@@ -53,10 +132,35 @@ bool SubscriptionTopic::isDone() const {
     return !_requestedResourceIsSubscribable || !_isSubscribedTo;
 }
 
+void SubscriptionTopic::sendPendingUpdates() {
+    if (!_hasPendingUpdate || !_isSubscribedTo || !_prop) {
+        _hasPendingUpdate = false;
+        return;
+    }
+    if (_connection->isThrottled(_topicId, _throttleInterval)) {
+        // Keep the update pending so that the latest value is sent eventually
+        return;
+    }
+    sendValue();
+    _hasPendingUpdate = false;
+}
+
+void SubscriptionTopic::sendValue() {
+    // This produces the same message as sending wrappedPayload(_prop), whose keys are
+    // ordered alphabetically, without serializing the property again for each topic
+    const Format format = _connection->format();
+    _connection->sendTopicMessage(
+        _topicId,
+        wrappedValue(serializedValue(_prop, format), _topicId, format)
+    );
+}
+
 void SubscriptionTopic::resetCallbacks() {
     if (!_prop) {
         return;
     }
+    // Without our callback, the cached value would not be invalidated by changes anymore
+    SerializedValues.erase(_prop);
     if (_onChangeHandle != UnsetCallbackHandle) {
         _prop->removeOnChange(_onChangeHandle);
         _onChangeHandle = UnsetCallbackHandle;
@@ -76,22 +180,30 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
         _prop = property(key);
         resetCallbacks();
 
+        auto throttle = json.find(ThrottleKey);
+        if (throttle != json.end() && throttle->is_number()) {
+            _throttleInterval = std::chrono::milliseconds(throttle->get<int>());
+        }
+
         if (_prop) {
             _requestedResourceIsSubscribable = true;
             _isSubscribedTo = true;
-            auto onChange = [this, k = std::move(key)]() {
-                _connection->sendJson(wrappedPayload(_prop));
-            };
-
-            _onChangeHandle = _prop->onChange(onChange);
+            // A property can change many times during a frame, but only its last value
+            // is interesting, so the update is sent once per frame in sendPendingUpdates
+            _onChangeHandle = _prop->onChange([this]() {
+                SerializedValues.erase(_prop);
+                _hasPendingUpdate = true;
+            });
             _onDeleteHandle = _prop->onDelete([this]() {
+                SerializedValues.erase(_prop);
                 _onChangeHandle = UnsetCallbackHandle;
                 _onDeleteHandle = UnsetCallbackHandle;
                 _isSubscribedTo = false;
+                _hasPendingUpdate = false;
             });
 
             // immediately send the value
-            onChange();
+            sendValue();
         }
         else {
             LWARNING(fmt::format("Could not subscribe. Property '{}' not found", key));
@@ -99,6 +211,7 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
     }
     if (event == StopSubscription) {
         _isSubscribedTo = false;
+        SerializedValues.erase(_prop);
         if (_prop && _onChangeHandle != UnsetCallbackHandle) {
             _prop->removeOnChange(_onChangeHandle);
             _onChangeHandle = UnsetCallbackHandle;
@@ -0,0 +1,505 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/rendering/renderableorbitalkepler.h>
+
+#include <modules/space/spacemodule.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/util/spicemanager.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/opengl/programobject.h>
+#include <glm/gtx/transform.hpp>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    constexpr const char* _loggerCat = "RenderableOrbitalKepler";
+    constexpr const char* ProgramName = "OrbitalKeplerProgram";
+
+    constexpr const std::array<const char*, 10> UniformNames = {
+        "modelViewTransform", "projectionTransform", "time", "color", "opacity",
+        "lineFade", "trailLength", "nSegments", "pointSize", "renderPhase"
+    };
+
+    // Fragile! Keep in sync with the shaders
+    constexpr const int RenderPhaseLines = 0;
+    constexpr const int RenderPhasePoints = 1;
+
+    constexpr const int NElementsPerOrbit = 8;
+
+    constexpr openspace::properties::Property::PropertyInfo PathInfo = {
+        "Path",
+        "Path",
+        "This value is the path to the file that contains the orbital elements. Each "
+        "line contains the eccentricity, the semi-major axis (km), the inclination, the "
+        "right ascension of the ascending node, the argument of periapsis, the mean "
+        "anomaly at the epoch (all in degrees), the epoch and the orbital period (in "
+        "seconds) of one orbit, separated by commas. Empty lines and lines starting with "
+        "'#' are ignored."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ColorInfo = {
+        "Color",
+        "Color",
+        "This value determines the RGB main color for the lines and points of the orbits."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo LineWidthInfo = {
+        "LineWidth",
+        "Line Width",
+        "This value specifies the line width of the trails."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo LineFadeInfo = {
+        "Fade",
+        "Line fade",
+        "The fading factor that is applied to the trail from the current position of "
+        "the body backwards. A value of 1 fades the trail linearly, larger values fade "
+        "it out quicker and 0 disables the fading."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo TrailLengthInfo = {
+        "TrailLength",
+        "Trail Length",
+        "This value is the fraction of a full orbit that is covered by each trail."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo SegmentsInfo = {
+        "Segments",
+        "Number of Segments",
+        "This value specifies the number of line segments that each trail consists of."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo RenderPointsInfo = {
+        "RenderPoints",
+        "Render Points",
+        "If this value is enabled, the current position of each body is shown as a "
+        "point at the head of its trail."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PointSizeInfo = {
+        "PointSize",
+        "Point Size",
+        "If the 'RenderPoints' is enabled, this value determines the size of the points."
+    };
+} // namespace
+
+namespace openspace {
+
+documentation::Documentation RenderableOrbitalKepler::Documentation() {
+    using namespace documentation;
+    return {
+        "Renderable Orbital Kepler",
+        "space_renderable_orbitalkepler",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("RenderableOrbitalKepler"),
+                Optional::No
+            },
+            {
+                PathInfo.identifier,
+                new StringVerifier,
+                Optional::No,
+                PathInfo.description
+            },
+            {
+                ColorInfo.identifier,
+                new DoubleVector3Verifier,
+                Optional::Yes,
+                ColorInfo.description
+            },
+            {
+                LineWidthInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                LineWidthInfo.description
+            },
+            {
+                LineFadeInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                LineFadeInfo.description
+            },
+            {
+                TrailLengthInfo.identifier,
+                new DoubleInRangeVerifier(0.0, 1.0),
+                Optional::Yes,
+                TrailLengthInfo.description
+            },
+            {
+                SegmentsInfo.identifier,
+                new IntGreaterVerifier(0),
+                Optional::Yes,
+                SegmentsInfo.description
+            },
+            {
+                RenderPointsInfo.identifier,
+                new BoolVerifier,
+                Optional::Yes,
+                RenderPointsInfo.description
+            },
+            {
+                PointSizeInfo.identifier,
+                new IntVerifier,
+                Optional::Yes,
+                PointSizeInfo.description
+            }
+        }
+    };
+}
+
+RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dictionary)
+    : Renderable(dictionary)
+    , _path(PathInfo)
+    , _color(ColorInfo, glm::vec3(1.f), glm::vec3(0.f), glm::vec3(1.f))
+    , _lineWidth(LineWidthInfo, 1.f, 1.f, 20.f)
+    , _lineFade(LineFadeInfo, 1.f, 0.f, 30.f)
+    , _trailLength(TrailLengthInfo, 0.5f, 0.f, 1.f)
+    , _nSegments(SegmentsInfo, 64, 1, 1024)
+    , _renderPoints(RenderPointsInfo, true)
+    , _pointSize(PointSizeInfo, 2, 1, 64)
+{
+    documentation::testSpecificationAndThrow(
+        Documentation(),
+        dictionary,
+        "RenderableOrbitalKepler"
+    );
+
+    _path = absPath(dictionary.value<std::string>(PathInfo.identifier));
+    _path.onChange([this]() { _orbitsAreDirty = true; });
+    addProperty(_path);
+
+    if (dictionary.hasKey(ColorInfo.identifier)) {
+        _color = dictionary.value<glm::vec3>(ColorInfo.identifier);
+    }
+    _color.setViewOption(properties::Property::ViewOptions::Color);
+    addProperty(_color);
+
+    if (dictionary.hasKey(LineWidthInfo.identifier)) {
+        _lineWidth = static_cast<float>(
+            dictionary.value<double>(LineWidthInfo.identifier)
+        );
+    }
+    addProperty(_lineWidth);
+
+    if (dictionary.hasKey(LineFadeInfo.identifier)) {
+        _lineFade = static_cast<float>(dictionary.value<double>(LineFadeInfo.identifier));
+    }
+    addProperty(_lineFade);
+
+    if (dictionary.hasKey(TrailLengthInfo.identifier)) {
+        _trailLength = static_cast<float>(
+            dictionary.value<double>(TrailLengthInfo.identifier)
+        );
+    }
+    addProperty(_trailLength);
+
+    if (dictionary.hasKey(SegmentsInfo.identifier)) {
+        _nSegments = static_cast<int>(dictionary.value<double>(SegmentsInfo.identifier));
+    }
+    addProperty(_nSegments);
+
+    if (dictionary.hasKey(RenderPointsInfo.identifier)) {
+        _renderPoints = dictionary.value<bool>(RenderPointsInfo.identifier);
+    }
+    addProperty(_renderPoints);
+
+    if (dictionary.hasKey(PointSizeInfo.identifier)) {
+        _pointSize = static_cast<int>(dictionary.value<double>(PointSizeInfo.identifier));
+    }
+    addProperty(_pointSize);
+
+    addProperty(_opacity);
+}
+
+void RenderableOrbitalKepler::initialize() {
+    // The epochs are converted by SPICE, so the kernels have to be loaded first
+    readOrbitalElements();
+}
+
+void RenderableOrbitalKepler::initializeGL() {
+    _programObject = SpaceModule::ProgramObjectManager.request(
+        ProgramName,
+        []() -> std::unique_ptr<ghoul::opengl::ProgramObject> {
+            return global::renderEngine.buildRenderProgram(
+                ProgramName,
+                absPath("${MODULE_SPACE}/shaders/orbitalkepler_vs.glsl"),
+                absPath("${MODULE_SPACE}/shaders/orbitalkepler_fs.glsl")
+            );
+        }
+    );
+    ghoul::opengl::updateUniformLocations(*_programObject, _uniformCache, UniformNames);
+
+    glGenVertexArrays(1, &_vertexArray);
+    glGenBuffers(1, &_vertexBuffer);
+
+    glBindVertexArray(_vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+
+    // All attributes are per orbit, the trail vertices are generated from gl_VertexID
+    constexpr const GLsizei Stride = sizeof(KeplerOrbit);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        0,
+        2,
+        GL_FLOAT,
+        GL_FALSE,
+        Stride,
+        reinterpret_cast<const void*>(offsetof(KeplerOrbit, shape))
+    );
+    glVertexAttribDivisor(0, 1);
+    for (GLuint i = 0; i < 3; ++i) {
+        glEnableVertexAttribArray(1 + i);
+        glVertexAttribPointer(
+            1 + i,
+            3,
+            GL_FLOAT,
+            GL_FALSE,
+            Stride,
+            reinterpret_cast<const void*>(
+                offsetof(KeplerOrbit, orbitPlane) + i * sizeof(glm::vec3)
+            )
+        );
+        glVertexAttribDivisor(1 + i, 1);
+    }
+    glEnableVertexAttribArray(4);
+    glVertexAttribLPointer(
+        4,
+        3,
+        GL_DOUBLE,
+        Stride,
+        reinterpret_cast<const void*>(offsetof(KeplerOrbit, timing))
+    );
+    glVertexAttribDivisor(4, 1);
+
+    glBindVertexArray(0);
+
+    uploadOrbits();
+}
+
+void RenderableOrbitalKepler::deinitializeGL() {
+    glDeleteBuffers(1, &_vertexBuffer);
+    _vertexBuffer = 0;
+    glDeleteVertexArrays(1, &_vertexArray);
+    _vertexArray = 0;
+
+    SpaceModule::ProgramObjectManager.release(
+        ProgramName,
+        [](ghoul::opengl::ProgramObject* p) {
+            global::renderEngine.removeRenderProgram(p);
+        }
+    );
+    _programObject = nullptr;
+}
+
+bool RenderableOrbitalKepler::isReady() const {
+    return _programObject != nullptr;
+}
+
+void RenderableOrbitalKepler::readOrbitalElements() {
+    _orbits.clear();
+
+    std::ifstream file(_path.value());
+    if (!file.good()) {
+        LERROR(fmt::format("Could not open file '{}'", _path.value()));
+        return;
+    }
+
+    float maxApoapsis = 0.f;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> values;
+        std::stringstream s(line);
+        std::string value;
+        while (std::getline(s, value, ',')) {
+            values.push_back(value);
+        }
+        if (values.size() != NElementsPerOrbit) {
+            LWARNING(fmt::format(
+                "{}:{}: Expected {} values, got {}",
+                _path.value(), lineNumber, NElementsPerOrbit, values.size()
+            ));
+            continue;
+        }
+
+        try {
+            const double eccentricity = std::stod(values[0]);
+            const double semiMajorAxis = std::stod(values[1]) * 1000.0;
+            const double inclination = glm::radians(std::stod(values[2]));
+            const double ascendingNode = glm::radians(std::stod(values[3]));
+            const double argumentOfPeriapsis = glm::radians(std::stod(values[4]));
+            const double meanAnomaly = glm::radians(std::stod(values[5]));
+            const double epoch = SpiceManager::ref().ephemerisTimeFromDate(values[6]);
+            const double period = std::stod(values[7]);
+
+            if (eccentricity < 0.0 || eccentricity >= 1.0 || period <= 0.0) {
+                LWARNING(fmt::format(
+                    "{}:{}: Only closed orbits are supported", _path.value(), lineNumber
+                ));
+                continue;
+            }
+
+            // Same rotations as in KeplerTranslation::computeOrbitPlane
+            const glm::dmat3 orbitPlane = glm::dmat3(
+                glm::rotate(ascendingNode, glm::dvec3(0.0, 0.0, 1.0)) *
+                glm::rotate(inclination, glm::dvec3(1.0, 0.0, 0.0)) *
+                glm::rotate(argumentOfPeriapsis, glm::dvec3(0.0, 0.0, 1.0))
+            );
+
+            KeplerOrbit orbit;
+            orbit.shape = glm::vec2(eccentricity, semiMajorAxis);
+            orbit.orbitPlane = glm::mat3(orbitPlane);
+            orbit.padding = 0.f;
+            orbit.timing = glm::dvec3(
+                epoch,
+                meanAnomaly,
+                glm::two_pi<double>() / period
+            );
+            _orbits.push_back(orbit);
+
+            maxApoapsis = std::max(
+                maxApoapsis,
+                static_cast<float>(semiMajorAxis * (1.0 + eccentricity))
+            );
+        }
+        catch (const std::logic_error&) {
+            // std::invalid_argument and std::out_of_range from std::stod
+            LWARNING(fmt::format(
+                "{}:{}: Invalid orbital element", _path.value(), lineNumber
+            ));
+        }
+        catch (const SpiceManager::SpiceException& e) {
+            LWARNING(fmt::format(
+                "{}:{}: Invalid epoch: {}", _path.value(), lineNumber, e.message
+            ));
+        }
+    }
+
+    LINFO(fmt::format("Read {} orbits from '{}'", _orbits.size(), _path.value()));
+    setBoundingSphere(maxApoapsis);
+}
+
+void RenderableOrbitalKepler::uploadOrbits() {
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _orbits.size() * sizeof(KeplerOrbit),
+        _orbits.data(),
+        GL_STATIC_DRAW
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RenderableOrbitalKepler::render(const RenderData& data, RendererTasks&) {
+    if (_orbits.empty()) {
+        return;
+    }
+
+    _programObject->activate();
+    _programObject->setUniform(_uniformCache.opacity, _opacity);
+
+    const glm::dmat4 modelTransform =
+        glm::translate(glm::dmat4(1.0), data.modelTransform.translation) *
+        glm::dmat4(data.modelTransform.rotation) *
+        glm::scale(glm::dmat4(1.0), glm::dvec3(data.modelTransform.scale));
+
+    // As for the RenderableTrail, the model view transformation is passed as double to
+    // maintain the precision for orbits that are far away from their reference
+    _programObject->setUniform(
+        _uniformCache.modelView,
+        data.camera.combinedViewMatrix() * modelTransform
+    );
+    _programObject->setUniform(_uniformCache.projection, data.camera.projectionMatrix());
+    _programObject->setUniform(_uniformCache.time, _time);
+    _programObject->setUniform(_uniformCache.color, _color);
+    _programObject->setUniform(_uniformCache.lineFade, _lineFade);
+    _programObject->setUniform(_uniformCache.trailLength, _trailLength);
+    _programObject->setUniform(_uniformCache.nSegments, _nSegments);
+    _programObject->setUniform(_uniformCache.pointSize, _pointSize);
+
+    const bool usingFramebufferRenderer =
+        global::renderEngine.rendererImplementation() ==
+        RenderEngine::RendererImplementation::Framebuffer;
+
+    if (usingFramebufferRenderer) {
+        glDepthMask(false);
+    }
+
+    const GLsizei nOrbits = static_cast<GLsizei>(_orbits.size());
+    glBindVertexArray(_vertexArray);
+
+    // Each instance is one orbit, whose trail starts at the current position
+    glLineWidth(_lineWidth);
+    _programObject->setUniform(_uniformCache.renderPhase, RenderPhaseLines);
+    glDrawArraysInstanced(GL_LINE_STRIP, 0, _nSegments + 1, nOrbits);
+
+    if (_renderPoints) {
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        _programObject->setUniform(_uniformCache.renderPhase, RenderPhasePoints);
+        glDrawArraysInstanced(GL_POINTS, 0, 1, nOrbits);
+        glDisable(GL_PROGRAM_POINT_SIZE);
+    }
+
+    glBindVertexArray(0);
+
+    if (usingFramebufferRenderer) {
+        glDepthMask(true);
+    }
+
+    _programObject->deactivate();
+}
+
+void RenderableOrbitalKepler::update(const UpdateData& data) {
+    if (_programObject->isDirty()) {
+        _programObject->rebuildFromFile();
+        ghoul::opengl::updateUniformLocations(
+            *_programObject,
+            _uniformCache,
+            UniformNames
+        );
+    }
+
+    if (_orbitsAreDirty) {
+        readOrbitalElements();
+        uploadOrbits();
+        _orbitsAreDirty = false;
+    }
+
+    _time = data.time.j2000Seconds();
+}
+
+} // namespace openspace
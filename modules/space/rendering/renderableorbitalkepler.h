@@ -0,0 +1,114 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___RENDERABLEORBITALKEPLER___H__
+#define __OPENSPACE_MODULE_SPACE___RENDERABLEORBITALKEPLER___H__
+
+#include <openspace/rendering/renderable.h>
+
+#include <openspace/properties/stringproperty.h>
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/properties/vector/vec3property.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/uniformcache.h>
+#include <vector>
+
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace {
+
+namespace documentation { struct Documentation; }
+
+/**
+ * This Renderable shows the trails and current positions of a large number of bodies on
+ * Keplerian orbits, such as satellite or minor planet catalogues, in a single draw call.
+ * The orbital elements are read from a file and uploaded once as per-instance vertex
+ * attributes. The Kepler equation is then solved in the vertex shader for every trail
+ * vertex, so no positions have to be computed on the CPU.
+ */
+class RenderableOrbitalKepler : public Renderable {
+public:
+    explicit RenderableOrbitalKepler(const ghoul::Dictionary& dictionary);
+
+    void initialize() override;
+    void initializeGL() override;
+    void deinitializeGL() override;
+
+    bool isReady() const override;
+
+    void render(const RenderData& data, RendererTasks& rendererTask) override;
+    void update(const UpdateData& data) override;
+
+    static documentation::Documentation Documentation();
+
+private:
+    /// The per-orbit data in the instance vertex buffer. Keep in sync with the shader
+    struct KeplerOrbit {
+        /// Eccentricity and semi-major axis (m)
+        glm::vec2 shape;
+        /// Rotation from the orbital plane into the reference frame of the parent
+        glm::mat3 orbitPlane;
+        float padding;
+        /// Epoch (s past J2000), mean anomaly at epoch (rad), mean motion (rad/s)
+        glm::dvec3 timing;
+    };
+
+    /**
+     * Reads the orbital elements from the file at _path. Each line contains the
+     * eccentricity, semi-major axis (km), inclination, right ascension of the ascending
+     * node, argument of periapsis, mean anomaly at epoch (all in degrees), the epoch and
+     * the orbital period (s), separated by commas. Empty lines and lines starting with
+     * \c # are ignored.
+     */
+    void readOrbitalElements();
+
+    /// Uploads the contents of _orbits into the instance vertex buffer
+    void uploadOrbits();
+
+    properties::StringProperty _path;
+    properties::Vec3Property _color;
+    properties::FloatProperty _lineWidth;
+    properties::FloatProperty _lineFade;
+    properties::FloatProperty _trailLength;
+    properties::IntProperty _nSegments;
+    properties::BoolProperty _renderPoints;
+    properties::IntProperty _pointSize;
+
+    std::vector<KeplerOrbit> _orbits;
+    bool _orbitsAreDirty = false;
+
+    ghoul::opengl::ProgramObject* _programObject = nullptr;
+    UniformCache(modelView, projection, time, color, opacity, lineFade, trailLength,
+        nSegments, pointSize, renderPhase) _uniformCache;
+
+    GLuint _vertexArray = 0;
+    GLuint _vertexBuffer = 0;
+    double _time = 0.0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___RENDERABLEORBITALKEPLER___H__
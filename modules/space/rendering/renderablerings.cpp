@@ -27,11 +27,11 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/rendering/compressedtexture.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scene.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
-#include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
@@ -267,10 +267,10 @@ void RenderableRings::update(const UpdateData& data) {
 
 void RenderableRings::loadTexture() {
     if (!_texturePath.value().empty()) {
-        using namespace ghoul::io;
         using namespace ghoul::opengl;
-        std::unique_ptr<Texture> texture = TextureReader::ref().loadTexture(
-            absPath(_texturePath)
+        std::unique_ptr<Texture> texture = rendering::loadTexture(
+            absPath(_texturePath),
+            Texture::FilterMode::AnisotropicMipMap
         );
 
         if (texture) {
@@ -280,9 +280,6 @@ void RenderableRings::loadTexture() {
             );
             _texture = std::move(texture);
 
-            _texture->uploadTexture();
-            _texture->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
-
             _textureFile = std::make_unique<ghoul::filesystem::File>(_texturePath);
             _textureFile->setCallback(
                 [&](const ghoul::filesystem::File&) { _textureIsDirty = true; }
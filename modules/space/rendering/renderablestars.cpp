@@ -28,6 +28,9 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/util/distanceconstants.h>
+#include <openspace/util/resourceloader.h>
+#include <openspace/util/speckcache.h>
+#include <openspace/util/speckreader.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
@@ -39,6 +42,7 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <fstream>
@@ -53,15 +57,19 @@ namespace {
     constexpr const char* KeyStaticFilterValue = "StaticFilter";
     constexpr const char* KeyStaticFilterReplacement = "StaticFilterReplacement";
 
-    constexpr const std::array<const char*, 16> UniformNames = {
+    constexpr const std::array<const char*, 19> UniformNames = {
         "modelMatrix", "cameraUp", "cameraViewProjectionMatrix",
         "colorOption", "magnitudeExponent", "eyePosition", "psfParamConf",
         "lumCent", "radiusCent", "brightnessCent", "colorTexture",
         "alphaValue", "psfTexture", "otherDataTexture", "otherDataRange",
-        "filterOutOfRange"
+        "filterOutOfRange", "hasStaticFilter", "staticFilterValue",
+        "staticFilterReplacementValue"
     };
 
-    constexpr int8_t CurrentCacheVersion = 3;
+
+    // The star data is uploaded to the GPU in chunks of this many bytes, so that large
+    // catalogs are spread over multiple frames by the ResourceLoader's upload budget
+    constexpr const size_t UploadChunkSize = 4 * 1024 * 1024;
 
     constexpr const int RenderOptionPointSpreadFunction = 0;
     constexpr const int RenderOptionTexture = 1;
@@ -69,28 +77,6 @@ namespace {
     constexpr const int PsfMethodSpencer = 0;
     constexpr const int PsfMethodMoffat = 1;
 
-    struct CommonDataLayout {
-        std::array<float, 3> position;
-        float value;
-        float luminance;
-        float absoluteMagnitude;
-        float apparentMagnitude;
-    };
-
-    struct ColorVBOLayout : public CommonDataLayout {};
-
-    struct VelocityVBOLayout : public CommonDataLayout {
-        float vx; // v_x
-        float vy; // v_y
-        float vz; // v_z
-    };
-
-    struct SpeedVBOLayout : public CommonDataLayout {
-        float speed;
-    };
-
-    struct OtherDataLayout : public CommonDataLayout {};
-
     constexpr openspace::properties::Property::PropertyInfo SpeckFileInfo = {
         "SpeckFile",
         "Speck File",
@@ -276,6 +262,43 @@ namespace {
         "Beta",
         "Moffat's Beta Constant."
     };
+
+    openspace::properties::PropertyOwner::PropertyOwnerInfo SplattingOwnerInfo = {
+        "ComputeSplatting",
+        "Compute Splatting",
+        "Settings for rendering the stars with compute shaders instead of billboards"
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo UseSplattingInfo = {
+        "UseComputeSplatting",
+        "Use Compute Splatting",
+        "If this value is enabled, the stars are rendered with compute shaders that add "
+        "the light of faint stars directly into the pixels and only draw the point "
+        "spread function for bright stars, which scales to much larger catalogs than "
+        "the billboards. This is only supported for the 'Color' and 'Other Data' color "
+        "options, the other options always use billboards."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo SplatExposureInfo = {
+        "Exposure",
+        "Exposure",
+        "The factor from the flux of a star, relative to a star with an apparent "
+        "magnitude of 0, to the intensity of its pixels."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo BrightStarThresholdInfo = {
+        "BrightStarThreshold",
+        "Bright Star Threshold",
+        "Stars whose intensity is larger than this value are drawn with the point "
+        "spread function, all others are added into the pixels they cover."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo SplatPsfRadiusInfo = {
+        "PsfRadius",
+        "Point Spread Function Radius",
+        "The radius in pixels of the point spread function of a star whose intensity "
+        "is equal to the bright star threshold. Brighter stars are drawn larger."
+    };
 }  // namespace
 
 namespace openspace {
@@ -374,6 +397,12 @@ documentation::Documentation RenderableStars::Documentation() {
                 Optional::No,
                 SizeCompositionOptionInfo.description
             },
+            {
+                UseSplattingInfo.identifier,
+                new BoolVerifier,
+                Optional::Yes,
+                UseSplattingInfo.description
+            },
         }
     };
 }
@@ -425,6 +454,12 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
     , _userProvidedTextureOwner(UserProvidedTextureOptionInfo)
     , _parametersOwner(ParametersOwnerOptionInfo)
     , _moffatMethodOwner(MoffatMethodOptionInfo)
+    , _splattingOwner(SplattingOwnerInfo)
+    , _useSplatting(UseSplattingInfo, false)
+    , _splatExposure(SplatExposureInfo, 1e3f, 1.f, 1e8f)
+    , _splatBrightStarThreshold(BrightStarThresholdInfo, 1.f, 0.01f, 100.f)
+    , _splatPsfRadius(SplatPsfRadiusInfo, 2.f, 1.f, 16.f)
+    , _splatter("RenderableStars", "${MODULE_SPACE}/shaders/star_splatsource_cs.glsl")
 {
     using File = ghoul::filesystem::File;
 
@@ -477,7 +512,7 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
             _colorOption = ColorOption::OtherData;
         }
     }
-    _colorOption.onChange([&] { _dataIsDirty = true; });
+    _colorOption.onChange([&] { _dataLayoutIsDirty = true; });
     addProperty(_colorOption);
 
     _colorTexturePath.onChange([&] { _colorTextureIsDirty = true; });
@@ -500,7 +535,7 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
         _queuedOtherData = dictionary.value<std::string>(OtherDataOptionInfo.identifier);
     }
 
-    _otherDataOption.onChange([&]() { _dataIsDirty = true; });
+    _otherDataOption.onChange([&]() { _dataLayoutIsDirty = true; });
     addProperty(_otherDataOption);
 
     addProperty(_otherDataRange);
@@ -634,6 +669,16 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
     addPropertySubOwner(_userProvidedTextureOwner);
     addPropertySubOwner(_parametersOwner);
     addPropertySubOwner(_moffatMethodOwner);
+
+    if (dictionary.hasKey(UseSplattingInfo.identifier)) {
+        _useSplatting = dictionary.value<bool>(UseSplattingInfo.identifier);
+    }
+    _splattingOwner.addProperty(_useSplatting);
+    _splatExposure.setExponent(10.f);
+    _splattingOwner.addProperty(_splatExposure);
+    _splattingOwner.addProperty(_splatBrightStarThreshold);
+    _splattingOwner.addProperty(_splatPsfRadius);
+    addPropertySubOwner(_splattingOwner);
 }
 
 RenderableStars::~RenderableStars() {}
@@ -653,17 +698,6 @@ void RenderableStars::initializeGL() {
     ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
 
     loadData();
-
-    if (!_queuedOtherData.empty()) {
-        auto it = std::find(_dataNames.begin(), _dataNames.end(), _queuedOtherData);
-        if (it == _dataNames.end()) {
-            LERROR(fmt::format("Could not find other data column {}", _queuedOtherData));
-        }
-        else {
-            _otherDataOption = static_cast<int>(std::distance(_dataNames.begin(), it));
-            _queuedOtherData.clear();
-        }
-    }
     _speckFileIsDirty = false;
 
     LDEBUG("Creating Polygon Texture");
@@ -741,9 +775,19 @@ void RenderableStars::initializeGL() {
     //loadShapeTexture();
 
     renderPSFToTexture();
+
+    _splatter.initializeGL();
+    _splatDataBinding = std::make_unique<ghoul::opengl::BufferBinding<
+        ghoul::opengl::bufferbinding::Buffer::ShaderStorage>
+    >();
 }
 
 void RenderableStars::deinitializeGL() {
+    _loadingHandle.cancel();
+
+    _splatDataBinding = nullptr;
+    _splatter.deinitializeGL();
+
     glDeleteBuffers(1, &_vbo);
     _vbo = 0;
     glDeleteVertexArrays(1, &_vao);
@@ -891,6 +935,20 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
         return;
     }
 
+    glm::dmat4 modelMatrix =
+        glm::translate(glm::dmat4(1.0), data.modelTransform.translation) *
+        glm::dmat4(data.modelTransform.rotation) *
+        glm::dmat4(glm::scale(glm::dmat4(1.0), glm::dvec3(data.modelTransform.scale)));
+
+    // Only the color options that look up a single value in a color map can be splat,
+    // the velocity and speed options fall back to the billboards
+    const bool canSplat = _colorOption == ColorOption::Color ||
+        (_colorOption == ColorOption::OtherData && _otherDataColorMapTexture);
+    if (_useSplatting && canSplat && _colorTexture) {
+        renderSplatted(data, modelMatrix);
+        return;
+    }
+
     // Saving current OpenGL state
     GLenum blendEquationRGB;
     GLenum blendEquationAlpha;
@@ -922,11 +980,6 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     glm::dvec3 cameraUp = data.camera.lookUpVectorWorldSpace();
     _program->setUniform(_uniformCache.cameraUp, cameraUp);
 
-    glm::dmat4 modelMatrix =
-        glm::translate(glm::dmat4(1.0), data.modelTransform.translation) *
-        glm::dmat4(data.modelTransform.rotation) *
-        glm::dmat4(glm::scale(glm::dmat4(1.0), glm::dvec3(data.modelTransform.scale)));
-
     glm::dmat4 modelViewMatrix = data.camera.combinedViewMatrix() * modelMatrix;
     glm::dmat4 projectionMatrix = glm::dmat4(data.camera.projectionMatrix());
 
@@ -983,7 +1036,15 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     // use this color mode --- abock 2018-11-19
     _program->setUniform(_uniformCache.otherDataRange, _otherDataRange);
     _program->setUniform(_uniformCache.filterOutOfRange, _filterOutOfRange);
-
+    _program->setUniform(_uniformCache.hasStaticFilter, _staticFilterValue.has_value());
+    _program->setUniform(
+        _uniformCache.staticFilterValue,
+        _staticFilterValue.value_or(0.f)
+    );
+    _program->setUniform(
+        _uniformCache.staticFilterReplacementValue,
+        _staticFilterReplacementValue
+    );
 
     glBindVertexArray(_vao);
     const GLsizei nStars = static_cast<GLsizei>(_fullData.size() / _nValuesPerStar);
@@ -1001,164 +1062,84 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     glDepthMask(depthMask);
 }
 
+void RenderableStars::renderSplatted(const RenderData& data,
+                                     const glm::dmat4& modelMatrix)
+{
+    StarSplatter::Settings settings;
+    settings.exposure = _splatExposure;
+    settings.brightStarThreshold = _splatBrightStarThreshold;
+    settings.psfRadius = _splatPsfRadius;
+    if (_colorOption == ColorOption::OtherData) {
+        settings.colorRange = _otherDataRange;
+        settings.colorTexture = static_cast<GLuint>(*_otherDataColorMapTexture);
+    }
+    else {
+        // The range of B-V values that is covered by the color map, as in the shaders
+        settings.colorRange = glm::vec2(-0.4f, 2.f);
+        settings.colorTexture = static_cast<GLuint>(*_colorTexture);
+    }
+    if (_renderingMethodOption.value() == 1 && _pointSpreadFunctionTexture) {
+        settings.psfTexture = static_cast<GLuint>(*_pointSpreadFunctionTexture);
+    }
+    else {
+        settings.psfTexture = _psfTexture;
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _splatDataBinding->bindingNumber(), _vbo);
+
+    const bool hasFixedValue = _enableTestGrid && _colorOption == ColorOption::Color;
+    const unsigned int nStars =
+        static_cast<unsigned int>(_fullData.size() / _nValuesPerStar);
+    _splatter.render(
+        data,
+        modelMatrix,
+        nStars,
+        settings,
+        [&](ghoul::opengl::ProgramObject& program) {
+            program.setSsboBinding("StarData", _splatDataBinding->bindingNumber());
+            program.setUniform("nValuesPerStar", static_cast<int>(_nValuesPerStar));
+            program.setUniform(
+                "absoluteMagnitudeColumn",
+                static_cast<int>(_absMagArrayPos)
+            );
+            program.setUniform("valueColumn", static_cast<int>(_valueArrayPos));
+            program.setUniform("hasFixedValue", hasFixedValue);
+            // Same value that is used for the billboards of the test grid
+            program.setUniform("fixedValue", 0.650f);
+            program.setUniform("hasStaticFilter", _staticFilterValue.has_value());
+            program.setUniform("staticFilterValue", _staticFilterValue.value_or(0.f));
+            program.setUniform(
+                "staticFilterReplacementValue",
+                _staticFilterReplacementValue
+            );
+            program.setUniform(
+                "filterOutOfRange",
+                _colorOption == ColorOption::OtherData && _filterOutOfRange
+            );
+            program.setUniform("valueRange", _otherDataRange.value());
+        }
+    );
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _splatDataBinding->bindingNumber(), 0);
+}
+
 void RenderableStars::update(const UpdateData&) {
     if (_speckFileIsDirty) {
         loadData();
         _speckFileIsDirty = false;
-        _dataIsDirty = true;
     }
 
     if (_fullData.empty()) {
         return;
     }
 
-    if (_dataIsDirty) {
-        const int value = _colorOption;
-        LDEBUG("Regenerating data");
-
-        createDataSlice(ColorOption(value));
-
-        int size = static_cast<int>(_slicedData.size());
-
-        if (_vao == 0) {
-            glGenVertexArrays(1, &_vao);
-        }
-        if (_vbo == 0) {
-            glGenBuffers(1, &_vbo);
-        }
-        glBindVertexArray(_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            size * sizeof(GLfloat),
-            _slicedData.data(),
-            GL_STATIC_DRAW
-        );
-
-        GLint positionAttrib = _program->attributeLocation("in_position");
-        // bvLumAbsMagAppMag = bv color, luminosity, abs magnitude and app magnitude
-        GLint bvLumAbsMagAppMagAttrib = _program->attributeLocation(
-            "in_bvLumAbsMagAppMag"
-        );
-
-        const size_t nStars = _fullData.size() / _nValuesPerStar;
-        const size_t nValues = _slicedData.size() / nStars;
-
-        GLsizei stride = static_cast<GLsizei>(sizeof(GLfloat) * nValues);
-
-        glEnableVertexAttribArray(positionAttrib);
-        glEnableVertexAttribArray(bvLumAbsMagAppMagAttrib);
-        const int colorOption = _colorOption;
-        switch (colorOption) {
-            case ColorOption::Color:
-                glVertexAttribPointer(
-                    positionAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    nullptr // = offsetof(ColorVBOLayout, position)
-                );
-                glVertexAttribPointer(
-                    bvLumAbsMagAppMagAttrib,
-                    4,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(ColorVBOLayout, value))
-                );
-
-                break;
-            case ColorOption::Velocity:
-            {
-                glVertexAttribPointer(
-                    positionAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    nullptr // = offsetof(VelocityVBOLayout, position)
-                );
-                glVertexAttribPointer(
-                    bvLumAbsMagAppMagAttrib,
-                    4,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(VelocityVBOLayout, value))
-                );
-
-                GLint velocityAttrib = _program->attributeLocation("in_velocity");
-                glEnableVertexAttribArray(velocityAttrib);
-                glVertexAttribPointer(
-                    velocityAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_TRUE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(VelocityVBOLayout, vx)) // NOLINT
-                );
-
-                break;
-            }
-            case ColorOption::Speed:
-            {
-                glVertexAttribPointer(
-                    positionAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    nullptr // = offsetof(SpeedVBOLayout, position)
-                );
-                glVertexAttribPointer(
-                    bvLumAbsMagAppMagAttrib,
-                    4,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(SpeedVBOLayout, value))
-                );
-
-                GLint speedAttrib = _program->attributeLocation("in_speed");
-                glEnableVertexAttribArray(speedAttrib);
-                glVertexAttribPointer(
-                    speedAttrib,
-                    1,
-                    GL_FLOAT,
-                    GL_TRUE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(SpeedVBOLayout, speed))
-                );
-                break;
-            }
-            case ColorOption::OtherData:
-            {
-                glVertexAttribPointer(
-                    positionAttrib,
-                    3,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    nullptr // = offsetof(OtherDataLayout, position)
-                );
-                glVertexAttribPointer(
-                    bvLumAbsMagAppMagAttrib,
-                    4,
-                    GL_FLOAT,
-                    GL_FALSE,
-                    stride,
-                    reinterpret_cast<void*>(offsetof(OtherDataLayout, value)) // NOLINT
-                );
-            }
-        }
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-
-        _dataIsDirty = false;
+    if (_dataLayoutIsDirty) {
+        updateDataLayout();
+        _dataLayoutIsDirty = false;
     }
 
+    _splatter.update();
+
     if (_pointSpreadFunctionTextureIsDirty) {
         LDEBUG("Reloading Point Spread Function texture");
         _pointSpreadFunctionTexture = nullptr;
@@ -1239,6 +1220,8 @@ void RenderableStars::update(const UpdateData&) {
     if (_program->isDirty()) {
         _program->rebuildFromFile();
         ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+        // The attribute locations might have changed with the new program
+        _dataLayoutIsDirty = true;
     }
 }
 
@@ -1272,54 +1255,137 @@ void RenderableStars::loadShapeTexture() {
 */
 
 void RenderableStars::loadData() {
-    std::string _file = _speckFile;
-    if (!FileSys.fileExists(absPath(_file))) {
-        return;
+    // Stop a previous load of the same renderable from overwriting the buffer again
+    _loadingHandle.cancel();
+
+    // Rendering resumes when the new data has been uploaded completely
+    _fullData.clear();
+
+    std::string file = _speckFile;
+    bool enableTestGrid = _enableTestGrid;
+    std::function<Dataset()> decode = [file, enableTestGrid]() {
+        return readDataset(file, enableTestGrid);
+    };
+
+    size_t uploadedBytes = 0;
+    std::function<bool(Dataset&)> upload = [this, uploadedBytes](Dataset& d) mutable {
+        if (d.data.empty()) {
+            return true;
+        }
+
+        if (_vao == 0) {
+            glGenVertexArrays(1, &_vao);
+        }
+        if (_vbo == 0) {
+            glGenBuffers(1, &_vbo);
+        }
+
+        // The VBO contains all columns of the speck file, which columns are used for
+        // rendering only depends on the attribute pointers set in updateDataLayout
+        const size_t size = d.data.size() * sizeof(GLfloat);
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        if (uploadedBytes == 0) {
+            LDEBUG("Uploading data");
+            glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STATIC_DRAW);
+        }
+        const size_t chunk = std::min(UploadChunkSize, size - uploadedBytes);
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            uploadedBytes,
+            chunk,
+            reinterpret_cast<const char*>(d.data.data()) + uploadedBytes
+        );
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        uploadedBytes += chunk;
+        return uploadedBytes == size;
+    };
+
+    std::function<void(Dataset&)> ready = [this](Dataset& d) {
+        _fullData = std::move(d.data);
+        _nValuesPerStar = d.nValuesPerStar;
+        _dataNames = std::move(d.dataNames);
+        _lumArrayPos = d.lumArrayPos;
+        _absMagArrayPos = d.absMagArrayPos;
+        _appMagArrayPos = d.appMagArrayPos;
+        _bvColorArrayPos = d.bvColorArrayPos;
+        _velocityArrayPos = d.velocityArrayPos;
+        _speedArrayPos = d.speedArrayPos;
+        _otherDataOption.addOptions(_dataNames);
+
+        if (!_queuedOtherData.empty()) {
+            auto it = std::find(_dataNames.begin(), _dataNames.end(), _queuedOtherData);
+            if (it == _dataNames.end()) {
+                LERROR(fmt::format(
+                    "Could not find other data column {}", _queuedOtherData
+                ));
+            }
+            else {
+                const auto option = std::distance(_dataNames.begin(), it);
+                _otherDataOption = static_cast<int>(option);
+                _queuedOtherData.clear();
+            }
+        }
+
+        _dataLayoutIsDirty = true;
+    };
+
+    _loadingHandle = global::resourceLoader.load(
+        std::move(decode),
+        std::move(upload),
+        std::move(ready)
+    );
+}
+
+RenderableStars::Dataset RenderableStars::readDataset(const std::string& file,
+                                                      bool enableTestGrid)
+{
+    if (!FileSys.fileExists(absPath(file))) {
+        return Dataset();
     }
 
     std::string cachedFile = FileSys.cacheManager()->cachedFilename(
-        _file,
+        file,
         ghoul::filesystem::CacheManager::Persistent::Yes
     );
 
-    _nValuesPerStar = 0;
-    _slicedData.clear();
-    _fullData.clear();
-    _dataNames.clear();
-
     bool hasCachedFile = FileSys.fileExists(cachedFile);
     if (hasCachedFile) {
         LINFO(fmt::format("Cached file '{}' used for Speck file '{}'",
-            cachedFile, _file
+            cachedFile, file
         ));
 
-        bool success = loadCachedFile(cachedFile);
-        if (success) {
-            return;
+        std::optional<Dataset> dataset = loadCachedFile(cachedFile);
+        if (dataset) {
+            return std::move(*dataset);
         }
         else {
-            FileSys.cacheManager()->removeCacheFile(_file);
+            FileSys.cacheManager()->removeCacheFile(file);
             // Intentional fall-through to the 'else' computation to generate the cache
             // file for the next run
         }
     }
     else {
-        LINFO(fmt::format("Cache for Speck file '{}' not found", _file));
+        LINFO(fmt::format("Cache for Speck file '{}' not found", file));
     }
-    LINFO(fmt::format("Loading Speck file '{}'", _file));
+    LINFO(fmt::format("Loading Speck file '{}'", file));
 
-    readSpeckFile();
+    Dataset dataset = readSpeckFile(file, enableTestGrid);
 
     LINFO("Saving cache");
-    saveCachedFile(cachedFile);
+    saveCachedFile(cachedFile, dataset);
+    return dataset;
 }
 
-void RenderableStars::readSpeckFile() {
-    std::string _file = _speckFile;
-    std::ifstream file(_file);
+RenderableStars::Dataset RenderableStars::readSpeckFile(const std::string& path,
+                                                        bool enableTestGrid)
+{
+    Dataset dataset;
+
+    std::ifstream file(path);
     if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _file));
-        return;
+        LERROR(fmt::format("Failed to open Speck file '{}'", path));
+        return dataset;
     }
 
     // The beginning of the speck file has a header that either contains comments
@@ -1340,7 +1406,7 @@ void RenderableStars::readSpeckFile() {
         {
             // we read a line that doesn't belong to the header, so we have to jump back
             // before the beginning of the current line
-            if (_enableTestGrid) {
+            if (enableTestGrid) {
                 file.seekg(position - std::streamoff(8));
             }
             else {
@@ -1359,293 +1425,186 @@ void RenderableStars::readSpeckFile() {
 
             std::string dummy;
             str >> dummy;
-            str >> _nValuesPerStar;
+            str >> dataset.nValuesPerStar;
 
             std::string name;
             str >> name;
-            _dataNames.push_back(name);
+            dataset.dataNames.push_back(name);
 
             // +3 because the position x, y, z
+            const size_t arrayPos = dataset.nValuesPerStar + 3;
             if (name == "lum") {
-                _lumArrayPos = _nValuesPerStar + 3;
+                dataset.lumArrayPos = arrayPos;
             }
             else if (name == "absmag") {
-                _absMagArrayPos = _nValuesPerStar + 3;
+                dataset.absMagArrayPos = arrayPos;
             }
             else if (name == "appmag") {
-                _appMagArrayPos = _nValuesPerStar + 3;
+                dataset.appMagArrayPos = arrayPos;
             }
             else if (name == "colorb_v") {
-                _bvColorArrayPos = _nValuesPerStar + 3;
+                dataset.bvColorArrayPos = arrayPos;
             }
             else if (name == "vx") {
-                _velocityArrayPos = _nValuesPerStar + 3;
+                dataset.velocityArrayPos = arrayPos;
             }
             else if (name == "speed") {
-                _speedArrayPos = _nValuesPerStar + 3;
+                dataset.speedArrayPos = arrayPos;
             }
-            _nValuesPerStar += 1; // We want the number, but the index is 0 based
+            dataset.nValuesPerStar += 1; // We want the number, but the index is 0 based
         }
     }
 
-    _nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
-    _otherDataOption.addOptions(_dataNames);
+    dataset.nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
 
-    float minLumValue = std::numeric_limits<float>::max();
+    // Rows with only zeros are not stored
+    speckreader::DataRows rows = speckreader::readDataRows(
+        file,
+        dataset.nValuesPerStar,
+        true
+    );
+    std::vector<float>& data = dataset.data;
+    data = std::move(rows.values);
+
+    // The luminosity range has always included the row of zeros that the line based
+    // parsing produced when reading past the last line, keep it that way so that the
+    // normalization doesn't change
+    const size_t lumPos = dataset.lumArrayPos;
+    float minLumValue = 0.f;
     float maxLumValue = std::numeric_limits<float>::min();
-
-    do {
-        std::vector<float> values(_nValuesPerStar);
-
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerStar; ++i) {
-            str >> values[i];
-        }
-        bool nullArray = true;
-        for (float v : values) {
-            if (v != 0.0) {
-                nullArray = false;
-                break;
-            }
-        }
-        minLumValue = values[_lumArrayPos] < minLumValue ?
-            values[_lumArrayPos] : minLumValue;
-        maxLumValue = values[_lumArrayPos] > maxLumValue ?
-            values[_lumArrayPos] : maxLumValue;
-        if (!nullArray) {
-            _fullData.insert(_fullData.end(), values.begin(), values.end());
-        }
-    } while (!file.eof());
+    for (size_t i = 0; i < data.size(); i += dataset.nValuesPerStar) {
+        minLumValue = std::min(minLumValue, data[i + lumPos]);
+        maxLumValue = std::max(maxLumValue, data[i + lumPos]);
+    }
 
     // Normalize Luminosity:
-    for (size_t i = 0; i < _fullData.size(); i += _nValuesPerStar) {
-        _fullData[i + _lumArrayPos] =
-            (_fullData[i + _lumArrayPos] - minLumValue) / (maxLumValue - minLumValue);
+    for (size_t i = 0; i < data.size(); i += dataset.nValuesPerStar) {
+        data[i + lumPos] = (data[i + lumPos] - minLumValue) / (maxLumValue - minLumValue);
     }
+    return dataset;
 }
 
-bool RenderableStars::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed: deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(file);
-            return false;
-        }
+std::optional<RenderableStars::Dataset> RenderableStars::loadCachedFile(
+                                                                const std::string& file)
+{
+    std::optional<speckcache::Dataset> cache = speckcache::loadCachedFile(file);
+    if (!cache || static_cast<int>(cache->columnNames.size()) != cache->nValuesPerObject)
+    {
+        return std::nullopt;
+    }
 
-        int32_t nValues = 0;
-        fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(&_nValuesPerStar), sizeof(int32_t));
-
-        fileStream.read(reinterpret_cast<char*>(&_lumArrayPos), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(&_absMagArrayPos), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(&_appMagArrayPos), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(&_bvColorArrayPos), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(&_velocityArrayPos), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(&_speedArrayPos), sizeof(int32_t));
-
-        for (int i = 0; i < _nValuesPerStar - 3; ++i) {
-            uint16_t len;
-            fileStream.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-            std::vector<char> buffer(len);
-            fileStream.read(buffer.data(), len);
-            std::string value(buffer.begin(), buffer.end());
-            _dataNames.push_back(value);
-        }
-        _otherDataOption.addOptions(_dataNames);
+    Dataset dataset;
+    dataset.nValuesPerStar = cache->nValuesPerObject;
+    dataset.lumArrayPos = cache->metadata["LuminosityPosition"];
+    dataset.absMagArrayPos = cache->metadata["AbsoluteMagnitudePosition"];
+    dataset.appMagArrayPos = cache->metadata["ApparentMagnitudePosition"];
+    dataset.bvColorArrayPos = cache->metadata["BvColorPosition"];
+    dataset.velocityArrayPos = cache->metadata["VelocityPosition"];
+    dataset.speedArrayPos = cache->metadata["SpeedPosition"];
 
-        _fullData.resize(nValues);
-        fileStream.read(reinterpret_cast<char*>(
-            _fullData.data()),
-            nValues * sizeof(_fullData[0])
-        );
+    // The first three columns are the xyz values which are not exposed as data names
+    dataset.dataNames.assign(cache->columnNames.begin() + 3, cache->columnNames.end());
 
-        bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
-        return false;
-    }
+    dataset.data = std::move(cache->data);
+    return dataset;
 }
 
-void RenderableStars::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
+void RenderableStars::saveCachedFile(const std::string& file, const Dataset& dataset) {
+    std::vector<std::string> columnNames = { "x", "y", "z" };
+    columnNames.insert(
+        columnNames.end(),
+        dataset.dataNames.begin(),
+        dataset.dataNames.end()
+    );
 
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
-        return;
-    }
+    const std::map<std::string, int> metadata = {
+        { "LuminosityPosition", static_cast<int>(dataset.lumArrayPos) },
+        { "AbsoluteMagnitudePosition", static_cast<int>(dataset.absMagArrayPos) },
+        { "ApparentMagnitudePosition", static_cast<int>(dataset.appMagArrayPos) },
+        { "BvColorPosition", static_cast<int>(dataset.bvColorArrayPos) },
+        { "VelocityPosition", static_cast<int>(dataset.velocityArrayPos) },
+        { "SpeedPosition", static_cast<int>(dataset.speedArrayPos) }
+    };
 
-    fileStream.write(
-        reinterpret_cast<const char*>(&CurrentCacheVersion),
-        sizeof(int8_t)
+    const bool success = speckcache::saveCachedFile(
+        file,
+        dataset.data,
+        dataset.nValuesPerStar,
+        columnNames,
+        metadata
     );
-
-    int32_t nValues = static_cast<int32_t>(_fullData.size());
-    if (nValues == 0) {
-        throw ghoul::RuntimeError("Error writing cache: No values were loaded");
-    }
-    fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
-
-    int32_t nValuesPerStar = static_cast<int32_t>(_nValuesPerStar);
-    fileStream.write(reinterpret_cast<const char*>(&nValuesPerStar), sizeof(int32_t));
-    fileStream.write(reinterpret_cast<const char*>(&_lumArrayPos), sizeof(int32_t));
-    fileStream.write(reinterpret_cast<const char*>(&_absMagArrayPos), sizeof(int32_t));
-    fileStream.write(reinterpret_cast<const char*>(&_appMagArrayPos), sizeof(int32_t));
-    fileStream.write(reinterpret_cast<const char*>(&_bvColorArrayPos), sizeof(int32_t));
-    fileStream.write(reinterpret_cast<const char*>(&_velocityArrayPos), sizeof(int32_t));
-    fileStream.write(reinterpret_cast<const char*>(&_speedArrayPos), sizeof(int32_t));
-
-    // -3 as we don't want to save the xyz values that are in the beginning of the file
-    for (int i = 0; i < _nValuesPerStar - 3; ++i) {
-        uint16_t len = static_cast<uint16_t>(_dataNames[i].size());
-        fileStream.write(reinterpret_cast<const char*>(&len), sizeof(uint16_t));
-        fileStream.write(_dataNames[i].c_str(), len);
+    if (!success) {
+        LERROR(fmt::format("Error writing cache file '{}'", file));
     }
-
-    size_t nBytes = nValues * sizeof(_fullData[0]);
-    fileStream.write(reinterpret_cast<const char*>(_fullData.data()), nBytes);
 }
 
-void RenderableStars::createDataSlice(ColorOption option) {
-    _slicedData.clear();
+void RenderableStars::updateDataLayout() {
+    const int colorOption = _colorOption;
 
-    _otherDataRange = glm::vec2(
-        std::numeric_limits<float>::max(),
-        -std::numeric_limits<float>::max()
-    );
+    // The value is the B-V color unless one of the other data columns is displayed
+    size_t valuePos = _bvColorArrayPos;
+    if (colorOption == ColorOption::OtherData) {
+        // plus 3 because of the position
+        valuePos = _otherDataOption.value() + 3;
 
-    for (size_t i = 0; i < _fullData.size(); i += _nValuesPerStar) {
-        glm::vec3 position = glm::vec3(
-            _fullData[i + 0],
-            _fullData[i + 1],
-            _fullData[i + 2]
+        glm::vec2 range = glm::vec2(
+            std::numeric_limits<float>::max(),
+            -std::numeric_limits<float>::max()
         );
-        position *= openspace::distanceconstants::Parsec;
-
-        switch (option) {
-            case ColorOption::Color:
-            {
-                union {
-                    ColorVBOLayout value;
-                    std::array<float, sizeof(ColorVBOLayout) / sizeof(float)> data;
-                } layout;
-
-                layout.value.position = { { position[0], position[1], position[2] } };
-
-                if (_enableTestGrid) {
-                    float sunColor = 0.650f;
-                    layout.value.value = sunColor;// _fullData[i + 3];
-                }
-                else {
-                    layout.value.value = _fullData[i + _bvColorArrayPos];
-                }
-
-                layout.value.luminance = _fullData[i + _lumArrayPos];
-                layout.value.absoluteMagnitude = _fullData[i + _absMagArrayPos];
-                layout.value.apparentMagnitude = _fullData[i + _appMagArrayPos];
-
-                _slicedData.insert(
-                    _slicedData.end(),
-                    layout.data.begin(),
-                    layout.data.end());
-
-                break;
+        for (size_t i = valuePos; i < _fullData.size(); i += _nValuesPerStar) {
+            float value = _fullData[i];
+            if (_staticFilterValue.has_value() && value == _staticFilterValue) {
+                value = _staticFilterReplacementValue;
             }
-            case ColorOption::Velocity:
-            {
-                union {
-                    VelocityVBOLayout value;
-                    std::array<float, sizeof(VelocityVBOLayout) / sizeof(float)> data;
-                } layout;
-
-                layout.value.position = { { position[0], position[1], position[2] } };
-
-                layout.value.value = _fullData[i + _bvColorArrayPos];
-                layout.value.luminance = _fullData[i + _lumArrayPos];
-                layout.value.absoluteMagnitude = _fullData[i + _absMagArrayPos];
-                layout.value.apparentMagnitude = _fullData[i + _appMagArrayPos];
-
-                layout.value.vx = _fullData[i + _velocityArrayPos];
-                layout.value.vy = _fullData[i + _velocityArrayPos + 1];
-                layout.value.vz = _fullData[i + _velocityArrayPos + 2];
-
-                _slicedData.insert(
-                    _slicedData.end(),
-                    layout.data.begin(),
-                    layout.data.end()
-                );
-                break;
-            }
-            case ColorOption::Speed:
-            {
-                union {
-                    SpeedVBOLayout value;
-                    std::array<float, sizeof(SpeedVBOLayout) / sizeof(float)> data;
-                } layout;
-
-                layout.value.position = { { position[0], position[1], position[2] } };
-
-                layout.value.value = _fullData[i + _bvColorArrayPos];
-                layout.value.luminance = _fullData[i + _lumArrayPos];
-                layout.value.absoluteMagnitude = _fullData[i + _absMagArrayPos];
-                layout.value.apparentMagnitude = _fullData[i + _appMagArrayPos];
-
-                layout.value.speed = _fullData[i + _speedArrayPos];
-
-                _slicedData.insert(
-                    _slicedData.end(),
-                    layout.data.begin(),
-                    layout.data.end()
-                );
-                break;
-            }
-            case ColorOption::OtherData:
-            {
-                union {
-                    OtherDataLayout value;
-                    std::array<float, sizeof(OtherDataLayout)> data;
-                } layout = {};
-
-                layout.value.position = { { position[0], position[1], position[2] } };
-
-                int index = _otherDataOption.value();
-                // plus 3 because of the position
-                layout.value.value = _fullData[i + index + 3];
-
-                if (_staticFilterValue.has_value() &&
-                    layout.value.value == _staticFilterValue)
-                {
-                    layout.value.value = _staticFilterReplacementValue;
-                }
-
-                glm::vec2 range = _otherDataRange.value();
-                range.x = std::min(range.x, layout.value.value);
-                range.y = std::max(range.y, layout.value.value);
-                _otherDataRange = range;
-                _otherDataRange.setMinValue(glm::vec2(range.x));
-                _otherDataRange.setMaxValue(glm::vec2(range.y));
-
-                layout.value.luminance = _fullData[i + _lumArrayPos];
-                layout.value.absoluteMagnitude = _fullData[i + _absMagArrayPos];
-                layout.value.apparentMagnitude = _fullData[i + _appMagArrayPos];
-
-                _slicedData.insert(
-                    _slicedData.end(),
-                    layout.data.begin(),
-                    layout.data.end()
-                );
+            range.x = std::min(range.x, value);
+            range.y = std::max(range.y, value);
+        }
+        _otherDataRange = range;
+        _otherDataRange.setMinValue(glm::vec2(range.x));
+        _otherDataRange.setMaxValue(glm::vec2(range.y));
+    }
 
-                break;
-            }
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+
+    const GLsizei stride = static_cast<GLsizei>(sizeof(GLfloat) * _nValuesPerStar);
+    auto setAttribute = [&](const char* name, GLint size, size_t column) {
+        const GLint attrib = _program->attributeLocation(name);
+        if (attrib == -1) {
+            // The attribute is not used by the shader
+            return -1;
         }
+        glEnableVertexAttribArray(attrib);
+        glVertexAttribPointer(
+            attrib,
+            size,
+            GL_FLOAT,
+            GL_FALSE,
+            stride,
+            reinterpret_cast<void*>(column * sizeof(GLfloat)) // NOLINT
+        );
+        return attrib;
+    };
+
+    _valueArrayPos = valuePos;
+
+    setAttribute("in_position", 3, 0);
+    const GLint valueAttrib = setAttribute("in_value", 1, valuePos);
+    setAttribute("in_luminance", 1, _lumArrayPos);
+    setAttribute("in_absoluteMagnitude", 1, _absMagArrayPos);
+    setAttribute("in_apparentMagnitude", 1, _appMagArrayPos);
+    setAttribute("in_velocity", 3, _velocityArrayPos);
+    setAttribute("in_speed", 1, _speedArrayPos);
+
+    if (_enableTestGrid && colorOption == ColorOption::Color && valueAttrib != -1) {
+        // All stars in the test grid get the color of the sun
+        constexpr const float SunColor = 0.650f;
+        glDisableVertexAttribArray(valueAttrib);
+        glVertexAttrib1f(valueAttrib, SunColor);
     }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
 }
 
 } // namespace openspace
@@ -33,6 +33,9 @@
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/propertyowner.h>
 #include <openspace/properties/vector/vec2property.h>
+#include <openspace/rendering/starsplatter.h>
+#include <openspace/util/resourceloader.h>
+#include <ghoul/opengl/bufferbinding.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
 #include <optional>
@@ -77,12 +80,35 @@ private:
     static const int _psfTextureSize = 64;
     static const int _convolvedfTextureSize = 257;
 
-    void createDataSlice(ColorOption option);
+    void updateDataLayout();
+
+    /**
+     * Renders the stars with the StarSplatter instead of one billboard per star, which
+     * is only possible for the color options that map a single value onto a color map.
+     */
+    void renderSplatted(const RenderData& data, const glm::dmat4& modelMatrix);
+
+    struct Dataset {
+        std::vector<float> data;
+        int nValuesPerStar = 0;
+        std::vector<std::string> dataNames;
+
+        std::size_t lumArrayPos = 0;
+        std::size_t absMagArrayPos = 0;
+        std::size_t appMagArrayPos = 0;
+        std::size_t bvColorArrayPos = 0;
+        std::size_t velocityArrayPos = 0;
+        std::size_t speedArrayPos = 0;
+    };
 
+    /// Starts loading the speck file asynchronously through the ResourceLoader
     void loadData();
-    void readSpeckFile();
-    bool loadCachedFile(const std::string& file);
-    void saveCachedFile(const std::string& file) const;
+
+    // These functions are executed on a worker thread and must not access the members
+    static Dataset readDataset(const std::string& file, bool enableTestGrid);
+    static Dataset readSpeckFile(const std::string& path, bool enableTestGrid);
+    static std::optional<Dataset> loadCachedFile(const std::string& file);
+    static void saveCachedFile(const std::string& file, const Dataset& dataset);
 
     properties::StringProperty _speckFile;
 
@@ -124,26 +150,36 @@ private:
     properties::PropertyOwner _parametersOwner;
     properties::PropertyOwner _moffatMethodOwner;
 
+    properties::PropertyOwner _splattingOwner;
+    properties::BoolProperty _useSplatting;
+    properties::FloatProperty _splatExposure;
+    properties::FloatProperty _splatBrightStarThreshold;
+    properties::FloatProperty _splatPsfRadius;
+    StarSplatter _splatter;
+    std::unique_ptr<ghoul::opengl::BufferBinding<
+        ghoul::opengl::bufferbinding::Buffer::ShaderStorage>> _splatDataBinding;
+
     std::unique_ptr<ghoul::opengl::ProgramObject> _program;
     UniformCache(
         modelMatrix, cameraUp, cameraViewProjectionMatrix,
         colorOption, magnitudeExponent, eyePosition, psfParamConf,
         lumCent, radiusCent, brightnessCent, colorTexture,
         alphaValue, psfTexture, otherDataTexture, otherDataRange,
-        filterOutOfRange
+        filterOutOfRange, hasStaticFilter, staticFilterValue,
+        staticFilterReplacementValue
     ) _uniformCache;
 
     bool _speckFileIsDirty = true;
     bool _pointSpreadFunctionTextureIsDirty = true;
     bool _colorTextureIsDirty = true;
     //bool _shapeTextureIsDirty = true;
-    bool _dataIsDirty = true;
+    bool _dataLayoutIsDirty = true;
     bool _otherDataColorMapIsDirty = true;
 
     // Test Grid Enabled
     bool _enableTestGrid = false;
 
-    std::vector<float> _slicedData;
+    ResourceLoader::Handle _loadingHandle;
     std::vector<float> _fullData;
 
     int _nValuesPerStar = 0;
@@ -159,6 +195,8 @@ private:
     std::size_t _bvColorArrayPos = 0;
     std::size_t _velocityArrayPos = 0;
     std::size_t _speedArrayPos = 0;
+    /// The column that is mapped onto the color map, as selected in updateDataLayout
+    std::size_t _valueArrayPos = 0;
 
     GLuint _vao = 0;
     GLuint _vbo = 0;
@@ -102,7 +102,7 @@ SpiceRotation::SpiceRotation(const ghoul::Dictionary& dictionary)
     , _destinationFrame(DestinationInfo)
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "SpiceRotation"
     );
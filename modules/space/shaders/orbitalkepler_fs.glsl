@@ -0,0 +1,66 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "fragment.glsl"
+
+in vec4 vs_positionScreenSpace;
+in vec4 vs_gPosition;
+in float fade;
+
+uniform vec3 color;
+uniform int renderPhase;
+uniform float opacity = 1.0;
+
+// Fragile! Keep in sync with RenderableOrbitalKepler::render
+#define RenderPhaseLines 0
+#define RenderPhasePoints 1
+
+#define Delta 0.25
+
+
+Fragment getFragment() {
+    Fragment frag;
+    frag.color = vec4(color * fade, fade * opacity);
+    frag.depth = vs_positionScreenSpace.w;
+    frag.blend = BLEND_MODE_ADDITIVE;
+
+    if (renderPhase == RenderPhasePoints) {
+        // The points are the heads of the trails and are never faded
+        frag.color = vec4(color, opacity);
+
+        vec2 circCoord = 2.0 * gl_PointCoord - 1.0;
+        float circleClipping = smoothstep(1.0, 1.0 - Delta, dot(circCoord, circCoord));
+        if (circleClipping < 0.1) {
+            discard;
+        }
+        frag.color.a *= circleClipping;
+    }
+
+    frag.gPosition = vs_gPosition;
+
+    // There is no normal here
+    frag.gNormal = vec4(0.0, 0.0, -1.0, 1.0);
+
+    return frag;
+}
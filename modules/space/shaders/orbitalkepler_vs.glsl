@@ -0,0 +1,89 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+#include "PowerScaling/powerScaling_vs.hglsl"
+
+// Fragile! Keep in sync with RenderableOrbitalKepler::KeplerOrbit
+layout(location = 0) in vec2 in_shape;      // eccentricity, semi-major axis (m)
+layout(location = 1) in mat3 in_orbitPlane;
+layout(location = 4) in dvec3 in_timing;    // epoch, mean anomaly, mean motion
+
+out vec4 vs_positionScreenSpace;
+out vec4 vs_gPosition;
+out float fade;
+
+uniform dmat4 modelViewTransform;
+uniform mat4 projectionTransform;
+uniform double time;
+uniform float lineFade;
+uniform float trailLength;
+uniform int nSegments;
+uniform int pointSize;
+
+const double TwoPi = 6.28318530717958647692lf;
+
+// Same Newton-Raphson iteration as in KeplerTranslation::eccentricAnomaly
+float eccentricAnomaly(float meanAnomaly, float e) {
+    float E = (e < 0.8) ? meanAnomaly : 3.14159265359;
+    for (int i = 0; i < 8; ++i) {
+        E = E - (E - e * sin(E) - meanAnomaly) / (1.0 - e * cos(E));
+    }
+    return E;
+}
+
+
+void main() {
+    float e = in_shape.x;
+    float a = in_shape.y;
+
+    // The mean anomaly grows without bound, so it has to be reduced in double
+    // precision before single precision is good enough again
+    double epoch = in_timing.x;
+    double meanAnomaly = in_timing.y + in_timing.z * (time - epoch);
+    meanAnomaly = meanAnomaly - TwoPi * floor(meanAnomaly / TwoPi);
+
+    // The first vertex of each trail is the current position of the body
+    float t = float(gl_VertexID) / float(nSegments);
+    float M = float(meanAnomaly) - t * trailLength * float(TwoPi);
+
+    float E = eccentricAnomaly(M, e);
+    vec3 p = in_orbitPlane * vec3(
+        a * (cos(E) - e),
+        a * sin(E) * sqrt(1.0 - e * e),
+        0.0
+    );
+
+    fade = clamp((1.0 - t) * lineFade, 0.0, 1.0);
+    if (lineFade == 0.0) {
+        fade = 1.0;
+    }
+
+    vs_gPosition = vec4(modelViewTransform * dvec4(p, 1.0));
+    vs_positionScreenSpace = z_normalization(projectionTransform * vs_gPosition);
+
+    gl_PointSize = float(pointSize);
+    gl_Position  = vs_positionScreenSpace;
+}
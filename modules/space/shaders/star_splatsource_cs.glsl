@@ -0,0 +1,72 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#version __CONTEXT__
+
+#include "starsplatter/splatstar.glsl"
+
+// Provides the stars of RenderableStars to the StarSplatter. The buffer is the vertex
+// buffer of the speck data, whose columns are selected by RenderableStars
+
+const float Parsec = 3.08567756E16;
+
+layout(std430) readonly buffer StarData {
+    float starData[];
+};
+
+uniform int nValuesPerStar;
+uniform int absoluteMagnitudeColumn;
+uniform int valueColumn;
+
+uniform bool hasFixedValue;
+uniform float fixedValue;
+uniform bool hasStaticFilter;
+uniform float staticFilterValue;
+uniform float staticFilterReplacementValue;
+uniform bool filterOutOfRange;
+uniform vec2 valueRange;
+
+bool splatStar(uint index, out SplatStar star) {
+    int base = int(index) * nValuesPerStar;
+    vec3 position = vec3(starData[base], starData[base + 1], starData[base + 2]);
+
+    // The sun is not displayed, as in the geometry shader of the billboards
+    if (position == vec3(0.0)) {
+        return false;
+    }
+
+    float value = hasFixedValue ? fixedValue : starData[base + valueColumn];
+    if (hasStaticFilter && value == staticFilterValue) {
+        value = staticFilterReplacementValue;
+    }
+    if (filterOutOfRange && (value < valueRange.x || value > valueRange.y)) {
+        return false;
+    }
+
+    star.position = position * Parsec;
+    star.absoluteMagnitude = starData[base + absoluteMagnitudeColumn];
+    star.colorValue = value;
+    return true;
+}
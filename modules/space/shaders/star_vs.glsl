@@ -26,19 +26,46 @@
 
 #include "PowerScaling/powerScaling_vs.hglsl"
 
-in vec3 in_position;
-in vec4 in_bvLumAbsMagAppMag;
+// keep in sync with renderablestars.h:ColorOption enum
+const int COLOROPTION_OTHERDATA = 3;
+
+const float PARSEC = 3.08567756E16;
+
+// The attributes point directly into the columns of the speck data, the columns that
+// are used for the value, luminance, etc are selected by RenderableStars
+in vec3 in_position; // in parsec
+in float in_value;
+in float in_luminance;
+in float in_absoluteMagnitude;
+in float in_apparentMagnitude;
 in vec3 in_velocity;
 in float in_speed;
 
+uniform int colorOption;
+uniform bool hasStaticFilter;
+uniform float staticFilterValue;
+uniform float staticFilterReplacementValue;
+
 out vec4 vs_bvLumAbsMagAppMag;
 out vec3 vs_velocity;
 out float vs_speed;
 
 void main() {
-    vs_bvLumAbsMagAppMag = in_bvLumAbsMagAppMag;
+    float value = in_value;
+    if (colorOption == COLOROPTION_OTHERDATA && hasStaticFilter &&
+        value == staticFilterValue)
+    {
+        value = staticFilterReplacementValue;
+    }
+
+    vs_bvLumAbsMagAppMag = vec4(
+        value,
+        in_luminance,
+        in_absoluteMagnitude,
+        in_apparentMagnitude
+    );
     vs_velocity          = in_velocity;
     vs_speed             = in_speed;
 
-    gl_Position = vec4(in_position, 1.0);
+    gl_Position = vec4(in_position * PARSEC, 1.0);
 }
@@ -25,6 +25,7 @@
 #include <modules/space/spacemodule.h>
 
 #include <modules/space/rendering/renderableconstellationbounds.h>
+#include <modules/space/rendering/renderableorbitalkepler.h>
 #include <modules/space/rendering/renderablerings.h>
 #include <modules/space/rendering/renderablestars.h>
 #include <modules/space/rendering/simplespheregeometry.h>
@@ -77,6 +78,7 @@ void SpaceModule::internalInitialize(const ghoul::Dictionary&) {
         "RenderableConstellationBounds"
     );
 
+    fRenderable->registerClass<RenderableOrbitalKepler>("RenderableOrbitalKepler");
     fRenderable->registerClass<RenderableRings>("RenderableRings");
     fRenderable->registerClass<RenderableStars>("RenderableStars");
 
@@ -105,6 +107,7 @@ void SpaceModule::internalDeinitializeGL() {
 std::vector<documentation::Documentation> SpaceModule::documentations() const {
     return {
         RenderableConstellationBounds::Documentation(),
+        RenderableOrbitalKepler::Documentation(),
         RenderableRings::Documentation(),
         RenderableStars::Documentation(),
         SpiceRotation::Documentation(),
@@ -28,14 +28,22 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/fmt.h>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/lua_helper.h>
+#include <algorithm>
 #include <fstream>
 
 namespace {
     constexpr const char* _loggerCat = "HorizonsTranslation";
+
+    constexpr const int8_t CurrentCacheVersion = 1;
+
+    // The maximum deviation (in seconds) between the spacing of two samples for them to
+    // still be considered equidistant
+    constexpr const double TimeStepEpsilon = 1e-3;
 } // namespace
 
 namespace {
@@ -45,6 +53,14 @@ namespace {
         "This value is the path to the text file generated by Horizons with observer "
         "range and Galactiv longitude and latitude for different timestamps."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo HermiteInterpolationInfo = {
+        "HermiteInterpolation",
+        "Hermite Interpolation",
+        "If this value is enabled, the position between two samples is interpolated "
+        "using a cubic Hermite spline with velocities estimated from the neighboring "
+        "samples. Otherwise, the position is interpolated linearly."
+    };
 } // namespace
 
 namespace openspace {
@@ -65,6 +81,12 @@ documentation::Documentation HorizonsTranslation::Documentation() {
                 new StringVerifier,
                 Optional::No,
                 HorizonsTextFileInfo.description
+            },
+            {
+                HermiteInterpolationInfo.identifier,
+                new BoolVerifier,
+                Optional::Yes,
+                HermiteInterpolationInfo.description
             }
         }
     };
@@ -73,8 +95,11 @@ documentation::Documentation HorizonsTranslation::Documentation() {
 
 HorizonsTranslation::HorizonsTranslation()
     : _horizonsTextFile(HorizonsTextFileInfo)
+    , _useHermiteInterpolation(HermiteInterpolationInfo, false)
 {
     addProperty(_horizonsTextFile);
+    _useHermiteInterpolation.onChange([&]() { requireUpdate(); });
+    addProperty(_useHermiteInterpolation);
 
     _horizonsTextFile.onChange([&](){
         requireUpdate();
@@ -83,7 +108,7 @@ HorizonsTranslation::HorizonsTranslation()
              requireUpdate();
              notifyObservers();
          });
-        readHorizonsTextFile(_horizonsTextFile);
+        loadData();
     });
 }
 
@@ -91,7 +116,7 @@ HorizonsTranslation::HorizonsTranslation(const ghoul::Dictionary& dictionary)
     : HorizonsTranslation()
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "HorizonsTranslation"
     );
@@ -100,58 +125,230 @@ HorizonsTranslation::HorizonsTranslation(const ghoul::Dictionary& dictionary)
         dictionary.value<std::string>(HorizonsTextFileInfo.identifier)
     );
 
+    if (dictionary.hasKey(HermiteInterpolationInfo.identifier)) {
+        _useHermiteInterpolation = dictionary.value<bool>(
+            HermiteInterpolationInfo.identifier
+        );
+    }
+
     // Read specified file and store it in memory.
-    readHorizonsTextFile(_horizonsTextFile);
+    loadData();
 }
 
 glm::dvec3 HorizonsTranslation::position(const UpdateData& data) const {
-    glm::dvec3 interpolatedPos = glm::dvec3(0.0);
-
-    auto lastBefore = _timeline.lastKeyframeBefore(data.time.j2000Seconds(), true);
-    auto firstAfter = _timeline.firstKeyframeAfter(data.time.j2000Seconds(), false);
-    if (lastBefore && firstAfter) {
-        // We're inbetween first and last value.
-        double timelineDiff = firstAfter->timestamp - lastBefore->timestamp;
-        double timeDiff = data.time.j2000Seconds() - lastBefore->timestamp;
-        double diff = (timelineDiff > DBL_EPSILON) ? timeDiff / timelineDiff : 0.0;
+    if (_times.empty()) {
+        return glm::dvec3(0.0);
+    }
 
-        glm::dvec3 dir = firstAfter->data - lastBefore->data;
-        interpolatedPos = lastBefore->data + dir * diff;
+    const double time = data.time.j2000Seconds();
+    if (time <= _times.front()) {
+        // Requesting a time before first value. Return first known position.
+        return _positions.front();
     }
-    else if (lastBefore) {
+    if (time >= _times.back()) {
         // Requesting a time after last value. Return last known position.
-        interpolatedPos = lastBefore->data;
+        return _positions.back();
+    }
+
+    // We're inbetween first and last value.
+    const size_t i = intervalIndex(time);
+    const double timelineDiff = _times[i + 1] - _times[i];
+    const double timeDiff = time - _times[i];
+    const double t = (timelineDiff > DBL_EPSILON) ? timeDiff / timelineDiff : 0.0;
+
+    if (!_useHermiteInterpolation) {
+        return _positions[i] + (_positions[i + 1] - _positions[i]) * t;
+    }
+
+    // Cubic Hermite basis functions, the tangents are scaled to the unit interval
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+    const double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+    const double h10 = t3 - 2.0 * t2 + t;
+    const double h01 = -2.0 * t3 + 3.0 * t2;
+    const double h11 = t3 - t2;
+    return h00 * _positions[i] + h10 * timelineDiff * _velocities[i] +
+           h01 * _positions[i + 1] + h11 * timelineDiff * _velocities[i + 1];
+}
+
+size_t HorizonsTranslation::intervalIndex(double time) const {
+    // The caller guarantees that _times.front() < time < _times.back()
+    if (_timeStep > 0.0) {
+        size_t i = std::min(
+            static_cast<size_t>((time - _times.front()) / _timeStep),
+            _times.size() - 2
+        );
+        // The samples are only equidistant up to TimeStepEpsilon, so the computed index
+        // might be off by one
+        if (time < _times[i] && i > 0) {
+            --i;
+        }
+        else if (time >= _times[i + 1] && i + 2 < _times.size()) {
+            ++i;
+        }
+        return i;
+    }
+    else {
+        const auto it = std::upper_bound(_times.begin(), _times.end(), time);
+        return std::distance(_times.begin(), it) - 1;
     }
-    else if (firstAfter) {
-        // Requesting a time before first value. Return last known position.
-        interpolatedPos = firstAfter->data;
+}
+
+void HorizonsTranslation::loadData() {
+    _times.clear();
+    _positions.clear();
+    _velocities.clear();
+    _timeStep = 0.0;
+
+    const std::string file = _horizonsTextFile;
+    if (!FileSys.fileExists(file)) {
+        LERROR(fmt::format("Failed to open Horizons text file '{}'", file));
+        return;
     }
 
-    return interpolatedPos;
+    const std::string cachedFile = FileSys.cacheManager()->cachedFilename(
+        ghoul::filesystem::File(file),
+        "HorizonsTranslation",
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+
+    const bool hasCachedFile = FileSys.fileExists(cachedFile);
+    if (hasCachedFile) {
+        LINFO(fmt::format(
+            "Cached file '{}' used for Horizons file '{}'", cachedFile, file
+        ));
+
+        const bool success = loadCachedFile(cachedFile);
+        if (success) {
+            computeVelocities();
+            return;
+        }
+        else {
+            FileSys.cacheManager()->removeCacheFile(file);
+            _times.clear();
+            _positions.clear();
+            // Intentional fall-through to the 'else' computation to generate the cache
+            // file for the next run
+        }
+    }
+    else {
+        LINFO(fmt::format("Cache for Horizons file '{}' not found", file));
+    }
+    LINFO(fmt::format("Loading Horizons file '{}'", file));
+
+    const bool success = readHorizonsTextFile(file);
+    if (success) {
+        computeVelocities();
+        saveCachedFile(cachedFile);
+    }
 }
 
-void HorizonsTranslation::readHorizonsTextFile(const std::string& horizonsTextFilePath) {
+bool HorizonsTranslation::loadCachedFile(const std::string& file) {
+    std::ifstream fileStream(file, std::ifstream::binary);
+    if (!fileStream.good()) {
+        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
+        return false;
+    }
+
+    int8_t version = 0;
+    fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (version != CurrentCacheVersion) {
+        LINFO("The format of the cached file has changed: deleting old cache");
+        return false;
+    }
+
+    uint64_t nSamples = 0;
+    fileStream.read(reinterpret_cast<char*>(&nSamples), sizeof(uint64_t));
+
+    _times.resize(nSamples);
+    _positions.resize(nSamples);
+    fileStream.read(
+        reinterpret_cast<char*>(_times.data()),
+        nSamples * sizeof(double)
+    );
+    fileStream.read(
+        reinterpret_cast<char*>(_positions.data()),
+        nSamples * sizeof(glm::dvec3)
+    );
+
+    return fileStream.good();
+}
+
+void HorizonsTranslation::saveCachedFile(const std::string& file) const {
+    std::ofstream fileStream(file, std::ofstream::binary);
+    if (!fileStream.good()) {
+        LERROR(fmt::format("Error opening file '{}' for saving cache file", file));
+        return;
+    }
+
+    fileStream.write(
+        reinterpret_cast<const char*>(&CurrentCacheVersion),
+        sizeof(int8_t)
+    );
+
+    const uint64_t nSamples = _times.size();
+    fileStream.write(reinterpret_cast<const char*>(&nSamples), sizeof(uint64_t));
+    fileStream.write(
+        reinterpret_cast<const char*>(_times.data()),
+        nSamples * sizeof(double)
+    );
+    fileStream.write(
+        reinterpret_cast<const char*>(_positions.data()),
+        nSamples * sizeof(glm::dvec3)
+    );
+}
+
+void HorizonsTranslation::computeVelocities() {
+    const size_t n = _times.size();
+    _velocities.assign(n, glm::dvec3(0.0));
+    _timeStep = 0.0;
+    if (n < 2) {
+        return;
+    }
+
+    // Central differences in the interior, one-sided differences at the ends
+    for (size_t i = 0; i < n; ++i) {
+        const size_t prev = (i == 0) ? 0 : i - 1;
+        const size_t next = (i == n - 1) ? n - 1 : i + 1;
+        const double dt = _times[next] - _times[prev];
+        if (dt > DBL_EPSILON) {
+            _velocities[i] = (_positions[next] - _positions[prev]) / dt;
+        }
+    }
+
+    const double step = _times[1] - _times[0];
+    for (size_t i = 1; i < n; ++i) {
+        if (std::abs((_times[i] - _times[i - 1]) - step) > TimeStepEpsilon) {
+            // Not equidistant, so we have to fall back to a binary search
+            return;
+        }
+    }
+    _timeStep = step;
+}
+
+bool HorizonsTranslation::readHorizonsTextFile(const std::string& horizonsTextFilePath) {
     std::ifstream fileStream(horizonsTextFilePath);
 
     if (!fileStream.good()) {
         LERROR(fmt::format(
             "Failed to open Horizons text file '{}'", horizonsTextFilePath
         ));
-        return;
+        return false;
     }
 
     // The beginning of a Horizons file has a header with a lot of information about the
     // query that we do not care about. Ignore everything until data starts, including
     // the row marked by $$SOE (i.e. Start Of Ephemerides).
     std::string line;
-    while (line[0] != '$') {
-        std::getline(fileStream, line);
-    }
+    while (std::getline(fileStream, line) && (line.empty() || line[0] != '$')) {}
 
     // Read data line by line until $$EOE (i.e. End Of Ephemerides).
     // Skip the rest of the file.
-    std::getline(fileStream, line);
-    while (line[0] != '$') {
+    while (std::getline(fileStream, line) && (line.empty() || line[0] != '$')) {
+        if (line.empty()) {
+            continue;
+        }
+
         std::stringstream str(line);
         std::string date;
         std::string time;
@@ -178,12 +375,22 @@ void HorizonsTranslation::readHorizonsTextFile(const std::string& horizonsTextFi
             1000 * range * sin(glm::radians(gLat))
         );
 
-        // Add position to stored timeline.
-        _timeline.addKeyframe(timeInJ2000, gPos);
+        // The lookup in position() requires strictly increasing timestamps
+        if (!_times.empty() && timeInJ2000 <= _times.back()) {
+            LWARNING(fmt::format(
+                "Ignoring out-of-order sample at '{}' in '{}'",
+                timeString, horizonsTextFilePath
+            ));
+            continue;
+        }
 
-        std::getline(fileStream, line);
+        // Add position to stored timeline.
+        _times.push_back(timeInJ2000);
+        _positions.push_back(gPos);
     }
     fileStream.close();
+
+    return !_times.empty();
 }
 
 } // namespace openspace
@@ -28,10 +28,11 @@
 #include <openspace/scene/translation.h>
 
 #include <openspace/properties/stringproperty.h>
-#include <openspace/util/timeline.h>
+#include <openspace/properties/scalar/boolproperty.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/lua/luastate.h>
 #include <memory>
+#include <vector>
 
 namespace openspace {
 
@@ -48,6 +49,13 @@ namespace documentation { struct Documentation; }
  * kilometers.
  * GalLon - Galactic Longitude. User must set output to Degrees in "Table Settings".
  * GalLat - Galactic Latitude. User must set output to Degrees in "Table Settings".
+ *
+ * The parsed positions are stored in a persistent binary cache, so that large exports
+ * only have to be parsed once. If the samples are equidistant in time, which is the case
+ * for all regular Horizons exports, the keyframe for a time is found by direct indexing,
+ * otherwise a binary search is used. Between two samples, the position is either
+ * interpolated linearly or with a cubic Hermite spline whose velocities are estimated
+ * from the neighboring samples.
  */
 class HorizonsTranslation : public Translation {
 public:
@@ -59,12 +67,31 @@ public:
     static documentation::Documentation Documentation();
 
 private:
-    void readHorizonsTextFile(const std::string& _horizonsTextFilePath);
+    /// Loads the samples either from the cache or from the Horizons text file
+    void loadData();
+    bool readHorizonsTextFile(const std::string& _horizonsTextFilePath);
+    bool loadCachedFile(const std::string& file);
+    void saveCachedFile(const std::string& file) const;
+
+    /**
+     * Estimates the velocity at each sample from its neighbors and determines whether the
+     * samples are equidistant, in which case \c _timeStep is set to their spacing.
+     */
+    void computeVelocities();
+
+    /// Returns the index \c i of the sample for which _times[i] <= time < _times[i+1]
+    size_t intervalIndex(double time) const;
 
     properties::StringProperty _horizonsTextFile;
+    properties::BoolProperty _useHermiteInterpolation;
     std::unique_ptr<ghoul::filesystem::File> _fileHandle;
     ghoul::lua::LuaState _state;
-    Timeline<glm::dvec3> _timeline;
+
+    std::vector<double> _times;
+    std::vector<glm::dvec3> _positions;
+    std::vector<glm::dvec3> _velocities;
+    /// The spacing of the samples, or 0 if they are not equidistant
+    double _timeStep = 0.0;
 };
 
 } // namespace openspace
@@ -220,7 +220,7 @@ KeplerTranslation::KeplerTranslation(const ghoul::Dictionary& dictionary)
     : KeplerTranslation()
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "KeplerTranslation"
     );
@@ -284,6 +284,10 @@ double KeplerTranslation::eccentricAnomaly(double meanAnomaly) const {
     }
 }
 
+bool KeplerTranslation::isThreadSafe() const {
+    return true;
+}
+
 glm::dvec3 KeplerTranslation::position(const UpdateData& data) const {
     if (_orbitPlaneDirty) {
         computeOrbitPlane();
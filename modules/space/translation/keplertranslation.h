@@ -68,6 +68,9 @@ public:
     */
     glm::dvec3 position(const UpdateData& data) const override;
 
+    /// The orbit plane is cached by the first call to position, which only reads state
+    bool isThreadSafe() const override;
+
     /**
      * Method returning the openspace::Documentation that describes the ghoul::Dictinoary
      * that can be passed to the constructor.
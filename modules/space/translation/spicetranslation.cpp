@@ -31,10 +31,19 @@
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cmath>
 
 namespace {
+    constexpr const char* _loggerCat = "SpiceTranslation";
+
     constexpr const char* KeyKernels = "Kernels";
+    constexpr const char* KeyPrecomputeTable = "PrecomputeTable";
+    constexpr const char* KeyTableStartTime = "TableStartTime";
+    constexpr const char* KeyTableEndTime = "TableEndTime";
+    constexpr const char* KeyTableSegmentDuration = "TableSegmentDuration";
 
     constexpr const char* DefaultReferenceFrame = "GALACTIC";
 
@@ -60,6 +69,25 @@ namespace {
         "This is the SPICE NAIF name for the reference frame in which the position "
         "should be retrieved. The default value is GALACTIC."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo TableErrorInfo = {
+        "TableError",
+        "Table Error (m)",
+        "This value is the largest deviation, in meters, between the precomputed "
+        "ephemeris table and the SPICE kernels, measured in the middle of each table "
+        "segment. It is 0 if no table is used."
+    };
+
+    // Cubic Hermite interpolation between the positions p0 and p1 with the velocities v0
+    // and v1, for a segment of length dt and the relative time t in [0,1]
+    glm::dvec3 hermite(const glm::dvec3& p0, const glm::dvec3& v0, const glm::dvec3& p1,
+                       const glm::dvec3& v1, double dt, double t)
+    {
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        return (2.0 * t3 - 3.0 * t2 + 1.0) * p0 + (t3 - 2.0 * t2 + t) * dt * v0 +
+               (-2.0 * t3 + 3.0 * t2) * p1 + (t3 - t2) * dt * v1;
+    }
 } // namespace
 
 namespace openspace {
@@ -105,6 +133,34 @@ documentation::Documentation SpiceTranslation::Documentation() {
                 "A single kernel or list of kernels that this SpiceTranslation depends "
                 "on. All provided kernels will be loaded before any other operation is "
                 "performed."
+            },
+            {
+                KeyPrecomputeTable,
+                new BoolVerifier,
+                Optional::Yes,
+                "If this value is 'true', the position is precomputed as a piecewise "
+                "cubic polynomial in the table time window and evaluated without calling "
+                "SPICE. Outside the window, the kernels are used. Defaults to 'false'."
+            },
+            {
+                KeyTableStartTime,
+                new StringAnnotationVerifier("A valid date in ISO 8601 format"),
+                Optional::Yes,
+                "The start of the precomputed table. If the start or the end are not "
+                "specified, the table covers the SPK coverage of the target."
+            },
+            {
+                KeyTableEndTime,
+                new StringAnnotationVerifier("A valid date in ISO 8601 format"),
+                Optional::Yes,
+                "The end of the precomputed table."
+            },
+            {
+                KeyTableSegmentDuration,
+                new DoubleGreaterVerifier(0.0),
+                Optional::Yes,
+                "The length, in seconds, of each polynomial segment of the precomputed "
+                "table. Defaults to one day."
             }
         }
     };
@@ -114,9 +170,10 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
     : _target(TargetInfo)
     , _observer(ObserverInfo)
     , _frame(FrameInfo, DefaultReferenceFrame)
+    , _tableError(TableErrorInfo, 0.0, 0.0, 1e12)
 {
     documentation::testSpecificationAndThrow(
-        Documentation(),
+        Documentation,
         dictionary,
         "SpiceTranslation"
     );
@@ -156,7 +213,24 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
         }
     }
 
+    if (dictionary.hasKey(KeyPrecomputeTable)) {
+        _usesEphemerisTable = dictionary.value<bool>(KeyPrecomputeTable);
+    }
+    if (dictionary.hasKey(KeyTableStartTime) && dictionary.hasKey(KeyTableEndTime)) {
+        _hasTableTimeWindow = true;
+        _tableStartTime = Time::convertTime(
+            dictionary.value<std::string>(KeyTableStartTime)
+        );
+        _tableEndTime = Time::convertTime(
+            dictionary.value<std::string>(KeyTableEndTime)
+        );
+    }
+    if (dictionary.hasKey(KeyTableSegmentDuration)) {
+        _tableSegmentDuration = dictionary.value<double>(KeyTableSegmentDuration);
+    }
+
     auto update = [this](){
+        createEphemerisTable();
         requireUpdate();
         notifyObservers();
     };
@@ -169,16 +243,137 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
 
     _frame.onChange(update);
     addProperty(_frame);
+
+    _tableError.setReadOnly(true);
+    if (_usesEphemerisTable) {
+        addProperty(_tableError);
+    }
+
+    createEphemerisTable();
+}
+
+void SpiceTranslation::createEphemerisTable() {
+    _table = EphemerisTable();
+    _tableError = 0.0;
+    if (!_usesEphemerisTable) {
+        return;
+    }
+
+    double start = _tableStartTime;
+    double end = _tableEndTime;
+    if (!_hasTableTimeWindow) {
+        using Interval = std::pair<double, double>;
+        std::vector<Interval> coverage = SpiceManager::ref().spkCoverage(_target);
+        if (coverage.empty()) {
+            LWARNING(fmt::format(
+                "No SPK coverage found for '{}'. Provide '{}' and '{}' to precompute "
+                "the ephemeris table", _target.value(), KeyTableStartTime, KeyTableEndTime
+            ));
+            return;
+        }
+        start = std::min_element(
+            coverage.begin(),
+            coverage.end(),
+            [](const Interval& a, const Interval& b) { return a.first < b.first; }
+        )->first;
+        end = std::max_element(
+            coverage.begin(),
+            coverage.end(),
+            [](const Interval& a, const Interval& b) { return a.second < b.second; }
+        )->second;
+    }
+    if (end <= start) {
+        LWARNING(fmt::format("Empty ephemeris table window for '{}'", _target.value()));
+        return;
+    }
+
+    const size_t nSegments = std::max(
+        static_cast<size_t>(std::ceil((end - start) / _tableSegmentDuration)),
+        size_t(1)
+    );
+    const double duration = (end - start) / nSegments;
+
+    EphemerisTable table;
+    table.startTime = start;
+    table.segmentDuration = duration;
+    table.positions.reserve(nSegments + 1);
+    table.velocities.reserve(nSegments + 1);
+
+    double maxError = 0.0;
+    try {
+        for (size_t i = 0; i <= nSegments; ++i) {
+            SpiceManager::TargetStateResult state = SpiceManager::ref().targetState(
+                _target,
+                _observer,
+                _frame,
+                {},
+                start + i * duration
+            );
+            table.positions.push_back(state.position);
+            table.velocities.push_back(state.velocity);
+        }
+
+        for (size_t i = 0; i < nSegments; ++i) {
+            const glm::dvec3 kernelPosition = SpiceManager::ref().targetPosition(
+                _target,
+                _observer,
+                _frame,
+                {},
+                start + (i + 0.5) * duration
+            );
+            const glm::dvec3 tablePosition = hermite(
+                table.positions[i],
+                table.velocities[i],
+                table.positions[i + 1],
+                table.velocities[i + 1],
+                duration,
+                0.5
+            );
+            maxError = std::max(maxError, glm::distance(kernelPosition, tablePosition));
+        }
+    }
+    catch (const SpiceManager::SpiceException& e) {
+        LERROR(fmt::format(
+            "Could not precompute the ephemeris table for '{}': {}",
+            _target.value(), e.message
+        ));
+        return;
+    }
+
+    _table = std::move(table);
+    _tableError = maxError * 1000.0;
+    LDEBUG(fmt::format(
+        "Precomputed {} segments for '{}' with a maximum error of {} m",
+        nSegments, _target.value(), _tableError.value()
+    ));
 }
 
 glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
+    const double time = data.time.j2000Seconds();
+
+    if (!_table.positions.empty()) {
+        const size_t nSegments = _table.positions.size() - 1;
+        const double t = (time - _table.startTime) / _table.segmentDuration;
+        if (t >= 0.0 && t <= static_cast<double>(nSegments)) {
+            const size_t i = std::min(static_cast<size_t>(t), nSegments - 1);
+            return hermite(
+                _table.positions[i],
+                _table.velocities[i],
+                _table.positions[i + 1],
+                _table.velocities[i + 1],
+                _table.segmentDuration,
+                t - static_cast<double>(i)
+            ) * glm::pow(10.0, 3.0);
+        }
+    }
+
     double lightTime = 0.0;
     return SpiceManager::ref().targetPosition(
         _target,
         _observer,
         _frame,
         {},
-        data.time.j2000Seconds(),
+        time,
         lightTime
     ) * glm::pow(10.0, 3.0);
 }
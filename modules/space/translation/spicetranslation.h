@@ -28,6 +28,8 @@
 #include <openspace/scene/translation.h>
 
 #include <openspace/properties/stringproperty.h>
+#include <openspace/properties/scalar/doubleproperty.h>
+#include <vector>
 
 namespace openspace {
 
@@ -40,9 +42,33 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /// Piecewise cubic Hermite interpolation table of the target's position
+    struct EphemerisTable {
+        double startTime = 0.0;
+        double segmentDuration = 0.0;
+        /// Positions (km) and velocities (km/s) at the boundaries of the segments
+        std::vector<glm::dvec3> positions;
+        std::vector<glm::dvec3> velocities;
+    };
+
+    /**
+     * Samples the target's state at the segment boundaries of the table and measures the
+     * deviation from the kernels in the middle of each segment. The table is left empty
+     * if it is disabled or if the kernels do not cover the whole time window.
+     */
+    void createEphemerisTable();
+
     properties::StringProperty _target;
     properties::StringProperty _observer;
     properties::StringProperty _frame;
+    properties::DoubleProperty _tableError;
+
+    bool _usesEphemerisTable = false;
+    bool _hasTableTimeWindow = false;
+    double _tableStartTime = 0.0;
+    double _tableEndTime = 0.0;
+    double _tableSegmentDuration = 86400.0;
+    EphemerisTable _table;
 
     glm::dvec3 _position;
 };
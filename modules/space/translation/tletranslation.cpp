@@ -27,13 +27,19 @@
 #include <openspace/documentation/verifier.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <sys/stat.h>
 #include <chrono>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace {
     constexpr const char* KeyFile = "File";
     constexpr const char* KeyLineNumber = "LineNumber";
+    constexpr const char* KeyNoradId = "NoradId";
 
     // The list of leap years only goes until 2056 as we need to touch this file then
     // again anyway ;)
@@ -226,82 +232,22 @@ namespace {
         // We need the semi major axis in km instead of m
         return semiMajorAxis / 1000.0;
     }
-} // namespace
-
-
-namespace openspace {
-
-documentation::Documentation TLETranslation::Documentation() {
-    using namespace openspace::documentation;
-    return {
-        "TLE Translation",
-        "space_transform_tle",
-        {
-            {
-                "Type",
-                new StringEqualVerifier("TLETranslation"),
-               Optional::No
-            },
-            {
-                KeyFile,
-                new StringVerifier,
-                Optional::No,
-                "Specifies the filename of the Two-Line-Element file"
-            },
-            {
-                KeyLineNumber,
-                new DoubleGreaterVerifier(0),
-                Optional::Yes,
-                "Specifies the line number within the file where the group of 3 TLE "
-                "lines begins (1-based). Defaults to 1."
-            }
-        }
-    };
-}
-
-TLETranslation::TLETranslation(const ghoul::Dictionary& dictionary) {
-    documentation::testSpecificationAndThrow(
-        Documentation(),
-        dictionary,
-        "TLETranslation"
-    );
 
-    const std::string& file = dictionary.value<std::string>(KeyFile);
-    int lineNum = 1;
-    if (dictionary.hasKeyAndValue<double>(KeyLineNumber)) {
-        lineNum = static_cast<int>(dictionary.value<double>(KeyLineNumber));
-    }
-    readTLEFile(file, lineNum);
-}
-
-void TLETranslation::readTLEFile(const std::string& filename, int lineNum) {
-    ghoul_assert(FileSys.fileExists(filename), "The filename must exist");
-
-    std::ifstream file;
-    file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
-    file.open(filename);
-
-    // All of the Kepler element information
-    struct {
+    // All of the Kepler element information of one satellite
+    struct TleElements {
         double inclination = 0.0;
         double semiMajorAxis = 0.0;
         double ascendingNode = 0.0;
         double eccentricity = 0.0;
         double argumentOfPeriapsis = 0.0;
         double meanAnomaly = 0.0;
-        double meanMotion = 0.0;
+        double period = 0.0;
         double epoch = 0.0;
-    } keplerElements;
+    };
 
-    std::string line;
-    // Loop through and throw out lines until getting to the linNum of interest
-    for (int i = 1; i < lineNum; ++i) {
-        std::getline(file, line);
-    }
-    std::getline(file, line); // Throw out the TLE title line (1st)
+    TleElements parseElements(const std::string& line1, const std::string& line2) {
+        TleElements elements;
 
-    std::getline(file, line); // Get line 1 of TLE format
-    if (line[0] == '1') {
         // First line
         // Field Columns   Content
         //     1   01-01   Line number
@@ -318,15 +264,8 @@ void TLETranslation::readTLEFile(const std::string& filename, int lineNum) {
         //    12   63-63   The "Ephemeris type"
         //    13   65-68   Element set  number.Incremented when a new TLE is generated
         //    14   69-69   Checksum (modulo 10)
-        keplerElements.epoch = epochFromSubstring(line.substr(18, 14));
-    } else {
-        throw ghoul::RuntimeError(fmt::format(
-            "File {} @ line {} does not have '1' header", filename, lineNum + 1
-        ));
-    }
+        elements.epoch = epochFromSubstring(line1.substr(18, 14));
 
-    std::getline(file, line); // Get line 2 of TLE format
-    if (line[0] == '2') {
         // Second line
         // Field    Columns   Content
         //     1      01-01   Line number
@@ -344,56 +283,214 @@ void TLETranslation::readTLEFile(const std::string& filename, int lineNum) {
         stream.exceptions(std::ios::failbit);
 
         // Get inclination
-        stream.str(line.substr(8, 8));
-        stream >> keplerElements.inclination;
+        stream.str(line2.substr(8, 8));
+        stream >> elements.inclination;
         stream.clear();
 
         // Get Right ascension of the ascending node
-        stream.str(line.substr(17, 8));
-        stream >> keplerElements.ascendingNode;
+        stream.str(line2.substr(17, 8));
+        stream >> elements.ascendingNode;
         stream.clear();
 
         // Get Eccentricity
-        stream.str("0." + line.substr(26, 7));
-        stream >> keplerElements.eccentricity;
+        stream.str("0." + line2.substr(26, 7));
+        stream >> elements.eccentricity;
         stream.clear();
 
         // Get argument of periapsis
-        stream.str(line.substr(34, 8));
-        stream >> keplerElements.argumentOfPeriapsis;
+        stream.str(line2.substr(34, 8));
+        stream >> elements.argumentOfPeriapsis;
         stream.clear();
 
         // Get mean anomaly
-        stream.str(line.substr(43, 8));
-        stream >> keplerElements.meanAnomaly;
+        stream.str(line2.substr(43, 8));
+        stream >> elements.meanAnomaly;
         stream.clear();
 
         // Get mean motion
-        stream.str(line.substr(52, 11));
-        stream >> keplerElements.meanMotion;
-    } else {
-        throw ghoul::RuntimeError(fmt::format(
-            "File {} @ line {} does not have '2' header", filename, lineNum + 2
-        ));
+        double meanMotion = 0.0;
+        stream.str(line2.substr(52, 11));
+        stream >> meanMotion;
+
+        // Calculate the semi major axis based on the mean motion using kepler's laws
+        elements.semiMajorAxis = calculateSemiMajorAxis(meanMotion);
+
+        // Converting the mean motion (revolutions per day) to period (seconds per
+        // revolution)
+        using namespace std::chrono;
+        elements.period = seconds(hours(24)).count() / meanMotion;
+
+        return elements;
+    }
+
+    // The satellites of a profile usually share a few large catalogue files, so every
+    // file is only read and parsed once and then shared by all TLETranslations
+    struct TleCatalogue {
+        long long modificationTime = 0;
+        std::vector<TleElements> elements;
+        /// Maps the (1-based) number of the title line of a satellite to its elements
+        std::unordered_map<int, size_t> byLine;
+        /// Maps the NORAD catalog number of a satellite to its elements
+        std::unordered_map<int, size_t> byNoradId;
+    };
+
+    long long modificationTime(const std::string& path) {
+        struct stat s;
+        return stat(path.c_str(), &s) == 0 ? static_cast<long long>(s.st_mtime) : 0;
+    }
+
+    std::shared_ptr<const TleCatalogue> readCatalogue(const std::string& path,
+                                                      long long modificationTime)
+    {
+        std::ifstream file;
+        file.exceptions(std::ofstream::badbit);
+        file.open(path);
+
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            lines.push_back(std::move(line));
+        }
+
+        auto catalogue = std::make_shared<TleCatalogue>();
+        catalogue->modificationTime = modificationTime;
+
+        // Every title line that is followed by the two element lines starts a satellite.
+        // Satellites are looked up by the line of their title, so all positions are
+        // checked rather than stepping over complete sets
+        for (size_t i = 0; i + 2 < lines.size(); ++i) {
+            const std::string& line1 = lines[i + 1];
+            const std::string& line2 = lines[i + 2];
+            if (line1.empty() || line1[0] != '1' || line2.empty() || line2[0] != '2') {
+                continue;
+            }
+
+            try {
+                catalogue->elements.push_back(parseElements(line1, line2));
+            }
+            catch (const std::exception&) {
+                // A malformed set is only reported if a satellite asks for it
+                continue;
+            }
+            const size_t idx = catalogue->elements.size() - 1;
+            catalogue->byLine[static_cast<int>(i + 1)] = idx;
+            const int noradId = std::atoi(line1.substr(2, 5).c_str());
+            if (noradId > 0) {
+                catalogue->byNoradId.emplace(noradId, idx);
+            }
+        }
+        return catalogue;
+    }
+
+    std::shared_ptr<const TleCatalogue> tleCatalogue(const std::string& filename) {
+        static std::mutex mutex;
+        static std::map<std::string, std::shared_ptr<const TleCatalogue>> catalogues;
+
+        const std::string path = absPath(filename);
+        const long long mtime = modificationTime(path);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<const TleCatalogue>& catalogue = catalogues[path];
+        // A catalogue that was updated on disk, for example by a new download, is read
+        // again
+        if (!catalogue || catalogue->modificationTime != mtime) {
+            catalogue = readCatalogue(path, mtime);
+        }
+        return catalogue;
+    }
+} // namespace
+
+
+namespace openspace {
+
+documentation::Documentation TLETranslation::Documentation() {
+    using namespace openspace::documentation;
+    return {
+        "TLE Translation",
+        "space_transform_tle",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("TLETranslation"),
+               Optional::No
+            },
+            {
+                KeyFile,
+                new StringVerifier,
+                Optional::No,
+                "Specifies the filename of the Two-Line-Element file"
+            },
+            {
+                KeyLineNumber,
+                new DoubleGreaterVerifier(0),
+                Optional::Yes,
+                "Specifies the line number within the file where the group of 3 TLE "
+                "lines begins (1-based). Defaults to 1."
+            },
+            {
+                KeyNoradId,
+                new IntGreaterVerifier(0),
+                Optional::Yes,
+                "Specifies the NORAD catalog number of the satellite within the file. If "
+                "this value is specified, it is used instead of the LineNumber."
+            }
+        }
+    };
+}
+
+TLETranslation::TLETranslation(const ghoul::Dictionary& dictionary) {
+    documentation::testSpecificationAndThrow(
+        Documentation,
+        dictionary,
+        "TLETranslation"
+    );
+
+    const std::string& file = dictionary.value<std::string>(KeyFile);
+    int lineNum = 1;
+    if (dictionary.hasKeyAndValue<double>(KeyLineNumber)) {
+        lineNum = static_cast<int>(dictionary.value<double>(KeyLineNumber));
     }
-    file.close();
+    int noradId = 0;
+    if (dictionary.hasKeyAndValue<double>(KeyNoradId)) {
+        noradId = static_cast<int>(dictionary.value<double>(KeyNoradId));
+    }
+    readTLEFile(file, lineNum, noradId);
+}
+
+void TLETranslation::readTLEFile(const std::string& filename, int lineNum,
+                                 int noradId)
+{
+    ghoul_assert(FileSys.fileExists(filename), "The filename must exist");
 
-    // Calculate the semi major axis based on the mean motion using kepler's laws
-    keplerElements.semiMajorAxis = calculateSemiMajorAxis(keplerElements.meanMotion);
+    std::shared_ptr<const TleCatalogue> catalogue = tleCatalogue(filename);
 
-    // Converting the mean motion (revolutions per day) to period (seconds per revolution)
-    using namespace std::chrono;
-    double period = seconds(hours(24)).count() / keplerElements.meanMotion;
+    const std::unordered_map<int, size_t>& index =
+        noradId > 0 ? catalogue->byNoradId : catalogue->byLine;
+    const auto it = index.find(noradId > 0 ? noradId : lineNum);
+    if (it == index.end()) {
+        if (noradId > 0) {
+            throw ghoul::RuntimeError(fmt::format(
+                "File {} does not contain a satellite with NORAD id {}", filename, noradId
+            ));
+        }
+        throw ghoul::RuntimeError(fmt::format(
+            "File {} @ line {} does not start a valid set of TLE lines", filename, lineNum
+        ));
+    }
+    const TleElements& e = catalogue->elements[it->second];
 
     setKeplerElements(
-        keplerElements.eccentricity,
-        keplerElements.semiMajorAxis,
-        keplerElements.inclination,
-        keplerElements.ascendingNode,
-        keplerElements.argumentOfPeriapsis,
-        keplerElements.meanAnomaly,
-        period,
-        keplerElements.epoch
+        e.eccentricity,
+        e.semiMajorAxis,
+        e.inclination,
+        e.ascendingNode,
+        e.argumentOfPeriapsis,
+        e.meanAnomaly,
+        e.period,
+        e.epoch
     );
 }
 
@@ -66,16 +66,21 @@ private:
      * disallowed values (see KeplerTranslation::setKeplerElements), a
      * KeplerTranslation::RangeError is thrown.
      *
+     * The file is only parsed for the first TLETranslation that uses it; all others that
+     * use the same, unmodified file share the parsed catalogue.
+     *
      * \param filename The path to the file that contains the TLE file.
      * \param lineNum The line number in the file where the set of 3 TLE lines starts
+     * \param noradId If this is positive, the satellite with this NORAD catalog number
+     *        is used instead of the one at \p lineNum
      *
-     * \throw std::system_error if the TLE file is malformed (does not contain at least
-     *        two lines that start with \c 1 and \c 2.
+     * \throw ghoul::RuntimeError if the TLE file does not contain a valid set of lines
+     *        that start with \c 1 and \c 2 at \p lineNum or for \p noradId
      * \throw KeplerTranslation::RangeError If the Keplerian elements are outside of
      *        the valid range supported by Kepler::setKeplerElements
      * \pre The \p filename must exist
      */
-    void readTLEFile(const std::string& filename, int lineNum);
+    void readTLEFile(const std::string& filename, int lineNum, int noradId);
 };
 
 } // namespace openspace
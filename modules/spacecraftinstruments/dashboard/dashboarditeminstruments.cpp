@@ -29,6 +29,7 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/timeconversion.h>
 #include <openspace/util/timemanager.h>
@@ -178,6 +179,7 @@ DashboardItemInstruments::DashboardItemInstruments(const ghoul::Dictionary& dict
 }
 
 void DashboardItemInstruments::render(glm::vec2& penPosition) {
+    TextBatcher& batcher = global::renderEngine.textBatcher();
     double currentTime = global::timeManager.time().j2000Seconds();
 
     if (!ImageSequencer::ref().isReady()) {
@@ -195,7 +197,7 @@ void DashboardItemInstruments::render(glm::vec2& penPosition) {
     );
 
     if (remaining > 0) {
-        RenderFont(
+        batcher.queue(
             *_font,
             penPosition,
             "Next instrument activity:",
@@ -212,7 +214,7 @@ void DashboardItemInstruments::render(glm::vec2& penPosition) {
 
         const int Size = 25;
         int p = std::max(static_cast<int>((t * (Size - 1)) + 1), 0);
-        RenderFont(
+        batcher.queue(
             *_font,
             penPosition,
             fmt::format(
@@ -232,7 +234,7 @@ void DashboardItemInstruments::render(glm::vec2& penPosition) {
             "YYYY MON DD HR:MN:SC"
         );
 
-        RenderFont(
+        batcher.queue(
             *_font,
             penPosition,
             fmt::format("Data acquisition time: {}", str),
@@ -255,7 +257,7 @@ void DashboardItemInstruments::render(glm::vec2& penPosition) {
     const minutes tlm = duration_cast<minutes>(tls);
     tls -= tlm;
 
-    RenderFont(
+    batcher.queue(
         *_font,
         penPosition,
         fmt::format(
@@ -274,7 +276,7 @@ void DashboardItemInstruments::render(glm::vec2& penPosition) {
     glm::vec4 firing(0.58f - t, 1.f - t, 1.f - t, 1.f);
     glm::vec4 notFiring(0.5f, 0.5f, 0.5f, 1.f);
 
-    RenderFont(
+    batcher.queue(
         *_font,
         penPosition,
         "Active Instruments:",
@@ -284,12 +286,12 @@ void DashboardItemInstruments::render(glm::vec2& penPosition) {
 
     for (const std::pair<std::string, bool>& m : activeMap) {
         if (m.second) {
-            RenderFont(*_font, penPosition, "|", glm::vec4(0.3f, 0.3f, 0.3f, 1.f));
+            batcher.queue(*_font, penPosition, "|", glm::vec4(0.3f, 0.3f, 0.3f, 1.f));
             if (m.first == "NH_LORRI") {
-                RenderFont(*_font, penPosition, " + ", firing);
+                batcher.queue(*_font, penPosition, " + ", firing);
             }
-            RenderFont(*_font, penPosition, "  |", glm::vec4(0.3f, 0.3f, 0.3f, 1.f));
-            RenderFont(*_font,
+            batcher.queue(*_font, penPosition, "  |", glm::vec4(0.3f, 0.3f, 0.3f, 1.f));
+            batcher.queue(*_font,
                 penPosition,
                 fmt::format("    {:5s}", m.first),
                 glm::vec4(_activeColor.value(), 1.f),
@@ -297,8 +299,8 @@ void DashboardItemInstruments::render(glm::vec2& penPosition) {
             );
         }
         else {
-            RenderFont(*_font, penPosition, "| |", glm::vec4(0.3f, 0.3f, 0.3f, 1.f));
-            RenderFont(
+            batcher.queue(*_font, penPosition, "| |", glm::vec4(0.3f, 0.3f, 0.3f, 1.f));
+            batcher.queue(
                 *_font,
                 penPosition,
                 fmt::format("    {:5s}", m.first),
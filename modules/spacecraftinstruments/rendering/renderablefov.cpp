@@ -52,6 +52,11 @@ namespace {
         "intersectionEndColor", "squareColor", "interpolation"
     };
 
+    constexpr const std::array<const char*, 7> InterceptUniformNames = {
+        "computeIntercepts", "instrumentToReference", "targetPosition",
+        "referenceToTarget", "targetRadii", "targetInFieldOfView", "standOffDistance"
+    };
+
     constexpr const int InterpolationSteps = 5;
 
     constexpr const double Epsilon = 1e-4;
@@ -63,6 +68,18 @@ namespace {
         "corners of the field of view."
     };
 
+    constexpr openspace::properties::Property::PropertyInfo BatchedInterceptsInfo = {
+        "BatchedIntercepts",
+        "Batched Intercepts",
+        "If this value is enabled, the intersections of the field of view with the "
+        "target are computed on the graphics card against the ellipsoid of the target. "
+        "This only requires the positions and orientations of the instrument and the "
+        "target from SPICE once per frame, instead of several surface intercept queries "
+        "for every bound vector. The result differs slightly from the surface "
+        "intercepts computed by SPICE, as the light time is only corrected for the "
+        "center of the target."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo DrawSolidInfo = {
         "SolidDraw",
         "Solid Draw",
@@ -236,6 +253,12 @@ documentation::Documentation RenderableFov::Documentation() {
                 Optional::Yes,
                 StandoffDistanceInfo.description
             },
+            {
+                BatchedInterceptsInfo.identifier,
+                new BoolVerifier,
+                Optional::Yes,
+                BatchedInterceptsInfo.description
+            },
             {
                 KeyBoundsSimplification,
                 new BoolVerifier,
@@ -254,6 +277,7 @@ RenderableFov::RenderableFov(const ghoul::Dictionary& dictionary)
     : Renderable(dictionary)
     , _lineWidth(LineWidthInfo, 1.f, 1.f, 20.f)
     , _drawSolid(DrawSolidInfo, false)
+    , _batchedIntercepts(BatchedInterceptsInfo, false)
     , _standOffDistance(StandoffDistanceInfo, 0.9999, 0.99, 1.0, 0.000001)
     , _colors({
         { DefaultStartColorInfo, glm::vec4(0.4f) },
@@ -314,8 +338,16 @@ RenderableFov::RenderableFov(const ghoul::Dictionary& dictionary)
         _simplifyBounds = dictionary.value<bool>(KeyBoundsSimplification);
     }
 
+    if (dictionary.hasKey(BatchedInterceptsInfo.identifier)) {
+        _batchedIntercepts = dictionary.value<bool>(BatchedInterceptsInfo.identifier);
+    }
+
     addProperty(_lineWidth);
     addProperty(_drawSolid);
+    // The vertex buffers either contain the final positions or the directions of the
+    // bound vectors, so they have to be refilled whenever the mode changes
+    _batchedIntercepts.onChange([this]() { _hasDirectionData = false; });
+    addProperty(_batchedIntercepts);
     addProperty(_standOffDistance);
 
     addProperty(_colors.defaultStart);
@@ -341,6 +373,11 @@ void RenderableFov::initializeGL() {
         );
 
     ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+    ghoul::opengl::updateUniformLocations(
+        *_program,
+        _interceptUniformCache,
+        InterceptUniformNames
+    );
 
     // Fetch information about the specific instrument
     SpiceManager::FieldOfViewResult res = SpiceManager::ref().fieldOfView(
@@ -857,6 +894,35 @@ void RenderableFov::render(const RenderData& data, RendererTasks&) {
         _program->setUniform(_uniformCache.squareColor, _colors.square);
         _program->setUniform(_uniformCache.interpolation, _interpolationTime);
 
+        const bool gpuIntercepts = _hasDirectionData;
+        _program->setUniform(_interceptUniformCache.computeIntercepts, gpuIntercepts);
+        if (gpuIntercepts) {
+            _program->setUniform(
+                _interceptUniformCache.instrumentToReference,
+                _intercepts.instrumentToReference
+            );
+            _program->setUniform(
+                _interceptUniformCache.targetPosition,
+                _intercepts.targetPosition
+            );
+            _program->setUniform(
+                _interceptUniformCache.referenceToTarget,
+                _intercepts.referenceToTarget
+            );
+            _program->setUniform(
+                _interceptUniformCache.targetRadii,
+                _intercepts.targetRadii
+            );
+            _program->setUniform(
+                _interceptUniformCache.targetInFieldOfView,
+                _intercepts.targetInFieldOfView
+            );
+            _program->setUniform(
+                _interceptUniformCache.standOffDistance,
+                _standOffDistance.value()
+            );
+        }
+
         GLenum mode = _drawSolid ? GL_TRIANGLE_STRIP : GL_LINES;
 
         glLineWidth(_lineWidth);
@@ -886,8 +952,22 @@ void RenderableFov::update(const UpdateData& data) {
     if (_drawFOV /* && time changed */) {
         const std::pair<std::string, bool>& t = determineTarget(data.time.j2000Seconds());
 
-        computeIntercepts(data, t.first, t.second);
-        updateGPU();
+        const bool useGpu = _batchedIntercepts &&
+            updateInterceptUniforms(data.time.j2000Seconds(), t.first, t.second);
+        if (useGpu) {
+            // The directions only have to be uploaded once, everything that changes
+            // over time is passed to the shader as uniforms
+            if (!_hasDirectionData) {
+                updateDirectionData();
+                updateGPU();
+                _hasDirectionData = true;
+            }
+        }
+        else {
+            _hasDirectionData = false;
+            computeIntercepts(data, t.first, t.second);
+            updateGPU();
+        }
 
         const double t2 = ImageSequencer::ref().nextCaptureTime(data.time.j2000Seconds());
         const double diff = (t2 - data.time.j2000Seconds());
@@ -905,6 +985,92 @@ void RenderableFov::update(const UpdateData& data) {
     if (_program->isDirty()) {
         _program->rebuildFromFile();
         ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+        ghoul::opengl::updateUniformLocations(
+            *_program,
+            _interceptUniformCache,
+            InterceptUniformNames
+        );
+    }
+}
+
+bool RenderableFov::updateInterceptUniforms(double time, const std::string& target,
+                                            bool isInFov)
+{
+    auto it = _targetRadii.find(target);
+    if (it == _targetRadii.end()) {
+        glm::dvec3 radii = glm::dvec3(0.0);
+        try {
+            SpiceManager::ref().getValue(target, "RADII", radii);
+        }
+        catch (const SpiceManager::SpiceException& e) {
+            LWARNINGC(
+                _instrument.name,
+                fmt::format(
+                    "Could not find the radii of '{}', falling back to the surface "
+                    "intercepts computed by SPICE: {}", target, e.message
+                )
+            );
+        }
+        // Convert the KM scale that SPICE uses to meter
+        it = _targetRadii.emplace(target, radii * 1000.0).first;
+    }
+    if (glm::any(glm::equal(it->second, glm::dvec3(0.0)))) {
+        return false;
+    }
+
+    // All instruments of a spacecraft share the same target position, which is only
+    // queried once per frame thanks to the position cache of the SpiceManager
+    _intercepts.instrumentToReference = SpiceManager::ref().frameTransformationMatrix(
+        _instrument.name,
+        _instrument.referenceFrame,
+        time
+    );
+    _intercepts.targetPosition = SpiceManager::ref().targetPosition(
+        target,
+        _instrument.spacecraft,
+        _instrument.referenceFrame,
+        _instrument.aberrationCorrection,
+        time
+    ) * 1000.0;
+    _intercepts.referenceToTarget = SpiceManager::ref().frameTransformationMatrix(
+        _instrument.referenceFrame,
+        SpiceManager::ref().frameFromBody(target),
+        time
+    );
+    _intercepts.targetRadii = it->second;
+    _intercepts.targetInFieldOfView = isInFov;
+    return true;
+}
+
+void RenderableFov::updateDirectionData() {
+    // Instead of positions, the vertices contain the directions of the bound vectors in
+    // the instrument's frame, and the color type determines which kind of vertex it is.
+    // The vertex shader intersects them with the target and picks the final color
+    for (size_t i = 0; i < _instrument.bounds.size(); ++i) {
+        const glm::vec3 bound = _instrument.bounds[i];
+        _fieldOfViewBounds.data[2 * i] = {
+            { bound.x, bound.y, bound.z },
+            RenderInformation::VertexColorTypeDefaultStart
+        };
+        _fieldOfViewBounds.data[2 * i + 1] = {
+            { bound.x, bound.y, bound.z },
+            RenderInformation::VertexColorTypeDefaultEnd
+        };
+
+        // Wrap around the array index to 0
+        const size_t j = (i == _instrument.bounds.size() - 1) ? 0 : i + 1;
+        for (size_t m = 0; m < InterpolationSteps; ++m) {
+            const double t = static_cast<double>(m) / (InterpolationSteps);
+            const glm::vec3 tBound = glm::mix(
+                _instrument.bounds[i],
+                _instrument.bounds[j],
+                t
+            );
+            _orthogonalPlane.data[i * InterpolationSteps + m] = {
+                { tBound.x, tBound.y, tBound.z },
+                RenderInformation::VertexColorTypeSquare
+            };
+        }
     }
 }
 
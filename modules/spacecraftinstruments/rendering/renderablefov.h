@@ -35,6 +35,7 @@
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <map>
 
 namespace ghoul::opengl {
     class ProgramObject;
@@ -67,6 +68,15 @@ private:
     std::pair<std::string,bool> determineTarget(double time);
 
     void updateGPU();
+
+    // Fills the vertex buffers with the directions of the bound vectors in the
+    // instrument's frame, which the vertex shader intersects with the target ellipsoid
+    void updateDirectionData();
+
+    // Queries the orientations of the instrument and the \p target as well as the
+    // position of the \p target that are used to compute the intercepts on the GPU.
+    // Returns false if the \p target does not have an ellipsoid shape
+    bool updateInterceptUniforms(double time, const std::string& target, bool isInFov);
     void insertPoint(std::vector<float>& arr, glm::vec4 p, glm::vec4 c);
 
     glm::vec4 squareColor(float t) const {
@@ -92,11 +102,15 @@ private:
     // properties
     properties::FloatProperty _lineWidth;
     properties::BoolProperty _drawSolid;
+    properties::BoolProperty _batchedIntercepts;
     properties::DoubleProperty _standOffDistance;
     ghoul::opengl::ProgramObject* _program = nullptr;
     UniformCache(modelViewProjection, defaultColorStart, defaultColorEnd, activeColor,
         targetInFieldOfViewColor, intersectionStartColor, intersectionEndColor,
         squareColor, interpolation) _uniformCache;
+    UniformCache(computeIntercepts, instrumentToReference, targetPosition,
+        referenceToTarget, targetRadii, targetInFieldOfView,
+        standOffDistance) _interceptUniformCache;
 
     // instance variables
     bool _rebuild = false;
@@ -122,6 +136,19 @@ private:
 
     float _interpolationTime = 0.f;
 
+    // The values that the vertex shader needs to compute the intercepts with the target
+    struct {
+        glm::dmat3 instrumentToReference = glm::dmat3(1.0);
+        glm::dvec3 targetPosition = glm::dvec3(0.0);
+        glm::dmat3 referenceToTarget = glm::dmat3(1.0);
+        glm::dvec3 targetRadii = glm::dvec3(0.0);
+        bool targetInFieldOfView = false;
+    } _intercepts;
+    // Whether the vertex buffers currently contain directions instead of positions
+    bool _hasDirectionData = false;
+    // The radii in meters of all targets so far, zero if a target is not an ellipsoid
+    std::map<std::string, glm::dvec3> _targetRadii;
+
     struct RenderInformation {
         // Differentiating different vertex types
         using VertexColorType = int32_t;
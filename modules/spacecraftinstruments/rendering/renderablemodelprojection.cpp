@@ -176,7 +176,7 @@ RenderableModelProjection::~RenderableModelProjection() {} // NOLINT
 
 bool RenderableModelProjection::isReady() const {
     return (_programObject != nullptr) && (_baseTexture != nullptr) &&
-           _projectionComponent.isReady();
+           _projectionComponent.isReady() && _geometry && _geometry->isReady();
 }
 
 void RenderableModelProjection::initializeGL() {
@@ -223,9 +223,8 @@ void RenderableModelProjection::initializeGL() {
     loadTextures();
     _projectionComponent.initializeGL();
 
-    float bs = boundingSphere();
-    _geometry->initialize(this);
-    setBoundingSphere(bs); // ignore bounding sphere set by geometry.
+    // The bounding sphere of the geometry is ignored, so we don't pass ourselves
+    _geometry->initialize(nullptr);
 }
 
 void RenderableModelProjection::deinitializeGL() {
@@ -361,6 +360,7 @@ void RenderableModelProjection::update(const UpdateData& data) {
                     time,
                     integrateFromTime
                 );
+                _projectionComponent.prefetchProjectionTextures(time);
             }
         }
     }
@@ -488,7 +488,9 @@ void RenderableModelProjection::project() {
         attitudeParameters(img.timeRange.start);
         std::shared_ptr<ghoul::opengl::Texture> projTexture =
             _projectionComponent.loadProjectionTexture(img.path, img.isPlaceholder);
-        imageProjectGPU(*projTexture);
+        if (projTexture) {
+            imageProjectGPU(*projTexture);
+        }
     }
     _shouldCapture = false;
 }
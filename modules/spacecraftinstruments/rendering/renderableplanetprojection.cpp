@@ -39,6 +39,8 @@
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureconversion.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <cmath>
 
 namespace {
     constexpr const char* _loggerCat = "RenderablePlanetProjection";
@@ -51,11 +53,14 @@ namespace {
         "_projectionFading", "baseTexture", "projectionTexture", "heightTexture"
     };
 
-    constexpr const std::array<const char*, 7> FboUniformNames = {
-        "projectionTexture", "ProjectorMatrix", "ModelTransform", "_scaling",
-        "boresight", "_radius", "_segments"
+    constexpr const std::array<const char*, 5> FboUniformNames = {
+        "ModelTransform", "_scaling", "_radius", "_segments", "nProjections"
     };
 
+    // The number of images that are projected in a single pass, has to match
+    // MaxProjections in renderablePlanetProjection_fs.glsl
+    constexpr const int MaxBatchedProjections = 8;
+
     constexpr const char* KeyGeometry = "Geometry";
     constexpr const char* KeyProjection = "Projection";
     constexpr const char* KeyRadius = "Geometry.Radius";
@@ -63,6 +68,172 @@ namespace {
 
     constexpr const char* NoImageText = "No Image";
 
+    // A rectangle in the texture coordinates of the projection texture
+    struct UvRegion {
+        glm::vec2 min;
+        glm::vec2 max;
+    };
+
+    // The inverse of uvToModel in renderablePlanetProjection_fs.glsl
+    glm::vec2 modelToUv(const glm::vec3& vertex, const glm::vec3& radius) {
+        const glm::vec3 p = vertex / radius;
+        float phi = std::atan2(p.y, p.x);
+        if (phi < 0.f) {
+            phi += glm::two_pi<float>();
+        }
+        const float theta = std::acos(glm::clamp(p.z, -1.f, 1.f));
+        return glm::vec2(phi / glm::two_pi<float>(), 1.f - theta / glm::pi<float>());
+    }
+
+    // The same as uvToModel in renderablePlanetProjection_fs.glsl
+    glm::vec3 uvToModel(const glm::vec2& uv, const glm::vec3& radius) {
+        const float theta = (1.f - uv.y) * glm::pi<float>();
+        const float phi = uv.x * glm::two_pi<float>();
+        return radius * glm::vec3(
+            std::sin(theta) * std::cos(phi),
+            std::sin(theta) * std::sin(phi),
+            std::cos(theta)
+        );
+    }
+
+    // Returns whether the image is projected onto the \p vertex, using the same test as
+    // renderablePlanetProjection_fs.glsl
+    bool isProjectedOnto(const glm::vec3& vertex, const glm::mat4& projectorMatrix,
+                         const glm::mat4& modelTransform, const glm::vec3& boresight)
+    {
+        const glm::vec4 p = projectorMatrix * modelTransform * glm::vec4(vertex, 1.f);
+        const glm::vec2 ndc = glm::vec2(p) / p.w;
+        const glm::vec3 normal = glm::normalize(
+            glm::vec3(modelTransform * glm::vec4(vertex, 0.f))
+        );
+        return glm::abs(ndc.x) <= 1.f && glm::abs(ndc.y) <= 1.f &&
+               glm::dot(glm::normalize(boresight), normal) < 0.f;
+    }
+
+    // Computes the regions of the projection texture that an image is projected onto.
+    // The boundary of the image is intersected with the ellipsoid and the texture
+    // coordinates of the hits are bounded. If part of the boundary misses the body, the
+    // limb is in view and the footprint is determined on a coarse grid instead
+    std::vector<UvRegion> projectionFootprint(const glm::mat4& projectorMatrix,
+                                              const glm::mat4& modelTransform,
+                                              const glm::vec3& radius,
+                                              const glm::vec3& boresight)
+    {
+        constexpr const int SamplesPerEdge = 16;
+        const glm::mat4 ndcToModel = glm::inverse(projectorMatrix * modelTransform);
+
+        std::vector<float> us;
+        us.reserve(4 * SamplesPerEdge);
+        float vMin = 1.f;
+        float vMax = 0.f;
+        bool isBoundaryOnBody = true;
+        for (int i = 0; i < 4 * SamplesPerEdge; ++i) {
+            const float t = 2.f * (i % SamplesPerEdge) / SamplesPerEdge - 1.f;
+            glm::vec2 ndc;
+            switch (i / SamplesPerEdge) {
+                case 0:  ndc = glm::vec2(t, -1.f);  break;
+                case 1:  ndc = glm::vec2(1.f, t);   break;
+                case 2:  ndc = glm::vec2(-t, 1.f);  break;
+                default: ndc = glm::vec2(-1.f, -t); break;
+            }
+
+            // Intersect the ray through the image point with the ellipsoid, which is a
+            // unit sphere after dividing by the radii
+            const glm::vec4 near = ndcToModel * glm::vec4(ndc, -1.f, 1.f);
+            const glm::vec4 far = ndcToModel * glm::vec4(ndc, 1.f, 1.f);
+            const glm::vec3 origin = glm::vec3(near) / near.w / radius;
+            const glm::vec3 direction = glm::vec3(far) / far.w / radius - origin;
+
+            const float a = glm::dot(direction, direction);
+            const float b = 2.f * glm::dot(origin, direction);
+            const float c = glm::dot(origin, origin) - 1.f;
+            const float discriminant = b * b - 4.f * a * c;
+            if (discriminant < 0.f) {
+                isBoundaryOnBody = false;
+                break;
+            }
+            const float s = (-b - std::sqrt(discriminant)) / (2.f * a);
+            const glm::vec2 uv = modelToUv((origin + s * direction) * radius, radius);
+            us.push_back(uv.x);
+            vMin = std::min(vMin, uv.y);
+            vMax = std::max(vMax, uv.y);
+        }
+
+        std::vector<UvRegion> regions;
+        if (!isBoundaryOnBody) {
+            constexpr const glm::ivec2 GridSize = glm::ivec2(256, 128);
+            const glm::vec2 cellSize = 1.f / glm::vec2(GridSize);
+            for (int y = 0; y < GridSize.y; ++y) {
+                // Consecutive cells of a row are combined into a single region
+                int runStart = -1;
+                for (int x = 0; x <= GridSize.x; ++x) {
+                    const glm::vec2 uv = (glm::vec2(x, y) + 0.5f) * cellSize;
+                    const bool isHit = x < GridSize.x &&
+                        isProjectedOnto(
+                            uvToModel(uv, radius),
+                            projectorMatrix,
+                            modelTransform,
+                            boresight
+                        );
+                    if (isHit && runStart == -1) {
+                        runStart = x;
+                    }
+                    else if (!isHit && runStart != -1) {
+                        regions.push_back({
+                            glm::vec2(runStart, y) * cellSize,
+                            glm::vec2(x, y + 1) * cellSize
+                        });
+                        runStart = -1;
+                    }
+                }
+            }
+            return regions;
+        }
+
+        // The footprint spans the shortest longitude range that contains all hits, which
+        // is the complement of the largest gap between them
+        std::sort(us.begin(), us.end());
+        float largestGap = us.front() + 1.f - us.back();
+        size_t start = 0;
+        for (size_t i = 1; i < us.size(); ++i) {
+            if (us[i] - us[i - 1] > largestGap) {
+                largestGap = us[i] - us[i - 1];
+                start = i;
+            }
+        }
+        float uMin = us[start];
+        float uMax = (start == 0) ? us.back() : us[start - 1] + 1.f;
+
+        // A footprint that contains a pole covers all longitudes around it
+        const bool hasNorthPole = isProjectedOnto(
+            uvToModel(glm::vec2(0.f, 1.f), radius),
+            projectorMatrix,
+            modelTransform,
+            boresight
+        );
+        const bool hasSouthPole = isProjectedOnto(
+            uvToModel(glm::vec2(0.f, 0.f), radius),
+            projectorMatrix,
+            modelTransform,
+            boresight
+        );
+        if (hasNorthPole || hasSouthPole) {
+            uMin = 0.f;
+            uMax = 1.f;
+            vMax = hasNorthPole ? 1.f : vMax;
+            vMin = hasSouthPole ? 0.f : vMin;
+        }
+
+        regions.push_back({
+            glm::vec2(uMin, vMin),
+            glm::vec2(std::min(uMax, 1.f), vMax)
+        });
+        if (uMax > 1.f) {
+            regions.push_back({ glm::vec2(0.f, vMin), glm::vec2(uMax - 1.f, vMax) });
+        }
+        return regions;
+    }
+
     constexpr openspace::properties::Property::PropertyInfo ColorTexturePathsInfo = {
         "ColorTexturePaths",
         "Color Texture",
@@ -466,21 +637,41 @@ bool RenderablePlanetProjection::isReady() const {
 }
 
 void RenderablePlanetProjection::imageProjectGPU(
-                                          const ghoul::opengl::Texture& projectionTexture)
+                                               const std::vector<Projection>& projections)
+{
+    for (size_t i = 0; i < projections.size(); i += MaxBatchedProjections) {
+        const size_t nBatched = std::min(
+            projections.size() - i,
+            static_cast<size_t>(MaxBatchedProjections)
+        );
+        imageProjectBatchGPU(&projections[i], static_cast<int>(nBatched));
+    }
+}
+
+void RenderablePlanetProjection::imageProjectBatchGPU(const Projection* projections,
+                                                      int nProjections)
 {
     _projectionComponent.imageProjectBegin();
 
     _fboProgramObject->activate();
 
-    ghoul::opengl::TextureUnit unitFbo;
-    unitFbo.activate();
-    projectionTexture.bind();
-    _fboProgramObject->setUniform(_fboUniformCache.projectionTexture, unitFbo);
+    ghoul::opengl::TextureUnit unitFbo[MaxBatchedProjections];
+    for (int i = 0; i < nProjections; ++i) {
+        const std::string index = "[" + std::to_string(i) + "]";
+
+        unitFbo[i].activate();
+        projections[i].texture->bind();
+        _fboProgramObject->setUniform("projectionTextures" + index, unitFbo[i]);
+        _fboProgramObject->setUniform(
+            "ProjectorMatrix" + index,
+            projections[i].projectorMatrix
+        );
+        _fboProgramObject->setUniform("boresight" + index, projections[i].boresight);
+    }
+    _fboProgramObject->setUniform(_fboUniformCache.nProjections, nProjections);
 
-    _fboProgramObject->setUniform(_fboUniformCache.projectorMatrix, _projectorMatrix);
     _fboProgramObject->setUniform(_fboUniformCache.modelTransform, _transform);
     _fboProgramObject->setUniform(_fboUniformCache.scaling, _camScaling);
-    _fboProgramObject->setUniform(_fboUniformCache.boresight, _boresight);
 
     if (_geometry->hasProperty("Radius")) {
         ghoul::any r = _geometry->property("Radius")->get();
@@ -506,6 +697,27 @@ void RenderablePlanetProjection::imageProjectGPU(
     _projectionComponent.imageProjectEnd();
 }
 
+void RenderablePlanetProjection::commitProjectionFootprint(const Projection& projection)
+{
+    glm::vec3 radius = glm::vec3(boundingSphere());
+    if (_geometry->hasProperty("Radius")) {
+        ghoul::any r = _geometry->property("Radius")->get();
+        if (glm::vec3* geometryRadius = ghoul::any_cast<glm::vec3>(&r)) {
+            radius = *geometryRadius;
+        }
+    }
+
+    const std::vector<UvRegion> regions = projectionFootprint(
+        projection.projectorMatrix,
+        _transform,
+        radius,
+        projection.boresight
+    );
+    for (const UvRegion& region : regions) {
+        _projectionComponent.commitProjectionRegion(region.min, region.max);
+    }
+}
+
 void RenderablePlanetProjection::attitudeParameters(double time) {
     // precomputations for shader
     _instrumentMatrix = SpiceManager::ref().positionTransformMatrix(
@@ -561,26 +773,34 @@ void RenderablePlanetProjection::render(const RenderData& data, RendererTasks&)
         _imageTimes.clear();
         _projectionsInBuffer = static_cast<int>(_imageTimes.size());
     }
-
-    if (_projectionComponent.needsMipMapGeneration()) {
-        _projectionComponent.generateMipMap();
-    }
+    _projectionComponent.makeProjectionTextureResident();
 
     _camScaling = glm::vec2(1.f, 0.f); // Unit scaling
     _up = data.camera.lookUpVectorCameraSpace();
 
     if (_projectionComponent.doesPerformProjection()) {
+        std::vector<Projection> projections;
         int nPerformedProjections = 0;
         for (const Image& img : _imageTimes) {
             if (nPerformedProjections >= _maxProjectionsPerFrame) {
                 break;
             }
+            if (_projectionComponent.isLoadingProjectionTexture(img.path)) {
+                // Keep the order of the projections and wait for the prefetched image
+                break;
+            }
             RenderablePlanetProjection::attitudeParameters(img.timeRange.start);
             std::shared_ptr<ghoul::opengl::Texture> t =
                 _projectionComponent.loadProjectionTexture(img.path);
-            imageProjectGPU(*t);
+            if (t) {
+                projections.push_back({ std::move(t), _projectorMatrix, _boresight });
+                if (_projectionComponent.isSparse()) {
+                    commitProjectionFootprint(projections.back());
+                }
+            }
             ++nPerformedProjections;
         }
+        imageProjectGPU(projections);
         _imageTimes.erase(
             _imageTimes.begin(),
             _imageTimes.begin() + nPerformedProjections
@@ -588,6 +808,12 @@ void RenderablePlanetProjection::render(const RenderData& data, RendererTasks&)
         _projectionsInBuffer = static_cast<int>(_imageTimes.size());
 
     }
+
+    // The mipmaps are regenerated once for all projections of this frame
+    if (_projectionComponent.needsMipMapGeneration()) {
+        _projectionComponent.generateMipMap();
+    }
+
     attitudeParameters(data.time.j2000Seconds());
 
     double lt;
@@ -713,6 +939,8 @@ void RenderablePlanetProjection::update(const UpdateData& data) {
                     // Now, insert the new images to the buffer
                     insertImageProjections(newImageTimes);
                 }
+
+                _projectionComponent.prefetchProjectionTextures(time);
             }
         }
     }
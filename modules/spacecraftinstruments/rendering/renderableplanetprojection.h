@@ -63,7 +63,23 @@ protected:
     void attitudeParameters(double time);
 
 private:
-    void imageProjectGPU(const ghoul::opengl::Texture& projectionTexture);
+    // An image together with the state of the projector at the time of its capture
+    struct Projection {
+        std::shared_ptr<ghoul::opengl::Texture> texture;
+        glm::mat4 projectorMatrix;
+        glm::vec3 boresight;
+    };
+
+    /**
+     * Projects the \p projections, which are ordered by their capture time, into the
+     * projection layer. Up to MaxBatchedProjections images share a single pass, so the
+     * framebuffer setup and the dilation are only paid once per batch.
+     */
+    void imageProjectGPU(const std::vector<Projection>& projections);
+    void imageProjectBatchGPU(const Projection* projections, int nProjections);
+
+    /// Commits the regions of a sparse projection texture that \p projection covers
+    void commitProjectionFootprint(const Projection& projection);
 
     void clearProjectionBufferAfterTime(double time);
     void insertImageProjections(const std::vector<Image>& images);
@@ -85,8 +101,8 @@ private:
         projectionFading, baseTexture, projectionTexture, heightTexture)
         _mainUniformCache;
 
-    UniformCache(projectionTexture, projectorMatrix, modelTransform, scaling, boresight,
-        radius, segments) _fboUniformCache;
+    UniformCache(modelTransform, scaling, radius, segments, nProjections)
+        _fboUniformCache;
 
     std::unique_ptr<ghoul::opengl::Texture> _baseTexture;
     std::unique_ptr<ghoul::opengl::Texture> _heightMapTexture;
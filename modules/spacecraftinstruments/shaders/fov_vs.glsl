@@ -43,6 +43,16 @@ uniform vec4 intersectionEndColor;
 uniform vec4 squareColor;
 uniform float interpolation;
 
+// If this is true, in_point_position is the direction of a bound vector in the
+// instrument's frame and the position is computed by intersecting it with the target
+uniform bool computeIntercepts;
+uniform dmat3 instrumentToReference;
+uniform dvec3 targetPosition;
+uniform dmat3 referenceToTarget;
+uniform dvec3 targetRadii;
+uniform bool targetInFieldOfView;
+uniform double standOffDistance;
+
 // This needs to be synced with the RenderableFov header
 const int VertexColorTypeDefaultStart = 0;
 const int VertexColorTypeDefaultEnd = 1;
@@ -53,14 +63,72 @@ const int VertexColorTypeIntersectionEnd = 5;
 const int VertexColorTypeSquare = 6;
 
 
+// Intersects the ray from the spacecraft along the direction with the target ellipsoid
+// and returns the intercept relative to the spacecraft in the reference frame
+bool interceptTarget(dvec3 direction, out dvec3 intercept) {
+    // In the body-fixed frame scaled by the radii, the ellipsoid is the unit sphere
+    dvec3 origin = (referenceToTarget * -targetPosition) / targetRadii;
+    dvec3 dir = (referenceToTarget * direction) / targetRadii;
+
+    double a = dot(dir, dir);
+    double b = dot(origin, dir);
+    double c = dot(origin, origin) - 1.0;
+    double discriminant = b * b - a * c;
+    if (discriminant < 0.0) {
+        intercept = dvec3(0.0);
+        return false;
+    }
+
+    double t = (-b - sqrt(discriminant)) / a;
+    intercept = t * direction;
+    return t >= 0.0;
+}
+
 void main() {
-    vec4 position = vec4(in_point_position, 1);
+    vec3 pointPosition = in_point_position;
+    int colorType = colorInformation;
+
+    if (computeIntercepts) {
+        dvec3 direction = instrumentToReference * dvec3(in_point_position);
+        dvec3 intercept = dvec3(0.0);
+        bool hasIntercept = targetInFieldOfView && interceptTarget(direction, intercept);
+
+        // Standoff distance, we would otherwise end up *exactly* on the surface
+        dvec3 surface = intercept * standOffDistance;
+        // Orthogonal projection of the target onto the direction
+        dvec3 projection = dot(targetPosition, direction) / dot(direction, direction) *
+                           direction;
+
+        if (colorInformation == VertexColorTypeDefaultStart) {
+            pointPosition = vec3(0.0);
+            colorType = hasIntercept ?
+                VertexColorTypeIntersectionStart :
+                VertexColorTypeDefaultStart;
+        }
+        else if (colorInformation == VertexColorTypeDefaultEnd) {
+            if (hasIntercept) {
+                pointPosition = vec3(surface);
+                colorType = VertexColorTypeIntersectionEnd;
+            }
+            else {
+                pointPosition = vec3(projection);
+                colorType = targetInFieldOfView ?
+                    VertexColorTypeInFieldOfView :
+                    VertexColorTypeDefaultEnd;
+            }
+        }
+        else {
+            pointPosition = vec3(hasIntercept ? surface : projection);
+        }
+    }
+
+    vec4 position = vec4(pointPosition, 1);
     vec4 positionClipSpace = modelViewProjectionTransform * position;
 
     vs_positionScreenSpace = z_normalization(positionClipSpace);
     gl_Position = vs_positionScreenSpace;
 
-    switch (colorInformation) { 
+    switch (colorType) { 
         case VertexColorTypeDefaultStart:
             vs_color = defaultColorStart;
             break;
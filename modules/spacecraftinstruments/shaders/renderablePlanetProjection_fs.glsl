@@ -31,17 +31,20 @@ in vec2 vs_position;
 layout (location = 0) out vec4 color; 
 layout (location = 1) out vec4 stencil;
 
-uniform sampler2D projectionTexture;
+// Has to match MaxBatchedProjections in renderableplanetprojection.cpp
+const int MaxProjections = 8;
+
+uniform sampler2D projectionTextures[MaxProjections];
+uniform mat4 ProjectorMatrix[MaxProjections];
+uniform vec3 boresight[MaxProjections];
+uniform int nProjections;
 
-uniform mat4 ProjectorMatrix;
 uniform mat4 ModelTransform;
 
 uniform vec2 _scaling;
 uniform vec3 _radius;
 uniform int _segments;
 
-uniform vec3 boresight;
-
 #define M_PI 3.14159265358979323846
 
 vec4 uvToModel(vec2 uv, vec3 radius, float segments){
@@ -68,25 +71,30 @@ void main() {
     vec4 vertex = uvToModel(uv, _radius, _segments);
 
     vec4 raw_pos   = psc_to_meter(vertex, _scaling);
-    vec4 projected = ProjectorMatrix * ModelTransform * raw_pos;
+    vec4 model_pos = ModelTransform * raw_pos;
 
-    projected.x /= projected.w;
-    projected.y /= projected.w;
+    vec3 normal = normalize((ModelTransform * vec4(vertex.xyz, 0.0)).xyz);
 
-    projected = projected * 0.5 + vec4(0.5);
+    color = vec4(0.0);
+    stencil = vec4(0.0);
 
-    vec3 normal = normalize((ModelTransform * vec4(vertex.xyz, 0.0)).xyz);
+    // The images are ordered by their capture time, so later images overwrite earlier
+    // ones, just like they would if they were projected one at a time
+    for (int i = 0; i < nProjections; i++) {
+        vec4 projected = ProjectorMatrix[i] * model_pos;
 
-    vec3 v_b = normalize(boresight);
+        projected.x /= projected.w;
+        projected.y /= projected.w;
 
-    if((inRange(projected.x, 0.0, 1.0) && inRange(projected.y, 0.0, 1.0)) &&
-       dot(v_b, normal) < 0.0)
-    {
-        color = texture(projectionTexture, vec2(projected.x, projected.y));
-        stencil = vec4(1.0); 
-    }
-    else {
-        color = vec4(0.0);
-        stencil = vec4(0.0);
+        projected = projected * 0.5 + vec4(0.5);
+
+        vec3 v_b = normalize(boresight[i]);
+
+        if ((inRange(projected.x, 0.0, 1.0) && inRange(projected.y, 0.0, 1.0)) &&
+            dot(v_b, normal) < 0.0)
+        {
+            color = texture(projectionTextures[i], vec2(projected.x, projected.y));
+            stencil = vec4(1.0);
+        }
     }
 }
@@ -125,6 +125,21 @@ std::string HongKangParser::findPlaybookSpecifiedTarget(std::string line) {
     return target;
 }
 
+SequenceParser::CacheSources HongKangParser::cacheSources() const {
+    CacheSources sources;
+    sources.information = fmt::format(
+        "HongKangParser|{}|{}|{}|{}|{}|",
+        _name, _fileName, _spacecraft, _metRef, _defaultCaptureImage
+    );
+    for (const std::string& target : _potentialTargets) {
+        sources.information += target + ",";
+    }
+    // The playbook has its own translations that are not shared with the sequencer
+    sources.information += "|" + translationInformation(_fileTranslation);
+    sources.files.push_back(absPath(_fileName));
+    return sources;
+}
+
 bool HongKangParser::create() {
     //check input for errors.
     const bool hasObserver = SpiceManager::ref().hasNaifId(_spacecraft);
@@ -39,6 +39,9 @@ public:
     bool create() override;
     std::string findPlaybookSpecifiedTarget(std::string line);
 
+protected:
+    CacheSources cacheSources() const override;
+
 private:
     std::string _defaultCaptureImage;
     double _metRef = 299180517;
@@ -28,9 +28,12 @@
 #include <openspace/util/timemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
 
 namespace {
     constexpr const char* _loggerCat = "ImageSequencer";
+
+    const std::pair<double, std::string> NoTarget = { 0.0, "No Target" };
 } // namespace
 
 namespace openspace {
@@ -56,7 +59,7 @@ bool ImageSequencer::isReady() {
     return _hasData;
 }
 
-std::pair<double, std::string> ImageSequencer::nextTarget(double time) {
+const std::pair<double, std::string>& ImageSequencer::nextTarget(double time) const {
     const auto it = std::lower_bound(
         _targetTimes.begin(),
         _targetTimes.end(),
@@ -68,11 +71,11 @@ std::pair<double, std::string> ImageSequencer::nextTarget(double time) {
         return *it;
     }
     else {
-        return { 0.0, "No Target" };
+        return NoTarget;
     }
 }
 
-std::pair<double, std::string> ImageSequencer::currentTarget(double time) {
+const std::pair<double, std::string>& ImageSequencer::currentTarget(double time) const {
     const auto it = std::lower_bound(
         _targetTimes.begin(),
         _targetTimes.end(),
@@ -84,7 +87,7 @@ std::pair<double, std::string> ImageSequencer::currentTarget(double time) {
         return *std::prev(it);
     }
     else {
-        return { 0.0, "No Target" };
+        return NoTarget;
     }
 }
 
@@ -103,7 +106,8 @@ std::pair<double, std::vector<std::string>> ImageSequencer::incidentTargetList(
 
     if (it != _targetTimes.end() && it != _targetTimes.begin()){
         // move the iterator to the first element of the range
-        std::advance(it, -(range + 1));
+        const std::ptrdiff_t nBefore = std::distance(_targetTimes.begin(), it);
+        std::advance(it, -std::min<std::ptrdiff_t>(range + 1, nBefore));
 
         // now extract incident range
         for (int i = 0; i < 2 * range + 1; i++){
@@ -152,27 +156,24 @@ Image ImageSequencer::latestImageForInstrument(const std::string& instrumentID)
     }
 }
 
-std::vector<std::pair<std::string, bool>> ImageSequencer::activeInstruments(double time) {
+const std::vector<std::pair<std::string, bool>>& ImageSequencer::activeInstruments(
+                                                                             double time)
+{
     // first set all instruments to off
     for (std::pair<std::string, bool>& i : _switchingMap) {
         i.second = false;
     }
 
-    // go over the filetranslaton map
-    using K = std::string;
-    using V = std::unique_ptr<Decoder>;
-    for (const std::pair<const K, V>& key : _fileTranslation) {
-        // for each spice-instrument
-        for (const std::string& instrumentID : key.second->translations()) {
-            // check if the spice-instrument is active
-            if (isInstrumentActive(time, instrumentID)) {
-                // go over switching map
-                for (std::pair<std::string, bool>& instrument : _switchingMap) {
-                    // if instrument is present in switching map
-                    if (instrumentID == instrument.first) {
-                        // set as active
-                        instrument.second = true;
-                    }
+    const std::pair<const int*, const int*> intervals = candidateIntervals(time);
+    for (const int* i = intervals.first; i != intervals.second; ++i) {
+        if (!_instrumentTimes[*i].second.includes(time)) {
+            continue;
+        }
+        // set every spice-instrument of this interval that is in the switching map
+        for (int id : _intervalInstruments[*i]) {
+            for (size_t j = 0; j < _switchingMapIds.size(); ++j) {
+                if (_switchingMapIds[j] == id) {
+                    _switchingMap[j].second = true;
                 }
             }
         }
@@ -181,19 +182,29 @@ std::vector<std::pair<std::string, bool>> ImageSequencer::activeInstruments(doub
     return _switchingMap;
 }
 
-bool ImageSequencer::isInstrumentActive(double time, const std::string& instrumentID) {
-    for (const std::pair<std::string, TimeRange>& i : _instrumentTimes) {
-        //check if this instrument is in range
-        if (i.second.includes(time)) {
-            //if so, then get the corresponding spiceID
-            const std::vector<std::string>& ids =
-                _fileTranslation[i.first]->translations();
-            //check which specific subinstrument is firing
-            for (const std::string& s : ids) {
-                if (s == instrumentID) {
-                    return true;
-                }
-            }
+int ImageSequencer::instrumentId(const std::string& instrumentID) const {
+    const auto it = _instrumentIds.find(instrumentID);
+    return (it != _instrumentIds.end()) ? it->second : -1;
+}
+
+bool ImageSequencer::isInstrumentActive(double time,
+                                        const std::string& instrumentID) const
+{
+    return isInstrumentActive(time, instrumentId(instrumentID));
+}
+
+bool ImageSequencer::isInstrumentActive(double time, int instrumentId) const {
+    if (instrumentId < 0) {
+        return false;
+    }
+
+    const std::pair<const int*, const int*> intervals = candidateIntervals(time);
+    for (const int* i = intervals.first; i != intervals.second; ++i) {
+        const std::vector<int>& ids = _intervalInstruments[*i];
+        if (_instrumentTimes[*i].second.includes(time) &&
+            std::find(ids.begin(), ids.end(), instrumentId) != ids.end())
+        {
+            return true;
         }
     }
     return false;
@@ -202,24 +213,102 @@ bool ImageSequencer::isInstrumentActive(double time, const std::string& instrume
 float ImageSequencer::instrumentActiveTime(double time,
                                            const std::string& instrumentID) const
 {
+    const int id = instrumentId(instrumentID);
+    if (id < 0) {
+        return -1.f;
+    }
+
+    // The candidates are ordered by their start time, like the _instrumentTimes
+    const std::pair<const int*, const int*> intervals = candidateIntervals(time);
+    for (const int* i = intervals.first; i != intervals.second; ++i) {
+        const TimeRange& range = _instrumentTimes[*i].second;
+        const std::vector<int>& ids = _intervalInstruments[*i];
+        if (range.includes(time) && std::find(ids.begin(), ids.end(), id) != ids.end()) {
+            return static_cast<float>((time - range.start) / (range.end - range.start));
+        }
+    }
+    return -1.f;
+}
+
+int ImageSequencer::internInstrument(const std::string& instrumentID) {
+    const int nextId = static_cast<int>(_instrumentIds.size());
+    return _instrumentIds.emplace(instrumentID, nextId).first->second;
+}
+
+std::pair<const int*, const int*> ImageSequencer::candidateIntervals(double time) const
+{
+    // The segment of the time starts at the last boundary that is not after it
+    const auto it = std::upper_bound(
+        _intervalBoundaries.begin(),
+        _intervalBoundaries.end(),
+        time
+    );
+    if (it == _intervalBoundaries.begin()) {
+        return { nullptr, nullptr };
+    }
+
+    const size_t segment = std::distance(_intervalBoundaries.begin(), it) - 1;
+    const int* intervals = _boundaryIntervals.data();
+    return {
+        intervals + _boundaryOffsets[segment],
+        intervals + _boundaryOffsets[segment + 1]
+    };
+}
+
+void ImageSequencer::buildInstrumentIndex() {
+    _intervalInstruments.clear();
+    _intervalBoundaries.clear();
+    _boundaryOffsets.clear();
+    _boundaryIntervals.clear();
+
     for (const std::pair<std::string, TimeRange>& i : _instrumentTimes) {
-        //check if this instrument is in range
-        if (i.second.includes(time)){
-            //if so, then get the corresponding spiceID
-            const std::vector<std::string>& ids =
-                _fileTranslation.at(i.first)->translations();
-
-            // check which specific subinstrument is firing
-            for (const std::string& s : ids) {
-                if (s == instrumentID) {
-                    return static_cast<float>(
-                        (time - i.second.start) / (i.second.end - i.second.start)
-                    );
+        std::vector<int> ids;
+        const auto it = _fileTranslation.find(i.first);
+        if (it != _fileTranslation.end()) {
+            for (const std::string& s : it->second->translations()) {
+                ids.push_back(internInstrument(s));
+            }
+        }
+        _intervalInstruments.push_back(std::move(ids));
+
+        _intervalBoundaries.push_back(i.second.start);
+        _intervalBoundaries.push_back(i.second.end);
+    }
+    std::sort(_intervalBoundaries.begin(), _intervalBoundaries.end());
+    _intervalBoundaries.erase(
+        std::unique(_intervalBoundaries.begin(), _intervalBoundaries.end()),
+        _intervalBoundaries.end()
+    );
+
+    // Sweep over the boundaries, the _instrumentTimes are sorted by their start time so
+    // the intervals in the active list stay sorted as well
+    std::vector<int> active;
+    size_t next = 0;
+    _boundaryOffsets.push_back(0);
+    for (double boundary : _intervalBoundaries) {
+        active.erase(
+            std::remove_if(
+                active.begin(),
+                active.end(),
+                [this, boundary](int i) {
+                    return _instrumentTimes[i].second.end < boundary;
                 }
+            ),
+            active.end()
+        );
+
+        while (next < _instrumentTimes.size() &&
+               _instrumentTimes[next].second.start <= boundary)
+        {
+            if (_instrumentTimes[next].second.end >= boundary) {
+                active.push_back(static_cast<int>(next));
             }
+            ++next;
         }
+
+        _boundaryIntervals.insert(_boundaryIntervals.end(), active.begin(), active.end());
+        _boundaryOffsets.push_back(static_cast<int>(_boundaryIntervals.size()));
     }
-    return -1.f;
 }
 
 bool ImageSequencer::imagePaths(std::vector<Image>& captures,
@@ -314,6 +403,38 @@ bool ImageSequencer::imagePaths(std::vector<Image>& captures,
     return true;
 }
 
+std::vector<Image> ImageSequencer::upcomingImages(const std::string& projectee,
+                                                  const std::string& instrument,
+                                                  double time, size_t maxImages) const
+{
+    const auto it = _subsetMap.find(projectee);
+    if (it == _subsetMap.end()) {
+        return std::vector<Image>();
+    }
+    const std::vector<Image>& subset = it->second._subset;
+
+    Image findCurrent;
+    findCurrent.timeRange.start = time;
+    auto curr = std::lower_bound(
+        subset.begin(),
+        subset.end(),
+        findCurrent,
+        [](const Image& a, const Image& b) {
+            return a.timeRange.start < b.timeRange.start;
+        }
+    );
+
+    std::vector<Image> images;
+    for (; curr != subset.end() && images.size() < maxImages; ++curr) {
+        if (!curr->activeInstruments.empty() &&
+            curr->activeInstruments.front() == instrument)
+        {
+            images.push_back(*curr);
+        }
+    }
+    return images;
+}
+
 void ImageSequencer::sortData() {
     std::sort(
         _targetTimes.begin(),
@@ -345,6 +466,8 @@ void ImageSequencer::sortData() {
             return a.second.start < b.second.start;
         }
     );
+
+    buildInstrumentIndex();
 }
 
 void ImageSequencer::runSequenceParser(SequenceParser& parser) {
@@ -442,10 +565,14 @@ void ImageSequencer::runSequenceParser(SequenceParser& parser) {
         if (t.second->decoderType() == "CAMERA" || t.second->decoderType() == "SCANNER") {
             const std::vector<std::string>& spiceIDs = t.second->translations();
             for (const std::string& id : spiceIDs) {
-                for (std::pair<std::string, bool>& switching : _switchingMap) {
-                    if (switching.first == id) {
-                        switching.second = false;
-                    }
+                const auto it = std::find_if(
+                    _switchingMap.begin(),
+                    _switchingMap.end(),
+                    [&id](const std::pair<std::string, bool>& s) { return s.first == id; }
+                );
+                if (it == _switchingMap.end()) {
+                    _switchingMap.emplace_back(id, false);
+                    _switchingMapIds.push_back(internInstrument(id));
                 }
             }
         }
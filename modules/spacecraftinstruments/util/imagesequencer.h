@@ -86,12 +86,12 @@ public:
     /**
      * Retrieves the next upcoming target in time.
      */
-    std::pair<double, std::string> nextTarget(double time);
+    const std::pair<double, std::string>& nextTarget(double time) const;
 
     /**
      * Retrieves the most current target in time.
      */
-    std::pair<double, std::string> currentTarget(double time);
+    const std::pair<double, std::string>& currentTarget(double time) const;
 
     /**
      * Retrieves current target and (in the list) adjacent targets, the number to retrieve
@@ -113,9 +113,10 @@ public:
 
     /**
      * Returns a vector with key instrument names whose value indicate whether an
-     * instrument is active or not.
+     * instrument is active or not. The vector is updated in place and stays valid until
+     * the next call.
      */
-    std::vector<std::pair<std::string, bool>> activeInstruments(double time);
+    const std::vector<std::pair<std::string, bool>>& activeInstruments(double time);
 
     /**
      * Retrieves the relevant data from a specific subset based on the what instance
@@ -125,10 +126,26 @@ public:
     bool imagePaths(std::vector<Image>& captures, const std::string& projectee,
         const std::string& instrumentRequest, double time, double sinceTime);
 
+    /**
+     * Returns up to \p maxImages images of the \p instrument for the \p projectee that
+     * are captured at or after \p time, in the order in which imagePaths will return
+     * them.
+     */
+    std::vector<Image> upcomingImages(const std::string& projectee,
+        const std::string& instrument, double time, size_t maxImages) const;
+
+    /**
+     * Returns the id under which the SPICE instrument \p instrumentID is known to the
+     * sequencer, or -1 if no parsed sequence uses the instrument. The ids do not change
+     * when further sequences are parsed.
+     */
+    int instrumentId(const std::string& instrumentID) const;
+
     /**
      * returns true if instrumentID is within a capture range.
      */
-    bool isInstrumentActive(double time, const std::string& instrumentID);
+    bool isInstrumentActive(double time, const std::string& instrumentID) const;
+    bool isInstrumentActive(double time, int instrumentId) const;
 
     float instrumentActiveTime(double time, const std::string& instrumentID) const;
 
@@ -140,6 +157,24 @@ public:
 private:
     void sortData();
 
+    /**
+     * Builds the index of the _instrumentTimes. The sorted start and end times of all
+     * intervals split the time line into segments, and for each segment the index stores
+     * the intervals that contain its start. Every interval that contains a time is one
+     * of the intervals stored for the segment of that time.
+     */
+    void buildInstrumentIndex();
+
+    /// Returns the interned id of \p instrumentID and creates one if it is new
+    int internInstrument(const std::string& instrumentID);
+
+    /**
+     * Returns the range of indices into _instrumentTimes of the intervals that might
+     * contain \p time. Intervals that end right before \p time still have to be
+     * filtered out by TimeRange::includes.
+     */
+    std::pair<const int*, const int*> candidateIntervals(double time) const;
+
     /**
      * _fileTranslation handles any types of ambiguities between the data and
      * spice/openspace -calls. This map is composed of a key that is a string in
@@ -163,6 +198,11 @@ private:
      * instrument name.
      */
     std::vector<std::pair<std::string, bool>> _switchingMap;
+    // The instrument id of each entry in the _switchingMap
+    std::vector<int> _switchingMapIds;
+
+    // The interned ids of the SPICE instruments
+    std::map<std::string, int> _instrumentIds;
 
     /**
      * This datastructure holds the specific times when the spacecraft switches from
@@ -177,6 +217,15 @@ private:
      */
     std::vector<std::pair<std::string, TimeRange>> _instrumentTimes;
 
+    // The instrument ids of the SPICE instruments of each entry in _instrumentTimes
+    std::vector<std::vector<int>> _intervalInstruments;
+    // The sorted start and end times of the _instrumentTimes, see buildInstrumentIndex
+    std::vector<double> _intervalBoundaries;
+    // The intervals of the segment starting at _intervalBoundaries[i] are stored in
+    // _boundaryIntervals between _boundaryOffsets[i] and _boundaryOffsets[i + 1]
+    std::vector<int> _boundaryOffsets;
+    std::vector<int> _boundaryIntervals;
+
     /**
      * Each consecutive images capture time, for easier traversal.
      */
@@ -65,6 +65,29 @@ InstrumentTimesParser::InstrumentTimesParser(std::string name, std::string seque
     }
 }
 
+SequenceParser::CacheSources InstrumentTimesParser::cacheSources() const {
+    CacheSources sources;
+    sources.information = fmt::format(
+        "InstrumentTimesParser|{}|{}|{}|", _name, _fileName, _target
+    );
+    sources.information += translationInformation(_fileTranslation);
+
+    using RawPath = ghoul::filesystem::Directory::RawPath;
+    ghoul::filesystem::Directory sequenceDir(_fileName, RawPath::Yes);
+    for (const std::pair<const std::string, std::vector<std::string>>& p :
+         _instrumentFiles)
+    {
+        sources.information += "|" + p.first + ":";
+        for (const std::string& filename : p.second) {
+            sources.information += filename + ",";
+            sources.files.push_back(
+                FileSys.pathByAppendingComponent(sequenceDir.path(), filename)
+            );
+        }
+    }
+    return sources;
+}
+
 bool InstrumentTimesParser::create() {
     using RawPath = ghoul::filesystem::Directory::RawPath;
     ghoul::filesystem::Directory sequenceDir(_fileName, RawPath::Yes);
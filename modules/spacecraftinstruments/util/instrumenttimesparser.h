@@ -38,6 +38,9 @@ public:
 
     bool create() override;
 
+protected:
+    CacheSources cacheSources() const override;
+
 private:
     std::regex _pattern;
 
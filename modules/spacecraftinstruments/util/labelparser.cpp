@@ -32,6 +32,7 @@
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
 #include <fstream>
 
 namespace {
@@ -102,6 +103,38 @@ LabelParser::LabelParser(std::string name, std::string fileName,
     }
 }
 
+SequenceParser::CacheSources LabelParser::cacheSources() const {
+    CacheSources sources;
+    sources.information = fmt::format("LabelParser|{}|{}|", _name, _fileName);
+    for (const std::string& spec : _specsOfInterest) {
+        sources.information += spec + ",";
+    }
+    // The images are found by the extensions that can be read
+    for (const std::string& ext : ghoul::io::TextureReader::ref().supportedExtensions()) {
+        sources.information += ext + ",";
+    }
+    sources.information += "|" + translationInformation(_fileTranslation);
+
+    using RawPath = ghoul::filesystem::Directory::RawPath;
+    ghoul::filesystem::Directory sequenceDir(_fileName, RawPath::Yes);
+    if (!FileSys.directoryExists(sequenceDir)) {
+        return sources;
+    }
+
+    using Recursive = ghoul::filesystem::Directory::Recursive;
+    using Sort = ghoul::filesystem::Directory::Sort;
+    for (std::string& path : sequenceDir.read(Recursive::Yes, Sort::Yes)) {
+        const std::string extension = ghoul::filesystem::File(path).fileExtension();
+        if (extension == "lbl" || extension == "LBL") {
+            sources.files.push_back(std::move(path));
+        }
+        else {
+            sources.listedFiles.push_back(std::move(path));
+        }
+    }
+    return sources;
+}
+
 std::string LabelParser::decode(const std::string& line) {
     for (std::pair<const std::string, std::unique_ptr<Decoder>>& key : _fileTranslation) {
         std::size_t value = line.find(key.first);
@@ -278,11 +311,6 @@ bool LabelParser::create() {
                         _subsetMap[image.target]._range.include(startTime);
 
                         _captureProgression.push_back(startTime);
-                        std::stable_sort(
-                            _captureProgression.begin(),
-                            _captureProgression.end()
-                        );
-
                         break;
                     }
                 }
@@ -290,6 +318,10 @@ bool LabelParser::create() {
         } while (!file.eof());
     }
 
+    // Sorting once after all files have been read is much cheaper than keeping the
+    // captures sorted while they are added
+    std::stable_sort(_captureProgression.begin(), _captureProgression.end());
+
     std::vector<Image> tmp;
     for (const std::pair<const std::string, ImageSubset>& key : _subsetMap) {
         for (const Image& image : key.second._subset) {
@@ -308,17 +340,17 @@ bool LabelParser::create() {
         if (previousTarget != image.target) {
             previousTarget = image.target;
             _targetTimes.emplace_back(image.timeRange.start , image.target);
-            std::sort(
-                _targetTimes.begin(),
-                _targetTimes.end(),
-                [](const std::pair<double, std::string> &a,
-                   const std::pair<double, std::string> &b) -> bool
-                {
-                    return a.first < b.first;
-                }
-            );
         }
     }
+    std::stable_sort(
+        _targetTimes.begin(),
+        _targetTimes.end(),
+        [](const std::pair<double, std::string> &a,
+           const std::pair<double, std::string> &b) -> bool
+        {
+            return a.first < b.first;
+        }
+    );
 
     for (const std::pair<const std::string, ImageSubset>& target : _subsetMap) {
         _instrumentTimes.emplace_back(lblName, _subsetMap[target.first]._range);
@@ -36,10 +36,13 @@ public:
 
     bool create() override;
 
+protected:
+    CacheSources cacheSources() const override;
+
+private:
     // temporary need to figure this out
     //std::map<std::string, Decoder*> translations() { return _fileTranslation; };
 
-private:
     void createImage(Image& image, double startTime, double stopTime,
         std::vector<std::string> instr, std::string target, std::string path);
 
@@ -28,10 +28,13 @@
 #include <modules/spacecraftinstruments/util/imagesequencer.h>
 #include <modules/spacecraftinstruments/util/instrumenttimesparser.h>
 #include <modules/spacecraftinstruments/util/labelparser.h>
+#include <modules/spacecraftinstruments/util/sparseprojectiontarget.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/scene/scenegraphnode.h>
+#include <openspace/util/job.h>
 #include <ghoul/glm.h>
+#include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/misc/dictionary.h>
@@ -42,6 +45,8 @@
 #include <ghoul/opengl/textureunit.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
+#include <fstream>
 
 namespace {
     constexpr const char* keyPotentialTargets = "PotentialTargets";
@@ -62,6 +67,7 @@ namespace {
     constexpr const char* keyNeedsTextureMapDilation = "TextureMap";
     constexpr const char* keyNeedsShadowing = "ShadowMap";
     constexpr const char* keyTextureMapAspectRatio = "AspectRatio";
+    constexpr const char* keySparseTexture = "SparseTexture";
 
     constexpr const char* sequenceTypeImage = "image-sequence";
     constexpr const char* sequenceTypePlaybook = "playbook";
@@ -72,6 +78,59 @@ namespace {
 
     constexpr const char* _loggerCat = "ProjectionComponent";
 
+    // The number of images that can be prefetched ahead of the current time
+    constexpr const size_t NumPrefetchedImages = 32;
+    // Limits the time the main thread spends on decoding prefetched images every frame
+    constexpr const int MaxDecodedImagesPerFrame = 8;
+
+    // The time after which the pages of an unused sparse projection texture are evicted
+    constexpr const std::chrono::seconds SparseEvictionTime = std::chrono::seconds(30);
+
+    using ImageFile = openspace::ProjectionComponent::ImageFile;
+
+    // Reads the content of a single image file on one of the image reader threads. The
+    // decoding has to happen on the main thread, as textures cannot be created without
+    // the OpenGL context
+    struct ImageReadJob : public openspace::Job<ImageFile> {
+        ImageReadJob(std::string path, std::string absolutePath)
+            : _absolutePath(std::move(absolutePath))
+        {
+            _imageFile.path = std::move(path);
+        }
+
+        void execute() override {
+            std::ifstream file(_absolutePath, std::ifstream::binary | std::ifstream::ate);
+            if (!file.good()) {
+                return;
+            }
+            const std::streamsize size = file.tellg();
+            file.seekg(0, std::ifstream::beg);
+            _imageFile.content.resize(static_cast<size_t>(size));
+            file.read(_imageFile.content.data(), size);
+            _imageFile.isSuccessful = file.good();
+        }
+
+        ImageFile product() override {
+            return std::move(_imageFile);
+        }
+
+        std::string _absolutePath;
+        ImageFile _imageFile;
+    };
+
+    void prepareProjectionTexture(ghoul::opengl::Texture& texture) {
+        using ghoul::opengl::Texture;
+
+        if (texture.format() == Texture::Format::Red) {
+            ghoul::opengl::convertTextureFormat(texture, Texture::Format::RGB);
+        }
+        texture.uploadTexture();
+        texture.setWrapping(
+            { Texture::WrappingMode::Repeat, Texture::WrappingMode::MirroredRepeat }
+        );
+        texture.setFilter(Texture::FilterMode::LinearMipMap);
+    }
+
     constexpr openspace::properties::Property::PropertyInfo ProjectionInfo = {
         "PerformProjection",
         "Perform Projections",
@@ -215,6 +274,17 @@ documentation::Documentation ProjectionComponent::Documentation() {
                 "necessary as planets usually have 2x1 aspect ratios, whereas this does "
                 "not hold for non-planet objects (comets, asteroids, etc). The default "
                 "value is '1.0'."
+            },
+            {
+                keySparseTexture,
+                new BoolVerifier,
+                Optional::Yes,
+                "If this value is 'true', the images are projected into a sparse texture "
+                "of the largest supported size, of which only the regions that images "
+                "were projected onto use video memory. The pages of the texture are "
+                "written to disk while the object is not rendered. This is only "
+                "supported for planet projections and requires the "
+                "GL_ARB_sparse_texture extension. The default value is 'false'."
             }
         }
     };
@@ -227,6 +297,8 @@ ProjectionComponent::ProjectionComponent()
     , _projectionFading(FadingInfo, 1.f, 0.f, 1.f)
     , _textureSize(TextureSizeInfo, glm::ivec2(16), glm::ivec2(16), glm::ivec2(32768))
     , _applyTextureSize(ApplyTextureSizeInfo)
+    , _imageRing(NumPrefetchedImages)
+    , _imageReader(ThreadPool(2))
 {
     addProperty(_performProjection);
     addProperty(_clearAllProjections);
@@ -237,6 +309,8 @@ ProjectionComponent::ProjectionComponent()
     _applyTextureSize.onChange([this]() { _textureSizeDirty = true; });
 }
 
+ProjectionComponent::~ProjectionComponent() {}
+
 void ProjectionComponent::initialize(const std::string& identifier,
                                      const ghoul::Dictionary& dictionary)
 {
@@ -281,6 +355,11 @@ void ProjectionComponent::initialize(const std::string& identifier,
             static_cast<float>(dictionary.value<double>(keyTextureMapAspectRatio));
     }
 
+    if (dictionary.hasKeyAndValue<bool>(keySparseTexture)) {
+        _sparse.isRequested = dictionary.value<bool>(keySparseTexture);
+        _sparse.identifier = identifier;
+    }
+
 
     if (!dictionary.hasKey(keySequenceDir)) {
         return;
@@ -372,7 +451,7 @@ void ProjectionComponent::initialize(const std::string& identifier,
     }
 
     for (std::unique_ptr<SequenceParser>& parser : parsers) {
-        bool success = parser->create();
+        bool success = parser->createCached();
         if (!success) {
             LERROR("One or more sequence loads failed; please check mod files");
         }
@@ -384,17 +463,20 @@ void ProjectionComponent::initialize(const std::string& identifier,
 }
 
 bool ProjectionComponent::initializeGL() {
-    int maxSize = OpenGLCap.max2DTextureSize();
+    auto sizeForAspectRatio = [this](int maxSize) {
+        glm::ivec2 size;
+        if (_projectionTextureAspectRatio > 1.f) {
+            size.x = maxSize;
+            size.y = static_cast<int>(maxSize / _projectionTextureAspectRatio);
+        }
+        else {
+            size.x = static_cast<int>(maxSize * _projectionTextureAspectRatio);
+            size.y = maxSize;
+        }
+        return size;
+    };
 
-    glm::ivec2 size;
-    if (_projectionTextureAspectRatio > 1.f) {
-        size.x = maxSize;
-        size.y = static_cast<int>(maxSize / _projectionTextureAspectRatio);
-    }
-    else {
-        size.x = static_cast<int>(maxSize * _projectionTextureAspectRatio);
-        size.y = maxSize;
-    }
+    glm::ivec2 size = sizeForAspectRatio(OpenGLCap.max2DTextureSize());
 
     _textureSize.setMaxValue(size);
     _textureSize = size / 2;
@@ -402,7 +484,30 @@ bool ProjectionComponent::initializeGL() {
     // We only want to use half the resolution per default:
     size /= 2;
 
-    bool success = generateProjectionLayerTexture(size);
+    glm::ivec2 projectionSize = size;
+    if (_sparse.isRequested) {
+        if (SparseProjectionTarget::isSupported()) {
+            _sparse.target = std::make_unique<SparseProjectionTarget>(_sparse.identifier);
+            _sparse.lastUse = std::chrono::steady_clock::now();
+
+            // Only the regions that are projected onto use memory, so there is no reason
+            // not to use the largest size. Resizing would require all pages to be copied
+            projectionSize = sizeForAspectRatio(
+                SparseProjectionTarget::maximumTextureSize()
+            );
+            _textureSize.setMaxValue(projectionSize);
+            _textureSize = projectionSize;
+            _textureSize.setReadOnly(true);
+            _applyTextureSize.setReadOnly(true);
+        }
+        else {
+            LWARNING(
+                "Sparse textures are not supported, using a regular texture instead"
+            );
+        }
+    }
+
+    bool success = generateProjectionLayerTexture(projectionSize);
     success &= generateDepthTexture(size);
     success &= auxiliaryRendertarget();
     success &= depthRendertarget();
@@ -461,6 +566,7 @@ bool ProjectionComponent::initializeGL() {
 
 bool ProjectionComponent::deinitialize() {
     _projectionTexture = nullptr;
+    _sparse.target = nullptr;
 
     glDeleteFramebuffers(1, &_fboID);
 
@@ -758,6 +864,14 @@ void ProjectionComponent::update() {
     if (_dilation.isEnabled && _dilation.program->isDirty()) {
         _dilation.program->rebuildFromFile();
     }
+
+    uploadPrefetchedImages();
+
+    if (_sparse.target && _sparse.target->isResident() &&
+        std::chrono::steady_clock::now() - _sparse.lastUse > SparseEvictionTime)
+    {
+        _sparse.target->evict();
+    }
 }
 
 bool ProjectionComponent::depthRendertarget() {
@@ -906,6 +1020,30 @@ ghoul::opengl::Texture& ProjectionComponent::projectionTexture() const {
     }
 }
 
+bool ProjectionComponent::isSparse() const {
+    return _sparse.target != nullptr;
+}
+
+void ProjectionComponent::commitProjectionRegion(const glm::vec2& uvMin,
+                                                 const glm::vec2& uvMax)
+{
+    if (_sparse.target) {
+        _sparse.target->commitRegion(uvMin, uvMax);
+    }
+}
+
+void ProjectionComponent::makeProjectionTextureResident() {
+    if (!_sparse.target) {
+        return;
+    }
+
+    _sparse.lastUse = std::chrono::steady_clock::now();
+    if (_sparse.target->makeResident()) {
+        // Only the base level is restored
+        _mipMapDirty = true;
+    }
+}
+
 std::string ProjectionComponent::projectorId() const {
     return _projectorID;
 }
@@ -931,6 +1069,14 @@ float ProjectionComponent::aspectRatio() const {
 }
 
 void ProjectionComponent::clearAllProjections() {
+    if (_sparse.target) {
+        // Releasing the pages clears them and at the same time frees their memory
+        _sparse.target->clear();
+        _clearAllProjections = false;
+        _mipMapDirty = true;
+        return;
+    }
+
     // keep handle to the current bound FBO
     GLint defaultFBO;
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &defaultFBO);
@@ -982,25 +1128,147 @@ std::shared_ptr<ghoul::opengl::Texture> ProjectionComponent::loadProjectionTextu
         return _placeholderTexture;
     }
 
+    const auto slot = std::find_if(
+        _imageRing.begin(),
+        _imageRing.end(),
+        [&texturePath](const ImageSlot& s) { return s.path == texturePath; }
+    );
+    if (slot != _imageRing.end()) {
+        // Every image is only projected once, so the slot can be reused right away. If
+        // the image is still being read, it is not waited for
+        std::shared_ptr<Texture> prefetched = std::move(slot->texture);
+        *slot = ImageSlot();
+        if (prefetched) {
+            return prefetched;
+        }
+    }
 
     unique_ptr<Texture> texture = TextureReader::ref().loadTexture(absPath(texturePath));
     if (texture) {
-        if (texture->format() == Texture::Format::Red) {
-            ghoul::opengl::convertTextureFormat(*texture, Texture::Format::RGB);
+        prepareProjectionTexture(*texture);
+    }
+    return std::move(texture);
+}
+
+void ProjectionComponent::prefetchProjectionTextures(double time) {
+    const std::vector<Image> images = ImageSequencer::ref().upcomingImages(
+        _projecteeID,
+        _instrumentID,
+        time,
+        _imageRing.size()
+    );
+
+    for (const Image& img : images) {
+        if (img.isPlaceholder) {
+            continue;
         }
-        texture->uploadTexture();
-        texture->setWrapping(
-            { Texture::WrappingMode::Repeat, Texture::WrappingMode::MirroredRepeat }
+
+        const bool isPrefetched = std::any_of(
+            _imageRing.begin(),
+            _imageRing.end(),
+            [&img](const ImageSlot& s) { return s.path == img.path; }
+        );
+        if (isPrefetched) {
+            continue;
+        }
+
+        // Unused slots have the lowest possible time, so they are picked first, followed
+        // by the slots of images that have passed without being projected
+        const auto slot = std::min_element(
+            _imageRing.begin(),
+            _imageRing.end(),
+            [](const ImageSlot& lhs, const ImageSlot& rhs) {
+                return lhs.time < rhs.time;
+            }
+        );
+        if (!slot->path.empty() && slot->time >= time) {
+            // The ring is filled with upcoming images, which are earlier than this one
+            break;
+        }
+
+        *slot = ImageSlot();
+        slot->path = img.path;
+        slot->time = img.timeRange.start;
+        _imageReader.enqueueJob(
+            std::make_shared<ImageReadJob>(img.path, absPath(img.path))
         );
-        texture->setFilter(Texture::FilterMode::LinearMipMap);
     }
-    return std::move(texture);
+}
+
+bool ProjectionComponent::isLoadingProjectionTexture(
+                                                   const std::string& texturePath) const
+{
+    return std::any_of(
+        _imageRing.begin(),
+        _imageRing.end(),
+        [&texturePath](const ImageSlot& s) { return s.path == texturePath && !s.texture; }
+    );
+}
+
+void ProjectionComponent::uploadPrefetchedImages() {
+    using ghoul::opengl::Texture;
+
+    int nDecoded = 0;
+    while (_imageReader.numFinishedJobs() > 0 && nDecoded < MaxDecodedImagesPerFrame) {
+        ImageFile file = _imageReader.popFinishedJob()->product();
+
+        const auto slot = std::find_if(
+            _imageRing.begin(),
+            _imageRing.end(),
+            [&file](const ImageSlot& s) { return s.path == file.path; }
+        );
+        if (slot == _imageRing.end() || slot->texture) {
+            // The image was projected or replaced while it was read
+            continue;
+        }
+
+        std::unique_ptr<Texture> texture;
+        if (file.isSuccessful) {
+            texture = ghoul::io::TextureReader::ref().loadTexture(
+                reinterpret_cast<void*>(file.content.data()),
+                file.content.size(),
+                ghoul::filesystem::File(file.path).fileExtension()
+            );
+            ++nDecoded;
+        }
+
+        if (!texture) {
+            // Free the slot, so that loadProjectionTexture reports the error when the
+            // image is due
+            *slot = ImageSlot();
+            continue;
+        }
+
+        prepareProjectionTexture(*texture);
+        slot->texture = std::move(texture);
+    }
 }
 
 bool ProjectionComponent::generateProjectionLayerTexture(const glm::ivec2& size) {
     LINFO(fmt::format("Creating projection texture of size '{}, {}'", size.x, size.y));
 
     using namespace ghoul::opengl;
+    if (_sparse.target) {
+        _projectionTexture = _sparse.target->createTexture(
+            size,
+            Texture::Format::RGBA,
+            GL_RGBA8
+        );
+        if (_dilation.isEnabled) {
+            _dilation.texture = _sparse.target->createTexture(
+                size,
+                Texture::Format::RGBA,
+                GL_RGBA8
+            );
+            _dilation.stencilTexture = _sparse.target->createTexture(
+                size,
+                Texture::Format::Red,
+                GL_R8
+            );
+        }
+        return _projectionTexture != nullptr;
+    }
+
     _projectionTexture = std::make_unique<Texture>(
         glm::uvec3(size, 1),
         Texture::Format::RGBA
@@ -31,8 +31,12 @@
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/vector/ivec2property.h>
+#include <openspace/util/concurrentjobmanager.h>
 #include <openspace/util/spicemanager.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <chrono>
+#include <limits>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 namespace ghoul::opengl {
@@ -44,9 +48,19 @@ namespace openspace {
 
 namespace documentation { struct Documentation; }
 
+class SparseProjectionTarget;
+
 class ProjectionComponent : public properties::PropertyOwner {
 public:
+    // The content of an image file that was read by one of the image reader threads
+    struct ImageFile {
+        std::string path;
+        std::vector<char> content;
+        bool isSuccessful = false;
+    };
+
     ProjectionComponent();
+    ~ProjectionComponent();
 
     void initialize(const std::string& identifier, const ghoul::Dictionary& dictionary);
     bool initializeGL();
@@ -65,9 +79,27 @@ public:
     bool auxiliaryRendertarget();
     bool depthRendertarget();
 
+    /**
+     * Returns the texture for the image at \p texturePath. If the image was prefetched,
+     * the texture that has already been uploaded is returned, otherwise the image is
+     * loaded synchronously.
+     */
     std::shared_ptr<ghoul::opengl::Texture> loadProjectionTexture(
         const std::string& texturePath, bool isPlaceholder = false);
 
+    /**
+     * Reads the images that the ImageSequencer provides for the projectee and instrument
+     * after \p time on the image reader threads. The images are decoded and uploaded in
+     * update, so that they are ready by the time they are projected.
+     */
+    void prefetchProjectionTextures(double time);
+
+    /**
+     * Returns \c true if the image at \p texturePath is prefetched but not uploaded yet.
+     * Projecting it should be postponed rather than loading it synchronously.
+     */
+    bool isLoadingProjectionTexture(const std::string& texturePath) const;
+
     glm::mat4 computeProjectorMatrix(const glm::vec3 loc, glm::dvec3 aim,
         const glm::vec3 up, const glm::dmat3& instrumentMatrix, float fieldOfViewY,
         float aspectRatio, float nearPlane, float farPlane, glm::vec3& boreSight);
@@ -84,6 +116,22 @@ public:
 
     ghoul::opengl::Texture& projectionTexture() const;
 
+    /// Returns \c true if the images are projected into sparse textures
+    bool isSparse() const;
+
+    /**
+     * Makes sure that the region of the projection texture between the texture
+     * coordinates \p uvMin and \p uvMax is backed by memory, so that images can be
+     * projected onto it. This only has an effect if the projection texture is sparse.
+     */
+    void commitProjectionRegion(const glm::vec2& uvMin, const glm::vec2& uvMax);
+
+    /**
+     * Has to be called in every frame in which the projection texture is used. Restores
+     * the pages of a sparse projection texture that were evicted while it was not used.
+     */
+    void makeProjectionTextureResident();
+
     std::string projectorId() const;
     std::string projecteeId() const;
     std::string instrumentId() const;
@@ -98,6 +146,9 @@ private:
     bool generateProjectionLayerTexture(const glm::ivec2& size);
     bool generateDepthTexture(const glm::ivec2& size);
 
+    /// Decodes and uploads the images that were read since the last call
+    void uploadPrefetchedImages();
+
 protected:
     properties::BoolProperty _performProjection;
     properties::BoolProperty _clearAllProjections;
@@ -141,6 +192,25 @@ protected:
         std::unique_ptr<ghoul::opengl::Texture> texture;
         std::unique_ptr<ghoul::opengl::Texture> stencilTexture;
     } _dilation;
+
+    // A slot in the ring of prefetched images
+    struct ImageSlot {
+        // The path of the image in this slot, empty if the slot is unused
+        std::string path;
+        // The start of the capture, so that slots of passed images can be reused
+        double time = std::numeric_limits<double>::lowest();
+        // nullptr while the image is being read
+        std::shared_ptr<ghoul::opengl::Texture> texture;
+    };
+    std::vector<ImageSlot> _imageRing;
+
+    struct {
+        bool isRequested = false;
+        std::string identifier;
+        std::unique_ptr<SparseProjectionTarget> target;
+        std::chrono::steady_clock::time_point lastUse;
+    } _sparse;
+    ConcurrentJobManager<ImageFile> _imageReader;
 };
 
 } // namespace openspace
@@ -26,11 +26,294 @@
 
 #include <openspace/engine/globals.h>
 #include <openspace/util/spicemanager.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr const char* _loggerCat = "SequenceParser";
+
+    // The version of the cached sequence files. This has to be increased whenever the
+    // layout of the cache files or the output of any parser changes
+    constexpr const int8_t SequenceCacheVersion = 1;
+
+    // The number of bytes at the beginning and at the end of a source file that are
+    // included in its hash
+    constexpr const std::streamoff HashedBytes = 1024 * 1024;
+
+    constexpr const uint64_t FnvOffsetBasis = 14695981039346656037ULL;
+    constexpr const uint64_t FnvPrime = 1099511628211ULL;
+
+    void hashBytes(uint64_t& hash, const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= FnvPrime;
+        }
+    }
+
+    void hashString(uint64_t& hash, const std::string& value) {
+        // The terminating zero separates consecutive strings
+        hashBytes(hash, value.c_str(), value.size() + 1);
+    }
+
+    // Computes the FNV-1a hash over the paths of all sources, and the size and the
+    // beginning and the end of the content of the files that are read
+    uint64_t sourceHash(const std::vector<std::string>& files,
+                        const std::vector<std::string>& listedFiles)
+    {
+        uint64_t hash = FnvOffsetBasis;
+        std::vector<char> buffer;
+        for (const std::string& path : files) {
+            hashString(hash, path);
+
+            std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+            const std::streamoff size = file.good() ? file.tellg() : std::streamoff(-1);
+            hashBytes(hash, reinterpret_cast<const char*>(&size), sizeof(size));
+
+            auto hashRange = [&](std::streamoff begin, std::streamoff count) {
+                buffer.resize(static_cast<size_t>(count));
+                file.seekg(begin);
+                file.read(buffer.data(), count);
+                hashBytes(hash, buffer.data(), buffer.size());
+            };
+            if (size <= 0) {
+                continue;
+            }
+            else if (size <= 2 * HashedBytes) {
+                hashRange(0, size);
+            }
+            else {
+                hashRange(0, HashedBytes);
+                hashRange(size - HashedBytes, HashedBytes);
+            }
+        }
+        for (const std::string& path : listedFiles) {
+            hashString(hash, path);
+        }
+        return hash;
+    }
+
+    template <typename T>
+    void writeValue(std::vector<char>& buffer, const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void writeValue(std::vector<char>& buffer, const std::string& value) {
+        writeValue(buffer, static_cast<uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    // Reads the values from a cache file that was loaded with a single read. Once the
+    // end of the data is reached, isGood returns false and all values are zero or empty
+    struct CacheReader {
+        template <typename T>
+        T read() {
+            T value = T();
+            if (isGood && offset + sizeof(T) <= data.size()) {
+                std::memcpy(&value, data.data() + offset, sizeof(T));
+                offset += sizeof(T);
+            }
+            else {
+                isGood = false;
+            }
+            return value;
+        }
+
+        std::string readString() {
+            const uint32_t size = read<uint32_t>();
+            if (!isGood || offset + size > data.size()) {
+                isGood = false;
+                return std::string();
+            }
+            std::string value(data.data() + offset, size);
+            offset += size;
+            return value;
+        }
+
+        const std::vector<char>& data;
+        size_t offset = 0;
+        bool isGood = true;
+    };
+} // namespace
 
 namespace openspace {
 
+bool SequenceParser::createCached() {
+    const CacheSources sources = cacheSources();
+    if (sources.information.empty() || !FileSys.cacheManager()) {
+        return create();
+    }
+
+    const std::string cacheFile = FileSys.cacheManager()->cachedFilename(
+        "sequence",
+        sources.information,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+    const uint64_t hash = sourceHash(sources.files, sources.listedFiles);
+
+    if (FileSys.fileExists(cacheFile)) {
+        if (loadCache(cacheFile, hash)) {
+            LDEBUG(fmt::format("Loaded sequence from cache '{}'", cacheFile));
+            return true;
+        }
+
+        // Remove anything that was read before the cache turned out to be outdated
+        _subsetMap.clear();
+        _instrumentTimes.clear();
+        _targetTimes.clear();
+        _captureProgression.clear();
+    }
+
+    if (!create()) {
+        return false;
+    }
+
+    if (!saveCache(cacheFile, hash)) {
+        LWARNING(fmt::format("Could not write sequence cache '{}'", cacheFile));
+    }
+    return true;
+}
+
+bool SequenceParser::loadCache(const std::string& cacheFile, uint64_t hash) {
+    std::ifstream file(cacheFile, std::ios::in | std::ios::binary | std::ios::ate);
+    const std::streamoff size = file.tellg();
+    if (!file.good() || size <= 0) {
+        return false;
+    }
+    std::vector<char> data(static_cast<size_t>(size));
+    file.seekg(0);
+    file.read(data.data(), size);
+    if (!file.good()) {
+        return false;
+    }
+
+    CacheReader reader = { data };
+    const int8_t version = reader.read<int8_t>();
+    const uint64_t cachedHash = reader.read<uint64_t>();
+    if (!reader.isGood || version != SequenceCacheVersion || cachedHash != hash) {
+        return false;
+    }
+
+    const uint64_t nSubsets = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < nSubsets && reader.isGood; ++i) {
+        ImageSubset& subset = _subsetMap[reader.readString()];
+        subset._range.start = reader.read<double>();
+        subset._range.end = reader.read<double>();
+
+        const uint64_t nImages = reader.read<uint64_t>();
+        if (!reader.isGood) {
+            break;
+        }
+        subset._subset.resize(static_cast<size_t>(nImages));
+        for (Image& image : subset._subset) {
+            image.timeRange.start = reader.read<double>();
+            image.timeRange.end = reader.read<double>();
+            image.path = reader.readString();
+            const uint32_t nInstruments = reader.read<uint32_t>();
+            for (uint32_t j = 0; j < nInstruments && reader.isGood; ++j) {
+                image.activeInstruments.push_back(reader.readString());
+            }
+            image.target = reader.readString();
+            image.isPlaceholder = reader.read<uint8_t>() != 0;
+            image.projected = reader.read<uint8_t>() != 0;
+        }
+    }
+
+    const uint64_t nInstrumentTimes = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < nInstrumentTimes && reader.isGood; ++i) {
+        std::string instrument = reader.readString();
+        const double start = reader.read<double>();
+        const double end = reader.read<double>();
+        _instrumentTimes.emplace_back(std::move(instrument), TimeRange(start, end));
+    }
+
+    const uint64_t nTargetTimes = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < nTargetTimes && reader.isGood; ++i) {
+        const double time = reader.read<double>();
+        _targetTimes.emplace_back(time, reader.readString());
+    }
+
+    const uint64_t nCaptures = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < nCaptures && reader.isGood; ++i) {
+        _captureProgression.push_back(reader.read<double>());
+    }
+
+    return reader.isGood && reader.offset == data.size();
+}
+
+bool SequenceParser::saveCache(const std::string& cacheFile, uint64_t hash) const {
+    // The whole cache is assembled in memory, so that it can be loaded with a single
+    // read of the file
+    std::vector<char> data;
+    writeValue(data, SequenceCacheVersion);
+    writeValue(data, hash);
+
+    writeValue(data, static_cast<uint64_t>(_subsetMap.size()));
+    for (const std::pair<const std::string, ImageSubset>& subset : _subsetMap) {
+        writeValue(data, subset.first);
+        writeValue(data, subset.second._range.start);
+        writeValue(data, subset.second._range.end);
+
+        writeValue(data, static_cast<uint64_t>(subset.second._subset.size()));
+        for (const Image& image : subset.second._subset) {
+            writeValue(data, image.timeRange.start);
+            writeValue(data, image.timeRange.end);
+            writeValue(data, image.path);
+            writeValue(data, static_cast<uint32_t>(image.activeInstruments.size()));
+            for (const std::string& instrument : image.activeInstruments) {
+                writeValue(data, instrument);
+            }
+            writeValue(data, image.target);
+            writeValue(data, static_cast<uint8_t>(image.isPlaceholder));
+            writeValue(data, static_cast<uint8_t>(image.projected));
+        }
+    }
+
+    writeValue(data, static_cast<uint64_t>(_instrumentTimes.size()));
+    for (const std::pair<std::string, TimeRange>& instrumentTime : _instrumentTimes) {
+        writeValue(data, instrumentTime.first);
+        writeValue(data, instrumentTime.second.start);
+        writeValue(data, instrumentTime.second.end);
+    }
+
+    writeValue(data, static_cast<uint64_t>(_targetTimes.size()));
+    for (const std::pair<double, std::string>& targetTime : _targetTimes) {
+        writeValue(data, targetTime.first);
+        writeValue(data, targetTime.second);
+    }
+
+    writeValue(data, static_cast<uint64_t>(_captureProgression.size()));
+    for (double capture : _captureProgression) {
+        writeValue(data, capture);
+    }
+
+    std::ofstream file(cacheFile, std::ios::out | std::ios::binary);
+    file.write(data.data(), data.size());
+    return file.good();
+}
+
+SequenceParser::CacheSources SequenceParser::cacheSources() const {
+    return CacheSources();
+}
+
+std::string SequenceParser::translationInformation(const std::map<std::string,
+                                                std::unique_ptr<Decoder>>& translations)
+{
+    std::string information;
+    for (const std::pair<const std::string, std::unique_ptr<Decoder>>& t : translations) {
+        information += t.first + "=" + t.second->decoderType() + ":";
+        for (const std::string& translation : t.second->translations()) {
+            information += translation + ",";
+        }
+        information += ";";
+    }
+    return information;
+}
+
 std::map<std::string, ImageSubset>& SequenceParser::getSubsetMap() {
     return _subsetMap;
 }
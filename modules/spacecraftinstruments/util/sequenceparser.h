@@ -29,6 +29,7 @@
 #include <openspace/util/timerange.h>
 #include <modules/spacecraftinstruments/util/image.h>
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -40,6 +41,14 @@ class SequenceParser {
 public:
     virtual ~SequenceParser() = default;
     virtual bool create() = 0;
+
+    /**
+     * Fills the tables of this parser from its binary cache if the cache is up to date.
+     * Otherwise, #create is called and its result is written to the cache. The cache is
+     * invalidated if any of the files returned by #cacheSources change.
+     */
+    bool createCached();
+
     std::map<std::string, ImageSubset>& getSubsetMap();
     const std::vector<std::pair<std::string, TimeRange>>& getInstrumentTimes() const;
     const std::vector<std::pair<double, std::string>>& getTargetTimes() const ;
@@ -47,12 +56,38 @@ public:
     const std::vector<double>& getCaptureProgression() const;
 
 protected:
+    /// Describes everything that the result of #create depends on
+    struct CacheSources {
+        /// The configuration of the parser, which identifies the cache. If this is
+        /// empty, the parser is not cached
+        std::string information;
+        /// The files whose content is read by #create
+        std::vector<std::string> files;
+        /// The files of which #create only checks the existence
+        std::vector<std::string> listedFiles;
+    };
+
+    /**
+     * Returns the sources from which #create builds the tables. The default
+     * implementation returns empty sources, which disables the cache.
+     */
+    virtual CacheSources cacheSources() const;
+
+    /// Returns a description of \p translations that can be added to the information
+    static std::string translationInformation(
+        const std::map<std::string, std::unique_ptr<Decoder>>& translations);
+
     std::map<std::string, ImageSubset> _subsetMap;
     std::vector<std::pair<std::string, TimeRange>> _instrumentTimes;
     std::vector<std::pair<double, std::string>> _targetTimes;
     std::vector<double> _captureProgression;
 
     std::map<std::string, std::unique_ptr<Decoder>> _fileTranslation;
+
+private:
+    /// Reads the tables from the \p cacheFile if it was written for the \p hash
+    bool loadCache(const std::string& cacheFile, uint64_t hash);
+    bool saveCache(const std::string& cacheFile, uint64_t hash) const;
 };
 
 } // namespace openspace
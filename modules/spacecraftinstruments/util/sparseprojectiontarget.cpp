@@ -0,0 +1,412 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <modules/spacecraftinstruments/util/sparseprojectiontarget.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace {
+    constexpr const char* _loggerCat = "SparseProjectionTarget";
+
+    // The edge length of the pages in texels. This has to be a multiple of the virtual
+    // page size of all formats that are used, which is at most 256 texels for the 8 bit
+    // formats on current hardware
+    constexpr const int PageSize = 512;
+
+    size_t nChannels(ghoul::opengl::Texture::Format format) {
+        using Format = ghoul::opengl::Texture::Format;
+        switch (format) {
+            case Format::Red:  return 1;
+            case Format::RG:   return 2;
+            case Format::RGB:  return 3;
+            case Format::RGBA: return 4;
+            default:           throw ghoul::MissingCaseException();
+        }
+    }
+} // namespace
+
+namespace openspace {
+
+bool SparseProjectionTarget::isSupported() {
+    return OpenGLCap.isExtensionSupported("GL_ARB_sparse_texture");
+}
+
+int SparseProjectionTarget::maximumTextureSize() {
+    GLint size = 0;
+    glGetIntegerv(GL_MAX_SPARSE_TEXTURE_SIZE_ARB, &size);
+    // Only full pages can be committed, so the size is reduced to the last full page
+    return (size / PageSize) * PageSize;
+}
+
+SparseProjectionTarget::SparseProjectionTarget(std::string identifier)
+    : _identifier(std::move(identifier))
+{}
+
+SparseProjectionTarget::~SparseProjectionTarget() {
+    if (_cacheWrite.valid()) {
+        _cacheWrite.wait();
+    }
+    glDeleteFramebuffers(1, &_fbo);
+}
+
+std::unique_ptr<ghoul::opengl::Texture> SparseProjectionTarget::createTexture(
+                                                                  const glm::ivec2& size,
+                                                  ghoul::opengl::Texture::Format format,
+                                                                   GLenum internalFormat)
+{
+    using ghoul::opengl::Texture;
+
+    glm::ivec2 formatPageSize;
+    glGetInternalformativ(
+        GL_TEXTURE_2D,
+        internalFormat,
+        GL_VIRTUAL_PAGE_SIZE_X_ARB,
+        1,
+        &formatPageSize.x
+    );
+    glGetInternalformativ(
+        GL_TEXTURE_2D,
+        internalFormat,
+        GL_VIRTUAL_PAGE_SIZE_Y_ARB,
+        1,
+        &formatPageSize.y
+    );
+    if (formatPageSize.x <= 0 || formatPageSize.y <= 0 ||
+        PageSize % formatPageSize.x != 0 || PageSize % formatPageSize.y != 0)
+    {
+        LERROR(fmt::format(
+            "Unsupported virtual page size '{}, {}'", formatPageSize.x, formatPageSize.y
+        ));
+        return nullptr;
+    }
+
+    if (_textures.empty()) {
+        _pageSize = glm::ivec2(PageSize);
+        _nPages = (size + _pageSize - 1) / _pageSize;
+        const int maxSize = std::max(_nPages.x, _nPages.y) * PageSize;
+        _nLevels = static_cast<int>(std::log2(maxSize)) + 1;
+        _isCommitted.assign(static_cast<size_t>(_nPages.x * _nPages.y), false);
+        _nCommittedPages = 0;
+    }
+    ghoul_assert(
+        (size + _pageSize - 1) / _pageSize == _nPages,
+        "All textures of a target must have the same size"
+    );
+    const glm::ivec2 textureSize = _nPages * _pageSize;
+
+    auto texture = std::make_unique<Texture>(
+        glm::uvec3(textureSize, 1),
+        format,
+        internalFormat,
+        GL_UNSIGNED_BYTE,
+        Texture::FilterMode::Linear,
+        Texture::WrappingMode::Repeat,
+        Texture::AllocateData::No
+    );
+    texture->bind();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, static_cast<GLint>(GL_TRUE));
+    glTexStorage2D(GL_TEXTURE_2D, _nLevels, internalFormat, textureSize.x, textureSize.y);
+
+    GLint nSparseLevels = 0;
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_NUM_SPARSE_LEVELS_ARB, &nSparseLevels);
+    nSparseLevels = std::min(nSparseLevels, _nLevels);
+    if (nSparseLevels < _nLevels) {
+        // The levels that are smaller than a page share the mip tail, which is small
+        // enough to always be committed
+        const glm::ivec2 tailSize = glm::max(textureSize >> nSparseLevels, 1);
+        glTexPageCommitmentARB(
+            GL_TEXTURE_2D,
+            nSparseLevels,
+            0, 0, 0,
+            tailSize.x, tailSize.y, 1,
+            GL_TRUE
+        );
+    }
+
+    const std::string cacheFile = FileSys.cacheManager()->cachedFilename(
+        fmt::format("{}-projection-{}", _identifier, _textures.size()),
+        "",
+        ghoul::filesystem::CacheManager::Persistent::No
+    );
+
+    _textures.push_back({
+        texture.get(),
+        static_cast<GLenum>(format),
+        nChannels(format),
+        formatPageSize,
+        nSparseLevels,
+        cacheFile
+    });
+    return texture;
+}
+
+void SparseProjectionTarget::commitRegion(const glm::vec2& uvMin, const glm::vec2& uvMax)
+{
+    ghoul_assert(_isResident, "Pages can only be committed while the target is resident");
+
+    const glm::vec2 textureSize = glm::vec2(_nPages * _pageSize);
+    const glm::ivec2 first =
+        glm::ivec2(glm::clamp(uvMin, 0.f, 1.f) * textureSize) / _pageSize - 1;
+    const glm::ivec2 last =
+        glm::ivec2(glm::clamp(uvMax, 0.f, 1.f) * textureSize) / _pageSize + 1;
+
+    for (int y = std::max(first.y, 0); y <= std::min(last.y, _nPages.y - 1); ++y) {
+        for (int x = first.x; x <= std::min(last.x, first.x + _nPages.x - 1); ++x) {
+            // The textures repeat along the x axis, so the margin wraps around
+            const int page = y * _nPages.x + (x + _nPages.x) % _nPages.x;
+            if (!_isCommitted[page]) {
+                commitPage(page);
+            }
+        }
+    }
+}
+
+void SparseProjectionTarget::commitPage(int page) {
+    if (_fbo == 0) {
+        glGenFramebuffers(1, &_fbo);
+    }
+
+    GLint defaultFbo;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &defaultFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+
+    // The content of newly committed memory is undefined, so the page has to be
+    // cleared before anything is projected onto it
+    const glm::ivec2 offset = pageOffset(page);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(offset.x, offset.y, _pageSize.x, _pageSize.y);
+    glClearColor(0.f, 0.f, 0.f, 0.f);
+    for (const SparseTexture& t : _textures) {
+        setCommitment(t, page, true);
+
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D,
+            *t.texture,
+            0
+        );
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
+
+    _isCommitted[page] = true;
+    ++_nCommittedPages;
+}
+
+void SparseProjectionTarget::setCommitment(const SparseTexture& t, int page,
+                                           bool commit)
+{
+    t.texture->bind();
+
+    const glm::ivec2 textureSize = _nPages * _pageSize;
+    for (int level = 0; level < t.nSparseLevels; ++level) {
+        const glm::ivec2 levelSize = glm::max(textureSize >> level, 1);
+
+        // On the coarser levels, a page of the format covers more than one of our pages.
+        // These shared pages are only ever released together with all of their pages
+        glm::ivec2 extent = glm::max(_pageSize >> level, t.pageSize);
+        const glm::ivec2 offset = ((pageOffset(page) >> level) / extent) * extent;
+        extent = glm::min(extent, levelSize - offset);
+
+        glTexPageCommitmentARB(
+            GL_TEXTURE_2D,
+            level,
+            offset.x, offset.y, 0,
+            extent.x, extent.y, 1,
+            commit ? GL_TRUE : GL_FALSE
+        );
+    }
+}
+
+glm::ivec2 SparseProjectionTarget::pageOffset(int page) const {
+    return glm::ivec2(page % _nPages.x, page / _nPages.x) * _pageSize;
+}
+
+void SparseProjectionTarget::clear() {
+    for (int page = 0; page < static_cast<int>(_isCommitted.size()); ++page) {
+        if (_isCommitted[page]) {
+            for (const SparseTexture& t : _textures) {
+                setCommitment(t, page, false);
+            }
+        }
+    }
+    std::fill(_isCommitted.begin(), _isCommitted.end(), false);
+    _nCommittedPages = 0;
+
+    _evictedPages.clear();
+    _isResident = true;
+}
+
+void SparseProjectionTarget::evict() {
+    if (!_isResident) {
+        return;
+    }
+    _isResident = false;
+
+    _evictedPages.clear();
+    for (int page = 0; page < static_cast<int>(_isCommitted.size()); ++page) {
+        if (_isCommitted[page]) {
+            _evictedPages.push_back(page);
+        }
+    }
+    if (_evictedPages.empty()) {
+        return;
+    }
+
+    // A previous eviction might still be writing into the same files
+    if (_cacheWrite.valid()) {
+        _cacheWrite.wait();
+    }
+
+    GLint defaultFbo;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &defaultFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    // The read back stalls until the projections are finished, which is acceptable as
+    // the target is only evicted once it has not been used for a while. Only the base
+    // level is stored, the others are regenerated when the pages are restored
+    std::vector<std::pair<std::string, std::vector<char>>> files;
+    for (const SparseTexture& t : _textures) {
+        const size_t pageBytes =
+            static_cast<size_t>(_pageSize.x * _pageSize.y) * t.bytesPerPixel;
+        std::vector<char> data(pageBytes * _evictedPages.size());
+
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D,
+            *t.texture,
+            0
+        );
+        for (size_t i = 0; i < _evictedPages.size(); ++i) {
+            const glm::ivec2 offset = pageOffset(_evictedPages[i]);
+            glReadPixels(
+                offset.x, offset.y,
+                _pageSize.x, _pageSize.y,
+                t.pixelFormat,
+                GL_UNSIGNED_BYTE,
+                data.data() + i * pageBytes
+            );
+        }
+        for (int page : _evictedPages) {
+            setCommitment(t, page, false);
+        }
+        files.emplace_back(t.cacheFile, std::move(data));
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
+
+    std::fill(_isCommitted.begin(), _isCommitted.end(), false);
+    _nCommittedPages = 0;
+
+    LDEBUG(fmt::format("Evicting {} pages of '{}'", _evictedPages.size(), _identifier));
+    _cacheWrite = std::async(
+        std::launch::async,
+        [files = std::move(files)]() {
+            for (const std::pair<std::string, std::vector<char>>& file : files) {
+                std::ofstream f(file.first, std::ofstream::binary);
+                f.write(file.second.data(), file.second.size());
+                if (!f.good()) {
+                    LERROR(fmt::format(
+                        "Error writing evicted pages to '{}'", file.first
+                    ));
+                }
+            }
+        }
+    );
+}
+
+bool SparseProjectionTarget::makeResident() {
+    if (_isResident) {
+        return false;
+    }
+    _isResident = true;
+
+    if (_evictedPages.empty()) {
+        return false;
+    }
+    if (_cacheWrite.valid()) {
+        _cacheWrite.wait();
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (const SparseTexture& t : _textures) {
+        const size_t pageBytes =
+            static_cast<size_t>(_pageSize.x * _pageSize.y) * t.bytesPerPixel;
+        std::vector<char> data(pageBytes * _evictedPages.size());
+
+        std::ifstream f(t.cacheFile, std::ifstream::binary);
+        f.read(data.data(), data.size());
+        if (!f.good()) {
+            // The pages are committed anyway so that they are cleared below, which is
+            // the same as losing the projections that were applied to them
+            LERROR(fmt::format("Error reading evicted pages from '{}'", t.cacheFile));
+            std::fill(data.begin(), data.end(), char(0));
+        }
+
+        for (size_t i = 0; i < _evictedPages.size(); ++i) {
+            setCommitment(t, _evictedPages[i], true);
+
+            const glm::ivec2 offset = pageOffset(_evictedPages[i]);
+            t.texture->bind();
+            glTexSubImage2D(
+                GL_TEXTURE_2D,
+                0,
+                offset.x, offset.y,
+                _pageSize.x, _pageSize.y,
+                t.pixelFormat,
+                GL_UNSIGNED_BYTE,
+                data.data() + i * pageBytes
+            );
+        }
+    }
+
+    for (int page : _evictedPages) {
+        _isCommitted[page] = true;
+    }
+    _nCommittedPages = static_cast<int>(_evictedPages.size());
+    LDEBUG(fmt::format("Restored {} pages of '{}'", _evictedPages.size(), _identifier));
+    _evictedPages.clear();
+    return true;
+}
+
+bool SparseProjectionTarget::isResident() const {
+    return _isResident;
+}
+
+int SparseProjectionTarget::nCommittedPages() const {
+    return _nCommittedPages;
+}
+
+} // namespace openspace
@@ -0,0 +1,132 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_MODULE_SPACECRAFTINSTRUMENTS___SPARSEPROJECTIONTARGET___H__
+#define __OPENSPACE_MODULE_SPACECRAFTINSTRUMENTS___SPARSEPROJECTIONTARGET___H__
+
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/texture.h>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Manages the memory of the sparse textures that images are projected into. The
+ * textures have the full virtual size, but only the pages that images were projected
+ * onto are backed by video memory. All textures of a target share the same page layout,
+ * so a region that is committed is available in every one of them.
+ *
+ * While a target is not used, its pages can be evicted. Their content is written to the
+ * cache directory on a background thread and the video memory is released until the
+ * target is made resident again.
+ */
+class SparseProjectionTarget {
+public:
+    /// Returns \c true if the GL_ARB_sparse_texture extension is available
+    static bool isSupported();
+
+    /// Returns the largest size that a sparse texture can have on this system
+    static int maximumTextureSize();
+
+    /**
+     * Creates a target whose evicted pages are stored in cache files whose names are
+     * derived from \p identifier.
+     */
+    explicit SparseProjectionTarget(std::string identifier);
+    ~SparseProjectionTarget();
+
+    /**
+     * Creates a new sparse texture with the \p internalFormat that has at least the
+     * \p size. The size is rounded up to a multiple of the page size and has to be the
+     * same for all textures of this target. No memory is committed for the texture until
+     * a region is committed with #commitRegion.
+     */
+    std::unique_ptr<ghoul::opengl::Texture> createTexture(const glm::ivec2& size,
+        ghoul::opengl::Texture::Format format, GLenum internalFormat);
+
+    /**
+     * Commits the pages of all textures that cover the texture coordinates between
+     * \p uvMin and \p uvMax, including a margin of one page for the filtering and the
+     * dilation. Pages that are newly committed are cleared.
+     */
+    void commitRegion(const glm::vec2& uvMin, const glm::vec2& uvMax);
+
+    /// Releases all pages, which discards the content of the textures
+    void clear();
+
+    /**
+     * Reads the committed pages back, writes them to disk, and releases their memory.
+     * The textures must not be used until the target is made resident again.
+     */
+    void evict();
+
+    /**
+     * Restores the pages that were evicted previously. Returns \c true if pages were
+     * restored, in which case the mipmaps have to be regenerated.
+     */
+    bool makeResident();
+
+    /// Returns \c true if the pages are currently backed by video memory
+    bool isResident() const;
+
+    /// Returns the number of pages that are committed in each texture
+    int nCommittedPages() const;
+
+private:
+    struct SparseTexture {
+        ghoul::opengl::Texture* texture;
+        GLenum pixelFormat;
+        size_t bytesPerPixel;
+        glm::ivec2 pageSize;
+        int nSparseLevels;
+        std::string cacheFile;
+    };
+
+    void commitPage(int page);
+    void setCommitment(const SparseTexture& texture, int page, bool commit);
+    glm::ivec2 pageOffset(int page) const;
+
+    std::string _identifier;
+    std::vector<SparseTexture> _textures;
+
+    // All textures share the same layout of pages, which is the largest page size of
+    // any of their formats
+    glm::ivec2 _pageSize = glm::ivec2(0);
+    glm::ivec2 _nPages = glm::ivec2(0);
+    int _nLevels = 0;
+    std::vector<bool> _isCommitted;
+    int _nCommittedPages = 0;
+
+    GLuint _fbo = 0;
+    bool _isResident = true;
+    std::vector<int> _evictedPages;
+    std::future<void> _cacheWrite;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACECRAFTINSTRUMENTS___SPARSEPROJECTIONTARGET___H__
@@ -160,6 +160,7 @@ RenderablePlaneSpout::RenderablePlaneSpout(const ghoul::Dictionary& dictionary)
 }
 
 void RenderablePlaneSpout::deinitializeGL() {
+    _interopTexture.release();
     _receiver->ReleaseReceiver();
     _receiver->Release();
 
@@ -206,6 +207,12 @@ void RenderablePlaneSpout::update(const UpdateData& data) {
         }
     }
 
+    // The shared texture is sampled directly, so as long as the sender keeps its texture
+    // only the description of the sender has to be checked
+    if (_interopTexture.update(_receiver, _currentSenderName)) {
+        return;
+    }
+
     unsigned int width;
     unsigned int height;
     const bool hasReceived = _receiver->ReceiveTexture(_currentSenderName, width, height);
@@ -220,11 +227,20 @@ void RenderablePlaneSpout::update(const UpdateData& data) {
 }
 
 void RenderablePlaneSpout::bindTexture() {
-    _receiver->BindSharedTexture();
+    _isInteropBound = _interopTexture.bind();
+    if (!_isInteropBound) {
+        _receiver->BindSharedTexture();
+    }
 }
 
 void RenderablePlaneSpout::unbindTexture() {
-    _receiver->UnBindSharedTexture();
+    if (_isInteropBound) {
+        _interopTexture.unbind();
+        _isInteropBound = false;
+    }
+    else {
+        _receiver->UnBindSharedTexture();
+    }
 }
 
 } // namespace openspace
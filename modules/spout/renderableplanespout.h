@@ -29,6 +29,7 @@
 
 #include <modules/base/rendering/renderableplane.h>
 
+#include <modules/spout/spoutinterop.h>
 #include <modules/spout/spoutlibrary.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/optionproperty.h>
@@ -56,6 +57,8 @@ private:
     properties::TriggerProperty _updateSelection;
 
     SPOUTHANDLE _receiver;
+    SpoutInteropTexture _interopTexture;
+    bool _isInteropBound = false;
 
     bool _isSpoutDirty = true;
     char _currentSenderName[256] = {};
@@ -159,6 +159,7 @@ ScreenSpaceSpout::ScreenSpaceSpout(const ghoul::Dictionary& dictionary)
 }
 
 bool ScreenSpaceSpout::deinitializeGL() {
+    _interopTexture.release();
     _receiver->ReleaseReceiver();
     _receiver->Release();
 
@@ -212,6 +213,13 @@ void ScreenSpaceSpout::update() {
         }
     }
 
+    // The shared texture is sampled directly, so as long as the sender keeps its texture
+    // only the description of the sender has to be checked
+    if (_interopTexture.update(_receiver, _currentSenderName)) {
+        _objectSize = { _interopTexture.width(), _interopTexture.height() };
+        return;
+    }
+
     unsigned int width;
     unsigned int height;
     const bool receiveSuccess = _receiver->ReceiveTexture(
@@ -230,11 +238,20 @@ void ScreenSpaceSpout::update() {
 }
 
 void ScreenSpaceSpout::bindTexture() {
-    _receiver->BindSharedTexture();
+    _isInteropBound = _interopTexture.bind();
+    if (!_isInteropBound) {
+        _receiver->BindSharedTexture();
+    }
 }
 
 void ScreenSpaceSpout::unbindTexture() {
-    _receiver->UnBindSharedTexture();
+    if (_isInteropBound) {
+        _interopTexture.unbind();
+        _isInteropBound = false;
+    }
+    else {
+        _receiver->UnBindSharedTexture();
+    }
 }
 
 } // namespace openspace
@@ -29,6 +29,7 @@
 
 #include <openspace/rendering/screenspacerenderable.h>
 
+#include <modules/spout/spoutinterop.h>
 #include <modules/spout/spoutlibrary.h>
 
 #include <openspace/properties/stringproperty.h>
@@ -60,6 +61,8 @@ private:
     properties::TriggerProperty _updateSelection;
 
     SPOUTHANDLE _receiver;
+    SpoutInteropTexture _interopTexture;
+    bool _isInteropBound = false;
 
     bool _isSpoutDirty = true;
     char _currentSenderName[256] = {};
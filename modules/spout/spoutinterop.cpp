@@ -0,0 +1,279 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifdef WIN32
+
+#include <modules/spout/spoutinterop.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <d3d11.h>
+
+namespace {
+    constexpr const char* _loggerCat = "SpoutInteropTexture";
+
+    // Spout senders hold this mutex while they write into their shared texture
+    constexpr const char* AccessMutexSuffix = "_SpoutAccessMutex";
+
+    // The longest time in milliseconds that we wait for a sender to finish a frame,
+    // which is a bit longer than one frame at 15 fps
+    constexpr const DWORD AccessTimeout = 67;
+
+    // WGL_NV_DX_interop2 is not part of the OpenGL bindings, so the entry points have
+    // to be loaded manually
+    using PFNWGLDXOPENDEVICENV = HANDLE(WINAPI*)(void* dxDevice);
+    using PFNWGLDXREGISTEROBJECTNV = HANDLE(WINAPI*)(HANDLE hDevice, void* dxObject,
+        GLuint name, GLenum type, GLenum access);
+    using PFNWGLDXUNREGISTEROBJECTNV = BOOL(WINAPI*)(HANDLE hDevice, HANDLE hObject);
+    using PFNWGLDXLOCKOBJECTSNV = BOOL(WINAPI*)(HANDLE hDevice, GLint count,
+        HANDLE* hObjects);
+    using PFNWGLDXUNLOCKOBJECTSNV = BOOL(WINAPI*)(HANDLE hDevice, GLint count,
+        HANDLE* hObjects);
+
+    constexpr const GLenum WglAccessReadOnly = GLenum(0x0000);
+
+    struct DxInterop {
+        ID3D11Device* device = nullptr;
+        HANDLE interopDevice = nullptr;
+        PFNWGLDXREGISTEROBJECTNV registerObject = nullptr;
+        PFNWGLDXUNREGISTEROBJECTNV unregisterObject = nullptr;
+        PFNWGLDXLOCKOBJECTSNV lockObjects = nullptr;
+        PFNWGLDXUNLOCKOBJECTSNV unlockObjects = nullptr;
+    };
+
+    // Returns nullptr if the interop is not available. The D3D11 device is shared by
+    // all Spout receivers and lives until the application ends
+    DxInterop* dxInterop() {
+        static bool isInitialized = false;
+        static DxInterop interop;
+        static bool isSupported = false;
+        if (isInitialized) {
+            return isSupported ? &interop : nullptr;
+        }
+        isInitialized = true;
+
+        PFNWGLDXOPENDEVICENV openDevice = reinterpret_cast<PFNWGLDXOPENDEVICENV>(
+            wglGetProcAddress("wglDXOpenDeviceNV")
+        );
+        interop.registerObject = reinterpret_cast<PFNWGLDXREGISTEROBJECTNV>(
+            wglGetProcAddress("wglDXRegisterObjectNV")
+        );
+        interop.unregisterObject = reinterpret_cast<PFNWGLDXUNREGISTEROBJECTNV>(
+            wglGetProcAddress("wglDXUnregisterObjectNV")
+        );
+        interop.lockObjects = reinterpret_cast<PFNWGLDXLOCKOBJECTSNV>(
+            wglGetProcAddress("wglDXLockObjectsNV")
+        );
+        interop.unlockObjects = reinterpret_cast<PFNWGLDXUNLOCKOBJECTSNV>(
+            wglGetProcAddress("wglDXUnlockObjectsNV")
+        );
+        if (!openDevice || !interop.registerObject || !interop.unregisterObject ||
+            !interop.lockObjects || !interop.unlockObjects)
+        {
+            LINFO("WGL_NV_DX_interop2 is not supported, using Spout's shared texture");
+            return nullptr;
+        }
+
+        HRESULT res = D3D11CreateDevice(
+            nullptr,
+            D3D_DRIVER_TYPE_HARDWARE,
+            nullptr,
+            0,
+            nullptr,
+            0,
+            D3D11_SDK_VERSION,
+            &interop.device,
+            nullptr,
+            nullptr
+        );
+        if (FAILED(res)) {
+            LWARNING("Could not create D3D11 device for shared Spout textures");
+            return nullptr;
+        }
+
+        interop.interopDevice = openDevice(interop.device);
+        if (!interop.interopDevice) {
+            LWARNING("Could not open D3D11 device for OpenGL interop");
+            interop.device->Release();
+            interop.device = nullptr;
+            return nullptr;
+        }
+
+        isSupported = true;
+        return &interop;
+    }
+} // namespace
+
+namespace openspace {
+
+SpoutInteropTexture::~SpoutInteropTexture() {
+    release();
+}
+
+bool SpoutInteropTexture::isSupported() {
+    return dxInterop() != nullptr;
+}
+
+bool SpoutInteropTexture::update(SPOUTHANDLE receiver, const char* senderName) {
+    DxInterop* interop = dxInterop();
+    if (!interop) {
+        return false;
+    }
+
+    unsigned int width = 0;
+    unsigned int height = 0;
+    HANDLE shareHandle = nullptr;
+    DWORD format = 0;
+    const bool hasSender = receiver->GetSenderInfo(
+        senderName,
+        width,
+        height,
+        shareHandle,
+        format
+    );
+    if (!hasSender || !shareHandle) {
+        release();
+        return false;
+    }
+
+    // A sender keeps its texture until it changes its resolution or format, so in the
+    // common case there is nothing to do here
+    if (shareHandle == _shareHandle && isReady()) {
+        return true;
+    }
+    release();
+
+    HRESULT res = interop->device->OpenSharedResource(
+        shareHandle,
+        __uuidof(ID3D11Texture2D),
+        reinterpret_cast<void**>(&_d3dTexture)
+    );
+    if (FAILED(res)) {
+        LERROR(fmt::format("Could not open shared texture of {}", senderName));
+        _d3dTexture = nullptr;
+        return false;
+    }
+
+    glGenTextures(1, &_texture);
+    _interopHandle = interop->registerObject(
+        interop->interopDevice,
+        _d3dTexture,
+        _texture,
+        GL_TEXTURE_2D,
+        WglAccessReadOnly
+    );
+    if (!_interopHandle) {
+        LERROR(fmt::format("Could not register shared texture of {}", senderName));
+        release();
+        return false;
+    }
+
+    // Older senders do not create the access mutex, in which case we can only rely on
+    // the synchronization of the interop lock
+    const std::string mutexName = std::string(senderName) + AccessMutexSuffix;
+    _accessMutex = OpenMutexA(SYNCHRONIZE, FALSE, mutexName.c_str());
+
+    _shareHandle = shareHandle;
+    _width = width;
+    _height = height;
+    return true;
+}
+
+void SpoutInteropTexture::release() {
+    DxInterop* interop = dxInterop();
+    if (_interopHandle && interop) {
+        interop->unregisterObject(interop->interopDevice, _interopHandle);
+    }
+    _interopHandle = nullptr;
+
+    if (_texture != 0) {
+        glDeleteTextures(1, &_texture);
+        _texture = 0;
+    }
+    if (_d3dTexture) {
+        _d3dTexture->Release();
+        _d3dTexture = nullptr;
+    }
+    if (_accessMutex) {
+        CloseHandle(_accessMutex);
+        _accessMutex = nullptr;
+    }
+
+    _shareHandle = nullptr;
+    _width = 0;
+    _height = 0;
+}
+
+bool SpoutInteropTexture::isReady() const {
+    return _interopHandle != nullptr;
+}
+
+unsigned int SpoutInteropTexture::width() const {
+    return _width;
+}
+
+unsigned int SpoutInteropTexture::height() const {
+    return _height;
+}
+
+bool SpoutInteropTexture::bind() {
+    DxInterop* interop = dxInterop();
+    if (!isReady() || !interop) {
+        return false;
+    }
+
+    _hasAccess = false;
+    if (_accessMutex) {
+        const DWORD res = WaitForSingleObject(_accessMutex, AccessTimeout);
+        // If the sender died while holding the mutex, the frame is still usable. If the
+        // sender takes too long, we rather show a partially written frame than none
+        _hasAccess = (res == WAIT_OBJECT_0 || res == WAIT_ABANDONED);
+    }
+
+    if (!interop->lockObjects(interop->interopDevice, 1, &_interopHandle)) {
+        if (_hasAccess) {
+            ReleaseMutex(_accessMutex);
+            _hasAccess = false;
+        }
+        return false;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, _texture);
+    return true;
+}
+
+void SpoutInteropTexture::unbind() {
+    DxInterop* interop = dxInterop();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    interop->unlockObjects(interop->interopDevice, 1, &_interopHandle);
+
+    if (_hasAccess) {
+        ReleaseMutex(_accessMutex);
+        _hasAccess = false;
+    }
+}
+
+} // namespace openspace
+
+#endif // WIN32
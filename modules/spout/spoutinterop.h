@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#ifndef __OPENSPACE_MODULE_SPOUT___SPOUTINTEROP___H__
+#define __OPENSPACE_MODULE_SPOUT___SPOUTINTEROP___H__
+
+#ifdef WIN32
+
+#include <modules/spout/spoutlibrary.h>
+
+struct ID3D11Texture2D;
+
+namespace openspace {
+
+/**
+ * Makes the DirectX texture that a Spout sender shares available as an OpenGL texture
+ * through the \c WGL_NV_DX_interop2 extension, so that it can be sampled directly without
+ * copying it. The texture is only opened again when the sender replaces its shared
+ * texture, for example after a change of resolution. While the texture is bound, the
+ * sender's access mutex is held, which fences the frame so that it is never sampled
+ * while the sender is writing the next one.
+ */
+class SpoutInteropTexture {
+public:
+    ~SpoutInteropTexture();
+
+    /**
+     * Returns whether the interop is supported by the current OpenGL context. If it is
+     * not, the Spout library's own shared texture has to be used instead.
+     */
+    static bool isSupported();
+
+    /**
+     * Opens the texture that is currently shared by the sender with the name
+     * \p senderName, unless it is already open. This only reads the description of the
+     * sender, so it is cheap to call once per frame.
+     *
+     * \param receiver The Spout handle through which the sender information is queried
+     * \param senderName The name of the sender whose texture is opened
+     * \return \c true if the texture of the sender can be bound
+     */
+    bool update(SPOUTHANDLE receiver, const char* senderName);
+
+    /// Releases the shared texture, after which #isReady returns \c false
+    void release();
+
+    bool isReady() const;
+
+    unsigned int width() const;
+    unsigned int height() const;
+
+    /**
+     * Locks the shared texture and binds it to the currently active texture unit. If the
+     * sender is still writing into the texture, this waits for at most one frame of the
+     * sender before the texture is bound regardless.
+     *
+     * \return \c true if the texture is bound and #unbind has to be called
+     */
+    bool bind();
+
+    /// Unbinds and unlocks the texture that was bound by a successful call to #bind
+    void unbind();
+
+private:
+    ID3D11Texture2D* _d3dTexture = nullptr;
+    HANDLE _shareHandle = nullptr;
+    HANDLE _interopHandle = nullptr;
+    HANDLE _accessMutex = nullptr;
+    unsigned int _texture = 0;
+    unsigned int _width = 0;
+    unsigned int _height = 0;
+    bool _hasAccess = false;
+};
+
+} // namespace openspace
+
+#endif // WIN32
+
+#endif // __OPENSPACE_MODULE_SPOUT___SPOUTINTEROP___H__
@@ -28,6 +28,10 @@
 // We need to have this extra file as the Spout people have not put an include guard into
 // their file which leads to a violation of the ODR in our usage.
 
+// The Spout interface uses the OpenGL types, but its own OpenGL header would clash with
+// our OpenGL bindings
+#include <ghoul/opengl/ghoul_gl.h>
+
 #define __gl_h_
 #include <modules/spout/ext/spout/SpoutLibrary.h>
 
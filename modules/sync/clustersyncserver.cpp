@@ -0,0 +1,236 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/sync/clustersyncserver.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/directory.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/io/socket/tcpsocket.h>
+#include <ghoul/io/socket/tcpsocketserver.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/crc32.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace {
+    constexpr const char* _loggerCat = "ClusterSyncServer";
+
+    constexpr const char* TempSuffix = ".tmp";
+    constexpr const size_t ChunkSize = 1024 * 1024;
+    constexpr const std::chrono::milliseconds AcceptPollInterval(100);
+
+    bool isTemporaryFile(const std::string& path) {
+        const size_t length = strlen(TempSuffix);
+        return path.size() >= length &&
+               path.compare(path.size() - length, length, TempSuffix) == 0;
+    }
+
+    // Requests may only refer to files inside the synchronization root
+    bool isValidPath(const std::string& path) {
+        return !path.empty() && path.find("..") == std::string::npos &&
+               path.front() != '/' && path.front() != '\\';
+    }
+} // namespace
+
+namespace openspace {
+
+ClusterSyncServer::ClusterSyncServer(std::string synchronizationRoot)
+    : _synchronizationRoot(std::move(synchronizationRoot))
+{}
+
+ClusterSyncServer::~ClusterSyncServer() {
+    stop();
+}
+
+void ClusterSyncServer::start(int port) {
+    if (_isRunning) {
+        return;
+    }
+    _server = std::make_unique<ghoul::io::TcpSocketServer>();
+    _server->listen(port);
+    _isRunning = true;
+    _acceptThread = std::thread([this]() { acceptClients(); });
+    LINFO(fmt::format("Serving synchronized resources on port {}", port));
+}
+
+void ClusterSyncServer::stop() {
+    if (!_isRunning) {
+        return;
+    }
+    _isRunning = false;
+    if (_acceptThread.joinable()) {
+        _acceptThread.join();
+    }
+    _server->close();
+
+    std::lock_guard<std::mutex> guard(_clientMutex);
+    for (std::unique_ptr<Client>& client : _clients) {
+        client->socket->disconnect();
+        if (client->thread.joinable()) {
+            client->thread.join();
+        }
+    }
+    _clients.clear();
+}
+
+bool ClusterSyncServer::isRunning() const {
+    return _isRunning;
+}
+
+void ClusterSyncServer::acceptClients() {
+    while (_isRunning) {
+        std::unique_ptr<ghoul::io::TcpSocket> socket = _server->nextPendingTcpSocket();
+        if (!socket) {
+            std::this_thread::sleep_for(AcceptPollInterval);
+            continue;
+        }
+        socket->startStreams();
+        LDEBUG(fmt::format("Accepted connection from {}", socket->address()));
+
+        std::lock_guard<std::mutex> guard(_clientMutex);
+        for (std::unique_ptr<Client>& client : _clients) {
+            if (client->isFinished && client->thread.joinable()) {
+                client->thread.join();
+            }
+        }
+        _clients.erase(
+            std::remove_if(
+                _clients.begin(),
+                _clients.end(),
+                [](const std::unique_ptr<Client>& c) { return c->isFinished.load(); }
+            ),
+            _clients.end()
+        );
+
+        std::unique_ptr<Client> client = std::make_unique<Client>();
+        client->socket = std::move(socket);
+        Client* c = client.get();
+        c->thread = std::thread([this, c]() {
+            handleClient(*c);
+            c->isFinished = true;
+        });
+        _clients.push_back(std::move(client));
+    }
+}
+
+void ClusterSyncServer::handleClient(Client& client) {
+    ghoul::io::TcpSocket& socket = *client.socket;
+
+    std::string message;
+    while (_isRunning && socket.getMessage(message)) {
+        const size_t separator = message.find(' ');
+        const std::string command = message.substr(0, separator);
+        const std::string path = (separator == std::string::npos) ?
+            "" :
+            message.substr(separator + 1);
+
+        if (!isValidPath(path)) {
+            LWARNING(fmt::format("Rejected request '{}'", message));
+            socket.putMessage("MISSING");
+            continue;
+        }
+
+        if (command == "LIST") {
+            const syncmanifest::Manifest* manifest = listing(path);
+            if (!manifest) {
+                socket.putMessage("PENDING");
+                continue;
+            }
+            socket.putMessage(fmt::format("FILES {}", manifest->size()));
+            for (const std::pair<const std::string, syncmanifest::Entry>& e : *manifest) {
+                socket.putMessage(fmt::format(
+                    "{} {:x} {}", e.second.size, e.second.checksum, e.first
+                ));
+            }
+        }
+        else if (command == "GET") {
+            const std::string file = _synchronizationRoot + '/' + path;
+            std::ifstream stream(file, std::ifstream::binary);
+            if (!stream.good()) {
+                socket.putMessage("MISSING");
+                continue;
+            }
+
+            size_t remaining = syncmanifest::fileSize(file);
+            socket.putMessage(fmt::format("DATA {}", remaining));
+
+            std::vector<char> buffer(ChunkSize);
+            while (remaining > 0) {
+                const size_t n = std::min(remaining, ChunkSize);
+                stream.read(buffer.data(), n);
+                if (!stream.good() || !socket.put<char>(buffer.data(), n)) {
+                    // The client cannot make sense of the rest of the stream anymore
+                    LERROR(fmt::format("Error sending file '{}'", path));
+                    socket.disconnect();
+                    return;
+                }
+                remaining -= n;
+            }
+        }
+        else {
+            LWARNING(fmt::format("Unknown request '{}'", message));
+        }
+    }
+}
+
+const syncmanifest::Manifest* ClusterSyncServer::listing(const std::string& directory) {
+    {
+        std::lock_guard<std::mutex> guard(_listingMutex);
+        auto it = _listings.find(directory);
+        if (it != _listings.end()) {
+            return &it->second;
+        }
+    }
+
+    // A resource is only served once the synchronization on this node has completed
+    const std::string local = absPath(_synchronizationRoot + '/' + directory);
+    if (!FileSys.fileExists(local + syncmanifest::Suffix)) {
+        return nullptr;
+    }
+
+    const ghoul::filesystem::Directory dir(local);
+    const std::vector<std::string> files = dir.readFiles(
+        ghoul::filesystem::Directory::Recursive::Yes
+    );
+
+    syncmanifest::Manifest manifest;
+    for (const std::string& file : files) {
+        if (file.size() <= local.size() || isTemporaryFile(file)) {
+            continue;
+        }
+        std::string relative = file.substr(local.size() + 1);
+        std::replace(relative.begin(), relative.end(), '\\', '/');
+        manifest[relative] = {
+            syncmanifest::fileSize(file),
+            ghoul::hashCRC32File(file)
+        };
+    }
+
+    std::lock_guard<std::mutex> guard(_listingMutex);
+    return &(_listings[directory] = std::move(manifest));
+}
+
+} // namespace openspace
@@ -0,0 +1,93 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SYNC___CLUSTERSYNCSERVER___H__
+#define __OPENSPACE_MODULE_SYNC___CLUSTERSYNCSERVER___H__
+
+#include <modules/sync/syncmanifest.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ghoul::io {
+    class TcpSocket;
+    class TcpSocketServer;
+} // namespace ghoul::io
+
+namespace openspace {
+
+/**
+ * The ClusterSyncServer runs on the node that downloads the resources for a cluster
+ * and serves the completed resource directories to the ClusterSynchronization%s of the
+ * other nodes. Each client connection is handled on its own thread with a simple line
+ * based protocol, in which every request names a directory or file relative to the
+ * synchronization root:
+ *   - <code>LIST dir</code> is answered with <code>PENDING</code> if the resource has
+ *     not been synchronized yet, or with <code>FILES n</code> followed by \c n lines of
+ *     the form <code>size checksum path</code>
+ *   - <code>GET path</code> is answered with <code>DATA size</code> followed by the
+ *     raw content of the file, or with <code>MISSING</code>
+ */
+class ClusterSyncServer {
+public:
+    explicit ClusterSyncServer(std::string synchronizationRoot);
+    ~ClusterSyncServer();
+
+    void start(int port);
+    void stop();
+    bool isRunning() const;
+
+private:
+    struct Client {
+        std::unique_ptr<ghoul::io::TcpSocket> socket;
+        std::thread thread;
+        std::atomic_bool isFinished = false;
+    };
+
+    void acceptClients();
+    void handleClient(Client& client);
+
+    /// Returns \c nullptr if the resource in \p directory is not complete yet
+    const syncmanifest::Manifest* listing(const std::string& directory);
+
+    std::string _synchronizationRoot;
+    std::unique_ptr<ghoul::io::TcpSocketServer> _server;
+    std::thread _acceptThread;
+    std::atomic_bool _isRunning = false;
+
+    std::mutex _clientMutex;
+    std::vector<std::unique_ptr<Client>> _clients;
+
+    // Computing the checksums is expensive, so each listing is only created once
+    std::mutex _listingMutex;
+    std::unordered_map<std::string, syncmanifest::Manifest> _listings;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SYNC___CLUSTERSYNCSERVER___H__
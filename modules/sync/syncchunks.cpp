@@ -0,0 +1,79 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/sync/syncchunks.h>
+
+#include <ghoul/misc/crc32.h>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    constexpr const char* Header = "OpenSpace chunk list";
+} // namespace
+
+namespace openspace::syncchunks {
+
+bool parse(const std::string& text, ChunkList& list) {
+    std::istringstream stream(text);
+    std::string header;
+    if (!std::getline(stream, header) || header != Header) {
+        return false;
+    }
+    if (!(stream >> list.chunkSize >> list.fileSize) || list.chunkSize == 0) {
+        return false;
+    }
+
+    list.checksums.clear();
+    unsigned int checksum;
+    while (stream >> std::hex >> checksum) {
+        list.checksums.push_back(checksum);
+    }
+    const size_t nChunks = (list.fileSize + list.chunkSize - 1) / list.chunkSize;
+    return list.checksums.size() == nChunks;
+}
+
+void write(std::ostream& stream, const ChunkList& list) {
+    stream << Header << '\n' << list.chunkSize << ' ' << list.fileSize << '\n'
+           << std::hex;
+    for (unsigned int checksum : list.checksums) {
+        stream << checksum << '\n';
+    }
+    stream << std::dec;
+}
+
+ChunkList compute(const std::string& path, size_t chunkSize) {
+    ChunkList list;
+    list.chunkSize = chunkSize;
+
+    std::ifstream file(path, std::ifstream::binary);
+    std::vector<char> buffer(chunkSize);
+    while (file.read(buffer.data(), chunkSize) || file.gcount() > 0) {
+        const size_t n = static_cast<size_t>(file.gcount());
+        list.checksums.push_back(ghoul::hashCRC32(buffer.data(), n));
+        list.fileSize += n;
+    }
+    return list;
+}
+
+} // namespace openspace::syncchunks
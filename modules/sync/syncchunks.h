@@ -0,0 +1,63 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SYNC___SYNCCHUNKS___H__
+#define __OPENSPACE_MODULE_SYNC___SYNCCHUNKS___H__
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * A chunk list can be published by a data server next to each file of a resource. It
+ * contains the CRC32 checksum of every fixed-size chunk of the file, so that a client
+ * that already has an older version of the file only has to download the chunks that
+ * have changed.
+ */
+namespace openspace::syncchunks {
+
+/// Suffix that is appended to the URL or path of a file to form its chunk list
+constexpr const char* Suffix = ".chunks";
+
+/// Default size of the chunks, large enough that only few requests are necessary
+constexpr const size_t DefaultChunkSize = 4 * 1024 * 1024;
+
+struct ChunkList {
+    size_t chunkSize = 0;
+    size_t fileSize = 0;
+    /// The checksum of each chunk; only the last chunk can be smaller than chunkSize
+    std::vector<unsigned int> checksums;
+};
+
+/// Parses the chunk list in \p text, returns \c false if it is not a valid chunk list
+bool parse(const std::string& text, ChunkList& list);
+
+void write(std::ostream& stream, const ChunkList& list);
+
+/// Splits the file at \p path into chunks of \p chunkSize bytes and hashes each of them
+ChunkList compute(const std::string& path, size_t chunkSize);
+
+} // namespace openspace::syncchunks
+
+#endif // __OPENSPACE_MODULE_SYNC___SYNCCHUNKS___H__
@@ -0,0 +1,94 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/sync/syncmanifest.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    constexpr const char* Header = "OpenSpace synchronization manifest";
+    // Content of the sync files that were written before manifests were introduced
+    constexpr const char* LegacySyncFileContent = "Synchronized";
+} // namespace
+
+namespace openspace::syncmanifest {
+
+Type read(const std::string& path, Manifest& manifest) {
+    std::ifstream file(path);
+    std::string header;
+    if (!file.good() || !std::getline(file, header)) {
+        return Type::Missing;
+    }
+    if (header == LegacySyncFileContent) {
+        return Type::Legacy;
+    }
+    if (header != Header) {
+        return Type::Missing;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream lineStream(line);
+        Entry entry;
+        std::string filename;
+        lineStream >> entry.size >> std::hex >> entry.checksum >> std::ws;
+        std::getline(lineStream, filename);
+        if (lineStream.fail() || filename.empty()) {
+            // Most likely the last line of a partial manifest that was interrupted
+            continue;
+        }
+        manifest[filename] = entry;
+    }
+    return Type::Manifest;
+}
+
+void writeHeader(std::ostream& stream) {
+    stream << Header << '\n';
+}
+
+void writeEntry(std::ostream& stream, const std::string& filename, const Entry& entry) {
+    stream << entry.size << ' ' << std::hex << entry.checksum << std::dec << ' '
+           << filename << '\n';
+}
+
+std::string findIncompleteFile(const Manifest& manifest, const std::string& directory) {
+    for (const std::pair<const std::string, Entry>& file : manifest) {
+        const std::string path =
+            directory + ghoul::filesystem::FileSystem::PathSeparator + file.first;
+        if (!FileSys.fileExists(path) || fileSize(path) != file.second.size) {
+            return file.first;
+        }
+    }
+    return "";
+}
+
+size_t fileSize(const std::string& path) {
+    std::ifstream file(path, std::ifstream::binary | std::ifstream::ate);
+    const std::streamoff size = file.tellg();
+    return size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+} // namespace openspace::syncmanifest
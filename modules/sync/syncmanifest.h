@@ -0,0 +1,73 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SYNC___SYNCMANIFEST___H__
+#define __OPENSPACE_MODULE_SYNC___SYNCMANIFEST___H__
+
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * A manifest is written next to the directory of each completed resource
+ * synchronization. It lists the size and CRC32 checksum of every file of the resource,
+ * so that incomplete resources can be detected on startup and unchanged files can be
+ * reused by later synchronizations.
+ */
+namespace openspace::syncmanifest {
+
+/// Suffix that is appended to the directory of a resource to form its manifest path
+constexpr const char* Suffix = ".ossync";
+
+struct Entry {
+    size_t size = 0;
+    unsigned int checksum = 0;
+};
+
+/// Maps the path of each file, relative to the resource directory, to its entry
+using Manifest = std::map<std::string, Entry>;
+
+enum class Type {
+    Missing, ///< The file does not exist or is not a manifest
+    Legacy,  ///< The file is a sync file written before manifests were introduced
+    Manifest
+};
+
+/// Adds the entries of the manifest at \p path to \p manifest
+Type read(const std::string& path, Manifest& manifest);
+
+void writeHeader(std::ostream& stream);
+void writeEntry(std::ostream& stream, const std::string& filename, const Entry& entry);
+
+/**
+ * Returns the first file of the \p manifest that is missing from \p directory or whose
+ * size does not match, or an empty string if all files are present.
+ */
+std::string findIncompleteFile(const Manifest& manifest, const std::string& directory);
+
+size_t fileSize(const std::string& path);
+
+} // namespace openspace::syncmanifest
+
+#endif // __OPENSPACE_MODULE_SYNC___SYNCMANIFEST___H__
@@ -24,16 +24,22 @@
 
 #include <modules/sync/syncmodule.h>
 
+#include <modules/sync/clustersyncserver.h>
+#include <modules/sync/syncs/clustersynchronization.h>
 #include <modules/sync/syncs/httpsynchronization.h>
 #include <modules/sync/syncs/torrentsynchronization.h>
 #include <modules/sync/syncs/urlsynchronization.h>
+#include <modules/sync/tasks/chunklisttask.h>
 #include <modules/sync/tasks/syncassettask.h>
 #include <openspace/documentation/documentation.h>
+#include <openspace/engine/globals.h>
 #include <openspace/engine/globalscallbacks.h>
+#include <openspace/engine/windowdelegate.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/resourcesynchronization.h>
+#include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
@@ -44,11 +50,25 @@ namespace {
     constexpr const char* KeyHttpSynchronizationRepositories =
         "HttpSynchronizationRepositories";
     constexpr const char* KeySynchronizationRoot = "SynchronizationRoot";
+    constexpr const char* KeyMaxConcurrentDownloads = "MaxConcurrentDownloads";
+    constexpr const char* KeyMaxDownloadBandwidth = "MaxDownloadBandwidth";
+
+    constexpr const char* KeyCluster = "Cluster";
+    constexpr const char* KeyClusterAddress = "Address";
+    constexpr const char* KeyClusterPort = "Port";
+    constexpr const char* KeyClusterRole = "Role";
+
+    constexpr const int DefaultMaxConcurrentDownloads = 8;
 } // namespace
 
 namespace openspace {
 
-SyncModule::SyncModule() : OpenSpaceModule(Name) {}
+SyncModule::SyncModule()
+    : OpenSpaceModule(Name)
+    , _transferBudget(DefaultMaxConcurrentDownloads, 0)
+{}
+
+SyncModule::~SyncModule() {} // NOLINT
 
 void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
     if (configuration.hasKey(KeyHttpSynchronizationRepositories)) {
@@ -73,16 +93,63 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
         // Group root and enabled into a sync config object that can be passed to syncs.
     }
 
+    if (configuration.hasKeyAndValue<double>(KeyMaxConcurrentDownloads)) {
+        _transferBudget.setMaxConnections(
+            static_cast<int>(configuration.value<double>(KeyMaxConcurrentDownloads))
+        );
+    }
+    if (configuration.hasKeyAndValue<double>(KeyMaxDownloadBandwidth)) {
+        // The bandwidth is specified in bytes per second
+        _transferBudget.setMaxBytesPerSecond(
+            static_cast<size_t>(configuration.value<double>(KeyMaxDownloadBandwidth))
+        );
+    }
+
+    if (configuration.hasKeyAndValue<ghoul::Dictionary>(KeyCluster)) {
+        // Only one node of a cluster downloads the resources, by default the master,
+        // and all other nodes receive them from it over the local network
+        const ghoul::Dictionary cluster =
+            configuration.value<ghoul::Dictionary>(KeyCluster);
+        _clusterAddress = cluster.value<std::string>(KeyClusterAddress);
+        _clusterPort = static_cast<int>(cluster.value<double>(KeyClusterPort));
+
+        const bool isMaster = global::windowDelegate.isMaster();
+        _clusterRole = isMaster ? ClusterRole::Server : ClusterRole::Client;
+        if (cluster.hasKeyAndValue<std::string>(KeyClusterRole)) {
+            const std::string role = cluster.value<std::string>(KeyClusterRole);
+            if (role == "Server") {
+                _clusterRole = ClusterRole::Server;
+            }
+            else if (role == "Client") {
+                _clusterRole = ClusterRole::Client;
+            }
+            else {
+                LWARNINGC("SyncModule", fmt::format("Unknown cluster role '{}'", role));
+            }
+        }
+
+        if (_clusterRole == ClusterRole::Server) {
+            _clusterSyncServer = std::make_unique<ClusterSyncServer>(
+                _synchronizationRoot
+            );
+            _clusterSyncServer->start(_clusterPort);
+        }
+    }
+
     auto fSynchronization = FactoryManager::ref().factory<ResourceSynchronization>();
     ghoul_assert(fSynchronization, "ResourceSynchronization factory was not created");
 
     fSynchronization->registerClass(
         "HttpSynchronization",
         [this](bool, const ghoul::Dictionary& dictionary) {
-            return new HttpSynchronization(
+            return clusterAware(
                 dictionary,
-                _synchronizationRoot,
-                _synchronizationRepositories
+                new HttpSynchronization(
+                    dictionary,
+                    _synchronizationRoot,
+                    _synchronizationRepositories,
+                    _transferBudget
+                )
             );
         }
     );
@@ -91,10 +158,13 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
     fSynchronization->registerClass(
         "TorrentSynchronization",
         [this](bool, const ghoul::Dictionary& dictionary) {
-            return new TorrentSynchronization(
+            return clusterAware(
                 dictionary,
-                _synchronizationRoot,
-                _torrentClient
+                new TorrentSynchronization(
+                    dictionary,
+                    _synchronizationRoot,
+                    _torrentClient
+                )
             );
         }
     );
@@ -103,9 +173,13 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
     fSynchronization->registerClass(
         "UrlSynchronization",
         [this](bool, const ghoul::Dictionary& dictionary) {
-            return new UrlSynchronization(
+            return clusterAware(
                 dictionary,
-                _synchronizationRoot
+                new UrlSynchronization(
+                    dictionary,
+                    _synchronizationRoot,
+                    _transferBudget
+                )
             );
         }
     );
@@ -113,6 +187,7 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
     auto fTask = FactoryManager::ref().factory<Task>();
     ghoul_assert(fTask, "No task factory existed");
     fTask->registerClass<SyncAssetTask>("SyncAssetTask");
+    fTask->registerClass<ChunkListTask>("ChunkListTask");
 
 #ifdef SYNC_USE_LIBTORRENT
     _torrentClient.initialize();
@@ -121,6 +196,10 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
 }
 
 void SyncModule::internalDeinitialize() {
+    if (_clusterSyncServer) {
+        _clusterSyncServer->stop();
+        _clusterSyncServer = nullptr;
+    }
 #ifdef SYNC_USE_LIBTORRENT
     _torrentClient.deinitialize();
 #endif // SYNC_USE_LIBTORRENT
@@ -138,6 +217,29 @@ std::vector<std::string> SyncModule::httpSynchronizationRepositories() const {
     return _synchronizationRepositories;
 }
 
+TransferBudget& SyncModule::transferBudget() {
+    return _transferBudget;
+}
+
+bool SyncModule::isServingCluster() const {
+    return _clusterSyncServer && _clusterSyncServer->isRunning();
+}
+
+ResourceSynchronization* SyncModule::clusterAware(const ghoul::Dictionary& dictionary,
+                                                  ResourceSynchronization* sync)
+{
+    if (_clusterRole != ClusterRole::Client) {
+        return sync;
+    }
+    return new ClusterSynchronization(
+        dictionary,
+        std::unique_ptr<ResourceSynchronization>(sync),
+        _synchronizationRoot,
+        _clusterAddress,
+        _clusterPort
+    );
+}
+
 std::vector<documentation::Documentation> SyncModule::documentations() const {
     return {
         HttpSynchronization::Documentation(),
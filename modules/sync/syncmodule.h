@@ -27,23 +27,35 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/sync/transferbudget.h>
+#include <memory>
+
 #ifdef SYNC_USE_LIBTORRENT
 #include <modules/sync/torrentclient.h>
 #endif // SYNC_USE_LIBTORRENT
 
 namespace openspace {
 
+class ClusterSyncServer;
+class ResourceSynchronization;
+
 class SyncModule : public OpenSpaceModule {
 public:
     constexpr static const char* Name = "Sync";
 
     SyncModule();
+    ~SyncModule();
 
     std::string synchronizationRoot() const;
 
     void addHttpSynchronizationRepository(std::string repository);
     std::vector<std::string> httpSynchronizationRepositories() const;
 
+    TransferBudget& transferBudget();
+
+    /// Returns \c true if this node serves synchronized resources to the cluster
+    bool isServingCluster() const;
+
 #ifdef SYNC_USE_LIBTORRENT
     TorrentClient& torrentClient();
 #endif // SYNC_USE_LIBTORRENT
@@ -55,11 +67,30 @@ protected:
     void internalDeinitialize() override;
 
 private:
+    enum class ClusterRole {
+        None = 0,
+        Server,
+        Client
+    };
+
+    /**
+     * Returns \p sync, or a ClusterSynchronization that receives the resource of
+     * \p sync from the cluster server if this node is a cluster client.
+     */
+    ResourceSynchronization* clusterAware(const ghoul::Dictionary& dictionary,
+        ResourceSynchronization* sync);
+
 #ifdef SYNC_USE_LIBTORRENT
     TorrentClient _torrentClient;
 #endif // SYNC_USE_LIBTORRENT
     std::vector<std::string> _synchronizationRepositories;
     std::string _synchronizationRoot;
+    TransferBudget _transferBudget;
+
+    ClusterRole _clusterRole = ClusterRole::None;
+    std::string _clusterAddress;
+    int _clusterPort = 0;
+    std::unique_ptr<ClusterSyncServer> _clusterSyncServer;
 };
 
 } // namespace openspace
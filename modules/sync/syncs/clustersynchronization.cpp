@@ -0,0 +1,332 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/sync/syncs/clustersynchronization.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/file.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/io/socket/tcpsocket.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/crc32.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    constexpr const char* _loggerCat = "ClusterSynchronization";
+
+    constexpr const char* TempSuffix = ".tmp";
+    constexpr const char* StoreDirectory = "store";
+    constexpr const size_t ChunkSize = 1024 * 1024;
+
+    // How often the server is asked whether a pending resource has been completed
+    constexpr const std::chrono::seconds PendingPollInterval(1);
+
+    bool linkOrCopyFile(const std::string& source, const std::string& destination) {
+#ifdef WIN32
+        if (CreateHardLinkA(destination.c_str(), source.c_str(), nullptr)) {
+            return true;
+        }
+#else
+        if (link(source.c_str(), destination.c_str()) == 0) {
+            return true;
+        }
+#endif // WIN32
+
+        // Not all file systems support hard links, in which case we have to copy
+        std::ifstream src(source, std::ifstream::binary);
+        std::ofstream dst(destination, std::ofstream::binary);
+        dst << src.rdbuf();
+        return dst.good();
+    }
+} // namespace
+
+namespace openspace {
+
+ClusterSynchronization::ClusterSynchronization(const ghoul::Dictionary& dict,
+                                          std::unique_ptr<ResourceSynchronization> source,
+                                               std::string synchronizationRoot,
+                                               std::string serverAddress, int serverPort)
+    : ResourceSynchronization(dict)
+    , _source(std::move(source))
+    , _synchronizationRoot(absPath(synchronizationRoot))
+    , _serverAddress(std::move(serverAddress))
+    , _serverPort(serverPort)
+{
+    // The server has the same directory structure below its own synchronization root
+    const std::string dir = directory();
+    if (dir.compare(0, _synchronizationRoot.size(), _synchronizationRoot) == 0) {
+        _relativeDirectory = dir.substr(_synchronizationRoot.size() + 1);
+        std::replace(_relativeDirectory.begin(), _relativeDirectory.end(), '\\', '/');
+    }
+}
+
+ClusterSynchronization::~ClusterSynchronization() {
+    if (_syncThread.joinable()) {
+        cancel();
+        _syncThread.join();
+    }
+}
+
+std::string ClusterSynchronization::directory() {
+    return _source->directory();
+}
+
+void ClusterSynchronization::start() {
+    if (isSyncing()) {
+        return;
+    }
+    begin();
+
+    if (isSynchronized()) {
+        resolve();
+        return;
+    }
+
+    _syncThread = std::thread([this]() {
+        if (trySynchronize()) {
+            resolve();
+        }
+        else if (!_shouldCancel) {
+            reject();
+        }
+    });
+}
+
+void ClusterSynchronization::cancel() {
+    _shouldCancel = true;
+    reset();
+}
+
+void ClusterSynchronization::clear() {
+    cancel();
+    // TODO: Remove all files from directory.
+}
+
+size_t ClusterSynchronization::nSynchronizedBytes() {
+    return _nSynchronizedBytes;
+}
+
+size_t ClusterSynchronization::nTotalBytes() {
+    return _nTotalBytes;
+}
+
+bool ClusterSynchronization::nTotalBytesIsKnown() {
+    return _nTotalBytesKnown;
+}
+
+bool ClusterSynchronization::isSynchronized() {
+    syncmanifest::Manifest manifest;
+    const std::string path = directory() + syncmanifest::Suffix;
+    const syncmanifest::Type type = syncmanifest::read(path, manifest);
+    if (type == syncmanifest::Type::Missing) {
+        return false;
+    }
+    if (type == syncmanifest::Type::Legacy) {
+        return true;
+    }
+    return syncmanifest::findIncompleteFile(manifest, directory()).empty();
+}
+
+bool ClusterSynchronization::trySynchronize() {
+    if (_relativeDirectory.empty()) {
+        LERROR(fmt::format(
+            "Directory '{}' is not located in the synchronization root", directory()
+        ));
+        return false;
+    }
+
+    ghoul::io::TcpSocket socket(_serverAddress, _serverPort);
+    try {
+        socket.connect();
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+    }
+    if (!socket.isConnected()) {
+        LERROR(fmt::format(
+            "Could not connect to {}:{} for '{}'",
+            _serverAddress, _serverPort, _relativeDirectory
+        ));
+        return false;
+    }
+
+    syncmanifest::Manifest manifest;
+    std::string response;
+    while (true) {
+        if (_shouldCancel) {
+            return false;
+        }
+        socket.putMessage("LIST " + _relativeDirectory);
+        if (!socket.getMessage(response)) {
+            LERROR(fmt::format("Lost connection while listing '{}'", _relativeDirectory));
+            return false;
+        }
+        if (response == "PENDING") {
+            std::this_thread::sleep_for(PendingPollInterval);
+            continue;
+        }
+        if (response.compare(0, 6, "FILES ") != 0) {
+            LERROR(fmt::format("Unexpected response '{}'", response));
+            return false;
+        }
+
+        const size_t nFiles = std::stoull(response.substr(6));
+        for (size_t i = 0; i < nFiles; ++i) {
+            if (!socket.getMessage(response)) {
+                return false;
+            }
+            std::istringstream line(response);
+            syncmanifest::Entry entry;
+            std::string file;
+            line >> entry.size >> std::hex >> entry.checksum >> std::ws;
+            std::getline(line, file);
+            manifest[file] = entry;
+        }
+        break;
+    }
+
+    size_t totalBytes = 0;
+    for (const std::pair<const std::string, syncmanifest::Entry>& file : manifest) {
+        totalBytes += file.second.size;
+    }
+    _nSynchronizedBytes = 0;
+    _nTotalBytes = totalBytes;
+    _nTotalBytesKnown = true;
+
+    FileSys.createDirectory(
+        _synchronizationRoot + '/' + StoreDirectory,
+        ghoul::filesystem::FileSystem::Recursive::Yes
+    );
+
+    const std::string dir = directory();
+    for (const std::pair<const std::string, syncmanifest::Entry>& file : manifest) {
+        if (_shouldCancel) {
+            return false;
+        }
+
+        const std::string stored = storePath(file.second);
+        const bool isStored = FileSys.fileExists(stored) &&
+                              syncmanifest::fileSize(stored) == file.second.size;
+        if (isStored) {
+            _nSynchronizedBytes += file.second.size;
+        }
+        else {
+            const std::string remote = _relativeDirectory + '/' + file.first;
+            if (!receiveFile(socket, remote, file.second, stored)) {
+                return false;
+            }
+        }
+
+        const std::string destination = dir + '/' + file.first;
+        FileSys.createDirectory(
+            ghoul::filesystem::File(destination).directoryName(),
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+        FileSys.deleteFile(destination);
+        if (!linkOrCopyFile(stored, destination)) {
+            LERROR(fmt::format("Error creating file '{}'", destination));
+            return false;
+        }
+    }
+
+    std::ofstream manifestFile(dir + syncmanifest::Suffix, std::ofstream::trunc);
+    syncmanifest::writeHeader(manifestFile);
+    for (const std::pair<const std::string, syncmanifest::Entry>& file : manifest) {
+        syncmanifest::writeEntry(manifestFile, file.first, file.second);
+    }
+    return manifestFile.good();
+}
+
+bool ClusterSynchronization::receiveFile(ghoul::io::TcpSocket& socket,
+                                         const std::string& path,
+                                         const syncmanifest::Entry& entry,
+                                         const std::string& destination)
+{
+    socket.putMessage("GET " + path);
+    std::string response;
+    if (!socket.getMessage(response) || response.compare(0, 5, "DATA ") != 0) {
+        LERROR(fmt::format("Could not receive '{}'", path));
+        return false;
+    }
+    size_t remaining = std::stoull(response.substr(5));
+    if (remaining != entry.size) {
+        LERROR(fmt::format("File '{}' changed on the server", path));
+        return false;
+    }
+
+    // Other synchronizations might be receiving the same file at the same time
+    const std::string temporary = fmt::format(
+        "{}.{}{}",
+        destination,
+        std::hash<std::thread::id>{}(std::this_thread::get_id()),
+        TempSuffix
+    );
+    std::ofstream file(temporary, std::ofstream::binary);
+    std::vector<char> buffer(ChunkSize);
+    while (remaining > 0) {
+        const size_t n = std::min(remaining, ChunkSize);
+        if (_shouldCancel || !socket.get<char>(buffer.data(), n)) {
+            file.close();
+            FileSys.deleteFile(temporary);
+            return false;
+        }
+        file.write(buffer.data(), n);
+        remaining -= n;
+        _nSynchronizedBytes += n;
+    }
+    file.close();
+
+    if (ghoul::hashCRC32File(temporary) != entry.checksum) {
+        LERROR(fmt::format("Checksum mismatch for '{}'", path));
+        FileSys.deleteFile(temporary);
+        return false;
+    }
+
+    FileSys.deleteFile(destination);
+    if (rename(temporary.c_str(), destination.c_str()) != 0) {
+        // Another synchronization might have stored the same file in the meantime
+        FileSys.deleteFile(temporary);
+        return FileSys.fileExists(destination);
+    }
+    return true;
+}
+
+std::string ClusterSynchronization::storePath(const syncmanifest::Entry& entry) const {
+    return fmt::format(
+        "{}/{}/{:08x}-{}",
+        _synchronizationRoot, StoreDirectory, entry.checksum, entry.size
+    );
+}
+
+} // namespace openspace
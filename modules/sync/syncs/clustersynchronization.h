@@ -0,0 +1,91 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SYNC___CLUSTERSYNCHRONIZATION___H__
+#define __OPENSPACE_MODULE_SYNC___CLUSTERSYNCHRONIZATION___H__
+
+#include <openspace/util/resourcesynchronization.h>
+
+#include <modules/sync/syncmanifest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace ghoul::io { class TcpSocket; }
+
+namespace openspace {
+
+/**
+ * A ClusterSynchronization replaces the synchronizations of the nodes of a cluster that
+ * do not download resources themselves. Instead of starting the \c source
+ * synchronization, it waits until the ClusterSyncServer has completed the same resource
+ * and then copies the files over the local network into the directory that the source
+ * synchronization would have used. Received files are kept in a content-addressed store
+ * in the synchronization root and hard linked into the resource directories, so files
+ * that are shared by multiple resources are only transferred and stored once.
+ */
+class ClusterSynchronization : public ResourceSynchronization {
+public:
+    ClusterSynchronization(const ghoul::Dictionary& dict,
+        std::unique_ptr<ResourceSynchronization> source, std::string synchronizationRoot,
+        std::string serverAddress, int serverPort);
+
+    virtual ~ClusterSynchronization();
+
+    std::string directory() override;
+    void start() override;
+    void cancel() override;
+    void clear() override;
+
+    size_t nSynchronizedBytes() override;
+    size_t nTotalBytes() override;
+    bool nTotalBytesIsKnown() override;
+
+private:
+    bool isSynchronized();
+    bool trySynchronize();
+
+    bool receiveFile(ghoul::io::TcpSocket& socket, const std::string& path,
+        const syncmanifest::Entry& entry, const std::string& destination);
+
+    /// Returns the location of a file with the provided \p entry in the content store
+    std::string storePath(const syncmanifest::Entry& entry) const;
+
+    std::unique_ptr<ResourceSynchronization> _source;
+    std::string _synchronizationRoot;
+    std::string _relativeDirectory;
+    std::string _serverAddress;
+    int _serverPort;
+
+    std::atomic_bool _nTotalBytesKnown = false;
+    std::atomic_size_t _nTotalBytes = 0;
+    std::atomic_size_t _nSynchronizedBytes = 0;
+    std::atomic_bool _shouldCancel = false;
+
+    std::thread _syncThread;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SYNC___CLUSTERSYNCHRONIZATION___H__
@@ -24,16 +24,28 @@
 
 #include <modules/sync/syncs/httpsynchronization.h>
 
+#include <modules/sync/syncchunks.h>
+#include <modules/sync/syncmanifest.h>
 #include <modules/sync/syncmodule.h>
+#include <modules/sync/transferbudget.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/httprequest.h>
 #include <ghoul/fmt.h>
+#include <ghoul/filesystem/directory.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/crc32.h>
+#include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <numeric>
+#include <set>
+#include <sstream>
 
 namespace {
     constexpr const char* _loggerCat = "HttpSynchronization";
@@ -42,11 +54,380 @@ namespace {
     constexpr const char* KeyVersion = "Version";
 
     constexpr const char* TempSuffix = ".tmp";
-
     constexpr const char* QueryKeyIdentifier = "identifier";
     constexpr const char* QueryKeyFileVersion = "file_version";
     constexpr const char* QueryKeyApplicationVersion = "application_version";
     constexpr const int ApplicationVersion = 1;
+
+    // Number of times a single file is requested before the synchronization fails
+    constexpr const int MaxDownloadAttempts = 3;
+
+    // Number of consecutive changed chunks that are combined into one ranged request.
+    // The chunks of a request are kept in memory until they are verified
+    constexpr const size_t MaxChunksPerRequest = 8;
+
+    struct FileEntry {
+        std::string url;
+        std::string filename;
+        size_t size = 0; // 0 if the size was not provided by the file list
+        bool hasChecksum = false;
+        unsigned int checksum = 0;
+    };
+
+    // Each line of the file list contains the URL of one file, optionally followed by
+    // the size of the file in bytes and its hexadecimal CRC32 checksum
+    std::vector<FileEntry> parseFileList(const std::string& fileList,
+                                         const std::string& identifier)
+    {
+        std::vector<FileEntry> files;
+        std::set<std::string> urls;
+
+        std::istringstream stream(fileList);
+        std::string line;
+        while (std::getline(stream, line)) {
+            std::istringstream lineStream(line);
+            FileEntry entry;
+            if (!(lineStream >> entry.url)) {
+                continue;
+            }
+            if (urls.find(entry.url) != urls.end()) {
+                LWARNING(fmt::format("{}: Duplicate entries: {}", identifier, entry.url));
+                continue;
+            }
+            urls.insert(entry.url);
+
+            entry.filename = entry.url.substr(entry.url.find_last_of('/') + 1);
+            if (lineStream >> entry.size) {
+                entry.hasChecksum = static_cast<bool>(
+                    lineStream >> std::hex >> entry.checksum
+                );
+            }
+            else {
+                entry.size = 0;
+            }
+            files.push_back(std::move(entry));
+        }
+        return files;
+    }
+
+    // A completed older version of the resource whose files are used as the basis for
+    // downloading only the changed chunks of updated files
+    struct Basis {
+        std::string directory;
+        openspace::syncmanifest::Manifest manifest;
+    };
+
+    // Returns the newest version of the resource in 'versionsDirectory' that is older
+    // than 'version' and has a manifest, or an empty basis if there is none
+    Basis findBasis(const std::string& versionsDirectory, int version) {
+        Basis basis;
+        if (!FileSys.directoryExists(versionsDirectory)) {
+            return basis;
+        }
+
+        std::map<int, std::string, std::greater<>> versions;
+        const ghoul::filesystem::Directory dir(versionsDirectory);
+        const std::vector<std::string> directories = dir.readDirectories(
+            ghoul::filesystem::Directory::Recursive::No
+        );
+        for (const std::string& d : directories) {
+            const std::string name = d.substr(d.find_last_of("/\\") + 1);
+            const bool isNumber = !name.empty() && std::all_of(
+                name.begin(),
+                name.end(),
+                [](unsigned char c) { return std::isdigit(c) != 0; }
+            );
+            if (isNumber && std::stoi(name) < version) {
+                versions[std::stoi(name)] = d;
+            }
+        }
+
+        using namespace openspace;
+        for (const std::pair<const int, std::string>& v : versions) {
+            syncmanifest::Manifest manifest;
+            const std::string path = v.second + syncmanifest::Suffix;
+            if (syncmanifest::read(path, manifest) == syncmanifest::Type::Manifest) {
+                basis.directory = v.second;
+                basis.manifest = std::move(manifest);
+                return basis;
+            }
+        }
+        return basis;
+    }
+
+    // Builds 'temporary' from the unchanged chunks of 'basis' and downloads only the
+    // chunks that differ. Returns false if the server does not provide a chunk list for
+    // the file or if anything does not match, in which case the file has to be
+    // downloaded in full
+    bool syncFileFromBasis(const FileEntry& file, const std::string& basis,
+                           const std::string& temporary,
+                           openspace::TransferBudget& budget,
+                           const std::atomic_bool& shouldCancel,
+                           const openspace::HttpDownload::ProgressCallback& onProgress)
+    {
+        using namespace openspace;
+
+        if (!budget.acquire(shouldCancel)) {
+            return false;
+        }
+        SyncHttpMemoryDownload listDownload(file.url + syncchunks::Suffix);
+        listDownload.onProgress([&shouldCancel](HttpRequest::Progress) {
+            return !shouldCancel;
+        });
+        HttpRequest::RequestOptions listOpt = {};
+        listOpt.requestTimeoutSeconds = 0;
+        listDownload.download(listOpt);
+        budget.release();
+        if (!listDownload.hasSucceeded()) {
+            return false;
+        }
+
+        const std::vector<char>& listData = listDownload.downloadedData();
+        syncchunks::ChunkList remote;
+        const bool isValid = syncchunks::parse(
+            std::string(listData.begin(), listData.end()),
+            remote
+        );
+        if (!isValid || (file.size > 0 && remote.fileSize != file.size)) {
+            // The list is outdated or does not belong to this version of the file
+            return false;
+        }
+
+        const size_t chunkSize = remote.chunkSize;
+        auto chunkLength = [chunkSize](const syncchunks::ChunkList& l, size_t i) {
+            return std::min(chunkSize, l.fileSize - i * chunkSize);
+        };
+
+        // Chunks are matched by their checksum regardless of their position, so chunks
+        // that were moved by a multiple of the chunk size are not downloaded either
+        const syncchunks::ChunkList local = syncchunks::compute(basis, chunkSize);
+        std::map<unsigned int, size_t> localChunks;
+        for (size_t i = 0; i < local.checksums.size(); ++i) {
+            localChunks.emplace(local.checksums[i], i);
+        }
+        auto findLocalChunk = [&](size_t i) -> const size_t* {
+            auto it = localChunks.find(remote.checksums[i]);
+            if (it == localChunks.end()) {
+                return nullptr;
+            }
+            const bool isSameLength =
+                chunkLength(local, it->second) == chunkLength(remote, i);
+            return isSameLength ? &it->second : nullptr;
+        };
+
+        std::ifstream source(basis, std::ifstream::binary);
+        std::ofstream destination(
+            temporary,
+            std::ofstream::binary | std::ofstream::trunc
+        );
+        std::vector<char> buffer(chunkSize);
+        size_t nBytes = 0;
+        size_t nReusedBytes = 0;
+
+        const size_t nChunks = remote.checksums.size();
+        size_t i = 0;
+        while (i < nChunks) {
+            if (shouldCancel) {
+                return false;
+            }
+
+            if (const size_t* localChunk = findLocalChunk(i)) {
+                const size_t length = chunkLength(remote, i);
+                source.seekg(static_cast<std::streamoff>(*localChunk * chunkSize));
+                source.read(buffer.data(), length);
+                destination.write(buffer.data(), length);
+                nBytes += length;
+                nReusedBytes += length;
+                onProgress({ true, remote.fileSize, nBytes });
+                ++i;
+                continue;
+            }
+
+            size_t end = i + 1;
+            while (end < nChunks && end - i < MaxChunksPerRequest && !findLocalChunk(end))
+            {
+                ++end;
+            }
+            const size_t offset = i * chunkSize;
+            const size_t length = std::min(end * chunkSize, remote.fileSize) - offset;
+
+            if (!budget.acquire(shouldCancel)) {
+                return false;
+            }
+            SyncHttpMemoryDownload download(file.url);
+            download.onProgress([&, nBytes](HttpRequest::Progress p) {
+                return onProgress({ true, remote.fileSize, nBytes + p.downloadedBytes });
+            });
+            HttpRequest::RequestOptions opt = {};
+            opt.requestTimeoutSeconds = 0;
+            opt.resumeFromByte = offset;
+            opt.rangeLength = length;
+            opt.maxBytesPerSecond = budget.bytesPerSecondPerConnection();
+            download.download(opt);
+            budget.release();
+
+            const std::vector<char>& data = download.downloadedData();
+            if (!download.hasSucceeded() || data.size() != length) {
+                return false;
+            }
+            for (size_t j = i; j < end; ++j) {
+                const char* chunk = data.data() + (j - i) * chunkSize;
+                const unsigned int checksum = ghoul::hashCRC32(
+                    chunk,
+                    chunkLength(remote, j)
+                );
+                if (checksum != remote.checksums[j]) {
+                    // The file was changed after the chunk list was written
+                    return false;
+                }
+            }
+            destination.write(data.data(), length);
+            nBytes += length;
+            i = end;
+        }
+        destination.close();
+        if (!destination.good()) {
+            return false;
+        }
+        if (file.hasChecksum && ghoul::hashCRC32File(temporary) != file.checksum) {
+            return false;
+        }
+
+        LDEBUG(fmt::format(
+            "Reused {} of {} bytes of {} from {}",
+            nReusedBytes, remote.fileSize, file.url, basis
+        ));
+        return true;
+    }
+
+    // Downloads a single file into 'directory', resuming an earlier partial download of
+    // it if possible, and verifies the result against the information in the file list
+    bool syncFile(const FileEntry& file, const std::string& directory,
+                  const openspace::syncmanifest::Manifest& previous, const Basis& basis,
+                  openspace::TransferBudget& budget, const std::atomic_bool& shouldCancel,
+                  openspace::syncmanifest::Entry& result,
+                  openspace::HttpDownload::ProgressCallback onProgress)
+    {
+        using namespace openspace;
+
+        const std::string destination = directory +
+            ghoul::filesystem::FileSystem::PathSeparator + file.filename;
+        const std::string temporary = destination + TempSuffix;
+
+        auto it = previous.find(file.filename);
+        if (it != previous.end() && FileSys.fileExists(destination)) {
+            const syncmanifest::Entry& e = it->second;
+            const bool isCurrent = (file.size == 0 || file.size == e.size) &&
+                                   (!file.hasChecksum || file.checksum == e.checksum);
+            if (isCurrent && syncmanifest::fileSize(destination) == e.size &&
+                ghoul::hashCRC32File(destination) == e.checksum)
+            {
+                result = e;
+                onProgress({ true, e.size, e.size });
+                return true;
+            }
+        }
+
+        bool hasSucceeded = false;
+        if (FileSys.fileExists(temporary) && file.size > 0) {
+            const size_t partialSize = syncmanifest::fileSize(temporary);
+            if (partialSize > file.size) {
+                FileSys.deleteFile(temporary);
+            }
+            // Requesting a range starting at the end of the file would fail
+            hasSucceeded = (partialSize == file.size);
+        }
+        else if (!basis.directory.empty()) {
+            // An older version of the file is only used if we are not in the middle of
+            // a full download of it already
+            auto b = basis.manifest.find(file.filename);
+            const std::string basisFile = basis.directory +
+                ghoul::filesystem::FileSystem::PathSeparator + file.filename;
+            const bool hasBasis = (b != basis.manifest.end()) &&
+                                  FileSys.fileExists(basisFile) &&
+                                  (syncmanifest::fileSize(basisFile) == b->second.size);
+            if (hasBasis) {
+                hasSucceeded = syncFileFromBasis(
+                    file,
+                    basisFile,
+                    temporary,
+                    budget,
+                    shouldCancel,
+                    onProgress
+                );
+                if (!hasSucceeded) {
+                    // Otherwise the file would be mistaken for a partial full download
+                    FileSys.deleteFile(temporary);
+                    if (shouldCancel) {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        for (int attempt = 0; !hasSucceeded && attempt < MaxDownloadAttempts; ++attempt) {
+            if (!budget.acquire(shouldCancel)) {
+                return false;
+            }
+            SyncHttpFileDownload download(
+                file.url,
+                temporary,
+                HttpFileDownload::Overwrite::Yes,
+                HttpFileDownload::Resume::Yes
+            );
+            download.onProgress(onProgress);
+
+            HttpRequest::RequestOptions opt = {};
+            opt.requestTimeoutSeconds = 0;
+            opt.maxBytesPerSecond = budget.bytesPerSecondPerConnection();
+            download.download(opt);
+            budget.release();
+
+            hasSucceeded = download.hasSucceeded();
+            if (!hasSucceeded && shouldCancel) {
+                // The partial file is kept so that it can be resumed on the next start
+                return false;
+            }
+            if (!hasSucceeded && download.resumeOffset() > 0) {
+                // The server might not support ranged requests, so the next attempt
+                // starts from scratch
+                LINFO(fmt::format("Restarting download from URL {}", file.url));
+                FileSys.deleteFile(temporary);
+            }
+        }
+
+        if (!hasSucceeded) {
+            LERROR(fmt::format("Error downloading file from URL {}", file.url));
+            // Otherwise an error page could be mistaken for a partial download
+            FileSys.deleteFile(temporary);
+            return false;
+        }
+
+        const size_t size = syncmanifest::fileSize(temporary);
+        if (file.size > 0 && size != file.size) {
+            LERROR(fmt::format(
+                "File from URL {} has {} bytes, expected {}", file.url, size, file.size
+            ));
+            FileSys.deleteFile(temporary);
+            return false;
+        }
+        const unsigned int checksum = ghoul::hashCRC32File(temporary);
+        if (file.hasChecksum && checksum != file.checksum) {
+            LERROR(fmt::format("Checksum mismatch for file from URL {}", file.url));
+            FileSys.deleteFile(temporary);
+            return false;
+        }
+
+        FileSys.deleteFile(destination);
+        if (rename(temporary.c_str(), destination.c_str()) != 0) {
+            LERROR(fmt::format("Error renaming file {} to {}", temporary, destination));
+            return false;
+        }
+
+        result = { size, checksum };
+        onProgress({ true, size, size });
+        return true;
+    }
 } // namespace
 
 namespace openspace {
@@ -75,11 +456,12 @@ documentation::Documentation HttpSynchronization::Documentation() {
 
 HttpSynchronization::HttpSynchronization(const ghoul::Dictionary& dict,
                                          std::string synchronizationRoot,
-                                      std::vector<std::string> synchronizationRepositories
-)
+                                         std::vector<std::string> repositories,
+                                         TransferBudget& transferBudget)
     : openspace::ResourceSynchronization(dict)
     , _synchronizationRoot(std::move(synchronizationRoot))
-    , _synchronizationRepositories(std::move(synchronizationRepositories))
+    , _synchronizationRepositories(std::move(repositories))
+    , _transferBudget(transferBudget)
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -118,7 +500,7 @@ void HttpSynchronization::start() {
     }
     begin();
 
-    if (hasSyncFile()) {
+    if (isSynchronized()) {
         resolve();
         return;
     }
@@ -132,7 +514,6 @@ void HttpSynchronization::start() {
         [this](const std::string& q) {
             for (const std::string& url : _synchronizationRepositories) {
                 if (trySyncFromUrl(url + q)) {
-                    createSyncFile();
                     resolve();
                     return;
                 }
@@ -167,20 +548,25 @@ bool HttpSynchronization::nTotalBytesIsKnown() {
     return _nTotalBytesKnown;
 }
 
-void HttpSynchronization::createSyncFile() {
-    const std::string& directoryName = directory();
-    const std::string& filepath = directoryName + ".ossync";
-
-    FileSys.createDirectory(directoryName, ghoul::filesystem::FileSystem::Recursive::Yes);
-
-    std::ofstream syncFile(filepath, std::ofstream::out);
-    syncFile << "Synchronized";
-    syncFile.close();
-}
+bool HttpSynchronization::isSynchronized() {
+    syncmanifest::Manifest manifest;
+    const std::string path = directory() + syncmanifest::Suffix;
+    const syncmanifest::Type type = syncmanifest::read(path, manifest);
+    if (type == syncmanifest::Type::Missing) {
+        return false;
+    }
+    if (type == syncmanifest::Type::Legacy) {
+        // We have no information about the individual files, so we have to trust that
+        // the synchronization that wrote this file was complete
+        return true;
+    }
 
-bool HttpSynchronization::hasSyncFile() {
-    const std::string& path = directory() + ".ossync";
-    return FileSys.fileExists(path);
+    const std::string file = syncmanifest::findIncompleteFile(manifest, directory());
+    if (!file.empty()) {
+        LINFO(fmt::format("{}: File '{}' is missing or incomplete", _identifier, file));
+        return false;
+    }
+    return true;
 }
 
 bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
@@ -198,121 +584,137 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
     }
 
     const std::vector<char>& buffer = fileListDownload.downloadedData();
+    const std::vector<FileEntry> files = parseFileList(
+        std::string(buffer.begin(), buffer.end()),
+        _identifier
+    );
+
     _nSynchronizedBytes = 0;
     _nTotalBytes = 0;
     _nTotalBytesKnown = false;
 
-    std::istringstream fileList(std::string(buffer.begin(), buffer.end()));
-
-    std::string line;
-
-    struct SizeData {
-        bool totalKnown;
-        size_t totalBytes;
-        size_t downloadedBytes;
-    };
-
-    std::unordered_map<std::string, SizeData> sizeData;
-    std::mutex sizeDataMutex;
-
-    std::atomic_bool startedAllDownloads(false);
-
-    std::vector<std::unique_ptr<AsyncHttpFileDownload>> downloads;
-
-    while (fileList >> line) {
-        size_t lastSlash = line.find_last_of('/');
-        std::string filename = line.substr(lastSlash + 1);
-
-        std::string fileDestination = directory() +
-            ghoul::filesystem::FileSystem::PathSeparator +
-            filename + TempSuffix;
-
-        if (sizeData.find(line) != sizeData.end()) {
-            LWARNING(fmt::format("{}: Duplicate entries: {}", _identifier, line));
-            continue;
+    const std::string dir = directory();
+    const std::string manifestPath = dir + syncmanifest::Suffix;
+    const std::string partialManifestPath = manifestPath + TempSuffix;
+    FileSys.createDirectory(dir, ghoul::filesystem::FileSystem::Recursive::Yes);
+
+    // Files that were completed by an earlier, interrupted or outdated synchronization
+    // are recorded in the manifests and can be reused if their checksum still matches
+    syncmanifest::Manifest previous;
+    syncmanifest::read(manifestPath, previous);
+    syncmanifest::read(partialManifestPath, previous);
+
+    // Files that changed since the newest older version we have are assembled from the
+    // chunks of that version that are still the same
+    const Basis basis = findBasis(dir.substr(0, dir.find_last_of("/\\")), _version);
+
+    // Every file that is completed is appended to the partial manifest right away, so
+    // that no finished file has to be downloaded again if we are interrupted
+    std::ofstream partialManifest(partialManifestPath, std::ofstream::trunc);
+    syncmanifest::writeHeader(partialManifest);
+    for (const std::pair<const std::string, syncmanifest::Entry>& entry : previous) {
+        syncmanifest::writeEntry(partialManifest, entry.first, entry.second);
+    }
+    partialManifest.flush();
+    FileSys.deleteFile(manifestPath);
+
+    std::vector<HttpRequest::Progress> progress(files.size());
+    std::mutex progressMutex;
+    auto updateProgress = [&](size_t i, HttpRequest::Progress p) {
+        std::lock_guard<std::mutex> guard(progressMutex);
+        if (files[i].size > 0) {
+            p.totalBytesKnown = true;
+            p.totalBytes = files[i].size;
         }
-
-        downloads.push_back(std::make_unique<AsyncHttpFileDownload>(
-            line,
-            fileDestination,
-            HttpFileDownload::Overwrite::Yes
-        ));
-
-        std::unique_ptr<AsyncHttpFileDownload>& fileDownload = downloads.back();
-
-        sizeData[line] = { false, 0, 0 };
-
-        fileDownload->onProgress(
-            [this, line, &sizeData, &sizeDataMutex,
-             &startedAllDownloads](HttpRequest::Progress p)
-        {
-            if (!p.totalBytesKnown || !startedAllDownloads) {
-                return !_shouldCancel;
+        else {
+            // curl reports a total of 0 until it has received the headers
+            p.totalBytesKnown = p.totalBytes > 0;
+        }
+        progress[i] = p;
+
+        HttpRequest::Progress sum = std::accumulate(
+            progress.begin(),
+            progress.end(),
+            HttpRequest::Progress{ true, 0, 0 },
+            [](const HttpRequest::Progress& a, const HttpRequest::Progress& b) {
+                return HttpRequest::Progress{
+                    a.totalBytesKnown && b.totalBytesKnown,
+                    a.totalBytes + b.totalBytes,
+                    a.downloadedBytes + b.downloadedBytes
+                };
             }
+        );
+        _nTotalBytesKnown = sum.totalBytesKnown;
+        _nTotalBytes = sum.totalBytes;
+        _nSynchronizedBytes = sum.downloadedBytes;
+    };
 
-            std::lock_guard<std::mutex> guard(sizeDataMutex);
-
-            sizeData[line] = { p.totalBytesKnown, p.totalBytes, p.downloadedBytes };
+    syncmanifest::Manifest completed;
+    std::mutex manifestMutex;
+    std::atomic_size_t nextFile(0);
+    std::atomic_bool failed(false);
+
+    // The files of this resource are downloaded by a few workers in parallel; how many
+    // of them are transferring at the same time is limited by the shared budget
+    auto worker = [&]() {
+        while (!failed && !_shouldCancel) {
+            const size_t i = nextFile++;
+            if (i >= files.size()) {
+                return;
+            }
 
-            SizeData size = std::accumulate(
-                sizeData.begin(),
-                sizeData.end(),
-                SizeData{ true, 0, 0 },
-                [](const SizeData& a, const std::pair<const std::string, SizeData>& b) {
-                    return SizeData {
-                        a.totalKnown && b.second.totalKnown,
-                        a.totalBytes + b.second.totalBytes,
-                        a.downloadedBytes + b.second.downloadedBytes
-                    };
+            syncmanifest::Entry result;
+            const bool success = syncFile(
+                files[i],
+                dir,
+                previous,
+                basis,
+                _transferBudget,
+                _shouldCancel,
+                result,
+                [&, i](HttpRequest::Progress p) {
+                    updateProgress(i, p);
+                    return !_shouldCancel;
                 }
             );
-
-            _nTotalBytesKnown = size.totalKnown;
-            _nTotalBytes = size.totalBytes;
-            _nSynchronizedBytes = size.downloadedBytes;
-
-            return !_shouldCancel;
-        });
-
-        fileDownload->start(opt);
-    }
-    startedAllDownloads = true;
-
-    bool failed = false;
-    for (std::unique_ptr<AsyncHttpFileDownload>& d : downloads) {
-        d->wait();
-        if (d->hasSucceeded()) {
-            // If we are forcing the override, we download to a temporary file
-            // first, so when we are done here, we need to rename the file to the
-            // original name
-
-            const std::string& tempName = d->destination();
-            std::string originalName = tempName.substr(
-                0,
-                tempName.size() - strlen(TempSuffix)
-            );
-
-            FileSys.deleteFile(originalName);
-            int success = rename(tempName.c_str(), originalName.c_str());
-            if (success != 0) {
-                LERROR(fmt::format(
-                    "Error renaming file {} to {}", tempName, originalName
-                ));
+            if (!success) {
                 failed = true;
+                return;
             }
+
+            std::lock_guard<std::mutex> guard(manifestMutex);
+            completed[files[i].filename] = result;
+            syncmanifest::writeEntry(partialManifest, files[i].filename, result);
+            partialManifest.flush();
         }
-        else {
-            LERROR(fmt::format("Error downloading file from URL {}", d->url()));
-            failed = true;
-        }
+    };
+
+    const size_t nWorkers = std::min(
+        files.size(),
+        static_cast<size_t>(_transferBudget.maxConnections())
+    );
+    std::vector<std::thread> workers;
+    workers.reserve(nWorkers);
+    for (size_t i = 0; i < nWorkers; ++i) {
+        workers.emplace_back(worker);
     }
-    if (!failed) {
-        return true;
+    for (std::thread& w : workers) {
+        w.join();
     }
-    for (std::unique_ptr<AsyncHttpFileDownload>& d : downloads) {
-        d->cancel();
+    partialManifest.close();
+
+    if (failed || _shouldCancel) {
+        return false;
+    }
+
+    std::ofstream manifest(manifestPath, std::ofstream::trunc);
+    syncmanifest::writeHeader(manifest);
+    for (const std::pair<const std::string, syncmanifest::Entry>& entry : completed) {
+        syncmanifest::writeEntry(manifest, entry.first, entry.second);
     }
-    return false;
+    manifest.close();
+    FileSys.deleteFile(partialManifestPath);
+    return true;
 }
 
 } // namespace openspace
@@ -27,15 +27,19 @@
 
 #include <openspace/util/resourcesynchronization.h>
 
+#include <atomic>
 #include <thread>
 #include <vector>
 
 namespace openspace {
 
+class TransferBudget;
+
 class HttpSynchronization : public ResourceSynchronization {
 public:
     HttpSynchronization(const ghoul::Dictionary& dict, std::string synchronizationRoot,
-        std::vector<std::string> synchronizationRepositories);
+        std::vector<std::string> synchronizationRepositories,
+        TransferBudget& transferBudget);
 
     virtual ~HttpSynchronization();
 
@@ -52,8 +56,11 @@ public:
     static documentation::Documentation Documentation();
 
 private:
-    void createSyncFile();
-    bool hasSyncFile();
+    /**
+     * Returns \c true if the manifest of this resource exists and all of the files it
+     * lists are present with their recorded sizes.
+     */
+    bool isSynchronized();
     bool trySyncFromUrl(std::string url);
 
     std::atomic_bool _nTotalBytesKnown = false;
@@ -65,6 +72,7 @@ private:
     int _version = -1;
     std::string _synchronizationRoot;
     std::vector<std::string> _synchronizationRepositories;
+    TransferBudget& _transferBudget;
 
     std::thread _syncThread;
 };
@@ -25,6 +25,7 @@
 #include <modules/sync/syncs/urlsynchronization.h>
 
 #include <modules/sync/syncmodule.h>
+#include <modules/sync/transferbudget.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/moduleengine.h>
@@ -34,7 +35,9 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
 #include <fstream>
+#include <mutex>
 #include <numeric>
 #include <memory>
 
@@ -96,9 +99,11 @@ documentation::Documentation UrlSynchronization::Documentation() {
 }
 
 UrlSynchronization::UrlSynchronization(const ghoul::Dictionary& dict,
-                                       std::string synchronizationRoot)
+                                       std::string synchronizationRoot,
+                                       TransferBudget& transferBudget)
     : ResourceSynchronization(dict)
     , _synchronizationRoot(std::move(synchronizationRoot))
+    , _transferBudget(transferBudget)
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -176,71 +181,73 @@ void UrlSynchronization::start() {
     _syncThread = std::thread([this] {
         std::unordered_map<std::string, size_t> fileSizes;
         std::mutex fileSizeMutex;
-        std::atomic_size_t nDownloads(0);
-        std::atomic_bool startedAllDownloads(false);
-        std::vector<std::unique_ptr<AsyncHttpFileDownload>> downloads;
-
-        for (const std::string& url : _urls) {
-            const size_t lastSlash = url.find_last_of('/');
-            const std::string filename = url.substr(lastSlash + 1);
+        std::atomic_size_t nextUrl(0);
+        std::atomic_bool failed(false);
+
+        // The downloads are performed by a few workers, of which only as many are
+        // transferring at the same time as the shared budget allows
+        auto worker = [&]() {
+            while (!failed && !_shouldCancel) {
+                const size_t i = nextUrl++;
+                if (i >= _urls.size()) {
+                    return;
+                }
+                const std::string& url = _urls[i];
+                const size_t lastSlash = url.find_last_of('/');
+                const std::string filename = url.substr(lastSlash + 1);
 
-            std::string fileDestination = directory() +
-                ghoul::filesystem::FileSystem::PathSeparator + filename + TempSuffix;
+                std::string fileDestination = directory() +
+                    ghoul::filesystem::FileSystem::PathSeparator + filename + TempSuffix;
 
-            std::unique_ptr<AsyncHttpFileDownload> download =
-                std::make_unique<AsyncHttpFileDownload>(
+                SyncHttpFileDownload download(
                     url,
                     fileDestination,
                     HttpFileDownload::Overwrite::Yes
                 );
 
-            downloads.push_back(std::move(download));
-
-            std::unique_ptr<AsyncHttpFileDownload>& fileDownload = downloads.back();
-
-            ++nDownloads;
-
-            fileDownload->onProgress(
-                [this, url, &fileSizes, &fileSizeMutex,
-                &startedAllDownloads, &nDownloads](HttpRequest::Progress p)
-            {
-                if (p.totalBytesKnown) {
-                    std::lock_guard<std::mutex> guard(fileSizeMutex);
-                    fileSizes[url] = p.totalBytes;
-
-                    if (!_nTotalBytesKnown && startedAllDownloads &&
-                        fileSizes.size() == nDownloads)
-                    {
-                        _nTotalBytesKnown = true;
-                        _nTotalBytes = std::accumulate(
-                            fileSizes.begin(),
-                            fileSizes.end(),
-                            size_t(0),
-                            [](size_t a, const std::pair<const std::string, size_t> b) {
-                                return a + b.second;
+                download.onProgress(
+                    [this, url, &fileSizes, &fileSizeMutex](HttpRequest::Progress p) {
+                        if (p.totalBytesKnown) {
+                            std::lock_guard<std::mutex> guard(fileSizeMutex);
+                            fileSizes[url] = p.totalBytes;
+
+                            if (!_nTotalBytesKnown && fileSizes.size() == _urls.size()) {
+                                _nTotalBytesKnown = true;
+                                _nTotalBytes = std::accumulate(
+                                    fileSizes.begin(),
+                                    fileSizes.end(),
+                                    size_t(0),
+                                    [](size_t a, const std::pair<const std::string,
+                                                                 size_t> b)
+                                    {
+                                        return a + b.second;
+                                    }
+                                );
                             }
-                        );
+                        }
+                        return !_shouldCancel;
                     }
-                }
-                return !_shouldCancel;
-            });
+                );
 
-            HttpRequest::RequestOptions opt = {};
-            opt.requestTimeoutSeconds = 0;
-            fileDownload->start(opt);
-        }
+                if (!_transferBudget.acquire(_shouldCancel)) {
+                    failed = true;
+                    return;
+                }
+                HttpRequest::RequestOptions opt = {};
+                opt.requestTimeoutSeconds = 0;
+                opt.maxBytesPerSecond = _transferBudget.bytesPerSecondPerConnection();
+                download.download(opt);
+                _transferBudget.release();
 
-        startedAllDownloads = true;
+                if (!download.hasSucceeded()) {
+                    failed = true;
+                    return;
+                }
 
-        bool failed = false;
-        for (std::unique_ptr<AsyncHttpFileDownload>& d : downloads) {
-            d->wait();
-            if (d->hasSucceeded()) {
                 // If we are forcing the override, we download to a temporary file first,
                 // so when we are done here, we need to rename the file to the original
                 // name
-
-                const std::string& tempName = d->destination();
+                const std::string& tempName = download.destination();
                 std::string originalName = tempName.substr(
                     0,
                     tempName.size() - strlen(TempSuffix)
@@ -259,19 +266,24 @@ void UrlSynchronization::start() {
                     failed = true;
                 }
             }
-            else {
-                failed = true;
-            }
+        };
+
+        const size_t nWorkers = std::min(
+            _urls.size(),
+            static_cast<size_t>(_transferBudget.maxConnections())
+        );
+        std::vector<std::thread> workers;
+        workers.reserve(nWorkers);
+        for (size_t i = 0; i < nWorkers; ++i) {
+            workers.emplace_back(worker);
+        }
+        for (std::thread& w : workers) {
+            w.join();
         }
 
-        if (!failed) {
+        if (!failed && !_shouldCancel) {
             createSyncFile();
         }
-        else {
-            for (std::unique_ptr<AsyncHttpFileDownload>& d : downloads) {
-                d->cancel();
-            }
-        }
         resolve();
     });
 }
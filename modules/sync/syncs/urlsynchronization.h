@@ -33,9 +33,12 @@
 
 namespace openspace {
 
+class TransferBudget;
+
 class UrlSynchronization : public ResourceSynchronization {
 public:
-    UrlSynchronization(const ghoul::Dictionary& dict, std::string synchronizationRoot);
+    UrlSynchronization(const ghoul::Dictionary& dict, std::string synchronizationRoot,
+        TransferBudget& transferBudget);
 
     virtual ~UrlSynchronization();
 
@@ -58,6 +61,7 @@ private:
     bool _forceOverride = false;
     std::string _synchronizationRoot;
     std::string _identifier;
+    TransferBudget& _transferBudget;
 
     std::atomic_bool _nTotalBytesKnown = false;
     std::atomic_size_t _nTotalBytes = 0;
@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/sync/tasks/chunklisttask.h>
+
+#include <modules/sync/syncchunks.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/directory.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <fstream>
+
+namespace {
+    constexpr const char* _loggerCat = "ChunkListTask";
+
+    constexpr const char* KeyDirectory = "Directory";
+    constexpr const char* KeyChunkSize = "ChunkSize";
+
+    bool endsWith(const std::string& str, const std::string& suffix) {
+        return str.size() >= suffix.size() &&
+               str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+} // namespace
+
+namespace openspace {
+
+documentation::Documentation ChunkListTask::documentation() {
+    using namespace documentation;
+    return {
+        "ChunkListTask",
+        "sync_chunk_list_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("ChunkListTask"),
+                Optional::No,
+                "The type of this task"
+            },
+            {
+                KeyDirectory,
+                new StringAnnotationVerifier("A path to a directory"),
+                Optional::No,
+                "The directory whose files are split into chunks. A chunk list is "
+                "written next to each file in this directory and its subdirectories."
+            },
+            {
+                KeyChunkSize,
+                new IntVerifier,
+                Optional::Yes,
+                "The size of the chunks in bytes. Smaller chunks reduce the amount of "
+                "data that is downloaded for small changes, but require more requests. "
+                "Default is 4 MB."
+            }
+        }
+    };
+}
+
+ChunkListTask::ChunkListTask(const ghoul::Dictionary& dictionary)
+    : _chunkSize(syncchunks::DefaultChunkSize)
+{
+    documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "ChunkListTask"
+    );
+
+    _directory = absPath(dictionary.value<std::string>(KeyDirectory));
+    if (dictionary.hasKey(KeyChunkSize)) {
+        const double chunkSize = dictionary.value<double>(KeyChunkSize);
+        if (chunkSize < 1.0) {
+            throw ghoul::RuntimeError("ChunkSize must be positive", "ChunkListTask");
+        }
+        _chunkSize = static_cast<size_t>(chunkSize);
+    }
+}
+
+std::string ChunkListTask::description() {
+    return fmt::format(
+        "Write chunk lists with {} byte chunks for the files in {}",
+        _chunkSize, _directory
+    );
+}
+
+void ChunkListTask::perform(const Task::ProgressCallback& progressCallback) {
+    const ghoul::filesystem::Directory dir(_directory);
+    std::vector<std::string> files = dir.readFiles(
+        ghoul::filesystem::Directory::Recursive::Yes
+    );
+    files.erase(
+        std::remove_if(
+            files.begin(),
+            files.end(),
+            [](const std::string& f) { return endsWith(f, syncchunks::Suffix); }
+        ),
+        files.end()
+    );
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        const std::string& file = files[i];
+        const syncchunks::ChunkList list = syncchunks::compute(file, _chunkSize);
+
+        // The list is written to a temporary file first so that a client never sees a
+        // partial list while the server is updating it
+        const std::string path = file + syncchunks::Suffix;
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream stream(temporary, std::ofstream::trunc);
+            syncchunks::write(stream, list);
+            if (!stream.good()) {
+                LERROR(fmt::format("Error writing chunk list {}", temporary));
+                continue;
+            }
+        }
+        FileSys.deleteFile(path);
+        if (rename(temporary.c_str(), path.c_str()) != 0) {
+            LERROR(fmt::format("Error renaming file {} to {}", temporary, path));
+        }
+        progressCallback(static_cast<float>(i + 1) / static_cast<float>(files.size()));
+    }
+    progressCallback(1.f);
+}
+
+} // namespace openspace
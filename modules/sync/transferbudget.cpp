@@ -0,0 +1,92 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/sync/transferbudget.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // Waiting threads wake up regularly to check whether they have been canceled
+    constexpr const std::chrono::milliseconds CancelPollInterval(100);
+} // namespace
+
+namespace openspace {
+
+TransferBudget::TransferBudget(int maxConnections, size_t maxBytesPerSecond)
+    : _maxConnections(std::max(maxConnections, 1))
+    , _maxBytesPerSecond(maxBytesPerSecond)
+{}
+
+void TransferBudget::setMaxConnections(int maxConnections) {
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _maxConnections = std::max(maxConnections, 1);
+    }
+    _connectionReleased.notify_all();
+}
+
+int TransferBudget::maxConnections() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _maxConnections;
+}
+
+void TransferBudget::setMaxBytesPerSecond(size_t maxBytesPerSecond) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _maxBytesPerSecond = maxBytesPerSecond;
+}
+
+size_t TransferBudget::bytesPerSecondPerConnection() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    if (_maxBytesPerSecond == 0) {
+        return 0;
+    }
+    // curl treats 0 as 'unlimited', so we never go below a single byte
+    return std::max<size_t>(_maxBytesPerSecond / _maxConnections, 1);
+}
+
+bool TransferBudget::acquire(const std::atomic_bool& shouldCancel) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_nActiveConnections >= _maxConnections) {
+        if (shouldCancel) {
+            return false;
+        }
+        _connectionReleased.wait_for(lock, CancelPollInterval);
+    }
+    if (shouldCancel) {
+        return false;
+    }
+    ++_nActiveConnections;
+    return true;
+}
+
+void TransferBudget::release() {
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        --_nActiveConnections;
+    }
+    _connectionReleased.notify_one();
+}
+
+} // namespace openspace
@@ -0,0 +1,77 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SYNC___TRANSFERBUDGET___H__
+#define __OPENSPACE_MODULE_SYNC___TRANSFERBUDGET___H__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace openspace {
+
+/**
+ * The TransferBudget limits the number of simultaneous HTTP connections and the total
+ * bandwidth that all resource synchronizations of the SyncModule are allowed to use.
+ * Each transfer has to acquire a connection before it is started and release it once
+ * it is finished. The bandwidth is split evenly between all possible connections, as
+ * the limit has to be passed to each transfer individually when it is created.
+ */
+class TransferBudget {
+public:
+    /**
+     * Creates a budget that allows \p maxConnections simultaneous connections that
+     * share \p maxBytesPerSecond. A \p maxBytesPerSecond of 0 means that the
+     * bandwidth is not limited.
+     */
+    TransferBudget(int maxConnections, size_t maxBytesPerSecond);
+
+    void setMaxConnections(int maxConnections);
+    int maxConnections() const;
+
+    void setMaxBytesPerSecond(size_t maxBytesPerSecond);
+
+    /// Returns the bandwidth available to a single connection, or 0 for no limit
+    size_t bytesPerSecondPerConnection() const;
+
+    /**
+     * Blocks until a connection is available and claims it. Returns \c false without
+     * claiming a connection if \p shouldCancel is set to \c true while waiting.
+     */
+    bool acquire(const std::atomic_bool& shouldCancel);
+
+    /// Returns a connection that was claimed by a successful call to #acquire
+    void release();
+
+private:
+    mutable std::mutex _mutex;
+    std::condition_variable _connectionReleased;
+    int _maxConnections;
+    int _nActiveConnections = 0;
+    size_t _maxBytesPerSecond;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SYNC___TRANSFERBUDGET___H__
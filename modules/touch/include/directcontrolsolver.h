@@ -0,0 +1,127 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_TOUCH___DIRECTCONTROLSOLVER___H__
+#define __OPENSPACE_MODULE_TOUCH___DIRECTCONTROLSOLVER___H__
+
+#include <ghoul/glm.h>
+#include <array>
+#include <string>
+
+namespace openspace::directcontrol {
+
+/**
+ * A value together with its partial derivatives with respect to \p N parameters. The
+ * direct-manipulation camera model is evaluated on Jets, which produces the residuals
+ * and their exact Jacobian in a single pass without any finite differencing.
+ */
+template <int N>
+struct Jet {
+    Jet() = default;
+    Jet(double v); // NOLINT
+
+    /// Returns a Jet that represents the parameter \p index with the current value \p v
+    static Jet variable(double v, int index);
+
+    double value = 0.0;
+    std::array<double, N> derivative = {};
+};
+
+/// The largest number of contact points that are used for direct-manipulation
+constexpr const int MaxContacts = 3;
+
+/// The largest number of degrees of freedom solved for: orbit (2), zoom, roll, pan (2)
+constexpr const int MaxDOF = 2 * MaxContacts;
+
+/**
+ * Result of a single run of the Levenberg-Marquardt solver in #levenbergMarquardt.
+ */
+struct Statistics {
+    bool success = false;
+    int iterations = 0;
+    double error = 0.0;
+};
+
+/**
+ * Minimizes the sum of squared residuals returned by \p residuals using the
+ * Levenberg-Marquardt algorithm for a system with \p NDOF parameters and just as many
+ * residuals. \p residuals is called with an array of parameter Jets and has to return an
+ * <code>std::array<Jet<NDOF>, NDOF></code>, the derivatives of which form the Jacobian.
+ * All intermediate matrices live on the stack. On return, \p parameters contains the
+ * best solution that was found. If \p log is not <code>nullptr</code>, one CSV row per
+ * iteration is appended to it.
+ */
+template <int NDOF, typename Func>
+Statistics levenbergMarquardt(std::array<double, NDOF>& parameters, const Func& residuals,
+    std::string* log = nullptr);
+
+/**
+ * A self-contained snapshot of everything needed to solve for the camera transform of
+ * one frame of direct-manipulation. As it does not reference the Camera or the
+ * SceneGraphNode, it can be solved on a different thread than the one rendering.
+ */
+struct Problem {
+    glm::dvec3 cameraPosition;
+    glm::dquat cameraRotation;
+    glm::dvec3 cameraLookUpCameraSpace;
+    glm::dvec3 cameraLookUpWorldSpace;
+    glm::dvec3 cameraViewDirectionWorldSpace;
+    glm::dmat4 projectionMatrix;
+
+    glm::dvec3 nodePosition;
+
+    /// Number of contact points; the number of degrees of freedom is twice this number
+    int nContacts = 0;
+    /// The world space positions of the surface points that were selected by the user
+    std::array<glm::dvec3, MaxContacts> surfacePoints;
+    /// The normalized [-1, 1] screen positions that the surface points has to end up at
+    std::array<glm::dvec2, MaxContacts> screenPoints;
+
+    /// The values from which the solve starts: orbit (2), zoom, roll, pan (2)
+    std::array<double, MaxDOF> initialParameters = {};
+
+    /// If this is true, the iterations of the solver are stored in Solution::log
+    bool recordIterations = false;
+};
+
+struct Solution {
+    Statistics statistics;
+    /// The number of degrees of freedom that were solved for
+    int nDOF = 0;
+    /// The solved orbit (2), zoom, roll and pan (2) parameters
+    std::array<double, MaxDOF> parameters = {};
+    std::string log;
+};
+
+/**
+ * Finds the orbit, zoom, roll, and pan with which the camera in \p problem has to move so
+ * that every surface point is projected onto its corresponding screen point.
+ */
+Solution solve(const Problem& problem);
+
+} // namespace openspace::directcontrol
+
+#include <modules/touch/include/directcontrolsolver.inl>
+
+#endif // __OPENSPACE_MODULE_TOUCH___DIRECTCONTROLSOLVER___H__
@@ -0,0 +1,347 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
+namespace openspace::directcontrol {
+
+template <int N>
+Jet<N>::Jet(double v)
+    : value(v)
+{}
+
+template <int N>
+Jet<N> Jet<N>::variable(double v, int index) {
+    Jet<N> res(v);
+    res.derivative[index] = 1.0;
+    return res;
+}
+
+template <int N>
+Jet<N> operator+(const Jet<N>& lhs, const Jet<N>& rhs) {
+    Jet<N> res(lhs.value + rhs.value);
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] = lhs.derivative[i] + rhs.derivative[i];
+    }
+    return res;
+}
+
+template <int N>
+Jet<N> operator+(const Jet<N>& lhs, double rhs) {
+    Jet<N> res(lhs);
+    res.value += rhs;
+    return res;
+}
+
+template <int N>
+Jet<N> operator+(double lhs, const Jet<N>& rhs) {
+    return rhs + lhs;
+}
+
+template <int N>
+Jet<N> operator-(const Jet<N>& lhs, const Jet<N>& rhs) {
+    Jet<N> res(lhs.value - rhs.value);
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] = lhs.derivative[i] - rhs.derivative[i];
+    }
+    return res;
+}
+
+template <int N>
+Jet<N> operator-(const Jet<N>& v) {
+    Jet<N> res(-v.value);
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] = -v.derivative[i];
+    }
+    return res;
+}
+
+template <int N>
+Jet<N> operator-(const Jet<N>& lhs, double rhs) {
+    return lhs + (-rhs);
+}
+
+template <int N>
+Jet<N> operator-(double lhs, const Jet<N>& rhs) {
+    return -rhs + lhs;
+}
+
+template <int N>
+Jet<N> operator*(const Jet<N>& lhs, const Jet<N>& rhs) {
+    Jet<N> res(lhs.value * rhs.value);
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] =
+            lhs.derivative[i] * rhs.value + lhs.value * rhs.derivative[i];
+    }
+    return res;
+}
+
+template <int N>
+Jet<N> operator*(const Jet<N>& lhs, double rhs) {
+    Jet<N> res(lhs.value * rhs);
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] = lhs.derivative[i] * rhs;
+    }
+    return res;
+}
+
+template <int N>
+Jet<N> operator*(double lhs, const Jet<N>& rhs) {
+    return rhs * lhs;
+}
+
+template <int N>
+Jet<N> operator/(const Jet<N>& lhs, const Jet<N>& rhs) {
+    const double inv = 1.0 / rhs.value;
+    Jet<N> res(lhs.value * inv);
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] = (lhs.derivative[i] - res.value * rhs.derivative[i]) * inv;
+    }
+    return res;
+}
+
+template <int N>
+Jet<N> sqrt(const Jet<N>& v) {
+    Jet<N> res(std::sqrt(v.value));
+    const double f = 0.5 / res.value;
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] = v.derivative[i] * f;
+    }
+    return res;
+}
+
+template <int N>
+Jet<N> sin(const Jet<N>& v) {
+    Jet<N> res(std::sin(v.value));
+    const double f = std::cos(v.value);
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] = v.derivative[i] * f;
+    }
+    return res;
+}
+
+template <int N>
+Jet<N> cos(const Jet<N>& v) {
+    Jet<N> res(std::cos(v.value));
+    const double f = -std::sin(v.value);
+    for (int i = 0; i < N; ++i) {
+        res.derivative[i] = v.derivative[i] * f;
+    }
+    return res;
+}
+
+namespace detail {
+    constexpr const int MaxIterations = 3000;
+    constexpr const double InitialLambda = 1e-6;
+    constexpr const double LambdaUpFactor = 10.0;
+    constexpr const double LambdaDownFactor = 10.0;
+    // Once an accepted step improves the error by less than this, the solve is done
+    constexpr const double TargetErrorChange = 1e-12;
+    // An error below this means the contact points coincide with the surface points
+    constexpr const double MinimumError = 1e-16;
+    // Smallest value allowed on the diagonal in choleskyDecomposition
+    constexpr const double CholeskyTolerance = 1e-30;
+    constexpr const std::chrono::milliseconds TimeLimit(200);
+
+    template <int N>
+    using Matrix = std::array<std::array<double, N>, N>;
+
+    // Computes the lower-triangular Cholesky factor of the symmetric, positive-definite
+    // matrix a; elements above the diagonal are ignored. Returns false if a is not
+    // positive-definite
+    template <int N>
+    bool choleskyDecomposition(const Matrix<N>& a, Matrix<N>& l) {
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < i; ++j) {
+                double sum = 0.0;
+                for (int k = 0; k < j; ++k) {
+                    sum += l[i][k] * l[j][k];
+                }
+                l[i][j] = (a[i][j] - sum) / l[j][j];
+            }
+            double sum = 0.0;
+            for (int k = 0; k < i; ++k) {
+                sum += l[i][k] * l[i][k];
+            }
+            sum = a[i][i] - sum;
+            if (sum < CholeskyTolerance) {
+                return false;
+            }
+            l[i][i] = std::sqrt(sum);
+        }
+        return true;
+    }
+
+    // Solves Ax=b for x, where l is the Cholesky factor of A
+    template <int N>
+    std::array<double, N> solveCholesky(const Matrix<N>& l,
+                                        const std::array<double, N>& b)
+    {
+        std::array<double, N> x;
+        // Solve L*y = b for y (where x is used to store y)
+        for (int i = 0; i < N; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j < i; ++j) {
+                sum += l[i][j] * x[j];
+            }
+            x[i] = (b[i] - sum) / l[i][i];
+        }
+        // Solve L^T*x = y for x
+        for (int i = N - 1; i >= 0; --i) {
+            double sum = 0.0;
+            for (int j = i + 1; j < N; ++j) {
+                sum += l[j][i] * x[j];
+            }
+            x[i] = (x[i] - sum) / l[i][i];
+        }
+        return x;
+    }
+
+    template <int N>
+    double squaredError(const std::array<Jet<N>, N>& residuals) {
+        double e = 0.0;
+        for (const Jet<N>& r : residuals) {
+            e += r.value * r.value;
+        }
+        return e;
+    }
+} // namespace detail
+
+template <int NDOF, typename Func>
+Statistics levenbergMarquardt(std::array<double, NDOF>& parameters, const Func& residuals,
+                              std::string* log)
+{
+    using namespace detail;
+
+    auto evaluate = [&residuals](const std::array<double, NDOF>& par) {
+        std::array<Jet<NDOF>, NDOF> variables;
+        for (int i = 0; i < NDOF; ++i) {
+            variables[i] = Jet<NDOF>::variable(par[i], i);
+        }
+        return residuals(variables);
+    };
+
+    if (log) {
+        std::ostringstream header;
+        header << "it,lambda,err,derr";
+        for (int i = 0; i < NDOF; ++i) {
+            header << ",q" << i;
+        }
+        for (int i = 0; i < NDOF; ++i) {
+            header << ",r" << i;
+        }
+        header << "\n";
+        log->append(header.str());
+    }
+
+    std::array<Jet<NDOF>, NDOF> res = evaluate(parameters);
+    double err = squaredError<NDOF>(res);
+    double lambda = InitialLambda;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    Statistics stats;
+    int it = 0;
+    for (; it < MaxIterations && err > MinimumError; ++it) {
+        if (std::chrono::steady_clock::now() - start > TimeLimit) {
+            stats.iterations = it;
+            stats.error = err;
+            return stats;
+        }
+
+        // Gauss-Newton approximation of the Hessian (J^T J) and the gradient (-J^T r)
+        Matrix<NDOF> h = {};
+        std::array<double, NDOF> d = {};
+        for (const Jet<NDOF>& r : res) {
+            for (int i = 0; i < NDOF; ++i) {
+                d[i] -= r.value * r.derivative[i];
+                for (int j = 0; j <= i; ++j) {
+                    h[i][j] += r.derivative[i] * r.derivative[j];
+                }
+            }
+        }
+
+        // Make a step; if the step would increase the error, increase lambda and retry
+        bool accepted = false;
+        double derr = 0.0;
+        while (!accepted && it < MaxIterations) {
+            Matrix<NDOF> damped = h;
+            for (int i = 0; i < NDOF; ++i) {
+                damped[i][i] *= 1.0 + lambda;
+            }
+            Matrix<NDOF> l = {};
+            if (choleskyDecomposition<NDOF>(damped, l)) {
+                const std::array<double, NDOF> delta = solveCholesky<NDOF>(l, d);
+                std::array<double, NDOF> trial;
+                for (int i = 0; i < NDOF; ++i) {
+                    trial[i] = parameters[i] + delta[i];
+                }
+                std::array<Jet<NDOF>, NDOF> trialRes = evaluate(trial);
+                const double trialErr = squaredError<NDOF>(trialRes);
+                derr = trialErr - err;
+                if (derr <= 0.0) {
+                    parameters = trial;
+                    res = trialRes;
+                    err = trialErr;
+                    accepted = true;
+                }
+            }
+
+            if (log) {
+                std::ostringstream row;
+                row << it << "," << lambda << "," << err << "," << derr;
+                for (int i = 0; i < NDOF; ++i) {
+                    row << "," << parameters[i];
+                }
+                for (int i = 0; i < NDOF; ++i) {
+                    row << "," << res[i].value;
+                }
+                row << "\n";
+                log->append(row.str());
+            }
+
+            if (!accepted) {
+                lambda *= LambdaUpFactor;
+                ++it;
+            }
+        }
+        if (!accepted) {
+            break;
+        }
+        lambda /= LambdaDownFactor;
+
+        if (-derr < TargetErrorChange) {
+            break;
+        }
+    }
+
+    stats.success = (it < MaxIterations);
+    stats.iterations = it;
+    stats.error = err;
+    return stats;
+}
+
+} // namespace openspace::directcontrol
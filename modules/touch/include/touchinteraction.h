@@ -27,7 +27,7 @@
 
 #include <openspace/properties/propertyowner.h>
 
-#include <modules/touch/ext/levmarq.h>
+#include <modules/touch/include/directcontrolsolver.h>
 #include <modules/touch/include/tuioear.h>
 
 #include <openspace/properties/scalar/boolproperty.h>
@@ -37,6 +37,8 @@
 #include <openspace/properties/vector/ivec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 
+#include <future>
+
 //#define TOUCH_DEBUG_PROPERTIES
 //#define TOUCH_DEBUG_NODE_PICK_MESSAGES
 
@@ -86,19 +88,6 @@ public:
         glm::dvec3 coordinates;
     };
 
-    // Used in the LM algorithm
-    struct FunctionData {
-        std::vector<glm::dvec3> selectedPoints;
-        std::vector<glm::dvec2> screenPoints;
-        int nDOF;
-        glm::dvec2(*castToNDC)(const glm::dvec3&, Camera&, SceneGraphNode*);
-        double(*distToMinimize)(double* par, int x, void* fdata, LMstat* lmstat);
-        Camera* camera;
-        SceneGraphNode* node;
-        LMstat stats;
-        double objectScreenRadius;
-    };
-
     /* Main function call
      * 1 Checks if doubleTap occured
      * 2 Goes through the guiMode() function
@@ -116,6 +105,12 @@ public:
     void updateStateFromInput(const std::vector<TUIO::TuioCursor>& list,
         std::vector<Point>& lastProcessed);
 
+    /* Applies the result of a direct-manipulation solve that finished after the last
+     * input was processed. Called each frame that the contact points are present but
+     * have not moved, as the result would otherwise wait for the next input event
+     */
+    void updateDirectControl(const std::vector<TUIO::TuioCursor>& list);
+
     // Calculates the new camera state with velocities and time since last frame
     void step(double dt);
 
@@ -150,10 +145,27 @@ private:
 
     /* Function that calculates the new camera state such that it minimizes the L2 error
      * in screenspace
-     * between contact points and surface coordinates projected to clip space using LMA
+     * between contact points and surface coordinates projected to clip space using LMA.
+     * The solve runs asynchronously, its result is applied in the first frame after it
+     * finished, at which point the next solve for the latest contact points is started
      */
     void directControl(const std::vector<TUIO::TuioCursor>& list);
 
+    /* Applies the result of the running direct-manipulation solve if it has finished.
+     * Returns true if a new solve can be started for the contact points in list
+     */
+    bool collectDirectControlSolve(const std::vector<TUIO::TuioCursor>& list);
+
+    /* Makes a snapshot of the camera, the selected surface points, and the contact points
+     * in list for the direct-manipulation solver. Returns false if a selected contact
+     * point is no longer part of list
+     */
+    bool createDirectControlProblem(const std::vector<TUIO::TuioCursor>& list,
+        directcontrol::Problem& problem) const;
+
+    // Sets the velocities that move the camera to the solved direct-manipulation state
+    void applyDirectControlSolution(const directcontrol::Solution& solution);
+
     /* Traces each contact point into the scene as a ray
      * if the ray hits a node, save the id, node and surface coordinates the cursor hit
      * in the list _selected
@@ -255,7 +267,9 @@ private:
     bool _guiON;
     std::vector<SelectedBody> _selected;
     SceneGraphNode* _pickingSelected = nullptr;
-    LMstat _lmstat;
+    std::future<directcontrol::Solution> _directControlSolve;
+    // Set if the input that the running solve was started from has been reset
+    bool _discardDirectControlSolve = false;
     glm::dquat _toSlerp;
     glm::dvec3 _centroid;
 
@@ -51,11 +51,35 @@
 #include <ghoul/glm.h>
 
 #include <math.h>
+#include <array>
+#include <atomic>
 #include <vector>
-#include <mutex>
 #include <numeric>
 #include <algorithm>
 
+/**
+ * A compact copy of a single TUIO cursor callback, which is handed from the thread that
+ * receives the TUIO messages to the main thread.
+ */
+struct TouchEvent {
+    enum class Type : uint8_t {
+        Added = 0,
+        Updated,
+        Removed,
+        Tap
+    };
+
+    Type type;
+    int cursorId;
+    long sessionId;
+    float x;
+    float y;
+    float xSpeed;
+    float ySpeed;
+    float motionAccel;
+    long seconds;
+    long microseconds;
+};
 
 class TuioEar : public TUIO::TuioListener {
     public:
@@ -84,9 +108,10 @@ class TuioEar : public TUIO::TuioListener {
         void refresh(TUIO::TuioTime frameTime);
 
         /**
-        * Returns a list of all touch history that happened since the last frame
+        * Applies all touch events that happened since the last frame and returns the
+        * resulting list of cursors. Must only be called from the main thread
         */
-        std::vector<TUIO::TuioCursor> getInput();
+        const std::vector<TUIO::TuioCursor>& getInput();
 
         /**
         * Returns true if a tap occured since the last frame
@@ -104,13 +129,29 @@ class TuioEar : public TUIO::TuioListener {
         void clearInput();
 
     private:
-        bool _tap = false;
-        TUIO::TuioCursor _tapCo = TUIO::TuioCursor(-1, -1, -1.0f, -1.0f);
-        std::mutex _mx;
+        /**
+        * Adds an event to the queue that is read in getInput. Must only be called from
+        * the TUIO thread
+        */
+        void pushEvent(TouchEvent::Type type, TUIO::TuioCursor* tcur);
 
         TUIO::TuioClient *_tuioClient;
         TUIO::OscReceiver *_oscReceiver;
 
+        // Single-producer/single-consumer ring buffer of events from the TUIO thread
+        static constexpr const size_t EventQueueCapacity = 512;
+        std::array<TouchEvent, EventQueueCapacity> _events;
+        std::atomic<size_t> _eventsWritten = { 0 };
+        std::atomic<size_t> _eventsRead = { 0 };
+
+        // Only accessed from the TUIO thread, used to detect taps
+        int _nActiveCursors = 0;
+        bool _isSingleTouch = false;
+
+        // Only accessed from the main thread
+        bool _tap = false;
+        TUIO::TuioCursor _tapCo = TUIO::TuioCursor(-1, -1, -1.0f, -1.0f);
+
         std::vector<TUIO::TuioCursor> _list;
 
         /**
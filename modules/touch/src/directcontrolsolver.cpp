@@ -0,0 +1,261 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/touch/include/directcontrolsolver.h>
+
+#include <ghoul/misc/assert.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <algorithm>
+
+namespace {
+    using openspace::directcontrol::Jet;
+
+    template <typename T>
+    struct Vec {
+        T x;
+        T y;
+        T z;
+    };
+
+    template <typename T>
+    struct Quat {
+        T w;
+        T x;
+        T y;
+        T z;
+    };
+
+    template <typename T>
+    Vec<T> toVec(const glm::dvec3& v) {
+        return { T(v.x), T(v.y), T(v.z) };
+    }
+
+    template <typename T>
+    Quat<T> toQuat(const glm::dquat& q) {
+        return { T(q.w), T(q.x), T(q.y), T(q.z) };
+    }
+
+    template <typename T>
+    Vec<T> operator+(const Vec<T>& lhs, const Vec<T>& rhs) {
+        return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z };
+    }
+
+    template <typename T>
+    Vec<T> operator-(const Vec<T>& lhs, const Vec<T>& rhs) {
+        return { lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z };
+    }
+
+    template <typename T>
+    Vec<T> operator*(const Vec<T>& lhs, const T& rhs) {
+        return { lhs.x * rhs, lhs.y * rhs, lhs.z * rhs };
+    }
+
+    template <typename T>
+    T dot(const Vec<T>& lhs, const Vec<T>& rhs) {
+        return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+    }
+
+    template <typename T>
+    Vec<T> cross(const Vec<T>& lhs, const Vec<T>& rhs) {
+        return {
+            lhs.y * rhs.z - lhs.z * rhs.y,
+            lhs.z * rhs.x - lhs.x * rhs.z,
+            lhs.x * rhs.y - lhs.y * rhs.x
+        };
+    }
+
+    template <typename T>
+    Vec<T> normalize(const Vec<T>& v) {
+        const T invLength = T(1.0) / sqrt(dot(v, v));
+        return v * invLength;
+    }
+
+    template <typename T>
+    Quat<T> operator*(const Quat<T>& lhs, const Quat<T>& rhs) {
+        return {
+            lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
+            lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+            lhs.w * rhs.y + lhs.y * rhs.w + lhs.z * rhs.x - lhs.x * rhs.z,
+            lhs.w * rhs.z + lhs.z * rhs.w + lhs.x * rhs.y - lhs.y * rhs.x
+        };
+    }
+
+    template <typename T>
+    Quat<T> conjugate(const Quat<T>& q) {
+        return { q.w, -q.x, -q.y, -q.z };
+    }
+
+    // Rotates v by the unit quaternion q
+    template <typename T>
+    Vec<T> rotate(const Quat<T>& q, const Vec<T>& v) {
+        const Vec<T> axis = { q.x, q.y, q.z };
+        const Vec<T> t = cross(axis, v) * T(2.0);
+        return v + t * q.w + cross(axis, t);
+    }
+
+    // Equivalent to glm::dquat(glm::dvec3(pitch, yaw, 0.0))
+    template <typename T>
+    Quat<T> fromPitchYaw(const T& pitch, const T& yaw) {
+        const T cx = cos(pitch * 0.5);
+        const T sx = sin(pitch * 0.5);
+        const T cy = cos(yaw * 0.5);
+        const T sy = sin(yaw * 0.5);
+        return { cx * cy, sx * cy, cx * sy, -(sx * sy) };
+    }
+
+    // Equivalent to glm::angleAxis(angle, glm::dvec3(0.0, 0.0, 1.0))
+    template <typename T>
+    Quat<T> fromRoll(const T& angle) {
+        return { cos(angle * 0.5), T(0.0), T(0.0), sin(angle * 0.5) };
+    }
+
+    /**
+     * The camera transformation of direct-manipulation as a function of the parameters
+     * { vec2 globalRot, zoom, roll, vec2 localRot }. The parameters are applied in the
+     * same order and with the same conventions as in TouchInteraction::step.
+     */
+    template <int NDOF>
+    struct CameraModel {
+        explicit CameraModel(const openspace::directcontrol::Problem& problem);
+
+        std::array<Jet<NDOF>, NDOF> operator()(
+            const std::array<Jet<NDOF>, NDOF>& par) const;
+
+        const openspace::directcontrol::Problem& problem;
+        glm::dvec3 centerToCamera;
+        glm::dquat globalRotation;
+        glm::dquat localRotation;
+        glm::dvec3 lookUpWhenFacingCenter;
+        glm::dmat4 projection;
+    };
+
+    template <int NDOF>
+    CameraModel<NDOF>::CameraModel(const openspace::directcontrol::Problem& p)
+        : problem(p)
+        , centerToCamera(p.cameraPosition - p.nodePosition)
+        , projection(p.projectionMatrix)
+    {
+        // Make a representation of the rotation quaternion with local and global
+        // rotations
+        const glm::dvec3 directionToCenter = glm::normalize(-centerToCamera);
+        const glm::dmat4 lookAtMat = glm::lookAt(
+            glm::dvec3(0.0),
+            directionToCenter,
+            // To avoid problem with lookup in up direction
+            glm::normalize(p.cameraViewDirectionWorldSpace + p.cameraLookUpWorldSpace)
+        );
+        globalRotation = glm::normalize(glm::quat_cast(glm::inverse(lookAtMat)));
+        localRotation = glm::inverse(globalRotation) * p.cameraRotation;
+        lookUpWhenFacingCenter = globalRotation * p.cameraLookUpCameraSpace;
+    }
+
+    template <int NDOF>
+    std::array<Jet<NDOF>, NDOF> CameraModel<NDOF>::operator()(
+                                            const std::array<Jet<NDOF>, NDOF>& par) const
+    {
+        using T = Jet<NDOF>;
+        auto q = [&par](int i) { return i < NDOF ? par[i] : T(0.0); };
+
+        const Vec<T> center = toVec<T>(problem.nodePosition);
+        const Quat<T> globalRot = toQuat<T>(globalRotation);
+
+        // Orbit (global rotation)
+        const Quat<T> orbit = fromPitchYaw(q(1), q(0));
+        const Quat<T> orbitWorldSpace =
+            globalRot * conjugate(orbit) * conjugate(globalRot);
+        Vec<T> camPos = center + rotate(orbitWorldSpace, toVec<T>(centerToCamera));
+
+        // The new global rotation is the lookAt towards the center, whose inverse has the
+        // columns (side, up, -direction)
+        const Vec<T> direction = normalize(center - camPos);
+        const Vec<T> side = normalize(cross(direction, toVec<T>(lookUpWhenFacingCenter)));
+        const Vec<T> up = cross(side, direction);
+
+        // Zooming
+        camPos = camPos + direction * q(2);
+
+        // Roll and panning (local rotation)
+        const Quat<T> localRot = toQuat<T>(localRotation) * fromRoll(q(3)) *
+                                 fromPitchYaw(q(5), q(4));
+        const Quat<T> inverseLocalRot = conjugate(localRot);
+
+        // Project the surface points with the new camera state; the residuals are the
+        // distances in x and y to the screen points they should end up at
+        const glm::dmat4& m = projection;
+        std::array<T, NDOF> res;
+        for (int i = 0; i < NDOF / 2; ++i) {
+            const Vec<T> v = toVec<T>(problem.surfacePoints[i]) - camPos;
+            const Vec<T> p = rotate(
+                inverseLocalRot,
+                Vec<T>{ dot(side, v), dot(up, v), -dot(direction, v) }
+            );
+            const T clipX = p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0];
+            const T clipY = p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1];
+            const T clipW = p.x * m[0][3] + p.y * m[1][3] + p.z * m[2][3] + m[3][3];
+            res[2 * i] = clipX / clipW - problem.screenPoints[i].x;
+            res[2 * i + 1] = clipY / clipW - problem.screenPoints[i].y;
+        }
+        return res;
+    }
+
+    template <int NDOF>
+    openspace::directcontrol::Solution solveFixed(
+                                         const openspace::directcontrol::Problem& problem)
+    {
+        openspace::directcontrol::Solution solution;
+        solution.nDOF = NDOF;
+
+        std::array<double, NDOF> par;
+        std::copy_n(problem.initialParameters.begin(), NDOF, par.begin());
+
+        solution.statistics = openspace::directcontrol::levenbergMarquardt<NDOF>(
+            par,
+            CameraModel<NDOF>(problem),
+            problem.recordIterations ? &solution.log : nullptr
+        );
+        std::copy(par.begin(), par.end(), solution.parameters.begin());
+        return solution;
+    }
+} // namespace
+
+namespace openspace::directcontrol {
+
+Solution solve(const Problem& problem) {
+    ghoul_assert(
+        problem.nContacts > 0 && problem.nContacts <= MaxContacts,
+        "Invalid number of contacts"
+    );
+
+    switch (problem.nContacts) {
+        case 1:
+            return solveFixed<2>(problem);
+        case 2:
+            return solveFixed<4>(problem);
+        default:
+            return solveFixed<6>(problem);
+    }
+}
+
+} // namespace openspace::directcontrol
@@ -52,6 +52,7 @@
 
 #include <cmath>
 #include <ghoul/fmt.h>
+#include <chrono>
 #include <functional>
 #include <fstream>
 
@@ -348,8 +349,6 @@ TouchInteraction::TouchInteraction()
         }
     });
 
-    levmarq_init(&_lmstat);
-
     _time.initSession();
 }
 
@@ -414,7 +413,7 @@ void TouchInteraction::updateStateFromInput(const std::vector<TuioCursor>& list,
 #endif
             directControl(list);
         }
-        if (_lmSuccess) {
+        else if (_lmSuccess) {
             findSelectedNode(list);
         }
 
@@ -492,232 +491,122 @@ void TouchInteraction::directControl(const std::vector<TuioCursor>& list) {
 #ifdef TOUCH_DEBUG_PROPERTIES
     LINFO("DirectControl");
 #endif
-    // Returns the screen point s(xi,par) dependent the transform M(par) and object
-    // point xi
-    auto distToMinimize = [](double* par, int x, void* fdata, LMstat* lmstat) {
-        FunctionData* ptr = reinterpret_cast<FunctionData*>(fdata);
-
-        // Apply transform to camera and find the new screen point of the updated camera
-        // state
-
-        // { vec2 globalRot, zoom, roll, vec2 localRot }
-        double q[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
-        for (int i = 0; i < ptr->nDOF; ++i) {
-            q[i] = par[i];
-        }
-
-        using namespace glm;
-        // Create variables from current state
-        dvec3 camPos = ptr->camera->positionVec3();
-        dvec3 centerPos = ptr->node->worldPosition();
-
-        dvec3 directionToCenter = normalize(centerPos - camPos);
-        dvec3 lookUp = ptr->camera->lookUpVectorWorldSpace();
-        dvec3 camDirection = ptr->camera->viewDirectionWorldSpace();
+    if (!collectDirectControlSolve(list)) {
+        return;
+    }
 
-        // Make a representation of the rotation quaternion with local and global
-        // rotations
-        dmat4 lookAtMat = lookAt(
-            dvec3(0, 0, 0),
-            directionToCenter,
-            // To avoid problem with lookup in up direction
-            normalize(camDirection + lookUp));
-        dquat globalCamRot = normalize(quat_cast(inverse(lookAtMat)));
-        dquat localCamRot = inverse(globalCamRot) * ptr->camera->rotationQuaternion();
+    directcontrol::Problem problem;
+    if (!createDirectControlProblem(list, problem)) {
+        global::moduleEngine.module<ImGUIModule>()->touchInput = {
+            true,
+            glm::dvec2(0.0, 0.0),
+            1
+        };
+        resetAfterInput();
+        return;
+    }
 
-        { // Roll
-            dquat rollRot = angleAxis(q[3], dvec3(0.0, 0.0, 1.0));
-            localCamRot = localCamRot * rollRot;
-        }
-        { // Panning (local rotation)
-            dvec3 eulerAngles(q[5], q[4], 0);
-            dquat panRot = dquat(eulerAngles);
-            localCamRot = localCamRot * panRot;
-        }
-        { // Orbit (global rotation)
-            dvec3 eulerAngles(q[1], q[0], 0);
-            dquat rotationDiffCamSpace = dquat(eulerAngles);
+    // finds best transform values for the new camera state on a worker thread, the
+    // problem is a copy so the camera and the selection can change in the meantime
+    _directControlSolve = std::async(std::launch::async, directcontrol::solve, problem);
+}
 
-            dvec3 centerToCamera = camPos - centerPos;
+void TouchInteraction::updateDirectControl(const std::vector<TuioCursor>& list) {
+    if (_directControlSolve.valid()) {
+        collectDirectControlSolve(list);
+    }
+}
 
-            dquat rotationDiffWorldSpace =
-                globalCamRot * rotationDiffCamSpace * inverse(globalCamRot);
-            dvec3 rotationDiffVec3 =
-                centerToCamera * rotationDiffWorldSpace - centerToCamera;
-            camPos += rotationDiffVec3;
+bool TouchInteraction::collectDirectControlSolve(const std::vector<TuioCursor>& list) {
+    if (!_directControlSolve.valid()) {
+        return true;
+    }
+    if (_directControlSolve.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready)
+    {
+        // Keep the selected surface points until the running solve has been applied
+        return false;
+    }
 
-            centerToCamera = camPos - centerPos;
-            directionToCenter = normalize(-centerToCamera);
-            dvec3 lookUpWhenFacingCenter =
-                globalCamRot * dvec3(ptr->camera->lookUpVectorCameraSpace());
-            lookAtMat = lookAt(
-                dvec3(0, 0, 0),
-                directionToCenter,
-                lookUpWhenFacingCenter);
-            globalCamRot = normalize(quat_cast(inverse(lookAtMat)));
-        }
-        { // Zooming
-            camPos += directionToCenter * q[2];
-        }
-        // Update the camera state
-        Camera cam = *(ptr->camera);
-        cam.setPositionVec3(camPos);
-        cam.setRotation(globalCamRot * localCamRot);
-
-        // we now have a new position and orientation of camera, project surfacePoint to
-        // the new screen to get distance to minimize
-        glm::dvec2 newScreenPoint = ptr->castToNDC(
-            ptr->selectedPoints.at(x),
-            cam,
-            ptr->node
-        );
-        lmstat->pos.push_back(newScreenPoint);
-        return glm::length(ptr->screenPoints.at(x) - newScreenPoint);
-    };
-    // Gradient of distToMinimize w.r.t par (using forward difference)
-    auto gradient = [](double* g, double* par, int x, void* fdata, LMstat* lmstat) {
-        FunctionData* ptr = reinterpret_cast<FunctionData*>(fdata);
-        double h, lastG, f1, f0 = ptr->distToMinimize(par, x, fdata, lmstat);
-         // scale value to find minimum step size h, dependant on planet size
-        double scale = log10(ptr->node->boundingSphere());
-        std::vector<double> dPar(ptr->nDOF, 0.0);
-        dPar.assign(par, par + ptr->nDOF);
-
-        for (int i = 0; i < ptr->nDOF; ++i) {
-            // Initial values
-            h = 1e-8;
-            lastG = 1;
-            dPar.at(i) += h;
-            f1 = ptr->distToMinimize(dPar.data(), x, fdata, lmstat);
-            dPar.at(i) = par[i];
-            // Iterative process to find the minimum step h that gives a good gradient
-            for (int j = 0; j < 100; ++j) {
-                if ((f1 - f0) != 0 && lastG == 0) { // found minimum step size h
-                    // scale up to get a good initial guess value
-                    h *= scale * scale * scale;
-
-                    // clamp min step size to a fraction of the incoming parameter
-                    if (i == 2) {
-                        double epsilon = 1e-3;
-                        // make sure incoming parameter is larger than 0
-                        h = std::max(std::max(std::abs(dPar.at(i)), epsilon) * 0.001, h);
-                    }
-                    else if (ptr->nDOF == 2) {
-                        h = std::max(std::abs(dPar.at(i)) * 0.001, h);
-                    }
+    const directcontrol::Solution solution = _directControlSolve.get();
+    if (_discardDirectControlSolve) {
+        _discardDirectControlSolve = false;
+        return true;
+    }
 
-                    // calculate f1 with good h for finite difference
-                    dPar.at(i) += h;
-                    f1 = ptr->distToMinimize(dPar.data(), x, fdata, lmstat);
-                    dPar.at(i) = par[i];
-                    break;
-                }
-                else if ((f1 - f0) != 0 && lastG != 0) { // h too big
-                    h /= scale;
-                }
-                else if ((f1 - f0) == 0) { // h too small
-                    h *= scale;
-                }
-                lastG = f1 - f0;
-                dPar.at(i) += h;
-                f1 = ptr->distToMinimize(dPar.data(), x, fdata, lmstat);
-                dPar.at(i) = par[i];
-            }
-            g[i] = (f1 - f0) / h;
-        }
-        if (ptr->nDOF == 2) {
-             // normalize on 1 finger case to allow for horizontal/vertical movement
-            for (int i = 0; i < 2; ++i) {
-                g[i] = g[i]/std::abs(g[i]);
-            }
-        }
-        else if (ptr->nDOF == 6) {
-            for (int i = 0; i < ptr->nDOF; ++i) {
-                 // lock to only pan and zoom on 3 finger case, no roll/orbit
-                g[i] = (i == 2) ? g[i] : g[i] / std::abs(g[i]);
-            }
-        }
-    };
+    applyDirectControlSolution(solution);
+    if (!_lmSuccess) {
+        return false;
+    }
 
-    // project back a 3D point in model view to clip space [-1,1] coordinates on the view
-    // plane
-    auto castToNDC = [](const glm::dvec3& vec, Camera& camera, SceneGraphNode* node) {
-        glm::dvec3 posInCamSpace = glm::inverse(camera.rotationQuaternion()) *
-            (node->rotationMatrix() * vec +
-            (node->worldPosition() - camera.positionVec3()));
+    // Select the surface points under the current contact points, so that the next
+    // solve starts from the camera state that was just set
+    findSelectedNode(list);
+    return !_selected.empty() && list.size() == _selected.size();
+}
 
-        glm::dvec4 clipspace = camera.projectionMatrix() * glm::dvec4(posInCamSpace, 1.0);
-        return (glm::dvec2(clipspace) / clipspace.w);
-    };
+bool TouchInteraction::createDirectControlProblem(const std::vector<TuioCursor>& list,
+                                                  directcontrol::Problem& problem) const
+{
+    if (_selected.empty()) {
+        return false;
+    }
 
     // only send in first three fingers (to make it easier for LMA to converge on 3+
     // finger case with only zoom/pan)
-    int nFingers = std::min(static_cast<int>(list.size()), 3);
-    int nDOF = std::min(nFingers * 2, 6);
-    std::vector<double> par(nDOF, 0.0);
-    par.at(0) = _lastVel.orbit.x; // use _lastVel for orbit
-    par.at(1) = _lastVel.orbit.y;
+    problem.nContacts = std::min(
+        static_cast<int>(std::min(list.size(), _selected.size())),
+        directcontrol::MaxContacts
+    );
+    problem.initialParameters[0] = _lastVel.orbit.x; // use _lastVel for orbit
+    problem.initialParameters[1] = _lastVel.orbit.y;
 
     // Parse input data to be used in the LM algorithm
-    std::vector<glm::dvec3> selectedPoints;
-    std::vector<glm::dvec2> screenPoints;
-    for (int i = 0; i < nFingers; ++i) {
+    const SceneGraphNode* node = _selected.at(0).node;
+    for (int i = 0; i < problem.nContacts; ++i) {
         const SelectedBody& sb = _selected.at(i);
-        selectedPoints.push_back(sb.coordinates);
+        problem.surfacePoints[i] =
+            node->rotationMatrix() * sb.coordinates + node->worldPosition();
 
         std::vector<TuioCursor>::const_iterator c = std::find_if(
             list.begin(),
             list.end(),
             [&sb](const TuioCursor& c) { return c.getSessionID() == sb.id; }
         );
-        if (c != list.end()) {
-             // normalized -1 to 1 coordinates on screen
-            screenPoints.emplace_back(2 * (c->getX() - 0.5), -2 * (c->getY() - 0.5));
-        } else {
-            global::moduleEngine.module<ImGUIModule>()->touchInput = {
-                true,
-                glm::dvec2(0.0, 0.0),
-                1
-            };
-            resetAfterInput();
-            return;
+        if (c == list.end()) {
+            return false;
         }
+        // normalized -1 to 1 coordinates on screen
+        problem.screenPoints[i] = glm::dvec2(
+            2 * (c->getX() - 0.5),
+            -2 * (c->getY() - 0.5)
+        );
     }
 
-    FunctionData fData = {
-        selectedPoints,
-        screenPoints,
-        nDOF,
-        castToNDC,
-        distToMinimize,
-        _camera,
-        _selected.at(0).node,
-        _lmstat,
-        _currentRadius
-    };
-    void* dataPtr = reinterpret_cast<void*>(&fData);
-
-    // finds best transform values for the new camera state and stores them in par
-    _lmSuccess = levmarq(
-        nDOF,
-        par.data(),
-        static_cast<int>(screenPoints.size()),
-        nullptr,
-        distToMinimize,
-        gradient,
-        dataPtr,
-        &_lmstat
-    );
+    problem.cameraPosition = _camera->positionVec3();
+    problem.cameraRotation = _camera->rotationQuaternion();
+    problem.cameraLookUpCameraSpace = _camera->lookUpVectorCameraSpace();
+    problem.cameraLookUpWorldSpace = _camera->lookUpVectorWorldSpace();
+    problem.cameraViewDirectionWorldSpace = _camera->viewDirectionWorldSpace();
+    problem.projectionMatrix = glm::dmat4(_camera->projectionMatrix());
+    problem.nodePosition = node->worldPosition();
+    return true;
+}
 
-    if (_lmSuccess && !_unitTest) {
+void TouchInteraction::applyDirectControlSolution(
+                                                const directcontrol::Solution& solution)
+{
+    _lmSuccess = solution.statistics.success;
+    if (_lmSuccess) {
+        const std::array<double, directcontrol::MaxDOF>& par = solution.parameters;
          // if good values were found set new camera state
-        _vel.orbit = glm::dvec2(par.at(0), par.at(1));
-        if (nDOF > 2) {
-            _vel.zoom = par.at(2);
-            _vel.roll = par.at(3);
-            if (_panEnabled && nDOF > 4) {
+        _vel.orbit = glm::dvec2(par[0], par[1]);
+        if (solution.nDOF > 2) {
+            _vel.zoom = par[2];
+            _vel.roll = par[3];
+            if (_panEnabled && solution.nDOF > 4) {
                 _vel.roll = 0.0;
-                _vel.pan = glm::dvec2(par.at(4), par.at(5));
+                _vel.pan = glm::dvec2(par[4], par[5]);
             }
         }
         step(1.0);
@@ -1377,8 +1266,6 @@ void TouchInteraction::step(double dt) {
 
 void TouchInteraction::unitTest() {
     if (_unitTest) {
-        _lmstat.verbose = true;
-
         // set _selected pos and new pos (on screen)
         std::vector<TuioCursor> lastFrame = {
             { TuioCursor(0, 10, 0.45f, 0.4f) }, // session id, cursor id, x, y
@@ -1389,16 +1276,21 @@ void TouchInteraction::unitTest() {
             { TuioCursor(1, 11, 0.8f, 0.4f) } // (0.6, 0.2)
         };
 
-        // call update
+        // solve synchronously, recording every iteration of the solver
         findSelectedNode(lastFrame);
-        directControl(currFrame);
+        directcontrol::Solution solution;
+        directcontrol::Problem problem;
+        if (createDirectControlProblem(currFrame, problem)) {
+            problem.recordIterations = true;
+            solution = directcontrol::solve(problem);
+        }
 
-        // save lmstats.data into a file and clear it
+        // save the solver log into a file and clear it
         char buffer[32];
         snprintf(buffer, sizeof(char) * 32, "lmdata%i.csv", _numOfTests);
         _numOfTests++;
         std::ofstream file(buffer);
-        file << _lmstat.data;
+        file << solution.log;
 
         // clear everything
         _selected.clear();
@@ -1477,6 +1369,8 @@ void TouchInteraction::resetAfterInput() {
     }
 
     _lmSuccess = true;
+    // A running direct-manipulation solve belongs to the selection that is cleared below
+    _discardDirectControlSolve = _directControlSolve.valid();
     // Ensure that _guiON is consistent with properties in OnScreenGUI and
     _guiON = module.gui.isEnabled();
 
@@ -31,6 +31,7 @@
 #include <openspace/rendering/screenspacerenderable.h>
 
 #include <ghoul/logging/logmanager.h>
+#include <thread>
 
 using namespace TUIO;
 
@@ -41,69 +42,46 @@ void TuioEar::updateTuioObject(TuioObject*) { }
 void TuioEar::removeTuioObject(TuioObject*) { }
 
 void TuioEar::addTuioCursor(TuioCursor* tcur) {
-    _mx.lock();
-    _tap = false;
-    // find same id in _list if it exists in _removeList (new input with same ID as a
-    // previously stored)
-    long i = tcur->getSessionID();
-    std::vector<long>::iterator foundID = std::find_if(
-        _removeList.begin(),
-        _removeList.end(),
-        [&i](long id) { return id == i; });
-
-    // if found, remove id from _removeList and update, otherwise add new id to list
-    if (foundID != _removeList.end()) {
-        std::find_if(
-            _list.begin(),
-            _list.end(),
-            [&i](const TuioCursor& cursor) {
-                return cursor.getSessionID() == i;
-            }
-        )->update(tcur);
-        _removeList.erase(foundID);
+    ++_nActiveCursors;
+    if (_nActiveCursors == 1) {
+        _isSingleTouch = true;
     }
     else {
-        _list.emplace_back(*tcur);
+        _isSingleTouch = false;
     }
-    _mx.unlock();
+    pushEvent(TouchEvent::Type::Added, tcur);
 }
 
 void TuioEar::updateTuioCursor(TuioCursor* tcur) {
-    _mx.lock();
-    _tap = false;
-    long i = tcur->getSessionID();
-    std::find_if(
-        _list.begin(),
-        _list.end(),
-        [&i](const TuioCursor& cursor) {
-            return cursor.getSessionID() == i;
-        }
-    )->update(tcur);
-    _mx.unlock();
+    pushEvent(TouchEvent::Type::Updated, tcur);
 }
 
 // save id to be removed and remove it in clearInput
 void TuioEar::removeTuioCursor(TuioCursor* tcur) {
-    _mx.lock();
-    _removeList.push_back(tcur->getSessionID());
+    pushEvent(TouchEvent::Type::Removed, tcur);
+
+    const bool wasSingleTouch = _isSingleTouch && _nActiveCursors == 1;
+    _nActiveCursors = std::max(_nActiveCursors - 1, 0);
+    if (!wasSingleTouch) {
+        return;
+    }
 
     // Check if the cursor ID could be considered a tap
+    const std::list<TuioPoint> path = tcur->getPath();
     glm::dvec2 currPos = glm::dvec2(tcur->getX(), tcur->getY());
     double dist = 0;
-    for (const TuioPoint& p : tcur->getPath()) {
+    for (const TuioPoint& p : path) {
         dist += glm::length(glm::dvec2(p.getX(), p.getY()) - currPos);
     }
-    dist /= tcur->getPath().size();
+    dist /= path.size();
 
     double heldTime =
-        tcur->getPath().back().getTuioTime().getTotalMilliseconds() -
-        tcur->getPath().front().getTuioTime().getTotalMilliseconds();
+        path.back().getTuioTime().getTotalMilliseconds() -
+        path.front().getTuioTime().getTotalMilliseconds();
 
-    if (heldTime < 180 && dist < 0.0004 && _list.size() == 1 && _removeList.size() == 1) {
-        _tapCo = TuioCursor(*tcur);
-        _tap = true;
+    if (heldTime < 180 && dist < 0.0004) {
+        pushEvent(TouchEvent::Type::Tap, tcur);
     }
-    _mx.unlock();
 }
 
 void TuioEar::addTuioBlob(TuioBlob*) { }
@@ -114,7 +92,86 @@ void TuioEar::removeTuioBlob(TuioBlob*) { }
 
 void TuioEar::refresh(TuioTime) { } // about every 15ms
 
-std::vector<TuioCursor> TuioEar::getInput() {
+void TuioEar::pushEvent(TouchEvent::Type type, TuioCursor* tcur) {
+    const size_t written = _eventsWritten.load(std::memory_order_relaxed);
+    while (written - _eventsRead.load(std::memory_order_acquire) == EventQueueCapacity) {
+        // The main thread has fallen behind. Waiting here only stalls the TUIO thread,
+        // whereas dropping the event could lose the addition or removal of a cursor
+        std::this_thread::yield();
+    }
+
+    const TuioTime time = tcur->getTuioTime();
+    _events[written % EventQueueCapacity] = {
+        type,
+        tcur->getCursorID(),
+        tcur->getSessionID(),
+        tcur->getX(),
+        tcur->getY(),
+        tcur->getXSpeed(),
+        tcur->getYSpeed(),
+        tcur->getMotionAccel(),
+        time.getSeconds(),
+        time.getMicroseconds()
+    };
+    _eventsWritten.store(written + 1, std::memory_order_release);
+}
+
+const std::vector<TuioCursor>& TuioEar::getInput() {
+    const size_t written = _eventsWritten.load(std::memory_order_acquire);
+    size_t read = _eventsRead.load(std::memory_order_relaxed);
+    for (; read != written; ++read) {
+        const TouchEvent& e = _events[read % EventQueueCapacity];
+        const TuioTime time(e.seconds, e.microseconds);
+
+        std::vector<TuioCursor>::iterator cursor = std::find_if(
+            _list.begin(),
+            _list.end(),
+            [&e](const TuioCursor& c) { return c.getSessionID() == e.sessionId; }
+        );
+
+        switch (e.type) {
+            case TouchEvent::Type::Added:
+            {
+                _tap = false;
+                // find same id in _list if it exists in _removeList (new input with same
+                // ID as a previously stored)
+                std::vector<long>::iterator foundID = std::find(
+                    _removeList.begin(),
+                    _removeList.end(),
+                    e.sessionId
+                );
+                if (foundID != _removeList.end()) {
+                    _removeList.erase(foundID);
+                }
+
+                // if found, update the existing cursor, otherwise add new id to list
+                if (cursor != _list.end()) {
+                    cursor->update(time, e.x, e.y, e.xSpeed, e.ySpeed, e.motionAccel);
+                }
+                else {
+                    _list.emplace_back(time, e.sessionId, e.cursorId, e.x, e.y);
+                }
+                break;
+            }
+            case TouchEvent::Type::Updated:
+                _tap = false;
+                if (cursor != _list.end()) {
+                    cursor->update(time, e.x, e.y, e.xSpeed, e.ySpeed, e.motionAccel);
+                }
+                break;
+            case TouchEvent::Type::Removed:
+                _removeList.push_back(e.sessionId);
+                break;
+            case TouchEvent::Type::Tap:
+                // Only a tap if no other cursor is left from the previous frame
+                if (_list.size() == 1 && _removeList.size() == 1) {
+                    _tapCo = TuioCursor(time, e.sessionId, e.cursorId, e.x, e.y);
+                    _tap = true;
+                }
+                break;
+        }
+    }
+    _eventsRead.store(read, std::memory_order_release);
     return _list;
 }
 
@@ -129,13 +186,11 @@ bool TuioEar::tap() {
 }
 
 TuioCursor TuioEar::getTap() {
-    std::lock_guard<std::mutex> lock(_mx);
     return _tapCo;
 }
 
 // Removes all cursor ID from list that exists in _removeList
 void TuioEar::clearInput() {
-    _mx.lock();
     _list.erase(
         std::remove_if(
             _list.begin(),
@@ -153,7 +208,6 @@ void TuioEar::clearInput() {
         _list.end()
     );
     _removeList.clear();
-    _mx.unlock();
 }
 
 // Standard UDP IP connection to port 3333
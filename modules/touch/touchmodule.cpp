@@ -72,7 +72,10 @@ bool TouchModule::hasNewInput() {
     if (listOfContactPoints.empty() && lastProcessed.empty() && ear.tap()) {
         TuioCursor c = ear.getTap();
         listOfContactPoints.push_back(c);
-        lastProcessed.emplace_back(c.getSessionID(), c.getPath().back());
+        lastProcessed.emplace_back(
+            c.getSessionID(),
+            TuioPoint(c.getTuioTime(), c.getX(), c.getY())
+        );
         touch.tap();
         return true;
     }
@@ -96,7 +99,7 @@ bool TouchModule::hasNewInput() {
                     listOfContactPoints.end(),
                     [&p](const TuioCursor& c) { return c.getSessionID() == p.first; }
             );
-            double now = cursor->getPath().back().getTuioTime().getTotalMilliseconds();
+            double now = cursor->getTuioTime().getTotalMilliseconds();
             if (!cursor->isMoving()) {
                  // if current cursor isn't moving, we want to interpret that as new input
                  // for interaction purposes
@@ -168,11 +171,17 @@ TouchModule::TouchModule()
         else if (listOfContactPoints.empty()) {
             touch.resetAfterInput();
         }
+        else if (global::windowDelegate.isMaster()) {
+            touch.updateDirectControl(listOfContactPoints);
+        }
 
         // update lastProcessed
         lastProcessed.clear();
         for (const TuioCursor& c : listOfContactPoints) {
-            lastProcessed.emplace_back(c.getSessionID(), c.getPath().back());
+            lastProcessed.emplace_back(
+                c.getSessionID(),
+                TuioPoint(c.getTuioTime(), c.getX(), c.getY())
+            );
         }
         // used to save data from solver, only calculated for one frame when user chooses
         // in GUI
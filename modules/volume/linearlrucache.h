@@ -27,11 +27,17 @@
 
 //#include <modules/volume/lrucache.h>
 #include <ghoul/glm.h>
-#include <list>
-#include <iterator>
+#include <cstddef>
+#include <utility>
+#include <vector>
 
 namespace openspace::volume {
 
+/**
+ * A least-recently-used cache for the keys <code>0</code> to <code>nIndices - 1</code>.
+ * The recency order is kept as a list that is linked through the indices of the keys,
+ * so that using or replacing a value never allocates.
+ */
 template <typename ValueType>
 class LinearLruCache {
 public:
@@ -47,10 +53,25 @@ public:
     size_t capacity() const;
 
 private:
-    void insert(size_t key, const ValueType& value);
+    static constexpr const size_t Nil = static_cast<size_t>(-1);
 
-    std::list<size_t> _tracker;
-    std::vector<std::pair<ValueType, typename std::list<size_t>::iterator>> _cache;
+    struct Node {
+        ValueType value;
+        size_t previous = Nil;
+        size_t next = Nil;
+        bool isCached = false;
+    };
+
+    void insert(size_t key, ValueType value);
+    void unlink(size_t key);
+    void linkBack(size_t key);
+
+    std::vector<Node> _cache;
+    /// The least recently used key
+    size_t _front = Nil;
+    /// The most recently used key
+    size_t _back = Nil;
+    size_t _size = 0;
     size_t _capacity;
 };
 
@@ -26,46 +26,49 @@ namespace openspace::volume {
 
 template <typename ValueType>
 LinearLruCache<ValueType>::LinearLruCache(size_t capacity, size_t nIndices)
-    : _tracker()
-    , _cache(nIndices, { nullptr, _tracker.end() })
+    : _cache(nIndices)
     , _capacity(capacity)
 {}
 
 template <typename ValueType>
 bool LinearLruCache<ValueType>::has(size_t key) const {
-    return _cache[key].first != nullptr;
+    return _cache[key].isCached;
 }
 
 template <typename ValueType>
 void LinearLruCache<ValueType>::set(size_t key, ValueType value) {
-    auto prev = _cache[key];
-    if (prev.first != nullptr) {
-        prev.first = value;
-        const std::list<size_t>::iterator trackerIter = prev.second;
-        _tracker.splice(_tracker.end(), _tracker, trackerIter);
+    Node& node = _cache[key];
+    if (node.isCached) {
+        node.value = std::move(value);
+        unlink(key);
+        linkBack(key);
     }
     else {
-        insert(key, value);
+        insert(key, std::move(value));
     }
 }
 
 template <typename ValueType>
 ValueType& LinearLruCache<ValueType>::use(size_t key) {
-    auto& pair = _cache[key];
-    const std::list<size_t>::iterator trackerIter = pair.second;
-    _tracker.splice(_tracker.end(), _tracker, trackerIter);
-    return pair.first;
+    if (_cache[key].isCached) {
+        unlink(key);
+        linkBack(key);
+    }
+    return _cache[key].value;
 }
 
 template <typename ValueType>
 ValueType& LinearLruCache<ValueType>::get(size_t key) {
-    return _cache[key].first;
+    return _cache[key].value;
 }
 
 template <typename ValueType>
 void LinearLruCache<ValueType>::evict() {
-    _cache[_tracker.front()] = make_pair(nullptr, _tracker.end());
-    _tracker.pop_front();
+    const size_t key = _front;
+    unlink(key);
+    _cache[key].value = ValueType();
+    _cache[key].isCached = false;
+    _size--;
 }
 
 template <typename ValueType>
@@ -74,12 +77,48 @@ size_t LinearLruCache<ValueType>::capacity() const {
 }
 
 template <typename ValueType>
-void LinearLruCache<ValueType>::insert(size_t key, const ValueType& value) {
-    if (_tracker.size() == _capacity) {
+void LinearLruCache<ValueType>::insert(size_t key, ValueType value) {
+    if (_size == _capacity) {
         evict();
     }
-    auto iter = _tracker.insert(_tracker.end(), key);
-    _cache[key] = { value, iter };
+    _cache[key].value = std::move(value);
+    _cache[key].isCached = true;
+    linkBack(key);
+    _size++;
+}
+
+template <typename ValueType>
+void LinearLruCache<ValueType>::unlink(size_t key) {
+    Node& node = _cache[key];
+    if (node.previous != Nil) {
+        _cache[node.previous].next = node.next;
+    }
+    else {
+        _front = node.next;
+    }
+
+    if (node.next != Nil) {
+        _cache[node.next].previous = node.previous;
+    }
+    else {
+        _back = node.previous;
+    }
+    node.previous = Nil;
+    node.next = Nil;
+}
+
+template <typename ValueType>
+void LinearLruCache<ValueType>::linkBack(size_t key) {
+    Node& node = _cache[key];
+    node.previous = _back;
+    node.next = Nil;
+    if (_back != Nil) {
+        _cache[_back].next = key;
+    }
+    _back = key;
+    if (_front == Nil) {
+        _front = key;
+    }
 }
 
 } // namespace openspace::volume
@@ -41,6 +41,10 @@ namespace {
     constexpr const char* KeyValueUnit = "ValueUnit";
 
     constexpr const char* KeyGridType = "GridType";
+
+    constexpr const char* KeyBitsPerVoxel = "BitsPerVoxel";
+    constexpr const char* KeyValueOffset = "ValueOffset";
+    constexpr const char* KeyValueScale = "ValueScale";
 } // namespace
 
 namespace openspace::volume {
@@ -56,6 +60,9 @@ RawVolumeMetadata RawVolumeMetadata::createFromDictionary(
 
     RawVolumeMetadata metadata;
     metadata.dimensions = dictionary.value<glm::vec3>(KeyDimensions);
+    if (dictionary.hasValue<std::string>(KeyGridType)) {
+        metadata.gridType = parseGridType(dictionary.value<std::string>(KeyGridType));
+    }
 
     metadata.hasDomainBounds = dictionary.hasValue<glm::vec3>(KeyLowerDomainBound) &&
             dictionary.hasValue<glm::vec3>(KeyUpperDomainBound);
@@ -87,6 +94,15 @@ RawVolumeMetadata RawVolumeMetadata::createFromDictionary(
         metadata.time = Time::convertTime(timeString);
     }
 
+    metadata.hasQuantization = dictionary.hasValue<double>(KeyBitsPerVoxel);
+    if (metadata.hasQuantization) {
+        metadata.bitsPerVoxel = static_cast<int>(
+            dictionary.value<double>(KeyBitsPerVoxel)
+        );
+        metadata.valueOffset = dictionary.value<float>(KeyValueOffset);
+        metadata.valueScale = dictionary.value<float>(KeyValueScale);
+    }
+
     return metadata;
 }
 
@@ -119,6 +135,12 @@ ghoul::Dictionary RawVolumeMetadata::dictionary() {
         }
         dict.setValue<std::string>(KeyTime, timeString);
     }
+
+    if (hasQuantization) {
+        dict.setValue<double>(KeyBitsPerVoxel, bitsPerVoxel);
+        dict.setValue<double>(KeyValueOffset, valueOffset);
+        dict.setValue<double>(KeyValueScale, valueScale);
+    }
     return dict;
 }
 
@@ -175,6 +197,27 @@ documentation::Documentation RawVolumeMetadata::Documentation() {
                 new DoubleVerifier,
                 Optional::Yes,
                 "Specifies the maximum value stored in the volume"
+            },
+            {
+                KeyBitsPerVoxel,
+                new IntInListVerifier({ 8, 16 }),
+                Optional::Yes,
+                "Specifies the number of bits per voxel of a quantized volume. If this "
+                "value is specified, the ValueOffset and ValueScale have to be "
+                "specified as well"
+            },
+            {
+                KeyValueOffset,
+                new DoubleVerifier,
+                Optional::Yes,
+                "Specifies the value that a quantized voxel of 0 represents"
+            },
+            {
+                KeyValueScale,
+                new DoubleVerifier,
+                Optional::Yes,
+                "Specifies the difference between the values that the largest and the "
+                "smallest quantized voxel represent"
             }
         }
     };
@@ -39,7 +39,7 @@ struct RawVolumeMetadata {
     ghoul::Dictionary dictionary();
 
     glm::uvec3 dimensions;
-    VolumeGridType gridType;
+    VolumeGridType gridType = VolumeGridType::Cartesian;
 
     bool hasTime;
     double time;
@@ -55,6 +55,14 @@ struct RawVolumeMetadata {
     glm::vec3 upperDomainBound;
     bool hasDomainUnit;
     std::string domainUnit;
+
+    // Quantized volumes store each value v as the normalized unsigned integer
+    // (v - valueOffset) / valueScale with bitsPerVoxel bits. Unquantized volumes store
+    // 32-bit floating point values
+    bool hasQuantization = false;
+    int bitsPerVoxel = 32;
+    float valueOffset = 0.f;
+    float valueScale = 1.f;
 };
 
 } // namespace openspace::volume
@@ -36,12 +36,16 @@
 #include <modules/volume/transferfunctionhandler.h>
 #include <modules/volume/rendering/volumeclipplanes.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
 
 namespace {
     constexpr const char* GlslRaycastPath = "${MODULE_VOLUME}/shaders/raycast.glsl";
     constexpr const char* GlslHelperPath = "${MODULE_VOLUME}/shaders/helper.glsl";
     constexpr const char* GlslBoundsVsPath = "${MODULE_VOLUME}/shaders/boundsvs.glsl";
     constexpr const char* GlslBoundsFsPath = "${MODULE_VOLUME}/shaders/boundsfs.glsl";
+
+    // The number of bins along each axis of the occupancy lookup table
+    constexpr const int OccupancyTableSize = 256;
 } // namespace
 
 namespace openspace::volume {
@@ -123,6 +127,17 @@ void BasicVolumeRaycaster::preRaycast(const RaycastData& data,
     _transferFunction->texture().bind();
     program.setUniform("transferFunction_" + id, _tfUnit->unitNumber());
 
+    _preintegrationUnit = std::make_unique<ghoul::opengl::TextureUnit>();
+    if (_usePreintegration) {
+        _preintegrationUnit->activate();
+        _transferFunction->preintegratedTexture().bind();
+    }
+    program.setUniform(
+        "preintegrationTable_" + id,
+        _preintegrationUnit->unitNumber()
+    );
+    program.setUniform("usePreintegration_" + id, _usePreintegration);
+
     _textureUnit = std::make_unique<ghoul::opengl::TextureUnit>();
     _textureUnit->activate();
     _volumeTexture->bind();
@@ -130,6 +145,28 @@ void BasicVolumeRaycaster::preRaycast(const RaycastData& data,
 
     program.setUniform("gridType_" + id, static_cast<int>(_gridType));
 
+    // The samplers are always assigned to separate units, as samplers of different
+    // types must not share a unit even if the skipping is disabled
+    const bool useSkipping = _minMaxTexture && _gridType == VolumeGridType::Cartesian;
+    if (useSkipping && _occupancyIsDirty) {
+        updateOccupancyTable();
+    }
+    _minMaxUnit = std::make_unique<ghoul::opengl::TextureUnit>();
+    _occupancyUnit = std::make_unique<ghoul::opengl::TextureUnit>();
+    if (useSkipping) {
+        _minMaxUnit->activate();
+        _minMaxTexture->bind();
+        _occupancyUnit->activate();
+        _occupancyTable->bind();
+        program.setUniform(
+            "blockGridSize_" + id,
+            glm::vec3(_minMaxTexture->dimensions())
+        );
+    }
+    program.setUniform("minMaxTexture_" + id, _minMaxUnit->unitNumber());
+    program.setUniform("occupancyTable_" + id, _occupancyUnit->unitNumber());
+    program.setUniform("useEmptySpaceSkipping_" + id, useSkipping);
+
     std::vector<glm::vec3> clipNormals = _clipPlanes->normals();
     std::vector<glm::vec2> clipOffsets = _clipPlanes->offsets();
     int nClips = static_cast<int>(clipNormals.size());
@@ -146,6 +183,55 @@ void BasicVolumeRaycaster::postRaycast(const RaycastData&, ghoul::opengl::Progra
 {
     _textureUnit = nullptr;
     _tfUnit = nullptr;
+    _preintegrationUnit = nullptr;
+    _minMaxUnit = nullptr;
+    _occupancyUnit = nullptr;
+}
+
+void BasicVolumeRaycaster::updateOccupancyTable() {
+    // A value bin is occupied if any transfer function texel that contributes to it,
+    // including the neighbors that are blended in by the linear filtering, is visible
+    const int width = static_cast<int>(_transferFunction->width());
+    std::vector<int> prefixSum(OccupancyTableSize + 1, 0);
+    for (int i = 0; i < OccupancyTableSize; ++i) {
+        const int begin = std::max(i * width / OccupancyTableSize - 1, 0);
+        const int end = std::min(
+            ((i + 1) * width + OccupancyTableSize - 1) / OccupancyTableSize + 1,
+            width
+        );
+        bool isOccupied = false;
+        for (int j = begin; j < end && !isOccupied; ++j) {
+            isOccupied = _transferFunction->sample(j).a > 0.f;
+        }
+        prefixSum[i + 1] = prefixSum[i] + (isOccupied ? 1 : 0);
+    }
+
+    // The table is indexed by the minimum value of a block along x and the maximum
+    // value along y and stores whether any bin in that range is occupied
+    _occupancyData.assign(OccupancyTableSize * OccupancyTableSize, 0);
+    for (int maxBin = 0; maxBin < OccupancyTableSize; ++maxBin) {
+        for (int minBin = 0; minBin <= maxBin; ++minBin) {
+            const bool isOccupied = prefixSum[maxBin + 1] - prefixSum[minBin] > 0;
+            _occupancyData[maxBin * OccupancyTableSize + minBin] = isOccupied ? 255 : 0;
+        }
+    }
+
+    if (!_occupancyTable) {
+        _occupancyTable = std::make_unique<ghoul::opengl::Texture>(
+            glm::uvec3(OccupancyTableSize, OccupancyTableSize, 1),
+            ghoul::opengl::Texture::Format::Red,
+            GL_R8,
+            GL_UNSIGNED_BYTE,
+            ghoul::opengl::Texture::FilterMode::Nearest,
+            ghoul::opengl::Texture::WrappingMode::ClampToEdge
+        );
+    }
+    _occupancyTable->setPixelData(
+        reinterpret_cast<void*>(_occupancyData.data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    _occupancyTable->uploadTexture();
+    _occupancyIsDirty = false;
 }
 
 bool BasicVolumeRaycaster::isCameraInside(const RenderData& data,
@@ -182,6 +268,7 @@ void BasicVolumeRaycaster::setTransferFunction(
                             std::shared_ptr<openspace::TransferFunction> transferFunction)
 {
     _transferFunction = std::move(transferFunction);
+    _occupancyIsDirty = true;
 }
 
 void BasicVolumeRaycaster::setVolumeTexture(
@@ -194,10 +281,24 @@ std::shared_ptr<ghoul::opengl::Texture> BasicVolumeRaycaster::volumeTexture() co
     return _volumeTexture;
 }
 
+void BasicVolumeRaycaster::setMinMaxTexture(
+                                    std::shared_ptr<ghoul::opengl::Texture> minMaxTexture)
+{
+    _minMaxTexture = std::move(minMaxTexture);
+}
+
+void BasicVolumeRaycaster::invalidateOccupancy() {
+    _occupancyIsDirty = true;
+}
+
 void BasicVolumeRaycaster::setStepSize(float stepSize) {
     _stepSize = stepSize;
 }
 
+void BasicVolumeRaycaster::setUsePreintegration(bool usePreintegration) {
+    _usePreintegration = usePreintegration;
+}
+
 void BasicVolumeRaycaster::setOpacity(float opacity) {
     _opacity = opacity;
 }
@@ -32,6 +32,7 @@
 
 #include <modules/volume/volumegridtype.h>
 #include <openspace/util/boxgeometry.h>
+#include <vector>
 
 namespace ghoul::opengl {
     class Texture;
@@ -78,10 +79,30 @@ public:
 
     void setVolumeTexture(std::shared_ptr<ghoul::opengl::Texture> texture);
     std::shared_ptr<ghoul::opengl::Texture> volumeTexture() const;
+
+    /**
+     * Sets the texture that contains the minimum and maximum value of each block of the
+     * volume texture, as created by computeMinMaxGrid. If a texture is set, rays skip
+     * the blocks that are fully transparent under the current transfer function. This
+     * is currently only supported for cartesian grids.
+     */
+    void setMinMaxTexture(std::shared_ptr<ghoul::opengl::Texture> texture);
+
+    /// Rebuilds the occupancy lookup table before the next raycast, which has to be
+    /// called whenever the contents of the transfer function have changed
+    void invalidateOccupancy();
     void setTransferFunction(
         std::shared_ptr<openspace::TransferFunction> transferFunction);
 
     void setStepSize(float stepSize);
+
+    /**
+     * If \p usePreintegration is true, the color of each segment of a ray is looked up in
+     * the pre-integrated table of the transfer function from the values at both of its
+     * ends, which allows for larger step sizes without banding for sharp transfer
+     * functions.
+     */
+    void setUsePreintegration(bool usePreintegration);
     float opacity() const;
     void setOpacity(float opacity);
     float rNormalization() const;
@@ -94,9 +115,14 @@ public:
 
 private:
     glm::dmat4 modelViewTransform(const RenderData& data);
+    void updateOccupancyTable();
 
     std::shared_ptr<VolumeClipPlanes> _clipPlanes;
     std::shared_ptr<ghoul::opengl::Texture> _volumeTexture;
+    std::shared_ptr<ghoul::opengl::Texture> _minMaxTexture;
+    std::unique_ptr<ghoul::opengl::Texture> _occupancyTable;
+    std::vector<unsigned char> _occupancyData;
+    bool _occupancyIsDirty = true;
     std::shared_ptr<openspace::TransferFunction> _transferFunction;
     BoxGeometry _boundingBox;
     VolumeGridType _gridType;
@@ -104,9 +130,13 @@ private:
     float _opacity = 20.f;
     float _rNormalization = 0.f;
     float _rUpperBound = 1.f;
+    bool _usePreintegration = false;
 
     std::unique_ptr<ghoul::opengl::TextureUnit> _tfUnit;
+    std::unique_ptr<ghoul::opengl::TextureUnit> _preintegrationUnit;
     std::unique_ptr<ghoul::opengl::TextureUnit> _textureUnit;
+    std::unique_ptr<ghoul::opengl::TextureUnit> _minMaxUnit;
+    std::unique_ptr<ghoul::opengl::TextureUnit> _occupancyUnit;
     float _stepSize;
 };
 
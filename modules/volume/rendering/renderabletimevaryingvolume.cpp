@@ -30,19 +30,25 @@
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumereader.h>
 #include <modules/volume/volumegridtype.h>
+#include <modules/volume/volumeutils.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/raycastermanager.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/histogram.h>
+#include <openspace/util/job.h>
 #include <openspace/util/time.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableTimeVaryingVolume";
@@ -51,6 +57,7 @@ namespace {
 namespace {
 
     const char* KeyStepSize = "StepSize";
+    const char* KeyPreintegration = "Preintegration";
     const char* KeyGridType = "GridType";
     const char* KeyTransferFunction = "TransferFunction";
     const char* KeySourceDirectory = "SourceDirectory";
@@ -58,8 +65,11 @@ namespace {
     const char* KeyClipPlanes = "ClipPlanes";
     const char* KeySecondsBefore = "SecondsBefore";
     const char* KeySecondsAfter = "SecondsAfter";
+    const char* KeyTextureBitsPerVoxel = "TextureBitsPerVoxel";
 
     const float SecondsInOneDay = 60 * 60 * 24;
+    // The size of the blocks that are used for the empty space skipping
+    constexpr const unsigned int MinMaxBlockSize = 8;
     constexpr const float VolumeMaxOpacity = 500;
 
     static const openspace::properties::Property::PropertyInfo StepSizeInfo = {
@@ -127,6 +137,131 @@ namespace {
         "Radius upper bound",
         "" // @TODO Missing documentation
     };
+
+    constexpr openspace::properties::Property::PropertyInfo DownscaleInfo = {
+        "downscale",
+        "Downscale Factor",
+        "The factor by which the resolution at which this volume is raycast is reduced "
+        "relative to the rendering resolution. Lower values trade image quality for "
+        "rendering performance."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PreintegrationInfo = {
+        "preintegration",
+        "Pre-integration",
+        "If enabled, the transfer function is integrated between the values of two "
+        "consecutive samples of a ray instead of being evaluated at single samples. "
+        "This avoids banding for transfer functions with sharp envelopes, so that a "
+        "step size that is several times larger gives the same image quality."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchCountInfo = {
+        "prefetchCount",
+        "Prefetch count",
+        "The number of timesteps following the current one in the playback direction "
+        "that are loaded in the background before they are needed."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo GpuMemoryBudgetInfo = {
+        "gpuMemoryBudget",
+        "GPU memory budget (MB)",
+        "The maximum amount of GPU memory that the volume textures of this renderable "
+        "may use. If the budget is exceeded, the least recently used timesteps are "
+        "evicted from the GPU."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo TextureBitsPerVoxelInfo = {
+        "textureBitsPerVoxel",
+        "Texture bits per voxel",
+        "The precision with which the voxels are stored on the GPU. Quantizing the "
+        "voxels to 16 or 8 bits reduces the GPU memory usage and the upload time of each "
+        "timestep to a half or a quarter, respectively, at the cost of precision."
+    };
+
+    using LoadedVolume = openspace::volume::RenderableTimeVaryingVolume::LoadedVolume;
+
+    // Reads a volume that was quantized to the unsigned integer type T and returns the
+    // reconstructed values
+    template <typename T>
+    std::unique_ptr<openspace::volume::RawVolume<float>> readQuantizedVolume(
+                                                                 const std::string& path,
+                                  const openspace::volume::RawVolumeMetadata& metadata)
+    {
+        openspace::volume::RawVolumeReader<T> reader(path, metadata.dimensions);
+        std::unique_ptr<openspace::volume::RawVolume<T>> quantized = reader.read();
+
+        auto volume = std::make_unique<openspace::volume::RawVolume<float>>(
+            metadata.dimensions
+        );
+        const float scale = metadata.valueScale /
+                            static_cast<float>(std::numeric_limits<T>::max());
+        const T* in = quantized->data();
+        float* out = volume->data();
+        for (size_t i = 0; i < volume->nCells(); ++i) {
+            out[i] = metadata.valueOffset + scale * static_cast<float>(in[i]);
+        }
+        return volume;
+    }
+
+    // Reads and normalizes the raw volume of a single timestep on the loader thread
+    struct TimestepLoadJob : public openspace::Job<LoadedVolume> {
+        TimestepLoadJob(std::string path, openspace::volume::RawVolumeMetadata metadata,
+                        int bitsPerVoxel)
+            : _path(std::move(path))
+            , _metadata(std::move(metadata))
+        {
+            _volume.bitsPerVoxel = bitsPerVoxel;
+        }
+
+        void execute() override {
+            using namespace openspace::volume;
+            _volume.time = _metadata.time;
+
+            std::unique_ptr<RawVolume<float>> volume;
+            try {
+                if (_metadata.hasQuantization && _metadata.bitsPerVoxel == 8) {
+                    volume = readQuantizedVolume<uint8_t>(_path, _metadata);
+                }
+                else if (_metadata.hasQuantization && _metadata.bitsPerVoxel == 16) {
+                    volume = readQuantizedVolume<uint16_t>(_path, _metadata);
+                }
+                else {
+                    volume = RawVolumeReader<float>(_path, _metadata.dimensions).read();
+                }
+            }
+            catch (const ghoul::RuntimeError&) {
+                // An empty volume signals the failure to the rendering thread
+                return;
+            }
+
+            // TODO: handle normalization properly for different timesteps + transfer
+            // function
+            const float min = _metadata.minValue;
+            const float diff = _metadata.maxValue - _metadata.minValue;
+            float* data = volume->data();
+            for (size_t i = 0; i < volume->nCells(); ++i) {
+                data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
+            }
+
+            _volume.histogram = std::make_shared<openspace::Histogram>(0.f, 1.f, 100);
+            _volume.histogram->add(data, volume->nCells());
+
+            _volume.minMaxGrid = computeMinMaxGrid(*volume, glm::uvec3(MinMaxBlockSize));
+            _volume.voxels = encodeNormalizedVoxels(
+                data,
+                volume->nCells(),
+                _volume.bitsPerVoxel
+            );
+        }
+
+        LoadedVolume product() override {
+            return std::move(_volume);
+        }
+
+        std::string _path;
+        openspace::volume::RawVolumeMetadata _metadata;
+        LoadedVolume _volume;
+    };
 } // namespace
 
 namespace openspace::volume {
@@ -162,6 +297,12 @@ namespace openspace::volume {
                 Optional::No,
                 "Specifies the number of seconds to show the the last timestep after its "
                 "actual time"
+            },
+            {
+                KeyTextureBitsPerVoxel,
+                new IntInListVerifier({ 8, 16, 32 }),
+                Optional::Yes,
+                TextureBitsPerVoxelInfo.description
             }
         }
     };
@@ -172,6 +313,8 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     : Renderable(dictionary)
     , _gridType(GridTypeInfo, properties::OptionProperty::DisplayType::Dropdown)
     , _stepSize(StepSizeInfo, 0.02f, 0.001f, 0.1f)
+    , _usePreintegration(PreintegrationInfo, true)
+    , _downscaleVolumeRendering(DownscaleInfo, 1.f, 0.1f, 1.f)
     , _rNormalization(rNormalizationInfo, 0.f, 0.f, 2.f)
     , _rUpperBound(rUpperBoundInfo, 1.f, 0.f, 2.f)
     , _secondsBefore(SecondsBeforeInfo, 0.f, 0.01f, SecondsInOneDay)
@@ -181,6 +324,13 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     , _triggerTimeJump(TriggerTimeJumpInfo)
     , _jumpToTimestep(JumpToTimestepInfo, 0, 0, 256)
     , _currentTimestep(CurrentTimeStepInfo, 0, 0, 256)
+    , _prefetchCount(PrefetchCountInfo, 2, 0, 16)
+    , _gpuMemoryBudget(GpuMemoryBudgetInfo, 1024, 64, 16384)
+    , _textureBitsPerVoxel(
+        TextureBitsPerVoxelInfo,
+        properties::OptionProperty::DisplayType::Dropdown
+    )
+    , _loadJobManager(ThreadPool(1))
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -192,7 +342,11 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     _transferFunctionPath = absPath(dictionary.value<std::string>(KeyTransferFunction));
     _transferFunction = std::make_shared<openspace::TransferFunction>(
         _transferFunctionPath,
-        [](const openspace::TransferFunction&) {}
+        [this](const openspace::TransferFunction&) {
+            if (_raycaster) {
+                _raycaster->invalidateOccupancy();
+            }
+        }
     );
 
     _gridType.addOptions({
@@ -205,11 +359,27 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
         _stepSize = dictionary.value<float>(KeyStepSize);
     }
 
+    if (dictionary.hasKeyAndValue<bool>(KeyPreintegration)) {
+        _usePreintegration = dictionary.value<bool>(KeyPreintegration);
+    }
+
     if (dictionary.hasKeyAndValue<float>(KeySecondsBefore)) {
         _secondsBefore = dictionary.value<float>(KeySecondsBefore);
     }
     _secondsAfter = dictionary.value<float>(KeySecondsAfter);
 
+    _textureBitsPerVoxel.addOptions({
+        { 32, "32 bit float" },
+        { 16, "16 bit" },
+        { 8, "8 bit" }
+    });
+    _textureBitsPerVoxel = 32;
+    if (dictionary.hasKeyAndValue<double>(KeyTextureBitsPerVoxel)) {
+        _textureBitsPerVoxel = static_cast<int>(
+            dictionary.value<double>(KeyTextureBitsPerVoxel)
+        );
+    }
+
     ghoul::Dictionary clipPlanesDictionary;
     dictionary.getValue(KeyClipPlanes, clipPlanesDictionary);
     _clipPlanes = std::make_shared<volume::VolumeClipPlanes>(clipPlanesDictionary);
@@ -249,44 +419,8 @@ void RenderableTimeVaryingVolume::initializeGL() {
         }
     }
 
-    // TODO: defer loading of data to later (separate thread or at least not when loading)
-    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
-        Timestep& t = p.second;
-        std::string path = FileSys.pathByAppendingComponent(
-            _sourceDirectory, t.baseName
-        ) + ".rawvolume";
-        RawVolumeReader<float> reader(path, t.metadata.dimensions);
-        t.rawVolume = reader.read();
-
-        float min = t.metadata.minValue;
-        float diff = t.metadata.maxValue - t.metadata.minValue;
-        float* data = t.rawVolume->data();
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
-        }
-
-        t.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            t.histogram->add(data[i]);
-        }
-
-        // TODO: handle normalization properly for different timesteps + transfer function
-
-        t.texture = std::make_shared<ghoul::opengl::Texture>(
-            t.metadata.dimensions,
-            ghoul::opengl::Texture::Format::Red,
-            GL_RED,
-            GL_FLOAT,
-            ghoul::opengl::Texture::FilterMode::Linear,
-            ghoul::opengl::Texture::WrappingMode::Clamp
-        );
-
-        t.texture->setPixelData(
-            reinterpret_cast<void*>(data),
-            ghoul::opengl::Texture::TakeOwnership::No
-        );
-        t.texture->uploadTexture();
-    }
+    // The volume data itself is streamed in by the loader thread as it is needed in
+    // the update method
 
     _clipPlanes->initialize();
 
@@ -298,6 +432,22 @@ void RenderableTimeVaryingVolume::initializeGL() {
 
     _raycaster->initialize();
     global::raycasterManager.attachRaycaster(*_raycaster.get());
+
+    _memoryBudgetClient = global::memoryBudget.registerClient(
+        "TimeVaryingVolume",
+        MemoryBudget::NormalPriority,
+        [this](MemoryBudget::Resource resource, size_t allowance) {
+            if (resource == MemoryBudget::Resource::Gpu) {
+                _memoryAllowance = allowance;
+                evictTimesteps(0, glm::uvec3(0), 0);
+                global::memoryBudget.setUsage(
+                    _memoryBudgetClient,
+                    MemoryBudget::Resource::Gpu,
+                    _gpuMemoryUsage
+                );
+            }
+        }
+    );
     onEnabledChange([&](bool enabled) {
         if (enabled) {
             global::raycasterManager.attachRaycaster(*_raycaster.get());
@@ -318,6 +468,8 @@ void RenderableTimeVaryingVolume::initializeGL() {
     _jumpToTimestep.setMaxValue(lastTimestep);
 
     addProperty(_stepSize);
+    addProperty(_usePreintegration);
+    addProperty(_downscaleVolumeRendering);
     addProperty(_transferFunctionPath);
     addProperty(_sourceDirectory);
     addPropertySubOwner(_clipPlanes.get());
@@ -325,6 +477,9 @@ void RenderableTimeVaryingVolume::initializeGL() {
     addProperty(_triggerTimeJump);
     addProperty(_jumpToTimestep);
     addProperty(_currentTimestep);
+    addProperty(_prefetchCount);
+    addProperty(_gpuMemoryBudget);
+    addProperty(_textureBitsPerVoxel);
     addProperty(_rNormalization);
     addProperty(_rUpperBound);
     addProperty(_gridType);
@@ -336,10 +491,19 @@ void RenderableTimeVaryingVolume::initializeGL() {
 
     _transferFunctionPath.onChange([this] {
         _transferFunction = std::make_shared<openspace::TransferFunction>(
-            _transferFunctionPath
+            _transferFunctionPath,
+            [this](const openspace::TransferFunction&) {
+                _raycaster->invalidateOccupancy();
+            }
         );
         _raycaster->setTransferFunction(_transferFunction);
     });
+
+    _gpuMemoryBudget.onChange([this] { evictTimesteps(0, glm::uvec3(0), 0); });
+    _textureBitsPerVoxel.onChange([this] {
+        // The timesteps are reloaded with the new precision as they are requested
+        unloadTimesteps();
+    });
 }
 
 void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::string& path) {
@@ -357,6 +521,8 @@ void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::string& path)
     t.baseName = ghoul::filesystem::File(path).baseName();
     t.inRam = false;
     t.onGpu = false;
+    t.loadRequested = false;
+    t.bitsPerVoxel = 32;
 
     _volumeTimesteps[t.metadata.time] = std::move(t);
 }
@@ -430,17 +596,239 @@ void RenderableTimeVaryingVolume::jumpToTimestep(int target) {
     }
 }
 
+void RenderableTimeVaryingVolume::requestTimesteps(int currentIndex) {
+    if (currentIndex < 0) {
+        return;
+    }
+
+    const bool forward = global::timeManager.deltaTime() >= 0.0;
+    const bool isContinuous = (forward == _lastRequestForward) &&
+                              (std::abs(currentIndex - _lastRequestedIndex) <= 1);
+    if (!isContinuous) {
+        // The playback jumped or changed its direction, so the timesteps that are still
+        // waiting in the queue are no longer the ones that are needed next
+        _loadJobManager.clearEnqueuedJobs();
+        for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
+            p.second.loadRequested = false;
+        }
+    }
+    _lastRequestedIndex = currentIndex;
+    _lastRequestForward = forward;
+
+    // Never prefetch more timesteps than would fit into the GPU memory budget, as they
+    // would only evict each other before they are displayed
+    const size_t budget = gpuMemoryBudget();
+    size_t windowSize = 0;
+
+    auto it = std::next(_volumeTimesteps.begin(), currentIndex);
+    for (int i = 0; i <= _prefetchCount; ++i) {
+        Timestep& t = it->second;
+        if (!t.onGpu) {
+            t.bitsPerVoxel = _textureBitsPerVoxel;
+        }
+        windowSize += textureSize(t);
+        if (i > 0 && windowSize > budget) {
+            break;
+        }
+
+        if (!t.onGpu && !t.inRam && !t.loadRequested) {
+            t.loadRequested = true;
+            std::string path = FileSys.pathByAppendingComponent(
+                _sourceDirectory, t.baseName
+            ) + ".rawvolume";
+            _loadJobManager.enqueueJob(std::make_shared<TimestepLoadJob>(
+                std::move(path),
+                t.metadata,
+                _textureBitsPerVoxel
+            ));
+        }
+
+        if (forward) {
+            ++it;
+            if (it == _volumeTimesteps.end()) {
+                break;
+            }
+        }
+        else {
+            if (it == _volumeTimesteps.begin()) {
+                break;
+            }
+            --it;
+        }
+    }
+}
+
+void RenderableTimeVaryingVolume::collectLoadedTimesteps() {
+    while (_loadJobManager.numFinishedJobs() > 0) {
+        std::shared_ptr<Job<LoadedVolume>> job = _loadJobManager.popFinishedJob();
+        LoadedVolume volume = job->product();
+
+        auto it = _volumeTimesteps.find(volume.time);
+        if (it == _volumeTimesteps.end() || it->second.onGpu) {
+            // This timestep was requested again after a jump while it was being loaded
+            continue;
+        }
+
+        Timestep& t = it->second;
+        if (volume.bitsPerVoxel != _textureBitsPerVoxel) {
+            // The precision was changed while this timestep was being loaded
+            t.loadRequested = false;
+            continue;
+        }
+        if (volume.voxels.empty()) {
+            // We leave the load request in place so that we don't retry every frame
+            LERROR(fmt::format("Could not load volume for timestep '{}'", t.baseName));
+            continue;
+        }
+
+        t.voxels = std::move(volume.voxels);
+        t.bitsPerVoxel = volume.bitsPerVoxel;
+        t.minMaxGrid = std::move(volume.minMaxGrid);
+        t.histogram = std::move(volume.histogram);
+        t.inRam = true;
+        uploadTimestep(t);
+    }
+}
+
+std::shared_ptr<ghoul::opengl::Texture> RenderableTimeVaryingVolume::evictTimesteps(
+                                                             size_t requiredBytes,
+                                                             const glm::uvec3& dimensions,
+                                                                         int bitsPerVoxel)
+{
+    const size_t budget = gpuMemoryBudget();
+
+    std::shared_ptr<ghoul::opengl::Texture> recycled;
+    while (!_gpuResidentTimesteps.empty() && _gpuMemoryUsage + requiredBytes > budget) {
+        Timestep& t = _volumeTimesteps[_gpuResidentTimesteps.back()];
+        _gpuResidentTimesteps.pop_back();
+        _gpuMemoryUsage -= textureSize(t);
+
+        // The raycaster might still be holding on to the texture of the displayed
+        // timestep, in which case it must not be overwritten
+        if (!recycled && t.metadata.dimensions == dimensions &&
+            t.bitsPerVoxel == bitsPerVoxel && t.texture.use_count() == 1)
+        {
+            recycled = std::move(t.texture);
+        }
+        t.texture = nullptr;
+        t.minMaxTexture = nullptr;
+        t.onGpu = false;
+        t.loadRequested = false;
+    }
+    return recycled;
+}
+
+void RenderableTimeVaryingVolume::uploadTimestep(Timestep& t) {
+    const size_t size = textureSize(t);
+    t.texture = evictTimesteps(size, t.metadata.dimensions, t.bitsPerVoxel);
+    if (!t.texture) {
+        const std::pair<GLenum, GLenum> format = voxelTextureFormat(t.bitsPerVoxel);
+        t.texture = std::make_shared<ghoul::opengl::Texture>(
+            t.metadata.dimensions,
+            ghoul::opengl::Texture::Format::Red,
+            format.first,
+            format.second,
+            ghoul::opengl::Texture::FilterMode::Linear,
+            ghoul::opengl::Texture::WrappingMode::Clamp
+        );
+    }
+
+    t.texture->setPixelData(
+        reinterpret_cast<void*>(t.voxels.data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    t.texture->uploadTexture();
+
+    // The data has been copied to the GPU, so we don't need to keep it in RAM
+    t.texture->setPixelData(nullptr, ghoul::opengl::Texture::TakeOwnership::No);
+    t.voxels.clear();
+    t.voxels.shrink_to_fit();
+
+    t.minMaxTexture = std::make_shared<ghoul::opengl::Texture>(
+        t.minMaxGrid->dimensions(),
+        ghoul::opengl::Texture::Format::RG,
+        GL_RG32F,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Nearest,
+        ghoul::opengl::Texture::WrappingMode::ClampToEdge
+    );
+    t.minMaxTexture->setPixelData(
+        reinterpret_cast<void*>(t.minMaxGrid->data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    t.minMaxTexture->uploadTexture();
+    t.minMaxTexture->setPixelData(nullptr, ghoul::opengl::Texture::TakeOwnership::No);
+    t.minMaxGrid = nullptr;
+    t.inRam = false;
+    t.onGpu = true;
+
+    _gpuResidentTimesteps.push_front(t.metadata.time);
+    _gpuMemoryUsage += size;
+}
+
+void RenderableTimeVaryingVolume::unloadTimesteps() {
+    _loadJobManager.clearEnqueuedJobs();
+    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
+        p.second.texture = nullptr;
+        p.second.minMaxTexture = nullptr;
+        p.second.voxels.clear();
+        p.second.minMaxGrid = nullptr;
+        p.second.inRam = false;
+        p.second.onGpu = false;
+        p.second.loadRequested = false;
+    }
+    _gpuResidentTimesteps.clear();
+    _gpuMemoryUsage = 0;
+    _lastRequestedIndex = -1;
+}
+
+void RenderableTimeVaryingVolume::touchTimestep(double time) {
+    auto it = std::find(_gpuResidentTimesteps.begin(), _gpuResidentTimesteps.end(), time);
+    if (it != _gpuResidentTimesteps.end()) {
+        _gpuResidentTimesteps.splice(
+            _gpuResidentTimesteps.begin(),
+            _gpuResidentTimesteps,
+            it
+        );
+    }
+}
+
+size_t RenderableTimeVaryingVolume::textureSize(const Timestep& t) const {
+    return static_cast<size_t>(t.metadata.dimensions.x) *
+           static_cast<size_t>(t.metadata.dimensions.y) *
+           static_cast<size_t>(t.metadata.dimensions.z) *
+           static_cast<size_t>(t.bitsPerVoxel / 8);
+}
+
+size_t RenderableTimeVaryingVolume::gpuMemoryBudget() const {
+    const size_t budget = static_cast<size_t>(_gpuMemoryBudget) * 1024 * 1024;
+    return std::min(budget, _memoryAllowance);
+}
+
 void RenderableTimeVaryingVolume::update(const UpdateData&) {
     _transferFunction->update();
 
+    if (_memoryBudgetClient != 0) {
+        using Resource = MemoryBudget::Resource;
+        MemoryBudget& budget = global::memoryBudget;
+        budget.setUsage(_memoryBudgetClient, Resource::Gpu, _gpuMemoryUsage);
+        _memoryAllowance = budget.allowance(_memoryBudgetClient, Resource::Gpu);
+    }
+
     if (_raycaster) {
         Timestep* t = currentTimestep();
-        _currentTimestep = timestepIndex(t);
+        const int index = timestepIndex(t);
+        _currentTimestep = index;
+
+        collectLoadedTimesteps();
+        requestTimesteps(index);
+        _hasCurrentTimestepOnGpu = !t || t->onGpu;
 
         // Set scale and translation matrices:
         // The original data cube is a unit cube centered in 0
         // ie with lower bound from (-0.5, -0.5, -0.5) and upper bound (0.5, 0.5, 0.5)
-        if (t && t->texture) {
+        if (t && t->onGpu) {
+            touchTimestep(t->metadata.time);
             if (_raycaster->gridType() == volume::VolumeGridType::Cartesian) {
                 glm::dvec3 scale = t->metadata.upperDomainBound -
                     t->metadata.lowerDomainBound;
@@ -462,10 +850,16 @@ void RenderableTimeVaryingVolume::update(const UpdateData&) {
                 );
             }
             _raycaster->setVolumeTexture(t->texture);
-        } else {
+            _raycaster->setMinMaxTexture(t->minMaxTexture);
+        } else if (!t) {
             _raycaster->setVolumeTexture(nullptr);
+            _raycaster->setMinMaxTexture(nullptr);
         }
+        // Otherwise the current timestep is still being loaded and we keep showing the
+        // previous one instead of stalling the rendering
         _raycaster->setStepSize(_stepSize);
+        _raycaster->setUsePreintegration(_usePreintegration);
+        _raycaster->setDownscaleRender(_downscaleVolumeRendering);
         _raycaster->setOpacity(_opacity * VolumeMaxOpacity);
         _raycaster->setRNormalization(_rNormalization);
         _raycaster->setRUpperBound(_rUpperBound);
@@ -482,7 +876,18 @@ bool RenderableTimeVaryingVolume::isReady() const {
     return true;
 }
 
+bool RenderableTimeVaryingVolume::renderedWithDesiredData() const {
+    return _hasCurrentTimestepOnGpu;
+}
+
 void RenderableTimeVaryingVolume::deinitializeGL() {
+    unloadTimesteps();
+
+    if (_memoryBudgetClient != 0) {
+        global::memoryBudget.unregisterClient(_memoryBudgetClient);
+        _memoryBudgetClient = 0;
+    }
+
     if (_raycaster) {
         global::raycasterManager.detachRaycaster(*_raycaster.get());
         _raycaster = nullptr;
@@ -28,8 +28,15 @@
 #include <openspace/rendering/renderable.h>
 
 #include <openspace/properties/optionproperty.h>
+#include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/util/concurrentjobmanager.h>
+#include <openspace/util/memorybudget.h>
+#include <limits>
+#include <list>
+#include <map>
+#include <vector>
 // #include <modules/volume/rawvolume.h>
  #include <modules/volume/rawvolumemetadata.h>
 // #include <modules/volume/rendering/basicvolumeraycaster.h>
@@ -62,19 +69,34 @@ public:
     void initializeGL() override;
     void deinitializeGL() override;
     bool isReady() const override;
+    bool renderedWithDesiredData() const override;
     void render(const RenderData& data, RendererTasks& tasks) override;
     void update(const UpdateData& data) override;
 
     static documentation::Documentation Documentation();
 
+    /// The result of loading and normalizing the raw volume of a single timestep
+    struct LoadedVolume {
+        double time;
+        /// The normalized voxels encoded with bitsPerVoxel bits, empty on failure
+        std::vector<unsigned char> voxels;
+        int bitsPerVoxel;
+        std::shared_ptr<RawVolume<glm::vec2>> minMaxGrid;
+        std::shared_ptr<Histogram> histogram;
+    };
+
 private:
     struct Timestep {
         std::string baseName;
         bool inRam;
         bool onGpu;
+        bool loadRequested;
         RawVolumeMetadata metadata;
-        std::shared_ptr<RawVolume<float>> rawVolume;
+        std::vector<unsigned char> voxels;
+        int bitsPerVoxel;
+        std::shared_ptr<RawVolume<glm::vec2>> minMaxGrid;
         std::shared_ptr<ghoul::opengl::Texture> texture;
+        std::shared_ptr<ghoul::opengl::Texture> minMaxTexture;
         std::shared_ptr<Histogram> histogram;
     };
 
@@ -85,10 +107,52 @@ private:
 
     void loadTimestepMetadata(const std::string& path);
 
+    /**
+     * Requests the loading of the current timestep and the next \p _prefetchCount
+     * timesteps in the playback direction from the loader thread.
+     * \param currentIndex The index of the timestep that is currently displayed
+     */
+    void requestTimesteps(int currentIndex);
+
+    /// Uploads the timesteps that the loader thread has finished since the last frame
+    void collectLoadedTimesteps();
+
+    /**
+     * Uploads the raw volume of the timestep \p t to the GPU. If the GPU memory budget
+     * would be exceeded, the least recently used timesteps are evicted and their
+     * textures are recycled if possible.
+     */
+    void uploadTimestep(Timestep& t);
+
+    /**
+     * Evicts the least recently used timesteps from the GPU until \p requiredBytes
+     * additional bytes fit into the GPU memory budget.
+     * \return The texture of an evicted timestep with the \p dimensions and
+     *         \p bitsPerVoxel that is no longer referenced elsewhere and can be reused,
+     *         or \c nullptr
+     */
+    std::shared_ptr<ghoul::opengl::Texture> evictTimesteps(size_t requiredBytes,
+        const glm::uvec3& dimensions, int bitsPerVoxel);
+
+    /// Removes all timesteps from the GPU and cancels the pending load requests
+    void unloadTimesteps();
+
+    /// Marks the timestep at \p time as the most recently used one
+    void touchTimestep(double time);
+
+    /// Returns the number of bytes that the texture of the timestep \p t requires
+    size_t textureSize(const Timestep& t) const;
+
+    /// Returns the number of bytes that the textures of all timesteps may use, which is
+    /// the smaller of the GpuMemoryBudget and what the MemoryBudget leaves for them
+    size_t gpuMemoryBudget() const;
+
     properties::OptionProperty _gridType;
     std::shared_ptr<VolumeClipPlanes> _clipPlanes;
 
     properties::FloatProperty _stepSize;
+    properties::BoolProperty _usePreintegration;
+    properties::FloatProperty _downscaleVolumeRendering;
     properties::FloatProperty _rNormalization;
     properties::FloatProperty _rUpperBound;
     properties::FloatProperty _secondsBefore;
@@ -99,8 +163,22 @@ private:
     properties::TriggerProperty _triggerTimeJump;
     properties::IntProperty _jumpToTimestep;
     properties::IntProperty _currentTimestep;
+    properties::IntProperty _prefetchCount;
+    properties::IntProperty _gpuMemoryBudget;
+    properties::OptionProperty _textureBitsPerVoxel;
 
     std::map<double, Timestep> _volumeTimesteps;
+    /// Whether the timestep for the current time was on the GPU in the last update
+    bool _hasCurrentTimestepOnGpu = true;
+
+    ConcurrentJobManager<LoadedVolume> _loadJobManager;
+    /// The times of the timesteps on the GPU, with the most recently used first
+    std::list<double> _gpuResidentTimesteps;
+    size_t _gpuMemoryUsage = 0;
+    MemoryBudget::ClientId _memoryBudgetClient = 0;
+    size_t _memoryAllowance = std::numeric_limits<size_t>::max();
+    int _lastRequestedIndex = -1;
+    bool _lastRequestForward = true;
     std::unique_ptr<BasicVolumeRaycaster> _raycaster;
 
     std::shared_ptr<openspace::TransferFunction> _transferFunction;
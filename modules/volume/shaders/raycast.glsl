@@ -25,6 +25,11 @@
 uniform float maxStepSize#{id} = 0.02;
 uniform sampler3D volumeTexture_#{id};
 uniform sampler1D transferFunction_#{id};
+
+// The pre-integrated transfer function, which is indexed by the values at the front and
+// the back of a ray segment
+uniform bool usePreintegration_#{id} = false;
+uniform sampler2D preintegrationTable_#{id};
 uniform int gridType_#{id} = 0;
 
 uniform int nClips_#{id};
@@ -42,14 +47,67 @@ uniform float rNormalization_#{id} = 0.0;
 
 uniform float rUpperBound_#{id} = 1.0;
 
+// Empty space skipping. The min/max texture stores the value range of each block of the
+// volume and the occupancy table whether any value in a range is visible under the
+// current transfer function
+uniform bool useEmptySpaceSkipping_#{id} = false;
+uniform sampler3D minMaxTexture_#{id};
+uniform sampler2D occupancyTable_#{id};
+uniform vec3 blockGridSize_#{id};
+
+// The length of the step that was last handed back to the raycasting loop
+float lastStepSize#{id} = 0.0;
+
+// The value of the previous sample, or a negative number if the segment in front of the
+// current sample was skipped or clipped and has to be treated as a single point
+float previousValue#{id} = -1.0;
+
+bool isBlockEmpty#{id}(vec3 position) {
+    ivec3 block = ivec3(floor(position * blockGridSize_#{id}));
+    if (any(lessThan(block, ivec3(0))) ||
+        any(greaterThanEqual(block, ivec3(blockGridSize_#{id}))))
+    {
+        return false;
+    }
+    vec2 minMax = texelFetch(minMaxTexture_#{id}, block, 0).rg;
+    return texture(occupancyTable_#{id}, minMax).r == 0.0;
+}
+
+// Returns the distance from the position to just past the exit of its block along dir
+float blockExitDistance#{id}(vec3 position, vec3 dir) {
+    vec3 block = floor(position * blockGridSize_#{id});
+    vec3 exitFace = (block + step(0.0, dir)) / blockGridSize_#{id};
+    vec3 distances = (exitFace - position) / dir;
+    // Directions parallel to a face never leave the block through it
+    distances = mix(distances, vec3(1e6), lessThan(abs(dir), vec3(1e-6)));
+    return min(distances.x, min(distances.y, distances.z)) + 1e-4;
+}
+
 void sample#{id}(vec3 samplePos, vec3 dir, inout vec3 accumulatedColor,
                  inout vec3 accumulatedAlpha, inout float stepSize)
 {
+    if (useEmptySpaceSkipping_#{id} && gridType_#{id} == 0 &&
+        isBlockEmpty#{id}(samplePos))
+    {
+        // The raycasting loop samples at a jittered position behind the start of the
+        // next step, so we reconstruct the jitter in the same way as the loop in
+        // raycastframebuffer.frag to find where the next step begins
+        float jitterFactor = 0.5 + 0.5 * rand(gl_FragCoord.xy);
+        vec3 position = samplePos + dir * (1.0 - jitterFactor) * lastStepSize#{id};
+        stepSize = maxStepSize#{id};
+        if (isBlockEmpty#{id}(position)) {
+            stepSize = max(stepSize, blockExitDistance#{id}(position, dir));
+        }
+        lastStepSize#{id} = stepSize;
+        previousValue#{id} = -1.0;
+        return;
+    }
 
     vec3 transformedPos = samplePos;
     if (gridType_#{id} == 1) {
         transformedPos = volume_cartesianToSpherical(samplePos);
         if (abs(transformedPos.r) > 1.0) {
+           previousValue#{id} = -1.0;
            return;
         }
     }
@@ -73,13 +131,23 @@ void sample#{id}(vec3 samplePos, vec3 dir, inout vec3 accumulatedColor,
             val *= pow(transformedPos.x, rNormalization_#{id});
         }
 
-        vec4 color = texture(transferFunction_#{id}, val);
+        vec4 color;
+        if (usePreintegration_#{id} && previousValue#{id} >= 0.0) {
+            color = texture(preintegrationTable_#{id}, vec2(previousValue#{id}, val));
+        }
+        else {
+            color = texture(transferFunction_#{id}, val);
+        }
+        previousValue#{id} = clamp(val, 0.0, 1.0);
 
         vec3 backColor = color.rgb;
         vec3 backAlpha = color.aaa;
 
-        backColor *= stepSize*opacity_#{id} * clipAlpha;
-        backAlpha *= stepSize*opacity_#{id} * clipAlpha;
+        // A sample directly after a skipped block must not be weighted by the
+        // length of the skip
+        float sampleStepSize = min(stepSize, maxStepSize#{id});
+        backColor *= sampleStepSize*opacity_#{id} * clipAlpha;
+        backAlpha *= sampleStepSize*opacity_#{id} * clipAlpha;
 
         backColor = clamp(backColor, 0.0, 1.0);
         backAlpha = clamp(backAlpha, 0.0, 1.0);
@@ -88,10 +156,23 @@ void sample#{id}(vec3 samplePos, vec3 dir, inout vec3 accumulatedColor,
         accumulatedColor += oneMinusFrontAlpha * backColor;
         accumulatedAlpha += oneMinusFrontAlpha * backAlpha;
     }
+    else {
+        previousValue#{id} = -1.0;
+    }
 
     stepSize = maxStepSize#{id};
+    lastStepSize#{id} = stepSize;
 }
 
 float stepSize#{id}(vec3 samplePos, vec3 dir) {
-    return maxStepSize#{id};
+    lastStepSize#{id} = maxStepSize#{id};
+    if (useEmptySpaceSkipping_#{id} && gridType_#{id} == 0 &&
+        isBlockEmpty#{id}(samplePos))
+    {
+        lastStepSize#{id} = max(
+            lastStepSize#{id},
+            blockExitDistance#{id}(samplePos, dir)
+        );
+    }
+    return lastStepSize#{id};
 }
@@ -0,0 +1,188 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/volume/tasks/quantizerawvolumetask.h>
+
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/rawvolumemetadata.h>
+#include <modules/volume/rawvolumereader.h>
+#include <modules/volume/volumeutils.h>
+#include <openspace/documentation/verifier.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/lua/ghoul_lua.h>
+#include <ghoul/misc/dictionaryluaformatter.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace {
+    constexpr const char* KeyRawVolumeInput = "RawVolumeInput";
+    constexpr const char* KeyDictionaryInput = "DictionaryInput";
+    constexpr const char* KeyRawVolumeOutput = "RawVolumeOutput";
+    constexpr const char* KeyDictionaryOutput = "DictionaryOutput";
+    constexpr const char* KeyBitsPerVoxel = "BitsPerVoxel";
+} // namespace
+
+namespace openspace::volume {
+
+QuantizeRawVolumeTask::QuantizeRawVolumeTask(const ghoul::Dictionary& dictionary) {
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "QuantizeRawVolumeTask"
+    );
+
+    _rawVolumeInputPath = absPath(dictionary.value<std::string>(KeyRawVolumeInput));
+    _dictionaryInputPath = absPath(dictionary.value<std::string>(KeyDictionaryInput));
+    _rawVolumeOutputPath = absPath(dictionary.value<std::string>(KeyRawVolumeOutput));
+    _dictionaryOutputPath = absPath(dictionary.value<std::string>(KeyDictionaryOutput));
+    _bitsPerVoxel = static_cast<int>(dictionary.value<double>(KeyBitsPerVoxel));
+}
+
+std::string QuantizeRawVolumeTask::description() {
+    return fmt::format(
+        "Quantize the raw volume {} with the metadata {} to {} bits per voxel. Write "
+        "raw volume data into {} and dictionary with metadata to {}",
+        _rawVolumeInputPath, _dictionaryInputPath, _bitsPerVoxel,
+        _rawVolumeOutputPath, _dictionaryOutputPath
+    );
+}
+
+void QuantizeRawVolumeTask::perform(const Task::ProgressCallback& progressCallback) {
+    RawVolumeMetadata metadata = RawVolumeMetadata::createFromDictionary(
+        ghoul::lua::loadDictionaryFromFile(_dictionaryInputPath)
+    );
+    if (metadata.hasQuantization) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Raw volume '{}' is already quantized", _rawVolumeInputPath
+        ));
+    }
+
+    RawVolumeReader<float> reader(_rawVolumeInputPath, metadata.dimensions);
+    std::unique_ptr<RawVolume<float>> volume = reader.read();
+    progressCallback(0.3f);
+
+    float* data = volume->data();
+    const size_t nCells = volume->nCells();
+    if (!metadata.hasValueRange) {
+        metadata.minValue = std::numeric_limits<float>::max();
+        metadata.maxValue = std::numeric_limits<float>::lowest();
+        for (size_t i = 0; i < nCells; ++i) {
+            metadata.minValue = std::min(metadata.minValue, data[i]);
+            metadata.maxValue = std::max(metadata.maxValue, data[i]);
+        }
+        metadata.hasValueRange = true;
+    }
+
+    const float diff = std::max(
+        metadata.maxValue - metadata.minValue,
+        std::numeric_limits<float>::min()
+    );
+    for (size_t i = 0; i < nCells; ++i) {
+        data[i] = glm::clamp((data[i] - metadata.minValue) / diff, 0.f, 1.f);
+    }
+
+    const std::vector<unsigned char> voxels = encodeNormalizedVoxels(
+        data,
+        nCells,
+        _bitsPerVoxel
+    );
+    volume = nullptr;
+    progressCallback(0.6f);
+
+    std::ofstream file(_rawVolumeOutputPath, std::ios::binary);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Could not create file '{}'", _rawVolumeOutputPath
+        ));
+    }
+    file.write(reinterpret_cast<const char*>(voxels.data()), voxels.size());
+    file.close();
+    progressCallback(0.9f);
+
+    metadata.hasQuantization = true;
+    metadata.bitsPerVoxel = _bitsPerVoxel;
+    metadata.valueOffset = metadata.minValue;
+    metadata.valueScale = diff;
+
+    ghoul::Dictionary outputDictionary = metadata.dictionary();
+    ghoul::DictionaryLuaFormatter formatter;
+    std::string metadataString = formatter.format(outputDictionary);
+
+    std::fstream f(_dictionaryOutputPath, std::ios::out);
+    f << "return " << metadataString;
+    f.close();
+
+    progressCallback(1.0f);
+}
+
+documentation::Documentation QuantizeRawVolumeTask::documentation() {
+    using namespace documentation;
+    return {
+        "QuantizeRawVolumeTask",
+        "quantize_raw_volume_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("QuantizeRawVolumeTask"),
+                Optional::No,
+                "The type of this task",
+            },
+            {
+                KeyRawVolumeInput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The raw volume file with 32-bit floating point values to quantize",
+            },
+            {
+                KeyDictionaryInput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The lua dictionary file with the metadata of the input volume",
+            },
+            {
+                KeyRawVolumeOutput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The raw volume file to export the quantized data to",
+            },
+            {
+                KeyDictionaryOutput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The lua dictionary file to export the metadata to",
+            },
+            {
+                KeyBitsPerVoxel,
+                new IntInListVerifier({ 8, 16 }),
+                Optional::No,
+                "The number of bits per voxel of the quantized volume",
+            }
+        }
+    };
+}
+
+} // namespace openspace::volume
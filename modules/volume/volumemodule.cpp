@@ -26,6 +26,7 @@
 
 #include <modules/volume/rendering/renderabletimevaryingvolume.h>
 #include <modules/volume/tasks/generaterawvolumetask.h>
+#include <modules/volume/tasks/quantizerawvolumetask.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/util/task.h>
 #include <openspace/util/factorymanager.h>
@@ -46,6 +47,7 @@ void VolumeModule::internalInitialize(const ghoul::Dictionary&) {
     auto tFactory = FactoryManager::ref().factory<Task>();
     ghoul_assert(tFactory, "No task factory existed");
     tFactory->registerClass<GenerateRawVolumeTask>("GenerateRawVolumeTask");
+    tFactory->registerClass<QuantizeRawVolumeTask>("QuantizeRawVolumeTask");
 
 }
 
@@ -24,6 +24,12 @@
 
 #include <modules/volume/volumeutils.h>
 
+#include <modules/volume/rawvolume.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
 namespace openspace::volume {
 
 size_t coordsToIndex(const glm::uvec3& coords, const glm::uvec3& dims) {
@@ -43,4 +49,77 @@ glm::uvec3 indexToCoords(size_t index, const glm::uvec3& dims) {
     return glm::uvec3(x, y, z);
 }
 
+std::unique_ptr<RawVolume<glm::vec2>> computeMinMaxGrid(const RawVolume<float>& volume,
+                                                        const glm::uvec3& blockSize)
+{
+    const glm::uvec3 dims = volume.dimensions();
+    const glm::uvec3 gridDims = (dims + blockSize - glm::uvec3(1)) / blockSize;
+    std::unique_ptr<RawVolume<glm::vec2>> grid =
+        std::make_unique<RawVolume<glm::vec2>>(gridDims);
+
+    const float* data = volume.data();
+    for (unsigned int bz = 0; bz < gridDims.z; ++bz) {
+        for (unsigned int by = 0; by < gridDims.y; ++by) {
+            for (unsigned int bx = 0; bx < gridDims.x; ++bx) {
+                const glm::uvec3 block(bx, by, bz);
+                // Extend the block by one voxel in each direction to account for the
+                // linear interpolation across the block boundaries
+                const glm::uvec3 begin = glm::max(block * blockSize, glm::uvec3(1)) -
+                                         glm::uvec3(1);
+                const glm::uvec3 end = glm::min((block + glm::uvec3(1)) * blockSize + 1u,
+                                                dims);
+
+                float minValue = std::numeric_limits<float>::max();
+                float maxValue = std::numeric_limits<float>::lowest();
+                for (unsigned int z = begin.z; z < end.z; ++z) {
+                    for (unsigned int y = begin.y; y < end.y; ++y) {
+                        const size_t row = coordsToIndex(glm::uvec3(0, y, z), dims);
+                        for (unsigned int x = begin.x; x < end.x; ++x) {
+                            minValue = std::min(minValue, data[row + x]);
+                            maxValue = std::max(maxValue, data[row + x]);
+                        }
+                    }
+                }
+                grid->set(block, glm::vec2(minValue, maxValue));
+            }
+        }
+    }
+    return grid;
+}
+
+std::vector<unsigned char> encodeNormalizedVoxels(const float* values, size_t nValues,
+                                                  int bitsPerVoxel)
+{
+    std::vector<unsigned char> voxels(nValues * bitsPerVoxel / 8);
+    switch (bitsPerVoxel) {
+        case 8:
+            for (size_t i = 0; i < nValues; ++i) {
+                voxels[i] = static_cast<uint8_t>(values[i] * 255.f + 0.5f);
+            }
+            break;
+        case 16: {
+            uint16_t* out = reinterpret_cast<uint16_t*>(voxels.data());
+            for (size_t i = 0; i < nValues; ++i) {
+                out[i] = static_cast<uint16_t>(values[i] * 65535.f + 0.5f);
+            }
+            break;
+        }
+        default:
+            std::memcpy(voxels.data(), values, nValues * sizeof(float));
+            break;
+    }
+    return voxels;
+}
+
+std::pair<GLenum, GLenum> voxelTextureFormat(int bitsPerVoxel) {
+    switch (bitsPerVoxel) {
+        case 8:
+            return { GL_R8, GL_UNSIGNED_BYTE };
+        case 16:
+            return { GL_R16, GL_UNSIGNED_SHORT };
+        default:
+            return { GL_RED, GL_FLOAT };
+    }
+}
+
 } // namespace openspace::volume
@@ -26,12 +26,46 @@
 #define __OPENSPACE_MODULE_VOLUME___VOLUMEUTILS___H__
 
 #include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace openspace::volume {
 
+template <typename T> class RawVolume;
+
 size_t coordsToIndex(const glm::uvec3& coords, const glm::uvec3& dimensions);
 glm::uvec3 indexToCoords(size_t index, const glm::uvec3& dimensions);
 
+/**
+ * Computes the minimum and maximum voxel value of each block of \p blockSize voxels in
+ * the \p volume. Each block includes a border of one voxel, so that the range also
+ * covers the values that are interpolated into the block from its neighbors.
+ * \param volume The volume for which the min/max grid is computed
+ * \param blockSize The number of voxels along each side of a block
+ * \return A volume with one cell per block that contains the minimum value in the
+ *         \c x and the maximum value in the \c y component
+ */
+std::unique_ptr<RawVolume<glm::vec2>> computeMinMaxGrid(const RawVolume<float>& volume,
+    const glm::uvec3& blockSize);
+
+/**
+ * Encodes the \p nValues \p values, which have to be normalized to [0, 1], as voxels
+ * with \p bitsPerVoxel bits. 8 and 16 bits are stored as normalized unsigned integers
+ * and 32 bits as floating point values.
+ * \return The encoded voxels, ready to be uploaded into a texture with the format
+ *         returned by voxelTextureFormat
+ */
+std::vector<unsigned char> encodeNormalizedVoxels(const float* values, size_t nValues,
+    int bitsPerVoxel);
+
+/**
+ * Returns the internal format and the data type of a single channel texture that holds
+ * voxels with \p bitsPerVoxel bits as produced by encodeNormalizedVoxels.
+ */
+std::pair<GLenum, GLenum> voxelTextureFormat(int bitsPerVoxel);
+
 } // namespace openspace::volume
 
 #endif // __OPENSPACE_MODULE_VOLUME___VOLUMEUTILS___H__
@@ -58,7 +58,13 @@ class BrowserInstance {
 public:
     static constexpr int SingleClick = 1;
 
-    BrowserInstance(WebRenderHandler* renderer, WebKeyboardHandler* keyboardHandler);
+    /**
+     * If \p acceleratedPaint is \c true, the browser renders into shared textures that
+     * are passed to WebRenderHandler::OnAcceleratedPaint, which is only supported on
+     * Windows. Such a browser cannot be hit tested using #hasContent.
+     */
+    BrowserInstance(WebRenderHandler* renderer, WebKeyboardHandler* keyboardHandler,
+        bool acceleratedPaint = false);
     ~BrowserInstance();
 
     void loadUrl(std::string url);
@@ -25,6 +25,8 @@
 #ifndef __OPENSPACE_MODULE_WEBBROWSER__WEB_RENDER_HANDLER_H
 #define __OPENSPACE_MODULE_WEBBROWSER__WEB_RENDER_HANDLER_H
 
+#include <array>
+#include <map>
 #include <vector>
 #include <ghoul/glm.h>
 
@@ -47,6 +49,8 @@ class WebRenderHandler : public CefRenderHandler {
 public:
     using Pixel = glm::tvec4<char>;
 
+    virtual ~WebRenderHandler();
+
     virtual void draw(void) = 0;
     virtual void render() = 0;
 
@@ -55,6 +59,23 @@ public:
     void GetViewRect(CefRefPtr<CefBrowser> browser, CefRect &rect) override;
     void OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type,
         const RectList &dirtyRects, const void* buffer, int width, int height) override;
+
+    /**
+     * Called instead of OnPaint if the browser was created with shared textures
+     * enabled. The pixels of the view are copied from the shared D3D11 texture into
+     * #_texture without leaving the GPU. Browsers receiving their pixels this way can
+     * not be hit tested by #hasContent
+     */
+    void OnAcceleratedPaint(CefRefPtr<CefBrowser> browser, PaintElementType type,
+        const RectList& dirtyRects, void* sharedHandle) override;
+
+    /**
+     * Returns \c true if browsers can render into shared textures on this machine,
+     * which requires Windows and an OpenGL driver supporting WGL_NV_DX_interop2. Must
+     * be called with the OpenGL context current.
+     */
+    static bool isAcceleratedPaintSupported();
+
     bool hasContent(int x, int y);
 
     bool isTextureReady() const;
@@ -64,18 +85,43 @@ protected:
     GLuint _texture;
 
 private:
+    /// Maps the next pixel buffer object so that OnPaint can write into it
+    void mapPixelBuffer();
+
     glm::ivec2 _windowSize;
     glm::ivec2 _browserBufferSize;
 
     /**
-     * RGBA buffer from browser
+     * RGBA buffer from browser. This is only used for the first frame after the size
+     * of the browser has changed, afterwards the dirty rectangles are copied straight
+     * into the mapped pixel buffer object
      */
     std::vector<Pixel> _browserBuffer;
+
+    /// The alpha channel of the browser, which is needed for hit testing
+    std::vector<unsigned char> _alphaMask;
+
+    // Two pixel buffer objects are used alternately, so that OnPaint can write into
+    // one of them while the upload from the other is still in flight
+    std::array<GLuint, 2> _pixelBuffers = { 0, 0 };
+    int _currentPixelBuffer = 0;
+    Pixel* _mappedPixelBuffer = nullptr;
+    glm::ivec2 _pixelBufferSize = glm::ivec2(0);
+    /// The rectangles that have been written to the mapped pixel buffer object
+    std::vector<CefRect> _pendingRects;
+
+    struct SharedTexture {
+        void* d3dTexture = nullptr;
+        void* interopHandle = nullptr;
+        GLuint texture = 0;
+        glm::ivec2 size = glm::ivec2(0);
+    };
+    // CEF renders into a small pool of textures that are registered only once
+    std::map<void*, SharedTexture> _sharedTextures;
+
     bool _needsRepaint = true;
     bool _textureSizeIsDirty = true;
     bool _textureIsDirty = true;
-    glm::ivec2 _lowerDirtyRectBound;
-    glm::ivec2 _upperDirtyRectBound;
 
     IMPLEMENT_REFCOUNTING(WebRenderHandler);
 };
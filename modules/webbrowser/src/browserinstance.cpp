@@ -42,7 +42,8 @@ namespace {
 namespace openspace {
 
 BrowserInstance::BrowserInstance(WebRenderHandler* renderer,
-                                 WebKeyboardHandler* keyboardHandler)
+                                 WebKeyboardHandler* keyboardHandler,
+                                 bool acceleratedPaint)
     : _renderHandler(renderer)
     , _keyboardHandler(keyboardHandler)
 {
@@ -50,6 +51,11 @@ BrowserInstance::BrowserInstance(WebRenderHandler* renderer,
 
     CefWindowInfo windowInfo;
     windowInfo.SetAsWindowless(nullptr);
+#ifdef WIN32
+    windowInfo.shared_texture_enabled = acceleratedPaint;
+#else
+    (void)acceleratedPaint;
+#endif // WIN32
 
     CefBrowserSettings browserSettings;
     browserSettings.windowless_frame_rate = 60;
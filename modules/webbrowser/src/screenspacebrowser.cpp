@@ -87,9 +87,11 @@ ScreenSpaceBrowser::ScreenSpaceBrowser(const ghoul::Dictionary &dictionary)
 
     _renderHandler = new ScreenSpaceRenderHandler();
     _keyboardHandler = new WebKeyboardHandler();
+    // Screen space browsers are not hit tested, so their pixels can stay on the GPU
     _browserInstance = std::make_unique<BrowserInstance>(
         _renderHandler,
-        _keyboardHandler
+        _keyboardHandler,
+        WebRenderHandler::isAcceleratedPaintSupported()
     );
 
     _url.onChange([this]() { _isUrlDirty = true; });
@@ -108,8 +110,6 @@ bool ScreenSpaceBrowser::initialize() {
     _originalViewportSize = global::windowDelegate.currentWindowSize();
     _renderHandler->setTexture(*_texture);
 
-    createShaders();
-
     _browserInstance->loadUrl(_url);
     return isReady();
 }
@@ -159,7 +159,7 @@ void ScreenSpaceBrowser::update() {
 }
 
 bool ScreenSpaceBrowser::isReady() const {
-    return _shader && _texture;
+    return _texture != nullptr;
 }
 
 } // namespace openspace
@@ -22,14 +22,141 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+
 #include <modules/webbrowser/include/webrenderhandler.h>
 
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
 #include <ghoul/glm.h>
 #include <fmt/format.h>
 #include <ghoul/logging/logmanager.h>
+#include <cstring>
+
+#ifdef WIN32
+#include <Windows.h>
+#include <d3d11.h>
+#endif // WIN32
+
+namespace {
+    constexpr const char* _loggerCat = "WebRenderHandler";
+
+#ifdef WIN32
+    // WGL_NV_DX_interop2 is not part of the OpenGL bindings, so the entry points have
+    // to be loaded manually
+    using PFNWGLDXOPENDEVICENV = HANDLE(WINAPI*)(void* dxDevice);
+    using PFNWGLDXCLOSEDEVICENV = BOOL(WINAPI*)(HANDLE hDevice);
+    using PFNWGLDXREGISTEROBJECTNV = HANDLE(WINAPI*)(HANDLE hDevice, void* dxObject,
+        GLuint name, GLenum type, GLenum access);
+    using PFNWGLDXUNREGISTEROBJECTNV = BOOL(WINAPI*)(HANDLE hDevice, HANDLE hObject);
+    using PFNWGLDXLOCKOBJECTSNV = BOOL(WINAPI*)(HANDLE hDevice, GLint count,
+        HANDLE* hObjects);
+    using PFNWGLDXUNLOCKOBJECTSNV = BOOL(WINAPI*)(HANDLE hDevice, GLint count,
+        HANDLE* hObjects);
+
+    constexpr const GLenum WglAccessReadOnly = GLenum(0x0000);
+
+    struct DxInterop {
+        ID3D11Device* device = nullptr;
+        HANDLE interopDevice = nullptr;
+        PFNWGLDXOPENDEVICENV openDevice = nullptr;
+        PFNWGLDXCLOSEDEVICENV closeDevice = nullptr;
+        PFNWGLDXREGISTEROBJECTNV registerObject = nullptr;
+        PFNWGLDXUNREGISTEROBJECTNV unregisterObject = nullptr;
+        PFNWGLDXLOCKOBJECTSNV lockObjects = nullptr;
+        PFNWGLDXUNLOCKOBJECTSNV unlockObjects = nullptr;
+    };
+
+    // Returns nullptr if the interop is not available. The D3D11 device is shared by
+    // all browsers and lives until the application ends
+    DxInterop* dxInterop() {
+        static bool isInitialized = false;
+        static DxInterop interop;
+        static bool isSupported = false;
+        if (isInitialized) {
+            return isSupported ? &interop : nullptr;
+        }
+        isInitialized = true;
+
+        interop.openDevice = reinterpret_cast<PFNWGLDXOPENDEVICENV>(
+            wglGetProcAddress("wglDXOpenDeviceNV")
+        );
+        interop.closeDevice = reinterpret_cast<PFNWGLDXCLOSEDEVICENV>(
+            wglGetProcAddress("wglDXCloseDeviceNV")
+        );
+        interop.registerObject = reinterpret_cast<PFNWGLDXREGISTEROBJECTNV>(
+            wglGetProcAddress("wglDXRegisterObjectNV")
+        );
+        interop.unregisterObject = reinterpret_cast<PFNWGLDXUNREGISTEROBJECTNV>(
+            wglGetProcAddress("wglDXUnregisterObjectNV")
+        );
+        interop.lockObjects = reinterpret_cast<PFNWGLDXLOCKOBJECTSNV>(
+            wglGetProcAddress("wglDXLockObjectsNV")
+        );
+        interop.unlockObjects = reinterpret_cast<PFNWGLDXUNLOCKOBJECTSNV>(
+            wglGetProcAddress("wglDXUnlockObjectsNV")
+        );
+        if (!interop.openDevice || !interop.closeDevice || !interop.registerObject ||
+            !interop.unregisterObject || !interop.lockObjects || !interop.unlockObjects)
+        {
+            LINFO("WGL_NV_DX_interop2 is not supported, using pixel buffer uploads");
+            return nullptr;
+        }
+
+        HRESULT res = D3D11CreateDevice(
+            nullptr,
+            D3D_DRIVER_TYPE_HARDWARE,
+            nullptr,
+            0,
+            nullptr,
+            0,
+            D3D11_SDK_VERSION,
+            &interop.device,
+            nullptr,
+            nullptr
+        );
+        if (FAILED(res)) {
+            LWARNING("Could not create D3D11 device for shared browser textures");
+            return nullptr;
+        }
+
+        interop.interopDevice = interop.openDevice(interop.device);
+        if (!interop.interopDevice) {
+            LWARNING("Could not open D3D11 device for OpenGL interop");
+            interop.device->Release();
+            interop.device = nullptr;
+            return nullptr;
+        }
+
+        isSupported = true;
+        return &interop;
+    }
+#endif // WIN32
+} // namespace
 
 namespace openspace {
 
+WebRenderHandler::~WebRenderHandler() {
+    if (_pixelBuffers[0] != 0) {
+        if (_mappedPixelBuffer) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffers[_currentPixelBuffer]);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        glDeleteBuffers(2, _pixelBuffers.data());
+    }
+
+#ifdef WIN32
+    DxInterop* interop = _sharedTextures.empty() ? nullptr : dxInterop();
+    for (std::pair<void* const, SharedTexture>& t : _sharedTextures) {
+        if (interop) {
+            interop->unregisterObject(interop->interopDevice, t.second.interopHandle);
+        }
+        static_cast<ID3D11Texture2D*>(t.second.d3dTexture)->Release();
+        glDeleteTextures(1, &t.second.texture);
+    }
+#endif // WIN32
+}
+
 void WebRenderHandler::reshape(int w, int h) {
     if (w == _windowSize.x && h == _windowSize.y) {
         return;
@@ -46,50 +173,160 @@ void WebRenderHandler::OnPaint(CefRefPtr<CefBrowser>, CefRenderHandler::PaintEle
                                const CefRenderHandler::RectList& dirtyRects,
                                const void* buffer, int w, int h)
 {
+    // The browser is drawn in every frame, but a repaint usually follows an interaction
+    // with it that changes the scene as well
+    global::renderEngine.requestRedraw();
+
+    const glm::ivec2 size = glm::ivec2(w, h);
+    const Pixel* pixels = reinterpret_cast<const Pixel*>(buffer);
     const size_t bufferSize = static_cast<size_t>(w * h);
 
-    glm::ivec2 upperUpdatingRectBound = glm::ivec2(0, 0);
-    glm::ivec2 lowerUpdatingRectBound = glm::ivec2(w, h);
+    if (_alphaMask.size() != bufferSize) {
+        _alphaMask.resize(bufferSize);
+    }
 
-    if (_needsRepaint || _browserBuffer.size() != bufferSize) {
-        _browserBufferSize = glm::ivec2(w, h);
-        _browserBuffer.resize(w * h, Pixel(0));
+    if (_needsRepaint || size != _browserBufferSize || !_mappedPixelBuffer ||
+        size != _pixelBufferSize)
+    {
+        // The pixel buffer objects only match the size of the browser from the frame
+        // after a resize on, until then the whole view is uploaded from memory
+        _browserBufferSize = size;
+        _browserBuffer.assign(pixels, pixels + bufferSize);
+        for (size_t i = 0; i < bufferSize; ++i) {
+            _alphaMask[i] = pixels[i].a;
+        }
+        _pendingRects.clear();
         _textureSizeIsDirty = true;
-        _upperDirtyRectBound = upperUpdatingRectBound = glm::ivec2(w, h);
-        _lowerDirtyRectBound = lowerUpdatingRectBound = glm::ivec2(0, 0);
+        _needsRepaint = false;
+        return;
     }
 
     for (const CefRect& r : dirtyRects) {
-        lowerUpdatingRectBound = glm::min(lowerUpdatingRectBound, glm::ivec2(r.x, r.y));
-        upperUpdatingRectBound = glm::max(
-            upperUpdatingRectBound,
-            glm::ivec2(r.x + r.width, r.y + r.height)
+        const glm::ivec2 lower = glm::clamp(glm::ivec2(r.x, r.y), glm::ivec2(0), size);
+        const glm::ivec2 upper = glm::clamp(
+            glm::ivec2(r.x + r.width, r.y + r.height),
+            glm::ivec2(0),
+            size
         );
+        if (upper.x <= lower.x || upper.y <= lower.y) {
+            continue;
+        }
 
+        const int rectWidth = upper.x - lower.x;
+        for (int y = lower.y; y < upper.y; ++y) {
+            const int lineOffset = y * w + lower.x;
+            std::memcpy(
+                _mappedPixelBuffer + lineOffset,
+                pixels + lineOffset,
+                rectWidth * sizeof(Pixel)
+            );
+            for (int x = 0; x < rectWidth; ++x) {
+                _alphaMask[lineOffset + x] = pixels[lineOffset + x].a;
+            }
+        }
+        _pendingRects.emplace_back(lower.x, lower.y, rectWidth, upper.y - lower.y);
+        _textureIsDirty = true;
     }
+}
 
-    const glm::ivec2 rectSize = upperUpdatingRectBound - lowerUpdatingRectBound;
-    if (rectSize.x > 0 && rectSize.y > 0) {
-        _textureIsDirty = true;
-    } else {
+void WebRenderHandler::OnAcceleratedPaint(CefRefPtr<CefBrowser>,
+                                          CefRenderHandler::PaintElementType type,
+                                          const CefRenderHandler::RectList&,
+                                          void* sharedHandle)
+{
+    global::renderEngine.requestRedraw();
+
+#ifdef WIN32
+    DxInterop* interop = dxInterop();
+    if (!interop || type != PET_VIEW) {
         return;
     }
 
-    // Copy the updated rectangle line by line.
-    for (int y = lowerUpdatingRectBound.y; y < upperUpdatingRectBound.y; ++y) {
-        int lineOffset = y * w + lowerUpdatingRectBound.x;
-        int rectWidth = upperUpdatingRectBound.x - lowerUpdatingRectBound.x;
-        std::copy(
-            reinterpret_cast<const Pixel*>(buffer) + lineOffset,
-            reinterpret_cast<const Pixel*>(buffer) + lineOffset + rectWidth,
-            _browserBuffer.data() + lineOffset
+    auto it = _sharedTextures.find(sharedHandle);
+    if (it == _sharedTextures.end()) {
+        SharedTexture t;
+        ID3D11Texture2D* d3dTexture = nullptr;
+        HRESULT res = interop->device->OpenSharedResource(
+            sharedHandle,
+            __uuidof(ID3D11Texture2D),
+            reinterpret_cast<void**>(&d3dTexture)
         );
+        if (FAILED(res)) {
+            LERROR("Could not open shared browser texture");
+            return;
+        }
+        D3D11_TEXTURE2D_DESC desc;
+        d3dTexture->GetDesc(&desc);
+        t.d3dTexture = d3dTexture;
+        t.size = glm::ivec2(desc.Width, desc.Height);
+
+        glGenTextures(1, &t.texture);
+        t.interopHandle = interop->registerObject(
+            interop->interopDevice,
+            d3dTexture,
+            t.texture,
+            GL_TEXTURE_2D,
+            WglAccessReadOnly
+        );
+        if (!t.interopHandle) {
+            LERROR("Could not register shared browser texture with OpenGL");
+            glDeleteTextures(1, &t.texture);
+            d3dTexture->Release();
+            return;
+        }
+        it = _sharedTextures.emplace(sharedHandle, t).first;
     }
+    SharedTexture& shared = it->second;
 
-    // Add the dirty rect bounds to the GPU texture dirty rect.
-    _lowerDirtyRectBound = glm::min(lowerUpdatingRectBound, _lowerDirtyRectBound);
-    _upperDirtyRectBound = glm::max(upperUpdatingRectBound, _upperDirtyRectBound);
+    if (shared.size != _browserBufferSize || _needsRepaint) {
+        _browserBufferSize = shared.size;
+        glBindTexture(GL_TEXTURE_2D, _texture);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RGBA8,
+            _browserBufferSize.x,
+            _browserBufferSize.y,
+            0,
+            GL_BGRA_EXT,
+            GL_UNSIGNED_BYTE,
+            nullptr
+        );
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // CEF reuses the shared texture as soon as we return, so it is copied right away.
+    // This is called from the message loop work in the render thread, so the OpenGL
+    // context is current
+    HANDLE handle = shared.interopHandle;
+    interop->lockObjects(interop->interopDevice, 1, &handle);
+    glCopyImageSubData(
+        shared.texture, GL_TEXTURE_2D, 0, 0, 0, 0,
+        _texture, GL_TEXTURE_2D, 0, 0, 0, 0,
+        _browserBufferSize.x, _browserBufferSize.y, 1
+    );
+    interop->unlockObjects(interop->interopDevice, 1, &handle);
+
+    _alphaMask.clear();
+    _textureSizeIsDirty = false;
+    _textureIsDirty = false;
     _needsRepaint = false;
+#else
+    (void)type;
+    (void)sharedHandle;
+#endif // WIN32
+}
+
+bool WebRenderHandler::isAcceleratedPaintSupported() {
+#ifdef WIN32
+    return dxInterop() != nullptr;
+#else
+    return false;
+#endif // WIN32
 }
 
 void WebRenderHandler::updateTexture() {
@@ -115,42 +352,90 @@ void WebRenderHandler::updateTexture() {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glBindTexture(GL_TEXTURE_2D, 0);
-    } else if (_textureIsDirty) {
-        glBindTexture(GL_TEXTURE_2D, _texture);
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, _browserBufferSize.x);
 
-        glTexSubImage2D(
-            GL_TEXTURE_2D,
-            0,
-            _lowerDirtyRectBound.x,
-            _lowerDirtyRectBound.y,
-            _upperDirtyRectBound.x - _lowerDirtyRectBound.x,
-            _upperDirtyRectBound.y - _lowerDirtyRectBound.y,
-            GL_BGRA_EXT,
-            GL_UNSIGNED_BYTE,
-            reinterpret_cast<char*>(
-                _browserBuffer.data() +
-                _lowerDirtyRectBound.y * _browserBufferSize.x + _lowerDirtyRectBound.x
-            )
-        );
+        // From now on, the pixels go straight into the pixel buffer objects
+        _browserBuffer.clear();
+        _browserBuffer.shrink_to_fit();
+    }
 
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    if (_mappedPixelBuffer) {
+        GLuint pbo = _pixelBuffers[_currentPixelBuffer];
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        _mappedPixelBuffer = nullptr;
+
+        if (_textureIsDirty && !_pendingRects.empty()) {
+            glBindTexture(GL_TEXTURE_2D, _texture);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, _pixelBufferSize.x);
+            // Only the pending rectangles are up to date in this buffer
+            for (const CefRect& r : _pendingRects) {
+                const size_t offset = static_cast<size_t>(r.y) * _pixelBufferSize.x + r.x;
+                glTexSubImage2D(
+                    GL_TEXTURE_2D,
+                    0,
+                    r.x,
+                    r.y,
+                    r.width,
+                    r.height,
+                    GL_BGRA_EXT,
+                    GL_UNSIGNED_BYTE,
+                    reinterpret_cast<void*>(offset * sizeof(Pixel))
+                );
+            }
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        _currentPixelBuffer = 1 - _currentPixelBuffer;
+    }
+    _pendingRects.clear();
+
+    if (_sharedTextures.empty()) {
+        mapPixelBuffer();
     }
 
-    _upperDirtyRectBound = glm::ivec2(0, 0);
-    _lowerDirtyRectBound = glm::ivec2(_browserBufferSize.x, _browserBufferSize.y);
     _textureSizeIsDirty = false;
     _textureIsDirty = false;
 }
 
+void WebRenderHandler::mapPixelBuffer() {
+    const GLsizeiptr size = static_cast<GLsizeiptr>(
+        _browserBufferSize.x * _browserBufferSize.y * sizeof(Pixel)
+    );
+    if (size == 0) {
+        return;
+    }
+
+    if (_pixelBuffers[0] == 0 || _pixelBufferSize != _browserBufferSize) {
+        if (_pixelBuffers[0] == 0) {
+            glGenBuffers(2, _pixelBuffers.data());
+        }
+        _pixelBufferSize = _browserBufferSize;
+        for (GLuint pbo : _pixelBuffers) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffers[_currentPixelBuffer]);
+    // The previous content is never needed, as only the rectangles that are written
+    // during the next frame are uploaded from this buffer
+    _mappedPixelBuffer = reinterpret_cast<Pixel*>(glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER,
+        0,
+        size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+    ));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
 bool WebRenderHandler::hasContent(int x, int y) {
-    if (_browserBuffer.empty()) {
+    if (_alphaMask.empty()) {
         return false;
     }
     int index = x + (_browserBufferSize.x * y);
-    index = glm::clamp(index, 0, static_cast<int>(_browserBuffer.size() - 1));
-    return _browserBuffer[index].a;
+    index = glm::clamp(index, 0, static_cast<int>(_alphaMask.size() - 1));
+    return _alphaMask[index] != 0;
 }
 
 bool WebRenderHandler::isTextureReady() const {
@@ -34,6 +34,19 @@ uint fragmentIndices[MAX_LAYERS];
 layout (binding = 0, r32ui) uniform uimage2D anchorPointerTexture;
 layout (binding = 1, rgba32ui) uniform uimageBuffer fragmentTexture;
 layout (binding = 0, offset = 0) uniform atomic_uint atomicCounterBuffer;
+// Number of fragments that fit into the fragment texture, written by the renderer
+layout (binding = 0, offset = 4) uniform atomic_uint fragmentCapacity;
+
+// Per pixel sums of the fragments that did not fit into the fragment texture:
+// premultiplied rgb, alpha, optical depth and the inverted bits of the nearest depth
+layout (std430, binding = 2) buffer OverflowBuffer {
+    uint overflowData[];
+};
+
+#define OVERFLOW_STRIDE 6
+#define OVERFLOW_PRECISION 1024.0
+#define OVERFLOW_MAX_COLOR 16.0
+#define OVERFLOW_MAX_OPTICAL_DEPTH 10.0
 
 const uint NULL_POINTER = 0;
 
@@ -48,6 +61,59 @@ ABufferFragment loadFragment(uint index) {
     return aBufferFragment;
 }
 
+uint overflowIndex() {
+    ivec2 size = imageSize(anchorPointerTexture);
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    return uint(pixel.y * size.x + pixel.x) * OVERFLOW_STRIDE;
+}
+
+/**
+ * Accumulates a fragment that did not fit into the fragment texture. These fragments are
+ * blended independent of their order, weighted by their alpha, and only the nearest
+ * depth of them is kept
+ */
+void storeOverflowFragment(vec4 color, float depth) {
+    uint index = overflowIndex();
+    float alpha = clamp(color.a, 0.0, 1.0);
+    vec3 premultiplied = clamp(color.rgb, 0.0, OVERFLOW_MAX_COLOR) * alpha;
+    float opticalDepth = min(-log(max(1.0 - alpha, 1e-5)), OVERFLOW_MAX_OPTICAL_DEPTH);
+
+    atomicAdd(overflowData[index], uint(premultiplied.r * OVERFLOW_PRECISION));
+    atomicAdd(overflowData[index + 1], uint(premultiplied.g * OVERFLOW_PRECISION));
+    atomicAdd(overflowData[index + 2], uint(premultiplied.b * OVERFLOW_PRECISION));
+    atomicAdd(overflowData[index + 3], uint(alpha * OVERFLOW_PRECISION));
+    atomicAdd(overflowData[index + 4], uint(opticalDepth * OVERFLOW_PRECISION));
+    // Positive floats keep their order when their bits are compared as integers. The
+    // buffer is cleared to zero, so the inverted bits are maximized instead
+    atomicMax(overflowData[index + 5], ~floatBitsToUint(max(depth, 0.0)));
+}
+
+/**
+ * Loads the average color and the combined opacity of all fragments of this pixel that
+ * did not fit into the fragment texture, together with the nearest of their depths.
+ * Returns false if there were no such fragments
+ */
+bool loadOverflowFragments(out vec4 color, out float depth) {
+    uint index = overflowIndex();
+    float alpha = float(overflowData[index + 3]) / OVERFLOW_PRECISION;
+    if (alpha <= 0.0) {
+        color = vec4(0.0);
+        depth = 0.0;
+        return false;
+    }
+
+    vec3 premultiplied = vec3(
+        overflowData[index],
+        overflowData[index + 1],
+        overflowData[index + 2]
+    ) / OVERFLOW_PRECISION;
+    float opticalDepth = float(overflowData[index + 4]) / OVERFLOW_PRECISION;
+
+    color = vec4(premultiplied / alpha, 1.0 - exp(-opticalDepth));
+    depth = uintBitsToFloat(~overflowData[index + 5]);
+    return true;
+}
+
 /**
  * Load fragments into the #fragments array.
  */ 
@@ -43,6 +43,10 @@ void main() {
 
     
     uint newHead = atomicCounterIncrement(atomicCounterBuffer);
+    if (newHead >= atomicCounter(fragmentCapacity)) {
+        // ABuffer is full. The bounds of a raycaster cannot be blended, so they are lost
+        discard;
+    }
     uint prevHead = imageAtomicExchange(anchorPointerTexture, ivec2(gl_FragCoord.xy), newHead);
 
     ABufferFragment aBufferFrag;
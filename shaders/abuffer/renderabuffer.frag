@@ -51,8 +51,10 @@ void main() {
 
     if (storeInAbuffer) {
         uint newHead = atomicCounterIncrement(atomicCounterBuffer);
-        if (newHead >= #{rendererData.maxTotalFragments}) {
-            discard; // ABuffer is full!
+        if (newHead >= atomicCounter(fragmentCapacity)) {
+            // ABuffer is full, fall back to order-independent blending
+            storeOverflowFragment(frag.color, frag.depth);
+            discard;
         }
         uint prevHead = imageAtomicExchange(anchorPointerTexture, ivec2(gl_FragCoord.xy), newHead);
 
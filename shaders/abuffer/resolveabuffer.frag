@@ -145,6 +145,16 @@ void main() {
     }
 
 
+    // Fragments that did not fit into the ABuffer are blended behind the sorted ones,
+    // unless even the nearest of them is hidden by the opaque geometry
+    vec4 overflowColor;
+    float overflowDepth;
+    if (loadOverflowFragments(overflowColor, overflowDepth) && overflowDepth < fboDepth) {
+        vec3 color = pow(overflowColor.rgb, vec3(gamma));
+        accumulatedColor += (1 - accumulatedAlpha) * color * overflowColor.a;
+        accumulatedAlpha += (1 - accumulatedAlpha) * overflowColor.aaa;
+    }
+
     accumulatedAlpha = clamp(accumulatedAlpha, 0.0, 1.0);
     //maccumulatedAlpha = vec3(0.0);
     accumulatedColor += (1 - accumulatedAlpha) * pow(fboRgba.rgb, vec3(gamma));
@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+// Raycasts all volumes of a frame in a single pass. The entry and exit points of each
+// volume are stored in one layer of the entry and exit textures as the position in the
+// local coordinates of the volume and the linear depth of that point, where a negative
+// depth marks pixels that are not covered by the volume. The ray advances through all
+// volumes in lock-step in units of depth, so that overlapping volumes are composited in
+// the correct order
+
+uniform sampler2DArray entryTexture;
+uniform sampler2DArray exitTexture;
+uniform sampler2DMS mainDepthTexture;
+uniform int nAaSamples;
+// The factor by which the raycasting resolution is reduced relative to mainDepthTexture
+uniform float downscaleRenderConst = 1.0;
+
+#for id, raycaster in raycasters
+uniform bool insideRaycaster#{raycaster.id};
+uniform vec3 cameraPosInRaycaster#{raycaster.id};
+#endfor
+
+#include "blending.glsl"
+#include "rand.glsl"
+#include "floatoperations.glsl"
+
+#for index, helperPath in helperPaths
+#include <#{helperPath}>
+#endfor
+
+#for id, raycaster in raycasters
+#include <#{raycaster.raycastPath}>
+#endfor
+
+out vec4 finalColor;
+
+#define ALPHA_LIMIT 0.99
+#define RAYCAST_MAX_STEPS 1000
+#define N_RAYCASTERS #{nRaycasters}
+
+void main() {
+    ivec2 depthCoord = min(
+        ivec2(gl_FragCoord.xy / downscaleRenderConst),
+        textureSize(mainDepthTexture) - 1
+    );
+
+    vec3 entryPos[N_RAYCASTERS];
+    vec3 direction[N_RAYCASTERS];
+    float entryDepth[N_RAYCASTERS];
+    float exitDepth[N_RAYCASTERS];
+    // The distance in local coordinates of a volume that corresponds to one unit of depth
+    float localScale[N_RAYCASTERS];
+
+    float rayStart = 3.402823466e38;
+    float rayEnd = 0.0;
+
+#for id, raycaster in raycasters
+    {
+        const int i = #{raycaster.layer};
+        vec4 entryPoint = texelFetch(entryTexture, ivec3(depthCoord, i), 0);
+        vec4 exitPoint = texelFetch(exitTexture, ivec3(depthCoord, i), 0);
+        if (insideRaycaster#{raycaster.id}) {
+            entryPoint = vec4(cameraPosInRaycaster#{raycaster.id}, 0.0);
+        }
+
+        vec3 diff = exitPoint.xyz - entryPoint.xyz;
+        float depthRange = exitPoint.w - entryPoint.w;
+        if (entryPoint.w >= 0.0 && depthRange > 0.0 && length(diff) > 0.0) {
+            entryPos[i] = entryPoint.xyz;
+            direction[i] = normalize(diff);
+            localScale[i] = length(diff) / depthRange;
+            entryDepth[i] = entryPoint.w;
+            exitDepth[i] = exitPoint.w;
+            rayStart = min(rayStart, entryDepth[i]);
+            rayEnd = max(rayEnd, exitDepth[i]);
+        }
+        else {
+            entryDepth[i] = -1.0;
+            exitDepth[i] = -1.0;
+        }
+    }
+#endfor
+
+    // The ray stops at the farthest geometry sample, just like for a single volume
+    float geoDepth = 0.0;
+    for (int s = 0; s < nAaSamples; ++s) {
+        geoDepth = max(
+            geoDepth,
+            denormalizeFloat(texelFetch(mainDepthTexture, depthCoord, s).x)
+        );
+    }
+    float rayLimit = min(rayEnd, geoDepth);
+    if (rayLimit <= rayStart) {
+        discard;
+    }
+
+    float jitterFactor = 0.5 + 0.5 * rand(gl_FragCoord.xy); // should be between 0.5 and 1.0
+    float currentDepth = rayStart;
+    float nextStepSize = rayLimit - rayStart;
+
+#for id, raycaster in raycasters
+    {
+        const int i = #{raycaster.layer};
+        if (entryDepth[i] >= 0.0) {
+            if (entryDepth[i] > currentDepth) {
+                nextStepSize = min(nextStepSize, entryDepth[i] - currentDepth);
+            }
+            else {
+                nextStepSize = min(
+                    nextStepSize,
+                    stepSize#{raycaster.id}(entryPos[i], direction[i]) / localScale[i]
+                );
+            }
+        }
+    }
+#endfor
+
+    vec3 accumulatedColor = vec3(0.0);
+    vec3 accumulatedAlpha = vec3(0.0);
+
+    for (int steps = 0; (accumulatedAlpha.r < ALPHA_LIMIT || accumulatedAlpha.g < ALPHA_LIMIT || accumulatedAlpha.b < ALPHA_LIMIT) && steps < RAYCAST_MAX_STEPS; ++steps) {
+        bool shortStepSize = nextStepSize < (rayLimit - rayStart) / 10000000000.0;
+        if (currentDepth + nextStepSize * jitterFactor > rayLimit || shortStepSize) {
+            break;
+        }
+
+        float currentStepSize = nextStepSize;
+        float sampleDepth = currentDepth + currentStepSize * jitterFactor;
+        currentDepth += currentStepSize;
+        nextStepSize = rayLimit - currentDepth;
+
+#for id, raycaster in raycasters
+        {
+            const int i = #{raycaster.layer};
+            if (entryDepth[i] >= 0.0) {
+                if (sampleDepth >= entryDepth[i] && sampleDepth <= exitDepth[i]) {
+                    vec3 position = entryPos[i] +
+                        direction[i] * ((sampleDepth - entryDepth[i]) * localScale[i]);
+                    float localStepSize = currentStepSize * localScale[i];
+                    sample#{raycaster.id}(
+                        position,
+                        direction[i],
+                        accumulatedColor,
+                        accumulatedAlpha,
+                        localStepSize
+                    );
+                    nextStepSize = min(nextStepSize, localStepSize / localScale[i]);
+                }
+                else if (currentDepth < entryDepth[i]) {
+                    // Step straight to the entry point of a volume that is still ahead
+                    nextStepSize = min(nextStepSize, entryDepth[i] - currentDepth);
+                }
+                else if (currentDepth < exitDepth[i]) {
+                    // The ray has just entered this volume
+                    vec3 position = entryPos[i] +
+                        direction[i] * ((currentDepth - entryDepth[i]) * localScale[i]);
+                    nextStepSize = min(
+                        nextStepSize,
+                        stepSize#{raycaster.id}(position, direction[i]) / localScale[i]
+                    );
+                }
+            }
+        }
+#endfor
+    }
+
+    finalColor = vec4(accumulatedColor, (accumulatedAlpha.r + accumulatedAlpha.g + accumulatedAlpha.b) / 3);
+    if (finalColor.a <= 0.0) {
+        discard;
+    }
+
+    finalColor.rgb /= finalColor.a;
+    gl_FragDepth = normalizeFloat(rayStart);
+}
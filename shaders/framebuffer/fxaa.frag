@@ -0,0 +1,95 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+layout (location = 0) out vec4 finalColor;
+
+in vec2 vs_position;
+
+uniform sampler2D sourceTexture;
+// The fraction of the source texture that contains the rendered image
+uniform vec2 sourceSize;
+
+// Fast approximate antialiasing, which blurs the image along the edges that it detects
+// in the luminance of the neighboring texels
+#define FXAA_SPAN_MAX 8.0
+#define FXAA_REDUCE_MUL (1.0 / 8.0)
+#define FXAA_REDUCE_MIN (1.0 / 128.0)
+
+vec2 texelSize;
+
+vec3 fetch(vec2 texCoord) {
+    // The texels outside of the rendered image must not be filtered into the edges
+    return texture(sourceTexture, min(texCoord, sourceSize - 0.5 * texelSize)).rgb;
+}
+
+float luminance(vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+void main() {
+    texelSize = 1.0 / vec2(textureSize(sourceTexture, 0));
+    vec2 texCoord = (vs_position * 0.5 + 0.5) * sourceSize;
+
+    vec3 colorM = fetch(texCoord);
+    float lumaNW = luminance(fetch(texCoord + vec2(-1.0, -1.0) * texelSize));
+    float lumaNE = luminance(fetch(texCoord + vec2( 1.0, -1.0) * texelSize));
+    float lumaSW = luminance(fetch(texCoord + vec2(-1.0,  1.0) * texelSize));
+    float lumaSE = luminance(fetch(texCoord + vec2( 1.0,  1.0) * texelSize));
+    float lumaM = luminance(colorM);
+
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    // The direction of the blur is perpendicular to the gradient of the luminance
+    vec2 dir = vec2(
+        -((lumaNW + lumaNE) - (lumaSW + lumaSE)),
+        (lumaNW + lumaSW) - (lumaNE + lumaSE)
+    );
+    float dirReduce = max(
+        (lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * FXAA_REDUCE_MUL),
+        FXAA_REDUCE_MIN
+    );
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * texelSize;
+
+    vec3 colorA = 0.5 * (
+        fetch(texCoord + dir * (1.0 / 3.0 - 0.5)) +
+        fetch(texCoord + dir * (2.0 / 3.0 - 0.5))
+    );
+    vec3 colorB = colorA * 0.5 + 0.25 * (
+        fetch(texCoord + dir * -0.5) +
+        fetch(texCoord + dir * 0.5)
+    );
+
+    // Fall back to the narrower blur if the wide one crosses into another edge
+    float lumaB = luminance(colorB);
+    if (lumaB < lumaMin || lumaB > lumaMax) {
+        finalColor = vec4(colorA, 1.0);
+    }
+    else {
+        finalColor = vec4(colorB, 1.0);
+    }
+}
@@ -0,0 +1,84 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+#include "floatoperations.glsl"
+
+layout (location = 0) out vec4 finalColor;
+
+uniform sampler2D downscaledVolume;
+uniform sampler2DMS mainDepthTexture;
+uniform float downscaleFactor;
+// The number of texels in downscaledVolume that contain the raycast volume
+uniform ivec2 downscaledSize;
+
+// Relative depth difference around which the weight of a sample is halved
+#define DEPTH_TOLERANCE 0.01
+
+void main() {
+    ivec2 fullResolution = textureSize(mainDepthTexture);
+    float depth = denormalizeFloat(
+        texelFetch(mainDepthTexture, ivec2(gl_FragCoord.xy), 0).x
+    );
+
+    // The position of this pixel in the texel space of the downscaled volume
+    vec2 downscaledPos = gl_FragCoord.xy * downscaleFactor - 0.5;
+    ivec2 base = ivec2(floor(downscaledPos));
+    vec2 f = fract(downscaledPos);
+
+    // Bilinear upsampling of the premultiplied colors of the four closest samples, which
+    // are weighted down by the difference between the geometry depth that each sample
+    // was raycast against and the geometry depth of this pixel
+    vec4 color = vec4(0.0);
+    float totalWeight = 0.0;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            ivec2 texel = clamp(base + ivec2(x, y), ivec2(0), downscaledSize - 1);
+            ivec2 depthCoord = min(
+                ivec2((vec2(texel) + 0.5) / downscaleFactor),
+                fullResolution - 1
+            );
+            float sampleDepth = denormalizeFloat(
+                texelFetch(mainDepthTexture, depthCoord, 0).x
+            );
+
+            float relativeDifference = abs(depth - sampleDepth) /
+                                       max(abs(depth), 1e-6);
+            float depthWeight = DEPTH_TOLERANCE / (DEPTH_TOLERANCE + relativeDifference);
+            float bilinearWeight = (x == 1 ? f.x : 1.0 - f.x) * (y == 1 ? f.y : 1.0 - f.y);
+            float weight = bilinearWeight * depthWeight + 1e-6;
+
+            vec4 s = texelFetch(downscaledVolume, texel, 0);
+            color += vec4(s.rgb * s.a, s.a) * weight;
+            totalWeight += weight;
+        }
+    }
+    color /= totalWeight;
+
+    if (color.a <= 0.0) {
+        discard;
+    }
+    finalColor = vec4(color.rgb / color.a, color.a);
+}
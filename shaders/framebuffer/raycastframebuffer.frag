@@ -31,6 +31,8 @@ uniform sampler2DMS mainDepthTexture;
 uniform bool insideRaycaster;
 uniform vec3 cameraPosInRaycaster;
 uniform vec2 windowSize;
+// The factor by which the raycasting resolution is reduced relative to mainDepthTexture
+uniform float downscaleRenderConst = 1.0;
 
 #include "blending.glsl"
 #include "rand.glsl"
@@ -81,8 +83,12 @@ void main() {
     int i, j;
     float tmp;
 
+    ivec2 depthCoord = min(
+        ivec2(gl_FragCoord.xy / downscaleRenderConst),
+        textureSize(mainDepthTexture) - 1
+    );
     for (i = 0; i < nAaSamples; i++) {
-        float geoDepth = denormalizeFloat(texelFetch(mainDepthTexture, ivec2(gl_FragCoord), i).x);
+        float geoDepth = denormalizeFloat(texelFetch(mainDepthTexture, depthCoord, i).x);
         float geoRatio = clamp((geoDepth - entryDepth) / (exitDepth - entryDepth), 0.0, 1.0);
         raycastDepths[i] = geoRatio * raycastDepth;
     }
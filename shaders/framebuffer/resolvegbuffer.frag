@@ -0,0 +1,60 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+layout (location = 0) out vec4 resolvedColor;
+layout (location = 1) out vec4 resolvedPosition;
+layout (location = 2) out vec4 resolvedNormal;
+
+uniform sampler2DMS mainColorTexture;
+uniform sampler2DMS mainPositionTexture;
+uniform sampler2DMS mainNormalTexture;
+uniform int nAaSamples;
+
+void main() {
+    ivec2 fragCoords = ivec2(gl_FragCoord.xy);
+
+    vec4 color = texelFetch(mainColorTexture, fragCoords, 0);
+    vec4 position = texelFetch(mainPositionTexture, fragCoords, 0);
+
+    // A pixel is on an edge if its samples were covered by different fragments
+    bool isEdge = false;
+    for (int i = 1; i < nAaSamples; i++) {
+        if (texelFetch(mainColorTexture, fragCoords, i) != color ||
+            texelFetch(mainPositionTexture, fragCoords, i) != position)
+        {
+            isEdge = true;
+            break;
+        }
+    }
+
+    resolvedColor = color;
+    resolvedPosition = position;
+    resolvedNormal = texelFetch(mainNormalTexture, fragCoords, 0);
+
+    // The depth is used as a mask that separates the pixels that are shaded once from
+    // the edge pixels that are shaded per sample from the multisampled G-buffer
+    gl_FragDepth = isEdge ? 0.0 : 1.0;
+}
@@ -0,0 +1,47 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "fragment.glsl"
+
+uniform sampler2D splatTexture;
+uniform ivec2 viewportOffset;
+
+// The stars are placed behind everything else
+const float StarDepth = 3.08567758e19; // 1000 pc
+
+Fragment getFragment() {
+    vec3 color = texelFetch(splatTexture, ivec2(gl_FragCoord.xy) - viewportOffset, 0).rgb;
+    if (all(equal(color, vec3(0.0)))) {
+        discard;
+    }
+
+    Fragment frag;
+    frag.color = vec4(color, 1.0);
+    frag.depth = StarDepth;
+    frag.gPosition = vec4(0.0, 0.0, 0.0, 1.0);
+    frag.gNormal = vec4(0.0, 0.0, 0.0, 1.0);
+    frag.blend = BLEND_MODE_ADDITIVE;
+    return frag;
+}
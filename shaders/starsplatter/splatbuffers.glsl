@@ -0,0 +1,61 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef _SPLATBUFFERS_GLSL_
+#define _SPLATBUFFERS_GLSL_
+
+// Keep in sync with starsplatter.cpp
+const int TileSize = 16;
+const uint MaxStarsPerTile = 256;
+const uint MaxBrightStars = 65536;
+const float MaxPsfRadius = 64.0;
+
+// The faint stars are added as fixed-point numbers, as there are no atomic operations
+// for floating point values
+const float FixedPointScale = 1024.0;
+
+struct BrightStar {
+    // The center in pixels (xy) and the radius of the point spread function (z)
+    vec4 positionRadius;
+    // The intensity per unit area of the point spread function
+    vec4 color;
+};
+
+// Three channels per pixel, stored row by row
+layout(std430) buffer Accumulation {
+    uint accumulation[];
+};
+
+// The number of stars of each tile, followed by MaxStarsPerTile star indices per tile
+layout(std430) buffer Tiles {
+    uint tiles[];
+};
+
+layout(std430) buffer BrightStars {
+    uint nBrightStars;
+    BrightStar brightStars[];
+};
+
+#endif // _SPLATBUFFERS_GLSL_
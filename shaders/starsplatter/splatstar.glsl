@@ -0,0 +1,47 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef _SPLATSTAR_GLSL_
+#define _SPLATSTAR_GLSL_
+
+// The interface between the StarSplatter and the shader that provides its stars. The
+// provider is a compute shader that is linked into the splat program and implements the
+// functions declared below
+
+struct SplatStar {
+    // The position in the model coordinates that are passed to StarSplatter::render, in
+    // meters
+    vec3 position;
+    // The absolute magnitude of the star
+    float absoluteMagnitude;
+    // The value that is mapped onto the color texture using the color range
+    float colorValue;
+};
+
+// Reads the star with the 'index', which is smaller than the number of stars that was
+// passed to StarSplatter::render, and returns false if it should not be drawn
+bool splatStar(uint index, out SplatStar star);
+
+#endif // _SPLATSTAR_GLSL_
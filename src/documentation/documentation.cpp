@@ -27,10 +27,15 @@
 #include <openspace/documentation/verifier.h>
 #include <ghoul/misc/dictionary.h>
 #include <algorithm>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 namespace {
 
+// Number of live SpecificationTestBypass objects on the calling thread
+thread_local int SpecificationTestBypassCount = 0;
+
 // Structure used to make offenses unique
 struct OffenseCompare {
     using Offense = openspace::documentation::TestResult::Offense;
@@ -177,11 +182,18 @@ Documentation::Documentation(DocumentationEntries ents)
 
 TestResult testSpecification(const Documentation& documentation,
                              const ghoul::Dictionary& dictionary)
+{
+    return testSpecification(documentation.entries, dictionary);
+}
+
+TestResult testSpecification(const Documentation::DocumentationEntries& entries,
+                             const ghoul::Dictionary& dictionary)
 {
     TestResult result;
     result.success = true;
 
-    auto applyVerifier = [dictionary, &result](Verifier& verifier, const std::string& key)
+    auto applyVerifier = [&dictionary, &result](Verifier& verifier,
+                                                const std::string& key)
     {
         TestResult res = verifier(dictionary, key);
         if (!res.success) {
@@ -199,7 +211,7 @@ TestResult testSpecification(const Documentation& documentation,
         );
     };
 
-    for (const auto& p : documentation.entries) {
+    for (const DocumentationEntry& p : entries) {
         if (p.key == DocumentationEntry::Wildcard) {
             for (const std::string& key : dictionary.keys()) {
                 applyVerifier(*(p.verifier), key);
@@ -217,19 +229,23 @@ TestResult testSpecification(const Documentation& documentation,
 
     // Remove duplicate offenders that might occur if multiple rules apply to a single
     // key and more than one of these rules are broken
-    std::set<TestResult::Offense, OffenseCompare> uniqueOffenders(
-        result.offenses.begin(), result.offenses.end()
-    );
-    result.offenses = std::vector<TestResult::Offense>(
-        uniqueOffenders.begin(), uniqueOffenders.end()
-    );
+    if (result.offenses.size() > 1) {
+        std::set<TestResult::Offense, OffenseCompare> uniqueOffenders(
+            result.offenses.begin(), result.offenses.end()
+        );
+        result.offenses = std::vector<TestResult::Offense>(
+            uniqueOffenders.begin(), uniqueOffenders.end()
+        );
+    }
     // Remove duplicate warnings. This should normally not happen, but we want to be sure
-    std::set<TestResult::Warning, WarningCompare> uniqueWarnings(
-        result.warnings.begin(), result.warnings.end()
-    );
-    result.warnings = std::vector<TestResult::Warning>(
-        uniqueWarnings.begin(), uniqueWarnings.end()
-    );
+    if (result.warnings.size() > 1) {
+        std::set<TestResult::Warning, WarningCompare> uniqueWarnings(
+            result.warnings.begin(), result.warnings.end()
+        );
+        result.warnings = std::vector<TestResult::Warning>(
+            uniqueWarnings.begin(), uniqueWarnings.end()
+        );
+    }
 
     return result;
 }
@@ -237,6 +253,10 @@ TestResult testSpecification(const Documentation& documentation,
 void testSpecificationAndThrow(const Documentation& documentation,
                                const ghoul::Dictionary& dictionary, std::string component)
 {
+    if (SpecificationTestBypassCount > 0) {
+        return;
+    }
+
     // Perform testing against the documentation/specification
     TestResult testResult = testSpecification(documentation, dictionary);
     if (!testResult.success) {
@@ -244,4 +264,43 @@ void testSpecificationAndThrow(const Documentation& documentation,
     }
 }
 
+const Documentation& cachedDocumentation(Documentation (*factory)()) {
+    ghoul_assert(factory, "Factory must not be nullptr");
+
+    // The cache is never cleared, so the references returned from here stay valid for
+    // the lifetime of the application. Element references of an unordered_map are not
+    // invalidated by insertions
+    static std::mutex Mutex;
+    static std::unordered_map<Documentation(*)(), Documentation> Cache;
+
+    std::lock_guard g(Mutex);
+    auto it = Cache.find(factory);
+    if (it == Cache.end()) {
+        it = Cache.emplace(factory, factory()).first;
+    }
+    return it->second;
+}
+
+void testSpecificationAndThrow(Documentation (*factory)(),
+                               const ghoul::Dictionary& dictionary, std::string component)
+{
+    if (SpecificationTestBypassCount > 0) {
+        return;
+    }
+
+    testSpecificationAndThrow(
+        cachedDocumentation(factory),
+        dictionary,
+        std::move(component)
+    );
+}
+
+SpecificationTestBypass::SpecificationTestBypass() {
+    ++SpecificationTestBypassCount;
+}
+
+SpecificationTestBypass::~SpecificationTestBypass() {
+    --SpecificationTestBypassCount;
+}
+
 } // namespace openspace::documentation
@@ -104,14 +104,9 @@ std::string generateJsonDocumentation(const Documentation& d) {
         ReferencingVerifier* rv = dynamic_cast<ReferencingVerifier*>(p.verifier.get());
 
         if (rv) {
-            const std::vector<Documentation>& documentations = DocEng.documentations();
-            auto it = std::find_if(
-                documentations.begin(),
-                documentations.end(),
-                [rv](const Documentation& doc) { return doc.id == rv->identifier; }
-            );
-
-            if (it == documentations.end()) {
+            const Documentation* it = DocEng.documentation(rv->identifier);
+
+            if (!it) {
                 result << R"("reference": { "found": false })";
             } else {
                 result << R"("reference": {)"
@@ -163,16 +158,12 @@ void DocumentationEngine::addDocumentation(Documentation documentation) {
         _documentations.push_back(std::move(documentation));
     }
     else {
-        auto it = std::find_if(
-            _documentations.begin(),
-            _documentations.end(),
-            [documentation](const Documentation& d) { return documentation.id == d.id; }
-        );
-
-        if (it != _documentations.end()) {
+        if (_documentationIndices.find(documentation.id) != _documentationIndices.end())
+        {
             throw DuplicateDocumentationException(std::move(documentation));
         }
         else {
+            _documentationIndices[documentation.id] = _documentations.size();
             _documentations.push_back(std::move(documentation));
         }
     }
@@ -190,6 +181,13 @@ std::vector<Documentation> DocumentationEngine::documentations() const {
     return _documentations;
 }
 
+const Documentation* DocumentationEngine::documentation(
+                                                      const std::string& identifier) const
+{
+    auto it = _documentationIndices.find(identifier);
+    return it != _documentationIndices.end() ? &_documentations[it->second] : nullptr;
+}
+
 void DocumentationEngine::writeDocumentationHtml(const std::string& path,
                                                  std::string data)
 {
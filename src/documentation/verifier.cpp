@@ -186,7 +186,7 @@ TestResult TableVerifier::operator()(const ghoul::Dictionary& dictionary,
 {
     if (dictionary.hasKeyAndValue<Type>(key)) {
         ghoul::Dictionary d = dictionary.value<ghoul::Dictionary>(key);
-        TestResult res = testSpecification({documentations}, d);
+        TestResult res = testSpecification(documentations, d);
 
         // Add the 'key' as a prefix to make the new offender a fully qualified identifer
         for (TestResult::Offense& s : res.offenses) {
@@ -244,48 +244,34 @@ ReferencingVerifier::ReferencingVerifier(std::string id)
 TestResult ReferencingVerifier::operator()(const ghoul::Dictionary& dictionary,
                                            const std::string& key) const
 {
-    TestResult res = TableVerifier::operator()(dictionary, key);
-    if (res.success) {
-        std::vector<Documentation> docs = DocEng.documentations();
-
-        auto it = std::find_if(
-            docs.begin(),
-            docs.end(),
-            [this](const Documentation& doc) { return doc.id == identifier; }
-        );
-
-        if (it == docs.end()) {
-            res.offenses.push_back({
-                key,
-                TestResult::Offense::Reason::UnknownIdentifier
-            });
-            res.success = false;
-            return res;
-        }
-
-        //ghoul_assert(
-        //    it != docs.end(),
-        //    "Did not find referencing identifier '" + identifier + "'"
-        //);
-
-        ghoul::Dictionary d = dictionary.value<ghoul::Dictionary>(key);
-        TestResult r = testSpecification(*it, d);
+    if (!dictionary.hasKeyAndValue<Type>(key)) {
+        // Reuse the TableVerifier's handling of missing or wrongly typed keys
+        return TableVerifier::operator()(dictionary, key);
+    }
 
-        // Add the 'key' as a prefix to make the offender a fully qualified identifer
-        for (TestResult::Offense& s : r.offenses) {
-            s.offender = key + "." + s.offender;
-        }
+    const Documentation* doc = DocEng.documentation(identifier);
+    if (!doc) {
+        return {
+            false,
+            { { key, TestResult::Offense::Reason::UnknownIdentifier } },
+            {}
+        };
+    }
 
-        // Add the 'key' as a prefix to make the warning a fully qualified identifer
-        for (TestResult::Warning& w : r.warnings) {
-            w.offender = key + "." + w.offender;
-        }
+    ghoul::Dictionary d = dictionary.value<ghoul::Dictionary>(key);
+    TestResult r = testSpecification(*doc, d);
 
-        return r;
+    // Add the 'key' as a prefix to make the offender a fully qualified identifer
+    for (TestResult::Offense& s : r.offenses) {
+        s.offender = key + "." + s.offender;
     }
-    else {
-        return res;
+
+    // Add the 'key' as a prefix to make the warning a fully qualified identifer
+    for (TestResult::Warning& w : r.warnings) {
+        w.offender = key + "." + w.offender;
     }
+
+    return r;
 }
 
 std::string ReferencingVerifier::documentation() const {
@@ -307,7 +293,7 @@ TestResult AndVerifier::operator()(const ghoul::Dictionary& dictionary,
         values.begin(),
         values.end(),
         res.begin(),
-        [dictionary, key](const std::shared_ptr<Verifier>& v) {
+        [&dictionary, &key](const std::shared_ptr<Verifier>& v) {
             return v->operator()(dictionary, key);
         }
     );
@@ -369,7 +355,7 @@ TestResult OrVerifier::operator()(const ghoul::Dictionary& dictionary,
         values.begin(),
         values.end(),
         res.begin(),
-        [dictionary, key](const std::shared_ptr<Verifier>& v) {
+        [&dictionary, &key](const std::shared_ptr<Verifier>& v) {
             return v->operator()(dictionary, key);
         }
     );
@@ -56,6 +56,8 @@ namespace {
     constexpr const char* KeyScriptLog = "ScriptLog";
     constexpr const char* KeyShutdownCountdown = "ShutdownCountdown";
     constexpr const char* KeyPerSceneCache = "PerSceneCache";
+    constexpr const char* KeySkipValidatedAssetSpecifications =
+        "SkipValidatedAssetSpecifications";
     constexpr const char* KeyOnScreenTextScaling = "OnScreenTextScaling";
     constexpr const char* KeyRenderingMethod = "RenderingMethod";
     constexpr const char* KeyDisableRenderingOnMaster = "DisableRenderingOnMaster";
@@ -289,6 +291,11 @@ void parseLuaState(Configuration& configuration) {
     getValue(s, KeyScreenshotUseDate, c.shouldUseScreenshotDate);
     getValue(s, KeyOnScreenTextScaling, c.onScreenTextScaling);
     getValue(s, KeyPerSceneCache, c.usePerSceneCache);
+    getValue(
+        s,
+        KeySkipValidatedAssetSpecifications,
+        c.isSkippingValidatedAssetSpecifications
+    );
     getValue(s, KeyDisableRenderingOnMaster, c.isRenderingOnMasterDisabled);
 
     getValue(s, KeyGlobalRotation, c.globalRotation);
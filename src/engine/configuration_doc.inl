@@ -182,6 +182,18 @@ documentation::Documentation Configuration::Documentation = {
             "cases where the same instance of OpenSpace is run with multiple scenes, but "
             "the caches should be retained. This value defaults to 'false'."
         },
+        {
+            KeySkipValidatedAssetSpecifications,
+            new BoolVerifier,
+            Optional::Yes,
+            "If this is set to 'true', the specification tests of scene graph nodes, "
+            "renderables, and other objects are skipped for assets whose path and "
+            "contents match a previous load in which these tests passed. The hashes of "
+            "validated assets are stored in the cache directory. This speeds up loading "
+            "large scenes, but errors in dictionaries created by unchanged assets might "
+            "only be reported by less descriptive messages. This value defaults to "
+            "'false'."
+        },
         {
             KeyOnScreenTextScaling,
             new StringInListVerifier({
@@ -30,7 +30,9 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/thread.h>
+#include <algorithm>
 #include <chrono>
+#include <map>
 #include <thread>
 
 #ifdef OPENSPACE_CURL_ENABLED
@@ -49,6 +51,15 @@
 namespace {
     constexpr const char* _loggerCat = "DownloadManager";
 
+    // The number of transfers that run at the same time. Further transfers are queued
+    constexpr const size_t MaxConcurrentTransfers = 8;
+    // The number of connections that are opened to a single host. With HTTP/2, several
+    // transfers share one connection
+    constexpr const long MaxConnectionsPerHost = 4;
+    // The time that the transfer thread waits for activity on any of the connections
+    // before it checks for newly queued transfers
+    constexpr const int TransferWaitTimeout = 50; // ms
+
     struct ProgressInformation {
         std::shared_ptr<openspace::DownloadManager::FileFuture> future;
         std::chrono::system_clock::time_point startTime;
@@ -121,6 +132,22 @@ namespace {
 
 namespace openspace {
 
+struct DownloadManager::Transfer {
+    CURL* handle = nullptr;
+    Priority priority = Priority::Normal;
+
+    // Set for downloads to a file, which can be aborted through the future
+    std::shared_ptr<FileFuture> future;
+    ProgressInformation progress = { nullptr, {}, nullptr };
+    DownloadProgressCallback progressCallback;
+
+    // The target of downloads into memory
+    MemoryFile memoryFile = { nullptr, 0, "", false };
+
+    // Called with the result once the transfer is done or cancelled
+    std::function<void(Transfer&, CURLcode)> finish;
+};
+
 DownloadManager::FileFuture::FileFuture(std::string file)
     : filePath(std::move(file))
 {}
@@ -129,6 +156,160 @@ DownloadManager::DownloadManager(UseMultipleThreads useMultipleThreads)
     : _useMultithreadedDownload(useMultipleThreads)
 {
     curl_global_init(CURL_GLOBAL_ALL);
+
+    if (_useMultithreadedDownload) {
+        CURLM* multi = curl_multi_init();
+        // NOLINTNEXTLINE
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        // NOLINTNEXTLINE
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, MaxConnectionsPerHost);
+        // NOLINTNEXTLINE
+        curl_multi_setopt(
+            multi,
+            CURLMOPT_MAX_TOTAL_CONNECTIONS,
+            static_cast<long>(MaxConcurrentTransfers)
+        );
+        _multiHandle = multi;
+
+        _transferThread = std::thread([this]() { transferLoop(); });
+        ghoul::thread::setPriority(
+            _transferThread,
+            ghoul::thread::ThreadPriorityClass::Idle,
+            ghoul::thread::ThreadPriorityLevel::Lowest
+        );
+    }
+}
+
+DownloadManager::~DownloadManager() {
+    if (_transferThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            _shouldStop = true;
+        }
+        _queueCondition.notify_one();
+        _transferThread.join();
+    }
+
+    // Transfers that never started are finished as aborted, so that nobody waits on
+    // them forever
+    while (std::unique_ptr<Transfer> transfer = nextQueuedTransfer()) {
+        transfer->finish(*transfer, CURLE_ABORTED_BY_CALLBACK);
+        curl_easy_cleanup(transfer->handle);
+    }
+
+    if (_multiHandle) {
+        curl_multi_cleanup(static_cast<CURLM*>(_multiHandle));
+    }
+}
+
+void DownloadManager::enqueue(std::unique_ptr<Transfer> transfer) {
+    // Prefer HTTP/2 for https connections and wait for an existing connection to be
+    // multiplexed rather than opening a new one
+    curl_easy_setopt(transfer->handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(transfer->handle, CURLOPT_PIPEWAIT, 1L); // NOLINT
+
+    if (!_useMultithreadedDownload) {
+        CURLcode res = curl_easy_perform(transfer->handle);
+        transfer->finish(*transfer, res);
+        curl_easy_cleanup(transfer->handle);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _queues[static_cast<int>(transfer->priority)].push_back(std::move(transfer));
+    }
+    _queueCondition.notify_one();
+}
+
+std::unique_ptr<DownloadManager::Transfer> DownloadManager::nextQueuedTransfer() {
+    for (auto it = _queues.rbegin(); it != _queues.rend(); ++it) {
+        if (!it->empty()) {
+            std::unique_ptr<Transfer> transfer = std::move(it->front());
+            it->pop_front();
+            return transfer;
+        }
+    }
+    return nullptr;
+}
+
+void DownloadManager::transferLoop() {
+    CURLM* multi = static_cast<CURLM*>(_multiHandle);
+    std::map<CURL*, std::unique_ptr<Transfer>> active;
+
+    while (true) {
+        std::vector<std::unique_ptr<Transfer>> cancelled;
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            if (active.empty()) {
+                _queueCondition.wait(lock, [this]() {
+                    return _shouldStop || std::any_of(
+                        _queues.begin(),
+                        _queues.end(),
+                        [](const std::deque<std::unique_ptr<Transfer>>& q) {
+                            return !q.empty();
+                        }
+                    );
+                });
+            }
+            if (_shouldStop) {
+                break;
+            }
+
+            while (active.size() < MaxConcurrentTransfers) {
+                std::unique_ptr<Transfer> transfer = nextQueuedTransfer();
+                if (!transfer) {
+                    break;
+                }
+                if (transfer->future && transfer->future->abortDownload) {
+                    cancelled.push_back(std::move(transfer));
+                    continue;
+                }
+                curl_multi_add_handle(multi, transfer->handle);
+                active.emplace(transfer->handle, std::move(transfer));
+            }
+        }
+
+        // The callbacks are invoked without holding the lock, as they might queue new
+        // transfers
+        for (std::unique_ptr<Transfer>& transfer : cancelled) {
+            transfer->future->isAborted = true;
+            transfer->finish(*transfer, CURLE_ABORTED_BY_CALLBACK);
+            curl_easy_cleanup(transfer->handle);
+        }
+
+        int nRunning = 0;
+        curl_multi_perform(multi, &nRunning);
+
+        int nMessages = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &nMessages)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            // The message is invalidated by removing the handle
+            CURL* handle = msg->easy_handle;
+            const CURLcode res = msg->data.result;
+            curl_multi_remove_handle(multi, handle);
+
+            auto it = active.find(handle);
+            ghoul_assert(it != active.end(), "Finished transfer must be active");
+            std::unique_ptr<Transfer> transfer = std::move(it->second);
+            active.erase(it);
+
+            transfer->finish(*transfer, res);
+            curl_easy_cleanup(handle);
+        }
+
+        if (!active.empty()) {
+            curl_multi_wait(multi, nullptr, 0, TransferWaitTimeout, nullptr);
+        }
+    }
+
+    for (std::pair<CURL* const, std::unique_ptr<Transfer>>& p : active) {
+        curl_multi_remove_handle(multi, p.first);
+        p.second->finish(*p.second, CURLE_ABORTED_BY_CALLBACK);
+        curl_easy_cleanup(p.first);
+    }
 }
 
 std::shared_ptr<DownloadManager::FileFuture> DownloadManager::downloadFile(
@@ -138,7 +319,8 @@ std::shared_ptr<DownloadManager::FileFuture> DownloadManager::downloadFile(
                                                                   FailOnError failOnError,
                                                                 unsigned int timeout_secs,
                                                 DownloadFinishedCallback finishedCallback,
-                                                DownloadProgressCallback progressCallback)
+                                                DownloadProgressCallback progressCallback,
+                                                                        Priority priority)
 {
     if (!overrideFile && FileSys.fileExists(file)) {
         return nullptr;
@@ -163,105 +345,90 @@ std::shared_ptr<DownloadManager::FileFuture> DownloadManager::downloadFile(
             "Could not open/create file:" + file.path() +
             ". Errno: " + std::to_string(errno)
         );
+        future->errorMessage = "Could not open/create file";
+        return future;
+    }
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        fclose(fp);
+        return future;
     }
 
-    auto downloadFunction = [url, failOnError, timeout_secs,
-                             finishedCb = std::move(finishedCallback),
-                             progressCb = std::move(progressCallback), future, fp]()
+    std::unique_ptr<Transfer> transfer = std::make_unique<Transfer>();
+    transfer->handle = curl;
+    transfer->priority = priority;
+    transfer->future = future;
+    transfer->progressCallback = std::move(progressCallback);
+    transfer->progress = {
+        future,
+        std::chrono::system_clock::now(),
+        &transfer->progressCallback
+    };
+    transfer->finish = [fp, finishedCb = std::move(finishedCallback)](Transfer& t,
+                                                                      CURLcode res)
     {
-        CURL* curl = curl_easy_init();
-        if (curl) {
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str()); // NOLINT
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L); // NOLINT
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp); // NOLINT
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeData); // NOLINT
-            if (timeout_secs) {
-                curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_secs); // NOLINT
-            }
-            if (failOnError) {
-                curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L); // NOLINT
-            }
+        fclose(fp);
 
-            ProgressInformation p = {
-                future,
-                std::chrono::system_clock::now(),
-                &progressCb
-            };
-            curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, xferinfo); // NOLINT
-            curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &p); // NOLINT
-            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L); // NOLINT
-
-            CURLcode res = curl_easy_perform(curl);
-            curl_easy_cleanup(curl);
-            fclose(fp);
-
-            if (res == CURLE_OK) {
-                future->isFinished = true;
-            }
-            else {
-                future->errorMessage = curl_easy_strerror(res);
-            }
+        if (res == CURLE_OK) {
+            t.future->isFinished = true;
+        }
+        else {
+            t.future->errorMessage = curl_easy_strerror(res);
+        }
 
-            if (finishedCb) {
-                finishedCb(*future);
-            }
+        if (finishedCb) {
+            finishedCb(*t.future);
         }
     };
 
-    if (_useMultithreadedDownload) {
-        std::thread t = std::thread(downloadFunction);
-        ghoul::thread::setPriority(
-            t,
-            ghoul::thread::ThreadPriorityClass::Idle,
-            ghoul::thread::ThreadPriorityLevel::Lowest
-        );
-
-        t.detach();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str()); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeData); // NOLINT
+    if (timeout_secs) {
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_secs); // NOLINT
     }
-    else {
-        downloadFunction();
+    if (failOnError) {
+        curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L); // NOLINT
     }
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, xferinfo); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &transfer->progress); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L); // NOLINT
 
+    enqueue(std::move(transfer));
     return future;
 }
 
 std::future<DownloadManager::MemoryFile> DownloadManager::fetchFile(
                                                                    const std::string& url,
                                                           SuccessCallback successCallback,
-                                                              ErrorCallback errorCallback)
+                                                              ErrorCallback errorCallback,
+                                                                        Priority priority)
 {
     LDEBUG(fmt::format("Start downloading file: '{}' into memory", url));
 
-    auto downloadFunction = [url, successCb = std::move(successCallback),
-                             errorCb = std::move(errorCallback)]()
-    {
-        DownloadManager::MemoryFile file;
-        file.buffer = reinterpret_cast<char*>(malloc(1));
-        file.size = 0;
-        file.corrupted = false;
-
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            throw ghoul::RuntimeError("Error initializing cURL");
-        }
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str()); // NOLINT
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L); // NOLINT
-        // NOLINTNEXTLINE
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, reinterpret_cast<void*>(&file));
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeMemoryCallback); // NOLINT
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L); // NOLINT
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false); // NOLINT
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        throw ghoul::RuntimeError("Error initializing cURL");
+    }
 
-        // Will fail when response status is 400 or above
-        curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L); // NOLINT
+    auto promise = std::make_shared<std::promise<MemoryFile>>();
+    std::future<MemoryFile> result = promise->get_future();
 
-        CURLcode res = curl_easy_perform(curl);
+    std::unique_ptr<Transfer> transfer = std::make_unique<Transfer>();
+    transfer->handle = curl;
+    transfer->priority = priority;
+    transfer->memoryFile.buffer = reinterpret_cast<char*>(malloc(1));
+    transfer->finish = [url, promise, successCb = std::move(successCallback),
+                        errorCb = std::move(errorCallback)](Transfer& t, CURLcode res)
+    {
+        MemoryFile& file = t.memoryFile;
         if (res == CURLE_OK) {
             // ask for the content-type
             char* ct;
-            res = curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &ct); // NOLINT
-            if (res == CURLE_OK) {
+            res = curl_easy_getinfo(t.handle, CURLINFO_CONTENT_TYPE, &ct); // NOLINT
+            if (res == CURLE_OK && ct) {
                 std::string extension = std::string(ct);
                 std::stringstream ss(extension);
                 getline(ss, extension ,'/');
@@ -270,9 +437,9 @@ std::future<DownloadManager::MemoryFile> DownloadManager::fetchFile(
             } else {
                 LWARNING("Could not get extension from file downloaded from: " + url);
             }
-            successCb(file);
-            curl_easy_cleanup(curl);
-            return file;
+            if (successCb) {
+                successCb(file);
+            }
         } else {
             std::string err = curl_easy_strerror(res);
             if (errorCb) {
@@ -280,56 +447,56 @@ std::future<DownloadManager::MemoryFile> DownloadManager::fetchFile(
             } else {
                 LWARNING(fmt::format("Error downloading '{}': {}", url, err));
             }
-            curl_easy_cleanup(curl);
-            // Throw an error and use try-catch around call to future.get()
-            //throw std::runtime_error( err );
-
-            // or set a boolean variable in MemoryFile to determine if it is
-            // valid/corrupted or not.
             // Return MemoryFile even if it is not valid, and check if it is after
             // future.get() call.
             file.corrupted = true;
-            return file;
         }
+        promise->set_value(file);
     };
 
-    return std::async(std::launch::async, downloadFunction);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str()); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L); // NOLINT
+    void* memoryFile = reinterpret_cast<void*>(&transfer->memoryFile);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, memoryFile); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeMemoryCallback); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L); // NOLINT
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false); // NOLINT
+
+    // Will fail when response status is 400 or above
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L); // NOLINT
+
+    enqueue(std::move(transfer));
+    return result;
 }
 
 void DownloadManager::getFileExtension(const std::string& url,
                                        RequestFinishedCallback finishedCallback)
 {
-    auto requestFunction = [url, finishedCb = std::move(finishedCallback)]() {
-        CURL* curl = curl_easy_init();
-        if (curl) {
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str()); // NOLINT
-            //USING CURLOPT NOBODY
-            curl_easy_setopt(curl, CURLOPT_NOBODY, 1); // NOLINT
-            CURLcode res = curl_easy_perform(curl);
-            if (CURLE_OK == res) {
-                char* ct;
-                // ask for the content-type
-                res = curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &ct); // NOLINT
-                if ((res == CURLE_OK) && ct && finishedCb) {
-                    finishedCb(std::string(ct));
-                }
-            }
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        return;
+    }
 
-            curl_easy_cleanup(curl);
+    std::unique_ptr<Transfer> transfer = std::make_unique<Transfer>();
+    transfer->handle = curl;
+    transfer->finish = [finishedCb = std::move(finishedCallback)](Transfer& t,
+                                                                  CURLcode res)
+    {
+        if (CURLE_OK == res) {
+            char* ct;
+            // ask for the content-type
+            res = curl_easy_getinfo(t.handle, CURLINFO_CONTENT_TYPE, &ct); // NOLINT
+            if ((res == CURLE_OK) && ct && finishedCb) {
+                finishedCb(std::string(ct));
+            }
         }
     };
-    if (_useMultithreadedDownload) {
-        std::thread t = std::thread(requestFunction);
-        ghoul::thread::setPriority(
-            t,
-            ghoul::thread::ThreadPriorityClass::Idle,
-            ghoul::thread::ThreadPriorityLevel::Lowest
-        );
-        t.detach();
-    }
-    else {
-        requestFunction();
-    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str()); // NOLINT
+    //USING CURLOPT NOBODY
+    curl_easy_setopt(curl, CURLOPT_NOBODY, 1); // NOLINT
+
+    enqueue(std::move(transfer));
 }
 
 } // namespace openspace
@@ -48,6 +48,10 @@
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/scripting/scriptscheduler.h>
+#include <openspace/util/framememory.h>
+#include <openspace/util/memorybudget.h>
+#include <openspace/util/resourceloader.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/versionchecker.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/glm.h>
@@ -79,11 +83,21 @@ DownloadManager& gDownloadManager() {
     return g;
 }
 
+FrameMemory& gFrameMemory() {
+    static FrameMemory g;
+    return g;
+}
+
 LuaConsole& gLuaConsole() {
     static LuaConsole g;
     return g;
 }
 
+MemoryBudget& gMemoryBudget() {
+    static MemoryBudget g;
+    return g;
+}
+
 MissionManager& gMissionManager() {
     static MissionManager g;
     return g;
@@ -114,6 +128,11 @@ RenderEngine& gRenderEngine() {
     return g;
 }
 
+ResourceLoader& gResourceLoader() {
+    static ResourceLoader g;
+    return g;
+}
+
 std::vector<std::unique_ptr<ScreenSpaceRenderable>>& gScreenspaceRenderables() {
     static std::vector<std::unique_ptr<ScreenSpaceRenderable>> g;
     return g;
@@ -124,6 +143,11 @@ SyncEngine& gSyncEngine() {
     return g;
 }
 
+TaskScheduler& gTaskScheduler() {
+    static TaskScheduler g;
+    return g;
+}
+
 TimeManager& gTimeManager() {
     static TimeManager g;
     return g;
@@ -212,6 +236,8 @@ void initialize() {
     global::rootPropertyOwner.addPropertySubOwner(global::timeManager);
 
     global::rootPropertyOwner.addPropertySubOwner(global::renderEngine);
+    global::rootPropertyOwner.addPropertySubOwner(global::resourceLoader);
+    global::rootPropertyOwner.addPropertySubOwner(global::memoryBudget);
     global::rootPropertyOwner.addPropertySubOwner(global::screenSpaceRootPropertyOwner);
 
     global::rootPropertyOwner.addPropertySubOwner(global::parallelPeer);
@@ -236,6 +262,10 @@ void deinitialize() {
     global::luaConsole.deinitialize();
     global::scriptEngine.deinitialize();
     global::fontManager.deinitialize();
+    global::resourceLoader.deinitialize();
+
+    // Everything that might still have tasks in flight has been deinitialized by now
+    global::taskScheduler.deinitialize();
 }
 
 void deinitializeGL() {
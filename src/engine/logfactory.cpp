@@ -26,6 +26,7 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/asynclog.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/loglevel.h>
 #include <ghoul/logging/htmllog.h>
@@ -42,6 +43,7 @@ namespace {
     constexpr const char* KeyCategoryStamping = "CategoryStamping";
     constexpr const char* KeyLogLevelStamping = "LogLevelStamping";
     constexpr const char* KeyLogLevel = "LogLevel";
+    constexpr const char* KeyAsynchronous = "Asynchronous";
 
     constexpr const char* ValueHtmlLog = "html";
     constexpr const char* ValueTextLog = "Text";
@@ -109,12 +111,23 @@ documentation::Documentation LogFactoryDocumentation() {
                 Optional::Yes,
                 "Determines whether the log entries should be stamped with the log level "
                 "that was used to create the log message."
+            },
+            {
+                KeyAsynchronous,
+                new BoolVerifier,
+                Optional::Yes,
+                "Determines whether the log entries are written to the file on a "
+                "background thread instead of the thread that logged the message. This "
+                "prevents a burst of messages from stalling the rendering, but entries "
+                "that are logged immediately before a crash might not be written."
             }
         }
     };
 }
 
-std::unique_ptr<ghoul::logging::Log> createLog(const ghoul::Dictionary& dictionary) {
+namespace {
+
+std::unique_ptr<ghoul::logging::Log> createFileLog(const ghoul::Dictionary& dictionary) {
     documentation::testSpecificationAndThrow(
         LogFactoryDocumentation(),
         dictionary,
@@ -215,4 +228,19 @@ std::unique_ptr<ghoul::logging::Log> createLog(const ghoul::Dictionary& dictiona
     }
 }
 
+} // namespace
+
+std::unique_ptr<ghoul::logging::Log> createLog(const ghoul::Dictionary& dictionary) {
+    std::unique_ptr<ghoul::logging::Log> log = createFileLog(dictionary);
+
+    if (dictionary.hasKeyAndValue<bool>(KeyAsynchronous) &&
+        dictionary.value<bool>(KeyAsynchronous))
+    {
+        return std::make_unique<AsyncLog>(std::move(log));
+    }
+    else {
+        return log;
+    }
+}
+
 } // namespace openspace
@@ -42,6 +42,7 @@
 #include <openspace/interaction/orbitalnavigator.h>
 #include <openspace/network/parallelpeer.h>
 #include <openspace/performance/performancemeasurement.h>
+#include <openspace/performance/tracezone.h>
 #include <openspace/performance/performancemanager.h>
 #include <openspace/rendering/dashboard.h>
 #include <openspace/rendering/dashboarditem.h>
@@ -49,6 +50,8 @@
 #include <openspace/rendering/loadingscreen.h>
 #include <openspace/rendering/luaconsole.h>
 #include <openspace/rendering/renderable.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scene/assetmanager.h>
 #include <openspace/scene/assetloader.h>
 #include <openspace/scene/scene.h>
@@ -57,12 +60,16 @@
 #include <openspace/scene/timeframe.h>
 #include <openspace/scene/lightsource.h>
 #include <openspace/scene/sceneinitializer.h>
+#include <openspace/scene/scenesnapshot.h>
 #include <openspace/scene/translation.h>
 #include <openspace/scene/scenelicensewriter.h>
 #include <openspace/scripting/scriptscheduler.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/util/camera.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/framememory.h>
+#include <openspace/util/memorybudget.h>
+#include <openspace/util/resourceloader.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/task.h>
 #include <openspace/util/timemanager.h>
@@ -82,7 +89,11 @@
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
 #include <glbinding/glbinding.h>
 #include <glbinding-aux/types_to_string.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
 #include <numeric>
+#include <optional>
 #include <sstream>
 
 #if defined(_MSC_VER) && defined(OPENSPACE_ENABLE_VLD)
@@ -98,12 +109,56 @@
 namespace {
     constexpr const char* _loggerCat = "OpenSpaceEngine";
     constexpr const int CacheVersion = 1;
+
+    // The time per loading screen frame that is spent on the OpenGL initialization of
+    // the nodes that have already been initialized
+    constexpr const std::chrono::milliseconds LoadingGLInitializationBudget(16);
+
+    /**
+     * Returns the cache file for the static documentation. The static documentation only
+     * depends on the code, so the file is identified by the build and the set of modules
+     * that are compiled in and is reused until either of them changes.
+     */
+    std::string staticDocumentationCacheFile() {
+        std::string key = std::string(OPENSPACE_VERSION_STRING_FULL) + ' ' +
+                          std::string(OPENSPACE_GIT_FULL);
+        for (openspace::OpenSpaceModule* m : openspace::global::moduleEngine.modules()) {
+            key += ' ' + m->identifier();
+        }
+
+        return FileSys.cacheManager()->cachedFilename(
+            "staticdocumentation",
+            std::to_string(std::hash<std::string>()(key)),
+            ghoul::filesystem::CacheManager::Persistent::Yes
+        );
+    }
 } // namespace
 
 namespace openspace {
 
 class Scene;
 
+OpenSpaceEngine::StartupPhase::StartupPhase(OpenSpaceEngine& engine, std::string name,
+                                            bool isBackground)
+    : _engine(engine)
+    , _name(std::move(name))
+    , _isBackground(isBackground)
+    , _begin(std::chrono::steady_clock::now())
+{}
+
+OpenSpaceEngine::StartupPhase::~StartupPhase() {
+    using namespace std::chrono;
+    const steady_clock::time_point end = steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(_engine._startupPhasesMutex);
+    _engine._startupPhases.push_back({
+        std::move(_name),
+        duration_cast<duration<double>>(_begin - _engine._startupTime).count(),
+        duration_cast<duration<double>>(end - _begin).count(),
+        _isBackground
+    });
+}
+
 OpenSpaceEngine::OpenSpaceEngine()
     : _scene(nullptr)
     , _loadingScreen(nullptr)
@@ -183,6 +238,10 @@ void OpenSpaceEngine::registerPathTokens() {
 void OpenSpaceEngine::initialize() {
     LTRACE("OpenSpaceEngine::initialize(begin)");
 
+    _startupTime = std::chrono::steady_clock::now();
+    std::optional<StartupPhase> setupPhase;
+    setupPhase.emplace(*this, "Setup");
+
     global::initialize();
 
     const std::string versionCheckUrl = global::configuration.versionCheckUrl;
@@ -274,8 +333,11 @@ void OpenSpaceEngine::initialize() {
 
     LINFOC("OpenSpace Version", std::string(OPENSPACE_VERSION_STRING_FULL));
     LINFOC("Commit", std::string(OPENSPACE_GIT_FULL));
+    setupPhase = std::nullopt;
 
     // Register modules
+    std::optional<StartupPhase> modulesPhase;
+    modulesPhase.emplace(*this, "Modules");
     global::moduleEngine.initialize(global::configuration.moduleConfigurations);
 
     // After registering the modules, the documentations for the available classes
@@ -289,8 +351,11 @@ void OpenSpaceEngine::initialize() {
 
     // Register the provided shader directories
     ghoul::opengl::ShaderPreprocessor::addIncludePath(absPath("${SHADERS}"));
+    modulesPhase = std::nullopt;
 
     // Register Lua script functions
+    std::optional<StartupPhase> luaPhase;
+    luaPhase.emplace(*this, "Lua libraries");
     LDEBUG("Registering Lua libraries");
     registerCoreClasses(global::scriptEngine);
 
@@ -299,12 +364,17 @@ void OpenSpaceEngine::initialize() {
         std::make_unique<SynchronizationWatcher>();
     SynchronizationWatcher* rawWatcher = w.get();
 
+    std::unique_ptr<AssetLoader> loader = std::make_unique<AssetLoader>(
+        *global::scriptEngine.luaState(),
+        rawWatcher,
+        FileSys.absPath("${ASSETS}")
+    );
+    if (global::configuration.isSkippingValidatedAssetSpecifications) {
+        loader->setValidatedAssetsFile(absPath("${CACHE}/validatedassets.txt"));
+    }
+
     global::openSpaceEngine._assetManager = std::make_unique<AssetManager>(
-        std::make_unique<AssetLoader>(
-            *global::scriptEngine.luaState(),
-            rawWatcher,
-            FileSys.absPath("${ASSETS}")
-        ),
+        std::move(loader),
         std::move(w)
     );
 
@@ -319,21 +389,34 @@ void OpenSpaceEngine::initialize() {
     }
 
     global::scriptEngine.initialize();
+    luaPhase = std::nullopt;
 
-    // To be concluded
-    _documentationJson.clear();
-    _documentationJson += "{\"documentation\":[";
+    {
+        StartupPhase phase(*this, "Engine components");
+        _shutdown.waitTime = global::configuration.shutdownCountdown;
 
-    writeStaticDocumentation();
+        global::navigationHandler.initialize();
 
-    _shutdown.waitTime = global::configuration.shutdownCountdown;
+        global::renderEngine.initialize();
 
-    global::navigationHandler.initialize();
+        for (const std::function<void()>& func : global::callback::initialize) {
+            func();
+        }
+    }
 
-    global::renderEngine.initialize();
+    // To be concluded
+    _documentationJson.clear();
+    _documentationJson += "{\"documentation\":[";
 
-    for (const std::function<void()>& func : global::callback::initialize) {
-        func();
+    // All script libraries, documentations, and factories are registered at this point,
+    // so generating their documentation can overlap with the OpenGL initialization.
+    // The task is joined before the documentation is accessed again. The documentation
+    // is only written by the master, so the other nodes of a cluster skip it altogether
+    if (global::windowDelegate.isMaster()) {
+        _documentationTask = std::async(std::launch::async, [this]() {
+            StartupPhase phase(*this, "Static documentation", true);
+            createStaticDocumentation();
+        });
     }
 
     global::openSpaceEngine._assetManager->initialize();
@@ -355,6 +438,9 @@ void OpenSpaceEngine::initializeGL() {
     LDEBUG("Clearing all Windows");
     global::windowDelegate.clearAllWindows(glm::vec4(0.f, 0.f, 0.f, 1.f));
 
+    std::optional<StartupPhase> capabilitiesPhase;
+    capabilitiesPhase.emplace(*this, "OpenGL capabilities");
+
     LDEBUG("Adding system components");
     // Detect and log OpenCL and OpenGL versions and available devices
     SysCap.addComponent(
@@ -374,6 +460,7 @@ void OpenSpaceEngine::initializeGL() {
         );
     SysCap.logCapabilities(verbosity);
 
+    global::memoryBudget.initialize();
 
     // Check the required OpenGL versions of the registered modules
     ghoul::systemcapabilities::Version version =
@@ -403,32 +490,37 @@ void OpenSpaceEngine::initializeGL() {
             }
         }
     }
+    capabilitiesPhase = std::nullopt;
 
-    loadFonts();
+    {
+        StartupPhase phase(*this, "Fonts");
+        loadFonts();
+    }
 
-    _loadingScreen = std::make_unique<LoadingScreen>(
-        LoadingScreen::ShowMessage(global::configuration.loadingScreen.isShowingMessages),
-        LoadingScreen::ShowNodeNames(
-            global::configuration.loadingScreen.isShowingNodeNames
-        ),
-        LoadingScreen::ShowProgressbar(
-            global::configuration.loadingScreen.isShowingProgressbar
-        )
+    {
+        StartupPhase phase(*this, "Loading screen");
+        using LS = LoadingScreen;
+        _loadingScreen = std::make_unique<LoadingScreen>(
+            LS::ShowMessage(global::configuration.loadingScreen.isShowingMessages),
+            LS::ShowNodeNames(global::configuration.loadingScreen.isShowingNodeNames),
+            LS::ShowProgressbar(
+                global::configuration.loadingScreen.isShowingProgressbar
+            )
         );
 
-    _loadingScreen->render();
-
-
-
-
+        _loadingScreen->render();
+    }
 
     LTRACE("OpenSpaceEngine::initializeGL::Console::initialize(begin)");
-    try {
-        global::luaConsole.initialize();
-    }
-    catch (ghoul::RuntimeError& e) {
-        LERROR("Error initializing Console with error:");
-        LERRORC(e.component, e.message);
+    {
+        StartupPhase phase(*this, "Console");
+        try {
+            global::luaConsole.initialize();
+        }
+        catch (ghoul::RuntimeError& e) {
+            LERROR("Error initializing Console with error:");
+            LERRORC(e.component, e.message);
+        }
     }
     LTRACE("OpenSpaceEngine::initializeGL::Console::initialize(end)");
 
@@ -599,12 +691,18 @@ void OpenSpaceEngine::initializeGL() {
     }
 
     LDEBUG("Initializing Rendering Engine");
-    global::renderEngine.initializeGL();
+    {
+        StartupPhase phase(*this, "Rendering engine OpenGL");
+        global::renderEngine.initializeGL();
+    }
 
-    global::moduleEngine.initializeGL();
+    {
+        StartupPhase phase(*this, "Modules OpenGL");
+        global::moduleEngine.initializeGL();
 
-    for (const std::function<void()>& func : global::callback::initializeGL) {
-        func();
+        for (const std::function<void()>& func : global::callback::initializeGL) {
+            func();
+        }
     }
 
     LINFO("Finished initializing OpenGL");
@@ -651,6 +749,20 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
         sceneInitializer = std::make_unique<SingleThreadedSceneInitializer>();
     }
 
+    // If the asset and everything it depends on is unchanged since the last time it was
+    // loaded, its nodes will take about as long to initialize as they did back then
+    const std::string snapshotFile = SceneSnapshot::file(assetPath);
+    SceneSnapshot snapshot;
+    if (snapshot.read(snapshotFile) && snapshot.isCurrent()) {
+        LINFO(fmt::format("Warm start of '{}' from the scene snapshot", assetPath));
+        SceneInitializer::Durations times;
+        for (const SceneSnapshot::Node& node : snapshot.nodes) {
+            times[node.identifier] = node.initializationTime;
+        }
+        sceneInitializer->setExpectedInitializationTimes(std::move(times));
+    }
+    SceneInitializer* initializer = sceneInitializer.get();
+
     _scene = std::make_unique<Scene>(std::move(sceneInitializer));
     global::renderEngine.setScene(_scene.get());
 
@@ -670,6 +782,17 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
         );
     }
 
+    {
+        // Loading another asset later on gets its own report of the phases below
+        std::lock_guard<std::mutex> lock(_startupPhasesMutex);
+        if (_startupPhases.empty()) {
+            _startupTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    std::optional<StartupPhase> assetPhase;
+    assetPhase.emplace(*this, "Asset loading");
+
     _assetManager->removeAll();
     _assetManager->add(assetPath);
 
@@ -677,6 +800,10 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
     _loadingScreen->postMessage("Loading assets");
 
     _assetManager->update();
+    assetPhase = std::nullopt;
+
+    std::optional<StartupPhase> syncPhase;
+    syncPhase.emplace(*this, "Asset synchronization");
 
     _loadingScreen->setPhase(LoadingScreen::Phase::Synchronization);
     _loadingScreen->postMessage("Synchronizing assets");
@@ -751,11 +878,19 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
         }
     }
 
+    syncPhase = std::nullopt;
+
     _loadingScreen->setPhase(LoadingScreen::Phase::Initialization);
 
     _loadingScreen->postMessage("Initializing scene");
-    while (_scene->isInitializing()) {
-        _loadingScreen->render();
+    {
+        StartupPhase phase(*this, "Scene initialization");
+        while (_scene->isInitializing()) {
+            // The OpenGL initialization of the finished nodes overlaps with the
+            // initialization of the remaining ones on the worker threads
+            _scene->initializePendingNodesGL(LoadingGLInitializationBudget);
+            _loadingScreen->render();
+        }
     }
 
     _loadingScreen->postMessage("Initializing OpenGL");
@@ -774,9 +909,22 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
     showTouchbar();
 #endif // APPLE
 
-    runGlobalCustomizationScripts();
+    {
+        StartupPhase phase(*this, "Customization scripts");
+        runGlobalCustomizationScripts();
+    }
 
-    writeSceneDocumentation();
+    {
+        StartupPhase phase(*this, "Scene documentation");
+        writeSceneDocumentation();
+    }
+
+    {
+        StartupPhase phase(*this, "Scene snapshot");
+        writeSceneSnapshot(snapshotFile, *initializer);
+    }
+
+    logStartupReport();
 
     LTRACE("OpenSpaceEngine::loadSingleAsset(end)");
 }
@@ -801,6 +949,8 @@ void OpenSpaceEngine::deinitialize() {
     }
     global::sessionRecording.deinitialize();
 
+    waitForDocumentation();
+
     global::deinitialize();
 
     FactoryManager::deinitialize();
@@ -841,6 +991,11 @@ void OpenSpaceEngine::deinitializeGL() {
 }
 
 void OpenSpaceEngine::writeStaticDocumentation() {
+    waitForDocumentation();
+    createStaticDocumentation();
+}
+
+void OpenSpaceEngine::createStaticDocumentation() {
     std::string path = global::configuration.documentation.path;
     if (!path.empty()) {
 
@@ -848,20 +1003,88 @@ void OpenSpaceEngine::writeStaticDocumentation() {
         DocEng.addHandlebarTemplates(FactoryManager::ref().templatesToRegister());
         DocEng.addHandlebarTemplates(DocEng.templatesToRegister());
 
-        _documentationJson += "{\"name\":\"Scripting\",";
-        _documentationJson += "\"identifier\":\"" + global::scriptEngine.jsonName();
-        _documentationJson += "\",\"data\":" + global::scriptEngine.generateJson();
-        _documentationJson += "},";
+        const std::string cacheFile = staticDocumentationCacheFile();
+        std::ifstream cache(cacheFile);
+        if (cache.good()) {
+            _documentationJson.append(
+                std::istreambuf_iterator<char>(cache),
+                std::istreambuf_iterator<char>()
+            );
+            return;
+        }
 
-        _documentationJson += "{\"name\":\"Top Level\",";
-        _documentationJson += "\"identifier\":\"" + DocEng.jsonName();
-        _documentationJson += "\",\"data\":" + DocEng.generateJson();
-        _documentationJson += "},";
+        std::string json;
+        json += "{\"name\":\"Scripting\",";
+        json += "\"identifier\":\"" + global::scriptEngine.jsonName();
+        json += "\",\"data\":" + global::scriptEngine.generateJson();
+        json += "},";
 
-        _documentationJson += "{\"name\":\"Factory\",";
-        _documentationJson += "\"identifier\":\"" + FactoryManager::ref().jsonName();
-        _documentationJson += "\",\"data\":" + FactoryManager::ref().generateJson();
-        _documentationJson += "},";
+        json += "{\"name\":\"Top Level\",";
+        json += "\"identifier\":\"" + DocEng.jsonName();
+        json += "\",\"data\":" + DocEng.generateJson();
+        json += "},";
+
+        json += "{\"name\":\"Factory\",";
+        json += "\"identifier\":\"" + FactoryManager::ref().jsonName();
+        json += "\",\"data\":" + FactoryManager::ref().generateJson();
+        json += "},";
+
+        std::ofstream(cacheFile) << json;
+        _documentationJson += json;
+    }
+}
+
+void OpenSpaceEngine::waitForDocumentation() {
+    if (!_documentationTask.valid()) {
+        return;
+    }
+
+    try {
+        _documentationTask.get();
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR("Error creating the documentation");
+        LERRORC(e.component, e.message);
+    }
+    catch (const std::exception& e) {
+        LERROR(fmt::format("Error creating the documentation: {}", e.what()));
+    }
+}
+
+void OpenSpaceEngine::logStartupReport() {
+    std::vector<StartupPhaseTiming> phases;
+    {
+        std::lock_guard<std::mutex> lock(_startupPhasesMutex);
+        phases = std::move(_startupPhases);
+        _startupPhases.clear();
+    }
+    if (phases.empty()) {
+        return;
+    }
+
+    std::sort(
+        phases.begin(),
+        phases.end(),
+        [](const StartupPhaseTiming& lhs, const StartupPhaseTiming& rhs) {
+            return lhs.begin < rhs.begin;
+        }
+    );
+
+    double total = 0.0;
+    for (const StartupPhaseTiming& p : phases) {
+        total = std::max(total, p.begin + p.duration);
+    }
+
+    LINFO(fmt::format("Startup took {:.3f} s", total));
+    for (const StartupPhaseTiming& p : phases) {
+        std::stringstream s;
+        s << std::left << std::setw(30) << p.name << std::right << std::fixed
+          << std::setprecision(3) << std::setw(9) << p.duration << " s  (at "
+          << std::setw(7) << p.begin << " s)";
+        if (p.isBackground) {
+            s << "  [background]";
+        }
+        LINFO(s.str());
     }
 }
 
@@ -920,8 +1143,37 @@ void OpenSpaceEngine::loadFonts() {
     }
 }
 
+void OpenSpaceEngine::writeSceneSnapshot(const std::string& path,
+                                         const SceneInitializer& initializer) const
+{
+    SceneSnapshot snapshot;
+    const std::vector<std::shared_ptr<const Asset>> assets =
+        _assetManager->rootAsset()->subTreeAssets();
+    for (const std::shared_ptr<const Asset>& a : assets) {
+        snapshot.dependencies.push_back(SceneSnapshot::dependency(a->assetFilePath()));
+    }
+    for (const std::string& script : global::configuration.globalCustomizationScripts) {
+        snapshot.dependencies.push_back(SceneSnapshot::dependency(absPath(script)));
+    }
+
+    const SceneInitializer::Durations times = initializer.initializationTimes();
+    for (const std::pair<const std::string, std::chrono::microseconds>& t : times) {
+        snapshot.nodes.push_back({ t.first, t.second });
+    }
+
+    if (!snapshot.write(path)) {
+        LWARNING(fmt::format("Could not write scene snapshot '{}'", path));
+    }
+}
+
 void OpenSpaceEngine::writeSceneDocumentation() {
     // Write documentation to json files if config file supplies path for doc files
+    waitForDocumentation();
+
+    // Only the master writes the documentation
+    if (!global::windowDelegate.isMaster()) {
+        return;
+    }
 
     std::string path = global::configuration.documentation.path;
     if (!path.empty()) {
@@ -959,13 +1211,23 @@ void OpenSpaceEngine::writeSceneDocumentation() {
         //we should write the html file that uses them.
         _documentationJson += "]}";
 
-        DocEng.writeDocumentationHtml(path, _documentationJson);
+        // Writing the html file only needs the json that was generated above, so there
+        // is no need for the startup to wait for it
+        _documentationTask = std::async(
+            std::launch::async,
+            [path = std::move(path), json = _documentationJson]() {
+                DocEng.writeDocumentationHtml(path, json);
+            }
+        );
     }
     //no else, if path was empty, that means that no documentation is requested
 }
 
 void OpenSpaceEngine::preSynchronization() {
     LTRACE("OpenSpaceEngine::preSynchronization(begin)");
+    // All zones of the previous frame have closed at this point
+    global::performanceManager.finishFrame();
+    PerfTrace("OpenSpaceEngine::preSynchronization");
 
     //std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
@@ -976,8 +1238,19 @@ void OpenSpaceEngine::preSynchronization() {
         );
     }
 
+    // The transformations of this frame might have been computed on the worker threads
+    // while the last frame was rendered. They have to be done before anything in this
+    // frame can modify the scene graph
+    if (_scene) {
+        _scene->finishTransformPrefetch();
+    }
+
     FileSys.triggerFilesystemEvents();
 
+    // Positions and orientations that were queried for the last frame's time are not
+    // needed anymore
+    SpiceManager::ref().clearCache();
+
     if (_hasScheduledAssetLoading) {
         LINFO(fmt::format("Loading asset: {}", _scheduledAssetPathToLoad));
         loadSingleAsset(_scheduledAssetPathToLoad);
@@ -998,6 +1271,13 @@ void OpenSpaceEngine::preSynchronization() {
         if (global::sessionRecording.isSavingFramesDuringPlayback()) {
             dt = global::sessionRecording.fixedDeltaTimeDuringFrameOutput();
         }
+        else if (_prefetchDeltaTime > 0.0) {
+            // Advancing the time with the same delta time that the prefetch used makes
+            // this frame arrive exactly at the predicted time. The average delta time
+            // is at most one frame older than it would be otherwise
+            dt = _prefetchDeltaTime;
+        }
+        _prefetchDeltaTime = 0.0;
 
         global::timeManager.preSynchronization(dt);
 
@@ -1019,8 +1299,9 @@ void OpenSpaceEngine::preSynchronization() {
         if (_scene) {
             Camera* camera = _scene->camera();
             if (camera) {
+                // The camera's setters invalidate the cached matrices that depend on
+                // them, so a camera at rest keeps its matrices
                 global::navigationHandler.updateCamera(dt);
-                camera->invalidateCache();
             }
         }
         global::sessionRecording.preSynchronization();
@@ -1035,6 +1316,7 @@ void OpenSpaceEngine::preSynchronization() {
 
 void OpenSpaceEngine::postSynchronizationPreDraw() {
     LTRACE("OpenSpaceEngine::postSynchronizationPreDraw(begin)");
+    PerfTrace("OpenSpaceEngine::postSynchronizationPreDraw");
 
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (global::performanceManager.isEnabled()) {
@@ -1050,6 +1332,9 @@ void OpenSpaceEngine::postSynchronizationPreDraw() {
     // weird results when using side_by_side stereo --- abock
     using FR = ghoul::fontrendering::FontRenderer;
     FR::defaultRenderer().setFramebufferSize(global::renderEngine.fontResolution());
+    global::renderEngine.textBatcher().setFramebufferSize(
+        global::renderEngine.fontResolution()
+    );
 
     FR::defaultProjectionRenderer().setFramebufferSize(
         global::renderEngine.renderingResolution()
@@ -1069,6 +1354,14 @@ void OpenSpaceEngine::postSynchronizationPreDraw() {
         writeSceneDocumentation();
     }
 
+    // Uploading the asynchronously loaded resources first makes them available to the
+    // scene update of the same frame
+    global::resourceLoader.update();
+
+    // The caches reported their usage during the last frame and can free memory before
+    // they are updated in this frame
+    global::memoryBudget.update();
+
     global::renderEngine.updateScene();
     global::renderEngine.updateRenderer();
     global::renderEngine.updateScreenSpaceRenderables();
@@ -1082,6 +1375,20 @@ void OpenSpaceEngine::postSynchronizationPreDraw() {
         func();
     }
 
+    // Only the master knows the delta time that the next frame will advance by; the
+    // clients receive the time and would seldom hit the prediction
+    if (master && _scene && global::renderEngine.isPipelinedSceneUpdateEnabled()) {
+        double dt = global::windowDelegate.averageDeltaTime();
+        if (global::sessionRecording.isSavingFramesDuringPlayback()) {
+            dt = global::sessionRecording.fixedDeltaTimeDuringFrameOutput();
+        }
+        const std::optional<double> nextTime = global::timeManager.predictedTime(dt);
+        if (nextTime.has_value() && dt > 0.0) {
+            _prefetchDeltaTime = dt;
+            global::renderEngine.prefetchScene(*nextTime);
+        }
+    }
+
     // Testing this every frame has minimal impact on the performance --- abock
     // Debug build: 1-2 us ; Release build: <= 1 us
     using ghoul::logging::LogManager;
@@ -1108,6 +1415,7 @@ void OpenSpaceEngine::render(const glm::mat4& sceneMatrix, const glm::mat4& view
                              const glm::mat4& projectionMatrix)
 {
     LTRACE("OpenSpaceEngine::render(begin)");
+    PerfTrace("OpenSpaceEngine::render");
 
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (global::performanceManager.isEnabled()) {
@@ -1136,6 +1444,7 @@ void OpenSpaceEngine::render(const glm::mat4& sceneMatrix, const glm::mat4& view
 
 void OpenSpaceEngine::drawOverlays() {
     LTRACE("OpenSpaceEngine::drawOverlays(begin)");
+    PerfTrace("OpenSpaceEngine::drawOverlays");
 
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (global::performanceManager.isEnabled()) {
@@ -1151,7 +1460,11 @@ void OpenSpaceEngine::drawOverlays() {
 
     if (isGuiWindow) {
         global::renderEngine.renderOverlays(_shutdown);
+        // The console draws its background over the overlays, so their text has to
+        // be submitted before the console is rendered
+        global::renderEngine.textBatcher().flush();
         global::luaConsole.render();
+        global::renderEngine.textBatcher().flush();
     }
 
     for (const std::function<void()>& func : global::callback::draw2D) {
@@ -1163,6 +1476,7 @@ void OpenSpaceEngine::drawOverlays() {
 
 void OpenSpaceEngine::postDraw() {
     LTRACE("OpenSpaceEngine::postDraw(begin)");
+    PerfTrace("OpenSpaceEngine::postDraw");
 
     std::unique_ptr<performance::PerformanceMeasurement> perf;
     if (global::performanceManager.isEnabled()) {
@@ -1177,6 +1491,9 @@ void OpenSpaceEngine::postDraw() {
         func();
     }
 
+    // Nothing that was allocated for this frame is used beyond this point
+    global::frameMemory.reset();
+
     if (_isFirstRenderingFirstFrame) {
         global::windowDelegate.setSynchronization(true);
         _isFirstRenderingFirstFrame = false;
@@ -1186,6 +1503,9 @@ void OpenSpaceEngine::postDraw() {
 }
 
 void OpenSpaceEngine::keyboardCallback(Key key, KeyModifier mod, KeyAction action) {
+    // Any input resumes the on-demand rendering, as it might change what is rendered
+    global::renderEngine.requestRedraw();
+
     using F = std::function<bool (Key, KeyModifier, KeyAction)>;
     for (const F& func : global::callback::keyboard) {
         const bool isConsumed = func(key, mod, action);
@@ -1206,6 +1526,8 @@ void OpenSpaceEngine::keyboardCallback(Key key, KeyModifier mod, KeyAction actio
 }
 
 void OpenSpaceEngine::charCallback(unsigned int codepoint, KeyModifier modifier) {
+    global::renderEngine.requestRedraw();
+
     using F = std::function<bool (unsigned int, KeyModifier)>;
     for (const F& func : global::callback::character) {
         bool isConsumed = func(codepoint, modifier);
@@ -1221,6 +1543,8 @@ void OpenSpaceEngine::mouseButtonCallback(MouseButton button,
                                           MouseAction action,
                                           KeyModifier mods)
 {
+    global::renderEngine.requestRedraw();
+
     using F = std::function<bool (MouseButton, MouseAction, KeyModifier)>;
     for (const F& func : global::callback::mouseButton) {
         bool isConsumed = func(button, action, mods);
@@ -1253,6 +1577,8 @@ void OpenSpaceEngine::mouseButtonCallback(MouseButton button,
 }
 
 void OpenSpaceEngine::mousePositionCallback(double x, double y) {
+    global::renderEngine.requestRedraw();
+
     using F = std::function<void (double, double)>;
     for (const F& func : global::callback::mousePosition) {
         func(x, y);
@@ -1262,6 +1588,8 @@ void OpenSpaceEngine::mousePositionCallback(double x, double y) {
 }
 
 void OpenSpaceEngine::mouseScrollWheelCallback(double posX, double posY) {
+    global::renderEngine.requestRedraw();
+
     using F = std::function<bool (double, double)>;
     for (const F& func : global::callback::mouseScrollWheel) {
         bool isConsumed = func(posX, posY);
@@ -1278,8 +1606,8 @@ std::vector<char> OpenSpaceEngine::encode() {
     return buffer;
 }
 
-void OpenSpaceEngine::decode(std::vector<char> data) {
-    global::syncEngine.decodeSyncables(std::move(data));
+void OpenSpaceEngine::decode(const std::vector<char>& data) {
+    global::syncEngine.decodeSyncables(data);
 }
 
 void OpenSpaceEngine::toggleShutdownMode() {
@@ -25,8 +25,40 @@
 #include <openspace/engine/syncengine.h>
 
 #include <openspace/util/syncdata.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <algorithm>
+#include <cstring>
+#include <lz4.h>
+
+namespace {
+    constexpr const char* _loggerCat = "SyncEngine";
+
+    constexpr const uint8_t FlagKeyframe = 1;
+    constexpr const uint8_t FlagCompressed = 2;
+
+    constexpr const uint8_t SyncableUnchanged = 0;
+    constexpr const uint8_t SyncableChanged = 1;
+
+    // Frames smaller than this are sent uncompressed as the savings would be negligible
+    constexpr const size_t CompressionThreshold = 1024;
+
+    template <typename T>
+    void append(std::vector<char>& data, T value) {
+        const size_t offset = data.size();
+        data.resize(offset + sizeof(T));
+        std::memcpy(data.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T read(const char*& data) {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return value;
+    }
+} // namespace
 
 namespace openspace {
 
@@ -38,18 +70,115 @@ SyncEngine::SyncEngine(unsigned int syncBufferSize)
 
 // Should be called on sgct master
 std::vector<char> SyncEngine::encodeSyncables() {
-    for (Syncable* syncable : _syncables) {
-        syncable->encode(&_syncBuffer);
+    const bool isKeyframe = _needsKeyframe;
+    if (isKeyframe) {
+        _previousFrame.clear();
+        _needsKeyframe = false;
+    }
+    _previousFrame.resize(_syncables.size());
+
+    std::vector<char> body;
+    append(body, static_cast<uint32_t>(_syncables.size()));
+    for (size_t i = 0; i < _syncables.size(); ++i) {
+        const size_t begin = _syncBuffer.encodedSize();
+        _syncables[i]->encode(&_syncBuffer);
+        const char* first = _syncBuffer.encodedData() + begin;
+        const char* last = _syncBuffer.encodedData() + _syncBuffer.encodedSize();
+
+        std::vector<char>& previous = _previousFrame[i];
+        const bool hasChanged = isKeyframe ||
+            !std::equal(first, last, previous.begin(), previous.end());
+        if (hasChanged) {
+            body.push_back(SyncableChanged);
+            append(body, static_cast<uint32_t>(last - first));
+            body.insert(body.end(), first, last);
+            previous.assign(first, last);
+        }
+        else {
+            body.push_back(SyncableUnchanged);
+        }
     }
-
-    std::vector<char> data = _syncBuffer.data();
     _syncBuffer.reset();
-    return data;
+
+    uint8_t flags = isKeyframe ? FlagKeyframe : 0;
+    if (body.size() > CompressionThreshold) {
+        const int bound = LZ4_compressBound(static_cast<int>(body.size()));
+        std::vector<char> data(1 + sizeof(uint32_t) + bound);
+        const int compressedSize = LZ4_compress_default(
+            body.data(),
+            data.data() + 1 + sizeof(uint32_t),
+            static_cast<int>(body.size()),
+            bound
+        );
+
+        if (compressedSize > 0 && static_cast<size_t>(compressedSize) < body.size()) {
+            flags |= FlagCompressed;
+            data[0] = static_cast<char>(flags);
+            const uint32_t uncompressedSize = static_cast<uint32_t>(body.size());
+            std::memcpy(data.data() + 1, &uncompressedSize, sizeof(uint32_t));
+            data.resize(1 + sizeof(uint32_t) + compressedSize);
+            _frameSize = data.size();
+            return data;
+        }
+    }
+
+    body.insert(body.begin(), static_cast<char>(flags));
+    _frameSize = body.size();
+    return body;
 }
 
 // Should be called on sgct slaves
-void SyncEngine::decodeSyncables(std::vector<char> data) {
-    _syncBuffer.setData(std::move(data));
+void SyncEngine::decodeSyncables(const std::vector<char>& data) {
+    if (data.empty()) {
+        return;
+    }
+    _frameSize = data.size();
+
+    const uint8_t flags = static_cast<uint8_t>(data[0]);
+    const char* body = data.data() + 1;
+    if (flags & FlagCompressed) {
+        const uint32_t uncompressedSize = read<uint32_t>(body);
+        _decompressionBuffer.resize(uncompressedSize);
+        const int nBytes = LZ4_decompress_safe(
+            body,
+            _decompressionBuffer.data(),
+            static_cast<int>(data.size() - 1 - sizeof(uint32_t)),
+            static_cast<int>(uncompressedSize)
+        );
+        if (nBytes != static_cast<int>(uncompressedSize)) {
+            LERROR("Error decompressing synchronization frame");
+            return;
+        }
+        body = _decompressionBuffer.data();
+    }
+
+    if (flags & FlagKeyframe) {
+        _previousFrame.clear();
+    }
+
+    const uint32_t nSyncables = read<uint32_t>(body);
+    if (nSyncables != _syncables.size()) {
+        LERROR(fmt::format(
+            "Received {} Syncables, but {} are registered", nSyncables, _syncables.size()
+        ));
+        return;
+    }
+    _previousFrame.resize(nSyncables);
+
+    // The full frame is reassembled in the SyncBuffer, whose memory is reused between
+    // frames, and then decoded from there
+    _syncBuffer.reset();
+    for (uint32_t i = 0; i < nSyncables; ++i) {
+        std::vector<char>& previous = _previousFrame[i];
+        const uint8_t marker = read<uint8_t>(body);
+        if (marker == SyncableChanged) {
+            const uint32_t size = read<uint32_t>(body);
+            previous.assign(body, body + size);
+            body += size;
+        }
+        _syncBuffer.encodeBytes(previous.data(), previous.size());
+    }
+
     for (Syncable* syncable : _syncables) {
         syncable->decode(&_syncBuffer);
     }
@@ -57,6 +186,18 @@ void SyncEngine::decodeSyncables(std::vector<char> data) {
     _syncBuffer.reset();
 }
 
+std::vector<size_t> SyncEngine::encodedSizes() const {
+    std::vector<size_t> sizes(_syncables.size(), 0);
+    for (size_t i = 0; i < std::min(sizes.size(), _previousFrame.size()); ++i) {
+        sizes[i] = _previousFrame[i].size();
+    }
+    return sizes;
+}
+
+size_t SyncEngine::frameSize() const {
+    return _frameSize;
+}
+
 void SyncEngine::preSynchronization(IsMaster isMaster) {
     for (Syncable* syncable : _syncables) {
         syncable->preSync(isMaster);
@@ -73,6 +214,7 @@ void SyncEngine::addSyncable(Syncable* syncable) {
     ghoul_assert(syncable, "Syncable must not be nullptr");
 
     _syncables.push_back(syncable);
+    _needsKeyframe = true;
 }
 
 void SyncEngine::addSyncables(const std::vector<Syncable*>& syncables) {
@@ -87,6 +229,7 @@ void SyncEngine::removeSyncable(Syncable* syncable) {
         std::remove(_syncables.begin(), _syncables.end(), syncable),
         _syncables.end()
     );
+    _needsKeyframe = true;
 }
 
 void SyncEngine::removeSyncables(const std::vector<Syncable*>& syncables) {
@@ -64,6 +64,16 @@ bool KeyframeNavigator::updateCamera(Camera& camera, bool ignoreFutureKeyframes)
         if (ignoreFutureKeyframes) {
             _cameraPoseTimeline.removeKeyframesBefore(now);
         }
+        else if (prevKeyframe && _maximumExtrapolationTime > 0.0) {
+            // The next keyframe is late, so we continue the motion between the last two
+            // keyframes for a while rather than letting the camera stall.
+            // Note that we return false as there still is no future keyframe
+            const Keyframe<CameraPose>* beforeKeyframe =
+                _cameraPoseTimeline.lastKeyframeBefore(prevKeyframe->timestamp);
+            if (beforeKeyframe) {
+                extrapolateCamera(camera, *beforeKeyframe, *prevKeyframe, now);
+            }
+        }
         return false;
     }
 
@@ -179,6 +189,37 @@ bool KeyframeNavigator::updateCamera(Camera* camera, const CameraPose prevPose,
     return true;
 }
 
+void KeyframeNavigator::extrapolateCamera(Camera& camera,
+                                          const Keyframe<CameraPose>& prevKeyframe,
+                                          const Keyframe<CameraPose>& lastKeyframe,
+                                          double now) const
+{
+    const CameraPose& prev = prevKeyframe.data;
+    const CameraPose& last = lastKeyframe.data;
+    const double interval = lastKeyframe.timestamp - prevKeyframe.timestamp;
+    if (interval <= 0.0 || prev.focusNode != last.focusNode ||
+        prev.followFocusNodeRotation != last.followFocusNodeRotation)
+    {
+        // The motion between the keyframes is not continuous, so we can't continue it
+        return;
+    }
+
+    const double elapsed = std::min(
+        now - lastKeyframe.timestamp,
+        _maximumExtrapolationTime
+    );
+    const double t = elapsed / interval;
+
+    CameraPose pose = last;
+    pose.position = last.position + (last.position - prev.position) * t;
+    pose.rotation = glm::quat(glm::slerp(
+        glm::dquat(prev.rotation),
+        glm::dquat(last.rotation),
+        1.0 + t
+    ));
+    updateCamera(&camera, pose, pose, 0.0, false);
+}
+
 double KeyframeNavigator::currentTime() const {
     if (_timeframeMode == KeyframeTimeRef::Relative_recordedStart) {
         return (global::windowDelegate.applicationTime() - _referenceTimestamp);
@@ -211,6 +252,10 @@ void KeyframeNavigator::removeKeyframesAfter(double timestamp, Inclusive inclusi
     timeline().removeKeyframesAfter(timestamp, inclusive);
 }
 
+void KeyframeNavigator::setMaximumExtrapolationTime(double seconds) {
+    _maximumExtrapolationTime = seconds;
+}
+
 void KeyframeNavigator::clearKeyframes() {
     timeline().clearKeyframes();
 }
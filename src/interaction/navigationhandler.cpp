@@ -51,6 +51,23 @@ namespace {
         "If this is set to 'true' the entire interaction is based off key frames rather "
         "than using the mouse interaction."
     };
+
+    constexpr const openspace::properties::Property::PropertyInfo PredictMotionInfo = {
+        "PredictCameraMotion",
+        "Predict camera motion",
+        "If this is set to 'true', the camera is moved ahead along its current motion "
+        "to where it is expected to be when the frame is shown, which compensates the "
+        "latency between the input and the display, for example the additional frame "
+        "of a cluster synchronization. The navigation itself remains unaffected."
+    };
+
+    constexpr const openspace::properties::Property::PropertyInfo PredictionFramesInfo = {
+        "PredictionFrames",
+        "Prediction frames",
+        "The number of frames that the camera motion is predicted ahead if "
+        "'PredictCameraMotion' is enabled. This should match the number of frames "
+        "between the input being read and the frame being displayed."
+    };
 } // namespace
 
 #include "navigationhandler_lua.inl"
@@ -60,6 +77,8 @@ namespace openspace::interaction {
 NavigationHandler::NavigationHandler()
     : properties::PropertyOwner({ "NavigationHandler" })
     , _useKeyFrameInteraction(KeyFrameInfo, false)
+    , _predictCameraMotion(PredictMotionInfo, false)
+    , _predictionFrames(PredictionFramesInfo, 1.f, 0.f, 4.f)
 {
 
     _inputState = std::make_unique<InputState>();
@@ -68,6 +87,8 @@ NavigationHandler::NavigationHandler()
 
     // Add the properties
     addProperty(_useKeyFrameInteraction);
+    addProperty(_predictCameraMotion);
+    addProperty(_predictionFrames);
     addPropertySubOwner(*_orbitalNavigator);
 }
 
@@ -90,6 +111,8 @@ void NavigationHandler::deinitialize() {
 
 void NavigationHandler::setCamera(Camera* camera) {
     _camera = camera;
+    _prediction.hasPreviousFrame = false;
+    _prediction.isApplied = false;
     _orbitalNavigator->setCamera(camera);
 }
 
@@ -121,22 +144,97 @@ void NavigationHandler::updateCamera(double deltaTime) {
     ghoul_assert(_inputState != nullptr, "InputState must not be nullptr");
     ghoul_assert(_camera != nullptr, "Camera must not be nullptr");
 
+    restorePredictedCamera();
+
     if (_cameraUpdatedFromScript) {
         _cameraUpdatedFromScript = false;
+        _prediction.hasPreviousFrame = false;
     }
     else {
         if (!_playbackModeEnabled && _camera) {
             if (_useKeyFrameInteraction) {
                 _keyframeNavigator->updateCamera(*_camera, _playbackModeEnabled);
+                // The keyframes already contain the pose that should be shown
+                _prediction.hasPreviousFrame = false;
             }
             else {
                 _orbitalNavigator->updateStatesFromInput(*_inputState, deltaTime);
                 _orbitalNavigator->updateCameraStateFromStates(deltaTime);
+                predictCamera(deltaTime);
             }
         }
     }
 }
 
+void NavigationHandler::restorePredictedCamera() {
+    if (!_prediction.isApplied) {
+        return;
+    }
+    _prediction.isApplied = false;
+
+    // If anything else has moved the camera since the last frame, that pose wins and the
+    // motion of the last frame is no longer meaningful
+    const bool isUnchanged =
+        _camera->positionVec3() == _prediction.predictedPosition &&
+        _camera->rotationQuaternion() == _prediction.predictedRotation;
+    if (!isUnchanged) {
+        _prediction.hasPreviousFrame = false;
+        return;
+    }
+
+    _camera->setPositionVec3(_prediction.position);
+    _camera->setRotation(_prediction.rotation);
+}
+
+void NavigationHandler::predictCamera(double deltaTime) {
+    const SceneGraphNode* anchor = _orbitalNavigator->anchorNode();
+    if (!_predictCameraMotion || !anchor || deltaTime <= 0.0) {
+        _prediction.hasPreviousFrame = false;
+        return;
+    }
+
+    const glm::dvec3 position = _camera->positionVec3();
+    const glm::dquat rotation = _camera->rotationQuaternion();
+    const glm::dvec3 anchorPosition = anchor->worldPosition();
+
+    const bool canPredict = _prediction.hasPreviousFrame &&
+                            _prediction.anchor == anchor;
+
+    _prediction.hasPreviousFrame = true;
+    _prediction.anchor = anchor;
+    const glm::dvec3 previousPosition = _prediction.position;
+    const glm::dvec3 previousAnchorPosition = _prediction.anchorPosition;
+    const glm::dquat previousRotation = _prediction.rotation;
+    _prediction.position = position;
+    _prediction.rotation = rotation;
+    _prediction.anchorPosition = anchorPosition;
+
+    if (!canPredict) {
+        return;
+    }
+
+    // The simulation time of the frame is not predicted, so the camera is only moved
+    // along its motion relative to the anchor and not along the motion of the anchor
+    const double t = _predictionFrames;
+    const glm::dvec3 motion =
+        (position - anchorPosition) - (previousPosition - previousAnchorPosition);
+
+    glm::dquat rotationChange = rotation * glm::inverse(previousRotation);
+    if (rotationChange.w < 0.0) {
+        rotationChange = -rotationChange;
+    }
+    const double angle = glm::angle(rotationChange);
+    const glm::dquat predictedChange = angle > 1e-12 ?
+        glm::angleAxis(angle * t, glm::axis(rotationChange)) :
+        glm::dquat(1.0, 0.0, 0.0, 0.0);
+
+    _prediction.predictedPosition = position + motion * t;
+    _prediction.predictedRotation = glm::normalize(predictedChange * rotation);
+    _camera->setPositionVec3(_prediction.predictedPosition);
+    _camera->setRotation(_prediction.predictedRotation);
+    _prediction.isApplied = true;
+}
+
 void NavigationHandler::setEnableKeyFrameInteraction() {
     _useKeyFrameInteraction = true;
 }
@@ -36,6 +36,22 @@ namespace {
     constexpr const double AngleEpsilon = 1E-7;
     constexpr const double DistanceRatioAimThreshold = 1E-4;
 
+    // Input velocities below this are treated as the camera being at rest
+    constexpr const double VelocityEpsilon = 1E-10;
+
+    // The number of updates for which a surface position handle is reused while the
+    // camera is at rest. Height data is streamed in over time, so the surface under a
+    // stationary camera still has to be checked now and then
+    constexpr const int SurfaceCacheLifetime = 30;
+
+    bool hasVelocity(const openspace::interaction::CameraInteractionStates& states) {
+        return glm::length(states.globalRotationVelocity()) > VelocityEpsilon ||
+               glm::length(states.localRotationVelocity()) > VelocityEpsilon ||
+               glm::length(states.truckMovementVelocity()) > VelocityEpsilon ||
+               glm::length(states.localRollVelocity()) > VelocityEpsilon ||
+               glm::length(states.globalRollVelocity()) > VelocityEpsilon;
+    }
+
     constexpr const openspace::properties::Property::PropertyInfo AnchorInfo = {
         "Anchor",
         "Anchor",
@@ -331,6 +347,14 @@ OrbitalNavigator::OrbitalNavigator()
 
     addProperty(_mouseSensitivity);
     addProperty(_joystickSensitivity);
+
+    // These change the outcome of an update even when nothing is moving
+    auto invalidateLastPose = [this]() { _hasLastPose = false; };
+    _followAnchorNodeRotationDistance.onChange(invalidateLastPose);
+    _minimumAllowedDistance.onChange(invalidateLastPose);
+    _useAdaptiveStereoscopicDepth.onChange(invalidateLastPose);
+    _staticViewScaleExponent.onChange(invalidateLastPose);
+    _stereoscopicDepthOfFocusSurface.onChange(invalidateLastPose);
 }
 
 glm::dvec3 OrbitalNavigator::anchorNodeToCameraVector() const {
@@ -363,6 +387,11 @@ void OrbitalNavigator::updateCameraStateFromStates(double deltaTime) {
         return;
     }
 
+    ++_surfaceCache.age;
+    if (isCameraAtRest()) {
+        return;
+    }
+
     const glm::dvec3 anchorPos = _anchorNode->worldPosition();
     const glm::dvec3 prevCameraPosition = _camera->positionVec3();
     const glm::dvec3 anchorDisplacement = anchorPos - _previousAnchorNodePosition;
@@ -482,6 +511,8 @@ void OrbitalNavigator::updateCameraStateFromStates(double deltaTime) {
     // Update the camera state
     _camera->setPositionVec3(pose.position);
     _camera->setRotation(composeCameraRotation(camRot));
+    _lastPose = { _camera->positionVec3(), _camera->rotationQuaternion() };
+    _hasLastPose = true;
 
     if (_useAdaptiveStereoscopicDepth) {
         double targetCameraToSurfaceDistance = glm::length(
@@ -514,6 +545,51 @@ void OrbitalNavigator::updateCameraStateFromStates(double deltaTime) {
     }
 }
 
+bool OrbitalNavigator::isCameraAtRest() {
+    if (!_hasLastPose || _camera->positionVec3() != _lastPose.position ||
+        _camera->rotationQuaternion() != _lastPose.rotation)
+    {
+        return false;
+    }
+
+    if (hasVelocity(_mouseStates) || hasVelocity(_joystickStates)) {
+        return false;
+    }
+
+    if (_retargetAnchorInterpolator.isInterpolating() ||
+        _retargetAimInterpolator.isInterpolating() ||
+        _followRotationInterpolator.isInterpolating() ||
+        (_useAdaptiveStereoscopicDepth &&
+            _cameraToSurfaceDistanceInterpolator.isInterpolating()))
+    {
+        return false;
+    }
+
+    if (_anchorNode->worldPosition() != _previousAnchorNodePosition ||
+        glm::quat_cast(_anchorNode->worldRotationMatrix()) != _previousAnchorNodeRotation)
+    {
+        return false;
+    }
+
+    if (_aimNode && _aimNode != _anchorNode &&
+        _aimNode->worldPosition() != _previousAimNodePosition)
+    {
+        return false;
+    }
+
+    if (_surfaceCache.age < SurfaceCacheLifetime) {
+        return true;
+    }
+
+    // Check whether the surface under the camera has changed since the last update
+    const SurfaceCache previous = _surfaceCache;
+    const SurfacePositionHandle handle =
+        calculateSurfacePositionHandle(*_anchorNode, _lastPose.position);
+    return previous.node == _surfaceCache.node &&
+           previous.handle.heightToSurface == handle.heightToSurface &&
+           previous.handle.centerToReferenceSurface == handle.centerToReferenceSurface;
+}
+
 glm::dquat OrbitalNavigator::composeCameraRotation(
     const CameraRotationDecomposition& decomposition)
 {
@@ -556,6 +632,7 @@ void OrbitalNavigator::setFocusNode(const std::string& focusNode) {
 }
 
 void OrbitalNavigator::setAnchorNode(const SceneGraphNode* anchorNode) {
+    _hasLastPose = false;
     if (!_anchorNode) {
         _directlySetStereoDistance = true;
     }
@@ -569,6 +646,7 @@ void OrbitalNavigator::setAnchorNode(const SceneGraphNode* anchorNode) {
 }
 
 void OrbitalNavigator::setAimNode(const SceneGraphNode* aimNode) {
+    _hasLastPose = false;
     _retargetAimInterpolator.end();
     _aimNode = aimNode;
 
@@ -586,6 +664,7 @@ void OrbitalNavigator::setAimNode(const std::string& aimNode) {
 }
 
 void OrbitalNavigator::resetNodeMovements() {
+    _hasLastPose = false;
     if (_anchorNode) {
         _previousAnchorNodePosition = _anchorNode->worldPosition();
         _previousAnchorNodeRotation = glm::quat_cast(_anchorNode->worldRotationMatrix());
@@ -690,7 +769,7 @@ OrbitalNavigator::CameraRotationDecomposition
                                                 glm::dvec4(cameraPose.position, 1));
 
     const SurfacePositionHandle posHandle =
-        reference.calculateSurfacePositionHandle(cameraPositionModelSpace);
+        surfacePositionHandleModelSpace(reference, cameraPositionModelSpace);
 
     const glm::dvec3 directionFromSurfaceToCameraModelSpace =
         posHandle.referenceSurfaceOutDirection;
@@ -1209,10 +1288,27 @@ SurfacePositionHandle OrbitalNavigator::calculateSurfacePositionHandle(
     const glm::dmat4 inverseModelTransform = node.inverseModelTransform();
     const glm::dvec3 cameraPositionModelSpace =
         glm::dvec3(inverseModelTransform * glm::dvec4(cameraPositionWorldSpace, 1));
-    const SurfacePositionHandle posHandle =
-        node.calculateSurfacePositionHandle(cameraPositionModelSpace);
+    return surfacePositionHandleModelSpace(node, cameraPositionModelSpace);
+}
+
+SurfacePositionHandle OrbitalNavigator::surfacePositionHandleModelSpace(
+                                               const SceneGraphNode& node,
+                                               const glm::dvec3& cameraPositionModelSpace)
+{
+    // A single update asks for the same position more than once, and a camera at rest
+    // asks for the same position in every update
+    if (_surfaceCache.node == &node &&
+        _surfaceCache.positionModelSpace == cameraPositionModelSpace &&
+        _surfaceCache.age < SurfaceCacheLifetime)
+    {
+        return _surfaceCache.handle;
+    }
 
-    return posHandle;
+    _surfaceCache.node = &node;
+    _surfaceCache.positionModelSpace = cameraPositionModelSpace;
+    _surfaceCache.handle = node.calculateSurfacePositionHandle(cameraPositionModelSpace);
+    _surfaceCache.age = 0;
+    return _surfaceCache.handle;
 }
 
 JoystickCameraStates& OrbitalNavigator::joystickStates() {
@@ -35,11 +35,15 @@
 #include <openspace/scene/scene.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/scripting/scriptscheduler.h>
+#include <openspace/util/asyncfilewriter.h>
 #include <openspace/util/camera.h>
 #include <openspace/util/timemanager.h>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <array>
 #include <iomanip>
 
 namespace {
@@ -53,7 +57,22 @@ namespace {
     };
     constexpr const char DataFormatAsciiTag = 'A';
     constexpr const char DataFormatBinaryTag = 'B';
-
+    // Binary entries organized in chunks, with an index of the chunks at the end
+    constexpr const char DataFormatBinaryIndexedTag = 'I';
+    // The same as the indexed binary format, but everything after the header is written
+    // as LZ4 compressed blocks by the AsyncFileWriter
+    constexpr const char DataFormatCompressedTag = 'Z';
+
+    // Number of entries per chunk of an indexed binary recording
+    constexpr const uint32_t ChunkSize = 256;
+    constexpr const size_t IndexFooterMagicLength = 8;
+    constexpr const char IndexFooterMagic[IndexFooterMagicLength] = {
+        'O', 'S', 'R', 'E', 'C', 'I', 'D', 'X'
+    };
+    // The index is followed by the number of chunks, the position of the index, and
+    // the magic marker
+    constexpr const size_t IndexFooterSize =
+        2 * sizeof(uint64_t) + IndexFooterMagicLength;
 
     template <typename T>
     T readFromPlayback(std::ifstream& stream) {
@@ -86,6 +105,34 @@ namespace {
         return temp.data();
     }
 
+    // Returns whether all enabled renderables, for example globes that stream tiles or
+    // volumes that load timesteps, were rendered with the data they need for the view
+    bool isSceneRenderedWithDesiredData() {
+        using namespace openspace;
+
+        const Scene* scene = global::renderEngine.scene();
+        if (!scene) {
+            return true;
+        }
+        for (const SceneGraphNode* node : scene->allSceneGraphNodes()) {
+            const Renderable* renderable = node->renderable();
+            if (renderable && renderable->isEnabled() &&
+                !renderable->renderedWithDesiredData())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr openspace::properties::Property::PropertyInfo CompressRecordingsInfo = {
+        "CompressRecordings",
+        "Compress Recordings",
+        "If this value is enabled, new binary recordings are LZ4 compressed, which "
+        "reduces their size considerably. Compressed recordings are decompressed into a "
+        "temporary file at the start of their playback."
+    };
+
     std::string readHeaderElement(std::ifstream& stream, size_t readLen_chars) {
         std::vector<char> readTemp(readLen_chars);
         stream.read(&readTemp[0], readLen_chars);
@@ -100,7 +147,10 @@ namespace openspace::interaction {
 
 SessionRecording::SessionRecording()
     : properties::PropertyOwner({ "SessionRecording", "Session Recording" })
-{}
+    , _compressRecordings(CompressRecordingsInfo, false)
+{
+    addProperty(_compressRecordings);
+}
 
 SessionRecording::~SessionRecording() {} // NOLINT
 
@@ -145,28 +195,38 @@ bool SessionRecording::startRecording(const std::string& filename) {
     _playbackActive_camera = false;
     _playbackActive_time = false;
     _playbackActive_script = false;
+    _chunks.clear();
+
+    // Only binary recordings can be compressed, as the point of the ASCII format is
+    // that it can be read and edited by hand
+    const bool compress =
+        _recordingDataMode == RecordedDataMode::Binary && _compressRecordings;
+
+    std::string header = FileHeaderTitle;
+    header.append(FileHeaderVersion, FileHeaderVersionLength);
     if (_recordingDataMode == RecordedDataMode::Binary) {
-        _recordFile.open(absFilename, std::ios::binary);
+        header += compress ? DataFormatCompressedTag : DataFormatBinaryIndexedTag;
     }
     else {
-        _recordFile.open(absFilename);
+        header += DataFormatAsciiTag;
     }
+    header += '\n';
 
-    if (!_recordFile.is_open() || !_recordFile.good()) {
+    // The keyframes are written on a background thread so that the latency of the disk
+    // does not show up as dropped frames in the recording
+    _recordFile = std::make_unique<AsyncFileWriter>(
+        absFilename,
+        header,
+        AsyncFileWriter::Compress(compress)
+    );
+    if (!_recordFile->isOpen()) {
         LERROR(fmt::format(
             "Unable to open file {} for keyframe recording", absFilename.c_str()
         ));
+        _recordFile = nullptr;
+        _state = SessionState::Idle;
         return false;
     }
-    _recordFile << FileHeaderTitle;
-    _recordFile.write(FileHeaderVersion, FileHeaderVersionLength);
-    if (_recordingDataMode == RecordedDataMode::Binary) {
-        _recordFile << DataFormatBinaryTag;
-    }
-    else {
-        _recordFile << DataFormatAsciiTag;
-    }
-    _recordFile << '\n';
 
     LINFO("Session recording started");
     _timestampRecordStarted = global::windowDelegate.applicationTime();
@@ -175,11 +235,14 @@ bool SessionRecording::startRecording(const std::string& filename) {
 
 void SessionRecording::stopRecording() {
     if (_state == SessionState::Recording) {
+        if (_recordingDataMode == RecordedDataMode::Binary) {
+            saveRecordIndexToFile();
+        }
         _state = SessionState::Idle;
         LINFO("Session recording stopped");
     }
-    // Close the recording file
-    _recordFile.close();
+    // Closing the recording file writes all keyframes that are still queued
+    _recordFile = nullptr;
 }
 
 bool SessionRecording::startPlayback(const std::string& filename,
@@ -223,12 +286,23 @@ bool SessionRecording::startPlayback(const std::string& filename,
     }
     readHeaderElement(_playbackFile, FileHeaderVersionLength);
     std::string readDataMode = readHeaderElement(_playbackFile, 1);
+    bool hasIndex = false;
+    bool isCompressed = false;
     if (readDataMode[0] == DataFormatAsciiTag) {
         _recordingDataMode = RecordedDataMode::Ascii;
     }
     else if (readDataMode[0] == DataFormatBinaryTag) {
         _recordingDataMode = RecordedDataMode::Binary;
     }
+    else if (readDataMode[0] == DataFormatBinaryIndexedTag) {
+        _recordingDataMode = RecordedDataMode::Binary;
+        hasIndex = true;
+    }
+    else if (readDataMode[0] == DataFormatCompressedTag) {
+        _recordingDataMode = RecordedDataMode::Binary;
+        hasIndex = true;
+        isCompressed = true;
+    }
     else {
         LERROR("Unknown data type in header (should be Ascii or Binary)");
         cleanUpPlayback();
@@ -236,13 +310,47 @@ bool SessionRecording::startPlayback(const std::string& filename,
     std::string throwawayNewlineChar = readHeaderElement(_playbackFile, 1);
 
     if (_recordingDataMode == RecordedDataMode::Binary) {
+        size_t headerSize = FileHeaderTitle.length() + FileHeaderVersionLength +
+                            sizeof(DataFormatBinaryTag) + sizeof('\n');
+
+        if (isCompressed) {
+            // The playback seeks through the file, so the entries are restored into a
+            // temporary file, which is played back instead
+            const std::string decompressed = FileSys.cacheManager()->cachedFilename(
+                _playbackFilename,
+                "decompressed",
+                ghoul::filesystem::CacheManager::Persistent::No
+            );
+            const bool success = AsyncFileWriter::decompress(
+                _playbackFilename,
+                decompressed,
+                headerSize
+            );
+            if (!success) {
+                LWARNING(fmt::format(
+                    "Playback file {} is incomplete; playing the restored part",
+                    _playbackFilename
+                ));
+            }
+            _playbackFilename = decompressed;
+        }
+
         //Close & re-open the file, starting from the beginning, and do dummy read
         // past the header, version, and data type
         _playbackFile.close();
         _playbackFile.open(_playbackFilename, std::ifstream::in | std::ios::binary);
-        size_t headerSize = FileHeaderTitle.length() + FileHeaderVersionLength +
-                            sizeof(DataFormatBinaryTag) + sizeof('\n');
         _playbackFile.read(reinterpret_cast<char*>(&_keyframeBuffer), headerSize);
+
+        if (hasIndex && !readPlaybackIndex()) {
+            // The recording was not stopped properly, so the index was never written.
+            // The entries themselves are still complete and can be read one by one
+            LWARNING(fmt::format(
+                "Playback file {} has no valid index; reading all entries",
+                _playbackFilename
+            ));
+            _playbackFile.clear();
+            _playbackFile.seekg(headerSize);
+        }
     }
 
     if (!_playbackFile.is_open() || !_playbackFile.good()) {
@@ -271,7 +379,10 @@ bool SessionRecording::startPlayback(const std::string& filename,
     global::scriptScheduler.setTimeReferenceMode(timeMode);
 
     _setSimulationTimeWithNextCameraKeyframe = forceSimTimeAtStart;
-    if (!playbackAddEntriesToTimeline()) {
+    const bool parsedEntries = _chunks.empty() ?
+        playbackAddEntriesToTimeline() :
+        playbackAddChunksToTimeline(currentTime());
+    if (!parsedEntries) {
         cleanUpPlayback();
         return false;
     }
@@ -281,9 +392,10 @@ bool SessionRecording::startPlayback(const std::string& filename,
 
     LINFO(fmt::format(
         "Playback session started: ({:8.3f},0.0,{:13.3f}) with {}/{}/{} entries, "
-        "forceTime={}",
+        "{}/{} chunks, forceTime={}",
         now, _timestampPlaybackStarted_simulation, _keyframesCamera.size(),
-        _keyframesTime.size(), _keyframesScript.size(), (forceSimTimeAtStart ? 1 : 0)
+        _keyframesTime.size(), _keyframesScript.size(), _idxChunkNext, _chunks.size(),
+        (forceSimTimeAtStart ? 1 : 0)
     ));
 
     global::navigationHandler.triggerPlaybackStart();
@@ -336,6 +448,7 @@ void SessionRecording::signalPlaybackFinishedForComponent(RecordedType type) {
 
 void SessionRecording::enableTakeScreenShotDuringPlayback(int fps) {
     _saveRenderingDuringPlayback = true;
+    _saveRenderingTakesScreenshots = true;
     _saveRenderingDeltaTime = 1.0 / fps;
 }
 
@@ -343,6 +456,12 @@ void SessionRecording::disableTakeScreenShotDuringPlayback() {
     _saveRenderingDuringPlayback = false;
 }
 
+void SessionRecording::enableFixedFramePaceDuringPlayback(int fps) {
+    _saveRenderingDuringPlayback = true;
+    _saveRenderingTakesScreenshots = false;
+    _saveRenderingDeltaTime = 1.0 / fps;
+}
+
 void SessionRecording::stopPlayback() {
     if (_state == SessionState::Playback) {
         _state = SessionState::Idle;
@@ -351,6 +470,63 @@ void SessionRecording::stopPlayback() {
     }
 }
 
+bool SessionRecording::seekPlayback(double recordedTime) {
+    if (_state != SessionState::Playback) {
+        LERROR("Unable to seek while not in session playback mode");
+        return false;
+    }
+    if (_chunks.empty()) {
+        LERROR("Unable to seek in a playback file without an index");
+        return false;
+    }
+    if (_playbackTimeReferenceMode != KeyframeTimeRef::Relative_recordedStart) {
+        LERROR("Seeking requires a playback relative to the recording start");
+        return false;
+    }
+
+    // The chunks are sorted by time, so the one that contains the requested time is the
+    // last one that starts before it
+    auto it = std::upper_bound(
+        _chunks.begin(),
+        _chunks.end(),
+        recordedTime,
+        [](double t, const RecordedChunk& chunk) { return t < chunk.timeRec; }
+    );
+    const size_t chunk = (it == _chunks.begin()) ?
+        0 :
+        static_cast<size_t>(std::distance(_chunks.begin(), it) - 1);
+
+    clearPlaybackTimeline();
+    _idxChunkNext = chunk;
+    _timestampPlaybackStarted_application =
+        global::windowDelegate.applicationTime() - recordedTime;
+    _saveRenderingCurrentRecordedTime = recordedTime;
+    _setSimulationTimeWithNextCameraKeyframe = true;
+    _playbackActive_camera = true;
+    _playbackActive_script = true;
+    if (UsingTimeKeyframes) {
+        _playbackActive_time = true;
+    }
+
+    if (!playbackAddChunksToTimeline(recordedTime)) {
+        stopPlayback();
+        return false;
+    }
+
+    // Skip the entries of the first chunk that lie before the requested time
+    while (_idxTimeline_nonCamera + 1 < _timeline.size() &&
+           _timeline[_idxTimeline_nonCamera].timestamp < recordedTime)
+    {
+        _idxTimeline_nonCamera++;
+    }
+    findFirstCameraKeyframeInTimeline();
+
+    LINFO(fmt::format(
+        "Playback moved to {:.3f} s (chunk {}/{})", recordedTime, chunk, _chunks.size()
+    ));
+    return true;
+}
+
 void SessionRecording::cleanUpPlayback() {
     global::navigationHandler.stopPlayback();
 
@@ -368,6 +544,15 @@ void SessionRecording::cleanUpPlayback() {
 
     _playbackFile.close();
 
+    clearPlaybackTimeline();
+    _chunks.clear();
+    _idxChunkNext = 0;
+    _saveRenderingDuringPlayback = false;
+
+    _cleanupNeeded = false;
+}
+
+void SessionRecording::clearPlaybackTimeline() {
     // Clear all timelines and keyframes
     _timeline.clear();
     _keyframesCamera.clear();
@@ -378,10 +563,8 @@ void SessionRecording::cleanUpPlayback() {
     _idxScript = 0;
     _idxTimeline_cameraPtrNext = 0;
     _idxTimeline_cameraPtrPrev = 0;
+    _idxTimeline_cameraFirstInTimeline = 0;
     _hasHitEndOfCameraKeyframes = false;
-    _saveRenderingDuringPlayback = false;
-
-    _cleanupNeeded = false;
 }
 
 void SessionRecording::writeToFileBuffer(double src) {
@@ -418,7 +601,7 @@ void SessionRecording::saveStringToFile(const std::string& s) {
     _bufferIndex += static_cast<unsigned int>(writeSize_bytes);
     saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
 
-    _recordFile.write(s.c_str(), s.size());
+    _recordFile->write(s.c_str(), s.size());
 }
 
 bool SessionRecording::hasCameraChangedFromPrev(
@@ -456,6 +639,12 @@ void SessionRecording::saveCameraKeyframe() {
     datamessagestructures::CameraKeyframe kf = _externInteract.generateCameraKeyframe();
 
     if (_recordingDataMode == RecordedDataMode::Binary) {
+        addEntryToRecordIndex(
+            kf._timestamp,
+            kf._timestamp - _timestampRecordStarted,
+            global::timeManager.time().j2000Seconds()
+        );
+
         // Writing to a binary session recording file
         _bufferIndex = 0;
         _keyframeBuffer[_bufferIndex++] = 'c';
@@ -512,6 +701,12 @@ void SessionRecording::saveTimeKeyframe() {
     datamessagestructures::TimeKeyframe kf = _externInteract.generateTimeKeyframe();
 
     if (_recordingDataMode == RecordedDataMode::Binary) {
+        addEntryToRecordIndex(
+            kf._timestamp,
+            kf._timestamp - _timestampRecordStarted,
+            kf._time
+        );
+
         _bufferIndex = 0;
         _keyframeBuffer[_bufferIndex++] = 't';
         writeToFileBuffer(kf._timestamp);
@@ -557,6 +752,12 @@ void SessionRecording::saveScriptKeyframe(std::string scriptToSave) {
         = _externInteract.generateScriptMessage(scriptToSave);
 
     if (_recordingDataMode == RecordedDataMode::Binary) {
+        addEntryToRecordIndex(
+            sm._timestamp,
+            sm._timestamp - _timestampRecordStarted,
+            global::timeManager.time().j2000Seconds()
+        );
+
         _bufferIndex = 0;
         _keyframeBuffer[_bufferIndex++] = 's';
         writeToFileBuffer(sm._timestamp);
@@ -645,25 +846,10 @@ bool SessionRecording::playbackAddEntriesToTimeline() {
                 fileReadOk = false;
                 break;
             }
-            if (frameType == 'c') {
-                playbackCamera();
-            }
-            else if (frameType == 't') {
-                playbackTimeChange();
-            }
-            else if (frameType == 's') {
-                playbackScript();
-            }
-            else {
-                LERROR(fmt::format(
-                    "Unknown frame type {} @ index {} of playback file {}",
-                    frameType, _playbackLineNum - 1, _playbackFilename
-                ));
+            if (!playbackAddBinaryEntryToTimeline(frameType)) {
                 parsingErrorsFound = true;
                 break;
             }
-
-            _playbackLineNum++;
         }
     }
     else {
@@ -707,6 +893,150 @@ bool SessionRecording::playbackAddEntriesToTimeline() {
     return !parsingErrorsFound;
 }
 
+bool SessionRecording::playbackAddBinaryEntryToTimeline(unsigned char frameType) {
+    if (frameType == 'c') {
+        playbackCamera();
+    }
+    else if (frameType == 't') {
+        playbackTimeChange();
+    }
+    else if (frameType == 's') {
+        playbackScript();
+    }
+    else {
+        LERROR(fmt::format(
+            "Unknown frame type {} @ index {} of playback file {}",
+            frameType, _playbackLineNum - 1, _playbackFilename
+        ));
+        return false;
+    }
+
+    _playbackLineNum++;
+    return true;
+}
+
+bool SessionRecording::playbackAddChunksToTimeline(double currTime) {
+    // Read ahead until the last chunk that was read starts in the future, so that the
+    // keyframes around the current time are always available for interpolation
+    while (!isPlaybackFullyLoaded()) {
+        if (!_timeline.empty() && !_keyframesCamera.empty()) {
+            const RecordedChunk& last = _chunks[_idxChunkNext - 1];
+            if (appropriateTimestamp(last.timeOs, last.timeRec, last.timeSim) > currTime)
+            {
+                break;
+            }
+        }
+
+        if (!playbackAddNextChunkToTimeline()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SessionRecording::playbackAddNextChunkToTimeline() {
+    const RecordedChunk& chunk = _chunks[_idxChunkNext];
+    _playbackFile.clear();
+    _playbackFile.seekg(chunk.filePosition);
+
+    for (uint32_t i = 0; i < chunk.nEntries; ++i) {
+        const unsigned char frameType = readFromPlayback<unsigned char>(_playbackFile);
+        if (!_playbackFile) {
+            LERROR(fmt::format(
+                "Unexpected end of chunk {} of playback file {}",
+                _idxChunkNext, _playbackFilename
+            ));
+            return false;
+        }
+        if (!playbackAddBinaryEntryToTimeline(frameType)) {
+            return false;
+        }
+    }
+
+    _idxChunkNext++;
+    return true;
+}
+
+bool SessionRecording::readPlaybackIndex() {
+    _chunks.clear();
+    _idxChunkNext = 0;
+
+    _playbackFile.seekg(0, std::ios::end);
+    const std::streamoff fileSize = _playbackFile.tellg();
+    if (fileSize < static_cast<std::streamoff>(IndexFooterSize)) {
+        return false;
+    }
+    _playbackFile.seekg(fileSize - IndexFooterSize);
+    const uint64_t nChunks = readFromPlayback<uint64_t>(_playbackFile);
+    const uint64_t indexPosition = readFromPlayback<uint64_t>(_playbackFile);
+    std::array<char, IndexFooterMagicLength> magic;
+    _playbackFile.read(magic.data(), IndexFooterMagicLength);
+    if (!_playbackFile ||
+        !std::equal(magic.begin(), magic.end(), std::begin(IndexFooterMagic)) ||
+        indexPosition > static_cast<uint64_t>(fileSize))
+    {
+        return false;
+    }
+
+    _playbackFile.seekg(indexPosition);
+    _chunks.reserve(nChunks);
+    for (uint64_t i = 0; i < nChunks; ++i) {
+        RecordedChunk chunk;
+        chunk.timeOs = readFromPlayback<double>(_playbackFile);
+        chunk.timeRec = readFromPlayback<double>(_playbackFile);
+        chunk.timeSim = readFromPlayback<double>(_playbackFile);
+        chunk.filePosition = readFromPlayback<uint64_t>(_playbackFile);
+        chunk.nEntries = readFromPlayback<uint32_t>(_playbackFile);
+        _chunks.push_back(chunk);
+    }
+    if (!_playbackFile) {
+        _chunks.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SessionRecording::isPlaybackFullyLoaded() const {
+    return _idxChunkNext >= _chunks.size();
+}
+
+void SessionRecording::addEntryToRecordIndex(double timeOs, double timeRec,
+                                             double timeSim)
+{
+    if (_chunks.empty() || _chunks.back().nEntries == ChunkSize) {
+        _chunks.push_back({
+            timeOs,
+            timeRec,
+            timeSim,
+            _recordFile->position(),
+            0
+        });
+    }
+    _chunks.back().nEntries++;
+}
+
+void SessionRecording::saveRecordIndexToFile() {
+    auto append = [](std::string& index, const auto& value) {
+        index.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    const uint64_t indexPosition = _recordFile->position();
+    std::string index;
+    for (const RecordedChunk& chunk : _chunks) {
+        append(index, chunk.timeOs);
+        append(index, chunk.timeRec);
+        append(index, chunk.timeSim);
+        append(index, chunk.filePosition);
+        append(index, chunk.nEntries);
+    }
+    const uint64_t nChunks = _chunks.size();
+    append(index, nChunks);
+    append(index, indexPosition);
+    index.append(IndexFooterMagic, IndexFooterMagicLength);
+    _recordFile->write(std::move(index));
+    _chunks.clear();
+}
+
 double SessionRecording::appropriateTimestamp(double timeOs, double timeRec,
                                               double timeSim)
 {
@@ -766,12 +1096,9 @@ double SessionRecording::currentTime() const {
 }
 
 double SessionRecording::fixedDeltaTimeDuringFrameOutput() const {
-    // Check if renderable in focus is still resolving tile loading
+    // Check if any renderable is still resolving its data, for example loading tiles,
     // do not adjust time while we are doing this
-    const SceneGraphNode* focusNode =
-        global::navigationHandler.orbitalNavigator().anchorNode();
-    const Renderable* focusRenderable = focusNode->renderable();
-    if (!focusRenderable || focusRenderable->renderedWithDesiredData()) {
+    if (isSceneRenderedWithDesiredData()) {
         return _saveRenderingDeltaTime;
     }
     else {
@@ -1023,28 +1350,39 @@ void SessionRecording::addKeyframe(double timestamp, std::string scriptToQueue)
 
 void SessionRecording::moveAheadInTime() {
     double currTime = currentTime();
+    if (!playbackAddChunksToTimeline(currTime)) {
+        LERROR("Error reading the next entries of the playback file");
+        stopPlayback();
+        return;
+    }
     lookForNonCameraKeyframesThatHaveComeDue(currTime);
     updateCameraWithOrWithoutNewKeyframes(currTime);
     if (isSavingFramesDuringPlayback()) {
-        // Check if renderable in focus is still resolving tile loading
-        // do not adjust time while we are doing this, or take screenshot
-        const SceneGraphNode* focusNode =
-            global::navigationHandler.orbitalNavigator().anchorNode();
-        const Renderable* focusRenderable = focusNode->renderable();
-        if (!focusRenderable || focusRenderable->renderedWithDesiredData()) {
+        // Check if any renderable is still resolving its data, for example loading
+        // tiles, do not adjust time while we are doing this, or take screenshot. Each
+        // saved frame thus advances the recorded time by exactly one frame interval
+        if (isSceneRenderedWithDesiredData()) {
             _saveRenderingCurrentRecordedTime += _saveRenderingDeltaTime;
-            global::renderEngine.takeScreenShot();
+            if (_saveRenderingTakesScreenshots) {
+                global::renderEngine.takeScreenShot();
+            }
         }
     }
 }
 
 void SessionRecording::lookForNonCameraKeyframesThatHaveComeDue(double currTime) {
-    while (isTimeToHandleNextNonCameraKeyframe(currTime)) {
+    while (_idxTimeline_nonCamera < _timeline.size() &&
+           isTimeToHandleNextNonCameraKeyframe(currTime))
+    {
         if (!processNextNonCameraKeyframeAheadInTime()) {
             break;
         }
 
         if (++_idxTimeline_nonCamera >= _timeline.size()) {
+            if (!isPlaybackFullyLoaded()) {
+                // The next entries are in a chunk that has not been read yet
+                break;
+            }
             _idxTimeline_nonCamera--;
             if (_playbackActive_time) {
                 signalPlaybackFinishedForComponent(RecordedType::Time);
@@ -1095,7 +1433,9 @@ bool SessionRecording::findNextFutureCameraIndex(double currTime) {
                 _timeline[seekAheadIndex].idxIntoKeyframeTypeArray;
             double seekAheadKeyframeTimestamp = _timeline[seekAheadIndex].timestamp;
 
-            if (indexIntoCameraKeyframes >= (_keyframesCamera.size() - 1)) {
+            if (indexIntoCameraKeyframes >= (_keyframesCamera.size() - 1) &&
+                isPlaybackFullyLoaded())
+            {
                 _hasHitEndOfCameraKeyframes = true;
             }
 
@@ -1241,7 +1581,11 @@ bool SessionRecording::processScriptKeyframe() {
         std::string nextScript = nextKeyframeObj(
             _idxScript,
             _keyframesScript,
-            ([this]() { signalPlaybackFinishedForComponent(RecordedType::Script); })
+            ([this]() {
+                if (isPlaybackFullyLoaded()) {
+                    signalPlaybackFinishedForComponent(RecordedType::Script);
+                }
+            })
         );
         global::scriptEngine.queueScript(
             nextScript,
@@ -1309,11 +1653,12 @@ SessionRecording::RecordedType SessionRecording::getPrevKeyframeType() {
 }
 
 void SessionRecording::saveKeyframeToFileBinary(unsigned char* buffer, size_t size) {
-    _recordFile.write(reinterpret_cast<char*>(buffer), size);
+    _recordFile->write(reinterpret_cast<char*>(buffer), size);
 }
 
 void SessionRecording::saveKeyframeToFile(std::string entry) {
-    _recordFile << std::move(entry) << std::endl;
+    entry += '\n';
+    _recordFile->write(std::move(entry));
 }
 
 SessionRecording::CallbackHandle SessionRecording::addStateChangeCallback(
@@ -1429,6 +1774,15 @@ scripting::LuaLibrary SessionRecording::luaLibrary() {
                 "void",
                 "Stops a playback session before playback of all keyframes is complete"
             },
+            {
+                "seekPlayback",
+                &luascriptfunctions::seekPlayback,
+                {},
+                "number",
+                "Moves a playback session to the provided time, in seconds since the "
+                "start of the recording. This requires a binary recording with an index "
+                "that is played back relative to the time the recording was started."
+            },
             {
                 "enableTakeScreenShotDuringPlayback",
                 &luascriptfunctions::enableTakeScreenShotDuringPlayback,
@@ -1442,6 +1796,15 @@ scripting::LuaLibrary SessionRecording::luaLibrary() {
                 {},
                 "void",
                 "Used to disable that renderings are saved during playback"
+            },
+            {
+                "enableFixedFramePaceDuringPlayback",
+                &luascriptfunctions::enableFixedFramePaceDuringPlayback,
+                {},
+                "int",
+                "Advances the playback by a fixed time step of one frame at the provided "
+                "number of frames per second with every rendered frame, without saving "
+                "the frames"
             }
         }
     };
@@ -142,6 +142,21 @@ int stopPlayback(lua_State* L) {
     return 0;
 }
 
+int seekPlayback(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::seekPlayback");
+
+    const double recordedTime = ghoul::lua::value<double>(
+        L,
+        1,
+        ghoul::lua::PopValue::Yes
+    );
+
+    global::sessionRecording.seekPlayback(recordedTime);
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
 int enableTakeScreenShotDuringPlayback(lua_State* L) {
     ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::enableTakeScreenShotDuringPlayback");
 
@@ -163,4 +178,18 @@ int disableTakeScreenShotDuringPlayback(lua_State* L) {
     return 0;
 }
 
+int enableFixedFramePaceDuringPlayback(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::enableFixedFramePaceDuringPlayback");
+
+    const int fps = ghoul::lua::value<int>(L, 1, ghoul::lua::PopValue::Yes);
+    if (fps <= 0) {
+        return luaL_error(L, "The number of frames per second must be positive");
+    }
+
+    global::sessionRecording.enableFixedFramePaceDuringPlayback(fps);
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
 } // namespace openspace::luascriptfunctions
@@ -37,7 +37,7 @@ namespace {
 
 namespace openspace {
 
-const unsigned int ParallelConnection::ProtocolVersion = 5;
+const unsigned int ParallelConnection::ProtocolVersion = 6;
 
 ParallelConnection::Message::Message(MessageType t, std::vector<char> c)
     : type(t)
@@ -90,36 +90,41 @@ void ParallelConnection::sendDataMessage(const DataMessage& dataMessage) {
 }
 
 bool ParallelConnection::sendMessage(const Message& message) {
+    return sendSerializedMessage(serializeMessage(message));
+}
+
+std::vector<char> ParallelConnection::serializeMessage(const Message& message) {
     const uint32_t messageTypeOut = static_cast<uint32_t>(message.type);
     const uint32_t messageSizeOut = static_cast<uint32_t>(message.content.size());
-    std::vector<char> header;
+    std::vector<char> buffer;
+    buffer.reserve(2 * sizeof(char) + 3 * sizeof(uint32_t) + message.content.size());
 
     //insert header into buffer
-    header.push_back('O');
-    header.push_back('S');
+    buffer.push_back('O');
+    buffer.push_back('S');
 
-    header.insert(header.end(),
+    buffer.insert(buffer.end(),
         reinterpret_cast<const char*>(&ProtocolVersion),
         reinterpret_cast<const char*>(&ProtocolVersion) + sizeof(uint32_t)
     );
 
-    header.insert(header.end(),
+    buffer.insert(buffer.end(),
         reinterpret_cast<const char*>(&messageTypeOut),
         reinterpret_cast<const char*>(&messageTypeOut) + sizeof(uint32_t)
     );
 
-    header.insert(header.end(),
+    buffer.insert(buffer.end(),
         reinterpret_cast<const char*>(&messageSizeOut),
         reinterpret_cast<const char*>(&messageSizeOut) + sizeof(uint32_t)
     );
 
-    if (!_socket->put<char>(header.data(), header.size())) {
-        return false;
-    }
-    if (!_socket->put<char>(message.content.data(), message.content.size())) {
-        return false;
-    }
-    return true;
+    buffer.insert(buffer.end(), message.content.begin(), message.content.end());
+    return buffer;
+}
+
+bool ParallelConnection::sendSerializedMessage(const std::vector<char>& serializedMessage)
+{
+    return _socket->put<char>(serializedMessage.data(), serializedMessage.size());
 }
 
 void ParallelConnection::disconnect() {
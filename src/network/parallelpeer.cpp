@@ -43,6 +43,14 @@ namespace {
     constexpr const size_t MaxLatencyDiffs = 64;
     constexpr const char* _loggerCat = "ParallelPeer";
 
+    // A full camera keyframe is sent after this many compact camera keyframes, so that
+    // clients that connect during a session receive a reference to decode against
+    constexpr const int MaxCompactCameraKeyframes = 10;
+
+    // The client predicts the camera motion past the last keyframe for as many standard
+    // deviations of the measured latency
+    constexpr const double ExtrapolationDeviations = 3.0;
+
     constexpr openspace::properties::Property::PropertyInfo PasswordInfo = {
         "Password",
         "Password",
@@ -136,6 +144,7 @@ ParallelPeer::~ParallelPeer() {
 
 void ParallelPeer::connect() {
     disconnect();
+    _hasReceivedCameraReference = false;
 
     setStatus(ParallelConnection::Status::Connecting);
 
@@ -244,6 +253,10 @@ double ParallelPeer::convertTimestamp(double messageTimestamp) {
 
 
 double ParallelPeer::latencyStandardDeviation() const {
+    if (_latencyDiffs.empty()) {
+        return 0.0;
+    }
+
     double accumulatedLatencyDiffSquared = 0;
     double accumulatedLatencyDiff = 0;
     for (double diff : _latencyDiffs) {
@@ -259,7 +272,26 @@ double ParallelPeer::latencyStandardDeviation() const {
     const double latencyVariance = expectedLatencyDiffSquared -
         expectedLatencyDiff * expectedLatencyDiff;
 
-    return std::sqrt(latencyVariance);
+    return std::sqrt(std::max(latencyVariance, 0.0));
+}
+
+void ParallelPeer::cameraKeyframeReceived(
+                                         const datamessagestructures::CameraKeyframe& kf)
+{
+    const double convertedTimestamp = convertTimestamp(kf._timestamp);
+
+    global::navigationHandler.keyframeNavigator().removeKeyframesAfter(
+        convertedTimestamp
+    );
+
+    interaction::KeyframeNavigator::CameraPose pose;
+    pose.focusNode = kf._focusNode;
+    pose.position = kf._position;
+    pose.rotation = kf._rotation;
+    pose.scale = kf._scale;
+    pose.followFocusNodeRotation = kf._followNodeRotation;
+
+    global::navigationHandler.keyframeNavigator().addKeyframe(convertedTimestamp, pose);
 }
 
 void ParallelPeer::dataMessageReceived(const std::vector<char>& message)
@@ -280,21 +312,19 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message)
     switch (static_cast<datamessagestructures::Type>(type)) {
         case datamessagestructures::Type::CameraData: {
             datamessagestructures::CameraKeyframe kf(buffer);
-            const double convertedTimestamp = convertTimestamp(kf._timestamp);
-
-            global::navigationHandler.keyframeNavigator().removeKeyframesAfter(
-                convertedTimestamp
-            );
-
-            interaction::KeyframeNavigator::CameraPose pose;
-            pose.focusNode = kf._focusNode;
-            pose.position = kf._position;
-            pose.rotation = kf._rotation;
-            pose.scale = kf._scale;
-            pose.followFocusNodeRotation = kf._followNodeRotation;
-
-            global::navigationHandler.keyframeNavigator().addKeyframe(convertedTimestamp,
-                                                                      pose);
+            _receivedCameraReference = kf;
+            _hasReceivedCameraReference = true;
+            cameraKeyframeReceived(kf);
+            break;
+        }
+        case datamessagestructures::Type::CompactCameraData: {
+            if (!_hasReceivedCameraReference) {
+                // We connected in the middle of a session and have to wait for the
+                // next full keyframe before we can decode the compact ones
+                break;
+            }
+            datamessagestructures::CompactCameraKeyframe kf(buffer);
+            cameraKeyframeReceived(kf.toKeyframe(_receivedCameraReference));
             break;
         }
         case datamessagestructures::Type::TimelineData: {
@@ -320,26 +350,41 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message)
                 global::timeManager.removeKeyframesAfter(convertedTimestamp, true);
             }
 
-            for (const datamessagestructures::TimeKeyframe& kfMessage : keyframesMessage)
-            {
+            // We only need at least one keyframe before the current timestamp, so we
+            // can skip and remove all previous ones. The keyframes of the message are
+            // sorted by their timestamp
+            size_t firstKeyframe = 0;
+            for (size_t i = 0; i < keyframesMessage.size(); ++i) {
+                if (convertTimestamp(keyframesMessage[i]._timestamp) < now) {
+                    firstKeyframe = i;
+                }
+            }
+            if (!keyframesMessage.empty()) {
+                const double firstTimestamp =
+                    convertTimestamp(keyframesMessage[firstKeyframe]._timestamp);
+                if (firstTimestamp < now) {
+                    global::timeManager.removeKeyframesBefore(firstTimestamp, true);
+                }
+            }
+
+            std::vector<std::pair<double, TimeKeyframeData>> keyframes;
+            keyframes.reserve(keyframesMessage.size() - firstKeyframe);
+            for (size_t i = firstKeyframe; i < keyframesMessage.size(); ++i) {
+                const datamessagestructures::TimeKeyframe& kfMessage =
+                    keyframesMessage[i];
+
                 TimeKeyframeData timeKeyframeData;
                 timeKeyframeData.delta = kfMessage._dt;
                 timeKeyframeData.pause = kfMessage._paused;
                 timeKeyframeData.time = kfMessage._time;
                 timeKeyframeData.jump = kfMessage._requiresTimeJump;
 
-                const double kfTimestamp = convertTimestamp(kfMessage._timestamp);
-
-                // We only need at least one keyframe before the current timestamp,
-                // so we can remove any other previous ones
-                if (kfTimestamp < now) {
-                    global::timeManager.removeKeyframesBefore(kfTimestamp, true);
-                }
-                global::timeManager.addKeyframe(
-                    kfTimestamp,
-                    timeKeyframeData
+                keyframes.emplace_back(
+                    convertTimestamp(kfMessage._timestamp),
+                    std::move(timeKeyframeData)
                 );
             }
+            global::timeManager.addKeyframes(std::move(keyframes));
             break;
         }
         case datamessagestructures::Type::ScriptData: {
@@ -510,6 +555,14 @@ void ParallelPeer::preSynchronization() {
         _receiveBuffer.pop_front();
     }
 
+    if (_status != _cameraReferenceStatus) {
+        // A new host has to start with a full camera keyframe that clients can use to
+        // decode the following compact ones
+        _hasCameraReference = false;
+        _nCompactCameraKeyframes = 0;
+        _cameraReferenceStatus = _status;
+    }
+
     if (isHost()) {
         double now = global::windowDelegate.applicationTime();
 
@@ -526,6 +579,14 @@ void ParallelPeer::preSynchronization() {
             _timeTimelineChanged = false;
         }
     }
+
+    // Keep moving the camera along its last known motion while a keyframe that is
+    // delayed by latency jitter might still be underway, instead of stalling
+    const bool isClient = _status == ParallelConnection::Status::ClientWithHost;
+    global::navigationHandler.keyframeNavigator().setMaximumExtrapolationTime(
+        isClient ? ExtrapolationDeviations * latencyStandardDeviation() : 0.0
+    );
+
     if (_shouldDisconnect) {
         disconnect();
     }
@@ -612,16 +673,39 @@ void ParallelPeer::sendCameraKeyframe() {
     // Timestamp as current runtime of OpenSpace instance
     kf._timestamp = global::windowDelegate.applicationTime();
 
+    // Most keyframes are sent relative to the last full keyframe. The single precision
+    // position offset is only accurate enough as long as it is not much larger than
+    // the distance to the focus node, so we send a new reference when that happens
+    const bool needsReference = !_hasCameraReference ||
+        _nCompactCameraKeyframes >= MaxCompactCameraKeyframes ||
+        kf._focusNode != _cameraReference._focusNode ||
+        kf._followNodeRotation != _cameraReference._followNodeRotation ||
+        glm::length(kf._position - _cameraReference._position) >
+            glm::length(kf._position);
+
     // Create a buffer for the keyframe
     std::vector<char> buffer;
 
-    // Fill the keyframe buffer
-    kf.serialize(buffer);
+    datamessagestructures::Type type;
+    if (needsReference) {
+        kf.serialize(buffer);
+        type = datamessagestructures::Type::CameraData;
+        _cameraReference = kf;
+        _hasCameraReference = true;
+        _nCompactCameraKeyframes = 0;
+    }
+    else {
+        datamessagestructures::CompactCameraKeyframe(kf, _cameraReference).serialize(
+            buffer
+        );
+        type = datamessagestructures::Type::CompactCameraData;
+        _nCompactCameraKeyframes++;
+    }
 
     const double timestamp = global::windowDelegate.applicationTime();
     // Send message
     _connection.sendDataMessage(ParallelConnection::DataMessage(
-        datamessagestructures::Type::CameraData,
+        type,
         timestamp,
         buffer
     ));
@@ -630,7 +714,7 @@ void ParallelPeer::sendCameraKeyframe() {
 void ParallelPeer::sendTimeTimeline() {
     // Create a keyframe with current position and orientation of camera
     const Timeline<TimeKeyframeData>& timeline = global::timeManager.timeline();
-    std::deque<Keyframe<TimeKeyframeData>> keyframes = timeline.keyframes();
+    const KeyframeSpan<TimeKeyframeData> keyframes = timeline.keyframes();
 
     datamessagestructures::TimeTimeline timelineMessage;
     timelineMessage._clear = true;
@@ -638,7 +722,7 @@ void ParallelPeer::sendTimeTimeline() {
 
     // Case 1: Copy all keyframes from the native timeline
     for (size_t i = 0; i < timeline.nKeyframes(); ++i) {
-        const Keyframe<TimeKeyframeData>& kf = keyframes.at(i);
+        const Keyframe<TimeKeyframeData>& kf = keyframes[i];
 
         datamessagestructures::TimeKeyframe kfMessage;
         kfMessage._time = kf.data.time.j2000Seconds();
@@ -27,13 +27,23 @@
 #include <ghoul/fmt.h>
 #include <ghoul/io/socket/tcpsocket.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cstring>
 #include <functional>
+#include <limits>
 
 // @TODO(abock): In the entire class remove std::shared_ptr<Peer> by const Peer& where
 //               possible to simplify the interface
 
 namespace {
     constexpr const char* _loggerCat = "ParallelServer";
+
+    // The id that messages from the upstream server of a relay are queued with
+    constexpr const size_t UpstreamPeerId = std::numeric_limits<size_t>::max();
+
+    // A peer whose outgoing queue grows beyond this size, even after the superseded
+    // keyframes have been dropped, is too slow to keep up and is disconnected
+    constexpr const size_t MaxOutgoingBytes = 64 * 1024 * 1024;
 } // namespace
 
 namespace openspace {
@@ -59,9 +69,143 @@ std::string ParallelServer::defaultHostAddress() const {
     return _defaultHostAddress;
 }
 
+void ParallelServer::startRelay(const std::string& address, int port,
+                                const std::string& password, const std::string& name)
+{
+    std::unique_ptr<ghoul::io::TcpSocket> socket =
+        std::make_unique<ghoul::io::TcpSocket>(address, port);
+    socket->connect();
+    _upstream = std::make_unique<ParallelConnection>(std::move(socket));
+
+    // The relay authenticates like any other peer
+    std::vector<char> buffer;
+    const uint64_t passCode = std::hash<std::string>{}(password);
+    buffer.insert(
+        buffer.end(),
+        reinterpret_cast<const char*>(&passCode),
+        reinterpret_cast<const char*>(&passCode) + sizeof(uint64_t)
+    );
+    const uint32_t nameLength = static_cast<uint32_t>(name.length());
+    buffer.insert(
+        buffer.end(),
+        reinterpret_cast<const char*>(&nameLength),
+        reinterpret_cast<const char*>(&nameLength) + sizeof(uint32_t)
+    );
+    buffer.insert(buffer.end(), name.begin(), name.end());
+    _upstream->sendMessage({ ParallelConnection::MessageType::Authentication, buffer });
+
+    _isRelay = true;
+    _upstreamThread = std::thread([this]() { handleUpstream(); });
+}
+
 void ParallelServer::stop() {
     _shouldStop = true;
     _socketServer.close();
+
+    if (_upstream) {
+        _upstream->disconnect();
+        if (_upstreamThread.joinable()) {
+            _upstreamThread.join();
+        }
+    }
+}
+
+void ParallelServer::handleUpstream() {
+    while (!_shouldStop && _upstream->isConnectedOrConnecting()) {
+        try {
+            ParallelConnection::Message m = _upstream->receiveMessage();
+            _incomingMessages.push({ UpstreamPeerId, std::move(m) });
+        }
+        catch (const ParallelConnection::ConnectionLostError&) {
+            LERROR("Connection lost to upstream server");
+            _incomingMessages.push({
+                UpstreamPeerId,
+                ParallelConnection::Message(
+                    ParallelConnection::MessageType::Disconnection, std::vector<char>()
+                )
+            });
+            return;
+        }
+    }
+}
+
+void ParallelServer::handleUpstreamMessage(ParallelConnection::Message message) {
+    switch (message.type) {
+        case ParallelConnection::MessageType::Data:
+            sendMessageToClients(ParallelConnection::MessageType::Data, message.content);
+            break;
+        case ParallelConnection::MessageType::ConnectionStatus:
+            handleUpstreamConnectionStatus(std::move(message.content));
+            break;
+        case ParallelConnection::MessageType::NConnections: {
+            uint32_t n = 0;
+            if (message.content.size() >= sizeof(uint32_t)) {
+                std::memcpy(&n, message.content.data(), sizeof(uint32_t));
+            }
+            _upstreamNConnections = n;
+            setNConnections(nConnections());
+            break;
+        }
+        case ParallelConnection::MessageType::Disconnection: {
+            // Without the upstream server there is nobody to receive data from
+            _upstreamHasHost = false;
+            {
+                std::lock_guard lock(_hostInfoMutex);
+                _hostName = "";
+            }
+            std::lock_guard lock(_peerListMutex);
+            for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
+                if (isConnected(*it.second)) {
+                    it.second->status = ParallelConnection::Status::ClientWithoutHost;
+                    sendConnectionStatus(*it.second);
+                }
+            }
+            break;
+        }
+        default:
+            LERROR(fmt::format(
+                "Unsupported upstream message type: {}", static_cast<int>(message.type)
+            ));
+            break;
+    }
+}
+
+void ParallelServer::handleUpstreamConnectionStatus(std::vector<char> message) {
+    if (message.size() < 2 * sizeof(uint32_t)) {
+        LERROR("Received malformed connection status from upstream server");
+        return;
+    }
+
+    uint32_t status = 0;
+    std::memcpy(&status, message.data(), sizeof(uint32_t));
+    uint32_t hostNameSize = 0;
+    std::memcpy(&hostNameSize, message.data() + sizeof(uint32_t), sizeof(uint32_t));
+    hostNameSize = std::min(
+        hostNameSize,
+        static_cast<uint32_t>(message.size() - 2 * sizeof(uint32_t))
+    );
+    const char* hostName = message.data() + 2 * sizeof(uint32_t);
+
+    _upstreamHasHost =
+        static_cast<ParallelConnection::Status>(status) ==
+        ParallelConnection::Status::ClientWithHost;
+    {
+        std::lock_guard lock(_hostInfoMutex);
+        _hostName = std::string(hostName, hostName + hostNameSize);
+    }
+
+    // The local peers mirror the relay's own status with the upstream server
+    const ParallelConnection::Status localStatus = _upstreamHasHost ?
+        ParallelConnection::Status::ClientWithHost :
+        ParallelConnection::Status::ClientWithoutHost;
+
+    std::lock_guard lock(_peerListMutex);
+    for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
+        if (isConnected(*it.second)) {
+            it.second->status = localStatus;
+            sendConnectionStatus(*it.second);
+        }
+    }
 }
 
 void ParallelServer::handleNewPeers() {
@@ -79,10 +223,15 @@ void ParallelServer::handleNewPeers() {
             ParallelConnection::Status::Connecting,
             std::thread()
         });
+        std::lock_guard<std::mutex> lock(_peerListMutex);
         auto it = _peers.emplace(p->id, p);
         it.first->second->thread = std::thread([this, id]() {
             handlePeer(id);
         });
+        Peer* rawPeer = it.first->second.get();
+        it.first->second->sendThread = std::thread([this, rawPeer]() {
+            sendQueuedMessages(*rawPeer);
+        });
     }
 }
 
@@ -130,6 +279,11 @@ void ParallelServer::eventLoop() {
 
 void ParallelServer::handlePeerMessage(PeerMessage peerMessage) {
     const size_t peerId = peerMessage.peerId;
+    if (peerId == UpstreamPeerId) {
+        handleUpstreamMessage(std::move(peerMessage.message));
+        return;
+    }
+
     auto it = _peers.find(peerId);
     if (it == _peers.end()) {
         return;
@@ -199,7 +353,7 @@ void ParallelServer::handleAuthentication(std::shared_ptr<Peer> peer,
         std::lock_guard<std::mutex> _hostMutex(_hostInfoMutex);
         defaultHostAddress = _defaultHostAddress;
     }
-    if (_hostPeerId == 0 &&
+    if (!_isRelay && _hostPeerId == 0 &&
         peer->parallelConnection.socket()->address() == defaultHostAddress)
     {
         // Directly promote the conenction to host (initialize)
@@ -223,9 +377,9 @@ void ParallelServer::handleData(const Peer& peer, std::vector<char> data) {
         LINFO(fmt::format(
             "Connection {} tried to send data without being the host. Ignoring", peer.id
         ));
+        return;
     }
     sendMessageToClients(ParallelConnection::MessageType::Data, data);
-
 }
 
 void ParallelServer::handleHostshipRequest(std::shared_ptr<Peer> peer,
@@ -235,6 +389,14 @@ void ParallelServer::handleHostshipRequest(std::shared_ptr<Peer> peer,
 
     LINFO(fmt::format("Connection {} requested hostship.", peer->id));
 
+    if (_isRelay) {
+        // The host of a relayed session has to connect to the upstream server directly
+        LERROR(fmt::format(
+            "Connection {} requested hostship, which relays do not support", peer->id
+        ));
+        return;
+    }
+
     uint64_t passwordHash = 0;
     input.read(reinterpret_cast<char*>(&passwordHash), sizeof(uint64_t));
 
@@ -277,19 +439,139 @@ bool ParallelServer::isConnected(const Peer& peer) const {
            peer.status != ParallelConnection::Status::Disconnected;
 }
 
+bool ParallelServer::hasHost() const {
+    return _isRelay ? _upstreamHasHost.load() : _hostPeerId > 0;
+}
+
+ParallelServer::OutgoingMessage ParallelServer::createOutgoingMessage(
+                                              ParallelConnection::MessageType messageType,
+                                                       const std::vector<char>& message)
+{
+    OutgoingMessage res;
+    res.serialized = std::make_shared<const std::vector<char>>(
+        ParallelConnection::serializeMessage({ messageType, message })
+    );
+
+    // A data message starts with its type and timestamp, see
+    // ParallelConnection::sendDataMessage
+    constexpr const size_t DataHeaderSize = sizeof(uint32_t) + sizeof(double);
+    if (messageType != ParallelConnection::MessageType::Data ||
+        message.size() < DataHeaderSize)
+    {
+        return res;
+    }
+
+    uint32_t type = 0;
+    std::memcpy(&type, message.data(), sizeof(uint32_t));
+    res.dataType = type;
+
+    using DataType = datamessagestructures::Type;
+    switch (static_cast<DataType>(type)) {
+        case DataType::CameraData:
+        case DataType::CompactCameraData:
+            // Camera keyframes contain the full state of the camera
+            res.isSuperseding = true;
+            break;
+        case DataType::TimelineData:
+            // A timeline only replaces the previous ones if it clears them first
+            res.isSuperseding = message.size() > DataHeaderSize &&
+                                message[DataHeaderSize] != 0;
+            break;
+        default:
+            // Scripts have to be executed in order and are never dropped
+            res.isSuperseding = false;
+            break;
+    }
+    return res;
+}
+
+void ParallelServer::enqueueMessage(Peer& peer, OutgoingMessage message) {
+    bool isOverflowing = false;
+    {
+        std::lock_guard<std::mutex> lock(peer.outgoingMutex);
+        if (!peer.isSending) {
+            return;
+        }
+
+        if (message.isSuperseding) {
+            // Messages only pile up for peers that do not keep up, and for those the
+            // keyframes that have been superseded are not worth sending anymore
+            auto it = std::remove_if(
+                peer.outgoing.begin(),
+                peer.outgoing.end(),
+                [&](const OutgoingMessage& m) {
+                    const bool isSuperseded = m.dataType == message.dataType;
+                    if (isSuperseded) {
+                        peer.nOutgoingBytes -= m.serialized->size();
+                    }
+                    return isSuperseded;
+                }
+            );
+            peer.outgoing.erase(it, peer.outgoing.end());
+        }
+
+        peer.nOutgoingBytes += message.serialized->size();
+        peer.outgoing.push_back(std::move(message));
+        isOverflowing = peer.nOutgoingBytes > MaxOutgoingBytes;
+        if (isOverflowing) {
+            peer.isSending = false;
+        }
+    }
+    peer.outgoingCondition.notify_one();
+
+    if (isOverflowing) {
+        LERROR(fmt::format(
+            "Connection {} cannot keep up with the session. Disconnecting", peer.id
+        ));
+        _incomingMessages.push({
+            peer.id,
+            ParallelConnection::Message(
+                ParallelConnection::MessageType::Disconnection, std::vector<char>()
+            )
+        });
+    }
+}
+
+void ParallelServer::sendQueuedMessages(Peer& peer) {
+    while (true) {
+        OutgoingMessage message;
+        {
+            std::unique_lock<std::mutex> lock(peer.outgoingMutex);
+            peer.outgoingCondition.wait(lock, [&peer]() {
+                return !peer.isSending || !peer.outgoing.empty();
+            });
+            if (!peer.isSending) {
+                return;
+            }
+            message = std::move(peer.outgoing.front());
+            peer.outgoing.pop_front();
+            peer.nOutgoingBytes -= message.serialized->size();
+        }
+
+        if (!peer.parallelConnection.sendSerializedMessage(*message.serialized)) {
+            // The receiving thread notices the lost connection and disconnects the peer
+            return;
+        }
+    }
+}
+
 void ParallelServer::sendMessage(Peer& peer,
                                  ParallelConnection::MessageType messageType,
                                  const std::vector<char>& message)
 {
-    peer.parallelConnection.sendMessage({ messageType, message });
+    enqueueMessage(peer, createOutgoingMessage(messageType, message));
 }
 
 void ParallelServer::sendMessageToAll(ParallelConnection::MessageType messageType,
                                       const std::vector<char>& message)
 {
+    // The message is serialized once and the same buffer is sent to every peer
+    const OutgoingMessage outgoing = createOutgoingMessage(messageType, message);
+
+    std::lock_guard<std::mutex> lock(_peerListMutex);
     for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
         if (isConnected(*it.second)) {
-            it.second->parallelConnection.sendMessage({ messageType, message });
+            enqueueMessage(*it.second, outgoing);
         }
     }
 }
@@ -297,9 +579,12 @@ void ParallelServer::sendMessageToAll(ParallelConnection::MessageType messageTyp
 void ParallelServer::sendMessageToClients(ParallelConnection::MessageType messageType,
                                           const std::vector<char>& message)
 {
+    const OutgoingMessage outgoing = createOutgoingMessage(messageType, message);
+
+    std::lock_guard<std::mutex> lock(_peerListMutex);
     for (std::pair<const size_t, std::shared_ptr<Peer>>& it : _peers) {
         if (it.second->status == ParallelConnection::Status::ClientWithHost) {
-            it.second->parallelConnection.sendMessage({ messageType, message });
+            enqueueMessage(*it.second, outgoing);
         }
     }
 }
@@ -321,8 +606,17 @@ void ParallelServer::disconnect(Peer& peer) {
         setToClient(peer);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(peer.outgoingMutex);
+        peer.isSending = false;
+    }
+    peer.outgoingCondition.notify_one();
+
+    // Disconnecting first unblocks a send thread that is waiting for a slow peer
     peer.parallelConnection.disconnect();
     peer.thread.join();
+    peer.sendThread.join();
+    std::lock_guard<std::mutex> lock(_peerListMutex);
     _peers.erase(peer.id);
 }
 
@@ -383,7 +677,7 @@ void ParallelServer::setToClient(Peer& peer) {
             sendConnectionStatus(*it.second);
         }
     } else {
-        peer.status = (_hostPeerId > 0) ?
+        peer.status = hasHost() ?
             ParallelConnection::Status::ClientWithHost :
             ParallelConnection::Status::ClientWithoutHost;
         sendConnectionStatus(peer);
@@ -393,7 +687,12 @@ void ParallelServer::setToClient(Peer& peer) {
 void ParallelServer::setNConnections(size_t nConnections) {
     _nConnections = nConnections;
     std::vector<char> data;
-    const uint32_t n = static_cast<uint32_t>(_nConnections);
+    // The peers of a relay are part of the upstream session, in which the relay itself
+    // counts as one connection
+    const size_t nUpstream = _upstreamNConnections;
+    const uint32_t n = static_cast<uint32_t>(
+        (_isRelay && nUpstream > 0) ? nUpstream - 1 + _nConnections : _nConnections
+    );
     data.insert(
         data.end(),
         reinterpret_cast<const char*>(&n),
@@ -0,0 +1,214 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/performance/frametimeregression.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/engine/windowdelegate.h>
+#include <openspace/interaction/sessionrecording.h>
+#include <openspace/json.h>
+#include <openspace/performance/performancemanager.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+namespace {
+    constexpr const char* _loggerCat = "FrameTimeRegression";
+
+    // Returns the nearest-rank percentile \p p in [0, 100] of the sorted \p values
+    double percentile(const std::vector<double>& values, double p) {
+        const double rank = std::ceil(p / 100.0 * static_cast<double>(values.size()));
+        const size_t i = static_cast<size_t>(std::max(rank, 1.0)) - 1;
+        return values[std::min(i, values.size() - 1)];
+    }
+
+    nlohmann::json statistics(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        const double sum = std::accumulate(values.begin(), values.end(), 0.0);
+        return {
+            { "samples", values.size() },
+            { "mean", sum / static_cast<double>(values.size()) },
+            { "p50", percentile(values, 50.0) },
+            { "p90", percentile(values, 90.0) },
+            { "p95", percentile(values, 95.0) },
+            { "p99", percentile(values, 99.0) },
+            { "max", values.back() }
+        };
+    }
+} // namespace
+
+namespace openspace::performance {
+
+bool FrameTimeRegression::start(Settings settings) {
+    if (_isRunning) {
+        LERROR("A frame time regression is already running");
+        return false;
+    }
+    if (settings.fps <= 0) {
+        LERROR("The number of frames per second must be positive");
+        return false;
+    }
+
+    global::sessionRecording.enableFixedFramePaceDuringPlayback(settings.fps);
+    const bool success = global::sessionRecording.startPlayback(
+        settings.recording,
+        interaction::KeyframeTimeRef::Relative_recordedStart,
+        true
+    );
+    if (!success) {
+        LERROR(fmt::format("Could not play back '{}'", settings.recording));
+        return false;
+    }
+
+    _settings = std::move(settings);
+    global::performanceManager.startFrameTimeRecording();
+    _isRunning = true;
+    LINFO(fmt::format(
+        "Measuring frame times of '{}' at {} fps", _settings.recording, _settings.fps
+    ));
+    return true;
+}
+
+void FrameTimeRegression::update() {
+    if (_isRunning && !global::sessionRecording.isPlayingBack()) {
+        finish();
+    }
+}
+
+bool FrameTimeRegression::isRunning() const {
+    return _isRunning;
+}
+
+void FrameTimeRegression::finish() {
+    _isRunning = false;
+    global::performanceManager.stopFrameTimeRecording();
+
+    const std::map<std::string, std::vector<double>>& frameTimes =
+        global::performanceManager.frameTimes();
+
+    nlohmann::json phases = nlohmann::json::object();
+    for (const std::pair<const std::string, std::vector<double>>& p : frameTimes) {
+        if (!p.second.empty()) {
+            phases[p.first] = statistics(p.second);
+        }
+    }
+
+    nlohmann::json failures = nlohmann::json::array();
+    if (!_settings.thresholdPath.empty()) {
+        nlohmann::json thresholds;
+        try {
+            std::ifstream file(_settings.thresholdPath);
+            file >> thresholds;
+        }
+        catch (const nlohmann::json::exception& e) {
+            LERROR(fmt::format(
+                "Could not read '{}': {}", _settings.thresholdPath, e.what()
+            ));
+        }
+        if (!thresholds.is_object()) {
+            LERROR(fmt::format("Invalid threshold file '{}'", _settings.thresholdPath));
+            failures.push_back({ { "error", "Invalid threshold file" } });
+            thresholds = nlohmann::json::object();
+        }
+
+        for (auto phase = thresholds.begin(); phase != thresholds.end(); ++phase) {
+            if (!phase->is_object()) {
+                LERROR(fmt::format("Invalid thresholds for phase '{}'", phase.key()));
+                failures.push_back({
+                    { "phase", phase.key() }, { "error", "Invalid thresholds" }
+                });
+                continue;
+            }
+            for (auto limit = phase->begin(); limit != phase->end(); ++limit) {
+                if (phases.count(phase.key()) == 0 ||
+                    phases[phase.key()].count(limit.key()) == 0 ||
+                    !limit->is_number())
+                {
+                    LERROR(fmt::format(
+                        "No statistic '{}' of phase '{}' to compare against",
+                        limit.key(), phase.key()
+                    ));
+                    failures.push_back({
+                        { "phase", phase.key() }, { "statistic", limit.key() },
+                        { "error", "Missing statistic" }
+                    });
+                    continue;
+                }
+
+                const double value = phases[phase.key()][limit.key()];
+                const double threshold = *limit;
+                if (value > threshold) {
+                    LERROR(fmt::format(
+                        "{} of {} is {:.3f} ms, exceeding the threshold of {:.3f} ms",
+                        limit.key(), phase.key(), value, threshold
+                    ));
+                    failures.push_back({
+                        { "phase", phase.key() }, { "statistic", limit.key() },
+                        { "value", value }, { "threshold", threshold }
+                    });
+                }
+            }
+        }
+    }
+
+    const size_t nFrames = frameTimes.count("Frame") > 0 ?
+        frameTimes.at("Frame").size() :
+        0;
+    const bool passed = failures.empty();
+    const nlohmann::json result = {
+        { "recording", _settings.recording },
+        { "fps", _settings.fps },
+        { "frames", nFrames },
+        { "phases", std::move(phases) },
+        { "passed", passed },
+        { "failures", std::move(failures) }
+    };
+
+    std::ofstream file(_settings.outputPath);
+    file << result.dump(2) << std::endl;
+    if (!file.good()) {
+        LERROR(fmt::format("Could not write results to '{}'", _settings.outputPath));
+    }
+
+    if (_settings.thresholdPath.empty()) {
+        LINFO(fmt::format(
+            "Wrote frame times of {} frames to '{}'", nFrames, _settings.outputPath
+        ));
+    }
+    else if (passed) {
+        LINFO(fmt::format("Frame time regression of {} frames passed", nFrames));
+    }
+    else {
+        LERROR(fmt::format("Frame time regression of {} frames failed", nFrames));
+    }
+
+    if (_settings.quitWhenDone) {
+        global::windowDelegate.terminate();
+    }
+}
+
+} // namespace openspace::performance
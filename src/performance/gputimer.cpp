@@ -0,0 +1,96 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/performance/gputimer.h>
+
+namespace openspace::performance {
+
+void GpuTimer::begin() {
+    if (!_isInitialized) {
+        glGenQueries(NQueries, _queries.data());
+        _isInitialized = true;
+    }
+
+    // The next query is the oldest one. If it is still waiting for its result, all of
+    // them are, so we skip this measurement instead of stalling the pipeline
+    latestResult();
+    if (_isPending[_current]) {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, _queries[_current]);
+    _isActive = true;
+}
+
+void GpuTimer::end() {
+    if (!_isActive) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    _isPending[_current] = true;
+    _current = (_current + 1) % NQueries;
+    _isActive = false;
+}
+
+long long GpuTimer::latestResult() {
+    // Walk from the oldest to the newest query, as the results become available in the
+    // order in which the queries were issued
+    for (int i = 0; i < NQueries; ++i) {
+        const int q = (_current + i) % NQueries;
+        if (!_isPending[q]) {
+            continue;
+        }
+
+        GLint isAvailable = GL_FALSE;
+        glGetQueryObjectiv(_queries[q], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (isAvailable == GL_FALSE) {
+            break;
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(_queries[q], GL_QUERY_RESULT, &elapsed);
+        _latestResult = static_cast<long long>(elapsed);
+        _isPending[q] = false;
+        ++_nResults;
+    }
+    return _latestResult;
+}
+
+unsigned long long GpuTimer::nResults() const {
+    return _nResults;
+}
+
+void GpuTimer::deinitialize() {
+    if (_isInitialized) {
+        glDeleteQueries(NQueries, _queries.data());
+        _queries = {};
+        _isPending = {};
+        _isInitialized = false;
+    }
+    _isActive = false;
+    _latestResult = 0;
+}
+
+} // namespace openspace::performance
@@ -35,6 +35,7 @@
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "PerformanceManager";
@@ -53,10 +54,49 @@ namespace {
     };
 
     constexpr const char* LocalSharedMemoryNameBase = "PerformanceMeasurement_";
+
+    // At 60 fps and a few hundred zones per frame, this covers more than 20 seconds of
+    // the main thread, at 24 bytes per event
+    constexpr const size_t MaxTraceEventsPerThread = 1 << 18;
+
+    // Writes the string as a JSON string literal, zone names are usually plain C++
+    // identifiers, but we want the file to stay valid regardless
+    void writeJsonString(std::ostream& out, const char* str) {
+        out << '"';
+        for (const char* c = str; *c != '\0'; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out << '\\';
+            }
+            out << *c;
+        }
+        out << '"';
+    }
 } // namespace
 
 namespace openspace::performance {
 
+struct PerformanceManager::TraceBuffer {
+    struct Event {
+        const char* name;
+        // Nanoseconds since the epoch of the steady_clock
+        int64_t begin;
+        int64_t end;
+    };
+
+    // Preallocated, so that the owning thread never has to reallocate while the
+    // exporting thread is reading
+    std::vector<Event> events;
+    // Only written by the owning thread, the release store publishes the event
+    std::atomic<size_t> nEvents = 0;
+    std::atomic<size_t> nDroppedEvents = 0;
+    int generation = 0;
+    int threadIndex = 0;
+};
+
+PerformanceManager::PerformanceManager() {} // NOLINT
+
+PerformanceManager::~PerformanceManager() {} // NOLINT
+
 // The Performance Manager will use a level of indirection in order to support multiple
 // PerformanceManagers running in parallel:
 // The ghoul::SharedData block addressed by OpenSpacePerformanceMeasurementSharedData
@@ -247,7 +287,8 @@ void PerformanceManager::outputLogs() {
                 node.updateRenderable[i],
                 node.updateRotation[i],
                 node.updateScaling[i],
-                node.updateTranslation[i]
+                node.updateTranslation[i],
+                node.renderTimeGpu[i]
             };
             writeData(out, data);
         }
@@ -336,6 +377,198 @@ PerformanceLayout* PerformanceManager::performanceData() {
     return reinterpret_cast<PerformanceLayout*>(ptr);
 }
 
+void PerformanceManager::startTracing() {
+    std::lock_guard<std::mutex> lock(_traceBufferMutex);
+
+    // Threads that started a zone while the previous trace was restarted might still be
+    // writing into its buffers, so we only release the ones from the trace before that
+    const int generation = _traceGeneration + 1;
+    _traceBuffers.erase(
+        std::remove_if(
+            _traceBuffers.begin(),
+            _traceBuffers.end(),
+            [generation](const std::unique_ptr<TraceBuffer>& b) {
+                return b->generation < generation - 1;
+            }
+        ),
+        _traceBuffers.end()
+    );
+
+    _traceStartTime = std::chrono::steady_clock::now();
+    _traceStartSystemTime = std::chrono::system_clock::now();
+    _traceGeneration = generation;
+    _isTracing = true;
+    _isCollectingTraceEvents = true;
+    LINFO("Started tracing");
+}
+
+void PerformanceManager::stopTracing() {
+    _isTracing = false;
+    updateTraceEventCollection();
+    LINFO("Stopped tracing");
+}
+
+bool PerformanceManager::isTracing() const {
+    return _isTracing.load(std::memory_order_relaxed);
+}
+
+PerformanceManager::TraceBuffer& PerformanceManager::traceBuffer() {
+    // There is only one PerformanceManager, so a single thread-local pointer suffices
+    thread_local TraceBuffer* buffer = nullptr;
+
+    const int generation = _traceGeneration;
+    if (!buffer || buffer->generation != generation) {
+        std::lock_guard<std::mutex> lock(_traceBufferMutex);
+
+        auto b = std::make_unique<TraceBuffer>();
+        b->events.resize(MaxTraceEventsPerThread);
+        b->generation = generation;
+        b->threadIndex = static_cast<int>(std::count_if(
+            _traceBuffers.begin(),
+            _traceBuffers.end(),
+            [generation](const std::unique_ptr<TraceBuffer>& tb) {
+                return tb->generation == generation;
+            }
+        ));
+        buffer = b.get();
+        _traceBuffers.push_back(std::move(b));
+    }
+    return *buffer;
+}
+
+void PerformanceManager::storeTraceEvent(const char* name,
+                                         std::chrono::steady_clock::time_point begin,
+                                         std::chrono::steady_clock::time_point end)
+{
+    using namespace std::chrono;
+
+    const bool isFrameThread =
+        std::this_thread::get_id() == _frameTimeThread.load(std::memory_order_relaxed);
+
+    if (isFrameThread && _isLiveFrameTimesEnabled.load(std::memory_order_acquire) &&
+        _hasFrameStart)
+    {
+        _currentFrame.zones.push_back({
+            name,
+            std::max(duration<double, std::milli>(begin - _frameStartTime).count(), 0.0),
+            duration<double, std::milli>(end - begin).count()
+        });
+    }
+
+    if (isFrameThread && _isRecordingFrameTimes.load(std::memory_order_acquire)) {
+        const double ms = duration<double, std::milli>(end - begin).count();
+        // There are only a handful of distinct zones per frame and the names are string
+        // literals, so comparing the pointers first is enough in almost all cases
+        auto it = std::find_if(
+            _currentFrameTimes.begin(),
+            _currentFrameTimes.end(),
+            [name](const std::pair<const char*, double>& p) {
+                return p.first == name || std::strcmp(p.first, name) == 0;
+            }
+        );
+        if (it != _currentFrameTimes.end()) {
+            it->second += ms;
+        }
+        else {
+            _currentFrameTimes.emplace_back(name, ms);
+        }
+    }
+
+    if (!isTracing()) {
+        return;
+    }
+
+    TraceBuffer& buffer = traceBuffer();
+    const size_t i = buffer.nEvents.load(std::memory_order_relaxed);
+    if (i >= buffer.events.size()) {
+        buffer.nDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[i] = {
+        name,
+        duration_cast<nanoseconds>(begin.time_since_epoch()).count(),
+        duration_cast<nanoseconds>(end.time_since_epoch()).count()
+    };
+    buffer.nEvents.store(i + 1, std::memory_order_release);
+}
+
+bool PerformanceManager::writeChromeTrace(const std::string& path, int processId,
+                                          const std::string& processName) const
+{
+    using namespace std::chrono;
+
+    std::ofstream out(absPath(path));
+    if (!out.good()) {
+        LERROR(fmt::format("Could not open file '{}' for writing the trace", path));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_traceBufferMutex);
+
+    // The events are recorded with the steady_clock, which is converted into wall-clock
+    // time using the offset between the two clocks at the beginning of the trace
+    const int64_t startTime = duration_cast<nanoseconds>(
+        _traceStartTime.time_since_epoch()
+    ).count();
+    const int64_t startSystemTime = duration_cast<microseconds>(
+        _traceStartSystemTime.time_since_epoch()
+    ).count();
+    auto toTimestamp = [&](int64_t t) {
+        return static_cast<double>(startSystemTime) +
+               static_cast<double>(t - startTime) / 1000.0;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << fmt::format(
+        R"({{"name":"process_name","ph":"M","pid":{},"args":{{"name":)",
+        processId
+    );
+    writeJsonString(out, processName.c_str());
+    out << "}}";
+
+    size_t nEvents = 0;
+    size_t nDroppedEvents = 0;
+    for (const std::unique_ptr<TraceBuffer>& buffer : _traceBuffers) {
+        if (buffer->generation != _traceGeneration) {
+            continue;
+        }
+
+        out << fmt::format(
+            ",\n"
+            R"({{"name":"thread_name","ph":"M","pid":{},"tid":{},)"
+            R"("args":{{"name":"Thread {}"}}}})",
+            processId, buffer->threadIndex, buffer->threadIndex
+        );
+
+        const size_t n = buffer->nEvents.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+            const TraceBuffer::Event& e = buffer->events[i];
+            out << ",\n{\"name\":";
+            writeJsonString(out, e.name);
+            out << fmt::format(
+                R"(,"ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{}}})",
+                toTimestamp(e.begin),
+                static_cast<double>(e.end - e.begin) / 1000.0,
+                processId,
+                buffer->threadIndex
+            );
+        }
+        nEvents += n;
+        nDroppedEvents += buffer->nDroppedEvents;
+    }
+    out << "\n]}\n";
+
+    if (nDroppedEvents > 0) {
+        LWARNING(fmt::format(
+            "{} trace events were dropped as the trace buffers were full",
+            nDroppedEvents
+        ));
+    }
+    LINFO(fmt::format("Wrote {} trace events to '{}'", nEvents, path));
+    return out.good();
+}
+
 void PerformanceManager::tick() {
     _currentTick = (_currentTick + 1) % PerformanceLayout::NumberValues;
 }
@@ -415,6 +648,14 @@ void PerformanceManager::storeScenePerformanceMeasurements(
         );
         entry.renderTime[PerformanceLayout::NumberValues - 1] = r.renderTime / Micro;
 
+        std::rotate(
+            std::begin(entry.renderTimeGpu),
+            std::next(std::begin(entry.renderTimeGpu)),
+            std::end(entry.renderTimeGpu)
+        );
+        entry.renderTimeGpu[PerformanceLayout::NumberValues - 1] =
+            r.renderTimeGpu / Micro;
+
         std::rotate(
             std::begin(entry.updateTranslation),
             std::next(std::begin(entry.updateTranslation)),
@@ -456,4 +697,115 @@ void PerformanceManager::storeScenePerformanceMeasurements(
     tick();
 }
 
+void PerformanceManager::startFrameTimeRecording() {
+    _isRecordingFrameTimes = false;
+
+    _frameTimes.clear();
+    _currentFrameTimes.clear();
+    _hasFrameStart = false;
+
+    _frameTimeThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    _isRecordingFrameTimes.store(true, std::memory_order_release);
+    _isCollectingTraceEvents = true;
+    LINFO("Started recording frame times");
+}
+
+void PerformanceManager::stopFrameTimeRecording() {
+    _isRecordingFrameTimes = false;
+    updateTraceEventCollection();
+    LINFO(fmt::format(
+        "Stopped recording frame times after {} frames",
+        _frameTimes.count("Frame") > 0 ? _frameTimes["Frame"].size() : 0
+    ));
+}
+
+bool PerformanceManager::isRecordingFrameTimes() const {
+    return _isRecordingFrameTimes.load(std::memory_order_relaxed);
+}
+
+bool PerformanceManager::isCollectingTraceEvents() const {
+    return _isCollectingTraceEvents.load(std::memory_order_relaxed);
+}
+
+void PerformanceManager::finishFrame() {
+    if (!isRecordingFrameTimes() && !isLiveFrameTimesEnabled()) {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (_hasFrameStart && isLiveFrameTimesEnabled()) {
+        _currentFrame.duration =
+            std::chrono::duration<double, std::milli>(now - _frameStartTime).count();
+        // Swapping keeps the capacity of both vectors, so this does not allocate
+        std::swap(_currentFrame, _lastFrame);
+    }
+    _currentFrame.zones.clear();
+
+    // The zones before the first call belong to a frame that was only partially recorded
+    if (_hasFrameStart && isRecordingFrameTimes()) {
+        _frameTimes["Frame"].push_back(
+            std::chrono::duration<double, std::milli>(now - _frameStartTime).count()
+        );
+        for (const std::pair<const char*, double>& p : _currentFrameTimes) {
+            _frameTimes[p.first].push_back(p.second);
+        }
+    }
+    _currentFrameTimes.clear();
+    _frameStartTime = now;
+    _hasFrameStart = true;
+}
+
+void PerformanceManager::storeGpuFrameTime(double milliseconds) {
+    if (isRecordingFrameTimes()) {
+        _frameTimes["GPU"].push_back(milliseconds);
+    }
+}
+
+const std::map<std::string, std::vector<double>>& PerformanceManager::frameTimes() const {
+    return _frameTimes;
+}
+
+void PerformanceManager::setLiveFrameTimesEnabled(bool enabled) {
+    if (enabled == isLiveFrameTimesEnabled()) {
+        return;
+    }
+
+    if (enabled) {
+        _currentFrame = FrameSummary();
+        _lastFrame = FrameSummary();
+        if (!isRecordingFrameTimes()) {
+            _hasFrameStart = false;
+        }
+        _frameTimeThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        _isLiveFrameTimesEnabled.store(true, std::memory_order_release);
+        _isCollectingTraceEvents = true;
+    }
+    else {
+        _isLiveFrameTimesEnabled = false;
+        updateTraceEventCollection();
+    }
+}
+
+bool PerformanceManager::isLiveFrameTimesEnabled() const {
+    return _isLiveFrameTimesEnabled.load(std::memory_order_relaxed);
+}
+
+const PerformanceManager::FrameSummary& PerformanceManager::lastFrame() const {
+    return _lastFrame;
+}
+
+void PerformanceManager::setGpuSynchronization(bool enabled) {
+    _synchronizeGpu = enabled;
+}
+
+bool PerformanceManager::isGpuSynchronizationEnabled() const {
+    return _synchronizeGpu.load(std::memory_order_relaxed);
+}
+
+void PerformanceManager::updateTraceEventCollection() {
+    _isCollectingTraceEvents =
+        _isTracing.load() || _isRecordingFrameTimes.load() ||
+        _isLiveFrameTimesEnabled.load();
+}
+
 } // namespace openspace::performance
@@ -32,13 +32,18 @@ namespace openspace::performance {
 
 PerformanceMeasurement::PerformanceMeasurement(std::string identifier)
     : _identifier(std::move(identifier))
+    , _synchronizeGpu(global::performanceManager.isGpuSynchronizationEnabled())
 {
-    glFinish();
+    if (_synchronizeGpu) {
+        glFinish();
+    }
     _startTime = std::chrono::high_resolution_clock::now();
 }
 
 PerformanceMeasurement::~PerformanceMeasurement() {
-    glFinish();
+    if (_synchronizeGpu) {
+        glFinish();
+    }
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
         endTime - _startTime
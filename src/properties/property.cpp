@@ -29,6 +29,7 @@
 #include <ghoul/lua/ghoul_lua.h>
 
 #include <algorithm>
+#include <atomic>
 
 #include <ghoul/logging/logmanager.h>
 
@@ -39,6 +40,15 @@ namespace {
 
     constexpr const char* _metaDataKeyViewPrefix = "view.";
 
+    // The nesting depth of the currently active change batches
+    int ChangeBatchDepth = 0;
+    // The properties that have changed during the current change batch. Entries are set
+    // to nullptr once they have been notified or if the property is destroyed before
+    std::vector<openspace::properties::Property*> PendingNotifications;
+    // The number of changes of any property. Properties are changed from worker threads
+    // as well, for example by asynchronously loaded resources
+    std::atomic<uint64_t> ChangeCount = 0;
+
 } // namespace
 
 namespace openspace::properties {
@@ -113,6 +123,14 @@ Property::Property(PropertyInfo info)
 }
 
 Property::~Property() {
+    if (_hasPendingNotification) {
+        std::replace(
+            PendingNotifications.begin(),
+            PendingNotifications.end(),
+            this,
+            static_cast<Property*>(nullptr)
+        );
+    }
     notifyDeleteListeners();
 }
 
@@ -300,7 +318,47 @@ void Property::setPropertyOwner(PropertyOwner* owner) {
     _owner = owner;
 }
 
+void Property::beginChangeBatch() {
+    ++ChangeBatchDepth;
+}
+
+void Property::endChangeBatch() {
+    ghoul_assert(ChangeBatchDepth > 0, "No change batch was started");
+
+    --ChangeBatchDepth;
+    if (ChangeBatchDepth > 0) {
+        return;
+    }
+
+    // The callbacks are free to change other properties, which will notify their own
+    // listeners immediately now that the batch is over, or to destroy pending properties
+    for (size_t i = 0; i < PendingNotifications.size(); ++i) {
+        Property* p = PendingNotifications[i];
+        if (!p) {
+            continue;
+        }
+        PendingNotifications[i] = nullptr;
+        p->_hasPendingNotification = false;
+        p->notifyChangeListeners();
+    }
+    PendingNotifications.clear();
+}
+
+uint64_t Property::changeCount() {
+    return ChangeCount;
+}
+
 void Property::notifyChangeListeners() {
+    ++ChangeCount;
+
+    if (ChangeBatchDepth > 0) {
+        if (!_hasPendingNotification) {
+            _hasPendingNotification = true;
+            PendingNotifications.push_back(this);
+        }
+        return;
+    }
+
     for (const std::pair<OnChangeHandle, std::function<void()>>& p : _onChangeCallbacks) {
         p.second();
     }
@@ -66,6 +66,8 @@ PropertyOwner::PropertyOwner(PropertyOwnerInfo info)
 PropertyOwner::~PropertyOwner() {
     _properties.clear();
     _subOwners.clear();
+    _uriIndex.clear();
+    _uriTrie.clear();
 }
 
 const std::vector<Property*>& PropertyOwner::properties() const {
@@ -84,43 +86,32 @@ std::vector<Property*> PropertyOwner::propertiesRecursive() const {
 }
 
 Property* PropertyOwner::property(const std::string& uri) const {
-    auto it = std::find_if(
-        _properties.begin(),
-        _properties.end(),
-        [&uri](Property* prop) { return prop->identifier() == uri; }
-    );
-
-    if (it == _properties.end() || (*it)->identifier() != uri) {
-        // if we do not own the searched property, it must consist of a concatenated
-        // name and we can delegate it to a subowner
-        const size_t ownerSeparator = uri.find(URISeparator);
-        if (ownerSeparator == std::string::npos) {
-            // if we do not own the property and there is no separator, it does not exist
-            return nullptr;
-        }
-        else {
-            const std::string ownerName = uri.substr(0, ownerSeparator);
-            const std::string propertyName = uri.substr(ownerSeparator + 1);
-
-            PropertyOwner* owner = propertySubOwner(ownerName);
-            if (!owner) {
-                return nullptr;
-            }
-            else {
-                // Recurse into the subOwner
-                return owner->property(propertyName);
-            }
-        }
-    }
-    else {
-        return *it;
-    }
+    // The root owner knows the URIs of all properties in the hierarchy, so instead of
+    // recursing into the sub-owners, a lookup is a single search in the root's index
+    const PropertyOwner& root = rootOwner();
+    const auto it = _owner ?
+        root._uriIndex.find(uriPrefix() + uri) :
+        root._uriIndex.find(uri);
+    return (it != root._uriIndex.end()) ? it->second : nullptr;
 }
 
 bool PropertyOwner::hasProperty(const std::string& uri) const {
     return property(uri) != nullptr;
 }
 
+std::vector<PrefixTrie::Completion> PropertyOwner::propertyUriCompletions(
+                                                            std::string_view prefix) const
+{
+    const std::string ownPrefix = uriPrefix();
+    std::vector<PrefixTrie::Completion> res = rootOwner()._uriTrie.completions(
+        ownPrefix + std::string(prefix)
+    );
+    for (PrefixTrie::Completion& c : res) {
+        c.value.erase(0, ownPrefix.size());
+    }
+    return res;
+}
+
 bool PropertyOwner::hasProperty(const Property* prop) const {
     ghoul_precondition(prop != nullptr, "prop must not be nullptr");
 
@@ -203,6 +194,10 @@ void PropertyOwner::addProperty(Property* prop) {
         else {
             _properties.push_back(prop);
             prop->setPropertyOwner(this);
+            PropertyOwner& root = rootOwner();
+            const std::string uri = uriPrefix() + prop->identifier();
+            root._uriIndex[uri] = prop;
+            root._uriTrie.insert(uri);
         }
     }
 }
@@ -247,6 +242,17 @@ void PropertyOwner::addPropertySubOwner(openspace::properties::PropertyOwner* ow
         else {
             _subOwners.push_back(owner);
             owner->setPropertyOwner(this);
+
+            // Until now, the new sub-owner was the root of its own hierarchy, so its
+            // index contains everything that has to be added to our root's index
+            const std::string prefix = owner->uriPrefix();
+            PropertyOwner& root = rootOwner();
+            for (const std::pair<const std::string, Property*>& p : owner->_uriIndex) {
+                root._uriIndex[prefix + p.first] = p.second;
+                root._uriTrie.insert(prefix + p.first);
+            }
+            owner->_uriIndex.clear();
+            owner->_uriTrie.clear();
         }
     }
 }
@@ -267,6 +273,10 @@ void PropertyOwner::removeProperty(Property* prop) {
 
     // If we found the property identifier, we can delete it
     if (it != _properties.end() && (*it)->identifier() == prop->identifier()) {
+        PropertyOwner& root = rootOwner();
+        const std::string uri = uriPrefix() + prop->identifier();
+        root._uriIndex.erase(uri);
+        root._uriTrie.erase(uri);
         (*it)->setPropertyOwner(nullptr);
         _properties.erase(it);
     } else {
@@ -294,7 +304,24 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner*
 
     // If we found the propertyowner, we can delete it
     if (it != _subOwners.end() && (*it)->identifier() == owner->identifier()) {
+        std::vector<std::pair<std::string, Property*>> uris;
+        owner->collectUris("", uris);
+
+        const std::string prefix = owner->uriPrefix();
+        PropertyOwner& root = rootOwner();
+        for (const std::pair<std::string, Property*>& p : uris) {
+            root._uriIndex.erase(prefix + p.first);
+            root._uriTrie.erase(prefix + p.first);
+        }
+
         _subOwners.erase(it);
+
+        // The removed owner becomes the root of its own hierarchy again
+        owner->setPropertyOwner(nullptr);
+        owner->_uriIndex.insert(uris.begin(), uris.end());
+        for (const std::pair<std::string, Property*>& p : uris) {
+            owner->_uriTrie.insert(p.first);
+        }
     } else {
         LERROR(fmt::format(
             "PropertyOwner with name '{}' not found for removal", owner->identifier()
@@ -316,13 +343,60 @@ void PropertyOwner::setIdentifier(std::string identifier) {
         "Identifier must contain any whitespaces"
     );
 
+    if (!_owner) {
+        _identifier = std::move(identifier);
+        return;
+    }
+
+    // The URIs of all properties below this owner change with the identifier, so they
+    // have to be reinserted into the root's index
+    std::vector<std::pair<std::string, Property*>> uris;
+    collectUris("", uris);
+
+    PropertyOwner& root = rootOwner();
+    const std::string oldPrefix = uriPrefix();
+    for (const std::pair<std::string, Property*>& p : uris) {
+        root._uriIndex.erase(oldPrefix + p.first);
+        root._uriTrie.erase(oldPrefix + p.first);
+    }
+
     _identifier = std::move(identifier);
+
+    const std::string newPrefix = uriPrefix();
+    for (const std::pair<std::string, Property*>& p : uris) {
+        root._uriIndex[newPrefix + p.first] = p.second;
+        root._uriTrie.insert(newPrefix + p.first);
+    }
 }
 
 const std::string& PropertyOwner::identifier() const {
     return _identifier;
 }
 
+PropertyOwner& PropertyOwner::rootOwner() {
+    return _owner ? _owner->rootOwner() : *this;
+}
+
+const PropertyOwner& PropertyOwner::rootOwner() const {
+    return _owner ? _owner->rootOwner() : *this;
+}
+
+std::string PropertyOwner::uriPrefix() const {
+    // The identifier of the root owner is not part of the URIs that it resolves
+    return _owner ? _owner->uriPrefix() + _identifier + URISeparator : "";
+}
+
+void PropertyOwner::collectUris(const std::string& prefix,
+                             std::vector<std::pair<std::string, Property*>>& uris) const
+{
+    for (Property* p : _properties) {
+        uris.emplace_back(prefix + p->identifier(), p);
+    }
+    for (const PropertyOwner* o : _subOwners) {
+        o->collectUris(prefix + o->identifier() + URISeparator, uris);
+    }
+}
+
 void PropertyOwner::setGuiName(std::string guiName) {
     _guiName = std::move(guiName);
 }
@@ -30,6 +30,7 @@
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/performance/performancemanager.h>
 #include <openspace/performance/performancemeasurement.h>
+#include <openspace/performance/tracezone.h>
 #include <openspace/rendering/raycastermanager.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/rendering/renderable.h>
@@ -43,6 +44,7 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 
 namespace {
     constexpr const char* _loggerCat = "ABufferRenderer";
@@ -53,7 +55,19 @@ namespace {
 
     constexpr int MaxRaycasters = 32;
     constexpr int MaxLayers = 32;
-    constexpr int MaxAverageLayers = 8;
+    constexpr int InitialAverageLayers = 8;
+
+    // Every fragment is stored as one uvec4
+    constexpr size_t FragmentSize = 4 * sizeof(GLuint);
+    // Number of values per pixel that the overflowing fragments are accumulated in
+    constexpr size_t OverflowStride = 6;
+
+    // When the fragment buffer is resized, it is made this much larger than the number
+    // of fragments that were requested in the last frame
+    constexpr double CapacityHeadroom = 1.25;
+    // The number of frames in which less than a quarter of the fragment buffer has to be
+    // used before it is shrunk
+    constexpr int ShrinkDelay = 120;
 } // namespace
 
 namespace openspace {
@@ -84,9 +98,20 @@ void ABufferRenderer::initialize() {
     glGenBuffers(1, &_anchorPointerTextureInitializer);
     glGenBuffers(1, &_atomicCounterBuffer);
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _atomicCounterBuffer);
-    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+    glBufferData(GL_ATOMIC_COUNTER_BUFFER, 2 * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
     glGenBuffers(1, &_fragmentBuffer);
     glGenTextures(1, &_fragmentTexture);
+    glGenBuffers(1, &_overflowBuffer);
+
+    glGenBuffers(
+        static_cast<GLsizei>(_counterReadback.buffers.size()),
+        _counterReadback.buffers.data()
+    );
+    for (GLuint buffer : _counterReadback.buffers) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, 2 * sizeof(GLuint), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
     glGenTextures(1, &_mainColorTexture);
     glGenTextures(1, &_mainDepthTexture);
@@ -146,6 +171,19 @@ void ABufferRenderer::deinitialize() {
     LINFO("Deinitializing ABufferRenderer");
     glDeleteBuffers(1, &_fragmentBuffer);
     glDeleteTextures(1, &_fragmentTexture);
+    glDeleteBuffers(1, &_overflowBuffer);
+
+    for (GLsync& fence : _counterReadback.fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    glDeleteBuffers(
+        static_cast<GLsizei>(_counterReadback.buffers.size()),
+        _counterReadback.buffers.data()
+    );
+    _fragmentCapacity = 0;
 
     glDeleteTextures(1, &_anchorPointerTexture);
     glDeleteBuffers(1, &_anchorPointerTextureInitializer);
@@ -170,6 +208,14 @@ void ABufferRenderer::update() {
         updateResolution();
         updateMSAASamplingPattern();
     }
+    else if (_dirtyFragmentBudget) {
+        updateFragmentCapacity(_fragmentCapacity);
+    }
+
+    // Grow or shrink the fragment buffer depending on how many fragments were
+    // requested in the last frame that has finished rendering
+    readBackFragmentCount();
+    adaptFragmentCapacity();
 
     // Make sure that the renderengine gets the correct render data
     // to feed into all render programs.
@@ -547,6 +593,7 @@ void ABufferRenderer::render(Scene* scene, Camera* camera, float blackoutFactor)
     const bool doPerformanceMeasurements = global::performanceManager.isEnabled();
 
     PerfMeasure("ABufferRenderer::render");
+    PerfTrace("ABufferRenderer::render");
 
     if (!scene || !camera) {
         return;
@@ -578,6 +625,7 @@ void ABufferRenderer::render(Scene* scene, Camera* camera, float blackoutFactor)
     glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, _atomicCounterBuffer);
     glBindImageTexture(0, _anchorPointerTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
     glBindImageTexture(1, _fragmentTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32UI);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, _overflowBuffer);
 
     // Render the scene to the fragment buffer. Collect renderer tasks (active raycasters)
     int renderBinMask = static_cast<int>(Renderable::RenderBin::Background) |
@@ -611,6 +659,31 @@ void ABufferRenderer::render(Scene* scene, Camera* camera, float blackoutFactor)
         }
     }
 
+    glMemoryBarrier(
+        GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT |
+        GL_BUFFER_UPDATE_BARRIER_BIT
+    );
+
+    // Copy the fragment counter so that it can be read back in a later frame, once the
+    // GPU has caught up, without stalling the pipeline
+    const int slot = _counterReadback.current;
+    if (_counterReadback.fences[slot]) {
+        glDeleteSync(_counterReadback.fences[slot]);
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, _atomicCounterBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _counterReadback.buffers[slot]);
+    glCopyBufferSubData(
+        GL_COPY_READ_BUFFER,
+        GL_COPY_WRITE_BUFFER,
+        0,
+        0,
+        2 * sizeof(GLuint)
+    );
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    _counterReadback.fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _counterReadback.current = (slot + 1) % _counterReadback.buffers.size();
+
 
     // Step 3: Resolve the buffer
     _resolveProgram->activate();
@@ -719,6 +792,11 @@ void ABufferRenderer::setHDRBackground(float hdrBackground) {
 }
 
 
+void ABufferRenderer::setFragmentBufferBudget(int megabytes) {
+    _fragmentBufferBudget = static_cast<size_t>(megabytes) * 1024 * 1024;
+    _dirtyFragmentBudget = true;
+}
+
 void ABufferRenderer::setGamma(float gamma) {
     _gamma = gamma;
     if (_gamma < 0.f) {
@@ -756,10 +834,21 @@ void ABufferRenderer::clear() {
     );
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    static const GLuint zero = 1;
+    // The counter starts at 1 as 0 is the null pointer. The capacity is stored next to it
+    const GLuint counter[2] = { 1, _fragmentCapacity };
     glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, _atomicCounterBuffer);
-    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(zero), &zero);
+    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(counter), counter);
     glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, 0);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _overflowBuffer);
+    glClearBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        GL_R32UI,
+        GL_RED_INTEGER,
+        GL_UNSIGNED_INT,
+        nullptr
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
 void ABufferRenderer::updateResolution() {
@@ -797,17 +886,19 @@ void ABufferRenderer::updateResolution() {
     glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-    glBindBuffer(GL_TEXTURE_BUFFER, _fragmentBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _overflowBuffer);
     glBufferData(
-        GL_TEXTURE_BUFFER,
-        MaxAverageLayers*totalPixels * sizeof(GLuint) * 4,
+        GL_SHADER_STORAGE_BUFFER,
+        totalPixels * OverflowStride * sizeof(GLuint),
         nullptr,
         GL_DYNAMIC_COPY
     );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
-    glBindTexture(GL_TEXTURE_BUFFER, _fragmentTexture);
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, _fragmentBuffer);
-    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    // Fragment counts that are read back from now on belong to the old resolution
+    _hasRequestedFragments = false;
+    _fragmentCapacity = 0;
+    updateFragmentCapacity(InitialAverageLayers * totalPixels);
 
     glBindImageTexture(1, _fragmentTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32UI);
 
@@ -835,6 +926,111 @@ void ABufferRenderer::updateResolution() {
     _dirtyResolution = false;
 }
 
+void ABufferRenderer::updateFragmentCapacity(GLuint capacity) {
+    const size_t totalPixels = static_cast<size_t>(_resolution.x) * _resolution.y;
+    const size_t overflowSize = totalPixels * OverflowStride * sizeof(GLuint);
+
+    // The overflow buffer counts towards the budget, but room for at least one fragment
+    // per pixel is always kept
+    const size_t budget = _fragmentBufferBudget > overflowSize ?
+        (_fragmentBufferBudget - overflowSize) / FragmentSize :
+        0;
+    GLint maxTextureBufferSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTextureBufferSize);
+    _maxFragmentCapacity = static_cast<GLuint>(std::min(
+        std::max(budget, totalPixels + 1),
+        static_cast<size_t>(maxTextureBufferSize)
+    ));
+    _dirtyFragmentBudget = false;
+
+    const GLuint minCapacity = std::min(
+        static_cast<GLuint>(totalPixels + 1),
+        _maxFragmentCapacity
+    );
+    capacity = std::clamp(capacity, minCapacity, _maxFragmentCapacity);
+    if (capacity == _fragmentCapacity) {
+        return;
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, _fragmentBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * FragmentSize, nullptr, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glBindTexture(GL_TEXTURE_BUFFER, _fragmentTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, _fragmentBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    _fragmentCapacity = capacity;
+    _framesBelowCapacity = 0;
+}
+
+void ABufferRenderer::readBackFragmentCount() {
+    // The slot that is written next is the one that was written the longest time ago
+    GLsync& fence = _counterReadback.fences[_counterReadback.current];
+    if (!fence) {
+        return;
+    }
+    const GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        return;
+    }
+
+    GLuint counter[2];
+    glBindBuffer(GL_COPY_READ_BUFFER, _counterReadback.buffers[_counterReadback.current]);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(counter), counter);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glDeleteSync(fence);
+    fence = nullptr;
+
+    // The first value is the counter, which also counts the unused null pointer, so it
+    // is the capacity that would have been needed to store all fragments
+    const GLuint requested = counter[0];
+    const GLuint capacity = counter[1];
+    if (capacity == _fragmentCapacity) {
+        _requestedFragments = requested;
+        _hasRequestedFragments = true;
+    }
+
+    if (global::performanceManager.isEnabled()) {
+        const GLuint overflow = requested > capacity ? requested - capacity : 0;
+        global::performanceManager.storeIndividualPerformanceMeasurement(
+            "ABufferRenderer::overflowFragments",
+            overflow
+        );
+        global::performanceManager.storeIndividualPerformanceMeasurement(
+            "ABufferRenderer::fragmentBufferKB",
+            static_cast<long long>(capacity * FragmentSize / 1024)
+        );
+    }
+}
+
+void ABufferRenderer::adaptFragmentCapacity() {
+    if (!_hasRequestedFragments) {
+        return;
+    }
+    _hasRequestedFragments = false;
+
+    const double target = _requestedFragments * CapacityHeadroom;
+    if (_requestedFragments > _fragmentCapacity) {
+        // Grow immediately to avoid that fragments are blended approximately for longer
+        // than necessary
+        updateFragmentCapacity(static_cast<GLuint>(
+            std::min(target, static_cast<double>(_maxFragmentCapacity))
+        ));
+    }
+    else if (_requestedFragments < _fragmentCapacity / 4) {
+        // Shrink only after a while so that the buffer is not reallocated every time
+        // the number of fragments fluctuates
+        _framesBelowCapacity++;
+        if (_framesBelowCapacity > ShrinkDelay) {
+            updateFragmentCapacity(static_cast<GLuint>(target));
+        }
+    }
+    else {
+        _framesBelowCapacity = 0;
+    }
+}
+
 void ABufferRenderer::updateResolveDictionary() {
     ghoul::Dictionary dict;
     ghoul::Dictionary raycastersDict;
@@ -957,7 +1153,6 @@ void ABufferRenderer::updateRendererData() {
     ghoul::Dictionary dict;
     dict.setValue("fragmentRendererPath", std::string(RenderFragmentShaderPath));
     dict.setValue("maxLayers", MaxLayers);
-    dict.setValue("maxTotalFragments", MaxLayers * _resolution.x * _resolution.y);
 
     _rendererData = dict;
 
@@ -0,0 +1,425 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/rendering/compressedtexture.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/file.h>
+#include <ghoul/io/texture/texturereader.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr const std::array<unsigned char, 12> Identifier = {
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+    };
+
+    // The identifier, nine uint32 header fields, and the index with four uint32 and two
+    // uint64 values, after which the level index starts
+    constexpr const size_t HeaderSize = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+    constexpr const size_t LevelIndexEntrySize = 3 * 8;
+
+    // Level data has to be aligned to the size of a block, which is at most 16 bytes
+    constexpr const size_t LevelAlignment = 16;
+
+    struct FormatInfo {
+        uint32_t vkFormat;
+        GLenum internalFormat;
+        ghoul::opengl::Texture::Format format;
+        // The number of bytes of a block of 4x4 texels, or 0 for 8-bit RGBA texels
+        uint32_t blockSize;
+    };
+
+    using Format = ghoul::opengl::Texture::Format;
+    const std::array<FormatInfo, 18> Formats = {
+        FormatInfo{ 37, GL_RGBA8, Format::RGBA, 0 },
+        FormatInfo{ 43, GL_SRGB8_ALPHA8, Format::RGBA, 0 },
+        FormatInfo{ 131, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, Format::RGB, 8 },
+        FormatInfo{ 132, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, Format::RGB, 8 },
+        FormatInfo{ 133, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, Format::RGBA, 8 },
+        FormatInfo{ 134, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, Format::RGBA, 8 },
+        FormatInfo{ 135, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, Format::RGBA, 16 },
+        FormatInfo{ 136, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, Format::RGBA, 16 },
+        FormatInfo{ 137, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, Format::RGBA, 16 },
+        FormatInfo{ 138, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, Format::RGBA, 16 },
+        FormatInfo{ 139, GL_COMPRESSED_RED_RGTC1, Format::Red, 8 },
+        FormatInfo{ 140, GL_COMPRESSED_SIGNED_RED_RGTC1, Format::Red, 8 },
+        FormatInfo{ 141, GL_COMPRESSED_RG_RGTC2, Format::RG, 16 },
+        FormatInfo{ 142, GL_COMPRESSED_SIGNED_RG_RGTC2, Format::RG, 16 },
+        FormatInfo{ 143, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, Format::RGB, 16 },
+        FormatInfo{ 144, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, Format::RGB, 16 },
+        FormatInfo{ 145, GL_COMPRESSED_RGBA_BPTC_UNORM, Format::RGBA, 16 },
+        FormatInfo{ 146, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, Format::RGBA, 16 }
+    };
+
+    const FormatInfo* vkFormatInfo(uint32_t vkFormat) {
+        const auto it = std::find_if(
+            Formats.begin(),
+            Formats.end(),
+            [vkFormat](const FormatInfo& f) { return f.vkFormat == vkFormat; }
+        );
+        return it != Formats.end() ? &*it : nullptr;
+    }
+
+    const FormatInfo* glFormatInfo(GLenum internalFormat) {
+        const auto it = std::find_if(
+            Formats.begin(),
+            Formats.end(),
+            [internalFormat](const FormatInfo& f) {
+                return f.internalFormat == internalFormat;
+            }
+        );
+        return it != Formats.end() ? &*it : nullptr;
+    }
+
+    size_t levelSize(const FormatInfo& info, const glm::uvec2& dimensions) {
+        if (info.blockSize == 0) {
+            return static_cast<size_t>(dimensions.x) * dimensions.y * 4;
+        }
+        const size_t nBlocksX = (dimensions.x + 3) / 4;
+        const size_t nBlocksY = (dimensions.y + 3) / 4;
+        return nBlocksX * nBlocksY * info.blockSize;
+    }
+
+    template <typename T>
+    T read(const std::vector<char>& buffer, size_t offset) {
+        T value;
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void write(std::vector<char>& buffer, T value) {
+        const char* p = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+
+    // Creates the data format descriptor of the formats that the writer supports, which
+    // consists of the total size and a single basic descriptor block
+    std::vector<char> dataFormatDescriptor(const FormatInfo& info) {
+        struct Sample {
+            uint16_t bitOffset;
+            uint8_t bitLength;
+            uint8_t channel;
+            uint32_t upper;
+        };
+
+        std::vector<Sample> samples;
+        uint8_t colorModel = 0;
+        uint8_t blockDimension = 0;
+        switch (info.vkFormat) {
+            case 37:
+            case 43:
+                // RGBSDA color model with one byte for each of the channels
+                colorModel = 1;
+                samples = {
+                    { 0, 7, 0, 255 },
+                    { 8, 7, 1, 255 },
+                    { 16, 7, 2, 255 },
+                    { 24, 7, 15, 255 }
+                };
+                break;
+            case 131:
+            case 132:
+                colorModel = 128;
+                blockDimension = 3;
+                samples = { { 0, 63, 0, 0xFFFFFFFF } };
+                break;
+            case 137:
+            case 138:
+                colorModel = 130;
+                blockDimension = 3;
+                samples = { { 0, 63, 15, 0xFFFFFFFF }, { 64, 63, 0, 0xFFFFFFFF } };
+                break;
+            default:
+                throw ghoul::RuntimeError(fmt::format(
+                    "Writing format {} is not supported", info.vkFormat
+                ));
+        }
+        const bool isSrgb = info.vkFormat == 43 || info.vkFormat == 132 ||
+                            info.vkFormat == 138;
+
+        const uint16_t blockSize = static_cast<uint16_t>(24 + 16 * samples.size());
+        std::vector<char> res;
+        write<uint32_t>(res, 4 + blockSize);
+        // Khronos vendor id and basic descriptor type
+        write<uint32_t>(res, 0);
+        write<uint16_t>(res, 2);
+        write<uint16_t>(res, blockSize);
+        write<uint8_t>(res, colorModel);
+        // BT.709 primaries, linear or sRGB transfer function, and straight alpha
+        write<uint8_t>(res, 1);
+        write<uint8_t>(res, isSrgb ? 2 : 1);
+        write<uint8_t>(res, 0);
+        write<uint8_t>(res, blockDimension);
+        write<uint8_t>(res, blockDimension);
+        write<uint8_t>(res, 0);
+        write<uint8_t>(res, 0);
+        const uint32_t bytesPerBlock = info.blockSize == 0 ? 4 : info.blockSize;
+        write<uint8_t>(res, static_cast<uint8_t>(bytesPerBlock));
+        for (int i = 0; i < 7; ++i) {
+            write<uint8_t>(res, 0);
+        }
+        for (const Sample& s : samples) {
+            write<uint16_t>(res, s.bitOffset);
+            write<uint8_t>(res, s.bitLength);
+            write<uint8_t>(res, s.channel);
+            write<uint32_t>(res, 0);
+            write<uint32_t>(res, 0);
+            write<uint32_t>(res, s.upper);
+        }
+        return res;
+    }
+} // namespace
+
+namespace openspace::rendering {
+
+bool isCompressedTextureFile(const std::string& path) {
+    return ghoul::filesystem::File(path).fileExtension() == "ktx2";
+}
+
+CompressedTextureData readCompressedTexture(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(fmt::format("Could not open file '{}'", path));
+    }
+
+    CompressedTextureData res;
+    res.buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(res.buffer.data(), res.buffer.size());
+    const std::vector<char>& buffer = res.buffer;
+
+    if (buffer.size() < HeaderSize ||
+        std::memcmp(buffer.data(), Identifier.data(), Identifier.size()) != 0)
+    {
+        throw ghoul::RuntimeError(fmt::format("File '{}' is not a KTX2 file", path));
+    }
+
+    const uint32_t vkFormat = read<uint32_t>(buffer, 12);
+    const uint32_t width = read<uint32_t>(buffer, 20);
+    const uint32_t height = read<uint32_t>(buffer, 24);
+    const uint32_t depth = read<uint32_t>(buffer, 28);
+    const uint32_t nLayers = read<uint32_t>(buffer, 32);
+    const uint32_t nFaces = read<uint32_t>(buffer, 36);
+    const uint32_t nLevels = std::max(read<uint32_t>(buffer, 40), 1u);
+    const uint32_t supercompression = read<uint32_t>(buffer, 44);
+
+    if (vkFormat == 0 || supercompression != 0) {
+        throw ghoul::RuntimeError(fmt::format(
+            "File '{}' has to be transcoded, which is not supported. Use the "
+            "ConvertTextureTask to create a block-compressed version of the image",
+            path
+        ));
+    }
+    const FormatInfo* info = vkFormatInfo(vkFormat);
+    if (!info) {
+        throw ghoul::RuntimeError(fmt::format(
+            "File '{}' uses the unsupported format {}", path, vkFormat
+        ));
+    }
+    if (height == 0 || depth != 0 || nLayers > 1 || nFaces != 1) {
+        throw ghoul::RuntimeError(fmt::format(
+            "File '{}' does not contain a single 2D image", path
+        ));
+    }
+    if (buffer.size() < HeaderSize + nLevels * LevelIndexEntrySize) {
+        throw ghoul::RuntimeError(fmt::format("File '{}' is truncated", path));
+    }
+
+    res.dimensions = glm::uvec2(width, height);
+    res.format = info->format;
+    res.internalFormat = info->internalFormat;
+    res.isBlockCompressed = info->blockSize > 0;
+    res.levels.reserve(nLevels);
+    for (uint32_t i = 0; i < nLevels; ++i) {
+        const size_t entry = HeaderSize + i * LevelIndexEntrySize;
+        CompressedTextureData::Level level;
+        level.dimensions = glm::max(res.dimensions >> i, glm::uvec2(1));
+        level.offset = static_cast<size_t>(read<uint64_t>(buffer, entry));
+        level.size = static_cast<size_t>(read<uint64_t>(buffer, entry + 8));
+
+        if (level.size < levelSize(*info, level.dimensions) ||
+            level.offset + level.size > buffer.size())
+        {
+            throw ghoul::RuntimeError(fmt::format(
+                "Level {} of file '{}' is truncated", i, path
+            ));
+        }
+        res.levels.push_back(level);
+    }
+    return res;
+}
+
+void writeCompressedTexture(const std::string& path, const CompressedTextureData& data) {
+    const FormatInfo* info = glFormatInfo(data.internalFormat);
+    if (!info || data.levels.empty()) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Could not write '{}' as the format is not supported", path
+        ));
+    }
+
+    const std::vector<char> dfd = dataFormatDescriptor(*info);
+    const size_t dfdOffset = HeaderSize + data.levels.size() * LevelIndexEntrySize;
+
+    // The smallest levels are stored first, so that a partially read file can be shown
+    // at a lower resolution
+    std::vector<uint64_t> offsets(data.levels.size());
+    size_t offset = dfdOffset + dfd.size();
+    for (size_t i = data.levels.size(); i-- > 0;) {
+        offset = (offset + LevelAlignment - 1) / LevelAlignment * LevelAlignment;
+        offsets[i] = offset;
+        offset += data.levels[i].size;
+    }
+
+    std::vector<char> header;
+    header.reserve(dfdOffset + dfd.size());
+    header.insert(header.end(), Identifier.begin(), Identifier.end());
+    write<uint32_t>(header, info->vkFormat);
+    write<uint32_t>(header, 1);
+    write<uint32_t>(header, data.dimensions.x);
+    write<uint32_t>(header, data.dimensions.y);
+    write<uint32_t>(header, 0);
+    write<uint32_t>(header, 0);
+    write<uint32_t>(header, 1);
+    write<uint32_t>(header, static_cast<uint32_t>(data.levels.size()));
+    write<uint32_t>(header, 0);
+
+    write<uint32_t>(header, static_cast<uint32_t>(dfdOffset));
+    write<uint32_t>(header, static_cast<uint32_t>(dfd.size()));
+    write<uint32_t>(header, 0);
+    write<uint32_t>(header, 0);
+    write<uint64_t>(header, 0);
+    write<uint64_t>(header, 0);
+
+    for (size_t i = 0; i < data.levels.size(); ++i) {
+        write<uint64_t>(header, offsets[i]);
+        write<uint64_t>(header, data.levels[i].size);
+        write<uint64_t>(header, data.levels[i].size);
+    }
+    header.insert(header.end(), dfd.begin(), dfd.end());
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(fmt::format("Could not create file '{}'", path));
+    }
+    file.write(header.data(), header.size());
+    size_t position = header.size();
+    const std::array<char, LevelAlignment> padding = {};
+    for (size_t i = data.levels.size(); i-- > 0;) {
+        file.write(padding.data(), offsets[i] - position);
+        file.write(data.buffer.data() + data.levels[i].offset, data.levels[i].size);
+        position = offsets[i] + data.levels[i].size;
+    }
+}
+
+std::unique_ptr<ghoul::opengl::Texture> createCompressedTexture(
+                                                       const CompressedTextureData& data,
+                                                ghoul::opengl::Texture::FilterMode filter)
+{
+    using Texture = ghoul::opengl::Texture;
+
+    std::unique_ptr<Texture> texture = std::make_unique<Texture>(
+        glm::uvec3(data.dimensions, 1),
+        data.format,
+        data.internalFormat,
+        GL_UNSIGNED_BYTE,
+        Texture::FilterMode::Linear,
+        Texture::WrappingMode::Repeat,
+        Texture::AllocateData::No
+    );
+    texture->bind();
+
+    const bool useMipMaps = data.levels.size() > 1 &&
+                            (filter == Texture::FilterMode::LinearMipMap ||
+                             filter == Texture::FilterMode::AnisotropicMipMap);
+    const size_t nLevels = useMipMaps ? data.levels.size() : 1;
+    for (size_t i = 0; i < nLevels; ++i) {
+        const CompressedTextureData::Level& level = data.levels[i];
+        const char* pixels = data.buffer.data() + level.offset;
+        if (data.isBlockCompressed) {
+            glCompressedTexImage2D(
+                GL_TEXTURE_2D,
+                static_cast<GLint>(i),
+                data.internalFormat,
+                level.dimensions.x,
+                level.dimensions.y,
+                0,
+                static_cast<GLsizei>(level.size),
+                pixels
+            );
+        }
+        else {
+            glTexImage2D(
+                GL_TEXTURE_2D,
+                static_cast<GLint>(i),
+                data.internalFormat,
+                level.dimensions.x,
+                level.dimensions.y,
+                0,
+                GL_RGBA,
+                GL_UNSIGNED_BYTE,
+                pixels
+            );
+        }
+    }
+
+    // Setting a mipmapped filter through the texture would regenerate the levels, which
+    // is not possible for block-compressed formats, so the parameters are set directly
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(nLevels - 1));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(
+        GL_TEXTURE_2D,
+        GL_TEXTURE_MIN_FILTER,
+        useMipMaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR
+    );
+    if (useMipMaps && filter == Texture::FilterMode::AnisotropicMipMap) {
+        GLfloat maxAnisotropy = 1.f;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy);
+    }
+
+    return texture;
+}
+
+std::unique_ptr<ghoul::opengl::Texture> loadTexture(const std::string& path,
+                                                ghoul::opengl::Texture::FilterMode filter)
+{
+    if (isCompressedTextureFile(path)) {
+        return createCompressedTexture(readCompressedTexture(path), filter);
+    }
+
+    std::unique_ptr<ghoul::opengl::Texture> texture =
+        ghoul::io::TextureReader::ref().loadTexture(path);
+    if (texture) {
+        texture->uploadTexture();
+        texture->setFilter(filter);
+    }
+    return texture;
+}
+
+} // namespace openspace::rendering
@@ -0,0 +1,465 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <openspace/rendering/depthpyramid.h>
+
+#include <openspace/util/camera.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/textureunit.h>
+#include <glm/gtc/matrix_access.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+    constexpr const char* VertexShaderPath =
+        "${SHADERS}/framebuffer/resolveframebuffer.vert";
+    constexpr const char* ResolveFragmentPath =
+        "${SHADERS}/framebuffer/depthpyramidresolve.frag";
+    constexpr const char* ReduceFragmentPath =
+        "${SHADERS}/framebuffer/depthpyramidreduce.frag";
+
+    constexpr const std::array<const char*, 3> ResolveUniformNames = {
+        "mainDepthTexture", "nSamples", "sourceSize"
+    };
+
+    constexpr const std::array<const char*, 2> ReduceUniformNames = {
+        "sourceTexture", "sourceSize"
+    };
+
+    // The GPU levels are reduced until both dimensions are at most this large, which
+    // keeps the readback small enough to not be noticeable
+    constexpr const int MaxReadbackSize = 128;
+
+    // The largest number of texels in each dimension that a single test looks at. The
+    // test chooses the finest level on which the screen bounds fit into this many texels
+    constexpr const int MaxTestTexels = 4;
+
+    // Objects have to be this much farther away than the occluding geometry, relative to
+    // its depth, which hides differences between the geometry of consecutive frames, for
+    // example if a globe has changed the level of detail of a chunk in the meantime
+    constexpr const double DepthTolerance = 0.01;
+
+    // Objects whose apparent position might have moved by more than this angle in
+    // radians since the pyramid was built are never considered to be hidden
+    constexpr const double MaxParallax = 0.05;
+} // namespace
+
+namespace openspace {
+
+DepthPyramid::DepthPyramid() = default;
+
+DepthPyramid::~DepthPyramid() = default;
+
+void DepthPyramid::initializeGL() {
+    const GLfloat vertexData[] = {
+        // x     y
+        -1.f, -1.f,
+         1.f,  1.f,
+        -1.f,  1.f,
+        -1.f, -1.f,
+         1.f, -1.f,
+         1.f,  1.f,
+    };
+
+    glGenVertexArrays(1, &_quad);
+    glBindVertexArray(_quad);
+
+    glGenBuffers(1, &_vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 2, nullptr);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+
+    glGenFramebuffers(1, &_framebuffer);
+    glGenBuffers(1, &_pixelBuffer);
+
+    _resolveProgram = ghoul::opengl::ProgramObject::Build(
+        "Depth Pyramid Resolve",
+        absPath(VertexShaderPath),
+        absPath(ResolveFragmentPath)
+    );
+    ghoul::opengl::updateUniformLocations(
+        *_resolveProgram,
+        _resolveUniformCache,
+        ResolveUniformNames
+    );
+
+    _reduceProgram = ghoul::opengl::ProgramObject::Build(
+        "Depth Pyramid Reduce",
+        absPath(VertexShaderPath),
+        absPath(ReduceFragmentPath)
+    );
+    ghoul::opengl::updateUniformLocations(
+        *_reduceProgram,
+        _reduceUniformCache,
+        ReduceUniformNames
+    );
+}
+
+void DepthPyramid::deinitializeGL() {
+    if (_readbackFence) {
+        glDeleteSync(_readbackFence);
+        _readbackFence = nullptr;
+    }
+    glDeleteTextures(static_cast<GLsizei>(_textures.size()), _textures.data());
+    _textures.clear();
+    _textureSizes.clear();
+    _resolution = glm::ivec2(0);
+
+    glDeleteBuffers(1, &_pixelBuffer);
+    _pixelBufferSize = 0;
+    glDeleteFramebuffers(1, &_framebuffer);
+    glDeleteBuffers(1, &_vertexBuffer);
+    glDeleteVertexArrays(1, &_quad);
+
+    _resolveProgram = nullptr;
+    _reduceProgram = nullptr;
+    invalidate();
+}
+
+void DepthPyramid::update(GLuint depthTexture, int nSamples,
+                          const glm::ivec2& resolution, const Camera& camera)
+{
+    if (_readbackFence) {
+        const GLenum status = glClientWaitSync(_readbackFence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return;
+        }
+        finishReadback();
+    }
+
+    if (_resolveProgram->isDirty()) {
+        _resolveProgram->rebuildFromFile();
+        ghoul::opengl::updateUniformLocations(
+            *_resolveProgram,
+            _resolveUniformCache,
+            ResolveUniformNames
+        );
+    }
+    if (_reduceProgram->isDirty()) {
+        _reduceProgram->rebuildFromFile();
+        ghoul::opengl::updateUniformLocations(
+            *_reduceProgram,
+            _reduceUniformCache,
+            ReduceUniformNames
+        );
+    }
+
+    if (resolution != _resolution) {
+        glDeleteTextures(static_cast<GLsizei>(_textures.size()), _textures.data());
+        _textures.clear();
+        _textureSizes.clear();
+
+        // Rounding up keeps the border texels of odd sizes in the next level
+        glm::ivec2 size = (resolution + 1) / 2;
+        while (true) {
+            GLuint texture;
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexImage2D(
+                GL_TEXTURE_2D,
+                0,
+                GL_R32F,
+                size.x,
+                size.y,
+                0,
+                GL_RED,
+                GL_FLOAT,
+                nullptr
+            );
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            _textures.push_back(texture);
+            _textureSizes.push_back(size);
+
+            if (size.x <= MaxReadbackSize && size.y <= MaxReadbackSize) {
+                break;
+            }
+            size = (size + 1) / 2;
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        _resolution = resolution;
+    }
+
+    GLint framebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const GLboolean hasDepthTest = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean hasBlending = glIsEnabledi(GL_BLEND, 0);
+
+    glDisable(GL_DEPTH_TEST);
+    glDisablei(GL_BLEND, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glBindVertexArray(_quad);
+
+    for (size_t i = 0; i < _textures.size(); ++i) {
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D,
+            _textures[i],
+            0
+        );
+        glViewport(0, 0, _textureSizes[i].x, _textureSizes[i].y);
+
+        ghoul::opengl::TextureUnit unit;
+        unit.activate();
+        if (i == 0) {
+            // The first level takes the farthest depth of all samples of the pixels
+            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, depthTexture);
+            _resolveProgram->activate();
+            _resolveProgram->setUniform(_resolveUniformCache.mainDepthTexture, unit);
+            _resolveProgram->setUniform(_resolveUniformCache.nSamples, nSamples);
+            _resolveProgram->setUniform(_resolveUniformCache.sourceSize, resolution);
+        }
+        else {
+            glBindTexture(GL_TEXTURE_2D, _textures[i - 1]);
+            _reduceProgram->activate();
+            _reduceProgram->setUniform(_reduceUniformCache.sourceTexture, unit);
+            _reduceProgram->setUniform(
+                _reduceUniformCache.sourceSize,
+                _textureSizes[i - 1]
+            );
+        }
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+    _reduceProgram->deactivate();
+    glBindVertexArray(0);
+
+    // The coarsest GPU level is read back asynchronously and only used once the fence
+    // has been passed in one of the next frames
+    const glm::ivec2 readbackSize = _textureSizes.back();
+    const size_t size = static_cast<size_t>(readbackSize.x) * readbackSize.y *
+                        sizeof(float);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pixelBuffer);
+    if (_pixelBufferSize != size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        _pixelBufferSize = size;
+    }
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, readbackSize.x, readbackSize.y, GL_RED, GL_FLOAT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    _readbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    const glm::dmat4 projection = glm::dmat4(camera.sgctInternal.projectionMatrix());
+    _pendingView.viewProjection = projection * camera.combinedViewMatrix();
+    _pendingView.cameraPosition = camera.positionVec3();
+    _pendingView.projectionScale = glm::dvec2(projection[0][0], projection[1][1]);
+    _pendingView.resolution = resolution;
+    _pendingView.pixelsPerTexel = 1 << static_cast<int>(_textures.size());
+    _pendingSize = readbackSize;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (hasDepthTest == GL_TRUE) {
+        glEnable(GL_DEPTH_TEST);
+    }
+    if (hasBlending == GL_TRUE) {
+        glEnablei(GL_BLEND, 0);
+    }
+}
+
+void DepthPyramid::finishReadback() {
+    glDeleteSync(_readbackFence);
+    _readbackFence = nullptr;
+
+    Level level;
+    level.size = _pendingSize;
+    level.depths.resize(static_cast<size_t>(level.size.x) * level.size.y);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pixelBuffer);
+    void* data = glMapBufferRange(
+        GL_PIXEL_PACK_BUFFER,
+        0,
+        level.depths.size() * sizeof(float),
+        GL_MAP_READ_BIT
+    );
+    if (data) {
+        std::memcpy(level.depths.data(), data, level.depths.size() * sizeof(float));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!data) {
+        invalidate();
+        return;
+    }
+
+    _levels.clear();
+    _levels.push_back(std::move(level));
+    // The coarser levels are cheap to build on the CPU and let large objects be tested
+    // with just a few texels
+    while (_levels.back().size.x > 1 || _levels.back().size.y > 1) {
+        const Level& source = _levels.back();
+        Level next;
+        next.size = (source.size + 1) / 2;
+        next.depths.resize(static_cast<size_t>(next.size.x) * next.size.y);
+        for (int y = 0; y < next.size.y; ++y) {
+            for (int x = 0; x < next.size.x; ++x) {
+                float depth = 0.f;
+                for (int dy = 0; dy < 2; ++dy) {
+                    for (int dx = 0; dx < 2; ++dx) {
+                        const int sx = std::min(2 * x + dx, source.size.x - 1);
+                        const int sy = std::min(2 * y + dy, source.size.y - 1);
+                        depth = std::max(depth, source.depths[sy * source.size.x + sx]);
+                    }
+                }
+                next.depths[y * next.size.x + x] = depth;
+            }
+        }
+        _levels.push_back(std::move(next));
+    }
+
+    _view = _pendingView;
+    _isValid = true;
+}
+
+void DepthPyramid::invalidate() {
+    _levels.clear();
+    _isValid = false;
+}
+
+bool DepthPyramid::isValid() const {
+    return _isValid;
+}
+
+bool DepthPyramid::isOccluded(const std::array<glm::dvec4, 8>& corners,
+                              const glm::dmat4& modelTransform,
+                              const Camera& camera) const
+{
+    if (!_isValid) {
+        return false;
+    }
+
+    std::array<glm::dvec3, 8> points;
+    double nearestDepth = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < corners.size(); ++i) {
+        points[i] = glm::dvec3(modelTransform * corners[i]);
+        const glm::dvec4 clip = _view.viewProjection * glm::dvec4(points[i], 1.0);
+        nearestDepth = std::min(nearestDepth, clip.w);
+    }
+    return isOccluded(points.data(), points.size(), nearestDepth, camera);
+}
+
+bool DepthPyramid::isOccluded(const glm::dvec3& center, double radius,
+                              const Camera& camera) const
+{
+    if (!_isValid) {
+        return false;
+    }
+
+    // The screen bounds of the enclosing cube contain those of the sphere. The depth is
+    // linear in the world coordinates, so the nearest depth of the sphere is exact
+    std::array<glm::dvec3, 8> points;
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = center + radius * glm::dvec3(
+            (i & 1) ? 1.0 : -1.0,
+            (i & 2) ? 1.0 : -1.0,
+            (i & 4) ? 1.0 : -1.0
+        );
+    }
+    const glm::dvec4 depthRow = glm::row(_view.viewProjection, 3);
+    const double nearestDepth = glm::dot(glm::dvec4(center, 1.0), depthRow) -
+                                radius * glm::length(glm::dvec3(depthRow));
+    return isOccluded(points.data(), points.size(), nearestDepth, camera);
+}
+
+bool DepthPyramid::isOccluded(const glm::dvec3* points, size_t nPoints,
+                              double nearestDepth, const Camera& camera) const
+{
+    // Objects that reach behind the previous camera cannot be projected
+    if (nearestDepth <= 0.0) {
+        return false;
+    }
+
+    // The camera might have moved closer to the object or around the occluding geometry
+    // since the pyramid was built, so the screen bounds are widened by the parallax
+    const double moved = glm::distance(camera.positionVec3(), _view.cameraPosition);
+    const double parallax = moved / nearestDepth;
+    if (parallax > MaxParallax) {
+        return false;
+    }
+
+    glm::dvec2 ndcMin = glm::dvec2(std::numeric_limits<double>::max());
+    glm::dvec2 ndcMax = glm::dvec2(-std::numeric_limits<double>::max());
+    for (size_t i = 0; i < nPoints; ++i) {
+        const glm::dvec4 clip = _view.viewProjection * glm::dvec4(points[i], 1.0);
+        if (clip.w <= 0.0) {
+            return false;
+        }
+        const glm::dvec2 ndc = glm::dvec2(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+    ndcMin -= parallax * _view.projectionScale;
+    ndcMax += parallax * _view.projectionScale;
+
+    // Nothing is known about the parts that were outside of the previous view
+    if (ndcMin.x < -1.0 || ndcMin.y < -1.0 || ndcMax.x > 1.0 || ndcMax.y > 1.0) {
+        return false;
+    }
+
+    const glm::dvec2 res = glm::dvec2(_view.resolution);
+    const glm::dvec2 pixelMin = (ndcMin * 0.5 + 0.5) * res;
+    const glm::dvec2 pixelMax = (ndcMax * 0.5 + 0.5) * res;
+
+    // Start at the finest level and move up until the bounds cover few enough texels
+    double pixelsPerTexel = static_cast<double>(_view.pixelsPerTexel);
+    for (const Level& level : _levels) {
+        const glm::ivec2 texelMin = glm::clamp(
+            glm::ivec2(glm::floor(pixelMin / pixelsPerTexel)),
+            glm::ivec2(0),
+            level.size - 1
+        );
+        const glm::ivec2 texelMax = glm::clamp(
+            glm::ivec2(glm::floor(pixelMax / pixelsPerTexel)),
+            glm::ivec2(0),
+            level.size - 1
+        );
+        pixelsPerTexel *= 2.0;
+
+        const glm::ivec2 extent = texelMax - texelMin + 1;
+        if (extent.x > MaxTestTexels || extent.y > MaxTestTexels) {
+            continue;
+        }
+
+        float farthestDepth = 0.f;
+        for (int y = texelMin.y; y <= texelMax.y; ++y) {
+            for (int x = texelMin.x; x <= texelMax.x; ++x) {
+                const float depth = level.depths[y * level.size.x + x];
+                farthestDepth = std::max(farthestDepth, depth);
+            }
+        }
+        return nearestDepth > farthestDepth * (1.0 + DepthTolerance);
+    }
+    return false;
+}
+
+} // namespace openspace
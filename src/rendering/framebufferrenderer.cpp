@@ -28,6 +28,7 @@
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/performance/performancemanager.h>
 #include <openspace/performance/performancemeasurement.h>
+#include <openspace/performance/tracezone.h>
 #include <openspace/rendering/deferredcaster.h>
 #include <openspace/rendering/deferredcastermanager.h>
 #include <openspace/rendering/raycastermanager.h>
@@ -36,7 +37,9 @@
 #include <openspace/rendering/volumeraycaster.h>
 #include <openspace/rendering/volumeraycaster.h>
 #include <openspace/scene/scene.h>
+#include <openspace/scene/scenegraphnode.h>
 #include <openspace/util/camera.h>
+#include <openspace/util/framememory.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -44,6 +47,11 @@
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -55,14 +63,67 @@ namespace {
         "mainColorTexture", "blackoutFactor", "nAaSamples"
     };
 
+    constexpr const std::array<const char*, 4> DownscaledVolumeUniformNames = {
+        "downscaledVolume", "mainDepthTexture", "downscaleFactor", "downscaledSize"
+    };
+
+    constexpr const std::array<const char*, 2> UpscaleUniformNames = {
+        "sourceTexture", "sourceSize"
+    };
+
+    constexpr const std::array<const char*, 4> ResolveGBufferUniformNames = {
+        "mainColorTexture", "mainPositionTexture", "mainNormalTexture", "nAaSamples"
+    };
+
+    constexpr const std::array<const char*, 2> BackgroundCacheUniformNames = {
+        "backgroundCubeMap", "inverseViewProjection"
+    };
+
+    // Every volume that is raycast in the combined pass needs one layer in the entry and
+    // exit textures, so the number of volumes per pass is limited to bound the memory
+    constexpr const size_t MaxCombinedRaycasters = 8;
+
+    struct CubeMapFace {
+        glm::dvec3 direction;
+        glm::dvec3 up;
+    };
+
+    // The view direction and up vector for each of the cube map faces in the order of
+    // GL_TEXTURE_CUBE_MAP_POSITIVE_X + i
+    const std::array<CubeMapFace, 6> CubeMapFaces = {{
+        { glm::dvec3( 1.0,  0.0,  0.0), glm::dvec3(0.0, -1.0,  0.0) },
+        { glm::dvec3(-1.0,  0.0,  0.0), glm::dvec3(0.0, -1.0,  0.0) },
+        { glm::dvec3( 0.0,  1.0,  0.0), glm::dvec3(0.0,  0.0,  1.0) },
+        { glm::dvec3( 0.0, -1.0,  0.0), glm::dvec3(0.0,  0.0, -1.0) },
+        { glm::dvec3( 0.0,  0.0,  1.0), glm::dvec3(0.0, -1.0,  0.0) },
+        { glm::dvec3( 0.0,  0.0, -1.0), glm::dvec3(0.0, -1.0,  0.0) }
+    }};
+
     constexpr const char* ExitFragmentShaderPath =
         "${SHADERS}/framebuffer/exitframebuffer.frag";
     constexpr const char* RaycastFragmentShaderPath =
         "${SHADERS}/framebuffer/raycastframebuffer.frag";
+    constexpr const char* VolumeBoundsFragmentShaderPath =
+        "${SHADERS}/framebuffer/volumeboundsframebuffer.frag";
+    constexpr const char* CombinedRaycastFragmentShaderPath =
+        "${SHADERS}/framebuffer/combinedraycastframebuffer.frag";
     constexpr const char* GetEntryInsidePath = "${SHADERS}/framebuffer/inside.glsl";
     constexpr const char* GetEntryOutsidePath = "${SHADERS}/framebuffer/outside.glsl";
     constexpr const char* RenderFragmentShaderPath =
         "${SHADERS}/framebuffer/renderframebuffer.frag";
+    constexpr const char* MergeDownscaledVolumeVertexPath =
+        "${SHADERS}/framebuffer/mergeDownscaledVolume.vert";
+    constexpr const char* MergeDownscaledVolumeFragmentPath =
+        "${SHADERS}/framebuffer/mergeDownscaledVolume.frag";
+    constexpr const char* UpscaleVertexPath = "${SHADERS}/framebuffer/upscale.vert";
+    constexpr const char* UpscaleFragmentPath = "${SHADERS}/framebuffer/upscale.frag";
+    constexpr const char* FxaaFragmentPath = "${SHADERS}/framebuffer/fxaa.frag";
+    constexpr const char* ResolveGBufferFragmentPath =
+        "${SHADERS}/framebuffer/resolvegbuffer.frag";
+    constexpr const char* BackgroundCacheVertexPath =
+        "${SHADERS}/framebuffer/backgroundCache.vert";
+    constexpr const char* BackgroundCacheFragmentPath =
+        "${SHADERS}/framebuffer/backgroundCache.frag";
 
     void saveTextureToMemory(GLenum attachment, int width, int height,
                              std::vector<double>& memory)
@@ -124,6 +185,98 @@ void FramebufferRenderer::initialize() {
     GLint defaultFbo;
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &defaultFbo);
 
+    // Background cache framebuffer, whose attachments are allocated on first use
+    glGenTextures(1, &_backgroundCache.cubeMap);
+    glGenRenderbuffers(1, &_backgroundCache.depthBuffer);
+    glGenFramebuffers(1, &_backgroundCache.framebuffer);
+
+    createWindowFramebuffers();
+    updateRendererData();
+    updateRaycastData();
+
+    // JCC: Moved to here to avoid NVidia: "Program/shader state performance warning"
+    updateHDRData();
+    updateDeferredcastData();
+    _dirtyMsaaSamplingPattern = true;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
+
+    _resolveProgram = ghoul::opengl::ProgramObject::Build(
+        "Framebuffer Resolve",
+        absPath("${SHADERS}/framebuffer/resolveframebuffer.vert"),
+        absPath("${SHADERS}/framebuffer/resolveframebuffer.frag")
+    );
+
+    ghoul::opengl::updateUniformLocations(*_resolveProgram, _uniformCache, UniformNames);
+
+    _downscaleVolumeRendering.mergeProgram = ghoul::opengl::ProgramObject::Build(
+        "Merge Downscaled Volume",
+        absPath(MergeDownscaledVolumeVertexPath),
+        absPath(MergeDownscaledVolumeFragmentPath)
+    );
+
+    ghoul::opengl::updateUniformLocations(
+        *_downscaleVolumeRendering.mergeProgram,
+        _downscaleVolumeRendering.uniformCache,
+        DownscaledVolumeUniformNames
+    );
+
+    _dynamicResolution.program = ghoul::opengl::ProgramObject::Build(
+        "Upscale",
+        absPath(UpscaleVertexPath),
+        absPath(UpscaleFragmentPath)
+    );
+
+    ghoul::opengl::updateUniformLocations(
+        *_dynamicResolution.program,
+        _dynamicResolution.uniformCache,
+        UpscaleUniformNames
+    );
+
+    _backgroundCache.program = ghoul::opengl::ProgramObject::Build(
+        "Background Cache",
+        absPath(BackgroundCacheVertexPath),
+        absPath(BackgroundCacheFragmentPath)
+    );
+
+    ghoul::opengl::updateUniformLocations(
+        *_backgroundCache.program,
+        _backgroundCache.uniformCache,
+        BackgroundCacheUniformNames
+    );
+
+    _resolvedGBuffer.program = ghoul::opengl::ProgramObject::Build(
+        "Resolve G-Buffer",
+        absPath("${SHADERS}/framebuffer/resolveframebuffer.vert"),
+        absPath(ResolveGBufferFragmentPath)
+    );
+
+    ghoul::opengl::updateUniformLocations(
+        *_resolvedGBuffer.program,
+        _resolvedGBuffer.uniformCache,
+        ResolveGBufferUniformNames
+    );
+
+    _postProcessAntialiasing.program = ghoul::opengl::ProgramObject::Build(
+        "Post-process Antialiasing",
+        absPath(UpscaleVertexPath),
+        absPath(FxaaFragmentPath)
+    );
+
+    ghoul::opengl::updateUniformLocations(
+        *_postProcessAntialiasing.program,
+        _postProcessAntialiasing.uniformCache,
+        UpscaleUniformNames
+    );
+
+    global::raycasterManager.addListener(*this);
+    global::deferredcasterManager.addListener(*this);
+}
+
+void FramebufferRenderer::createWindowFramebuffers() {
+    GLint defaultFbo;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &defaultFbo);
+
     // Main framebuffer
     glGenTextures(1, &_mainColorTexture);
     glGenTextures(1, &_mainDepthTexture);
@@ -134,15 +287,34 @@ void FramebufferRenderer::initialize() {
     glGenTextures(1, &_exitDepthTexture);
     glGenFramebuffers(1, &_exitFramebuffer);
 
+    // Entry and exit points for the combined raycasting, allocated on first use
+    glGenTextures(1, &_combinedRaycasting.entryTexture);
+    glGenTextures(1, &_combinedRaycasting.exitTexture);
+    glGenRenderbuffers(1, &_combinedRaycasting.depthBuffer);
+    glGenFramebuffers(1, &_combinedRaycasting.framebuffer);
+
+    // Resolved G-buffer, which is allocated on first use
+    glGenTextures(1, &_resolvedGBuffer.colorTexture);
+    glGenTextures(1, &_resolvedGBuffer.positionTexture);
+    glGenTextures(1, &_resolvedGBuffer.normalTexture);
+    glGenRenderbuffers(1, &_resolvedGBuffer.depthBuffer);
+    glGenFramebuffers(1, &_resolvedGBuffer.framebuffer);
+
     // Deferred framebuffer
     glGenTextures(1, &_deferredColorTexture);
     glGenTextures(1, &_mainPositionTexture);
     glGenTextures(1, &_mainNormalTexture);
     glGenFramebuffers(1, &_deferredFramebuffer);
 
+    // Downscaled volume rendering framebuffer
+    glGenTextures(1, &_downscaleVolumeRendering.colorTexture);
+    glGenFramebuffers(1, &_downscaleVolumeRendering.framebuffer);
+
+    // Copy of the last frame, which is allocated on first use
+    glGenTextures(1, &_lastFrame.colorTexture);
+    glGenFramebuffers(1, &_lastFrame.framebuffer);
+
     updateResolution();
-    updateRendererData();
-    updateRaycastData();
 
     glBindFramebuffer(GL_FRAMEBUFFER, _mainFramebuffer);
     glFramebufferTexture2D(
@@ -215,31 +387,34 @@ void FramebufferRenderer::initialize() {
         LERROR("Deferred framebuffer is not complete");
     }
 
-    // JCC: Moved to here to avoid NVidia: "Program/shader state performance warning"
-    updateHDRData();
-    updateDeferredcastData();
-    _dirtyMsaaSamplingPattern = true;
-
-    glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
-
-    _resolveProgram = ghoul::opengl::ProgramObject::Build(
-        "Framebuffer Resolve",
-        absPath("${SHADERS}/framebuffer/resolveframebuffer.vert"),
-        absPath("${SHADERS}/framebuffer/resolveframebuffer.frag")
+    glBindFramebuffer(GL_FRAMEBUFFER, _downscaleVolumeRendering.framebuffer);
+    glFramebufferTexture2D(
+        GL_FRAMEBUFFER,
+        GL_COLOR_ATTACHMENT0,
+        GL_TEXTURE_2D,
+        _downscaleVolumeRendering.colorTexture,
+        0
     );
 
-    ghoul::opengl::updateUniformLocations(*_resolveProgram, _uniformCache, UniformNames);
+    status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LERROR("Downscaled volume framebuffer is not complete");
+    }
 
-    global::raycasterManager.addListener(*this);
-    global::deferredcasterManager.addListener(*this);
-}
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
 
-void FramebufferRenderer::deinitialize() {
-    LINFO("Deinitializing FramebufferRenderer");
+    _occlusionCulling.pyramid = std::make_unique<DepthPyramid>();
+    _occlusionCulling.pyramid->initializeGL();
+}
 
+void FramebufferRenderer::deleteWindowFramebuffers() {
     glDeleteFramebuffers(1, &_mainFramebuffer);
     glDeleteFramebuffers(1, &_exitFramebuffer);
     glDeleteFramebuffers(1, &_deferredFramebuffer);
+    glDeleteFramebuffers(1, &_downscaleVolumeRendering.framebuffer);
+    glDeleteFramebuffers(1, &_lastFrame.framebuffer);
+    glDeleteFramebuffers(1, &_combinedRaycasting.framebuffer);
+    glDeleteFramebuffers(1, &_resolvedGBuffer.framebuffer);
 
     glDeleteTextures(1, &_mainColorTexture);
     glDeleteTextures(1, &_mainDepthTexture);
@@ -251,6 +426,74 @@ void FramebufferRenderer::deinitialize() {
 
     glDeleteTextures(1, &_exitColorTexture);
     glDeleteTextures(1, &_exitDepthTexture);
+    glDeleteTextures(1, &_downscaleVolumeRendering.colorTexture);
+    glDeleteTextures(1, &_lastFrame.colorTexture);
+    glDeleteTextures(1, &_combinedRaycasting.entryTexture);
+    glDeleteTextures(1, &_combinedRaycasting.exitTexture);
+    glDeleteRenderbuffers(1, &_combinedRaycasting.depthBuffer);
+    glDeleteTextures(1, &_resolvedGBuffer.colorTexture);
+    glDeleteTextures(1, &_resolvedGBuffer.positionTexture);
+    glDeleteTextures(1, &_resolvedGBuffer.normalTexture);
+    glDeleteRenderbuffers(1, &_resolvedGBuffer.depthBuffer);
+
+    if (_occlusionCulling.pyramid) {
+        _occlusionCulling.pyramid->deinitializeGL();
+        _occlusionCulling.pyramid = nullptr;
+    }
+}
+
+void FramebufferRenderer::swapWindowFramebuffers(WindowFramebuffers& fbs) {
+    std::swap(_resolution, fbs.resolution);
+
+    std::swap(_mainFramebuffer, fbs.mainFramebuffer);
+    std::swap(_mainColorTexture, fbs.mainColorTexture);
+    std::swap(_mainPositionTexture, fbs.mainPositionTexture);
+    std::swap(_mainNormalTexture, fbs.mainNormalTexture);
+    std::swap(_mainDepthTexture, fbs.mainDepthTexture);
+    std::swap(_exitFramebuffer, fbs.exitFramebuffer);
+    std::swap(_exitColorTexture, fbs.exitColorTexture);
+    std::swap(_exitDepthTexture, fbs.exitDepthTexture);
+    std::swap(_deferredFramebuffer, fbs.deferredFramebuffer);
+    std::swap(_deferredColorTexture, fbs.deferredColorTexture);
+    std::swap(_downscaleVolumeRendering.framebuffer, fbs.downscaleFramebuffer);
+    std::swap(_downscaleVolumeRendering.colorTexture, fbs.downscaleColorTexture);
+
+    std::swap(_lastFrame.framebuffer, fbs.lastFrameFramebuffer);
+    std::swap(_lastFrame.colorTexture, fbs.lastFrameColorTexture);
+    std::swap(_lastFrame.isValid, fbs.isLastFrameValid);
+    std::swap(_lastFrame.viewport, fbs.lastFrameViewport);
+    std::swap(_lastFrame.textureSize, fbs.lastFrameTextureSize);
+
+    std::swap(_combinedRaycasting.framebuffer, fbs.combinedRaycastingFramebuffer);
+    std::swap(_combinedRaycasting.entryTexture, fbs.combinedRaycastingEntryTexture);
+    std::swap(_combinedRaycasting.exitTexture, fbs.combinedRaycastingExitTexture);
+    std::swap(_combinedRaycasting.depthBuffer, fbs.combinedRaycastingDepthBuffer);
+    std::swap(_combinedRaycasting.nLayers, fbs.combinedRaycastingLayers);
+    std::swap(_combinedRaycasting.textureSize, fbs.combinedRaycastingTextureSize);
+
+    std::swap(_resolvedGBuffer.framebuffer, fbs.resolvedFramebuffer);
+    std::swap(_resolvedGBuffer.colorTexture, fbs.resolvedColorTexture);
+    std::swap(_resolvedGBuffer.positionTexture, fbs.resolvedPositionTexture);
+    std::swap(_resolvedGBuffer.normalTexture, fbs.resolvedNormalTexture);
+    std::swap(_resolvedGBuffer.depthBuffer, fbs.resolvedDepthBuffer);
+    std::swap(_resolvedGBuffer.textureSize, fbs.resolvedTextureSize);
+
+    std::swap(_occlusionCulling.pyramid, fbs.depthPyramid);
+}
+
+void FramebufferRenderer::deinitialize() {
+    LINFO("Deinitializing FramebufferRenderer");
+
+    deleteWindowFramebuffers();
+    for (std::pair<const int, WindowFramebuffers>& window : _windowFramebuffers) {
+        swapWindowFramebuffers(window.second);
+        deleteWindowFramebuffers();
+    }
+    _windowFramebuffers.clear();
+
+    glDeleteFramebuffers(1, &_backgroundCache.framebuffer);
+    glDeleteTextures(1, &_backgroundCache.cubeMap);
+    glDeleteRenderbuffers(1, &_backgroundCache.depthBuffer);
 
     glDeleteBuffers(1, &_vertexPositionBuffer);
     glDeleteVertexArrays(1, &_screenQuad);
@@ -305,6 +548,56 @@ void FramebufferRenderer::update() {
         );
     }
 
+    if (_downscaleVolumeRendering.mergeProgram->isDirty()) {
+        _downscaleVolumeRendering.mergeProgram->rebuildFromFile();
+
+        ghoul::opengl::updateUniformLocations(
+            *_downscaleVolumeRendering.mergeProgram,
+            _downscaleVolumeRendering.uniformCache,
+            DownscaledVolumeUniformNames
+        );
+    }
+
+    if (_dynamicResolution.program->isDirty()) {
+        _dynamicResolution.program->rebuildFromFile();
+
+        ghoul::opengl::updateUniformLocations(
+            *_dynamicResolution.program,
+            _dynamicResolution.uniformCache,
+            UpscaleUniformNames
+        );
+    }
+
+    if (_backgroundCache.program->isDirty()) {
+        _backgroundCache.program->rebuildFromFile();
+
+        ghoul::opengl::updateUniformLocations(
+            *_backgroundCache.program,
+            _backgroundCache.uniformCache,
+            BackgroundCacheUniformNames
+        );
+    }
+
+    if (_resolvedGBuffer.program->isDirty()) {
+        _resolvedGBuffer.program->rebuildFromFile();
+
+        ghoul::opengl::updateUniformLocations(
+            *_resolvedGBuffer.program,
+            _resolvedGBuffer.uniformCache,
+            ResolveGBufferUniformNames
+        );
+    }
+
+    if (_postProcessAntialiasing.program->isDirty()) {
+        _postProcessAntialiasing.program->rebuildFromFile();
+
+        ghoul::opengl::updateUniformLocations(
+            *_postProcessAntialiasing.program,
+            _postProcessAntialiasing.uniformCache,
+            UpscaleUniformNames
+        );
+    }
+
     using K = VolumeRaycaster*;
     using V = std::unique_ptr<ghoul::opengl::ProgramObject>;
     for (const std::pair<const K, V>& program : _exitPrograms) {
@@ -340,6 +633,30 @@ void FramebufferRenderer::update() {
         }
     }
 
+    for (const std::pair<const K, V>& program : _boundsPrograms) {
+        if (program.second->isDirty()) {
+            try {
+                program.second->rebuildFromFile();
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.message);
+            }
+        }
+    }
+
+    for (const std::pair<const std::vector<K>, V>& program :
+         _combinedRaycasting.programs)
+    {
+        if (program.second && program.second->isDirty()) {
+            try {
+                program.second->rebuildFromFile();
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.message);
+            }
+        }
+    }
+
     for (const std::pair<
             Deferredcaster* const,
             std::unique_ptr<ghoul::opengl::ProgramObject>
@@ -451,6 +768,24 @@ void FramebufferRenderer::updateResolution() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
+    // The downscaled volumes are rendered into the lower left corner of this texture,
+    // so it only has to be resized when the full resolution changes
+    glBindTexture(GL_TEXTURE_2D, _downscaleVolumeRendering.colorTexture);
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        GL_RGBA32F,
+        _resolution.x,
+        _resolution.y,
+        0,
+        GL_RGBA,
+        GL_FLOAT,
+        nullptr
+    );
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
     _dirtyResolution = false;
 }
 
@@ -459,6 +794,8 @@ void FramebufferRenderer::updateRaycastData() {
     _exitPrograms.clear();
     _raycastPrograms.clear();
     _insideRaycastPrograms.clear();
+    _boundsPrograms.clear();
+    _combinedRaycasting.programs.clear();
 
     const std::vector<VolumeRaycaster*>& raycasters =
         global::raycasterManager.raycasters();
@@ -496,6 +833,17 @@ void FramebufferRenderer::updateRaycastData() {
             LERROR(e.message);
         }
 
+        try {
+            _boundsPrograms[raycaster] = ghoul::opengl::ProgramObject::Build(
+                "Volume " + std::to_string(data.id) + " bounds",
+                absPath(vsPath),
+                absPath(VolumeBoundsFragmentShaderPath),
+                dict
+            );
+        } catch (const ghoul::RuntimeError& e) {
+            LERROR(e.message);
+        }
+
         try {
             ghoul::Dictionary outsideDict = dict;
             outsideDict.setValue("getEntryPath", GetEntryOutsidePath);
@@ -910,6 +1258,7 @@ void FramebufferRenderer::updateMSAASamplingPattern() {
 }
 
 void FramebufferRenderer::render(Scene* scene, Camera* camera, float blackoutFactor) {
+    PerfTrace("FramebufferRenderer::render");
     const bool doPerformanceMeasurements = global::performanceManager.isEnabled();
 
     std::unique_ptr<performance::PerformanceMeasurement> perf;
@@ -929,6 +1278,9 @@ void FramebufferRenderer::render(Scene* scene, Camera* camera, float blackoutFac
     GLint defaultFbo;
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &defaultFbo);
 
+    const bool useBackgroundCache = _backgroundCache.isEnabled &&
+        updateBackgroundCache(*scene, *camera, doPerformanceMeasurements);
+
     glBindFramebuffer(GL_FRAMEBUFFER, _mainFramebuffer);
     glEnable(GL_DEPTH_TEST);
 
@@ -941,11 +1293,31 @@ void FramebufferRenderer::render(Scene* scene, Camera* camera, float blackoutFac
     glDrawBuffers(3, textureBuffers);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // With a resolution scale, everything up to the upscaling is rendered into the lower
+    // left part of the framebuffers
+    const glm::ivec2 res = scaledResolution();
+    const bool isScaled = (res != _resolution);
+    // The scaled image is composed in the deferred framebuffer and upscaled afterwards.
+    // The same is true if it is filtered or if the resolved G-buffer masks the edges
+    const bool isComposedInDeferredFbo = isScaled || _resolvedGBuffer.isEnabled ||
+                                         _postProcessAntialiasing.isEnabled;
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    if (isComposedInDeferredFbo) {
+        glViewport(0, 0, res.x, res.y);
+    }
+
     glEnablei(GL_BLEND, 0);
     glDisablei(GL_BLEND, 1);
     glDisablei(GL_BLEND, 2);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    // The adaptive raycasting resolution is reduced for every frame in which the camera
+    // has moved since the previous one
+    const glm::dmat4 viewMatrix = camera->combinedViewMatrix();
+    _isCameraMoving = (viewMatrix != _previousViewMatrix);
+    _previousViewMatrix = viewMatrix;
+
     Time time = global::timeManager.time();
 
     RenderData data = {
@@ -953,14 +1325,26 @@ void FramebufferRenderer::render(Scene* scene, Camera* camera, float blackoutFac
         std::move(time),
         doPerformanceMeasurements,
         0,
-        {}
+        {},
+        global::frameMemory.resource(),
+        depthPyramid()
     };
-    RendererTasks tasks;
+    RendererTasks tasks(data.frameMemory);
 
-    data.renderBinMask = static_cast<int>(Renderable::RenderBin::Background);
-    scene->render(data, tasks);
+    if (useBackgroundCache) {
+        drawBackgroundCache(*camera);
+    }
+    else {
+        data.renderBinMask = static_cast<int>(Renderable::RenderBin::Background);
+        scene->render(data, tasks);
+    }
     data.renderBinMask = static_cast<int>(Renderable::RenderBin::Opaque);
     scene->render(data, tasks);
+    if (_occlusionCulling.isEnabled) {
+        // Only the opaque geometry can hide the objects behind it
+        PerfTrace("FramebufferRenderer::render::depthPyramid");
+        _occlusionCulling.pyramid->update(_mainDepthTexture, _nAaSamples, res, *camera);
+    }
     data.renderBinMask = static_cast<int>(Renderable::RenderBin::Transparent);
     scene->render(data, tasks);
     data.renderBinMask = static_cast<int>(Renderable::RenderBin::Overlay);
@@ -973,12 +1357,25 @@ void FramebufferRenderer::render(Scene* scene, Camera* camera, float blackoutFac
                 "FramebufferRenderer::render::raycasterTasks"
             );
         }
+        PerfTrace("FramebufferRenderer::render::raycasterTasks");
         performRaycasterTasks(tasks.raycasterTasks);
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
+    // The deferred casters are only run once per pixel if the G-buffer is resolved and
+    // that is only worth it if there is more than one sample to begin with
+    const bool useResolvedGBuffer = _resolvedGBuffer.isEnabled && _nAaSamples > 1 &&
+                                    !tasks.deferredcasterTasks.empty();
+
+    const GLint targetFbo = isComposedInDeferredFbo ?
+        static_cast<GLint>(_deferredFramebuffer) :
+        defaultFbo;
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFbo);
     GLenum dBuffer[1] = { GL_COLOR_ATTACHMENT0 };
     glDrawBuffers(1, dBuffer);
+    if (isComposedInDeferredFbo) {
+        // The depth buffer is only attached once the resolved G-buffer has been used
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
 
     {
         std::unique_ptr<performance::PerformanceMeasurement> perfInternal;
@@ -987,11 +1384,17 @@ void FramebufferRenderer::render(Scene* scene, Camera* camera, float blackoutFac
                 "FramebufferRenderer::render::deferredTasks"
             );
         }
-        performDeferredTasks(tasks.deferredcasterTasks, blackoutFactor);
+        PerfTrace("FramebufferRenderer::render::deferredTasks");
+        if (useResolvedGBuffer) {
+            performResolvedDeferredTasks(tasks.deferredcasterTasks, blackoutFactor);
+        }
+        else {
+            performDeferredTasks(tasks.deferredcasterTasks, blackoutFactor);
+        }
     }
 
     if (tasks.deferredcasterTasks.empty()) {
-        glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, targetFbo);
         _resolveProgram->activate();
 
         ghoul::opengl::TextureUnit mainColorTextureUnit;
@@ -1007,121 +1410,817 @@ void FramebufferRenderer::render(Scene* scene, Camera* camera, float blackoutFac
 
         _resolveProgram->deactivate();
     }
-}
-
-void FramebufferRenderer::performRaycasterTasks(const std::vector<RaycasterTask>& tasks) {
-    for (const RaycasterTask& raycasterTask : tasks) {
-        VolumeRaycaster* raycaster = raycasterTask.raycaster;
-
-        glBindFramebuffer(GL_FRAMEBUFFER, _exitFramebuffer);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        ghoul::opengl::ProgramObject* exitProgram = _exitPrograms[raycaster].get();
-        if (exitProgram) {
-            exitProgram->activate();
-            raycaster->renderExitPoints(raycasterTask.renderData, *exitProgram);
-            exitProgram->deactivate();
-        }
-
-        glBindFramebuffer(GL_FRAMEBUFFER, _mainFramebuffer);
-        glm::vec3 cameraPosition;
-        bool isCameraInside = raycaster->isCameraInside(
-            raycasterTask.renderData,
-            cameraPosition
-        );
-        ghoul::opengl::ProgramObject* raycastProgram = nullptr;
 
-        if (isCameraInside) {
-            raycastProgram = _insideRaycastPrograms[raycaster].get();
-            if (raycastProgram) {
-                raycastProgram->activate();
-                raycastProgram->setUniform("cameraPosInRaycaster", cameraPosition);
-            }
-            else {
-                raycastProgram = _insideRaycastPrograms[raycaster].get();
-                raycastProgram->activate();
-                raycastProgram->setUniform("cameraPosInRaycaster", cameraPosition);
-            }
+    if (isComposedInDeferredFbo) {
+        glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        if (_postProcessAntialiasing.isEnabled) {
+            postProcessAntialiasing();
         }
         else {
-            raycastProgram = _raycastPrograms[raycaster].get();
-            if (raycastProgram) {
-                raycastProgram->activate();
-            }
-            else {
-                raycastProgram = _raycastPrograms[raycaster].get();
-                raycastProgram->activate();
-            }
+            upscale();
         }
+    }
 
-        if (raycastProgram) {
-            raycaster->preRaycast(_raycastData[raycaster], *raycastProgram);
+    if (_lastFrame.isEnabled) {
+        storeLastFrame(defaultFbo);
+    }
+}
 
-            ghoul::opengl::TextureUnit exitColorTextureUnit;
-            exitColorTextureUnit.activate();
-            glBindTexture(GL_TEXTURE_2D, _exitColorTexture);
-            raycastProgram->setUniform("exitColorTexture", exitColorTextureUnit);
+void FramebufferRenderer::storeLastFrame(GLint framebuffer) {
+    PerfTrace("FramebufferRenderer::storeLastFrame");
 
-            ghoul::opengl::TextureUnit exitDepthTextureUnit;
-            exitDepthTextureUnit.activate();
-            glBindTexture(GL_TEXTURE_2D, _exitDepthTexture);
-            raycastProgram->setUniform("exitDepthTexture", exitDepthTextureUnit);
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const glm::ivec4 vp = glm::ivec4(viewport[0], viewport[1], viewport[2], viewport[3]);
+    const glm::ivec2 size = glm::ivec2(vp.z, vp.w);
+
+    if (_lastFrame.textureSize != size) {
+        glBindTexture(GL_TEXTURE_2D, _lastFrame.colorTexture);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RGBA8,
+            size.x,
+            size.y,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            nullptr
+        );
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, _lastFrame.framebuffer);
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D,
+            _lastFrame.colorTexture,
+            0
+        );
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        _lastFrame.textureSize = size;
+    }
 
-            ghoul::opengl::TextureUnit mainDepthTextureUnit;
-            mainDepthTextureUnit.activate();
-            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainDepthTexture);
-            raycastProgram->setUniform("mainDepthTexture", mainDepthTextureUnit);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _lastFrame.framebuffer);
+    glBlitFramebuffer(
+        vp.x, vp.y, vp.x + vp.z, vp.y + vp.w,
+        0, 0, size.x, size.y,
+        GL_COLOR_BUFFER_BIT,
+        GL_NEAREST
+    );
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 
-            raycastProgram->setUniform("nAaSamples", _nAaSamples);
-            raycastProgram->setUniform("windowSize", static_cast<glm::vec2>(_resolution));
+    _lastFrame.viewport = vp;
+    _lastFrame.isValid = true;
+}
 
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            if (isCameraInside) {
-                glBindVertexArray(_screenQuad);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                glBindVertexArray(0);
-            }
-            else {
-                raycaster->renderEntryPoints(raycasterTask.renderData, *raycastProgram);
-            }
-            glDepthMask(true);
-            glEnable(GL_DEPTH_TEST);
+bool FramebufferRenderer::presentLastFrame() {
+    if (!_lastFrame.isEnabled || !_lastFrame.isValid) {
+        return false;
+    }
 
-            raycaster->postRaycast(_raycastData[raycaster], *raycastProgram);
-            raycastProgram->deactivate();
-        }
-        else {
-            LWARNING("Raycaster is not attached when trying to perform raycaster task");
-        }
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const glm::ivec4 vp = glm::ivec4(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (vp != _lastFrame.viewport) {
+        // The frame was rendered for a different viewport or before a resize
+        _lastFrame.isValid = false;
+        return false;
     }
-}
 
-void FramebufferRenderer::performDeferredTasks(
-                                             const std::vector<DeferredcasterTask>& tasks,
-                                                                     float blackoutFactor
-                                              )
-{
-    bool firstPaint = true;
+    PerfTrace("FramebufferRenderer::presentLastFrame");
+    GLint defaultFbo;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &defaultFbo);
 
-    for (const DeferredcasterTask& deferredcasterTask : tasks) {
-        Deferredcaster* deferredcaster = deferredcasterTask.deferredcaster;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _lastFrame.framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, defaultFbo);
+    glBlitFramebuffer(
+        0, 0, vp.z, vp.w,
+        vp.x, vp.y, vp.x + vp.z, vp.y + vp.w,
+        GL_COLOR_BUFFER_BIT,
+        GL_NEAREST
+    );
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFbo);
+    return true;
+}
 
-        ghoul::opengl::ProgramObject* deferredcastProgram = nullptr;
+glm::ivec2 FramebufferRenderer::scaledResolution() const {
+    return glm::max(
+        glm::ivec2(glm::round(glm::vec2(_resolution) * _dynamicResolution.scale)),
+        glm::ivec2(1)
+    );
+}
 
-        if (deferredcastProgram != _deferredcastPrograms[deferredcaster].get()
-            || deferredcastProgram == nullptr)
-        {
-            deferredcastProgram = _deferredcastPrograms[deferredcaster].get();
-        }
+void FramebufferRenderer::upscale() {
+    ghoul::opengl::ProgramObject& program = *_dynamicResolution.program;
+    program.activate();
 
-        if (deferredcastProgram) {
-            deferredcastProgram->activate();
+    ghoul::opengl::TextureUnit sourceTextureUnit;
+    sourceTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D, _deferredColorTexture);
+    program.setUniform(_dynamicResolution.uniformCache.sourceTexture, sourceTextureUnit);
+    program.setUniform(
+        _dynamicResolution.uniformCache.sourceSize,
+        glm::vec2(scaledResolution()) / glm::vec2(_resolution)
+    );
+
+    // The deferred framebuffer already contains the blended result
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(false);
+    glDisablei(GL_BLEND, 0);
+    glBindVertexArray(_screenQuad);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glEnablei(GL_BLEND, 0);
+    glDepthMask(true);
+    glEnable(GL_DEPTH_TEST);
+
+    program.deactivate();
+}
+
+void FramebufferRenderer::postProcessAntialiasing() {
+    ghoul::opengl::ProgramObject& program = *_postProcessAntialiasing.program;
+    program.activate();
+
+    ghoul::opengl::TextureUnit sourceTextureUnit;
+    sourceTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D, _deferredColorTexture);
+    program.setUniform(
+        _postProcessAntialiasing.uniformCache.sourceTexture,
+        sourceTextureUnit
+    );
+    program.setUniform(
+        _postProcessAntialiasing.uniformCache.sourceSize,
+        glm::vec2(scaledResolution()) / glm::vec2(_resolution)
+    );
+
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(false);
+    glDisablei(GL_BLEND, 0);
+    glBindVertexArray(_screenQuad);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glEnablei(GL_BLEND, 0);
+    glDepthMask(true);
+    glEnable(GL_DEPTH_TEST);
+
+    program.deactivate();
+}
+
+void FramebufferRenderer::performRaycasterTasks(
+                                          const std::pmr::vector<RaycasterTask>& tasks)
+{
+    size_t nCombined = 0;
+    if (_combinedRaycasting.isEnabled && tasks.size() > 1) {
+        std::vector<const RaycasterTask*> combinedTasks;
+        for (const RaycasterTask& task : tasks) {
+            if (combinedTasks.size() == MaxCombinedRaycasters) {
+                break;
+            }
+            combinedTasks.push_back(&task);
+        }
+
+        if (performCombinedRaycasterTasks(combinedTasks)) {
+            nCombined = combinedTasks.size();
+        }
+    }
+
+    // Volumes beyond the limit of the combined pass, or all of them if the combined
+    // program is not available, are raycast one after another
+    for (size_t i = nCombined; i < tasks.size(); ++i) {
+        performRaycasterTask(tasks[i]);
+    }
+}
+
+void FramebufferRenderer::performRaycasterTask(const RaycasterTask& raycasterTask) {
+    VolumeRaycaster* raycaster = raycasterTask.raycaster;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _exitFramebuffer);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    ghoul::opengl::ProgramObject* exitProgram = _exitPrograms[raycaster].get();
+    if (exitProgram) {
+        exitProgram->activate();
+        raycaster->renderExitPoints(raycasterTask.renderData, *exitProgram);
+        exitProgram->deactivate();
+    }
+
+    float downscaleFactor = raycaster->downscaleRender();
+    if (_adaptiveRaycastResolution && _isCameraMoving) {
+        downscaleFactor *= _raycastMotionDownscale;
+    }
+    const bool isDownscaled = downscaleFactor < 1.f;
+
+    const glm::ivec2 resolution = scaledResolution();
+    if (isDownscaled) {
+        glBindFramebuffer(GL_FRAMEBUFFER, _downscaleVolumeRendering.framebuffer);
+        glViewport(
+            0,
+            0,
+            static_cast<GLsizei>(std::ceil(resolution.x * downscaleFactor)),
+            static_cast<GLsizei>(std::ceil(resolution.y * downscaleFactor))
+        );
+        const GLfloat transparent[] = { 0.f, 0.f, 0.f, 0.f };
+        glClearBufferfv(GL_COLOR, 0, transparent);
+        // The raycast color is blended into the main framebuffer when merging
+        glDisablei(GL_BLEND, 0);
+    }
+    else {
+        glBindFramebuffer(GL_FRAMEBUFFER, _mainFramebuffer);
+    }
+
+    glm::vec3 cameraPosition;
+    bool isCameraInside = raycaster->isCameraInside(
+        raycasterTask.renderData,
+        cameraPosition
+    );
+    ghoul::opengl::ProgramObject* raycastProgram = nullptr;
+
+    if (isCameraInside) {
+        raycastProgram = _insideRaycastPrograms[raycaster].get();
+        if (raycastProgram) {
+            raycastProgram->activate();
+            raycastProgram->setUniform("cameraPosInRaycaster", cameraPosition);
+        }
+        else {
+            raycastProgram = _insideRaycastPrograms[raycaster].get();
+            raycastProgram->activate();
+            raycastProgram->setUniform("cameraPosInRaycaster", cameraPosition);
+        }
+    }
+    else {
+        raycastProgram = _raycastPrograms[raycaster].get();
+        if (raycastProgram) {
+            raycastProgram->activate();
+        }
+        else {
+            raycastProgram = _raycastPrograms[raycaster].get();
+            raycastProgram->activate();
+        }
+    }
+
+    if (raycastProgram) {
+        raycaster->preRaycast(_raycastData[raycaster], *raycastProgram);
+
+        ghoul::opengl::TextureUnit exitColorTextureUnit;
+        exitColorTextureUnit.activate();
+        glBindTexture(GL_TEXTURE_2D, _exitColorTexture);
+        raycastProgram->setUniform("exitColorTexture", exitColorTextureUnit);
+
+        ghoul::opengl::TextureUnit exitDepthTextureUnit;
+        exitDepthTextureUnit.activate();
+        glBindTexture(GL_TEXTURE_2D, _exitDepthTexture);
+        raycastProgram->setUniform("exitDepthTexture", exitDepthTextureUnit);
+
+        ghoul::opengl::TextureUnit mainDepthTextureUnit;
+        mainDepthTextureUnit.activate();
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainDepthTexture);
+        raycastProgram->setUniform("mainDepthTexture", mainDepthTextureUnit);
+
+        raycastProgram->setUniform("nAaSamples", _nAaSamples);
+        raycastProgram->setUniform(
+            "windowSize",
+            static_cast<glm::vec2>(resolution) * downscaleFactor
+        );
+        raycastProgram->setUniform("downscaleRenderConst", downscaleFactor);
+
+        glDisable(GL_DEPTH_TEST);
+        glDepthMask(false);
+        if (isCameraInside) {
+            glBindVertexArray(_screenQuad);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            glBindVertexArray(0);
+        }
+        else {
+            raycaster->renderEntryPoints(raycasterTask.renderData, *raycastProgram);
+        }
+        glDepthMask(true);
+        glEnable(GL_DEPTH_TEST);
+
+        raycaster->postRaycast(_raycastData[raycaster], *raycastProgram);
+        raycastProgram->deactivate();
+    }
+    else {
+        LWARNING("Raycaster is not attached when trying to perform raycaster task");
+    }
+
+    if (isDownscaled) {
+        glViewport(0, 0, resolution.x, resolution.y);
+        glBindFramebuffer(GL_FRAMEBUFFER, _mainFramebuffer);
+        glEnablei(GL_BLEND, 0);
+        if (raycastProgram) {
+            mergeDownscaledVolume(downscaleFactor);
+        }
+    }
+}
+
+bool FramebufferRenderer::performCombinedRaycasterTasks(
+                                          const std::vector<const RaycasterTask*>& tasks)
+{
+    std::vector<VolumeRaycaster*> raycasters;
+    raycasters.reserve(tasks.size());
+    for (const RaycasterTask* task : tasks) {
+        if (!_boundsPrograms[task->raycaster]) {
+            return false;
+        }
+        raycasters.push_back(task->raycaster);
+    }
+
+    ghoul::opengl::ProgramObject* program = combinedRaycastProgram(raycasters);
+    if (!program) {
+        return false;
+    }
+
+    const int nLayers = static_cast<int>(tasks.size());
+    if (_combinedRaycasting.nLayers < nLayers ||
+        _combinedRaycasting.textureSize != _resolution)
+    {
+        for (GLuint texture : { _combinedRaycasting.entryTexture,
+                                _combinedRaycasting.exitTexture })
+        {
+            glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+            glTexImage3D(
+                GL_TEXTURE_2D_ARRAY,
+                0,
+                GL_RGBA32F,
+                _resolution.x,
+                _resolution.y,
+                nLayers,
+                0,
+                GL_RGBA,
+                GL_FLOAT,
+                nullptr
+            );
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        }
+
+        glBindRenderbuffer(GL_RENDERBUFFER, _combinedRaycasting.depthBuffer);
+        glRenderbufferStorage(
+            GL_RENDERBUFFER,
+            GL_DEPTH_COMPONENT32F,
+            _resolution.x,
+            _resolution.y
+        );
+        glBindFramebuffer(GL_FRAMEBUFFER, _combinedRaycasting.framebuffer);
+        glFramebufferRenderbuffer(
+            GL_FRAMEBUFFER,
+            GL_DEPTH_ATTACHMENT,
+            GL_RENDERBUFFER,
+            _combinedRaycasting.depthBuffer
+        );
+
+        _combinedRaycasting.nLayers = nLayers;
+        _combinedRaycasting.textureSize = _resolution;
+    }
+
+    // Render the entry and exit points of every volume into its own layer. The position
+    // is written into the color, so blending has to be disabled while doing so
+    glBindFramebuffer(GL_FRAMEBUFFER, _combinedRaycasting.framebuffer);
+    glDisablei(GL_BLEND, 0);
+    const GLfloat uncovered[] = { 0.f, 0.f, 0.f, -1.f };
+    for (int i = 0; i < nLayers; ++i) {
+        const RaycasterTask& task = *tasks[i];
+        ghoul::opengl::ProgramObject& boundsProgram = *_boundsPrograms[task.raycaster];
+
+        glFramebufferTextureLayer(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            _combinedRaycasting.entryTexture,
+            0,
+            i
+        );
+        glClearBufferfv(GL_COLOR, 0, uncovered);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        boundsProgram.activate();
+        task.raycaster->renderEntryPoints(task.renderData, boundsProgram);
+        boundsProgram.deactivate();
+
+        glFramebufferTextureLayer(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            _combinedRaycasting.exitTexture,
+            0,
+            i
+        );
+        glClearBufferfv(GL_COLOR, 0, uncovered);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        boundsProgram.activate();
+        task.raycaster->renderExitPoints(task.renderData, boundsProgram);
+        boundsProgram.deactivate();
+    }
+    glEnablei(GL_BLEND, 0);
+
+    // All volumes share one pass, so the pass uses the finest resolution that any of
+    // them asks for
+    float downscaleFactor = 0.f;
+    for (VolumeRaycaster* raycaster : raycasters) {
+        downscaleFactor = std::max(downscaleFactor, raycaster->downscaleRender());
+    }
+    if (_adaptiveRaycastResolution && _isCameraMoving) {
+        downscaleFactor *= _raycastMotionDownscale;
+    }
+    const bool isDownscaled = downscaleFactor < 1.f;
+
+    const glm::ivec2 resolution = scaledResolution();
+    if (isDownscaled) {
+        glBindFramebuffer(GL_FRAMEBUFFER, _downscaleVolumeRendering.framebuffer);
+        glViewport(
+            0,
+            0,
+            static_cast<GLsizei>(std::ceil(resolution.x * downscaleFactor)),
+            static_cast<GLsizei>(std::ceil(resolution.y * downscaleFactor))
+        );
+        const GLfloat transparent[] = { 0.f, 0.f, 0.f, 0.f };
+        glClearBufferfv(GL_COLOR, 0, transparent);
+        // The raycast color is blended into the main framebuffer when merging
+        glDisablei(GL_BLEND, 0);
+    }
+    else {
+        glBindFramebuffer(GL_FRAMEBUFFER, _mainFramebuffer);
+    }
+
+    program->activate();
+    for (const RaycasterTask* task : tasks) {
+        const RaycastData& data = _raycastData[task->raycaster];
+        task->raycaster->preRaycast(data, *program);
+
+        glm::vec3 cameraPosition;
+        const bool isCameraInside = task->raycaster->isCameraInside(
+            task->renderData,
+            cameraPosition
+        );
+        const std::string id = std::to_string(data.id);
+        program->setUniform("insideRaycaster" + id, isCameraInside);
+        program->setUniform("cameraPosInRaycaster" + id, cameraPosition);
+    }
+
+    ghoul::opengl::TextureUnit entryTextureUnit;
+    entryTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, _combinedRaycasting.entryTexture);
+    program->setUniform("entryTexture", entryTextureUnit);
+
+    ghoul::opengl::TextureUnit exitTextureUnit;
+    exitTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, _combinedRaycasting.exitTexture);
+    program->setUniform("exitTexture", exitTextureUnit);
+
+    ghoul::opengl::TextureUnit mainDepthTextureUnit;
+    mainDepthTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainDepthTexture);
+    program->setUniform("mainDepthTexture", mainDepthTextureUnit);
+
+    program->setUniform("nAaSamples", _nAaSamples);
+    program->setUniform("downscaleRenderConst", downscaleFactor);
+
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(false);
+    glBindVertexArray(_screenQuad);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glDepthMask(true);
+    glEnable(GL_DEPTH_TEST);
+
+    for (const RaycasterTask* task : tasks) {
+        task->raycaster->postRaycast(_raycastData[task->raycaster], *program);
+    }
+    program->deactivate();
+
+    if (isDownscaled) {
+        glViewport(0, 0, resolution.x, resolution.y);
+        glBindFramebuffer(GL_FRAMEBUFFER, _mainFramebuffer);
+        glEnablei(GL_BLEND, 0);
+        mergeDownscaledVolume(downscaleFactor);
+    }
+    return true;
+}
+
+ghoul::opengl::ProgramObject* FramebufferRenderer::combinedRaycastProgram(
+                                          const std::vector<VolumeRaycaster*>& raycasters)
+{
+    const auto it = _combinedRaycasting.programs.find(raycasters);
+    if (it != _combinedRaycasting.programs.end()) {
+        // A failed build is stored as well, so that it is not repeated every frame
+        return it->second.get();
+    }
+
+    ghoul::Dictionary raycastersDict;
+    ghoul::Dictionary helpersDict;
+    std::vector<std::string> helperPaths;
+    for (size_t i = 0; i < raycasters.size(); ++i) {
+        VolumeRaycaster* raycaster = raycasters[i];
+        const RaycastData& data = _raycastData[raycaster];
+
+        // The raycaster code refers to its own functions and uniforms through the id,
+        // which is the key of the dictionary in the loops of the shader
+        ghoul::Dictionary innerDict;
+        innerDict.setValue("id", data.id);
+        innerDict.setValue("layer", static_cast<int>(i));
+        innerDict.setValue("raycastPath", raycaster->raycasterPath());
+        raycastersDict.setValue(std::to_string(data.id), std::move(innerDict));
+
+        std::string helperPath = raycaster->helperPath();
+        const bool isNewHelper = std::find(
+            helperPaths.begin(),
+            helperPaths.end(),
+            helperPath
+        ) == helperPaths.end();
+        if (!helperPath.empty() && isNewHelper) {
+            helpersDict.setValue(std::to_string(helperPaths.size()), helperPath);
+            helperPaths.push_back(std::move(helperPath));
+        }
+    }
+
+    ghoul::Dictionary dict;
+    dict.setValue("rendererData", _rendererData);
+    dict.setValue("raycasters", std::move(raycastersDict));
+    dict.setValue("helperPaths", std::move(helpersDict));
+    dict.setValue("nRaycasters", static_cast<int>(raycasters.size()));
+
+    std::unique_ptr<ghoul::opengl::ProgramObject>& program =
+        _combinedRaycasting.programs[raycasters];
+    try {
+        program = ghoul::opengl::ProgramObject::Build(
+            "Combined volume raycast",
+            absPath("${SHADERS}/framebuffer/resolveframebuffer.vert"),
+            absPath(CombinedRaycastFragmentShaderPath),
+            dict
+        );
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+    }
+    return program.get();
+}
+
+void FramebufferRenderer::mergeDownscaledVolume(float downscaleFactor) {
+    ghoul::opengl::ProgramObject& program = *_downscaleVolumeRendering.mergeProgram;
+    program.activate();
+
+    ghoul::opengl::TextureUnit downscaledTextureUnit;
+    downscaledTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D, _downscaleVolumeRendering.colorTexture);
+    program.setUniform(
+        _downscaleVolumeRendering.uniformCache.downscaledVolume,
+        downscaledTextureUnit
+    );
+
+    ghoul::opengl::TextureUnit mainDepthTextureUnit;
+    mainDepthTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainDepthTexture);
+    program.setUniform(
+        _downscaleVolumeRendering.uniformCache.mainDepthTexture,
+        mainDepthTextureUnit
+    );
+
+    program.setUniform(
+        _downscaleVolumeRendering.uniformCache.downscaleFactor,
+        downscaleFactor
+    );
+    program.setUniform(
+        _downscaleVolumeRendering.uniformCache.downscaledSize,
+        glm::ivec2(glm::ceil(glm::vec2(scaledResolution()) * downscaleFactor))
+    );
+
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(false);
+    glBindVertexArray(_screenQuad);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glDepthMask(true);
+    glEnable(GL_DEPTH_TEST);
+
+    program.deactivate();
+}
+
+bool FramebufferRenderer::updateBackgroundCache(Scene& scene, const Camera& camera,
+                                                bool doPerformanceMeasurements)
+{
+    const Time& time = global::timeManager.time();
+
+    std::vector<const SceneGraphNode*> nodes;
+    for (const SceneGraphNode* node : scene.allSceneGraphNodes()) {
+        const Renderable* renderable = node->renderable();
+        if (renderable && renderable->renderBin() == Renderable::RenderBin::Background &&
+            node->shouldRender(time))
+        {
+            nodes.push_back(node);
+        }
+    }
+    if (nodes != _backgroundCache.nodes) {
+        _backgroundCache.nodes = std::move(nodes);
+        _backgroundCache.isValid = false;
+        _backgroundCache.isCachable = true;
+    }
+    if (!_backgroundCache.isCachable || _backgroundCache.nodes.empty()) {
+        return false;
+    }
+
+    const double distance = glm::distance(
+        camera.positionVec3(),
+        _backgroundCache.cameraPosition
+    );
+    if (_backgroundCache.isValid &&
+        _backgroundCache.textureResolution == _backgroundCache.resolution &&
+        distance <= _backgroundCache.distance)
+    {
+        return true;
+    }
+
+    PerfTrace("FramebufferRenderer::updateBackgroundCache");
+    const int res = _backgroundCache.resolution;
+    if (_backgroundCache.textureResolution != res) {
+        glBindTexture(GL_TEXTURE_CUBE_MAP, _backgroundCache.cubeMap);
+        for (int i = 0; i < 6; ++i) {
+            glTexImage2D(
+                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
+                0,
+                GL_RGBA16F,
+                res,
+                res,
+                0,
+                GL_RGBA,
+                GL_FLOAT,
+                nullptr
+            );
+        }
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, _backgroundCache.depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, res, res);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, _backgroundCache.framebuffer);
+        glFramebufferRenderbuffer(
+            GL_FRAMEBUFFER,
+            GL_DEPTH_ATTACHMENT,
+            GL_RENDERBUFFER,
+            _backgroundCache.depthBuffer
+        );
+        _backgroundCache.textureResolution = res;
+    }
+
+    // The faces are rendered from the camera position with a 90 degree field of view
+    // and the near and far planes of the current projection
+    const glm::mat4& projection = camera.sgctInternal.projectionMatrix();
+    const float nearPlane = projection[3][2] / (projection[2][2] - 1.f);
+    const float farPlane = projection[3][2] / (projection[2][2] + 1.f);
+
+    Camera faceCamera(camera);
+    faceCamera.sgctInternal.setSceneMatrix(glm::mat4(1.f));
+    faceCamera.sgctInternal.setViewMatrix(glm::mat4(1.f));
+    faceCamera.sgctInternal.setProjectionMatrix(
+        glm::perspective(glm::half_pi<float>(), 1.f, nearPlane, farPlane)
+    );
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, _backgroundCache.framebuffer);
+    glViewport(0, 0, res, res);
+    GLenum drawBuffer = GL_COLOR_ATTACHMENT0;
+    glDrawBuffers(1, &drawBuffer);
+    glEnable(GL_DEPTH_TEST);
+    glEnablei(GL_BLEND, 0);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    RendererTasks tasks(global::frameMemory.resource());
+    for (size_t i = 0; i < CubeMapFaces.size(); ++i) {
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(i),
+            _backgroundCache.cubeMap,
+            0
+        );
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // The camera rotation is the inverse of the rotation of the view matrix
+        const glm::dmat4 faceView = glm::lookAt(
+            glm::dvec3(0.0),
+            CubeMapFaces[i].direction,
+            CubeMapFaces[i].up
+        );
+        faceCamera.setRotation(glm::quat_cast(glm::transpose(glm::dmat3(faceView))));
+        faceCamera.invalidateCache();
+
+        RenderData data = {
+            faceCamera,
+            time,
+            doPerformanceMeasurements,
+            static_cast<int>(Renderable::RenderBin::Background),
+            {},
+            global::frameMemory.resource()
+        };
+        // The nodes outside of the camera frustum were culled, but they might be visible
+        // in any of the faces
+        scene.render(data, tasks, false);
+    }
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    // Raycasters and deferredcasters have to be performed for the actual view, so the
+    // background cannot be cached with them until the background nodes change
+    if (!tasks.raycasterTasks.empty() || !tasks.deferredcasterTasks.empty()) {
+        LINFO("Background render bin contains raycasters, not caching it");
+        _backgroundCache.isCachable = false;
+        _backgroundCache.isValid = false;
+        return false;
+    }
+
+    _backgroundCache.cameraPosition = camera.positionVec3();
+    _backgroundCache.isValid = true;
+    return true;
+}
+
+void FramebufferRenderer::drawBackgroundCache(const Camera& camera) {
+    ghoul::opengl::ProgramObject& program = *_backgroundCache.program;
+    program.activate();
+
+    ghoul::opengl::TextureUnit cubeMapUnit;
+    cubeMapUnit.activate();
+    glBindTexture(GL_TEXTURE_CUBE_MAP, _backgroundCache.cubeMap);
+    program.setUniform(_backgroundCache.uniformCache.backgroundCubeMap, cubeMapUnit);
+
+    // The translation of the view is removed as the cube map is centered on the camera
+    const glm::dmat4 viewRotation = glm::dmat4(glm::dmat3(camera.combinedViewMatrix()));
+    const glm::dmat4 viewProjection =
+        glm::dmat4(camera.sgctInternal.projectionMatrix()) * viewRotation;
+    program.setUniform(
+        _backgroundCache.uniformCache.inverseViewProjection,
+        glm::mat4(glm::inverse(viewProjection))
+    );
+
+    // Only the color is written, which is what rendering the background onto the
+    // cleared framebuffer would have produced
+    GLenum drawBuffer = GL_COLOR_ATTACHMENT0;
+    glDrawBuffers(1, &drawBuffer);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(false);
+    glDisablei(GL_BLEND, 0);
+    glBindVertexArray(_screenQuad);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glEnablei(GL_BLEND, 0);
+    glDepthMask(true);
+    glEnable(GL_DEPTH_TEST);
+    GLenum textureBuffers[3] = {
+        GL_COLOR_ATTACHMENT0,
+        GL_COLOR_ATTACHMENT1,
+        GL_COLOR_ATTACHMENT2,
+    };
+    glDrawBuffers(3, textureBuffers);
+
+    program.deactivate();
+}
+
+void FramebufferRenderer::performDeferredTasks(
+                                        const std::pmr::vector<DeferredcasterTask>& tasks,
+                                                                     float blackoutFactor
+                                              )
+{
+    performDeferredTasks(
+        tasks,
+        blackoutFactor,
+        _mainColorTexture,
+        _mainPositionTexture,
+        _mainNormalTexture,
+        _nAaSamples,
+        GL_ALWAYS
+    );
+}
+
+void FramebufferRenderer::performDeferredTasks(
+                                        const std::pmr::vector<DeferredcasterTask>& tasks,
+                                              float blackoutFactor, GLuint color,
+                                              GLuint position, GLuint normal,
+                                              int nSamples, GLenum depthFunction)
+{
+    bool firstPaint = true;
+
+    for (const DeferredcasterTask& deferredcasterTask : tasks) {
+        Deferredcaster* deferredcaster = deferredcasterTask.deferredcaster;
+
+        ghoul::opengl::ProgramObject* deferredcastProgram = nullptr;
+
+        if (deferredcastProgram != _deferredcastPrograms[deferredcaster].get()
+            || deferredcastProgram == nullptr)
+        {
+            deferredcastProgram = _deferredcastPrograms[deferredcaster].get();
+        }
+
+        if (deferredcastProgram) {
+            deferredcastProgram->activate();
 
             // adding G-Buffer
             ghoul::opengl::TextureUnit mainDColorTextureUnit;
             mainDColorTextureUnit.activate();
-            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainColorTexture);
+            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, color);
             deferredcastProgram->setUniform(
                 "mainColorTexture",
                 mainDColorTextureUnit
@@ -1129,7 +2228,7 @@ void FramebufferRenderer::performDeferredTasks(
 
             ghoul::opengl::TextureUnit mainPositionTextureUnit;
             mainPositionTextureUnit.activate();
-            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainPositionTexture);
+            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, position);
             deferredcastProgram->setUniform(
                 "mainPositionTexture",
                 mainPositionTextureUnit
@@ -1137,13 +2236,13 @@ void FramebufferRenderer::performDeferredTasks(
 
             ghoul::opengl::TextureUnit mainNormalTextureUnit;
             mainNormalTextureUnit.activate();
-            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainNormalTexture);
+            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, normal);
             deferredcastProgram->setUniform(
                 "mainNormalTexture",
                 mainNormalTextureUnit
             );
 
-            deferredcastProgram->setUniform("nAaSamples", _nAaSamples);
+            deferredcastProgram->setUniform("nAaSamples", nSamples);
             // 48 = 16 samples * 3 coords
             deferredcastProgram->setUniform("msaaSamplePatter", &_mSAAPattern[0], 48);
 
@@ -1153,6 +2252,33 @@ void FramebufferRenderer::performDeferredTasks(
 
             deferredcastProgram->setUniform("blackoutFactor", blackoutFactor);
 
+            // Convert the caster's bounds from normalized device coordinates into
+            // window coordinates of the current viewport
+            const glm::vec4 bounds = deferredcaster->screenSpaceBounds(
+                deferredcasterTask.renderData
+            );
+            GLint viewport[4];
+            glGetIntegerv(GL_VIEWPORT, viewport);
+            const glm::ivec4 pixelBounds = glm::ivec4(
+                viewport[0] + std::floor((bounds.x * 0.5f + 0.5f) * viewport[2]),
+                viewport[1] + std::floor((bounds.y * 0.5f + 0.5f) * viewport[3]),
+                viewport[0] + std::ceil((bounds.z * 0.5f + 0.5f) * viewport[2]),
+                viewport[1] + std::ceil((bounds.w * 0.5f + 0.5f) * viewport[3])
+            );
+            const bool isEmpty = pixelBounds.x >= pixelBounds.z ||
+                                 pixelBounds.y >= pixelBounds.w;
+
+            // The first pass has to cover the entire screen as it also copies the
+            // background to the render target; all following passes only need to touch
+            // the pixels that the deferredcaster can affect
+            if (isEmpty && !firstPaint) {
+                deferredcastProgram->deactivate();
+                continue;
+            }
+            deferredcastProgram->setUniform(
+                "screenSpaceBounds",
+                glm::vec4(pixelBounds)
+            );
 
             deferredcaster->preRaycast(
                 deferredcasterTask.renderData,
@@ -1160,15 +2286,33 @@ void FramebufferRenderer::performDeferredTasks(
                 *deferredcastProgram
             );
 
-            glDisable(GL_DEPTH_TEST);
+            if (depthFunction == GL_ALWAYS) {
+                glDisable(GL_DEPTH_TEST);
+            }
+            else {
+                glDepthFunc(depthFunction);
+            }
             glDepthMask(false);
+            if (!firstPaint) {
+                glEnable(GL_SCISSOR_TEST);
+                glScissor(
+                    pixelBounds.x,
+                    pixelBounds.y,
+                    pixelBounds.z - pixelBounds.x,
+                    pixelBounds.w - pixelBounds.y
+                );
+            }
 
             glBindVertexArray(_screenQuad);
             glDrawArrays(GL_TRIANGLES, 0, 6);
             glBindVertexArray(0);
 
+            if (!firstPaint) {
+                glDisable(GL_SCISSOR_TEST);
+            }
             glDepthMask(true);
             glEnable(GL_DEPTH_TEST);
+            glDepthFunc(GL_LESS);
 
             deferredcaster->postRaycast(
                 deferredcasterTask.renderData,
@@ -1190,6 +2334,199 @@ void FramebufferRenderer::performDeferredTasks(
     }
 }
 
+void FramebufferRenderer::performResolvedDeferredTasks(
+                                        const std::pmr::vector<DeferredcasterTask>& tasks,
+                                                                     float blackoutFactor)
+{
+    if (_resolvedGBuffer.textureSize != _resolution) {
+        // The textures are multisampled with a single sample, so that the deferred
+        // casters can read them in the same way as the main G-buffer
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _resolvedGBuffer.colorTexture);
+        glTexImage2DMultisample(
+            GL_TEXTURE_2D_MULTISAMPLE,
+            1,
+            GL_RGBA,
+            _resolution.x,
+            _resolution.y,
+            true
+        );
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _resolvedGBuffer.positionTexture);
+        glTexImage2DMultisample(
+            GL_TEXTURE_2D_MULTISAMPLE,
+            1,
+            GL_RGBA32F,
+            _resolution.x,
+            _resolution.y,
+            true
+        );
+        // Normals do not need the full precision that the positions do
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _resolvedGBuffer.normalTexture);
+        glTexImage2DMultisample(
+            GL_TEXTURE_2D_MULTISAMPLE,
+            1,
+            GL_RGBA16F,
+            _resolution.x,
+            _resolution.y,
+            true
+        );
+
+        glBindRenderbuffer(GL_RENDERBUFFER, _resolvedGBuffer.depthBuffer);
+        glRenderbufferStorage(
+            GL_RENDERBUFFER,
+            GL_DEPTH_COMPONENT32F,
+            _resolution.x,
+            _resolution.y
+        );
+
+        glBindFramebuffer(GL_FRAMEBUFFER, _resolvedGBuffer.framebuffer);
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D_MULTISAMPLE,
+            _resolvedGBuffer.colorTexture,
+            0
+        );
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT1,
+            GL_TEXTURE_2D_MULTISAMPLE,
+            _resolvedGBuffer.positionTexture,
+            0
+        );
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT2,
+            GL_TEXTURE_2D_MULTISAMPLE,
+            _resolvedGBuffer.normalTexture,
+            0
+        );
+        glFramebufferRenderbuffer(
+            GL_FRAMEBUFFER,
+            GL_DEPTH_ATTACHMENT,
+            GL_RENDERBUFFER,
+            _resolvedGBuffer.depthBuffer
+        );
+
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            LERROR("Resolved G-buffer framebuffer is not complete");
+        }
+
+        // The deferred passes are depth tested against the edge mask
+        glBindFramebuffer(GL_FRAMEBUFFER, _deferredFramebuffer);
+        glFramebufferRenderbuffer(
+            GL_FRAMEBUFFER,
+            GL_DEPTH_ATTACHMENT,
+            GL_RENDERBUFFER,
+            _resolvedGBuffer.depthBuffer
+        );
+
+        _resolvedGBuffer.textureSize = _resolution;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _resolvedGBuffer.framebuffer);
+    GLenum textureBuffers[3] = {
+        GL_COLOR_ATTACHMENT0,
+        GL_COLOR_ATTACHMENT1,
+        GL_COLOR_ATTACHMENT2,
+    };
+    glDrawBuffers(3, textureBuffers);
+
+    ghoul::opengl::ProgramObject& program = *_resolvedGBuffer.program;
+    program.activate();
+
+    ghoul::opengl::TextureUnit mainColorTextureUnit;
+    mainColorTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainColorTexture);
+    program.setUniform(
+        _resolvedGBuffer.uniformCache.mainColorTexture,
+        mainColorTextureUnit
+    );
+
+    ghoul::opengl::TextureUnit mainPositionTextureUnit;
+    mainPositionTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainPositionTexture);
+    program.setUniform(
+        _resolvedGBuffer.uniformCache.mainPositionTexture,
+        mainPositionTextureUnit
+    );
+
+    ghoul::opengl::TextureUnit mainNormalTextureUnit;
+    mainNormalTextureUnit.activate();
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, _mainNormalTexture);
+    program.setUniform(
+        _resolvedGBuffer.uniformCache.mainNormalTexture,
+        mainNormalTextureUnit
+    );
+
+    program.setUniform(_resolvedGBuffer.uniformCache.nAaSamples, _nAaSamples);
+
+    // Every pixel writes its depth, so the mask does not have to be cleared
+    glDisablei(GL_BLEND, 0);
+    glDepthFunc(GL_ALWAYS);
+    glBindVertexArray(_screenQuad);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glDepthFunc(GL_LESS);
+    glEnablei(GL_BLEND, 0);
+
+    program.deactivate();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _deferredFramebuffer);
+    GLenum dBuffer[1] = { GL_COLOR_ATTACHMENT0 };
+    glDrawBuffers(1, dBuffer);
+
+    // The screen quad lies at a depth of 0.5, between the mask values of 0 for the edge
+    // pixels and 1 for all others
+    performDeferredTasks(
+        tasks,
+        blackoutFactor,
+        _resolvedGBuffer.colorTexture,
+        _resolvedGBuffer.positionTexture,
+        _resolvedGBuffer.normalTexture,
+        1,
+        GL_LESS
+    );
+    performDeferredTasks(
+        tasks,
+        blackoutFactor,
+        _mainColorTexture,
+        _mainPositionTexture,
+        _mainNormalTexture,
+        _nAaSamples,
+        GL_GREATER
+    );
+}
+
+void FramebufferRenderer::setWindow(int windowId, glm::ivec2 resolution) {
+    if (_activeWindow == -1) {
+        // The first window that is rendered to uses the initial framebuffers
+        _activeWindow = windowId;
+    }
+
+    if (windowId != _activeWindow) {
+        // Park the framebuffers of the previous window, which leaves the members empty
+        swapWindowFramebuffers(_windowFramebuffers[_activeWindow]);
+        _activeWindow = windowId;
+
+        auto it = _windowFramebuffers.find(windowId);
+        if (it != _windowFramebuffers.end()) {
+            swapWindowFramebuffers(it->second);
+            _windowFramebuffers.erase(it);
+        }
+        else {
+            _resolution = resolution;
+            createWindowFramebuffers();
+        }
+    }
+
+    if (resolution != _resolution) {
+        _resolution = resolution;
+        updateResolution();
+        _lastFrame.isValid = false;
+    }
+}
+
 void FramebufferRenderer::setResolution(glm::ivec2 res) {
     _resolution = std::move(res);
     _dirtyResolution = true;
@@ -1226,6 +2563,73 @@ void FramebufferRenderer::setGamma(float gamma) {
     _gamma = gamma;
 }
 
+void FramebufferRenderer::setAdaptiveRaycastResolution(bool enabled) {
+    _adaptiveRaycastResolution = enabled;
+}
+
+void FramebufferRenderer::setRaycastMotionDownscale(float factor) {
+    ghoul_assert(
+        factor > 0.f && factor <= 1.f,
+        "Raycast motion downscale must be in (0, 1]"
+    );
+    _raycastMotionDownscale = factor;
+}
+
+void FramebufferRenderer::setCombinedRaycasting(bool enabled) {
+    _combinedRaycasting.isEnabled = enabled;
+}
+
+void FramebufferRenderer::setResolvedDeferredShading(bool enabled) {
+    _resolvedGBuffer.isEnabled = enabled;
+}
+
+void FramebufferRenderer::setPostProcessAntialiasing(bool enabled) {
+    _postProcessAntialiasing.isEnabled = enabled;
+}
+
+void FramebufferRenderer::setBackgroundCache(bool enabled) {
+    _backgroundCache.isEnabled = enabled;
+    _backgroundCache.isValid = false;
+}
+
+void FramebufferRenderer::setBackgroundCacheResolution(int resolution) {
+    _backgroundCache.resolution = resolution;
+}
+
+void FramebufferRenderer::setBackgroundCacheDistance(float distance) {
+    _backgroundCache.distance = distance;
+}
+
+void FramebufferRenderer::setKeepLastFrame(bool enabled) {
+    _lastFrame.isEnabled = enabled;
+    _lastFrame.isValid = false;
+    for (std::pair<const int, WindowFramebuffers>& window : _windowFramebuffers) {
+        window.second.isLastFrameValid = false;
+    }
+}
+
+void FramebufferRenderer::setOcclusionCulling(bool enabled) {
+    _occlusionCulling.isEnabled = enabled;
+    // The renderer might not have been initialized yet
+    if (!enabled && _occlusionCulling.pyramid) {
+        _occlusionCulling.pyramid->invalidate();
+        for (std::pair<const int, WindowFramebuffers>& window : _windowFramebuffers) {
+            window.second.depthPyramid->invalidate();
+        }
+    }
+}
+
+const DepthPyramid* FramebufferRenderer::depthPyramid() const {
+    const bool isUsable = _occlusionCulling.isEnabled && _occlusionCulling.pyramid &&
+                          _occlusionCulling.pyramid->isValid();
+    return isUsable ? _occlusionCulling.pyramid.get() : nullptr;
+}
+
+void FramebufferRenderer::setResolutionScale(float scale) {
+    ghoul_assert(scale > 0.f && scale <= 1.f, "Resolution scale must be in (0, 1]");
+    _dynamicResolution.scale = scale;
+}
+
 float FramebufferRenderer::hdrBackground() const {
     return _hdrBackground;
 }
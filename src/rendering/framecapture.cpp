@@ -0,0 +1,227 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/rendering/framecapture.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/engine/windowdelegate.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace {
+    constexpr const char* _loggerCat = "FrameCapture";
+
+    // One core is left for the rendering thread
+    size_t numberOfWorkers() {
+        const unsigned int n = std::thread::hardware_concurrency();
+        return n > 1 ? n - 1 : 1;
+    }
+
+    // The pixels are read back as BGRA, starting with the bottom row, which matches the
+    // layout of a TGA file with a bottom-left origin
+    void writeTga(const std::string& filename, const glm::ivec2& res,
+                  const std::vector<unsigned char>& pixels)
+    {
+        std::array<unsigned char, 18> header = {};
+        header[2] = 2; // Uncompressed true color image
+        header[12] = static_cast<unsigned char>(res.x & 0xFF);
+        header[13] = static_cast<unsigned char>((res.x >> 8) & 0xFF);
+        header[14] = static_cast<unsigned char>(res.y & 0xFF);
+        header[15] = static_cast<unsigned char>((res.y >> 8) & 0xFF);
+        header[16] = 32; // Bits per pixel
+        header[17] = 8;  // Bits of alpha, with the origin in the bottom-left corner
+
+        std::ofstream file(filename, std::ofstream::binary);
+        file.write(reinterpret_cast<const char*>(header.data()), header.size());
+        file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+    }
+
+    void writePam(const std::string& filename, const glm::ivec2& res,
+                  std::vector<unsigned char>& pixels)
+    {
+        // PAM files store RGBA starting with the top row
+        const size_t rowSize = static_cast<size_t>(res.x) * 4;
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            std::swap(pixels[i], pixels[i + 2]);
+        }
+        for (size_t y = 0; y < static_cast<size_t>(res.y) / 2; ++y) {
+            std::swap_ranges(
+                pixels.begin() + y * rowSize,
+                pixels.begin() + (y + 1) * rowSize,
+                pixels.begin() + (res.y - 1 - y) * rowSize
+            );
+        }
+
+        std::ofstream file(filename, std::ofstream::binary);
+        file << fmt::format(
+            "P7\nWIDTH {}\nHEIGHT {}\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n",
+            res.x, res.y
+        );
+        file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+    }
+} // namespace
+
+namespace openspace {
+
+FrameCapture::FrameCapture() : _workers(numberOfWorkers()) {}
+
+FrameCapture::~FrameCapture() {} // NOLINT
+
+void FrameCapture::initializeGL() {
+    for (Slot& slot : _slots) {
+        glGenBuffers(1, &slot.pbo);
+    }
+}
+
+void FrameCapture::deinitializeGL() {
+    for (size_t i = 0; i < NumSlots; ++i) {
+        Slot& slot = _slots[(_nextSlot + i) % NumSlots];
+        if (slot.fence) {
+            finishCapture(slot);
+        }
+        glDeleteBuffers(1, &slot.pbo);
+        slot.pbo = 0;
+        slot.bufferSize = 0;
+    }
+
+    // The thread pool drops its queue when it is destroyed, so we have to wait until all
+    // images have been written
+    while (_nPendingWrites > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void FrameCapture::capture(std::string filename, Format format) {
+    Slot& slot = _slots[_nextSlot];
+    if (slot.pbo == 0) {
+        return;
+    }
+    if (slot.fence) {
+        // All buffers are in flight, so we have to wait for the oldest one
+        finishCapture(slot);
+    }
+
+    slot.resolution = global::windowDelegate.currentWindowResolution();
+    slot.filename = std::move(filename);
+    slot.format = format;
+    const size_t size = static_cast<size_t>(slot.resolution.x) * slot.resolution.y * 4;
+
+    GLint readFramebuffer = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(GL_BACK);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    if (slot.bufferSize != size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        slot.bufferSize = size;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(
+        0,
+        0,
+        slot.resolution.x,
+        slot.resolution.y,
+        GL_BGRA,
+        GL_UNSIGNED_BYTE,
+        nullptr
+    );
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _nextSlot = (_nextSlot + 1) % NumSlots;
+}
+
+void FrameCapture::update() {
+    for (size_t i = 0; i < NumSlots; ++i) {
+        Slot& slot = _slots[(_nextSlot + i) % NumSlots];
+        if (!slot.fence) {
+            continue;
+        }
+        const GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+            finishCapture(slot);
+        }
+    }
+}
+
+int FrameCapture::nPendingCaptures() const {
+    const int nInFlight = static_cast<int>(std::count_if(
+        _slots.begin(),
+        _slots.end(),
+        [](const Slot& slot) { return slot.fence != nullptr; }
+    ));
+    return nInFlight + _nPendingWrites;
+}
+
+void FrameCapture::finishCapture(Slot& slot) {
+    glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    // Copying the pixels is the only work that is left on the rendering thread. The
+    // buffer can then be reused for the next capture right away
+    // The pixels are shared, as the worker threads copy their tasks
+    auto pixels = std::make_shared<std::vector<unsigned char>>(slot.bufferSize);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    void* data = glMapBufferRange(
+        GL_PIXEL_PACK_BUFFER,
+        0,
+        slot.bufferSize,
+        GL_MAP_READ_BIT
+    );
+    if (data) {
+        std::memcpy(pixels->data(), data, slot.bufferSize);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!data) {
+        LERROR(fmt::format("Could not read back the pixels for {}", slot.filename));
+        return;
+    }
+
+    _nPendingWrites++;
+    _workers.enqueue(
+        [this, filename = slot.filename, format = slot.format, res = slot.resolution,
+         pixels]()
+        {
+            if (format == Format::Pam) {
+                writePam(filename + ".pam", res, *pixels);
+            }
+            else {
+                writeTga(filename + ".tga", res, *pixels);
+            }
+            _nPendingWrites--;
+        }
+    );
+}
+
+} // namespace openspace
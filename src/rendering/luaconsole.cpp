@@ -27,7 +27,10 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/network/parallelpeer.h>
+#include <openspace/properties/propertyowner.h>
 #include <openspace/rendering/helper.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scripting/scriptengine.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -37,6 +40,7 @@
 #include <ghoul/misc/clipboard.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
+#include <algorithm>
 #include <fstream>
 
 namespace {
@@ -441,93 +445,73 @@ bool LuaConsole::keyboardCallback(Key key, KeyModifier modifier, KeyAction actio
     }
 
     if (key == Key::Tab) {
-        // We get a list of all the available commands and initially find the first
-        // command that starts with how much we typed sofar. We store the index so
-        // that in subsequent "tab" presses, we will discard previous commands. This
-        // implements the 'hop-over' behavior. As soon as another key is pressed,
-        // everything is set back to normal
+        // We get the completions of what we typed sofar and store the index of the
+        // completion that was used, so that in subsequent "tab" presses, we will move on
+        // to the following completions. This implements the 'hop-over' behavior. As soon
+        // as another key is pressed, everything is set back to normal
 
         // If the shift key is pressed, we decrement the current index so that we will
         // find the value before the one that was previously found
         if (_autoCompleteInfo.lastIndex != NoAutoComplete && modifierShift) {
             _autoCompleteInfo.lastIndex -= 2;
         }
-        std::vector<std::string> allCommands = global::scriptEngine.allLuaFunctions();
-        std::sort(allCommands.begin(), allCommands.end());
-
-        std::string currentCommand = _commands.at(_activeCommand);
 
         // Check if it is the first time the tab has been pressed. If so, we need to
         // store the already entered command so that we can later start the search
-        // from there. We will overwrite the 'currentCommand' thus making the storage
+        // from there. We will overwrite the current command thus making the storage
         // necessary
         if (!_autoCompleteInfo.hasInitialValue) {
-            _autoCompleteInfo.initialValue = currentCommand;
+            _autoCompleteInfo.initialValue = _commands.at(_activeCommand);
             _autoCompleteInfo.hasInitialValue = true;
         }
-
-        for (int i = 0; i < static_cast<int>(allCommands.size()); ++i) {
-            const std::string& command = allCommands[i];
-
-            // Check if the command has enough length (we don't want crashes here)
-            // Then check if the iterator-command's start is equal to what we want
-            // then check if we need to skip the first found values as the user has
-            // pressed TAB repeatedly
-            const size_t fullLength = _autoCompleteInfo.initialValue.length();
-            const bool correctLength = command.length() >= fullLength;
-
-            std::string commandLowerCase;
-            std::transform(
-                command.begin(), command.end(),
-                std::back_inserter(commandLowerCase),
-                [](char v) { return static_cast<char>(tolower(v)); }
-            );
-
-            std::string initialValueLowerCase;
-            std::transform(
-                _autoCompleteInfo.initialValue.begin(),
-                _autoCompleteInfo.initialValue.end(),
-                std::back_inserter(initialValueLowerCase),
-                [](char v) { return static_cast<char>(tolower(v)); }
-            );
-
-            const bool correctCommand =
-                commandLowerCase.substr(0, fullLength) == initialValueLowerCase;
-
-            if (correctLength && correctCommand && (i > _autoCompleteInfo.lastIndex)) {
-                // We found our index, so store it
-                _autoCompleteInfo.lastIndex = i;
-
-                // We only want to auto-complete until the next separator "."
-                const size_t pos = command.find('.', fullLength);
-                if (pos == std::string::npos) {
-                    // If we don't find a separator, we autocomplete until the end
-                    // Set the found command as active command
-                    _commands.at(_activeCommand) = command + "();";
-                    // Set the cursor position to be between the brackets
-                    _inputPosition = _commands.at(_activeCommand).size() - 2;
-                }
-                else {
-                    // If we find a separator, we autocomplete until and including the
-                    // separator unless the autocompletion would be the same that we
-                    // already have (the case if there are multiple commands in the
-                    // same group
-                    const std::string subCommand = command.substr(0, pos + 1);
-                    if (subCommand == _commands.at(_activeCommand)) {
-                        continue;
-                    }
-                    else {
-                        _commands.at(_activeCommand) = command.substr(0, pos + 1);
-                        _inputPosition = _commands.at(_activeCommand).length();
-                        // We only want to remove the autocomplete info if we just
-                        // entered the 'default' openspace namespace
-                        if (command.substr(0, pos + 1) == "openspace.") {
-                            _autoCompleteInfo = { NoAutoComplete, false, "" };
-                        }
-                    }
+        const std::string& initialValue = _autoCompleteInfo.initialValue;
+
+        // Inside of an unterminated string, the text after the opening quote is completed
+        // as a property URI. Otherwise, the command is completed as a function name
+        size_t stringStart = std::string::npos;
+        for (const char quote : { '"', '\'' }) {
+            if (std::count(initialValue.begin(), initialValue.end(), quote) % 2 == 1) {
+                stringStart = initialValue.rfind(quote);
+            }
+        }
+        const bool isInString = stringStart != std::string::npos;
+
+        // Both completions come from tries that are kept up to date when libraries and
+        // properties are added, so no full list of candidates has to be built here
+        const std::string head =
+            isInString ? initialValue.substr(0, stringStart + 1) : "";
+        const std::vector<PrefixTrie::Completion> completions = isInString ?
+            global::rootPropertyOwner.propertyUriCompletions(
+                std::string_view(initialValue).substr(stringStart + 1)
+            ) :
+            global::scriptEngine.luaFunctionCompletions(initialValue);
+
+        const int index = std::max(_autoCompleteInfo.lastIndex + 1, 0);
+        if (index < static_cast<int>(completions.size())) {
+            const PrefixTrie::Completion& completion = completions[index];
+            _autoCompleteInfo.lastIndex = index;
+
+            std::string& command = _commands.at(_activeCommand);
+            if (!completion.isEntry) {
+                // We autocomplete until and including the next separator
+                command = head + completion.value;
+                _inputPosition = command.length();
+                // If this was the only possible completion, there is nothing to cycle
+                // through, so the next "tab" starts completing the entries within
+                if (completions.size() == 1) {
+                    _autoCompleteInfo = { NoAutoComplete, false, "" };
                 }
-
-                break;
+            }
+            else if (isInString) {
+                // A completed property URI also closes the string
+                command = head + completion.value + initialValue[stringStart];
+                _inputPosition = command.length();
+            }
+            else {
+                // Set the found function as active command with the cursor between the
+                // brackets
+                command = completion.value + "();";
+                _inputPosition = command.size() - 2;
             }
         }
         return true;
@@ -728,7 +712,8 @@ void LuaConsole::render() {
         );
     }
 
-    RenderFont(
+    TextBatcher& batcher = global::renderEngine.textBatcher();
+    batcher.queue(
         *_font,
         inputLocation,
         "> " + currentCommand,
@@ -740,7 +725,7 @@ void LuaConsole::render() {
     inputLocation.y += 3 * dpiScaling.y;
 
     // Render the ^ marker below the text to show where the current entry point is
-    RenderFont(
+    batcher.queue(
         *_font,
         inputLocation,
         (std::string(_inputPosition - nChoppedCharsBeginning + 2, ' ') + "^"),
@@ -765,7 +750,7 @@ void LuaConsole::render() {
     }
 
     for (const std::string& cmd : commandSubset) {
-        RenderFont(
+        batcher.queue(
             *_historyFont,
             historyInputLocation,
             cmd,
@@ -807,13 +792,13 @@ void LuaConsole::render() {
             "Broadcasting script to " + std::to_string(nClients) + " clients";
 
         const glm::vec2 loc = locationForRightJustifiedText(nClientsText);
-        RenderFont(*_font, loc, nClientsText, Red);
+        batcher.queue(*_font, loc, nClientsText, Red);
     } else if (global::parallelPeer.isHost()) {
         const glm::vec4 LightBlue(0.4, 0.4, 1, 1);
 
         const std::string localExecutionText = "Local script execution";
         const glm::vec2 loc = locationForRightJustifiedText(localExecutionText);
-        RenderFont(*_font, loc, localExecutionText, LightBlue);
+        batcher.queue(*_font, loc, localExecutionText, LightBlue);
     }
 }
 
@@ -93,7 +93,7 @@ documentation::Documentation Renderable::Documentation() {
 std::unique_ptr<Renderable> Renderable::createFromDictionary(
                                                       const ghoul::Dictionary& dictionary)
 {
-    documentation::testSpecificationAndThrow(Documentation(), dictionary, "Renderable");
+    documentation::testSpecificationAndThrow(Documentation, dictionary, "Renderable");
 
     std::string renderableType = dictionary.value<std::string>(KeyType);
 
@@ -181,6 +181,14 @@ bool Renderable::renderedWithDesiredData() const {
     return true;
 }
 
+bool Renderable::canReleaseGLResources() const {
+    return false;
+}
+
+void Renderable::releaseGLResources() {}
+
+void Renderable::restoreGLResources() {}
+
 Renderable::RenderBin Renderable::renderBin() const {
     return _renderBin;
 }
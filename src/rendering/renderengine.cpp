@@ -34,20 +34,26 @@
 #include <openspace/mission/missionmanager.h>
 #include <openspace/performance/performancemanager.h>
 #include <openspace/performance/performancemeasurement.h>
+#include <openspace/performance/tracezone.h>
 #include <openspace/rendering/abufferrenderer.h>
 #include <openspace/rendering/dashboard.h>
 #include <openspace/rendering/deferredcastermanager.h>
 #include <openspace/rendering/helper.h>
 #include <openspace/rendering/framebufferrenderer.h>
+#include <openspace/rendering/framecapture.h>
 #include <openspace/rendering/luaconsole.h>
 #include <openspace/rendering/raycastermanager.h>
+#include <openspace/rendering/screenspacebatcher.h>
 #include <openspace/rendering/screenspacerenderable.h>
+#include <openspace/rendering/textbatcher.h>
 #include <openspace/scene/scene.h>
 #include <openspace/scripting/scriptengine.h>
+#include <openspace/util/framememory.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/screenlog.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/util/versionchecker.h>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
@@ -56,6 +62,8 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/stringconversion.h>
 #include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/shaderobject.h>
+#include <ghoul/opengl/shaderpreprocessor.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
 
 #ifdef GHOUL_USE_DEVIL
@@ -75,6 +83,10 @@
 #include <ghoul/io/texture/texturereaderstb.h>
 #endif // GHOUL_USE_STB_IMAGE
 
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
 #include "renderengine_lua.inl"
 
 namespace {
@@ -143,6 +155,26 @@ namespace {
         "interface."
     };
 
+    constexpr openspace::properties::Property::PropertyInfo AsynchronousScreenshotInfo =
+    {
+        "AsynchronousScreenshot",
+        "Asynchronous Screenshots",
+        "If this value is enabled, screenshots are read back a few frames after they "
+        "were requested and are encoded and written by worker threads, so that saving "
+        "many frames, for example during a session playback, does not slow down the "
+        "rendering. The final image of the window is captured, so the warping is always "
+        "applied. The images are written in the 'ScreenshotFormat' into the screenshot "
+        "folder, named with the frame number."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ScreenshotFormatInfo = {
+        "ScreenshotFormat",
+        "Screenshot Format",
+        "The file format of the asynchronous screenshots. Both formats are "
+        "uncompressed, which keeps the encoding cheap enough for recording at full "
+        "frame rate."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo ShowFrameNumberInfo = {
         "ShowFrameNumber",
         "Show Frame Number",
@@ -159,6 +191,32 @@ namespace {
         "master node is not required and performance can be gained by disabling it."
     };
 
+    constexpr openspace::properties::Property::PropertyInfo SceneCullingInfo = {
+        "SceneCulling",
+        "Scene Culling",
+        "If this value is enabled, scene graph nodes whose bounding spheres are entirely "
+        "outside the view frustum are not rendered. Disabling it renders every enabled "
+        "node, which is mainly useful for debugging missing bounding spheres."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo OcclusionCullingInfo = {
+        "OcclusionCulling",
+        "Occlusion Culling",
+        "If this value is enabled, scene graph nodes and globe chunks that were hidden "
+        "behind opaque geometry in the previous frames are not rendered. Objects that "
+        "become visible when the camera moves quickly can appear a few frames late."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PipelinedSceneUpdateInfo = {
+        "PipelinedSceneUpdate",
+        "Pipelined Scene Update",
+        "If this value is enabled, the translations, rotations, and scales of the next "
+        "frame are computed on worker threads while the current frame is rendered, "
+        "which hides their cost on machines with many cores. This only applies to "
+        "transformations that are thread-safe and as long as the simulation time "
+        "advances predictably."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo GlobalRotationInfo = {
         "GlobalRotation",
         "Global Rotation",
@@ -211,6 +269,146 @@ namespace {
         "tristimulus values in the image."
     };
 
+    constexpr openspace::properties::Property::PropertyInfo AdaptiveRaycastInfo = {
+        "AdaptiveRaycastResolution",
+        "Adaptive Raycast Resolution",
+        "If this value is enabled, volumes are raycast at a reduced resolution while the "
+        "camera is moving and are refined to their full resolution once it stops."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo RaycastMotionDownscaleInfo =
+    {
+        "RaycastMotionDownscale",
+        "Raycast Motion Downscale",
+        "The factor by which the resolution of the volume raycasting is reduced while "
+        "the camera is moving, if the adaptive raycast resolution is enabled."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo CombinedRaycastingInfo = {
+        "CombinedRaycasting",
+        "Combined Raycasting",
+        "If this value is enabled, all volumes are raycast together in a single pass, "
+        "which composites overlapping volumes in the correct order. Otherwise, each "
+        "volume is raycast separately and blended on top of the volumes before it."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ResolvedDeferredShadingInfo =
+    {
+        "ResolvedDeferredShading",
+        "Resolved Deferred Shading",
+        "If this value is enabled, the multisampled geometry buffers are resolved before "
+        "the deferred effects, such as atmospheres, are applied. These effects are then "
+        "computed once per pixel and only the pixels on the edges of objects are "
+        "computed for every antialiasing sample."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PostProcessAntialiasingInfo =
+    {
+        "PostProcessAntialiasing",
+        "Post-process Antialiasing",
+        "If this value is enabled, the edges in the final image are smoothed by a "
+        "filter. This is an inexpensive alternative to increasing the number of "
+        "antialiasing samples, for example in combination with a single sample."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo BackgroundCacheInfo = {
+        "BackgroundCache",
+        "Background Cache",
+        "If this value is enabled, the objects in the background render bin are "
+        "rendered into a cube map around the camera that is reused for as long as the "
+        "camera does not move further than the background cache distance. Changes to "
+        "the properties of these objects only become visible once the cube map is "
+        "rendered again, which also happens when one of them is enabled or disabled."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo
+    BackgroundCacheResolutionInfo =
+    {
+        "BackgroundCacheResolution",
+        "Background Cache Resolution",
+        "The resolution in pixels of each of the faces of the background cube map."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo BackgroundCacheDistanceInfo =
+    {
+        "BackgroundCacheDistance",
+        "Background Cache Distance",
+        "The distance in meters that the camera can move before the background cube map "
+        "is rendered again."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ResolutionScaleInfo = {
+        "ResolutionScale",
+        "Resolution Scale",
+        "The fraction of the window resolution in each dimension at which the scene is "
+        "rendered before it is upscaled to the window. This value is adjusted "
+        "automatically if the dynamic resolution is enabled."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo DynamicResolutionInfo = {
+        "DynamicResolution",
+        "Dynamic Resolution",
+        "If this value is enabled, the resolution scale is continuously adjusted so that "
+        "the GPU time spent rendering the scene stays within the target frame time. The "
+        "GPU time is not measured while performance measurements are enabled, in which "
+        "case the resolution scale is kept as it is."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo TargetFrameTimeInfo = {
+        "TargetFrameTime",
+        "Target Frame Time (ms)",
+        "The GPU time in milliseconds that the dynamic resolution aims to spend on "
+        "rendering the scene each frame. To hold the vertical synchronization, this "
+        "should be a bit below the refresh interval of the display."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MinimumResolutionScaleInfo =
+    {
+        "MinimumResolutionScale",
+        "Minimum Resolution Scale",
+        "The lowest resolution scale that the dynamic resolution will use."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo FragmentBufferBudgetInfo = {
+        "FragmentBufferBudget",
+        "Fragment Buffer Budget",
+        "The maximum amount of memory in megabytes that the A-buffer renderer uses to "
+        "store transparent fragments. Fragments that do not fit are blended in an "
+        "order-independent approximation instead."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo OnDemandRenderingInfo = {
+        "OnDemandRendering",
+        "On-demand Rendering",
+        "If this value is enabled, the scene is only rendered while something changes, "
+        "such as the camera, the simulation time, a property, or incoming user input. "
+        "Otherwise the last frame is presented again, which reduces the load on the GPU "
+        "of unattended installations. Screen space renderables and overlays are still "
+        "drawn in every frame. This only takes effect if a single view is rendered."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo OnDemandRenderingDelayInfo =
+    {
+        "OnDemandRenderingDelay",
+        "On-demand Rendering Delay",
+        "The time in seconds that the scene continues to be rendered after the last "
+        "change before the last frame is presented again. This covers animations that "
+        "continue for a while after a change, such as fading or streaming data."
+    };
+
+    // The resolution scale is changed in steps of this size to avoid that the image is
+    // resampled with a slightly different scale in every frame
+    constexpr const float ResolutionScaleStep = 0.05f;
+
+    // The GPU time has to be below this fraction of the target before the scale is
+    // increased again, so that it does not oscillate around the target
+    constexpr const double ResolutionScaleHysteresis = 0.85;
+
+    // The number of frames to wait after a change before the next one, which covers
+    // the latency of the GPU timer queries
+    constexpr const int ResolutionScaleCooldown =
+        openspace::performance::GpuTimer::NQueries + 4;
+
     constexpr openspace::properties::Property::PropertyInfo HorizFieldOfViewInfo = {
         "HorizFieldOfView",
         "Horizontal Field of View",
@@ -225,6 +423,156 @@ namespace {
         "The blackout factor of the rendering. This can be used for fading in or out the "
         "rendering window"
     };
+
+    // Increase this number whenever the layout of the cached program binaries changes
+    constexpr const int8_t ProgramBinaryCacheVersion = 1;
+
+    using ShaderFile = std::pair<ghoul::opengl::ShaderObject::ShaderType, std::string>;
+
+    bool isProgramBinarySupported() {
+        // Program binaries are part of OpenGL 4.1. On older contexts the query fails and
+        // leaves the number at 0
+        static const bool IsSupported = []() {
+            GLint nFormats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nFormats);
+            return nFormats > 0;
+        }();
+        return IsSupported;
+    }
+
+    // Returns the cache file for the program built from the shaders with the provided
+    // dictionary. The key covers the preprocessed sources, including all included files
+    // and defines, as well as the driver, since a binary is only valid for the driver
+    // that created it
+    std::string programBinaryCacheFile(const std::vector<ShaderFile>& shaders,
+                                       const ghoul::Dictionary& dictionary)
+    {
+        std::string key;
+        for (GLenum e : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+            key += reinterpret_cast<const char*>(glGetString(e));
+        }
+        for (const ShaderFile& s : shaders) {
+            std::string source;
+            ghoul::opengl::ShaderPreprocessor(absPath(s.second), dictionary).process(
+                source
+            );
+            key += source;
+        }
+
+        return FileSys.cacheManager()->cachedFilename(
+            "programbinary",
+            std::to_string(std::hash<std::string>()(key)),
+            ghoul::filesystem::CacheManager::Persistent::Yes
+        );
+    }
+
+    bool loadProgramBinary(GLuint program, const std::string& file) {
+        std::ifstream f(file, std::ifstream::binary);
+        if (!f.good()) {
+            return false;
+        }
+
+        int8_t version = 0;
+        f.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+        if (version != ProgramBinaryCacheVersion) {
+            return false;
+        }
+
+        GLenum format;
+        f.read(reinterpret_cast<char*>(&format), sizeof(GLenum));
+        int32_t size = 0;
+        f.read(reinterpret_cast<char*>(&size), sizeof(int32_t));
+        std::vector<char> binary(size);
+        f.read(binary.data(), size);
+        if (!f.good()) {
+            return false;
+        }
+
+        // The driver rejects binaries that it cannot use, for example after an update,
+        // in which case the program is built from the sources instead
+        glProgramBinary(program, format, binary.data(), size);
+        GLint status = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        return status != 0;
+    }
+
+    void saveProgramBinary(GLuint program, const std::string& file) {
+        GLint size = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+        if (size <= 0) {
+            return;
+        }
+
+        std::vector<char> binary(size);
+        GLsizei length = 0;
+        GLenum format;
+        glGetProgramBinary(program, size, &length, &format, binary.data());
+        const int32_t s = static_cast<int32_t>(length);
+
+        // The nodes of a cluster might share the cache directory, so the file is written
+        // under a unique name first and moved into place when it is complete
+        const std::string tmpFile = fmt::format(
+            "{}.{}", file, std::chrono::system_clock::now().time_since_epoch().count()
+        );
+        {
+            std::ofstream f(tmpFile, std::ofstream::binary);
+            f.write(reinterpret_cast<const char*>(&ProgramBinaryCacheVersion), 1);
+            f.write(reinterpret_cast<const char*>(&format), sizeof(GLenum));
+            f.write(reinterpret_cast<const char*>(&s), sizeof(int32_t));
+            f.write(binary.data(), s);
+        }
+        if (std::rename(tmpFile.c_str(), file.c_str()) != 0) {
+            std::remove(tmpFile.c_str());
+        }
+    }
+
+    // Builds the program from the shader files, reusing the binary of a previous build
+    // of the same sources with the same driver if one is available
+    std::unique_ptr<ghoul::opengl::ProgramObject> buildProgram(const std::string& name,
+                                                   const std::vector<ShaderFile>& shaders,
+                                                         const ghoul::Dictionary& dict)
+    {
+        using namespace ghoul::opengl;
+
+        std::unique_ptr<ProgramObject> program = std::make_unique<ProgramObject>(name);
+        program->setDictionary(dict);
+        for (const ShaderFile& s : shaders) {
+            program->attachObject(std::make_shared<ShaderObject>(
+                s.first,
+                absPath(s.second),
+                name,
+                dict
+            ));
+        }
+
+        std::string cacheFile;
+        if (isProgramBinarySupported()) {
+            try {
+                cacheFile = programBinaryCacheFile(shaders, dict);
+            }
+            catch (const ghoul::RuntimeError& e) {
+                // The compilation below will report the problem with the shader
+                LDEBUGC(e.component, e.message);
+            }
+        }
+
+        // The shader objects stay attached, so a program that was loaded from the cache
+        // is rebuilt from its sources as usual when one of the files changes
+        if (!cacheFile.empty() && loadProgramBinary(*program, cacheFile)) {
+            return program;
+        }
+
+        if (!cacheFile.empty()) {
+            glProgramParameteri(*program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, 1);
+        }
+        program->compileShaderObjects();
+        program->linkProgramObject();
+
+        if (!cacheFile.empty()) {
+            saveProgramBinary(*program, cacheFile);
+        }
+        return program;
+    }
 } // namespace
 
 
@@ -239,13 +587,34 @@ RenderEngine::RenderEngine()
     , _showCameraInfo(ShowCameraInfo, true)
     , _takeScreenshot(TakeScreenshotInfo)
     , _applyWarping(ApplyWarpingInfo, false)
+    , _asynchronousScreenshot(AsynchronousScreenshotInfo, false)
+    , _screenshotFormat(ScreenshotFormatInfo)
+    , _frameCapture(std::make_unique<FrameCapture>())
+    , _textBatcher(std::make_unique<TextBatcher>())
+    , _screenSpaceBatcher(std::make_unique<ScreenSpaceBatcher>())
     , _showFrameNumber(ShowFrameNumberInfo, false)
     , _disableMasterRendering(DisableMasterInfo, false)
+    , _sceneCulling(SceneCullingInfo, true)
+    , _occlusionCulling(OcclusionCullingInfo, false)
+    , _pipelinedSceneUpdate(PipelinedSceneUpdateInfo, false)
     , _globalBlackOutFactor(GlobalBlackoutFactorInfo, 1.f, 0.f, 1.f)
     , _nAaSamples(AaSamplesInfo, 4, 1, 8)
     , _hdrExposure(HDRExposureInfo, 0.4f, 0.01f, 10.0f)
     , _hdrBackground(BackgroundExposureInfo, 2.8f, 0.01f, 10.0f)
     , _gamma(GammaInfo, 2.2f, 0.01f, 10.0f)
+    , _adaptiveRaycastResolution(AdaptiveRaycastInfo, false)
+    , _raycastMotionDownscale(RaycastMotionDownscaleInfo, 0.5f, 0.1f, 1.f)
+    , _combinedRaycasting(CombinedRaycastingInfo, true)
+    , _resolvedDeferredShading(ResolvedDeferredShadingInfo, false)
+    , _postProcessAntialiasing(PostProcessAntialiasingInfo, false)
+    , _backgroundCache(BackgroundCacheInfo, false)
+    , _backgroundCacheResolution(BackgroundCacheResolutionInfo, 1024, 128, 4096)
+    , _backgroundCacheDistance(BackgroundCacheDistanceInfo, 1e12f, 0.f, 1e20f)
+    , _resolutionScale(ResolutionScaleInfo, 1.f, 0.25f, 1.f)
+    , _dynamicResolution(DynamicResolutionInfo, false)
+    , _targetFrameTime(TargetFrameTimeInfo, 14.f, 1.f, 100.f)
+    , _minimumResolutionScale(MinimumResolutionScaleInfo, 0.5f, 0.25f, 1.f)
+    , _fragmentBufferBudget(FragmentBufferBudgetInfo, 512, 16, 8192)
     , _globalRotation(
         GlobalRotationInfo,
         glm::vec3(0.f),
@@ -265,6 +634,8 @@ RenderEngine::RenderEngine()
         glm::vec3(glm::pi<float>())
     )
     , _horizFieldOfView(HorizFieldOfViewInfo, 80.f, 1.f, 179.0f)
+    , _onDemandRendering(OnDemandRenderingInfo, false)
+    , _onDemandRenderingDelay(OnDemandRenderingDelayInfo, 2.f, 0.f, 60.f)
 {
     _doPerformanceMeasurements.onChange([this](){
         global::performanceManager.setEnabled(_doPerformanceMeasurements);
@@ -304,6 +675,84 @@ RenderEngine::RenderEngine()
     });
     addProperty(_gamma);
 
+    _adaptiveRaycastResolution.onChange([this]() {
+        if (_renderer) {
+            _renderer->setAdaptiveRaycastResolution(_adaptiveRaycastResolution);
+        }
+    });
+    addProperty(_adaptiveRaycastResolution);
+
+    _raycastMotionDownscale.onChange([this]() {
+        if (_renderer) {
+            _renderer->setRaycastMotionDownscale(_raycastMotionDownscale);
+        }
+    });
+    addProperty(_raycastMotionDownscale);
+
+    _combinedRaycasting.onChange([this]() {
+        if (_renderer) {
+            _renderer->setCombinedRaycasting(_combinedRaycasting);
+        }
+    });
+    addProperty(_combinedRaycasting);
+
+    _resolvedDeferredShading.onChange([this]() {
+        if (_renderer) {
+            _renderer->setResolvedDeferredShading(_resolvedDeferredShading);
+        }
+    });
+    addProperty(_resolvedDeferredShading);
+
+    _postProcessAntialiasing.onChange([this]() {
+        if (_renderer) {
+            _renderer->setPostProcessAntialiasing(_postProcessAntialiasing);
+        }
+    });
+    addProperty(_postProcessAntialiasing);
+
+    _backgroundCache.onChange([this]() {
+        if (_renderer) {
+            _renderer->setBackgroundCache(_backgroundCache);
+        }
+    });
+    addProperty(_backgroundCache);
+
+    _backgroundCacheResolution.onChange([this]() {
+        if (_renderer) {
+            _renderer->setBackgroundCacheResolution(_backgroundCacheResolution);
+        }
+    });
+    addProperty(_backgroundCacheResolution);
+
+    _backgroundCacheDistance.onChange([this]() {
+        if (_renderer) {
+            _renderer->setBackgroundCacheDistance(_backgroundCacheDistance);
+        }
+    });
+    addProperty(_backgroundCacheDistance);
+
+    _resolutionScale.onChange([this]() {
+        if (_renderer) {
+            _renderer->setResolutionScale(_resolutionScale);
+        }
+    });
+    addProperty(_resolutionScale);
+
+    _dynamicResolution.onChange([this]() {
+        _resolutionController.smoothedTime = 0.0;
+        _resolutionController.framesSinceChange = 0;
+    });
+    addProperty(_dynamicResolution);
+    addProperty(_targetFrameTime);
+    addProperty(_minimumResolutionScale);
+
+    _fragmentBufferBudget.onChange([this]() {
+        if (_renderer) {
+            _renderer->setFragmentBufferBudget(_fragmentBufferBudget);
+        }
+    });
+    addProperty(_fragmentBufferBudget);
+
     addProperty(_globalBlackOutFactor);
     addProperty(_applyWarping);
 
@@ -317,12 +766,38 @@ RenderEngine::RenderEngine()
     _takeScreenshot.onChange([this](){ _shouldTakeScreenshot = true; });
     addProperty(_takeScreenshot);
 
+    addProperty(_asynchronousScreenshot);
+    _screenshotFormat.addOptions({
+        { static_cast<int>(FrameCapture::Format::Tga), "TGA" },
+        { static_cast<int>(FrameCapture::Format::Pam), "PAM" }
+    });
+    addProperty(_screenshotFormat);
+
     addProperty(_showFrameNumber);
 
     addProperty(_globalRotation);
     addProperty(_screenSpaceRotation);
     addProperty(_masterRotation);
     addProperty(_disableMasterRendering);
+    addProperty(_sceneCulling);
+
+    _occlusionCulling.onChange([this]() {
+        if (_renderer) {
+            _renderer->setOcclusionCulling(_occlusionCulling);
+        }
+    });
+    addProperty(_occlusionCulling);
+
+    addProperty(_pipelinedSceneUpdate);
+
+    _onDemandRendering.onChange([this]() {
+        if (_renderer) {
+            _renderer->setKeepLastFrame(_onDemandRendering);
+        }
+        requestRedraw();
+    });
+    addProperty(_onDemandRendering);
+    addProperty(_onDemandRenderingDelay);
 }
 
 RenderEngine::~RenderEngine() {} // NOLINT
@@ -428,6 +903,11 @@ void RenderEngine::initializeGL() {
     constexpr const float FontSizeLight = 8.f;
     _fontLog = global::fontManager.font(KeyFontLight, FontSizeLight);
 
+    _frameCapture->initializeGL();
+    _textBatcher->initializeGL();
+    _textBatcher->setFramebufferSize(fontResolution());
+    _screenSpaceBatcher->initializeGL();
+
     LINFO("Initializing Log");
     std::unique_ptr<ScreenLog> log = std::make_unique<ScreenLog>(ScreenLogTimeToLive);
     _log = log.get();
@@ -438,6 +918,10 @@ void RenderEngine::initializeGL() {
 }
 
 void RenderEngine::deinitializeGL() {
+    _resolutionController.timer.deinitialize();
+    _frameCapture->deinitializeGL();
+    _textBatcher->deinitializeGL();
+    _screenSpaceBatcher->deinitializeGL();
     _renderer = nullptr;
 }
 
@@ -455,12 +939,32 @@ void RenderEngine::updateScene() {
         { glm::dvec3(0.0), glm::dmat3(11.), 1.0 },
         currentTime,
         integrateFromTime,
-        _doPerformanceMeasurements
+        _doPerformanceMeasurements,
+        global::frameMemory.resource()
     });
 
     LTRACE("RenderEngine::updateSceneGraph(end)");
 }
 
+bool RenderEngine::isPipelinedSceneUpdateEnabled() const {
+    // The per-node timings would include the prefetched work of the previous frame
+    return _pipelinedSceneUpdate && !_doPerformanceMeasurements;
+}
+
+void RenderEngine::prefetchScene(double nextTime) {
+    if (!_scene) {
+        return;
+    }
+
+    // The next frame integrates from the time of this frame
+    _scene->prefetchTransforms({
+        { glm::dvec3(0.0), glm::dmat3(1.0), 1.0 },
+        Time(nextTime),
+        global::timeManager.time(),
+        false
+    });
+}
+
 void RenderEngine::updateShaderPrograms() {
     for (ghoul::opengl::ProgramObject* program : _programs) {
         try {
@@ -483,12 +987,52 @@ void RenderEngine::updateRenderer() {
         using FR = ghoul::fontrendering::FontRenderer;
         FR::defaultRenderer().setFramebufferSize(fontResolution());
         FR::defaultProjectionRenderer().setFramebufferSize(renderingResolution());
+        _textBatcher->setFramebufferSize(fontResolution());
         //Override the aspect ratio property value to match that of resized window
         _horizFieldOfView =
             static_cast<float>(global::windowDelegate.getHorizFieldOfView());
     }
 
     _renderer->update();
+
+    updateIdleState(windowResized);
+}
+
+void RenderEngine::updateIdleState(bool windowResized) {
+    if (!_onDemandRendering) {
+        _idleDetection.isIdle = false;
+        return;
+    }
+
+    const uint64_t propertyChangeCount = properties::Property::changeCount();
+    const double time = global::timeManager.time().j2000Seconds();
+
+    bool hasChanged = _idleDetection.isRedrawRequested.exchange(false) ||
+        windowResized || _idleDetection.hasMultipleViews ||
+        propertyChangeCount != _idleDetection.propertyChangeCount ||
+        time != _idleDetection.time;
+    _idleDetection.propertyChangeCount = propertyChangeCount;
+    _idleDetection.time = time;
+
+    if (_camera) {
+        const glm::dvec3& position = _camera->positionVec3();
+        const glm::dquat& rotation = _camera->rotationQuaternion();
+        hasChanged |= (position != _idleDetection.cameraPosition) ||
+                      (rotation != _idleDetection.cameraRotation);
+        _idleDetection.cameraPosition = position;
+        _idleDetection.cameraRotation = rotation;
+    }
+
+    const double now = global::windowDelegate.applicationTime();
+    if (hasChanged) {
+        _idleDetection.lastChangeTime = now;
+    }
+    _idleDetection.isIdle = (now - _idleDetection.lastChangeTime) >
+                            static_cast<double>(_onDemandRenderingDelay);
+}
+
+void RenderEngine::requestRedraw() {
+    _idleDetection.isRedrawRequested = true;
 }
 
 void RenderEngine::updateScreenSpaceRenderables() {
@@ -557,6 +1101,7 @@ void RenderEngine::render(const glm::mat4& sceneMatrix, const glm::mat4& viewMat
                           const glm::mat4& projectionMatrix)
 {
     LTRACE("RenderEngine::render(begin)");
+    PerfTrace("RenderEngine::render");
 
     const WindowDelegate& delegate = global::windowDelegate;
 
@@ -570,16 +1115,47 @@ void RenderEngine::render(const glm::mat4& sceneMatrix, const glm::mat4& viewMat
         );
         _camera->sgctInternal.setSceneMatrix(combinedGlobalRot * sceneMatrix);
         _camera->sgctInternal.setProjectionMatrix(projectionMatrix);
-        _camera->invalidateCache();
     }
 
     const bool masterEnabled = delegate.isMaster() ? !_disableMasterRendering : true;
-    if (masterEnabled && !delegate.isGuiWindow() && _globalBlackOutFactor > 0.f) {
+    const bool isSceneRendered =
+        masterEnabled && !delegate.isGuiWindow() && _globalBlackOutFactor > 0.f;
+    if (isSceneRendered) {
+        ++_idleDetection.nViews;
+        // Each window renders into its own framebuffers, but shares all other resources
+        _renderer->setWindow(delegate.currentWindowId(), renderingResolution());
+    }
+
+    // The last frame is only presented if the renderer has kept a valid copy of it
+    const bool isLastFramePresented =
+        isSceneRendered && _idleDetection.isIdle && _renderer->presentLastFrame();
+
+    if (isSceneRendered && !isLastFramePresented) {
+        if (_scene) {
+            _scene->cull(_camera, _sceneCulling, _renderer->depthPyramid());
+        }
+
+        // The per-node performance measurements use their own elapsed time queries,
+        // which cannot be nested inside of this one
+        if (_resolutionController.windowId == -1) {
+            _resolutionController.windowId = delegate.currentWindowId();
+        }
+        const bool measureGpuTime =
+            (_dynamicResolution || global::performanceManager.isRecordingFrameTimes()) &&
+            !global::performanceManager.isEnabled() &&
+            delegate.currentWindowId() == _resolutionController.windowId;
+        if (measureGpuTime) {
+            _resolutionController.timer.begin();
+            ++_resolutionController.nViews;
+        }
         _renderer->render(
             _scene,
             _camera,
             _globalBlackOutFactor
         );
+        if (measureGpuTime) {
+            _resolutionController.timer.end();
+        }
     }
 
     if (_showFrameNumber) {
@@ -593,7 +1169,7 @@ void RenderEngine::render(const glm::mat4& sceneMatrix, const glm::mat4& viewMat
 
     ++_frameNumber;
 
-    if (masterEnabled && !delegate.isGuiWindow() && _globalBlackOutFactor > 0.f) {
+    if (isSceneRendered) {
         std::vector<ScreenSpaceRenderable*> ssrs;
         ssrs.reserve(global::screenSpaceRenderables.size());
         for (const std::unique_ptr<ScreenSpaceRenderable>& ssr :
@@ -617,9 +1193,11 @@ void RenderEngine::render(const glm::mat4& sceneMatrix, const glm::mat4& viewMat
         glDisable(GL_DEPTH_TEST);
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // The renderables only queue their planes, which are then composited together
         for (ScreenSpaceRenderable* ssr : ssrs) {
             ssr->render();
         }
+        _screenSpaceBatcher->flush(_scene->camera()->viewProjectionMatrix());
         glDisable(GL_BLEND);
     }
     LTRACE("RenderEngine::render(end)");
@@ -690,6 +1268,14 @@ void RenderEngine::renderOverlays(const ShutdownInformation& shutdownInfo) {
     }
 }
 
+TextBatcher& RenderEngine::textBatcher() {
+    return *_textBatcher;
+}
+
+ScreenSpaceBatcher& RenderEngine::screenSpaceBatcher() {
+    return *_screenSpaceBatcher;
+}
+
 void RenderEngine::renderEndscreen() {
     glEnable(GL_BLEND);
 
@@ -726,19 +1312,21 @@ void RenderEngine::renderShutdownInformation(float timer, float fullTime) {
         fontResolution().y - size.boundingBox.y
     );
 
-    RenderFont(
+    _textBatcher->queue(
         *_fontDate,
         penPosition,
         fmt::format("Shutdown in: {:.2f}s/{:.2f}s", timer, fullTime),
+        glm::vec4(1.f),
         ghoul::fontrendering::CrDirection::Down
     );
 
-    RenderFont(
+    _textBatcher->queue(
         *_fontDate,
         penPosition,
         // Important: length of this string is the same as the shutdown time text
         // to make them align
         "Press ESC again to abort",
+        glm::vec4(1.f),
         ghoul::fontrendering::CrDirection::Down
     );
 }
@@ -763,7 +1351,7 @@ void RenderEngine::renderDashboard() {
     glm::dvec3 p = _camera->positionVec3();
     glm::dquat rot = _camera->rotationQuaternion();
     std::string fc = global::navigationHandler.focusNode()->identifier();
-    RenderFont(
+    _textBatcher->queue(
         *_fontInfo,
         penPosition,
         fmt::format("Pos: {} {} {}\nOrientation: {} {} {} {}\nFocus: {}",
@@ -785,9 +1373,24 @@ void RenderEngine::postDraw() {
             );
         }
 
-        global::windowDelegate.takeScreenshot(_applyWarping);
+        if (_asynchronousScreenshot) {
+            _frameCapture->capture(
+                absPath(fmt::format("${{SCREENSHOTS}}/OpenSpace_{:06d}", _frameNumber)),
+                static_cast<FrameCapture::Format>(_screenshotFormat.value())
+            );
+        }
+        else {
+            global::windowDelegate.takeScreenshot(_applyWarping);
+        }
         _shouldTakeScreenshot = false;
     }
+    _frameCapture->update();
+    _frameTimeRegression.update();
+
+    _idleDetection.hasMultipleViews = _idleDetection.nViews > 1;
+    _idleDetection.nViews = 0;
+
+    updateResolutionScale();
 
     if (global::performanceManager.isEnabled()) {
         global::performanceManager.storeScenePerformanceMeasurements(
@@ -796,6 +1399,70 @@ void RenderEngine::postDraw() {
     }
 }
 
+void RenderEngine::updateResolutionScale() {
+    const int nViews = _resolutionController.nViews;
+    _resolutionController.nViews = 0;
+    ++_resolutionController.framesSinceChange;
+
+    const long long result = _resolutionController.timer.latestResult();
+    const unsigned long long nResults = _resolutionController.timer.nResults();
+    const bool isNewResult = nResults != _resolutionController.nResults;
+    _resolutionController.nResults = nResults;
+    if (nViews == 0 || result == 0) {
+        return;
+    }
+
+    // The latest result is for a single view, but all views count towards the frame
+    const double frameTime = static_cast<double>(result) * nViews / 1e6;
+    if (isNewResult) {
+        global::performanceManager.storeGpuFrameTime(frameTime);
+    }
+    if (!_dynamicResolution) {
+        return;
+    }
+
+    double& smoothed = _resolutionController.smoothedTime;
+    smoothed = (smoothed == 0.0) ? frameTime : glm::mix(smoothed, frameTime, 0.1);
+
+    if (_resolutionController.framesSinceChange < ResolutionScaleCooldown) {
+        return;
+    }
+
+    const double target = _targetFrameTime;
+    if (smoothed <= target && smoothed >= target * ResolutionScaleHysteresis) {
+        return;
+    }
+
+    // The GPU time is roughly proportional to the number of pixels, so the scale of
+    // each dimension goes with the square root of the time ratio
+    // It is decreased to the scale that meets the target right away, as a too high
+    // scale drops frames, but only increased one step at a time
+    const float current = _resolutionScale;
+    float scale = current + ResolutionScaleStep;
+    if (smoothed > target) {
+        const float desired = current * static_cast<float>(std::sqrt(target / smoothed));
+        scale = std::floor(desired / ResolutionScaleStep) * ResolutionScaleStep;
+    }
+    scale = glm::clamp(
+        std::round(scale / ResolutionScaleStep) * ResolutionScaleStep,
+        _minimumResolutionScale.value(),
+        1.f
+    );
+
+    if (scale != current) {
+        _resolutionScale = scale;
+        _resolutionController.framesSinceChange = 0;
+        // The measurements in flight were made at the previous scale
+        smoothed = 0.0;
+    }
+}
+
+bool RenderEngine::startFrameTimeRegression(
+                                     performance::FrameTimeRegression::Settings settings)
+{
+    return _frameTimeRegression.start(std::move(settings));
+}
+
 Scene* RenderEngine::scene() {
     return _scene;
 }
@@ -843,11 +1510,13 @@ std::unique_ptr<ghoul::opengl::ProgramObject> RenderEngine::buildRenderProgram(
     dict.setValue("fragmentPath", std::move(fsPath));
 
     using namespace ghoul::opengl;
-    std::unique_ptr<ProgramObject> program = ProgramObject::Build(
+    std::unique_ptr<ProgramObject> program = buildProgram(
         name,
-        vsPath,
-        absPath(RenderFsPath),
-        std::move(dict)
+        {
+            { ShaderObject::ShaderType::Vertex, vsPath },
+            { ShaderObject::ShaderType::Fragment, RenderFsPath }
+        },
+        dict
     );
 
     if (program) {
@@ -875,12 +1544,14 @@ std::unique_ptr<ghoul::opengl::ProgramObject> RenderEngine::buildRenderProgram(
     dict.setValue("fragmentPath", std::move(fsPath));
 
     using namespace ghoul::opengl;
-    std::unique_ptr<ProgramObject> program = ProgramObject::Build(
+    std::unique_ptr<ProgramObject> program = buildProgram(
         name,
-        vsPath,
-        absPath(RenderFsPath),
-        csPath,
-        std::move(dict)
+        {
+            { ShaderObject::ShaderType::Vertex, vsPath },
+            { ShaderObject::ShaderType::Fragment, RenderFsPath },
+            { ShaderObject::ShaderType::Geometry, csPath }
+        },
+        dict
     );
 
     if (program) {
@@ -966,6 +1637,18 @@ void RenderEngine::setRenderer(std::unique_ptr<Renderer> renderer) {
     _renderer->setResolution(renderingResolution());
     _renderer->setNAaSamples(_nAaSamples);
     _renderer->setHDRExposure(_hdrExposure);
+    _renderer->setAdaptiveRaycastResolution(_adaptiveRaycastResolution);
+    _renderer->setRaycastMotionDownscale(_raycastMotionDownscale);
+    _renderer->setCombinedRaycasting(_combinedRaycasting);
+    _renderer->setResolvedDeferredShading(_resolvedDeferredShading);
+    _renderer->setPostProcessAntialiasing(_postProcessAntialiasing);
+    _renderer->setBackgroundCache(_backgroundCache);
+    _renderer->setBackgroundCacheResolution(_backgroundCacheResolution);
+    _renderer->setBackgroundCacheDistance(_backgroundCacheDistance);
+    _renderer->setResolutionScale(_resolutionScale);
+    _renderer->setFragmentBufferBudget(_fragmentBufferBudget);
+    _renderer->setOcclusionCulling(_occlusionCulling);
+    _renderer->setKeepLastFrame(_onDemandRendering);
     _renderer->initialize();
 }
 
@@ -996,6 +1679,36 @@ scripting::LuaLibrary RenderEngine::luaLibrary() {
                 "Given a ScreenSpaceRenderable name this script will remove it from the "
                 "renderengine"
             },
+            {
+                "startTracing",
+                &luascriptfunctions::startTracing,
+                {},
+                "",
+                "Starts recording a timeline of the trace zones of all threads. The "
+                "events of a previous trace are discarded"
+            },
+            {
+                "stopTracing",
+                &luascriptfunctions::stopTracing,
+                {},
+                "string",
+                "Stops recording the timeline and writes it to the provided file in the "
+                "Chrome trace event format, which can be opened in chrome://tracing or "
+                "Perfetto. On a cluster, every node writes its own file"
+            },
+            {
+                "runFrameTimeRegression",
+                &luascriptfunctions::runFrameTimeRegression,
+                {},
+                "string, int, string [, string, bool]",
+                "Plays back the session recording with the provided name at a fixed pace "
+                "of the provided number of frames per second and writes the percentiles "
+                "of the CPU time of each frame phase and of the GPU time to the JSON "
+                "file at the third argument. If a threshold file is provided as fourth "
+                "argument, the percentiles are compared against it and the result is "
+                "stored in the output file. If the last argument is 'true', the "
+                "application quits after the results have been written"
+            },
         },
     };
 }
@@ -1124,7 +1837,7 @@ void RenderEngine::renderCameraInformation() {
         rotationBox.boundingBox.x,
         rotationBox.boundingBox.y
     };
-    FR::defaultRenderer().render(
+    _textBatcher->queue(
         *_fontInfo,
         glm::vec2(fontResolution().x - rotationBox.boundingBox.x - XSeparation, penPosY),
         "Rotation",
@@ -1143,7 +1856,7 @@ void RenderEngine::renderCameraInformation() {
         zoomBox.boundingBox.x,
         zoomBox.boundingBox.y
     };
-    FR::defaultRenderer().render(
+    _textBatcher->queue(
         *_fontInfo,
         glm::vec2(fontResolution().x - zoomBox.boundingBox.x - XSeparation, penPosY),
         "Zoom",
@@ -1162,7 +1875,7 @@ void RenderEngine::renderCameraInformation() {
         rollBox.boundingBox.x,
         rollBox.boundingBox.y
     };
-    FR::defaultRenderer().render(
+    _textBatcher->queue(
         *_fontInfo,
         glm::vec2(fontResolution().x - rollBox.boundingBox.x - XSeparation, penPosY),
         "Roll",
@@ -1205,7 +1918,7 @@ void RenderEngine::renderVersionInformation() {
         fmt::format("{}@{}", OPENSPACE_GIT_BRANCH, OPENSPACE_GIT_COMMIT)
     );
 
-    FR::defaultRenderer().render(
+    _textBatcher->queue(
         *_fontInfo,
         glm::vec2(
             fontResolution().x - versionBox.boundingBox.x - 10.f,
@@ -1221,7 +1934,7 @@ void RenderEngine::renderVersionInformation() {
         // We check OPENSPACE_GIT_COMMIT but puse OPENSPACE_GIT_FULL on purpose since
         // OPENSPACE_GIT_FULL will never be empty (always will contain at least @, but
         // checking for that is a bit brittle)
-        FR::defaultRenderer().render(
+        _textBatcher->queue(
             *_fontInfo,
             glm::vec2(
                 fontResolution().x - commitBox.boundingBox.x - 10.f,
@@ -1278,7 +1991,7 @@ void RenderEngine::renderScreenLog() {
 
         const glm::vec4 white(0.9f, 0.9f, 0.9f, alpha);
 
-        RenderFont(
+        _textBatcher->queue(
             *_fontLog,
             glm::vec2(10.f, _fontLog->pointSize() * nr * 2),
             fmt::format(
@@ -1309,14 +2022,14 @@ void RenderEngine::renderScreenLog() {
                 break;
         }
 
-        RenderFont(
+        _textBatcher->queue(
             *_fontLog,
             glm::vec2(10 + 30 * _fontLog->pointSize(), _fontLog->pointSize() * nr * 2),
             lvl,
             color
         );
 
-        RenderFont(
+        _textBatcher->queue(
             *_fontLog,
             glm::vec2(10 + 41 * _fontLog->pointSize(), _fontLog->pointSize() * nr * 2),
             message,
@@ -89,4 +89,79 @@ int removeScreenSpaceRenderable(lua_State* L) {
     return 0;
 }
 
+/**
+* \ingroup LuaScripts
+* startTracing():
+* Starts recording the trace zones of all threads
+*/
+int startTracing(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 0, "lua::startTracing");
+
+    global::performanceManager.startTracing();
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
+/**
+* \ingroup LuaScripts
+* stopTracing(string):
+* Stops recording the trace zones and writes them to the provided file
+*/
+int stopTracing(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::stopTracing");
+
+    const std::string path = ghoul::lua::value<std::string>(
+        L,
+        1,
+        ghoul::lua::PopValue::Yes
+    );
+
+    global::performanceManager.stopTracing();
+    const bool isMaster = global::windowDelegate.isMaster();
+    global::performanceManager.writeChromeTrace(
+        path,
+        isMaster ? 0 : 1,
+        isMaster ? "Master" : "Client"
+    );
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
+/**
+* \ingroup LuaScripts
+* runFrameTimeRegression(string, int, string [, string, bool]):
+* Plays back a session recording at a fixed frame pace and writes its frame times
+*/
+int runFrameTimeRegression(lua_State* L) {
+    const int nArguments = ghoul::lua::checkArgumentsAndThrow(
+        L,
+        { 3, 5 },
+        "lua::runFrameTimeRegression"
+    );
+
+    performance::FrameTimeRegression::Settings settings;
+    settings.recording = ghoul::lua::value<std::string>(L, 1);
+    settings.fps = ghoul::lua::value<int>(L, 2);
+    settings.outputPath = absPath(ghoul::lua::value<std::string>(L, 3));
+    if (nArguments >= 4) {
+        settings.thresholdPath = absPath(ghoul::lua::value<std::string>(L, 4));
+    }
+    if (nArguments == 5) {
+        settings.quitWhenDone = ghoul::lua::value<bool>(L, 5);
+    }
+    lua_settop(L, 0);
+
+    const bool success = global::renderEngine.startFrameTimeRegression(
+        std::move(settings)
+    );
+    if (!success) {
+        return ghoul::lua::luaError(L, "Could not start the frame time regression");
+    }
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
 }// namespace openspace::luascriptfunctions
@@ -0,0 +1,131 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/rendering/screenspacebatcher.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/engine/windowdelegate.h>
+#include <openspace/rendering/helper.h>
+#include <openspace/rendering/screenspacerenderable.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <string>
+
+namespace {
+    constexpr const char* VertexShaderPath = "${MODULE_BASE}/shaders/screenspace_vs.glsl";
+    constexpr const char* FragmentShaderPath =
+        "${MODULE_BASE}/shaders/screenspace_fs.glsl";
+} // namespace
+
+namespace openspace {
+
+ScreenSpaceBatcher::ScreenSpaceBatcher() {
+    _modelTransformLocations.fill(-1);
+    _alphaLocations.fill(-1);
+    _textureLocations.fill(-1);
+}
+
+ScreenSpaceBatcher::~ScreenSpaceBatcher() = default;
+
+void ScreenSpaceBatcher::initializeGL() {
+    const glm::ivec2 res = global::windowDelegate.currentWindowResolution();
+    ghoul::Dictionary rendererData = {
+        { "fragmentRendererPath", "${SHADERS}/framebuffer/renderframebuffer.frag" },
+        { "windowWidth" , res.x },
+        { "windowHeight" , res.y }
+    };
+
+    ghoul::Dictionary dict;
+    dict.setValue("rendererData", rendererData);
+    dict.setValue("fragmentPath", FragmentShaderPath);
+    _program = ghoul::opengl::ProgramObject::Build(
+        "ScreenSpaceBatcher",
+        absPath(VertexShaderPath),
+        absPath("${SHADERS}/render.frag"),
+        dict
+    );
+
+    _viewProjectionLocation = _program->uniformLocation("ViewProjectionMatrix");
+    for (int i = 0; i < MaxBatchSize; ++i) {
+        const std::string idx = "[" + std::to_string(i) + "]";
+        _modelTransformLocations[i] = _program->uniformLocation("ModelTransforms" + idx);
+        _alphaLocations[i] = _program->uniformLocation("Alphas" + idx);
+        _textureLocations[i] = _program->uniformLocation("Textures" + idx);
+    }
+}
+
+void ScreenSpaceBatcher::deinitializeGL() {
+    _program = nullptr;
+    _items.clear();
+}
+
+void ScreenSpaceBatcher::queue(ScreenSpaceRenderable& renderable,
+                               const glm::mat4& modelTransform, float alpha)
+{
+    _items.push_back({ &renderable, modelTransform, alpha });
+}
+
+void ScreenSpaceBatcher::flush(const glm::mat4& viewProjection) {
+    if (_items.empty()) {
+        return;
+    }
+
+    glDisable(GL_CULL_FACE);
+    _program->activate();
+    _program->setUniform(_viewProjectionLocation, viewProjection);
+    glBindVertexArray(rendering::helper::vertexObjects.square.vao);
+
+    for (size_t first = 0; first < _items.size(); first += MaxBatchSize) {
+        const size_t nItems = std::min<size_t>(MaxBatchSize, _items.size() - first);
+
+        std::array<ghoul::opengl::TextureUnit, MaxBatchSize> units;
+        for (size_t i = 0; i < nItems; ++i) {
+            const Item& item = _items[first + i];
+            _program->setUniform(_modelTransformLocations[i], item.modelTransform);
+            _program->setUniform(_alphaLocations[i], item.alpha);
+
+            units[i].activate();
+            item.renderable->bindTexture();
+            _program->setUniform(_textureLocations[i], units[i]);
+        }
+
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(nItems));
+
+        for (size_t i = 0; i < nItems; ++i) {
+            units[i].activate();
+            _items[first + i].renderable->unbindTexture();
+        }
+    }
+
+    glBindVertexArray(0);
+    _program->deactivate();
+    glEnable(GL_CULL_FACE);
+
+    _items.clear();
+}
+
+} // namespace openspace
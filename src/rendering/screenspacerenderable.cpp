@@ -28,24 +28,14 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
-#include <openspace/rendering/helper.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scripting/scriptengine.h>
-#include <openspace/scene/scene.h>
-#include <openspace/util/camera.h>
 #include <openspace/util/factorymanager.h>
-#include <ghoul/filesystem/filesystem.h>
-#include <ghoul/opengl/programobject.h>
-#include <ghoul/opengl/textureunit.h>
 
 namespace {
     constexpr const char* KeyType = "Type";
     constexpr const char* KeyTag = "Tag";
 
-    constexpr const std::array<const char*, 5> UniformNames = {
-        "OcclusionDepth", "Alpha", "ModelTransform", "ViewProjectionMatrix", "texture1"
-    };
-
     constexpr openspace::properties::Property::PropertyInfo EnabledInfo = {
         "Enabled",
         "Is Enabled",
@@ -452,7 +442,6 @@ bool ScreenSpaceRenderable::initialize() {
 
 bool ScreenSpaceRenderable::initializeGL() {
     _originalViewportSize = global::windowDelegate.currentWindowResolution();
-    createShaders();
     return isReady();
 }
 
@@ -461,11 +450,6 @@ bool ScreenSpaceRenderable::deinitialize() {
 }
 
 bool ScreenSpaceRenderable::deinitializeGL() {
-    if (_shader) {
-        global::renderEngine.removeRenderProgram(_shader.get());
-        _shader = nullptr;
-    }
-
     return true;
 }
 
@@ -479,7 +463,7 @@ void ScreenSpaceRenderable::render() {
 }
 
 bool ScreenSpaceRenderable::isReady() const {
-    return _shader != nullptr;
+    return true;
 }
 
 void ScreenSpaceRenderable::update() {}
@@ -494,28 +478,6 @@ float ScreenSpaceRenderable::depth() {
         cartesianToSpherical(_cartesianPosition).x;
 }
 
-void ScreenSpaceRenderable::createShaders() {
-    ghoul::Dictionary dict = ghoul::Dictionary();
-
-    auto res = global::windowDelegate.currentWindowResolution();
-    ghoul::Dictionary rendererData = {
-        { "fragmentRendererPath", "${SHADERS}/framebuffer/renderframebuffer.frag" },
-        { "windowWidth" , res.x },
-        { "windowHeight" , res.y }
-    };
-
-    dict.setValue("rendererData", rendererData);
-    dict.setValue("fragmentPath", "${MODULE_BASE}/shaders/screenspace_fs.glsl");
-    _shader = ghoul::opengl::ProgramObject::Build(
-        "ScreenSpaceProgram",
-        absPath("${MODULE_BASE}/shaders/screenspace_vs.glsl"),
-        absPath("${SHADERS}/render.frag"),
-        dict
-    );
-
-    ghoul::opengl::updateUniformLocations(*_shader, _uniformCache, UniformNames);
-}
-
 glm::mat4 ScreenSpaceRenderable::scaleMatrix() {
     glm::vec2 resolution = global::windowDelegate.currentWindowResolution();
 
@@ -588,30 +550,7 @@ glm::mat4 ScreenSpaceRenderable::translationMatrix() {
 }
 
 void ScreenSpaceRenderable::draw(glm::mat4 modelTransform) {
-    glDisable(GL_CULL_FACE);
-
-    _shader->activate();
-
-    _shader->setUniform(_uniformCache.alpha, _alpha);
-    _shader->setUniform(_uniformCache.modelTransform, modelTransform);
-
-    _shader->setUniform(
-        _uniformCache.viewProj,
-        global::renderEngine.scene()->camera()->viewProjectionMatrix()
-    );
-
-    ghoul::opengl::TextureUnit unit;
-    unit.activate();
-    bindTexture();
-    _shader->setUniform(_uniformCache.texture, unit);
-
-    glBindVertexArray(rendering::helper::vertexObjects.square.vao);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    glEnable(GL_CULL_FACE);
-
-    _shader->deactivate();
-    unbindTexture();
+    global::renderEngine.screenSpaceBatcher().queue(*this, modelTransform, _alpha);
 }
 
 void ScreenSpaceRenderable::bindTexture() {}
@@ -0,0 +1,423 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/rendering/starsplatter.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/util/camera.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/shaderobject.h>
+#include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <array>
+
+namespace {
+    constexpr const char* SplatShaderPath = "${SHADERS}/starsplatter/splat.comp";
+    constexpr const char* ResolveShaderPath = "${SHADERS}/starsplatter/resolve.comp";
+    constexpr const char* CompositeVertexPath =
+        "${SHADERS}/framebuffer/resolveframebuffer.vert";
+    constexpr const char* CompositeFragmentPath =
+        "${SHADERS}/starsplatter/composite.frag";
+
+    constexpr const std::array<const char*, 10> SplatUniformNames = {
+        "modelViewTransform", "projectionTransform", "resolution", "tileCount",
+        "exposure", "brightStarThreshold", "psfRadius", "colorRange", "colorTexture",
+        "nStars"
+    };
+
+    constexpr const std::array<const char*, 4> ResolveUniformNames = {
+        "resolution", "tileCount", "psfTexture", "outputImage"
+    };
+
+    constexpr const std::array<const char*, 2> CompositeUniformNames = {
+        "splatTexture", "viewportOffset"
+    };
+
+    // Keep in sync with shaders/starsplatter/splatbuffers.glsl
+    constexpr const int TileSize = 16;
+    constexpr const GLsizeiptr MaxStarsPerTile = 256;
+    constexpr const GLsizeiptr MaxBrightStars = 65536;
+    // The size of the header with the number of bright stars and of each bright star
+    constexpr const GLsizeiptr BrightStarHeaderSize = 16;
+    constexpr const GLsizeiptr BrightStarSize = 32;
+
+    constexpr const GLuint SplatWorkGroupSize = 256;
+    // Larger numbers of stars are handled in a loop by the invocations of the shader
+    constexpr const GLuint MaxSplatWorkGroups = 65535;
+} // namespace
+
+namespace openspace {
+
+StarSplatter::StarSplatter(std::string name, std::string sourceShaderPath)
+    : _name(std::move(name))
+    , _sourceShaderPath(std::move(sourceShaderPath))
+{}
+
+StarSplatter::~StarSplatter() = default;
+
+void StarSplatter::initializeGL() {
+    using ghoul::opengl::ShaderObject;
+
+    _splatProgram = std::make_unique<ghoul::opengl::ProgramObject>(_name + " Splat");
+    _splatProgram->attachObject(std::make_shared<ShaderObject>(
+        ShaderObject::ShaderType::Compute,
+        absPath(SplatShaderPath),
+        _name + " Splat"
+    ));
+    _splatProgram->attachObject(std::make_shared<ShaderObject>(
+        ShaderObject::ShaderType::Compute,
+        absPath(_sourceShaderPath),
+        _name + " Source"
+    ));
+    _splatProgram->compileShaderObjects();
+    _splatProgram->linkProgramObject();
+    ghoul::opengl::updateUniformLocations(
+        *_splatProgram,
+        _splatUniformCache,
+        SplatUniformNames
+    );
+
+    _resolveProgram = std::make_unique<ghoul::opengl::ProgramObject>(_name + " Resolve");
+    _resolveProgram->attachObject(std::make_shared<ShaderObject>(
+        ShaderObject::ShaderType::Compute,
+        absPath(ResolveShaderPath),
+        _name + " Resolve"
+    ));
+    _resolveProgram->compileShaderObjects();
+    _resolveProgram->linkProgramObject();
+    ghoul::opengl::updateUniformLocations(
+        *_resolveProgram,
+        _resolveUniformCache,
+        ResolveUniformNames
+    );
+
+    _compositeProgram = global::renderEngine.buildRenderProgram(
+        _name + " Composite",
+        absPath(CompositeVertexPath),
+        absPath(CompositeFragmentPath)
+    );
+    ghoul::opengl::updateUniformLocations(
+        *_compositeProgram,
+        _compositeUniformCache,
+        CompositeUniformNames
+    );
+
+    const GLfloat vertexData[] = {
+        // x     y
+        -1.f, -1.f,
+         1.f,  1.f,
+        -1.f,  1.f,
+        -1.f, -1.f,
+         1.f, -1.f,
+         1.f,  1.f,
+    };
+    glGenVertexArrays(1, &_vao);
+    glBindVertexArray(_vao);
+    glGenBuffers(1, &_vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 2, nullptr);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+
+    _accumulationBinding = std::make_unique<SsboBinding>();
+    _tileBinding = std::make_unique<SsboBinding>();
+    _brightStarBinding = std::make_unique<SsboBinding>();
+    setBlockBindings(*_splatProgram);
+    setBlockBindings(*_resolveProgram);
+}
+
+void StarSplatter::deinitializeGL() {
+    destroyResources();
+
+    _accumulationBinding = nullptr;
+    _tileBinding = nullptr;
+    _brightStarBinding = nullptr;
+
+    glDeleteBuffers(1, &_vertexBuffer);
+    _vertexBuffer = 0;
+    glDeleteVertexArrays(1, &_vao);
+    _vao = 0;
+
+    _splatProgram = nullptr;
+    _resolveProgram = nullptr;
+    if (_compositeProgram) {
+        global::renderEngine.removeRenderProgram(_compositeProgram.get());
+        _compositeProgram = nullptr;
+    }
+}
+
+void StarSplatter::update() {
+    if (!_splatProgram) {
+        // Not initialized
+        return;
+    }
+
+    if (_splatProgram->isDirty()) {
+        _splatProgram->rebuildFromFile();
+        ghoul::opengl::updateUniformLocations(
+            *_splatProgram,
+            _splatUniformCache,
+            SplatUniformNames
+        );
+        setBlockBindings(*_splatProgram);
+    }
+
+    if (_resolveProgram->isDirty()) {
+        _resolveProgram->rebuildFromFile();
+        ghoul::opengl::updateUniformLocations(
+            *_resolveProgram,
+            _resolveUniformCache,
+            ResolveUniformNames
+        );
+        setBlockBindings(*_resolveProgram);
+    }
+
+    if (_compositeProgram->isDirty()) {
+        _compositeProgram->rebuildFromFile();
+        ghoul::opengl::updateUniformLocations(
+            *_compositeProgram,
+            _compositeUniformCache,
+            CompositeUniformNames
+        );
+    }
+}
+
+void StarSplatter::setBlockBindings(ghoul::opengl::ProgramObject& program) const {
+    program.setSsboBinding("Accumulation", _accumulationBinding->bindingNumber());
+    program.setSsboBinding("Tiles", _tileBinding->bindingNumber());
+    program.setSsboBinding("BrightStars", _brightStarBinding->bindingNumber());
+}
+
+void StarSplatter::createResources(const glm::ivec2& resolution) {
+    destroyResources();
+
+    _resolution = resolution;
+    _tileCount = (resolution + TileSize - 1) / TileSize;
+    const GLsizeiptr nPixels = static_cast<GLsizeiptr>(resolution.x) * resolution.y;
+    const GLsizeiptr nTiles = static_cast<GLsizeiptr>(_tileCount.x) * _tileCount.y;
+
+    // The resolve pass clears every pixel of the accumulation buffer after reading it,
+    // so it only has to be cleared once after its creation
+    const GLuint zero = 0;
+    glGenBuffers(1, &_accumulationBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _accumulationBuffer);
+    glBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        3 * nPixels * sizeof(GLuint),
+        nullptr,
+        GL_DYNAMIC_COPY
+    );
+    glClearBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        GL_R32UI,
+        GL_RED_INTEGER,
+        GL_UNSIGNED_INT,
+        &zero
+    );
+
+    glGenBuffers(1, &_tileBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _tileBuffer);
+    glBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        nTiles * (1 + MaxStarsPerTile) * sizeof(GLuint),
+        nullptr,
+        GL_DYNAMIC_COPY
+    );
+
+    glGenBuffers(1, &_brightStarBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _brightStarBuffer);
+    glBufferData(
+        GL_SHADER_STORAGE_BUFFER,
+        BrightStarHeaderSize + MaxBrightStars * BrightStarSize,
+        nullptr,
+        GL_DYNAMIC_COPY
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glGenTextures(1, &_outputTexture);
+    glBindTexture(GL_TEXTURE_2D, _outputTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, resolution.x, resolution.y);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void StarSplatter::destroyResources() {
+    glDeleteBuffers(1, &_accumulationBuffer);
+    _accumulationBuffer = 0;
+    glDeleteBuffers(1, &_tileBuffer);
+    _tileBuffer = 0;
+    glDeleteBuffers(1, &_brightStarBuffer);
+    _brightStarBuffer = 0;
+    glDeleteTextures(1, &_outputTexture);
+    _outputTexture = 0;
+    _resolution = glm::ivec2(0);
+    _tileCount = glm::ivec2(0);
+}
+
+void StarSplatter::render(const RenderData& data, const glm::dmat4& modelTransform,
+                          unsigned int nStars, const Settings& settings,
+          const std::function<void(ghoul::opengl::ProgramObject&)>& setSourceUniforms)
+{
+    if (nStars == 0) {
+        return;
+    }
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const glm::ivec2 resolution = glm::ivec2(viewport[2], viewport[3]);
+    if (resolution != _resolution) {
+        createResources(resolution);
+    }
+
+    // Only the counters have to be reset, the star lists are overwritten
+    const GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _tileBuffer);
+    glClearBufferSubData(
+        GL_SHADER_STORAGE_BUFFER,
+        GL_R32UI,
+        0,
+        static_cast<GLsizeiptr>(_tileCount.x) * _tileCount.y * sizeof(GLuint),
+        GL_RED_INTEGER,
+        GL_UNSIGNED_INT,
+        &zero
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _brightStarBuffer);
+    glClearBufferSubData(
+        GL_SHADER_STORAGE_BUFFER,
+        GL_R32UI,
+        0,
+        sizeof(GLuint),
+        GL_RED_INTEGER,
+        GL_UNSIGNED_INT,
+        &zero
+    );
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        _accumulationBinding->bindingNumber(),
+        _accumulationBuffer
+    );
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        _tileBinding->bindingNumber(),
+        _tileBuffer
+    );
+    glBindBufferBase(
+        GL_SHADER_STORAGE_BUFFER,
+        _brightStarBinding->bindingNumber(),
+        _brightStarBuffer
+    );
+
+    //
+    // Splat the faint stars and bin the bright ones
+    //
+    _splatProgram->activate();
+    _splatProgram->setUniform(
+        _splatUniformCache.modelViewTransform,
+        data.camera.combinedViewMatrix() * modelTransform
+    );
+    _splatProgram->setUniform(
+        _splatUniformCache.projectionTransform,
+        glm::dmat4(data.camera.projectionMatrix())
+    );
+    _splatProgram->setUniform(_splatUniformCache.resolution, _resolution);
+    _splatProgram->setUniform(_splatUniformCache.tileCount, _tileCount);
+    _splatProgram->setUniform(_splatUniformCache.exposure, settings.exposure);
+    _splatProgram->setUniform(
+        _splatUniformCache.brightStarThreshold,
+        settings.brightStarThreshold
+    );
+    _splatProgram->setUniform(_splatUniformCache.psfRadius, settings.psfRadius);
+    _splatProgram->setUniform(_splatUniformCache.colorRange, settings.colorRange);
+    _splatProgram->setUniform(_splatUniformCache.nStars, nStars);
+
+    ghoul::opengl::TextureUnit colorUnit;
+    colorUnit.activate();
+    glBindTexture(GL_TEXTURE_1D, settings.colorTexture);
+    _splatProgram->setUniform(_splatUniformCache.colorTexture, colorUnit);
+
+    setSourceUniforms(*_splatProgram);
+
+    const GLuint nGroups = std::min(
+        (nStars + SplatWorkGroupSize - 1) / SplatWorkGroupSize,
+        MaxSplatWorkGroups
+    );
+    glDispatchCompute(nGroups, 1, 1);
+    _splatProgram->deactivate();
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    //
+    // Resolve one tile per work group
+    //
+    _resolveProgram->activate();
+    _resolveProgram->setUniform(_resolveUniformCache.resolution, _resolution);
+    _resolveProgram->setUniform(_resolveUniformCache.tileCount, _tileCount);
+
+    ghoul::opengl::TextureUnit psfUnit;
+    psfUnit.activate();
+    glBindTexture(GL_TEXTURE_2D, settings.psfTexture);
+    _resolveProgram->setUniform(_resolveUniformCache.psfTexture, psfUnit);
+
+    glBindImageTexture(0, _outputTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    _resolveProgram->setUniform(_resolveUniformCache.outputImage, 0);
+
+    glDispatchCompute(_tileCount.x, _tileCount.y, 1);
+    _resolveProgram->deactivate();
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    //
+    // Composite into the current framebuffer
+    //
+    _compositeProgram->activate();
+    ghoul::opengl::TextureUnit splatUnit;
+    splatUnit.activate();
+    glBindTexture(GL_TEXTURE_2D, _outputTexture);
+    _compositeProgram->setUniform(_compositeUniformCache.splatTexture, splatUnit);
+    _compositeProgram->setUniform(
+        _compositeUniformCache.viewportOffset,
+        glm::ivec2(viewport[0], viewport[1])
+    );
+
+    GLboolean depthMask;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+    glDepthMask(false);
+
+    glBindVertexArray(_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+
+    glDepthMask(depthMask);
+    _compositeProgram->deactivate();
+}
+
+} // namespace openspace
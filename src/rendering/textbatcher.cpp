@@ -0,0 +1,333 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/rendering/textbatcher.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/font/font.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/texture.h>
+#include <ghoul/opengl/textureatlas.h>
+#include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <array>
+
+namespace {
+    constexpr const char* VertexShaderPath = "${SHADERS}/text/textbatch.vert";
+    constexpr const char* FragmentShaderPath = "${SHADERS}/text/textbatch.frag";
+
+    constexpr const std::array<const char*, 2> UniformNames = { "projection", "atlas" };
+
+    // Each glyph is drawn as a quad of two triangles
+    constexpr const int VerticesPerGlyph = 4;
+    constexpr const int IndicesPerGlyph = 6;
+
+    // Parameters of the 64 bit FNV-1a hash that is used for the checksum
+    constexpr const uint64_t ChecksumOffsetBasis = 0xcbf29ce484222325;
+    constexpr const uint64_t ChecksumPrime = 0x100000001b3;
+} // namespace
+
+namespace openspace {
+
+TextBatcher::TextBatcher() : _checksum(ChecksumOffsetBasis) {}
+
+TextBatcher::~TextBatcher() = default;
+
+void TextBatcher::initializeGL() {
+    _program = ghoul::opengl::ProgramObject::Build(
+        "TextBatcher",
+        absPath(VertexShaderPath),
+        absPath(FragmentShaderPath)
+    );
+    ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+
+    glGenVertexArrays(1, &_vao);
+    glGenBuffers(1, &_vbo);
+    glGenBuffers(1, &_ibo);
+
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(
+        1,
+        2,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Vertex),
+        reinterpret_cast<void*>(offsetof(Vertex, texCoords)) // NOLINT
+    );
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(
+        2,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Vertex),
+        reinterpret_cast<void*>(offsetof(Vertex, color)) // NOLINT
+    );
+    glBindVertexArray(0);
+}
+
+void TextBatcher::deinitializeGL() {
+    glDeleteBuffers(1, &_ibo);
+    glDeleteBuffers(1, &_vbo);
+    glDeleteVertexArrays(1, &_vao);
+    _vboCapacity = 0;
+    _iboCapacity = 0;
+    _program = nullptr;
+
+    _batches.clear();
+    _fontMetrics.clear();
+}
+
+void TextBatcher::setFramebufferSize(glm::vec2 size) {
+    _framebufferSize = std::move(size);
+}
+
+TextBatcher::FontMetrics& TextBatcher::fontMetrics(ghoul::fontrendering::Font& font) {
+    auto it = _fontMetrics.find(&font);
+    if (it == _fontMetrics.end()) {
+        FontMetrics metrics;
+        metrics.font = &font;
+        metrics.atlas = &font.atlas();
+        metrics.height = font.height();
+        it = _fontMetrics.emplace(&font, std::move(metrics)).first;
+    }
+    return it->second;
+}
+
+const TextBatcher::GlyphMetrics* TextBatcher::glyphMetrics(FontMetrics& metrics,
+                                                          wchar_t character)
+{
+    auto it = metrics.glyphs.find(character);
+    if (it == metrics.glyphs.end()) {
+        // This might load the glyph into the atlas, which is the only time that the font
+        // itself is needed for this character
+        const ghoul::fontrendering::Font::Glyph* glyph =
+            metrics.font->glyph(character);
+        if (!glyph) {
+            return nullptr;
+        }
+
+        GlyphMetrics m;
+        m.bearing = glm::vec2(glyph->horizontalBearingX(), glyph->horizontalBearingY());
+        m.size = glm::vec2(glyph->width(), glyph->height());
+        m.texCoordsTopLeft = glyph->topLeft();
+        m.texCoordsBottomRight = glyph->bottomRight();
+        m.advance = glyph->advanceX();
+        it = metrics.glyphs.emplace(character, m).first;
+    }
+    return &it->second;
+}
+
+void TextBatcher::updateChecksum(const void* data, size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        _checksum = (_checksum ^ bytes[i]) * ChecksumPrime;
+    }
+}
+
+void TextBatcher::queue(ghoul::fontrendering::Font& font, const glm::vec2& position,
+                        const std::string& text, const glm::vec4& color)
+{
+    if (text.empty()) {
+        return;
+    }
+
+    const ghoul::fontrendering::Font* fontPtr = &font;
+    updateChecksum(&fontPtr, sizeof(fontPtr));
+    updateChecksum(glm::value_ptr(position), sizeof(glm::vec2));
+    updateChecksum(glm::value_ptr(color), sizeof(glm::vec4));
+    updateChecksum(text.data(), text.size());
+
+    FontMetrics& metrics = fontMetrics(font);
+    std::vector<Vertex>& vertices = _batches[metrics.atlas];
+
+    // The lines are stacked upwards from the position, so the first line is the highest
+    const int nLines = static_cast<int>(std::count(text.begin(), text.end(), '\n')) + 1;
+    glm::vec2 pen = glm::vec2(position.x, position.y + (nLines - 1) * metrics.height);
+
+    for (char c : text) {
+        if (c == '\n') {
+            pen = glm::vec2(position.x, pen.y - metrics.height);
+            continue;
+        }
+
+        const GlyphMetrics* glyph = glyphMetrics(metrics, wchar_t(c));
+        if (!glyph) {
+            continue;
+        }
+
+        const glm::vec2 topLeft = pen + glyph->bearing;
+        const glm::vec2 bottomRight = topLeft + glm::vec2(glyph->size.x, -glyph->size.y);
+        const glm::vec2& uv0 = glyph->texCoordsTopLeft;
+        const glm::vec2& uv1 = glyph->texCoordsBottomRight;
+
+        vertices.push_back({
+            { topLeft.x, topLeft.y }, { uv0.x, uv0.y },
+            { color.r, color.g, color.b, color.a }
+        });
+        vertices.push_back({
+            { topLeft.x, bottomRight.y }, { uv0.x, uv1.y },
+            { color.r, color.g, color.b, color.a }
+        });
+        vertices.push_back({
+            { bottomRight.x, bottomRight.y }, { uv1.x, uv1.y },
+            { color.r, color.g, color.b, color.a }
+        });
+        vertices.push_back({
+            { bottomRight.x, topLeft.y }, { uv1.x, uv0.y },
+            { color.r, color.g, color.b, color.a }
+        });
+
+        pen.x += glyph->advance;
+    }
+}
+
+void TextBatcher::queue(ghoul::fontrendering::Font& font, glm::vec2& penPosition,
+                        const std::string& text, const glm::vec4& color,
+                        ghoul::fontrendering::CrDirection direction)
+{
+    queue(font, static_cast<const glm::vec2&>(penPosition), text, color);
+
+    if (direction == ghoul::fontrendering::CrDirection::Down) {
+        const int nLines =
+            static_cast<int>(std::count(text.begin(), text.end(), '\n')) + 1;
+        penPosition.y -= nLines * fontMetrics(font).height;
+    }
+}
+
+void TextBatcher::flush() {
+    size_t nVertices = 0;
+    for (const std::pair<ghoul::opengl::TextureAtlas* const, std::vector<Vertex>>& b :
+         _batches)
+    {
+        nVertices += b.second.size();
+    }
+    if (nVertices == 0) {
+        _checksum = ChecksumOffsetBasis;
+        return;
+    }
+
+    // All quads share the same index pattern, so the index buffer only has to be
+    // extended if there are more glyphs than ever before
+    const size_t nGlyphs = nVertices / VerticesPerGlyph;
+    glBindVertexArray(_vao);
+    if (nGlyphs * IndicesPerGlyph > _iboCapacity) {
+        for (size_t i = _indices.size() / IndicesPerGlyph; i < nGlyphs; ++i) {
+            const GLuint v = static_cast<GLuint>(i * VerticesPerGlyph);
+            _indices.insert(_indices.end(), { v, v + 1, v + 2, v, v + 2, v + 3 });
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            _indices.size() * sizeof(GLuint),
+            _indices.data(),
+            GL_STATIC_DRAW
+        );
+        _iboCapacity = _indices.size();
+    }
+
+    // Orphan the buffer and upload all batches after each other
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    if (nVertices > _vboCapacity) {
+        _vboCapacity = nVertices;
+    }
+    glBufferData(GL_ARRAY_BUFFER, _vboCapacity * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    size_t offset = 0;
+    for (const std::pair<ghoul::opengl::TextureAtlas* const, std::vector<Vertex>>& b :
+         _batches)
+    {
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            offset * sizeof(Vertex),
+            b.second.size() * sizeof(Vertex),
+            b.second.data()
+        );
+        offset += b.second.size();
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+
+    _program->activate();
+    _program->setUniform(
+        _uniformCache.projection,
+        glm::ortho(0.f, _framebufferSize.x, 0.f, _framebufferSize.y)
+    );
+
+    ghoul::opengl::TextureUnit unit;
+    unit.activate();
+    _program->setUniform(_uniformCache.atlas, unit);
+
+    // One draw call per atlas. The vertices of each following batch start after the
+    // ones of the previous batches, which the base vertex accounts for
+    size_t baseVertex = 0;
+    for (std::pair<ghoul::opengl::TextureAtlas* const, std::vector<Vertex>>& b :
+         _batches)
+    {
+        if (b.second.empty()) {
+            continue;
+        }
+        b.first->texture().bind();
+
+        glDrawElementsBaseVertex(
+            GL_TRIANGLES,
+            static_cast<GLsizei>(b.second.size() / VerticesPerGlyph * IndicesPerGlyph),
+            GL_UNSIGNED_INT,
+            nullptr,
+            static_cast<GLint>(baseVertex)
+        );
+        baseVertex += b.second.size();
+
+        // Keep the allocation around for the next frame
+        b.second.clear();
+    }
+
+    _program->deactivate();
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+
+    _checksum = ChecksumOffsetBasis;
+}
+
+void TextBatcher::discard() {
+    for (std::pair<ghoul::opengl::TextureAtlas* const, std::vector<Vertex>>& b :
+         _batches)
+    {
+        b.second.clear();
+    }
+    _checksum = ChecksumOffsetBasis;
+}
+
+uint64_t TextBatcher::checksum() const {
+    return _checksum;
+}
+
+} // namespace openspace
@@ -30,7 +30,11 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/shaderobject.h>
 #include <ghoul/opengl/texture.h>
+#include <ghoul/opengl/textureunit.h>
 #include <iterator>
 #include <fstream>
 #include <string>
@@ -38,6 +42,14 @@
 namespace {
     constexpr const char* _loggerCat = "TransferFunction";
 
+    constexpr const char* PreintegrationShaderPath =
+        "${SHADERS}/transferfunction/preintegrate.comp";
+
+    // The number of texels along each axis of the pre-integrated table. Keep the work
+    // group size in sync with preintegrate.comp
+    constexpr const int PreintegrationTableSize = 256;
+    constexpr const int PreintegrationWorkGroupSize = 16;
+
     // @TODO Replace with Filesystem::File extension
     bool hasExtension(const std::string& filepath, const std::string& extension) {
         std::string ending = "." + extension;
@@ -100,12 +112,84 @@ void TransferFunction::update() {
         }
         _texture->uploadTexture();
         _needsUpdate = false;
+        _preintegrationIsDirty = true;
         if (_tfChangedCallback) {
             _tfChangedCallback(*this);
         }
     }
 }
 
+ghoul::opengl::Texture& TransferFunction::preintegratedTexture() {
+    ghoul_assert(_texture != nullptr, "Transfer function is null");
+    update();
+    if (_preintegrationIsDirty) {
+        updatePreintegratedTexture();
+    }
+    return *_preintegratedTexture;
+}
+
+void TransferFunction::updatePreintegratedTexture() {
+    using ghoul::opengl::ShaderObject;
+
+    if (!_preintegrationProgram) {
+        _preintegrationProgram = std::make_unique<ghoul::opengl::ProgramObject>(
+            "TransferFunction Preintegration"
+        );
+        _preintegrationProgram->attachObject(std::make_shared<ShaderObject>(
+            ShaderObject::ShaderType::Compute,
+            absPath(PreintegrationShaderPath),
+            "TransferFunction Preintegration"
+        ));
+        _preintegrationProgram->compileShaderObjects();
+        _preintegrationProgram->linkProgramObject();
+    }
+
+    if (!_preintegratedTexture) {
+        _preintegratedTexture = std::make_unique<ghoul::opengl::Texture>(
+            glm::uvec3(PreintegrationTableSize, PreintegrationTableSize, 1),
+            ghoul::opengl::Texture::Format::RGBA,
+            GL_RGBA16F,
+            GL_FLOAT,
+            ghoul::opengl::Texture::FilterMode::Linear,
+            ghoul::opengl::Texture::WrappingMode::ClampToEdge,
+            ghoul::opengl::Texture::AllocateData::No
+        );
+        _preintegratedTexture->uploadTexture();
+    }
+
+    _preintegrationProgram->activate();
+
+    ghoul::opengl::TextureUnit tfUnit;
+    tfUnit.activate();
+    _texture->bind();
+    _preintegrationProgram->setUniform("transferFunction", tfUnit);
+    _preintegrationProgram->setUniform("tableSize", PreintegrationTableSize);
+
+    glBindImageTexture(
+        0,
+        *_preintegratedTexture,
+        0,
+        GL_FALSE,
+        0,
+        GL_WRITE_ONLY,
+        GL_RGBA16F
+    );
+    _preintegrationProgram->setUniform("table", 0);
+
+    const GLuint nGroups = static_cast<GLuint>(
+        (PreintegrationTableSize + PreintegrationWorkGroupSize - 1) /
+        PreintegrationWorkGroupSize
+    );
+    glDispatchCompute(nGroups, nGroups, 1);
+    _preintegrationProgram->deactivate();
+
+    // The table is sampled by the raycasting shaders later in this frame
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    _preintegrationIsDirty = false;
+}
+
 void TransferFunction::setCallback(TfChangedCallback callback) {
     _tfChangedCallback = std::move(callback);
 }
@@ -24,6 +24,8 @@
 
 #include <openspace/rendering/volumeraycaster.h>
 
+#include <ghoul/misc/assert.h>
+
 namespace openspace {
 
 void VolumeRaycaster::preRaycast(const RaycastData&, ghoul::opengl::ProgramObject&) {}
@@ -33,4 +35,13 @@ bool VolumeRaycaster::isCameraInside(const RenderData&, glm::vec3&) {
     return false;
 }
 
+float VolumeRaycaster::downscaleRender() const {
+    return _downscaleRenderConst;
+}
+
+void VolumeRaycaster::setDownscaleRender(float value) {
+    ghoul_assert(value > 0.f && value <= 1.f, "Downscale factor must be in (0, 1]");
+    _downscaleRenderConst = value;
+}
+
 } // namespace openspace
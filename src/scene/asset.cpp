@@ -178,6 +178,14 @@ void Asset::addSynchronization(std::shared_ptr<ResourceSynchronization> synchron
             }
         );
     _syncWatches.push_back(watch);
+
+    // Start the transfer right away instead of waiting until the whole asset tree has
+    // been loaded. The assets' states are still only advanced top-down from
+    // startSynchronizations, but the downloads of all assets overlap with the loading of
+    // the remaining assets and with each other
+    if (!synchronization->isResolved()) {
+        synchronization->start();
+    }
 }
 
 void Asset::clearSynchronizations() {
@@ -390,9 +398,11 @@ bool Asset::startSynchronizations() {
         }
     }
 
-    // Now synchronize its own synchronizations.
+    // Now synchronize its own synchronizations. Most of them were already started while
+    // the asset was loaded; the ones that were rejected have reported their failure and
+    // are not restarted
     for (const std::shared_ptr<ResourceSynchronization>& s : ownSynchronizations()) {
-        if (!s->isResolved()) {
+        if (!s->isResolved() && !s->isRejected()) {
             s->start();
         }
     }
@@ -24,6 +24,7 @@
 
 #include <openspace/scene/assetloader.h>
 
+#include <openspace/documentation/documentation.h>
 #include <openspace/scene/assetlistener.h>
 #include <openspace/util/resourcesynchronization.h>
 #include <ghoul/fmt.h>
@@ -34,6 +35,8 @@
 #include <ghoul/lua/lua_helper.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/defer.h>
+#include <fstream>
+#include <sstream>
 
 
 #include "assetloader_lua.inl"
@@ -268,6 +271,13 @@ bool AssetLoader::loadAsset(std::shared_ptr<Asset> asset) {
         return false;
     }
 
+    if (!_validatedAssetsFile.empty()) {
+        std::ifstream file(asset->assetFilePath());
+        std::stringstream buffer;
+        buffer << asset->assetFilePath() << '\n' << file.rdbuf();
+        _assetHashes[asset.get()] = std::hash<std::string>()(buffer.str());
+    }
+
     try {
         ghoul::lua::runScriptFile(*_luaState, asset->assetFilePath());
     } catch (const ghoul::lua::LuaRuntimeException& e) {
@@ -307,6 +317,8 @@ void AssetLoader::unloadAsset(Asset* asset) {
     }
     _onDependencyDeinitializationFunctionRefs.erase(asset);
 
+    _assetHashes.erase(asset);
+
     asset->clearSynchronizations();
     untrackAsset(asset);
 }
@@ -504,6 +516,17 @@ const std::string& AssetLoader::assetRootDirectory() const {
 }
 
 void AssetLoader::callOnInitialize(Asset* asset) {
+    auto hashIt = _assetHashes.find(asset);
+    const bool hasHash = hashIt != _assetHashes.end();
+    const bool isValidated = hasHash && _validatedAssetHashes.count(hashIt->second) > 0;
+
+    // The dictionaries created by an unchanged asset passed their specification tests
+    // the last time they were created, so we don't need to test them again
+    std::unique_ptr<documentation::SpecificationTestBypass> bypass;
+    if (isValidated) {
+        bypass = std::make_unique<documentation::SpecificationTestBypass>();
+    }
+
     for (int init : _onInitializationFunctionRefs[asset]) {
         lua_rawgeti(*_luaState, LUA_REGISTRYINDEX, init);
         if (lua_pcall(*_luaState, 0, 0, 0) != LUA_OK) {
@@ -515,6 +538,27 @@ void AssetLoader::callOnInitialize(Asset* asset) {
         // Clean up lua stack, in case the pcall left anything there.
         lua_settop(*_luaState, 0);
     }
+
+    if (hasHash && !isValidated) {
+        _validatedAssetHashes.insert(hashIt->second);
+        std::ofstream file(_validatedAssetsFile, std::ofstream::app);
+        file << hashIt->second << '\n';
+    }
+}
+
+void AssetLoader::setValidatedAssetsFile(std::string path) {
+    _validatedAssetsFile = std::move(path);
+    _validatedAssetHashes.clear();
+    _assetHashes.clear();
+    if (_validatedAssetsFile.empty()) {
+        return;
+    }
+
+    std::ifstream file(_validatedAssetsFile);
+    size_t hash;
+    while (file >> hash) {
+        _validatedAssetHashes.insert(hash);
+    }
 }
 
 void AssetLoader::callOnDeinitialize(Asset * asset) {
@@ -86,7 +86,7 @@ documentation::Documentation LightSource::Documentation() {
 std::unique_ptr<LightSource> LightSource::createFromDictionary(
     const ghoul::Dictionary& dictionary)
 {
-    documentation::testSpecificationAndThrow(Documentation(), dictionary, "LightSource");
+    documentation::testSpecificationAndThrow(Documentation, dictionary, "LightSource");
 
     const std::string timeFrameType = dictionary.value<std::string>(KeyType);
 
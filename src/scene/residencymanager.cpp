@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/scene/residencymanager.h>
+
+#include <openspace/rendering/renderable.h>
+#include <openspace/scene/scenegraphnode.h>
+#include <openspace/util/time.h>
+
+namespace {
+    // Restoring a renderable can involve loading textures and building programs, so
+    // only this many nodes are restored per frame
+    constexpr const int MaxRestoresPerFrame = 1;
+
+    constexpr openspace::properties::Property::PropertyInfo EnabledInfo = {
+        "Enabled",
+        "Enabled",
+        "If this value is enabled, the GPU resources of renderables that are not needed "
+        "for a while are released and restored when they are needed again."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ReleaseDelayInfo = {
+        "ReleaseDelay",
+        "Release Delay (in seconds)",
+        "The number of seconds that a renderable has to be disabled, outside of its "
+        "time frame, or farther away than the release distance before its GPU "
+        "resources are released."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ReleaseDistanceInfo = {
+        "ReleaseDistance",
+        "Release Distance (in bounding spheres)",
+        "The distance from the camera, in multiples of the radius of its bounding "
+        "sphere, beyond which a renderable is considered to not be needed. Renderables "
+        "without a bounding sphere are only released if they are not active."
+    };
+} // namespace
+
+namespace openspace {
+
+ResidencyManager::ResidencyManager()
+    : properties::PropertyOwner({ "Residency" })
+    , _enabled(EnabledInfo, false)
+    , _releaseDelay(ReleaseDelayInfo, 30.f, 1.f, 3600.f)
+    , _releaseDistance(ReleaseDistanceInfo, 10000.f, 10.f, 1e8f)
+{
+    addProperty(_enabled);
+    addProperty(_releaseDelay);
+    addProperty(_releaseDistance);
+}
+
+void ResidencyManager::update(const std::vector<SceneGraphNode*>& nodes,
+                              const glm::dvec3& cameraPosition, const Time& time)
+{
+    if (!_enabled) {
+        _unneededSince.clear();
+
+        // Everything that has been released is brought back when the manager is turned
+        // off, still at the same pace as when the nodes are needed again
+        int nRestored = 0;
+        for (SceneGraphNode* node : nodes) {
+            if (nRestored < MaxRestoresPerFrame && node->isGLReleased()) {
+                node->restoreGL();
+                nRestored++;
+            }
+        }
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const std::chrono::duration<float> delay(_releaseDelay);
+
+    int nRestored = 0;
+    for (SceneGraphNode* node : nodes) {
+        const Renderable* renderable = node->renderable();
+        if (!renderable || !renderable->canReleaseGLResources() ||
+            node->state() != SceneGraphNode::State::GLInitialized)
+        {
+            continue;
+        }
+
+        const bool isNeeded = this->isNeeded(*node, cameraPosition, time);
+        if (node->isGLReleased()) {
+            if (isNeeded && nRestored < MaxRestoresPerFrame) {
+                node->restoreGL();
+                nRestored++;
+            }
+            continue;
+        }
+
+        if (isNeeded) {
+            _unneededSince.erase(node);
+            continue;
+        }
+
+        const auto it = _unneededSince.find(node);
+        if (it == _unneededSince.end()) {
+            _unneededSince[node] = now;
+        }
+        else if (now - it->second > delay) {
+            node->releaseGL();
+            _unneededSince.erase(it);
+        }
+    }
+}
+
+void ResidencyManager::removeNode(const SceneGraphNode* node) {
+    _unneededSince.erase(node);
+}
+
+bool ResidencyManager::isNeeded(const SceneGraphNode& node,
+                                const glm::dvec3& cameraPosition, const Time& time) const
+{
+    const Renderable* renderable = node.renderable();
+    if (!renderable->isEnabled() || !node.isTimeFrameActive(time)) {
+        return false;
+    }
+
+    const double radius = static_cast<double>(node.boundingSphere()) * node.worldScale();
+    if (radius <= 0.0) {
+        return true;
+    }
+    const double distance = glm::distance(node.worldPosition(), cameraPosition);
+    return distance <= radius * static_cast<double>(_releaseDistance);
+}
+
+} // namespace openspace
@@ -26,6 +26,7 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/properties/property.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
@@ -62,7 +63,7 @@ documentation::Documentation Rotation::Documentation() {
 std::unique_ptr<Rotation> Rotation::createFromDictionary(
                                                       const ghoul::Dictionary& dictionary)
 {
-    documentation::testSpecificationAndThrow(Documentation(), dictionary, "Rotation");
+    documentation::testSpecificationAndThrow(Documentation, dictionary, "Rotation");
 
     const std::string& rotationType = dictionary.value<std::string>(KeyType);
     auto factory = FactoryManager::ref().factory<Rotation>();
@@ -81,20 +82,50 @@ void Rotation::requireUpdate() {
 }
 
 bool Rotation::initialize() {
+    // The properties are all added by now, and any of them might change the value
+    for (properties::Property* property : propertiesRecursive()) {
+        property->onChange([this]() { _needsUpdate = true; });
+    }
+    return true;
+}
+
+bool Rotation::isThreadSafe() const {
+    return false;
+}
+
+bool Rotation::dependsOnTime() const {
     return true;
 }
 
+bool Rotation::dependsOnExternalState() const {
+    return false;
+}
+
 const glm::dmat3& Rotation::matrix() const {
     return _cachedMatrix;
 }
 
 void Rotation::update(const UpdateData& data) {
-    if (!_needsUpdate && (data.time.j2000Seconds() == _cachedTime)) {
+    const bool isTimeCurrent =
+        !dependsOnTime() || data.time.j2000Seconds() == _cachedTime;
+    if (!_needsUpdate && isTimeCurrent && !dependsOnExternalState()) {
         return;
     }
-    _cachedMatrix = matrix(data);
+    // A parameter change sets _needsUpdate and thus also invalidates a prefetched value
+    const bool usePrefetch = !_needsUpdate && data.time.j2000Seconds() == _prefetchedTime;
+    _cachedMatrix = usePrefetch ? _prefetchedMatrix : matrix(data);
     _cachedTime = data.time.j2000Seconds();
     _needsUpdate = false;
 }
 
+void Rotation::prefetch(const UpdateData& data) {
+    // There is nothing to compute in advance if the time does not matter or if it has
+    // not changed, for example while the time is paused
+    if (!dependsOnTime() || data.time.j2000Seconds() == _cachedTime) {
+        return;
+    }
+    _prefetchedMatrix = matrix(data);
+    _prefetchedTime = data.time.j2000Seconds();
+}
+
 } // namespace openspace
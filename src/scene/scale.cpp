@@ -26,6 +26,7 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/properties/property.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/logging/logmanager.h>
@@ -59,7 +60,7 @@ documentation::Documentation Scale::Documentation() {
 }
 
 std::unique_ptr<Scale> Scale::createFromDictionary(const ghoul::Dictionary& dictionary) {
-    documentation::testSpecificationAndThrow(Documentation(), dictionary, "Scale");
+    documentation::testSpecificationAndThrow(Documentation, dictionary, "Scale");
 
     std::string scaleType = dictionary.value<std::string>(KeyType);
 
@@ -76,20 +77,50 @@ void Scale::requireUpdate() {
 }
 
 bool Scale::initialize() {
+    // The properties are all added by now, and any of them might change the value
+    for (properties::Property* property : propertiesRecursive()) {
+        property->onChange([this]() { _needsUpdate = true; });
+    }
+    return true;
+}
+
+bool Scale::isThreadSafe() const {
+    return false;
+}
+
+bool Scale::dependsOnTime() const {
     return true;
 }
 
+bool Scale::dependsOnExternalState() const {
+    return false;
+}
+
 double Scale::scaleValue() const {
     return _cachedScale;
 }
 
 void Scale::update(const UpdateData& data) {
-    if (!_needsUpdate && data.time.j2000Seconds() == _cachedTime) {
+    const bool isTimeCurrent =
+        !dependsOnTime() || data.time.j2000Seconds() == _cachedTime;
+    if (!_needsUpdate && isTimeCurrent && !dependsOnExternalState()) {
         return;
     }
-    _cachedScale = scaleValue(data);
+    // A parameter change sets _needsUpdate and thus also invalidates a prefetched value
+    const bool usePrefetch = !_needsUpdate && data.time.j2000Seconds() == _prefetchedTime;
+    _cachedScale = usePrefetch ? _prefetchedScale : scaleValue(data);
     _cachedTime = data.time.j2000Seconds();
     _needsUpdate = false;
 }
 
+void Scale::prefetch(const UpdateData& data) {
+    // There is nothing to compute in advance if the time does not matter or if it has
+    // not changed, for example while the time is paused
+    if (!dependsOnTime() || data.time.j2000Seconds() == _cachedTime) {
+        return;
+    }
+    _prefetchedScale = scaleValue(data);
+    _prefetchedTime = data.time.j2000Seconds();
+}
+
 } // namespace openspace
@@ -27,16 +27,29 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/globalscallbacks.h>
 #include <openspace/engine/windowdelegate.h>
+#include <openspace/performance/tracezone.h>
 #include <openspace/query/query.h>
+#include <openspace/rendering/depthpyramid.h>
+#include <openspace/rendering/renderable.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scene/scenelicensewriter.h>
 #include <openspace/scene/sceneinitializer.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/camera.h>
+#include <openspace/util/lazylog.h>
+#include <openspace/util/taskscheduler.h>
+#include <openspace/util/timemanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
-
+#include <ghoul/misc/exception.h>
+#include <glm/gtc/matrix_access.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
 #include <string>
 #include <stack>
 
@@ -46,6 +59,59 @@ namespace {
     constexpr const char* _loggerCat = "Scene";
     constexpr const char* KeyIdentifier = "Identifier";
     constexpr const char* KeyParent = "Parent";
+
+    // Levels with fewer nodes than this are updated on the main thread, as handing them
+    // to the worker threads would cost more than it saves
+    constexpr const size_t MinNodesForConcurrentUpdate = 32;
+
+    // The time per frame that may be spent on calling initializeGL on newly initialized
+    // nodes. Nodes that do not fit are initialized in the following frames
+    constexpr const std::chrono::milliseconds GLInitializationBudget(8);
+
+    // Converts the bit of the render bin into an index into Scene::_visibleNodes
+    size_t renderBinIndex(openspace::Renderable::RenderBin bin) {
+        using RenderBin = openspace::Renderable::RenderBin;
+        switch (bin) {
+            case RenderBin::Background:  return 0;
+            case RenderBin::Opaque:      return 1;
+            case RenderBin::Transparent: return 2;
+            case RenderBin::Overlay:     return 3;
+            default:                     throw ghoul::MissingCaseException();
+        }
+    }
+
+    // Returns the planes of the view frustum as (normal, distance) with normals pointing
+    // inwards. The far plane is left out, as the scene is rendered with very distant far
+    // planes anyway
+    std::array<glm::dvec4, 5> frustumPlanes(const glm::dmat4& viewProjection) {
+        const glm::dvec4 r0 = glm::row(viewProjection, 0);
+        const glm::dvec4 r1 = glm::row(viewProjection, 1);
+        const glm::dvec4 r2 = glm::row(viewProjection, 2);
+        const glm::dvec4 r3 = glm::row(viewProjection, 3);
+        std::array<glm::dvec4, 5> planes = {
+            r3 + r0, // left
+            r3 - r0, // right
+            r3 + r1, // bottom
+            r3 - r1, // top
+            r3 + r2  // near
+        };
+        for (glm::dvec4& p : planes) {
+            p /= glm::length(glm::dvec3(p));
+        }
+        return planes;
+    }
+
+    bool isSphereOutside(const std::array<glm::dvec4, 5>& planes,
+                         const glm::dvec3& center, double radius)
+    {
+        return std::any_of(
+            planes.begin(),
+            planes.end(),
+            [&](const glm::dvec4& p) {
+                return glm::dot(glm::dvec3(p), center) + p.w < -radius;
+            }
+        );
+    }
 } // namespace
 
 namespace openspace {
@@ -60,9 +126,29 @@ Scene::Scene(std::unique_ptr<SceneInitializer> initializer)
 {
     _rootDummy.setIdentifier(SceneGraphNode::RootNodeIdentifier);
     _rootDummy.setScene(this);
+
+    // The main thread takes part in the update, and the scheduler does not have a
+    // worker for it either
+    _nUpdateThreads = static_cast<int>(global::taskScheduler.numberOfThreads());
+
+    addPropertySubOwner(_residencyManager);
 }
 
+struct Scene::TransformPrefetch {
+    TransformPrefetch(const UpdateData& d) : data(d) {}
+
+    const UpdateData data;
+    std::vector<SceneGraphNode*> nodes;
+    std::atomic<size_t> nextNode = 0;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    int nRunning = 0;
+    bool isDone = false;
+};
+
 Scene::~Scene() {
+    finishTransformPrefetch();
     clear();
     _rootDummy.setScene(nullptr);
 }
@@ -94,6 +180,12 @@ void Scene::registerNode(SceneGraphNode* node) {
     _nodesByIdentifier[node->identifier()] = node;
     addPropertySubOwner(node);
     _dirtyNodeRegistry = true;
+
+    // A node that is moved to a new parent is unregistered and registered again. If that
+    // happens while it is waiting for its initializeGL, it has to be queued again
+    if (node->state() == SceneGraphNode::State::Initialized) {
+        _pendingGLInitialization.push_back(node);
+    }
 }
 
 void Scene::unregisterNode(SceneGraphNode* node) {
@@ -106,6 +198,17 @@ void Scene::unregisterNode(SceneGraphNode* node) {
         _topologicallySortedNodes.end()
     );
     _nodesByIdentifier.erase(node->identifier());
+    _pendingGLInitialization.erase(
+        std::remove(
+            _pendingGLInitialization.begin(),
+            _pendingGLInitialization.end(),
+            node
+        ),
+        _pendingGLInitialization.end()
+    );
+    _residencyManager.removeNode(node);
+    // The node might still be in one of the visible lists until the next culling pass
+    _hasCullingResults = false;
     // Just try to remove all properties; if the property doesn't exist, the
     // removeInterpolation will not do anything
     for (properties::Property* p : node->properties()) {
@@ -199,6 +302,31 @@ void Scene::sortTopologically() {
     }
 
     _topologicallySortedNodes = nodes;
+
+    _nodeIndices.clear();
+    for (size_t i = 0; i < _topologicallySortedNodes.size(); ++i) {
+        _nodeIndices[_topologicallySortedNodes[i]] = i;
+    }
+    _hasCullingResults = false;
+
+    // Nodes within one level do not depend on each other and can be updated in any order
+    _updateLevels.clear();
+    std::unordered_map<SceneGraphNode*, size_t> levels;
+    for (SceneGraphNode* node : _topologicallySortedNodes) {
+        size_t level = 0;
+        if (node->parent()) {
+            level = levels[node->parent()] + 1;
+        }
+        for (SceneGraphNode* dependency : node->dependencies()) {
+            level = std::max(level, levels[dependency] + 1);
+        }
+        levels[node] = level;
+
+        if (_updateLevels.size() <= level) {
+            _updateLevels.resize(level + 1);
+        }
+        _updateLevels[level].push_back(node);
+    }
 }
 
 void Scene::initializeNode(SceneGraphNode* node) {
@@ -209,6 +337,34 @@ bool Scene::isInitializing() const {
     return _initializer->isInitializing();
 }
 
+void Scene::initializePendingNodesGL(std::chrono::milliseconds budget) {
+    std::vector<SceneGraphNode*> initializedNodes = _initializer->takeInitializedNodes();
+    _pendingGLInitialization.insert(
+        _pendingGLInitialization.end(),
+        initializedNodes.begin(),
+        initializedNodes.end()
+    );
+
+    // At least one node is initialized per call
+    const auto start = std::chrono::steady_clock::now();
+    while (!_pendingGLInitialization.empty()) {
+        SceneGraphNode* node = _pendingGLInitialization.front();
+        _pendingGLInitialization.pop_front();
+        if (node->state() != SceneGraphNode::State::Initialized) {
+            continue;
+        }
+        try {
+            node->initializeGL();
+        } catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+        }
+
+        if (std::chrono::steady_clock::now() - start > budget) {
+            break;
+        }
+    }
+}
+
 /*
 void Scene::initialize() {
     bool useMultipleThreads = true;
@@ -279,23 +435,214 @@ void Scene::initializeGL() {
 */
 
 void Scene::update(const UpdateData& data) {
-    std::vector<SceneGraphNode*> initializedNodes = _initializer->takeInitializedNodes();
+    PerfTrace("Scene::update");
+    // This is usually already done at the beginning of the frame, before anything could
+    // have modified the scene graph
+    finishTransformPrefetch();
+
+    // Loading shaders and uploading textures for a large asset can take seconds, so this
+    // is spread over multiple frames
+    initializePendingNodesGL(GLInitializationBudget);
 
-    for (SceneGraphNode* node : initializedNodes) {
-        try {
-            node->initializeGL();
-        } catch (const ghoul::RuntimeError& e) {
-            LERRORC(e.component, e.message);
-        }
-    }
     if (_dirtyNodeRegistry) {
         updateNodeRegistry();
     }
+
+    // This uses the transformations of the previous frame, which is close enough to
+    // decide whether a node is needed
+    if (_camera) {
+        _residencyManager.update(
+            _topologicallySortedNodes,
+            _camera->positionVec3(),
+            data.time
+        );
+    }
+
+    // The per-node CPU timings would be distorted by the worker threads competing for
+    // the caches, so performance measurements keep to a single thread
+    if (_nUpdateThreads == 0 || data.doPerformanceMeasurement) {
+        for (SceneGraphNode* node : _topologicallySortedNodes) {
+            try {
+                LTRACE_LAZY("Scene::update(begin '" + node->identifier() + "')");
+                node->update(data);
+                LTRACE_LAZY("Scene::update(end '" + node->identifier() + "')");
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.what());
+            }
+        }
+        return;
+    }
+
+    // The frame memory must not be shared between the worker threads
+    UpdateData parallelData = data;
+    parallelData.frameMemory = std::pmr::get_default_resource();
+    for (const std::vector<SceneGraphNode*>& level : _updateLevels) {
+        updateLevel(level, parallelData);
+    }
+}
+
+void Scene::prefetchTransforms(const UpdateData& data) {
+    finishTransformPrefetch();
+    if (_dirtyNodeRegistry || _nUpdateThreads == 0) {
+        return;
+    }
+
+    auto prefetch = std::make_shared<TransformPrefetch>(data);
     for (SceneGraphNode* node : _topologicallySortedNodes) {
+        if (node->canUpdateTransformConcurrently()) {
+            prefetch->nodes.push_back(node);
+        }
+    }
+    if (prefetch->nodes.empty()) {
+        return;
+    }
+
+    // The local transformations do not depend on other nodes, so they can be computed
+    // in any order. Like in updateLevel, the helpers pull nodes from a shared index and
+    // a helper that only starts after the hand-off returns without touching the scene
+    for (int i = 0; i < _nUpdateThreads; ++i) {
+        global::taskScheduler.submit(
+            [prefetch]() {
+                {
+                    std::lock_guard<std::mutex> lock(prefetch->mutex);
+                    if (prefetch->isDone) {
+                        return;
+                    }
+                    ++prefetch->nRunning;
+                }
+                {
+                    PerfTrace("Scene::prefetchTransforms");
+                    const std::vector<SceneGraphNode*>& nodes = prefetch->nodes;
+                    for (size_t j = prefetch->nextNode++;
+                         j < nodes.size();
+                         j = prefetch->nextNode++)
+                    {
+                        nodes[j]->prefetchTransform(prefetch->data);
+                    }
+                }
+                std::lock_guard<std::mutex> lock(prefetch->mutex);
+                --prefetch->nRunning;
+                prefetch->finished.notify_one();
+            }
+        );
+    }
+    _transformPrefetch = std::move(prefetch);
+}
+
+void Scene::finishTransformPrefetch() {
+    if (!_transformPrefetch) {
+        return;
+    }
+
+    PerfTrace("Scene::finishTransformPrefetch");
+    std::unique_lock<std::mutex> lock(_transformPrefetch->mutex);
+    _transformPrefetch->isDone = true;
+    // Helpers that are still running finish their current node and then find no more
+    // work, as the remaining nodes are claimed here
+    _transformPrefetch->nextNode = _transformPrefetch->nodes.size();
+    _transformPrefetch->finished.wait(
+        lock,
+        [this]() { return _transformPrefetch->nRunning == 0; }
+    );
+    lock.unlock();
+    _transformPrefetch = nullptr;
+}
+
+void Scene::updateLevel(const std::vector<SceneGraphNode*>& level,
+                        const UpdateData& data)
+{
+    auto updateTransform = [&data](SceneGraphNode* node) {
+        try {
+            LTRACE_LAZY("Scene::updateTransform(begin '" + node->identifier() + "')");
+            node->updateTransform(data);
+            LTRACE_LAZY("Scene::updateTransform(end '" + node->identifier() + "')");
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.what());
+        }
+    };
+
+    std::vector<SceneGraphNode*> concurrentNodes;
+    if (level.size() >= MinNodesForConcurrentUpdate) {
+        concurrentNodes.reserve(level.size());
+        for (SceneGraphNode* node : level) {
+            if (node->canUpdateTransformConcurrently()) {
+                concurrentNodes.push_back(node);
+            }
+        }
+    }
+
+    if (concurrentNodes.size() < MinNodesForConcurrentUpdate) {
+        for (SceneGraphNode* node : level) {
+            updateTransform(node);
+        }
+    }
+    else {
+        // The workers and the main thread pull nodes from a shared index, so that a
+        // thread that is done with a cheap node immediately takes over the next one
+        std::atomic<size_t> nextNode(0);
+        auto work = [&]() {
+            for (size_t i = nextNode++; i < concurrentNodes.size(); i = nextNode++) {
+                updateTransform(concurrentNodes[i]);
+            }
+        };
+
+        // The helpers run on the shared scheduler and might only get a worker after
+        // the main thread is done with this level. The state they synchronize on thus
+        // outlives this function, and a helper that starts too late returns right away
+        // without touching the level
+        struct Helpers {
+            std::mutex mutex;
+            std::condition_variable finished;
+            int nRunning = 0;
+            bool isDone = false;
+        };
+        std::shared_ptr<Helpers> helpers = std::make_shared<Helpers>();
+        for (int i = 0; i < _nUpdateThreads; ++i) {
+            global::taskScheduler.submit(
+                [helpers, &work]() {
+                    {
+                        std::lock_guard<std::mutex> lock(helpers->mutex);
+                        if (helpers->isDone) {
+                            return;
+                        }
+                        ++helpers->nRunning;
+                    }
+                    {
+                        PerfTrace("Scene::updateTransforms");
+                        work();
+                    }
+                    std::lock_guard<std::mutex> lock(helpers->mutex);
+                    --helpers->nRunning;
+                    helpers->finished.notify_one();
+                },
+                TaskScheduler::Priority::High
+            );
+        }
+
+        // Nodes that are not thread-safe are updated on the main thread first, and then
+        // the main thread helps out with the rest
+        PerfTrace("Scene::updateTransforms");
+        for (SceneGraphNode* node : level) {
+            if (!node->canUpdateTransformConcurrently()) {
+                updateTransform(node);
+            }
+        }
+        work();
+
+        std::unique_lock<std::mutex> lock(helpers->mutex);
+        helpers->isDone = true;
+        helpers->finished.wait(lock, [&helpers]() { return helpers->nRunning == 0; });
+    }
+
+    // Renderables usually touch OpenGL and are therefore always updated on the main
+    // thread and in topological order
+    for (SceneGraphNode* node : level) {
         try {
-            LTRACE("Scene::update(begin '" + node->identifier() + "')");
-            node->update(data);
-            LTRACE("Scene::update(end '" + node->identifier() + "')");
+            LTRACE_LAZY("Scene::updateRenderable(begin '" + node->identifier() + "')");
+            node->updateRenderable(data);
+            LTRACE_LAZY("Scene::updateRenderable(end '" + node->identifier() + "')");
         }
         catch (const ghoul::RuntimeError& e) {
             LERRORC(e.component, e.what());
@@ -303,12 +650,140 @@ void Scene::update(const UpdateData& data) {
     }
 }
 
-void Scene::render(const RenderData& data, RendererTasks& tasks) {
-    for (SceneGraphNode* node : _topologicallySortedNodes) {
+void Scene::cull(const Camera* camera, bool useFrustumCulling,
+                 const DepthPyramid* depthPyramid)
+{
+    PerfTrace("Scene::cull");
+
+    for (std::vector<SceneGraphNode*>& nodes : _visibleNodes) {
+        nodes.clear();
+    }
+    _hasCullingResults = true;
+
+    const size_t nNodes = _topologicallySortedNodes.size();
+    std::vector<bool> isVisible(nNodes, true);
+
+    if (camera && useFrustumCulling && nNodes > 0) {
+        constexpr const double Unbounded = std::numeric_limits<double>::infinity();
+
+        // Children come after their parents in the topological order, so a reverse
+        // traversal sees all children before their parent
+        _subtreeBoundingSpheres.assign(nNodes, 0.0);
+        for (size_t i = nNodes; i-- > 0;) {
+            const SceneGraphNode* node = _topologicallySortedNodes[i];
+            const double bs = static_cast<double>(node->boundingSphere());
+            double radius = (bs > 0.0) ? bs * node->worldScale() : Unbounded;
+
+            for (const SceneGraphNode* child : node->children()) {
+                const auto it = _nodeIndices.find(child);
+                if (it == _nodeIndices.end()) {
+                    continue;
+                }
+                const double distance = glm::distance(
+                    child->worldPosition(),
+                    node->worldPosition()
+                );
+                radius = std::max(radius, distance + _subtreeBoundingSpheres[it->second]);
+            }
+            _subtreeBoundingSpheres[i] = radius;
+        }
+
+        const std::array<glm::dvec4, 5> planes = frustumPlanes(
+            glm::dmat4(camera->projectionMatrix()) * camera->combinedViewMatrix()
+        );
+
+        // Parents come first, so an invisible subtree marks all of its descendants as
+        // invisible before they are reached
+        for (size_t i = 0; i < nNodes; ++i) {
+            if (!isVisible[i]) {
+                continue;
+            }
+            SceneGraphNode* node = _topologicallySortedNodes[i];
+
+            const double subtreeRadius = _subtreeBoundingSpheres[i];
+            const bool isSubtreeOccluded = depthPyramid && subtreeRadius < Unbounded &&
+                depthPyramid->isOccluded(node->worldPosition(), subtreeRadius, *camera);
+            if (isSubtreeOccluded ||
+                isSphereOutside(planes, node->worldPosition(), subtreeRadius))
+            {
+                node->traversePreOrder([this, &isVisible](SceneGraphNode* n) {
+                    const auto it = _nodeIndices.find(n);
+                    if (it != _nodeIndices.end()) {
+                        isVisible[it->second] = false;
+                    }
+                });
+                continue;
+            }
+
+            const double bs = static_cast<double>(node->boundingSphere());
+            if (bs > 0.0) {
+                const double radius = bs * node->worldScale();
+                isVisible[i] = !isSphereOutside(planes, node->worldPosition(), radius) &&
+                    !(depthPyramid &&
+                      depthPyramid->isOccluded(node->worldPosition(), radius, *camera));
+            }
+        }
+    }
+
+    // The checks that SceneGraphNode::render would do for every render bin are done once
+    // here, so that Scene::render only has to draw the nodes in the lists
+    const Time& time = global::timeManager.time();
+    for (size_t i = 0; i < nNodes; ++i) {
+        SceneGraphNode* node = _topologicallySortedNodes[i];
+        if (isVisible[i] && node->shouldRender(time)) {
+            const Renderable::RenderBin bin = node->renderable()->renderBin();
+            _visibleNodes[renderBinIndex(bin)].push_back(node);
+        }
+    }
+
+    if (!camera) {
+        return;
+    }
+
+    // Opaque nodes are drawn front-to-back to make the most of the early depth test and
+    // transparent nodes are drawn back-to-front so that they blend correctly. The stable
+    // sort keeps the topological order for nodes at the same distance
+    const glm::dvec3 cameraPosition = camera->positionVec3();
+    auto sortByDistance = [&cameraPosition](std::vector<SceneGraphNode*>& nodes,
+                                            bool isFrontToBack)
+    {
+        std::vector<std::pair<double, SceneGraphNode*>> distances;
+        distances.reserve(nodes.size());
+        for (SceneGraphNode* node : nodes) {
+            const double d = glm::distance(cameraPosition, node->worldPosition());
+            distances.emplace_back(isFrontToBack ? d : -d, node);
+        }
+        std::stable_sort(
+            distances.begin(),
+            distances.end(),
+            [](const std::pair<double, SceneGraphNode*>& lhs,
+               const std::pair<double, SceneGraphNode*>& rhs)
+            {
+                return lhs.first < rhs.first;
+            }
+        );
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            nodes[i] = distances[i].second;
+        }
+    };
+    using RenderBin = Renderable::RenderBin;
+    sortByDistance(_visibleNodes[renderBinIndex(RenderBin::Opaque)], true);
+    sortByDistance(_visibleNodes[renderBinIndex(RenderBin::Transparent)], false);
+}
+
+void Scene::render(const RenderData& data, RendererTasks& tasks, bool useCulling) {
+    PerfTrace("Scene::render");
+
+    auto renderNode = [&data, &tasks](SceneGraphNode* node, bool isChecked) {
         try {
-            LTRACE("Scene::render(begin '" + node->identifier() + "')");
-            node->render(data, tasks);
-            LTRACE("Scene::render(end '" + node->identifier() + "')");
+            LTRACE_LAZY("Scene::render(begin '" + node->identifier() + "')");
+            if (isChecked) {
+                node->renderUnchecked(data, tasks);
+            }
+            else {
+                node->render(data, tasks);
+            }
+            LTRACE_LAZY("Scene::render(end '" + node->identifier() + "')");
         }
         catch (const ghoul::RuntimeError& e) {
             LERRORC(e.component, e.what());
@@ -316,11 +791,40 @@ void Scene::render(const RenderData& data, RendererTasks& tasks) {
         if (global::callback::webBrowserPerformanceHotfix) {
             (*global::callback::webBrowserPerformanceHotfix)();
         }
+    };
+
+    if (useCulling && _hasCullingResults) {
+        using RenderBin = Renderable::RenderBin;
+        for (RenderBin bin : { RenderBin::Background, RenderBin::Opaque,
+                               RenderBin::Transparent, RenderBin::Overlay })
+        {
+            if (data.renderBinMask & static_cast<int>(bin)) {
+                for (SceneGraphNode* node : _visibleNodes[renderBinIndex(bin)]) {
+                    renderNode(node, true);
+                }
+            }
+        }
+    }
+    else {
+        for (SceneGraphNode* node : _topologicallySortedNodes) {
+            renderNode(node, false);
+        }
+    }
+
+    for (const std::function<void()>& draw : tasks.batchedDrawTasks) {
+        try {
+            draw();
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.what());
+        }
     }
+    tasks.batchedDrawTasks.clear();
 }
 
 void Scene::clear() {
     LINFO("Clearing current scene graph");
+    finishTransformPrefetch();
     _rootDummy.clearChildren();
 }
 
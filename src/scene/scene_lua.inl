@@ -27,6 +27,7 @@
 #include <openspace/engine/openspaceengine.h>
 #include <ghoul/misc/defer.h>
 #include <ghoul/misc/easing.h>
+#include <functional>
 #include <regex>
 
 namespace openspace {
@@ -58,11 +59,67 @@ properties::PropertyOwner* findPropertyOwnerWithMatchingGroupTag(T* prop,
     return tagMatchOwner;
 }
 
-void applyRegularExpression(lua_State* L, const std::string& regex,
-                            const std::vector<properties::Property*>& properties,
-                            double interpolationDuration,
-                            const std::string& groupName,
-                            ghoul::EasingFunction easingFunction)
+// A URI with '*' wildcards that has been split at the wildcards. Matching a URI against
+// it is a sequence of substring comparisons instead of a regular expression evaluation
+class WildcardPattern {
+public:
+    explicit WildcardPattern(const std::string& pattern) {
+        size_t begin = 0;
+        size_t end = pattern.find('*');
+        while (end != std::string::npos) {
+            _segments.push_back(pattern.substr(begin, end - begin));
+            begin = end + 1;
+            end = pattern.find('*', begin);
+        }
+        _segments.push_back(pattern.substr(begin));
+    }
+
+    bool operator()(const std::string& uri) const {
+        if (_segments.size() == 1) {
+            return uri == _segments.front();
+        }
+
+        // The first segment has to be a prefix and the last segment a suffix, everything
+        // in between has to appear in order in the remaining part
+        const std::string& first = _segments.front();
+        const std::string& last = _segments.back();
+        if (uri.size() < first.size() + last.size() ||
+            uri.compare(0, first.size(), first) != 0 ||
+            uri.compare(uri.size() - last.size(), last.size(), last) != 0)
+        {
+            return false;
+        }
+
+        size_t pos = first.size();
+        const size_t end = uri.size() - last.size();
+        for (size_t i = 1; i < _segments.size() - 1; ++i) {
+            const size_t p = uri.find(_segments[i], pos);
+            if (p == std::string::npos || p + _segments[i].size() > end) {
+                return false;
+            }
+            pos = p + _segments[i].size();
+        }
+        return true;
+    }
+
+    // Returns whether the wildcard expression has the same meaning as the regular
+    // expression that is created by replacing every '*' with '(.*)'. This is the case if
+    // there are no special characters other than the '.', which only occur as
+    // separators in a URI
+    static bool isEquivalentToRegex(const std::string& pattern) {
+        return pattern.find_first_of("[](){}+?|^$\\") == std::string::npos;
+    }
+
+private:
+    std::vector<std::string> _segments;
+};
+
+void applyMatchingProperties(lua_State* L, const std::string& pattern,
+                             const std::function<bool(const std::string&)>& matches,
+                             const std::vector<properties::Property*>& properties,
+                             double interpolationDuration,
+                             const std::string& groupName,
+                             ghoul::EasingFunction easingFunction)
 {
     using ghoul::lua::errorLocation;
     using ghoul::lua::luaTypeToString;
@@ -74,14 +131,13 @@ void applyRegularExpression(lua_State* L, const std::string& regex,
     // Stores whether we found at least one matching property. If this is false at the end
     // of the loop, the property name regex was probably misspelled.
     bool foundMatching = false;
-    std::regex r(regex);
     for (properties::Property* prop : properties) {
-        // Check the regular expression for all properties
+        // Check the pattern for all properties
         const std::string& id = prop->fullyQualifiedIdentifier();
 
-        if (std::regex_match(id, r)) {
-            // If the fully qualified id matches the regular expression, we queue the
-            // value change if the types agree
+        if (matches(id)) {
+            // If the fully qualified id matches the pattern, we queue the value change if
+            // the types agree
             if (isGroupMode) {
                 properties::PropertyOwner* matchingTaggedOwner =
                     findPropertyOwnerWithMatchingGroupTag(
@@ -130,12 +186,30 @@ void applyRegularExpression(lua_State* L, const std::string& regex,
             fmt::format(
                 "{}: No property matched the requested URI '{}'",
                 errorLocation(L),
-                regex
+                pattern
             )
         );
     }
 }
 
+void applyRegularExpression(lua_State* L, const std::string& regex,
+                            const std::vector<properties::Property*>& properties,
+                            double interpolationDuration,
+                            const std::string& groupName,
+                            ghoul::EasingFunction easingFunction)
+{
+    const std::regex r(regex);
+    applyMatchingProperties(
+        L,
+        regex,
+        [&r](const std::string& id) { return std::regex_match(id, r); },
+        properties,
+        interpolationDuration,
+        groupName,
+        easingFunction
+    );
+}
+
 // Checks to see if URI contains a group tag (with { } around the first term). If so,
 // returns true and sets groupName with the tag
 bool doesUriContainGroupTag(const std::string& command, std::string& groupName) {
@@ -272,6 +346,40 @@ int property_setValue(lua_State* L) {
     }
 
     if (optimization.empty()) {
+        std::string groupName;
+        const bool hasGroupTag = doesUriContainGroupTag(uriOrRegex, groupName);
+        const std::string pattern = hasGroupTag ?
+            "*" + extractUriWithoutGroupName(uriOrRegex) :
+            uriOrRegex;
+
+        if (WildcardPattern::isEquivalentToRegex(pattern)) {
+            // Without a wildcard, the URI names at most one property, which the root
+            // owner's index can find directly
+            properties::Property* prop = (pattern.find('*') == std::string::npos) ?
+                property(pattern) :
+                nullptr;
+            if (prop) {
+                return setPropertyCall_single(
+                    *prop,
+                    pattern,
+                    L,
+                    interpolationDuration,
+                    easingMethod
+                );
+            }
+
+            applyMatchingProperties(
+                L,
+                uriOrRegex,
+                WildcardPattern(pattern),
+                allProperties(),
+                interpolationDuration,
+                groupName,
+                easingMethod
+            );
+            return 0;
+        }
+
         // Replace all wildcards * with the correct regex (.*)
         size_t startPos = uriOrRegex.find("*");
         while (startPos != std::string::npos) {
@@ -280,9 +388,7 @@ int property_setValue(lua_State* L) {
             startPos = uriOrRegex.find("*", startPos);
         }
 
-        std::string groupName;
-        if (doesUriContainGroupTag(uriOrRegex, groupName)) {
-            std::string pathRemainderToMatch = extractUriWithoutGroupName(uriOrRegex);
+        if (hasGroupTag) {
             // Remove group name from start of regex and replace with '.*'
             uriOrRegex = replaceUriWithGroupName(uriOrRegex, ".*");
         }
@@ -87,7 +87,7 @@ std::unique_ptr<SceneGraphNode> SceneGraphNode::createFromDictionary(
                                                       const ghoul::Dictionary& dictionary)
 {
     openspace::documentation::testSpecificationAndThrow(
-        SceneGraphNode::Documentation(),
+        SceneGraphNode::Documentation,
         dictionary,
         "SceneGraphNode"
     );
@@ -278,6 +278,36 @@ void SceneGraphNode::initializeGL() {
     LDEBUG(fmt::format("Finished initializating GL: {}", identifier()));
 }
 
+SceneGraphNode::State SceneGraphNode::state() const {
+    return _state;
+}
+
+void SceneGraphNode::releaseGL() {
+    if (_isGLReleased || _state != State::GLInitialized || !_renderable ||
+        !_renderable->canReleaseGLResources())
+    {
+        return;
+    }
+
+    LDEBUG(fmt::format("Releasing GL resources: {}", identifier()));
+    _renderable->releaseGLResources();
+    _isGLReleased = true;
+}
+
+void SceneGraphNode::restoreGL() {
+    if (!_isGLReleased) {
+        return;
+    }
+
+    LDEBUG(fmt::format("Restoring GL resources: {}", identifier()));
+    _isGLReleased = false;
+    _renderable->restoreGLResources();
+}
+
+bool SceneGraphNode::isGLReleased() const {
+    return _isGLReleased;
+}
+
 void SceneGraphNode::deinitialize() {
     LDEBUG(fmt::format("Deinitializing: {}", identifier()));
 
@@ -298,6 +328,7 @@ void SceneGraphNode::deinitializeGL() {
     if (_renderable) {
         _renderable->deinitializeGL();
     }
+    _renderTimer.deinitialize();
 
     LDEBUG(fmt::format("Finished deinitializing GL: {}", identifier()));
 }
@@ -317,6 +348,39 @@ void SceneGraphNode::traversePostOrder(const std::function<void(SceneGraphNode*)
 }
 
 void SceneGraphNode::update(const UpdateData& data) {
+    updateTransform(data);
+    updateRenderable(data);
+}
+
+bool SceneGraphNode::canUpdateTransformConcurrently() const {
+    return (!_transform.translation || _transform.translation->isThreadSafe()) &&
+           (!_transform.rotation || _transform.rotation->isThreadSafe()) &&
+           (!_transform.scale || _transform.scale->isThreadSafe());
+}
+
+void SceneGraphNode::prefetchTransform(const UpdateData& data) {
+    State s = _state;
+    if (s != State::Initialized && s != State::GLInitialized) {
+        return;
+    }
+
+    // Errors are not reported here, as they will be reported by the regular update if
+    // the time is actually reached
+    try {
+        if (_transform.translation) {
+            _transform.translation->prefetch(data);
+        }
+        if (_transform.rotation) {
+            _transform.rotation->prefetch(data);
+        }
+        if (_transform.scale) {
+            _transform.scale->prefetch(data);
+        }
+    }
+    catch (const ghoul::RuntimeError&) {}
+}
+
+void SceneGraphNode::updateTransform(const UpdateData& data) {
     State s = _state;
     if (s != State::Initialized && _state != State::GLInitialized) {
         return;
@@ -327,12 +391,10 @@ void SceneGraphNode::update(const UpdateData& data) {
 
     if (_transform.translation) {
         if (data.doPerformanceMeasurement) {
-            glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
             _transform.translation->update(data);
 
-            glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeTranslation = (end - start).count();
         }
@@ -343,12 +405,10 @@ void SceneGraphNode::update(const UpdateData& data) {
 
     if (_transform.rotation) {
         if (data.doPerformanceMeasurement) {
-            glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
             _transform.rotation->update(data);
 
-            glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeRotation = (end - start).count();
         }
@@ -359,12 +419,10 @@ void SceneGraphNode::update(const UpdateData& data) {
 
     if (_transform.scale) {
         if (data.doPerformanceMeasurement) {
-            glFinish();
             const auto start = std::chrono::high_resolution_clock::now();
 
             _transform.scale->update(data);
 
-            glFinish();
             const auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeScaling = (end - start).count();
         }
@@ -372,42 +430,74 @@ void SceneGraphNode::update(const UpdateData& data) {
             _transform.scale->update(data);
         }
     }
-    UpdateData newUpdateData = data;
 
-    _worldRotationCached = calculateWorldRotation();
-    _worldScaleCached = calculateWorldScale();
-    // Assumes _worldRotationCached and _worldScaleCached have been calculated for parent
-    _worldPositionCached = calculateWorldPosition();
+    // A parent is always updated before its children, so the world transform only needs
+    // to be recomputed if the local transform or the parent's world transform changed.
+    // This avoids both the walk up the hierarchy and the matrix inversion for the large
+    // number of nodes that are at rest
+    const glm::dvec3 localPosition = position();
+    const glm::dmat3 localRotation = rotationMatrix();
+    const double localScale = scale();
+    const uint64_t parentVersion = _parent ? _parent->_worldTransformVersion : 0;
+    const bool isUnchanged = _worldTransformVersion != 0 &&
+        _parent == _worldTransformParent &&
+        parentVersion == _parentWorldTransformVersion &&
+        localPosition == _localPositionCached &&
+        localRotation == _localRotationCached &&
+        localScale == _localScaleCached;
+    if (isUnchanged) {
+        return;
+    }
+    _worldTransformParent = _parent;
+    _parentWorldTransformVersion = parentVersion;
+    _localPositionCached = localPosition;
+    _localRotationCached = localRotation;
+    _localScaleCached = localScale;
+    ++_worldTransformVersion;
 
-    newUpdateData.modelTransform.translation = worldPosition();
-    newUpdateData.modelTransform.rotation = worldRotationMatrix();
-    newUpdateData.modelTransform.scale = worldScale();
+    if (_parent) {
+        _worldRotationCached = _parent->_worldRotationCached * localRotation;
+        _worldScaleCached = _parent->_worldScaleCached * localScale;
+        _worldPositionCached = _parent->_worldPositionCached +
+            _parent->_worldRotationCached * _parent->_worldScaleCached * localPosition;
+    }
+    else {
+        _worldRotationCached = localRotation;
+        _worldScaleCached = localScale;
+        _worldPositionCached = localPosition;
+    }
 
-    glm::dmat4 translation = glm::translate(
-        glm::dmat4(1.0),
-        newUpdateData.modelTransform.translation
-    );
-    glm::dmat4 rotation = glm::dmat4(newUpdateData.modelTransform.rotation);
+    glm::dmat4 translation = glm::translate(glm::dmat4(1.0), _worldPositionCached);
+    glm::dmat4 rotation = glm::dmat4(_worldRotationCached);
     glm::dmat4 scaling = glm::scale(
         glm::dmat4(1.0),
-        glm::dvec3(
-            newUpdateData.modelTransform.scale,
-            newUpdateData.modelTransform.scale,
-            newUpdateData.modelTransform.scale
-        )
+        glm::dvec3(_worldScaleCached, _worldScaleCached, _worldScaleCached)
     );
 
     _modelTransformCached = translation * rotation * scaling;
     _inverseModelTransformCached = glm::inverse(_modelTransformCached);
+}
 
-    if (_renderable && _renderable->isReady()) {
+void SceneGraphNode::updateRenderable(const UpdateData& data) {
+    State s = _state;
+    if (s != State::Initialized && _state != State::GLInitialized) {
+        return;
+    }
+    if (!isTimeFrameActive(data.time)) {
+        return;
+    }
+
+    UpdateData newUpdateData = data;
+    newUpdateData.modelTransform.translation = worldPosition();
+    newUpdateData.modelTransform.rotation = worldRotationMatrix();
+    newUpdateData.modelTransform.scale = worldScale();
+
+    if (_renderable && !_isGLReleased && _renderable->isReady()) {
         if (data.doPerformanceMeasurement) {
-            glFinish();
             auto start = std::chrono::high_resolution_clock::now();
 
             _renderable->update(newUpdateData);
 
-            glFinish();
             auto end = std::chrono::high_resolution_clock::now();
             _performanceRecord.updateTimeRenderable = (end - start).count();
         }
@@ -418,40 +508,44 @@ void SceneGraphNode::update(const UpdateData& data) {
 }
 
 void SceneGraphNode::render(const RenderData& data, RendererTasks& tasks) {
-    if (_state != State::GLInitialized) {
-        return;
+    if (shouldRender(data.time) && _renderable->matchesRenderBinMask(data.renderBinMask))
+    {
+        renderUnchecked(data, tasks);
     }
+}
+
+bool SceneGraphNode::shouldRender(const Time& time) const {
+    return _state == State::GLInitialized &&
+           !_isGLReleased &&
+           isTimeFrameActive(time) &&
+           _renderable &&
+           _renderable->isVisible() &&
+           _renderable->isReady() &&
+           _renderable->isEnabled();
+}
 
+void SceneGraphNode::renderUnchecked(const RenderData& data, RendererTasks& tasks) {
     RenderData newData = {
         data.camera,
         data.time,
         data.doPerformanceMeasurement,
         data.renderBinMask,
-        { _worldPositionCached, _worldRotationCached, _worldScaleCached }
+        { _worldPositionCached, _worldRotationCached, _worldScaleCached },
+        data.frameMemory,
+        data.depthPyramid
     };
 
-    if (!isTimeFrameActive(data.time)) {
-        return;
-    }
-
-    bool visible = _renderable &&
-                   _renderable->isVisible() &&
-                   _renderable->isReady() &&
-                   _renderable->isEnabled() &&
-                   _renderable->matchesRenderBinMask(data.renderBinMask);
-
-    if (!visible) {
-        return;
-    }
-
     if (data.doPerformanceMeasurement) {
-        glFinish();
+        // The GPU time is measured asynchronously and is therefore reported a few
+        // frames late, but measuring it does not stall the pipeline
+        _performanceRecord.renderTimeGpu = _renderTimer.latestResult();
+        _renderTimer.begin();
         auto start = std::chrono::high_resolution_clock::now();
 
         _renderable->render(newData, tasks);
 
-        glFinish();
         auto end = std::chrono::high_resolution_clock::now();
+        _renderTimer.end();
         _performanceRecord.renderTime = (end - start).count();
     }
     else {
@@ -30,10 +30,22 @@
 #include <openspace/scene/scenegraphnode.h>
 #include <ghoul/logging/logmanager.h>
 
+namespace {
+    std::chrono::microseconds timeSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start
+        );
+    }
+} // namespace
+
 namespace openspace {
 
+void SceneInitializer::setExpectedInitializationTimes(Durations) {}
+
 void SingleThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
+    const auto start = std::chrono::steady_clock::now();
     node->initialize();
+    _initializationTimes[node->identifier()] = timeSince(start);
     _initializedNodes.push_back(node);
 }
 
@@ -46,40 +58,63 @@ bool SingleThreadedSceneInitializer::isInitializing() const {
     return false;
 }
 
+SceneInitializer::Durations SingleThreadedSceneInitializer::initializationTimes() const {
+    return _initializationTimes;
+}
+
+bool MultiThreadedSceneInitializer::PendingNode::operator<(const PendingNode& rhs) const
+{
+    if (expectedTime != rhs.expectedTime) {
+        return expectedTime < rhs.expectedTime;
+    }
+    return arrival > rhs.arrival;
+}
+
 MultiThreadedSceneInitializer::MultiThreadedSceneInitializer(unsigned int nThreads)
     : _threadPool(nThreads)
 {}
 
-void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
-    auto initFunction = [this, node]() {
-        LoadingScreen* loadingScreen = global::openSpaceEngine.loadingScreen();
-
-        LoadingScreen::ProgressInfo progressInfo;
-        progressInfo.progress = 1.f;
-        if (loadingScreen) {
-            loadingScreen->updateItem(
-                node->identifier(),
-                node->guiName(),
-                LoadingScreen::ItemStatus::Initializing,
-                progressInfo
-            );
-        }
-
-        node->initialize();
+void MultiThreadedSceneInitializer::initializeNextNode() {
+    SceneGraphNode* node = nullptr;
+    {
         std::lock_guard<std::mutex> g(_mutex);
-        _initializedNodes.push_back(node);
-        _initializingNodes.erase(node);
-
-        if (loadingScreen) {
-            loadingScreen->updateItem(
-                node->identifier(),
-                node->guiName(),
-                LoadingScreen::ItemStatus::Finished,
-                progressInfo
-            );
-        }
-    };
+        node = _pendingNodes.top().node;
+        _pendingNodes.pop();
+    }
+
+    LoadingScreen* loadingScreen = global::openSpaceEngine.loadingScreen();
+
+    LoadingScreen::ProgressInfo progressInfo;
+    progressInfo.progress = 1.f;
+    if (loadingScreen) {
+        loadingScreen->updateItem(
+            node->identifier(),
+            node->guiName(),
+            LoadingScreen::ItemStatus::Initializing,
+            progressInfo
+        );
+    }
 
+    const auto start = std::chrono::steady_clock::now();
+    node->initialize();
+    const std::chrono::microseconds duration = timeSince(start);
+
+    std::lock_guard<std::mutex> g(_mutex);
+    _initializedNodes.push_back(node);
+    _initializingNodes.erase(node);
+    _initializationTimes[node->identifier()] = duration;
+
+    if (loadingScreen) {
+        loadingScreen->updateItem(
+            node->identifier(),
+            node->guiName(),
+            LoadingScreen::ItemStatus::Finished,
+            progressInfo
+        );
+    }
+}
+
+void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
     LoadingScreen::ProgressInfo progressInfo;
     progressInfo.progress = 0.f;
 
@@ -96,7 +131,14 @@ void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
 
     std::lock_guard<std::mutex> g(_mutex);
     _initializingNodes.insert(node);
-    _threadPool.enqueue(initFunction);
+
+    // Every task initializes whichever pending node is expected to take the longest at
+    // the time it starts, which is not necessarily the node that was added here
+    auto it = _expectedTimes.find(node->identifier());
+    const std::chrono::microseconds expected =
+        it != _expectedTimes.end() ? it->second : std::chrono::microseconds(0);
+    _pendingNodes.push({ expected, _nArrivedNodes++, node });
+    _threadPool.enqueue([this]() { initializeNextNode(); });
 }
 
 std::vector<SceneGraphNode*> MultiThreadedSceneInitializer::takeInitializedNodes() {
@@ -110,4 +152,14 @@ bool MultiThreadedSceneInitializer::isInitializing() const {
     return !_initializingNodes.empty();
 }
 
+SceneInitializer::Durations MultiThreadedSceneInitializer::initializationTimes() const {
+    std::lock_guard<std::mutex> g(_mutex);
+    return _initializationTimes;
+}
+
+void MultiThreadedSceneInitializer::setExpectedInitializationTimes(Durations times) {
+    std::lock_guard<std::mutex> g(_mutex);
+    _expectedTimes = std::move(times);
+}
+
 } // namespace openspace
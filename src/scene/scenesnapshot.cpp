@@ -0,0 +1,145 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/scene/scenesnapshot.h>
+
+#include <openspace/openspace.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
+#include <openspace/util/openspacemodule.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    constexpr const char* Header = "OpenSpace scene snapshot";
+
+    // A different build might initialize the nodes in an entirely different way
+    std::string buildKey() {
+        std::string key = std::string(OPENSPACE_VERSION_STRING_FULL) + ' ' +
+                          std::string(OPENSPACE_GIT_FULL);
+        for (openspace::OpenSpaceModule* m : openspace::global::moduleEngine.modules()) {
+            key += ' ' + m->identifier();
+        }
+        return key;
+    }
+} // namespace
+
+namespace openspace {
+
+std::string SceneSnapshot::file(const std::string& assetPath) {
+    return FileSys.cacheManager()->cachedFilename(
+        "scenesnapshot",
+        std::to_string(std::hash<std::string>()(assetPath)),
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+}
+
+SceneSnapshot::Dependency SceneSnapshot::dependency(std::string path) {
+    std::ifstream file(path, std::ifstream::binary);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string content = buffer.str();
+
+    Dependency d;
+    d.path = std::move(path);
+    d.size = content.size();
+    d.hash = std::hash<std::string>()(content);
+    return d;
+}
+
+bool SceneSnapshot::read(const std::string& path) {
+    dependencies.clear();
+    nodes.clear();
+
+    std::ifstream file(path);
+    std::string header;
+    std::string key;
+    if (!std::getline(file, header) || header != Header ||
+        !std::getline(file, key) || key != buildKey())
+    {
+        return false;
+    }
+
+    size_t nDependencies = 0;
+    file >> nDependencies;
+    for (size_t i = 0; i < nDependencies && file.good(); ++i) {
+        Dependency d;
+        file >> d.size >> d.hash >> std::ws;
+        std::getline(file, d.path);
+        dependencies.push_back(std::move(d));
+    }
+
+    size_t nNodes = 0;
+    file >> nNodes;
+    for (size_t i = 0; i < nNodes && file.good(); ++i) {
+        Node n;
+        long long microseconds = 0;
+        file >> microseconds >> n.identifier;
+        n.initializationTime = std::chrono::microseconds(microseconds);
+        nodes.push_back(std::move(n));
+    }
+
+    // A snapshot that was cut short can not vouch for the dependencies it is missing
+    return !file.fail() && dependencies.size() == nDependencies &&
+           nodes.size() == nNodes;
+}
+
+bool SceneSnapshot::write(const std::string& path) const {
+    // The snapshot is replaced in one step, so that a crash while writing it does not
+    // leave a partial snapshot behind
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ofstream::trunc);
+        file << Header << '\n' << buildKey() << '\n';
+
+        file << dependencies.size() << '\n';
+        for (const Dependency& d : dependencies) {
+            file << d.size << ' ' << d.hash << ' ' << d.path << '\n';
+        }
+        file << nodes.size() << '\n';
+        for (const Node& n : nodes) {
+            file << n.initializationTime.count() << ' ' << n.identifier << '\n';
+        }
+        if (!file.good()) {
+            return false;
+        }
+    }
+
+    FileSys.deleteFile(path);
+    return rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool SceneSnapshot::isCurrent() const {
+    for (const Dependency& d : dependencies) {
+        const Dependency current = dependency(d.path);
+        if (current.size != d.size || current.hash != d.hash) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace openspace
@@ -25,6 +25,7 @@
 #include <openspace/scene/translation.h>
 
 #include <openspace/documentation/verifier.h>
+#include <openspace/properties/property.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/updatestructures.h>
 
@@ -61,7 +62,7 @@ documentation::Documentation Translation::Documentation() {
 std::unique_ptr<Translation> Translation::createFromDictionary(
                                                       const ghoul::Dictionary& dictionary)
 {
-    documentation::testSpecificationAndThrow(Documentation(), dictionary, "Translation");
+    documentation::testSpecificationAndThrow(Documentation, dictionary, "Translation");
 
     const std::string& translationType = dictionary.value<std::string>(KeyType);
     ghoul::TemplateFactory<Translation>* factory
@@ -74,15 +75,23 @@ std::unique_ptr<Translation> Translation::createFromDictionary(
 Translation::Translation() : properties::PropertyOwner({ "Translation" }) {}
 
 bool Translation::initialize() {
+    // The properties are all added by now, and any of them might change the value
+    for (properties::Property* property : propertiesRecursive()) {
+        property->onChange([this]() { _needsUpdate = true; });
+    }
     return true;
 }
 
 void Translation::update(const UpdateData& data) {
-    if (!_needsUpdate && data.time.j2000Seconds() == _cachedTime) {
+    const bool isTimeCurrent =
+        !dependsOnTime() || data.time.j2000Seconds() == _cachedTime;
+    if (!_needsUpdate && isTimeCurrent && !dependsOnExternalState()) {
         return;
     }
     const glm::dvec3 oldPosition = _cachedPosition;
-    _cachedPosition = position(data);
+    // A parameter change sets _needsUpdate and thus also invalidates a prefetched value
+    const bool usePrefetch = !_needsUpdate && data.time.j2000Seconds() == _prefetchedTime;
+    _cachedPosition = usePrefetch ? _prefetchedPosition : position(data);
     _cachedTime = data.time.j2000Seconds();
     _needsUpdate = false;
 
@@ -91,10 +100,32 @@ void Translation::update(const UpdateData& data) {
     }
 }
 
+void Translation::prefetch(const UpdateData& data) {
+    // There is nothing to compute in advance if the time does not matter or if it has
+    // not changed, for example while the time is paused
+    if (!dependsOnTime() || data.time.j2000Seconds() == _cachedTime) {
+        return;
+    }
+    _prefetchedPosition = position(data);
+    _prefetchedTime = data.time.j2000Seconds();
+}
+
 glm::dvec3 Translation::position() const {
     return _cachedPosition;
 }
 
+bool Translation::isThreadSafe() const {
+    return false;
+}
+
+bool Translation::dependsOnTime() const {
+    return true;
+}
+
+bool Translation::dependsOnExternalState() const {
+    return false;
+}
+
 void Translation::notifyObservers() const {
     if (_onParameterChangeCallback) {
         _onParameterChangeCallback();
@@ -28,11 +28,18 @@
 #include <openspace/engine/globals.h>
 #include <openspace/interaction/sessionrecording.h>
 #include <openspace/network/parallelpeer.h>
+#include <openspace/properties/property.h>
+#include <openspace/query/query.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/scene/scene.h>
 #include <openspace/util/syncbuffer.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/defer.h>
+#include <cctype>
 #include <fstream>
+#include <optional>
 
 #include "scriptengine_lua.inl"
 
@@ -40,6 +47,106 @@ namespace {
     constexpr const char* _loggerCat = "ScriptEngine";
 
     constexpr const int TableOffset = -3; // top-first argument-second argument
+
+    // The number of compiled chunks that are kept around for scripts that are repeated
+    constexpr const size_t CompiledScriptCacheSize = 256;
+
+    constexpr const std::string_view SetPropertySingleCall =
+        "openspace.setPropertyValueSingle";
+
+    struct PropertyAssignment {
+        std::string_view uri;
+        // Either a quoted string literal, or the unquoted token of any other literal
+        std::string_view value;
+        bool isString = false;
+    };
+
+    // The error object on top of the stack is usually, but not necessarily, a string
+    std::string luaError(lua_State* state) {
+        const char* message = lua_tostring(state, -1);
+        return message ? message : "Unknown error";
+    }
+
+    void skipWhitespace(std::string_view s, size_t& pos) {
+        while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) {
+            ++pos;
+        }
+    }
+
+    // Extracts a string literal without escape sequences starting at pos
+    bool parseStringLiteral(std::string_view s, size_t& pos, std::string_view& result) {
+        if (pos >= s.size() || (s[pos] != '"' && s[pos] != '\'')) {
+            return false;
+        }
+        const size_t end = s.find(s[pos], pos + 1);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+        result = s.substr(pos + 1, end - pos - 1);
+        if (result.find_first_of("\\\n") != std::string_view::npos) {
+            return false;
+        }
+        pos = end + 1;
+        return true;
+    }
+
+    // Recognizes scripts of the form  openspace.setPropertyValueSingle("uri", value);
+    std::optional<PropertyAssignment> parsePropertyAssignment(std::string_view script) {
+        size_t pos = 0;
+        skipWhitespace(script, pos);
+        if (script.substr(pos, SetPropertySingleCall.size()) != SetPropertySingleCall) {
+            return std::nullopt;
+        }
+        pos += SetPropertySingleCall.size();
+        skipWhitespace(script, pos);
+        if (pos >= script.size() || script[pos] != '(') {
+            return std::nullopt;
+        }
+        ++pos;
+        skipWhitespace(script, pos);
+
+        PropertyAssignment result;
+        if (!parseStringLiteral(script, pos, result.uri)) {
+            return std::nullopt;
+        }
+        skipWhitespace(script, pos);
+        if (pos >= script.size() || script[pos] != ',') {
+            return std::nullopt;
+        }
+        ++pos;
+        skipWhitespace(script, pos);
+
+        if (pos < script.size() && (script[pos] == '"' || script[pos] == '\'')) {
+            if (!parseStringLiteral(script, pos, result.value)) {
+                return std::nullopt;
+            }
+            result.isString = true;
+        }
+        else {
+            const size_t begin = pos;
+            while (pos < script.size() && script[pos] != ')' && script[pos] != ',' &&
+                   !std::isspace(static_cast<unsigned char>(script[pos])))
+            {
+                ++pos;
+            }
+            result.value = script.substr(begin, pos - begin);
+        }
+
+        skipWhitespace(script, pos);
+        if (pos >= script.size() || script[pos] != ')') {
+            return std::nullopt;
+        }
+        ++pos;
+        skipWhitespace(script, pos);
+        if (pos < script.size() && script[pos] == ';') {
+            ++pos;
+            skipWhitespace(script, pos);
+        }
+        if (pos != script.size()) {
+            return std::nullopt;
+        }
+        return result;
+    }
 } // namespace
 
 namespace openspace::scripting {
@@ -63,6 +170,7 @@ void ScriptEngine::initialize() {
 }
 
 void ScriptEngine::deinitialize() {
+    clearCompiledScripts();
     _registeredLibraries.clear();
 }
 
@@ -101,6 +209,7 @@ void ScriptEngine::addLibrary(LuaLibrary library) {
     if (it == _registeredLibraries.end()) {
         // If not, we can add it after we sorted it
         std::sort(library.functions.begin(), library.functions.end(), sortFunc);
+        indexLibraryFunctions(library);
         _registeredLibraries.push_back(std::move(library));
         std::sort(_registeredLibraries.begin(), _registeredLibraries.end());
     }
@@ -139,6 +248,7 @@ void ScriptEngine::addLibrary(LuaLibrary library) {
 
         // Sort the merged library before inserting it
         std::sort(merged.functions.begin(), merged.functions.end(), sortFunc);
+        indexLibraryFunctions(merged);
         _registeredLibraries.push_back(std::move(merged));
         std::sort(_registeredLibraries.begin(), _registeredLibraries.end());
     }
@@ -164,14 +274,17 @@ bool ScriptEngine::runScript(const std::string& script, ScriptCallback callback)
         writeLog(script);
     }
 
-    try {
-        if (callback) {
-            ghoul::Dictionary returnValue =
-                ghoul::lua::loadArrayDictionaryFromString(script, _state);
-            callback.value()(returnValue);
-        } else {
-            ghoul::lua::runScript(_state, script);
+    if (!callback) {
+        if (applyPropertyAssignment(script)) {
+            return true;
         }
+        return runCompiledScript(script);
+    }
+
+    try {
+        ghoul::Dictionary returnValue =
+            ghoul::lua::loadArrayDictionaryFromString(script, _state);
+        callback.value()(returnValue);
     }
     catch (const ghoul::lua::LuaLoadingException& e) {
         LERRORC(e.component, e.message);
@@ -189,6 +302,100 @@ bool ScriptEngine::runScript(const std::string& script, ScriptCallback callback)
     return true;
 }
 
+bool ScriptEngine::applyPropertyAssignment(const std::string& script) {
+    std::optional<PropertyAssignment> assignment = parsePropertyAssignment(script);
+    if (!assignment) {
+        return false;
+    }
+    // Wildcards and group tags have to be resolved by the full Lua function
+    if (assignment->uri.find_first_of("*{") != std::string_view::npos) {
+        return false;
+    }
+
+    Scene* scene = global::renderEngine.scene();
+    properties::Property* prop = property(std::string(assignment->uri));
+    if (!scene || !prop) {
+        // The Lua function is in charge of reporting the missing property
+        return false;
+    }
+
+    const int top = lua_gettop(_state);
+    defer { lua_settop(_state, top); };
+
+    if (assignment->isString) {
+        lua_pushlstring(_state, assignment->value.data(), assignment->value.size());
+    }
+    else if (assignment->value == "true" || assignment->value == "false") {
+        lua_pushboolean(_state, assignment->value == "true");
+    }
+    else if (lua_stringtonumber(_state, std::string(assignment->value).c_str()) == 0) {
+        // Any other value might be an expression that needs the interpreter
+        return false;
+    }
+
+    if (lua_type(_state, -1) != prop->typeLua()) {
+        // The Lua function is in charge of reporting the type mismatch
+        return false;
+    }
+
+    // This is what setPropertyValueSingle does for a value without interpolation
+    scene->removePropertyInterpolation(prop);
+    prop->setLuaValue(_state);
+    return true;
+}
+
+bool ScriptEngine::runCompiledScript(const std::string& script) {
+    const int top = lua_gettop(_state);
+    defer { lua_settop(_state, top); };
+
+    const auto it = _compiledScriptIndex.find(script);
+    if (it != _compiledScriptIndex.end()) {
+        _compiledScripts.splice(_compiledScripts.begin(), _compiledScripts, it->second);
+        lua_rawgeti(_state, LUA_REGISTRYINDEX, it->second->reference);
+    }
+    else {
+        // Use the script itself as the chunk name, like luaL_loadstring does, so that
+        // error messages look the same as before
+        const int status = luaL_loadbuffer(
+            _state,
+            script.data(),
+            script.size(),
+            script.c_str()
+        );
+        if (status != LUA_OK) {
+            LERRORC("Lua", fmt::format("Error loading script: {}", luaError(_state)));
+            return false;
+        }
+
+        if (_compiledScripts.size() >= CompiledScriptCacheSize) {
+            const CompiledScript& oldest = _compiledScripts.back();
+            luaL_unref(_state, LUA_REGISTRYINDEX, oldest.reference);
+            _compiledScriptIndex.erase(oldest.source);
+            _compiledScripts.pop_back();
+        }
+
+        // Keep one copy of the chunk on the stack for the call below
+        lua_pushvalue(_state, -1);
+        const int reference = luaL_ref(_state, LUA_REGISTRYINDEX);
+        _compiledScripts.push_front({ script, reference });
+        _compiledScriptIndex[_compiledScripts.front().source] = _compiledScripts.begin();
+    }
+
+    if (lua_pcall(_state, 0, 0, 0) != LUA_OK) {
+        LERRORC("Lua", fmt::format("Error executing script: {}", luaError(_state)));
+        return false;
+    }
+    return true;
+}
+
+void ScriptEngine::clearCompiledScripts() {
+    for (const CompiledScript& script : _compiledScripts) {
+        luaL_unref(_state, LUA_REGISTRYINDEX, script.reference);
+    }
+    _compiledScriptIndex.clear();
+    _compiledScripts.clear();
+}
+
 bool ScriptEngine::runScriptFile(const std::string& filename) {
     if (filename.empty()) {
         LWARNING("Filename was empty");
@@ -327,6 +534,11 @@ void ScriptEngine::addLibraryFunctions(lua_State* state, LuaLibrary& library,
         }
         lua_pop(state, 1);
     }
+
+    // The functions that are defined in the scripts are only known from now on
+    if (!library.scripts.empty()) {
+        indexLibraryFunctions(library);
+    }
 }
 
 void ScriptEngine::addBaseLibrary() {
@@ -546,6 +758,26 @@ std::vector<std::string> ScriptEngine::allLuaFunctions() const {
     return result;
 }
 
+std::vector<PrefixTrie::Completion> ScriptEngine::luaFunctionCompletions(
+                                                            std::string_view prefix) const
+{
+    return _functionIndex.completions(prefix);
+}
+
+void ScriptEngine::indexLibraryFunctions(const LuaLibrary& library) {
+    std::string prefix = std::string(OpenSpaceLibraryName) + '.';
+    if (!library.name.empty()) {
+        prefix += library.name + '.';
+    }
+
+    for (const LuaLibrary::Function& function : library.functions) {
+        _functionIndex.insert(prefix + function.name);
+    }
+    for (const LuaLibrary::Documentation& doc : library.documentations) {
+        _functionIndex.insert(prefix + doc.name);
+    }
+}
+
 std::string ScriptEngine::generateJson() const {
     // Create JSON
     std::stringstream json;
@@ -683,6 +915,11 @@ void ScriptEngine::decode(SyncBuffer* syncBuffer) {
 }
 
 void ScriptEngine::postSync(bool isMaster) {
+    // A script, or a group of scripts sent by the GUI, often changes many properties at
+    // once. Their listeners are only notified once after all scripts of this frame ran
+    properties::Property::beginChangeBatch();
+    defer { properties::Property::endChangeBatch(); };
+
     if (isMaster) {
         while (!_masterScriptQueue.empty()) {
             std::string script = std::move(_masterScriptQueue.front().script);
@@ -29,9 +29,57 @@
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/util/time.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
 
 #include "scriptscheduler_lua.inl"
 
+namespace {
+    // Returns the index of the first timing at or after \p from that is bigger than
+    // \p time. The search gallops away from \p from before it bisects, so a small step
+    // costs a handful of comparisons and a jump across the whole schedule is logarithmic
+    size_t forwardBound(const std::vector<double>& timings, size_t from, double time) {
+        size_t lo = from;
+        size_t step = 1;
+        // All timings in [from, lo) are smaller or equal to the time
+        while (lo < timings.size()) {
+            const size_t probe = std::min(lo + step - 1, timings.size() - 1);
+            if (timings[probe] > time) {
+                const auto it = std::upper_bound(
+                    timings.begin() + lo,
+                    timings.begin() + probe,
+                    time
+                );
+                return static_cast<size_t>(std::distance(timings.begin(), it));
+            }
+            lo = probe + 1;
+            step *= 2;
+        }
+        return timings.size();
+    }
+
+    // Returns the index of the first timing before \p from that is bigger or equal to
+    // \p time, or \p from if there is none. This is the mirror image of forwardBound
+    size_t backwardBound(const std::vector<double>& timings, size_t from, double time) {
+        size_t hi = from;
+        size_t step = 1;
+        // All timings in [hi, from) are bigger or equal to the time
+        while (hi > 0) {
+            const size_t probe = hi > step ? hi - step : 0;
+            if (timings[probe] < time) {
+                const auto it = std::lower_bound(
+                    timings.begin() + probe + 1,
+                    timings.begin() + hi,
+                    time
+                );
+                return static_cast<size_t>(std::distance(timings.begin(), it));
+            }
+            hi = probe;
+            step *= 2;
+        }
+        return 0;
+    }
+} // namespace
+
 namespace openspace::scripting {
 
 documentation::Documentation ScriptScheduler::Documentation() {
@@ -138,20 +186,46 @@ void ScriptScheduler::loadScripts(const ghoul::Dictionary& dictionary) {
         }
     );
 
-    // Move the scheduled scripts into their SOA alignment
-    // For the forward scripts, this is the forwards direction
-    // For the backward scripts, we insert them in the opposite order so that we can still
-    // return forward iterators to them in the progressTo method
-    for (ScheduledScript& script : scheduledScripts) {
-        _timings.push_back(script.time);
-
-        _forwardScripts.push_back(std::move(script.forwardScript));
-
-        _backwardScripts.insert(
-            _backwardScripts.begin(),
-            std::move(script.backwardScript)
-        );
+    // Merge the new scripts with the already loaded ones into their SOA alignment. For
+    // the forward scripts, this is the forwards direction. The backward scripts are
+    // stored in the opposite order so that we can still return forward iterators to
+    // them in the progressTo method. Scripts that were loaded earlier stay in front of
+    // new scripts with the same time
+    const size_t nScripts = _timings.size() + scheduledScripts.size();
+    std::vector<double> timings;
+    timings.reserve(nScripts);
+    std::vector<std::string> forwardScripts;
+    forwardScripts.reserve(nScripts);
+    std::vector<std::string> backwardScripts;
+    backwardScripts.reserve(nScripts);
+
+    size_t iOld = 0;
+    size_t iNew = 0;
+    while (iOld < _timings.size() || iNew < scheduledScripts.size()) {
+        const bool takeOld = iNew == scheduledScripts.size() ||
+            (iOld < _timings.size() && _timings[iOld] <= scheduledScripts[iNew].time);
+
+        if (takeOld) {
+            timings.push_back(_timings[iOld]);
+            forwardScripts.push_back(std::move(_forwardScripts[iOld]));
+            backwardScripts.push_back(
+                std::move(_backwardScripts[_timings.size() - 1 - iOld])
+            );
+            ++iOld;
+        }
+        else {
+            ScheduledScript& script = scheduledScripts[iNew];
+            timings.push_back(script.time);
+            forwardScripts.push_back(std::move(script.forwardScript));
+            backwardScripts.push_back(std::move(script.backwardScript));
+            ++iNew;
+        }
     }
+    std::reverse(backwardScripts.begin(), backwardScripts.end());
+
+    _timings = std::move(timings);
+    _forwardScripts = std::move(forwardScripts);
+    _backwardScripts = std::move(backwardScripts);
 
     // Ensure _currentIndex and _currentTime is accurate after new scripts was added
     const double lastTime = _currentTime;
@@ -186,17 +260,10 @@ ScriptScheduler::progressTo(double newTime)
 
     if (newTime > _currentTime) {
         // Moving forward in time; we need to find the highest entry in the timings
-        // vector that is still smaller than the newTime
-        size_t prevIndex = _currentIndex;
-        const auto it = std::upper_bound(
-            _timings.begin() + prevIndex, // We only need to start at the previous time
-            _timings.end(),
-            newTime
-         );
-
-        // How many values did we pass over?
-        const ptrdiff_t n = std::distance(_timings.begin() + prevIndex, it);
-        _currentIndex = static_cast<int>(prevIndex + n);
+        // vector that is still smaller than the newTime. We only need to start at the
+        // previous time
+        const size_t prevIndex = _currentIndex;
+        _currentIndex = forwardBound(_timings, prevIndex, newTime);
 
         // Update the new time
         _currentTime = newTime;
@@ -209,16 +276,9 @@ ScriptScheduler::progressTo(double newTime)
     else {
         // Moving backward in time; the need to find the lowest entry that is still bigger
         // than the newTime
+        // We can stop at the previous time
         const size_t prevIndex = _currentIndex;
-        const auto it = std::lower_bound(
-            _timings.begin(),
-            _timings.begin() + prevIndex, // We can stop at the previous time
-            newTime
-        );
-
-        // How many values did we pass over?
-        const ptrdiff_t n = std::distance(it, _timings.begin() + prevIndex);
-        _currentIndex = static_cast<int>(prevIndex - n);
+        _currentIndex = backwardBound(_timings, prevIndex, newTime);
 
         // Update the new time
         _currentTime = newTime;
@@ -252,7 +312,7 @@ std::vector<ScriptScheduler::ScheduledScript> ScriptScheduler::allScripts() cons
         ScheduledScript script;
         script.time = _timings[i];
         script.forwardScript = _forwardScripts[i];
-        script.backwardScript = _backwardScripts[i];
+        script.backwardScript = _backwardScripts[_timings.size() - 1 - i];
 
         result.push_back(std::move(script));
     }
@@ -0,0 +1,238 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <openspace/util/asyncfilewriter.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <chrono>
+#include <lz4.h>
+
+namespace {
+    constexpr const char* _loggerCat = "AsyncFileWriter";
+
+    // The writer thread writes and flushes the queued data at least this often, which
+    // limits how much data is lost if the application terminates abnormally
+    constexpr const std::chrono::milliseconds FlushInterval(100);
+
+    // With compression, the data is collected into blocks of this size before it is
+    // compressed, unless the pending data is older than MaxBlockAge
+    constexpr const size_t BlockSize = 64 * 1024;
+    constexpr const std::chrono::seconds MaxBlockAge(2);
+} // namespace
+
+namespace openspace {
+
+AsyncFileWriter::AsyncFileWriter(const std::string& path, const std::string& header,
+                                 Compress compress, size_t capacity)
+    : _file(path, std::ios::binary)
+    , _queue(capacity)
+    , _compress(compress)
+{
+    if (!_file.good()) {
+        _file.close();
+        return;
+    }
+
+    _file.write(header.data(), header.size());
+    _position = header.size();
+    if (_compress) {
+        _block.reserve(BlockSize);
+    }
+
+    _writer = std::thread([this]() { writeQueuedData(); });
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+bool AsyncFileWriter::isOpen() const {
+    return _writer.joinable();
+}
+
+void AsyncFileWriter::write(std::string data) {
+    ghoul_assert(isOpen(), "File must be open");
+
+    _position += data.size();
+    if (!_queue.tryPush(std::move(data))) {
+        // The writer thread cannot keep up, so the data is written right away after the
+        // data that is already queued to keep the order intact
+        std::lock_guard<std::mutex> lock(_fileMutex);
+        drainQueue();
+        writeToFile(data);
+    }
+}
+
+void AsyncFileWriter::write(const char* data, size_t size) {
+    write(std::string(data, size));
+}
+
+uint64_t AsyncFileWriter::position() const {
+    return _position;
+}
+
+void AsyncFileWriter::close() {
+    if (!_writer.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_wakeUpMutex);
+        _isRunning = false;
+    }
+    _wakeUp.notify_one();
+    _writer.join();
+
+    std::lock_guard<std::mutex> lock(_fileMutex);
+    drainQueue();
+    if (_compress && !_block.empty()) {
+        writeBlock();
+    }
+    _file.close();
+}
+
+void AsyncFileWriter::writeQueuedData() {
+    using namespace std::chrono;
+    steady_clock::time_point blockStart = steady_clock::now();
+
+    while (_isRunning) {
+        {
+            std::lock_guard<std::mutex> lock(_fileMutex);
+            const bool hasWritten = drainQueue();
+            const bool isBlockDue = _block.size() >= BlockSize ||
+                                    steady_clock::now() - blockStart > MaxBlockAge;
+            if (_compress && !_block.empty() && isBlockDue) {
+                writeBlock();
+                blockStart = steady_clock::now();
+            }
+            if (hasWritten) {
+                _file.flush();
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(_wakeUpMutex);
+        _wakeUp.wait_for(lock, FlushInterval, [this]() { return !_isRunning; });
+    }
+}
+
+bool AsyncFileWriter::drainQueue() {
+    bool hasWritten = false;
+    std::string data;
+    while (_queue.tryPop(data)) {
+        writeToFile(data);
+        hasWritten = true;
+    }
+    return hasWritten;
+}
+
+void AsyncFileWriter::writeToFile(const std::string& data) {
+    if (_compress) {
+        _block += data;
+        if (_block.size() >= 2 * BlockSize) {
+            // Happens if the writer thread is falling behind, in which case the block is
+            // written right away rather than growing without bounds
+            writeBlock();
+        }
+    }
+    else {
+        _file.write(data.data(), data.size());
+    }
+}
+
+void AsyncFileWriter::writeBlock() {
+    const int bound = LZ4_compressBound(static_cast<int>(_block.size()));
+    _compressedBlock.resize(bound);
+    const int compressedSize = LZ4_compress_default(
+        _block.data(),
+        _compressedBlock.data(),
+        static_cast<int>(_block.size()),
+        bound
+    );
+    if (compressedSize <= 0) {
+        LERROR("Error compressing data block");
+        _block.clear();
+        return;
+    }
+
+    const uint32_t sizes[2] = {
+        static_cast<uint32_t>(_block.size()),
+        static_cast<uint32_t>(compressedSize)
+    };
+    _file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    _file.write(_compressedBlock.data(), compressedSize);
+    _block.clear();
+}
+
+bool AsyncFileWriter::decompress(const std::string& source,
+                                 const std::string& destination, size_t headerSize)
+{
+    std::ifstream in(source, std::ios::binary);
+    std::ofstream out(destination, std::ios::binary);
+    if (!in.good() || !out.good()) {
+        return false;
+    }
+
+    std::vector<char> header(headerSize);
+    in.read(header.data(), headerSize);
+    if (!in.good()) {
+        return false;
+    }
+    out.write(header.data(), headerSize);
+
+    std::vector<char> compressed;
+    std::vector<char> block;
+    while (true) {
+        uint32_t sizes[2];
+        in.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+        if (in.gcount() == 0 && in.eof()) {
+            return true;
+        }
+        if (!in.good()) {
+            // The file ends in the middle of a block, for example because the writer
+            // did not close the file, so everything up to the last full block is kept
+            return false;
+        }
+
+        compressed.resize(sizes[1]);
+        block.resize(sizes[0]);
+        in.read(compressed.data(), sizes[1]);
+        if (static_cast<uint32_t>(in.gcount()) != sizes[1]) {
+            return false;
+        }
+        const int nBytes = LZ4_decompress_safe(
+            compressed.data(),
+            block.data(),
+            static_cast<int>(sizes[1]),
+            static_cast<int>(sizes[0])
+        );
+        if (nBytes != static_cast<int>(sizes[0])) {
+            LERROR(fmt::format("Error decompressing a block of {}", source));
+            return false;
+        }
+        out.write(block.data(), sizes[0]);
+    }
+}
+
+} // namespace openspace
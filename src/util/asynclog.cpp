@@ -0,0 +1,143 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <openspace/util/asynclog.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/misc/assert.h>
+#include <chrono>
+
+namespace {
+    constexpr const char* _loggerCat = "AsyncLog";
+
+    // Messages that are not urgent wait at most this long before they are written
+    constexpr const std::chrono::milliseconds WakeUpInterval(50);
+} // namespace
+
+namespace openspace {
+
+AsyncLog::AsyncLog(std::unique_ptr<ghoul::logging::Log> log, size_t capacity)
+    : ghoul::logging::Log(
+        TimeStamping::No,
+        DateStamping::No,
+        CategoryStamping::No,
+        LogLevelStamping::No,
+        log->logLevel()
+    )
+    , _log(std::move(log))
+    , _queue(capacity)
+{
+    ghoul_assert(_log, "Log must not be nullptr");
+
+    _writer = std::thread([this]() { writeMessages(); });
+}
+
+AsyncLog::~AsyncLog() {
+    {
+        std::lock_guard<std::mutex> lock(_wakeUpMutex);
+        _isRunning = false;
+    }
+    _wakeUp.notify_one();
+    _writer.join();
+
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    drainQueue();
+    _log->flush();
+}
+
+void AsyncLog::log(ghoul::logging::LogLevel level, const std::string& category,
+                   const std::string& message)
+{
+    using ghoul::logging::LogLevel;
+
+    Entry entry = { level, category, message };
+    if (_queue.tryPush(std::move(entry))) {
+        // Errors should show up in the log file as soon as possible in case they are
+        // followed by a crash, everything else can wait for the next wake-up or flush
+        if (level >= LogLevel::Error) {
+            wakeUpWriter();
+        }
+    }
+    else if (level >= LogLevel::Error) {
+        // The queue is full, but this message is too important to be discarded. The
+        // queued messages are written first to keep the order of the messages intact
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        drainQueue();
+        _log->log(entry.level, entry.category, entry.message);
+    }
+    else {
+        ++_nDiscarded;
+    }
+}
+
+void AsyncLog::flush() {
+    wakeUpWriter();
+}
+
+void AsyncLog::wakeUpWriter() {
+    // Not taking the wake-up mutex here means that the writer might miss a wake-up if
+    // it is just about to go to sleep, in which case it wakes up after the interval
+    _isWakeUpRequested = true;
+    _wakeUp.notify_one();
+}
+
+void AsyncLog::writeMessages() {
+    while (_isRunning) {
+        {
+            std::lock_guard<std::mutex> lock(_writeMutex);
+            if (drainQueue()) {
+                _log->flush();
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(_wakeUpMutex);
+        _wakeUp.wait_for(
+            lock,
+            WakeUpInterval,
+            [this]() { return !_isRunning || _isWakeUpRequested; }
+        );
+        _isWakeUpRequested = false;
+    }
+}
+
+bool AsyncLog::drainQueue() {
+    bool hasWritten = false;
+    Entry entry;
+    while (_queue.tryPop(entry)) {
+        _log->log(entry.level, entry.category, entry.message);
+        hasWritten = true;
+    }
+
+    const unsigned int nDiscarded = _nDiscarded.exchange(0);
+    if (nDiscarded > 0) {
+        _log->log(
+            ghoul::logging::LogLevel::Warning,
+            _loggerCat,
+            fmt::format("Discarded {} log messages as the queue was full", nDiscarded)
+        );
+        hasWritten = true;
+    }
+    return hasWritten;
+}
+
+} // namespace openspace
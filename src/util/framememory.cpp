@@ -0,0 +1,79 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/framememory.h>
+
+#include <ghoul/misc/assert.h>
+
+namespace openspace {
+
+void* FrameMemory::OverflowResource::do_allocate(size_t bytes, size_t alignment) {
+    nAllocatedBytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void FrameMemory::OverflowResource::do_deallocate(void* p, size_t bytes,
+                                                  size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool FrameMemory::OverflowResource::do_is_equal(
+                                    const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+FrameMemory::FrameMemory(size_t initialCapacity)
+    : _buffer(std::make_unique<std::byte[]>(initialCapacity))
+    , _capacity(initialCapacity)
+{
+    ghoul_assert(initialCapacity > 0, "The initial capacity must be positive");
+    _arena.emplace(_buffer.get(), _capacity, &_overflow);
+}
+
+std::pmr::memory_resource* FrameMemory::resource() {
+    return &*_arena;
+}
+
+void FrameMemory::reset() {
+    // Destroying the arena returns everything that overflowed to the heap
+    _arena.reset();
+
+    if (_overflow.nAllocatedBytes > 0) {
+        // The arena grows its overflow allocations geometrically, so their total is an
+        // upper bound of what the last frame needed in addition to the buffer
+        _capacity += _overflow.nAllocatedBytes;
+        _buffer = std::make_unique<std::byte[]>(_capacity);
+        _overflow.nAllocatedBytes = 0;
+    }
+
+    _arena.emplace(_buffer.get(), _capacity, &_overflow);
+}
+
+size_t FrameMemory::capacity() const {
+    return _capacity;
+}
+
+} // namespace openspace
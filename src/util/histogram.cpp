@@ -24,12 +24,59 @@
 
 #include <openspace/util/histogram.h>
 
+#include <openspace/engine/globals.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
+#include <algorithm>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
 
 namespace {
     constexpr const char* _loggerCat = "Histogram";
+
+    // The values are binned in blocks: first all bin indices of a block are computed in
+    // a branchless loop that the compiler turns into SIMD code, then the bins are
+    // incremented
+    constexpr const size_t BlockSize = 256;
+
+    // Inputs are only split across threads if every thread gets at least this many
+    constexpr const size_t MinValuesPerTask = 1 << 20;
+
+    // Counts the values into counts, which has numBins + 1 entries. The last entry
+    // collects the values that are outside of [minValue, maxValue]
+    void countValues(const float* values, size_t nValues, float minValue,
+                     float maxValue, int numBins, uint64_t* counts)
+    {
+        const float range = maxValue - minValue;
+        const float nBins = static_cast<float>(numBins);
+        const float lastBin = nBins - 1.f;
+
+        int32_t indices[BlockSize];
+        for (size_t begin = 0; begin < nValues; begin += BlockSize) {
+            const size_t n = std::min(BlockSize, nValues - begin);
+            const float* block = values + begin;
+
+            for (size_t i = 0; i < n; ++i) {
+                const float value = block[i];
+                // Same computation as in Histogram::add, but clamped before converting
+                // so that out-of-range and NaN values do not overflow the conversion
+                const float bin = std::min(
+                    std::max(0.f, (value - minValue) / range * nBins),
+                    lastBin
+                );
+                const bool isInside = value >= minValue && value <= maxValue;
+                indices[i] = isInside ? static_cast<int32_t>(bin) : numBins;
+            }
+
+            for (size_t i = 0; i < n; ++i) {
+                ++counts[indices[i]];
+            }
+        }
+    }
 } // namespace
 
 namespace openspace {
@@ -48,10 +95,35 @@ Histogram::Histogram(float minValue, float maxValue, int numBins, float* data)
     }
 }
 
+Histogram::Histogram(Histogram&& other)
+    : _numBins(other._numBins)
+    , _minValue(other._minValue)
+    , _maxValue(other._maxValue)
+    , _data(other._data)
+    , _equalizer(std::move(other._equalizer))
+    , _numValues(other._numValues)
+{
+    other._data = nullptr;
+}
+
 Histogram::~Histogram() {
     delete[] _data;
 }
 
+Histogram& Histogram::operator=(Histogram&& other) {
+    if (this != &other) {
+        delete[] _data;
+        _numBins = other._numBins;
+        _minValue = other._minValue;
+        _maxValue = other._maxValue;
+        _data = other._data;
+        _equalizer = std::move(other._equalizer);
+        _numValues = other._numValues;
+        other._data = nullptr;
+    }
+    return *this;
+}
+
 int Histogram::numBins() const {
     return _numBins;
 }
@@ -86,34 +158,91 @@ bool Histogram::add(float value, float repeat) {
     return true;
 }
 
+size_t Histogram::add(const float* values, size_t nValues) {
+    if (!isValid() || nValues == 0) {
+        return 0;
+    }
+
+    // Waiting for other tasks from within a worker could deadlock the scheduler
+    size_t nTasks = 1;
+    if (nValues >= 2 * MinValuesPerTask && !global::taskScheduler.isWorkerThread()) {
+        nTasks = std::min(
+            nValues / MinValuesPerTask,
+            global::taskScheduler.numberOfThreads() + 1
+        );
+    }
+    const size_t valuesPerTask = (nValues + nTasks - 1) / nTasks;
+
+    std::vector<std::vector<uint64_t>> counts(
+        nTasks,
+        std::vector<uint64_t>(_numBins + 1, 0)
+    );
+    auto countPart = [&](size_t part) {
+        const size_t begin = part * valuesPerTask;
+        const size_t n = std::min(valuesPerTask, nValues - begin);
+        uint64_t* partCounts = counts[part].data();
+        countValues(values + begin, n, _minValue, _maxValue, _numBins, partCounts);
+    };
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t nRunning = nTasks - 1;
+    for (size_t part = 1; part < nTasks; ++part) {
+        global::taskScheduler.submit([&, part]() {
+            countPart(part);
+            // Notify while holding the lock, as the calling thread destroys the
+            // condition variable as soon as it has seen the last task finish
+            std::lock_guard<std::mutex> lock(mutex);
+            --nRunning;
+            finished.notify_one();
+        });
+    }
+    countPart(0);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&nRunning]() { return nRunning == 0; });
+    }
+
+    // Merge the partial histograms
+    uint64_t nOutside = 0;
+    for (const std::vector<uint64_t>& c : counts) {
+        for (int i = 0; i < _numBins; ++i) {
+            _data[i] += static_cast<float>(c[i]);
+        }
+        nOutside += c[_numBins];
+    }
+
+    const size_t nInside = nValues - static_cast<size_t>(nOutside);
+    _numValues = static_cast<int>(_numValues + nInside);
+    return nInside;
+}
+
 void Histogram::changeRange(float minValue, float maxValue){
     if (minValue > _minValue && maxValue < _maxValue) {
         return;
     }
 
-    float* oldData = _data;
-    float oldMin = _minValue;
-    float oldMax = _maxValue;
-
-    float* newData = new float[_numBins]{0.0};
-    for(int i=0; i<_numBins; i++){
-        float unNormalizedValue = i*(oldMax-oldMin)+oldMin;
-        float normalizedValue = (unNormalizedValue - _minValue) /
-                                (_maxValue - _minValue);      // [0.0, 1.0]
-        int binIndex = static_cast<int>(std::min(
-            static_cast<float>(floor(normalizedValue * _numBins)),
-            _numBins - 1.f
-        )); // [0, _numBins - 1]
-
-        newData[binIndex] = oldData[i];
+    const float oldMin = _minValue;
+    const float oldBinWidth = (_maxValue - _minValue) / _numBins;
+
+    // Every old bin is moved in one piece into the new bin that contains its center
+    float* newData = new float[_numBins]{ 0.f };
+    for (int i = 0; i < _numBins; ++i) {
+        const float center = oldMin + (i + 0.5f) * oldBinWidth;
+        const float normalizedValue = (center - minValue) / (maxValue - minValue);
+        const int binIndex = std::clamp(
+            static_cast<int>(std::floor(normalizedValue * _numBins)),
+            0,
+            _numBins - 1
+        );
+        newData[binIndex] += _data[i];
     }
 
+    delete[] _data;
     _data = newData;
-    delete oldData;
 
     _minValue = minValue;
     _maxValue = maxValue;
-
 }
 
 bool Histogram::add(const Histogram& histogram) {
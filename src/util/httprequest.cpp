@@ -45,6 +45,7 @@
 
 namespace {
     constexpr const long StatusCodeOk = 200;
+    constexpr const long StatusCodePartialContent = 206;
     constexpr const char* _loggerCat = "HttpRequest";
 } // namespace
 
@@ -132,11 +133,34 @@ void HttpRequest::perform(RequestOptions opt) {
         curl_easy_setopt(curl, CURLOPT_TIMEOUT, opt.requestTimeoutSeconds); // NOLINT
     }
 
+    if (opt.rangeLength > 0) {
+        const std::string range = fmt::format(
+            "{}-{}", opt.resumeFromByte, opt.resumeFromByte + opt.rangeLength - 1
+        );
+        curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str()); // NOLINT
+    }
+    else if (opt.resumeFromByte > 0) {
+        // If the server does not honor the range, curl aborts with CURLE_RANGE_ERROR
+        // before any data is passed to the write callback
+        const curl_off_t from = static_cast<curl_off_t>(opt.resumeFromByte);
+        curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, from); // NOLINT
+    }
+
+    if (opt.maxBytesPerSecond > 0) {
+        const curl_off_t speed = static_cast<curl_off_t>(opt.maxBytesPerSecond);
+        curl_easy_setopt(curl, CURLOPT_MAX_RECV_SPEED_LARGE, speed); // NOLINT
+    }
+
     CURLcode res = curl_easy_perform(curl);
     if (res == CURLE_OK) {
         long responseCode;
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode); // NOLINT
-        if (responseCode == StatusCodeOk) {
+        const bool isRanged = (opt.resumeFromByte > 0) || (opt.rangeLength > 0);
+        const bool isPartial = isRanged && (responseCode == StatusCodePartialContent);
+        // curl does not detect a server that answers an explicit range with the
+        // entire resource
+        const bool isComplete = (responseCode == StatusCodeOk) && (opt.rangeLength == 0);
+        if (isComplete || isPartial) {
             setReadyState(ReadyState::Success);
         } else {
             setReadyState(ReadyState::Fail);
@@ -186,7 +210,15 @@ void HttpDownload::markAsSuccessful() {
     _successful = true;
 }
 
+size_t HttpDownload::resumeOffset() const {
+    return 0;
+}
+
 bool HttpDownload::callOnProgress(HttpRequest::Progress p) {
+    // curl only reports the part of the file that is transferred by this request
+    const size_t offset = resumeOffset();
+    p.totalBytes += offset;
+    p.downloadedBytes += offset;
     return _onProgress(p);
 }
 
@@ -201,6 +233,7 @@ void SyncHttpDownload::download(HttpRequest::RequestOptions opt) {
         markAsFailed();
         return;
     }
+    opt.resumeFromByte += resumeOffset();
     _httpRequest.onData([this] (HttpRequest::Data d) {
         return handleData(d);
     });
@@ -266,6 +299,7 @@ void AsyncHttpDownload::download(HttpRequest::RequestOptions opt) {
     LTRACE(fmt::format("Start async download '{}'", _httpRequest.url()));
 
     initDownload();
+    opt.resumeFromByte += resumeOffset();
 
     _httpRequest.onData([this](HttpRequest::Data d) {
         return handleData(d);
@@ -331,13 +365,16 @@ size_t HttpMemoryDownload::handleData(HttpRequest::Data d) {
 }
 
 HttpFileDownload::HttpFileDownload(std::string destination,
-                                   HttpFileDownload::Overwrite overwrite)
+                                   HttpFileDownload::Overwrite overwrite,
+                                   HttpFileDownload::Resume resume)
     : _destination(std::move(destination))
     , _overwrite(overwrite)
+    , _resume(resume)
 {}
 
 bool HttpFileDownload::initDownload() {
-    if (!_overwrite && FileSys.fileExists(_destination)) {
+    const bool exists = FileSys.fileExists(_destination);
+    if (!_overwrite && !_resume && exists) {
         LWARNING(fmt::format("File {} already exists", _destination));
         return false;
     }
@@ -356,9 +393,21 @@ bool HttpFileDownload::initDownload() {
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 
+    _resumeOffset = 0;
+    if (_resume && exists) {
+        std::ifstream partial(_destination, std::ifstream::binary | std::ifstream::ate);
+        const std::streamoff size = partial.tellg();
+        _resumeOffset = size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
     ++nCurrentFilehandles;
     _hasHandle = true;
-    _file = std::ofstream(_destination, std::ofstream::binary);
+    _file = std::ofstream(
+        _destination,
+        _resumeOffset > 0 ?
+            std::ofstream::binary | std::ofstream::app :
+            std::ofstream::binary
+    );
 
     if (_file.fail()) {
 #ifdef WIN32
@@ -420,6 +469,10 @@ const std::string& HttpFileDownload::destination() const {
     return _destination;
 }
 
+size_t HttpFileDownload::resumeOffset() const {
+    return _resumeOffset;
+}
+
 bool HttpFileDownload::deinitDownload() {
     if (_hasHandle) {
         _hasHandle = false;
@@ -442,9 +495,10 @@ SyncHttpMemoryDownload::SyncHttpMemoryDownload(std::string url)
 {}
 
 SyncHttpFileDownload::SyncHttpFileDownload(std::string url, std::string destinationPath,
-                                           HttpFileDownload::Overwrite overwrite)
+                                           HttpFileDownload::Overwrite overwrite,
+                                           HttpFileDownload::Resume resume)
     : SyncHttpDownload(std::move(url))
-    , HttpFileDownload(std::move(destinationPath), overwrite)
+    , HttpFileDownload(std::move(destinationPath), overwrite, resume)
 {}
 
 AsyncHttpMemoryDownload::AsyncHttpMemoryDownload(std::string url)
@@ -452,9 +506,10 @@ AsyncHttpMemoryDownload::AsyncHttpMemoryDownload(std::string url)
 {}
 
 AsyncHttpFileDownload::AsyncHttpFileDownload(std::string url, std::string destinationPath,
-                                             HttpFileDownload::Overwrite overwrite)
+                                             HttpFileDownload::Overwrite overwrite,
+                                             HttpFileDownload::Resume resume)
     : AsyncHttpDownload(std::move(url))
-    , HttpFileDownload(std::move(destinationPath), overwrite)
+    , HttpFileDownload(std::move(destinationPath), overwrite, resume)
 {}
 
 } // namespace openspace
@@ -0,0 +1,252 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/memorybudget.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+    constexpr const size_t MegaByte = 1024 * 1024;
+
+    constexpr openspace::properties::Property::PropertyInfo CpuBudgetInfo = {
+        "CpuBudget",
+        "CPU memory budget (MB)",
+        "This value denotes the amount of main memory (in megabytes) that all caches "
+        "that are registered with the memory budget may use together. If they exceed "
+        "it, the caches with the lowest priority are asked to free memory first. A "
+        "value of 0 disables the budget."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo GpuBudgetInfo = {
+        "GpuBudget",
+        "GPU memory budget (MB)",
+        "This value denotes the amount of video memory (in megabytes) that all caches "
+        "that are registered with the memory budget may use together. If they exceed "
+        "it, the caches with the lowest priority are asked to free memory first. A "
+        "value of 0 disables the budget."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo CpuUsageInfo = {
+        "CpuUsage",
+        "CPU memory usage (MB)",
+        "This value denotes the amount of main memory (in megabytes) that is used by the "
+        "registered caches."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo GpuUsageInfo = {
+        "GpuUsage",
+        "GPU memory usage (MB)",
+        "This value denotes the amount of video memory (in megabytes) that is used by "
+        "the registered caches."
+    };
+
+    int toMegaBytes(size_t bytes) {
+        return static_cast<int>(
+            std::min<size_t>(bytes / MegaByte, std::numeric_limits<int>::max())
+        );
+    }
+} // namespace
+
+namespace openspace {
+
+MemoryBudget::MemoryBudget()
+    : properties::PropertyOwner({ "MemoryBudget" })
+    , _cpuBudget(CpuBudgetInfo, 0, 0, std::numeric_limits<int>::max())
+    , _gpuBudget(GpuBudgetInfo, 0, 0, std::numeric_limits<int>::max())
+    , _cpuUsage(CpuUsageInfo, 0, 0, std::numeric_limits<int>::max())
+    , _gpuUsage(GpuUsageInfo, 0, 0, std::numeric_limits<int>::max())
+{
+    addProperty(_cpuBudget);
+    // There is no portable way to query the amount of video memory
+    addProperty(_gpuBudget);
+
+    _cpuUsage.setReadOnly(true);
+    addProperty(_cpuUsage);
+    _gpuUsage.setReadOnly(true);
+    addProperty(_gpuUsage);
+}
+
+MemoryBudget::~MemoryBudget() {} // NOLINT
+
+void MemoryBudget::initialize() {
+    // Leave a quarter of the main memory for everything that is not a cache, so that the
+    // caches together do not push the machine into swapping
+    _cpuBudget = static_cast<int>(CpuCap.installedMainMemory() * 0.75);
+}
+
+MemoryBudget::ClientId MemoryBudget::registerClient(std::string name, int priority,
+                                                    ShrinkCallback shrink)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const ClientId id = _nextClientId++;
+
+    // Multiple instances of the same cache, for example of different renderables, each
+    // get their own property owner
+    std::string identifier = name;
+    if (hasPropertySubOwner(identifier)) {
+        identifier += std::to_string(id);
+    }
+
+    Client client;
+    client.name = std::move(name);
+    client.priority = priority;
+    client.shrink = std::move(shrink);
+    client.owner = std::make_unique<properties::PropertyOwner>(
+        properties::PropertyOwner::PropertyOwnerInfo{ identifier, client.name }
+    );
+    client.cpuUsage = std::make_unique<properties::IntProperty>(
+        CpuUsageInfo, 0, 0, std::numeric_limits<int>::max()
+    );
+    client.cpuUsage->setReadOnly(true);
+    client.owner->addProperty(client.cpuUsage.get());
+    client.gpuUsage = std::make_unique<properties::IntProperty>(
+        GpuUsageInfo, 0, 0, std::numeric_limits<int>::max()
+    );
+    client.gpuUsage->setReadOnly(true);
+    client.owner->addProperty(client.gpuUsage.get());
+    addPropertySubOwner(client.owner.get());
+
+    _clients[id] = std::move(client);
+    return id;
+}
+
+void MemoryBudget::unregisterClient(ClientId id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _clients.find(id);
+    ghoul_assert(it != _clients.end(), "Client must have been registered");
+    removePropertySubOwner(it->second.owner.get());
+    _clients.erase(it);
+}
+
+void MemoryBudget::setUsage(ClientId id, Resource resource, size_t bytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _clients.find(id);
+    ghoul_assert(it != _clients.end(), "Client must have been registered");
+    it->second.usage[static_cast<int>(resource)] = bytes;
+}
+
+size_t MemoryBudget::allowance(ClientId id, Resource resource) const {
+    const size_t total = budget(resource);
+    if (total == 0) {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _clients.find(id);
+    ghoul_assert(it != _clients.end(), "Client must have been registered");
+
+    // Clients of a lower priority have to make room, so only the others count
+    size_t used = 0;
+    for (const std::pair<const ClientId, Client>& p : _clients) {
+        if (p.first != id && p.second.priority >= it->second.priority) {
+            used += p.second.usage[static_cast<int>(resource)];
+        }
+    }
+    return used < total ? total - used : 0;
+}
+
+size_t MemoryBudget::budget(Resource resource) const {
+    const int mb = resource == Resource::Cpu ? _cpuBudget : _gpuBudget;
+    return static_cast<size_t>(mb) * MegaByte;
+}
+
+size_t MemoryBudget::usage(Resource resource) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t result = 0;
+    for (const std::pair<const ClientId, Client>& p : _clients) {
+        result += p.second.usage[static_cast<int>(resource)];
+    }
+    return result;
+}
+
+void MemoryBudget::update() {
+    struct Request {
+        ShrinkCallback callback;
+        Resource resource;
+        size_t allowance;
+    };
+    std::vector<Request> requests;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (Resource resource : { Resource::Cpu, Resource::Gpu }) {
+            const int r = static_cast<int>(resource);
+
+            size_t total = 0;
+            for (std::pair<const ClientId, Client>& p : _clients) {
+                total += p.second.usage[r];
+                properties::IntProperty& prop = resource == Resource::Cpu ?
+                    *p.second.cpuUsage :
+                    *p.second.gpuUsage;
+                prop = toMegaBytes(p.second.usage[r]);
+            }
+            (resource == Resource::Cpu ? _cpuUsage : _gpuUsage) = toMegaBytes(total);
+
+            const size_t limit = budget(resource);
+            if (limit == 0 || total <= limit) {
+                continue;
+            }
+
+            // The lowest priority clients shrink first and within a priority the
+            // largest ones, which are the most likely to be able to free the excess
+            std::vector<const Client*> clients;
+            for (const std::pair<const ClientId, Client>& p : _clients) {
+                if (p.second.usage[r] > 0 && p.second.shrink) {
+                    clients.push_back(&p.second);
+                }
+            }
+            std::sort(
+                clients.begin(),
+                clients.end(),
+                [r](const Client* lhs, const Client* rhs) {
+                    if (lhs->priority != rhs->priority) {
+                        return lhs->priority < rhs->priority;
+                    }
+                    return lhs->usage[r] > rhs->usage[r];
+                }
+            );
+
+            size_t excess = total - limit;
+            for (const Client* c : clients) {
+                if (excess == 0) {
+                    break;
+                }
+                const size_t freed = std::min(excess, c->usage[r]);
+                requests.push_back({ c->shrink, resource, c->usage[r] - freed });
+                excess -= freed;
+            }
+        }
+    }
+
+    // The clients report their new usage from within the callbacks
+    for (const Request& request : requests) {
+        request.callback(request.resource, request.allowance);
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,198 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/prefixtrie.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    bool startsWithIgnoringCase(std::string_view value, std::string_view prefix) {
+        return value.size() >= prefix.size() &&
+            std::equal(
+                prefix.begin(),
+                prefix.end(),
+                value.begin(),
+                [](char lhs, char rhs) {
+                    return std::tolower(static_cast<unsigned char>(lhs)) ==
+                           std::tolower(static_cast<unsigned char>(rhs));
+                }
+            );
+    }
+} // namespace
+
+namespace openspace {
+
+PrefixTrie::PrefixTrie(char separator)
+    : _separator(separator)
+{}
+
+void PrefixTrie::insert(std::string_view entry) {
+    if (contains(entry)) {
+        return;
+    }
+
+    Node* node = &_root;
+    node->nEntries++;
+    size_t begin = 0;
+    while (true) {
+        const size_t end = std::min(entry.find(_separator, begin), entry.size());
+        const std::string_view segment = entry.substr(begin, end - begin);
+
+        auto it = node->children.find(segment);
+        if (it == node->children.end()) {
+            it = node->children.emplace(
+                std::string(segment),
+                std::make_unique<Node>()
+            ).first;
+        }
+        node = it->second.get();
+        node->nEntries++;
+
+        if (end == entry.size()) {
+            break;
+        }
+        begin = end + 1;
+    }
+    node->isEntry = true;
+}
+
+void PrefixTrie::erase(std::string_view entry) {
+    if (!contains(entry)) {
+        return;
+    }
+
+    // Every node along the path loses one entry, and the nodes that have no entries left
+    // are removed together with everything below them
+    Node* node = &_root;
+    node->nEntries--;
+    size_t begin = 0;
+    while (true) {
+        const size_t end = std::min(entry.find(_separator, begin), entry.size());
+        const std::string_view segment = entry.substr(begin, end - begin);
+
+        auto it = node->children.find(segment);
+        Node* next = it->second.get();
+        next->nEntries--;
+        if (next->nEntries == 0) {
+            node->children.erase(it);
+            return;
+        }
+        node = next;
+
+        if (end == entry.size()) {
+            break;
+        }
+        begin = end + 1;
+    }
+    node->isEntry = false;
+}
+
+bool PrefixTrie::contains(std::string_view entry) const {
+    const Node* node = &_root;
+    size_t begin = 0;
+    while (true) {
+        const size_t end = std::min(entry.find(_separator, begin), entry.size());
+        const std::string_view segment = entry.substr(begin, end - begin);
+
+        const auto it = node->children.find(segment);
+        if (it == node->children.end()) {
+            return false;
+        }
+        node = it->second.get();
+
+        if (end == entry.size()) {
+            return node->isEntry;
+        }
+        begin = end + 1;
+    }
+}
+
+size_t PrefixTrie::size() const {
+    return _root.nEntries;
+}
+
+void PrefixTrie::clear() {
+    _root.children.clear();
+    _root.nEntries = 0;
+}
+
+std::vector<PrefixTrie::Completion> PrefixTrie::completions(
+                                                           std::string_view prefix) const
+{
+    // Walk along the complete segments of the prefix first, which leaves the node whose
+    // children are matched against the last, partial segment
+    const Node* node = &_root;
+    std::string path;
+    size_t begin = 0;
+    size_t end = prefix.find(_separator);
+    while (end != std::string_view::npos) {
+        std::string segment;
+        node = child(*node, prefix.substr(begin, end - begin), &segment);
+        if (!node) {
+            return {};
+        }
+        path += segment;
+        path += _separator;
+
+        begin = end + 1;
+        end = prefix.find(_separator, begin);
+    }
+    const std::string_view partial = prefix.substr(begin);
+
+    std::vector<Completion> res;
+    for (const std::pair<const std::string, std::unique_ptr<Node>>& c : node->children) {
+        if (!startsWithIgnoringCase(c.first, partial)) {
+            continue;
+        }
+        if (c.second->isEntry) {
+            res.push_back({ path + c.first, true });
+        }
+        if (!c.second->children.empty()) {
+            res.push_back({ path + c.first + _separator, false });
+        }
+    }
+    return res;
+}
+
+const PrefixTrie::Node* PrefixTrie::child(const Node& node, std::string_view segment,
+                                          std::string* childSegment) const
+{
+    const auto it = node.children.find(segment);
+    if (it != node.children.end()) {
+        *childSegment = it->first;
+        return it->second.get();
+    }
+
+    for (const std::pair<const std::string, std::unique_ptr<Node>>& c : node.children) {
+        if (c.first.size() == segment.size() && startsWithIgnoringCase(c.first, segment))
+        {
+            *childSegment = c.first;
+            return c.second.get();
+        }
+    }
+    return nullptr;
+}
+
+} // namespace openspace
@@ -0,0 +1,142 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <openspace/util/resourceloader.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <chrono>
+#include <iterator>
+#include <limits>
+
+namespace {
+    constexpr openspace::properties::Property::PropertyInfo UploadBudgetInfo = {
+        "UploadBudget",
+        "Upload budget (microseconds)",
+        "This value denotes the maximum amount of time (in microseconds) that is spent "
+        "uploading the data of asynchronously loaded resources to the GPU in a single "
+        "frame. Data that does not fit is uploaded in one of the following frames, but "
+        "at least one chunk is uploaded every frame. A value of 0 disables the budget "
+        "and all pending data is uploaded immediately."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PendingUploadsInfo = {
+        "PendingUploads",
+        "Pending uploads",
+        "This value denotes the number of resources that have finished loading, but "
+        "that are still waiting to be uploaded to the GPU due to the upload budget."
+    };
+} // namespace
+
+namespace openspace {
+
+ResourceLoader::Handle::Handle()
+    : _isFinished(std::make_shared<std::atomic<bool>>(false))
+{}
+
+void ResourceLoader::Handle::cancel() {
+    _token.cancel();
+}
+
+bool ResourceLoader::Handle::isFinished() const {
+    return *_isFinished;
+}
+
+ResourceLoader::ResourceLoader()
+    : properties::PropertyOwner({ "ResourceLoader" })
+    , _uploadBudget(UploadBudgetInfo, 4000, 0, 100000)
+    , _nPendingUploads(PendingUploadsInfo, 0, 0, std::numeric_limits<int>::max())
+{
+    addProperty(_uploadBudget);
+
+    _nPendingUploads.setReadOnly(true);
+    addProperty(_nPendingUploads);
+}
+
+void ResourceLoader::update() {
+    {
+        std::lock_guard<std::mutex> lock(_decodedMutex);
+        std::move(_decoded.begin(), _decoded.end(), std::back_inserter(_uploading));
+        _decoded.clear();
+    }
+
+    using namespace std::chrono;
+    const steady_clock::time_point start = steady_clock::now();
+    const microseconds budget(_uploadBudget);
+
+    bool hasUploaded = false;
+    while (!_uploading.empty()) {
+        if (hasUploaded && budget.count() > 0 && steady_clock::now() - start > budget) {
+            break;
+        }
+
+        Job& job = _uploading.front();
+        if (job.token.isCancelled()) {
+            _uploading.pop_front();
+            continue;
+        }
+
+        hasUploaded = true;
+        if (job.upload && !job.upload()) {
+            // There are more chunks left that are uploaded in the next iteration
+            continue;
+        }
+
+        *job.isFinished = true;
+        if (job.ready) {
+            job.ready();
+        }
+        _uploading.pop_front();
+    }
+
+    _nPendingUploads = static_cast<int>(_uploading.size());
+
+    if (hasUploaded) {
+        // The uploaded resources change the rendered image without any property change
+        global::renderEngine.requestRedraw();
+    }
+}
+
+void ResourceLoader::deinitialize() {
+    _isRunning = false;
+
+    std::lock_guard<std::mutex> lock(_decodedMutex);
+    _decoded.clear();
+    _uploading.clear();
+    _nPendingUploads = 0;
+}
+
+void ResourceLoader::submit(TaskScheduler::Task task, const Handle& handle,
+                            TaskScheduler::Priority priority)
+{
+    global::taskScheduler.submit(std::move(task), handle._token, priority);
+}
+
+void ResourceLoader::enqueue(Job job) {
+    std::lock_guard<std::mutex> lock(_decodedMutex);
+    if (_isRunning) {
+        _decoded.push_back(std::move(job));
+    }
+}
+
+} // namespace openspace
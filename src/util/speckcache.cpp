@@ -0,0 +1,192 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/speckcache.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+
+namespace {
+    constexpr const char* _loggerCat = "SpeckCache";
+
+    constexpr const std::array<char, 4> Magic = { 'O', 'S', 'S', 'C' };
+    constexpr const int8_t CurrentCacheVersion = 1;
+
+    // The data block starts at a multiple of this so that it can be used directly when
+    // the file is memory mapped
+    constexpr const int64_t DataAlignment = 16;
+
+    void writeString(std::ofstream& stream, const std::string& value) {
+        const uint16_t len = static_cast<uint16_t>(value.size());
+        stream.write(reinterpret_cast<const char*>(&len), sizeof(uint16_t));
+        stream.write(value.data(), len);
+    }
+
+    std::string readString(std::ifstream& stream) {
+        uint16_t len = 0;
+        stream.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
+        std::string value(len, '\0');
+        stream.read(value.data(), len);
+        return value;
+    }
+} // namespace
+
+namespace openspace::speckcache {
+
+bool saveCachedFile(const std::string& file, const std::vector<float>& data,
+                    int nValuesPerObject, const std::vector<std::string>& columnNames,
+                    const std::map<std::string, int>& metadata)
+{
+    const int64_t nValues = static_cast<int64_t>(data.size());
+    if (nValues == 0 || nValuesPerObject <= 0) {
+        LERROR("Error writing cache: No values were loaded");
+        return false;
+    }
+
+    std::ofstream fileStream(file, std::ofstream::binary);
+    if (!fileStream.good()) {
+        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
+        return false;
+    }
+
+    fileStream.write(Magic.data(), Magic.size());
+    fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+
+    const int32_t valuesPerObject = static_cast<int32_t>(nValuesPerObject);
+    fileStream.write(reinterpret_cast<const char*>(&valuesPerObject), sizeof(int32_t));
+    fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int64_t));
+
+    // Column descriptions
+    std::vector<glm::vec2> ranges(
+        nValuesPerObject,
+        glm::vec2(
+            std::numeric_limits<float>::max(),
+            -std::numeric_limits<float>::max()
+        )
+    );
+    for (int64_t i = 0; i < nValues; ++i) {
+        const float v = data[i];
+        glm::vec2& range = ranges[i % nValuesPerObject];
+        range.x = std::min(range.x, v);
+        range.y = std::max(range.y, v);
+    }
+    for (int i = 0; i < nValuesPerObject; ++i) {
+        const bool hasName = static_cast<size_t>(i) < columnNames.size();
+        writeString(fileStream, hasName ? columnNames[i] : std::string());
+        fileStream.write(reinterpret_cast<const char*>(&ranges[i]), sizeof(glm::vec2));
+    }
+
+    // Metadata
+    const int32_t nMetadata = static_cast<int32_t>(metadata.size());
+    fileStream.write(reinterpret_cast<const char*>(&nMetadata), sizeof(int32_t));
+    for (const std::pair<const std::string, int>& p : metadata) {
+        writeString(fileStream, p.first);
+        const int32_t value = static_cast<int32_t>(p.second);
+        fileStream.write(reinterpret_cast<const char*>(&value), sizeof(int32_t));
+    }
+
+    // Data, padded to the alignment
+    const int64_t headerSize = static_cast<int64_t>(fileStream.tellp());
+    const int64_t padding = (DataAlignment - headerSize % DataAlignment) % DataAlignment;
+    const std::array<char, DataAlignment> zeros = {};
+    fileStream.write(zeros.data(), padding);
+    fileStream.write(
+        reinterpret_cast<const char*>(data.data()),
+        nValues * sizeof(float)
+    );
+
+    return fileStream.good();
+}
+
+std::optional<Dataset> loadCachedFile(const std::string& file) {
+    std::ifstream fileStream(file, std::ifstream::binary);
+    if (!fileStream.good()) {
+        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
+        return std::nullopt;
+    }
+
+    std::array<char, 4> magic = {};
+    int8_t version = 0;
+    fileStream.read(magic.data(), magic.size());
+    fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (magic != Magic || version != CurrentCacheVersion) {
+        LINFO("The format of the cached file has changed: deleting old cache");
+        fileStream.close();
+        FileSys.deleteFile(file);
+        return std::nullopt;
+    }
+
+    Dataset dataset;
+    int32_t nValuesPerObject = 0;
+    int64_t nValues = 0;
+    fileStream.read(reinterpret_cast<char*>(&nValuesPerObject), sizeof(int32_t));
+    fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int64_t));
+    if (!fileStream.good() || nValuesPerObject <= 0 || nValues < 0) {
+        LERROR(fmt::format("Error reading header of cache file '{}'", file));
+        return std::nullopt;
+    }
+    dataset.nValuesPerObject = nValuesPerObject;
+
+    dataset.columnNames.reserve(nValuesPerObject);
+    dataset.columnRanges.resize(nValuesPerObject);
+    for (int32_t i = 0; i < nValuesPerObject; ++i) {
+        dataset.columnNames.push_back(readString(fileStream));
+        fileStream.read(
+            reinterpret_cast<char*>(&dataset.columnRanges[i]),
+            sizeof(glm::vec2)
+        );
+    }
+
+    int32_t nMetadata = 0;
+    fileStream.read(reinterpret_cast<char*>(&nMetadata), sizeof(int32_t));
+    for (int32_t i = 0; i < nMetadata; ++i) {
+        std::string key = readString(fileStream);
+        int32_t value = 0;
+        fileStream.read(reinterpret_cast<char*>(&value), sizeof(int32_t));
+        dataset.metadata[std::move(key)] = value;
+    }
+
+    const int64_t headerSize = static_cast<int64_t>(fileStream.tellg());
+    const int64_t padding = (DataAlignment - headerSize % DataAlignment) % DataAlignment;
+    fileStream.ignore(padding);
+
+    dataset.data.resize(nValues);
+    fileStream.read(
+        reinterpret_cast<char*>(dataset.data.data()),
+        nValues * sizeof(float)
+    );
+
+    if (!fileStream.good()) {
+        LERROR(fmt::format("Error reading cache file '{}'", file));
+        return std::nullopt;
+    }
+    return dataset;
+}
+
+} // namespace openspace::speckcache
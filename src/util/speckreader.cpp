@@ -0,0 +1,180 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/speckreader.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+
+namespace {
+    // Chunks smaller than this are not worth the overhead of a separate task
+    constexpr const size_t MinChunkSize = 1024 * 1024;
+
+    struct ChunkResult {
+        std::vector<float> values;
+        size_t nNullRows = 0;
+    };
+
+    // Parses the lines in [begin, end). The range has to end at a line boundary and the
+    // line after the range must start with a character that is not part of a number, the
+    // terminating null character of the buffer satisfies this
+    ChunkResult parseChunk(const char* begin, const char* end, int nValuesPerRow,
+                           bool skipNullRows)
+    {
+        ChunkResult result;
+        result.values.reserve((end - begin) / 8);
+        std::vector<float> row(nValuesPerRow);
+
+        const char* p = begin;
+        while (p < end) {
+            const char* lineEnd = std::find(p, end, '\n');
+
+            // Guard against wrong line endings (copying files from Windows to Mac)
+            const char* contentEnd = lineEnd;
+            if (contentEnd > p && *(contentEnd - 1) == '\r') {
+                --contentEnd;
+            }
+
+            if (contentEnd == p) {
+                p = lineEnd + 1;
+                continue;
+            }
+
+            std::fill(row.begin(), row.end(), 0.f);
+            for (int i = 0; i < nValuesPerRow; ++i) {
+                while (p < contentEnd && (*p == ' ' || *p == '\t')) {
+                    ++p;
+                }
+                if (p >= contentEnd) {
+                    break;
+                }
+
+                char* valueEnd = nullptr;
+                const float v = std::strtof(p, &valueEnd);
+                if (valueEnd == p || valueEnd > contentEnd) {
+                    // Not a number, the rest of the row stays 0
+                    break;
+                }
+                row[i] = v;
+                p = valueEnd;
+            }
+
+            const bool isNullRow = std::all_of(
+                row.begin(),
+                row.end(),
+                [](float v) { return v == 0.f; }
+            );
+            if (skipNullRows && isNullRow) {
+                result.nNullRows++;
+            }
+            else {
+                result.values.insert(result.values.end(), row.begin(), row.end());
+            }
+
+            p = lineEnd + 1;
+        }
+        return result;
+    }
+} // namespace
+
+namespace openspace::speckreader {
+
+DataRows readDataRows(std::ifstream& file, int nValuesPerRow, bool skipNullRows) {
+    DataRows result;
+    if (nValuesPerRow <= 0) {
+        return result;
+    }
+
+    // Read the remainder of the file into memory
+    const std::streampos start = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streampos end = file.tellg();
+    file.seekg(start);
+    if (start < 0 || end <= start) {
+        return result;
+    }
+
+    std::string buffer(static_cast<size_t>(end - start), '\0');
+    file.read(buffer.data(), buffer.size());
+    buffer.resize(static_cast<size_t>(file.gcount()));
+
+    // Split the buffer into chunks at line boundaries
+    const size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t chunkSize = std::max(MinChunkSize, buffer.size() / nThreads + 1);
+
+    std::vector<std::pair<const char*, const char*>> chunks;
+    const char* chunkBegin = buffer.data();
+    const char* bufferEnd = buffer.data() + buffer.size();
+    while (chunkBegin < bufferEnd) {
+        const char* chunkEnd = chunkBegin + std::min(
+            chunkSize,
+            static_cast<size_t>(bufferEnd - chunkBegin)
+        );
+        chunkEnd = std::find(chunkEnd, bufferEnd, '\n');
+        if (chunkEnd != bufferEnd) {
+            ++chunkEnd;
+        }
+        chunks.emplace_back(chunkBegin, chunkEnd);
+        chunkBegin = chunkEnd;
+    }
+
+    std::vector<std::future<ChunkResult>> futures;
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        futures.push_back(std::async(
+            std::launch::async,
+            parseChunk,
+            chunks[i].first,
+            chunks[i].second,
+            nValuesPerRow,
+            skipNullRows
+        ));
+    }
+
+    // Parse the first chunk on this thread and then append the rest in order
+    if (!chunks.empty()) {
+        ChunkResult first = parseChunk(
+            chunks[0].first,
+            chunks[0].second,
+            nValuesPerRow,
+            skipNullRows
+        );
+        result.values = std::move(first.values);
+        result.nNullRows = first.nNullRows;
+    }
+    for (std::future<ChunkResult>& f : futures) {
+        ChunkResult chunk = f.get();
+        result.values.insert(
+            result.values.end(),
+            chunk.values.begin(),
+            chunk.values.end()
+        );
+        result.nNullRows += chunk.nNullRows;
+    }
+    return result;
+}
+
+} // namespace openspace::speckreader
@@ -27,10 +27,14 @@
 #include <openspace/scripting/lualibrary.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/assert.h>
 #include <algorithm>
+#include <fstream>
+#include <future>
+#include <optional>
 #include "SpiceUsr.h"
 #include "SpiceZpr.h"
 
@@ -42,6 +46,10 @@ namespace {
     // as the maximum message length
     constexpr const unsigned SpiceErrorBufferSize = 1841;
 
+    // The caches are cleared every frame, this only limits their size if the
+    // SpiceManager is used outside of the render loop, for example in tasks
+    constexpr const size_t MaxCacheEntries = 8192;
+
     // This method checks if one of the previous SPICE methods has failed. If it has, an
     // exception with the SPICE error message is thrown
     // If an error occurred, true is returned, otherwise, false
@@ -65,6 +73,153 @@ namespace {
         }
     }
 
+    // The version of the cached kernel coverage files. This has to be increased whenever
+    // the layout of the cache files changes
+    constexpr const int8_t CoverageCacheVersion = 1;
+
+    // The number of bytes at the beginning and at the end of a kernel that are included
+    // in its content hash. Hashing the entire kernel would defeat the purpose of the
+    // cache for large kernels
+    constexpr const std::streamoff HashedBytes = 1024 * 1024;
+
+    using Coverage = std::map<int, std::vector<std::pair<double, double>>>;
+
+    enum class KernelType {
+        Ck,
+        Spk,
+        Other
+    };
+
+    KernelType kernelType(const std::string& path) {
+        using File = ghoul::filesystem::File;
+        const std::string ext = File(path, File::RawPath::Yes).fileExtension();
+        if (ext == "bc" || ext == "BC") {
+            return KernelType::Ck;
+        }
+        else if (ext == "bsp" || ext == "BSP") {
+            return KernelType::Spk;
+        }
+        else {
+            return KernelType::Other;
+        }
+    }
+
+    struct CachedCoverage {
+        uint64_t size = 0;
+        uint64_t hash = 0;
+        // Contains a value only if a valid cache file existed for the kernel
+        std::optional<Coverage> coverage;
+    };
+
+    // Computes the size and the FNV-1a hash over the beginning and the end of the kernel
+    std::pair<uint64_t, uint64_t> kernelFingerprint(const std::string& path) {
+        std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+        const std::streamoff size = file.tellg();
+
+        uint64_t hash = 14695981039346656037ULL;
+        std::vector<char> buffer;
+        auto hashRange = [&](std::streamoff begin, std::streamoff count) {
+            buffer.resize(static_cast<size_t>(count));
+            file.seekg(begin);
+            file.read(buffer.data(), count);
+            for (char c : buffer) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ULL;
+            }
+        };
+
+        if (size <= 2 * HashedBytes) {
+            hashRange(0, size);
+        }
+        else {
+            hashRange(0, HashedBytes);
+            hashRange(size - HashedBytes, HashedBytes);
+        }
+        return { static_cast<uint64_t>(size), hash };
+    }
+
+    // Reads the coverage of the kernel at \p path from the \p cacheFile. This function
+    // does not call into SPICE and can thus be executed on any thread
+    CachedCoverage loadCachedCoverage(const std::string& path,
+                                      const std::string& cacheFile)
+    {
+        CachedCoverage result;
+        std::tie(result.size, result.hash) = kernelFingerprint(path);
+
+        std::ifstream file(cacheFile, std::ios::in | std::ios::binary);
+        if (!file.good()) {
+            return result;
+        }
+
+        int8_t version = 0;
+        file.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+        uint64_t size = 0;
+        file.read(reinterpret_cast<char*>(&size), sizeof(uint64_t));
+        uint64_t hash = 0;
+        file.read(reinterpret_cast<char*>(&hash), sizeof(uint64_t));
+        if (!file.good() || version != CoverageCacheVersion || size != result.size ||
+            hash != result.hash)
+        {
+            return result;
+        }
+
+        int32_t nObjects = 0;
+        file.read(reinterpret_cast<char*>(&nObjects), sizeof(int32_t));
+        Coverage coverage;
+        for (int32_t i = 0; i < nObjects && file.good(); ++i) {
+            int32_t id = 0;
+            file.read(reinterpret_cast<char*>(&id), sizeof(int32_t));
+            int32_t nIntervals = 0;
+            file.read(reinterpret_cast<char*>(&nIntervals), sizeof(int32_t));
+
+            std::vector<std::pair<double, double>>& intervals = coverage[id];
+            intervals.reserve(nIntervals);
+            for (int32_t j = 0; j < nIntervals && file.good(); ++j) {
+                double b = 0.0;
+                file.read(reinterpret_cast<char*>(&b), sizeof(double));
+                double e = 0.0;
+                file.read(reinterpret_cast<char*>(&e), sizeof(double));
+                intervals.emplace_back(b, e);
+            }
+        }
+
+        if (file.good()) {
+            result.coverage = std::move(coverage);
+        }
+        return result;
+    }
+
+    bool saveCachedCoverage(const std::string& cacheFile, const CachedCoverage& info,
+                            const Coverage& coverage)
+    {
+        std::ofstream file(cacheFile, std::ios::out | std::ios::binary);
+        if (!file.good()) {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&CoverageCacheVersion), sizeof(int8_t));
+        file.write(reinterpret_cast<const char*>(&info.size), sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&info.hash), sizeof(uint64_t));
+
+        const int32_t nObjects = static_cast<int32_t>(coverage.size());
+        file.write(reinterpret_cast<const char*>(&nObjects), sizeof(int32_t));
+        for (const std::pair<const int, std::vector<std::pair<double, double>>>& c :
+             coverage)
+        {
+            const int32_t id = c.first;
+            file.write(reinterpret_cast<const char*>(&id), sizeof(int32_t));
+            const int32_t nIntervals = static_cast<int32_t>(c.second.size());
+            file.write(reinterpret_cast<const char*>(&nIntervals), sizeof(int32_t));
+            for (const std::pair<double, double>& interval : c.second) {
+                const double b = interval.first;
+                file.write(reinterpret_cast<const char*>(&b), sizeof(double));
+                const double e = interval.second;
+                file.write(reinterpret_cast<const char*>(&e), sizeof(double));
+            }
+        }
+        return file.good();
+    }
+
     const char* toString(openspace::SpiceManager::FieldOfViewMethod m) {
         using SM = openspace::SpiceManager;
         switch (m) {
@@ -207,66 +362,123 @@ SpiceManager& SpiceManager::ref() {
 }
 
 SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
-    ghoul_assert(!filePath.empty(), "Empty file path");
-    ghoul_assert(
-        FileSys.fileExists(filePath),
-        fmt::format("File '{}' ('{}') does not exist", filePath, absPath(filePath))
-    );
-    ghoul_assert(
-        FileSys.directoryExists(ghoul::filesystem::File(filePath).directoryName()),
-        fmt::format(
-            "File '{}' exists, but directory '{}' doesn't",
-            absPath(filePath), ghoul::filesystem::File(filePath).directoryName()
-        )
-    );
+    return loadKernels({ std::move(filePath) }).front();
+}
 
-    std::string path = absPath(std::move(filePath));
-    const auto it = std::find_if(
-        _loadedKernels.begin(),
-        _loadedKernels.end(),
-        [path](const KernelInformation& info) { return info.path == path; }
-    );
+std::vector<SpiceManager::KernelHandle> SpiceManager::loadKernels(
+                                                       std::vector<std::string> filePaths)
+{
+    using RawPath = ghoul::filesystem::File::RawPath;
 
-    if (it != _loadedKernels.end()) {
-        it->refCount++;
-        return it->id;
+    std::vector<std::string> paths;
+    paths.reserve(filePaths.size());
+    for (std::string& filePath : filePaths) {
+        ghoul_assert(!filePath.empty(), "Empty file path");
+        ghoul_assert(
+            FileSys.fileExists(filePath),
+            fmt::format("File '{}' ('{}') does not exist", filePath, absPath(filePath))
+        );
+        ghoul_assert(
+            FileSys.directoryExists(ghoul::filesystem::File(filePath).directoryName()),
+            fmt::format(
+                "File '{}' exists, but directory '{}' doesn't",
+                absPath(filePath), ghoul::filesystem::File(filePath).directoryName()
+            )
+        );
+        paths.push_back(absPath(std::move(filePath)));
     }
 
-    // We need to set the current directory as meta-kernels are usually defined relative
-    // to the directory they reside in. The directory change is not necessary for regular
-    // kernels
-    ghoul::filesystem::Directory currentDirectory = FileSys.currentDirectory();
-    using RawPath = ghoul::filesystem::File::RawPath;
-    std::string fileDirectory = ghoul::filesystem::File(
-        path,
-        RawPath::Yes
-    ).directoryName();
-    FileSys.setCurrentDirectory(fileDirectory);
-
-    LINFO(fmt::format("Loading SPICE kernel '{}'", path));
-    // Load the kernel
-    furnsh_c(path.c_str());
-
-    // Reset the current directory to the previous one
-    FileSys.setCurrentDirectory(currentDirectory);
-
-    throwOnSpiceError("Kernel loading");
-
-    std::string fileExtension = ghoul::filesystem::File(
-        path,
-        RawPath::Yes
-    ).fileExtension();
-    if (fileExtension == "bc" || fileExtension == "BC") {
-        findCkCoverage(path); // binary ck kernel
-    }
-    else if (fileExtension == "bsp" || fileExtension == "BSP") {
-        findSpkCoverage(path); // binary spk kernel
+    auto findKernel = [this](const std::string& path) {
+        return std::find_if(
+            _loadedKernels.begin(),
+            _loadedKernels.end(),
+            [&path](const KernelInformation& info) { return info.path == path; }
+        );
+    };
+
+    // Hashing the binary kernels and reading their cached coverage does not require
+    // SPICE, so it is started for all new kernels up front and overlaps with the loading
+    // of the preceding kernels
+    std::vector<std::string> cacheFiles(paths.size());
+    std::vector<std::future<CachedCoverage>> cachedCoverages(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (kernelType(paths[i]) == KernelType::Other) {
+            continue;
+        }
+        if (findKernel(paths[i]) != _loadedKernels.end()) {
+            continue;
+        }
+        if (std::find(paths.begin(), paths.begin() + i, paths[i]) != paths.begin() + i) {
+            continue;
+        }
+
+        cacheFiles[i] = FileSys.cacheManager()->cachedFilename(
+            paths[i],
+            ghoul::filesystem::CacheManager::Persistent::Yes
+        );
+        cachedCoverages[i] = std::async(
+            std::launch::async,
+            loadCachedCoverage,
+            paths[i],
+            cacheFiles[i]
+        );
     }
 
-    KernelHandle kernelId = ++_lastAssignedKernel;
-    ghoul_assert(kernelId != 0, fmt::format("Kernel Handle wrapped around to 0"));
-    _loadedKernels.push_back({std::move(path), kernelId, 1});
-    return kernelId;
+    std::vector<KernelHandle> handles;
+    handles.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        std::string& path = paths[i];
+
+        const auto it = findKernel(path);
+        if (it != _loadedKernels.end()) {
+            it->refCount++;
+            handles.push_back(it->id);
+            continue;
+        }
+
+        // We need to set the current directory as meta-kernels are usually defined
+        // relative to the directory they reside in. The directory change is not necessary
+        // for regular kernels
+        ghoul::filesystem::Directory currentDirectory = FileSys.currentDirectory();
+        std::string fileDirectory = ghoul::filesystem::File(
+            path,
+            RawPath::Yes
+        ).directoryName();
+        FileSys.setCurrentDirectory(fileDirectory);
+
+        LINFO(fmt::format("Loading SPICE kernel '{}'", path));
+        // Load the kernel
+        furnsh_c(path.c_str());
+
+        // Reset the current directory to the previous one
+        FileSys.setCurrentDirectory(currentDirectory);
+
+        throwOnSpiceError("Kernel loading");
+
+        if (cachedCoverages[i].valid()) {
+            const bool isCk = kernelType(path) == KernelType::Ck;
+            CachedCoverage cached = cachedCoverages[i].get();
+            if (cached.coverage) {
+                LDEBUG(fmt::format("Using cached coverage for '{}'", path));
+            }
+            else {
+                cached.coverage = isCk ? findCkCoverage(path) : findSpkCoverage(path);
+                if (!saveCachedCoverage(cacheFiles[i], cached, *cached.coverage)) {
+                    LWARNING(fmt::format(
+                        "Error writing coverage cache file '{}'", cacheFiles[i]
+                    ));
+                }
+            }
+            storeCoverage(*cached.coverage, isCk);
+        }
+
+        KernelHandle kernelId = ++_lastAssignedKernel;
+        ghoul_assert(kernelId != 0, fmt::format("Kernel Handle wrapped around to 0"));
+        _loadedKernels.push_back({ std::move(path), kernelId, 1 });
+        handles.push_back(kernelId);
+        clearCache();
+    }
+    return handles;
 }
 
 void SpiceManager::unloadKernel(KernelHandle kernelId) {
@@ -286,6 +498,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", it->path));
             unload_c(it->path.c_str());
             _loadedKernels.erase(it);
+            clearCache();
         }
         // Otherwise, we hold on to it, but reduce the reference counter by 1
         else {
@@ -322,6 +535,7 @@ void SpiceManager::unloadKernel(std::string filePath) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", path));
             unload_c(path.c_str());
             _loadedKernels.erase(it);
+            clearCache();
         }
         else {
             // Otherwise, we hold on to it, but reduce the reference counter by 1
@@ -347,6 +561,19 @@ bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
     return false;
 }
 
+std::vector<std::pair<double, double>> SpiceManager::spkCoverage(
+                                                          const std::string& target) const
+{
+    ghoul_assert(!target.empty(), "Empty target");
+
+    const int id = naifId(target);
+    const auto it = _spkIntervals.find(id);
+    if (it != _spkIntervals.end()) {
+        return it->second;
+    }
+    return {};
+}
+
 bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
     ghoul_assert(!frame.empty(), "Empty target");
 
@@ -509,6 +736,66 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
     ghoul_assert(!observer.empty(), "Observer is not empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
 
+    PositionCacheKey key = std::make_tuple(
+        target,
+        observer,
+        referenceFrame,
+        aberrationCorrection.type,
+        aberrationCorrection.direction,
+        ephemerisTime
+    );
+    const auto it = _positionCache.find(key);
+    if (it != _positionCache.end()) {
+        lightTime = it->second.second;
+        return it->second.first;
+    }
+
+    double lt = 0.0;
+    glm::dvec3 position = computeTargetPosition(
+        target,
+        observer,
+        referenceFrame,
+        aberrationCorrection,
+        ephemerisTime,
+        lt
+    );
+
+    if (_positionCache.size() >= MaxCacheEntries) {
+        _positionCache.clear();
+    }
+    _positionCache.emplace(std::move(key), std::make_pair(position, lt));
+    lightTime = lt;
+    return position;
+}
+
+std::vector<glm::dvec3> SpiceManager::targetPositions(
+                                                const std::vector<std::string>& targets,
+                                                              const std::string& observer,
+                                                        const std::string& referenceFrame,
+                                                AberrationCorrection aberrationCorrection,
+                                                               double ephemerisTime) const
+{
+    std::vector<glm::dvec3> positions;
+    positions.reserve(targets.size());
+    for (const std::string& target : targets) {
+        positions.push_back(targetPosition(
+            target,
+            observer,
+            referenceFrame,
+            aberrationCorrection,
+            ephemerisTime
+        ));
+    }
+    return positions;
+}
+
+glm::dvec3 SpiceManager::computeTargetPosition(const std::string& target,
+                                               const std::string& observer,
+                                               const std::string& referenceFrame,
+                                               AberrationCorrection aberrationCorrection,
+                                               double ephemerisTime,
+                                               double& lightTime) const
+{
     bool targetHasCoverage = hasSpkCoverage(target, ephemerisTime);
     bool observerHasCoverage = hasSpkCoverage(observer, ephemerisTime);
     if (!targetHasCoverage && !observerHasCoverage) {
@@ -771,6 +1058,29 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
+    TransformCacheKey key = std::make_tuple(sourceFrame, destinationFrame, ephemerisTime);
+    const auto it = _transformCache.find(key);
+    if (it != _transformCache.end()) {
+        return it->second;
+    }
+
+    glm::dmat3 result = computePositionTransformMatrix(
+        sourceFrame,
+        destinationFrame,
+        ephemerisTime
+    );
+
+    if (_transformCache.size() >= MaxCacheEntries) {
+        _transformCache.clear();
+    }
+    _transformCache.emplace(std::move(key), result);
+    return result;
+}
+
+glm::dmat3 SpiceManager::computePositionTransformMatrix(const std::string& sourceFrame,
+                                                     const std::string& destinationFrame,
+                                                        double ephemerisTime) const
+{
     glm::dmat3 result;
     pxform_c(
         sourceFrame.c_str(),
@@ -940,7 +1250,9 @@ std::string SpiceManager::frameFromBody(const std::string& body) const {
     }
 }
 
-void SpiceManager::findCkCoverage(const std::string& path) {
+SpiceManager::KernelCoverage SpiceManager::findCkCoverage(
+                                                            const std::string& path) const
+{
     ghoul_assert(!path.empty(), "Empty file path");
     ghoul_assert(FileSys.fileExists(path), fmt::format("File '{}' does not exist", path));
 
@@ -961,6 +1273,8 @@ void SpiceManager::findCkCoverage(const std::string& path) {
     ckobj_c(path.c_str(), &ids);
     throwOnSpiceError("Error finding Ck Coverage");
 
+    KernelCoverage coverage;
+
     for (SpiceInt i = 0; i < card_c(&ids); ++i) {
         const SpiceInt frame = SPICE_CELL_ELEM_I(&ids, i); // NOLINT
 
@@ -983,14 +1297,15 @@ void SpiceManager::findCkCoverage(const std::string& path) {
             wnfetd_c(&cover, j, &b, &e);
             throwOnSpiceError("Error finding Ck Coverage");
 
-            _ckCoverageTimes[frame].insert(e);
-            _ckCoverageTimes[frame].insert(b);
-            _ckIntervals[frame].emplace_back(b, e);
+            coverage[frame].emplace_back(b, e);
         }
     }
+    return coverage;
 }
 
-void SpiceManager::findSpkCoverage(const std::string& path) {
+SpiceManager::KernelCoverage SpiceManager::findSpkCoverage(
+                                                            const std::string& path) const
+{
     ghoul_assert(!path.empty(), "Empty file path");
     ghoul_assert(FileSys.fileExists(path), fmt::format("File '{}' does not exist", path));
 
@@ -1011,6 +1326,8 @@ void SpiceManager::findSpkCoverage(const std::string& path) {
     spkobj_c(path.c_str(), &ids);
     throwOnSpiceError("Error finding Spk ID for coverage");
 
+    KernelCoverage coverage;
+
     for (SpiceInt i = 0; i < card_c(&ids); ++i) {
         const SpiceInt obj = SPICE_CELL_ELEM_I(&ids, i); // NOLINT
 
@@ -1033,10 +1350,24 @@ void SpiceManager::findSpkCoverage(const std::string& path) {
             wnfetd_c(&cover, j, &b, &e);
             throwOnSpiceError("Error finding Spk coverage");
 
+            coverage[obj].emplace_back(b, e);
+        }
+    }
+    return coverage;
+}
+
+void SpiceManager::storeCoverage(const KernelCoverage& coverage, bool isCk) {
+    std::map<int, std::set<double>>& times = isCk ? _ckCoverageTimes : _spkCoverageTimes;
+    KernelCoverage& intervals = isCk ? _ckIntervals : _spkIntervals;
+
+    for (const std::pair<const int, std::vector<std::pair<double, double>>>& c :
+         coverage)
+    {
+        for (const std::pair<double, double>& interval : c.second) {
             // insert all into coverage time set, the windows could be merged @AA
-            _spkCoverageTimes[obj].insert(e);
-            _spkCoverageTimes[obj].insert(b);
-            _spkIntervals[obj].emplace_back(b, e);
+            times[c.first].insert(interval.second);
+            times[c.first].insert(interval.first);
+            intervals[c.first].push_back(interval);
         }
     }
 }
@@ -1239,6 +1570,11 @@ SpiceManager::UseException SpiceManager::exceptionHandling() const {
     return _useExceptions;
 }
 
+void SpiceManager::clearCache() {
+    _positionCache.clear();
+    _transformCache.clear();
+}
+
 scripting::LuaLibrary SpiceManager::luaLibrary() {
     return {
         "spice",
@@ -1247,9 +1583,12 @@ scripting::LuaLibrary SpiceManager::luaLibrary() {
                 "loadKernel",
                 &luascriptfunctions::loadKernel,
                 {},
-                "string",
+                "{string, table}",
                 "Loads the provided SPICE kernel by name. The name can contain path "
-                "tokens, which are automatically resolved"
+                "tokens, which are automatically resolved. If a list of kernels is "
+                "provided, they are loaded in order, the coverage of the binary kernels "
+                "is read from the cache concurrently, and a list of the kernel handles "
+                "is returned"
             },
             {
                 "unloadKernel",
@@ -23,23 +23,57 @@
  ****************************************************************************************/
 
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/dictionary.h>
 
 namespace openspace::luascriptfunctions {
 
 /**
  * \ingroup LuaScripts
- * loadKernel(string):
+ * loadKernel({string, table}):
  * Loads the provided SPICE kernel by name. The name can contain path tokens, which are
- * automatically resolved.
+ * automatically resolved. If a list of kernels is provided, they are all loaded in order
+ * and a list of the kernel handles is returned.
  */
 
 int loadKernel(lua_State* L) {
     ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::loadKernel");
 
+    if (lua_istable(L, 1)) {
+        ghoul::Dictionary d;
+        ghoul::lua::luaDictionaryFromState(L, d);
+        lua_settop(L, 0);
+
+        std::vector<std::string> kernels;
+        for (size_t i = 1; i <= d.size(); ++i) {
+            std::string kernel = d.value<std::string>(std::to_string(i));
+            if (!FileSys.fileExists(kernel)) {
+                return ghoul::lua::luaError(
+                    L,
+                    fmt::format("Kernel file '{}' did not exist", kernel)
+                );
+            }
+            kernels.push_back(std::move(kernel));
+        }
+
+        std::vector<SpiceManager::KernelHandle> result =
+            SpiceManager::ref().loadKernels(std::move(kernels));
+
+        lua_createtable(L, static_cast<int>(result.size()), 0);
+        for (size_t i = 0; i < result.size(); ++i) {
+            lua_pushnumber(L, result[i]);
+            lua_rawseti(L, -2, static_cast<int>(i + 1));
+        }
+
+        ghoul_assert(lua_gettop(L) == 1, "Incorrect number of items left on stack");
+        return 1;
+    }
+
     bool isString = (lua_isstring(L, 1) == 1);
     if (!isString) {
         LERROR(fmt::format(
-            "{}: Expected argument of type 'string'", ghoul::lua::errorLocation(L)
+            "{}: Expected argument of type 'string' or 'table'",
+            ghoul::lua::errorLocation(L)
         ));
         return 0;
     }
@@ -24,6 +24,8 @@
 
 #include <openspace/util/syncbuffer.h>
 
+#include <algorithm>
+
 namespace openspace {
 
 SyncBuffer::SyncBuffer(size_t n)
@@ -34,10 +36,17 @@ SyncBuffer::SyncBuffer(size_t n)
 
 SyncBuffer::~SyncBuffer() {} // NOLINT
 
+void SyncBuffer::ensureCapacity(size_t size) {
+    const size_t required = _encodeOffset + size;
+    if (required > _dataStream.size()) {
+        _dataStream.resize(std::max(required, 2 * _dataStream.size()));
+    }
+}
+
 void SyncBuffer::encode(const std::string& s) {
-    ghoul_assert(_encodeOffset + sizeof(char) * s.size() + sizeof(int32_t) < _n, "");
+    const int32_t length = static_cast<int32_t>(s.length());
+    ensureCapacity(sizeof(int32_t) + length);
 
-    int32_t length = static_cast<int32_t>(s.length());
     memcpy(
         _dataStream.data() + _encodeOffset,
         reinterpret_cast<const char*>(&length),
@@ -48,24 +57,35 @@ void SyncBuffer::encode(const std::string& s) {
     _encodeOffset += length;
 }
 
+void SyncBuffer::encodeBytes(const char* data, size_t size) {
+    ensureCapacity(size);
+    memcpy(_dataStream.data() + _encodeOffset, data, size);
+    _encodeOffset += size;
+}
+
 std::string SyncBuffer::decode() {
+    return std::string(decodeStringView());
+}
+
+std::string_view SyncBuffer::decodeStringView() {
+    ghoul_assert(_decodeOffset + sizeof(int32_t) <= _dataStream.size(), "");
+
     int32_t length;
     memcpy(
         reinterpret_cast<char*>(&length),
         _dataStream.data() + _decodeOffset,
         sizeof(int32_t)
     );
-    std::vector<char> tmp(length + 1);
     _decodeOffset += sizeof(int32_t);
-    memcpy(tmp.data(), _dataStream.data() + _decodeOffset, length);
+    ghoul_assert(_decodeOffset + length <= _dataStream.size(), "");
+
+    std::string_view s(_dataStream.data() + _decodeOffset, length);
     _decodeOffset += length;
-    tmp[length] = '\0';
-    std::string ret(tmp.data());
-    return ret;
+    return s;
 }
 
 void SyncBuffer::decode(std::string& s) {
-    s = decode();
+    s = decodeStringView();
 }
 
 void SyncBuffer::setData(std::vector<char> data) {
@@ -73,13 +93,25 @@ void SyncBuffer::setData(std::vector<char> data) {
 }
 
 std::vector<char> SyncBuffer::data() {
-    _dataStream.resize(_encodeOffset);
+    return std::vector<char>(
+        _dataStream.begin(),
+        _dataStream.begin() + _encodeOffset
+    );
+}
 
-    return _dataStream;
+const char* SyncBuffer::encodedData() const {
+    return _dataStream.data();
+}
+
+size_t SyncBuffer::encodedSize() const {
+    return _encodeOffset;
 }
 
 void SyncBuffer::reset() {
-    _dataStream.resize(_n);
+    // The buffer is only ever grown so that the memory is reused in the next frame
+    if (_dataStream.size() < _n) {
+        _dataStream.resize(_n);
+    }
     _encodeOffset = 0;
     _decodeOffset = 0;
 }
@@ -30,6 +30,12 @@
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/templatefactory.h>
 
+namespace {
+    constexpr const char* KeyType = "Type";
+    constexpr const char* KeyIdentifier = "Identifier";
+    constexpr const char* KeyDependencies = "Dependencies";
+} // namespace
+
 namespace openspace {
 
 documentation::Documentation Task::documentation() {
@@ -39,13 +45,29 @@ documentation::Documentation Task::documentation() {
         "core_task",
         {
             {
-                "Type",
+                KeyType,
                 new StringAnnotationVerifier("A valid Task created by a factory"),
                 Optional::No,
                 "This key specifies the type of Task that gets created. It has to be one"
                 "of the valid Tasks that are available for creation (see the "
                 "FactoryDocumentation for a list of possible Tasks), which depends on "
                 "the configration of the application"
+            },
+            {
+                KeyIdentifier,
+                new StringVerifier,
+                Optional::Yes,
+                "An identifier for this Task that other Tasks in the same task file can "
+                "use to declare that they depend on this Task"
+            },
+            {
+                KeyDependencies,
+                new StringListVerifier,
+                Optional::Yes,
+                "The identifiers of the Tasks that have to finish successfully before "
+                "this Task is performed. Tasks without dependencies might be performed "
+                "concurrently with other Tasks if the TaskRunner is allowed to use more "
+                "than one thread"
             }
         }
     };
@@ -53,16 +75,34 @@ documentation::Documentation Task::documentation() {
 
 std::unique_ptr<Task> Task::createFromDictionary(const ghoul::Dictionary& dictionary) {
     openspace::documentation::testSpecificationAndThrow(
-        documentation::Documentation(),
+        documentation(),
         dictionary,
         "Task"
     );
 
-    std::string taskType = dictionary.value<std::string>("Type");
+    std::string taskType = dictionary.value<std::string>(KeyType);
     auto factory = FactoryManager::ref().factory<Task>();
 
     std::unique_ptr<Task> task = factory->create(taskType, dictionary);
+
+    if (dictionary.hasKey(KeyIdentifier)) {
+        task->_identifier = dictionary.value<std::string>(KeyIdentifier);
+    }
+    if (dictionary.hasKey(KeyDependencies)) {
+        const ghoul::Dictionary d = dictionary.value<ghoul::Dictionary>(KeyDependencies);
+        for (size_t i = 1; i <= d.size(); ++i) {
+            task->_dependencies.push_back(d.value<std::string>(std::to_string(i)));
+        }
+    }
     return task;
 }
 
+const std::string& Task::identifier() const {
+    return _identifier;
+}
+
+const std::vector<std::string>& Task::dependencies() const {
+    return _dependencies;
+}
+
 } // namespace openspace
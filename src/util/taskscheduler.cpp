@@ -0,0 +1,266 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/taskscheduler.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+
+namespace {
+    constexpr const char* _loggerCat = "TaskScheduler";
+
+    // The capacity of the queue that each worker keeps for its own tasks. Tasks that do
+    // not fit are passed on to the shared queue of their priority
+    constexpr const size_t WorkerQueueCapacity = 256;
+
+    // Set for the worker threads, so that tasks submitted from inside of a task can be
+    // kept on the worker that submitted them
+    thread_local const openspace::TaskScheduler* CurrentScheduler = nullptr;
+    thread_local size_t CurrentWorker = 0;
+} // namespace
+
+namespace openspace {
+
+TaskScheduler::Task::Task(Task&& other) noexcept
+    : _operations(other._operations)
+{
+    if (_operations) {
+        _operations->move(&other._storage, &_storage);
+        other._operations = nullptr;
+    }
+}
+
+TaskScheduler::Task& TaskScheduler::Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+        reset();
+        _operations = other._operations;
+        if (_operations) {
+            _operations->move(&other._storage, &_storage);
+            other._operations = nullptr;
+        }
+    }
+    return *this;
+}
+
+TaskScheduler::Task::~Task() {
+    reset();
+}
+
+void TaskScheduler::Task::operator()() {
+    ghoul_assert(_operations, "Task must not be empty");
+    _operations->invoke(&_storage);
+}
+
+TaskScheduler::Task::operator bool() const {
+    return _operations != nullptr;
+}
+
+void TaskScheduler::Task::reset() {
+    if (_operations) {
+        _operations->destroy(&_storage);
+        _operations = nullptr;
+    }
+}
+
+TaskScheduler::CancellationToken::CancellationToken()
+    : _isCancelled(std::make_shared<std::atomic<bool>>(false))
+{}
+
+void TaskScheduler::CancellationToken::cancel() {
+    *_isCancelled = true;
+}
+
+bool TaskScheduler::CancellationToken::isCancelled() const {
+    return *_isCancelled;
+}
+
+TaskScheduler::Worker::Worker() : tasks(WorkerQueueCapacity) {}
+
+TaskScheduler::TaskScheduler(size_t nThreads)
+    : _nThreads(
+        nThreads > 0 ?
+        nThreads :
+        // The main thread is busy with rendering, so it does not get a worker
+        std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(2)) - 1
+    )
+{}
+
+TaskScheduler::~TaskScheduler() {
+    deinitialize();
+}
+
+void TaskScheduler::submit(Task task, Priority priority) {
+    ghoul_assert(task, "Task must not be empty");
+    submit(Entry{ std::move(task), nullptr }, priority);
+}
+
+void TaskScheduler::submit(Task task, const CancellationToken& token, Priority priority)
+{
+    ghoul_assert(task, "Task must not be empty");
+    submit(Entry{ std::move(task), token._isCancelled }, priority);
+}
+
+void TaskScheduler::submit(Entry entry, Priority priority) {
+    ensureWorkersRunning();
+
+    bool isQueued = false;
+    if (priority == Priority::Normal) {
+        // Tasks submitted by a worker are kept by that worker, as they are likely to work
+        // on the same data as the task that spawned them. All other tasks are spread
+        // across the workers so that they do not all contend for the same queue
+        const size_t worker = (CurrentScheduler == this) ?
+            CurrentWorker :
+            _nextWorker++ % _workers.size();
+        isQueued = _workers[worker]->tasks.tryPush(std::move(entry));
+    }
+    if (!isQueued) {
+        _queues[static_cast<int>(priority)].push(std::move(entry));
+    }
+
+    // The counter has to be increased before the sleeping workers are checked, as the
+    // workers register themselves as sleeping before they look at the counter
+    ++_nQueued;
+    if (_nSleeping > 0) {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _wakeUp.notify_one();
+    }
+}
+
+void TaskScheduler::deinitialize() {
+    std::lock_guard<std::mutex> startLock(_startMutex);
+    if (!_isRunning) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _shouldStop = true;
+        _wakeUp.notify_all();
+    }
+    for (std::unique_ptr<Worker>& worker : _workers) {
+        worker->thread.join();
+    }
+    _workers.clear();
+
+    _shouldStop = false;
+    _isRunning = false;
+}
+
+size_t TaskScheduler::numberOfThreads() const {
+    return _nThreads;
+}
+
+bool TaskScheduler::isWorkerThread() const {
+    return CurrentScheduler == this;
+}
+
+void TaskScheduler::ensureWorkersRunning() {
+    if (_isRunning) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_startMutex);
+    if (_isRunning) {
+        return;
+    }
+
+    // All queues have to exist before the first worker starts looking for work in them
+    _workers.reserve(_nThreads);
+    for (size_t i = 0; i < _nThreads; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < _nThreads; ++i) {
+        _workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+    LDEBUG(fmt::format("Started {} worker threads", _nThreads));
+
+    _isRunning = true;
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+    CurrentScheduler = this;
+    CurrentWorker = index;
+
+    Entry entry;
+    while (true) {
+        if (findTask(index, entry)) {
+            --_nQueued;
+
+            if (!entry.isCancelled || !*entry.isCancelled) {
+                try {
+                    entry.task();
+                }
+                catch (const ghoul::RuntimeError& e) {
+                    LERRORC(e.component, e.message);
+                }
+                catch (const std::exception& e) {
+                    LERROR(e.what());
+                }
+            }
+
+            // Release the captured state of the task right away instead of keeping it
+            // alive until the next task replaces it
+            entry = Entry();
+            continue;
+        }
+
+        // There are no tasks left anywhere, so a requested shutdown can proceed
+        if (_shouldStop) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        ++_nSleeping;
+        _wakeUp.wait(lock, [this]() { return _nQueued > 0 || _shouldStop; });
+        --_nSleeping;
+    }
+}
+
+bool TaskScheduler::findTask(size_t index, Entry& entry) {
+    if (_queues[static_cast<int>(Priority::High)].tryPop(entry)) {
+        return true;
+    }
+    if (_workers[index]->tasks.tryPop(entry)) {
+        return true;
+    }
+    if (_queues[static_cast<int>(Priority::Normal)].tryPop(entry)) {
+        return true;
+    }
+
+    // Steal from the other workers, starting with the next one so that the thieves do
+    // not all descend on the same victim
+    const size_t nWorkers = _workers.size();
+    for (size_t i = 1; i < nWorkers; ++i) {
+        if (_workers[(index + i) % nWorkers]->tasks.tryPop(entry)) {
+            return true;
+        }
+    }
+
+    return _queues[static_cast<int>(Priority::Low)].tryPop(entry);
+}
+
+} // namespace openspace
@@ -24,79 +24,116 @@
 
 #include <openspace/util/threadpool.h>
 
+#include <openspace/engine/globals.h>
+#include <openspace/util/concurrentqueue.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace {
+    constexpr const char* _loggerCat = "ThreadPool";
+} // namespace
+
 namespace openspace {
 
-Worker::Worker(ThreadPool& p) : pool(p) {}
+struct ThreadPool::State {
+    size_t maxConcurrency;
+    TaskScheduler::Priority priority;
 
-void Worker::operator()() {
-    std::function<void()> task;
-    while (true) {
-        // acquire lock
-        {
-            std::unique_lock<std::mutex> lock(pool.queue_mutex);
+    ConcurrentQueue<TaskScheduler::Task> tasks;
 
-            // look for a work item
-            while (!pool.stop && pool.tasks.empty()) {
-                // if there are none wait for notification
-                pool.condition.wait(lock);
-            }
+    /// The number of tasks that have been handed to the scheduler
+    std::atomic<size_t> nScheduled = 0;
+    /// The number of tasks that are currently executing
+    std::atomic<size_t> nExecuting = 0;
+    std::atomic<bool> isStopped = false;
 
-            if (pool.stop) { // exit if the pool is stopped
-                return;
-            }
+    std::mutex mutex;
+    std::condition_variable executionFinished;
+};
 
-            // get the task from the queue
-            task = pool.tasks.front();
-            pool.tasks.pop_front();
+ThreadPool::ThreadPool(size_t numThreads, TaskScheduler::Priority priority)
+    : _state(std::make_shared<State>())
+{
+    _state->maxConcurrency = std::max(numThreads, size_t(1));
+    _state->priority = priority;
+}
 
-        } // release lock
+ThreadPool::ThreadPool(const ThreadPool& toCopy)
+    : ThreadPool(toCopy._state->maxConcurrency, toCopy._state->priority)
+{}
 
-        // execute the task
-        task();
-    }
+ThreadPool::~ThreadPool() {
+    _state->isStopped = true;
+    clearTasks();
+
+    // The tasks that are already running might still refer to the owner of this pool,
+    // so we have to wait for them. Tasks that the scheduler has not started yet see the
+    // stopped flag and return without touching anything but the shared state
+    std::unique_lock<std::mutex> lock(_state->mutex);
+    _state->executionFinished.wait(lock, [this]() { return _state->nExecuting == 0; });
 }
 
-ThreadPool::ThreadPool(size_t numThreads) : stop(false) {
-    for (size_t i = 0; i < numThreads; ++i) {
-        workers.emplace_back(std::thread(Worker(*this)));
-    }
+void ThreadPool::enqueue(TaskScheduler::Task task) {
+    _state->tasks.push(std::move(task));
+    schedule(_state);
 }
 
-ThreadPool::ThreadPool(const ThreadPool& toCopy) : ThreadPool(toCopy.workers.size()) {}
-
-// the destructor joins all threads
-ThreadPool::~ThreadPool() {
-    // stop all threads
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        stop = true;
-    }
-    condition.notify_all();
+void ThreadPool::clearTasks() {
+    TaskScheduler::Task task;
+    while (_state->tasks.tryPop(task)) {}
+}
 
-    // join them
-    for (std::thread& w : workers) {
-        w.join();
+void ThreadPool::schedule(const std::shared_ptr<State>& state) {
+    size_t nScheduled = state->nScheduled;
+    while (nScheduled < state->maxConcurrency) {
+        if (state->nScheduled.compare_exchange_weak(nScheduled, nScheduled + 1)) {
+            global::taskScheduler.submit(
+                [state]() { runNext(state); },
+                state->priority
+            );
+            return;
+        }
     }
 }
 
-// add new work item to the pool
-void ThreadPool::enqueue(std::function<void()> f) {
-    { // acquire lock
-        std::unique_lock<std::mutex> lock(queue_mutex);
-
-        // add the task
-        tasks.push_back(std::move(f));
-    } // release lock
-
-    // wake up one thread
-    condition.notify_one();
-}
+void ThreadPool::runNext(const std::shared_ptr<State>& state) {
+    TaskScheduler::Task task;
+    if (state->tasks.tryPop(task)) {
+        // Registering as executing before checking the flag, while the destructor sets
+        // the flag before checking the number of executing tasks, guarantees that either
+        // we see the pool being stopped or the destructor waits for us
+        ++state->nExecuting;
+        if (!state->isStopped) {
+            try {
+                task();
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.message);
+            }
+            catch (const std::exception& e) {
+                LERROR(e.what());
+            }
+        }
+        // The captured state of the task has to be gone before the owner is released
+        task = TaskScheduler::Task();
+
+        --state->nExecuting;
+        if (state->isStopped) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->executionFinished.notify_all();
+        }
+    }
 
-void ThreadPool::clearTasks() {
-    { // acquire lock
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.clear();
-    } // release lock
+    // Each scheduled task runs a single queued task and then makes room for the next
+    // one, so that a busy pool does not monopolize a worker of the scheduler
+    --state->nScheduled;
+    if (!state->isStopped && !state->tasks.empty()) {
+        schedule(state);
+    }
 }
 
 } // namespace openspace
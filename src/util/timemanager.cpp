@@ -168,7 +168,7 @@ void TimeManager::preSynchronization(double dt) {
 }
 
 TimeKeyframeData TimeManager::interpolate(double applicationTime) {
-    const std::deque<Keyframe<TimeKeyframeData>>& keyframes = _timeline.keyframes();
+    const KeyframeSpan<TimeKeyframeData> keyframes = _timeline.keyframes();
 
     auto firstFutureKeyframe = std::lower_bound(
         keyframes.begin(),
@@ -237,7 +237,7 @@ void TimeManager::progressTime(double dt) {
     }
 
     const double now = global::windowDelegate.applicationTime();
-    const std::deque<Keyframe<TimeKeyframeData>>& keyframes = _timeline.keyframes();
+    const KeyframeSpan<TimeKeyframeData> keyframes = _timeline.keyframes();
 
     auto firstFutureKeyframe = std::lower_bound(
         keyframes.begin(),
@@ -338,6 +338,16 @@ void TimeManager::addKeyframe(double timestamp, TimeKeyframeData time) {
     _timelineChanged = true;
 }
 
+void TimeManager::addKeyframes(
+                             std::vector<std::pair<double, TimeKeyframeData>> keyframes)
+{
+    if (keyframes.empty()) {
+        return;
+    }
+    _timeline.addKeyframes(std::move(keyframes));
+    _timelineChanged = true;
+}
+
 void TimeManager::removeKeyframesAfter(double timestamp, bool inclusive) {
     size_t nKeyframes = _timeline.nKeyframes();
     _timeline.removeKeyframesAfter(timestamp, inclusive);
@@ -494,6 +504,14 @@ bool TimeManager::isPaused() const {
     return _timePaused;
 }
 
+std::optional<double> TimeManager::predictedTime(double dt) const {
+    if (_shouldSetTime || _timeline.nKeyframes() > 0 || isPaused()) {
+        return std::nullopt;
+    }
+    // This has to be the same computation as the advance in progressTime
+    return _currentTime.data().j2000Seconds() + dt * _targetDeltaTime;
+}
+
 float TimeManager::defaultTimeInterpolationDuration() const {
     return _defaultTimeInterpolationDuration;
 }
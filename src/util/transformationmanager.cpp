@@ -27,6 +27,7 @@
 #include <openspace/util/spicemanager.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
+#include <cmath>
 
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 #ifdef WIN32
@@ -41,6 +42,16 @@
 #endif // WIN32
 #endif
 
+namespace {
+    // The number of transformations that are remembered before the cache is cleared.
+    // The requests of a frame are mostly for a handful of frame pairs at the same time
+    constexpr const size_t MaxCachedTransformations = 256;
+
+    // Time in seconds between the samples of the Kameleon transformations
+    constexpr const double KameleonSampleInterval = 60.0;
+    constexpr const size_t MaxKameleonSamples = 1024;
+} // namespace
+
 namespace openspace {
 
 TransformationManager* TransformationManager::_instance = nullptr;
@@ -87,7 +98,42 @@ TransformationManager& TransformationManager::ref() {
 }
 
 
-glm::dmat3 TransformationManager::kameleonTransformationMatrix(
+glm::dmat3 TransformationManager::kameleonTransformationMatrix(const std::string& from,
+                                                               const std::string& to,
+                                                               double ephemerisTime) const
+{
+    const double sample = ephemerisTime / KameleonSampleInterval;
+    const double first = std::floor(sample);
+    const long long firstIndex = static_cast<long long>(first);
+
+    const glm::dquat q0 = kameleonSample(from, to, firstIndex);
+    const glm::dquat q1 = kameleonSample(from, to, firstIndex + 1);
+    return glm::mat3_cast(glm::slerp(q0, q1, sample - first));
+}
+
+glm::dquat TransformationManager::kameleonSample(const std::string& from,
+                                                 const std::string& to,
+                                                 long long sampleIndex) const
+{
+    std::tuple<std::string, std::string, long long> key = { from, to, sampleIndex };
+    auto it = _kameleonSamples.find(key);
+    if (it != _kameleonSamples.end()) {
+        return it->second;
+    }
+
+    if (_kameleonSamples.size() >= MaxKameleonSamples) {
+        _kameleonSamples.clear();
+    }
+    const glm::dquat sample = glm::quat_cast(exactKameleonTransformationMatrix(
+        from,
+        to,
+        static_cast<double>(sampleIndex) * KameleonSampleInterval
+    ));
+    _kameleonSamples.emplace(std::move(key), sample);
+    return sample;
+}
+
+glm::dmat3 TransformationManager::exactKameleonTransformationMatrix(
                                                  [[maybe_unused]] const std::string& from,
                                                    [[maybe_unused]] const std::string& to,
                                               [[maybe_unused]] double ephemerisTime) const
@@ -115,7 +161,31 @@ glm::dmat3 TransformationManager::kameleonTransformationMatrix(
 #endif
 }
 
-glm::dmat3 TransformationManager::frameTransformationMatrix(
+glm::dmat3 TransformationManager::frameTransformationMatrix(const std::string& from,
+                                                            const std::string& to,
+                                                            double ephemerisTime) const
+{
+    std::lock_guard lock(_mutex);
+
+    std::tuple<std::string, std::string, double> key = { from, to, ephemerisTime };
+    auto it = _transformationCache.find(key);
+    if (it != _transformationCache.end()) {
+        return it->second;
+    }
+
+    if (_transformationCache.size() >= MaxCachedTransformations) {
+        _transformationCache.clear();
+    }
+    const glm::dmat3 transformation = computeFrameTransformationMatrix(
+        from,
+        to,
+        ephemerisTime
+    );
+    _transformationCache.emplace(std::move(key), transformation);
+    return transformation;
+}
+
+glm::dmat3 TransformationManager::computeFrameTransformationMatrix(
                                                  [[maybe_unused]] const std::string& from,
                                                    [[maybe_unused]] const std::string& to,
                                               [[maybe_unused]] double ephemerisTime) const
@@ -0,0 +1,80 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/concurrentqueue.h>
+
+#include <thread>
+#include <vector>
+
+OPENSPACE_BENCHMARK(ConcurrentQueuePushPop) {
+    using namespace openspace;
+
+    // Stays within the lock-free ring of the queue
+    constexpr const int NItems = 512;
+
+    ConcurrentQueue<int> queue;
+    int sum = 0;
+    while (state.keepRunning()) {
+        for (int i = 0; i < NItems; ++i) {
+            queue.push(i);
+        }
+        for (int i = 0; i < NItems; ++i) {
+            sum += queue.pop();
+        }
+    }
+    state.setItemsProcessed(state.iterations() * NItems);
+    if (sum < 0) {
+        std::cerr << "Invalid sum of popped items" << std::endl;
+    }
+}
+
+OPENSPACE_BENCHMARK(ConcurrentQueueThroughput) {
+    using namespace openspace;
+
+    // Two producers and two consumers move all items through a single queue. The time
+    // includes starting and joining the threads, which is small compared to the items
+    constexpr const int NThreads = 2;
+    constexpr const int NItemsPerThread = 50000;
+
+    ConcurrentQueue<int> queue;
+    while (state.keepRunning()) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NThreads; ++t) {
+            threads.emplace_back([&queue]() {
+                for (int i = 0; i < NItemsPerThread; ++i) {
+                    queue.push(i);
+                }
+            });
+            threads.emplace_back([&queue]() {
+                for (int i = 0; i < NItemsPerThread; ++i) {
+                    queue.pop();
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+    state.setItemsProcessed(state.iterations() * NThreads * NItemsPerThread);
+}
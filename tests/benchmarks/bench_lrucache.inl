@@ -0,0 +1,73 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/lrucache.h>
+
+#include <string>
+
+namespace {
+    struct LRUCacheHasher {
+        unsigned long long operator()(const int& var) const {
+            return static_cast<unsigned long long>(var);
+        }
+    };
+
+    using BenchmarkLRUCache =
+        openspace::globebrowsing::cache::LRUCache<int, std::string, LRUCacheHasher>;
+
+    constexpr const int LRUCacheSize = 1024;
+} // namespace
+
+OPENSPACE_BENCHMARK(LRUCachePut) {
+    BenchmarkLRUCache cache(LRUCacheSize);
+    const std::string value = "value";
+
+    // Cycling through four times as many keys as fit into the cache evicts the least
+    // recently used item with every put once the cache is full
+    int key = 0;
+    while (state.keepRunning()) {
+        cache.put(key, value);
+        key = (key + 1) % (4 * LRUCacheSize);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+OPENSPACE_BENCHMARK(LRUCacheGet) {
+    BenchmarkLRUCache cache(LRUCacheSize);
+    for (int i = 0; i < LRUCacheSize; ++i) {
+        cache.put(i, std::to_string(i));
+    }
+
+    // Stepping through the keys with a stride touches items all over the list
+    int key = 0;
+    size_t totalSize = 0;
+    while (state.keepRunning()) {
+        totalSize += cache.get(key).size();
+        key = (key + 97) % LRUCacheSize;
+    }
+    state.setItemsProcessed(state.iterations());
+    if (totalSize == 0) {
+        std::cerr << "Cache did not contain any items" << std::endl;
+    }
+}
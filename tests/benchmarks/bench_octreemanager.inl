@@ -0,0 +1,120 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/gaia/rendering/octreemanager.h>
+
+#include <ghoul/glm.h>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr const int NOctreeStars = 200000;
+    constexpr const int NValuesPerStar = 8;
+
+    // Random stars within the default extent of the octree of 2 kPc
+    std::vector<std::vector<float>> createStars() {
+        std::mt19937 generator(1337);
+        std::uniform_real_distribution<float> position(-2.f, 2.f);
+        std::uniform_real_distribution<float> magnitude(-5.f, 20.f);
+        std::uniform_real_distribution<float> other(0.f, 1.f);
+
+        std::vector<std::vector<float>> stars(NOctreeStars);
+        for (std::vector<float>& star : stars) {
+            star.resize(NValuesPerStar);
+            star[0] = position(generator);
+            star[1] = position(generator);
+            star[2] = position(generator);
+            star[3] = magnitude(generator);
+            star[4] = magnitude(generator);
+            for (int i = 5; i < NValuesPerStar; ++i) {
+                star[i] = other(generator);
+            }
+        }
+        return stars;
+    }
+} // namespace
+
+OPENSPACE_BENCHMARK(OctreeManagerInsert) {
+    using namespace openspace;
+
+    const std::vector<std::vector<float>> stars = createStars();
+
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        OctreeManager octree;
+        octree.initOctree();
+        state.resumeTiming();
+
+        for (const std::vector<float>& star : stars) {
+            octree.insert(star);
+        }
+
+        // Exclude the destruction of the tree from the measurement
+        state.pauseTiming();
+    }
+    state.setItemsProcessed(state.iterations() * NOctreeStars);
+}
+
+OPENSPACE_BENCHMARK(OctreeManagerTraverseData) {
+    using namespace openspace;
+
+    OctreeManager octree;
+    octree.initOctree();
+    for (const std::vector<float>& star : createStars()) {
+        octree.insert(star);
+    }
+    octree.sliceLodData();
+    octree.initBufferIndexStack(static_cast<long long>(octree.totalNodes()), true, true);
+
+    // Alternating between looking in opposite directions unloads the nodes of one half
+    // of the tree and loads those of the other half every traversal
+    const glm::dmat4 projection = glm::perspective(
+        glm::radians(60.0),
+        16.0 / 9.0,
+        1e10,
+        1e23
+    );
+    const glm::dvec3 up(0.0, 1.0, 0.0);
+    const glm::dmat4 views[2] = {
+        glm::lookAt(glm::dvec3(0.0), glm::dvec3(0.0, 0.0, -1.0), up),
+        glm::lookAt(glm::dvec3(0.0), glm::dvec3(0.0, 0.0, 1.0), up)
+    };
+    const glm::vec2 screenSize(1920.f, 1080.f);
+
+    size_t nChunks = 0;
+    int i = 0;
+    while (state.keepRunning()) {
+        int deltaStars = 0;
+        std::map<int, std::vector<float>> data = octree.traverseData(
+            projection * views[i],
+            screenSize,
+            deltaStars,
+            gaia::RenderOption::Color,
+            250.f
+        );
+        nChunks += data.size();
+        i = 1 - i;
+    }
+    state.setItemsProcessed(nChunks);
+}
@@ -0,0 +1,78 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalar/floatproperty.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+OPENSPACE_BENCHMARK(PropertyOwnerProperty) {
+    using namespace openspace;
+    using namespace openspace::properties;
+
+    // A hierarchy that resembles a scene with many scene graph nodes that each own a
+    // renderable with a few properties
+    constexpr const int NOwners = 200;
+    constexpr const int NPropertiesPerOwner = 10;
+
+    PropertyOwner root({ "Root" });
+    std::vector<std::unique_ptr<PropertyOwner>> nodes;
+    std::vector<std::unique_ptr<PropertyOwner>> renderables;
+    std::vector<std::unique_ptr<FloatProperty>> properties;
+    std::vector<std::string> uris;
+    for (int i = 0; i < NOwners; ++i) {
+        nodes.push_back(std::make_unique<PropertyOwner>(
+            PropertyOwner::PropertyOwnerInfo{ "Node" + std::to_string(i) }
+        ));
+        renderables.push_back(std::make_unique<PropertyOwner>(
+            PropertyOwner::PropertyOwnerInfo{ "Renderable" }
+        ));
+        root.addPropertySubOwner(nodes.back().get());
+        nodes.back()->addPropertySubOwner(renderables.back().get());
+
+        for (int j = 0; j < NPropertiesPerOwner; ++j) {
+            const std::string identifier = "Property" + std::to_string(j);
+            properties.push_back(std::make_unique<FloatProperty>(
+                Property::PropertyInfo(identifier.c_str(), identifier.c_str(), "")
+            ));
+            renderables.back()->addProperty(properties.back().get());
+            uris.push_back(nodes.back()->identifier() + ".Renderable." + identifier);
+        }
+    }
+
+    size_t nFound = 0;
+    size_t i = 0;
+    while (state.keepRunning()) {
+        if (root.property(uris[i])) {
+            ++nFound;
+        }
+        i = (i + 7919) % uris.size();
+    }
+    state.setItemsProcessed(state.iterations());
+    if (nFound != state.iterations()) {
+        std::cerr << "Not all properties were found" << std::endl;
+    }
+}
@@ -0,0 +1,64 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/speckreader.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <fstream>
+#include <random>
+
+OPENSPACE_BENCHMARK(SpeckReaderReadDataRows) {
+    using namespace openspace;
+
+    // About the size of the smaller digital universe datasets
+    constexpr const int NRows = 100000;
+    constexpr const int NValuesPerRow = 7;
+
+    const std::string path = absPath("${TEMPORARY}/benchmark.speck");
+    {
+        std::mt19937 generator(1337);
+        std::uniform_real_distribution<float> distribution(-1000.f, 1000.f);
+        std::ofstream file(path);
+        for (int i = 0; i < NRows; ++i) {
+            for (int j = 0; j < NValuesPerRow; ++j) {
+                file << distribution(generator) << ' ';
+            }
+            file << "# Star " << i << '\n';
+        }
+    }
+
+    size_t nRows = 0;
+    while (state.keepRunning()) {
+        std::ifstream file(path);
+        speckreader::DataRows rows = speckreader::readDataRows(
+            file,
+            NValuesPerRow,
+            true
+        );
+        nRows += rows.values.size() / NValuesPerRow;
+    }
+    state.setItemsProcessed(nRows);
+
+    FileSys.deleteFile(path);
+}
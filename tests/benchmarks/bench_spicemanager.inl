@@ -0,0 +1,70 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/spicemanager.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <vector>
+
+OPENSPACE_BENCHMARK(SpiceManagerTargetPosition) {
+    using namespace openspace;
+
+    const std::vector<std::string> kernels = {
+        "${TESTDIR}/SpiceTest/spicekernels/naif0008.tls",
+        "${TESTDIR}/SpiceTest/spicekernels/cas00084.tsc",
+        "${TESTDIR}/SpiceTest/spicekernels/981005_PLTEPH-DE405S.bsp",
+        "${TESTDIR}/SpiceTest/spicekernels/020514_SE_SAT105.bsp",
+        "${TESTDIR}/SpiceTest/spicekernels/030201AP_SK_SM546_T45.bsp"
+    };
+    std::vector<SpiceManager::KernelHandle> handles;
+    for (const std::string& kernel : kernels) {
+        handles.push_back(SpiceManager::ref().loadKernel(absPath(kernel)));
+    }
+
+    const SpiceManager::AberrationCorrection corr = {
+        SpiceManager::AberrationCorrection::Type::LightTimeStellar,
+        SpiceManager::AberrationCorrection::Direction::Reception
+    };
+    const double et = SpiceManager::ref().ephemerisTimeFromDate("2004 jun 11 19:32:00");
+
+    // Using a different time in every iteration avoids measuring only cached results
+    double sum = 0.0;
+    int i = 0;
+    while (state.keepRunning()) {
+        double lightTime = 0.0;
+        const glm::dvec3 p = SpiceManager::ref().targetPosition(
+            "EARTH", "CASSINI", "J2000", corr, et + static_cast<double>(i), lightTime
+        );
+        sum += p.x;
+        i = (i + 1) % 3600;
+    }
+    state.setItemsProcessed(state.iterations());
+
+    for (SpiceManager::KernelHandle h : handles) {
+        SpiceManager::ref().unloadKernel(h);
+    }
+    if (sum == 0.0) {
+        std::cerr << "Invalid sum of positions" << std::endl;
+    }
+}
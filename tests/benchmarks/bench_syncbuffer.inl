@@ -0,0 +1,77 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/syncbuffer.h>
+
+#include <ghoul/glm.h>
+#include <string>
+
+namespace {
+    // Roughly the size of the state that a synchronized camera and time produce
+    constexpr const int NSyncValues = 64;
+} // namespace
+
+OPENSPACE_BENCHMARK(SyncBufferEncode) {
+    openspace::SyncBuffer buffer(4096);
+    const glm::dvec3 position(1.0, 2.0, 3.0);
+    const glm::dquat rotation(1.0, 0.0, 0.0, 0.0);
+    const std::string name = "Earth";
+
+    while (state.keepRunning()) {
+        buffer.reset();
+        for (int i = 0; i < NSyncValues; ++i) {
+            buffer.encode(position);
+            buffer.encode(rotation);
+            buffer.encode(static_cast<double>(i));
+            buffer.encode(name);
+        }
+    }
+    state.setItemsProcessed(state.iterations() * NSyncValues);
+}
+
+OPENSPACE_BENCHMARK(SyncBufferDecode) {
+    openspace::SyncBuffer buffer(4096);
+    for (int i = 0; i < NSyncValues; ++i) {
+        buffer.encode(glm::dvec3(1.0, 2.0, 3.0));
+        buffer.encode(glm::dquat(1.0, 0.0, 0.0, 0.0));
+        buffer.encode(static_cast<double>(i));
+        buffer.encode(std::string("Earth"));
+    }
+
+    // Resetting the buffer rewinds the decoding but keeps the encoded bytes
+    double sum = 0.0;
+    while (state.keepRunning()) {
+        buffer.reset();
+        for (int i = 0; i < NSyncValues; ++i) {
+            sum += buffer.decode<glm::dvec3>().x;
+            sum += buffer.decode<glm::dquat>().w;
+            sum += buffer.decode<double>();
+            sum += static_cast<double>(buffer.decodeStringView().size());
+        }
+    }
+    state.setItemsProcessed(state.iterations() * NSyncValues);
+    if (sum < 0.0) {
+        std::cerr << "Invalid sum of decoded values" << std::endl;
+    }
+}
@@ -0,0 +1,84 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/timeline.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr const int NTimelineKeyframes = 10000;
+    constexpr const int NTimelineQueries = 4096;
+
+    openspace::Timeline<double> createTimeline() {
+        openspace::Timeline<double> timeline;
+        for (int i = 0; i < NTimelineKeyframes; ++i) {
+            timeline.addKeyframe(static_cast<double>(i), static_cast<double>(i));
+        }
+        return timeline;
+    }
+} // namespace
+
+OPENSPACE_BENCHMARK(TimelineRandomLookup) {
+    const openspace::Timeline<double> timeline = createTimeline();
+
+    std::mt19937 generator(1337);
+    std::uniform_real_distribution<double> distribution(0.0, NTimelineKeyframes);
+    std::vector<double> times(NTimelineQueries);
+    for (double& t : times) {
+        t = distribution(generator);
+    }
+
+    double sum = 0.0;
+    size_t i = 0;
+    while (state.keepRunning()) {
+        const openspace::Keyframe<double>* k = timeline.lastKeyframeBefore(times[i]);
+        sum += k ? k->data : 0.0;
+        i = (i + 1) % times.size();
+    }
+    state.setItemsProcessed(state.iterations());
+    if (sum < 0.0) {
+        std::cerr << "Invalid sum of keyframes" << std::endl;
+    }
+}
+
+OPENSPACE_BENCHMARK(TimelineSequentialLookup) {
+    const openspace::Timeline<double> timeline = createTimeline();
+
+    // Advancing in small steps is what happens during playback every frame
+    double sum = 0.0;
+    double time = 0.0;
+    while (state.keepRunning()) {
+        const openspace::Keyframe<double>* k = timeline.firstKeyframeAfter(time);
+        sum += k ? k->data : 0.0;
+        time += 0.1;
+        if (time >= NTimelineKeyframes) {
+            time = 0.0;
+        }
+    }
+    state.setItemsProcessed(state.iterations());
+    if (sum < 0.0) {
+        std::cerr << "Invalid sum of keyframes" << std::endl;
+    }
+}
@@ -0,0 +1,222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "benchmark.h"
+
+#include <openspace/json.h>
+#include <openspace/openspace.h>
+#include <ghoul/fmt.h>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr const uint64_t MaxIterations = 1000000000;
+
+    struct Benchmark {
+        std::string name;
+        openspace::benchmark::Function function;
+    };
+
+    std::vector<Benchmark>& benchmarks() {
+        static std::vector<Benchmark> b;
+        return b;
+    }
+
+    std::string currentDate() {
+        std::time_t now = std::time(nullptr);
+        std::array<char, 64> buffer;
+        std::strftime(buffer.data(), buffer.size(), "%FT%T", std::localtime(&now));
+        return buffer.data();
+    }
+} // namespace
+
+namespace openspace::benchmark {
+
+State::State(uint64_t nIterations)
+    : _nIterations(nIterations)
+    , _nRemaining(nIterations)
+{}
+
+bool State::keepRunning() {
+    if (!_isRunning) {
+        _isRunning = true;
+        resumeTiming();
+    }
+    if (_nRemaining == 0) {
+        pauseTiming();
+        return false;
+    }
+    --_nRemaining;
+    return true;
+}
+
+void State::pauseTiming() {
+    if (_isPaused) {
+        return;
+    }
+    _realSeconds += std::chrono::duration<double>(Clock::now() - _realStart).count();
+    _cpuSeconds += static_cast<double>(std::clock() - _cpuStart) / CLOCKS_PER_SEC;
+    _isPaused = true;
+}
+
+void State::resumeTiming() {
+    _isPaused = false;
+    _cpuStart = std::clock();
+    _realStart = Clock::now();
+}
+
+void State::setItemsProcessed(uint64_t nItems) {
+    _nItems = nItems;
+}
+
+uint64_t State::iterations() const {
+    return _nIterations;
+}
+
+struct Runner {
+    struct Result {
+        double realSeconds;
+        double cpuSeconds;
+        uint64_t nItems;
+    };
+
+    static Result run(const Function& function, uint64_t nIterations) {
+        State state(nIterations);
+        function(state);
+        // Stop the timer in case the benchmark left its loop early
+        state.pauseTiming();
+        return { state._realSeconds, state._cpuSeconds, state._nItems };
+    }
+};
+
+bool registerBenchmark(std::string name, Function function) {
+    benchmarks().push_back({ std::move(name), std::move(function) });
+    return true;
+}
+
+int runBenchmarks(const std::string& filter, double minTime,
+                  const std::string& outputPath)
+{
+    const std::regex regex(filter.empty() ? ".*" : filter);
+
+    std::vector<Benchmark> selected;
+    for (const Benchmark& b : benchmarks()) {
+        if (std::regex_search(b.name, regex)) {
+            selected.push_back(b);
+        }
+    }
+    std::sort(
+        selected.begin(),
+        selected.end(),
+        [](const Benchmark& lhs, const Benchmark& rhs) { return lhs.name < rhs.name; }
+    );
+
+    nlohmann::json results = nlohmann::json::array();
+
+    std::cout << fmt::format(
+        "{:<40} {:>15} {:>15} {:>12}\n", "Benchmark", "Time", "CPU", "Iterations"
+    );
+    for (const Benchmark& b : selected) {
+        // Increase the number of iterations until a single run takes long enough to be
+        // meaningful, using the last run as an estimate for the next number
+        uint64_t nIterations = 1;
+        Runner::Result res = Runner::run(b.function, nIterations);
+        while (res.realSeconds < minTime && nIterations < MaxIterations) {
+            const double factor = res.realSeconds > minTime / 10.0 ?
+                (minTime * 1.4) / res.realSeconds :
+                10.0;
+            nIterations = std::min(
+                MaxIterations,
+                std::max(
+                    nIterations + 1,
+                    static_cast<uint64_t>(static_cast<double>(nIterations) * factor)
+                )
+            );
+            res = Runner::run(b.function, nIterations);
+        }
+
+        const double n = static_cast<double>(nIterations);
+        const double realTime = res.realSeconds / n * 1e9;
+        const double cpuTime = res.cpuSeconds / n * 1e9;
+
+        std::string line = fmt::format(
+            "{:<40} {:>12.0f} ns {:>12.0f} ns {:>12}",
+            b.name, realTime, cpuTime, nIterations
+        );
+
+        nlohmann::json result = {
+            { "name", b.name },
+            { "run_name", b.name },
+            { "run_type", "iteration" },
+            { "iterations", nIterations },
+            { "real_time", realTime },
+            { "cpu_time", cpuTime },
+            { "time_unit", "ns" }
+        };
+        if (res.nItems > 0 && res.realSeconds > 0.0) {
+            const double itemsPerSecond =
+                static_cast<double>(res.nItems) / res.realSeconds;
+            result["items_per_second"] = itemsPerSecond;
+            line += fmt::format(" {:>12.4g} items/s", itemsPerSecond);
+        }
+        std::cout << line << std::endl;
+        results.push_back(std::move(result));
+    }
+
+    if (!outputPath.empty()) {
+        nlohmann::json output = {
+            {
+                "context",
+                {
+                    { "date", currentDate() },
+                    { "num_cpus", std::thread::hardware_concurrency() },
+#ifdef NDEBUG
+                    { "library_build_type", "release" },
+#else
+                    { "library_build_type", "debug" },
+#endif // NDEBUG
+                    { "openspace_version", OPENSPACE_VERSION_STRING_FULL },
+                    { "openspace_commit", OPENSPACE_GIT_FULL }
+                }
+            },
+            { "benchmarks", std::move(results) }
+        };
+        std::ofstream file(outputPath);
+        file << output.dump(2) << std::endl;
+        if (!file.good()) {
+            std::cerr << fmt::format("Could not write results to '{}'", outputPath)
+                      << std::endl;
+        }
+    }
+
+    return static_cast<int>(selected.size());
+}
+
+} // namespace openspace::benchmark
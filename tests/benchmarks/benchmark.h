@@ -0,0 +1,107 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_TEST___BENCHMARK___H__
+#define __OPENSPACE_TEST___BENCHMARK___H__
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+
+namespace openspace::benchmark {
+
+/**
+ * The State is passed to every benchmark function, which repeats its measured code for
+ * as long as #keepRunning returns \c true. Work that should not be measured, such as
+ * resetting the benchmarked object, can be excluded by surrounding it with #pauseTiming
+ * and #resumeTiming.
+ */
+class State {
+public:
+    explicit State(uint64_t nIterations);
+
+    bool keepRunning();
+
+    void pauseTiming();
+    void resumeTiming();
+
+    /// Sets the number of items processed by all iterations to report a throughput
+    void setItemsProcessed(uint64_t nItems);
+
+    uint64_t iterations() const;
+
+private:
+    friend struct Runner;
+
+    using Clock = std::chrono::steady_clock;
+
+    const uint64_t _nIterations;
+    uint64_t _nRemaining;
+    bool _isRunning = false;
+    bool _isPaused = false;
+
+    Clock::time_point _realStart;
+    std::clock_t _cpuStart = 0;
+    double _realSeconds = 0.0;
+    double _cpuSeconds = 0.0;
+    uint64_t _nItems = 0;
+};
+
+using Function = std::function<void(State&)>;
+
+/**
+ * Registers the benchmark \p function under the \p name. This function is used by the
+ * OPENSPACE_BENCHMARK macro and returns \c true to make it usable in static
+ * initialization.
+ */
+bool registerBenchmark(std::string name, Function function);
+
+/**
+ * Runs all registered benchmarks whose name matches the ECMAScript regular expression
+ * \p filter. Each benchmark is repeated until it has run for at least \p minTime
+ * seconds. The results are printed to the console and, if \p outputPath is not empty,
+ * written to that file using the JSON format of Google Benchmark so that the results
+ * of different releases can be compared with the existing tools for that format.
+ *
+ * \return The number of benchmarks that were run
+ */
+int runBenchmarks(const std::string& filter, double minTime,
+    const std::string& outputPath);
+
+} // namespace openspace::benchmark
+
+/**
+ * Defines and registers a benchmark function with the provided \p name, which has to be
+ * a valid identifier. The function has a parameter <code>state</code> of type
+ * openspace::benchmark::State.
+ */
+#define OPENSPACE_BENCHMARK(name)                                                        \
+    static void name(openspace::benchmark::State& state);                                \
+    [[maybe_unused]] static const bool name##Registered =                                \
+        openspace::benchmark::registerBenchmark(#name, name);                            \
+    static void name(openspace::benchmark::State& state)
+
+#endif // __OPENSPACE_TEST___BENCHMARK___H__
@@ -0,0 +1,101 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "benchmark.h"
+
+#include <openspace/engine/configuration.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/openspaceengine.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/ghoul.h>
+#include <iostream>
+#include <string>
+
+#include "bench_concurrentqueue.inl"
+#include "bench_propertyowner.inl"
+#include "bench_speckreader.inl"
+#include "bench_spicemanager.inl"
+#include "bench_syncbuffer.inl"
+#include "bench_timeline.inl"
+
+#ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
+#include "bench_lrucache.inl"
+#endif // OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
+
+#ifdef OPENSPACE_MODULE_GAIA_ENABLED
+#include "bench_octreemanager.inl"
+#endif // OPENSPACE_MODULE_GAIA_ENABLED
+
+namespace {
+    constexpr const char* FilterArgument = "--benchmark_filter=";
+    constexpr const char* MinTimeArgument = "--benchmark_min_time=";
+    constexpr const char* OutputArgument = "--benchmark_out=";
+
+    bool startsWith(const std::string& s, const std::string& prefix) {
+        return s.compare(0, prefix.size(), prefix) == 0;
+    }
+} // namespace
+
+// The command line arguments are named after their Google Benchmark counterparts:
+//   --benchmark_filter=<regex>   Only run the benchmarks whose name matches the regex
+//   --benchmark_min_time=<s>     The minimum time in seconds each benchmark runs for
+//   --benchmark_out=<file>       Writes the results as JSON into the file
+int main(int argc, char** argv) {
+    using namespace openspace;
+
+    std::string filter;
+    double minTime = 0.5;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (startsWith(arg, FilterArgument)) {
+            filter = arg.substr(std::string(FilterArgument).size());
+        }
+        else if (startsWith(arg, MinTimeArgument)) {
+            minTime = std::stod(arg.substr(std::string(MinTimeArgument).size()));
+        }
+        else if (startsWith(arg, OutputArgument)) {
+            outputPath = arg.substr(std::string(OutputArgument).size());
+        }
+        else {
+            std::cerr << "Unknown argument '" << arg << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    ghoul::initialize();
+
+    std::string configFile = configuration::findConfiguration();
+    global::configuration = configuration::loadConfigurationFromFile(configFile);
+    global::openSpaceEngine.initialize();
+
+    FileSys.registerPathToken("${TESTDIR}", "${BASE}/tests");
+
+    const int nBenchmarks = benchmark::runBenchmarks(filter, minTime, outputPath);
+    if (nBenchmarks == 0) {
+        std::cerr << "No benchmark matches the filter '" << filter << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -67,6 +67,7 @@
 #include <test_luaconversions.inl>
 #include <test_optionproperty.inl>
 #include <test_powerscalecoordinates.inl>
+#include <test_prefixtrie.inl>
 #include <test_scriptscheduler.inl>
 #include <test_spicemanager.inl>
 #include <test_timeline.inl>
@@ -0,0 +1,18 @@
+-- Frame time regression for the 'default' scene. This script plays back the session
+-- recording 'frametime_default.osrec' from the recordings folder at a fixed 60 frames
+-- per second and quits OpenSpace afterwards. The statistics are written to
+-- ${BASE}/frametime_default.json and compared against the thresholds in default.json
+-- next to this file. Start OpenSpace with:
+--
+--   OpenSpace --config "Asset='default';GlobalCustomizationScripts={'${BASE}/tests/regression/frametime/default.lua'}"
+--
+-- Other scenes work the same way with a copy of this file and their own recording and
+-- threshold file
+
+openspace.runFrameTimeRegression(
+    'frametime_default.osrec',
+    60,
+    '${BASE}/frametime_default.json',
+    '${BASE}/tests/regression/frametime/default.json',
+    true
+)
@@ -41,6 +41,29 @@ TEST_F(ConcurrentQueueTest, Basic) {
     std::cout << val << std::endl;
 }
 
+TEST_F(ConcurrentQueueTest, OverflowKeepsOrder) {
+    using namespace openspace;
+
+    // More items than fit into the lock-free ring buffer
+    constexpr const int NItems = 5000;
+
+    ConcurrentQueue<int> q;
+    for (int i = 0; i < NItems; ++i) {
+        q.push(i);
+    }
+    ASSERT_EQ(q.size(), NItems);
+
+    for (int i = 0; i < NItems; ++i) {
+        int val = -1;
+        ASSERT_TRUE(q.tryPop(val));
+        ASSERT_EQ(val, i);
+    }
+
+    int val = -1;
+    EXPECT_FALSE(q.tryPop(val));
+    EXPECT_TRUE(q.empty());
+}
+
 /*
 TEST_F(ConcurrentQueueTest, SharedPtr) {
     ConcurrentQueue<std::shared_ptr<int>> q1;
@@ -2922,3 +2922,41 @@ TEST_F(DocumentationTest, VerifierDocumentationPostConditions) {
     EXPECT_NE("", ReferencingVerifier("identifier"s).documentation());
 
 }
+
+namespace {
+    openspace::documentation::Documentation cachedTestDocumentation() {
+        using namespace openspace::documentation;
+        return { {{ "Int", new IntVerifier, Optional::No }} };
+    }
+} // namespace
+
+TEST_F(DocumentationTest, CachedDocumentation) {
+    using namespace openspace::documentation;
+    using namespace std::string_literals;
+
+    const Documentation& doc = cachedDocumentation(cachedTestDocumentation);
+    EXPECT_EQ(&doc, &cachedDocumentation(cachedTestDocumentation));
+    ASSERT_EQ(1, doc.entries.size());
+
+    ghoul::Dictionary positive { { "Int", 1 } };
+    EXPECT_NO_THROW(testSpecificationAndThrow(cachedTestDocumentation, positive, "Test"));
+
+    ghoul::Dictionary negative { { "Int", "foo"s } };
+    EXPECT_THROW(
+        testSpecificationAndThrow(cachedTestDocumentation, negative, "Test"),
+        SpecificationError
+    );
+
+    {
+        SpecificationTestBypass bypass;
+        EXPECT_NO_THROW(
+            testSpecificationAndThrow(cachedTestDocumentation, negative, "Test")
+        );
+        EXPECT_FALSE(testSpecification(doc, negative).success);
+    }
+
+    EXPECT_THROW(
+        testSpecificationAndThrow(cachedTestDocumentation, negative, "Test"),
+        SpecificationError
+    );
+}
@@ -95,3 +95,42 @@ TEST_F(LRUCacheTest, StructKey) {
     ASSERT_EQ(lru.get(key1), val2);
     ASSERT_EQ(lru.get(key2), val2);
 }
+
+TEST_F(LRUCacheTest, ItemsOrder) {
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(4);
+    lru.put(1, 10);
+    lru.put(2, 20);
+    lru.put(3, 30);
+    lru.get(1);
+
+    // The items are ordered from the most to the least recently used one
+    std::vector<int> keys;
+    for (const std::pair<int, int>& item : lru.items()) {
+        keys.push_back(item.first);
+    }
+    ASSERT_EQ(keys, std::vector<int>({ 1, 3, 2 }));
+    ASSERT_EQ(lru.popLRU().first, 2);
+    ASSERT_EQ(lru.popMRU().first, 1);
+    ASSERT_EQ(lru.size(), size_t(1));
+    ASSERT_TRUE(lru.exist(3));
+}
+
+TEST_F(LRUCacheTest, RemovalKeepsItemsReachable) {
+    // Removing items from the middle of the cache fills their gaps with other items,
+    // which have to remain reachable by their keys
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(1000);
+    for (int i = 0; i < 1000; ++i) {
+        lru.put(i * 64, i);
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        lru.touch(i * 64);
+        lru.popMRU();
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(lru.exist(i * 64), i % 3 != 0) << "Key " << i * 64;
+        if (i % 3 != 0) {
+            ASSERT_EQ(lru.get(i * 64), i);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/prefixtrie.h>
+
+class PrefixTrieTest : public testing::Test {};
+
+TEST_F(PrefixTrieTest, InsertAndErase) {
+    openspace::PrefixTrie trie;
+    trie.insert("Scene.Earth.Renderable.Enabled");
+    trie.insert("Scene.Earth.Renderable.Opacity");
+    trie.insert("Scene.Earth.Renderable.Enabled");
+    EXPECT_EQ(trie.size(), 2u);
+    EXPECT_TRUE(trie.contains("Scene.Earth.Renderable.Enabled"));
+    EXPECT_FALSE(trie.contains("Scene.Earth.Renderable"));
+
+    trie.erase("Scene.Earth.Renderable.Enabled");
+    trie.erase("Scene.Mars");
+    EXPECT_EQ(trie.size(), 1u);
+    EXPECT_FALSE(trie.contains("Scene.Earth.Renderable.Enabled"));
+    EXPECT_TRUE(trie.contains("Scene.Earth.Renderable.Opacity"));
+
+    trie.erase("Scene.Earth.Renderable.Opacity");
+    EXPECT_EQ(trie.size(), 0u);
+    EXPECT_TRUE(trie.completions("").empty());
+}
+
+TEST_F(PrefixTrieTest, Completions) {
+    openspace::PrefixTrie trie;
+    trie.insert("openspace.setPropertyValue");
+    trie.insert("openspace.setPropertyValueSingle");
+    trie.insert("openspace.time.setTime");
+    trie.insert("openspace.time.setDeltaTime");
+    trie.insert("openspace.globebrowsing.addLayer");
+
+    std::vector<openspace::PrefixTrie::Completion> c = trie.completions("op");
+    ASSERT_EQ(c.size(), 1u);
+    EXPECT_EQ(c[0].value, "openspace.");
+    EXPECT_FALSE(c[0].isEntry);
+
+    c = trie.completions("openspace.SETprop");
+    ASSERT_EQ(c.size(), 2u);
+    EXPECT_EQ(c[0].value, "openspace.setPropertyValue");
+    EXPECT_TRUE(c[0].isEntry);
+    EXPECT_EQ(c[1].value, "openspace.setPropertyValueSingle");
+
+    c = trie.completions("OpenSpace.time.");
+    ASSERT_EQ(c.size(), 2u);
+    EXPECT_EQ(c[0].value, "openspace.time.setDeltaTime");
+    EXPECT_EQ(c[1].value, "openspace.time.setTime");
+
+    c = trie.completions("openspace.");
+    ASSERT_EQ(c.size(), 4u);
+    EXPECT_EQ(c[0].value, "openspace.globebrowsing.");
+    EXPECT_EQ(c[3].value, "openspace.time.");
+
+    EXPECT_TRUE(trie.completions("openspace.space.").empty());
+}
+
+TEST_F(PrefixTrieTest, EntryWithChildren) {
+    openspace::PrefixTrie trie;
+    trie.insert("a.b");
+    trie.insert("a.b.c");
+
+    const std::vector<openspace::PrefixTrie::Completion> c = trie.completions("a.");
+    ASSERT_EQ(c.size(), 2u);
+    EXPECT_EQ(c[0].value, "a.b");
+    EXPECT_TRUE(c[0].isEntry);
+    EXPECT_EQ(c[1].value, "a.b.");
+    EXPECT_FALSE(c[1].isEntry);
+
+    trie.erase("a.b");
+    EXPECT_TRUE(trie.contains("a.b.c"));
+    EXPECT_EQ(trie.completions("a.").size(), 1u);
+}
@@ -802,3 +802,59 @@ TEST_F(ScriptSchedulerTest, AllScriptsMixedLoad) {
     EXPECT_LE(allScripts[0].time, allScripts[1].time);
     EXPECT_LE(allScripts[1].time, allScripts[2].time);
 }
+
+TEST_F(ScriptSchedulerTest, OutOfOrderMultipleLoad) {
+    using namespace openspace::scripting;
+    using namespace std::string_literals;
+
+    ScriptScheduler scheduler;
+
+    ghoul::Dictionary testDictionary1 = {
+        { "Time", "2000 JAN 03"s },
+        { "ForwardScript", "ForwardScript1"s },
+        { "BackwardScript", "BackwardScript1"s }
+    };
+
+    ghoul::Dictionary testDictionary2 = {
+        { "Time", "2000 JAN 05"s },
+        { "ForwardScript", "ForwardScript2"s },
+        { "BackwardScript", "BackwardScript2"s }
+    };
+
+    ghoul::Dictionary testDictionary3 = {
+        { "Time", "2000 JAN 10"s },
+        { "ForwardScript", "ForwardScript3"s },
+        { "BackwardScript", "BackwardScript3"s }
+    };
+
+    scheduler.progressTo(openspace::Time::convertTime("2000 JAN 01"));
+    scheduler.loadScripts({
+        { "1", testDictionary3 }
+    });
+    scheduler.loadScripts({
+        { "1", testDictionary1 }
+    });
+    scheduler.loadScripts({
+        { "1", testDictionary2 }
+    });
+
+    auto allScripts = scheduler.allScripts();
+    ASSERT_EQ(3, allScripts.size());
+    EXPECT_EQ("ForwardScript1", allScripts[0].forwardScript);
+    EXPECT_EQ("BackwardScript1", allScripts[0].backwardScript);
+    EXPECT_EQ("ForwardScript2", allScripts[1].forwardScript);
+    EXPECT_EQ("BackwardScript2", allScripts[1].backwardScript);
+    EXPECT_EQ("ForwardScript3", allScripts[2].forwardScript);
+    EXPECT_EQ("BackwardScript3", allScripts[2].backwardScript);
+
+    auto res = scheduler.progressTo(openspace::Time::convertTime("2000 JAN 11"));
+    ASSERT_EQ(3, std::distance(res.first, res.second));
+    EXPECT_EQ("ForwardScript1", *(res.first));
+    EXPECT_EQ("ForwardScript2", *(std::next(res.first)));
+    EXPECT_EQ("ForwardScript3", *(std::next(res.first, 2)));
+
+    res = scheduler.progressTo(openspace::Time::convertTime("2000 JAN 04"));
+    ASSERT_EQ(2, std::distance(res.first, res.second));
+    EXPECT_EQ("BackwardScript3", *(res.first));
+    EXPECT_EQ("BackwardScript2", *(std::next(res.first)));
+}
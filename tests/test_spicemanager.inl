@@ -149,6 +149,36 @@ TEST_F(SpiceManagerTest, loadSingleKernel) {
     ASSERT_TRUE(found == SPICETRUE) << "Kernel not loaded";
 }
 
+// Try loading multiple kernels at once, the second time using the cached coverage
+TEST_F(SpiceManagerTest, loadMultipleKernels) {
+    const std::vector<std::string> kernels = {
+        absPath("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls"),
+        absPath("${TESTDIR}/SpiceTest/spicekernels/981005_PLTEPH-DE405S.bsp"),
+        absPath("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls"),
+        absPath("${TESTDIR}/SpiceTest/spicekernels/04135_04171pc_psiv2.bc")
+    };
+
+    std::vector<openspace::SpiceManager::KernelHandle> handles =
+        openspace::SpiceManager::ref().loadKernels(kernels);
+    ASSERT_EQ(4, handles.size());
+    EXPECT_EQ(1, handles[0]) << "loadKernels did not return proper id";
+    EXPECT_EQ(2, handles[1]) << "loadKernels did not return proper id";
+    EXPECT_EQ(1, handles[2]) << "Duplicate kernel was not reference counted";
+    EXPECT_EQ(3, handles[3]) << "loadKernels did not return proper id";
+
+    std::vector<std::pair<double, double>> coverage =
+        openspace::SpiceManager::ref().spkCoverage("EARTH");
+    EXPECT_FALSE(coverage.empty()) << "No coverage was found for the Spk kernel";
+
+    openspace::SpiceManager::deinitialize();
+    openspace::SpiceManager::initialize();
+
+    openspace::SpiceManager::ref().loadKernels(kernels);
+    std::vector<std::pair<double, double>> cachedCoverage =
+        openspace::SpiceManager::ref().spkCoverage("EARTH");
+    EXPECT_EQ(coverage, cachedCoverage) << "Cached coverage differs from the kernel";
+}
+
 // Try unloading kernel using user assigned keyword
 TEST_F(SpiceManagerTest, unloadKernelString) {
     loadLSKKernel();
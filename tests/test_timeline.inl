@@ -94,3 +94,31 @@ TEST_F(TimelineTest, RemoveKeyframesInRange) {
     timeline.removeKeyframesBetween(-1.0, 4.0);
     ASSERT_EQ(timeline.nKeyframes(), 0);
 }
+
+TEST_F(TimelineTest, AddKeyframesInBulk) {
+    openspace::Timeline<float> timeline;
+    timeline.addKeyframe(1.0, 1.f);
+    timeline.addKeyframe(3.0, 3.f);
+
+    timeline.addKeyframes({ { 4.0, 4.f }, { 2.0, 2.f }, { 0.0, 0.f } });
+    ASSERT_EQ(timeline.nKeyframes(), 5);
+
+    const openspace::KeyframeSpan<float> keyframes = timeline.keyframes();
+    for (size_t i = 0; i < keyframes.size(); ++i) {
+        ASSERT_EQ(keyframes[i].data, static_cast<float>(i)) << "Keyframes not sorted";
+    }
+}
+
+TEST_F(TimelineTest, QueryKeyframesMonotonically) {
+    openspace::Timeline<float> timeline;
+    for (int i = 0; i < 100; ++i) {
+        timeline.addKeyframe(static_cast<double>(i), static_cast<float>(i));
+    }
+
+    for (double t = 0.5; t < 99.0; t += 0.25) {
+        ASSERT_EQ(timeline.lastKeyframeBefore(t)->data, std::floor(t));
+        ASSERT_EQ(timeline.firstKeyframeAfter(t)->data, std::floor(t) + 1.f);
+        timeline.removeKeyframesBefore(std::floor(t));
+        ASSERT_EQ(timeline.keyframes().begin()->data, std::floor(t));
+    }
+}